@@ -76,6 +76,7 @@ QuicAckTrackerReset(
     Tracker->LargestPacketNumberRecvTime = 0;
     Tracker->AlreadyWrittenAckFrame = FALSE;
     Tracker->NonZeroRecvECN = FALSE;
+    Tracker->AckBlockCacheValid = FALSE;
     CxPlatZeroMemory(&Tracker->ReceivedECN, sizeof(Tracker->ReceivedECN));
     QuicRangeReset(&Tracker->PacketNumbersToAck);
     QuicRangeReset(&Tracker->PacketNumbersReceived);
@@ -161,6 +162,103 @@ QuicAckTrackerDidHitReorderingThreshold(
     return FALSE;
 }
 
+//
+// Returns the number of ACK eliciting packets that may be received before an
+// ACK is sent immediately. Normally this is the tolerance requested by the
+// peer, but when ACK decimation is enabled locally and the 1-RTT packets have
+// been received in order, with no gap above what was last reported, it is
+// widened to the configured maximum. Any loss or reordering falls back to the
+// peer's tolerance, and the delayed ACK timer still bounds the ACK latency.
+//
+static
+uint16_t
+QuicAckTrackerGetPacketTolerance(
+    _In_ QUIC_ACK_TRACKER* Tracker,
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    const uint16_t PacketTolerance = (uint16_t)Connection->PacketTolerance;
+    if (Connection->Settings.AckDecimationMaxPackets <= PacketTolerance ||
+        QuicAckTrackerGetPacketSpace(Tracker)->EncryptLevel != QUIC_ENCRYPT_LEVEL_1_RTT) {
+        return PacketTolerance;
+    }
+
+    const QUIC_SUBRANGE* Last =
+        QuicRangeGet(
+            &Tracker->PacketNumbersToAck,
+            QuicRangeSize(&Tracker->PacketNumbersToAck) - 1);
+    if (Last->Low > Tracker->LargestPacketNumberAcknowledged + 1) {
+        return PacketTolerance; // Gap since the last ACK.
+    }
+
+    return (uint16_t)CXPLAT_MIN(Connection->Settings.AckDecimationMaxPackets, UINT16_MAX);
+}
+
+//
+// Updates the cached ACK blocks after PacketNumber was added to the ranges to
+// ACK, given the largest packet number and number of ranges from before.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicAckTrackerUpdateAckBlockCache(
+    _Inout_ QUIC_ACK_TRACKER* Tracker,
+    _In_ uint64_t PacketNumber,
+    _In_ uint64_t PrevLargestPacketNumber,
+    _In_ uint32_t PrevRangeSize
+    )
+{
+    const uint32_t RangeSize = QuicRangeSize(&Tracker->PacketNumbersToAck);
+
+    if (PrevRangeSize == 0) {
+        //
+        // Nothing below the only range.
+        //
+        Tracker->AckBlockCacheLength = 0;
+        Tracker->AckBlockCacheValid = TRUE;
+
+    } else if (!Tracker->AckBlockCacheValid) {
+        return;
+
+    } else if (PacketNumber == PrevLargestPacketNumber + 1 && RangeSize == PrevRangeSize) {
+        //
+        // The largest range grew, which only changes the frame's header.
+        //
+
+    } else if (PacketNumber > PrevLargestPacketNumber + 1 && RangeSize == PrevRangeSize + 1) {
+        //
+        // A new largest range; the previous largest becomes the first of the
+        // additional blocks.
+        //
+        uint8_t Block[2 * sizeof(QUIC_VAR_INT)];
+        uint16_t BlockLength = 0;
+        if (QuicAckBlocksEncode(
+                &Tracker->PacketNumbersToAck,
+                RangeSize - 1,
+                RangeSize - 2,
+                &BlockLength,
+                sizeof(Block),
+                Block) &&
+            Tracker->AckBlockCacheLength + BlockLength <= sizeof(Tracker->AckBlockCache)) {
+            CxPlatMoveMemory(
+                Tracker->AckBlockCache + BlockLength,
+                Tracker->AckBlockCache,
+                Tracker->AckBlockCacheLength);
+            CxPlatCopyMemory(Tracker->AckBlockCache, Block, BlockLength);
+            Tracker->AckBlockCacheLength += BlockLength;
+        } else {
+            Tracker->AckBlockCacheValid = FALSE;
+        }
+
+    } else {
+        //
+        // Reordering filled in or split a lower range, or the oldest ranges
+        // were dropped to bound the range's growth.
+        //
+        Tracker->AckBlockCacheValid = FALSE;
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicAckTrackerAckPacket(
@@ -181,7 +279,8 @@ QuicAckTrackerAckPacket(
 
     CXPLAT_DBG_ASSERT(PacketNumber <= QUIC_VAR_INT_MAX);
 
-    uint64_t CurLargestPacketNumber;
+    const uint32_t PrevRangeSize = QuicRangeSize(&Tracker->PacketNumbersToAck);
+    uint64_t CurLargestPacketNumber = 0;
     if (QuicRangeGetMaxSafe(&Tracker->PacketNumbersToAck, &CurLargestPacketNumber) &&
         CurLargestPacketNumber > PacketNumber) {
         //
@@ -199,6 +298,8 @@ QuicAckTrackerAckPacket(
         return;
     }
 
+    QuicAckTrackerUpdateAckBlockCache(
+        Tracker, PacketNumber, CurLargestPacketNumber, PrevRangeSize);
 
     BOOLEAN NewLargestPacketNumber =
         PacketNumber == QuicRangeGetMax(&Tracker->PacketNumbersToAck);
@@ -240,7 +341,8 @@ QuicAckTrackerAckPacket(
     //
     //   1. The packet included an IMMEDIATE_ACK frame.
     //   2. ACK delay is disabled (MaxAckDelayMs == 0).
-    //   3. We have received 'PacketTolerance' ACK eliciting packets.
+    //   3. We have received 'PacketTolerance' ACK eliciting packets (widened
+    //      by local ACK decimation while packets arrive in order).
     //   4. We have received an ACK eliciting packet that is out of order and the
     //      gap between the smallest Unreported Missing packet and the Largest
     //      Unacked is greater than or equal to the Reordering Threshold value. This logic is
@@ -253,7 +355,10 @@ QuicAckTrackerAckPacket(
 
     if (AckType == QUIC_ACK_TYPE_ACK_IMMEDIATE ||
         Connection->Settings.MaxAckDelayMs == 0 ||
-        (Tracker->AckElicitingPacketsToAcknowledge >= (uint16_t)Connection->PacketTolerance) ||
+        (Tracker->AckElicitingPacketsToAcknowledge >=
+            (NewLargestPacketNumber ?
+                QuicAckTrackerGetPacketTolerance(Tracker, Connection) :
+                (uint16_t)Connection->PacketTolerance)) ||
         (NewLargestPacketNumber &&
         QuicAckTrackerDidHitReorderingThreshold(Tracker, Connection->ReorderingThreshold))) {
         //
@@ -301,7 +406,37 @@ QuicAckTrackerAckFrameEncode(
         }
     }
 
-    if (!QuicAckFrameEncode(
+    if (!Tracker->AckBlockCacheValid) {
+        //
+        // Rebuild the cached ACK blocks if they fit. Otherwise, this frame is
+        // encoded from scratch.
+        //
+        Tracker->AckBlockCacheLength = 0;
+        Tracker->AckBlockCacheValid =
+            QuicAckBlocksEncode(
+                &Tracker->PacketNumbersToAck,
+                QuicRangeSize(&Tracker->PacketNumbersToAck) - 1,
+                0,
+                &Tracker->AckBlockCacheLength,
+                sizeof(Tracker->AckBlockCache),
+                Tracker->AckBlockCache);
+    }
+
+    if (Tracker->AckBlockCacheValid) {
+        if (!QuicAckFrameEncodeWithBlocks(
+                &Tracker->PacketNumbersToAck,
+                AckDelay,
+                Tracker->NonZeroRecvECN ?
+                    &Tracker->ReceivedECN :
+                    NULL,
+                Tracker->AckBlockCacheLength,
+                Tracker->AckBlockCache,
+                &Builder->DatagramLength,
+                (uint16_t)Builder->Datagram->Length - Builder->EncryptionOverhead,
+                Builder->Datagram->Buffer)) {
+            return FALSE;
+        }
+    } else if (!QuicAckFrameEncode(
             &Tracker->PacketNumbersToAck,
             AckDelay,
             Tracker->NonZeroRecvECN ?
@@ -343,6 +478,7 @@ QuicAckTrackerOnAckFrameAcked(
     QuicRangeSetMin(
         &Tracker->PacketNumbersToAck,
         LargestAckedPacketNumber + 1);
+    Tracker->AckBlockCacheValid = FALSE;
 
     if (!QuicAckTrackerHasPacketsToAck(Tracker) &&
         Tracker->AckElicitingPacketsToAcknowledge) {
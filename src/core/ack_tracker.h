@@ -56,6 +56,21 @@ typedef struct QUIC_ACK_TRACKER {
     //
     BOOLEAN NonZeroRecvECN : 1;
 
+    //
+    // Indicates AckBlockCache holds the encoded additional ACK blocks for all
+    // of PacketNumbersToAck below its largest range.
+    //
+    BOOLEAN AckBlockCacheValid : 1;
+
+    //
+    // The encoded additional ACK blocks, kept between ACK frames so that only
+    // the header needs encoding while packets arrive in order. A new largest
+    // range just prepends a block; any other change to the ranges invalidates
+    // the cache.
+    //
+    uint16_t AckBlockCacheLength;
+    uint8_t AckBlockCache[QUIC_ACK_BLOCK_CACHE_SIZE];
+
 } QUIC_ACK_TRACKER;
 
 //
@@ -45,6 +45,11 @@ _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
 #pragma prefast(suppress : __WARNING_25024, "Pointer cast already validated.")
   Registration = (QUIC_REGISTRATION *)RegistrationHandle;
 
+  if (!QuicRegistrationHasConnectionQuota(Registration)) {
+    Status = QUIC_STATUS_CONNECTION_REFUSED;
+    goto Error;
+  }
+
   //
   // Just use the current partition for now. Once the connection receives a
   // packet the partition can be updated accordingly.
@@ -59,7 +64,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
   // Hard partitioning is only supported on a subset of platforms.
   //
 #if defined(__linux__) && !defined(CXPLAT_USE_IO_URING) &&                     \
-    !defined(CXPLAT_LINUX_XDP_ENABLED)
+    !defined(CXPLAT_LINUX_XDP_ENABLED) && !defined(CXPLAT_LINUX_DPDK_ENABLED)
   Connection->State.Partitioned = Partitioned;
 #else
   UNREFERENCED_PARAMETER(Partitioned);
@@ -303,7 +308,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
 
   Configuration = (QUIC_CONFIGURATION *)ConfigHandle;
 
-  if (Configuration->SecurityConfig == NULL) {
+  if (QuicConfigurationGetSecurityConfig(Configuration) == NULL) {
     Status = QUIC_STATUS_INVALID_PARAMETER;
     goto Error;
   }
@@ -407,7 +412,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
 
   Configuration = (QUIC_CONFIGURATION *)ConfigHandle;
 
-  if (Configuration->SecurityConfig == NULL) {
+  if (QuicConfigurationGetSecurityConfig(Configuration) == NULL) {
     Status = QUIC_STATUS_INVALID_PARAMETER;
     goto Error;
   }
@@ -435,6 +440,157 @@ Error:
   return Status;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicConnectionSetConfigurationBatch(
+        _In_ uint32_t ConnectionCount,
+        _In_reads_(ConnectionCount) _Pre_defensive_ const HQUIC *Connections,
+        _In_ _Pre_defensive_ HQUIC ConfigHandle) {
+  QUIC_STATUS Status;
+  QUIC_CONFIGURATION *Configuration;
+  QUIC_OPERATION **Opers = NULL;
+  uint32_t OperCount = 0;
+
+  if (ConnectionCount == 0 || Connections == NULL || ConfigHandle == NULL ||
+      ConfigHandle->Type != QUIC_HANDLE_TYPE_CONFIGURATION) {
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  Configuration = (QUIC_CONFIGURATION *)ConfigHandle;
+
+  if (QuicConfigurationGetSecurityConfig(Configuration) == NULL) {
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  for (uint32_t i = 0; i < ConnectionCount; ++i) {
+    if (!IS_CONN_HANDLE(Connections[i])) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+#pragma prefast(suppress : __WARNING_25024, "Pointer cast already validated.")
+    QUIC_CONNECTION *Connection = (QUIC_CONNECTION *)Connections[i];
+    QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+    QUIC_CONN_VERIFY(Connection, !Connection->State.HandleClosed);
+
+    if (QuicConnIsClient(Connection)) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+    if (Connection->Configuration != NULL) {
+      Status = QUIC_STATUS_INVALID_STATE;
+      goto Exit;
+    }
+  }
+
+  //
+  // Allocate every operation up front so that the configuration is either
+  // queued on all the connections or none of them.
+  //
+  Opers = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_OPERATION *) * ConnectionCount,
+                                QUIC_POOL_CONFIG_BATCH);
+  if (Opers == NULL) {
+    Status = QUIC_STATUS_OUT_OF_MEMORY;
+    goto Exit;
+  }
+
+  for (; OperCount < ConnectionCount; ++OperCount) {
+    QUIC_OPERATION *Oper = QuicConnAllocOperation(
+        (QUIC_CONNECTION *)Connections[OperCount], QUIC_OPER_TYPE_API_CALL);
+    if (Oper == NULL) {
+      Status = QUIC_STATUS_OUT_OF_MEMORY;
+      goto Exit;
+    }
+
+    QuicConfigurationAddRef(Configuration, QUIC_CONF_REF_CONN_SET_OP);
+    Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SET_CONFIGURATION;
+    Oper->API_CALL.Context->CONN_SET_CONFIGURATION.Configuration =
+        Configuration;
+    Opers[OperCount] = Oper;
+  }
+
+  //
+  // Queue the operations but don't wait for the completions.
+  //
+  for (uint32_t i = 0; i < ConnectionCount; ++i) {
+    QuicConnQueueOper((QUIC_CONNECTION *)Connections[i], Opers[i]);
+  }
+  OperCount = 0;
+  Status = QUIC_STATUS_PENDING;
+
+Exit:
+
+  if (Opers != NULL) {
+    for (uint32_t i = 0; i < OperCount; ++i) {
+      QuicOperationFree(Opers[i]);
+    }
+    CXPLAT_FREE(Opers, QUIC_POOL_CONFIG_BATCH);
+  }
+
+  return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicConnectionExecute(
+        _In_ _Pre_defensive_ HQUIC Handle,
+        _In_ _Pre_defensive_ QUIC_CONNECTION_EXECUTE_HANDLER *Handler,
+        _In_opt_ void *Context) {
+  QUIC_STATUS Status;
+  QUIC_CONNECTION *Connection;
+  QUIC_OPERATION *Oper;
+
+  if (!IS_CONN_HANDLE(Handle) || Handler == NULL) {
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    goto Error;
+  }
+
+#pragma prefast(suppress : __WARNING_25024, "Pointer cast already validated.")
+  Connection = (QUIC_CONNECTION *)Handle;
+
+  QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+  QUIC_CONN_VERIFY(Connection, !Connection->State.HandleClosed);
+
+#pragma warning(push)
+#pragma warning(disable : 6240) // CXPLAT_AT_DISPATCH only really does anything
+                                // for kernel mode
+  const BOOLEAN IsWorkerThread =
+      !CXPLAT_AT_DISPATCH() &&
+      Connection->WorkerThreadID == CxPlatCurThreadID();
+#pragma warning(pop)
+
+  if (IsWorkerThread) {
+    //
+    // Already in the connection's drain (e.g. in one of its callbacks), so
+    // run the handler now, without allocating or queuing an operation. API
+    // calls it makes execute inline the same as from a callback.
+    //
+    Handler(Handle, Context, QUIC_STATUS_SUCCESS);
+    Status = QUIC_STATUS_SUCCESS;
+    goto Error;
+  }
+
+  Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
+  if (Oper == NULL) {
+    Status = QUIC_STATUS_OUT_OF_MEMORY;
+    goto Error;
+  }
+  Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_EXECUTE;
+  Oper->API_CALL.Context->CONN_EXECUTE.Connection = Handle;
+  Oper->API_CALL.Context->CONN_EXECUTE.Handler = Handler;
+  Oper->API_CALL.Context->CONN_EXECUTE.Context = Context;
+
+  //
+  // Queue the operation but don't wait for the completion.
+  //
+  QuicConnQueueOper(Connection, Oper);
+  Status = QUIC_STATUS_PENDING;
+
+Error:
+  return Status;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
     MsQuicConnectionSendResumptionTicket(_In_ _Pre_defensive_ HQUIC Handle,
                                          _In_ QUIC_SEND_RESUMPTION_FLAGS Flags,
@@ -720,6 +876,93 @@ Exit:
   return Status;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicStreamStartBatch(_In_ uint32_t StreamCount,
+                           _In_reads_(StreamCount) _Pre_defensive_ const HQUIC *Streams,
+                           _In_ QUIC_STREAM_START_FLAGS Flags) {
+  QUIC_STATUS Status;
+  QUIC_CONNECTION *Connection = NULL;
+  QUIC_STREAM **StreamArray = NULL;
+
+  if (StreamCount == 0 || Streams == NULL) {
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  for (uint32_t i = 0; i < StreamCount; ++i) {
+    if (!IS_STREAM_HANDLE(Streams[i])) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+#pragma prefast(suppress : __WARNING_25024, "Pointer cast already validated.")
+    QUIC_STREAM *Stream = (QUIC_STREAM *)Streams[i];
+
+    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+
+    if (Connection == NULL) {
+      Connection = Stream->Connection;
+      QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+    } else if (Stream->Connection != Connection) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+    if (Stream->Flags.Started) {
+      Status = QUIC_STATUS_INVALID_STATE;
+      goto Exit;
+    }
+  }
+
+  if (Connection->State.ClosedRemotely) {
+    Status = QUIC_STATUS_ABORTED;
+    goto Exit;
+  }
+
+  StreamArray = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_STREAM *) * StreamCount,
+                                      QUIC_POOL_STREAM_BATCH);
+  if (StreamArray == NULL) {
+    Status = QUIC_STATUS_OUT_OF_MEMORY;
+    goto Exit;
+  }
+
+  QUIC_OPERATION *Oper =
+      QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
+  if (Oper == NULL) {
+    CXPLAT_FREE(StreamArray, QUIC_POOL_STREAM_BATCH);
+    Status = QUIC_STATUS_OUT_OF_MEMORY;
+    goto Exit;
+  }
+
+  //
+  // Each stream holds a ref for the operation, just like StreamStart.
+  //
+  for (uint32_t i = 0; i < StreamCount; ++i) {
+    StreamArray[i] = (QUIC_STREAM *)Streams[i];
+    QuicStreamAddRef(StreamArray[i], QUIC_STREAM_REF_OPERATION);
+  }
+
+  Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_START_BATCH;
+  Oper->API_CALL.Context->STRM_START_BATCH.Streams = StreamArray;
+  Oper->API_CALL.Context->STRM_START_BATCH.StreamCount = StreamCount;
+  Oper->API_CALL.Context->STRM_START_BATCH.Flags = Flags;
+
+  //
+  // Queue the operation but don't wait for the completion.
+  //
+  if (Flags & QUIC_STREAM_START_FLAG_PRIORITY_WORK) {
+    QuicConnQueuePriorityOper(Connection, Oper);
+  } else {
+    QuicConnQueueOper(Connection, Oper);
+  }
+  Status = QUIC_STATUS_PENDING;
+
+Exit:
+
+  return Status;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
     MsQuicStreamShutdown(_In_ _Pre_defensive_ HQUIC Handle,
                          _In_ QUIC_STREAM_SHUTDOWN_FLAGS Flags,
@@ -821,12 +1064,16 @@ Error:
   return Status;
 }
 
-_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
-    MsQuicStreamSend(_In_ _Pre_defensive_ HQUIC Handle,
-                     _In_reads_(BufferCount)
-                         _Pre_defensive_ const QUIC_BUFFER *const Buffers,
-                     _In_ uint32_t BufferCount, _In_ QUIC_SEND_FLAGS Flags,
-                     _In_opt_ void *ClientSendContext) {
+//
+// Queues a send request on the stream. Unlike MsQuicStreamSend, Flags may
+// include internal flags.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) static QUIC_STATUS
+    QuicStreamQueueSend(_In_ _Pre_defensive_ HQUIC Handle,
+                        _In_reads_(BufferCount)
+                            _Pre_defensive_ const QUIC_BUFFER *const Buffers,
+                        _In_ uint32_t BufferCount, _In_ QUIC_SEND_FLAGS Flags,
+                        _In_opt_ void *ClientSendContext) {
   QUIC_STATUS Status;
   QUIC_STREAM *Stream;
   QUIC_CONNECTION *Connection;
@@ -876,15 +1123,14 @@ _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
   SendRequest->Next = NULL;
   SendRequest->Buffers = Buffers;
   SendRequest->BufferCount = BufferCount;
-  SendRequest->Flags = Flags & ~QUIC_SEND_FLAGS_INTERNAL;
+  SendRequest->Flags = Flags;
   SendRequest->TotalLength = TotalLength;
   SendRequest->ClientContext = ClientSendContext;
 
 #pragma warning(push)
 #pragma warning(disable : 6240) // CXPLAT_AT_DISPATCH only really does anything
                                 // for kernel mode
-  SendInline = !Connection->Settings.SendBufferingEnabled &&
-               !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
+  SendInline = !CXPLAT_AT_DISPATCH() && // Never run inline if at DISPATCH
                Connection->WorkerThreadID == CxPlatCurThreadID();
 #pragma warning(pop)
 
@@ -992,6 +1238,217 @@ Exit:
   return Status;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicStreamSend(_In_ _Pre_defensive_ HQUIC Handle,
+                     _In_reads_(BufferCount)
+                         _Pre_defensive_ const QUIC_BUFFER *const Buffers,
+                     _In_ uint32_t BufferCount, _In_ QUIC_SEND_FLAGS Flags,
+                     _In_opt_ void *ClientSendContext) {
+  return QuicStreamQueueSend(Handle, Buffers, BufferCount,
+                             Flags & ~QUIC_SEND_FLAGS_INTERNAL,
+                             ClientSendContext);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicStreamSendFile(_In_ _Pre_defensive_ HQUIC Handle,
+                         _In_ QUIC_FILE_HANDLE File, _In_ uint64_t Offset,
+                         _In_ uint32_t Length, _In_ QUIC_SEND_FLAGS Flags,
+                         _In_opt_ void *ClientSendContext) {
+  QUIC_STATUS Status;
+  QUIC_SEND_FILE *SendFile;
+
+  if (!IS_STREAM_HANDLE(Handle) || Length == 0) {
+    return QUIC_STATUS_INVALID_PARAMETER;
+  }
+
+  SendFile = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_SEND_FILE), QUIC_POOL_SEND_FILE);
+  if (SendFile == NULL) {
+    return QUIC_STATUS_OUT_OF_MEMORY;
+  }
+
+  Status = CxPlatFileRangeMap(File, Offset, Length, &SendFile->Range);
+  if (QUIC_FAILED(Status)) {
+    CXPLAT_FREE(SendFile, QUIC_POOL_SEND_FILE);
+    return Status;
+  }
+
+  SendFile->Buffer.Length = Length;
+  SendFile->Buffer.Buffer = (uint8_t *)SendFile->Range.Data;
+
+  //
+  // The request is never buffered, so packets are built straight from the
+  // mapped pages, and the mapping lives until the data is acknowledged. It is
+  // released when the request completes.
+  //
+  Status = QuicStreamQueueSend(Handle, &SendFile->Buffer, 1,
+                               (Flags & ~QUIC_SEND_FLAGS_INTERNAL) |
+                                   QUIC_SEND_FLAG_NO_BUFFERING |
+                                   QUIC_SEND_FLAG_FILE,
+                               ClientSendContext);
+  if (QUIC_FAILED(Status)) {
+    CxPlatFileRangeUnmap(&SendFile->Range);
+    CXPLAT_FREE(SendFile, QUIC_POOL_SEND_FILE);
+  }
+
+  return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicStreamSendBatch(_In_ uint32_t SendCount,
+                          _In_reads_(SendCount)
+                              _Pre_defensive_ const QUIC_STREAM_SEND_DESC *Sends) {
+  QUIC_STATUS Status;
+  QUIC_CONNECTION *Connection = NULL;
+  QUIC_STREAM_SEND_BATCH_ENTRY *Entries = NULL;
+  QUIC_SEND_REQUEST **SendRequests = NULL;
+  QUIC_OPERATION *Oper;
+  BOOLEAN IsPriority = FALSE;
+
+  if (SendCount == 0 || Sends == NULL) {
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  for (uint32_t i = 0; i < SendCount; ++i) {
+    if (!IS_STREAM_HANDLE(Sends[i].Stream) ||
+        (Sends[i].Buffers == NULL && Sends[i].BufferCount != 0)) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+#pragma prefast(suppress : __WARNING_25024, "Pointer cast already validated.")
+    QUIC_STREAM *Stream = (QUIC_STREAM *)Sends[i].Stream;
+
+    CXPLAT_TEL_ASSERT(!Stream->Flags.HandleClosed);
+    CXPLAT_TEL_ASSERT(!Stream->Flags.Freed);
+
+    if (Connection == NULL) {
+      Connection = Stream->Connection;
+      QUIC_CONN_VERIFY(Connection, !Connection->State.Freed);
+    } else if (Stream->Connection != Connection) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+    uint64_t TotalLength = 0;
+    for (uint32_t j = 0; j < Sends[i].BufferCount; ++j) {
+      TotalLength += Sends[i].Buffers[j].Length;
+    }
+    if (TotalLength > UINT32_MAX) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Exit;
+    }
+
+    IsPriority |= !!(Sends[i].Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+  }
+
+  if (Connection->State.ClosedRemotely) {
+    Status = QUIC_STATUS_ABORTED;
+    goto Exit;
+  }
+
+  //
+  // Allocate everything up front, so that either all the sends are queued or
+  // none of them are.
+  //
+  Entries = CXPLAT_ALLOC_NONPAGED(
+      sizeof(QUIC_STREAM_SEND_BATCH_ENTRY) * SendCount,
+      QUIC_POOL_STREAM_SEND_BATCH);
+  SendRequests = CXPLAT_ALLOC_NONPAGED(
+      sizeof(QUIC_SEND_REQUEST *) * SendCount, QUIC_POOL_STREAM_SEND_BATCH);
+  if (Entries == NULL || SendRequests == NULL) {
+    Status = QUIC_STATUS_OUT_OF_MEMORY;
+    goto Exit;
+  }
+  CxPlatZeroMemory(SendRequests, sizeof(QUIC_SEND_REQUEST *) * SendCount);
+
+  for (uint32_t i = 0; i < SendCount; ++i) {
+    SendRequests[i] = CxPlatPoolAlloc(&Connection->Partition->SendRequestPool);
+    if (SendRequests[i] == NULL) {
+      Status = QUIC_STATUS_OUT_OF_MEMORY;
+      goto Exit;
+    }
+  }
+
+  Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_API_CALL);
+  if (Oper == NULL) {
+    Status = QUIC_STATUS_OUT_OF_MEMORY;
+    goto Exit;
+  }
+
+  for (uint32_t i = 0; i < SendCount; ++i) {
+    QUIC_STREAM *Stream = (QUIC_STREAM *)Sends[i].Stream;
+    QUIC_SEND_REQUEST *SendRequest = SendRequests[i];
+    SendRequests[i] = NULL;
+
+    SendRequest->Next = NULL;
+    SendRequest->Buffers = Sends[i].Buffers;
+    SendRequest->BufferCount = Sends[i].BufferCount;
+    SendRequest->Flags = Sends[i].Flags & ~QUIC_SEND_FLAGS_INTERNAL;
+    SendRequest->TotalLength = 0;
+    for (uint32_t j = 0; j < Sends[i].BufferCount; ++j) {
+      SendRequest->TotalLength += Sends[i].Buffers[j].Length;
+    }
+    SendRequest->ClientContext = Sends[i].ClientSendContext;
+
+    Entries[i].Stream = Stream;
+    Entries[i].Rejected = NULL;
+
+    //
+    // Queue the request behind any the app already sent on the stream, so
+    // the stream's sends stay in order.
+    //
+    CxPlatDispatchLockAcquire(&Stream->ApiSendRequestLock);
+    if (Stream->Flags.SendEnabled) {
+      QUIC_SEND_REQUEST **ApiSendRequestsTail = &Stream->ApiSendRequests;
+      while (*ApiSendRequestsTail != NULL) {
+        ApiSendRequestsTail = &((*ApiSendRequestsTail)->Next);
+      }
+      *ApiSendRequestsTail = SendRequest;
+    } else {
+      Entries[i].Rejected = SendRequest; // Completed as canceled.
+    }
+    CxPlatDispatchLockRelease(&Stream->ApiSendRequestLock);
+
+    //
+    // Each entry holds a ref on its stream for the operation, just like
+    // StreamSend.
+    //
+    QuicStreamAddRef(Stream, QUIC_STREAM_REF_OPERATION);
+  }
+
+  Oper->API_CALL.Context->Type = QUIC_API_TYPE_STRM_SEND_BATCH;
+  Oper->API_CALL.Context->STRM_SEND_BATCH.Entries = Entries;
+  Oper->API_CALL.Context->STRM_SEND_BATCH.EntryCount = SendCount;
+  Entries = NULL;
+
+  //
+  // Queue the operation but don't wait for the completion.
+  //
+  if (IsPriority) {
+    QuicConnQueuePriorityOper(Connection, Oper);
+  } else {
+    QuicConnQueueOper(Connection, Oper);
+  }
+  Status = QUIC_STATUS_PENDING;
+
+Exit:
+
+  if (SendRequests != NULL) {
+    for (uint32_t i = 0; i < SendCount; ++i) {
+      if (SendRequests[i] != NULL) {
+        CxPlatPoolFree(SendRequests[i]);
+      }
+    }
+    CXPLAT_FREE(SendRequests, QUIC_POOL_STREAM_SEND_BATCH);
+  }
+  if (Entries != NULL) {
+    CXPLAT_FREE(Entries, QUIC_POOL_STREAM_SEND_BATCH);
+  }
+
+  return Status;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
     MsQuicStreamReceiveSetEnabled(_In_ _Pre_defensive_ HQUIC Handle,
                                   _In_ BOOLEAN IsEnabled) {
@@ -1478,8 +1935,9 @@ _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
   SendRequest->Next = NULL;
   SendRequest->Buffers = Buffers;
   SendRequest->BufferCount = BufferCount;
-  SendRequest->Flags = Flags;
+  SendRequest->Flags = Flags & ~QUIC_SEND_FLAGS_INTERNAL;
   SendRequest->TotalLength = TotalLength;
+  SendRequest->DeadlineUs = 0;
   SendRequest->ClientContext = ClientSendContext;
 
   Status = QuicDatagramQueueSend(&Connection->Datagram, SendRequest);
@@ -1489,6 +1947,87 @@ Error:
   return Status;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
+    MsQuicDatagramSendBatch(_In_ _Pre_defensive_ HQUIC Handle,
+                            _In_ uint32_t DatagramCount,
+                            _In_reads_(DatagramCount) _Pre_defensive_
+                                const QUIC_DATAGRAM_SEND_DESC *Datagrams) {
+  QUIC_STATUS Status;
+  QUIC_CONNECTION *Connection;
+  QUIC_SEND_REQUEST *Head = NULL;
+  QUIC_SEND_REQUEST **Tail = &Head;
+
+  if (!IS_CONN_HANDLE(Handle) || Datagrams == NULL || DatagramCount == 0) {
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    goto Error;
+  }
+
+#pragma prefast(suppress : __WARNING_25024, "Pointer cast already validated.")
+  Connection = (QUIC_CONNECTION *)Handle;
+
+  CXPLAT_TEL_ASSERT(!Connection->State.Freed);
+
+  const uint64_t TimeNow = CxPlatTimeUs64();
+
+  for (uint32_t i = 0; i < DatagramCount; ++i) {
+    const QUIC_DATAGRAM_SEND_DESC *Desc = &Datagrams[i];
+    if (Desc->Buffers == NULL || Desc->BufferCount == 0 ||
+        Desc->PriorityClass >= QUIC_DATAGRAM_PRIORITY_CLASS_COUNT) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Error;
+    }
+
+    uint64_t TotalLength = 0;
+    for (uint32_t j = 0; j < Desc->BufferCount; ++j) {
+      TotalLength += Desc->Buffers[j].Length;
+    }
+
+    if (TotalLength > UINT16_MAX) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      goto Error;
+    }
+
+#pragma prefast(suppress : __WARNING_6014, "Memory is correctly freed (...).")
+    QUIC_SEND_REQUEST *SendRequest =
+        CxPlatPoolAlloc(&Connection->Partition->SendRequestPool);
+    if (SendRequest == NULL) {
+      Status = QUIC_STATUS_OUT_OF_MEMORY;
+      goto Error;
+    }
+
+    SendRequest->Next = NULL;
+    SendRequest->Buffers = Desc->Buffers;
+    SendRequest->BufferCount = Desc->BufferCount;
+    SendRequest->Flags =
+        (Desc->Flags & ~QUIC_SEND_FLAGS_INTERNAL) |
+        ((QUIC_SEND_FLAGS)Desc->PriorityClass << QUIC_SEND_FLAG_DGRAM_CLASS_SHIFT);
+    SendRequest->TotalLength = TotalLength;
+    SendRequest->DeadlineUs =
+        Desc->DeadlineMs == 0 ? 0 : TimeNow + MS_TO_US((uint64_t)Desc->DeadlineMs);
+    SendRequest->ClientContext = Desc->ClientContext;
+
+    *Tail = SendRequest;
+    Tail = &SendRequest->Next;
+  }
+
+  //
+  // The whole chain is queued (or failed) together, with one lock acquisition
+  // and at most one operation.
+  //
+  Status = QuicDatagramQueueSend(&Connection->Datagram, Head);
+  Head = NULL;
+
+Error:
+
+  while (Head != NULL) {
+    QUIC_SEND_REQUEST *SendRequest = Head;
+    Head = Head->Next;
+    CxPlatPoolFree(SendRequest);
+  }
+
+  return Status;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) QUIC_STATUS QUIC_API
     MsQuicConnectionResumptionTicketValidationComplete(
         _In_ _Pre_defensive_ HQUIC Handle, _In_ BOOLEAN Result) {
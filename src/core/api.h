@@ -242,6 +242,15 @@ MsQuicStreamStart(
     _In_ QUIC_STREAM_START_FLAGS Flags
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamStartBatch(
+    _In_ uint32_t StreamCount,
+    _In_reads_(StreamCount) _Pre_defensive_ const HQUIC* Streams,
+    _In_ QUIC_STREAM_START_FLAGS Flags
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -326,6 +335,16 @@ MsQuicDatagramSend(
     _In_opt_ void* ClientSendContext
     );
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicDatagramSendBatch(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ uint32_t DatagramCount,
+    _In_reads_(DatagramCount) _Pre_defensive_
+        const QUIC_DATAGRAM_SEND_DESC* Datagrams
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -351,3 +370,74 @@ MsQuicConnectionPoolCreate(
     _Out_writes_(Config->NumberOfConnections)
         HQUIC* ConnectionPool
     );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolOpen(
+    _In_ QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Outptr_ _At_(*Pool, __drv_allocatesMem(Mem)) _Pre_defensive_
+        HQUIC* Pool
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QUIC_API
+MsQuicConnectionPoolClose(
+    _In_ _Pre_defensive_ __drv_freesMem(Mem)
+        HQUIC Pool
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolAcquire(
+    _In_ _Pre_defensive_ HQUIC Pool,
+    _Out_ HQUIC* Connection
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+MsQuicConnectionPoolRelease(
+    _In_ _Pre_defensive_ HQUIC Pool,
+    _In_ _Pre_defensive_ HQUIC Connection
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionSetConfigurationBatch(
+    _In_ uint32_t ConnectionCount,
+    _In_reads_(ConnectionCount) _Pre_defensive_ const HQUIC* Connections,
+    _In_ _Pre_defensive_ HQUIC Configuration
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionExecute(
+    _In_ _Pre_defensive_ HQUIC Connection,
+    _In_ _Pre_defensive_ QUIC_CONNECTION_EXECUTE_HANDLER* Handler,
+    _In_opt_ void* Context
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamSendBatch(
+    _In_ uint32_t SendCount,
+    _In_reads_(SendCount) _Pre_defensive_ const QUIC_STREAM_SEND_DESC* Sends
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicStreamSendFile(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    );
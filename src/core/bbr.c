@@ -127,7 +127,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void BbrBandwidthFilterOnPacketAcked(
 
     if (AckedPacket->Flags.HasLastAckedPacketInfo) {
       CXPLAT_DBG_ASSERT(AckedPacket->TotalBytesSent >=
-                        AckedPacket->LastAckedPacketInfo.TotalBytesSent);
+                        QuicSentPacketLastAckedTotalBytesSent(AckedPacket));
       CXPLAT_DBG_ASSERT(CxPlatTimeAtOrBefore64(
           AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime));
 
@@ -138,7 +138,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void BbrBandwidthFilterOnPacketAcked(
       if (SendElapsed) {
         SendRate = (kMicroSecsInSec * BW_UNIT *
                     (AckedPacket->TotalBytesSent -
-                     AckedPacket->LastAckedPacketInfo.TotalBytesSent) /
+                     QuicSentPacketLastAckedTotalBytesSent(AckedPacket)) /
                     SendElapsed);
       }
 
@@ -154,11 +154,11 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void BbrBandwidthFilterOnPacketAcked(
       }
 
       CXPLAT_DBG_ASSERT(AckEvent->NumTotalAckedRetransmittableBytes >=
-                        AckedPacket->LastAckedPacketInfo.TotalBytesAcked);
+                        QuicSentPacketLastAckedTotalBytesAcked(AckedPacket));
       if (AckElapsed) {
         AckRate = (kMicroSecsInSec * BW_UNIT *
                    (AckEvent->NumTotalAckedRetransmittableBytes -
-                    AckedPacket->LastAckedPacketInfo.TotalBytesAcked) /
+                    QuicSentPacketLastAckedTotalBytesAcked(AckedPacket)) /
                    AckElapsed);
       }
     } else if (!CxPlatTimeAtOrBefore64(TimeNow, AckedPacket->SentTime)) {
@@ -334,6 +334,24 @@ _IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
   return Cc->Bbr.BytesInFlightMax;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    BbrCongestionControlGetBandwidthDelayProduct(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONGESTION_CONTROL_BBR *Bbr = &Cc->Bbr;
+
+  uint64_t BandwidthEst = BbrCongestionControlGetBandwidth(Cc);
+  if (!BandwidthEst || Bbr->MinRtt >= UINT32_MAX) {
+    return 0;
+  }
+
+  //
+  // Scale by the current cwnd gain so the estimate tracks what BBR will
+  // actually put in flight (i.e. ahead of the measured BDP during startup).
+  //
+  uint64_t Bdp = BandwidthEst * Bbr->MinRtt / kMicroSecsInSec / BW_UNIT;
+  return Bdp * Bbr->CwndGain / GAIN_UNIT;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) uint8_t
     BbrCongestionControlGetExemptions(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
   return Cc->Bbr.Exemptions;
@@ -557,6 +575,18 @@ _IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
   return SendAllowance;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    BbrCongestionControlGetPacingRate(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  const QUIC_CONGESTION_CONTROL_BBR *Bbr = &Cc->Bbr;
+  if (!Connection->Settings.PacingEnabled || Bbr->MinRtt == UINT32_MAX ||
+      Bbr->MinRtt < QUIC_SEND_PACING_INTERVAL) {
+    return 0;
+  }
+  return BbrCongestionControlGetBandwidth(Cc) * Bbr->PacingGain / GAIN_UNIT /
+         BW_UNIT;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) void BbrCongestionControlTransitToProbeRtt(
     _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t LargestSentPacketNumber) {
   QUIC_CONGESTION_CONTROL_BBR *Bbr = &Cc->Bbr;
@@ -741,6 +771,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
     if (CurrentBandwidth >= BandwidthTarget) {
       Bbr->LastEstimatedStartupBandwidth = CurrentBandwidth;
       Bbr->SlowStartupRoundCounter = 0;
+      QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
     } else if (++Bbr->SlowStartupRoundCounter >= kStartupSlowGrowRoundLimit) {
       Bbr->BtlbwFound = TRUE;
     }
@@ -831,8 +862,24 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void BbrCongestionControlOnDataLost(
 _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
     BbrCongestionControlOnSpuriousCongestionEvent(
         _In_ QUIC_CONGESTION_CONTROL *Cc) {
-  UNREFERENCED_PARAMETER(Cc);
-  return FALSE;
+  QUIC_CONGESTION_CONTROL_BBR *Bbr = &Cc->Bbr;
+
+  if (!BbrCongestionControlInRecovery(Cc)) {
+    return FALSE;
+  }
+
+  BOOLEAN PreviousCanSendState = BbrCongestionControlCanSend(Cc);
+
+  //
+  // The recovery window is the only reduction made for loss, so leaving
+  // recovery undoes it; the model itself was never changed.
+  //
+  Bbr->RecoveryState = RECOVERY_STATE_NOT_RECOVERY;
+
+  BOOLEAN Result =
+      BbrCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+  QuicConnLogBbr(QuicCongestionControlGetConnection(Cc));
+  return Result;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL) void BbrCongestionControlSetAppLimited(
@@ -924,6 +971,7 @@ static const QUIC_CONGESTION_CONTROL QuicCongestionControlBbr = {
     .QuicCongestionControlReset = BbrCongestionControlReset,
     .QuicCongestionControlGetSendAllowance =
         BbrCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = BbrCongestionControlGetPacingRate,
     .QuicCongestionControlGetCongestionWindow =
         BbrCongestionControlGetCongestionWindow,
     .QuicCongestionControlOnDataSent = BbrCongestionControlOnDataSent,
@@ -940,6 +988,8 @@ static const QUIC_CONGESTION_CONTROL QuicCongestionControlBbr = {
     .QuicCongestionControlGetExemptions = BbrCongestionControlGetExemptions,
     .QuicCongestionControlGetBytesInFlightMax =
         BbrCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlGetBandwidthDelayProduct =
+        BbrCongestionControlGetBandwidthDelayProduct,
     .QuicCongestionControlIsAppLimited = BbrCongestionControlIsAppLimited,
     .QuicCongestionControlSetAppLimited = BbrCongestionControlSetAppLimited,
     .QuicCongestionControlGetNetworkStatistics =
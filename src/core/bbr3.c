@@ -0,0 +1,1530 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Bottleneck Bandwidth and RTT version 3 (BBRv3) congestion control.
+
+    Unlike BBR (v1), the model is bounded by what loss and ECN say about the
+    path: a long term upper bound on inflight (InflightHi) is learnt while
+    probing for bandwidth, and short term lower bounds (BwLo, InflightLo)
+    react to congestion within a round. ProbeBW cycles through DOWN, CRUISE,
+    REFILL and UP phases, with the time between probes randomized and capped
+    at what a Reno flow would need (so BBRv3 coexists with loss based flows).
+
+--*/
+
+#include "precomp.h"
+
+typedef enum BBR3_STATE {
+
+  BBR3_STATE_STARTUP,
+
+  BBR3_STATE_DRAIN,
+
+  BBR3_STATE_PROBE_BW_DOWN,
+
+  BBR3_STATE_PROBE_BW_CRUISE,
+
+  BBR3_STATE_PROBE_BW_REFILL,
+
+  BBR3_STATE_PROBE_BW_UP,
+
+  BBR3_STATE_PROBE_RTT
+
+} BBR3_STATE;
+
+typedef enum BBR3_ACK_PHASE {
+
+  BBR3_ACK_PHASE_INIT,
+
+  BBR3_ACK_PHASE_REFILLING,
+
+  BBR3_ACK_PHASE_PROBE_STARTING,
+
+  BBR3_ACK_PHASE_PROBE_FEEDBACK,
+
+  BBR3_ACK_PHASE_PROBE_STOPPING
+
+} BBR3_ACK_PHASE;
+
+//
+// Bandwidth is measured as (bytes / BW_UNIT) per second
+//
+#define BW_UNIT 8 // 1 << 3
+
+//
+// Gain is measured as (1 / GAIN_UNIT)
+//
+#define GAIN_UNIT 256 // 1 << 8
+
+static const uint64_t kBbr3MicroSecsInSec = 1000000;
+
+static const uint64_t kBbr3MilliSecsInSec = 1000;
+
+static const uint64_t kBbr3LowPacingRateThresholdBytesPerSecond = 1200ULL * 1000;
+
+static const uint64_t kBbr3HighPacingRateThresholdBytesPerSecond = 24ULL * 1000 * 1000;
+
+static const uint64_t kBbr3QuantaFactor = 3;
+
+static const uint32_t kBbr3MinPipeCwndInMss = 4;
+
+static const uint32_t kBbr3StartupPacingGain = GAIN_UNIT * 277 / 100; // 4*ln(2)
+
+static const uint32_t kBbr3StartupCwndGain = GAIN_UNIT * 2;
+
+static const uint32_t kBbr3DrainPacingGain = GAIN_UNIT * 35 / 100;
+
+static const uint32_t kBbr3DefaultCwndGain = GAIN_UNIT * 2;
+
+static const uint32_t kBbr3ProbeBwDownPacingGain = GAIN_UNIT * 90 / 100;
+
+static const uint32_t kBbr3ProbeBwUpPacingGain = GAIN_UNIT * 5 / 4;
+
+static const uint32_t kBbr3ProbeBwUpCwndGain = GAIN_UNIT * 9 / 4;
+
+static const uint32_t kBbr3ProbeRttCwndGain = GAIN_UNIT / 2;
+
+//
+// Pace slightly below the estimated bandwidth to drain any queue built by
+// estimation noise.
+//
+static const uint32_t kBbr3PacingMarginPercent = 1;
+
+//
+// STARTUP exits once the bandwidth hasn't grown by kBbr3StartupGrowthTarget
+// for kBbr3StartupFullBwRounds rounds.
+//
+static const uint32_t kBbr3StartupGrowthTarget = GAIN_UNIT * 5 / 4;
+
+static const uint8_t kBbr3StartupFullBwRounds = 3;
+
+//
+// STARTUP also exits on kBbr3StartupFullLossCount loss events in a round with
+// a loss rate above kBbr3LossThresh, or on kBbr3StartupEcnRounds consecutive
+// rounds with a CE ratio above kBbr3EcnThresh.
+//
+static const uint32_t kBbr3StartupFullLossCount = 6;
+
+static const uint8_t kBbr3StartupEcnRounds = 2;
+
+//
+// The maximum tolerated per-round loss rate and CE ratio.
+//
+static const uint32_t kBbr3LossThresh = GAIN_UNIT * 2 / 100;
+
+static const uint32_t kBbr3EcnThresh = GAIN_UNIT / 2;
+
+//
+// The multiplicative decrease applied to the bounds on congestion.
+//
+static const uint32_t kBbr3Beta = GAIN_UNIT * 7 / 10;
+
+//
+// The share of InflightHi left unused while cruising to leave room for other
+// flows.
+//
+static const uint32_t kBbr3Headroom = GAIN_UNIT * 15 / 100;
+
+//
+// ECN: EcnAlpha is updated with a gain of 1 / (1 << kBbr3EcnAlphaGainShift) at
+// the end of each round, and scales the lower bounds by (1 - EcnAlpha *
+// kBbr3EcnFactor).
+//
+static const uint32_t kBbr3EcnAlphaGainShift = 4;
+
+static const uint32_t kBbr3EcnFactor = GAIN_UNIT / 3;
+
+//
+// Bounds on how long to wait in PROBE_BW_DOWN/CRUISE before probing again.
+//
+static const uint64_t kBbr3ProbeBwMaxRounds = 63;
+
+static const uint64_t kBbr3ProbeBwBaseWaitInMicroSecs = S_TO_US(2);
+
+static const uint64_t kBbr3ProbeBwRandWaitInMicroSecs = S_TO_US(1);
+
+static const uint8_t kBbr3ProbeBwUpMaxRounds = 30;
+
+//
+// ProbeRTT is entered when the ProbeRTT minimum is older than
+// kBbr3ProbeRttIntervalInMicroSecs and lasts at least
+// kBbr3ProbeRttDurationInMicroSecs. MinRtt itself expires after
+// kBbr3MinRttFilterLenInMicroSecs.
+//
+static const uint64_t kBbr3ProbeRttIntervalInMicroSecs = S_TO_US(5);
+
+static const uint64_t kBbr3ProbeRttDurationInMicroSecs = MS_TO_US(200);
+
+static const uint64_t kBbr3MinRttFilterLenInMicroSecs = S_TO_US(10);
+
+static const uint32_t kBbr3MaxAckHeightFilterLen = 10;
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint16_t
+    Bbr3CongestionControlGetMss(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  return QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetMinPipeCwnd(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return kBbr3MinPipeCwndInMss * Bbr3CongestionControlGetMss(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlIsInProbeBwState(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.State >= BBR3_STATE_PROBE_BW_DOWN &&
+         Cc->Bbr3.State <= BBR3_STATE_PROBE_BW_UP;
+}
+
+//
+// TRUE while deliberately sending faster than the estimated bandwidth, when
+// congestion shouldn't lower the short term bounds.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlIsProbingBw(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.State == BBR3_STATE_STARTUP ||
+         Cc->Bbr3.State == BBR3_STATE_PROBE_BW_REFILL ||
+         Cc->Bbr3.State == BBR3_STATE_PROBE_BW_UP;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    Bbr3CongestionControlGetBdp(_In_ const QUIC_CONGESTION_CONTROL *Cc,
+                                _In_ uint64_t Bandwidth, _In_ uint32_t Gain) {
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (!Bandwidth || Bbr->MinRtt == UINT64_MAX) {
+    return (uint64_t)Gain * Bbr->InitialCongestionWindow / GAIN_UNIT;
+  }
+
+  uint64_t Bdp = Bandwidth * Bbr->MinRtt / kBbr3MicroSecsInSec / BW_UNIT;
+  return Bdp * Gain / GAIN_UNIT;
+}
+
+//
+// Returns the volume of data to keep in flight for the given bandwidth and
+// gain, padded for send quantization (and ACK aggregation is handled by the
+// caller).
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetInflight(_In_ const QUIC_CONGESTION_CONTROL *Cc,
+                                     _In_ uint64_t Bandwidth,
+                                     _In_ uint32_t Gain) {
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  uint64_t Inflight = Bbr3CongestionControlGetBdp(Cc, Bandwidth, Gain);
+  Inflight += kBbr3QuantaFactor * Bbr->SendQuantum;
+  Inflight = CXPLAT_MAX(Inflight, Bbr3CongestionControlGetMinPipeCwnd(Cc));
+  if (Bbr->State == BBR3_STATE_PROBE_BW_UP) {
+    Inflight += 2 * (uint64_t)Bbr3CongestionControlGetMss(Cc);
+  }
+
+  return (uint32_t)CXPLAT_MIN(Inflight, UINT32_MAX);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetInflightWithHeadroom(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (Bbr->InflightHi == UINT32_MAX) {
+    return UINT32_MAX;
+  }
+
+  uint32_t Headroom =
+      CXPLAT_MAX((uint32_t)Bbr3CongestionControlGetMss(Cc),
+                 (uint32_t)((uint64_t)Bbr->InflightHi * kBbr3Headroom / GAIN_UNIT));
+  uint32_t Inflight =
+      Bbr->InflightHi > Headroom ? Bbr->InflightHi - Headroom : 0;
+  return CXPLAT_MAX(Inflight, Bbr3CongestionControlGetMinPipeCwnd(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetTargetInflight(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  uint64_t Bdp = Bbr3CongestionControlGetBdp(Cc, Cc->Bbr3.Bw, GAIN_UNIT);
+  return (uint32_t)CXPLAT_MIN(Bdp, Cc->Bbr3.CongestionWindow);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetProbeRttCwnd(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  uint64_t ProbeRttCwnd =
+      Bbr3CongestionControlGetBdp(Cc, Cc->Bbr3.Bw, kBbr3ProbeRttCwndGain);
+  return (uint32_t)CXPLAT_MAX(ProbeRttCwnd,
+                              Bbr3CongestionControlGetMinPipeCwnd(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetCongestionWindow(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlIsAppLimited(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.AppLimited;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlGetNetworkStatistics(
+    _In_ const QUIC_CONNECTION *const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL *const Cc,
+    _Out_ QUIC_NETWORK_STATISTICS *NetworkStatistics) {
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  const QUIC_PATH *Path = &Connection->Paths[0];
+
+  NetworkStatistics->BytesInFlight = Bbr->BytesInFlight;
+  NetworkStatistics->PostedBytes = Connection->SendBuffer.PostedBytes;
+  NetworkStatistics->IdealBytes = Connection->SendBuffer.IdealBytes;
+  NetworkStatistics->SmoothedRTT = Path->SmoothedRtt;
+  NetworkStatistics->CongestionWindow = Bbr->CongestionWindow;
+  NetworkStatistics->Bandwidth = Bbr->Bw / BW_UNIT;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlIndicateConnectionEvent(
+    _In_ QUIC_CONNECTION *const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONNECTION_EVENT Event;
+  Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+
+  Bbr3CongestionControlGetNetworkStatistics(Connection, Cc,
+                                            &Event.NETWORK_STATISTICS);
+
+  QuicConnIndicateEvent(Connection, &Event);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlCanSend(_In_ QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.BytesInFlight < Cc->Bbr3.CongestionWindow ||
+         Cc->Bbr3.Exemptions > 0;
+}
+
+void Bbr3CongestionControlLogOutFlowStatus(
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  (void)Cc;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlUpdateBlockedState(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                            _In_ BOOLEAN PreviousCanSendState) {
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  QuicConnLogOutFlowStats(Connection);
+
+  if (PreviousCanSendState != Bbr3CongestionControlCanSend(Cc)) {
+    if (PreviousCanSendState) {
+      QuicConnAddOutFlowBlockedReason(Connection,
+                                      QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+    } else {
+      QuicConnRemoveOutFlowBlockedReason(Connection,
+                                         QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+      Connection->Send.LastFlushTime =
+          CxPlatTimeUs64(); // Reset last flush time
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetBytesInFlightMax(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    Bbr3CongestionControlGetBandwidthDelayProduct(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (!Bbr->Bw || Bbr->MinRtt >= UINT32_MAX) {
+    return 0;
+  }
+
+  return Bbr3CongestionControlGetBdp(Cc, Bbr->Bw, Bbr->CwndGain);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint8_t
+    Bbr3CongestionControlGetExemptions(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Bbr3.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint8_t NumPackets) {
+  Cc->Bbr3.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t NumRetransmittableBytes) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+  if (!Bbr->BytesInFlight && Bbr->AppLimited) {
+    Bbr->IdleRestart = TRUE;
+  }
+
+  Bbr->BytesInFlight += NumRetransmittableBytes;
+  if (Bbr->BytesInFlight + Bbr3CongestionControlGetMss(Cc) > Bbr->CongestionWindow) {
+    Bbr->CwndLimitedInRound = TRUE;
+  }
+  if (Bbr->BytesInFlightMax < Bbr->BytesInFlight) {
+    Bbr->BytesInFlightMax = Bbr->BytesInFlight;
+    QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+  }
+
+  if (Bbr->Exemptions > 0) {
+    --Bbr->Exemptions;
+  }
+
+  Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlOnDataInvalidated(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                           _In_ uint32_t
+                                               NumRetransmittableBytes) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+  CXPLAT_DBG_ASSERT(Bbr->BytesInFlight >= NumRetransmittableBytes);
+  Bbr->BytesInFlight -= NumRetransmittableBytes;
+
+  return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+//
+// Ends the current round once everything sent so far is acknowledged.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlStartRound(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  Cc->Bbr3.EndOfRoundTrip =
+      QuicCongestionControlGetConnection(Cc)->LossDetection.LargestSentPacketNumber;
+  Cc->Bbr3.EndOfRoundTripValid = TRUE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlSaveCwnd(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (!Bbr->InRecovery && Bbr->State != BBR3_STATE_PROBE_RTT) {
+    Bbr->PriorCongestionWindow = Bbr->CongestionWindow;
+  } else {
+    Bbr->PriorCongestionWindow =
+        CXPLAT_MAX(Bbr->PriorCongestionWindow, Bbr->CongestionWindow);
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlRestoreCwnd(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  Cc->Bbr3.CongestionWindow =
+      CXPLAT_MAX(Cc->Bbr3.CongestionWindow, Cc->Bbr3.PriorCongestionWindow);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlResetLowerBounds(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  Cc->Bbr3.BwLo = UINT64_MAX;
+  Cc->Bbr3.InflightLo = UINT32_MAX;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlResetCongestionSignals(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr->LossInRound = FALSE;
+  Bbr->EcnInRound = FALSE;
+  Bbr->CwndLimitedInRound = FALSE;
+  Bbr->LossBytesInRound = 0;
+  Bbr->LossEventsInRound = 0;
+  Bbr->CePacketsInRound = 0;
+  Bbr->DeliveredPacketsInRound = 0;
+  Bbr->BwLatest = 0;
+  Bbr->InflightLatest = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlEnterStartup(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  Cc->Bbr3.State = BBR3_STATE_STARTUP;
+  Cc->Bbr3.PacingGain = kBbr3StartupPacingGain;
+  Cc->Bbr3.CwndGain = kBbr3StartupCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlEnterDrain(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  Cc->Bbr3.State = BBR3_STATE_DRAIN;
+  Cc->Bbr3.PacingGain = kBbr3DrainPacingGain;
+  Cc->Bbr3.CwndGain = kBbr3StartupCwndGain;
+}
+
+//
+// Randomizes the time until the next bandwidth probe so that flows sharing a
+// bottleneck don't synchronize.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlPickProbeWait(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  uint32_t RandomValue = 0;
+  CxPlatRandom(sizeof(uint32_t), &RandomValue);
+
+  Bbr->RoundsSinceBwProbe = RandomValue & 1;
+  Bbr->BwProbeWait = kBbr3ProbeBwBaseWaitInMicroSecs +
+                     (RandomValue >> 1) % kBbr3ProbeBwRandWaitInMicroSecs;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlRaiseInflightHiSlope(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  //
+  // Double the InflightHi growth every round: after N rounds it grows by 2^N
+  // packets per round.
+  //
+  uint32_t GrowthThisRound = 1u << Bbr->BwProbeUpRounds;
+  Bbr->BwProbeUpRounds =
+      (uint8_t)CXPLAT_MIN(Bbr->BwProbeUpRounds + 1, kBbr3ProbeBwUpMaxRounds);
+  Bbr->BwProbeUpCount =
+      CXPLAT_MAX(Bbr->CongestionWindow / GrowthThisRound,
+                 (uint32_t)Bbr3CongestionControlGetMss(Cc));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlStartProbeBwDown(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr3CongestionControlResetCongestionSignals(Cc);
+  Bbr->BwProbeUpCount = UINT32_MAX;
+  Bbr3CongestionControlPickProbeWait(Cc);
+  Bbr->CycleStart = TimeNow;
+  Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_STOPPING;
+  Bbr3CongestionControlStartRound(Cc);
+  Bbr->State = BBR3_STATE_PROBE_BW_DOWN;
+  Bbr->PacingGain = kBbr3ProbeBwDownPacingGain;
+  Bbr->CwndGain = kBbr3DefaultCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlStartProbeBwCruise(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  Cc->Bbr3.State = BBR3_STATE_PROBE_BW_CRUISE;
+  Cc->Bbr3.PacingGain = GAIN_UNIT;
+  Cc->Bbr3.CwndGain = kBbr3DefaultCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlStartProbeBwRefill(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr3CongestionControlResetLowerBounds(Cc);
+  Bbr->BwProbeUpRounds = 0;
+  Bbr->BwProbeUpAcks = 0;
+  Bbr->AckPhase = BBR3_ACK_PHASE_REFILLING;
+  Bbr3CongestionControlStartRound(Cc);
+  Bbr->State = BBR3_STATE_PROBE_BW_REFILL;
+  Bbr->PacingGain = GAIN_UNIT;
+  Bbr->CwndGain = kBbr3DefaultCwndGain;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlStartProbeBwUp(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_STARTING;
+  Bbr3CongestionControlStartRound(Cc);
+  Bbr->CycleStart = TimeNow;
+  Bbr->State = BBR3_STATE_PROBE_BW_UP;
+  Bbr->PacingGain = kBbr3ProbeBwUpPacingGain;
+  Bbr->CwndGain = kBbr3ProbeBwUpCwndGain;
+  Bbr3CongestionControlRaiseInflightHiSlope(Cc);
+}
+
+//
+// Returns TRUE if the loss rate or the CE ratio in the current round shows
+// that TxInFlight bytes in flight is more than the path can hold.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlIsInflightTooHigh(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t TxInFlight) {
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (Bbr->LossBytesInRound > 0 && TxInFlight > 0 &&
+      (uint64_t)Bbr->LossBytesInRound * GAIN_UNIT >
+          (uint64_t)TxInFlight * kBbr3LossThresh) {
+    return TRUE;
+  }
+
+  if (Bbr->CePacketsInRound > 0 && Bbr->DeliveredPacketsInRound > 0 &&
+      (uint64_t)Bbr->CePacketsInRound * GAIN_UNIT >
+          (uint64_t)Bbr->DeliveredPacketsInRound * kBbr3EcnThresh) {
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlHandleInflightTooHigh(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t TxInFlight,
+    _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr->BwProbeSamples = FALSE;
+  if (!Bbr->AppLimited) {
+    uint32_t Target = (uint32_t)((uint64_t)Bbr3CongestionControlGetTargetInflight(Cc) *
+                                 kBbr3Beta / GAIN_UNIT);
+    Bbr->InflightHi = CXPLAT_MAX(TxInFlight, Target);
+  }
+  if (Bbr->State == BBR3_STATE_PROBE_BW_UP) {
+    Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+  }
+}
+
+//
+// Checks the congestion signals against the inflight the lost/marked data was
+// sent at, and lowers InflightHi if this was while probing for bandwidth.
+// Returns TRUE if inflight was too high.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlCheckInflightTooHigh(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                              _In_ uint32_t TxInFlight,
+                                              _In_ uint64_t TimeNow) {
+  if (Bbr3CongestionControlIsInflightTooHigh(Cc, TxInFlight)) {
+    if (Cc->Bbr3.BwProbeSamples) {
+      Bbr3CongestionControlHandleInflightTooHigh(Cc, TxInFlight, TimeNow);
+    }
+    return TRUE;
+  }
+  return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlAdvanceMaxBwFilter(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr->CycleCount++;
+  Bbr->MaxBwFilter[Bbr->CycleCount % kBbr3MaxBwFilterLen] = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlUpdateMaxBw(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t DeliveryRate,
+    _In_ BOOLEAN RateAppLimited) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (DeliveryRate >= Bbr->MaxBw || !RateAppLimited) {
+    uint64_t *Slot = &Bbr->MaxBwFilter[Bbr->CycleCount % kBbr3MaxBwFilterLen];
+    *Slot = CXPLAT_MAX(*Slot, DeliveryRate);
+  }
+
+  Bbr->MaxBw = 0;
+  for (uint32_t i = 0; i < kBbr3MaxBwFilterLen; ++i) {
+    Bbr->MaxBw = CXPLAT_MAX(Bbr->MaxBw, Bbr->MaxBwFilter[i]);
+  }
+}
+
+//
+// Computes the delivery rate sample (bytes * BW_UNIT per second) for the
+// newly acknowledged packets, the same way BBR (v1) does. Returns 0 if no
+// sample could be taken.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    Bbr3CongestionControlSampleDeliveryRate(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                            _In_ const QUIC_ACK_EVENT *AckEvent,
+                                            _Out_ BOOLEAN *RateAppLimited) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  uint64_t TimeNow = AckEvent->TimeNow;
+  uint64_t MaxDeliveryRate = 0;
+
+  *RateAppLimited = FALSE;
+
+  QUIC_SENT_PACKET_METADATA *AckedPacketsIterator = AckEvent->AckedPackets;
+  while (AckedPacketsIterator != NULL) {
+    QUIC_SENT_PACKET_METADATA *AckedPacket = AckedPacketsIterator;
+    AckedPacketsIterator = AckedPacketsIterator->Next;
+
+    if (AckedPacket->PacketLength == 0) {
+      continue;
+    }
+
+    Bbr->DeliveredPacketsInRound++;
+
+    uint64_t SendRate = UINT64_MAX;
+    uint64_t AckRate = UINT64_MAX;
+
+    if (AckedPacket->Flags.HasLastAckedPacketInfo) {
+      uint64_t AckElapsed = 0;
+      uint64_t SendElapsed = CxPlatTimeDiff64(
+          AckedPacket->LastAckedPacketInfo.SentTime, AckedPacket->SentTime);
+
+      if (SendElapsed) {
+        SendRate = (kBbr3MicroSecsInSec * BW_UNIT *
+                    (AckedPacket->TotalBytesSent -
+                     QuicSentPacketLastAckedTotalBytesSent(AckedPacket)) /
+                    SendElapsed);
+      }
+
+      if (!CxPlatTimeAtOrBefore64(
+              AckEvent->AdjustedAckTime,
+              AckedPacket->LastAckedPacketInfo.AdjustedAckTime)) {
+        AckElapsed =
+            CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AdjustedAckTime,
+                             AckEvent->AdjustedAckTime);
+      } else {
+        AckElapsed =
+            CxPlatTimeDiff64(AckedPacket->LastAckedPacketInfo.AckTime, TimeNow);
+      }
+
+      if (AckElapsed) {
+        AckRate = (kBbr3MicroSecsInSec * BW_UNIT *
+                   (AckEvent->NumTotalAckedRetransmittableBytes -
+                    QuicSentPacketLastAckedTotalBytesAcked(AckedPacket)) /
+                   AckElapsed);
+      }
+    } else if (!CxPlatTimeAtOrBefore64(TimeNow, AckedPacket->SentTime)) {
+      SendRate = (kBbr3MicroSecsInSec * BW_UNIT *
+                  AckEvent->NumTotalAckedRetransmittableBytes /
+                  CxPlatTimeDiff64(AckedPacket->SentTime, TimeNow));
+    }
+
+    if (SendRate == UINT64_MAX && AckRate == UINT64_MAX) {
+      continue;
+    }
+
+    uint64_t DeliveryRate = CXPLAT_MIN(SendRate, AckRate);
+    if (DeliveryRate > MaxDeliveryRate) {
+      MaxDeliveryRate = DeliveryRate;
+      *RateAppLimited = AckedPacket->Flags.IsAppLimited;
+    }
+  }
+
+  return MaxDeliveryRate;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    Bbr3CongestionControlUpdateAckAggregation(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (!Bbr->AckAggregationStartTimeValid || !Bbr->Bw) {
+    Bbr->AckAggregationStartTime = AckEvent->TimeNow;
+    Bbr->AckAggregationStartTimeValid = TRUE;
+    return 0;
+  }
+
+  uint64_t ExpectedAckBytes =
+      Bbr->Bw *
+      CxPlatTimeDiff64(Bbr->AckAggregationStartTime, AckEvent->TimeNow) /
+      kBbr3MicroSecsInSec / BW_UNIT;
+
+  //
+  // Reset current ack aggregation status when we witness ack arrival rate being
+  // less or equal than estimated bandwidth
+  //
+  if (Bbr->AggregatedAckBytes <= ExpectedAckBytes) {
+    Bbr->AggregatedAckBytes = AckEvent->NumRetransmittableBytes;
+    Bbr->AckAggregationStartTime = AckEvent->TimeNow;
+    return 0;
+  }
+
+  Bbr->AggregatedAckBytes += AckEvent->NumRetransmittableBytes;
+
+  QuicSlidingWindowExtremumUpdateMax(&Bbr->MaxAckHeightFilter,
+                                     Bbr->AggregatedAckBytes - ExpectedAckBytes,
+                                     Bbr->RoundTripCounter);
+
+  return Bbr->AggregatedAckBytes - ExpectedAckBytes;
+}
+
+//
+// Called at the end of every round with the congestion signals of the round
+// that just ended.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlOnRoundEnd(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ BOOLEAN RateAppLimited) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  BOOLEAN EcnTooHigh =
+      Bbr->DeliveredPacketsInRound > 0 &&
+      (uint64_t)Bbr->CePacketsInRound * GAIN_UNIT >
+          (uint64_t)Bbr->DeliveredPacketsInRound * kBbr3EcnThresh;
+
+  if (Bbr->EcnInRound || Bbr->EcnAlpha > 0) {
+    uint32_t CeRatio =
+        Bbr->DeliveredPacketsInRound == 0
+            ? 0
+            : (uint32_t)CXPLAT_MIN((uint64_t)Bbr->CePacketsInRound * GAIN_UNIT /
+                                       Bbr->DeliveredPacketsInRound,
+                                   GAIN_UNIT);
+    Bbr->EcnAlpha = Bbr->EcnAlpha - (Bbr->EcnAlpha >> kBbr3EcnAlphaGainShift) +
+                    (CeRatio >> kBbr3EcnAlphaGainShift);
+  }
+
+  if (!Bbr->FilledPipe) {
+    //
+    // Exit STARTUP when the bandwidth stops growing...
+    //
+    if (!RateAppLimited) {
+      if (Bbr->MaxBw >= Bbr->FullBw * kBbr3StartupGrowthTarget / GAIN_UNIT) {
+        Bbr->FullBw = Bbr->MaxBw;
+        Bbr->FullBwCount = 0;
+      } else if (++Bbr->FullBwCount >= kBbr3StartupFullBwRounds) {
+        Bbr->FilledPipe = TRUE;
+      }
+    }
+
+    //
+    // ...or on persistent loss or ECN marking, in which case the inflight the
+    // path managed to deliver becomes the upper bound.
+    //
+    BOOLEAN TooHigh = FALSE;
+    if (Bbr->LossEventsInRound >= kBbr3StartupFullLossCount &&
+        Bbr3CongestionControlIsInflightTooHigh(
+            Cc, Bbr->InflightLatest + Bbr->LossBytesInRound)) {
+      TooHigh = TRUE;
+    }
+    if (EcnTooHigh) {
+      if (++Bbr->StartupEcnRounds >= kBbr3StartupEcnRounds) {
+        TooHigh = TRUE;
+      }
+    } else {
+      Bbr->StartupEcnRounds = 0;
+    }
+    if (TooHigh) {
+      Bbr->FilledPipe = TRUE;
+      Bbr->InflightHi = (uint32_t)CXPLAT_MAX(
+          Bbr3CongestionControlGetBdp(Cc, Bbr->MaxBw, GAIN_UNIT),
+          Bbr->InflightLatest);
+    }
+  }
+
+  //
+  // Lower the short term bounds in response to loss or ECN, unless this round
+  // was deliberately probing for more bandwidth.
+  //
+  if ((Bbr->LossInRound || Bbr->EcnInRound) &&
+      !Bbr3CongestionControlIsProbingBw(Cc)) {
+    if (Bbr->BwLo == UINT64_MAX) {
+      Bbr->BwLo = Bbr->MaxBw;
+    }
+    if (Bbr->InflightLo == UINT32_MAX) {
+      Bbr->InflightLo = Bbr->CongestionWindow;
+    }
+
+    uint32_t Cut = GAIN_UNIT;
+    if (Bbr->LossInRound) {
+      Cut = kBbr3Beta;
+    }
+    if (Bbr->EcnInRound) {
+      uint32_t EcnCut = GAIN_UNIT - Bbr->EcnAlpha * kBbr3EcnFactor / GAIN_UNIT;
+      Cut = CXPLAT_MIN(Cut, CXPLAT_MAX(EcnCut, kBbr3Beta));
+    }
+
+    Bbr->BwLo = CXPLAT_MAX(Bbr->BwLatest, Bbr->BwLo * Cut / GAIN_UNIT);
+    Bbr->InflightLo =
+        CXPLAT_MAX(Bbr->InflightLatest,
+                   (uint32_t)((uint64_t)Bbr->InflightLo * Cut / GAIN_UNIT));
+  }
+
+  if (Bbr3CongestionControlIsInProbeBwState(Cc)) {
+    Bbr->RoundsSinceBwProbe++;
+  }
+
+  Bbr->PacketConservation = FALSE;
+  Bbr3CongestionControlResetCongestionSignals(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlHasElapsedInPhase(_In_ const QUIC_CONGESTION_CONTROL *Cc,
+                                           _In_ uint64_t Interval,
+                                           _In_ uint64_t TimeNow) {
+  return CxPlatTimeAtOrBefore64(Cc->Bbr3.CycleStart + Interval, TimeNow);
+}
+
+//
+// Returns TRUE (and starts probing) if it's time to probe for bandwidth:
+// either the randomized wait has elapsed, or a Reno flow would have grown its
+// window by now.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlCheckTimeToProbeBw(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                            _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  uint64_t RenoRounds = Bbr3CongestionControlGetTargetInflight(Cc) /
+                        Bbr3CongestionControlGetMss(Cc);
+  RenoRounds = CXPLAT_MIN(RenoRounds, kBbr3ProbeBwMaxRounds);
+
+  if (Bbr3CongestionControlHasElapsedInPhase(Cc, Bbr->BwProbeWait, TimeNow) ||
+      Bbr->RoundsSinceBwProbe >= RenoRounds) {
+    Bbr3CongestionControlStartProbeBwRefill(Cc);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlProbeInflightHiUpward(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t PrevInflightBytes,
+    _In_ uint32_t AckedBytes) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  const uint16_t Mss = Bbr3CongestionControlGetMss(Cc);
+
+  BOOLEAN IsCwndLimited = Bbr->CwndLimitedInRound ||
+                          PrevInflightBytes + Mss >= Bbr->CongestionWindow;
+  if (!IsCwndLimited || Bbr->CongestionWindow < Bbr->InflightHi) {
+    return; // Not fully using InflightHi, so don't grow it.
+  }
+
+  Bbr->BwProbeUpAcks += AckedBytes;
+  if (Bbr->BwProbeUpAcks >= Bbr->BwProbeUpCount) {
+    uint32_t Delta = Bbr->BwProbeUpAcks / Bbr->BwProbeUpCount;
+    Bbr->BwProbeUpAcks -= Delta * Bbr->BwProbeUpCount;
+    Bbr->InflightHi = (uint32_t)CXPLAT_MIN(
+        (uint64_t)Bbr->InflightHi + (uint64_t)Delta * Mss, UINT32_MAX - 1);
+  }
+
+  if (Bbr->RoundStart) {
+    Bbr3CongestionControlRaiseInflightHiSlope(Cc);
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlAdaptUpperBounds(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t PrevInflightBytes,
+    _In_ uint32_t AckedBytes, _In_ BOOLEAN RateAppLimited,
+    _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (Bbr->AckPhase == BBR3_ACK_PHASE_PROBE_STARTING && Bbr->RoundStart) {
+    //
+    // Starting to get feedback for data sent while probing.
+    //
+    Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_FEEDBACK;
+  }
+
+  if (Bbr->AckPhase == BBR3_ACK_PHASE_PROBE_STOPPING && Bbr->RoundStart) {
+    //
+    // End of the samples from the last probe. The latest samples are the best
+    // recent view of the available bandwidth, so forget the previous cycle.
+    //
+    Bbr->BwProbeSamples = FALSE;
+    Bbr->AckPhase = BBR3_ACK_PHASE_INIT;
+    if (Bbr3CongestionControlIsInProbeBwState(Cc) && !RateAppLimited) {
+      Bbr3CongestionControlAdvanceMaxBwFilter(Cc);
+    }
+  }
+
+  if (Bbr3CongestionControlCheckInflightTooHigh(Cc, PrevInflightBytes, TimeNow)) {
+    return;
+  }
+
+  if (Bbr->InflightHi == UINT32_MAX) {
+    return; // No upper bound to raise.
+  }
+
+  if (PrevInflightBytes > Bbr->InflightHi) {
+    Bbr->InflightHi = PrevInflightBytes;
+  }
+
+  if (Bbr->State == BBR3_STATE_PROBE_BW_UP) {
+    Bbr3CongestionControlProbeInflightHiUpward(Cc, PrevInflightBytes, AckedBytes);
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlUpdateProbeBwCyclePhase(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t PrevInflightBytes,
+    _In_ uint32_t AckedBytes, _In_ BOOLEAN RateAppLimited,
+    _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  if (!Bbr->FilledPipe) {
+    return;
+  }
+
+  Bbr3CongestionControlAdaptUpperBounds(Cc, PrevInflightBytes, AckedBytes,
+                                        RateAppLimited, TimeNow);
+
+  switch (Bbr->State) {
+  case BBR3_STATE_PROBE_BW_DOWN:
+    if (Bbr3CongestionControlCheckTimeToProbeBw(Cc, TimeNow)) {
+      break;
+    }
+    //
+    // Cruise once the queue built while probing has drained.
+    //
+    if (Bbr->BytesInFlight <= Bbr3CongestionControlGetInflightWithHeadroom(Cc) &&
+        Bbr->BytesInFlight <=
+            Bbr3CongestionControlGetInflight(Cc, Bbr->MaxBw, GAIN_UNIT)) {
+      Bbr3CongestionControlStartProbeBwCruise(Cc);
+    }
+    break;
+
+  case BBR3_STATE_PROBE_BW_CRUISE:
+    (void)Bbr3CongestionControlCheckTimeToProbeBw(Cc, TimeNow);
+    break;
+
+  case BBR3_STATE_PROBE_BW_REFILL:
+    //
+    // After one round of refilling the pipe, start probing.
+    //
+    if (Bbr->RoundStart) {
+      Bbr->BwProbeSamples = TRUE;
+      Bbr3CongestionControlStartProbeBwUp(Cc, TimeNow);
+    }
+    break;
+
+  case BBR3_STATE_PROBE_BW_UP:
+    if (Bbr->MinRtt != UINT64_MAX &&
+        Bbr3CongestionControlHasElapsedInPhase(Cc, Bbr->MinRtt, TimeNow) &&
+        Bbr->BytesInFlight >
+            Bbr3CongestionControlGetInflight(Cc, Bbr->MaxBw, Bbr->PacingGain)) {
+      Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlUpdateMinRtt(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  uint64_t TimeNow = AckEvent->TimeNow;
+
+  Bbr->ProbeRttExpired =
+      CxPlatTimeAtOrBefore64(
+          Bbr->ProbeRttMinTimestamp + kBbr3ProbeRttIntervalInMicroSecs, TimeNow);
+
+  if (AckEvent->MinRttValid &&
+      (AckEvent->MinRtt < Bbr->ProbeRttMinDelay || Bbr->ProbeRttExpired)) {
+    Bbr->ProbeRttMinDelay = AckEvent->MinRtt;
+    Bbr->ProbeRttMinTimestamp = TimeNow;
+  }
+
+  BOOLEAN MinRttExpired =
+      Bbr->MinRttTimestampValid &&
+      CxPlatTimeAtOrBefore64(
+          Bbr->MinRttTimestamp + kBbr3MinRttFilterLenInMicroSecs, TimeNow);
+
+  if (Bbr->ProbeRttMinDelay < Bbr->MinRtt || MinRttExpired) {
+    Bbr->MinRtt = Bbr->ProbeRttMinDelay;
+    Bbr->MinRttTimestamp = Bbr->ProbeRttMinTimestamp;
+    Bbr->MinRttTimestampValid = TRUE;
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlExitProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t TimeNow) {
+  Bbr3CongestionControlResetLowerBounds(Cc);
+  if (Cc->Bbr3.FilledPipe) {
+    Bbr3CongestionControlStartProbeBwDown(Cc, TimeNow);
+    Bbr3CongestionControlStartProbeBwCruise(Cc);
+  } else {
+    Bbr3CongestionControlEnterStartup(Cc);
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlCheckProbeRtt(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t TimeNow) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+
+  if (Bbr->State != BBR3_STATE_PROBE_RTT && Bbr->ProbeRttExpired &&
+      !Bbr->IdleRestart) {
+    Bbr3CongestionControlSaveCwnd(Cc);
+    Bbr->State = BBR3_STATE_PROBE_RTT;
+    Bbr->PacingGain = GAIN_UNIT;
+    Bbr->CwndGain = kBbr3ProbeRttCwndGain;
+    Bbr->ProbeRttDoneTimestampValid = FALSE;
+    Bbr->AckPhase = BBR3_ACK_PHASE_PROBE_STOPPING;
+    Bbr3CongestionControlStartRound(Cc);
+  }
+
+  if (Bbr->State == BBR3_STATE_PROBE_RTT) {
+    //
+    // Samples taken while draining the pipe aren't representative.
+    //
+    Bbr->AppLimited = TRUE;
+    Bbr->AppLimitedExitTarget = Connection->LossDetection.LargestSentPacketNumber;
+
+    if (!Bbr->ProbeRttDoneTimestampValid &&
+        Bbr->BytesInFlight <= Bbr3CongestionControlGetProbeRttCwnd(Cc)) {
+      //
+      // Hold the low inflight for at least the ProbeRTT duration and one
+      // round.
+      //
+      Bbr->ProbeRttDoneTimestamp = TimeNow + kBbr3ProbeRttDurationInMicroSecs;
+      Bbr->ProbeRttDoneTimestampValid = TRUE;
+      Bbr->ProbeRttRoundDone = FALSE;
+      Bbr3CongestionControlStartRound(Cc);
+    } else if (Bbr->ProbeRttDoneTimestampValid) {
+      if (Bbr->RoundStart) {
+        Bbr->ProbeRttRoundDone = TRUE;
+      }
+      if (Bbr->ProbeRttRoundDone &&
+          CxPlatTimeAtOrBefore64(Bbr->ProbeRttDoneTimestamp, TimeNow)) {
+        Bbr->ProbeRttMinTimestamp = TimeNow;
+        Bbr3CongestionControlRestoreCwnd(Cc);
+        Bbr3CongestionControlExitProbeRtt(Cc, TimeNow);
+      }
+    }
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlSetSendQuantum(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  const uint16_t DatagramPayloadLength = Bbr3CongestionControlGetMss(Cc);
+
+  uint64_t PacingRate = Bbr->Bw * Bbr->PacingGain / GAIN_UNIT;
+
+  if (PacingRate < kBbr3LowPacingRateThresholdBytesPerSecond * BW_UNIT) {
+    Bbr->SendQuantum = (uint64_t)DatagramPayloadLength;
+  } else if (PacingRate < kBbr3HighPacingRateThresholdBytesPerSecond * BW_UNIT) {
+    Bbr->SendQuantum = (uint64_t)DatagramPayloadLength * 2;
+  } else {
+    Bbr->SendQuantum = CXPLAT_MIN(PacingRate * kBbr3MilliSecsInSec / BW_UNIT,
+                                  64 * 1024 /* 64k */);
+  }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlUpdateCongestionWindow(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint64_t TotalBytesAcked,
+    _In_ uint32_t AckedBytes) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  const uint32_t MinPipeCwnd = Bbr3CongestionControlGetMinPipeCwnd(Cc);
+
+  Bbr3CongestionControlSetSendQuantum(Cc);
+
+  uint64_t MaxInflight =
+      Bbr3CongestionControlGetInflight(Cc, Bbr->Bw, Bbr->CwndGain);
+  QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY Entry =
+      (QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY){.Value = 0, .Time = 0};
+  if (QUIC_SUCCEEDED(
+          QuicSlidingWindowExtremumGet(&Bbr->MaxAckHeightFilter, &Entry))) {
+    MaxInflight += Entry.Value;
+  }
+
+  uint64_t CongestionWindow = Bbr->CongestionWindow;
+  if (Bbr->PacketConservation) {
+    CongestionWindow =
+        CXPLAT_MAX(CongestionWindow, (uint64_t)Bbr->BytesInFlight + AckedBytes);
+  } else if (Bbr->FilledPipe) {
+    CongestionWindow = CXPLAT_MIN(CongestionWindow + AckedBytes, MaxInflight);
+  } else if (CongestionWindow < MaxInflight ||
+             TotalBytesAcked < Bbr->InitialCongestionWindow) {
+    CongestionWindow += AckedBytes;
+  }
+  CongestionWindow = CXPLAT_MAX(CongestionWindow, MinPipeCwnd);
+
+  //
+  // Bound the window by what the model learnt from loss and ECN.
+  //
+  uint64_t Cap = UINT32_MAX;
+  if (Bbr->State == BBR3_STATE_PROBE_RTT) {
+    Cap = Bbr3CongestionControlGetProbeRttCwnd(Cc);
+  } else if (Bbr->State == BBR3_STATE_PROBE_BW_CRUISE) {
+    Cap = Bbr3CongestionControlGetInflightWithHeadroom(Cc);
+  } else if (Bbr3CongestionControlIsInProbeBwState(Cc)) {
+    Cap = Bbr->InflightHi;
+  }
+  Cap = CXPLAT_MIN(Cap, Bbr->InflightLo);
+  Cap = CXPLAT_MAX(Cap, MinPipeCwnd);
+
+  Bbr->CongestionWindow = (uint32_t)CXPLAT_MIN(CongestionWindow, Cap);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    Bbr3CongestionControlGetSendAllowance(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                          _In_ uint64_t
+                                              TimeSinceLastSend, // microsec
+                                          _In_ BOOLEAN TimeSinceLastSendValid) {
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  uint64_t BandwidthEst = Bbr->Bw;
+  uint32_t CongestionWindow = Bbr->CongestionWindow;
+
+  uint32_t SendAllowance = 0;
+
+  if (Bbr->BytesInFlight >= CongestionWindow) {
+    //
+    // We are CC blocked, so we can't send anything.
+    //
+    SendAllowance = 0;
+
+  } else if (!TimeSinceLastSendValid || !Connection->Settings.PacingEnabled ||
+             Bbr->MinRtt == UINT64_MAX ||
+             Bbr->MinRtt < QUIC_SEND_PACING_INTERVAL) {
+    //
+    // We're not in the necessary state to pace.
+    //
+    SendAllowance = CongestionWindow - Bbr->BytesInFlight;
+
+  } else {
+    //
+    // We are pacing, so send as much as the pacing rate allows since the last
+    // send. The rate is BandwidthEst * PacingGain, less a small margin.
+    //
+    uint64_t PacingRate = BandwidthEst * Bbr->PacingGain / GAIN_UNIT *
+                          (100 - kBbr3PacingMarginPercent) / 100;
+    if (Bbr->State == BBR3_STATE_STARTUP) {
+      SendAllowance = (uint32_t)CXPLAT_MAX(
+          PacingRate * TimeSinceLastSend / kBbr3MicroSecsInSec / BW_UNIT,
+          (uint64_t)CongestionWindow * Bbr->PacingGain / GAIN_UNIT -
+              Bbr->BytesInFlight);
+    } else {
+      SendAllowance = (uint32_t)CXPLAT_MIN(
+          PacingRate * TimeSinceLastSend / kBbr3MicroSecsInSec / BW_UNIT,
+          UINT32_MAX);
+    }
+
+    if (SendAllowance > CongestionWindow - Bbr->BytesInFlight) {
+      SendAllowance = CongestionWindow - Bbr->BytesInFlight;
+    }
+
+    if (SendAllowance > (CongestionWindow >> 2)) {
+      SendAllowance =
+          CongestionWindow >>
+          2; // Don't send more than a quarter of the current window.
+    }
+  }
+  return SendAllowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    Bbr3CongestionControlGetPacingRate(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  const QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  if (!Connection->Settings.PacingEnabled || Bbr->MinRtt == UINT64_MAX ||
+      Bbr->MinRtt < QUIC_SEND_PACING_INTERVAL) {
+    return 0;
+  }
+  return Bbr->Bw * Bbr->PacingGain / GAIN_UNIT / BW_UNIT *
+         (100 - kBbr3PacingMarginPercent) / 100;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlOnDataAcknowledged(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+
+  if (AckEvent->IsImplicit) {
+    Bbr3CongestionControlUpdateCongestionWindow(
+        Cc, AckEvent->NumTotalAckedRetransmittableBytes,
+        AckEvent->NumRetransmittableBytes);
+
+    if (Connection->Settings.NetStatsEventEnabled) {
+      Bbr3CongestionControlIndicateConnectionEvent(Connection, Cc);
+    }
+    return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+  }
+
+  uint32_t PrevInflightBytes = Bbr->BytesInFlight;
+
+  CXPLAT_DBG_ASSERT(Bbr->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+  Bbr->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+
+  if (Bbr->AppLimited && Bbr->AppLimitedExitTarget < AckEvent->LargestAck) {
+    Bbr->AppLimited = FALSE;
+  }
+
+  if (Bbr->InRecovery && !AckEvent->HasLoss &&
+      Bbr->EndOfRecovery < AckEvent->LargestAck) {
+    Bbr->InRecovery = FALSE;
+    Bbr->PacketConservation = FALSE;
+    Bbr3CongestionControlRestoreCwnd(Cc);
+  }
+
+  BOOLEAN RateAppLimited = FALSE;
+  uint64_t DeliveryRate =
+      Bbr3CongestionControlSampleDeliveryRate(Cc, AckEvent, &RateAppLimited);
+
+  Bbr->RoundStart = FALSE;
+  if (!Bbr->EndOfRoundTripValid || Bbr->EndOfRoundTrip < AckEvent->LargestAck) {
+    Bbr->RoundTripCounter++;
+    Bbr->EndOfRoundTripValid = TRUE;
+    Bbr->EndOfRoundTrip = AckEvent->LargestSentPacketNumber;
+    Bbr->RoundStart = TRUE;
+  }
+
+  Bbr->BwLatest = CXPLAT_MAX(Bbr->BwLatest, DeliveryRate);
+  Bbr->InflightLatest += AckEvent->NumRetransmittableBytes;
+  Bbr3CongestionControlUpdateMaxBw(Cc, DeliveryRate, RateAppLimited);
+
+  Bbr3CongestionControlUpdateAckAggregation(Cc, AckEvent);
+
+  if (Bbr->RoundStart) {
+    Bbr3CongestionControlOnRoundEnd(Cc, RateAppLimited);
+  }
+
+  if (Bbr->State == BBR3_STATE_STARTUP && Bbr->FilledPipe) {
+    Bbr3CongestionControlEnterDrain(Cc);
+  }
+
+  if (Bbr->State == BBR3_STATE_DRAIN &&
+      Bbr->BytesInFlight <=
+          Bbr3CongestionControlGetInflight(Cc, Bbr->MaxBw, GAIN_UNIT)) {
+    Bbr3CongestionControlStartProbeBwDown(Cc, AckEvent->TimeNow);
+  }
+
+  Bbr3CongestionControlUpdateProbeBwCyclePhase(
+      Cc, PrevInflightBytes, AckEvent->NumRetransmittableBytes, RateAppLimited,
+      AckEvent->TimeNow);
+
+  Bbr3CongestionControlUpdateMinRtt(Cc, AckEvent);
+  Bbr3CongestionControlCheckProbeRtt(Cc, AckEvent->TimeNow);
+  Bbr->IdleRestart = FALSE;
+
+  Bbr->Bw = CXPLAT_MIN(Bbr->MaxBw, Bbr->BwLo);
+
+  Bbr3CongestionControlUpdateCongestionWindow(
+      Cc, AckEvent->NumTotalAckedRetransmittableBytes,
+      AckEvent->NumRetransmittableBytes);
+
+  if (Connection->Settings.NetStatsEventEnabled) {
+    Bbr3CongestionControlIndicateConnectionEvent(Connection, Cc);
+  }
+
+  return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_LOSS_EVENT *LossEvent) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  const uint32_t MinPipeCwnd = Bbr3CongestionControlGetMinPipeCwnd(Cc);
+
+  Connection->Stats.Send.CongestionCount++;
+
+  BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+  CXPLAT_DBG_ASSERT(LossEvent->NumRetransmittableBytes > 0);
+
+  uint32_t TxInFlight = Bbr->BytesInFlight;
+
+  CXPLAT_DBG_ASSERT(Bbr->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+  Bbr->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+  Bbr->LossInRound = TRUE;
+  Bbr->LossBytesInRound += LossEvent->NumRetransmittableBytes;
+  Bbr->LossEventsInRound++;
+
+  //
+  // React to excessive loss while probing right away instead of waiting for
+  // the end of the round.
+  //
+  (void)Bbr3CongestionControlCheckInflightTooHigh(Cc, TxInFlight,
+                                                  CxPlatTimeUs64());
+
+  if (!Bbr->InRecovery) {
+    Bbr3CongestionControlSaveCwnd(Cc);
+    Bbr->InRecovery = TRUE;
+    Bbr->PacketConservation = TRUE;
+    Bbr->CongestionWindow = CXPLAT_MAX(
+        Bbr->BytesInFlight + Bbr3CongestionControlGetMss(Cc), MinPipeCwnd);
+    Bbr->EndOfRoundTripValid = TRUE;
+    Bbr->EndOfRoundTrip = LossEvent->LargestSentPacketNumber;
+  }
+  Bbr->EndOfRecovery = LossEvent->LargestSentPacketNumber;
+
+  if (LossEvent->PersistentCongestion) {
+    Bbr->PriorCongestionWindow = MinPipeCwnd;
+    Bbr->CongestionWindow = MinPipeCwnd;
+    Connection->Stats.Send.PersistentCongestionCount++;
+  }
+
+  Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ECN_EVENT *EcnEvent) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+  if (!Bbr->EcnInRound) {
+    QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
+  }
+
+  //
+  // Unlike loss, CE marks don't put the connection in recovery; they only
+  // feed the per-round CE ratio that drives the bounds.
+  //
+  Bbr->EcnInRound = TRUE;
+  Bbr->CePacketsInRound += EcnEvent->NewCePackets;
+
+  (void)Bbr3CongestionControlCheckInflightTooHigh(Cc, Bbr->BytesInFlight,
+                                                  CxPlatTimeUs64());
+
+  Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    Bbr3CongestionControlOnSpuriousCongestionEvent(
+        _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  BOOLEAN PreviousCanSendState = Bbr3CongestionControlCanSend(Cc);
+
+  //
+  // Every loss was really reordering: drop the loss signals of this round and
+  // the short term bounds they may have cut, and end packet conservation with
+  // the window from before it (as Linux BBR's undo does).
+  //
+  Bbr->LossInRound = FALSE;
+  Bbr->LossBytesInRound = 0;
+  Bbr->LossEventsInRound = 0;
+  Bbr3CongestionControlResetLowerBounds(Cc);
+
+  if (Bbr->InRecovery) {
+    Bbr->InRecovery = FALSE;
+    Bbr->PacketConservation = FALSE;
+    Bbr3CongestionControlRestoreCwnd(Cc);
+  }
+
+  return Bbr3CongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+
+  if (Bbr->BytesInFlight > Bbr->CongestionWindow) {
+    return;
+  }
+
+  Bbr->AppLimited = TRUE;
+  Bbr->AppLimitedExitTarget = Connection->LossDetection.LargestSentPacketNumber;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ BOOLEAN FullReset) {
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  const uint16_t DatagramPayloadLength = Bbr3CongestionControlGetMss(Cc);
+
+  Bbr->InitialCongestionWindow =
+      Bbr->InitialCongestionWindowPackets * DatagramPayloadLength;
+  Bbr->CongestionWindow = Bbr->InitialCongestionWindow;
+  Bbr->PriorCongestionWindow = Bbr->InitialCongestionWindow;
+  Bbr->BytesInFlightMax = Bbr->CongestionWindow / 2;
+
+  if (FullReset) {
+    Bbr->BytesInFlight = 0;
+  }
+  Bbr->Exemptions = 0;
+
+  Bbr->FilledPipe = FALSE;
+  Bbr->IdleRestart = FALSE;
+  Bbr->RoundStart = FALSE;
+  Bbr->InRecovery = FALSE;
+  Bbr->PacketConservation = FALSE;
+  Bbr->BwProbeSamples = FALSE;
+  Bbr->AppLimited = FALSE;
+  Bbr->AppLimitedExitTarget = 0;
+
+  Bbr->RoundTripCounter = 0;
+  Bbr->EndOfRoundTripValid = FALSE;
+  Bbr->EndOfRoundTrip = 0;
+  Bbr->EndOfRecovery = 0;
+
+  for (uint32_t i = 0; i < kBbr3MaxBwFilterLen; ++i) {
+    Bbr->MaxBwFilter[i] = 0;
+  }
+  Bbr->CycleCount = 0;
+  Bbr->MaxBw = 0;
+  Bbr->Bw = 0;
+  Bbr->InflightHi = UINT32_MAX;
+  Bbr3CongestionControlResetLowerBounds(Cc);
+  Bbr3CongestionControlResetCongestionSignals(Cc);
+
+  Bbr->FullBw = 0;
+  Bbr->FullBwCount = 0;
+  Bbr->StartupEcnRounds = 0;
+  Bbr->EcnAlpha = GAIN_UNIT;
+
+  Bbr->AckPhase = BBR3_ACK_PHASE_INIT;
+  Bbr->CycleStart = 0;
+  Bbr->BwProbeWait = 0;
+  Bbr->RoundsSinceBwProbe = 0;
+  Bbr->BwProbeUpRounds = 0;
+  Bbr->BwProbeUpCount = UINT32_MAX;
+  Bbr->BwProbeUpAcks = 0;
+  Bbr->SendQuantum = 0;
+
+  Bbr->AckAggregationStartTimeValid = FALSE;
+  Bbr->AckAggregationStartTime = 0;
+  Bbr->AggregatedAckBytes = 0;
+  QuicSlidingWindowExtremumReset(&Bbr->MaxAckHeightFilter);
+
+  uint64_t TimeNow = CxPlatTimeUs64();
+  Bbr->MinRtt = UINT64_MAX;
+  Bbr->MinRttTimestamp = 0;
+  Bbr->MinRttTimestampValid = FALSE;
+  Bbr->ProbeRttMinDelay = UINT64_MAX;
+  Bbr->ProbeRttMinTimestamp = TimeNow;
+  Bbr->ProbeRttExpired = FALSE;
+  Bbr->ProbeRttDoneTimestampValid = FALSE;
+  Bbr->ProbeRttDoneTimestamp = 0;
+  Bbr->ProbeRttRoundDone = FALSE;
+
+  Bbr3CongestionControlEnterStartup(Cc);
+
+  Bbr3CongestionControlLogOutFlowStatus(Cc);
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlBbr3 = {
+    .Name = "BBRv3",
+    .QuicCongestionControlCanSend = Bbr3CongestionControlCanSend,
+    .QuicCongestionControlSetExemption = Bbr3CongestionControlSetExemption,
+    .QuicCongestionControlReset = Bbr3CongestionControlReset,
+    .QuicCongestionControlGetSendAllowance =
+        Bbr3CongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = Bbr3CongestionControlGetPacingRate,
+    .QuicCongestionControlGetCongestionWindow =
+        Bbr3CongestionControlGetCongestionWindow,
+    .QuicCongestionControlOnDataSent = Bbr3CongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated =
+        Bbr3CongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged =
+        Bbr3CongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = Bbr3CongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = Bbr3CongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent =
+        Bbr3CongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlLogOutFlowStatus =
+        Bbr3CongestionControlLogOutFlowStatus,
+    .QuicCongestionControlGetExemptions = Bbr3CongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax =
+        Bbr3CongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlGetBandwidthDelayProduct =
+        Bbr3CongestionControlGetBandwidthDelayProduct,
+    .QuicCongestionControlIsAppLimited = Bbr3CongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = Bbr3CongestionControlSetAppLimited,
+    .QuicCongestionControlGetNetworkStatistics =
+        Bbr3CongestionControlGetNetworkStatistics};
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void Bbr3CongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL *Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL *Settings) {
+  *Cc = QuicCongestionControlBbr3;
+
+  QUIC_CONGESTION_CONTROL_BBR3 *Bbr = &Cc->Bbr3;
+
+  Bbr->InitialCongestionWindowPackets = Settings->InitialWindowPackets;
+
+  Bbr->MaxAckHeightFilter = QuicSlidingWindowExtremumInitialize(
+      kBbr3MaxAckHeightFilterLen, kBbr3DefaultFilterCapacity,
+      Bbr->MaxAckHeightFilterEntries);
+
+  Bbr3CongestionControlReset(Cc, TRUE);
+
+  QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+}
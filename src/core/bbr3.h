@@ -0,0 +1,306 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#include "sliding_window_extremum.h"
+
+#define kBbr3DefaultFilterCapacity 3
+
+//
+// Number of ProbeBW cycles the max bandwidth filter covers.
+//
+#define kBbr3MaxBwFilterLen 2
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_CONGESTION_CONTROL_BBR3 {
+
+    //
+    // TRUE once STARTUP has filled the pipe (the bottleneck bandwidth has been
+    // found, either because it stopped growing or because of loss/ECN).
+    //
+    BOOLEAN FilledPipe : 1;
+
+    //
+    // TRUE when restarting from an idle (app limited, nothing in flight)
+    // period.
+    //
+    BOOLEAN IdleRestart : 1;
+
+    //
+    // TRUE if the current ACK started a new round trip.
+    //
+    BOOLEAN RoundStart : 1;
+
+    //
+    // If TRUE, EndOfRoundTrip is valid.
+    //
+    BOOLEAN EndOfRoundTripValid : 1;
+
+    //
+    // TRUE while in loss recovery. If TRUE, EndOfRecovery is valid.
+    //
+    BOOLEAN InRecovery : 1;
+
+    //
+    // TRUE during the first round of loss recovery, when the window is only
+    // grown by what is acknowledged (packet conservation).
+    //
+    BOOLEAN PacketConservation : 1;
+
+    //
+    // TRUE if there has been at least one MinRtt sample.
+    //
+    BOOLEAN MinRttTimestampValid : 1;
+
+    //
+    // If TRUE, ProbeRttDoneTimestamp is valid.
+    //
+    BOOLEAN ProbeRttDoneTimestampValid : 1;
+
+    //
+    // TRUE once a full round has passed with the window at the ProbeRTT level.
+    //
+    BOOLEAN ProbeRttRoundDone : 1;
+
+    //
+    // TRUE if ProbeRttMinDelay is older than the ProbeRTT interval.
+    //
+    BOOLEAN ProbeRttExpired : 1;
+
+    //
+    // TRUE if loss was detected during the current round.
+    //
+    BOOLEAN LossInRound : 1;
+
+    //
+    // TRUE if a CE mark was reported during the current round.
+    //
+    BOOLEAN EcnInRound : 1;
+
+    //
+    // TRUE if the congestion window limited sending during the current round.
+    //
+    BOOLEAN CwndLimitedInRound : 1;
+
+    //
+    // TRUE while the ACKs being received are for data sent while probing for
+    // bandwidth (used to decide whether loss should lower InflightHi).
+    //
+    BOOLEAN BwProbeSamples : 1;
+
+    //
+    // If TRUE, AckAggregationStartTime is valid.
+    //
+    BOOLEAN AckAggregationStartTimeValid : 1;
+
+    //
+    // TRUE if the sender has been app limited and the current bandwidth
+    // samples may underestimate the path.
+    //
+    BOOLEAN AppLimited : 1;
+
+    //
+    // The size of the initial congestion window in packets
+    //
+    uint32_t InitialCongestionWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+
+    uint32_t InitialCongestionWindow; // bytes
+
+    //
+    // The congestion window saved on entering loss recovery or ProbeRTT, to be
+    // restored on exit.
+    //
+    uint32_t PriorCongestionWindow; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    //
+    // The current BBR3_STATE.
+    //
+    uint8_t State;
+
+    //
+    // The current BBR3_ACK_PHASE, tracking whether the ACKs being received are
+    // for data sent while probing for bandwidth.
+    //
+    uint8_t AckPhase;
+
+    //
+    // Count of consecutive rounds in STARTUP without significant bandwidth
+    // growth.
+    //
+    uint8_t FullBwCount;
+
+    //
+    // Count of consecutive rounds in STARTUP with a CE ratio above the ECN
+    // threshold.
+    //
+    uint8_t StartupEcnRounds;
+
+    //
+    // The number of rounds in PROBE_BW_UP so far, used to grow InflightHi
+    // exponentially.
+    //
+    uint8_t BwProbeUpRounds;
+
+    //
+    // The dynamic gains (in units of GAIN_UNIT) applied to the bandwidth
+    // estimate to produce the pacing rate and the congestion window.
+    //
+    uint32_t PacingGain;
+    uint32_t CwndGain;
+
+    //
+    // Count of packet-timed round trips.
+    //
+    uint64_t RoundTripCounter;
+
+    //
+    // Receiving acknowledgment of a packet after EndOfRoundTrip will indicate
+    // the current round trip is ended.
+    //
+    uint64_t EndOfRoundTrip;
+
+    //
+    // Receiving acknowledgment of a packet after EndOfRecovery will cause
+    // BBR to exit loss recovery.
+    //
+    uint64_t EndOfRecovery;
+
+    //
+    // The max filter of delivery rate samples, one slot per ProbeBW cycle,
+    // and the index of the current cycle.
+    //
+    uint64_t MaxBwFilter[kBbr3MaxBwFilterLen];
+    uint32_t CycleCount;
+
+    //
+    // The long term (MaxBw) and short term (BwLo) bandwidth estimates and the
+    // one actually used by the model (Bw, zero until the first sample). A BwLo
+    // of UINT64_MAX means "unbounded".
+    //
+    uint64_t MaxBw;
+    uint64_t BwLo;
+    uint64_t Bw;
+
+    //
+    // The maximum delivery rate seen and the bytes delivered in the latest
+    // round.
+    //
+    uint64_t BwLatest;
+    uint32_t InflightLatest;
+
+    //
+    // The long term (InflightHi) and short term (InflightLo) upper bounds on
+    // the volume of data in flight, learnt from loss and ECN. UINT32_MAX means
+    // "unbounded".
+    //
+    uint32_t InflightHi;
+    uint32_t InflightLo;
+
+    //
+    // Bandwidth seen at the start of the last growth round in STARTUP.
+    //
+    uint64_t FullBw;
+
+    //
+    // Loss and ECN signals accumulated over the current round.
+    //
+    uint32_t LossBytesInRound;
+    uint32_t LossEventsInRound;
+    uint32_t CePacketsInRound;
+    uint32_t DeliveredPacketsInRound;
+
+    //
+    // EWMA of the per-round CE ratio (in units of GAIN_UNIT).
+    //
+    uint32_t EcnAlpha;
+
+    //
+    // The time the current ProbeBW phase was started.
+    //
+    uint64_t CycleStart;
+
+    //
+    // Randomized wall clock time to wait in PROBE_BW_DOWN/CRUISE before probing
+    // again, and the count of rounds since the last probe (for Reno
+    // coexistence).
+    //
+    uint64_t BwProbeWait;
+    uint32_t RoundsSinceBwProbe;
+
+    //
+    // Bytes to ACK before raising InflightHi by one packet in PROBE_BW_UP.
+    //
+    uint32_t BwProbeUpCount;
+    uint32_t BwProbeUpAcks;
+
+    //
+    // The dynamic send quantum, the maximum size of a transmission aggregate.
+    //
+    uint64_t SendQuantum;
+
+    //
+    // ACK aggregation (extra acked) tracking.
+    //
+    uint64_t AckAggregationStartTime;
+    uint64_t AggregatedAckBytes;
+    QUIC_SLIDING_WINDOW_EXTREMUM MaxAckHeightFilter;
+    QUIC_SLIDING_WINDOW_EXTREMUM_ENTRY MaxAckHeightFilterEntries[kBbr3DefaultFilterCapacity];
+
+    //
+    // Target packet number to quit the AppLimited state.
+    //
+    uint64_t AppLimitedExitTarget;
+
+    uint64_t MinRtt; // microseconds
+
+    //
+    // Time when MinRtt was sampled. Only valid if MinRttTimestampValid is set.
+    //
+    uint64_t MinRttTimestamp; // microseconds
+
+    //
+    // The minimum RTT seen over the shorter ProbeRTT interval, and when it was
+    // sampled.
+    //
+    uint64_t ProbeRttMinDelay; // microseconds
+    uint64_t ProbeRttMinTimestamp; // microseconds
+
+    //
+    // The earliest time to exit ProbeRTT. Only valid if
+    // ProbeRttDoneTimestampValid is set.
+    //
+    uint64_t ProbeRttDoneTimestamp; // microseconds
+
+} QUIC_CONGESTION_CONTROL_BBR3;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+Bbr3CongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -41,6 +41,7 @@ QuicBindingInitialize(
     QUIC_STATUS Status;
     QUIC_BINDING* Binding;
     BOOLEAN HashTableInitialized = FALSE;
+    BOOLEAN CibirTableInitialized = FALSE;
 
     Binding = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_BINDING), QUIC_POOL_BINDING);
     if (Binding == NULL) {
@@ -60,6 +61,8 @@ QuicBindingInitialize(
     CxPlatDispatchRwLockInitialize(&Binding->RwLock);
     CxPlatDispatchLockInitialize(&Binding->StatelessOperLock);
     CxPlatListInitializeHead(&Binding->Listeners);
+    CxPlatListInitializeHead(&Binding->CibirListenerList);
+    CxPlatZeroMemory(Binding->CibirLengthCounts, sizeof(Binding->CibirLengthCounts));
     QuicLookupInitialize(&Binding->Lookup);
 #if DEBUG
     QuicLibraryTrackDbgObject(QUIC_DBG_OBJECT_TYPE_BINDING, &Binding->DbgObjectLink);
@@ -69,6 +72,11 @@ QuicBindingInitialize(
         goto Error;
     }
     HashTableInitialized = TRUE;
+    if (!CxPlatHashtableInitializeEx(&Binding->CibirListeners, CXPLAT_HASH_MIN_SIZE)) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    CibirTableInitialized = TRUE;
     CxPlatListInitializeHead(&Binding->StatelessOperList);
 
     //
@@ -156,6 +164,9 @@ Error:
             if (HashTableInitialized) {
                 CxPlatHashtableUninitialize(&Binding->StatelessOperTable);
             }
+            if (CibirTableInitialized) {
+                CxPlatHashtableUninitialize(&Binding->CibirListeners);
+            }
 #if DEBUG
             QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_BINDING, &Binding->DbgObjectLink);
 #endif
@@ -177,6 +188,7 @@ QuicBindingUninitialize(
 
     CXPLAT_TEL_ASSERT(Binding->RefCount == 0);
     CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&Binding->Listeners));
+    CXPLAT_TEL_ASSERT(CxPlatListIsEmpty(&Binding->CibirListenerList));
 
     //
     // Delete the datapath binding. This function blocks until all receive
@@ -207,6 +219,7 @@ QuicBindingUninitialize(
     QuicLookupUninitialize(&Binding->Lookup);
     CxPlatDispatchLockUninitialize(&Binding->StatelessOperLock);
     CxPlatHashtableUninitialize(&Binding->StatelessOperTable);
+    CxPlatHashtableUninitialize(&Binding->CibirListeners);
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_BINDING, &Binding->DbgObjectLink);
 #endif
@@ -280,7 +293,60 @@ QuicBindingHasListenerRegistered(
     _In_ const QUIC_BINDING* const Binding
     )
 {
-    return !CxPlatListIsEmpty(&Binding->Listeners);
+    return
+        !CxPlatListIsEmpty(&Binding->Listeners) ||
+        !CxPlatListIsEmpty(&Binding->CibirListenerList);
+}
+
+//
+// Adds a listener with a CIBIR ID to the binding's CIBIR index. It only
+// conflicts with listeners of the same ID, address and overlapping ALPN.
+// Requires the binding's lock to be held exclusively.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_STATUS
+QuicBindingInsertCibirListener(
+    _In_ QUIC_BINDING* Binding,
+    _In_ QUIC_LISTENER* NewListener
+    )
+{
+    const uint8_t* NewCibirId = NewListener->CibirId;
+    const QUIC_ADDR* NewAddr = &NewListener->LocalAddress;
+    const BOOLEAN NewWildCard = NewListener->WildCard;
+    const QUIC_ADDRESS_FAMILY NewFamily = QuicAddrGetFamily(NewAddr);
+    const uint32_t Signature = CxPlatHashSimple(NewCibirId[0], NewCibirId + 2);
+
+    CXPLAT_DBG_ASSERT(NewCibirId[0] != 0 && NewCibirId[0] <= QUIC_MAX_CIBIR_LENGTH);
+
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    CXPLAT_HASHTABLE_ENTRY* Entry =
+        CxPlatHashtableLookup(&Binding->CibirListeners, Signature, &Context);
+    while (Entry != NULL) {
+        const QUIC_LISTENER* ExistingListener =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_LISTENER, CibirEntry);
+        const QUIC_ADDR* ExistingAddr = &ExistingListener->LocalAddress;
+
+        if (memcmp(ExistingListener->CibirId, NewCibirId, 2 + NewCibirId[0]) == 0 &&
+            QuicAddrGetFamily(ExistingAddr) == NewFamily &&
+            ExistingListener->WildCard == NewWildCard &&
+            (NewFamily == QUIC_ADDRESS_FAMILY_UNSPEC || QuicAddrCompareIp(NewAddr, ExistingAddr)) &&
+            QuicListenerHasAlpnOverlap(NewListener, ExistingListener)) {
+            return QUIC_STATUS_ALPN_IN_USE;
+        }
+
+        Entry = CxPlatHashtableLookupNext(&Binding->CibirListeners, &Context);
+    }
+
+    CxPlatHashtableInsert(
+        &Binding->CibirListeners,
+        &NewListener->CibirEntry,
+        Signature,
+        NULL);
+    CxPlatListInsertTail(&Binding->CibirListenerList, &NewListener->Link);
+    Binding->CibirLengthCounts[NewCibirId[0]]++;
+
+    return QUIC_STATUS_SUCCESS;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -299,6 +365,13 @@ QuicBindingRegisterListener(
 
     CxPlatDispatchRwLockAcquireExclusive(&Binding->RwLock, PrevIrql);
 
+    const BOOLEAN FirstListener = !QuicBindingHasListenerRegistered(Binding);
+
+    if (NewListener->CibirId[0] != 0) {
+        Status = QuicBindingInsertCibirListener(Binding, NewListener);
+        goto Exit;
+    }
+
     //
     // For a single binding, listeners are saved in a linked list, sorted by
     // family first, in decending order {AF_INET6, AF_INET, AF_UNSPEC}, and then
@@ -345,8 +418,6 @@ QuicBindingRegisterListener(
     }
 
     if (Status == QUIC_STATUS_SUCCESS) {
-        MaximizeLookup = CxPlatListIsEmpty(&Binding->Listeners);
-
         //
         // If we search all the way back to the head of the list, just insert
         // the new listener at the end of the list. Otherwise, we terminated
@@ -363,6 +434,10 @@ QuicBindingRegisterListener(
         }
     }
 
+Exit:
+
+    MaximizeLookup = FirstListener && QUIC_SUCCEEDED(Status);
+
     CxPlatDispatchRwLockReleaseExclusive(&Binding->RwLock, PrevIrql);
 
     if (MaximizeLookup &&
@@ -374,6 +449,103 @@ QuicBindingRegisterListener(
     return Status;
 }
 
+//
+// Finds the best CIBIR listener for a new connection, by the CIBIR ID the
+// client put in its original destination CID. The ID sits at the same offset
+// as in the CIDs the listener's connections hand out, so each registered ID
+// length costs one hash lookup, however many listeners share the binding.
+// Requires the binding's lock to be held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_LISTENER*
+QuicBindingGetCibirListener(
+    _In_ QUIC_BINDING* Binding,
+    _In_ const QUIC_CONNECTION* Connection,
+    _Inout_ QUIC_NEW_CONNECTION_INFO* Info,
+    _Out_ BOOLEAN* FailedAlpnMatch
+    )
+{
+    const QUIC_CID* DestCid;
+    if (Connection->OrigDestCID != NULL) {
+        DestCid = Connection->OrigDestCID; // The client's CID from before a retry.
+    } else if (Connection->SourceCids.Next != NULL) {
+        DestCid =
+            &CXPLAT_CONTAINING_RECORD(
+                Connection->SourceCids.Next,
+                QUIC_CID_HASH_ENTRY,
+                Link)->CID;
+    } else {
+        *FailedAlpnMatch = FALSE;
+        return NULL;
+    }
+
+    const uint8_t Offset = MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH;
+    const QUIC_ADDR* Addr = Info->LocalAddress;
+    const QUIC_ADDRESS_FAMILY Family = QuicAddrGetFamily(Addr);
+
+    QUIC_LISTENER* Listener = NULL;
+    uint8_t ListenerRank = 0;
+    *FailedAlpnMatch = FALSE;
+
+    for (uint8_t Length = 1;
+        Length <= QUIC_MAX_CIBIR_LENGTH && Offset + Length <= DestCid->Length;
+        ++Length) {
+
+        if (Binding->CibirLengthCounts[Length] == 0) {
+            continue;
+        }
+
+        const uint8_t* CibirId = DestCid->Data + Offset;
+        CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+        CXPLAT_HASHTABLE_ENTRY* Entry =
+            CxPlatHashtableLookup(
+                &Binding->CibirListeners,
+                CxPlatHashSimple(Length, CibirId),
+                &Context);
+        while (Entry != NULL) {
+            QUIC_LISTENER* ExistingListener =
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_LISTENER, CibirEntry);
+            const QUIC_ADDR* ExistingAddr = &ExistingListener->LocalAddress;
+            const QUIC_ADDRESS_FAMILY ExistingFamily = QuicAddrGetFamily(ExistingAddr);
+
+            //
+            // Rank the address matches the same way the sorted listener list
+            // does: specific addresses, then wild cards, then any family.
+            //
+            uint8_t Rank;
+            if (ExistingFamily == QUIC_ADDRESS_FAMILY_UNSPEC) {
+                Rank = 1;
+            } else if (Family != ExistingFamily ||
+                (!ExistingListener->WildCard && !QuicAddrCompareIp(Addr, ExistingAddr))) {
+                Rank = 0; // No IP match.
+            } else {
+                Rank = ExistingListener->WildCard ? 2 : 3;
+            }
+
+            if (Rank > ListenerRank &&
+                ExistingListener->CibirId[0] == Length &&
+                memcmp(ExistingListener->CibirId + 2, CibirId, Length) == 0) {
+                if (QuicListenerMatchesAlpn(ExistingListener, Info)) {
+                    Listener = ExistingListener;
+                    ListenerRank = Rank;
+                } else {
+                    *FailedAlpnMatch = TRUE;
+                }
+            }
+
+            Entry = CxPlatHashtableLookupNext(&Binding->CibirListeners, &Context);
+        }
+    }
+
+    if (Listener != NULL &&
+        !CxPlatRefIncrementNonZero(&Listener->StartRefCount, 1)) {
+        Listener = NULL;
+    }
+
+    return Listener;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 _Success_(return != NULL)
 QUIC_LISTENER*
@@ -390,9 +562,23 @@ QuicBindingGetListener(
 
     BOOLEAN FailedAlpnMatch = FALSE;
     BOOLEAN FailedAddrMatch = TRUE;
+    BOOLEAN FailedCibirAlpnMatch = FALSE;
 
     CxPlatDispatchRwLockAcquireShared(&Binding->RwLock, PrevIrql);
 
+    //
+    // Listeners with a CIBIR ID take precedence. Connections that don't carry
+    // a registered ID fall back to the regular listeners.
+    //
+    if (!CxPlatListIsEmpty(&Binding->CibirListenerList)) {
+        Listener =
+            QuicBindingGetCibirListener(
+                Binding, Connection, Info, &FailedCibirAlpnMatch);
+        if (Listener != NULL) {
+            goto Done;
+        }
+    }
+
     for (CXPLAT_LIST_ENTRY* Link = Binding->Listeners.Flink;
         Link != &Binding->Listeners;
         Link = Link->Flink) {
@@ -427,8 +613,8 @@ Done:
 
     CxPlatDispatchRwLockReleaseShared(&Binding->RwLock, PrevIrql);
 
-    if (FailedAddrMatch) {
-    } else if (FailedAlpnMatch) {
+    if (Listener == NULL &&
+        (FailedCibirAlpnMatch || (!FailedAddrMatch && FailedAlpnMatch))) {
         QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_NO_ALPN);
     }
 
@@ -443,6 +629,10 @@ QuicBindingUnregisterListener(
     )
 {
     CxPlatDispatchRwLockAcquireExclusive(&Binding->RwLock, PrevIrql);
+    if (Listener->CibirId[0] != 0) {
+        CxPlatHashtableRemove(&Binding->CibirListeners, &Listener->CibirEntry, NULL);
+        Binding->CibirLengthCounts[Listener->CibirId[0]]--;
+    }
     CxPlatListEntryRemove(&Listener->Link);
     CxPlatDispatchRwLockReleaseExclusive(&Binding->RwLock, PrevIrql);
 }
@@ -452,20 +642,11 @@ void
 QuicBindingAcceptConnection(
     _In_ QUIC_BINDING* Binding,
     _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_LISTENER* Listener,
     _In_ QUIC_NEW_CONNECTION_INFO* Info
     )
 {
-    //
-    // Find a listener that matches the incoming connection request, by IP, port
-    // and ALPN.
-    //
-    QUIC_LISTENER* Listener = QuicBindingGetListener(Binding, Connection, Info);
-    if (Listener == NULL) {
-        QuicConnTransportError(
-            Connection,
-            QUIC_ERROR_CRYPTO_NO_APPLICATION_PROTOCOL);
-        return;
-    }
+    UNREFERENCED_PARAMETER(Binding);
 
     //
     // Save the negotiated ALPN (starting with the length prefix) to be
@@ -511,6 +692,18 @@ QuicBindingAddSourceConnectionID(
     return QuicLookupAddLocalCid(&Binding->Lookup, SourceCid, NULL);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+QuicBindingAddSourceConnectionIDs(
+    _In_ QUIC_BINDING* Binding,
+    _In_ uint8_t Count,
+    _In_reads_(Count)
+        QUIC_CID_HASH_ENTRY** SourceCids
+    )
+{
+    return QuicLookupAddLocalCids(&Binding->Lookup, Count, SourceCids);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicBindingRemoveSourceConnectionID(
@@ -595,7 +788,7 @@ QuicBindingCreateStatelessOperation(
                 ListEntry);
 
         if (CxPlatTimeDiff32(OldStatelessCtx->CreationTimeMs, TimeMs) <
-            (uint32_t)MsQuicLib.Settings.StatelessOperationExpirationMs) {
+            (uint32_t)QuicLibraryGetSettings()->StatelessOperationExpirationMs) {
             break;
         }
 
@@ -618,8 +811,8 @@ QuicBindingCreateStatelessOperation(
         }
     }
 
-    if (Binding->StatelessOperCount >= (uint32_t)MsQuicLib.Settings.MaxBindingStatelessOperations) {
-        QuicPacketLogDrop(Binding, Packet, "Max binding operations reached");
+    if (Binding->StatelessOperCount >= (uint32_t)QuicLibraryGetSettings()->MaxBindingStatelessOperations) {
+        QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_QUEUE_FULL, "Max binding operations reached");
         goto Exit;
     }
 
@@ -636,7 +829,7 @@ QuicBindingCreateStatelessOperation(
             CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_STATELESS_CONTEXT, TableEntry);
 
         if (QuicAddrCompare(&ExistingCtx->RemoteAddress, RemoteAddress)) {
-            QuicPacketLogDrop(Binding, Packet, "Already in stateless oper table");
+            QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_QUEUE_FULL, "Already in stateless oper table");
             goto Exit;
         }
 
@@ -651,7 +844,11 @@ QuicBindingCreateStatelessOperation(
     StatelessCtx =
         (QUIC_STATELESS_CONTEXT*)CxPlatPoolAlloc(&Worker->Partition->StatelessContextPool);
     if (StatelessCtx == NULL) {
-        QuicPacketLogDrop(Binding, Packet, "Alloc failure for stateless oper ctx");
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_OUT_OF_MEMORY,
+            "Alloc failure for stateless oper ctx");
         goto Exit;
     }
 
@@ -693,13 +890,30 @@ QuicBindingQueueStatelessOperation(
     )
 {
     if (MsQuicLib.StatelessRegistration == NULL) {
-        QuicPacketLogDrop(Binding, Packet, "NULL stateless registration");
+        QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_NO_CONNECTION, "NULL stateless registration");
+        return FALSE;
+    }
+
+    //
+    // Apply the partition's rate limit before taking any locks or allocating,
+    // so a flood of (possibly spoofed) packets is shed cheaply here.
+    //
+    if (!QuicPartitionStatelessOperAdmit(&MsQuicLib.Partitions[Packet->PartitionIndex])) {
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_QUEUE_FULL,
+            "Stateless operation rate limit reached");
         return FALSE;
     }
 
     QUIC_WORKER* Worker = QuicLibraryGetWorker(Packet);
     if (QuicWorkerIsOverloaded(Worker)) {
-        QuicPacketLogDrop(Binding, Packet, "Stateless worker overloaded (stateless oper)");
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_QUEUE_FULL,
+            "Stateless worker overloaded (stateless oper)");
         return FALSE;
     }
 
@@ -711,7 +925,11 @@ QuicBindingQueueStatelessOperation(
 
     QUIC_OPERATION* Oper = QuicOperationAlloc(Worker->Partition, OperType);
     if (Oper == NULL) {
-        QuicPacketLogDrop(Binding, Packet, "Alloc failure for stateless operation");
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_OUT_OF_MEMORY,
+            "Alloc failure for stateless operation");
         QuicBindingReleaseStatelessOperation(Context, FALSE);
         return FALSE;
     }
@@ -749,11 +967,12 @@ QuicBindingProcessStatelessOperation(
         CXPLAT_DBG_ASSERT(RecvPacket->DestCid != NULL);
         CXPLAT_DBG_ASSERT(RecvPacket->SourceCid != NULL);
 
+        const QUIC_SETTINGS_INTERNAL* Settings = QuicLibraryGetSettings();
         const uint32_t* SupportedVersions;
         uint32_t SupportedVersionsLength;
-        if (MsQuicLib.Settings.IsSet.VersionSettings) {
-            SupportedVersions = MsQuicLib.Settings.VersionSettings->OfferedVersions;
-            SupportedVersionsLength = MsQuicLib.Settings.VersionSettings->OfferedVersionsLength;
+        if (Settings->IsSet.VersionSettings) {
+            SupportedVersions = Settings->VersionSettings->OfferedVersions;
+            SupportedVersionsLength = Settings->VersionSettings->OfferedVersionsLength;
         } else {
             SupportedVersions = DefaultSupportedVersionsList;
             SupportedVersionsLength = ARRAYSIZE(DefaultSupportedVersionsList);
@@ -904,12 +1123,12 @@ QuicBindingProcessStatelessOperation(
             CxPlatCopyMemory(Iv, NewDestCid, MsQuicLib.CidTotalLength);
         }
 
-        CxPlatDispatchLockAcquire(&Partition->StatelessRetryKeysLock);
-
+        QUIC_PARTITION* ReadPartition;
+        uint32_t ReadEpoch;
         CXPLAT_KEY* StatelessRetryKey =
-            QuicPartitionGetCurrentStatelessRetryKey(Partition);
+            QuicPartitionGetCurrentStatelessRetryKey(
+                Partition, &ReadPartition, &ReadEpoch);
         if (StatelessRetryKey == NULL) {
-            CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
             goto Exit;
         }
 
@@ -920,13 +1139,14 @@ QuicBindingProcessStatelessOperation(
                 sizeof(Token.Authenticated), (uint8_t*) &Token.Authenticated,
                 sizeof(Token.Encrypted) + sizeof(Token.EncryptionTag), (uint8_t*)&(Token.Encrypted));
 
-        CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
+        QuicLibraryReadEnd(ReadPartition, ReadEpoch);
         if (QUIC_FAILED(Status)) {
             goto Exit;
         }
 
         SendDatagram->Length =
             QuicPacketEncodeRetryV1(
+                Partition,
                 RecvPacket->LH->Version,
                 RecvPacket->SourceCid, RecvPacket->SourceCidLen,
                 NewDestCid, MsQuicLib.CidTotalLength,
@@ -1005,7 +1225,11 @@ QuicBindingQueueStatelessReset(
     CXPLAT_DBG_ASSERT(!((QUIC_SHORT_HEADER_V1*)Packet->Buffer)->IsLongHeader);
 
     if (Packet->BufferLength <= QUIC_MIN_STATELESS_RESET_PACKET_LENGTH) {
-        QuicPacketLogDrop(Binding, Packet, "Packet too short for stateless reset");
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Packet too short for stateless reset");
         return FALSE;
     }
 
@@ -1015,7 +1239,11 @@ QuicBindingQueueStatelessReset(
         // a connection ID. Without a connection ID, a stateless reset token
         // cannot be generated.
         //
-        QuicPacketLogDrop(Binding, Packet, "No stateless reset on exclusive binding");
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_NO_CONNECTION,
+            "No stateless reset on exclusive binding");
         return FALSE;
     }
 
@@ -1062,10 +1290,10 @@ QuicBindingPreprocessPacket(
             // we should respond with a version negotiation packet.
             //
             if (!QuicBindingHasListenerRegistered(Binding)) {
-                QuicPacketLogDrop(Binding, Packet, "No listener to send VN");
+                QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_NO_CONNECTION, "No listener to send VN");
 
             } else if (Packet->BufferLength < QUIC_MIN_UDP_PAYLOAD_LENGTH_FOR_VN) {
-                QuicPacketLogDrop(Binding, Packet, "Too small to send VN");
+                QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Too small to send VN");
 
             } else {
                 *ReleaseDatagram =
@@ -1077,16 +1305,24 @@ QuicBindingPreprocessPacket(
 
         if (Binding->Exclusive) {
             if (Packet->DestCidLen != 0) {
-                QuicPacketLogDrop(Binding, Packet, "Non-zero length CID on exclusive binding");
+                QuicPacketLogDrop(
+                    Binding,
+                    Packet,
+                    QUIC_RECV_DROP_INVALID_PACKET,
+                    "Non-zero length CID on exclusive binding");
                 return FALSE;
             }
         } else {
             if (Packet->DestCidLen == 0) {
-                QuicPacketLogDrop(Binding, Packet, "Zero length DestCid");
+                QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Zero length DestCid");
                 return FALSE;
             }
             if (Packet->DestCidLen < QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH) {
-                QuicPacketLogDrop(Binding, Packet, "Less than min length CID on non-exclusive binding");
+                QuicPacketLogDrop(
+                    Binding,
+                    Packet,
+                    QUIC_RECV_DROP_INVALID_PACKET,
+                    "Less than min length CID on non-exclusive binding");
                 return FALSE;
             }
         }
@@ -1136,8 +1372,12 @@ QuicBindingShouldRetryConnection(
         }
     }
 
+    if (Packet->ForceRetry) {
+        return TRUE;
+    }
+
     uint64_t CurrentMemoryLimit =
-        (MsQuicLib.Settings.RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
+        (QuicLibraryGetSettings()->RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
 
     return MsQuicLib.CurrentHandshakeMemoryUsage >= CurrentMemoryLimit;
 }
@@ -1161,7 +1401,7 @@ QuicBindingCreateConnection(
     //
     QUIC_WORKER* Worker = QuicLibraryGetWorker(Packet);
     if (QuicWorkerIsOverloaded(Worker)) {
-        QuicPacketLogDrop(Binding, Packet, "Stateless worker overloaded");
+        QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_QUEUE_FULL, "Stateless worker overloaded");
         return NULL;
     }
 
@@ -1175,7 +1415,11 @@ QuicBindingCreateConnection(
             Packet,
             &NewConnection);
     if (QUIC_FAILED(Status)) {
-        QuicPacketLogDrop(Binding, Packet, "Failed to initialize new connection");
+        QuicPacketLogDrop(
+            Binding,
+            Packet,
+            QUIC_RECV_DROP_OUT_OF_MEMORY,
+            "Failed to initialize new connection");
         return NULL;
     }
 
@@ -1197,7 +1441,7 @@ QuicBindingCreateConnection(
     //
 
     if (!QuicLibraryTryAddRefBinding(Binding)) {
-        QuicPacketLogDrop(Binding, Packet, "Clean up in progress");
+        QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_UNEXPECTED, "Clean up in progress");
         goto Exit;
     }
 
@@ -1215,7 +1459,7 @@ QuicBindingCreateConnection(
         // Collision with an existing connection or a memory failure.
         //
         if (Connection == NULL) {
-            QuicPacketLogDrop(Binding, Packet, "Failed to insert remote hash");
+            QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_OUT_OF_MEMORY, "Failed to insert remote hash");
         }
         goto Exit;
     }
@@ -1297,7 +1541,7 @@ QuicBindingDropBlockedSourcePorts(
 
     for (size_t i = 0; i < ARRAYSIZE(BlockedPorts) && SourcePort <= BlockedPorts[i]; ++i) {
         if (BlockedPorts[i] == SourcePort) {
-            QuicPacketLogDrop(Binding, Packet, "Blocked source port");
+            QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_FILTERED, "Blocked source port");
             return TRUE;
         }
     }
@@ -1306,7 +1550,8 @@ QuicBindingDropBlockedSourcePorts(
 }
 
 //
-// Looks up or creates a connection to handle a chain of packets.
+// Looks up or creates a connection to handle a chain of packets. Connection
+// is the result of an earlier (batched) local CID lookup, if one was done.
 // Returns TRUE if the packets were delivered, and FALSE if they should be
 // dropped.
 //
@@ -1317,7 +1562,8 @@ QuicBindingDeliverPackets(
     _In_ QUIC_BINDING* Binding,
     _In_ QUIC_RX_PACKET* Packets,
     _In_ uint32_t PacketChainLength,
-    _In_ uint32_t PacketChainByteLength
+    _In_ uint32_t PacketChainByteLength,
+    _In_opt_ QUIC_CONNECTION* Connection
     )
 {
     CXPLAT_DBG_ASSERT(Packets->ValidatedHeaderInv);
@@ -1348,14 +1594,8 @@ QuicBindingDeliverPackets(
     // packet, then the packet is dropped.
     //
 
-    QUIC_CONNECTION* Connection;
-    if (!Binding->ServerOwned || Packets->IsShortHeader) {
-        Connection =
-            QuicLookupFindConnectionByLocalCid(
-                &Binding->Lookup,
-                Packets->DestCid,
-                Packets->DestCidLen);
-    } else {
+    if (Binding->ServerOwned && !Packets->IsShortHeader) {
+        CXPLAT_DBG_ASSERT(Connection == NULL);
         Connection =
             QuicLookupFindConnectionByRemoteHash(
                 &Binding->Lookup,
@@ -1375,12 +1615,20 @@ QuicBindingDeliverPackets(
         //
 
         if (!Binding->ServerOwned) {
-            QuicPacketLogDrop(Binding, Packets, "No matching client connection");
+            QuicPacketLogDrop(
+                Binding,
+                Packets,
+                QUIC_RECV_DROP_NO_CONNECTION,
+                "No matching client connection");
             return FALSE;
         }
 
         if (Binding->Exclusive) {
-            QuicPacketLogDrop(Binding, Packets, "No connection on exclusive binding");
+            QuicPacketLogDrop(
+                Binding,
+                Packets,
+                QUIC_RECV_DROP_NO_CONNECTION,
+                "No connection on exclusive binding");
             return FALSE;
         }
 
@@ -1397,7 +1645,11 @@ QuicBindingDeliverPackets(
         }
 
         if (Packets->Invariant->LONG_HDR.Version == QUIC_VERSION_VER_NEG) {
-            QuicPacketLogDrop(Binding, Packets, "Version negotiation packet not matched with a connection");
+            QuicPacketLogDrop(
+                Binding,
+                Packets,
+                QUIC_RECV_DROP_NO_CONNECTION,
+                "Version negotiation packet not matched with a connection");
             return FALSE;
         }
 
@@ -1416,13 +1668,21 @@ QuicBindingDeliverPackets(
         case QUIC_VERSION_DRAFT_29:
         case QUIC_VERSION_MS_1:
             if (Packets->LH->Type != QUIC_INITIAL_V1) {
-                QuicPacketLogDrop(Binding, Packets, "Non-initial packet not matched with a connection");
+                QuicPacketLogDrop(
+                    Binding,
+                    Packets,
+                    QUIC_RECV_DROP_NO_CONNECTION,
+                    "Non-initial packet not matched with a connection");
                 return FALSE;
             }
             break;
         case QUIC_VERSION_2:
             if (Packets->LH->Type != QUIC_INITIAL_V2) {
-                QuicPacketLogDrop(Binding, Packets, "Non-initial packet not matched with a connection");
+                QuicPacketLogDrop(
+                    Binding,
+                    Packets,
+                    QUIC_RECV_DROP_NO_CONNECTION,
+                    "Non-initial packet not matched with a connection");
                 return FALSE;
             }
         }
@@ -1454,7 +1714,11 @@ QuicBindingDeliverPackets(
         CXPLAT_DBG_ASSERT(Token != NULL);
 
         if (!QuicBindingHasListenerRegistered(Binding)) {
-            QuicPacketLogDrop(Binding, Packets, "No listeners registered to accept new connection.");
+            QuicPacketLogDrop(
+                Binding,
+                Packets,
+                QUIC_RECV_DROP_NO_CONNECTION,
+                "No listeners registered to accept new connection.");
             return FALSE;
         }
 
@@ -1484,6 +1748,108 @@ QuicBindingDeliverPackets(
     return TRUE;
 }
 
+//
+// Builds the Initial packet filter's per-source key from only the IP address
+// (not the port) of the remote address, and returns its hash. The hash is keyed
+// with the library's random Toeplitz key so sources can't be picked to collide.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint32_t
+QuicBindingGetInitialFilterKey(
+    _In_ const QUIC_ADDR* const RemoteAddress,
+    _Out_ QUIC_INITIAL_FILTER_KEY* Key
+    )
+{
+    if (QuicAddrGetFamily(RemoteAddress) == QUIC_ADDRESS_FAMILY_INET) {
+        CxPlatZeroMemory(Key->Address, 10);
+        Key->Address[10] = 0xFF;
+        Key->Address[11] = 0xFF;
+        CxPlatCopyMemory(
+            Key->Address + 12,
+            &RemoteAddress->Ipv4.sin_addr,
+            sizeof(RemoteAddress->Ipv4.sin_addr));
+    } else {
+        CXPLAT_STATIC_ASSERT(
+            sizeof(RemoteAddress->Ipv6.sin6_addr) == sizeof(Key->Address),
+            "Key must hold an IPv6 address");
+        CxPlatCopyMemory(
+            Key->Address,
+            &RemoteAddress->Ipv6.sin6_addr,
+            sizeof(Key->Address));
+    }
+    return
+        CxPlatToeplitzHashCompute(
+            &MsQuicLib.ToeplitzHash,
+            Key->Address,
+            sizeof(Key->Address),
+            0);
+}
+
+//
+// A chain of datagrams with the same destination CID, with handshake packets
+// first.
+//
+typedef struct QUIC_RECV_SUBCHAIN {
+    CXPLAT_RECV_DATA* Head;
+    CXPLAT_RECV_DATA** Tail;        // The end of the handshake packets.
+    CXPLAT_RECV_DATA** DataTail;    // The end of the chain.
+    uint32_t Length;
+    uint32_t Bytes;
+} QUIC_RECV_SUBCHAIN;
+
+//
+// Resolves the connections for a batch of subchains and delivers them. The
+// local CID lookups of the whole batch are done in a single pass.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicBindingDeliverSubChains(
+    _In_ QUIC_BINDING* Binding,
+    _In_range_(<=, QUIC_LOOKUP_BATCH_MAX) uint32_t Count,
+    _In_reads_(Count) QUIC_RECV_SUBCHAIN* SubChains,
+    _Inout_ CXPLAT_RECV_DATA*** ReleaseChainTail
+    )
+{
+    const uint8_t* Cids[QUIC_LOOKUP_BATCH_MAX];
+    uint8_t CidLens[QUIC_LOOKUP_BATCH_MAX];
+    QUIC_CONNECTION* Found[QUIC_LOOKUP_BATCH_MAX];
+    QUIC_CONNECTION* Connections[QUIC_LOOKUP_BATCH_MAX];
+    uint32_t LocalCount = 0;
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        QUIC_RX_PACKET* Packet = (QUIC_RX_PACKET*)SubChains[i].Head;
+        if (!Binding->ServerOwned || Packet->IsShortHeader) {
+            Cids[LocalCount] = Packet->DestCid;
+            CidLens[LocalCount] = Packet->DestCidLen;
+            LocalCount++;
+        }
+    }
+
+    if (LocalCount != 0) {
+        QuicLookupFindConnectionsByLocalCid(
+            &Binding->Lookup, LocalCount, Cids, CidLens, Found);
+    }
+
+    for (uint32_t i = 0, j = 0; i < Count; ++i) {
+        QUIC_RX_PACKET* Packet = (QUIC_RX_PACKET*)SubChains[i].Head;
+        Connections[i] =
+            (!Binding->ServerOwned || Packet->IsShortHeader) ? Found[j++] : NULL;
+    }
+
+    for (uint32_t i = 0; i < Count; ++i) {
+        if (!QuicBindingDeliverPackets(
+                Binding,
+                (QUIC_RX_PACKET*)SubChains[i].Head,
+                SubChains[i].Length,
+                SubChains[i].Bytes,
+                Connections[i])) {
+            **ReleaseChainTail = SubChains[i].Head;
+            *ReleaseChainTail = SubChains[i].DataTail;
+        }
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Function_class_(CXPLAT_DATAPATH_RECEIVE_CALLBACK)
 void
@@ -1500,11 +1866,8 @@ QuicBindingReceive(
     QUIC_BINDING* Binding = (QUIC_BINDING*)RecvCallbackContext;
     CXPLAT_RECV_DATA* ReleaseChain = NULL;
     CXPLAT_RECV_DATA** ReleaseChainTail = &ReleaseChain;
-    CXPLAT_RECV_DATA* SubChain = NULL;
-    CXPLAT_RECV_DATA** SubChainTail = &SubChain;
-    CXPLAT_RECV_DATA** SubChainDataTail = &SubChain;
-    uint32_t SubChainLength = 0;
-    uint32_t SubChainBytes = 0;
+    QUIC_RECV_SUBCHAIN SubChains[QUIC_LOOKUP_BATCH_MAX];
+    uint32_t SubChainCount = 0;
     uint32_t TotalChainLength = 0;
     uint32_t TotalDatagramBytes = 0;
 
@@ -1512,7 +1875,10 @@ QuicBindingReceive(
 
     //
     // Breaks the chain of datagrams into subchains by destination CID and
-    // delivers the subchains.
+    // delivers the subchains. Subchains are collected into batches so their
+    // connections can be looked up together, and a datagram is appended to
+    // any subchain in the batch with the same destination CID, so each
+    // connection is only looked up (and referenced) once per batch.
     //
     // NB: All packets in a datagram are required to have the same destination
     // CID, so we don't split datagrams here. Later on, the packet handling
@@ -1523,6 +1889,10 @@ QuicBindingReceive(
     CXPLAT_DBG_ASSERT(DatagramChain->PartitionIndex < MsQuicLib.PartitionCount);
     QUIC_PARTITION* Partition = &MsQuicLib.Partitions[DatagramChain->PartitionIndex];
     const uint64_t PartitionShifted = ((uint64_t)Partition->Index + 1) << 40;
+    const QUIC_INITIAL_FILTER_CONFIG FilterConfig = MsQuicLib.InitialFilterConfig;
+    const BOOLEAN FilterInitials =
+        FilterConfig.Enabled && Binding->ServerOwned && !Binding->Exclusive;
+    const uint32_t TimeMs = FilterInitials ? CxPlatTimeMs32() : 0;
 
     CXPLAT_RECV_DATA* Datagram;
     while ((Datagram = DatagramChain) != NULL) {
@@ -1564,12 +1934,48 @@ QuicBindingReceive(
             if (Hooks->Receive(Datagram)) {
                 *ReleaseChainTail = Datagram;
                 ReleaseChainTail = &Datagram->Next;
-                QuicPacketLogDrop(Binding, Packet, "Test Dropped");
+                QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_FILTERED, "Test Dropped");
                 continue;
             }
         }
 #endif
 
+        //
+        // Run the cheap Initial packet filter on the raw datagram first, so
+        // flood traffic is shed before any further processing.
+        //
+        QUIC_INITIAL_FILTER_ACTION FilterAction = QUIC_INITIAL_FILTER_PASS;
+        if (FilterInitials) {
+            BOOLEAN HasToken;
+            FilterAction =
+                QuicInitialFilterClassify(
+                    Datagram->Buffer,
+                    Datagram->BufferLength,
+                    &HasToken);
+            if (FilterAction == QUIC_INITIAL_FILTER_COUNT) {
+                QUIC_INITIAL_FILTER_KEY SourceKey;
+                const uint32_t SourceHash =
+                    QuicBindingGetInitialFilterKey(
+                        &Datagram->Route->RemoteAddress,
+                        &SourceKey);
+                FilterAction =
+                    QuicInitialFilterCount(
+                        &FilterConfig,
+                        &SourceKey,
+                        SourceHash,
+                        HasToken,
+                        TimeMs,
+                        Partition->InitialFilterBucketCount,
+                        Partition->InitialFilterBuckets);
+            }
+            if (FilterAction == QUIC_INITIAL_FILTER_DROP) {
+                *ReleaseChainTail = Datagram;
+                ReleaseChainTail = &Datagram->Next;
+                QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_FILTERED, "Initial filter");
+                continue;
+            }
+        }
+
         //
         // Perform initial validation.
         //
@@ -1581,33 +1987,49 @@ QuicBindingReceive(
             }
             continue;
         }
+        Packet->ForceRetry = FilterAction == QUIC_INITIAL_FILTER_RETRY;
 
         CXPLAT_DBG_ASSERT(Packet->DestCid != NULL);
         CXPLAT_DBG_ASSERT(Packet->DestCidLen != 0 || Binding->Exclusive);
         CXPLAT_DBG_ASSERT(Packet->ValidatedHeaderInv);
 
         //
-        // If the next datagram doesn't match the current subchain, deliver the
-        // current subchain and start a new one.
+        // Find the subchain in the batch with the datagram's destination CID,
+        // checking the most recent one first. If there is none, start a new
+        // subchain, delivering the batch first if it is full.
         // (If the binding is exclusively owned, all datagrams are delivered to
         // the same connection and this chain-splitting step is skipped.)
         //
-        if (!Binding->Exclusive && SubChain != NULL) {
-            QUIC_RX_PACKET* SubChainPacket = (QUIC_RX_PACKET*)SubChain;
-            if ((Packet->DestCidLen != SubChainPacket->DestCidLen ||
-                 memcmp(Packet->DestCid, SubChainPacket->DestCid, Packet->DestCidLen) != 0)) {
-                if (!QuicBindingDeliverPackets(Binding, (QUIC_RX_PACKET*)SubChain, SubChainLength, SubChainBytes)) {
-                    *ReleaseChainTail = SubChain;
-                    ReleaseChainTail = SubChainDataTail;
+        QUIC_RECV_SUBCHAIN* SubChain = NULL;
+        if (SubChainCount != 0) {
+            if (Binding->Exclusive) {
+                SubChain = &SubChains[0];
+            } else {
+                for (uint32_t i = SubChainCount; i > 0; --i) {
+                    QUIC_RX_PACKET* SubChainPacket = (QUIC_RX_PACKET*)SubChains[i - 1].Head;
+                    if (Packet->DestCidLen == SubChainPacket->DestCidLen &&
+                        memcmp(Packet->DestCid, SubChainPacket->DestCid, Packet->DestCidLen) == 0) {
+                        SubChain = &SubChains[i - 1];
+                        break;
+                    }
                 }
-                SubChain = NULL;
-                SubChainTail = &SubChain;
-                SubChainDataTail = &SubChain;
-                SubChainLength = 0;
-                SubChainBytes = 0;
             }
         }
 
+        if (SubChain == NULL) {
+            if (SubChainCount == QUIC_LOOKUP_BATCH_MAX) {
+                QuicBindingDeliverSubChains(
+                    Binding, SubChainCount, SubChains, &ReleaseChainTail);
+                SubChainCount = 0;
+            }
+            SubChain = &SubChains[SubChainCount++];
+            SubChain->Head = NULL;
+            SubChain->Tail = &SubChain->Head;
+            SubChain->DataTail = &SubChain->Head;
+            SubChain->Length = 0;
+            SubChain->Bytes = 0;
+        }
+
         //
         // Insert the datagram into the current chain, with handshake packets
         // first (we assume handshake packets don't come after non-handshake
@@ -1616,32 +2038,30 @@ QuicBindingReceive(
         // packets can create a new connection.
         //
 
-        SubChainLength++;
-        SubChainBytes += Datagram->BufferLength;
+        SubChain->Length++;
+        SubChain->Bytes += Datagram->BufferLength;
         if (!QuicPacketIsHandshake(Packet->Invariant)) {
-            *SubChainDataTail = Datagram;
-            SubChainDataTail = &Datagram->Next;
+            *SubChain->DataTail = Datagram;
+            SubChain->DataTail = &Datagram->Next;
         } else {
-            if (*SubChainTail == NULL) {
-                *SubChainTail = Datagram;
-                SubChainTail = &Datagram->Next;
-                SubChainDataTail = &Datagram->Next;
+            if (*SubChain->Tail == NULL) {
+                *SubChain->Tail = Datagram;
+                SubChain->Tail = &Datagram->Next;
+                SubChain->DataTail = &Datagram->Next;
             } else {
-                Datagram->Next = *SubChainTail;
-                *SubChainTail = Datagram;
-                SubChainTail = &Datagram->Next;
+                Datagram->Next = *SubChain->Tail;
+                *SubChain->Tail = Datagram;
+                SubChain->Tail = &Datagram->Next;
             }
         }
     }
 
-    if (SubChain != NULL) {
+    if (SubChainCount != 0) {
         //
-        // Deliver the last subchain.
+        // Deliver the last batch.
         //
-        if (!QuicBindingDeliverPackets(Binding, (QUIC_RX_PACKET*)SubChain, SubChainLength, SubChainBytes)) {
-            *ReleaseChainTail = SubChain;
-            ReleaseChainTail = SubChainTail; // cppcheck-suppress unreadVariable; NOLINT
-        }
+        QuicBindingDeliverSubChains(
+            Binding, SubChainCount, SubChains, &ReleaseChainTail);
     }
 
     if (ReleaseChain != NULL) {
@@ -1651,6 +2071,8 @@ QuicBindingReceive(
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_UDP_RECV, TotalChainLength);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_UDP_RECV_BYTES, TotalDatagramBytes);
     QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_UDP_RECV_EVENTS);
+
+    QuicProbe3(datapath_recv, Binding, TotalChainLength, TotalDatagramBytes);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -1690,6 +2112,8 @@ QuicBindingSend(
     _In_ uint32_t DatagramsToSend
     )
 {
+    QuicProbe3(datapath_send, Binding, DatagramsToSend, BytesToSend);
+
 #if QUIC_TEST_DATAPATH_HOOKS_ENABLED
     QUIC_TEST_DATAPATH_HOOKS* Hooks = MsQuicLib.TestDatapathHooks;
     if (Hooks != NULL) {
@@ -1734,5 +2158,12 @@ QuicBindingHandleDosModeStateChange(
         QUIC_LISTENER* Listener = CXPLAT_CONTAINING_RECORD(ListenerLink, QUIC_LISTENER, Link);
         QuicListenerHandleDosModeStateChange(Listener, DosModeEnabled, FALSE);
     }
+    for (CXPLAT_LIST_ENTRY* ListenerLink = Binding->CibirListenerList.Flink;
+            ListenerLink != &Binding->CibirListenerList;
+            ListenerLink = ListenerLink->Flink) {
+
+        QUIC_LISTENER* Listener = CXPLAT_CONTAINING_RECORD(ListenerLink, QUIC_LISTENER, Link);
+        QuicListenerHandleDosModeStateChange(Listener, DosModeEnabled, FALSE);
+    }
     CxPlatDispatchRwLockReleaseShared(&Binding->RwLock, PrevIrql);
 }
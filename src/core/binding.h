@@ -145,6 +145,12 @@ typedef struct QUIC_RX_PACKET {
     //
     BOOLEAN EncryptedWith0Rtt : 1;
 
+    //
+    // Flag indicating the packet already failed to decrypt, as part of a
+    // batch.
+    //
+    BOOLEAN DecryptFailed : 1;
+
     //
     // Flag indicating the packet couldn't be decrypted yet, because the key
     // isn't available yet, or a stateless operation has been queued; so it is
@@ -166,6 +172,33 @@ typedef struct QUIC_RX_PACKET {
     // Flag indicating the packet contained a non-probing frame.
     //
     BOOLEAN HasNonProbingFrame : 1;
+
+    //
+    // Flag indicating the Initial packet filter requires a Retry for the
+    // packet.
+    //
+    BOOLEAN ForceRetry : 1;
+
+    //
+    // Flag indicating a stream receive buffer references the decrypted
+    // payload in place, so the packet must not be returned to the datapath
+    // until the app completes the receive.
+    //
+    BOOLEAN HeldByStream : 1;
+
+    //
+    // Flag indicating the connection finished processing the packet while it
+    // was still held by a stream, leaving the stream responsible for
+    // returning it to the datapath.
+    //
+    BOOLEAN ReleasedByConnection : 1;
+
+    //
+    // Flag indicating the packet's single STREAM frame was decrypted straight
+    // into the stream's app-owned receive buffer, so its payload isn't in the
+    // packet.
+    //
+    BOOLEAN DecryptedToStream : 1;
     };
     };
 
@@ -255,6 +288,16 @@ typedef struct QUIC_BINDING {
     //
     CXPLAT_LIST_ENTRY Listeners;
 
+    //
+    // The listeners registered with a CIBIR ID. These are kept out of the
+    // Listeners list, and are found by a hash of the ID instead, so that many
+    // per-tenant listeners sharing a port don't make every lookup linear. The
+    // list is only for enumeration; the count is per CIBIR ID length.
+    //
+    CXPLAT_LIST_ENTRY CibirListenerList;
+    CXPLAT_HASHTABLE CibirListeners;
+    uint32_t CibirLengthCounts[QUIC_MAX_CIBIR_LENGTH + 1];
+
     //
     // Lookup tables for connection IDs.
     //
@@ -375,13 +418,15 @@ QuicBindingUnregisterListener(
     );
 
 //
-// Passes the connection to the binding to (possibly) accept it.
+// Passes the connection to the listener (found with QuicBindingGetListener)
+// to (possibly) accept it. Releases the listener's start reference.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicBindingAcceptConnection(
     _In_ QUIC_BINDING* Binding,
     _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_LISTENER* Listener,
     _In_ QUIC_NEW_CONNECTION_INFO* Info
     );
 
@@ -396,6 +441,19 @@ QuicBindingAddSourceConnectionID(
     _In_ QUIC_CID_HASH_ENTRY* SourceCid
     );
 
+//
+// Attempts to insert several of the connection's new source CIDs into the
+// binding's lookup table at once. Returns the number inserted.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+QuicBindingAddSourceConnectionIDs(
+    _In_ QUIC_BINDING* Binding,
+    _In_ uint8_t Count,
+    _In_reads_(Count)
+        QUIC_CID_HASH_ENTRY** SourceCids
+    );
+
 //
 // Removes a single source CID from the binding's lookup table.
 //
@@ -531,13 +589,15 @@ QuicRetryTokenDecrypt(
         CxPlatCopyMemory(Iv, Packet->DestCid, MsQuicLib.CidTotalLength);
     }
 
-    CxPlatDispatchLockAcquire(&Partition->StatelessRetryKeysLock);
-
+    QUIC_PARTITION* ReadPartition;
+    uint32_t ReadEpoch;
     CXPLAT_KEY* StatelessRetryKey =
         QuicPartitionGetStatelessRetryKeyForTimestamp(
-            Partition, (int64_t)Token->Authenticated.Timestamp);
+            Partition,
+            (int64_t)Token->Authenticated.Timestamp,
+            &ReadPartition,
+            &ReadEpoch);
     if (StatelessRetryKey == NULL) {
-        CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
         return FALSE;
     }
 
@@ -550,6 +610,6 @@ QuicRetryTokenDecrypt(
             sizeof(Token->Encrypted) + sizeof(Token->EncryptionTag),
             (uint8_t*)&Token->Encrypted);
 
-    CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
+    QuicLibraryReadEnd(ReadPartition, ReadEpoch);
     return QUIC_SUCCEEDED(Status);
 }
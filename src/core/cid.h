@@ -42,13 +42,22 @@ Abstract:
 #define QUIC_CID_MIN_LENGTH \
     (QUIC_CID_PID_LENGTH + QUIC_CID_PAYLOAD_LENGTH)
 
+//
+// The length of the encrypted block in CIDs generated for the QUIC-LB block
+// cipher mode. It follows the first byte and holds the rest of the server ID,
+// the PID and the payload, padded with random bytes.
+//
+#define QUIC_CID_LB_BLOCK_LENGTH                16
+
 //
 // The maximum length CIDs that MsQuic ever will generate.
 //
 #define QUIC_CID_MAX_LENGTH \
-    (QUIC_MAX_CID_SID_LENGTH + \
-     QUIC_CID_PID_LENGTH + \
-     QUIC_CID_PAYLOAD_LENGTH)
+    (1 + QUIC_CID_LB_BLOCK_LENGTH)
+
+CXPLAT_STATIC_ASSERT(
+    QUIC_MAX_CID_SID_LENGTH + QUIC_CID_PID_LENGTH + QUIC_CID_PAYLOAD_LENGTH <= QUIC_CID_MAX_LENGTH,
+    "MsQuic CID layout must fit in the maximum length");
 
 CXPLAT_STATIC_ASSERT(
     QUIC_CID_MIN_LENGTH >= QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH,
@@ -165,7 +174,6 @@ typedef struct QUIC_CID_LIST_ENTRY {
 
 typedef struct QUIC_CID_HASH_ENTRY {
 
-    CXPLAT_HASHTABLE_ENTRY Entry;
     CXPLAT_SLIST_ENTRY Link;
     QUIC_CONNECTION* Connection;
     QUIC_CID CID;
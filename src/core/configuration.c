@@ -13,6 +13,155 @@ Abstract:
 
 #include "precomp.h"
 
+//
+// Fills in any settings not explicitly set on the configuration from the
+// silo/global settings and the app specific storage.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConfigurationLoadSettings(
+    _In_ QUIC_CONFIGURATION* Configuration,
+    _Inout_ QUIC_SETTINGS_INTERNAL* Settings
+    )
+{
+#ifdef QUIC_SILO
+    if (Configuration->Storage != NULL) {
+        QuicSettingsSetDefault(Settings);
+        QuicSettingsLoad(Settings, Configuration->Storage);
+    } else {
+        QuicSettingsCopy(Settings, QuicLibraryGetSettings());
+    }
+#else
+    QuicSettingsCopy(Settings, QuicLibraryGetSettings());
+#endif
+
+    if (Configuration->AppSpecificStorage != NULL) {
+        QuicSettingsLoad(Settings, Configuration->AppSpecificStorage);
+    }
+
+    QuicSettingsDump(Settings);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConfigurationSettingsFree(
+    _In_ __drv_freesMem(Mem) QUIC_CONFIGURATION_SETTINGS* Snapshot
+    )
+{
+    QuicSettingsCleanup(&Snapshot->Settings);
+    if (Snapshot->ServerTPCache != NULL) {
+        CXPLAT_FREE(Snapshot->ServerTPCache, QUIC_POOL_TP_CACHE);
+    }
+    CXPLAT_FREE(Snapshot, QUIC_POOL_CONFIG_SETTINGS);
+}
+
+//
+// Allocates a new settings snapshot holding a full copy of Source.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_CONFIGURATION_SETTINGS*
+QuicConfigurationSettingsClone(
+    _In_ const QUIC_SETTINGS_INTERNAL* Source
+    )
+{
+    QUIC_CONFIGURATION_SETTINGS* Snapshot =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONFIGURATION_SETTINGS), QUIC_POOL_CONFIG_SETTINGS);
+    if (Snapshot == NULL) {
+        return NULL;
+    }
+    CxPlatZeroMemory(Snapshot, sizeof(QUIC_CONFIGURATION_SETTINGS));
+
+    //
+    // Copy takes every value, Apply then carries over the IsSet flags.
+    //
+    QuicSettingsCopy(&Snapshot->Settings, Source);
+    if (!QuicSettingApply(&Snapshot->Settings, TRUE, TRUE, Source)) {
+        QuicConfigurationSettingsFree(Snapshot);
+        return NULL;
+    }
+
+    return Snapshot;
+}
+
+//
+// Makes the snapshot the current settings. Handshakes that start after this
+// pick it up; existing connections already copied theirs. The previous
+// snapshot may still be in use by a concurrent reader, so it is kept until
+// the configuration is cleaned up.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Requires_lock_held_(Configuration->UpdateLock)
+static
+void
+QuicConfigurationSettingsPublish(
+    _In_ QUIC_CONFIGURATION* Configuration,
+    _In_ QUIC_CONFIGURATION_SETTINGS* Snapshot
+    )
+{
+    CxPlatListInsertTail(&Configuration->SettingsSnapshots, &Snapshot->Link);
+    QuicWritePtrRelease((void**)&Configuration->Settings, &Snapshot->Settings);
+}
+
+//
+// Applies NewSettings on top of a copy of the current settings and publishes
+// the result. Either all of NewSettings takes effect or none of it does.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicConfigurationSettingsUpdate(
+    _In_ QUIC_CONFIGURATION* Configuration,
+    _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    CxPlatLockAcquire(&Configuration->UpdateLock);
+    QUIC_CONFIGURATION_SETTINGS* Snapshot =
+        QuicConfigurationSettingsClone(Configuration->Settings);
+    if (Snapshot == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+    } else if (!QuicSettingApply(&Snapshot->Settings, TRUE, TRUE, NewSettings)) {
+        QuicConfigurationSettingsFree(Snapshot);
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+    } else {
+        QuicConfigurationSettingsPublish(Configuration, Snapshot);
+    }
+    CxPlatLockRelease(&Configuration->UpdateLock);
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConfigurationFreeRetired(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    while (!CxPlatListIsEmpty(&Configuration->SettingsSnapshots)) {
+        QuicConfigurationSettingsFree(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Configuration->SettingsSnapshots),
+                QUIC_CONFIGURATION_SETTINGS,
+                Link));
+    }
+
+    while (!CxPlatListIsEmpty(&Configuration->RetiredSecConfigs)) {
+        QUIC_CONFIGURATION_RETIRED_SEC_CONFIG* Retired =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Configuration->RetiredSecConfigs),
+                QUIC_CONFIGURATION_RETIRED_SEC_CONFIG,
+                Link);
+        if (Retired->SecurityConfig != NULL) {
+            CxPlatTlsSecConfigDelete(Retired->SecurityConfig);
+        }
+        CXPLAT_FREE(Retired, QUIC_POOL_CONFIG_RETIRED);
+    }
+}
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -36,6 +185,7 @@ MsQuicConfigurationOpen(
     uint8_t* AlpnList;
     uint32_t AlpnListLength;
     QUIC_SETTINGS_INTERNAL InternalSettings;
+    QUIC_CONFIGURATION_SETTINGS* Snapshot;
 
 
     if (Handle == NULL ||
@@ -72,6 +222,9 @@ MsQuicConfigurationOpen(
     Configuration->ClientContext = Context;
     Configuration->Registration = Registration;
     CxPlatRefInitialize(&Configuration->RefCount);
+    CxPlatLockInitialize(&Configuration->UpdateLock);
+    CxPlatListInitializeHead(&Configuration->RetiredSecConfigs);
+    CxPlatListInitializeHead(&Configuration->SettingsSnapshots);
 #if DEBUG
     CxPlatRefInitializeMultiple(Configuration->RefTypeBiasedCount, QUIC_CONF_REF_COUNT);
     CxPlatRefIncrement(&Configuration->RefTypeBiasedCount[QUIC_CONF_REF_HANDLE]);
@@ -152,6 +305,16 @@ MsQuicConfigurationOpen(
         }
     }
 
+    Snapshot =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONFIGURATION_SETTINGS), QUIC_POOL_CONFIG_SETTINGS);
+    if (Snapshot == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    CxPlatZeroMemory(Snapshot, sizeof(QUIC_CONFIGURATION_SETTINGS));
+    CxPlatListInsertTail(&Configuration->SettingsSnapshots, &Snapshot->Link);
+    Configuration->Settings = &Snapshot->Settings;
+
     if (Settings != NULL && Settings->IsSetFlags != 0) {
         Status =
             QuicSettingsSettingsToInternal(
@@ -162,7 +325,7 @@ MsQuicConfigurationOpen(
             goto Error;
         }
         if (!QuicSettingApply(
-                &Configuration->Settings,
+                Configuration->Settings,
                 TRUE,
                 TRUE,
                 &InternalSettings)) {
@@ -172,7 +335,7 @@ MsQuicConfigurationOpen(
     }
 
 
-    QuicConfigurationSettingsChanged(Configuration);
+    QuicConfigurationLoadSettings(Configuration, Configuration->Settings);
 
     BOOLEAN Result = QuicRegistrationRundownAcquire(Registration, QUIC_REG_REF_CONFIGURATION);
     CXPLAT_FRE_ASSERT(Result);
@@ -197,6 +360,8 @@ Error:
 #if DEBUG
         QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_CONFIGURATION, &Configuration->DbgObjectLink);
 #endif
+        QuicConfigurationFreeRetired(Configuration);
+        CxPlatLockUninitialize(&Configuration->UpdateLock);
         CXPLAT_FREE(Configuration, QUIC_POOL_CONFIG);
     }
 
@@ -231,7 +396,8 @@ QuicConfigurationUninitialize(
     QuicProcessRelease(Configuration->OwningProcess);
 #endif
 
-    QuicSettingsCleanup(&Configuration->Settings);
+    QuicConfigurationFreeRetired(Configuration);
+    CxPlatLockUninitialize(&Configuration->UpdateLock);
 
     QuicRegistrationRundownRelease(Configuration->Registration, QUIC_REG_REF_CONFIGURATION);
 
@@ -277,13 +443,49 @@ MsQuicConfigurationLoadCredentialComplete(
     CXPLAT_DBG_ASSERT(Configuration != NULL);
     CXPLAT_DBG_ASSERT(CredConfig != NULL);
 
+    //
+    // Claim the retire entry reserved by MsQuicConfigurationLoadCredential.
+    //
+    QUIC_CONFIGURATION_RETIRED_SEC_CONFIG* Retired = NULL;
+    CxPlatLockAcquire(&Configuration->UpdateLock);
+    for (CXPLAT_LIST_ENTRY* Entry = Configuration->RetiredSecConfigs.Flink;
+        Entry != &Configuration->RetiredSecConfigs;
+        Entry = Entry->Flink) {
+        QUIC_CONFIGURATION_RETIRED_SEC_CONFIG* Temp =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONFIGURATION_RETIRED_SEC_CONFIG, Link);
+        if (Temp->SecurityConfig == NULL) {
+            Retired = Temp;
+            break;
+        }
+    }
+    CXPLAT_DBG_ASSERT(Retired != NULL);
+
     if (QUIC_SUCCEEDED(Status)) {
         CXPLAT_DBG_ASSERT(SecurityConfig);
-        Configuration->SecurityConfig = SecurityConfig;
+        //
+        // Publish the new credentials for new handshakes. Connections already
+        // using the previous security config keep it, so it is retired rather
+        // than deleted.
+        //
+        CXPLAT_SEC_CONFIG* PrevSecurityConfig = Configuration->SecurityConfig;
+        QuicWritePtrRelease((void**)&Configuration->SecurityConfig, SecurityConfig);
+        if (PrevSecurityConfig != NULL && Retired != NULL) {
+            Retired->SecurityConfig = PrevSecurityConfig;
+            Retired = NULL;
+        }
     } else {
         CXPLAT_DBG_ASSERT(SecurityConfig == NULL);
     }
 
+    if (Retired != NULL) {
+        CxPlatListEntryRemove(&Retired->Link);
+    }
+    CxPlatLockRelease(&Configuration->UpdateLock);
+
+    if (Retired != NULL) {
+        CXPLAT_FREE(Retired, QUIC_POOL_CONFIG_RETIRED);
+    }
+
     if (CredConfig->Flags & QUIC_CREDENTIAL_FLAG_LOAD_ASYNCHRONOUS) {
         CXPLAT_DBG_ASSERT(CredConfig->AsyncHandler != NULL);
         CredConfig->AsyncHandler(
@@ -294,6 +496,179 @@ MsQuicConfigurationLoadCredentialComplete(
     }
 }
 
+//
+// Returns the space needed to copy the (optional) string.
+//
+static
+size_t
+QuicCredentialLoadStringSize(
+    _In_opt_z_ const char* String
+    )
+{
+    return String == NULL ? 0 : strlen(String) + 1;
+}
+
+//
+// Copies the (optional) string to the cursor and advances it.
+//
+static
+const char*
+QuicCredentialLoadCopyString(
+    _In_opt_z_ const char* String,
+    _Inout_ uint8_t** Cursor
+    )
+{
+    if (String == NULL) {
+        return NULL;
+    }
+    const size_t Size = strlen(String) + 1;
+    char* Copy = (char*)*Cursor;
+    CxPlatCopyMemory(Copy, String, Size);
+    *Cursor += Size;
+    return Copy;
+}
+
+//
+// Tries to queue an asynchronous credential load to a TLS offload thread.
+// Only done for the TLS providers that otherwise create the security config
+// inline, and for credentials that have to be parsed. Returns FALSE if the
+// load wasn't queued and should be done inline instead.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicConfigurationQueueCredentialLoad(
+    _In_ QUIC_CONFIGURATION* Configuration,
+    _In_ const QUIC_CREDENTIAL_CONFIG* CredConfig,
+    _In_ CXPLAT_TLS_CREDENTIAL_FLAGS TlsCredFlags
+    )
+{
+    if (!(CredConfig->Flags & QUIC_CREDENTIAL_FLAG_LOAD_ASYNCHRONOUS) ||
+        CredConfig->AsyncHandler == NULL ||
+        CxPlatTlsGetProvider() == QUIC_TLS_PROVIDER_SCHANNEL) {
+        return FALSE;
+    }
+
+    size_t Size =
+        sizeof(QUIC_CREDENTIAL_LOAD) +
+        QuicCredentialLoadStringSize(CredConfig->Principal) +
+        QuicCredentialLoadStringSize(CredConfig->CaCertificateFile);
+    switch (CredConfig->Type) {
+    case QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE:
+        if (CredConfig->CertificateFile == NULL) {
+            return FALSE;
+        }
+        Size +=
+            QuicCredentialLoadStringSize(CredConfig->CertificateFile->PrivateKeyFile) +
+            QuicCredentialLoadStringSize(CredConfig->CertificateFile->CertificateFile);
+        break;
+    case QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED:
+        if (CredConfig->CertificateFileProtected == NULL) {
+            return FALSE;
+        }
+        Size +=
+            QuicCredentialLoadStringSize(CredConfig->CertificateFileProtected->PrivateKeyFile) +
+            QuicCredentialLoadStringSize(CredConfig->CertificateFileProtected->CertificateFile) +
+            QuicCredentialLoadStringSize(CredConfig->CertificateFileProtected->PrivateKeyPassword);
+        break;
+    case QUIC_CREDENTIAL_TYPE_CERTIFICATE_PKCS12:
+        if (CredConfig->CertificatePkcs12 == NULL ||
+            CredConfig->CertificatePkcs12->Asn1Blob == NULL) {
+            return FALSE;
+        }
+        Size +=
+            CredConfig->CertificatePkcs12->Asn1BlobLength +
+            QuicCredentialLoadStringSize(CredConfig->CertificatePkcs12->PrivateKeyPassword);
+        break;
+    default:
+        return FALSE; // Nothing worth offloading.
+    }
+
+    if (QUIC_FAILED(QuicLibraryStartTlsOffload())) {
+        return FALSE;
+    }
+
+    QUIC_CREDENTIAL_LOAD* Load = CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_CREDENTIAL_LOAD);
+    if (Load == NULL) {
+        return FALSE;
+    }
+
+    uint8_t* Cursor = (uint8_t*)(Load + 1);
+    Load->Configuration = Configuration;
+    Load->TlsCredFlags = TlsCredFlags;
+    Load->CredConfig = *CredConfig;
+    Load->CredConfig.Principal =
+        QuicCredentialLoadCopyString(CredConfig->Principal, &Cursor);
+    Load->CredConfig.CaCertificateFile =
+        QuicCredentialLoadCopyString(CredConfig->CaCertificateFile, &Cursor);
+
+    if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE) {
+        Load->CertificateFile.PrivateKeyFile =
+            QuicCredentialLoadCopyString(CredConfig->CertificateFile->PrivateKeyFile, &Cursor);
+        Load->CertificateFile.CertificateFile =
+            QuicCredentialLoadCopyString(CredConfig->CertificateFile->CertificateFile, &Cursor);
+        Load->CredConfig.CertificateFile = &Load->CertificateFile;
+
+    } else if (CredConfig->Type == QUIC_CREDENTIAL_TYPE_CERTIFICATE_FILE_PROTECTED) {
+        Load->CertificateFileProtected.PrivateKeyFile =
+            QuicCredentialLoadCopyString(CredConfig->CertificateFileProtected->PrivateKeyFile, &Cursor);
+        Load->CertificateFileProtected.CertificateFile =
+            QuicCredentialLoadCopyString(CredConfig->CertificateFileProtected->CertificateFile, &Cursor);
+        Load->CertificateFileProtected.PrivateKeyPassword =
+            QuicCredentialLoadCopyString(CredConfig->CertificateFileProtected->PrivateKeyPassword, &Cursor);
+        Load->CredConfig.CertificateFileProtected = &Load->CertificateFileProtected;
+
+    } else {
+        CxPlatCopyMemory(
+            Cursor,
+            CredConfig->CertificatePkcs12->Asn1Blob,
+            CredConfig->CertificatePkcs12->Asn1BlobLength);
+        Load->CertificatePkcs12.Asn1Blob = Cursor;
+        Load->CertificatePkcs12.Asn1BlobLength = CredConfig->CertificatePkcs12->Asn1BlobLength;
+        Cursor += CredConfig->CertificatePkcs12->Asn1BlobLength;
+        Load->CertificatePkcs12.PrivateKeyPassword =
+            QuicCredentialLoadCopyString(CredConfig->CertificatePkcs12->PrivateKeyPassword, &Cursor);
+        Load->CredConfig.CertificatePkcs12 = &Load->CertificatePkcs12;
+    }
+    CXPLAT_DBG_ASSERT(Cursor == (uint8_t*)Load + Size);
+
+    QuicLibraryQueueCredentialLoad(&Load->Link);
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConfigurationProcessCredentialLoad(
+    _In_ QUIC_CREDENTIAL_LOAD* Load
+    )
+{
+    QUIC_STATUS Status =
+        CxPlatTlsSecConfigCreate(
+            &Load->CredConfig,
+            Load->TlsCredFlags,
+            &QuicTlsCallbacks,
+            Load->Configuration,
+            MsQuicConfigurationLoadCredentialComplete);
+    if (QUIC_FAILED(Status)) {
+        //
+        // The TLS provider rejected the credentials without completing the
+        // load, so complete it here to indicate the failure to the app.
+        //
+        MsQuicConfigurationLoadCredentialComplete(
+            &Load->CredConfig,
+            Load->Configuration,
+            Status,
+            NULL);
+    }
+
+    //
+    // The completion has run, so the copied credential config isn't needed
+    // anymore.
+    //
+    CXPLAT_FREE(Load, QUIC_POOL_CREDENTIAL_LOAD);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QUIC_API
@@ -313,28 +688,69 @@ MsQuicConfigurationLoadCredential(
         QUIC_CONFIGURATION* Configuration = (QUIC_CONFIGURATION*)Handle;
         CXPLAT_TLS_CREDENTIAL_FLAGS TlsCredFlags = CXPLAT_TLS_CREDENTIAL_FLAG_NONE;
         if (!(CredConfig->Flags & QUIC_CREDENTIAL_FLAG_CLIENT) &&
-            Configuration->Settings.ServerResumptionLevel == QUIC_SERVER_NO_RESUME) {
+            QuicConfigurationGetSettings(Configuration)->ServerResumptionLevel == QUIC_SERVER_NO_RESUME) {
             TlsCredFlags |= CXPLAT_TLS_CREDENTIAL_FLAG_DISABLE_RESUMPTION;
         }
 
+        if (CredConfig->Flags & QUIC_CREDENTIAL_FLAG_OFFLOAD_HANDSHAKE) {
+            if (CredConfig->Flags & QUIC_CREDENTIAL_FLAG_CLIENT) {
+                goto Error;
+            }
+            if (CxPlatTlsGetProvider() != QUIC_TLS_PROVIDER_OPENSSL) {
+                Status = QUIC_STATUS_NOT_SUPPORTED;
+                goto Error;
+            }
+            Status = QuicLibraryStartTlsOffload();
+            if (QUIC_FAILED(Status)) {
+                goto Error;
+            }
+            Configuration->OffloadHandshake = TRUE;
+        }
+
+        //
+        // Loading credentials again replaces the current ones. Reserve the
+        // entry the replaced security config is retired into up front, so the
+        // completion can't fail after the new config was created.
+        //
+        QUIC_CONFIGURATION_RETIRED_SEC_CONFIG* Retired =
+            CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONFIGURATION_RETIRED_SEC_CONFIG), QUIC_POOL_CONFIG_RETIRED);
+        if (Retired == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Error;
+        }
+        Retired->SecurityConfig = NULL;
+        CxPlatLockAcquire(&Configuration->UpdateLock);
+        CxPlatListInsertTail(&Configuration->RetiredSecConfigs, &Retired->Link);
+        CxPlatLockRelease(&Configuration->UpdateLock);
+
         QuicConfigurationAddRef(Configuration, QUIC_CONF_REF_LOAD_CRED);
 
-        Status =
-            CxPlatTlsSecConfigCreate(
-                CredConfig,
-                TlsCredFlags,
-                &QuicTlsCallbacks,
-                Configuration,
-                MsQuicConfigurationLoadCredentialComplete);
-        if (!(CredConfig->Flags & QUIC_CREDENTIAL_FLAG_LOAD_ASYNCHRONOUS) ||
-            QUIC_FAILED(Status)) {
+        if (QuicConfigurationQueueCredentialLoad(Configuration, CredConfig, TlsCredFlags)) {
             //
-            // Release ref for synchronous calls or asynchronous failures.
+            // Parsing the credentials and creating the TLS context happen on a
+            // TLS offload thread, which completes the load.
             //
-            QuicConfigurationRelease(Configuration, QUIC_CONF_REF_LOAD_CRED);
+            Status = QUIC_STATUS_PENDING;
+
+        } else {
+            Status =
+                CxPlatTlsSecConfigCreate(
+                    CredConfig,
+                    TlsCredFlags,
+                    &QuicTlsCallbacks,
+                    Configuration,
+                    MsQuicConfigurationLoadCredentialComplete);
+            if (!(CredConfig->Flags & QUIC_CREDENTIAL_FLAG_LOAD_ASYNCHRONOUS) ||
+                QUIC_FAILED(Status)) {
+                //
+                // Release ref for synchronous calls or asynchronous failures.
+                //
+                QuicConfigurationRelease(Configuration, QUIC_CONF_REF_LOAD_CRED);
+            }
         }
     }
 
+Error:
 
     return Status;
 }
@@ -355,22 +771,14 @@ QuicConfigurationSettingsChanged(
     _Inout_ QUIC_CONFIGURATION* Configuration
     )
 {
-#ifdef QUIC_SILO
-    if (Configuration->Storage != NULL) {
-        QuicSettingsSetDefault(&Configuration->Settings);
-        QuicSettingsLoad(&Configuration->Settings, Configuration->Storage);
-    } else {
-        QuicSettingsCopy(&Configuration->Settings, &MsQuicLib.Settings);
-    }
-#else
-    QuicSettingsCopy(&Configuration->Settings, &MsQuicLib.Settings);
-#endif
-
-    if (Configuration->AppSpecificStorage != NULL) {
-        QuicSettingsLoad(&Configuration->Settings, Configuration->AppSpecificStorage);
+    CxPlatLockAcquire(&Configuration->UpdateLock);
+    QUIC_CONFIGURATION_SETTINGS* Snapshot =
+        QuicConfigurationSettingsClone(Configuration->Settings);
+    if (Snapshot != NULL) {
+        QuicConfigurationLoadSettings(Configuration, &Snapshot->Settings);
+        QuicConfigurationSettingsPublish(Configuration, Snapshot);
     }
-
-    QuicSettingsDump(&Configuration->Settings);
+    CxPlatLockRelease(&Configuration->UpdateLock);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -383,11 +791,13 @@ QuicConfigurationParamGet(
         void* Buffer
     )
 {
+    const QUIC_SETTINGS_INTERNAL* Settings = QuicConfigurationGetSettings(Configuration);
+
     if (Param == QUIC_PARAM_CONFIGURATION_SETTINGS) {
-        return QuicSettingsGetSettings(&Configuration->Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
+        return QuicSettingsGetSettings(Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
     }
     if (Param == QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS) {
-        return QuicSettingsGetVersionSettings(&Configuration->Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
+        return QuicSettingsGetVersionSettings(Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
     }
     if (Param  == QUIC_PARAM_CONFIGURATION_VERSION_NEG_ENABLED) {
 
@@ -401,7 +811,7 @@ QuicConfigurationParamGet(
         }
 
         *BufferLength = sizeof(BOOLEAN);
-        *(BOOLEAN*)Buffer = Configuration->Settings.VersionNegotiationExtEnabled;
+        *(BOOLEAN*)Buffer = Settings->VersionNegotiationExtEnabled;
 
         return QUIC_STATUS_SUCCESS;
     }
@@ -439,15 +849,7 @@ QuicConfigurationParamSet(
             return Status;
         }
 
-        if (!QuicSettingApply(
-                &Configuration->Settings,
-                TRUE,
-                TRUE,
-                &InternalSettings)) {
-            return QUIC_STATUS_INVALID_PARAMETER;
-        }
-
-        return QUIC_STATUS_SUCCESS;
+        return QuicConfigurationSettingsUpdate(Configuration, &InternalSettings);
 
     case QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS:
 
@@ -465,34 +867,29 @@ QuicConfigurationParamSet(
             return Status;
         }
 
-        if (!QuicSettingApply(
-                &Configuration->Settings,
-                TRUE,
-                TRUE,
-                &InternalSettings)) {
-            QuicSettingsCleanup(&InternalSettings);
-            return QUIC_STATUS_INVALID_PARAMETER;
-        }
+        Status = QuicConfigurationSettingsUpdate(Configuration, &InternalSettings);
         QuicSettingsCleanup(&InternalSettings);
 
-        return QUIC_STATUS_SUCCESS;
+        return Status;
 
-    case QUIC_PARAM_CONFIGURATION_TICKET_KEYS:
+    case QUIC_PARAM_CONFIGURATION_TICKET_KEYS: {
 
         if (Buffer == NULL ||
             BufferLength < sizeof(QUIC_TICKET_KEY_CONFIG)) {
             return QUIC_STATUS_INVALID_PARAMETER;
         }
 
-        if (Configuration->SecurityConfig == NULL) {
+        CXPLAT_SEC_CONFIG* SecurityConfig = QuicConfigurationGetSecurityConfig(Configuration);
+        if (SecurityConfig == NULL) {
             return QUIC_STATUS_INVALID_STATE;
         }
 
         return
             CxPlatTlsSecConfigSetTicketKeys(
-                Configuration->SecurityConfig,
+                SecurityConfig,
                 (QUIC_TICKET_KEY_CONFIG*)Buffer,
                 (uint8_t)(BufferLength / sizeof(QUIC_TICKET_KEY_CONFIG)));
+    }
 
     case QUIC_PARAM_CONFIGURATION_VERSION_NEG_ENABLED:
 
@@ -501,17 +898,17 @@ QuicConfigurationParamSet(
             return QUIC_STATUS_INVALID_PARAMETER;
         }
 
-        Configuration->Settings.IsSet.VersionNegotiationExtEnabled = TRUE;
-        Configuration->Settings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
+        InternalSettings.IsSet.VersionNegotiationExtEnabled = TRUE;
+        InternalSettings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
 
-        return QUIC_STATUS_SUCCESS;
+        return QuicConfigurationSettingsUpdate(Configuration, &InternalSettings);
 
 #ifdef WIN32
     case QUIC_PARAM_CONFIGURATION_SCHANNEL_CREDENTIAL_ATTRIBUTE_W:
 
         return
             CxPlatSecConfigParamSet(
-                Configuration->SecurityConfig,
+                QuicConfigurationGetSecurityConfig(Configuration),
                 Param,
                 BufferLength,
                 Buffer);
@@ -15,10 +15,86 @@ typedef enum QUIC_CONFIGURATION_REF {
     QUIC_CONF_REF_LOAD_CRED,
     QUIC_CONF_REF_CONN_START_OP,
     QUIC_CONF_REF_CONN_SET_OP,
+    QUIC_CONF_REF_CONN_POOL,
 
     QUIC_CONF_REF_COUNT
 } QUIC_CONFIGURATION_REF;
 
+//
+// An immutable snapshot of a configuration's settings. Settings updates build
+// a new snapshot and publish it, so readers never observe a partial update.
+//
+typedef struct QUIC_CONFIGURATION_SETTINGS {
+
+    //
+    // Link in the configuration's SettingsSnapshots list.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    QUIC_SETTINGS_INTERNAL Settings;
+
+    //
+    // The server transport parameters derived from these settings, encoded
+    // once by the first handshake that uses them.
+    //
+    QUIC_TP_ENCODE_CACHE* ServerTPCache;
+
+} QUIC_CONFIGURATION_SETTINGS;
+
+//
+// A security configuration replaced by a credential reload. Connections that
+// were created from it still reference it, so it lives until the
+// configuration is cleaned up.
+//
+typedef struct QUIC_CONFIGURATION_RETIRED_SEC_CONFIG {
+
+    //
+    // Link in the configuration's RetiredSecConfigs list.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // NULL while the entry is reserved for an in-progress credential load.
+    //
+    CXPLAT_SEC_CONFIG* SecurityConfig;
+
+} QUIC_CONFIGURATION_RETIRED_SEC_CONFIG;
+
+//
+// An asynchronous credential load, run on a TLS offload thread so parsing
+// the certificate and key and creating the TLS context don't block the
+// caller. It holds a private copy of the app's credential config.
+//
+typedef struct QUIC_CREDENTIAL_LOAD {
+
+    //
+    // Link in the library's credential load queue.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // The configuration the credentials are loaded for.
+    //
+    QUIC_CONFIGURATION* Configuration;
+
+    //
+    // TLS credential flags derived from the configuration's settings.
+    //
+    CXPLAT_TLS_CREDENTIAL_FLAGS TlsCredFlags;
+
+    //
+    // The copied credential config. The certificate description and strings
+    // it points to are copied into the same allocation.
+    //
+    QUIC_CREDENTIAL_CONFIG CredConfig;
+    union {
+        QUIC_CERTIFICATE_FILE CertificateFile;
+        QUIC_CERTIFICATE_FILE_PROTECTED CertificateFileProtected;
+        QUIC_CERTIFICATE_PKCS12 CertificatePkcs12;
+    };
+
+} QUIC_CREDENTIAL_LOAD;
+
 //
 // Represents a set of TLS and QUIC configurations and settings.
 //
@@ -62,10 +138,33 @@ typedef struct QUIC_CONFIGURATION {
 #endif
 
     //
-    // The TLS security configurations.
+    // The TLS security configurations. Replaced atomically when credentials
+    // are reloaded; read via QuicConfigurationGetSecurityConfig.
     //
     CXPLAT_SEC_CONFIG* SecurityConfig;
 
+    //
+    // Serializes credential and settings updates and protects the
+    // RetiredSecConfigs and SettingsSnapshots lists. Never held by readers.
+    //
+    CXPLAT_LOCK UpdateLock;
+
+    //
+    // Security configurations replaced by credential reloads.
+    //
+    CXPLAT_LIST_ENTRY RetiredSecConfigs;
+
+    //
+    // All settings snapshots ever published, the current one included.
+    //
+    CXPLAT_LIST_ENTRY SettingsSnapshots;
+
+    //
+    // Indicates server handshakes should be processed on the TLS offload
+    // threads instead of the connection's worker.
+    //
+    BOOLEAN OffloadHandshake;
+
 #ifdef QUIC_COMPARTMENT_ID
     //
     // The network compartment ID.
@@ -94,9 +193,10 @@ typedef struct QUIC_CONFIGURATION {
     CXPLAT_STORAGE* AppSpecificStorage;
 
     //
-    // Configurable (app & registry) settings.
+    // Configurable (app & registry) settings. Points to the current snapshot;
+    // read via QuicConfigurationGetSettings.
     //
-    QUIC_SETTINGS_INTERNAL Settings;
+    QUIC_SETTINGS_INTERNAL* Settings;
 
     uint16_t AlpnListLength;
     uint8_t AlpnList[0];
@@ -168,6 +268,61 @@ QuicConfigurationRelease(
     }
 }
 
+//
+// Returns the current security configuration. Lock free; the returned config
+// stays valid for as long as the caller holds a reference on the configuration.
+//
+QUIC_INLINE
+CXPLAT_SEC_CONFIG*
+QuicConfigurationGetSecurityConfig(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    return (CXPLAT_SEC_CONFIG*)QuicReadPtrAcquire((void**)&Configuration->SecurityConfig);
+}
+
+//
+// Returns the current settings snapshot. Lock free; the snapshot is immutable
+// and stays valid for as long as the caller holds a reference on the
+// configuration.
+//
+QUIC_INLINE
+const QUIC_SETTINGS_INTERNAL*
+QuicConfigurationGetSettings(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    return (const QUIC_SETTINGS_INTERNAL*)QuicReadPtrAcquire((void**)&Configuration->Settings);
+}
+
+//
+// Returns the server transport parameter encoding cache of the current
+// settings snapshot.
+//
+QUIC_INLINE
+QUIC_TP_ENCODE_CACHE**
+QuicConfigurationGetServerTPCache(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    QUIC_CONFIGURATION_SETTINGS* Snapshot =
+        CXPLAT_CONTAINING_RECORD(
+            (QUIC_SETTINGS_INTERNAL*)QuicConfigurationGetSettings(Configuration),
+            QUIC_CONFIGURATION_SETTINGS,
+            Settings);
+    return &Snapshot->ServerTPCache;
+}
+
+//
+// Creates the TLS security config for a queued credential load and completes
+// it. Called on a TLS offload thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConfigurationProcessCredentialLoad(
+    _In_ QUIC_CREDENTIAL_LOAD* Load
+    );
+
 //
 // Tracing rundown for the configuration.
 //
@@ -33,5 +33,28 @@ QuicCongestionControlInitialize(
     case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
         BbrCongestionControlInitialize(Cc, Settings);
         break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3:
+        Bbr3CongestionControlInitialize(Cc, Settings);
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE:
+        PragueCongestionControlInitialize(Cc, Settings);
+        break;
+    case QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM: {
+        //
+        // The custom controller is the one set on the connection's
+        // registration. Until the connection is registered, or if there is no
+        // such controller (or it fails to create its state), fall back to the
+        // default algorithm.
+        //
+        const QUIC_REGISTRATION* Registration =
+            QuicCongestionControlGetConnection(Cc)->Registration;
+        if (Registration == NULL ||
+            Registration->CongestionControl.Create == NULL ||
+            !CustomCongestionControlInitialize(
+                Cc, Settings, &Registration->CongestionControl)) {
+            CubicCongestionControlInitialize(Cc, Settings);
+        }
+        break;
+    }
     }
 }
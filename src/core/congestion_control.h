@@ -6,7 +6,10 @@
 --*/
 
 #include "bbr.h"
+#include "bbr3.h"
 #include "cubic.h"
+#include "custom_cc.h"
+#include "prague.h"
 
 typedef struct QUIC_ACK_EVENT {
 
@@ -73,8 +76,18 @@ typedef struct QUIC_ECN_EVENT {
 
     uint64_t LargestSentPacketNumber;
 
+    //
+    // Number of packets newly reported as CE marked by the peer.
+    //
+    uint32_t NewCePackets;
+
 } QUIC_ECN_EVENT;
 
+//
+// Defined below; the careful resume callback needs it first.
+//
+struct QUIC_CONN_CAREFUL_RESUME_V1;
+
 typedef struct QUIC_CONGESTION_CONTROL {
 
     //
@@ -82,6 +95,12 @@ typedef struct QUIC_CONGESTION_CONTROL {
     //
     const char* Name;
 
+    //
+    // TRUE if the algorithm is an L4S (RFC 9331) scalable congestion
+    // controller, in which case packets are marked ECT(1) instead of ECT(0).
+    //
+    BOOLEAN IsL4S;
+
     BOOLEAN (*QuicCongestionControlCanSend)(
         _In_ struct QUIC_CONGESTION_CONTROL* Cc
         );
@@ -102,6 +121,10 @@ typedef struct QUIC_CONGESTION_CONTROL {
         _In_ BOOLEAN TimeSinceLastSendValid
         );
 
+    uint64_t (*QuicCongestionControlGetPacingRate)(
+        _In_ const struct QUIC_CONGESTION_CONTROL* Cc
+        );
+
     void (*QuicCongestionControlOnDataSent)(
         _In_ struct QUIC_CONGESTION_CONTROL* Cc,
         _In_ uint32_t NumRetransmittableBytes
@@ -143,6 +166,10 @@ typedef struct QUIC_CONGESTION_CONTROL {
         _In_ const struct QUIC_CONGESTION_CONTROL* Cc
         );
 
+    uint64_t (*QuicCongestionControlGetBandwidthDelayProduct)(
+        _In_ const struct QUIC_CONGESTION_CONTROL* Cc
+        );
+
     uint32_t (*QuicCongestionControlGetCongestionWindow)(
         _In_ const struct QUIC_CONGESTION_CONTROL* Cc
         );
@@ -161,12 +188,31 @@ typedef struct QUIC_CONGESTION_CONTROL {
         _Out_ struct QUIC_NETWORK_STATISTICS* NetworkStatistics
         );
 
+    //
+    // Optional. Releases any resources the algorithm holds.
+    //
+    void (*QuicCongestionControlUninitialize)(
+        _In_ struct QUIC_CONGESTION_CONTROL* Cc
+        );
+
+    //
+    // Optional. Supplies what an earlier connection learned about the path,
+    // for careful resume.
+    //
+    void (*QuicCongestionControlSetCarefulResume)(
+        _In_ struct QUIC_CONGESTION_CONTROL* Cc,
+        _In_ const struct QUIC_CONN_CAREFUL_RESUME_V1* State
+        );
+
     //
     // Algorithm specific state.
     //
     union {
         QUIC_CONGESTION_CONTROL_CUBIC Cubic;
         QUIC_CONGESTION_CONTROL_BBR Bbr;
+        QUIC_CONGESTION_CONTROL_BBR3 Bbr3;
+        QUIC_CONGESTION_CONTROL_PRAGUE Prague;
+        QUIC_CONGESTION_CONTROL_CUSTOM Custom;
     };
 
 } QUIC_CONGESTION_CONTROL;
@@ -217,6 +263,42 @@ QuicCongestionControlInitialize(
     _In_ const QUIC_SETTINGS_INTERNAL* Settings
     );
 
+//
+// Releases the algorithm's resources. Must be called before the congestion
+// control is initialized again or freed.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicCongestionControlUninitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    if (Cc->QuicCongestionControlUninitialize) {
+        Cc->QuicCongestionControlUninitialize(Cc);
+        Cc->QuicCongestionControlUninitialize = NULL;
+    }
+}
+
+//
+// Supplies the state saved from an earlier connection over the same path. If
+// the algorithm supports careful resume, it may jump to (a part of) the saved
+// window once it has confirmed the path looks the same. Must be called before
+// any data is acknowledged.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicCongestionControlSetCarefulResume(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_CONN_CAREFUL_RESUME_STATE* State
+    )
+{
+    if (Cc->QuicCongestionControlSetCarefulResume) {
+        Cc->QuicCongestionControlSetCarefulResume(Cc, State);
+    }
+}
+
 //
 // Returns TRUE if more bytes can be sent on the network.
 //
@@ -267,6 +349,20 @@ QuicCongestionControlGetSendAllowance(
     return Cc->QuicCongestionControlGetSendAllowance(Cc, TimeSinceLastSend, TimeSinceLastSendValid);
 }
 
+//
+// Returns the rate (in bytes per second) sends should currently be paced at,
+// or 0 if sends aren't being paced.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicCongestionControlGetPacingRate(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->QuicCongestionControlGetPacingRate(Cc);
+}
+
 //
 // Called when any retransmittable data is sent.
 //
@@ -340,6 +436,20 @@ QuicCongestionControlOnEcn(
     }
 }
 
+//
+// Returns the ECN codepoint to mark packets with, once the path is known to
+// be ECN capable.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+CXPLAT_ECN_TYPE
+QuicCongestionControlGetEct(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    return Cc->IsL4S ? CXPLAT_ECN_ECT_1 : CXPLAT_ECN_ECT_0;
+}
+
 //
 // Called when all recently considered lost data was actually acknowledged.
 //
@@ -383,6 +493,23 @@ QuicCongestionControlGetBytesInFlightMax(
     return Cc->QuicCongestionControlGetBytesInFlightMax(Cc);
 }
 
+//
+// Returns the algorithm's estimate of the bytes needed in flight to fill the
+// path, or 0 if it doesn't have one.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicCongestionControlGetBandwidthDelayProduct(
+    _In_ const QUIC_CONGESTION_CONTROL* Cc
+    )
+{
+    if (Cc->QuicCongestionControlGetBandwidthDelayProduct) {
+        return Cc->QuicCongestionControlGetBandwidthDelayProduct(Cc);
+    }
+    return 0;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
 uint32_t
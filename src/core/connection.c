@@ -77,8 +77,8 @@ QuicConnAlloc(
     CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
     Connection->Partition = Partition;
 
-#if DEBUG
     InterlockedIncrement(&MsQuicLib.ConnectionCount);
+#if DEBUG
     QuicLibraryTrackDbgObject(QUIC_DBG_OBJECT_TYPE_CONNECTION, &Connection->DbgObjectLink);
 #endif
     QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_CREATED);
@@ -97,15 +97,19 @@ QuicConnAlloc(
     Connection->State.ShareBinding = IsServer;
     Connection->State.FixedBit = TRUE;
     Connection->Stats.Timing.Start = CxPlatTimeUs64();
+    QuicQlogInitialize(Connection);
     Connection->SourceCidLimit = QUIC_ACTIVE_CONNECTION_ID_LIMIT;
     Connection->AckDelayExponent = QUIC_ACK_DELAY_EXPONENT;
     Connection->PacketTolerance = QUIC_MIN_ACK_SEND_NUMBER;
     Connection->PeerPacketTolerance = QUIC_MIN_ACK_SEND_NUMBER;
     Connection->ReorderingThreshold = QUIC_MIN_REORDERING_THRESHOLD;
     Connection->PeerReorderingThreshold = QUIC_MIN_REORDERING_THRESHOLD;
+    Connection->SchedulingWeight = QUIC_DEFAULT_CONN_SCHEDULING_WEIGHT;
     Connection->PeerTransportParams.AckDelayExponent = QUIC_TP_ACK_DELAY_EXPONENT_DEFAULT;
     Connection->ReceiveQueueTail = &Connection->ReceiveQueue;
-    QuicSettingsCopy(&Connection->Settings, &MsQuicLib.Settings);
+    Connection->FlushRecvOper.Type = QUIC_OPER_TYPE_FLUSH_RECV;
+    Connection->FlushRecvOper.FreeAfterProcess = FALSE;
+    QuicSettingsCopy(&Connection->Settings, QuicLibraryGetSettings());
     Connection->Settings.IsSetFlags = 0; // Just grab the global values, not IsSet flags.
     CxPlatDispatchLockInitialize(&Connection->ReceiveQueueLock);
     CxPlatListInitializeHead(&Connection->DestCids);
@@ -120,15 +124,26 @@ QuicConnAlloc(
         QUIC_MAX_RANGE_DECODE_ACKS,
         &Connection->DecodedAckRanges);
 
-    for (uint32_t i = 0; i < ARRAYSIZE(Connection->Packets); i++) {
-        Status =
-            QuicPacketSpaceInitialize(
-                Connection,
-                (QUIC_ENCRYPT_LEVEL)i,
-                &Connection->Packets[i]);
-        if (QUIC_FAILED(Status)) {
-            goto Error;
-        }
+    Connection->HandshakeState = CxPlatPoolAlloc(&Partition->HandshakeStatePool);
+    if (Connection->HandshakeState == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    CxPlatZeroMemory(Connection->HandshakeState, sizeof(QUIC_CONN_HANDSHAKE_STATE));
+
+    //
+    // Only the Initial packet space is allocated up front. The others are
+    // allocated once they are needed (see QuicConnEnsurePacketSpace), so that
+    // connection attempts that never get past their Initial packets don't pay
+    // for them.
+    //
+    Status =
+        QuicPacketSpaceInitialize(
+            Connection,
+            QUIC_ENCRYPT_LEVEL_INITIAL,
+            &Connection->Packets[QUIC_ENCRYPT_LEVEL_INITIAL]);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
     }
 
     QUIC_PATH* Path = &Connection->Paths[0];
@@ -144,7 +159,8 @@ QuicConnAlloc(
     if (IsServer) {
 
         Connection->Type = QUIC_HANDLE_TYPE_CONNECTION_SERVER;
-        if (MsQuicLib.Settings.LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_IP) {
+        const QUIC_SETTINGS_INTERNAL* Settings = QuicLibraryGetSettings();
+        if (Settings->LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_IP) {
             CxPlatRandom(1, Connection->ServerID); // Randomize the first byte.
             if (QuicAddrGetFamily(&Packet->Route->LocalAddress) == QUIC_ADDRESS_FAMILY_INET) {
                 CxPlatCopyMemory(
@@ -157,12 +173,12 @@ QuicConnAlloc(
                     ((uint8_t*)&Packet->Route->LocalAddress.Ipv6.sin6_addr) + 12,
                     4);
             }
-        } else if (MsQuicLib.Settings.LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_FIXED) {
+        } else if (Settings->LoadBalancingMode != QUIC_LOAD_BALANCING_DISABLED) {
             CxPlatRandom(1, Connection->ServerID); // Randomize the first byte.
             CxPlatCopyMemory(
                 Connection->ServerID + 1,
-                &MsQuicLib.Settings.FixedServerID,
-                sizeof(MsQuicLib.Settings.FixedServerID));
+                &Settings->FixedServerID,
+                sizeof(Settings->FixedServerID));
         }
 
         Connection->Stats.QuicVersion = Packet->Invariant->LONG_HDR.Version;
@@ -259,6 +275,28 @@ Error:
     return Status;
 }
 
+//
+// Frees the packet protection offload state. No batches may be out on the
+// offload threads, as the packet builder waits for them before returning.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+void
+QuicConnFreeProtectOffloads(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->ProtectOffloads == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < QUIC_MAX_PROTECT_OFFLOADS; ++i) {
+        CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&Connection->ProtectOffloads[i].Link));
+        QuicPacketKeyFree(Connection->ProtectOffloads[i].Key);
+    }
+    CXPLAT_FREE(Connection->ProtectOffloads, QUIC_POOL_PROTECT_OFFLOAD);
+    Connection->ProtectOffloads = NULL;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicConnFree(
@@ -281,6 +319,7 @@ QuicConnFree(
     QuicRangeUninitialize(&Connection->DecodedAckRanges);
     QuicCryptoUninitialize(&Connection->Crypto);
     QuicLossDetectionUninitialize(&Connection->LossDetection);
+    QuicCongestionControlUninitialize(&Connection->CongestionControl);
     QuicSendUninitialize(&Connection->Send);
     for (uint32_t i = 0; i < ARRAYSIZE(Connection->Packets); i++) {
         if (Connection->Packets[i] != NULL) {
@@ -354,6 +393,7 @@ QuicConnFree(
         CxPlatPoolFree(Connection->HandshakeTP);
         Connection->HandshakeTP = NULL;
     }
+    QuicConnFreeHandshakeState(Connection);
     QuicCryptoTlsCleanupTransportParameters(&Connection->PeerTransportParams);
     QuicSettingsCleanup(&Connection->Settings);
     if (Connection->State.Started && !Connection->State.Connected) {
@@ -368,15 +408,18 @@ QuicConnFree(
     if (Connection->CloseReasonPhrase != NULL) {
         CXPLAT_FREE(Connection->CloseReasonPhrase, QUIC_POOL_CLOSE_REASON);
     }
+    QuicQlogUninitialize(Connection);
+    if (Connection->StatsSamples != NULL) {
+        CXPLAT_FREE(Connection->StatsSamples, QUIC_POOL_STATS_SAMPLES);
+    }
+    QuicConnFreeProtectOffloads(Connection);
     Connection->State.Freed = TRUE;
 #if DEBUG
     QuicLibraryUntrackDbgObject(QUIC_DBG_OBJECT_TYPE_CONNECTION, &Connection->DbgObjectLink);
 #endif
     CxPlatPoolFree(Connection);
 
-#if DEBUG
     InterlockedDecrement(&MsQuicLib.ConnectionCount);
-#endif
     QuicPerfCounterDecrement(Partition, QUIC_PERF_COUNTER_CONN_ACTIVE);
 #ifdef QUIC_SILO
     QuicConfigurationDetachSilo();
@@ -384,6 +427,18 @@ QuicConnFree(
 #endif
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnFreeHandshakeState(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->HandshakeState != NULL) {
+        CxPlatPoolFree(Connection->HandshakeState);
+        Connection->HandshakeState = NULL;
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnShutdown(
@@ -409,6 +464,9 @@ QuicConnShutdown(
     if (Flags & QUIC_CONNECTION_SHUTDOWN_FLAG_STATUS) {
         CloseFlags |= QUIC_CLOSE_QUIC_STATUS;
     }
+    if (Flags & QUIC_CONNECTION_SHUTDOWN_FLAG_FAST) {
+        CloseFlags |= QUIC_CLOSE_FAST;
+    }
 
     QuicConnCloseLocally(Connection, CloseFlags, ErrorCode, NULL);
 }
@@ -445,7 +503,13 @@ QuicConnUnregister(
     if (Connection->State.Registered) {
         CxPlatDispatchLockAcquire(&Connection->Registration->ConnectionLock);
         CxPlatListEntryRemove(&Connection->RegistrationLink);
+        Connection->Registration->ConnectionCount--;
         CxPlatDispatchLockRelease(&Connection->Registration->ConnectionLock);
+        if (Connection->SendBuffer.BufferedBytes != 0) {
+            InterlockedExchangeAdd64(
+                (int64_t*)&Connection->Registration->BufferedBytes,
+                -1 * (int64_t)Connection->SendBuffer.BufferedBytes);
+        }
         QuicRegistrationRundownRelease(Connection->Registration, QUIC_REG_REF_CONNECTION);
 
         Connection->Registration = NULL;
@@ -480,6 +544,7 @@ QuicConnRegister(
             QuicRegistrationQueueNewConnection(Registration, Connection);
         }
         CxPlatListInsertTail(&Registration->Connections, &Connection->RegistrationLink);
+        Registration->ConnectionCount++;
     }
     CxPlatDispatchLockRelease(&Registration->ConnectionLock);
 
@@ -487,7 +552,14 @@ QuicConnRegister(
         Connection->State.Registered = FALSE;
         Connection->Registration = NULL;
         QuicRegistrationRundownRelease(Registration, QUIC_REG_REF_CONNECTION);
-    } else {
+    } else if (Connection->SendBuffer.BufferedBytes != 0) {
+        //
+        // Buffered send bytes are charged to whichever registration the
+        // connection currently belongs to.
+        //
+        InterlockedExchangeAdd64(
+            (int64_t*)&Registration->BufferedBytes,
+            (int64_t)Connection->SendBuffer.BufferedBytes);
     }
 
     return !RegistrationShuttingDown;
@@ -506,6 +578,46 @@ QuicConnQueueTraceRundown(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnQueueDrain(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_OPERATION* Oper;
+    if ((Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_DRAIN)) != NULL) {
+        QuicConnQueueOper(Connection, Oper);
+    } else {
+    }
+}
+
+//
+// Closes a draining connection with NO_ERROR once its handshake is complete
+// and the last open stream is gone, so in-flight requests finish but the peer
+// reconnects (elsewhere) right after instead of at its idle timeout.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnTryDrain(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (!Connection->State.Connected ||
+        Connection->State.ClosedLocally ||
+        Connection->State.ClosedRemotely) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < NUMBER_OF_STREAM_TYPES; ++i) {
+        if (Connection->Streams.Types[i].CurrentStreamCount != 0) {
+            return;
+        }
+    }
+
+    QuicConnCloseLocally(Connection, QUIC_CLOSE_INTERNAL, QUIC_ERROR_NO_ERROR, NULL);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnTraceRundownOper(
@@ -573,11 +685,23 @@ QuicConnIndicateEvent(
         CXPLAT_DBG_ASSERT(
             !Connection->State.InlineApiExecution ||
             Connection->State.HandleClosed);
+        QUIC_WORKER* Worker = Connection->Worker;
+        const QUIC_WORKER_ACTIVITY_TYPE PrevActivity =
+            Worker != NULL ?
+                QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_APP_CALLBACK) :
+                QUIC_WORKER_ACTIVITY_OTHER;
+        const uint32_t EventType = Event->Type;
+        const uint64_t StartTime = QuicLibraryCallbackStart();
         Status =
             Connection->ClientCallbackHandler(
                 (HQUIC)Connection,
                 Connection->ClientContext,
                 Event);
+        QuicLibraryCallbackComplete(
+            Connection->Partition, QUIC_CALLBACK_CONNECTION, EventType, StartTime);
+        if (Worker != NULL) {
+            QuicWorkerSetActivity(Worker, PrevActivity);
+        }
     } else {
         QUIC_CONN_VERIFY(
             Connection,
@@ -681,6 +805,7 @@ QuicConnUpdateRtt(
 
     BOOLEAN NewMinRtt = FALSE;
     Path->LatestRttSample = LatestRtt;
+    QuicWorkerRecordMetric(Connection->Worker, QUIC_METRIC_HISTOGRAM_RTT, LatestRtt);
     if (LatestRtt < Path->MinRtt) {
         Path->MinRtt = LatestRtt;
         NewMinRtt = TRUE;
@@ -718,6 +843,68 @@ QuicConnUpdateRtt(
     CXPLAT_DBG_ASSERT(Path->SmoothedRtt != 0);
 }
 
+//
+// Creates a new random source CID for the connection, with the random bytes
+// drawn from its worker's pool.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_CID_HASH_ENTRY*
+QuicConnNewRandomSourceCid(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_reads_opt_(MsQuicLib.CidServerIdLength)
+        const void* ServerID
+    )
+{
+    uint8_t Random[QUIC_MAX_CONNECTION_ID_LENGTH_V1];
+    const uint8_t* RandomBytes = NULL;
+    if (Connection->Worker != NULL) {
+        QuicWorkerRandom(Connection->Worker, MsQuicLib.CidTotalLength, Random);
+        RandomBytes = Random;
+    }
+
+    return
+        QuicCidNewRandomSource(
+            Connection,
+            ServerID,
+            Connection->PartitionID,
+            Connection->CibirId[0],
+            Connection->CibirId+2,
+            RandomBytes);
+}
+
+//
+// Assigns the next sequence number to a source CID already in the binding's
+// lookup table and adds it to the connection's list.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnAddSourceCid(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
+    _In_ BOOLEAN IsInitial
+    )
+{
+    SourceCid->CID.SequenceNumber = Connection->NextSourceCidSequenceNumber++;
+    if (SourceCid->CID.SequenceNumber > 0) {
+        SourceCid->CID.NeedsToSend = TRUE;
+        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_NEW_CONNECTION_ID);
+    }
+
+    if (IsInitial) {
+        SourceCid->CID.IsInitial = TRUE;
+        CxPlatListPushEntry(&Connection->SourceCids, &SourceCid->Link);
+    } else {
+        CXPLAT_SLIST_ENTRY** Tail = &Connection->SourceCids.Next;
+        while (*Tail != NULL) {
+            Tail = &(*Tail)->Next;
+        }
+        *Tail = &SourceCid->Link;
+        SourceCid->Link.Next = NULL;
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_CID_HASH_ENTRY*
 QuicConnGenerateNewSourceCid(
@@ -742,13 +929,7 @@ QuicConnGenerateNewSourceCid(
     //
 
     do {
-        SourceCid =
-            QuicCidNewRandomSource(
-                Connection,
-                Connection->ServerID,
-                Connection->PartitionID,
-                Connection->CibirId[0],
-                Connection->CibirId+2);
+        SourceCid = QuicConnNewRandomSourceCid(Connection, Connection->ServerID);
         if (SourceCid == NULL) {
             QuicConnFatalError(Connection, QUIC_STATUS_INTERNAL_ERROR, NULL);
             return NULL;
@@ -763,24 +944,7 @@ QuicConnGenerateNewSourceCid(
         }
     } while (SourceCid == NULL);
 
-
-    SourceCid->CID.SequenceNumber = Connection->NextSourceCidSequenceNumber++;
-    if (SourceCid->CID.SequenceNumber > 0) {
-        SourceCid->CID.NeedsToSend = TRUE;
-        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_NEW_CONNECTION_ID);
-    }
-
-    if (IsInitial) {
-        SourceCid->CID.IsInitial = TRUE;
-        CxPlatListPushEntry(&Connection->SourceCids, &SourceCid->Link);
-    } else {
-        CXPLAT_SLIST_ENTRY** Tail = &Connection->SourceCids.Next;
-        while (*Tail != NULL) {
-            Tail = &(*Tail)->Next;
-        }
-        *Tail = &SourceCid->Link;
-        SourceCid->Link.Next = NULL;
-    }
+    QuicConnAddSourceCid(Connection, SourceCid, IsInitial);
 
     return SourceCid;
 }
@@ -843,9 +1007,43 @@ QuicConnGenerateNewSourceCids(
         }
     }
 
+    //
+    // Generate the whole batch up front and insert it into the binding's
+    // lookup under a single lock acquisition. Any that collide are replaced
+    // one at a time, the slow way.
+    //
+    QUIC_CID_HASH_ENTRY* SourceCids[QUIC_ACTIVE_CONNECTION_ID_LIMIT];
+    CXPLAT_DBG_ASSERT(NewCidCount <= ARRAYSIZE(SourceCids));
+
     for (uint8_t i = 0; i < NewCidCount; ++i) {
-        if (QuicConnGenerateNewSourceCid(Connection, FALSE) == NULL) {
-            break;
+        SourceCids[i] = QuicConnNewRandomSourceCid(Connection, Connection->ServerID);
+        if (SourceCids[i] == NULL) {
+            while (i > 0) {
+                CXPLAT_FREE(SourceCids[--i], QUIC_POOL_CIDHASH);
+            }
+            QuicConnFatalError(Connection, QUIC_STATUS_INTERNAL_ERROR, NULL);
+            return;
+        }
+    }
+
+    if (NewCidCount == 0 ||
+        QuicBindingAddSourceConnectionIDs(
+            Connection->Paths[0].Binding, NewCidCount, SourceCids) == NewCidCount) {
+        for (uint8_t i = 0; i < NewCidCount; ++i) {
+            QuicConnAddSourceCid(Connection, SourceCids[i], FALSE);
+        }
+        return;
+    }
+
+    BOOLEAN Failed = FALSE;
+    for (uint8_t i = 0; i < NewCidCount; ++i) {
+        if (SourceCids[i]->CID.IsInLookupTable) {
+            QuicConnAddSourceCid(Connection, SourceCids[i], FALSE);
+        } else {
+            CXPLAT_FREE(SourceCids[i], QUIC_POOL_CIDHASH);
+            if (!Failed && QuicConnGenerateNewSourceCid(Connection, FALSE) == NULL) {
+                Failed = TRUE;
+            }
         }
     }
 }
@@ -906,10 +1104,17 @@ QuicConnRetireCurrentDestCid(
     }
 
     CXPLAT_DBG_ASSERT(Path->DestCid != NewDestCid);
+    if (Path->EncryptionOffloading) {
+        //
+        // The offload is bound to the old CID. Fall back to software.
+        //
+        QuicPathUpdateQeo(Connection, Path, CXPLAT_QEO_OPERATION_REMOVE);
+    }
     QUIC_CID_LIST_ENTRY* OldDestCid = Path->DestCid;
     QUIC_CID_CLEAR_PATH(Path->DestCid);
     QuicConnRetireCid(Connection, Path->DestCid);
     Path->DestCid = NewDestCid;
+    QuicPathInvalidateShortHeader(Path);
     QUIC_CID_SET_PATH(Connection, Path->DestCid, Path);
     QUIC_CID_VALIDATE_NULL(Connection, OldDestCid);
     Path->DestCid->CID.UsedLocally = TRUE;
@@ -976,7 +1181,11 @@ QuicConnReplaceRetiredCids(
         }
 
         CXPLAT_DBG_ASSERT(NewDestCid != Path->DestCid);
+        if (Path->EncryptionOffloading) {
+            QuicPathUpdateQeo(Connection, Path, CXPLAT_QEO_OPERATION_REMOVE);
+        }
         Path->DestCid = NewDestCid;
+        QuicPathInvalidateShortHeader(Path);
         QUIC_CID_SET_PATH(Connection, NewDestCid, Path);
         Path->DestCid->CID.UsedLocally = TRUE;
         Path->InitiatedCidUpdate = TRUE;
@@ -1014,6 +1223,69 @@ QuicGetEarliestExpirationTime(
     return EarliestExpirationTime;
 }
 
+//
+// Returns how long (in us) the timer may be deferred past its due time so it
+// can fire along with other timers.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+uint64_t
+QuicConnTimerGetSlack(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ QUIC_CONN_TIMER_TYPE Type
+    )
+{
+    switch (Type) {
+    case QUIC_CONN_TIMER_IDLE:
+        return MS_TO_US((uint64_t)Connection->Settings.IdleTimerSlackMs);
+    case QUIC_CONN_TIMER_KEEP_ALIVE:
+        return MS_TO_US((uint64_t)Connection->Settings.KeepAliveTimerSlackMs);
+    case QUIC_CONN_TIMER_SHUTDOWN:
+        return MS_TO_US((uint64_t)Connection->Settings.ShutdownTimerSlackMs);
+    default:
+        return 0;
+    }
+}
+
+//
+// Moves the expiration time of a timer with slack so that it coincides with
+// another wakeup. If one of the connection's other timers is due within the
+// slack window, the timer fires with it. Otherwise the time is rounded up to a
+// multiple of the slack, which lines up the timers of all connections on the
+// worker that use the same slack.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+uint64_t
+QuicConnTimerCoalesce(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ QUIC_CONN_TIMER_TYPE Type,
+    _In_ uint64_t ExpirationTime,
+    _In_ uint64_t Slack
+    )
+{
+    if (ExpirationTime > UINT64_MAX - Slack) {
+        return ExpirationTime;
+    }
+
+    uint64_t CoalescedTime = ExpirationTime + Slack;
+    BOOLEAN Found = FALSE;
+    for (QUIC_CONN_TIMER_TYPE Other = 0; Other < QUIC_CONN_TIMER_COUNT; ++Other) {
+        if (Other != Type &&
+            Connection->ExpirationTimes[Other] >= ExpirationTime &&
+            Connection->ExpirationTimes[Other] <= CoalescedTime) {
+            CoalescedTime = Connection->ExpirationTimes[Other];
+            Found = TRUE;
+        }
+    }
+
+    if (!Found) {
+        CoalescedTime = ((ExpirationTime + Slack - 1) / Slack) * Slack;
+    }
+
+    return CoalescedTime;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnTimerSetEx(
@@ -1023,8 +1295,13 @@ QuicConnTimerSetEx(
     _In_ uint64_t TimeNow
     )
 {
-    const uint64_t NewExpirationTime = TimeNow + Delay;
+    uint64_t NewExpirationTime = TimeNow + Delay;
 
+    const uint64_t Slack = QuicConnTimerGetSlack(Connection, Type);
+    if (Slack != 0) {
+        NewExpirationTime =
+            QuicConnTimerCoalesce(Connection, Type, NewExpirationTime, Slack);
+    }
 
     Connection->ExpirationTimes[Type] = NewExpirationTime;
     uint64_t NewEarliestExpirationTime  = QuicGetEarliestExpirationTime(Connection);
@@ -1091,8 +1368,6 @@ QuicConnTimerExpired(
             if (Type == QUIC_CONN_TIMER_ACK_DELAY) {
                 QuicSendProcessDelayedAckTimer(&Connection->Send);
                 FlushSendImmediate = TRUE;
-            } else if (Type == QUIC_CONN_TIMER_PACING) {
-                FlushSendImmediate = TRUE;
             } else {
                 QUIC_OPERATION* Oper;
                 if ((Oper = QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_TIMER_EXPIRED)) != NULL) {
@@ -1143,6 +1418,35 @@ QuicConnIndicateShutdownBegin(
     (void)QuicConnIndicateEvent(Connection, &Event);
 }
 
+//
+// Saves what the connection learned about its path for later connections to
+// the same destination.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnCachePathMetrics(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    if (!Connection->State.HandshakeConfirmed || !Path->GotFirstRttSample) {
+        return;
+    }
+
+    //
+    // Only the part of the window that was actually filled has been shown to
+    // be safe for the path.
+    //
+    QUIC_PATH_METRICS Metrics = { 0 };
+    Metrics.SmoothedRtt = Path->SmoothedRtt;
+    Metrics.MinRtt = Path->MinRtt;
+    Metrics.CongestionWindow =
+        CXPLAT_MIN(
+            QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl),
+            QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl));
+    QuicLibraryCachePathMetrics(&Path->Route.RemoteAddress, &Metrics);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnOnShutdownComplete(
@@ -1156,6 +1460,9 @@ QuicConnOnShutdownComplete(
     Connection->State.ShutdownComplete = TRUE;
     Connection->State.UpdateWorker = FALSE;
 
+    if (Connection->Settings.PathMetricsCacheEnabled) {
+        QuicConnCachePathMetrics(Connection);
+    }
 
     //
     // Clean up any pending state that is irrelevant now.
@@ -1177,6 +1484,7 @@ QuicConnOnShutdownComplete(
     // Clean up the rest of the internal state.
     //
     QuicTimerWheelRemoveConnection(&Connection->Worker->TimerWheel, Connection);
+    QuicWorkerPacingTimerCancel(Connection->Worker, Connection);
     QuicLossDetectionUninitialize(&Connection->LossDetection);
     QuicSendUninitialize(&Connection->Send);
     QuicDatagramSendShutdown(&Connection->Datagram);
@@ -1320,8 +1628,10 @@ QuicConnTryClose(
             //
             // Enter 'closing period' to wait for a (optional) connection close
             // response. During that time, the connection close will be re-transmitted
-            // when packets are received.
+            // when packets are received. A fast close skips this once the close
+            // frame is sent, and only falls back to the timer if it can't be.
             //
+            Connection->State.ClosedFast = !!(Flags & QUIC_CLOSE_FAST);
             uint64_t Pto =
                 QuicLossDetectionComputeProbeTimeout(
                     &Connection->LossDetection,
@@ -1451,6 +1761,26 @@ QuicConnTryClose(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnOnFastCloseSent(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    CXPLAT_DBG_ASSERT(Connection->State.ClosedFast);
+    CXPLAT_DBG_ASSERT(Connection->State.ClosedLocally);
+
+    //
+    // The peer hasn't closed, so this is not marked ClosedRemotely: a close
+    // from the peer is still handled normally until shutdown completes. Since
+    // the peer never acknowledged the close, it's reported like a closing
+    // period that timed out.
+    //
+    QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_SHUTDOWN);
+    Connection->State.ShutdownCompleteTimedOut = TRUE;
+    Connection->State.ProcessShutdownComplete = TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnProcessShutdownTimerOperation(
@@ -1506,6 +1836,46 @@ QuicConnOnQuicVersionSet(
     }
 }
 
+//
+// Resumes with the ticket an earlier connection (possibly of an earlier
+// process) persisted for the server, if there is one.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnApplyPersistedTicket(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort
+    )
+{
+    uint8_t* Ticket;
+    uint32_t TicketLength;
+    if (!QuicPersistentCacheTakeTicket(ServerName, ServerPort, &Ticket, &TicketLength)) {
+        return;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_INVALID_PARAMETER;
+    if (TicketLength <= UINT16_MAX) {
+        Status =
+            QuicCryptoDecodeClientTicket(
+                Connection,
+                (uint16_t)TicketLength,
+                Ticket,
+                &Connection->PeerTransportParams,
+                &Connection->Crypto.ResumptionTicket,
+                &Connection->Crypto.ResumptionTicketLength,
+                &Connection->Stats.QuicVersion);
+    }
+    if (QUIC_SUCCEEDED(Status)) {
+        QuicConnOnQuicVersionSet(Connection);
+        Status = QuicConnProcessPeerTransportParameters(Connection, TRUE);
+        CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status));
+    }
+
+    CXPLAT_FREE(Ticket, QUIC_POOL_PERSISTENT_CACHE);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicConnStart(
@@ -1550,7 +1920,7 @@ QuicConnStart(
     QuicConnApplyNewSettings(
         Connection,
         FALSE,
-        &Configuration->Settings);
+        QuicConfigurationGetSettings(Configuration));
 
     if (!Connection->State.RemoteAddressSet) {
 
@@ -1641,13 +2011,7 @@ QuicConnStart(
     //
     QUIC_CID_HASH_ENTRY* SourceCid;
     if (Connection->State.ShareBinding) {
-        SourceCid =
-            QuicCidNewRandomSource(
-                Connection,
-                NULL,
-                Connection->PartitionID,
-                Connection->CibirId[0],
-                Connection->CibirId+2);
+        SourceCid = QuicConnNewRandomSourceCid(Connection, NULL);
     } else {
         SourceCid = QuicCidNewNullSource(Connection);
     }
@@ -1669,6 +2033,12 @@ QuicConnStart(
     Connection->State.LocalAddressSet = TRUE;
     QuicBindingGetLocalAddress(Path->Binding, &Path->Route.LocalAddress);
 
+    if (ServerName != NULL &&
+        Connection->Crypto.ResumptionTicket == NULL &&
+        MsQuicLib.PersistentCache.Enabled) {
+        QuicConnApplyPersistedTicket(Connection, ServerName, ServerPort);
+    }
+
     //
     // Save the server name.
     //
@@ -1680,8 +2050,17 @@ QuicConnStart(
         goto Exit;
     }
 
-    //
-    // Start the handshake.
+    if (StartFlags & QUIC_CONN_START_FLAG_DEFER_HANDSHAKE) {
+        //
+        // The handshake is started by a QUIC_API_TYPE_CONN_SET_CONFIGURATION
+        // operation on the connection's worker, so that many connections can
+        // start their handshakes in parallel.
+        //
+        goto Exit;
+    }
+
+    //
+    // Start the handshake.
     //
     Status = QuicConnSetConfiguration(Connection, Configuration);
     if (QUIC_FAILED(Status)) {
@@ -1723,13 +2102,14 @@ QuicConnRestart(
         //
         QUIC_PATH* Path = &Connection->Paths[0];
         Path->GotFirstRttSample = FALSE;
-        Path->SmoothedRtt = MS_TO_US(Connection->Settings.InitialRttMs);
+        Path->SmoothedRtt = QuicConnGetInitialRtt(Connection);
         Path->RttVariance = Path->SmoothedRtt / 2;
     }
 
     for (uint32_t i = 0; i < ARRAYSIZE(Connection->Packets); ++i) {
-        CXPLAT_DBG_ASSERT(Connection->Packets[i] != NULL);
-        QuicPacketSpaceReset(Connection->Packets[i]);
+        if (Connection->Packets[i] != NULL) {
+            QuicPacketSpaceReset(Connection->Packets[i]);
+        }
     }
 
     QuicCongestionControlReset(&Connection->CongestionControl, TRUE);
@@ -1749,7 +2129,7 @@ QuicConnRestart(
         Status =
             QuicCryptoInitializeTls(
                 &Connection->Crypto,
-                Connection->Configuration->SecurityConfig,
+                Connection->Crypto.SecConfig,
                 &LocalTP);
         if (QUIC_FAILED(Status)) {
             QuicConnFatalError(Connection, Status, NULL);
@@ -1904,6 +2284,15 @@ QuicConnRecvResumptionTicket(
             Event.RESUMPTION_TICKET_RECEIVED.ResumptionTicket = ClientTicket;
             (void)QuicConnIndicateEvent(Connection, &Event);
 
+            if (MsQuicLib.PersistentCache.Enabled &&
+                Connection->RemoteServerName != NULL) {
+                QuicPersistentCacheStoreTicket(
+                    Connection->RemoteServerName,
+                    QuicAddrGetPort(&Connection->Paths[0].Route.RemoteAddress),
+                    ClientTicketLength,
+                    ClientTicket);
+            }
+
             CXPLAT_FREE(ClientTicket, QUIC_POOL_CLIENT_CRYPTO_TICKET);
             ResumptionAccepted = TRUE;
         }
@@ -2053,6 +2442,11 @@ QuicConnGenerateLocalTransportParameters(
                           QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED;
     }
 
+    if (Connection->Settings.FecEnabled) {
+        LocalTP->Flags |= QUIC_TP_FLAG_FEC_ENABLED;
+        LocalTP->FecBlockSize = QUIC_FEC_BLOCK_SIZE;
+    }
+
     if (QuicConnIsServer(Connection)) {
 
         if (Connection->Streams.Types[STREAM_ID_FLAG_IS_CLIENT | STREAM_ID_FLAG_IS_BI_DIR].MaxTotalStreamCount) {
@@ -2125,6 +2519,45 @@ QuicConnGenerateLocalTransportParameters(
     return QUIC_STATUS_SUCCESS;
 }
 
+//
+// Warm starts the connection from the path metrics an earlier connection to
+// the same destination left in the library's cache: the RTT estimate, and the
+// congestion window via careful resume. The MTU is picked up separately when
+// MTU discovery starts.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnApplyCachedPathMetrics(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_PATH* Path = &Connection->Paths[0];
+    QUIC_PATH_METRICS Metrics;
+    if (Path->GotFirstRttSample ||
+        !QuicLibraryGetPathMetrics(
+            &Path->Route.RemoteAddress,
+            QUIC_PATH_METRICS_MAX_AGE,
+            &Metrics) ||
+        Metrics.SmoothedRtt == 0) {
+        return;
+    }
+
+    if (!Connection->Settings.IsSet.InitialRttMs) {
+        Path->SmoothedRtt = Metrics.SmoothedRtt;
+        Path->RttVariance = Path->SmoothedRtt / 2;
+    }
+
+    QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState = { 0 };
+    CarefulResumeState.SmoothedRtt = Metrics.SmoothedRtt;
+    CarefulResumeState.MinRtt = Metrics.MinRtt;
+    CarefulResumeState.RemoteEndpoint = Path->Route.RemoteAddress;
+    CarefulResumeState.Algorithm =
+        (QUIC_CONGESTION_CONTROL_ALGORITHM)Connection->Settings.CongestionControlAlgorithm;
+    CarefulResumeState.CongestionWindow = Metrics.CongestionWindow;
+    QuicCongestionControlSetCarefulResume(
+        &Connection->CongestionControl, &CarefulResumeState);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicConnSetConfiguration(
@@ -2141,7 +2574,13 @@ QuicConnSetConfiguration(
 
     CXPLAT_TEL_ASSERT(Connection->Configuration == NULL);
     CXPLAT_TEL_ASSERT(Configuration != NULL);
-    CXPLAT_TEL_ASSERT(Configuration->SecurityConfig != NULL);
+
+    //
+    // Snapshot the credentials once; a concurrent reload only affects
+    // connections configured after it.
+    //
+    CXPLAT_SEC_CONFIG* SecurityConfig = QuicConfigurationGetSecurityConfig(Configuration);
+    CXPLAT_TEL_ASSERT(SecurityConfig != NULL);
 
 
     QuicConfigurationAddRef(Configuration, QUIC_CONF_REF_CONNECTION);
@@ -2152,7 +2591,7 @@ QuicConnSetConfiguration(
         QuicConnApplyNewSettings(
             Connection,
             FALSE,
-            &Configuration->Settings);
+            QuicConfigurationGetSettings(Configuration));
     }
 
     if (QuicConnIsClient(Connection)) {
@@ -2229,13 +2668,17 @@ QuicConnSetConfiguration(
         QuicCryptoTlsCopyTransportParameters(&LocalTP, Connection->HandshakeTP);
     }
 
+    if (Connection->Settings.PathMetricsCacheEnabled) {
+        QuicConnApplyCachedPathMetrics(Connection);
+    }
+
     Connection->State.Started = TRUE;
     Connection->Stats.Timing.Start = CxPlatTimeUs64();
 
     Status =
         QuicCryptoInitializeTls(
             &Connection->Crypto,
-            Configuration->SecurityConfig,
+            SecurityConfig,
             &LocalTP);
 
 Cleanup:
@@ -2298,15 +2741,17 @@ QuicConnProcessPeerVersionNegotiationTP(
     )
 {
     QUIC_STATUS Status;
+    CXPLAT_DBG_ASSERT(Connection->HandshakeState != NULL);
     if (QuicConnIsServer(Connection)) {
         //
         // Check whether version is in (App-specified) list of acceptable versions.
         //
         uint32_t SupportedVersionsLength = 0;
         const uint32_t* SupportedVersions = NULL;
-        if (MsQuicLib.Settings.IsSet.VersionSettings) {
-            SupportedVersionsLength = MsQuicLib.Settings.VersionSettings->AcceptableVersionsLength;
-            SupportedVersions = MsQuicLib.Settings.VersionSettings->AcceptableVersions;
+        const QUIC_SETTINGS_INTERNAL* Settings = QuicLibraryGetSettings();
+        if (Settings->IsSet.VersionSettings) {
+            SupportedVersionsLength = Settings->VersionSettings->AcceptableVersionsLength;
+            SupportedVersions = Settings->VersionSettings->AcceptableVersions;
         } else {
             SupportedVersionsLength = ARRAYSIZE(DefaultSupportedVersionsList);
             SupportedVersions = DefaultSupportedVersionsList;
@@ -2426,7 +2871,7 @@ QuicConnProcessPeerVersionNegotiationTP(
                 QuicVersionNegotiationExtIsVersionClientSupported(Connection, ServerVI.AvailableVersions[i])) {
                 ClientChosenVersion = ServerVI.AvailableVersions[i];
             }
-            if (Connection->OriginalQuicVersion == ServerVI.AvailableVersions[i]) {
+            if (Connection->HandshakeState->OriginalQuicVersion == ServerVI.AvailableVersions[i]) {
                 OriginalVersionFound = TRUE;
             }
         }
@@ -2434,7 +2879,7 @@ QuicConnProcessPeerVersionNegotiationTP(
             QuicVersionNegotiationExtIsVersionClientSupported(Connection, ServerVI.ChosenVersion)) {
             ClientChosenVersion = ServerVI.ChosenVersion;
         }
-        if (ClientChosenVersion == 0 || (ClientChosenVersion != Connection->OriginalQuicVersion &&
+        if (ClientChosenVersion == 0 || (ClientChosenVersion != Connection->HandshakeState->OriginalQuicVersion &&
             ClientChosenVersion != ServerVI.ChosenVersion)) {
             QuicConnTransportError(Connection, QUIC_ERROR_VERSION_NEGOTIATION_ERROR);
             return QUIC_STATUS_PROTOCOL_ERROR;
@@ -2443,17 +2888,17 @@ QuicConnProcessPeerVersionNegotiationTP(
         // If the client has already received a version negotiation packet, do
         // extra validation.
         //
-        if (Connection->PreviousQuicVersion != 0) {
-            if (Connection->PreviousQuicVersion == ServerVI.ChosenVersion) {
+        if (Connection->HandshakeState->PreviousQuicVersion != 0) {
+            if (Connection->HandshakeState->PreviousQuicVersion == ServerVI.ChosenVersion) {
                 QuicConnTransportError(Connection, QUIC_ERROR_VERSION_NEGOTIATION_ERROR);
                 return QUIC_STATUS_PROTOCOL_ERROR;
             }
             //
             // Ensure the version which generated a VN packet is not in the AvailableVersions.
             //
-            if (!QuicIsVersionReserved(Connection->PreviousQuicVersion)) {
+            if (!QuicIsVersionReserved(Connection->HandshakeState->PreviousQuicVersion)) {
                 for (uint32_t i = 0; i < ServerVI.AvailableVersionsCount; ++i) {
-                    if (Connection->PreviousQuicVersion == ServerVI.AvailableVersions[i]) {
+                    if (Connection->HandshakeState->PreviousQuicVersion == ServerVI.AvailableVersions[i]) {
                         QuicConnTransportError(Connection, QUIC_ERROR_VERSION_NEGOTIATION_ERROR);
                         return QUIC_STATUS_PROTOCOL_ERROR;
                     }
@@ -2465,7 +2910,7 @@ QuicConnProcessPeerVersionNegotiationTP(
         //
         if (Connection->State.CompatibleVerNegotiationAttempted) {
             if (!QuicVersionNegotiationExtAreVersionsCompatible(
-                Connection->OriginalQuicVersion, ServerVI.ChosenVersion)) {
+                Connection->HandshakeState->OriginalQuicVersion, ServerVI.ChosenVersion)) {
                 QuicConnTransportError(Connection, QUIC_ERROR_VERSION_NEGOTIATION_ERROR);
                 return QUIC_STATUS_PROTOCOL_ERROR;
             }
@@ -2511,7 +2956,7 @@ QuicConnProcessPeerTransportParameters(
             }
         }
         if (QuicConnIsClient(Connection) &&
-            (Connection->State.CompatibleVerNegotiationAttempted || Connection->PreviousQuicVersion != 0) &&
+            (Connection->State.CompatibleVerNegotiationAttempted || Connection->HandshakeState->PreviousQuicVersion != 0) &&
             !(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION)) {
             //
             // Client responded to a version negotiation packet, or compatible version negotiation,
@@ -2556,6 +3001,7 @@ QuicConnProcessPeerTransportParameters(
             (void) CxPlatRandom(sizeof(RandomValue), &RandomValue);
             Connection->State.FixedBit = (RandomValue % 2);
             Connection->Stats.GreaseBitNegotiated = TRUE;
+            QuicConnInvalidateShortHeaders(Connection);
         }
 
         if (Connection->Settings.ReliableResetEnabled) {
@@ -2679,12 +3125,21 @@ QuicConnPeerCertReceived(
 {
     QUIC_CONNECTION_EVENT Event;
     Connection->Crypto.CertValidationPending = TRUE;
+    Connection->Stats.Handshake.CertValidationStart = CxPlatTimeUs64();
     Event.Type = QUIC_CONNECTION_EVENT_PEER_CERTIFICATE_RECEIVED;
     Event.PEER_CERTIFICATE_RECEIVED.Certificate = Certificate;
     Event.PEER_CERTIFICATE_RECEIVED.Chain = Chain;
     Event.PEER_CERTIFICATE_RECEIVED.DeferredErrorFlags = DeferredErrorFlags;
     Event.PEER_CERTIFICATE_RECEIVED.DeferredStatus = DeferredStatus;
     QUIC_STATUS Status = QuicConnIndicateEvent(Connection, &Event);
+    if (Status != QUIC_STATUS_PENDING) {
+        //
+        // Pending validation is timed until QuicCryptoCustomCertValidationComplete.
+        //
+        Connection->Stats.Handshake.CertValidationTime +=
+            (uint32_t)CxPlatTimeDiff64(
+                Connection->Stats.Handshake.CertValidationStart, CxPlatTimeUs64());
+    }
     if (QUIC_FAILED(Status)) {
         Connection->Crypto.CertValidationPending = FALSE;
         return FALSE;
@@ -2731,10 +3186,14 @@ QuicConnQueueRecvPackets(
     if (Connection->ReceiveQueueCount >= QueueLimit) {
         QueueOperation = FALSE;
     } else {
+        QueueOperation = (Connection->ReceiveQueueCount == 0);
+        if (QueueOperation && !Connection->State.Connected) {
+            Connection->Stats.Handshake.RecvQueueTime =
+                Packets->RecvTimeUs != 0 ? Packets->RecvTimeUs : CxPlatTimeUs64();
+        }
         *Connection->ReceiveQueueTail = Packets;
         Connection->ReceiveQueueTail = PacketsTail;
         Packets = NULL;
-        QueueOperation = (Connection->ReceiveQueueCount == 0);
         Connection->ReceiveQueueCount += PacketChainLength;
         Connection->ReceiveQueueByteCount += PacketChainByteLength;
     }
@@ -2744,19 +3203,19 @@ QuicConnQueueRecvPackets(
         QUIC_RX_PACKET* Packet = Packets;
         do {
             Packet->QueuedOnConnection = FALSE;
-            QuicPacketLogDrop(Connection, Packet, "Max queue limit reached");
+            QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_QUEUE_FULL, "Max queue limit reached");
         } while ((Packet = (QUIC_RX_PACKET*)Packet->Next) != NULL);
         CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)Packets);
         return;
     }
 
     if (QueueOperation) {
-        QUIC_OPERATION* ConnOper =
-            QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_FLUSH_RECV);
-        if (ConnOper != NULL) {
-            QuicConnQueueOper(Connection, ConnOper);
-        } else {
-        }
+        //
+        // The embedded operation can't already be queued, since the receive
+        // queue was empty (i.e. any previous flush has already taken
+        // everything and won't requeue the operation).
+        //
+        QuicConnQueueOper(Connection, &Connection->FlushRecvOper);
     }
 }
 
@@ -2822,6 +3281,35 @@ QuicConnQueueRouteCompletion(
     QuicConnRelease(Connection, QUIC_CONN_REF_ROUTE);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnQueueTlsOffloadCompletion(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_OPERATION* ConnOper =
+        QuicConnAllocOperation(Connection, QUIC_OPER_TYPE_TLS_COMPLETION);
+    if (ConnOper != NULL) {
+        QuicConnQueueOper(Connection, ConnOper);
+    } else if (InterlockedCompareExchange16((short*)&Connection->BackUpOperUsed, 1, 0) == 0) {
+        //
+        // The offloaded TLS state is reclaimed when the connection is freed.
+        //
+        QUIC_OPERATION* Oper = &Connection->BackUpOper;
+        Oper->FreeAfterProcess = FALSE;
+        Oper->Type = QUIC_OPER_TYPE_API_CALL;
+        Oper->API_CALL.Context = &Connection->BackupApiContext;
+        Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SHUTDOWN;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.ErrorCode = QUIC_ERROR_INTERNAL_ERROR;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.RegistrationShutdown = FALSE;
+        Oper->API_CALL.Context->CONN_SHUTDOWN.TransportShutdown = TRUE;
+        QuicConnQueueHighestPriorityOper(Connection, Oper);
+    }
+
+    QuicConnRelease(Connection, QUIC_CONN_REF_TLS_OFFLOAD);
+}
+
 //
 // Updates the current destination CID to the received packet's source CID, if
 // not already equal. Only used during the handshake, on the client side.
@@ -2894,6 +3382,8 @@ QuicConnUpdateDestCid(
 
         if (DestCid != NULL) {
         }
+
+        QuicPathInvalidateShortHeader(&Connection->Paths[0]);
     }
 
     return TRUE;
@@ -2934,7 +3424,11 @@ QuicConnRecvVerNeg(
         // Check to see if this is the current version.
         //
         if (ServerVersion == Connection->Stats.QuicVersion && !QuicIsVersionReserved(ServerVersion)) {
-            QuicPacketLogDrop(Connection, Packet, "Version Negotation that includes the current version");
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_INVALID_PACKET,
+                "Version Negotation that includes the current version");
             return;
         }
 
@@ -2961,7 +3455,7 @@ QuicConnRecvVerNeg(
         return;
     }
 
-    Connection->PreviousQuicVersion = Connection->Stats.QuicVersion;
+    Connection->HandshakeState->PreviousQuicVersion = Connection->Stats.QuicVersion;
     Connection->Stats.QuicVersion = SupportedVersion;
     QuicConnOnQuicVersionSet(Connection);
     QUIC_STATUS Status = QuicCryptoOnVersionChange(&Connection->Crypto);
@@ -2988,7 +3482,7 @@ QuicConnRecvRetry(
     // Only clients should receive Retry packets.
     //
     if (QuicConnIsServer(Connection)) {
-        QuicPacketLogDrop(Connection, Packet, "Retry sent to server");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_UNEXPECTED, "Retry sent to server");
         return;
     }
 
@@ -2996,7 +3490,7 @@ QuicConnRecvRetry(
     // Make sure we are in the correct state of the handshake.
     //
     if (Connection->State.GotFirstServerResponse) {
-        QuicPacketLogDrop(Connection, Packet, "Already received server response");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_UNEXPECTED, "Already received server response");
         return;
     }
 
@@ -3004,7 +3498,7 @@ QuicConnRecvRetry(
     // Make sure the connection is still active
     //
     if (Connection->State.ClosedLocally || Connection->State.ClosedRemotely) {
-        QuicPacketLogDrop(Connection, Packet, "Retry while shutting down");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_UNEXPECTED, "Retry while shutting down");
         return;
     }
 
@@ -3013,12 +3507,16 @@ QuicConnRecvRetry(
     //
 
     if (Packet->AvailBufferLength - Packet->HeaderLength <= QUIC_RETRY_INTEGRITY_TAG_LENGTH_V1) {
-        QuicPacketLogDrop(Connection, Packet, "No room for Retry Token");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_INVALID_TOKEN, "No room for Retry Token");
         return;
     }
 
     if (!QuicVersionNegotiationExtIsVersionClientSupported(Connection, Packet->LH->Version)) {
-        QuicPacketLogDrop(Connection, Packet, "Retry Version not supported by client");
+        QuicPacketLogDrop(
+            Connection,
+            Packet,
+            QUIC_RECV_DROP_UNEXPECTED,
+            "Retry Version not supported by client");
     }
 
     const QUIC_VERSION_INFO* VersionInfo = NULL;
@@ -3045,13 +3543,18 @@ QuicConnRecvRetry(
 
     if (QUIC_FAILED(
         QuicPacketGenerateRetryIntegrity(
+            Connection->Partition,
             VersionInfo,
             DestCid->CID.Length,
             DestCid->CID.Data,
             Packet->AvailBufferLength - QUIC_RETRY_INTEGRITY_TAG_LENGTH_V1,
             Packet->AvailBuffer,
             CalculatedIntegrityValue))) {
-        QuicPacketLogDrop(Connection, Packet, "Failed to generate integrity field");
+        QuicPacketLogDrop(
+            Connection,
+            Packet,
+            QUIC_RECV_DROP_OUT_OF_MEMORY,
+            "Failed to generate integrity field");
         return;
     }
 
@@ -3059,7 +3562,7 @@ QuicConnRecvRetry(
             CalculatedIntegrityValue,
             Packet->AvailBuffer + (Packet->AvailBufferLength - QUIC_RETRY_INTEGRITY_TAG_LENGTH_V1),
             QUIC_RETRY_INTEGRITY_TAG_LENGTH_V1) != 0) {
-        QuicPacketLogDrop(Connection, Packet, "Invalid integrity field");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Invalid integrity field");
         return;
     }
 
@@ -3069,7 +3572,7 @@ QuicConnRecvRetry(
 
     Connection->Send.InitialToken = CXPLAT_ALLOC_PAGED(TokenLength, QUIC_POOL_INITIAL_TOKEN);
     if (Connection->Send.InitialToken == NULL) {
-        QuicPacketLogDrop(Connection, Packet, "InitialToken alloc failed");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_OUT_OF_MEMORY, "InitialToken alloc failed");
         return;
     }
 
@@ -3152,7 +3655,19 @@ QuicConnGetKeyOrDeferDatagram(
             // the packets.
             //
             CXPLAT_DBG_ASSERT(Connection->Crypto.TlsState.EarlyDataState != CXPLAT_TLS_EARLY_DATA_ACCEPTED);
-            QuicPacketLogDrop(Connection, Packet, "0-RTT not currently accepted");
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_KEY_UNAVAILABLE,
+                "0-RTT not currently accepted");
+
+        } else if (QUIC_FAILED(QuicConnEnsurePacketSpace(
+                Connection, QuicKeyTypeToEncryptLevel(Packet->KeyType)))) {
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_OUT_OF_MEMORY,
+                "Alloc failure for packet space");
 
         } else {
             QUIC_ENCRYPT_LEVEL EncryptLevel = QuicKeyTypeToEncryptLevel(Packet->KeyType);
@@ -3162,7 +3677,11 @@ QuicConnGetKeyOrDeferDatagram(
                 // We already have too many packets queued up. Just drop this
                 // one.
                 //
-                QuicPacketLogDrop(Connection, Packet, "Max deferred packet count reached");
+                QuicPacketLogDrop(
+                    Connection,
+                    Packet,
+                    QUIC_RECV_DROP_KEY_UNAVAILABLE,
+                    "Max deferred packet count reached");
 
             } else {
 
@@ -3199,7 +3718,7 @@ QuicConnGetKeyOrDeferDatagram(
         //
         // This key is no longer being accepted. Throw the packet away.
         //
-        QuicPacketLogDrop(Connection, Packet, "Key no longer accepted");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_KEY_UNAVAILABLE, "Key no longer accepted");
         return FALSE;
     }
 
@@ -3233,6 +3752,7 @@ QuicConnRecvHeader(
     if (!Packet->IsShortHeader) {
         if (Packet->Invariant->LONG_HDR.Version != Connection->Stats.QuicVersion) {
             if (QuicConnIsClient(Connection) &&
+                Connection->HandshakeState != NULL &&
                 !Connection->State.CompatibleVerNegotiationAttempted &&
                 QuicVersionNegotiationExtIsVersionCompatible(Connection, Packet->Invariant->LONG_HDR.Version)) {
                 //
@@ -3240,7 +3760,7 @@ QuicConnRecvHeader(
                 // to proceed to TP processing. The TP processing must validate
                 // this new version is the same as in the ChosenVersion field.
                 //
-                Connection->OriginalQuicVersion = Connection->Stats.QuicVersion;
+                Connection->HandshakeState->OriginalQuicVersion = Connection->Stats.QuicVersion;
                 Connection->State.CompatibleVerNegotiationAttempted = TRUE;
                 Connection->Stats.QuicVersion = Packet->Invariant->LONG_HDR.Version;
                 QuicConnOnQuicVersionSet(Connection);
@@ -3252,7 +3772,8 @@ QuicConnRecvHeader(
                 //
             } else if (QuicConnIsClient(Connection) &&
                 Packet->Invariant->LONG_HDR.Version == QUIC_VERSION_VER_NEG &&
-                !Connection->Stats.VersionNegotiation) {
+                !Connection->Stats.VersionNegotiation &&
+                Connection->HandshakeState != NULL) {
                 //
                 // Version negotiation packet received.
                 //
@@ -3261,13 +3782,22 @@ QuicConnRecvHeader(
 
                 return FALSE;
             } else {
-                QuicPacketLogDropWithValue(Connection, Packet, "Invalid version", CxPlatByteSwapUint32(Packet->Invariant->LONG_HDR.Version));
+                QuicPacketLogDropWithValue(
+                    Connection,
+                    Packet,
+                    QUIC_RECV_DROP_INVALID_PACKET,
+                    "Invalid version",
+                    CxPlatByteSwapUint32(Packet->Invariant->LONG_HDR.Version));
                 return FALSE;
             }
         }
     } else {
         if (!QuicIsVersionSupported(Connection->Stats.QuicVersion)) {
-            QuicPacketLogDrop(Connection, Packet, "SH packet during version negotiation");
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_UNEXPECTED,
+                "SH packet during version negotiation");
             return FALSE;
         }
     }
@@ -3336,7 +3866,11 @@ QuicConnRecvHeader(
                 QUIC_TOKEN_CONTENTS Token;
                 if (!QuicRetryTokenDecrypt(Packet, TokenBuffer, &Token)) {
                     CXPLAT_DBG_ASSERT(FALSE); // Was already decrypted sucessfully once.
-                    QuicPacketLogDrop(Connection, Packet, "Retry token decrypt failure");
+                    QuicPacketLogDrop(
+                        Connection,
+                        Packet,
+                        QUIC_RECV_DROP_INVALID_TOKEN,
+                        "Retry token decrypt failure");
                     return FALSE;
                 }
 
@@ -3353,7 +3887,11 @@ QuicConnRecvHeader(
                         Token.Encrypted.OrigConnIdLength,
                         QUIC_POOL_CID);
                 if (Connection->OrigDestCID == NULL) {
-                    QuicPacketLogDrop(Connection, Packet, "OrigDestCID from Retry OOM");
+                    QuicPacketLogDrop(
+                        Connection,
+                        Packet,
+                        QUIC_RECV_DROP_OUT_OF_MEMORY,
+                        "OrigDestCID from Retry OOM");
                     return FALSE;
                 }
 
@@ -3376,7 +3914,7 @@ QuicConnRecvHeader(
                     Packet->DestCidLen,
                     QUIC_POOL_CID);
             if (Connection->OrigDestCID == NULL) {
-                QuicPacketLogDrop(Connection, Packet, "OrigDestCID OOM");
+                QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_OUT_OF_MEMORY, "OrigDestCID OOM");
                 return FALSE;
             }
 
@@ -3401,16 +3939,20 @@ QuicConnRecvHeader(
             return FALSE;
         }
 
+        //
+        // With encryption offload, the datapath only decrypts the packets it
+        // can; any others are still decrypted here.
+        //
         Packet->KeyType = QUIC_PACKET_KEY_1_RTT;
         Packet->Encrypted =
             !Connection->State.Disable1RttEncrytion &&
-            !Connection->Paths[0].EncryptionOffloading;
+            !Packet->Decrypted;
     }
 
     if (Packet->Encrypted &&
         Connection->State.HeaderProtectionEnabled &&
         Packet->PayloadLength < 4 + CXPLAT_HP_SAMPLE_LENGTH) {
-        QuicPacketLogDrop(Connection, Packet, "Too short for HP");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Too short for HP");
         return FALSE;
     }
 
@@ -3513,7 +4055,7 @@ QuicConnRecvPrepareDecrypt(
     Packet->PacketNumberSet = TRUE;
 
     if (Packet->PacketNumber > QUIC_VAR_INT_MAX) {
-        QuicPacketLogDrop(Connection, Packet, "Packet number too big");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Packet number too big");
         return FALSE;
     }
 
@@ -3526,12 +4068,17 @@ QuicConnRecvPrepareDecrypt(
     //
     if (Packet->Encrypted &&
         Packet->PayloadLength < CXPLAT_ENCRYPTION_OVERHEAD) {
-        QuicPacketLogDrop(Connection, Packet, "Payload length less than encryption tag");
+        QuicPacketLogDrop(
+            Connection,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Payload length less than encryption tag");
         return FALSE;
     }
 
     QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
     if (Packet->IsShortHeader && EncryptLevel == QUIC_ENCRYPT_LEVEL_1_RTT &&
+        !Packet->Decrypted &&
         Packet->SH->KeyPhase != PacketSpace->CurrentKeyPhase) {
         if (Packet->PacketNumber < PacketSpace->ReadKeyPhaseStartPacketNumber) {
             //
@@ -3551,7 +4098,11 @@ QuicConnRecvPrepareDecrypt(
 
             QUIC_STATUS Status = QuicCryptoGenerateNewKeys(Connection);
             if (QUIC_FAILED(Status)) {
-                QuicPacketLogDrop(Connection, Packet, "Generate new packet keys");
+                QuicPacketLogDrop(
+                    Connection,
+                    Packet,
+                    QUIC_RECV_DROP_KEY_UNAVAILABLE,
+                    "Generate new packet keys");
                 return FALSE;
             }
             Packet->KeyType = QUIC_PACKET_KEY_1_RTT_NEW;
@@ -3561,6 +4112,100 @@ QuicConnRecvPrepareDecrypt(
     return TRUE;
 }
 
+//
+// Decrypts a short header packet whose payload is a single STREAM frame, for
+// a stream using app-owned receive buffers, with the frame's data written
+// straight into the app's buffer instead of in place and then copied. Only
+// the start of the payload is decrypted in place to find the frame header.
+//
+// Returns FALSE, with nothing decrypted, if the key can't decrypt in steps.
+// Otherwise returns TRUE with the result of the decryption in DecryptStatus;
+// the packet is decrypted in place if it isn't eligible.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicConnRecvDecryptToStream(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_RX_PACKET* Packet,
+    _Out_ QUIC_STATUS* DecryptStatus
+    )
+{
+    if (!Connection->State.AppOwnedRecvBuffersUsed ||
+        !Packet->IsShortHeader ||
+        Packet->PayloadLength <= CXPLAT_ENCRYPTION_OVERHEAD + QUIC_DIRECT_DECRYPT_PREFIX_LENGTH) {
+        return FALSE;
+    }
+
+    const QUIC_PACKET_KEY* Key = Connection->Crypto.TlsState.ReadKeys[Packet->KeyType];
+    uint8_t* Payload = (uint8_t*)Packet->AvailBuffer + Packet->HeaderLength;
+    const uint16_t CipherTextLength = Packet->PayloadLength - CXPLAT_ENCRYPTION_OVERHEAD;
+
+    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+    QuicCryptoCombineIvAndPacketNumber(Key->Iv, (uint8_t*)&Packet->PacketNumber, Iv);
+
+    *DecryptStatus =
+        CxPlatDecryptBegin(
+            Key->PacketKey,
+            Iv,
+            Packet->HeaderLength,
+            Packet->AvailBuffer,
+            QUIC_DIRECT_DECRYPT_PREFIX_LENGTH,
+            Payload);
+    if (*DecryptStatus == QUIC_STATUS_NOT_SUPPORTED) {
+        return FALSE;
+    }
+    if (QUIC_FAILED(*DecryptStatus)) {
+        return TRUE;
+    }
+
+    //
+    // The frame header is still unauthenticated here, but it only decides
+    // where the data goes: unwritten app buffer space, reserved so that it
+    // can't be handed out again. Whatever lands there is only delivered once
+    // the packet is authenticated and processed.
+    //
+    uint8_t* Output = Payload + QUIC_DIRECT_DECRYPT_PREFIX_LENGTH;
+    uint16_t Offset = sizeof(uint8_t);
+    QUIC_STREAM_EX Frame;
+    if (Payload[0] >= QUIC_FRAME_STREAM && Payload[0] <= QUIC_FRAME_STREAM_7 &&
+        QuicStreamFrameDecode(Payload[0], CipherTextLength, Payload, &Offset, &Frame) &&
+        Offset == CipherTextLength &&
+        Frame.Length != 0 &&
+        CipherTextLength - Frame.Length <= QUIC_DIRECT_DECRYPT_PREFIX_LENGTH) {
+
+        QUIC_STREAM* Stream = QuicStreamSetLookupStream(&Connection->Streams, Frame.StreamID);
+        if (Stream != NULL &&
+            Stream->Flags.UseAppOwnedRecvBuffers &&
+            !Stream->Flags.SentStopSending &&
+            !Stream->Flags.RemoteCloseFin &&
+            !Stream->Flags.RemoteCloseReset) {
+            uint8_t* Buffer =
+                QuicRecvBufferReserveDirectWrite(
+                    &Stream->RecvBuffer, Frame.Offset, (uint32_t)Frame.Length);
+            if (Buffer != NULL) {
+                const uint16_t PrefixDataLength =
+                    (uint16_t)(Frame.Length - (CipherTextLength - QUIC_DIRECT_DECRYPT_PREFIX_LENGTH));
+                CxPlatCopyMemory(Buffer, Frame.Data, PrefixDataLength);
+                Output = Buffer + PrefixDataLength;
+                Packet->DecryptedToStream = TRUE;
+            }
+        }
+    }
+
+    *DecryptStatus =
+        CxPlatDecryptEnd(
+            Key->PacketKey,
+            CipherTextLength - QUIC_DIRECT_DECRYPT_PREFIX_LENGTH,
+            Payload + QUIC_DIRECT_DECRYPT_PREFIX_LENGTH,
+            Output,
+            Payload + CipherTextLength);
+    if (QUIC_FAILED(*DecryptStatus)) {
+        Packet->DecryptedToStream = FALSE;
+    }
+
+    return TRUE;
+}
+
 //
 // Decrypts the packet's payload and authenticates the whole packet. On
 // successful authentication of the packet, does some final processing of the
@@ -3607,14 +4252,19 @@ QuicConnRecvDecryptAndAuthenticate(
     // Decrypt the payload with the appropriate key.
     //
     if (Packet->Encrypted) {
-        if (QUIC_FAILED(
-            CxPlatDecrypt(
-                Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->PacketKey,
-                Iv,
-                Packet->HeaderLength,   // HeaderLength
-                Packet->AvailBuffer,    // Header
-                Packet->PayloadLength,  // BufferLength
-                (uint8_t*)Payload))) {  // Buffer
+        QUIC_STATUS DecryptStatus = QUIC_STATUS_TLS_ERROR;
+        if (!Packet->DecryptFailed &&
+            !QuicConnRecvDecryptToStream(Connection, Packet, &DecryptStatus)) {
+            DecryptStatus =
+                CxPlatDecrypt(
+                    Connection->Crypto.TlsState.ReadKeys[Packet->KeyType]->PacketKey,
+                    Iv,
+                    Packet->HeaderLength,   // HeaderLength
+                    Packet->AvailBuffer,    // Header
+                    Packet->PayloadLength,  // BufferLength
+                    (uint8_t*)Payload);     // Buffer
+        }
+        if (QUIC_FAILED(DecryptStatus)) {
 
             //
             // Check for a stateless reset packet.
@@ -3651,7 +4301,7 @@ QuicConnRecvDecryptAndAuthenticate(
             if (QuicTraceLogVerboseEnabled()) {
             }
             Connection->Stats.Recv.DecryptionFailures++;
-            QuicPacketLogDrop(Connection, Packet, "Decryption failure");
+            QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_DECRYPTION_FAILURE, "Decryption failure");
             QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL);
             if (Connection->Stats.Recv.DecryptionFailures >= CXPLAT_AEAD_INTEGRITY_LIMIT) {
                 QuicConnTransportError(Connection, QUIC_ERROR_AEAD_LIMIT_REACHED);
@@ -3669,13 +4319,21 @@ QuicConnRecvDecryptAndAuthenticate(
     //
     if (Packet->IsShortHeader) {
         if (Packet->SH->Reserved != 0) {
-            QuicPacketLogDrop(Connection, Packet, "Invalid SH Reserved bits values");
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_INVALID_PACKET,
+                "Invalid SH Reserved bits values");
             QuicConnTransportError(Connection, QUIC_ERROR_PROTOCOL_VIOLATION);
             return FALSE;
         }
     } else {
         if (Packet->LH->Reserved != 0) {
-            QuicPacketLogDrop(Connection, Packet, "Invalid LH Reserved bits values");
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_INVALID_PACKET,
+                "Invalid LH Reserved bits values");
             QuicConnTransportError(Connection, QUIC_ERROR_PROTOCOL_VIOLATION);
             return FALSE;
         }
@@ -3705,7 +4363,7 @@ QuicConnRecvDecryptAndAuthenticate(
 
         if (QuicTraceLogVerboseEnabled()) {
         }
-        QuicPacketLogDrop(Connection, Packet, "Duplicate packet number");
+        QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_DUPLICATE, "Duplicate packet number");
         Connection->Stats.Recv.DuplicatePackets++;
         return FALSE;
     }
@@ -3800,7 +4458,7 @@ QuicConnRecvFrames(
     const BOOLEAN ClosingState = Connection->State.ClosedLocally && !Connection->State.ClosedRemotely;
     const uint8_t* Payload = Packet->AvailBuffer + Packet->HeaderLength;
     uint16_t PayloadLength = Packet->PayloadLength;
-    uint64_t RecvTime = CxPlatTimeUs64();
+    uint64_t RecvTime = Packet->RecvTimeUs != 0 ? Packet->RecvTimeUs : CxPlatTimeUs64();
 
     //
     // In closing state, respond to any packet with a new close frame (rate-limited).
@@ -3826,10 +4484,15 @@ QuicConnRecvFrames(
     while (Offset < PayloadLength) {
 
         //
-        // Read the frame type.
+        // Read the frame type. Every frame type defined by RFC 9000 encodes
+        // in a single byte, so take that directly and only fall back to the
+        // general variable-length decode for extension frame types.
         //
         QUIC_VAR_INT FrameType INIT_NO_SAL(0);
-        if (!QuicVarIntDecode(PayloadLength, Payload, &Offset, &FrameType)) {
+        if (Payload[Offset] < 0x40) {
+            FrameType = Payload[Offset];
+            Offset += sizeof(uint8_t);
+        } else if (!QuicVarIntDecode(PayloadLength, Payload, &Offset, &FrameType)) {
             QuicConnTransportError(Connection, QUIC_ERROR_FRAME_ENCODING_ERROR);
             return FALSE;
         }
@@ -3946,7 +4609,11 @@ QuicConnRecvFrames(
             if (QUIC_SUCCEEDED(Status)) {
                 AckEliciting = TRUE;
             } else if (Status == QUIC_STATUS_OUT_OF_MEMORY) {
-                QuicPacketLogDrop(Connection, Packet, "Crypto frame process OOM");
+                QuicPacketLogDrop(
+                    Connection,
+                    Packet,
+                    QUIC_RECV_DROP_OUT_OF_MEMORY,
+                    "Crypto frame process OOM");
                 return FALSE;
             } else {
                 if (Status == QUIC_STATUS_VER_NEG_ERROR) {
@@ -4063,7 +4730,11 @@ QuicConnRecvFrames(
                         &UpdatedFlowControl);
                 QuicStreamRelease(Stream, QUIC_STREAM_REF_LOOKUP);
                 if (Status == QUIC_STATUS_OUT_OF_MEMORY) {
-                    QuicPacketLogDrop(Connection, Packet, "Stream frame process OOM");
+                    QuicPacketLogDrop(
+                        Connection,
+                        Packet,
+                        QUIC_RECV_DROP_OUT_OF_MEMORY,
+                        "Stream frame process OOM");
                     return FALSE;
                 }
 
@@ -4439,6 +5110,28 @@ QuicConnRecvFrames(
             break;
         }
 
+        case QUIC_FRAME_FEC_SOURCE:
+        case QUIC_FRAME_FEC_REPAIR: {
+            if (!Connection->Settings.DatagramReceiveEnabled ||
+                !Connection->Settings.FecEnabled ||
+                !(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_FEC_ENABLED)) {
+                QuicConnTransportError(Connection, QUIC_ERROR_PROTOCOL_VIOLATION);
+                return FALSE;
+            }
+            if (!QuicDatagramProcessFrame(
+                    &Connection->Datagram,
+                    Packet,
+                    FrameType,
+                    PayloadLength,
+                    Payload,
+                    &Offset)) {
+                QuicConnTransportError(Connection, QUIC_ERROR_FRAME_ENCODING_ERROR);
+                return FALSE;
+            }
+            AckEliciting = TRUE;
+            break;
+        }
+
         case QUIC_FRAME_ACK_FREQUENCY: { // Always accept the frame, because we always enable support.
             QUIC_ACK_FREQUENCY_EX Frame;
             if (!QuicAckFrequencyFrameDecode(PayloadLength, Payload, &Offset, &Frame)) {
@@ -4597,6 +5290,7 @@ QuicConnRecvPostProcessing(
                 }
                 CXPLAT_DBG_ASSERT(NewDestCid != (*Path)->DestCid);
                 (*Path)->DestCid = NewDestCid;
+                QuicPathInvalidateShortHeader(*Path);
                 QUIC_CID_SET_PATH(Connection, (*Path)->DestCid, (*Path));
                 (*Path)->DestCid->CID.UsedLocally = TRUE;
             }
@@ -4661,6 +5355,102 @@ QuicConnRecvPostProcessing(
     }
 }
 
+//
+// Removes the header protection from, and decrypts, the leading packets of the
+// batch that use the current 1-RTT key phase all at once, before any of them
+// are processed further. Returns the number of packets prepared, with the
+// result of QuicConnRecvPrepareDecrypt for each in Prepared. The packets that
+// decrypted successfully are no longer marked as Encrypted.
+//
+// The packets' numbers are all decompressed against the same expected packet
+// number, which is fine since the packets of a batch are close together.
+//
+// Only done for servers; clients need the original payload of packets that
+// fail to decrypt to check them for a stateless reset.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint8_t
+QuicConnRecvDecryptBatch(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint8_t BatchCount,
+    _In_reads_(BatchCount) QUIC_RX_PACKET** Packets,
+    _In_reads_(BatchCount * CXPLAT_HP_SAMPLE_LENGTH)
+        const uint8_t* HpMask,
+    _Out_writes_to_(BatchCount, return) BOOLEAN* Prepared
+    )
+{
+    const QUIC_PACKET_KEY* Key = Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT];
+    if (BatchCount < 2 ||
+        QuicConnIsClient(Connection) ||
+        Packets[0]->KeyType != QUIC_PACKET_KEY_1_RTT ||
+        !Packets[0]->Encrypted ||
+        Key == NULL) {
+        return 0;
+    }
+
+    const QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    CXPLAT_CRYPT_BATCH_PACKET DecryptBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    QUIC_RX_PACKET* DecryptPackets[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t DecryptCount = 0;
+
+    uint8_t PreparedCount = 0;
+    for (; PreparedCount < BatchCount; ++PreparedCount) {
+        QUIC_RX_PACKET* Packet = Packets[PreparedCount];
+        const uint8_t* PacketHpMask = HpMask + PreparedCount * CXPLAT_HP_SAMPLE_LENGTH;
+
+        //
+        // Stop at the first packet of a different key phase, as preparing it
+        // may update the keys.
+        //
+        uint8_t FirstByte = Packet->AvailBuffer[0] ^ (PacketHpMask[0] & 0x1f);
+        if (!Packet->IsShortHeader ||
+            ((QUIC_SHORT_HEADER_V1*)&FirstByte)->KeyPhase != PacketSpace->CurrentKeyPhase) {
+            break;
+        }
+
+        Prepared[PreparedCount] =
+            QuicConnRecvPrepareDecrypt(Connection, Packet, PacketHpMask);
+        if (Prepared[PreparedCount]) {
+            CXPLAT_DBG_ASSERT(Packet->KeyType == QUIC_PACKET_KEY_1_RTT);
+            QUIC_STATUS DecryptStatus;
+            if (QuicConnRecvDecryptToStream(Connection, Packet, &DecryptStatus)) {
+                if (QUIC_SUCCEEDED(DecryptStatus)) {
+                    Packet->Encrypted = FALSE;
+                    Packet->PayloadLength -= CXPLAT_ENCRYPTION_OVERHEAD;
+                } else {
+                    Packet->DecryptFailed = TRUE;
+                }
+                continue;
+            }
+            DecryptBatch[DecryptCount].Header = (uint8_t*)Packet->AvailBuffer;
+            DecryptBatch[DecryptCount].PacketNumber = Packet->PacketNumber;
+            DecryptBatch[DecryptCount].HeaderLength = Packet->HeaderLength;
+            DecryptBatch[DecryptCount].PayloadLength = Packet->PayloadLength;
+            DecryptPackets[DecryptCount++] = Packet;
+        }
+    }
+
+    if (DecryptCount != 0) {
+        BOOLEAN Results[QUIC_MAX_CRYPTO_BATCH_COUNT];
+        CxPlatDecryptBatch(
+            Key->PacketKey,
+            Key->Iv,
+            DecryptCount,
+            DecryptBatch,
+            Results);
+        for (uint8_t i = 0; i < DecryptCount; ++i) {
+            if (Results[i]) {
+                DecryptPackets[i]->Encrypted = FALSE;
+                DecryptPackets[i]->PayloadLength -= CXPLAT_ENCRYPTION_OVERHEAD;
+            } else {
+                DecryptPackets[i]->DecryptFailed = TRUE;
+            }
+        }
+    }
+
+    return PreparedCount;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnRecvDatagramBatch(
@@ -4680,7 +5470,11 @@ QuicConnRecvDatagramBatch(
 
 
     if (Connection->Crypto.TlsState.ReadKeys[Packet->KeyType] == NULL) {
-        QuicPacketLogDrop(Connection, Packet, "Key no longer accepted (batch)");
+        QuicPacketLogDrop(
+            Connection,
+            Packet,
+            QUIC_RECV_DROP_KEY_UNAVAILABLE,
+            "Key no longer accepted (batch)");
         return;
     }
 
@@ -4692,56 +5486,116 @@ QuicConnRecvDatagramBatch(
                 BatchCount,
                 Cipher,
                 HpMask))) {
-            QuicPacketLogDrop(Connection, Packet, "Failed to compute HP mask");
+            QuicPacketLogDrop(
+                Connection,
+                Packet,
+                QUIC_RECV_DROP_DECRYPTION_FAILURE,
+                "Failed to compute HP mask");
             return;
         }
     } else {
         CxPlatZeroMemory(HpMask, BatchCount * CXPLAT_HP_SAMPLE_LENGTH);
     }
 
+    BOOLEAN Prepared[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    const uint8_t PreparedCount =
+        QuicConnRecvDecryptBatch(Connection, BatchCount, Packets, HpMask, Prepared);
+
     for (uint8_t i = 0; i < BatchCount; ++i) {
         CXPLAT_DBG_ASSERT(Packets[i]->Allocated);
         CXPLAT_ECN_TYPE ECN = CXPLAT_ECN_FROM_TOS(Packets[i]->TypeOfService);
         Packet = Packets[i];
         CXPLAT_DBG_ASSERT(Packet->PacketId != 0);
-        if (!QuicConnRecvPrepareDecrypt(
-                Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH) ||
+        const BOOLEAN PacketPrepared =
+            i < PreparedCount ?
+                Prepared[i] :
+                QuicConnRecvPrepareDecrypt(
+                    Connection, Packet, HpMask + i * CXPLAT_HP_SAMPLE_LENGTH);
+        if (!PacketPrepared ||
             !QuicConnRecvDecryptAndAuthenticate(Connection, Path, Packet)) {
             if (Connection->State.CompatibleVerNegotiationAttempted &&
-                !Connection->State.CompatibleVerNegotiationCompleted) {
+                !Connection->State.CompatibleVerNegotiationCompleted &&
+                Connection->HandshakeState != NULL) {
                 //
                 // The packet which initiated compatible version negotation failed
                 // decryption, so undo the version change.
                 //
-                Connection->Stats.QuicVersion = Connection->OriginalQuicVersion;
+                Connection->Stats.QuicVersion = Connection->HandshakeState->OriginalQuicVersion;
                 Connection->State.CompatibleVerNegotiationAttempted = FALSE;
             }
         } else if (QuicConnRecvFrames(Connection, Path, Packet, ECN)) {
 
+            QuicQlogPacketReceived(Connection, Packet);
             QuicConnRecvPostProcessing(Connection, &Path, Packet);
             RecvState->ResetIdleTimeout |= Packet->CompletelyValid;
 
             if (Connection->Registration != NULL && !Connection->Registration->NoPartitioning &&
                 !Path->Binding->Partitioned && !Connection->State.Partitioned && Path->IsActive &&
-                !Path->PartitionUpdated && Packet->CompletelyValid &&
-                (Packets[i]->PartitionIndex % MsQuicLib.PartitionCount) != RecvState->PartitionIndex) {
-                RecvState->PartitionIndex = Packets[i]->PartitionIndex % MsQuicLib.PartitionCount;
-                RecvState->UpdatePartitionId = TRUE;
-                Path->PartitionUpdated = TRUE;
+                !Path->PartitionUpdated && Packet->CompletelyValid) {
+                //
+                // Follow the receive (RSS) partition, unless it (or the
+                // current worker) is overloaded, in which case new CIDs are
+                // steered to the least loaded partition instead.
+                //
+                uint16_t PartitionIndex = Packets[i]->PartitionIndex % MsQuicLib.PartitionCount;
+                if (MsQuicLib.Partitions[PartitionIndex].Overloaded ||
+                    (PartitionIndex == RecvState->PartitionIndex &&
+                     QuicWorkerIsOverloaded(Connection->Worker))) {
+                    PartitionIndex = MsQuicLib.LeastLoadedPartition;
+                }
+                if (PartitionIndex != RecvState->PartitionIndex) {
+                    RecvState->PartitionIndex = PartitionIndex;
+                    RecvState->UpdatePartitionId = TRUE;
+                    Path->PartitionUpdated = TRUE;
+                }
             }
 
             if (Packet->IsShortHeader && Packet->NewLargestPacketNumber) {
 
-                if (QuicConnIsServer(Connection)) {
-                    Path->SpinBit = Packet->SH->SpinBit;
-                } else {
-                    Path->SpinBit = !Packet->SH->SpinBit;
+                const BOOLEAN SpinBit =
+                    QuicConnIsServer(Connection) ?
+                        Packet->SH->SpinBit : !Packet->SH->SpinBit;
+                if (Path->SpinBit != SpinBit) {
+                    Path->SpinBit = SpinBit;
+                    QuicPathInvalidateShortHeader(Path);
                 }
             }
         }
     }
 }
 
+//
+// Returns a chain of processed packets to the datapath. Packets whose payload
+// is still referenced by a stream receive buffer are left for the stream to
+// return once the app completes the receive.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnReturnRecvPackets(
+    _In_ QUIC_RX_PACKET* Packets
+    )
+{
+    QUIC_RX_PACKET* ReturnChain = NULL;
+    QUIC_RX_PACKET** ReturnChainTail = &ReturnChain;
+
+    while (Packets != NULL) {
+        QUIC_RX_PACKET* Packet = Packets;
+        Packets = (QUIC_RX_PACKET*)Packet->Next;
+        Packet->Next = NULL;
+
+        if (Packet->HeldByStream) {
+            Packet->ReleasedByConnection = TRUE;
+        } else {
+            *ReturnChainTail = Packet;
+            ReturnChainTail = (QUIC_RX_PACKET**)&Packet->Next;
+        }
+    }
+
+    if (ReturnChain != NULL) {
+        CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReturnChain);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnRecvDatagrams(
@@ -4793,7 +5647,7 @@ QuicConnRecvDatagrams(
 
         QUIC_PATH* DatagramPath = QuicConnGetPathForPacket(Connection, Packet);
         if (DatagramPath == NULL) {
-            QuicPacketLogDrop(Connection, Packet, "Max paths already tracked");
+            QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_QUEUE_FULL, "Max paths already tracked");
             goto Drop;
         }
 
@@ -4940,7 +5794,8 @@ QuicConnRecvDatagrams(
                         &RecvState);
                     BatchCount = 0;
                 }
-                CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+                QuicDatagramFlushRecvBatch(&Connection->Datagram);
+                QuicConnReturnRecvPackets(ReleaseChain);
                 ReleaseChain = NULL;
                 ReleaseChainTail = &ReleaseChain;
                 ReleaseChainCount = 0;
@@ -4959,6 +5814,12 @@ QuicConnRecvDatagrams(
         BatchCount = 0; // cppcheck-suppress unreadVariable; NOLINT
     }
 
+    //
+    // Batched datagram indications reference the packets' buffers, so they must
+    // be delivered before the packets are returned below.
+    //
+    QuicDatagramFlushRecvBatch(&Connection->Datagram);
+
     if (Connection->State.DelayedApplicationError && Connection->CloseStatus == 0) {
         //
         // We received transport APPLICATION_ERROR, but didn't receive the expected
@@ -4978,7 +5839,7 @@ QuicConnRecvDatagrams(
     }
 
     if (ReleaseChain != NULL) {
-        CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)ReleaseChain);
+        QuicConnReturnRecvPackets(ReleaseChain);
     }
 
     if (QuicConnIsServer(Connection) &&
@@ -5034,8 +5895,9 @@ QuicConnFlushRecv(
         ReceiveQueueByteCount = 0;
         while (++ReceiveQueueCount < QUIC_MAX_RECEIVE_FLUSH_COUNT) {
             ReceiveQueueByteCount += Tail->BufferLength;
-            Tail = Connection->ReceiveQueue;
+            Tail = (QUIC_RX_PACKET*)Tail->Next;
         }
+        ReceiveQueueByteCount += Tail->BufferLength;
         Connection->ReceiveQueueByteCount -= ReceiveQueueByteCount;
         Connection->ReceiveQueue = (QUIC_RX_PACKET*)Tail->Next;
         Tail->Next = NULL;
@@ -5048,14 +5910,40 @@ QuicConnFlushRecv(
         Connection->ReceiveQueue = NULL;
         Connection->ReceiveQueueTail = &Connection->ReceiveQueue;
     }
+    const uint64_t RecvQueueTime = Connection->Stats.Handshake.RecvQueueTime;
+    Connection->Stats.Handshake.RecvQueueTime = 0;
     CxPlatDispatchLockRelease(&Connection->ReceiveQueueLock);
 
+    if (RecvQueueTime != 0) {
+        Connection->Stats.Handshake.QueueDelay +=
+            (uint32_t)CxPlatTimeDiff64(RecvQueueTime, CxPlatTimeUs64());
+    }
+
+    QuicWorkerRecordMetric(
+        Connection->Worker, QUIC_METRIC_HISTOGRAM_RECV_BATCH_SIZE, ReceiveQueueCount);
     QuicConnRecvDatagrams(
         Connection, ReceiveQueue, ReceiveQueueCount, ReceiveQueueByteCount, FALSE);
 
     return FlushedAll;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnEnsurePacketSpace(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_ENCRYPT_LEVEL EncryptLevel
+    )
+{
+    if (Connection->Packets[EncryptLevel] != NULL) {
+        return QUIC_STATUS_SUCCESS;
+    }
+    return
+        QuicPacketSpaceInitialize(
+            Connection,
+            EncryptLevel,
+            &Connection->Packets[EncryptLevel]);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicConnDiscardDeferred0Rtt(
@@ -5065,7 +5953,9 @@ QuicConnDiscardDeferred0Rtt(
     QUIC_RX_PACKET* ReleaseChain = NULL;
     QUIC_RX_PACKET** ReleaseChainTail = &ReleaseChain;
     QUIC_PACKET_SPACE* Packets = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
-    CXPLAT_DBG_ASSERT(Packets != NULL);
+    if (Packets == NULL) {
+        return; // Nothing was ever deferred.
+    }
 
     QUIC_RX_PACKET* DeferredPackets = Packets->DeferredPackets;
     QUIC_RX_PACKET** DeferredPacketsTail = &Packets->DeferredPackets;
@@ -5076,7 +5966,7 @@ QuicConnDiscardDeferred0Rtt(
         DeferredPackets = (QUIC_RX_PACKET*)DeferredPackets->Next;
 
         if (Packet->KeyType == QUIC_PACKET_KEY_0_RTT) {
-            QuicPacketLogDrop(Connection, Packet, "0-RTT rejected");
+            QuicPacketLogDrop(Connection, Packet, QUIC_RECV_DROP_KEY_UNAVAILABLE, "0-RTT rejected");
             Packets->DeferredPacketsCount--;
             *ReleaseChainTail = Packet;
             ReleaseChainTail = (QUIC_RX_PACKET**)&Packet->Next;
@@ -5266,32 +6156,129 @@ QuicConnProcessIdleTimerOperation(
         NULL);
 }
 
+//
+// Releases memory a quiet connection doesn't currently need: grown receive
+// buffers that have been fully drained, oversized ACK range arrays and an
+// empty stream table. Everything is reallocated lazily on the next packet or
+// app send that needs it.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
+static
 void
-QuicConnProcessKeepAliveOperation(
+QuicConnHibernate(
     _In_ QUIC_CONNECTION* Connection
     )
 {
-    //
-    // Send a PING frame to keep the connection alive.
-    //
-    Connection->Send.TailLossProbeNeeded = TRUE;
-    QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PING);
-
-    //
-    // Restart the keep alive timer.
-    //
-    QuicConnTimerSet(
-        Connection,
-        QUIC_CONN_TIMER_KEEP_ALIVE,
-        MS_TO_US(Connection->Settings.KeepAliveIntervalMs));
+    QuicStreamSetHibernate(&Connection->Streams);
+    QuicRangeCompact(&Connection->DecodedAckRanges);
+    for (uint32_t i = 0; i < ARRAYSIZE(Connection->Packets); i++) {
+        if (Connection->Packets[i] != NULL) {
+            QuicRangeCompact(&Connection->Packets[i]->AckTracker.PacketNumbersReceived);
+            QuicRangeCompact(&Connection->Packets[i]->AckTracker.PacketNumbersToAck);
+        }
+    }
+    if (Connection->Crypto.Initialized) {
+        (void)QuicRecvBufferShrink(
+            &Connection->Crypto.RecvBuffer,
+            QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE);
+        QuicRangeCompact(&Connection->Crypto.SparseAckRanges);
+    }
 }
 
+//
+// Records the current network statistics in the sample ring and schedules the
+// next sample.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicConnUpdatePeerPacketTolerance(
-    _In_ QUIC_CONNECTION* Connection,
-    _In_ uint8_t NewPacketTolerance
+QuicConnProcessStatsSampleTimerOperation(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_CONN_STATS_SAMPLES* StatsSamples = Connection->StatsSamples;
+    if (StatsSamples == NULL) {
+        return;
+    }
+
+    QUIC_NETWORK_STATISTICS NetStats;
+    CxPlatZeroMemory(&NetStats, sizeof(NetStats));
+    Connection->CongestionControl.QuicCongestionControlGetNetworkStatistics(
+        Connection, &Connection->CongestionControl, &NetStats);
+
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    QUIC_NETWORK_STATISTICS_SAMPLE* Sample =
+        &StatsSamples->Samples[StatsSamples->Count % StatsSamples->Capacity];
+    Sample->TimeUs = CxPlatTimeDiff64(Connection->Stats.Timing.Start, CxPlatTimeUs64());
+    Sample->SmoothedRtt = Path->SmoothedRtt;
+    Sample->MinRtt = Path->MinRtt;
+    Sample->RttVariance = Path->RttVariance;
+    Sample->Bandwidth = NetStats.Bandwidth;
+    Sample->LostPackets = Connection->Stats.Send.SuspectedLostPackets;
+    Sample->CongestionWindow = NetStats.CongestionWindow;
+    Sample->BytesInFlight = NetStats.BytesInFlight;
+    StatsSamples->Count++;
+
+    QuicConnTimerSet(
+        Connection,
+        QUIC_CONN_TIMER_STATS_SAMPLE,
+        MS_TO_US((uint64_t)StatsSamples->IntervalMs));
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnProcessHibernateTimerOperation(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->Settings.IdleHibernateTimeoutMs == 0) {
+        return;
+    }
+
+    //
+    // Only stream data counts as activity. Keep alives and the ACKs for them
+    // carry on while the connection is hibernated.
+    //
+    const uint64_t StreamBytes =
+        Connection->Stats.Send.TotalStreamBytes +
+        Connection->Stats.Recv.TotalStreamBytes;
+    if (StreamBytes == Connection->HibernateStreamBytes) {
+        QuicConnHibernate(Connection);
+    } else {
+        Connection->HibernateStreamBytes = StreamBytes;
+    }
+
+    QuicConnTimerSet(
+        Connection,
+        QUIC_CONN_TIMER_HIBERNATE,
+        MS_TO_US(Connection->Settings.IdleHibernateTimeoutMs));
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnProcessKeepAliveOperation(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    //
+    // Send a PING frame to keep the connection alive.
+    //
+    Connection->Send.TailLossProbeNeeded = TRUE;
+    QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PING);
+
+    //
+    // Restart the keep alive timer.
+    //
+    QuicConnTimerSet(
+        Connection,
+        QUIC_CONN_TIMER_KEEP_ALIVE,
+        MS_TO_US(Connection->Settings.KeepAliveIntervalMs));
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnUpdatePeerPacketTolerance(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint8_t NewPacketTolerance
     )
 {
     if (Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY &&
@@ -5564,6 +6551,11 @@ QuicConnParamSet(
         Connection->State.UseRoundRobinStreamScheduling =
             Scheme == QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN;
 
+        BOOLEAN UseUrgency = Scheme == QUIC_STREAM_SCHEDULING_SCHEME_URGENCY;
+        if (Connection->State.UseUrgencyStreamScheduling != UseUrgency) {
+            Connection->State.UseUrgencyStreamScheduling = UseUrgency;
+            QuicSendUpdateStreamScheduling(&Connection->Send);
+        }
 
         Status = QUIC_STATUS_SUCCESS;
         break;
@@ -5695,8 +6687,10 @@ QuicConnParamSet(
             break;
         }
 
-        Connection->TlsSecrets = (QUIC_TLS_SECRETS*)Buffer;
-        CxPlatZeroMemory(Connection->TlsSecrets, sizeof(*Connection->TlsSecrets));
+        Connection->HandshakeState->TlsSecrets = (QUIC_TLS_SECRETS*)Buffer;
+        CxPlatZeroMemory(
+            Connection->HandshakeState->TlsSecrets,
+            sizeof(*Connection->HandshakeState->TlsSecrets));
         Status = QUIC_STATUS_SUCCESS;
         break;
 
@@ -5773,6 +6767,112 @@ QuicConnParamSet(
 
         break;
 
+    case QUIC_PARAM_CONN_DATAGRAM_CLASS_RATES:
+        if (BufferLength != sizeof(Connection->Datagram.ClassRates) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QuicDatagramSetClassRates(&Connection->Datagram, (const uint32_t*)Buffer);
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_NETWORK_STATISTICS_SAMPLING: {
+
+        if (BufferLength != sizeof(QUIC_NETWORK_STATISTICS_SAMPLING) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_NETWORK_STATISTICS_SAMPLING* Sampling =
+            (const QUIC_NETWORK_STATISTICS_SAMPLING*)Buffer;
+        const uint32_t Capacity =
+            Sampling->SampleCount == 0 ?
+                QUIC_STATS_SAMPLES_DEFAULT_COUNT : Sampling->SampleCount;
+        if (Capacity > QUIC_STATS_SAMPLES_MAX_COUNT) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (Connection->StatsSamples != NULL) {
+            CXPLAT_FREE(Connection->StatsSamples, QUIC_POOL_STATS_SAMPLES);
+            Connection->StatsSamples = NULL;
+        }
+        QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_STATS_SAMPLE);
+
+        if (Sampling->IntervalMs != 0) {
+            if (QuicConnIsClosed(Connection)) {
+                Status = QUIC_STATUS_INVALID_STATE;
+                break;
+            }
+
+            QUIC_CONN_STATS_SAMPLES* StatsSamples =
+                CXPLAT_ALLOC_NONPAGED(
+                    sizeof(QUIC_CONN_STATS_SAMPLES) +
+                    Capacity * sizeof(QUIC_NETWORK_STATISTICS_SAMPLE),
+                    QUIC_POOL_STATS_SAMPLES);
+            if (StatsSamples == NULL) {
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+                break;
+            }
+            StatsSamples->IntervalMs = Sampling->IntervalMs;
+            StatsSamples->Capacity = Capacity;
+            StatsSamples->Count = 0;
+            Connection->StatsSamples = StatsSamples;
+            QuicConnProcessStatsSampleTimerOperation(Connection);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_PARALLEL_PROTECTION: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (!*(BOOLEAN*)Buffer) {
+            QuicConnFreeProtectOffloads(Connection);
+            Status = QUIC_STATUS_SUCCESS;
+            break;
+        }
+
+        if (Connection->ProtectOffloads != NULL) {
+            Status = QUIC_STATUS_SUCCESS;
+            break;
+        }
+
+        if (QuicConnIsClosed(Connection)) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        Status = QuicLibraryStartProtectOffload();
+        if (QUIC_FAILED(Status)) {
+            break;
+        }
+
+        QUIC_PROTECT_OFFLOAD* ProtectOffloads =
+            CXPLAT_ALLOC_NONPAGED(
+                QUIC_MAX_PROTECT_OFFLOADS * sizeof(QUIC_PROTECT_OFFLOAD),
+                QUIC_POOL_PROTECT_OFFLOAD);
+        if (ProtectOffloads == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            break;
+        }
+        CxPlatZeroMemory(
+            ProtectOffloads, QUIC_MAX_PROTECT_OFFLOADS * sizeof(QUIC_PROTECT_OFFLOAD));
+        for (uint32_t i = 0; i < QUIC_MAX_PROTECT_OFFLOADS; ++i) {
+            CxPlatListInitializeHead(&ProtectOffloads[i].Link);
+        }
+        Connection->ProtectOffloads = ProtectOffloads;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
     //
     // Private
     //
@@ -5828,7 +6928,7 @@ QuicConnParamSet(
         }
 
         CxPlatCopyMemory(
-            &Connection->TestTransportParameter, Buffer, BufferLength);
+            &Connection->HandshakeState->TestTransportParameter, Buffer, BufferLength);
         Connection->State.TestTransportParameterSet = TRUE;
 
 
@@ -5859,6 +6959,84 @@ QuicConnParamSet(
         break;
 #endif
 
+    case QUIC_PARAM_CONN_SEND_CORK_TIMEOUT: {
+
+        if (BufferLength != sizeof(uint32_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const uint32_t CorkTimeoutUs = *(uint32_t*)Buffer;
+        if (CorkTimeoutUs > QUIC_MAX_SEND_CORK_TIMEOUT_US) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->Send.CorkTimeoutUs = CorkTimeoutUs;
+        if (CorkTimeoutUs == 0) {
+            QuicSendUncork(&Connection->Send, REASON_STREAM_FLAGS);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_DATAGRAM_RECEIVE_BATCHING:
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->Datagram.RecvBatchEnabled = *(BOOLEAN*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_EGRESS_RATE_LIMIT:
+
+        if (BufferLength != sizeof(uint64_t) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Start the bucket out full at the new rate, and don't leave sends
+        // waiting on the old one.
+        //
+        Connection->Send.EgressRateLimit = *(uint64_t*)Buffer;
+        Connection->Send.EgressRefillTime = 0;
+        Connection->Send.EgressTokens = 0;
+        QuicSendQueueFlush(&Connection->Send, REASON_SCHEDULING);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_SCHEDULING_WEIGHT:
+
+        if (BufferLength != sizeof(uint8_t) || Buffer == NULL ||
+            *(uint8_t*)Buffer == 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->SchedulingWeight = *(uint8_t*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_TAIL_PROTECTION:
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Connection->LossDetection.TailProbeEnabled = *(BOOLEAN*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -5967,6 +7145,52 @@ QuicConnGetV2Statistics(
     if (STATISTICS_HAS_FIELD(*StatsLength, RttVariance)) {
         Stats->RttVariance = (uint32_t)Path->RttVariance;
     }
+    if (STATISTICS_HAS_FIELD(*StatsLength, DrainBudget)) {
+        Stats->DrainBudget = Connection->Stats.Schedule.DrainBudget;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendPacketFillPercent)) {
+        Stats->SendPacketFillPercent =
+            Connection->Stats.Send.PacketCapacityBytes == 0 ? 0 :
+            (uint32_t)(
+                (Connection->Stats.Send.PacketFillBytes * 100) /
+                Connection->Stats.Send.PacketCapacityBytes);
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SlowStartExitReason)) {
+        Stats->SlowStartExitReason = Connection->Stats.Send.SlowStartExitReason;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SlowStartExitCongestionWindow)) {
+        Stats->SlowStartExitCongestionWindow = Connection->Stats.Send.SlowStartExitWindow;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendSpuriousRetransmissions)) {
+        Stats->SendSpuriousRetransmissions = Connection->Stats.Send.SpuriousRetransmissions;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendPacketReorderThreshold)) {
+        Stats->SendPacketReorderThreshold = Connection->LossDetection.PacketReorderThreshold;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendReorderWindowMultiplier)) {
+        Stats->SendReorderWindowMultiplier = Connection->LossDetection.ReorderWindowMultiplier;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, SendFecRepairSymbols)) {
+        Stats->SendFecRepairSymbols = Connection->Stats.Send.FecRepairSymbols;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, RecvFecRecoveredDatagrams)) {
+        Stats->RecvFecRecoveredDatagrams = Connection->Stats.Recv.FecRecoveredDatagrams;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, TimingHandshakeComplete)) {
+        Stats->TimingHandshakeComplete =
+            IsPlat ?
+                CxPlatTimeUs64ToPlat(Connection->Stats.Timing.HandshakeComplete) :
+                Connection->Stats.Timing.HandshakeComplete;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, HandshakeQueueDelay)) {
+        Stats->HandshakeQueueDelay = Connection->Stats.Handshake.QueueDelay;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, HandshakeTlsTime)) {
+        Stats->HandshakeTlsTime = Connection->Stats.Handshake.TlsTime;
+    }
+    if (STATISTICS_HAS_FIELD(*StatsLength, HandshakeCertValidationTime)) {
+        Stats->HandshakeCertValidationTime = Connection->Stats.Handshake.CertValidationTime;
+    }
 
     *StatsLength = CXPLAT_MIN(*StatsLength, sizeof(QUIC_STATISTICS_V2));
 
@@ -6290,6 +7514,8 @@ QuicConnParamGet(
 
         *BufferLength = sizeof(QUIC_STREAM_SCHEDULING_SCHEME);
         *(QUIC_STREAM_SCHEDULING_SCHEME*)Buffer =
+            Connection->State.UseUrgencyStreamScheduling ?
+                QUIC_STREAM_SCHEDULING_SCHEME_URGENCY :
             Connection->State.UseRoundRobinStreamScheduling ?
                 QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN : QUIC_STREAM_SCHEDULING_SCHEME_FIFO;
 
@@ -6442,6 +7668,193 @@ QuicConnParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_CONN_DATAGRAM_CLASS_RATES:
+
+        if (*BufferLength < sizeof(Connection->Datagram.ClassRates)) {
+            *BufferLength = sizeof(Connection->Datagram.ClassRates);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(Connection->Datagram.ClassRates);
+        CxPlatCopyMemory(
+            Buffer,
+            Connection->Datagram.ClassRates,
+            sizeof(Connection->Datagram.ClassRates));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_QLOG:
+        Status = QuicQlogGet(Connection, BufferLength, Buffer);
+        break;
+
+    case QUIC_PARAM_CONN_NETWORK_STATISTICS_SAMPLING: {
+
+        const QUIC_CONN_STATS_SAMPLES* StatsSamples = Connection->StatsSamples;
+        if (StatsSamples == NULL) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const uint32_t Count =
+            (uint32_t)CXPLAT_MIN(StatsSamples->Count, (uint64_t)StatsSamples->Capacity);
+        Length = Count * sizeof(QUIC_NETWORK_STATISTICS_SAMPLE);
+        if (*BufferLength < Length) {
+            *BufferLength = Length;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL && Length != 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Copy out oldest first: from the next slot to be overwritten to the
+        // end of the ring, then from its start.
+        //
+        const uint32_t Start =
+            Count < StatsSamples->Capacity ?
+                0 : (uint32_t)(StatsSamples->Count % StatsSamples->Capacity);
+        const uint32_t FirstCount = Count - Start;
+        QUIC_NETWORK_STATISTICS_SAMPLE* Samples = (QUIC_NETWORK_STATISTICS_SAMPLE*)Buffer;
+        if (Count != 0) {
+            CxPlatCopyMemory(
+                Samples,
+                StatsSamples->Samples + Start,
+                FirstCount * sizeof(QUIC_NETWORK_STATISTICS_SAMPLE));
+            CxPlatCopyMemory(
+                Samples + FirstCount,
+                StatsSamples->Samples,
+                Start * sizeof(QUIC_NETWORK_STATISTICS_SAMPLE));
+        }
+
+        *BufferLength = Length;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_CONN_PARALLEL_PROTECTION:
+
+        if (*BufferLength < sizeof(BOOLEAN)) {
+            *BufferLength = sizeof(BOOLEAN);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(BOOLEAN);
+        *(BOOLEAN*)Buffer = Connection->ProtectOffloads != NULL;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_SEND_CORK_TIMEOUT:
+
+        if (*BufferLength < sizeof(uint32_t)) {
+            *BufferLength = sizeof(uint32_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint32_t);
+        *(uint32_t*)Buffer = Connection->Send.CorkTimeoutUs;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_DATAGRAM_RECEIVE_BATCHING:
+
+        if (*BufferLength < sizeof(BOOLEAN)) {
+            *BufferLength = sizeof(BOOLEAN);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(BOOLEAN);
+        *(BOOLEAN*)Buffer = Connection->Datagram.RecvBatchEnabled;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_EGRESS_RATE_LIMIT:
+
+        if (*BufferLength < sizeof(uint64_t)) {
+            *BufferLength = sizeof(uint64_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint64_t);
+        *(uint64_t*)Buffer = Connection->Send.EgressRateLimit;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_SCHEDULING_WEIGHT:
+
+        if (*BufferLength < sizeof(uint8_t)) {
+            *BufferLength = sizeof(uint8_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint8_t);
+        *(uint8_t*)Buffer = Connection->SchedulingWeight;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_CONN_TAIL_PROTECTION:
+
+        if (*BufferLength < sizeof(BOOLEAN)) {
+            *BufferLength = sizeof(BOOLEAN);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(BOOLEAN);
+        *(BOOLEAN*)Buffer = Connection->LossDetection.TailProbeEnabled;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -6458,6 +7871,11 @@ QuicConnApplyNewSettings(
     _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
     )
 {
+    //
+    // The offload itself may be (or have been) unavailable, so only changes
+    // to the setting matter.
+    //
+    const BOOLEAN EncryptionOffloadAllowed = Connection->Settings.EncryptionOffloadAllowed;
 
     if (!QuicSettingApply(
             &Connection->Settings,
@@ -6469,7 +7887,7 @@ QuicConnApplyNewSettings(
 
     if (!Connection->State.Started) {
 
-        Connection->Paths[0].SmoothedRtt = MS_TO_US(Connection->Settings.InitialRttMs);
+        Connection->Paths[0].SmoothedRtt = QuicConnGetInitialRtt(Connection);
         Connection->Paths[0].RttVariance = Connection->Paths[0].SmoothedRtt / 2;
         Connection->Paths[0].Mtu = Connection->Settings.MinimumMtu;
 
@@ -6486,6 +7904,7 @@ QuicConnApplyNewSettings(
         }
 
         QuicSendApplyNewSettings(&Connection->Send, &Connection->Settings);
+        QuicCongestionControlUninitialize(&Connection->CongestionControl);
         QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
 
         if (QuicConnIsClient(Connection) && Connection->Settings.IsSet.VersionSettings) {
@@ -6513,6 +7932,7 @@ QuicConnApplyNewSettings(
             (void)CxPlatRandom(sizeof(RandomValue), &RandomValue);
             Connection->State.FixedBit = (RandomValue % 2);
             Connection->Stats.GreaseBitNegotiated = TRUE;
+            QuicConnInvalidateShortHeaders(Connection);
         }
 
         if (QuicConnIsServer(Connection) && Connection->Settings.ReliableResetEnabled) {
@@ -6553,7 +7973,7 @@ QuicConnApplyNewSettings(
     }
 
     if (Connection->State.Started &&
-        (Connection->Settings.EncryptionOffloadAllowed ^ Connection->Paths[0].EncryptionOffloading)) {
+        Connection->Settings.EncryptionOffloadAllowed != EncryptionOffloadAllowed) {
         // TODO: enable/disable after start
         CXPLAT_FRE_ASSERT(FALSE);
     }
@@ -6643,6 +8063,17 @@ QuicConnProcessApiOperation(
             QuicConnSetConfiguration(
                 Connection,
                 ApiCtx->CONN_SET_CONFIGURATION.Configuration);
+        if (QUIC_FAILED(Status) && QuicConnIsClient(Connection)) {
+            //
+            // Clients only get here to start a deferred handshake, so there is
+            // nothing left to do with the connection.
+            //
+            QuicConnCloseLocally(
+                Connection,
+                QUIC_CLOSE_INTERNAL_SILENT | QUIC_CLOSE_QUIC_STATUS,
+                (uint64_t)Status,
+                NULL);
+        }
         break;
 
     case QUIC_API_TYPE_CONN_SEND_RESUMPTION_TICKET:
@@ -6691,11 +8122,56 @@ QuicConnProcessApiOperation(
                 FALSE);
         break;
 
+    case QUIC_API_TYPE_STRM_START_BATCH:
+        //
+        // Each stream indicates its own start completion; any send work is
+        // coalesced into the connection's next flush.
+        //
+        for (uint32_t i = 0; i < ApiCtx->STRM_START_BATCH.StreamCount; ++i) {
+            (void)QuicStreamStart(
+                ApiCtx->STRM_START_BATCH.Streams[i],
+                ApiCtx->STRM_START_BATCH.Flags,
+                FALSE);
+        }
+        break;
+
+    case QUIC_API_TYPE_CONN_EXECUTE: {
+        QUIC_WORKER* Worker = Connection->Worker;
+        const QUIC_WORKER_ACTIVITY_TYPE PrevActivity =
+            Worker != NULL ?
+                QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_APP_CALLBACK) :
+                QUIC_WORKER_ACTIVITY_OTHER;
+        ApiCtx->CONN_EXECUTE.Handler(
+            ApiCtx->CONN_EXECUTE.Connection,
+            ApiCtx->CONN_EXECUTE.Context,
+            Connection->State.HandleClosed ? QUIC_STATUS_ABORTED : QUIC_STATUS_SUCCESS);
+        if (Worker != NULL) {
+            QuicWorkerSetActivity(Worker, PrevActivity);
+        }
+        break;
+    }
+
     case QUIC_API_TYPE_STRM_SEND:
         QuicStreamSendFlush(
             ApiCtx->STRM_SEND.Stream);
         break;
 
+    case QUIC_API_TYPE_STRM_SEND_BATCH:
+        //
+        // Flushing a stream more than once is harmless: the first flush takes
+        // all its queued requests.
+        //
+        for (uint32_t i = 0; i < ApiCtx->STRM_SEND_BATCH.EntryCount; ++i) {
+            QUIC_STREAM_SEND_BATCH_ENTRY* Entry = &ApiCtx->STRM_SEND_BATCH.Entries[i];
+            if (Entry->Rejected != NULL) {
+                QuicStreamCompleteSendRequest(Entry->Stream, Entry->Rejected, TRUE, FALSE);
+                Entry->Rejected = NULL;
+            } else {
+                QuicStreamSendFlush(Entry->Stream);
+            }
+        }
+        break;
+
     case QUIC_API_TYPE_STRM_RECV_COMPLETE:
         QuicStreamReceiveCompletePending(
             ApiCtx->STRM_RECV_COMPLETE.Stream);
@@ -6780,15 +8256,47 @@ QuicConnProcessExpiredTimer(
     case QUIC_CONN_TIMER_KEEP_ALIVE:
         QuicConnProcessKeepAliveOperation(Connection);
         break;
+    case QUIC_CONN_TIMER_HIBERNATE:
+        QuicConnProcessHibernateTimerOperation(Connection);
+        break;
+    case QUIC_CONN_TIMER_STATS_SAMPLE:
+        QuicConnProcessStatsSampleTimerOperation(Connection);
+        break;
     case QUIC_CONN_TIMER_SHUTDOWN:
         QuicConnProcessShutdownTimerOperation(Connection);
         break;
+    case QUIC_CONN_TIMER_CORK:
+        QuicSendUncork(&Connection->Send, REASON_CORK_TIMEOUT);
+        break;
+    case QUIC_CONN_TIMER_RECV_BATCH:
+        QuicStreamSetProcessRecvBatchTimer(&Connection->Streams);
+        break;
     default:
         CXPLAT_FRE_ASSERT(FALSE);
         break;
     }
 }
 
+//
+// What the worker is doing while processing each type of operation.
+//
+static const uint8_t QuicOperActivity[] = {
+    QUIC_WORKER_ACTIVITY_OTHER,     // QUIC_OPER_TYPE_API_CALL
+    QUIC_WORKER_ACTIVITY_RECEIVE,   // QUIC_OPER_TYPE_FLUSH_RECV
+    QUIC_WORKER_ACTIVITY_RECEIVE,   // QUIC_OPER_TYPE_UNREACHABLE
+    QUIC_WORKER_ACTIVITY_RECEIVE,   // QUIC_OPER_TYPE_FLUSH_STREAM_RECV
+    QUIC_WORKER_ACTIVITY_SEND,      // QUIC_OPER_TYPE_FLUSH_SEND
+    QUIC_WORKER_ACTIVITY_OTHER,     // QUIC_OPER_TYPE_DEPRECATED
+    QUIC_WORKER_ACTIVITY_TIMERS,    // QUIC_OPER_TYPE_TIMER_EXPIRED
+    QUIC_WORKER_ACTIVITY_OTHER,     // QUIC_OPER_TYPE_TRACE_RUNDOWN
+    QUIC_WORKER_ACTIVITY_OTHER,     // QUIC_OPER_TYPE_ROUTE_COMPLETION
+    QUIC_WORKER_ACTIVITY_CRYPTO,    // QUIC_OPER_TYPE_TLS_COMPLETION
+    QUIC_WORKER_ACTIVITY_OTHER,     // QUIC_OPER_TYPE_DRAIN
+};
+CXPLAT_STATIC_ASSERT(
+    ARRAYSIZE(QuicOperActivity) == QUIC_OPER_TYPE_DRAIN + 1,
+    "Every connection operation type has an activity");
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicConnDrainOperations(
@@ -6797,10 +8305,19 @@ QuicConnDrainOperations(
     )
 {
     QUIC_OPERATION* Oper;
+    //
+    // Unless the app explicitly configured a limit, use the worker's adaptive
+    // budget.
+    //
     const uint32_t MaxOperationCount =
-        Connection->Settings.MaxOperationsPerDrain;
+        Connection->Settings.IsSet.MaxOperationsPerDrain ?
+            Connection->Settings.MaxOperationsPerDrain :
+            Connection->Worker->DrainBudget;
+    Connection->Stats.Schedule.DrainBudget = (uint8_t)MaxOperationCount;
     uint32_t OperationCount = 0;
     BOOLEAN HasMoreWorkToDo = TRUE;
+    QUIC_WORKER* Worker = Connection->Worker;
+    const QUIC_WORKER_ACTIVITY_TYPE PrevActivity = Worker->Activity;
 
     CXPLAT_PASSIVE_CODE();
 
@@ -6834,6 +8351,8 @@ QuicConnDrainOperations(
         }
 
         QuicOperLog(Connection, Oper);
+        CXPLAT_DBG_ASSERT(Oper->Type < ARRAYSIZE(QuicOperActivity));
+        QuicWorkerSetActivity(Worker, (QUIC_WORKER_ACTIVITY_TYPE)QuicOperActivity[Oper->Type]);
 
         BOOLEAN FreeOper = Oper->FreeAfterProcess;
 
@@ -6914,11 +8433,30 @@ QuicConnDrainOperations(
                 Connection, Oper->ROUTE.PhysicalAddress, Oper->ROUTE.PathId, Oper->ROUTE.Succeeded);
             break;
 
+        case QUIC_OPER_TYPE_TLS_COMPLETION:
+            QuicCryptoProcessOffloadComplete(&Connection->Crypto);
+            break;
+
+        case QUIC_OPER_TYPE_DRAIN:
+            Connection->State.DrainRequested = TRUE;
+            break;
+
         default:
             CXPLAT_FRE_ASSERT(FALSE);
             break;
         }
 
+        if (Connection->Send.BufferFillPending) {
+            //
+            // The app sent inline from a callback during this operation.
+            //
+            Connection->Send.BufferFillPending = FALSE;
+            if (Connection->Settings.SendBufferingEnabled &&
+                !Connection->State.ShutdownComplete) {
+                QuicSendBufferFill(Connection);
+            }
+        }
+
         QuicConnValidate(Connection);
 
         if (FreeOper) {
@@ -6929,6 +8467,10 @@ QuicConnDrainOperations(
         QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_OPER_COMPLETED);
     }
 
+    if (Connection->State.DrainRequested) {
+        QuicConnTryDrain(Connection);
+    }
+
     if (Connection->State.ProcessShutdownComplete) {
         QuicConnOnShutdownComplete(Connection);
     }
@@ -6941,12 +8483,23 @@ QuicConnDrainOperations(
             // immediate ACK. So as to not introduce additional queuing delay do
             // one immediate flush now.
             //
+            QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_SEND);
             (void)QuicSendFlush(&Connection->Send);
         }
     }
 
     QuicStreamSetDrainClosedStreams(&Connection->Streams);
 
+    if (!HasMoreWorkToDo && !Connection->State.ShutdownComplete) {
+        //
+        // Now that the queue is drained, derive the keys for the next key
+        // phase, if they aren't already.
+        //
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_CRYPTO);
+        QuicCryptoPrepareNextKeys(Connection);
+    }
+
+    QuicWorkerSetActivity(Worker, PrevActivity);
     QuicConnValidate(Connection);
 
     if (HasMoreWorkToDo) {
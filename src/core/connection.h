@@ -16,6 +16,7 @@ typedef struct QUIC_LISTENER QUIC_LISTENER;
 #define QUIC_CLOSE_APPLICATION              0x00000004U // Application closed the connection.
 #define QUIC_CLOSE_REMOTE                   0x00000008U // Connection closed remotely.
 #define QUIC_CLOSE_QUIC_STATUS              0x00000010U // QUIC_STATUS used for closing.
+#define QUIC_CLOSE_FAST                     0x00000020U // Complete once the close frame is sent.
 
 #define QUIC_CLOSE_INTERNAL QUIC_CLOSE_SEND_NOTIFICATION
 #define QUIC_CLOSE_INTERNAL_SILENT (QUIC_CLOSE_INTERNAL | QUIC_CLOSE_SILENT)
@@ -140,6 +141,12 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN UseRoundRobinStreamScheduling : 1;
 
+        //
+        // Indicates the connection is using the urgency stream scheduling
+        // scheme.
+        //
+        BOOLEAN UseUrgencyStreamScheduling : 1;
+
         //
         // Indicates that this connection has resumption enabled and needs to
         // keep the TLS state and transport parameters until it is done sending
@@ -195,6 +202,36 @@ typedef union QUIC_CONNECTION_STATE {
         //
         BOOLEAN DelayedApplicationError : 1;
 
+        //
+        // Indicates a stream has been given app-owned receive buffers, so
+        // packets may be decrypted straight into them.
+        //
+        BOOLEAN AppOwnedRecvBuffersUsed : 1;
+
+        //
+        // The listener accepted the connection, but it's waiting in its
+        // worker's accept queue to be indicated to the app in a batch.
+        //
+        BOOLEAN AcceptQueued : 1;
+
+        //
+        // The app accepted the connection from the accept queue, and it needs
+        // to be moved to its partition's worker the next time it's processed.
+        //
+        BOOLEAN AcceptQueueMove : 1;
+
+        //
+        // The registration is draining: close the connection gracefully as
+        // soon as it has no open streams.
+        //
+        BOOLEAN DrainRequested : 1;
+
+        //
+        // Closed with QUIC_CONNECTION_SHUTDOWN_FLAG_FAST: shutdown completes as
+        // soon as the close frame is sent, instead of after the closing period.
+        //
+        BOOLEAN ClosedFast : 1;
+
 #ifdef CxPlatVerifierEnabledByAddr
         //
         // The calling app is being verified (app or driver verifier).
@@ -224,8 +261,11 @@ typedef enum QUIC_CONNECTION_REF {
     QUIC_CONN_REF_LOOKUP_RESULT,        // For connections returned from lookups.
     QUIC_CONN_REF_WORKER,               // Worker is (queued for) processing.
     QUIC_CONN_REF_TIMER_WHEEL,          // The timer wheel is tracking the connection.
+    QUIC_CONN_REF_PACING,               // The worker's pacing queue is tracking the connection.
     QUIC_CONN_REF_ROUTE,                // Route resolution is undergoing.
+    QUIC_CONN_REF_TLS_OFFLOAD,          // TLS processing is offloaded.
     QUIC_CONN_REF_STREAM,               // A stream depends on the connection.
+    QUIC_CONN_REF_ACCEPT_QUEUE,         // Waiting in a worker's accept queue.
 
     QUIC_CONN_REF_COUNT
 
@@ -257,6 +297,7 @@ typedef struct QUIC_CONN_STATS {
         uint64_t Start;
         uint64_t InitialFlightEnd;      // Processed all peer's Initial packets
         uint64_t HandshakeFlightEnd;    // Processed all peer's Handshake packets
+        uint64_t HandshakeComplete;     // Handshake completed (connected)
         int64_t PhaseShift;             // Time between local and peer epochs
     } Timing;
 
@@ -264,6 +305,7 @@ typedef struct QUIC_CONN_STATS {
         uint32_t LastQueueTime;         // Time the connection last entered the work queue.
         uint64_t DrainCount;            // Sum of drain calls
         uint64_t OperationCount;        // Sum of operations processed
+        uint8_t DrainBudget;            // Operation limit of the last drain
     } Schedule;
 
     struct {
@@ -271,6 +313,11 @@ typedef struct QUIC_CONN_STATS {
         uint32_t ServerFlight1Bytes;    // Sum of TLS payloads
         uint32_t ClientFlight2Bytes;    // Sum of TLS payloads
         uint8_t HandshakeHopLimitTTL;   // TTL value in the initial packet of the handshake.
+        uint32_t QueueDelay;            // Peer's packets waiting for the worker (us)
+        uint32_t TlsTime;               // Processing in the TLS provider (us)
+        uint32_t CertValidationTime;    // Peer certificate validation (us)
+        uint64_t CertValidationStart;   // When validation of the peer certificate started
+        uint64_t RecvQueueTime;         // When the oldest queued packet was received
     } Handshake;
 
     struct {
@@ -278,13 +325,21 @@ typedef struct QUIC_CONN_STATS {
         uint64_t RetransmittablePackets;
         uint64_t SuspectedLostPackets;
         uint64_t SpuriousLostPackets;   // Actual lost is (SuspectedLostPackets - SpuriousLostPackets)
+        uint64_t SpuriousRetransmissions; // Ack eliciting packets among SpuriousLostPackets
+        uint64_t FecRepairSymbols;      // FEC repair frames sent for datagrams
 
         uint64_t TotalBytes;            // Sum of UDP payloads
         uint64_t TotalStreamBytes;      // Sum of stream payloads
 
+        uint64_t PacketFillBytes;       // Sum of 1-RTT packet lengths, before padding
+        uint64_t PacketCapacityBytes;   // Sum of space available to 1-RTT packets
+
         uint32_t CongestionCount;
         uint32_t EcnCongestionCount;
         uint32_t PersistentCongestionCount;
+
+        uint32_t SlowStartExitWindow;   // Congestion window when slow start last ended
+        uint8_t SlowStartExitReason;    // QUIC_SLOW_START_EXIT_REASON
     } Send;
 
     struct {
@@ -298,6 +353,7 @@ typedef struct QUIC_CONN_STATS {
 
         uint64_t TotalBytes;            // Sum of UDP payloads
         uint64_t TotalStreamBytes;      // Sum of stream payloads
+        uint64_t FecRecoveredDatagrams; // Datagrams rebuilt from FEC repair frames
     } Recv;
 
     struct {
@@ -307,6 +363,56 @@ typedef struct QUIC_CONN_STATS {
 
 } QUIC_CONN_STATS;
 
+//
+// Connection state that is only needed until the handshake is confirmed. It is
+// allocated separately so that it can be returned to the partition pool once
+// the connection is established, keeping long-lived connections smaller.
+//
+typedef struct QUIC_CONN_HANDSHAKE_STATE {
+
+    //
+    // Mostly test specific state.
+    //
+    QUIC_PRIVATE_TRANSPORT_PARAMETER TestTransportParameter;
+
+    //
+    // Struct to log TLS traffic secrets. The app will have to read and
+    // format the struct once the connection is connected.
+    //
+    QUIC_TLS_SECRETS* TlsSecrets;
+
+    //
+    // Previously-attempted QUIC version, after Incompatible Version Negotiation.
+    //
+    uint32_t PreviousQuicVersion;
+
+    //
+    // Initially-attempted QUIC version.
+    // Only populated during compatible version negotiation.
+    //
+    uint32_t OriginalQuicVersion;
+
+} QUIC_CONN_HANDSHAKE_STATE;
+
+//
+// The network statistics samples of a connection, allocated once the app
+// enables sampling. A ring of the last Capacity samples.
+//
+typedef struct QUIC_CONN_STATS_SAMPLES {
+
+    uint32_t IntervalMs;
+    uint32_t Capacity;
+
+    //
+    // Samples taken so far. The next one goes to Count % Capacity.
+    //
+    uint64_t Count;
+
+    _Field_size_(Capacity)
+    QUIC_NETWORK_STATISTICS_SAMPLE Samples[0];
+
+} QUIC_CONN_STATS_SAMPLES;
+
 //
 // Connection-specific state.
 //   N.B. In general, all variables should only be written on the QUIC worker
@@ -343,11 +449,33 @@ typedef struct QUIC_CONNECTION {
     //
     CXPLAT_LIST_ENTRY TimerLink;
 
+    //
+    // Link in the worker's pacing queue, and the time the pacer next allows a
+    // send.
+    //
+    CXPLAT_LIST_ENTRY PacingLink;
+    uint64_t PacingTime;
+
     //
     // The worker that is processing this connection.
     //
     QUIC_WORKER* Worker;
 
+    //
+    // An idle sibling worker that has claimed this connection for itself. The
+    // current worker hands the connection off the next time it dequeues it.
+    // N.B. Multi-threaded access, synchronized by worker's connection lock.
+    //
+    QUIC_WORKER* StealWorker;
+
+    //
+    // The app's scheduling weight for the connection, and the processing time
+    // (in us) its worker still owes it (positive) or it owes the worker's
+    // other connections (negative). Only accessed on the worker thread.
+    //
+    uint8_t SchedulingWeight;
+    int32_t SchedulingDeficitUs;
+
     //
     // The partition this connection is currently assigned to. It is changed at
     // the same time as the worker, but doesn't always need to stay in sync with
@@ -440,6 +568,23 @@ typedef struct QUIC_CONNECTION {
     BOOLEAN HasQueuedWork : 1;
     BOOLEAN HasPriorityWork : 1;
 
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    //
+    // With the lock-free worker queue, the flags above are only accessed by the
+    // worker thread (HasPriorityWork then means "linked in the priority part of
+    // the worker's queue") and the cross-thread queue state is tracked by the
+    // atomic QUIC_WORKER_QUEUE_* bits in WorkerQueueState instead.
+    //
+    BOOLEAN WorkerLinked : 1;
+    short volatile WorkerQueueState;
+
+    //
+    // Links in the worker's lock-free normal and priority inboxes.
+    //
+    CXPLAT_SLIST_ENTRY WorkerInboxLink;
+    CXPLAT_SLIST_ENTRY WorkerPriorityInboxLink;
+#endif
+
     //
     // Set of current reasons sending more packets is currently blocked.
     //
@@ -495,6 +640,14 @@ typedef struct QUIC_CONNECTION {
     //
     uint64_t NextRecvAckFreqSeqNum;
 
+    //
+    // The received packets held by stream receive buffers that reference their
+    // payload in place, and the length of those datagrams. Streams release
+    // them as the app completes receives, or when they are freed.
+    //
+    int64_t HeldRecvPacketCount;
+    int64_t HeldRecvPacketBytes;
+
     //
     // The sequence number to use for the next source CID.
     //
@@ -546,6 +699,11 @@ typedef struct QUIC_CONNECTION {
     //
     uint64_t EarliestExpirationTime;
 
+    //
+    // The level of the (hierarchical) timer wheel the connection is in.
+    //
+    uint8_t TimerWheelLevel;
+
     //
     // Timestamp (us) of when we last queued up a connection close (or
     // application close) response to be sent.
@@ -561,6 +719,14 @@ typedef struct QUIC_CONNECTION {
     QUIC_RX_PACKET** ReceiveQueueTail;
     CXPLAT_DISPATCH_LOCK ReceiveQueueLock;
 
+    //
+    // The single flush receive operation for the receive queue. It is queued
+    // only when the receive queue goes from empty to non-empty, so all
+    // packets indicated before it is processed are handled by one drain, and
+    // it is never allocated or freed.
+    //
+    QUIC_OPERATION FlushRecvOper;
+
     //
     // The queue of operations to process.
     //
@@ -658,31 +824,37 @@ typedef struct QUIC_CONNECTION {
     QUIC_TRANSPORT_PARAMETERS* HandshakeTP;
 
     //
-    // Statistics
+    // State only used until the handshake is confirmed. NULL afterwards.
     //
-    QUIC_CONN_STATS Stats;
+    QUIC_CONN_HANDSHAKE_STATE* HandshakeState;
 
     //
-    // Mostly test specific state.
+    // The qlog trace, if the connection was sampled for tracing.
     //
-    QUIC_PRIVATE_TRANSPORT_PARAMETER TestTransportParameter;
+    struct QUIC_QLOG* Qlog;
 
     //
-    // Struct to log TLS traffic secrets. The app will have to read and
-    // format the struct once the connection is connected.
+    // Periodic network statistics samples, if enabled by the app.
     //
-    QUIC_TLS_SECRETS* TlsSecrets;
+    QUIC_CONN_STATS_SAMPLES* StatsSamples;
 
     //
-    // Previously-attempted QUIC version, after Incompatible Version Negotiation.
+    // Batches of packets being sealed on packet protection offload threads.
+    // Count of QUIC_MAX_PROTECT_OFFLOADS. Only allocated if the app enabled
+    // parallel packet protection.
     //
-    uint32_t PreviousQuicVersion;
+    struct QUIC_PROTECT_OFFLOAD* ProtectOffloads;
 
     //
-    // Initially-attempted QUIC version.
-    // Only populated during compatible version negotiation.
+    // Statistics
     //
-    uint32_t OriginalQuicVersion;
+    QUIC_CONN_STATS Stats;
+
+    //
+    // Sent plus received stream bytes when the hibernate timer last fired. If
+    // unchanged at the next expiration, the connection is considered idle.
+    //
+    uint64_t HibernateStreamBytes;
 
     //
     // The size of the keep alive padding.
@@ -774,6 +946,21 @@ QuicConnIsClosed(
     return Connection->State.ClosedLocally || Connection->State.ClosedRemotely;
 }
 
+//
+// Helper for invalidating the short header templates of all paths, after a
+// connection-wide header field (key phase or fixed bit) changes.
+//
+QUIC_INLINE
+void
+QuicConnInvalidateShortHeaders(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    for (uint8_t i = 0; i < Connection->PathsCount; ++i) {
+        QuicPathInvalidateShortHeader(&Connection->Paths[i]);
+    }
+}
+
 //
 // Helper to get the owning QUIC_CONNECTION for the stream set module.
 //
@@ -986,6 +1173,15 @@ QuicConnFree(
     _In_ __drv_freesMem(Mem) QUIC_CONNECTION* Connection
     );
 
+//
+// Frees the handshake-only state, once the handshake is confirmed.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnFreeHandshakeState(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Releases the handle usage of the app.
 //
@@ -1001,6 +1197,25 @@ QuicConnOnShutdownComplete(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Saves what the connection learned about its active path in the library's
+// path metrics cache.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnCachePathMetrics(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Warm starts the active path from the library's path metrics cache.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnApplyCachedPathMetrics(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 #if DEBUG
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
@@ -1111,6 +1326,15 @@ QuicConnQueueTraceRundown(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Queues the start of a graceful drain of the connection.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicConnQueueDrain(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Indicates an event to the application layer.
 //
@@ -1160,7 +1384,8 @@ QuicConnQueueHighestPriorityOper(
 
 typedef enum QUIC_CONN_START_FLAGS {
     QUIC_CONN_START_FLAG_NONE =              0x00000000U,
-    QUIC_CONN_START_FLAG_FAIL_SILENTLY =     0x00000001U // Don't send notification to API client
+    QUIC_CONN_START_FLAG_FAIL_SILENTLY =     0x00000001U, // Don't send notification to API client
+    QUIC_CONN_START_FLAG_DEFER_HANDSHAKE =   0x00000002U  // Caller queues QUIC_API_TYPE_CONN_SET_CONFIGURATION
 } QUIC_CONN_START_FLAGS;
 
 //
@@ -1380,6 +1605,22 @@ QuicConnGetAckDelay(
     return (uint64_t)Connection->Settings.MaxAckDelayMs;
 }
 
+//
+// Returns the RTT (in microseconds) to assume until the first RTT sample.
+//
+QUIC_INLINE
+uint64_t
+QuicConnGetInitialRtt(
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->Settings.DatacenterModeEnabled &&
+        !Connection->Settings.IsSet.InitialRttMs) {
+        return QUIC_DATACENTER_INITIAL_RTT;
+    }
+    return MS_TO_US((uint64_t)Connection->Settings.InitialRttMs);
+}
+
 //
 // Called when the QUIC version is set.
 //
@@ -1448,6 +1689,17 @@ QuicConnCleanupServerResumptionState(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Allocates the packet space for the encryption level, if it hasn't been
+// already.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnEnsurePacketSpace(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ QUIC_ENCRYPT_LEVEL EncryptLevel
+    );
+
 //
 // Discard any 0-RTT deferred datagrams.
 //
@@ -1478,6 +1730,16 @@ QuicConnCloseLocally(
     _In_opt_z_ const char* ErrorMsg
     );
 
+//
+// Completes a fast (QUIC_CLOSE_FAST) local close once its close frame has been
+// sent, instead of waiting out the closing period.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnOnFastCloseSent(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Close the connection for a transport protocol error.
 //
@@ -1576,6 +1838,15 @@ QuicConnQueueRouteCompletion(
     _In_ BOOLEAN Succeeded
     );
 
+//
+// Queues the completion of offloaded TLS processing to a connection.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnQueueTlsOffloadCompletion(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Queues up an update to the packet tolerance we want the peer to use.
 //
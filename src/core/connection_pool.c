@@ -8,11 +8,12 @@ Abstract:
     Connection pools allow client application to create a pool of connections
     spread across RSS cores.
 
-    To create connection spread over RSS cores, the connection pool tries multiple
-    port numbers, until the connection lands on a new RSS core. To know where a
+    To create connection spread over RSS cores, the connection pool picks local
+    port numbers that land on the least loaded RSS core. To know where a
     connection will land, the connection pool compute the RSS core based on the
     connection parameters. To do so, it needs to query the driver RSS configuration,
-    and use the exact same RSS hash algorithm.
+    and use the exact same RSS hash algorithm. This is done once for every
+    ephemeral port, building a table of ports per RSS core to pick from.
 
     There is also a chance that a port number found by the connection pool is not
     available, preventing the connection from starting successfully. To work around
@@ -22,6 +23,17 @@ Abstract:
     for other reasons and be kept in the pool (no guarantee that all connection in the
     pool are successful).
 
+    Only the path setup happens in the caller's context; the handshakes are
+    queued to the connections' workers, so they run in parallel across the RSS
+    cores. Connections may resume (and send 0-RTT data) with a resumption ticket
+    shared by the whole pool.
+
+    Managed connection pools (ConnectionPoolOpen) keep ownership of their
+    connections. A connection that shuts down is replaced on a later
+    ConnectionPoolAcquire call, after an exponential backoff if it never
+    connected. When a connection's local address changes, the RSS state is
+    queried again so replacements land on the least loaded RSS cores.
+
     Connection pools are currently only supported on Windows XDP datapath,
     since this is the only datapath that supports querying the RSS configuration parameters.
 
@@ -44,6 +56,14 @@ typedef struct QUIC_CONN_POOL_RSS_PROC_INFO {
     // The number of connections assigned to this CPU.
     //
     uint32_t ConnectionCount;
+
+    //
+    // The local ports that land on this CPU: PortCount entries of the RSS
+    // port table starting at PortIndex, tried in order from NextPort.
+    //
+    uint32_t PortIndex;
+    uint32_t PortCount;
+    uint32_t NextPort;
 } QUIC_CONN_POOL_RSS_PROC_INFO;
 
 static
@@ -85,7 +105,7 @@ QuicConnPoolAllocUniqueRssProcInfo(
         //
         if (j == RssProcessorCount) {
             CXPLAT_DBG_ASSERT(RssProcessorCount < RssConfig->RssIndirectionTableCount);
-            RssProcessors[RssProcessorCount].ConnectionCount = 0;
+            CxPlatZeroMemory(&RssProcessors[RssProcessorCount], sizeof(*RssProcessors));
             RssProcessors[RssProcessorCount++].ProcIndex = RssConfig->RssIndirectionTable[i];
         }
     }
@@ -270,6 +290,10 @@ QuicConnPoolTryCreateConnection(
     _In_ uint16_t CibirIdLength,
     _In_reads_bytes_opt_(CibirIdLength)
         const uint8_t* CibirId,
+    _In_ uint32_t ResumptionTicketLength,
+    _In_reads_bytes_opt_(ResumptionTicketLength)
+        const uint8_t* ResumptionTicket,
+    _In_ BOOLEAN CloseAsync,
     _Outptr_ _At_(*Connection, __drv_allocatesMem(Mem))
         QUIC_CONNECTION** Connection
     )
@@ -340,15 +364,57 @@ QuicConnPoolTryCreateConnection(
         }
     }
 
+    if (CloseAsync) {
+        Status =
+            QuicConnParamSet(
+                *Connection,
+                QUIC_PARAM_CONN_CLOSE_ASYNC,
+                sizeof(CloseAsync),
+                &CloseAsync);
+        CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status));
+        if (QUIC_FAILED(Status)) {
+            goto Error;
+        }
+    }
+
+    if (ResumptionTicket != NULL) {
+        //
+        // A ticket the server no longer accepts just means a full handshake,
+        // so don't fail the connection over it.
+        //
+        (void)QuicConnParamSet(
+            *Connection,
+            QUIC_PARAM_CONN_RESUMPTION_TICKET,
+            ResumptionTicketLength,
+            ResumptionTicket);
+    }
+
     Status = QuicConnStart(
         *Connection,
         Configuration,
         Family,
         ServerName,
         ServerPort,
-        QUIC_CONN_START_FLAG_FAIL_SILENTLY);
+        QUIC_CONN_START_FLAG_FAIL_SILENTLY | QUIC_CONN_START_FLAG_DEFER_HANDSHAKE);
 
     ServerName = NULL; // The connection now owns the ServerName.
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    //
+    // Run the handshake on the connection's worker, in parallel with the rest
+    // of the pool.
+    //
+    QUIC_OPERATION* Oper = QuicConnAllocOperation(*Connection, QUIC_OPER_TYPE_API_CALL);
+    if (Oper == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    QuicConfigurationAddRef(Configuration, QUIC_CONF_REF_CONN_SET_OP);
+    Oper->API_CALL.Context->Type = QUIC_API_TYPE_CONN_SET_CONFIGURATION;
+    Oper->API_CALL.Context->CONN_SET_CONFIGURATION.Configuration = Configuration;
+    QuicConnQueueOper(*Connection, Oper);
 
 Error:
     //
@@ -363,9 +429,11 @@ Error:
         //
         // This connection has never left MsQuic back to the application.
         // Mark it as internally owned so no notification is sent to the app,
-        // the closing logic will handle the final deref.
+        // the closing logic will handle the final deref (so the close must not
+        // also release it, as an async close would).
         //
         (*Connection)->State.ExternalOwner = FALSE;
+        (*Connection)->State.CloseAsync = FALSE;
         QuicConnPoolQueueConnectionClose(*Connection, FALSE);
         *Connection = NULL;
     }
@@ -374,129 +442,191 @@ Error:
 }
 
 
-_IRQL_requires_max_(PASSIVE_LEVEL)
-QUIC_STATUS
-QUIC_API
-MsQuicConnectionPoolCreate(
-    _In_ QUIC_CONNECTION_POOL_CONFIG* Config,
-    _Out_writes_(Config->NumberOfConnections)
-        HQUIC* ConnectionPool
-    )
-{
-    QUIC_CONNECTION** Connections = (QUIC_CONNECTION**)ConnectionPool;
-    CXPLAT_RSS_CONFIG* RssConfig = NULL;
-    QUIC_CONN_POOL_RSS_PROC_INFO* RssProcessors = NULL;
-    const char* ServerNameCopy = NULL;
-    CXPLAT_TOEPLITZ_HASH ToeplitzHash;
-    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
-    uint32_t CreatedConnections = 0;
+typedef struct QUIC_CONN_POOL_RSS {
 
+    //
+    // The RSS configuration of the interface used to reach the server.
+    //
+    CXPLAT_RSS_CONFIG* RssConfig;
 
-    if (Config == NULL || ConnectionPool == NULL) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Error;
-    }
+    //
+    // The unique RSS processors of the indirection table, with the number of
+    // connections assigned to each.
+    //
+    QUIC_CONN_POOL_RSS_PROC_INFO* RssProcessors;
+    uint32_t RssProcessorCount;
 
-    if (Config->Registration == NULL ||
-        Config->Configuration == NULL|| Config->NumberOfConnections == 0 ||
-        Config->Handler == NULL || Config->ServerName == NULL || Config->ServerPort == 0 ||
-        (Config->Family != QUIC_ADDRESS_FAMILY_UNSPEC &&
-            Config->Family != QUIC_ADDRESS_FAMILY_INET &&
-            Config->Family != QUIC_ADDRESS_FAMILY_INET6)) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Error;
-    }
+    //
+    // Every ephemeral local port, grouped by the RSS processor it lands on for
+    // the pool's local IP and remote address.
+    //
+    uint16_t* Ports;
 
-    if (((QUIC_CONFIGURATION*)Config->Configuration)->SecurityConfig == NULL) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Error;
-    }
+    CXPLAT_TOEPLITZ_HASH ToeplitzHash;
 
-    if ((Config->CibirIds != NULL && Config->CibirIdLength == 0) ||
-        (Config->CibirIds == NULL && Config->CibirIdLength != 0)) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Error;
-    }
+} QUIC_CONN_POOL_RSS;
 
-    const size_t ServerNameLength = strnlen(Config->ServerName, QUIC_MAX_SNI_LENGTH + 1);
-    if (ServerNameLength == QUIC_MAX_SNI_LENGTH + 1) {
-        Status = QUIC_STATUS_INVALID_PARAMETER;
-        goto Error;
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnPoolRssUninitialize(
+    _Inout_ QUIC_CONN_POOL_RSS* Rss
+    )
+{
+    if (Rss->Ports != NULL) {
+        CXPLAT_FREE(Rss->Ports, QUIC_POOL_TMP_ALLOC);
+        Rss->Ports = NULL;
     }
+    if (Rss->RssProcessors != NULL) {
+        CXPLAT_FREE(Rss->RssProcessors, QUIC_POOL_TMP_ALLOC);
+        Rss->RssProcessors = NULL;
+    }
+    if (Rss->RssConfig != NULL) {
+        CxPlatDataPathRssConfigFree(Rss->RssConfig);
+        Rss->RssConfig = NULL;
+    }
+    Rss->RssProcessorCount = 0;
+}
 
-    CxPlatZeroMemory(ConnectionPool, sizeof(HQUIC) * Config->NumberOfConnections);
+//
+// Groups every ephemeral local port by the RSS processor it lands on, so that
+// picking a port for a processor is a lookup instead of a search.
+//
+// Toeplitz hashing is linear over XOR, so the hash of a tuple is the hash of
+// the tuple with a zero local port, XOR the hash of the local port bytes
+// alone. Only the latter is computed per port.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolRssBuildPortTable(
+    _Inout_ QUIC_CONN_POOL_RSS* Rss,
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ const QUIC_ADDR* LocalAddress
+    )
+{
+    const uint32_t PortCount = QUIC_ADDR_EPHEMERAL_PORT_MAX - QUIC_ADDR_EPHEMERAL_PORT_MIN + 1;
+    const uint32_t Mask = Rss->RssConfig->RssIndirectionTableCount - 1;
+    const uint32_t PortOffset =
+        QuicAddrGetFamily(LocalAddress) == QUIC_ADDRESS_FAMILY_INET ?
+            4 + 4 + 2 : 16 + 16 + 2;
+    const uint16_t StartPort = QuicAddrGetPort(LocalAddress);
+    uint8_t PortBytes[2];
 
     //
-    // Resolve the server name or use the remote address.
+    // Map each indirection table entry to its index in RssProcessors.
     //
-    QUIC_ADDR ResolvedRemoteAddress = { 0 };
-    QuicAddrSetFamily(&ResolvedRemoteAddress, Config->Family);
-    if (Config->ServerAddress != NULL) {
-         ResolvedRemoteAddress = *Config->ServerAddress;
-    } else {
-        Status =
-            CxPlatDataPathResolveAddress(
-                MsQuicLib.Datapath,
-                Config->ServerName,
-                &ResolvedRemoteAddress);
-        if (QUIC_FAILED(Status)) {
-            goto Error;
+    uint32_t* ProcForEntry =
+        CXPLAT_ALLOC_PAGED(
+            Rss->RssConfig->RssIndirectionTableCount * sizeof(uint32_t),
+            QUIC_POOL_TMP_ALLOC);
+    if (ProcForEntry == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < Rss->RssConfig->RssIndirectionTableCount; i++) {
+        uint32_t j = 0;
+        while (Rss->RssProcessors[j].ProcIndex != Rss->RssConfig->RssIndirectionTable[i]) {
+            j++;
         }
+        CXPLAT_DBG_ASSERT(j < Rss->RssProcessorCount);
+        ProcForEntry[i] = j;
+    }
+
+    Rss->Ports = CXPLAT_ALLOC_PAGED(PortCount * sizeof(uint16_t), QUIC_POOL_TMP_ALLOC);
+    if (Rss->Ports == NULL) {
+        CXPLAT_FREE(ProcForEntry, QUIC_POOL_TMP_ALLOC);
+        return QUIC_STATUS_OUT_OF_MEMORY;
     }
 
-    QuicAddrSetPort(&ResolvedRemoteAddress, Config->ServerPort);
+    QUIC_ADDR ZeroPortAddress = *LocalAddress;
+    QuicAddrSetPort(&ZeroPortAddress, 0);
+    uint32_t BaseHash = 0, Offset;
+    CxPlatToeplitzHashComputeRss(
+        &Rss->ToeplitzHash,
+        RemoteAddress,
+        &ZeroPortAddress,
+        &BaseHash,
+        &Offset);
 
     //
-    // Copying how Connection Settings flow downwards. It will first inherit the global settings,
-    // if a global setting field is not set, but the configuration setting is set, override the global.
+    // Count the ports per processor, then place them (in port order) after the
+    // ones of the previous processors. Each processor starts from the first
+    // port at or after the starting port the OS handed out.
     //
-    QUIC_CONFIGURATION* ConnectionConfig =
-        (QUIC_CONFIGURATION*)Config->Configuration;
-    CXPLAT_SOCKET_FLAGS SocketFlags = CXPLAT_SOCKET_FLAG_NONE;
-
-    if (MsQuicLib.Settings.XdpEnabled) {
-        SocketFlags |= CXPLAT_SOCKET_FLAG_XDP;
-    }
-    if (ConnectionConfig->Settings.IsSet.XdpEnabled) {
-        if (ConnectionConfig->Settings.XdpEnabled) {
-            SocketFlags |= CXPLAT_SOCKET_FLAG_XDP;
-        } else {
-            SocketFlags &= ~CXPLAT_SOCKET_FLAG_XDP;
+    for (uint32_t Pass = 0; Pass < 2; Pass++) {
+        if (Pass == 1) {
+            uint32_t PortIndex = 0;
+            for (uint32_t i = 0; i < Rss->RssProcessorCount; i++) {
+                Rss->RssProcessors[i].PortIndex = PortIndex;
+                PortIndex += Rss->RssProcessors[i].PortCount;
+                Rss->RssProcessors[i].PortCount = 0;
+                Rss->RssProcessors[i].NextPort = 0;
+            }
+        }
+        for (uint32_t Port = QUIC_ADDR_EPHEMERAL_PORT_MIN; Port <= QUIC_ADDR_EPHEMERAL_PORT_MAX; Port++) {
+            PortBytes[0] = (uint8_t)(Port >> 8);
+            PortBytes[1] = (uint8_t)Port;
+            const uint32_t Hash =
+                BaseHash ^
+                CxPlatToeplitzHashCompute(&Rss->ToeplitzHash, PortBytes, 2, PortOffset);
+            QUIC_CONN_POOL_RSS_PROC_INFO* Proc =
+                &Rss->RssProcessors[ProcForEntry[Hash & Mask]];
+            if (Pass == 1) {
+                Rss->Ports[Proc->PortIndex + Proc->PortCount] = (uint16_t)Port;
+                if (Port < StartPort) {
+                    Proc->NextPort = Proc->PortCount + 1;
+                }
+            }
+            Proc->PortCount++;
         }
     }
 
-    if (MsQuicLib.Settings.QTIPEnabled) {
-        SocketFlags |= CXPLAT_SOCKET_FLAG_QTIP;
-    }
-    if (ConnectionConfig->Settings.IsSet.QTIPEnabled) {
-        if (ConnectionConfig->Settings.QTIPEnabled) {
-            SocketFlags |= CXPLAT_SOCKET_FLAG_QTIP;
-        } else {
-            SocketFlags &= ~CXPLAT_SOCKET_FLAG_QTIP;
+    for (uint32_t i = 0; i < Rss->RssProcessorCount; i++) {
+        if (Rss->RssProcessors[i].NextPort >= Rss->RssProcessors[i].PortCount) {
+            Rss->RssProcessors[i].NextPort = 0;
         }
     }
 
+    CXPLAT_FREE(ProcForEntry, QUIC_POOL_TMP_ALLOC);
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Queries the RSS configuration of the interface used to reach RemoteAddress,
+// and returns the local address (and port) to start searching from.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolRssInitialize(
+    _Out_ QUIC_CONN_POOL_RSS* Rss,
+    _In_ QUIC_ADDR* RemoteAddress,
+    _In_ CXPLAT_SOCKET_FLAGS SocketFlags,
+    _Out_ QUIC_ADDR* LocalAddress
+    )
+{
+    CxPlatZeroMemory(Rss, sizeof(*Rss));
+
     //
     // Get the local address and a port to start from.
     //
-    QUIC_ADDR LocalAddress;
-    Status = QuicConnPoolGetStartingLocalAddress(&ResolvedRemoteAddress, &LocalAddress, SocketFlags);
+    QUIC_STATUS Status = QuicConnPoolGetStartingLocalAddress(RemoteAddress, LocalAddress, SocketFlags);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
 
     uint32_t InterfaceIndex;
-    Status = QuicConnPoolGetInterfaceIndexForLocalAddress(&LocalAddress, &InterfaceIndex);
+    Status = QuicConnPoolGetInterfaceIndexForLocalAddress(LocalAddress, &InterfaceIndex);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
 
-    Status = CxPlatDataPathRssConfigGet(InterfaceIndex, &RssConfig);
+    Status = CxPlatDataPathRssConfigGet(InterfaceIndex, &Rss->RssConfig);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
 
-    if (RssConfig->RssIndirectionTableCount == 0) {
+    if (Rss->RssConfig->RssIndirectionTableCount == 0) {
         //
         // No RSS cores configured.
         //
@@ -504,10 +634,10 @@ MsQuicConnectionPoolCreate(
         goto Error;
     }
 
-    if (RssConfig->RssSecretKeyLength > CXPLAT_TOEPLITZ_KEY_SIZE_MAX) {
+    if (Rss->RssConfig->RssSecretKeyLength > CXPLAT_TOEPLITZ_KEY_SIZE_MAX) {
         Status = QUIC_STATUS_INTERNAL_ERROR;
         goto Error;
-    } else if (RssConfig->RssSecretKeyLength < CXPLAT_TOEPLITZ_KEY_SIZE_MIN) {
+    } else if (Rss->RssConfig->RssSecretKeyLength < CXPLAT_TOEPLITZ_KEY_SIZE_MIN) {
         Status = QUIC_STATUS_INTERNAL_ERROR;
         goto Error;
     }
@@ -515,12 +645,11 @@ MsQuicConnectionPoolCreate(
     //
     // Get unique RSS processors.
     //
-    uint32_t RssProcessorCount = 0;
     Status =
         QuicConnPoolAllocUniqueRssProcInfo(
-            RssConfig,
-            &RssProcessors,
-            &RssProcessorCount);
+            Rss->RssConfig,
+            &Rss->RssProcessors,
+            &Rss->RssProcessorCount);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
@@ -528,131 +657,1174 @@ MsQuicConnectionPoolCreate(
     //
     // Initialize the Toeplitz hash.
     //
-    CxPlatCopyMemory(&ToeplitzHash.HashKey, RssConfig->RssSecretKey, RssConfig->RssSecretKeyLength);
-    ToeplitzHash.InputSize = CXPLAT_TOEPLITZ_INPUT_SIZE_IP;
-    CxPlatToeplitzHashInitialize(&ToeplitzHash);
+    CxPlatCopyMemory(
+        &Rss->ToeplitzHash.HashKey,
+        Rss->RssConfig->RssSecretKey,
+        Rss->RssConfig->RssSecretKeyLength);
+    Rss->ToeplitzHash.InputSize = CXPLAT_TOEPLITZ_INPUT_SIZE_IP;
+    CxPlatToeplitzHashInitialize(&Rss->ToeplitzHash);
 
-    const uint32_t ConnectionsPerProc =
-        Config->NumberOfConnections % RssProcessorCount != 0 ?
-            (Config->NumberOfConnections / RssProcessorCount) + 1:
-            (Config->NumberOfConnections / RssProcessorCount);
+    Status = QuicConnPoolRssBuildPortTable(Rss, RemoteAddress, LocalAddress);
+
+Error:
+
+    if (QUIC_FAILED(Status)) {
+        QuicConnPoolRssUninitialize(Rss);
+    }
+
+    return Status;
+}
+
+static
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONN_POOL_RSS_PROC_INFO*
+QuicConnPoolRssGetProc(
+    _In_ const QUIC_CONN_POOL_RSS* Rss,
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ const QUIC_ADDR* LocalAddress
+    )
+{
+    return
+        QuicConnPoolGetRssProcForTuple(
+            &Rss->ToeplitzHash,
+            RemoteAddress,
+            LocalAddress,
+            Rss->RssProcessors,
+            Rss->RssProcessorCount,
+            Rss->RssConfig->RssIndirectionTable,
+            Rss->RssConfig->RssIndirectionTableCount);
+}
+
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+CXPLAT_SOCKET_FLAGS
+QuicConnPoolGetSocketFlags(
+    _In_ QUIC_CONFIGURATION* Configuration
+    )
+{
+    const QUIC_SETTINGS_INTERNAL* Settings = QuicConfigurationGetSettings(Configuration);
 
     //
-    // Begin creating and starting connections.
+    // Copying how Connection Settings flow downwards. It will first inherit the global settings,
+    // if a global setting field is not set, but the configuration setting is set, override the global.
     //
-    for (uint32_t i = 0; i < Config->NumberOfConnections; i++) {
-        const uint32_t MaxCreationRetries = RssProcessorCount * MAX_CONNECTION_POOL_RETRY_MULTIPLIER;
-        uint32_t RetryCount = 0;
+    CXPLAT_SOCKET_FLAGS SocketFlags = CXPLAT_SOCKET_FLAG_NONE;
 
-        for (; RetryCount < MaxCreationRetries; RetryCount++) {
+    if (QuicLibraryGetSettings()->XdpEnabled) {
+        SocketFlags |= CXPLAT_SOCKET_FLAG_XDP;
+    }
+    if (Settings->IsSet.XdpEnabled) {
+        if (Settings->XdpEnabled) {
+            SocketFlags |= CXPLAT_SOCKET_FLAG_XDP;
+        } else {
+            SocketFlags &= ~CXPLAT_SOCKET_FLAG_XDP;
+        }
+    }
 
-            //
-            // The connection takes ownership of the ServerName parameter, so we must
-            // allocate a copy of it for each connection (attempt).
-            //
-            if (ServerNameCopy == NULL) {
-                ServerNameCopy =
-                    QuicConnPoolAllocServerNameCopy(
-                        Config->ServerName,
-                        ServerNameLength);
-                if (ServerNameCopy == NULL) {
-                    Status = QUIC_STATUS_OUT_OF_MEMORY;
-                    goto CleanUpConnections;
-                }
-            }
+    if (QuicLibraryGetSettings()->QTIPEnabled) {
+        SocketFlags |= CXPLAT_SOCKET_FLAG_QTIP;
+    }
+    if (Settings->IsSet.QTIPEnabled) {
+        if (Settings->QTIPEnabled) {
+            SocketFlags |= CXPLAT_SOCKET_FLAG_QTIP;
+        } else {
+            SocketFlags &= ~CXPLAT_SOCKET_FLAG_QTIP;
+        }
+    }
 
-            uint32_t NewPort = QuicAddrGetPort(&LocalAddress) + 1;
-            if (NewPort > QUIC_ADDR_EPHEMERAL_PORT_MAX) {
-                NewPort = QUIC_ADDR_EPHEMERAL_PORT_MIN;
-            }
-            QuicAddrSetPort(&LocalAddress, (uint16_t)NewPort);
-
-            QUIC_CONN_POOL_RSS_PROC_INFO* CurrentProc =
-                QuicConnPoolGetRssProcForTuple(
-                    &ToeplitzHash,
-                    &ResolvedRemoteAddress,
-                    &LocalAddress,
-                    RssProcessors,
-                    RssProcessorCount,
-                    RssConfig->RssIndirectionTable,
-                    RssConfig->RssIndirectionTableCount);
-
-            if (CurrentProc->ConnectionCount >= ConnectionsPerProc) {
-                //
-                // This processor already has enough connections on it, so try another port number.
-                //
-                continue;
-            }
+    return SocketFlags;
+}
+
+//
+// Creates and starts a connection on the least loaded RSS processor with fewer
+// than ConnectionsPerProc connections, using the next local port of that
+// processor (set in LocalAddress) and moving on to the following one if the
+// connection fails to start. The caller is responsible for accounting the
+// connection on the returned processor.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolCreateOnRss(
+    _Inout_ QUIC_CONN_POOL_RSS* Rss,
+    _In_ uint32_t ConnectionsPerProc,
+    _In_ QUIC_REGISTRATION* Registration,
+    _In_ QUIC_CONFIGURATION* Configuration,
+    _In_ QUIC_CONNECTION_CALLBACK_HANDLER Handler,
+    _In_opt_ void* Context,
+    _In_ QUIC_ADDR* RemoteAddress,
+    _Inout_ QUIC_ADDR* LocalAddress,
+    _In_z_ const char* ServerName,
+    _In_ size_t ServerNameLength,
+    _In_ uint16_t ServerPort,
+    _In_ QUIC_ADDRESS_FAMILY Family,
+    _In_ uint16_t CibirIdLength,
+    _In_reads_bytes_opt_(CibirIdLength)
+        const uint8_t* CibirId,
+    _In_ uint32_t ResumptionTicketLength,
+    _In_reads_bytes_opt_(ResumptionTicketLength)
+        const uint8_t* ResumptionTicket,
+    _In_ BOOLEAN CloseAsync,
+    _Out_ QUIC_CONN_POOL_RSS_PROC_INFO** Proc,
+    _Outptr_ _At_(*Connection, __drv_allocatesMem(Mem))
+        QUIC_CONNECTION** Connection
+    )
+{
+    const uint32_t MaxCreationRetries = Rss->RssProcessorCount * MAX_CONNECTION_POOL_RETRY_MULTIPLIER;
+    QUIC_STATUS Status = QUIC_STATUS_ADDRESS_IN_USE;
 
-            QUIC_PARTITION* Partition =
-                QuicLibraryGetPartitionFromProcessorIndex(CurrentProc->ProcIndex);
-
-            Status =
-                QuicConnPoolTryCreateConnection(
-                    (QUIC_REGISTRATION*)Config->Registration,
-                    (QUIC_CONFIGURATION*)Config->Configuration,
-                    Partition,
-                    Config->Handler,
-                    Config->Context ? Config->Context[i] : NULL,
-                    &ResolvedRemoteAddress,
-                    &LocalAddress,
-                    ServerNameCopy,
-                    Config->ServerPort,
-                    Config->Family,
-                    Config->CibirIdLength,
-                    Config->CibirIds ? Config->CibirIds[i] : NULL,
-                    &Connections[i]);
+    *Proc = NULL;
+    *Connection = NULL;
 
-            //
-            // The connection either owns the ServerNameCopy, or it was freed.
-            //
-            ServerNameCopy = NULL;
-            if (QUIC_FAILED(Status)) {
-                continue;
-            }
+    for (uint32_t RetryCount = 0; RetryCount < MaxCreationRetries; RetryCount++) {
 
-            //
-            // The connection was created successfully, add it to the count for this processor.
-            //
-            CurrentProc->ConnectionCount++;
-            CreatedConnections++;
+        QUIC_CONN_POOL_RSS_PROC_INFO* CurrentProc = NULL;
+        for (uint32_t i = 0; i < Rss->RssProcessorCount; i++) {
+            QUIC_CONN_POOL_RSS_PROC_INFO* RssProc = &Rss->RssProcessors[i];
+            if (RssProc->PortCount != 0 &&
+                RssProc->ConnectionCount < ConnectionsPerProc &&
+                (CurrentProc == NULL ||
+                 RssProc->ConnectionCount < CurrentProc->ConnectionCount)) {
+                CurrentProc = RssProc;
+            }
+        }
+        if (CurrentProc == NULL) {
             break;
         }
 
-        if (RetryCount == MaxCreationRetries) {
-            Status = QUIC_STATUS_ADDRESS_IN_USE;
-            goto CleanUpConnections;
+        QuicAddrSetPort(
+            LocalAddress,
+            Rss->Ports[CurrentProc->PortIndex + CurrentProc->NextPort]);
+        if (++CurrentProc->NextPort == CurrentProc->PortCount) {
+            CurrentProc->NextPort = 0;
         }
-    }
-
-CleanUpConnections:
-    if (QUIC_FAILED(Status) &&
-        (Config->Flags & QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE) != 0) {
 
         //
-        // Close every connection that was created.
-        // The application will receive the shutdown notification.
-        // Wait for the task to complete so that when this function returns to the app,
-        // all connections are already closed (since the shutdown notification is visible).
+        // The connection takes ownership of the ServerName parameter, so we must
+        // allocate a copy of it for each connection attempt.
         //
-        for (uint32_t i = 0; i < CreatedConnections; i++) {
-            QuicConnPoolQueueConnectionClose(Connections[i], TRUE);
-            QuicConnRelease(Connections[i], QUIC_CONN_REF_HANDLE_OWNER);
-            Connections[i] = NULL;
+        const char* ServerNameCopy =
+            QuicConnPoolAllocServerNameCopy(ServerName, ServerNameLength);
+        if (ServerNameCopy == NULL) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+
+        QUIC_PARTITION* Partition =
+            QuicLibraryGetPartitionFromProcessorIndex(CurrentProc->ProcIndex);
+
+        Status =
+            QuicConnPoolTryCreateConnection(
+                Registration,
+                Configuration,
+                Partition,
+                Handler,
+                Context,
+                RemoteAddress,
+                LocalAddress,
+                ServerNameCopy,
+                ServerPort,
+                Family,
+                CibirIdLength,
+                CibirId,
+                ResumptionTicketLength,
+                ResumptionTicket,
+                CloseAsync,
+                Connection);
+        if (QUIC_SUCCEEDED(Status)) {
+            *Proc = CurrentProc;
+            return Status;
         }
     }
 
-Error:
-    if (ServerNameCopy != NULL) {
-        CXPLAT_FREE(ServerNameCopy, QUIC_POOL_SERVERNAME);
+    return QUIC_STATUS_ADDRESS_IN_USE;
+}
+
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolValidateConfig(
+    _In_ const QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Out_ size_t* ServerNameLength
+    )
+{
+    if (Config->Registration == NULL ||
+        Config->Configuration == NULL|| Config->NumberOfConnections == 0 ||
+        Config->Handler == NULL || Config->ServerName == NULL || Config->ServerPort == 0 ||
+        (Config->Family != QUIC_ADDRESS_FAMILY_UNSPEC &&
+            Config->Family != QUIC_ADDRESS_FAMILY_INET &&
+            Config->Family != QUIC_ADDRESS_FAMILY_INET6)) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (QuicConfigurationGetSecurityConfig((QUIC_CONFIGURATION*)Config->Configuration) == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((Config->CibirIds != NULL && Config->CibirIdLength == 0) ||
+        (Config->CibirIds == NULL && Config->CibirIdLength != 0)) {
+        return QUIC_STATUS_INVALID_PARAMETER;
     }
-    if (RssProcessors != NULL) {
-        CXPLAT_FREE(RssProcessors, QUIC_POOL_TMP_ALLOC);
+
+    if ((Config->ResumptionTicket != NULL && Config->ResumptionTicketLength == 0) ||
+        (Config->ResumptionTicket == NULL && Config->ResumptionTicketLength != 0) ||
+        Config->ResumptionTicketLength > UINT16_MAX) {
+        return QUIC_STATUS_INVALID_PARAMETER;
     }
-    if (RssConfig != NULL) {
-        CxPlatDataPathRssConfigFree(RssConfig);
+
+    *ServerNameLength = strnlen(Config->ServerName, QUIC_MAX_SNI_LENGTH + 1);
+    if (*ServerNameLength == QUIC_MAX_SNI_LENGTH + 1) {
+        return QUIC_STATUS_INVALID_PARAMETER;
     }
 
+    return QUIC_STATUS_SUCCESS;
+}
 
-    return Status;
+//
+// Resolve the server name or use the remote address.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolResolveRemoteAddress(
+    _In_ const QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Out_ QUIC_ADDR* RemoteAddress
+    )
+{
+    CxPlatZeroMemory(RemoteAddress, sizeof(*RemoteAddress));
+    QuicAddrSetFamily(RemoteAddress, Config->Family);
+    if (Config->ServerAddress != NULL) {
+         *RemoteAddress = *Config->ServerAddress;
+    } else {
+        QUIC_STATUS Status =
+            CxPlatDataPathResolveAddress(
+                MsQuicLib.Datapath,
+                Config->ServerName,
+                RemoteAddress);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+
+    QuicAddrSetPort(RemoteAddress, Config->ServerPort);
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolCreate(
+    _In_ QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Out_writes_(Config->NumberOfConnections)
+        HQUIC* ConnectionPool
+    )
+{
+    QUIC_CONNECTION** Connections = (QUIC_CONNECTION**)ConnectionPool;
+    QUIC_CONN_POOL_RSS Rss = { 0 };
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    uint32_t CreatedConnections = 0;
+    size_t ServerNameLength;
+
+
+    if (Config == NULL || ConnectionPool == NULL) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Error;
+    }
+
+    Status = QuicConnPoolValidateConfig(Config, &ServerNameLength);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    CxPlatZeroMemory(ConnectionPool, sizeof(HQUIC) * Config->NumberOfConnections);
+
+    QUIC_ADDR ResolvedRemoteAddress;
+    Status = QuicConnPoolResolveRemoteAddress(Config, &ResolvedRemoteAddress);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    QUIC_ADDR LocalAddress;
+    Status =
+        QuicConnPoolRssInitialize(
+            &Rss,
+            &ResolvedRemoteAddress,
+            QuicConnPoolGetSocketFlags((QUIC_CONFIGURATION*)Config->Configuration),
+            &LocalAddress);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    const uint32_t ConnectionsPerProc =
+        Config->NumberOfConnections % Rss.RssProcessorCount != 0 ?
+            (Config->NumberOfConnections / Rss.RssProcessorCount) + 1:
+            (Config->NumberOfConnections / Rss.RssProcessorCount);
+
+    //
+    // Begin creating and starting connections.
+    //
+    for (uint32_t i = 0; i < Config->NumberOfConnections; i++) {
+        QUIC_CONN_POOL_RSS_PROC_INFO* CurrentProc;
+        Status =
+            QuicConnPoolCreateOnRss(
+                &Rss,
+                ConnectionsPerProc,
+                (QUIC_REGISTRATION*)Config->Registration,
+                (QUIC_CONFIGURATION*)Config->Configuration,
+                Config->Handler,
+                Config->Context ? Config->Context[i] : NULL,
+                &ResolvedRemoteAddress,
+                &LocalAddress,
+                Config->ServerName,
+                ServerNameLength,
+                Config->ServerPort,
+                Config->Family,
+                Config->CibirIdLength,
+                Config->CibirIds ? Config->CibirIds[i] : NULL,
+                Config->ResumptionTicketLength,
+                Config->ResumptionTicket,
+                FALSE,
+                &CurrentProc,
+                &Connections[i]);
+        if (QUIC_FAILED(Status)) {
+            goto CleanUpConnections;
+        }
+
+        //
+        // The connection was created successfully, add it to the count for this processor.
+        //
+        CurrentProc->ConnectionCount++;
+        CreatedConnections++;
+    }
+
+CleanUpConnections:
+    if (QUIC_FAILED(Status) &&
+        (Config->Flags & QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE) != 0) {
+
+        //
+        // Close every connection that was created.
+        // The application will receive the shutdown notification.
+        // Wait for the task to complete so that when this function returns to the app,
+        // all connections are already closed (since the shutdown notification is visible).
+        //
+        for (uint32_t i = 0; i < CreatedConnections; i++) {
+            QuicConnPoolQueueConnectionClose(Connections[i], TRUE);
+            QuicConnRelease(Connections[i], QUIC_CONN_REF_HANDLE_OWNER);
+            Connections[i] = NULL;
+        }
+    }
+
+Error:
+    QuicConnPoolRssUninitialize(&Rss);
+
+    return Status;
+}
+
+typedef struct QUIC_CONN_POOL QUIC_CONN_POOL;
+
+//
+// A managed pool's place for one connection. The connection is replaced when
+// it shuts down, so a slot may see many connections over the pool's lifetime
+// but never more than one at a time.
+//
+typedef struct QUIC_CONN_POOL_SLOT {
+
+    QUIC_CONN_POOL* Pool;
+
+    //
+    // The slot's connection, or NULL if a new one needs to be created.
+    //
+    QUIC_CONNECTION* Connection;
+
+    //
+    // The app context passed to the pool handler for this slot's connections.
+    //
+    void* Context;
+
+    //
+    // The CIBIR ID used by this slot's connections, if any.
+    //
+    const uint8_t* CibirId;
+
+    //
+    // The current local address of the connection.
+    //
+    QUIC_ADDR LocalAddress;
+
+    //
+    // The earliest time (in ms) a new connection may be created for the slot.
+    //
+    uint64_t RetryTime;
+
+    //
+    // The number of consecutive connections that failed to connect.
+    //
+    uint32_t FailureCount;
+
+    //
+    // The number of outstanding ConnectionPoolAcquire calls that returned the
+    // connection. The connection isn't closed until this drops to zero.
+    //
+    uint32_t AcquireCount;
+
+    //
+    // The RSS processor the connection is accounted on, if ProcCounted.
+    //
+    uint32_t ProcIndex;
+
+    BOOLEAN ProcCounted         : 1;
+    BOOLEAN Connected           : 1;
+    BOOLEAN ShutdownComplete    : 1;
+
+} QUIC_CONN_POOL_SLOT;
+
+typedef struct QUIC_CONN_POOL {
+
+#ifdef __cplusplus
+    struct QUIC_HANDLE _;
+#else
+    struct QUIC_HANDLE;
+#endif
+
+    //
+    // One reference for the app's handle, and one for each connection that
+    // has not yet indicated shutdown complete.
+    //
+    CXPLAT_REF_COUNT RefCount;
+
+    //
+    // Serializes the API calls that create connections or update the RSS
+    // state.
+    //
+    CXPLAT_LOCK Lock;
+
+    //
+    // Protects the slots' state, which is shared with the connection callbacks.
+    //
+    CXPLAT_DISPATCH_LOCK SlotLock;
+
+    QUIC_REGISTRATION* Registration;
+    QUIC_CONFIGURATION* Configuration;
+    QUIC_CONNECTION_CALLBACK_HANDLER Handler;
+
+    const char* ServerName;
+    size_t ServerNameLength;
+
+    QUIC_ADDR RemoteAddress;
+
+    //
+    // Where the search for the next local port continues from.
+    //
+    QUIC_ADDR LocalAddress;
+
+    CXPLAT_SOCKET_FLAGS SocketFlags;
+    QUIC_ADDRESS_FAMILY Family;
+    uint16_t ServerPort;
+    uint16_t CibirIdLength;
+    QUIC_CONNECTION_POOL_FLAGS Flags;
+
+    //
+    // The resumption ticket new connections resume with, if any. Updated from
+    // the connections with QUIC_CONNECTION_POOL_FLAG_SHARE_RESUMPTION_TICKET.
+    //
+    uint8_t* ResumptionTicket;
+    uint32_t ResumptionTicketLength;
+
+    //
+    // Set when a connection's local address changed, to query the RSS state
+    // again on the next acquire.
+    //
+    BOOLEAN RssRefreshNeeded;
+    BOOLEAN Closing;
+
+    QUIC_CONN_POOL_RSS Rss;
+
+    uint32_t SlotCount;
+    _Field_size_(SlotCount)
+    QUIC_CONN_POOL_SLOT* Slots;
+
+} QUIC_CONN_POOL;
+
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnPoolRelease(
+    _In_ QUIC_CONN_POOL* Pool
+    )
+{
+    if (CxPlatRefDecrement(&Pool->RefCount)) {
+        QuicConnPoolRssUninitialize(&Pool->Rss);
+        QuicConfigurationRelease(Pool->Configuration, QUIC_CONF_REF_CONN_POOL);
+        CxPlatDispatchLockUninitialize(&Pool->SlotLock);
+        CxPlatLockUninitialize(&Pool->Lock);
+        if (Pool->ServerName != NULL) {
+            CXPLAT_FREE(Pool->ServerName, QUIC_POOL_SERVERNAME);
+        }
+        if (Pool->ResumptionTicket != NULL) {
+            CXPLAT_FREE(Pool->ResumptionTicket, QUIC_POOL_CONN_POOL);
+        }
+        CXPLAT_FREE(Pool, QUIC_POOL_CONN_POOL);
+    }
+}
+
+//
+// Sets when the slot may get a new connection: immediately if the last one
+// connected, or after an exponential backoff if it failed to.
+//
+static
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Requires_lock_held_(Slot->Pool->SlotLock)
+void
+QuicConnPoolSlotSetRetryTime(
+    _In_ QUIC_CONN_POOL_SLOT* Slot,
+    _In_ BOOLEAN Failed
+    )
+{
+    uint64_t Delay = 0;
+    if (Failed) {
+        Delay = (uint64_t)QUIC_CONN_POOL_RETRY_DELAY_MIN_MS << CXPLAT_MIN(Slot->FailureCount, 16);
+        if (Delay > QUIC_CONN_POOL_RETRY_DELAY_MAX_MS) {
+            Delay = QUIC_CONN_POOL_RETRY_DELAY_MAX_MS;
+        }
+        Slot->FailureCount++;
+    } else {
+        Slot->FailureCount = 0;
+    }
+    Slot->RetryTime = CxPlatTimeMs64() + Delay;
+}
+
+static
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Requires_lock_held_(Pool->SlotLock)
+void
+QuicConnPoolSlotUncountProc(
+    _In_ QUIC_CONN_POOL* Pool,
+    _In_ QUIC_CONN_POOL_SLOT* Slot
+    )
+{
+    for (uint32_t i = 0; i < Pool->Rss.RssProcessorCount; i++) {
+        if (Pool->Rss.RssProcessors[i].ProcIndex == Slot->ProcIndex) {
+            if (Pool->Rss.RssProcessors[i].ConnectionCount > 0) {
+                Pool->Rss.RssProcessors[i].ConnectionCount--;
+            }
+            break;
+        }
+    }
+    Slot->ProcCounted = FALSE;
+}
+
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicConnPoolOnShutdownComplete(
+    _In_ QUIC_CONN_POOL* Pool,
+    _In_ QUIC_CONN_POOL_SLOT* Slot,
+    _In_ BOOLEAN HandshakeCompleted
+    )
+{
+    QUIC_CONNECTION* Connection = NULL;
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    Slot->ShutdownComplete = TRUE;
+    Slot->Connected = FALSE;
+    if (Slot->ProcCounted) {
+        QuicConnPoolSlotUncountProc(Pool, Slot);
+    }
+    QuicConnPoolSlotSetRetryTime(Slot, !HandshakeCompleted);
+    if (!Pool->Closing && Slot->AcquireCount == 0) {
+        //
+        // Nobody is using the connection, so free up the slot now. Otherwise,
+        // the last ConnectionPoolRelease does it.
+        //
+        Connection = Slot->Connection;
+        Slot->Connection = NULL;
+    }
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    if (Connection != NULL) {
+        QuicConnPoolQueueConnectionClose(Connection, FALSE);
+    }
+
+    //
+    // Release the reference held by the connection. This may free the pool.
+    //
+    QuicConnPoolRelease(Pool);
+}
+
+//
+// Replaces the resumption ticket used by the pool's new connections.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicConnPoolSetResumptionTicket(
+    _In_ QUIC_CONN_POOL* Pool,
+    _In_ uint32_t ResumptionTicketLength,
+    _In_reads_bytes_(ResumptionTicketLength)
+        const uint8_t* ResumptionTicket
+    )
+{
+    uint8_t* Ticket = CXPLAT_ALLOC_NONPAGED(ResumptionTicketLength, QUIC_POOL_CONN_POOL);
+    if (Ticket == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    CxPlatCopyMemory(Ticket, ResumptionTicket, ResumptionTicketLength);
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    uint8_t* OldTicket = Pool->ResumptionTicket;
+    Pool->ResumptionTicket = Ticket;
+    Pool->ResumptionTicketLength = ResumptionTicketLength;
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    if (OldTicket != NULL) {
+        CXPLAT_FREE(OldTicket, QUIC_POOL_CONN_POOL);
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_CONNECTION_CALLBACK)
+QUIC_STATUS
+QUIC_API
+QuicConnPoolConnectionCallback(
+    _In_ HQUIC Connection,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    )
+{
+    QUIC_CONN_POOL_SLOT* Slot = (QUIC_CONN_POOL_SLOT*)Context;
+    CXPLAT_DBG_ASSERT(Slot != NULL);
+    _Analysis_assume_(Slot != NULL);
+    QUIC_CONN_POOL* Pool = Slot->Pool;
+
+    switch (Event->Type) {
+    case QUIC_CONNECTION_EVENT_CONNECTED:
+        CxPlatDispatchLockAcquire(&Pool->SlotLock);
+        Slot->Connected = TRUE;
+        Slot->FailureCount = 0;
+        CxPlatDispatchLockRelease(&Pool->SlotLock);
+        break;
+
+    case QUIC_CONNECTION_EVENT_LOCAL_ADDRESS_CHANGED:
+        CxPlatDispatchLockAcquire(&Pool->SlotLock);
+        Slot->LocalAddress = *Event->LOCAL_ADDRESS_CHANGED.Address;
+        Pool->RssRefreshNeeded = TRUE;
+        CxPlatDispatchLockRelease(&Pool->SlotLock);
+        break;
+
+    case QUIC_CONNECTION_EVENT_RESUMPTION_TICKET_RECEIVED:
+        if (Pool->Flags & QUIC_CONNECTION_POOL_FLAG_SHARE_RESUMPTION_TICKET) {
+            QuicConnPoolSetResumptionTicket(
+                Pool,
+                Event->RESUMPTION_TICKET_RECEIVED.ResumptionTicketLength,
+                Event->RESUMPTION_TICKET_RECEIVED.ResumptionTicket);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    QUIC_STATUS Status = Pool->Handler(Connection, Slot->Context, Event);
+
+    if (Event->Type == QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE) {
+        QuicConnPoolOnShutdownComplete(
+            Pool,
+            Slot,
+            Event->SHUTDOWN_COMPLETE.HandshakeCompleted);
+    }
+
+    return Status;
+}
+
+//
+// Creates a new connection for an empty slot, on the least loaded RSS
+// processors.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Requires_lock_held_(Pool->Lock)
+QUIC_STATUS
+QuicConnPoolSlotConnect(
+    _In_ QUIC_CONN_POOL* Pool,
+    _In_ QUIC_CONN_POOL_SLOT* Slot
+    )
+{
+    QUIC_CONN_POOL_RSS_PROC_INFO* Proc;
+    QUIC_CONNECTION* Connection;
+    const uint32_t ConnectionsPerProc =
+        (Pool->SlotCount + Pool->Rss.RssProcessorCount - 1) / Pool->Rss.RssProcessorCount;
+
+    uint8_t* ResumptionTicket = NULL;
+    uint32_t ResumptionTicketLength = 0;
+
+    //
+    // Take a copy of the current resumption ticket, since a connection may
+    // replace it while this one is created.
+    //
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    CXPLAT_DBG_ASSERT(Slot->Connection == NULL);
+    Slot->Connected = FALSE;
+    Slot->ShutdownComplete = FALSE;
+    if (Pool->ResumptionTicket != NULL) {
+        ResumptionTicket = CXPLAT_ALLOC_NONPAGED(Pool->ResumptionTicketLength, QUIC_POOL_CONN_POOL);
+        if (ResumptionTicket != NULL) {
+            ResumptionTicketLength = Pool->ResumptionTicketLength;
+            CxPlatCopyMemory(ResumptionTicket, Pool->ResumptionTicket, ResumptionTicketLength);
+        }
+    }
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    //
+    // The connection holds a reference on the pool until it indicates shutdown
+    // complete.
+    //
+    CxPlatRefIncrement(&Pool->RefCount);
+
+    QUIC_STATUS Status =
+        QuicConnPoolCreateOnRss(
+            &Pool->Rss,
+            ConnectionsPerProc,
+            Pool->Registration,
+            Pool->Configuration,
+            QuicConnPoolConnectionCallback,
+            Slot,
+            &Pool->RemoteAddress,
+            &Pool->LocalAddress,
+            Pool->ServerName,
+            Pool->ServerNameLength,
+            Pool->ServerPort,
+            Pool->Family,
+            Pool->CibirIdLength,
+            Slot->CibirId,
+            ResumptionTicketLength,
+            ResumptionTicket,
+            TRUE,
+            &Proc,
+            &Connection);
+    if (ResumptionTicket != NULL) {
+        CXPLAT_FREE(ResumptionTicket, QUIC_POOL_CONN_POOL);
+    }
+    if (QUIC_FAILED(Status)) {
+        CxPlatDispatchLockAcquire(&Pool->SlotLock);
+        QuicConnPoolSlotSetRetryTime(Slot, TRUE);
+        CxPlatDispatchLockRelease(&Pool->SlotLock);
+        QuicConnPoolRelease(Pool);
+        return Status;
+    }
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    if (!Slot->ShutdownComplete) {
+        Slot->Connection = Connection;
+        Slot->LocalAddress = Pool->LocalAddress;
+        Slot->ProcIndex = Proc->ProcIndex;
+        Slot->ProcCounted = TRUE;
+        Proc->ConnectionCount++;
+        Connection = NULL;
+    }
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    if (Connection != NULL) {
+        //
+        // The connection already shut down (and set the slot's retry time), so
+        // it can be closed right away.
+        //
+        QuicConnPoolQueueConnectionClose(Connection, FALSE);
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Queries the RSS state again after a local address change, and recounts the
+// connections per RSS processor from their current local addresses. New
+// connections then go to the processors left with the fewest.
+//
+static
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Requires_lock_held_(Pool->Lock)
+void
+QuicConnPoolRefreshRss(
+    _In_ QUIC_CONN_POOL* Pool
+    )
+{
+    QUIC_CONN_POOL_RSS Rss;
+    QUIC_ADDR LocalAddress;
+
+    QUIC_STATUS Status =
+        QuicConnPoolRssInitialize(
+            &Rss,
+            &Pool->RemoteAddress,
+            Pool->SocketFlags,
+            &LocalAddress);
+    if (QUIC_FAILED(Status)) {
+        //
+        // Keep using the current state.
+        //
+        return;
+    }
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    QUIC_CONN_POOL_RSS OldRss = Pool->Rss;
+    Pool->Rss = Rss;
+    Pool->LocalAddress = LocalAddress;
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        QUIC_CONN_POOL_SLOT* Slot = &Pool->Slots[i];
+        if (Slot->ProcCounted) {
+            QUIC_CONN_POOL_RSS_PROC_INFO* Proc =
+                QuicConnPoolRssGetProc(&Pool->Rss, &Pool->RemoteAddress, &Slot->LocalAddress);
+            Slot->ProcIndex = Proc->ProcIndex;
+            Proc->ConnectionCount++;
+        }
+    }
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    QuicConnPoolRssUninitialize(&OldRss);
+}
+
+static
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicConnPoolGetStreamsInFlight(
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    uint32_t Count = 0;
+    for (uint32_t i = 0; i < NUMBER_OF_STREAM_TYPES; i++) {
+        Count += Connection->Streams.Types[i].CurrentStreamCount;
+    }
+    return Count;
+}
+
+//
+// Compares the load of two slots' connections. The connection state is read
+// from outside its worker thread, so this is only a heuristic.
+//
+static
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Requires_lock_held_(A->Pool->SlotLock)
+BOOLEAN
+QuicConnPoolSlotIsLessLoaded(
+    _In_ const QUIC_CONN_POOL_SLOT* A,
+    _In_ const QUIC_CONN_POOL_SLOT* B
+    )
+{
+    if (A->Connected != B->Connected) {
+        return A->Connected;
+    }
+
+    const QUIC_CONGESTION_CONTROL* CcA = &A->Connection->CongestionControl;
+    const QUIC_CONGESTION_CONTROL* CcB = &B->Connection->CongestionControl;
+
+    const BOOLEAN CanSendA = QuicCongestionControlCanSend((QUIC_CONGESTION_CONTROL*)CcA);
+    const BOOLEAN CanSendB = QuicCongestionControlCanSend((QUIC_CONGESTION_CONTROL*)CcB);
+    if (CanSendA != CanSendB) {
+        return CanSendA;
+    }
+
+    const uint32_t LoadA = QuicConnPoolGetStreamsInFlight(A->Connection) + A->AcquireCount;
+    const uint32_t LoadB = QuicConnPoolGetStreamsInFlight(B->Connection) + B->AcquireCount;
+    if (LoadA != LoadB) {
+        return LoadA < LoadB;
+    }
+
+    return
+        QuicCongestionControlGetCongestionWindow(CcA) >
+        QuicCongestionControlGetCongestionWindow(CcB);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolOpen(
+    _In_ QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Outptr_ _At_(*NewPool, __drv_allocatesMem(Mem)) _Pre_defensive_
+        HQUIC* NewPool
+    )
+{
+    QUIC_CONN_POOL* Pool = NULL;
+    QUIC_STATUS Status;
+    size_t ServerNameLength;
+
+    if (Config == NULL || NewPool == NULL) {
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+        goto Error;
+    }
+
+    Status = QuicConnPoolValidateConfig(Config, &ServerNameLength);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    QUIC_ADDR ResolvedRemoteAddress;
+    Status = QuicConnPoolResolveRemoteAddress(Config, &ResolvedRemoteAddress);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    //
+    // The slots and a copy of the CIBIR IDs are allocated with the pool.
+    //
+    const size_t AllocSize =
+        sizeof(QUIC_CONN_POOL) +
+        Config->NumberOfConnections * (sizeof(QUIC_CONN_POOL_SLOT) + Config->CibirIdLength);
+    Pool = CXPLAT_ALLOC_NONPAGED(AllocSize, QUIC_POOL_CONN_POOL);
+    if (Pool == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+
+    CxPlatZeroMemory(Pool, AllocSize);
+    Pool->Type = QUIC_HANDLE_TYPE_CONNECTION_POOL;
+    CxPlatRefInitialize(&Pool->RefCount);
+    CxPlatLockInitialize(&Pool->Lock);
+    CxPlatDispatchLockInitialize(&Pool->SlotLock);
+    Pool->Registration = (QUIC_REGISTRATION*)Config->Registration;
+    Pool->Configuration = (QUIC_CONFIGURATION*)Config->Configuration;
+    QuicConfigurationAddRef(Pool->Configuration, QUIC_CONF_REF_CONN_POOL);
+    Pool->Handler = Config->Handler;
+    Pool->RemoteAddress = ResolvedRemoteAddress;
+    Pool->SocketFlags = QuicConnPoolGetSocketFlags(Pool->Configuration);
+    Pool->Family = Config->Family;
+    Pool->ServerPort = Config->ServerPort;
+    Pool->CibirIdLength = Config->CibirIdLength;
+    Pool->Flags = Config->Flags;
+    Pool->ServerNameLength = ServerNameLength;
+    Pool->ServerName = QuicConnPoolAllocServerNameCopy(Config->ServerName, ServerNameLength);
+    if (Pool->ServerName == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+
+    if (Config->ResumptionTicket != NULL) {
+        Status =
+            QuicConnPoolSetResumptionTicket(
+                Pool,
+                Config->ResumptionTicketLength,
+                Config->ResumptionTicket);
+        if (QUIC_FAILED(Status)) {
+            goto Error;
+        }
+    }
+
+    Pool->SlotCount = Config->NumberOfConnections;
+    Pool->Slots = (QUIC_CONN_POOL_SLOT*)(Pool + 1);
+    uint8_t* CibirIds = (uint8_t*)(Pool->Slots + Pool->SlotCount);
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        QUIC_CONN_POOL_SLOT* Slot = &Pool->Slots[i];
+        Slot->Pool = Pool;
+        Slot->Context = Config->Context ? Config->Context[i] : NULL;
+        if (Config->CibirIds != NULL) {
+            CxPlatCopyMemory(CibirIds, Config->CibirIds[i], Config->CibirIdLength);
+            Slot->CibirId = CibirIds;
+            CibirIds += Config->CibirIdLength;
+        }
+    }
+
+    Status =
+        QuicConnPoolRssInitialize(
+            &Pool->Rss,
+            &Pool->RemoteAddress,
+            Pool->SocketFlags,
+            &Pool->LocalAddress);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    //
+    // Start the initial connections. Any that fail to start are retried later,
+    // unless the app asked to fail the whole pool.
+    //
+    CxPlatLockAcquire(&Pool->Lock);
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        Status = QuicConnPoolSlotConnect(Pool, &Pool->Slots[i]);
+        if (QUIC_FAILED(Status) &&
+            (Config->Flags & QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE) != 0) {
+            break;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+
+    if (QUIC_FAILED(Status) &&
+        (Config->Flags & QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE) != 0) {
+        MsQuicConnectionPoolClose((HQUIC)Pool);
+        Pool = NULL;
+        goto Error;
+    }
+
+    *NewPool = (HQUIC)Pool;
+    Pool = NULL;
+    Status = QUIC_STATUS_SUCCESS;
+
+Error:
+
+    if (Pool != NULL) {
+        QuicConnPoolRelease(Pool);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QUIC_API
+MsQuicConnectionPoolClose(
+    _In_ _Pre_defensive_ __drv_freesMem(Mem)
+        HQUIC Handle
+    )
+{
+    if (Handle == NULL || Handle->Type != QUIC_HANDLE_TYPE_CONNECTION_POOL) {
+        return;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    QUIC_CONN_POOL* Pool = (QUIC_CONN_POOL*)Handle;
+
+    CxPlatLockAcquire(&Pool->Lock);
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    Pool->Closing = TRUE;
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+    CxPlatLockRelease(&Pool->Lock);
+
+    //
+    // Close every connection, waiting so that the app has seen all shutdown
+    // notifications when this returns. Each connection drops its pool
+    // reference on shutdown complete.
+    //
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        QUIC_CONN_POOL_SLOT* Slot = &Pool->Slots[i];
+        CxPlatDispatchLockAcquire(&Pool->SlotLock);
+        CXPLAT_DBG_ASSERT(Slot->AcquireCount == 0);
+        QUIC_CONNECTION* Connection = Slot->Connection;
+        Slot->Connection = NULL;
+        CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+        if (Connection != NULL) {
+            QuicConnPoolQueueConnectionClose(Connection, TRUE);
+        }
+    }
+
+    QuicConnPoolRelease(Pool);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QUIC_API
+MsQuicConnectionPoolAcquire(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _Out_ HQUIC* Connection
+    )
+{
+    if (Handle == NULL || Handle->Type != QUIC_HANDLE_TYPE_CONNECTION_POOL ||
+        Connection == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    QUIC_CONN_POOL* Pool = (QUIC_CONN_POOL*)Handle;
+    QUIC_CONN_POOL_SLOT* Best = NULL;
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    BOOLEAN RssRefreshNeeded;
+
+    *Connection = NULL;
+
+    CxPlatLockAcquire(&Pool->Lock);
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    RssRefreshNeeded = Pool->RssRefreshNeeded;
+    Pool->RssRefreshNeeded = FALSE;
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    if (Pool->Closing) {
+        Status = QUIC_STATUS_INVALID_STATE;
+        goto Exit;
+    }
+
+    if (RssRefreshNeeded) {
+        QuicConnPoolRefreshRss(Pool);
+    }
+
+    //
+    // Replace the connections that shut down, once their backoff expired.
+    //
+    const uint64_t TimeNow = CxPlatTimeMs64();
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        QUIC_CONN_POOL_SLOT* Slot = &Pool->Slots[i];
+        CxPlatDispatchLockAcquire(&Pool->SlotLock);
+        const BOOLEAN Reconnect =
+            Slot->Connection == NULL &&
+            CxPlatTimeAtOrBefore64(Slot->RetryTime, TimeNow);
+        CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+        if (Reconnect) {
+            (void)QuicConnPoolSlotConnect(Pool, Slot);
+        }
+    }
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        QUIC_CONN_POOL_SLOT* Slot = &Pool->Slots[i];
+        if (Slot->Connection == NULL || Slot->ShutdownComplete) {
+            continue;
+        }
+        if (Best == NULL || QuicConnPoolSlotIsLessLoaded(Slot, Best)) {
+            Best = Slot;
+        }
+    }
+    if (Best != NULL) {
+        Best->AcquireCount++;
+        *Connection = (HQUIC)Best->Connection;
+    }
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    if (Best == NULL) {
+        Status = QUIC_STATUS_UNREACHABLE;
+    }
+
+Exit:
+
+    CxPlatLockRelease(&Pool->Lock);
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QUIC_API
+MsQuicConnectionPoolRelease(
+    _In_ _Pre_defensive_ HQUIC Handle,
+    _In_ _Pre_defensive_ HQUIC ConnectionHandle
+    )
+{
+    if (Handle == NULL || Handle->Type != QUIC_HANDLE_TYPE_CONNECTION_POOL ||
+        ConnectionHandle == NULL) {
+        return;
+    }
+
+#pragma prefast(suppress: __WARNING_25024, "Pointer cast already validated.")
+    QUIC_CONN_POOL* Pool = (QUIC_CONN_POOL*)Handle;
+    QUIC_CONNECTION* Connection = NULL;
+
+    CxPlatDispatchLockAcquire(&Pool->SlotLock);
+    for (uint32_t i = 0; i < Pool->SlotCount; i++) {
+        QUIC_CONN_POOL_SLOT* Slot = &Pool->Slots[i];
+        if (Slot->Connection != (QUIC_CONNECTION*)ConnectionHandle) {
+            continue;
+        }
+        CXPLAT_DBG_ASSERT(Slot->AcquireCount > 0);
+        if (--Slot->AcquireCount == 0 && Slot->ShutdownComplete && !Pool->Closing) {
+            //
+            // The connection shut down while in use; free up the slot now.
+            //
+            Connection = Slot->Connection;
+            Slot->Connection = NULL;
+        }
+        break;
+    }
+    CxPlatDispatchLockRelease(&Pool->SlotLock);
+
+    if (Connection != NULL) {
+        QuicConnPoolQueueConnectionClose(Connection, FALSE);
+    }
 }
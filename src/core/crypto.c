@@ -51,6 +51,95 @@ QuicCryptoValidate(
 #define QuicCryptoValidate(Crypto)
 #endif
 
+//
+// Creates the Initial packet keys for the handshake CID. Servers first look
+// for the secrets in the partition's cache, since clients retransmitting (or
+// replaying) an Initial reuse the same original destination CID.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoCreateInitialKeys(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_VERSION_INFO* VersionInfo,
+    _In_ uint8_t CidLength,
+    _In_reads_(CidLength)
+        const uint8_t* const Cid,
+    _Out_ QUIC_PACKET_KEY** ReadKey,
+    _Out_ QUIC_PACKET_KEY** WriteKey
+    )
+{
+    if (!QuicConnIsServer(Connection) || CidLength > QUIC_MAX_CONNECTION_ID_LENGTH_V1) {
+        return
+            QuicPacketKeyCreateInitial(
+                QuicConnIsServer(Connection),
+                &VersionInfo->HkdfLabels,
+                VersionInfo->Salt,
+                CidLength,
+                Cid,
+                ReadKey,
+                WriteKey);
+    }
+
+    QUIC_PARTITION* Partition = Connection->Partition;
+    QUIC_INITIAL_SECRET_CACHE_ENTRY* Entry =
+        &Partition->InitialSecretCache[
+            CxPlatHashSimple(CidLength, Cid) & (QUIC_INITIAL_SECRET_CACHE_SIZE - 1)];
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    CXPLAT_SECRET ClientInitial, ServerInitial;
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    BOOLEAN Cached = FALSE;
+
+    CxPlatDispatchLockAcquire(&Partition->InitialSecretCacheLock);
+    if (Entry->TimeUs != 0 &&
+        CxPlatTimeDiff64(Entry->TimeUs, TimeNow) < QUIC_INITIAL_SECRET_CACHE_TTL_US &&
+        Entry->Version == VersionInfo->Number &&
+        Entry->CidLength == CidLength &&
+        memcmp(Entry->Cid, Cid, CidLength) == 0) {
+        ClientInitial = Entry->ClientInitial;
+        ServerInitial = Entry->ServerInitial;
+        Cached = TRUE;
+    }
+    CxPlatDispatchLockRelease(&Partition->InitialSecretCacheLock);
+
+    if (!Cached) {
+        Status =
+            CxPlatTlsDeriveInitialSecrets(
+                VersionInfo->Salt,
+                Cid,
+                CidLength,
+                &ClientInitial,
+                &ServerInitial);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+
+        CxPlatDispatchLockAcquire(&Partition->InitialSecretCacheLock);
+        Entry->TimeUs = TimeNow;
+        Entry->Version = VersionInfo->Number;
+        Entry->CidLength = CidLength;
+        CxPlatCopyMemory(Entry->Cid, Cid, CidLength);
+        Entry->ClientInitial = ClientInitial;
+        Entry->ServerInitial = ServerInitial;
+        CxPlatDispatchLockRelease(&Partition->InitialSecretCacheLock);
+    }
+
+    Status =
+        QuicPacketKeyCreateInitialFromSecrets(
+            TRUE,
+            &VersionInfo->HkdfLabels,
+            &ClientInitial,
+            &ServerInitial,
+            ReadKey,
+            WriteKey);
+
+Exit:
+
+    CxPlatSecureZeroMemory(&ClientInitial, sizeof(ClientInitial));
+    CxPlatSecureZeroMemory(&ServerInitial, sizeof(ServerInitial));
+
+    return Status;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicCryptoInitialize(
@@ -97,6 +186,7 @@ QuicCryptoInitialize(
             InitialRecvBufferLength,
             QUIC_DEFAULT_STREAM_FC_WINDOW_SIZE / 2,
             QUIC_RECV_BUF_MODE_SINGLE,
+            NULL,
             NULL);
     if (QUIC_FAILED(Status)) {
         goto Exit;
@@ -127,10 +217,9 @@ QuicCryptoInitialize(
     }
 
     Status =
-        QuicPacketKeyCreateInitial(
-            QuicConnIsServer(Connection),
-            &VersionInfo->HkdfLabels,
-            VersionInfo->Salt,
+        QuicCryptoCreateInitialKeys(
+            Connection,
+            VersionInfo,
             HandshakeCidLength,
             HandshakeCid,
             &Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL],
@@ -171,6 +260,15 @@ QuicCryptoUninitialize(
     _In_ QUIC_CRYPTO* Crypto
     )
 {
+    if (Crypto->Offload != NULL) {
+        //
+        // The offload completion was never processed. Take back the state TLS
+        // updated, so it gets cleaned up below.
+        //
+        Crypto->TlsState = Crypto->Offload->TlsState;
+        CXPLAT_FREE(Crypto->Offload, QUIC_POOL_TLS_OFFLOAD);
+        Crypto->Offload = NULL;
+    }
     for (size_t i = 0; i < QUIC_PACKET_KEY_COUNT; ++i) {
         QuicPacketKeyFree(Crypto->TlsState.ReadKeys[i]);
         Crypto->TlsState.ReadKeys[i] = NULL;
@@ -236,6 +334,7 @@ QuicCryptoInitializeTls(
         TlsConfig.AlpnBuffer = Connection->Configuration->AlpnList;
         TlsConfig.AlpnBufferLength = Connection->Configuration->AlpnListLength;
     }
+    Crypto->SecConfig = SecConfig;
     TlsConfig.SecConfig = SecConfig;
     TlsConfig.Connection = Connection;
     TlsConfig.ResumptionTicketBuffer = Crypto->ResumptionTicket;
@@ -243,7 +342,8 @@ QuicCryptoInitializeTls(
     if (QuicConnIsClient(Connection)) {
         TlsConfig.ServerName = Connection->RemoteServerName;
     }
-    TlsConfig.TlsSecrets = Connection->TlsSecrets;
+    CXPLAT_DBG_ASSERT(Connection->HandshakeState != NULL);
+    TlsConfig.TlsSecrets = Connection->HandshakeState->TlsSecrets;
 
     TlsConfig.HkdfLabels = &QuicSupportedVersionList[0].HkdfLabels; // Default to latest
     for (uint32_t i = 0; i < ARRAYSIZE(QuicSupportedVersionList); ++i) {
@@ -263,7 +363,9 @@ QuicCryptoInitializeTls(
             QuicConnIsServer(Connection),
             Params,
             (Connection->State.TestTransportParameterSet ?
-                &Connection->TestTransportParameter : NULL),
+                &Connection->HandshakeState->TestTransportParameter : NULL),
+            (QuicConnIsServer(Connection) && Connection->Configuration != NULL ?
+                QuicConfigurationGetServerTPCache(Connection->Configuration) : NULL),
             &TlsConfig.LocalTPLength);
     if (TlsConfig.LocalTPBuffer == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
@@ -378,10 +480,9 @@ QuicCryptoOnVersionChange(
     }
 
     Status =
-        QuicPacketKeyCreateInitial(
-            QuicConnIsServer(Connection),
-            &VersionInfo->HkdfLabels,
-            VersionInfo->Salt,
+        QuicCryptoCreateInitialKeys(
+            Connection,
+            VersionInfo,
             HandshakeCidLength,
             HandshakeCid,
             &Crypto->TlsState.ReadKeys[QUIC_PACKET_KEY_INITIAL],
@@ -425,6 +526,18 @@ QuicCryptoHandshakeConfirmed(
     }
 
     QuicCryptoDiscardKeys(Crypto, QUIC_PACKET_KEY_HANDSHAKE);
+
+    //
+    // Nothing reads the handshake-only state past this point.
+    //
+    QuicConnFreeHandshakeState(Connection);
+
+    if (Connection->Settings.IdleHibernateTimeoutMs != 0) {
+        QuicConnTimerSet(
+            Connection,
+            QUIC_CONN_TIMER_HIBERNATE,
+            MS_TO_US(Connection->Settings.IdleHibernateTimeoutMs));
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1180,6 +1293,29 @@ QuicCryptoProcessDataFrame(
             EncLevelOffset = Crypto->RecvEncryptLevelStartOffset;
         }
 
+        if (EncLevelOffset + Frame->Offset == Crypto->RecvBuffer.BaseOffset &&
+            QuicRecvBufferGetTotalLength(&Crypto->RecvBuffer) ==
+                Crypto->RecvBuffer.BaseOffset) {
+            //
+            // The frame starts a new flight at the head of an empty buffer.
+            // Large messages (i.e. a ClientHello with post-quantum key shares
+            // or a long certificate chain) span multiple packets, so size the
+            // buffer for the whole message up front. This way each following
+            // frame is copied exactly once, instead of the buffer repeatedly
+            // doubling and copying everything received so far.
+            //
+            uint32_t MessagesLength =
+                QuicCryptoTlsGetStartedTlsMessagesLength(
+                    Frame->Data, (uint32_t)Frame->Length);
+            if (MessagesLength > Frame->Length) {
+                (void)QuicRecvBufferReserve(
+                    &Crypto->RecvBuffer,
+                    CXPLAT_MIN(
+                        MessagesLength,
+                        Crypto->RecvBuffer.VirtualBufferLength));
+            }
+        }
+
         //
         // Write the received data (could be duplicate) to the stream buffer. The
         // stream buffer will indicate if there is data to process.
@@ -1292,6 +1428,28 @@ QuicCryptoProcessTlsCompletion(
 
     QuicCryptoValidate(Crypto);
 
+    if (Crypto->ResultFlags &
+        (CXPLAT_TLS_RESULT_WRITE_KEY_UPDATED | CXPLAT_TLS_RESULT_READ_KEY_UPDATED)) {
+        //
+        // Make sure the packet spaces exist for all the encryption levels that
+        // now have keys.
+        //
+        for (uint8_t i = QUIC_PACKET_KEY_0_RTT; i <= QUIC_PACKET_KEY_1_RTT; ++i) {
+            if (Crypto->TlsState.WriteKeys[i] == NULL &&
+                Crypto->TlsState.ReadKeys[i] == NULL) {
+                continue;
+            }
+            QUIC_STATUS Status =
+                QuicConnEnsurePacketSpace(
+                    Connection,
+                    QuicKeyTypeToEncryptLevel((QUIC_PACKET_KEY_TYPE)i));
+            if (QUIC_FAILED(Status)) {
+                QuicConnFatalError(Connection, Status, "Packet space OOM");
+                return;
+            }
+        }
+    }
+
     if (Crypto->ResultFlags & CXPLAT_TLS_RESULT_EARLY_DATA_ACCEPT) {
         CXPLAT_TEL_ASSERT(Crypto->TlsState.EarlyDataState == CXPLAT_TLS_EARLY_DATA_ACCEPTED);
     }
@@ -1411,7 +1569,8 @@ QuicCryptoProcessTlsCompletion(
         // Parse the client initial to populate the TlsSecrets with the
         // ClientRandom
         //
-        if (Connection->TlsSecrets != NULL &&
+        if (Connection->HandshakeState != NULL &&
+            Connection->HandshakeState->TlsSecrets != NULL &&
             QuicConnIsClient(Connection) &&
             (Crypto->TlsState.WriteKey == QUIC_PACKET_KEY_INITIAL ||
                 Crypto->TlsState.WriteKey == QUIC_PACKET_KEY_0_RTT) &&
@@ -1420,11 +1579,11 @@ QuicCryptoProcessTlsCompletion(
             QuicCryptoTlsReadClientRandom(
                 Crypto->TlsState.Buffer,
                 Crypto->TlsState.BufferLength,
-                Connection->TlsSecrets);
+                Connection->HandshakeState->TlsSecrets);
             //
             // Connection is done with TlsSecrets, clean up.
             //
-            Connection->TlsSecrets = NULL;
+            Connection->HandshakeState->TlsSecrets = NULL;
         }
         QuicSendSetSendFlag(
             &QuicCryptoGetConnection(Crypto)->Send,
@@ -1482,7 +1641,14 @@ QuicCryptoProcessTlsCompletion(
         // CONNECTED event is indicated to the app).
         //
         Connection->State.Connected = TRUE;
+        Connection->Stats.Timing.HandshakeComplete = CxPlatTimeUs64();
         QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_CONNECTED);
+        QuicWorkerRecordMetric(
+            Connection->Worker,
+            QUIC_METRIC_HISTOGRAM_HANDSHAKE_DURATION,
+            CxPlatTimeDiff64(
+                Connection->Stats.Timing.Start,
+                Connection->Stats.Timing.HandshakeComplete));
 
         QuicConnGenerateNewSourceCids(Connection, FALSE);
 
@@ -1575,6 +1741,10 @@ QuicCryptoCustomCertValidationComplete(
     }
 
     Crypto->CertValidationPending = FALSE;
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    Connection->Stats.Handshake.CertValidationTime +=
+        (uint32_t)CxPlatTimeDiff64(
+            Connection->Stats.Handshake.CertValidationStart, CxPlatTimeUs64());
     if (Result) {
         QuicCryptoProcessDataComplete(Crypto, Crypto->PendingValidationBufferLength);
 
@@ -1587,7 +1757,7 @@ QuicCryptoCustomCertValidationComplete(
     } else {
         CXPLAT_DBG_ASSERT(TlsAlert <= QUIC_TLS_ALERT_CODE_MAX);
         QuicConnTransportError(
-            QuicCryptoGetConnection(Crypto),
+            Connection,
             QUIC_ERROR_CRYPTO_ERROR(0xFF & TlsAlert));
     }
     Crypto->PendingValidationBufferLength = 0;
@@ -1647,7 +1817,7 @@ QuicCryptoCustomTicketValidationComplete(
         }
         QuicRecvBufferResetRead(&Crypto->RecvBuffer);
         QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
-        QUIC_STATUS Status = QuicCryptoInitializeTls(Crypto, Connection->Configuration->SecurityConfig, Connection->HandshakeTP);
+        QUIC_STATUS Status = QuicCryptoInitializeTls(Crypto, Crypto->SecConfig, Connection->HandshakeTP);
         if (Status != QUIC_STATUS_SUCCESS) {
             QuicConnFatalError(Connection, Status, "Failed finalizing resumption ticket rejection");
         }
@@ -1655,6 +1825,133 @@ QuicCryptoCustomTicketValidationComplete(
     Crypto->PendingValidationBufferLength = 0;
 }
 
+//
+// Only a server's first flight of a full (not resumed) handshake is offloaded.
+// It carries the expensive certificate signature and key exchange, and TLS
+// doesn't call back into the connection while producing it.
+//
+QUIC_INLINE
+BOOLEAN
+QuicCryptoShouldOffload(
+    _In_ QUIC_CRYPTO* Crypto
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    return
+        QuicConnIsServer(Connection) &&
+        Connection->Configuration != NULL &&
+        Connection->Configuration->OffloadHandshake &&
+        !Crypto->PeerOfferedPsk &&
+        Crypto->TlsState.BufferTotalLength == 0;
+}
+
+//
+// Hands the TLS processing of the data off to a TLS offload thread. Returns
+// FALSE if the data should be processed inline instead.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicCryptoOffloadData(
+    _In_ QUIC_CRYPTO* Crypto,
+    _In_ const QUIC_BUFFER* Buffer
+    )
+{
+    QUIC_CRYPTO_OFFLOAD* Offload =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_CRYPTO_OFFLOAD) + Buffer->Length,
+            QUIC_POOL_TLS_OFFLOAD);
+    if (Offload == NULL) {
+        return FALSE;
+    }
+
+    //
+    // The received data is copied, since the receive buffer may be written to
+    // while TLS is processing. TLS works on a private copy of the process
+    // state; the worker keeps using the current (initial) keys meanwhile.
+    //
+    Offload->Crypto = Crypto;
+    Offload->TlsState = Crypto->TlsState;
+    Offload->ResultFlags = 0;
+    Offload->BufferLength = Buffer->Length;
+    CxPlatCopyMemory(Offload->Buffer, Buffer->Buffer, Buffer->Length);
+    Crypto->Offload = Offload;
+
+    QuicConnAddRef(QuicCryptoGetConnection(Crypto), QUIC_CONN_REF_TLS_OFFLOAD);
+    QuicLibraryQueueTlsOffload(&Offload->Link);
+
+    return TRUE;
+}
+
+//
+// Returns the time TLS spent processing since TimeStart. Peer certificate
+// validation happens in TLS's callback, but is accounted for separately.
+//
+static
+uint32_t
+QuicCryptoTlsTime(
+    _In_ const QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeStart,
+    _In_ uint32_t CertValidationTime
+    )
+{
+    return
+        (uint32_t)CxPlatTimeDiff64(TimeStart, CxPlatTimeUs64()) -
+        (Connection->Stats.Handshake.CertValidationTime - CertValidationTime);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoProcessOffload(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload
+    )
+{
+    QUIC_CRYPTO* Crypto = Offload->Crypto;
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    const uint32_t CertValidationTime = Connection->Stats.Handshake.CertValidationTime;
+    const uint64_t TimeStart = CxPlatTimeUs64();
+
+    Offload->ResultFlags =
+        CxPlatTlsProcessData(
+            Crypto->TLS,
+            CXPLAT_TLS_CRYPTO_DATA,
+            Offload->Buffer,
+            &Offload->BufferLength,
+            &Offload->TlsState);
+    Offload->TlsTime = QuicCryptoTlsTime(Connection, TimeStart, CertValidationTime);
+
+    QuicConnQueueTlsOffloadCompletion(Connection);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoProcessOffloadComplete(
+    _In_ QUIC_CRYPTO* Crypto
+    )
+{
+    QUIC_CRYPTO_OFFLOAD* Offload = Crypto->Offload;
+    CXPLAT_DBG_ASSERT(Offload != NULL);
+
+    Crypto->Offload = NULL;
+    Crypto->TlsState = Offload->TlsState;
+    Crypto->ResultFlags = Offload->ResultFlags;
+    QuicCryptoGetConnection(Crypto)->Stats.Handshake.TlsTime += Offload->TlsTime;
+    const uint32_t RecvBufferConsumed = Offload->BufferLength;
+    CXPLAT_FREE(Offload, QUIC_POOL_TLS_OFFLOAD);
+
+    if (QuicCryptoGetConnection(Crypto)->State.ShutdownComplete) {
+        return; // Ignore if already shutdown
+    }
+
+    QuicCryptoProcessDataComplete(Crypto, RecvBufferConsumed);
+
+    if (QuicRecvBufferHasUnreadData(&Crypto->RecvBuffer)) {
+        //
+        // More data was received while TLS was processing.
+        //
+        QuicCryptoProcessData(Crypto, FALSE);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicCryptoProcessData(
@@ -1674,6 +1971,13 @@ QuicCryptoProcessData(
         return Status;
     }
 
+    if (Crypto->Offload != NULL) {
+        //
+        // TLS is still processing previous data on an offload thread.
+        //
+        return Status;
+    }
+
     if (IsClientInitial) {
         Buffer.Length = 0;
         Buffer.Buffer = NULL;
@@ -1704,12 +2008,14 @@ QuicCryptoProcessData(
             //
             CXPLAT_DBG_ASSERT(BufferOffset == 0);
             QUIC_NEW_CONNECTION_INFO Info = {0};
+            QUIC_BUFFER PeerTP;
             Status =
                 QuicCryptoTlsReadInitial(
                     Connection,
                     Buffer.Buffer,
                     Buffer.Length,
-                    &Info);
+                    &Info,
+                    &PeerTP);
             if (QUIC_FAILED(Status)) {
                 QuicConnTransportError(
                     Connection,
@@ -1722,6 +2028,40 @@ QuicCryptoProcessData(
                 goto Error;
             }
 
+            Info.LocalAddress = &Connection->Paths[0].Route.LocalAddress;
+            Info.RemoteAddress = &Connection->Paths[0].Route.RemoteAddress;
+            Info.CryptoBufferLength = Buffer.Length;
+            Info.CryptoBuffer = Buffer.Buffer;
+
+            //
+            // Match a listener first, so that handshakes for an unknown ALPN
+            // are rejected before their transport parameters are decoded.
+            //
+            QUIC_LISTENER* Listener =
+                QuicBindingGetListener(
+                    Connection->Paths[0].Binding,
+                    Connection,
+                    &Info);
+            if (Listener == NULL) {
+                QuicConnTransportError(
+                    Connection,
+                    QUIC_ERROR_CRYPTO_NO_APPLICATION_PROTOCOL);
+                goto Error;
+            }
+
+            if (!QuicCryptoTlsDecodeTransportParameters(
+                    Connection,
+                    FALSE,
+                    PeerTP.Buffer,
+                    (uint16_t)PeerTP.Length,
+                    &Connection->PeerTransportParams)) {
+                QuicListenerStartRelease(Listener, TRUE);
+                QuicConnTransportError(
+                    Connection,
+                    QUIC_ERROR_CRYPTO_HANDSHAKE_FAILURE);
+                goto Error;
+            }
+
             Status =
                 QuicConnProcessPeerTransportParameters(Connection, FALSE);
             if (QUIC_FAILED(Status)) {
@@ -1729,6 +2069,7 @@ QuicCryptoProcessData(
                 // Communicate error up the stack to perform Incompatible
                 // Version Negotiation.
                 //
+                QuicListenerStartRelease(Listener, TRUE);
                 goto Error;
             }
 
@@ -1736,17 +2077,15 @@ QuicCryptoProcessData(
             QuicCryptoValidate(Crypto);
 
             Info.QuicVersion = Connection->Stats.QuicVersion;
-            Info.LocalAddress = &Connection->Paths[0].Route.LocalAddress;
-            Info.RemoteAddress = &Connection->Paths[0].Route.RemoteAddress;
-            Info.CryptoBufferLength = Buffer.Length;
-            Info.CryptoBuffer = Buffer.Buffer;
 
             QuicBindingAcceptConnection(
                 Connection->Paths[0].Binding,
                 Connection,
+                Listener,
                 &Info);
 
-            if (Connection->TlsSecrets != NULL &&
+            if (Connection->HandshakeState != NULL &&
+                Connection->HandshakeState->TlsSecrets != NULL &&
                 !Connection->State.HandleClosed &&
                 Connection->State.ExternalOwner) {
                 //
@@ -1756,7 +2095,7 @@ QuicCryptoProcessData(
                 QuicCryptoTlsReadClientRandom(
                     Buffer.Buffer,
                     Buffer.Length,
-                    Connection->TlsSecrets);
+                    Connection->HandshakeState->TlsSecrets);
             }
             return Status;
         }
@@ -1772,6 +2111,16 @@ QuicCryptoProcessData(
 
     QuicCryptoValidate(Crypto);
 
+    if (QuicCryptoShouldOffload(Crypto) &&
+        QuicCryptoOffloadData(Crypto, &Buffer)) {
+        return Status;
+    }
+
+    QUIC_CONNECTION* Connection = QuicCryptoGetConnection(Crypto);
+    const uint32_t CertValidationTime = Connection->Stats.Handshake.CertValidationTime;
+    const uint64_t TimeStart = CxPlatTimeUs64();
+    const QUIC_WORKER_ACTIVITY_TYPE PrevActivity =
+        QuicWorkerSetActivity(Connection->Worker, QUIC_WORKER_ACTIVITY_CRYPTO);
     Crypto->ResultFlags =
         CxPlatTlsProcessData(
             Crypto->TLS,
@@ -1779,6 +2128,9 @@ QuicCryptoProcessData(
             Buffer.Buffer,
             &Buffer.Length,
             &Crypto->TlsState);
+    QuicWorkerSetActivity(Connection->Worker, PrevActivity);
+    Connection->Stats.Handshake.TlsTime +=
+        QuicCryptoTlsTime(Connection, TimeStart, CertValidationTime);
 
     QuicCryptoProcessDataComplete(Crypto, Buffer.Length);
 
@@ -1884,6 +2236,57 @@ Error:
     return Status;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoClonePacketKey(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_PACKET_KEY* Key,
+    _Out_ QUIC_PACKET_KEY** NewKey
+    )
+{
+    CXPLAT_DBG_ASSERT(Key->Type == QUIC_PACKET_KEY_1_RTT);
+
+    const QUIC_VERSION_INFO* VersionInfo = &QuicSupportedVersionList[0]; // Default to latest
+    for (uint32_t i = 0; i < ARRAYSIZE(QuicSupportedVersionList); ++i) {
+        if (QuicSupportedVersionList[i].Number == Connection->Stats.QuicVersion) {
+            VersionInfo = &QuicSupportedVersionList[i];
+            break;
+        }
+    }
+
+    return
+        QuicPacketKeyDerive(
+            QUIC_PACKET_KEY_1_RTT,
+            &VersionInfo->HkdfLabels,
+            Key->TrafficSecret,
+            "clone",
+            FALSE,
+            NewKey);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoPrepareNextKeys(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const QUIC_PACKET_SPACE* PacketSpace = Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT];
+    if (!Connection->State.HandshakeConfirmed ||
+        PacketSpace == NULL ||
+        PacketSpace->AwaitingKeyPhaseConfirmation ||
+        Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT] == NULL ||
+        Connection->Crypto.TlsState.WriteKeys[QUIC_PACKET_KEY_1_RTT] == NULL ||
+        Connection->Crypto.TlsState.ReadKeys[QUIC_PACKET_KEY_1_RTT_NEW] != NULL) {
+        return;
+    }
+
+    //
+    // Failure isn't fatal here; the key update itself tries again and handles
+    // the error.
+    //
+    (void)QuicCryptoGenerateNewKeys(Connection);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicCryptoUpdateKeyPhase(
@@ -1949,8 +2352,17 @@ QuicCryptoUpdateKeyPhase(
 
     UNREFERENCED_PARAMETER(LocalUpdate);
 
+    if (Connection->Paths[0].EncryptionOffloading) {
+        //
+        // The offload only has the previous keys. Fall back to software for
+        // the rest of the connection.
+        //
+        QuicPathUpdateQeo(Connection, &Connection->Paths[0], CXPLAT_QEO_OPERATION_REMOVE);
+    }
+
     PacketSpace->WriteKeyPhaseStartPacketNumber = Connection->Send.NextPacketNumber;
     PacketSpace->CurrentKeyPhase = !PacketSpace->CurrentKeyPhase;
+    QuicConnInvalidateShortHeaders(Connection);
 
     //
     // Reset the read packet space so any new packet will be properly detected.
@@ -2282,6 +2694,7 @@ QuicCryptoEncodeServerTicket(
             TRUE,
             &HSTPCopy,
             NULL,
+            NULL,
             &EncodedTPLength);
     if (EncodedHSTP == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
@@ -2526,6 +2939,7 @@ QuicCryptoEncodeClientTicket(
             TRUE,
             &ServerTPCopy,
             NULL,
+            NULL,
             &EncodedTPLength);
     if (EncodedServerTP == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
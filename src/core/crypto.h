@@ -19,6 +19,49 @@ extern "C" {
 //
 extern CXPLAT_TLS_CALLBACKS QuicTlsCallbacks;
 
+//
+// A TLS process call handed off to one of the library's TLS offload threads.
+//
+typedef struct QUIC_CRYPTO_OFFLOAD {
+
+    //
+    // Link in the library's TLS offload queue.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // The crypto object being processed.
+    //
+    struct QUIC_CRYPTO* Crypto;
+
+    //
+    // Private copy of the TLS process state, updated by TLS on the offload
+    // thread and copied back to the connection on completion.
+    //
+    CXPLAT_TLS_PROCESS_STATE TlsState;
+
+    //
+    // Result flags from the TLS process call.
+    //
+    CXPLAT_TLS_RESULT_FLAGS ResultFlags;
+
+    //
+    // On input, the length of Buffer. On completion, the length TLS consumed.
+    //
+    uint32_t BufferLength;
+
+    //
+    // Time (in us) TLS spent processing, for the handshake statistics.
+    //
+    uint32_t TlsTime;
+
+    //
+    // Copy of the received TLS data.
+    //
+    uint8_t Buffer[0];
+
+} QUIC_CRYPTO_OFFLOAD;
+
 //
 // Stream of TLS data.
 //
@@ -39,11 +82,29 @@ typedef struct QUIC_CRYPTO {
     //
     BOOLEAN CertValidationPending : 1;
 
+    //
+    // Indicates the peer's ClientHello offered a pre-shared key (resumption).
+    //
+    BOOLEAN PeerOfferedPsk : 1;
+
+    //
+    // The TLS processing currently running on an offload thread, if any. No
+    // more data is passed to TLS until it completes.
+    //
+    QUIC_CRYPTO_OFFLOAD* Offload;
+
     //
     // The TLS context for processing handshake messages.
     //
     CXPLAT_TLS* TLS;
 
+    //
+    // The security config the TLS context was created from. Kept so that
+    // reinitializing TLS reuses it even if the configuration's credentials
+    // have since been reloaded.
+    //
+    CXPLAT_SEC_CONFIG* SecConfig;
+
     //
     // Send State
     //
@@ -253,6 +314,24 @@ QuicCryptoProcessData(
     _In_ BOOLEAN IsClientInitial
     );
 
+//
+// Runs an offloaded TLS process call. Called on a TLS offload thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoProcessOffload(
+    _In_ QUIC_CRYPTO_OFFLOAD* Offload
+    );
+
+//
+// Completes an offloaded TLS process call, on the connection's worker.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoProcessOffloadComplete(
+    _In_ QUIC_CRYPTO* Crypto
+    );
+
 //
 // Processes app-provided data for TLS (i.e. resumption ticket data).
 //
@@ -298,10 +377,24 @@ QuicCryptoTlsGetCompleteTlsMessagesLength(
     _In_ uint32_t BufferLength
     );
 
+//
+// Helper function to determine the total length of all TLS messages that have
+// started in the buffer, including a trailing, partially received one.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicCryptoTlsGetStartedTlsMessagesLength(
+    _In_reads_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    );
+
 //
 // Reads, validates and decodes all information needed for preprocessing the
 // initial CRYPTO data from a client. Return QUIC_STATUS_PENDING if not all the
-// data necessary to decode is available.
+// data necessary to decode is available. The peer's transport parameters are
+// only located (in PeerTP), not decoded, so that a connection without a
+// matching listener can be rejected before spending any more work on it.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -310,7 +403,8 @@ QuicCryptoTlsReadInitial(
     _In_reads_(BufferLength)
         const uint8_t* Buffer,
     _In_ uint32_t BufferLength,
-    _Inout_ QUIC_NEW_CONNECTION_INFO* Info
+    _Inout_ QUIC_NEW_CONNECTION_INFO* Info,
+    _Out_ QUIC_BUFFER* PeerTP
     );
 
 //
@@ -335,6 +429,29 @@ QuicCryptoGenerateNewKeys(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Derives an independent copy of a 1-RTT packet key (without a header key),
+// so another thread can seal packets with it at the same time.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicCryptoClonePacketKey(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_PACKET_KEY* Key,
+    _Out_ QUIC_PACKET_KEY** NewKey
+    );
+
+//
+// Generates the 1-RTT keys for the next key phase ahead of time, once the
+// current key phase is confirmed, so the next key update (local or peer
+// initiated) doesn't have to derive them on the packet processing path.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCryptoPrepareNextKeys(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 //
 // Shift 1-RTT keys, freeing the old keys and replacing them with the current
 // keys, replacing the current keys with the new keys; update the start packet
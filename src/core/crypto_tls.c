@@ -28,6 +28,7 @@ typedef enum eTlsExtensions {
     TlsExt_ServerName               = 0x00,
     TlsExt_AppProtocolNegotiation   = 0x10,
     TlsExt_SessionTicket            = 0x23,
+    TlsExt_PreSharedKey             = 0x29,
 } eTlsExtensions;
 
 typedef enum eSniNameType {
@@ -66,6 +67,7 @@ typedef enum eSniNameType {
 #define QUIC_TP_ID_GREASE_QUIC_BIT                          0x2AB2          // N/A
 #define QUIC_TP_ID_RELIABLE_RESET_ENABLED                   0x17f7586d2cb570   // varint
 #define QUIC_TP_ID_ENABLE_TIMESTAMP                         0x7158          // varint
+#define QUIC_TP_ID_FEC_BLOCK_SIZE                           0x3fec          // varint
 
 BOOLEAN
 QuicTpIdIsReserved(
@@ -296,7 +298,8 @@ QuicCryptoTlsReadExtensions(
     _In_reads_(BufferLength)
         const uint8_t* Buffer,
     _In_ uint16_t BufferLength,
-    _Inout_ QUIC_NEW_CONNECTION_INFO* Info
+    _Inout_ QUIC_NEW_CONNECTION_INFO* Info,
+    _Inout_ QUIC_BUFFER* PeerTP
     )
 {
     /*
@@ -356,37 +359,21 @@ QuicCryptoTlsReadExtensions(
             }
             FoundALPN = TRUE;
 
-        } else if (Connection->Stats.QuicVersion != QUIC_VERSION_DRAFT_29) {
-            if (ExtType == TLS_EXTENSION_TYPE_QUIC_TRANSPORT_PARAMETERS) {
-                if (FoundTransportParameters) {
-                    return QUIC_STATUS_INVALID_PARAMETER;
-                }
-                if (!QuicCryptoTlsDecodeTransportParameters(
-                        Connection,
-                        FALSE,
-                        Buffer,
-                        ExtLen,
-                        &Connection->PeerTransportParams)) {
-                    return QUIC_STATUS_INVALID_PARAMETER;
-                }
-                FoundTransportParameters = TRUE;
-            }
+        } else if (ExtType == TlsExt_PreSharedKey) {
+            Connection->Crypto.PeerOfferedPsk = TRUE;
 
-        } else {
-            if (ExtType == TLS_EXTENSION_TYPE_QUIC_TRANSPORT_PARAMETERS_DRAFT) {
-                if (FoundTransportParameters) {
-                    return QUIC_STATUS_INVALID_PARAMETER;
-                }
-                if (!QuicCryptoTlsDecodeTransportParameters(
-                        Connection,
-                        FALSE,
-                        Buffer,
-                        ExtLen,
-                        &Connection->PeerTransportParams)) {
-                    return QUIC_STATUS_INVALID_PARAMETER;
-                }
-                FoundTransportParameters = TRUE;
+        } else if (ExtType == (Connection->Stats.QuicVersion != QUIC_VERSION_DRAFT_29 ?
+                    TLS_EXTENSION_TYPE_QUIC_TRANSPORT_PARAMETERS :
+                    TLS_EXTENSION_TYPE_QUIC_TRANSPORT_PARAMETERS_DRAFT)) {
+            if (FoundTransportParameters) {
+                return QUIC_STATUS_INVALID_PARAMETER;
             }
+            //
+            // Only located here. They are decoded once a listener matches.
+            //
+            PeerTP->Buffer = (uint8_t*)Buffer;
+            PeerTP->Length = ExtLen;
+            FoundTransportParameters = TRUE;
         }
 
         BufferLength -= ExtLen;
@@ -407,7 +394,8 @@ QuicCryptoTlsReadClientHello(
     _In_reads_(BufferLength)
         const uint8_t* Buffer,
     _In_ uint32_t BufferLength,
-    _Inout_ QUIC_NEW_CONNECTION_INFO* Info
+    _Inout_ QUIC_NEW_CONNECTION_INFO* Info,
+    _Inout_ QUIC_BUFFER* PeerTP
     )
 {
     /*
@@ -496,7 +484,8 @@ QuicCryptoTlsReadClientHello(
             Connection,
             Buffer + sizeof(uint16_t),
             Len,
-            Info);
+            Info,
+            PeerTP);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -525,6 +514,32 @@ QuicCryptoTlsGetCompleteTlsMessagesLength(
     return MessagesLength;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicCryptoTlsGetStartedTlsMessagesLength(
+    _In_reads_(BufferLength)
+        const uint8_t* Buffer,
+    _In_ uint32_t BufferLength
+    )
+{
+    uint32_t MessagesLength = 0;
+
+    while (BufferLength >= TLS_MESSAGE_HEADER_LENGTH) {
+
+        uint32_t MessageLength =
+            TLS_MESSAGE_HEADER_LENGTH + TlsReadUint24(Buffer + 1);
+        MessagesLength += MessageLength;
+        if (BufferLength < MessageLength) {
+            break;
+        }
+
+        Buffer += MessageLength;
+        BufferLength -= MessageLength;
+    }
+
+    return MessagesLength;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicCryptoTlsReadInitial(
@@ -532,9 +547,13 @@ QuicCryptoTlsReadInitial(
     _In_reads_(BufferLength)
         const uint8_t* Buffer,
     _In_ uint32_t BufferLength,
-    _Inout_ QUIC_NEW_CONNECTION_INFO* Info
+    _Inout_ QUIC_NEW_CONNECTION_INFO* Info,
+    _Out_ QUIC_BUFFER* PeerTP
     )
 {
+    PeerTP->Buffer = NULL;
+    PeerTP->Length = 0;
+
     do {
         if (BufferLength < TLS_MESSAGE_HEADER_LENGTH) {
             return QUIC_STATUS_PENDING;
@@ -554,7 +573,8 @@ QuicCryptoTlsReadInitial(
                 Connection,
                 Buffer + TLS_MESSAGE_HEADER_LENGTH,
                 MessageLength,
-                Info);
+                Info,
+                PeerTP);
         if (QUIC_FAILED(Status)) {
             return Status;
         }
@@ -595,27 +615,21 @@ QuicCryptoTlsReadClientRandom(
     return QUIC_STATUS_SUCCESS;
 }
 
-_IRQL_requires_max_(DISPATCH_LEVEL)
-_Success_(return != NULL)
-const uint8_t*
-QuicCryptoTlsEncodeTransportParameters(
-    _In_opt_ QUIC_CONNECTION* Connection,
+//
+// Computes the encoded length of the transport parameters selected by Flags.
+//
+static
+size_t
+QuicCryptoTlsGetTransportParametersLength(
     _In_ BOOLEAN IsServerTP,
     _In_ const QUIC_TRANSPORT_PARAMETERS *TransportParams,
-    _In_opt_ const QUIC_PRIVATE_TRANSPORT_PARAMETER* TestParam,
-    _Out_ uint32_t* TPLen
+    _In_ uint32_t Flags
     )
 {
-    //
-    // Precompute the required size so we can allocate all at once.
-    //
-
-    UNREFERENCED_PARAMETER(Connection);
     UNREFERENCED_PARAMETER(IsServerTP);
 
-
     size_t RequiredTPLen = 0;
-    if (TransportParams->Flags & QUIC_TP_FLAG_ORIGINAL_DESTINATION_CONNECTION_ID) {
+    if (Flags & QUIC_TP_FLAG_ORIGINAL_DESTINATION_CONNECTION_ID) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         CXPLAT_FRE_ASSERT(TransportParams->OriginalDestinationConnectionIDLength <= QUIC_MAX_CONNECTION_ID_LENGTH_V1);
         RequiredTPLen +=
@@ -623,97 +637,97 @@ QuicCryptoTlsEncodeTransportParameters(
                 QUIC_TP_ID_ORIGINAL_DESTINATION_CONNECTION_ID,
                 TransportParams->OriginalDestinationConnectionIDLength);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_IDLE_TIMEOUT) {
+    if (Flags & QUIC_TP_FLAG_IDLE_TIMEOUT) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_IDLE_TIMEOUT,
                 QuicVarIntSize(TransportParams->IdleTimeout));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_STATELESS_RESET_TOKEN) {
+    if (Flags & QUIC_TP_FLAG_STATELESS_RESET_TOKEN) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_STATELESS_RESET_TOKEN,
                 QUIC_STATELESS_RESET_TOKEN_LENGTH);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_UDP_PAYLOAD_SIZE) {
+    if (Flags & QUIC_TP_FLAG_MAX_UDP_PAYLOAD_SIZE) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_MAX_UDP_PAYLOAD_SIZE,
                 QuicVarIntSize(TransportParams->MaxUdpPayloadSize));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_DATA) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_DATA) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_MAX_DATA,
                 QuicVarIntSize(TransportParams->InitialMaxData));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_LOCAL) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_LOCAL) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_MAX_STREAM_DATA_BIDI_LOCAL,
                 QuicVarIntSize(TransportParams->InitialMaxStreamDataBidiLocal));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_REMOTE) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_REMOTE) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_MAX_STREAM_DATA_BIDI_REMOTE,
                 QuicVarIntSize(TransportParams->InitialMaxStreamDataBidiRemote));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_UNI) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_UNI) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_MAX_STREAM_DATA_UNI,
                 QuicVarIntSize(TransportParams->InitialMaxStreamDataUni));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_BIDI) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_BIDI) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_MAX_STREAMS_BIDI,
                 QuicVarIntSize(TransportParams->InitialMaxBidiStreams));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_UNI) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_UNI) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_MAX_STREAMS_UNI,
                 QuicVarIntSize(TransportParams->InitialMaxUniStreams));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_ACK_DELAY_EXPONENT) {
+    if (Flags & QUIC_TP_FLAG_ACK_DELAY_EXPONENT) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_ACK_DELAY_EXPONENT,
                 QuicVarIntSize(TransportParams->AckDelayExponent));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_ACK_DELAY) {
+    if (Flags & QUIC_TP_FLAG_MAX_ACK_DELAY) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_MAX_ACK_DELAY,
                 QuicVarIntSize(TransportParams->MaxAckDelay));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_DISABLE_ACTIVE_MIGRATION) {
+    if (Flags & QUIC_TP_FLAG_DISABLE_ACTIVE_MIGRATION) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_DISABLE_ACTIVE_MIGRATION,
                 0);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
+    if (Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         CXPLAT_FRE_ASSERT(FALSE); // TODO - Implement
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_ACTIVE_CONNECTION_ID_LIMIT) {
+    if (Flags & QUIC_TP_FLAG_ACTIVE_CONNECTION_ID_LIMIT) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_ACTIVE_CONNECTION_ID_LIMIT,
                 QuicVarIntSize(TransportParams->ActiveConnectionIdLimit));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_SOURCE_CONNECTION_ID) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_SOURCE_CONNECTION_ID) {
         CXPLAT_FRE_ASSERT(TransportParams->InitialSourceConnectionIDLength <= QUIC_MAX_CONNECTION_ID_LENGTH_V1);
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_INITIAL_SOURCE_CONNECTION_ID,
                 TransportParams->InitialSourceConnectionIDLength);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_RETRY_SOURCE_CONNECTION_ID) {
+    if (Flags & QUIC_TP_FLAG_RETRY_SOURCE_CONNECTION_ID) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         CXPLAT_FRE_ASSERT(TransportParams->RetrySourceConnectionIDLength <= QUIC_MAX_CONNECTION_ID_LENGTH_V1);
         RequiredTPLen +=
@@ -721,57 +735,57 @@ QuicCryptoTlsEncodeTransportParameters(
                 QUIC_TP_ID_RETRY_SOURCE_CONNECTION_ID,
                 TransportParams->RetrySourceConnectionIDLength);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_DATAGRAM_FRAME_SIZE) {
+    if (Flags & QUIC_TP_FLAG_MAX_DATAGRAM_FRAME_SIZE) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_MAX_DATAGRAM_FRAME_SIZE,
                 QuicVarIntSize(TransportParams->MaxDatagramFrameSize));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_DISABLE_1RTT_ENCRYPTION) {
+    if (Flags & QUIC_TP_FLAG_DISABLE_1RTT_ENCRYPTION) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_DISABLE_1RTT_ENCRYPTION,
                 0);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION) {
+    if (Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION) {
         RequiredTPLen += (size_t)
             TlsTransportParamLength(
                 QUIC_TP_ID_VERSION_NEGOTIATION_EXT,
                 TransportParams->VersionInfoLength);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) {
+    if (Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) {
         CXPLAT_DBG_ASSERT(
-            (TransportParams->Flags & QUIC_TP_FLAG_MIN_ACK_DELAY &&
+            (Flags & QUIC_TP_FLAG_MIN_ACK_DELAY &&
              US_TO_MS(TransportParams->MinAckDelay) <= TransportParams->MaxAckDelay) ||
-            (!(TransportParams->Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) &&
+            (!(Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) &&
              US_TO_MS(TransportParams->MinAckDelay) <= QUIC_TP_MAX_ACK_DELAY_DEFAULT));
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_MIN_ACK_DELAY,
                 QuicVarIntSize(TransportParams->MinAckDelay));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_CIBIR_ENCODING) {
+    if (Flags & QUIC_TP_FLAG_CIBIR_ENCODING) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_CIBIR_ENCODING,
                 QuicVarIntSize(TransportParams->CibirLength) +
                 QuicVarIntSize(TransportParams->CibirOffset));
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_GREASE_QUIC_BIT) {
+    if (Flags & QUIC_TP_FLAG_GREASE_QUIC_BIT) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_GREASE_QUIC_BIT,
                 0);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_RELIABLE_RESET_ENABLED) {
+    if (Flags & QUIC_TP_FLAG_RELIABLE_RESET_ENABLED) {
         RequiredTPLen +=
             TlsTransportParamLength(
                 QUIC_TP_ID_RELIABLE_RESET_ENABLED,
                 0);
     }
-    if (TransportParams->Flags & (QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED | QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED)) {
+    if (Flags & (QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED | QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED)) {
         const uint32_t value =
-            (TransportParams->Flags &
+            (Flags &
              (QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED | QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED))
             >> QUIC_TP_FLAG_TIMESTAMP_SHIFT;
         RequiredTPLen +=
@@ -779,32 +793,33 @@ QuicCryptoTlsEncodeTransportParameters(
                 QUIC_TP_ID_ENABLE_TIMESTAMP,
                 QuicVarIntSize(value));
     }
-    if (TestParam != NULL) {
+    if (Flags & QUIC_TP_FLAG_FEC_ENABLED) {
         RequiredTPLen +=
             TlsTransportParamLength(
-                TestParam->Type,
-                TestParam->Length);
+                QUIC_TP_ID_FEC_BLOCK_SIZE,
+                QuicVarIntSize(TransportParams->FecBlockSize));
     }
 
-    CXPLAT_TEL_ASSERT(RequiredTPLen <= UINT16_MAX);
-    if (RequiredTPLen > UINT16_MAX) {
-        return NULL;
-    }
-
-    uint8_t* TPBufBase = CXPLAT_ALLOC_NONPAGED(CxPlatTlsTPHeaderSize + RequiredTPLen, QUIC_POOL_TLS_TRANSPARAMS);
-    if (TPBufBase == NULL) {
-        return NULL;
-    }
-
-    *TPLen = (uint32_t)(CxPlatTlsTPHeaderSize + RequiredTPLen);
-    uint8_t* TPBuf = TPBufBase + CxPlatTlsTPHeaderSize;
+    return RequiredTPLen;
+}
 
-    //
-    // Now that we have allocated the exact size, we can freely write to the
-    // buffer without checking any more lengths.
-    //
+//
+// Encodes the transport parameters selected by Flags. The buffer must have
+// room for QuicCryptoTlsGetTransportParametersLength bytes.
+//
+static
+uint8_t*
+QuicCryptoTlsWriteTransportParameters(
+    _In_ BOOLEAN IsServerTP,
+    _In_ const QUIC_TRANSPORT_PARAMETERS *TransportParams,
+    _In_ uint32_t Flags,
+    _Out_writes_bytes_(_Inexpressible_("Too Dynamic"))
+        uint8_t* TPBuf
+    )
+{
+    UNREFERENCED_PARAMETER(IsServerTP);
 
-    if (TransportParams->Flags & QUIC_TP_FLAG_ORIGINAL_DESTINATION_CONNECTION_ID) {
+    if (Flags & QUIC_TP_FLAG_ORIGINAL_DESTINATION_CONNECTION_ID) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         TPBuf =
             TlsWriteTransportParam(
@@ -813,13 +828,13 @@ QuicCryptoTlsEncodeTransportParameters(
                 TransportParams->OriginalDestinationConnectionID,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_IDLE_TIMEOUT) {
+    if (Flags & QUIC_TP_FLAG_IDLE_TIMEOUT) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_IDLE_TIMEOUT,
                 TransportParams->IdleTimeout, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_STATELESS_RESET_TOKEN) {
+    if (Flags & QUIC_TP_FLAG_STATELESS_RESET_TOKEN) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         TPBuf =
             TlsWriteTransportParam(
@@ -828,61 +843,61 @@ QuicCryptoTlsEncodeTransportParameters(
                 TransportParams->StatelessResetToken,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_UDP_PAYLOAD_SIZE) {
+    if (Flags & QUIC_TP_FLAG_MAX_UDP_PAYLOAD_SIZE) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_MAX_UDP_PAYLOAD_SIZE,
                 TransportParams->MaxUdpPayloadSize, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_DATA) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_DATA) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_INITIAL_MAX_DATA,
                 TransportParams->InitialMaxData, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_LOCAL) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_LOCAL) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_INITIAL_MAX_STREAM_DATA_BIDI_LOCAL,
                 TransportParams->InitialMaxStreamDataBidiLocal, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_REMOTE) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_BIDI_REMOTE) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_INITIAL_MAX_STREAM_DATA_BIDI_REMOTE,
                 TransportParams->InitialMaxStreamDataBidiRemote, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_UNI) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRM_DATA_UNI) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_INITIAL_MAX_STREAM_DATA_UNI,
                 TransportParams->InitialMaxStreamDataUni, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_BIDI) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_BIDI) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_INITIAL_MAX_STREAMS_BIDI,
                 TransportParams->InitialMaxBidiStreams, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_UNI) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_MAX_STRMS_UNI) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_INITIAL_MAX_STREAMS_UNI,
                 TransportParams->InitialMaxUniStreams, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_ACK_DELAY_EXPONENT) {
+    if (Flags & QUIC_TP_FLAG_ACK_DELAY_EXPONENT) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_ACK_DELAY_EXPONENT,
                 TransportParams->AckDelayExponent, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_ACK_DELAY) {
+    if (Flags & QUIC_TP_FLAG_MAX_ACK_DELAY) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_MAX_ACK_DELAY,
                 TransportParams->MaxAckDelay, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_DISABLE_ACTIVE_MIGRATION) {
+    if (Flags & QUIC_TP_FLAG_DISABLE_ACTIVE_MIGRATION) {
         TPBuf =
             TlsWriteTransportParam(
                 QUIC_TP_ID_DISABLE_ACTIVE_MIGRATION,
@@ -890,18 +905,18 @@ QuicCryptoTlsEncodeTransportParameters(
                 NULL,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
+    if (Flags & QUIC_TP_FLAG_PREFERRED_ADDRESS) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         CXPLAT_FRE_ASSERT(FALSE); // TODO - Implement
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_ACTIVE_CONNECTION_ID_LIMIT) {
+    if (Flags & QUIC_TP_FLAG_ACTIVE_CONNECTION_ID_LIMIT) {
         CXPLAT_DBG_ASSERT(TransportParams->ActiveConnectionIdLimit >= QUIC_TP_ACTIVE_CONNECTION_ID_LIMIT_MIN);
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_ACTIVE_CONNECTION_ID_LIMIT,
                 TransportParams->ActiveConnectionIdLimit, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_INITIAL_SOURCE_CONNECTION_ID) {
+    if (Flags & QUIC_TP_FLAG_INITIAL_SOURCE_CONNECTION_ID) {
         TPBuf =
             TlsWriteTransportParam(
                 QUIC_TP_ID_INITIAL_SOURCE_CONNECTION_ID,
@@ -909,7 +924,7 @@ QuicCryptoTlsEncodeTransportParameters(
                 TransportParams->InitialSourceConnectionID,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_RETRY_SOURCE_CONNECTION_ID) {
+    if (Flags & QUIC_TP_FLAG_RETRY_SOURCE_CONNECTION_ID) {
         CXPLAT_DBG_ASSERT(IsServerTP);
         TPBuf =
             TlsWriteTransportParam(
@@ -918,13 +933,13 @@ QuicCryptoTlsEncodeTransportParameters(
                 TransportParams->RetrySourceConnectionID,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MAX_DATAGRAM_FRAME_SIZE) {
+    if (Flags & QUIC_TP_FLAG_MAX_DATAGRAM_FRAME_SIZE) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_MAX_DATAGRAM_FRAME_SIZE,
                 TransportParams->MaxDatagramFrameSize, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_DISABLE_1RTT_ENCRYPTION) {
+    if (Flags & QUIC_TP_FLAG_DISABLE_1RTT_ENCRYPTION) {
         TPBuf =
             TlsWriteTransportParam(
                 QUIC_TP_ID_DISABLE_1RTT_ENCRYPTION,
@@ -932,7 +947,7 @@ QuicCryptoTlsEncodeTransportParameters(
                 NULL,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION) {
+    if (Flags & QUIC_TP_FLAG_VERSION_NEGOTIATION) {
         TPBuf =
             TlsWriteTransportParam(
                 QUIC_TP_ID_VERSION_NEGOTIATION_EXT,
@@ -940,13 +955,13 @@ QuicCryptoTlsEncodeTransportParameters(
                 TransportParams->VersionInfo,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) {
+    if (Flags & QUIC_TP_FLAG_MIN_ACK_DELAY) {
         TPBuf =
             TlsWriteTransportParamVarInt(
                 QUIC_TP_ID_MIN_ACK_DELAY,
                 TransportParams->MinAckDelay, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_CIBIR_ENCODING) {
+    if (Flags & QUIC_TP_FLAG_CIBIR_ENCODING) {
         const uint8_t TPLength =
             QuicVarIntSize(TransportParams->CibirLength) +
             QuicVarIntSize(TransportParams->CibirOffset);
@@ -955,7 +970,7 @@ QuicCryptoTlsEncodeTransportParameters(
         TPBuf = QuicVarIntEncode(TransportParams->CibirLength, TPBuf);
         TPBuf = QuicVarIntEncode(TransportParams->CibirOffset, TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_GREASE_QUIC_BIT) {
+    if (Flags & QUIC_TP_FLAG_GREASE_QUIC_BIT) {
         TPBuf =
             TlsWriteTransportParam(
                 QUIC_TP_ID_GREASE_QUIC_BIT,
@@ -963,7 +978,7 @@ QuicCryptoTlsEncodeTransportParameters(
                 NULL,
                 TPBuf);
     }
-    if (TransportParams->Flags & QUIC_TP_FLAG_RELIABLE_RESET_ENABLED) {
+    if (Flags & QUIC_TP_FLAG_RELIABLE_RESET_ENABLED) {
         TPBuf =
             TlsWriteTransportParam(
                 QUIC_TP_ID_RELIABLE_RESET_ENABLED,
@@ -971,9 +986,9 @@ QuicCryptoTlsEncodeTransportParameters(
                 NULL,
                 TPBuf);
     }
-    if (TransportParams->Flags & (QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED | QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED)) {
+    if (Flags & (QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED | QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED)) {
         const uint32_t value =
-            (TransportParams->Flags &
+            (Flags &
              (QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED | QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED))
             >> QUIC_TP_FLAG_TIMESTAMP_SHIFT;
         TPBuf =
@@ -982,6 +997,175 @@ QuicCryptoTlsEncodeTransportParameters(
                 value,
                 TPBuf);
     }
+    if (Flags & QUIC_TP_FLAG_FEC_ENABLED) {
+        TPBuf =
+            TlsWriteTransportParamVarInt(
+                QUIC_TP_ID_FEC_BLOCK_SIZE,
+                TransportParams->FecBlockSize,
+                TPBuf);
+    }
+
+    return TPBuf;
+}
+
+//
+// Returns TRUE if the transport parameters that don't vary per connection are
+// the same in both, so the encoding of one can stand in for the other.
+//
+static
+BOOLEAN
+QuicCryptoTlsStaticTransportParametersEqual(
+    _In_ const QUIC_TRANSPORT_PARAMETERS *A,
+    _In_ const QUIC_TRANSPORT_PARAMETERS *B
+    )
+{
+    return
+        (A->Flags & ~QUIC_TP_FLAGS_PER_CONNECTION) ==
+            (B->Flags & ~QUIC_TP_FLAGS_PER_CONNECTION) &&
+        A->IdleTimeout == B->IdleTimeout &&
+        A->InitialMaxStreamDataBidiLocal == B->InitialMaxStreamDataBidiLocal &&
+        A->InitialMaxStreamDataBidiRemote == B->InitialMaxStreamDataBidiRemote &&
+        A->InitialMaxStreamDataUni == B->InitialMaxStreamDataUni &&
+        A->InitialMaxData == B->InitialMaxData &&
+        A->InitialMaxBidiStreams == B->InitialMaxBidiStreams &&
+        A->InitialMaxUniStreams == B->InitialMaxUniStreams &&
+        A->MaxUdpPayloadSize == B->MaxUdpPayloadSize &&
+        A->AckDelayExponent == B->AckDelayExponent &&
+        A->MaxAckDelay == B->MaxAckDelay &&
+        A->MinAckDelay == B->MinAckDelay &&
+        A->ActiveConnectionIdLimit == B->ActiveConnectionIdLimit &&
+        A->MaxDatagramFrameSize == B->MaxDatagramFrameSize &&
+        A->FecBlockSize == B->FecBlockSize;
+}
+
+//
+// Returns the pre-encoded static transport parameters in *CacheSlot, building
+// them from TransportParams on first use. Returns NULL if the cached encoding
+// doesn't match TransportParams (e.g. the connection overrode a setting).
+//
+static
+const QUIC_TP_ENCODE_CACHE*
+QuicCryptoTlsGetTransportParametersCache(
+    _In_ BOOLEAN IsServerTP,
+    _In_ const QUIC_TRANSPORT_PARAMETERS *TransportParams,
+    _Inout_ QUIC_TP_ENCODE_CACHE** CacheSlot
+    )
+{
+    const QUIC_TP_ENCODE_CACHE* Cache =
+        (const QUIC_TP_ENCODE_CACHE*)QuicReadPtrAcquire((void**)CacheSlot);
+    if (Cache == NULL) {
+        const uint32_t Flags = TransportParams->Flags & ~QUIC_TP_FLAGS_PER_CONNECTION;
+        const size_t Length =
+            QuicCryptoTlsGetTransportParametersLength(IsServerTP, TransportParams, Flags);
+        if (Length > UINT16_MAX) {
+            return NULL;
+        }
+
+        QUIC_TP_ENCODE_CACHE* NewCache =
+            CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_TP_ENCODE_CACHE) + Length, QUIC_POOL_TP_CACHE);
+        if (NewCache == NULL) {
+            return NULL;
+        }
+
+        NewCache->Params = *TransportParams;
+        NewCache->Params.Flags = Flags;
+        NewCache->Params.VersionInfo = NULL;
+        NewCache->Params.VersionInfoLength = 0;
+        NewCache->Length = (uint16_t)Length;
+        uint8_t* End =
+            QuicCryptoTlsWriteTransportParameters(
+                IsServerTP, TransportParams, Flags, NewCache->Buffer);
+        CXPLAT_DBG_ASSERT(End == NewCache->Buffer + Length);
+        UNREFERENCED_PARAMETER(End);
+
+        //
+        // Another handshake may have raced to build the same encoding; keep
+        // whichever was published first.
+        //
+        Cache =
+            (const QUIC_TP_ENCODE_CACHE*)InterlockedCompareExchangePointer(
+                (void* volatile*)CacheSlot, NewCache, NULL);
+        if (Cache == NULL) {
+            Cache = NewCache;
+        } else {
+            CXPLAT_FREE(NewCache, QUIC_POOL_TP_CACHE);
+        }
+    }
+
+    return
+        QuicCryptoTlsStaticTransportParametersEqual(&Cache->Params, TransportParams) ?
+            Cache : NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+const uint8_t*
+QuicCryptoTlsEncodeTransportParameters(
+    _In_opt_ QUIC_CONNECTION* Connection,
+    _In_ BOOLEAN IsServerTP,
+    _In_ const QUIC_TRANSPORT_PARAMETERS *TransportParams,
+    _In_opt_ const QUIC_PRIVATE_TRANSPORT_PARAMETER* TestParam,
+    _Inout_opt_ QUIC_TP_ENCODE_CACHE** Cache,
+    _Out_ uint32_t* TPLen
+    )
+{
+    UNREFERENCED_PARAMETER(Connection);
+
+    //
+    // When the static parameters are already encoded, only the per-connection
+    // ones are encoded here and the rest is copied in after them. The order of
+    // transport parameters is not significant.
+    //
+    const QUIC_TP_ENCODE_CACHE* StaticTP = NULL;
+    uint32_t Flags = TransportParams->Flags;
+    if (Cache != NULL) {
+        StaticTP =
+            QuicCryptoTlsGetTransportParametersCache(IsServerTP, TransportParams, Cache);
+        if (StaticTP != NULL) {
+            Flags &= QUIC_TP_FLAGS_PER_CONNECTION;
+        }
+    }
+
+    //
+    // Precompute the required size so we can allocate all at once.
+    //
+
+    size_t RequiredTPLen =
+        QuicCryptoTlsGetTransportParametersLength(IsServerTP, TransportParams, Flags);
+    if (StaticTP != NULL) {
+        RequiredTPLen += StaticTP->Length;
+    }
+    if (TestParam != NULL) {
+        RequiredTPLen +=
+            TlsTransportParamLength(
+                TestParam->Type,
+                TestParam->Length);
+    }
+
+    CXPLAT_TEL_ASSERT(RequiredTPLen <= UINT16_MAX);
+    if (RequiredTPLen > UINT16_MAX) {
+        return NULL;
+    }
+
+    uint8_t* TPBufBase = CXPLAT_ALLOC_NONPAGED(CxPlatTlsTPHeaderSize + RequiredTPLen, QUIC_POOL_TLS_TRANSPARAMS);
+    if (TPBufBase == NULL) {
+        return NULL;
+    }
+
+    *TPLen = (uint32_t)(CxPlatTlsTPHeaderSize + RequiredTPLen);
+    uint8_t* TPBuf = TPBufBase + CxPlatTlsTPHeaderSize;
+
+    //
+    // Now that we have allocated the exact size, we can freely write to the
+    // buffer without checking any more lengths.
+    //
+
+    TPBuf = QuicCryptoTlsWriteTransportParameters(IsServerTP, TransportParams, Flags, TPBuf);
+    if (StaticTP != NULL) {
+        CxPlatCopyMemory(TPBuf, StaticTP->Buffer, StaticTP->Length);
+        TPBuf += StaticTP->Length;
+    }
+
     if (TestParam != NULL) {
         TPBuf =
             TlsWriteTransportParam(
@@ -1305,6 +1489,17 @@ QuicCryptoTlsDecodeTransportParameters( // NOLINT(readability-function-size, goo
             break;
         }
 
+        case QUIC_TP_ID_FEC_BLOCK_SIZE:
+            if (!TRY_READ_VAR_INT(TransportParams->FecBlockSize)) {
+                goto Exit;
+            }
+            if (TransportParams->FecBlockSize < 2 ||
+                TransportParams->FecBlockSize > QUIC_FEC_MAX_BLOCK_SIZE) {
+                goto Exit;
+            }
+            TransportParams->Flags |= QUIC_TP_FLAG_FEC_ENABLED;
+            break;
+
         default:
             if (QuicTpIdIsReserved(Id)) {
             } else {
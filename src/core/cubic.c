@@ -19,6 +19,14 @@ Abstract:
 #define TEN_TIMES_BETA_CUBIC 7
 #define TEN_TIMES_C_CUBIC 4
 
+//
+// DCTCP alpha (datacenter mode) is measured in (1 / CUBIC_DCTCP_ALPHA_UNIT)
+// and updated with a gain of 1 / (1 << CUBIC_DCTCP_ALPHA_GAIN_SHIFT), which is
+// the g = 1/16 recommended by RFC 8257.
+//
+#define CUBIC_DCTCP_ALPHA_UNIT 1024
+#define CUBIC_DCTCP_ALPHA_GAIN_SHIFT 4
+
 //
 // Shifting nth root algorithm.
 //
@@ -90,6 +98,27 @@ void CubicCongestionHyStartResetPerRttRound(
   Cubic->MinRttInCurrentRound = UINT64_MAX;
 }
 
+//
+// Records why, and at what window, slow start ended.
+//
+void CubicCongestionControlOnSlowStartExit(
+    _In_ QUIC_CONGESTION_CONTROL *Cc,
+    _In_ QUIC_SLOW_START_EXIT_REASON Reason) {
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  Connection->Stats.Send.SlowStartExitReason = (uint8_t)Reason;
+  Connection->Stats.Send.SlowStartExitWindow = Cc->Cubic.CongestionWindow;
+}
+
+//
+// TRUE if sends are currently being paced.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CubicCongestionControlIsPacing(_In_ const QUIC_CONNECTION *Connection) {
+  return Connection->Settings.PacingEnabled &&
+         Connection->Paths[0].GotFirstRttSample &&
+         Connection->Paths[0].SmoothedRtt >= QUIC_MIN_PACING_RTT;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
     CubicCongestionControlCanSend(_In_ QUIC_CONGESTION_CONTROL *Cc) {
   QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
@@ -114,8 +143,12 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlReset(
   Cubic->HyStartRoundEnd = Connection->Send.NextPacketNumber;
   CubicCongestionHyStartResetPerRttRound(Cubic);
   CubicCongestionHyStartChangeState(Cc, HYSTART_NOT_STARTED);
+  Cubic->DctcpAckedPacketsInRound = 0;
+  Cubic->DctcpCePacketsInRound = 0;
+  Cubic->DctcpRoundEnd = Connection->Send.NextPacketNumber;
   Cubic->IsInRecovery = FALSE;
   Cubic->HasHadCongestionEvent = FALSE;
+  Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
   Cubic->CongestionWindow = DatagramPayloadLength * Cubic->InitialWindowPackets;
   Cubic->BytesInFlightMax = Cubic->CongestionWindow / 2;
   Cubic->LastSendAllowance = 0;
@@ -127,6 +160,32 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlReset(
   QuicConnLogCubic(Connection);
 }
 
+//
+// Since the window grows via ACK feedback and since we defer packets when
+// pacing, using the current window to calculate the pacing rate can slow the
+// growth of the window. So instead, use the predicted window of the next round
+// trip. In slowstart, this is double the current window (the window grows by
+// only 1/CWndSlowStartGrowthDivisor of that in Conservative Slow Start). In
+// congestion avoidance the growth function is more complicated, and we use a
+// simple estimate of 25% growth.
+//
+static uint64_t
+CubicCongestionControlGetEstimatedWindow(
+    _In_ const QUIC_CONGESTION_CONTROL_CUBIC *Cubic) {
+  uint64_t EstimatedWnd;
+  if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
+    EstimatedWnd = (uint64_t)Cubic->CongestionWindow +
+                   Cubic->CongestionWindow / Cubic->CWndSlowStartGrowthDivisor;
+    if (EstimatedWnd > Cubic->SlowStartThreshold) {
+      EstimatedWnd = Cubic->SlowStartThreshold;
+    }
+  } else {
+    EstimatedWnd = Cubic->CongestionWindow +
+                   (Cubic->CongestionWindow >> 2); // CongestionWindow * 1.25
+  }
+  return EstimatedWnd;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
     CubicCongestionControlGetSendAllowance(
         _In_ QUIC_CONGESTION_CONTROL *Cc,
@@ -142,9 +201,8 @@ _IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
     //
     SendAllowance = 0;
 
-  } else if (!TimeSinceLastSendValid || !Connection->Settings.PacingEnabled ||
-             !Connection->Paths[0].GotFirstRttSample ||
-             Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+  } else if (!TimeSinceLastSendValid ||
+             !CubicCongestionControlIsPacing(Connection)) {
     //
     // We're not in the necessary state to pace.
     //
@@ -157,25 +215,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
     // spread out over the RTT. Calculate the current send allowance (chunk
     // size) as the time since the last send times the pacing rate (CWND / RTT).
     //
-
-    //
-    // Since the window grows via ACK feedback and since we defer packets
-    // when pacing, using the current window to calculate the pacing
-    // interval can slow the growth of the window. So instead, use the
-    // predicted window of the next round trip. In slowstart, this is double
-    // the current window. In congestion avoidance the growth function is
-    // more complicated, and we use a simple estimate of 25% growth.
-    //
-    uint64_t EstimatedWnd;
-    if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
-      EstimatedWnd = (uint64_t)Cubic->CongestionWindow << 1;
-      if (EstimatedWnd > Cubic->SlowStartThreshold) {
-        EstimatedWnd = Cubic->SlowStartThreshold;
-      }
-    } else {
-      EstimatedWnd = Cubic->CongestionWindow +
-                     (Cubic->CongestionWindow >> 2); // CongestionWindow * 1.25
-    }
+    uint64_t EstimatedWnd = CubicCongestionControlGetEstimatedWindow(Cubic);
 
     SendAllowance = Cubic->LastSendAllowance +
                     (uint32_t)((EstimatedWnd * TimeSinceLastSend) /
@@ -190,6 +230,17 @@ _IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
   return SendAllowance;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    CubicCongestionControlGetPacingRate(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  if (!CubicCongestionControlIsPacing(Connection)) {
+    return 0;
+  }
+  return CubicCongestionControlGetEstimatedWindow(&Cc->Cubic) *
+         CXPLAT_MICROSEC_PER_SEC / Connection->Paths[0].SmoothedRtt;
+}
+
 //
 // Returns TRUE if we became unblocked.
 //
@@ -223,6 +274,12 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlOnCongestionEvent
       QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
   Connection->Stats.Send.CongestionCount++;
 
+  if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
+    CubicCongestionControlOnSlowStartExit(
+        Cc, Ecn ? QUIC_SLOW_START_EXIT_REASON_ECN
+                : QUIC_SLOW_START_EXIT_REASON_LOSS);
+  }
+
   Cubic->IsInRecovery = TRUE;
   Cubic->HasHadCongestionEvent = TRUE;
 
@@ -293,6 +350,189 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlOnCongestionEvent
   }
 }
 
+//
+// Datacenter mode (DCTCP, RFC 8257) response to CE marks: the window is
+// reduced by Alpha / 2 and the cubic curve restarts from there, with K set so
+// that the curve climbs back to the window at the time of the marks.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlOnDctcpEvent(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
+
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  const uint16_t DatagramPayloadLength =
+      QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+  Connection->Stats.Send.CongestionCount++;
+
+  if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
+    CubicCongestionControlOnSlowStartExit(Cc, QUIC_SLOW_START_EXIT_REASON_ECN);
+  }
+
+  Cubic->IsInRecovery = TRUE;
+  Cubic->HasHadCongestionEvent = TRUE;
+
+  const uint32_t Reduction =
+      (uint32_t)((uint64_t)Cubic->CongestionWindow * Cubic->DctcpAlpha /
+                 (2 * CUBIC_DCTCP_ALPHA_UNIT));
+  Cubic->WindowPrior = Cubic->WindowMax = Cubic->WindowLastMax =
+      Cubic->CongestionWindow;
+
+  //
+  // K = (Reduction / C) ^ (1/3), with the same scaling as above.
+  //
+  Cubic->KCubic =
+      CubeRoot(((Reduction / DatagramPayloadLength * 10) << 9) /
+               TEN_TIMES_C_CUBIC);
+  Cubic->KCubic = S_TO_MS(Cubic->KCubic);
+  Cubic->KCubic >>= 3;
+
+  CubicCongestionHyStartChangeState(Cc, HYSTART_DONE);
+  Cubic->SlowStartThreshold = Cubic->CongestionWindow = Cubic->AimdWindow =
+      CXPLAT_MAX((uint32_t)DatagramPayloadLength *
+                     QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS,
+                 Cubic->CongestionWindow - Reduction);
+}
+
+//
+// Counts the packets acknowledged for the DCTCP marking rate, and folds the
+// rate of each round trip that ends into DctcpAlpha.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlDctcpOnAck(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
+
+  //
+  // The peer's ECN counts cover every packet it received, so count every
+  // acknowledged packet (not just the retransmittable ones).
+  //
+  for (const QUIC_SENT_PACKET_METADATA *Packet = AckEvent->AckedPackets;
+       Packet != NULL; Packet = Packet->Next) {
+    Cubic->DctcpAckedPacketsInRound++;
+  }
+
+  if (AckEvent->IsImplicit || AckEvent->LargestAck < Cubic->DctcpRoundEnd) {
+    return;
+  }
+
+  Cubic->DctcpRoundEnd =
+      QuicCongestionControlGetConnection(Cc)->Send.NextPacketNumber;
+  if (Cubic->DctcpAckedPacketsInRound > 0) {
+    const uint32_t CeRatio = (uint32_t)CXPLAT_MIN(
+        (uint64_t)Cubic->DctcpCePacketsInRound * CUBIC_DCTCP_ALPHA_UNIT /
+            Cubic->DctcpAckedPacketsInRound,
+        CUBIC_DCTCP_ALPHA_UNIT);
+    Cubic->DctcpAlpha = Cubic->DctcpAlpha -
+                        (Cubic->DctcpAlpha >> CUBIC_DCTCP_ALPHA_GAIN_SHIFT) +
+                        (CeRatio >> CUBIC_DCTCP_ALPHA_GAIN_SHIFT);
+  }
+  Cubic->DctcpAckedPacketsInRound = 0;
+  Cubic->DctcpCePacketsInRound = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlSetCarefulResume(
+    _In_ QUIC_CONGESTION_CONTROL *Cc,
+    _In_ const QUIC_CONN_CAREFUL_RESUME_STATE *State) {
+  QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
+
+  if (State->MinRtt == 0 || Cubic->HasHadCongestionEvent ||
+      State->CongestionWindow / 2 <= Cubic->CongestionWindow) {
+    return;
+  }
+
+  Cubic->CarefulResumePhase = CAREFUL_RESUME_RECONNAISSANCE;
+  Cubic->CarefulResumeWindow = State->CongestionWindow;
+  Cubic->CarefulResumeMinRtt = State->MinRtt;
+}
+
+//
+// Moves careful resume through its phases as data is acknowledged. Returns
+// TRUE if the window must not grow on this ACK.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CubicCongestionControlCarefulResumeOnAck(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+
+  switch (Cubic->CarefulResumePhase) {
+  case CAREFUL_RESUME_RECONNAISSANCE: {
+    //
+    // Only jump if the path still looks like the one the window was saved
+    // on; the draft's bounds are half to ten times the saved RTT.
+    //
+    const uint64_t MinRtt = Connection->Paths[0].MinRtt;
+    const uint32_t JumpWindow = Cubic->CarefulResumeWindow / 2;
+    if (MinRtt < Cubic->CarefulResumeMinRtt / 2 ||
+        MinRtt > Cubic->CarefulResumeMinRtt * 10 ||
+        JumpWindow <= Cubic->CongestionWindow) {
+      Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
+      return FALSE;
+    }
+
+    Cubic->CongestionWindow = JumpWindow;
+    if (Cubic->BytesInFlightMax < JumpWindow / 2) {
+      Cubic->BytesInFlightMax = JumpWindow / 2;
+      QuicSendBufferConnectionAdjust(Connection);
+    }
+    Cubic->CarefulResumeAckedBytes = 0;
+    Cubic->CarefulResumeEnd = Connection->Send.NextPacketNumber;
+    Cubic->CarefulResumePhase = CAREFUL_RESUME_UNVALIDATED;
+    return TRUE;
+  }
+
+  case CAREFUL_RESUME_UNVALIDATED:
+    //
+    // Hold the jumped window until the first packet sent with it is
+    // acknowledged, then keep track until all of them are.
+    //
+    Cubic->CarefulResumeAckedBytes += AckEvent->NumRetransmittableBytes;
+    if (AckEvent->LargestAck < Cubic->CarefulResumeEnd) {
+      return TRUE;
+    }
+    Cubic->CarefulResumeEnd = Connection->Send.NextPacketNumber;
+    Cubic->CarefulResumePhase = CAREFUL_RESUME_VALIDATING;
+    return FALSE;
+
+  case CAREFUL_RESUME_VALIDATING:
+    Cubic->CarefulResumeAckedBytes += AckEvent->NumRetransmittableBytes;
+    if (AckEvent->LargestAck >= Cubic->CarefulResumeEnd) {
+      Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
+    }
+    return FALSE;
+
+  default:
+    return FALSE;
+  }
+}
+
+//
+// Called after a congestion event is handled. A congestion event while the
+// jumped window is not yet validated means the saved window was too large, so
+// retreat to half of what was acknowledged since the jump.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void
+    CubicCongestionControlCarefulResumeOnCongestion(
+        _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
+
+  if (Cubic->CarefulResumePhase == CAREFUL_RESUME_UNVALIDATED ||
+      Cubic->CarefulResumePhase == CAREFUL_RESUME_VALIDATING) {
+    const uint16_t DatagramPayloadLength = QuicPathGetDatagramPayloadSize(
+        &QuicCongestionControlGetConnection(Cc)->Paths[0]);
+    const uint32_t RetreatWindow =
+        CXPLAT_MAX((uint32_t)DatagramPayloadLength *
+                       QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS,
+                   Cubic->CarefulResumeAckedBytes / 2);
+    if (RetreatWindow < Cubic->CongestionWindow) {
+      Cubic->SlowStartThreshold = Cubic->CongestionWindow = Cubic->AimdWindow =
+          Cubic->WindowPrior = Cubic->WindowMax = Cubic->WindowLastMax =
+              RetreatWindow;
+      Cubic->KCubic = 0;
+    }
+  }
+  Cubic->CarefulResumePhase = CAREFUL_RESUME_NONE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL) void CubicCongestionControlOnDataSent(
     _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t NumRetransmittableBytes) {
   QUIC_CONGESTION_CONTROL_CUBIC *Cubic = &Cc->Cubic;
@@ -360,6 +600,10 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
   CXPLAT_DBG_ASSERT(Cubic->BytesInFlight >= BytesAcked);
   Cubic->BytesInFlight -= BytesAcked;
 
+  if (Cubic->DatacenterMode) {
+    CubicCongestionControlDctcpOnAck(Cc, AckEvent);
+  }
+
   if (Cubic->IsInRecovery) {
     if (AckEvent->LargestAck > Cubic->RecoverySentPacketNumber) {
       //
@@ -376,6 +620,11 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
     goto Exit;
   }
 
+  if (Cubic->CarefulResumePhase != CAREFUL_RESUME_NONE &&
+      CubicCongestionControlCarefulResumeOnAck(Cc, AckEvent)) {
+    goto Exit;
+  }
+
   //
   // Update HyStart++ RTT sample.
   //
@@ -383,41 +632,49 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
       Cubic->HyStartState != HYSTART_DONE) {
     if (AckEvent->MinRttValid) {
       //
-      // Update Min RTT for the first N ACKs.
+      // Track the minimum RTT over the whole round (RFC 9406). The rounds are
+      // only compared once there are enough samples in the current one.
       //
-      if (Cubic->HyStartAckCount < QUIC_HYSTART_DEFAULT_N_SAMPLING) {
-        Cubic->MinRttInCurrentRound =
-            CXPLAT_MIN(Cubic->MinRttInCurrentRound, AckEvent->MinRtt);
-        Cubic->HyStartAckCount++;
-      } else if (Cubic->HyStartState == HYSTART_NOT_STARTED) {
-        const uint64_t Eta =
-            CXPLAT_MIN(QUIC_HYSTART_DEFAULT_MAX_ETA,
-                       CXPLAT_MAX(QUIC_HYSTART_DEFAULT_MIN_ETA,
-                                  Cubic->MinRttInLastRound /
-                                      8)); // Use 1/8th RTT from HyStart spec.
-        //
-        // Looking for delay increase.
-        //
-        if (Cubic->MinRttInLastRound != UINT64_MAX &&
-            Cubic->MinRttInCurrentRound != UINT64_MAX &&
-            (Cubic->MinRttInCurrentRound >= Cubic->MinRttInLastRound + Eta)) {
+      Cubic->MinRttInCurrentRound =
+          CXPLAT_MIN(Cubic->MinRttInCurrentRound, AckEvent->MinRtt);
+      Cubic->HyStartAckCount++;
+
+      if (Cubic->HyStartAckCount >= QUIC_HYSTART_DEFAULT_N_SAMPLING &&
+          Cubic->MinRttInLastRound != UINT64_MAX) {
+        if (Cubic->HyStartState == HYSTART_NOT_STARTED) {
           //
-          // Exit Slow Start. Now we are going to do Conservative Slow Start for
-          // ConservativeSlowStartRounds rounds.
+          // The default minimum is far above datacenter RTTs, where it would
+          // never let HyStart++ see a delay increase.
           //
-          CubicCongestionHyStartChangeState(Cc, HYSTART_ACTIVE);
-          Cubic->CWndSlowStartGrowthDivisor =
-              QUIC_CONSERVATIVE_SLOW_START_DEFAULT_GROWTH_DIVISOR;
-          Cubic->ConservativeSlowStartRounds =
-              QUIC_CONSERVATIVE_SLOW_START_DEFAULT_ROUNDS;
-          Cubic->CssBaselineMinRtt = Cubic->MinRttInCurrentRound;
-        }
-      } else {
-        //
-        // RTT decreased. Resume SlowStart since we assume the SlowStart exit
-        // was spurious.
-        //
-        if (Cubic->MinRttInCurrentRound < Cubic->CssBaselineMinRtt) {
+          const uint64_t MinEta = Cubic->DatacenterMode
+                                      ? QUIC_DATACENTER_HYSTART_MIN_ETA
+                                      : QUIC_HYSTART_DEFAULT_MIN_ETA;
+          const uint64_t Eta =
+              CXPLAT_MIN(QUIC_HYSTART_DEFAULT_MAX_ETA,
+                         CXPLAT_MAX(MinEta,
+                                    Cubic->MinRttInLastRound /
+                                        8)); // Use 1/8th RTT from HyStart spec.
+          //
+          // Looking for delay increase.
+          //
+          if (Cubic->MinRttInCurrentRound >= Cubic->MinRttInLastRound + Eta) {
+            //
+            // Exit Slow Start. Now we are going to do Conservative Slow Start
+            // for ConservativeSlowStartRounds rounds.
+            //
+            CubicCongestionHyStartChangeState(Cc, HYSTART_ACTIVE);
+            Cubic->CWndSlowStartGrowthDivisor =
+                QUIC_CONSERVATIVE_SLOW_START_DEFAULT_GROWTH_DIVISOR;
+            Cubic->ConservativeSlowStartRounds =
+                QUIC_CONSERVATIVE_SLOW_START_DEFAULT_ROUNDS;
+            Cubic->CssBaselineMinRtt = Cubic->MinRttInCurrentRound;
+          }
+        } else if (Cubic->MinRttInCurrentRound < Cubic->CssBaselineMinRtt) {
+          //
+          // RTT decreased. Resume SlowStart since we assume the SlowStart exit
+          // was spurious.
+          //
+          Cubic->CssBaselineMinRtt = UINT64_MAX;
           CubicCongestionHyStartChangeState(Cc, HYSTART_NOT_STARTED);
         }
       }
@@ -436,6 +693,8 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
           Cubic->SlowStartThreshold = Cubic->CongestionWindow;
           Cubic->TimeOfCongAvoidStart = TimeNowUs;
           Cubic->AimdWindow = Cubic->CongestionWindow;
+          CubicCongestionControlOnSlowStartExit(
+              Cc, QUIC_SLOW_START_EXIT_REASON_HYSTART);
           CubicCongestionHyStartChangeState(Cc, HYSTART_DONE);
         }
       }
@@ -449,10 +708,26 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
     // Slow Start
     //
 
-    Cubic->CongestionWindow += (BytesAcked / Cubic->CWndSlowStartGrowthDivisor);
+    uint32_t Growth = BytesAcked / Cubic->CWndSlowStartGrowthDivisor;
+    if (Connection->Settings.HyStartEnabled &&
+        !CubicCongestionControlIsPacing(Connection)) {
+      //
+      // Without pacing, the window growth is sent as a burst, so HyStart++
+      // limits it per ACK.
+      //
+      const uint32_t BurstLimit =
+          (uint32_t)QuicPathGetDatagramPayloadSize(&Connection->Paths[0]) *
+          QUIC_HYSTART_DEFAULT_BURST_LIMIT;
+      if (Growth > BurstLimit) {
+        Growth = BurstLimit;
+      }
+    }
+    Cubic->CongestionWindow += Growth;
     BytesAcked = 0;
     if (Cubic->CongestionWindow >= Cubic->SlowStartThreshold) {
       Cubic->TimeOfCongAvoidStart = TimeNowUs;
+      CubicCongestionControlOnSlowStartExit(
+          Cc, QUIC_SLOW_START_EXIT_REASON_THRESHOLD);
 
       //
       // We only want exponential growth up to SlowStartThreshold. If
@@ -561,8 +836,8 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
       Cubic->AimdAccumulator += BytesAcked;
     }
     if (Cubic->AimdAccumulator > Cubic->AimdWindow) {
-      Cubic->AimdWindow += DatagramPayloadLength;
       Cubic->AimdAccumulator -= Cubic->AimdWindow;
+      Cubic->AimdWindow += DatagramPayloadLength;
     }
 
     if (Cubic->AimdWindow > CubicWindow) {
@@ -640,6 +915,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlOnDataLost(
     Cubic->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
     CubicCongestionControlOnCongestionEvent(Cc, LossEvent->PersistentCongestion,
                                             FALSE);
+    CubicCongestionControlCarefulResumeOnCongestion(Cc);
 
     CubicCongestionHyStartChangeState(Cc, HYSTART_DONE);
   }
@@ -657,6 +933,10 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlOnEcn(
 
   BOOLEAN PreviousCanSendState = CubicCongestionControlCanSend(Cc);
 
+  if (Cubic->DatacenterMode) {
+    Cubic->DctcpCePacketsInRound += EcnEvent->NewCePackets;
+  }
+
   //
   // If the ECN signal is received after the most recent congestion event
   // (or if there hasn't been a congestion event yet) then treat it as a
@@ -667,7 +947,12 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlOnEcn(
 
     Cubic->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
     QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
-    CubicCongestionControlOnCongestionEvent(Cc, FALSE, TRUE);
+    if (Cubic->DatacenterMode) {
+      CubicCongestionControlOnDctcpEvent(Cc);
+    } else {
+      CubicCongestionControlOnCongestionEvent(Cc, FALSE, TRUE);
+    }
+    CubicCongestionControlCarefulResumeOnCongestion(Cc);
     CubicCongestionHyStartChangeState(Cc, HYSTART_DONE);
   }
 
@@ -699,8 +984,16 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
   Cubic->AimdWindow = Cubic->PrevAimdWindow;
 
   Cubic->IsInRecovery = FALSE;
+  Cubic->IsInPersistentCongestion = FALSE;
   Cubic->HasHadCongestionEvent = FALSE;
 
+  if (Cubic->CongestionWindow < Cubic->SlowStartThreshold) {
+    //
+    // The loss ended slow start, so pick it (and HyStart++) back up.
+    //
+    CubicCongestionHyStartChangeState(Cc, HYSTART_NOT_STARTED);
+  }
+
   BOOLEAN Result =
       CubicCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
   QuicConnLogCubic(Connection);
@@ -740,6 +1033,7 @@ static const QUIC_CONGESTION_CONTROL QuicCongestionControlCubic = {
     .QuicCongestionControlReset = CubicCongestionControlReset,
     .QuicCongestionControlGetSendAllowance =
         CubicCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = CubicCongestionControlGetPacingRate,
     .QuicCongestionControlOnDataSent = CubicCongestionControlOnDataSent,
     .QuicCongestionControlOnDataInvalidated =
         CubicCongestionControlOnDataInvalidated,
@@ -757,7 +1051,9 @@ static const QUIC_CONGESTION_CONTROL QuicCongestionControlCubic = {
     .QuicCongestionControlGetCongestionWindow =
         CubicCongestionControlGetCongestionWindow,
     .QuicCongestionControlGetNetworkStatistics =
-        CubicCongestionControlGetNetworkStatistics};
+        CubicCongestionControlGetNetworkStatistics,
+    .QuicCongestionControlSetCarefulResume =
+        CubicCongestionControlSetCarefulResume};
 
 _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlInitialize(
     _In_ QUIC_CONGESTION_CONTROL *Cc,
@@ -779,6 +1075,9 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void CubicCongestionControlInitialize(
   Cubic->HyStartState = HYSTART_NOT_STARTED;
   Cubic->CWndSlowStartGrowthDivisor = 1;
   CubicCongestionHyStartResetPerRttRound(Cubic);
+  Cubic->DatacenterMode = Settings->DatacenterModeEnabled;
+  Cubic->DctcpAlpha = CUBIC_DCTCP_ALPHA_UNIT;
+  Cubic->DctcpRoundEnd = Connection->Send.NextPacketNumber;
 
   QuicConnLogOutFlowStats(Connection);
   QuicConnLogCubic(Connection);
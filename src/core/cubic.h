@@ -17,6 +17,16 @@ typedef enum QUIC_CUBIC_HYSTART_STATE {
     HYSTART_DONE = 2
 } QUIC_CUBIC_HYSTART_STATE;
 
+//
+// Careful resume phases (draft-ietf-tsvwg-careful-resume).
+//
+typedef enum QUIC_CUBIC_CAREFUL_RESUME_PHASE {
+    CAREFUL_RESUME_NONE = 0,            // Not resuming, or done.
+    CAREFUL_RESUME_RECONNAISSANCE = 1,  // Confirming the path on the first ACK.
+    CAREFUL_RESUME_UNVALIDATED = 2,     // Jumped, waiting for the first ACK.
+    CAREFUL_RESUME_VALIDATING = 3       // Waiting for the jumped data's ACKs.
+} QUIC_CUBIC_CAREFUL_RESUME_PHASE;
+
 typedef struct QUIC_CONGESTION_CONTROL_CUBIC {
 
     //
@@ -42,6 +52,12 @@ typedef struct QUIC_CONGESTION_CONTROL_CUBIC {
     //
     BOOLEAN TimeOfLastAckValid : 1;
 
+    //
+    // TRUE for the datacenter profile, where CE marks reduce the window in
+    // proportion to the marking rate (DCTCP) instead of by BETA.
+    //
+    BOOLEAN DatacenterMode : 1;
+
     //
     // The size of the initial congestion window, in packets.
     //
@@ -107,6 +123,27 @@ typedef struct QUIC_CONGESTION_CONTROL_CUBIC {
     uint32_t CWndSlowStartGrowthDivisor;
     uint32_t ConservativeSlowStartRounds;
 
+    //
+    // Datacenter mode ECN state: the EWMA of the fraction of packets CE marked
+    // per round trip (in 1 / CUBIC_DCTCP_ALPHA_UNIT), and the packets
+    // acknowledged and CE marked so far in the current round trip.
+    //
+    uint32_t DctcpAlpha;
+    uint32_t DctcpAckedPacketsInRound;
+    uint32_t DctcpCePacketsInRound;
+    uint64_t DctcpRoundEnd; // Packet Number
+
+    //
+    // Careful resume state: the window and minimum RTT saved from an earlier
+    // connection, the end of the current phase, and the bytes acknowledged
+    // since the jump to the saved window.
+    //
+    QUIC_CUBIC_CAREFUL_RESUME_PHASE CarefulResumePhase;
+    uint32_t CarefulResumeWindow; // bytes
+    uint32_t CarefulResumeAckedBytes; // bytes
+    uint64_t CarefulResumeMinRtt; // microseconds
+    uint64_t CarefulResumeEnd; // Packet Number
+
     //
     // This variable tracks the largest packet that was outstanding at the time
     // the last congestion event occurred. An ACK for any packet number greater
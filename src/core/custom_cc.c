@@ -0,0 +1,410 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Adapter that runs an app supplied congestion controller (see
+    QUIC_CONGESTION_CONTROL_CALLBACKS) behind the congestion control
+    interface.
+
+    The adapter does the bookkeeping every algorithm needs (bytes in flight,
+    exemptions, pacing allowance and the congestion blocked state) and only
+    asks the controller for the congestion window and the pacing rate, which
+    it updates from the ACK, loss and ECN events.
+
+--*/
+
+#include "precomp.h"
+
+#include "custom_cc.h"
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint16_t
+    CustomCongestionControlGetMss(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  return QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    CustomCongestionControlGetCongestionWindow(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+  return Custom->Callbacks->GetCongestionWindow(Custom->State);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CustomCongestionControlCanSend(_In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+  return Custom->BytesInFlight <
+             CustomCongestionControlGetCongestionWindow(Cc) ||
+         Custom->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint8_t NumPackets) {
+  Cc->Custom.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ BOOLEAN FullReset) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  if (Custom->Callbacks->Reset != NULL) {
+    Custom->Callbacks->Reset(Custom->State, FullReset);
+  }
+  Custom->BytesInFlightMax = CustomCongestionControlGetCongestionWindow(Cc) / 2;
+  Custom->LastSendAllowance = 0;
+  if (FullReset) {
+    Custom->BytesInFlight = 0;
+  }
+
+  QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+}
+
+//
+// Returns the controller's pacing rate, or 0 if sends shouldn't be paced.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    CustomCongestionControlGetPacingRate(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  if (Custom->Callbacks->GetPacingRate == NULL ||
+      !Connection->Settings.PacingEnabled ||
+      !Connection->Paths[0].GotFirstRttSample ||
+      Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+    return 0;
+  }
+  return Custom->Callbacks->GetPacingRate(Custom->State);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    CustomCongestionControlGetSendAllowance(
+        _In_ QUIC_CONGESTION_CONTROL *Cc,
+        _In_ uint64_t TimeSinceLastSend, // microsec
+        _In_ BOOLEAN TimeSinceLastSendValid) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  uint32_t SendAllowance;
+  const uint32_t CongestionWindow =
+      CustomCongestionControlGetCongestionWindow(Cc);
+  const uint64_t PacingRate =
+      TimeSinceLastSendValid ? CustomCongestionControlGetPacingRate(Cc) : 0;
+  if (Custom->BytesInFlight >= CongestionWindow) {
+    //
+    // We are CC blocked, so we can't send anything.
+    //
+    SendAllowance = 0;
+
+  } else if (PacingRate == 0) {
+    //
+    // We're not pacing.
+    //
+    SendAllowance = CongestionWindow - Custom->BytesInFlight;
+
+  } else {
+    //
+    // We are pacing, so send what the controller's rate allows for the time
+    // since the last send.
+    //
+    SendAllowance =
+        Custom->LastSendAllowance +
+        (uint32_t)CXPLAT_MIN(PacingRate * TimeSinceLastSend /
+                                 CXPLAT_MICROSEC_PER_SEC,
+                             UINT32_MAX);
+    if (SendAllowance < Custom->LastSendAllowance || // Overflow case
+        SendAllowance > (CongestionWindow - Custom->BytesInFlight)) {
+      SendAllowance = CongestionWindow - Custom->BytesInFlight;
+    }
+
+    Custom->LastSendAllowance = SendAllowance;
+  }
+  return SendAllowance;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CustomCongestionControlUpdateBlockedState(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ BOOLEAN PreviousCanSendState) {
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  QuicConnLogOutFlowStats(Connection);
+  if (PreviousCanSendState != CustomCongestionControlCanSend(Cc)) {
+    if (PreviousCanSendState) {
+      QuicConnAddOutFlowBlockedReason(Connection,
+                                      QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+    } else {
+      QuicConnRemoveOutFlowBlockedReason(Connection,
+                                         QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+      Connection->Send.LastFlushTime =
+          CxPlatTimeUs64(); // Reset last flush time
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL) void CustomCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t NumRetransmittableBytes) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+  Custom->BytesInFlight += NumRetransmittableBytes;
+  if (Custom->BytesInFlightMax < Custom->BytesInFlight) {
+    Custom->BytesInFlightMax = Custom->BytesInFlight;
+    QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+  }
+
+  if (NumRetransmittableBytes > Custom->LastSendAllowance) {
+    Custom->LastSendAllowance = 0;
+  } else {
+    Custom->LastSendAllowance -= NumRetransmittableBytes;
+  }
+
+  if (Custom->Exemptions > 0) {
+    --Custom->Exemptions;
+  }
+
+  if (Custom->Callbacks->OnDataSent != NULL) {
+    Custom->Callbacks->OnDataSent(Custom->State, NumRetransmittableBytes,
+                                  Custom->BytesInFlight);
+  }
+
+  CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CustomCongestionControlOnDataInvalidated(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                             _In_ uint32_t
+                                                 NumRetransmittableBytes) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+  CXPLAT_DBG_ASSERT(Custom->BytesInFlight >= NumRetransmittableBytes);
+  Custom->BytesInFlight -= NumRetransmittableBytes;
+
+  return CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlGetNetworkStatistics(
+    _In_ const QUIC_CONNECTION *const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL *const Cc,
+    _Out_ QUIC_NETWORK_STATISTICS *NetworkStatistics) {
+  const QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+  const QUIC_PATH *Path = &Connection->Paths[0];
+  const uint32_t CongestionWindow =
+      CustomCongestionControlGetCongestionWindow(Cc);
+
+  NetworkStatistics->BytesInFlight = Custom->BytesInFlight;
+  NetworkStatistics->PostedBytes = Connection->SendBuffer.PostedBytes;
+  NetworkStatistics->IdealBytes = Connection->SendBuffer.IdealBytes;
+  NetworkStatistics->SmoothedRTT = Path->SmoothedRtt;
+  NetworkStatistics->CongestionWindow = CongestionWindow;
+  NetworkStatistics->Bandwidth = CongestionWindow / Path->SmoothedRtt;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CustomCongestionControlOnDataAcknowledged(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+  CXPLAT_DBG_ASSERT(Custom->BytesInFlight >= AckEvent->NumRetransmittableBytes);
+  Custom->BytesInFlight -= AckEvent->NumRetransmittableBytes;
+
+  QUIC_CONGESTION_CONTROL_ACK_EVENT Event = {
+      .TimeNow = AckEvent->TimeNow,
+      .LargestAck = AckEvent->LargestAck,
+      .LargestSentPacketNumber = AckEvent->LargestSentPacketNumber,
+      .TotalAckedRetransmittableBytes =
+          AckEvent->NumTotalAckedRetransmittableBytes,
+      .SmoothedRtt = AckEvent->SmoothedRtt,
+      .MinRtt = AckEvent->MinRtt,
+      .OneWayDelay = AckEvent->OneWayDelay,
+      .AdjustedAckTime = AckEvent->AdjustedAckTime,
+      .NumRetransmittableBytes = AckEvent->NumRetransmittableBytes,
+      .BytesInFlight = Custom->BytesInFlight,
+      .DatagramPayloadSize = CustomCongestionControlGetMss(Cc),
+      .IsImplicit = AckEvent->IsImplicit,
+      .HasLoss = AckEvent->HasLoss,
+      .IsLargestAckedPacketAppLimited =
+          AckEvent->IsLargestAckedPacketAppLimited,
+      .MinRttValid = AckEvent->MinRttValid};
+  Custom->Callbacks->OnDataAcknowledged(Custom->State, &Event);
+
+  if (Connection->Settings.NetStatsEventEnabled) {
+    QUIC_CONNECTION_EVENT NetStatsEvent;
+    NetStatsEvent.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+    CustomCongestionControlGetNetworkStatistics(
+        Connection, Cc, &NetStatsEvent.NETWORK_STATISTICS);
+    QuicConnIndicateEvent(Connection, &NetStatsEvent);
+  }
+
+  return CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_LOSS_EVENT *LossEvent) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+  CXPLAT_DBG_ASSERT(Custom->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+  Custom->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+  QUIC_CONGESTION_CONTROL_LOSS_EVENT Event = {
+      .LargestPacketNumberLost = LossEvent->LargestPacketNumberLost,
+      .LargestSentPacketNumber = LossEvent->LargestSentPacketNumber,
+      .NumRetransmittableBytes = LossEvent->NumRetransmittableBytes,
+      .BytesInFlight = Custom->BytesInFlight,
+      .DatagramPayloadSize = CustomCongestionControlGetMss(Cc),
+      .PersistentCongestion = LossEvent->PersistentCongestion};
+  const uint32_t PrevCongestionWindow =
+      CustomCongestionControlGetCongestionWindow(Cc);
+  Custom->Callbacks->OnDataLost(Custom->State, &Event);
+
+  //
+  // The controller's recovery state isn't visible, so count a congestion
+  // event whenever it responds by shrinking the window.
+  //
+  if (CustomCongestionControlGetCongestionWindow(Cc) < PrevCongestionWindow) {
+    QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+    Connection->Stats.Send.CongestionCount++;
+    if (LossEvent->PersistentCongestion) {
+      Connection->Stats.Send.PersistentCongestionCount++;
+    }
+  }
+
+  CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ECN_EVENT *EcnEvent) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  if (Custom->Callbacks->OnEcn == NULL) {
+    return;
+  }
+
+  BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+  QUIC_CONGESTION_CONTROL_ECN_EVENT Event = {
+      .LargestPacketNumberAcked = EcnEvent->LargestPacketNumberAcked,
+      .LargestSentPacketNumber = EcnEvent->LargestSentPacketNumber,
+      .NewCePackets = EcnEvent->NewCePackets,
+      .BytesInFlight = Custom->BytesInFlight,
+      .DatagramPayloadSize = CustomCongestionControlGetMss(Cc)};
+  const uint32_t PrevCongestionWindow =
+      CustomCongestionControlGetCongestionWindow(Cc);
+  Custom->Callbacks->OnEcn(Custom->State, &Event);
+
+  if (CustomCongestionControlGetCongestionWindow(Cc) < PrevCongestionWindow) {
+    QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
+  }
+
+  CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CustomCongestionControlOnSpuriousCongestionEvent(
+        _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+
+  if (Custom->Callbacks->OnSpuriousCongestionEvent == NULL) {
+    return FALSE;
+  }
+
+  BOOLEAN PreviousCanSendState = CustomCongestionControlCanSend(Cc);
+
+  Custom->Callbacks->OnSpuriousCongestionEvent(Custom->State);
+
+  return CustomCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+uint32_t CustomCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Custom.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint8_t CustomCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Custom.Exemptions;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    CustomCongestionControlIsAppLimited(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  UNREFERENCED_PARAMETER(Cc);
+  return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL *Cc) {
+  UNREFERENCED_PARAMETER(Cc);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void CustomCongestionControlUninitialize(
+    _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_CUSTOM *Custom = &Cc->Custom;
+  if (Custom->Callbacks->Delete != NULL) {
+    Custom->Callbacks->Delete(Custom->State);
+  }
+  Custom->State = NULL;
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlCustom = {
+    .QuicCongestionControlCanSend = CustomCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = CustomCongestionControlSetExemption,
+    .QuicCongestionControlReset = CustomCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance =
+        CustomCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = CustomCongestionControlGetPacingRate,
+    .QuicCongestionControlOnDataSent = CustomCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated =
+        CustomCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged =
+        CustomCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = CustomCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = CustomCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent =
+        CustomCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlGetExemptions = CustomCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax =
+        CustomCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = CustomCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = CustomCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow =
+        CustomCongestionControlGetCongestionWindow,
+    .QuicCongestionControlGetNetworkStatistics =
+        CustomCongestionControlGetNetworkStatistics,
+    .QuicCongestionControlUninitialize = CustomCongestionControlUninitialize};
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN CustomCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL *Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL *Settings,
+    _In_ const QUIC_CONGESTION_CONTROL_CALLBACKS *Callbacks) {
+  void *State = NULL;
+  QUIC_STATUS Status = Callbacks->Create(
+      Callbacks->Context, (HQUIC)QuicCongestionControlGetConnection(Cc),
+      CustomCongestionControlGetMss(Cc), Settings->InitialWindowPackets,
+      &State);
+  if (QUIC_FAILED(Status)) {
+    return FALSE;
+  }
+
+  *Cc = QuicCongestionControlCustom;
+  Cc->Name = Callbacks->Name != NULL ? Callbacks->Name : "Custom";
+  Cc->IsL4S = Callbacks->IsL4S;
+  Cc->Custom.Callbacks = Callbacks;
+  Cc->Custom.State = State;
+  Cc->Custom.BytesInFlightMax =
+      CustomCongestionControlGetCongestionWindow(Cc) / 2;
+
+  QuicConnLogOutFlowStats(QuicCongestionControlGetConnection(Cc));
+  return TRUE;
+}
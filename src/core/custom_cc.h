@@ -0,0 +1,57 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_CONGESTION_CONTROL_CUSTOM {
+
+    //
+    // The app's controller, owned by the connection's registration.
+    //
+    const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks;
+
+    //
+    // The controller's per connection state, from Callbacks->Create.
+    //
+    void* State;
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // The leftover send allowance from a previous send. Only used when pacing.
+    //
+    uint32_t LastSendAllowance; // bytes
+
+    //
+    // A count of packets which can be sent ignoring the congestion window.
+    //
+    uint8_t Exemptions;
+
+} QUIC_CONGESTION_CONTROL_CUSTOM;
+
+//
+// Returns FALSE if the controller failed to create its state.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CustomCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings,
+    _In_ const QUIC_CONGESTION_CONTROL_CALLBACKS* Callbacks
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -14,6 +14,12 @@ Abstract:
 
 #define DATAGRAM_FRAME_HEADER_LENGTH 3
 
+//
+// Worst case header of a FEC_SOURCE or FEC_REPAIR frame: a 2 byte type, an 8
+// byte symbol ID and a 2 byte length, plus a 2 byte length XOR for repairs.
+//
+#define FEC_FRAME_HEADER_LENGTH 14
+
 #define QUIC_DATAGRAM_OVERHEAD(CidLength) \
 (\
     MIN_SHORT_HEADER_LENGTH_V1 + \
@@ -34,28 +40,79 @@ QuicDatagramValidate(
     // items in its queue. Otherwise, sending will have an error case.
     //
     if (QuicConnIsClosed(Connection)) {
-        CXPLAT_DBG_ASSERT(Datagram->SendQueue == NULL);
+        CXPLAT_DBG_ASSERT(Datagram->QueuedClasses == 0);
         CXPLAT_DBG_ASSERT((Connection->Send.SendFlags & QUIC_CONN_SEND_FLAG_DATAGRAM) == 0);
     } else if ((Connection->Send.SendFlags & QUIC_CONN_SEND_FLAG_DATAGRAM) != 0) {
-        CXPLAT_DBG_ASSERT(Datagram->SendQueue != NULL);
+        CXPLAT_DBG_ASSERT(Datagram->QueuedClasses != 0 || Datagram->FecRepairPending);
     } else if (Connection->State.PeerTransportParameterValid) {
-        CXPLAT_DBG_ASSERT(Datagram->SendQueue == NULL);
+        CXPLAT_DBG_ASSERT((Datagram->QueuedClasses & ~Datagram->ThrottledClasses) == 0);
     }
+    CXPLAT_DBG_ASSERT((Datagram->ThrottledClasses & ~Datagram->QueuedClasses) == 0);
 
-    if (!Datagram->SendEnabled) {
-        CXPLAT_DBG_ASSERT(Datagram->MaxSendLength == 0);
-    } else {
-        QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueue;
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        CXPLAT_DBG_ASSERT(
+            (Datagram->SendQueues[Class] != NULL) ==
+            !!(Datagram->QueuedClasses & (1 << Class)));
+        QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueues[Class];
         while (SendRequest) {
             CXPLAT_DBG_ASSERT(SendRequest->TotalLength <= (uint64_t)Datagram->MaxSendLength);
             SendRequest = SendRequest->Next;
         }
     }
+
+    if (!Datagram->SendEnabled) {
+        CXPLAT_DBG_ASSERT(Datagram->MaxSendLength == 0);
+    }
 }
 #else
 #define QuicDatagramValidate(Datagram)
 #endif
 
+//
+// Returns TRUE if there is anything that can be sent right now.
+//
+#define QuicDatagramHasSendWork(Datagram) \
+    (((Datagram)->QueuedClasses & ~(Datagram)->ThrottledClasses) != 0 || \
+     (Datagram)->FecRepairPending)
+
+//
+// The priority class a send request was queued with.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint8_t
+QuicDatagramGetClass(
+    _In_ const QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    if (SendRequest->Flags & QUIC_SEND_FLAG_DGRAM_PRIORITY) {
+        return QUIC_DATAGRAM_PRIORITY_CLASS_COUNT - 1;
+    }
+    return
+        (uint8_t)((SendRequest->Flags & QUIC_SEND_FLAG_DGRAM_CLASS) >>
+            QUIC_SEND_FLAG_DGRAM_CLASS_SHIFT);
+}
+
+//
+// Returns the highest class in a non-empty class mask.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint8_t
+QuicDatagramHighestClass(
+    _In_ uint8_t Classes
+    )
+{
+    CXPLAT_STATIC_ASSERT(
+        QUIC_DATAGRAM_PRIORITY_CLASS_COUNT == 4,
+        "Lookup table assumes 4 classes");
+    static const uint8_t HighestClass[16] = {
+        0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+    };
+    CXPLAT_DBG_ASSERT(Classes != 0 && Classes < 16);
+    return HighestClass[Classes];
+}
+
 uint16_t
 QuicCalculateDatagramLength(
     _In_ QUIC_ADDRESS_FAMILY Family,
@@ -77,8 +134,10 @@ QuicDatagramInitialize(
 {
     Datagram->SendEnabled = TRUE;
     Datagram->MaxSendLength = UINT16_MAX;
-    Datagram->PrioritySendQueueTail = &Datagram->SendQueue;
-    Datagram->SendQueueTail = &Datagram->SendQueue;
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        Datagram->SendQueueTails[Class] = &Datagram->SendQueues[Class];
+    }
+    Datagram->ApiQueueTail = &Datagram->ApiQueue;
     CxPlatDispatchLockInitialize(&Datagram->ApiQueueLock);
     QuicDatagramValidate(Datagram);
 }
@@ -137,8 +196,14 @@ QuicDatagramUninitialize(
     _In_ QUIC_DATAGRAM* Datagram
     )
 {
-    CXPLAT_DBG_ASSERT(Datagram->SendQueue == NULL);
+    CXPLAT_DBG_ASSERT(Datagram->QueuedClasses == 0);
     CXPLAT_DBG_ASSERT(Datagram->ApiQueue == NULL);
+    if (Datagram->FecSendRepair != NULL) {
+        CXPLAT_FREE(Datagram->FecSendRepair, QUIC_POOL_FEC);
+    }
+    if (Datagram->FecRecvBlocks[0].Symbol != NULL) {
+        CXPLAT_FREE(Datagram->FecRecvBlocks[0].Symbol, QUIC_POOL_FEC);
+    }
     CxPlatDispatchLockUninitialize(&Datagram->ApiQueueLock);
 }
 
@@ -158,8 +223,11 @@ QuicDatagramSendShutdown(
     CxPlatDispatchLockAcquire(&Datagram->ApiQueueLock);
     Datagram->SendEnabled = FALSE;
     Datagram->MaxSendLength = 0;
+    Datagram->FecSendEnabled = FALSE;
+    Datagram->FecRepairPending = FALSE;
     QUIC_SEND_REQUEST* ApiQueue = Datagram->ApiQueue;
     Datagram->ApiQueue = NULL;
+    Datagram->ApiQueueTail = &Datagram->ApiQueue;
     CxPlatDispatchLockRelease(&Datagram->ApiQueueLock);
 
     QuicSendClearSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
@@ -167,13 +235,16 @@ QuicDatagramSendShutdown(
     //
     // Cancel all outstanding send requests.
     //
-    while (Datagram->SendQueue != NULL) {
-        QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueue;
-        Datagram->SendQueue = SendRequest->Next;
-        QuicDatagramCancelSend(Connection, SendRequest);
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        while (Datagram->SendQueues[Class] != NULL) {
+            QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueues[Class];
+            Datagram->SendQueues[Class] = SendRequest->Next;
+            QuicDatagramCancelSend(Connection, SendRequest);
+        }
+        Datagram->SendQueueTails[Class] = &Datagram->SendQueues[Class];
     }
-    Datagram->PrioritySendQueueTail = &Datagram->SendQueue;
-    Datagram->SendQueueTail = &Datagram->SendQueue;
+    Datagram->QueuedClasses = 0;
+    Datagram->ThrottledClasses = 0;
 
     while (ApiQueue != NULL) {
         QUIC_SEND_REQUEST* SendRequest = ApiQueue;
@@ -184,33 +255,40 @@ QuicDatagramSendShutdown(
     QuicDatagramValidate(Datagram);
 }
 
+//
+// Cancels the queued requests that are too long for the current max send
+// length or, if CancelBlocked is set, that were flagged to be canceled when
+// they can't be sent immediately.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicDatagramOnMaxSendLengthChanged(
-    _In_ QUIC_DATAGRAM* Datagram
+QuicDatagramCancelQueued(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ BOOLEAN CancelBlocked
     )
 {
     QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
 
-    //
-    // Cancel any outstanding requests that might not fit any more.
-    //
-    QUIC_SEND_REQUEST** SendQueue = &Datagram->SendQueue;
-    while (*SendQueue != NULL) {
-        if ((*SendQueue)->TotalLength > (uint64_t)Datagram->MaxSendLength) {
-            QUIC_SEND_REQUEST* SendRequest = *SendQueue;
-            if (Datagram->PrioritySendQueueTail == &SendRequest->Next) {
-                Datagram->PrioritySendQueueTail = SendQueue;
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        QUIC_SEND_REQUEST** SendQueue = &Datagram->SendQueues[Class];
+        while (*SendQueue != NULL) {
+            if ((*SendQueue)->TotalLength > (uint64_t)Datagram->MaxSendLength ||
+                (CancelBlocked && ((*SendQueue)->Flags & QUIC_SEND_FLAG_CANCEL_ON_BLOCKED))) {
+                QUIC_SEND_REQUEST* SendRequest = *SendQueue;
+                *SendQueue = SendRequest->Next;
+                QuicDatagramCancelSend(Connection, SendRequest);
+            } else {
+                SendQueue = &((*SendQueue)->Next);
             }
-            *SendQueue = SendRequest->Next;
-            QuicDatagramCancelSend(Connection, SendRequest);
-        } else {
-            SendQueue = &((*SendQueue)->Next);
+        }
+        Datagram->SendQueueTails[Class] = SendQueue;
+        if (Datagram->SendQueues[Class] == NULL) {
+            Datagram->QueuedClasses &= ~(1 << Class);
+            Datagram->ThrottledClasses &= ~(1 << Class);
         }
     }
-    Datagram->SendQueueTail = SendQueue;
 
-    if (Datagram->SendQueue != NULL) {
+    if (QuicDatagramHasSendWork(Datagram)) {
         QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
     } else {
         QuicSendClearSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
@@ -219,6 +297,18 @@ QuicDatagramOnMaxSendLengthChanged(
     QuicDatagramValidate(Datagram);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramOnMaxSendLengthChanged(
+    _In_ QUIC_DATAGRAM* Datagram
+    )
+{
+    //
+    // Cancel any outstanding requests that might not fit any more.
+    //
+    QuicDatagramCancelQueued(Datagram, FALSE);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicDatagramOnSendStateChanged(
@@ -248,6 +338,9 @@ QuicDatagramOnSendStateChanged(
             if (Connection->PeerTransportParams.MaxDatagramFrameSize < UINT16_MAX) {
                 NewMaxSendLength = (uint16_t)Connection->PeerTransportParams.MaxDatagramFrameSize;
             }
+            Datagram->FecSendEnabled =
+                Connection->Settings.FecEnabled &&
+                !!(Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_FEC_ENABLED);
         }
     }
 
@@ -310,29 +403,45 @@ QuicDatagramQueueSend(
 {
     QUIC_STATUS Status;
     BOOLEAN QueueOper = TRUE;
-    const BOOLEAN IsPriority = !!(SendRequest->Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+    BOOLEAN IsPriority = FALSE;
+    uint64_t MaxLength = 0;
     QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
 
+    QUIC_SEND_REQUEST* Last = SendRequest;
+    for (;;) {
+        IsPriority |= !!(Last->Flags & QUIC_SEND_FLAG_PRIORITY_WORK);
+        if (Last->TotalLength > MaxLength) {
+            MaxLength = Last->TotalLength;
+        }
+        if (Last->Next == NULL) {
+            break;
+        }
+        Last = Last->Next;
+    }
+
     CxPlatDispatchLockAcquire(&Datagram->ApiQueueLock);
     if (!Datagram->SendEnabled) {
         Status = QUIC_STATUS_INVALID_STATE;
     } else {
-        if (SendRequest->TotalLength > (uint64_t)Datagram->MaxSendLength) {
+        if (MaxLength > (uint64_t)Datagram->MaxSendLength) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
         } else {
-            QUIC_SEND_REQUEST** ApiQueueTail = &Datagram->ApiQueue;
-            while (*ApiQueueTail != NULL) {
-                ApiQueueTail = &((*ApiQueueTail)->Next);
+            if (Datagram->ApiQueue != NULL) {
                 QueueOper = FALSE; // Not necessary if the previous send hasn't been flushed yet.
             }
-            *ApiQueueTail = SendRequest;
+            *Datagram->ApiQueueTail = SendRequest;
+            Datagram->ApiQueueTail = &Last->Next;
             Status = QUIC_STATUS_SUCCESS;
         }
     }
     CxPlatDispatchLockRelease(&Datagram->ApiQueueLock);
 
     if (QUIC_FAILED(Status)) {
-        CxPlatPoolFree(SendRequest);
+        while (SendRequest != NULL) {
+            QUIC_SEND_REQUEST* Next = SendRequest->Next;
+            CxPlatPoolFree(SendRequest);
+            SendRequest = Next;
+        }
         goto Exit;
     }
 
@@ -377,6 +486,7 @@ QuicDatagramSendFlush(
     CxPlatDispatchLockAcquire(&Datagram->ApiQueueLock);
     QUIC_SEND_REQUEST* ApiQueue = Datagram->ApiQueue;
     Datagram->ApiQueue = NULL;
+    Datagram->ApiQueueTail = &Datagram->ApiQueue;
     CxPlatDispatchLockRelease(&Datagram->ApiQueueLock);
     uint64_t TotalBytesSent = 0;
 
@@ -400,21 +510,13 @@ QuicDatagramSendFlush(
         }
         TotalBytesSent += SendRequest->TotalLength;
 
-        if (SendRequest->Flags & QUIC_SEND_FLAG_DGRAM_PRIORITY) {
-            SendRequest->Next = *Datagram->PrioritySendQueueTail;
-            *Datagram->PrioritySendQueueTail = SendRequest;
-            if (Datagram->SendQueueTail == Datagram->PrioritySendQueueTail) {
-                Datagram->SendQueueTail = &SendRequest->Next;
-            }
-            Datagram->PrioritySendQueueTail = &SendRequest->Next;
-        } else {
-            *Datagram->SendQueueTail = SendRequest;
-            Datagram->SendQueueTail = &SendRequest->Next;
-        }
-
+        const uint8_t Class = QuicDatagramGetClass(SendRequest);
+        *Datagram->SendQueueTails[Class] = SendRequest;
+        Datagram->SendQueueTails[Class] = &SendRequest->Next;
+        Datagram->QueuedClasses |= (1 << Class);
     }
 
-    if (Connection->State.PeerTransportParameterValid && Datagram->SendQueue != NULL) {
+    if (Connection->State.PeerTransportParameterValid && QuicDatagramHasSendWork(Datagram)) {
         CXPLAT_DBG_ASSERT(Datagram->SendEnabled);
         QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
     }
@@ -426,6 +528,230 @@ QuicDatagramSendFlush(
         TotalBytesSent);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramSetClassRates(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_reads_(QUIC_DATAGRAM_PRIORITY_CLASS_COUNT)
+        const uint32_t* Rates
+    )
+{
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+
+    //
+    // Start each limited class with a full bucket. The refill caps it at the
+    // class's burst size.
+    //
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        Datagram->ClassRates[Class] = Rates[Class];
+        Datagram->ClassTokens[Class] = UINT32_MAX;
+    }
+    Datagram->ThrottledClasses = 0;
+    Datagram->ClassRefillTime = CxPlatTimeUs64();
+    QuicDatagramRefillClassTokens(Datagram, Datagram->ClassRefillTime);
+
+    if (Connection->State.PeerTransportParameterValid && QuicDatagramHasSendWork(Datagram)) {
+        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
+    }
+
+    QuicDatagramValidate(Datagram);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramRefillClassTokens(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+    const uint64_t Elapsed = CxPlatTimeDiff64(Datagram->ClassRefillTime, TimeNow);
+    Datagram->ClassRefillTime = TimeNow;
+
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        const uint64_t Rate = Datagram->ClassRates[Class];
+        if (Rate == 0) {
+            continue;
+        }
+
+        uint64_t Burst = Rate * QUIC_DATAGRAM_CLASS_BURST_MS / CXPLAT_MS_PER_SECOND;
+        if (Burst < Datagram->MaxSendLength) {
+            Burst = Datagram->MaxSendLength; // Always allow a full datagram.
+        }
+        if (Burst > UINT32_MAX) {
+            Burst = UINT32_MAX;
+        }
+
+        uint64_t Tokens =
+            Datagram->ClassTokens[Class] + Rate * Elapsed / CXPLAT_MICROSEC_PER_SEC;
+        if (Tokens > Burst) {
+            Tokens = Burst;
+        }
+        Datagram->ClassTokens[Class] = (uint32_t)Tokens;
+
+        if ((Datagram->ThrottledClasses & (1 << Class)) &&
+            Tokens >= Datagram->SendQueues[Class]->TotalLength) {
+            Datagram->ThrottledClasses &= ~(1 << Class);
+            if (Connection->State.PeerTransportParameterValid) {
+                QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
+            }
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicDatagramGetThrottledReadyTime(
+    _In_ const QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t TimeNow
+    )
+{
+    uint64_t Delay = UINT64_MAX;
+    for (uint8_t Class = 0; Class < QUIC_DATAGRAM_PRIORITY_CLASS_COUNT; ++Class) {
+        if (!(Datagram->ThrottledClasses & (1 << Class))) {
+            continue;
+        }
+        const uint64_t Missing =
+            Datagram->SendQueues[Class]->TotalLength - Datagram->ClassTokens[Class];
+        const uint64_t ClassDelay =
+            CXPLAT_MAX(
+                1,
+                Missing * CXPLAT_MICROSEC_PER_SEC / Datagram->ClassRates[Class]);
+        if (ClassDelay < Delay) {
+            Delay = ClassDelay;
+        }
+    }
+    CXPLAT_DBG_ASSERT(Delay != UINT64_MAX);
+    return TimeNow + Delay;
+}
+
+//
+// Unlinks the request at the head of a class's send queue.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramRemoveHead(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint8_t Class
+    )
+{
+    QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueues[Class];
+    Datagram->SendQueues[Class] = SendRequest->Next;
+    if (Datagram->SendQueues[Class] == NULL) {
+        Datagram->SendQueueTails[Class] = &Datagram->SendQueues[Class];
+        Datagram->QueuedClasses &= ~(1 << Class);
+    }
+}
+
+//
+// Returns TRUE if the datagram should be sent as an FEC source symbol. The
+// send side repair buffer is allocated on first use; if that fails, the
+// datagram just goes out unprotected.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicDatagramFecShouldProtect(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ const QUIC_PACKET_BUILDER* Builder,
+    _In_ const QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    if (!Datagram->FecSendEnabled ||
+        Builder->Metadata->Flags.KeyType != QUIC_PACKET_KEY_1_RTT ||
+        SendRequest->TotalLength > QUIC_FEC_MAX_SYMBOL_LENGTH ||
+        SendRequest->TotalLength + FEC_FRAME_HEADER_LENGTH >
+            (uint64_t)Datagram->MaxSendLength + DATAGRAM_FRAME_HEADER_LENGTH) {
+        return FALSE;
+    }
+
+    if (Datagram->FecSendRepair == NULL) {
+        Datagram->FecSendRepair =
+            CXPLAT_ALLOC_NONPAGED(QUIC_FEC_MAX_SYMBOL_LENGTH, QUIC_POOL_FEC);
+        if (Datagram->FecSendRepair == NULL) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+//
+// Folds a just framed source datagram into the current block's repair symbol.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramFecAddSourceSymbol(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ const QUIC_SEND_REQUEST* SendRequest
+    )
+{
+    CXPLAT_DBG_ASSERT(!Datagram->FecRepairPending);
+    uint8_t* Repair = Datagram->FecSendRepair;
+    if (Datagram->FecSendBlockCount == 0) {
+        CxPlatZeroMemory(Repair, QUIC_FEC_MAX_SYMBOL_LENGTH);
+    }
+
+    for (uint32_t i = 0; i < SendRequest->BufferCount; ++i) {
+        const QUIC_BUFFER* Buffer = &SendRequest->Buffers[i];
+        for (uint32_t j = 0; j < Buffer->Length; ++j) {
+            Repair[j] ^= Buffer->Buffer[j];
+        }
+        Repair += Buffer->Length;
+    }
+
+    const uint16_t Length = (uint16_t)SendRequest->TotalLength;
+    if (Length > Datagram->FecSendRepairLength) {
+        Datagram->FecSendRepairLength = Length;
+    }
+    Datagram->FecSendLengthXor ^= Length;
+    Datagram->FecNextSymbolId++;
+
+    if (++Datagram->FecSendBlockCount == QUIC_FEC_BLOCK_SIZE) {
+        Datagram->FecRepairPending = TRUE;
+    }
+}
+
+//
+// Writes the repair frame for the completed send block. Returns FALSE if it
+// didn't fit in the packet.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicDatagramFecWriteRepairFrame(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    )
+{
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+    CXPLAT_DBG_ASSERT(Datagram->FecRepairPending);
+
+    QUIC_FEC_REPAIR_EX Frame = {
+        Datagram->FecNextSymbolId - QUIC_FEC_BLOCK_SIZE,
+        Datagram->FecSendLengthXor,
+        Datagram->FecSendRepairLength,
+        Datagram->FecSendRepair
+    };
+
+    if (!QuicFecRepairFrameEncode(
+            &Frame,
+            &Builder->DatagramLength,
+            (uint16_t)Builder->Datagram->Length - Builder->EncryptionOverhead,
+            Builder->Datagram->Buffer)) {
+        return FALSE;
+    }
+
+    Builder->Metadata->Flags.IsAckEliciting = TRUE;
+    Builder->Metadata->Frames[Builder->Metadata->FrameCount].Type = QUIC_FRAME_FEC_REPAIR;
+
+    Datagram->FecRepairPending = FALSE;
+    Datagram->FecSendBlockCount = 0;
+    Datagram->FecSendRepairLength = 0;
+    Datagram->FecSendLengthXor = 0;
+    Connection->Stats.Send.FecRepairSymbols++;
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicDatagramWriteFrame(
@@ -436,11 +762,55 @@ QuicDatagramWriteFrame(
     QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
     CXPLAT_DBG_ASSERT(Datagram->SendEnabled);
     BOOLEAN Result = FALSE;
+    uint64_t TimeNow = 0;
 
     QuicDatagramValidate(Datagram);
 
-    while (Datagram->SendQueue != NULL) {
-        QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueue;
+    for (;;) {
+        if (Datagram->FecRepairPending &&
+            Builder->Metadata->Flags.KeyType == QUIC_PACKET_KEY_1_RTT) {
+            if (!QuicDatagramFecWriteRepairFrame(Datagram, Builder)) {
+                Result = TRUE;
+                goto Exit;
+            }
+            if (++Builder->Metadata->FrameCount == QUIC_MAX_FRAMES_PER_PACKET) {
+                Result = TRUE;
+                goto Exit;
+            }
+        }
+
+        const uint8_t SendableClasses =
+            Datagram->QueuedClasses & ~Datagram->ThrottledClasses;
+        if (SendableClasses == 0) {
+            break;
+        }
+
+        const uint8_t Class = QuicDatagramHighestClass(SendableClasses);
+        QUIC_SEND_REQUEST* SendRequest = Datagram->SendQueues[Class];
+
+        if (SendRequest->DeadlineUs != 0) {
+            if (TimeNow == 0) {
+                TimeNow = CxPlatTimeUs64();
+            }
+            if (TimeNow >= SendRequest->DeadlineUs) {
+                //
+                // Sending the datagram late is worse than not sending it.
+                //
+                QuicDatagramRemoveHead(Datagram, Class);
+                QuicDatagramCancelSend(Connection, SendRequest);
+                continue;
+            }
+        }
+
+        if (Datagram->ClassRates[Class] != 0 &&
+            Datagram->ClassTokens[Class] < SendRequest->TotalLength) {
+            //
+            // The class is over its rate. Let lower classes use the room until
+            // its tokens are refilled.
+            //
+            Datagram->ThrottledClasses |= (1 << Class);
+            continue;
+        }
 
         if (Builder->Metadata->Flags.KeyType == QUIC_PACKET_KEY_0_RTT &&
             !(SendRequest->Flags & QUIC_SEND_FLAG_ALLOW_0_RTT)) {
@@ -454,14 +824,30 @@ QuicDatagramWriteFrame(
         uint16_t AvailableBufferLength =
             (uint16_t)Builder->Datagram->Length - Builder->EncryptionOverhead;
 
-        BOOLEAN HadRoomForDatagram =
-            QuicDatagramFrameEncodeEx(
-                SendRequest->Buffers,
-                SendRequest->BufferCount,
-                SendRequest->TotalLength,
-                &Builder->DatagramLength,
-                AvailableBufferLength,
-                Builder->Datagram->Buffer);
+        const BOOLEAN FecProtected =
+            QuicDatagramFecShouldProtect(Datagram, Builder, SendRequest);
+
+        BOOLEAN HadRoomForDatagram;
+        if (FecProtected) {
+            HadRoomForDatagram =
+                QuicFecSourceFrameEncodeEx(
+                    Datagram->FecNextSymbolId,
+                    SendRequest->Buffers,
+                    SendRequest->BufferCount,
+                    SendRequest->TotalLength,
+                    &Builder->DatagramLength,
+                    AvailableBufferLength,
+                    Builder->Datagram->Buffer);
+        } else {
+            HadRoomForDatagram =
+                QuicDatagramFrameEncodeEx(
+                    SendRequest->Buffers,
+                    SendRequest->BufferCount,
+                    SendRequest->TotalLength,
+                    &Builder->DatagramLength,
+                    AvailableBufferLength,
+                    Builder->Datagram->Buffer);
+        }
         if (!HadRoomForDatagram) {
             //
             // We didn't have room to frame this datagram. This should only
@@ -477,16 +863,18 @@ QuicDatagramWriteFrame(
             goto Exit;
         }
 
-        if (Datagram->PrioritySendQueueTail == &SendRequest->Next) {
-            Datagram->PrioritySendQueueTail = &Datagram->SendQueue;
+        QuicDatagramRemoveHead(Datagram, Class);
+        if (Datagram->ClassRates[Class] != 0) {
+            Datagram->ClassTokens[Class] -= (uint32_t)SendRequest->TotalLength;
         }
-        if (Datagram->SendQueueTail == &SendRequest->Next) {
-            Datagram->SendQueueTail = &Datagram->SendQueue;
+
+        if (FecProtected) {
+            QuicDatagramFecAddSourceSymbol(Datagram, SendRequest);
         }
-        Datagram->SendQueue = SendRequest->Next;
 
         Builder->Metadata->Flags.IsAckEliciting = TRUE;
-        Builder->Metadata->Frames[Builder->Metadata->FrameCount].Type = QUIC_FRAME_DATAGRAM;
+        Builder->Metadata->Frames[Builder->Metadata->FrameCount].Type =
+            FecProtected ? QUIC_FRAME_FEC_SOURCE : QUIC_FRAME_DATAGRAM;
         Builder->Metadata->Frames[Builder->Metadata->FrameCount].DATAGRAM.ClientContext = SendRequest->ClientContext;
         QuicDatagramCompleteSend(
             Connection,
@@ -499,7 +887,7 @@ QuicDatagramWriteFrame(
     }
 
 Exit:
-    if (Datagram->SendQueue == NULL) {
+    if (!QuicDatagramHasSendWork(Datagram)) {
         Connection->Send.SendFlags &= ~QUIC_CONN_SEND_FLAG_DATAGRAM;
     }
 
@@ -508,6 +896,251 @@ Exit:
     return Result;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramIndicateReceive(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_reads_bytes_(Length)
+        const uint8_t* Data,
+    _In_ uint16_t Length,
+    _In_ QUIC_RECEIVE_FLAGS Flags
+    )
+{
+    QUIC_DATAGRAM* Datagram = &Connection->Datagram;
+    if (Datagram->RecvBatchEnabled) {
+        if (Datagram->RecvBatchCount != 0 && Datagram->RecvBatchFlags != Flags) {
+            QuicDatagramFlushRecvBatch(Datagram);
+        }
+        Datagram->RecvBatch[Datagram->RecvBatchCount].Length = Length;
+        Datagram->RecvBatch[Datagram->RecvBatchCount].Buffer = (uint8_t*)Data;
+        Datagram->RecvBatchFlags = Flags;
+        if (++Datagram->RecvBatchCount == QUIC_MAX_DATAGRAM_RECV_BATCH_COUNT) {
+            QuicDatagramFlushRecvBatch(Datagram);
+        }
+        return;
+    }
+
+    const QUIC_BUFFER QuicBuffer = { Length, (uint8_t*)Data };
+
+    QUIC_CONNECTION_EVENT Event;
+    Event.Type = QUIC_CONNECTION_EVENT_DATAGRAM_RECEIVED;
+    Event.DATAGRAM_RECEIVED.Buffer = &QuicBuffer;
+    Event.DATAGRAM_RECEIVED.Flags = Flags;
+
+    (void)QuicConnIndicateEvent(Connection, &Event);
+
+    QuicPerfCounterAdd(
+        Connection->Partition,
+        QUIC_PERF_COUNTER_APP_RECV_BYTES,
+        QuicBuffer.Length);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramFlushRecvBatch(
+    _In_ QUIC_DATAGRAM* Datagram
+    )
+{
+    if (Datagram->RecvBatchCount == 0) {
+        return;
+    }
+
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+    int64_t TotalLength = 0;
+    for (uint8_t i = 0; i < Datagram->RecvBatchCount; ++i) {
+        TotalLength += Datagram->RecvBatch[i].Length;
+    }
+
+    QUIC_CONNECTION_EVENT Event;
+    Event.Type = QUIC_CONNECTION_EVENT_DATAGRAMS_RECEIVED;
+    Event.DATAGRAMS_RECEIVED.Buffers = Datagram->RecvBatch;
+    Event.DATAGRAMS_RECEIVED.BufferCount = Datagram->RecvBatchCount;
+    Event.DATAGRAMS_RECEIVED.Flags = Datagram->RecvBatchFlags;
+    Datagram->RecvBatchCount = 0;
+
+    (void)QuicConnIndicateEvent(Connection, &Event);
+
+    QuicPerfCounterAdd(
+        Connection->Partition,
+        QUIC_PERF_COUNTER_APP_RECV_BYTES,
+        TotalLength);
+}
+
+//
+// Returns the receive state for the given block of the peer's FEC protected
+// datagrams, recycling the slot of an older block if necessary. Returns NULL
+// if the block is too old to be tracked any more, or if the symbol buffers
+// couldn't be allocated.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_FEC_RECV_BLOCK*
+QuicDatagramFecGetRecvBlock(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t BlockIndex
+    )
+{
+    if (Datagram->FecRecvBlocks[0].Symbol == NULL) {
+        uint8_t* Symbols =
+            CXPLAT_ALLOC_NONPAGED(
+                QUIC_FEC_RECV_BLOCK_COUNT * QUIC_FEC_MAX_SYMBOL_LENGTH,
+                QUIC_POOL_FEC);
+        if (Symbols == NULL) {
+            return NULL;
+        }
+        for (uint32_t i = 0; i < QUIC_FEC_RECV_BLOCK_COUNT; ++i) {
+            Datagram->FecRecvBlocks[i].Symbol = Symbols + i * QUIC_FEC_MAX_SYMBOL_LENGTH;
+        }
+    }
+
+    QUIC_FEC_RECV_BLOCK* Block =
+        &Datagram->FecRecvBlocks[BlockIndex % QUIC_FEC_RECV_BLOCK_COUNT];
+    if (Block->InUse) {
+        if (Block->BlockIndex == BlockIndex) {
+            return Block;
+        }
+        if (Block->BlockIndex > BlockIndex) {
+            return NULL;
+        }
+    }
+
+    Block->BlockIndex = BlockIndex;
+    Block->ReceivedMask = 0;
+    Block->LengthXor = 0;
+    Block->InUse = TRUE;
+    Block->HasRepair = FALSE;
+    CxPlatZeroMemory(Block->Symbol, QUIC_FEC_MAX_SYMBOL_LENGTH);
+
+    return Block;
+}
+
+//
+// Rebuilds and indicates the block's missing datagram once the repair symbol
+// and all but one of the source symbols have arrived.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramFecTryRecover(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _Inout_ QUIC_FEC_RECV_BLOCK* Block
+    )
+{
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+    const uint32_t BlockSize = (uint32_t)Connection->PeerTransportParams.FecBlockSize;
+    const uint32_t FullMask =
+        BlockSize == 32 ? UINT32_MAX : ((1u << BlockSize) - 1);
+    const uint32_t MissingMask = ~Block->ReceivedMask & FullMask;
+
+    if (!Block->HasRepair ||
+        MissingMask == 0 ||
+        (MissingMask & (MissingMask - 1)) != 0) {
+        return; // Nothing missing, or more than a single repair can rebuild.
+    }
+
+    Block->ReceivedMask |= MissingMask;
+    if (Block->LengthXor > QUIC_FEC_MAX_SYMBOL_LENGTH) {
+        return; // Inconsistent block; give up on it.
+    }
+
+    Connection->Stats.Recv.FecRecoveredDatagrams++;
+    QuicDatagramIndicateReceive(
+        Connection,
+        Block->Symbol,
+        Block->LengthXor,
+        QUIC_RECEIVE_FLAG_NONE);
+
+    //
+    // The rebuilt datagram lives in the block's symbol buffer, which later
+    // frames may recycle, so it can't wait for the end of the receive flush.
+    //
+    QuicDatagramFlushRecvBatch(Datagram);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicDatagramFecProcessSourceFrame(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ const QUIC_RX_PACKET* const Packet,
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_ uint16_t* Offset
+    )
+{
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+
+    QUIC_FEC_SOURCE_EX Frame;
+    if (!QuicFecSourceFrameDecode(BufferLength, Buffer, Offset, &Frame)) {
+        return FALSE;
+    }
+
+    const uint64_t BlockSize = Connection->PeerTransportParams.FecBlockSize;
+    const uint32_t SymbolBit = 1u << (uint32_t)(Frame.SymbolId % BlockSize);
+    QUIC_FEC_RECV_BLOCK* Block = NULL;
+    if (Frame.Length <= QUIC_FEC_MAX_SYMBOL_LENGTH) {
+        Block = QuicDatagramFecGetRecvBlock(Datagram, Frame.SymbolId / BlockSize);
+        if (Block != NULL && (Block->ReceivedMask & SymbolBit)) {
+            return TRUE; // Already rebuilt from the repair symbol.
+        }
+    }
+
+    QuicDatagramIndicateReceive(
+        Connection,
+        Frame.Data,
+        (uint16_t)Frame.Length,
+        Packet->EncryptedWith0Rtt ? QUIC_RECEIVE_FLAG_0_RTT : QUIC_RECEIVE_FLAG_NONE);
+
+    if (Block != NULL) {
+        for (uint16_t i = 0; i < (uint16_t)Frame.Length; ++i) {
+            Block->Symbol[i] ^= Frame.Data[i];
+        }
+        Block->LengthXor ^= (uint16_t)Frame.Length;
+        Block->ReceivedMask |= SymbolBit;
+        QuicDatagramFecTryRecover(Datagram, Block);
+    }
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicDatagramFecProcessRepairFrame(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_ uint16_t* Offset
+    )
+{
+    QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
+
+    QUIC_FEC_REPAIR_EX Frame;
+    if (!QuicFecRepairFrameDecode(BufferLength, Buffer, Offset, &Frame)) {
+        return FALSE;
+    }
+
+    const uint64_t BlockSize = Connection->PeerTransportParams.FecBlockSize;
+    if (Frame.Length > QUIC_FEC_MAX_SYMBOL_LENGTH ||
+        Frame.LengthXor > UINT16_MAX ||
+        Frame.BlockStart % BlockSize != 0) {
+        return FALSE;
+    }
+
+    QUIC_FEC_RECV_BLOCK* Block =
+        QuicDatagramFecGetRecvBlock(Datagram, Frame.BlockStart / BlockSize);
+    if (Block == NULL || Block->HasRepair) {
+        return TRUE;
+    }
+
+    for (uint16_t i = 0; i < (uint16_t)Frame.Length; ++i) {
+        Block->Symbol[i] ^= Frame.Data[i];
+    }
+    Block->LengthXor ^= (uint16_t)Frame.LengthXor;
+    Block->HasRepair = TRUE;
+    QuicDatagramFecTryRecover(Datagram, Block);
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicDatagramProcessFrame(
@@ -523,6 +1156,13 @@ QuicDatagramProcessFrame(
     QUIC_CONNECTION* Connection = QuicDatagramGetConnection(Datagram);
     CXPLAT_DBG_ASSERT(Connection->Settings.DatagramReceiveEnabled);
 
+    if (FrameType == QUIC_FRAME_FEC_SOURCE) {
+        return QuicDatagramFecProcessSourceFrame(Datagram, Packet, BufferLength, Buffer, Offset);
+    }
+    if (FrameType == QUIC_FRAME_FEC_REPAIR) {
+        return QuicDatagramFecProcessRepairFrame(Datagram, BufferLength, Buffer, Offset);
+    }
+
     QUIC_DATAGRAM_EX Frame;
     if (!QuicDatagramFrameDecode(FrameType, BufferLength, Buffer, Offset, &Frame)) {
         return FALSE;
@@ -530,23 +1170,11 @@ QuicDatagramProcessFrame(
 
     // TODO - If we ever limit max receive length, validate it here.
 
-    const QUIC_BUFFER QuicBuffer = { (uint16_t)Frame.Length, (uint8_t*)Frame.Data };
-
-    QUIC_CONNECTION_EVENT Event;
-    Event.Type = QUIC_CONNECTION_EVENT_DATAGRAM_RECEIVED;
-    Event.DATAGRAM_RECEIVED.Buffer = &QuicBuffer;
-    if (Packet->EncryptedWith0Rtt) {
-        Event.DATAGRAM_RECEIVED.Flags = QUIC_RECEIVE_FLAG_0_RTT;
-    } else {
-        Event.DATAGRAM_RECEIVED.Flags = 0;
-    }
-
-    (void)QuicConnIndicateEvent(Connection, &Event);
-
-    QuicPerfCounterAdd(
-        Connection->Partition,
-        QUIC_PERF_COUNTER_APP_RECV_BYTES,
-        QuicBuffer.Length);
+    QuicDatagramIndicateReceive(
+        Connection,
+        Frame.Data,
+        (uint16_t)Frame.Length,
+        Packet->EncryptedWith0Rtt ? QUIC_RECEIVE_FLAG_0_RTT : QUIC_RECEIVE_FLAG_NONE);
 
     return TRUE;
 }
@@ -558,32 +1186,10 @@ QuicDatagramCancelBlocked(
     )
 {
     QUIC_DATAGRAM* Datagram = &Connection->Datagram;
-    QUIC_SEND_REQUEST** SendQueue = &Datagram->SendQueue;
 
-    if (*SendQueue == NULL) {
+    if (Datagram->QueuedClasses == 0) {
         return;
     }
 
-    do {
-        if ((*SendQueue)->Flags & QUIC_SEND_FLAG_CANCEL_ON_BLOCKED) {
-            QUIC_SEND_REQUEST* SendRequest = *SendQueue;
-            if (Datagram->PrioritySendQueueTail == &SendRequest->Next) {
-                Datagram->PrioritySendQueueTail = SendQueue;
-            }
-            *SendQueue = SendRequest->Next;
-            QuicDatagramCancelSend(Connection, SendRequest);
-        } else {
-            SendQueue = &((*SendQueue)->Next);
-        }
-    } while (*SendQueue != NULL);
-
-    Datagram->SendQueueTail = SendQueue;
-
-    if (Datagram->SendQueue != NULL) {
-        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
-    } else {
-        QuicSendClearSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_DATAGRAM);
-    }
-
-    QuicDatagramValidate(Datagram);
+    QuicDatagramCancelQueued(Datagram, TRUE);
 }
@@ -5,14 +5,59 @@
 
 --*/
 
+//
+// Receive state for one block of FEC protected datagrams from the peer.
+//
+typedef struct QUIC_FEC_RECV_BLOCK {
+
+    //
+    // The block's first symbol ID divided by the peer's block size.
+    //
+    uint64_t BlockIndex;
+
+    //
+    // Bit mask of the source symbols received (or recovered) in the block.
+    //
+    uint32_t ReceivedMask;
+
+    //
+    // XOR of the lengths of everything folded into Symbol.
+    //
+    uint16_t LengthXor;
+
+    BOOLEAN InUse : 1;
+    BOOLEAN HasRepair : 1;
+
+    //
+    // XOR of the zero padded source symbols and repair symbol received so
+    // far. QUIC_FEC_MAX_SYMBOL_LENGTH bytes.
+    //
+    uint8_t* Symbol;
+
+} QUIC_FEC_RECV_BLOCK;
+
 typedef struct QUIC_DATAGRAM {
 
     //
-    // Datagram send queue.
+    // Datagram send queues, one per priority class.
+    //
+    QUIC_SEND_REQUEST* SendQueues[QUIC_DATAGRAM_PRIORITY_CLASS_COUNT];
+    QUIC_SEND_REQUEST** SendQueueTails[QUIC_DATAGRAM_PRIORITY_CLASS_COUNT];
+
+    //
+    // Bit masks of the classes that have datagrams queued, and of the rate
+    // limited classes that are waiting for more send tokens.
+    //
+    uint8_t QueuedClasses;
+    uint8_t ThrottledClasses;
+
+    //
+    // Per class rate limits in bytes per second (zero for no limit) and the
+    // token buckets that enforce them.
     //
-    QUIC_SEND_REQUEST* SendQueue;
-    QUIC_SEND_REQUEST** PrioritySendQueueTail;
-    QUIC_SEND_REQUEST** SendQueueTail;
+    uint32_t ClassRates[QUIC_DATAGRAM_PRIORITY_CLASS_COUNT];
+    uint32_t ClassTokens[QUIC_DATAGRAM_PRIORITY_CLASS_COUNT];
+    uint64_t ClassRefillTime;
 
     //
     // API calls to DatagramSend queue the send request here and then queue the
@@ -20,6 +65,7 @@ typedef struct QUIC_DATAGRAM {
     // send queue.
     //
     QUIC_SEND_REQUEST* ApiQueue;
+    QUIC_SEND_REQUEST** ApiQueueTail;
     CXPLAT_DISPATCH_LOCK ApiQueueLock;
 
     //
@@ -38,6 +84,57 @@ typedef struct QUIC_DATAGRAM {
     //
     BOOLEAN SendEnabled : 1;
 
+    //
+    // Indicates that the peer accepts FEC protected datagrams.
+    //
+    BOOLEAN FecSendEnabled : 1;
+
+    //
+    // Indicates the current send block is complete and its repair frame still
+    // needs to be sent.
+    //
+    BOOLEAN FecRepairPending : 1;
+
+    //
+    // The number of source datagrams in the current send block, the largest of
+    // them, and the XOR of their lengths.
+    //
+    uint8_t FecSendBlockCount;
+    uint16_t FecSendRepairLength;
+    uint16_t FecSendLengthXor;
+
+    //
+    // The symbol ID of the next FEC protected datagram sent.
+    //
+    uint64_t FecNextSymbolId;
+
+    //
+    // The running XOR of the current send block's datagrams.
+    // QUIC_FEC_MAX_SYMBOL_LENGTH bytes, allocated on first use.
+    //
+    uint8_t* FecSendRepair;
+
+    //
+    // Recently received blocks of FEC protected datagrams. The symbol buffers
+    // are allocated on first use.
+    //
+    QUIC_FEC_RECV_BLOCK FecRecvBlocks[QUIC_FEC_RECV_BLOCK_COUNT];
+
+    //
+    // Indicates the app opted in to receiving datagrams in batches, via
+    // QUIC_CONNECTION_EVENT_DATAGRAMS_RECEIVED.
+    //
+    BOOLEAN RecvBatchEnabled : 1;
+
+    //
+    // Received datagrams not yet indicated, all with the same flags. The
+    // buffers point into the receive packets, so the batch is indicated
+    // before those are returned at the end of the receive flush.
+    //
+    uint8_t RecvBatchCount;
+    QUIC_RECEIVE_FLAGS RecvBatchFlags;
+    QUIC_BUFFER RecvBatch[QUIC_MAX_DATAGRAM_RECV_BATCH_COUNT];
+
 } QUIC_DATAGRAM;
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -64,6 +161,10 @@ QuicDatagramOnSendStateChanged(
     _In_ QUIC_DATAGRAM* Datagram
     );
 
+//
+// Queues a chain of one or more send requests, linked through Next. On
+// failure, every request in the chain is freed.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicDatagramQueueSend(
@@ -77,6 +178,36 @@ QuicDatagramSendFlush(
     _In_ QUIC_DATAGRAM* Datagram
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramSetClassRates(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_reads_(QUIC_DATAGRAM_PRIORITY_CLASS_COUNT)
+        const uint32_t* Rates
+    );
+
+//
+// Refills the rate limited classes' send tokens, at the start of a send flush,
+// and queues the datagram send flag for any class that can send again.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramRefillClassTokens(
+    _In_ QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t TimeNow
+    );
+
+//
+// Returns when the first throttled class will have enough tokens to send its
+// next datagram.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+uint64_t
+QuicDatagramGetThrottledReadyTime(
+    _In_ const QUIC_DATAGRAM* Datagram,
+    _In_ uint64_t TimeNow
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicDatagramWriteFrame(
@@ -104,6 +235,16 @@ QuicDatagramProcessFrame(
     _Inout_ uint16_t* Offset
     );
 
+//
+// Indicates any received datagrams batched up during the current receive
+// flush.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicDatagramFlushRecvBatch(
+    _In_ QUIC_DATAGRAM* Datagram
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicDatagramCancelBlocked(
@@ -86,14 +86,15 @@ QuicAckHeaderDecode(
     _Out_ QUIC_ACK_EX* Frame
     )
 {
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->LargestAcknowledged) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->AckDelay) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->AdditionalAckBlockCount) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->FirstAckBlock) ||
-        Frame->FirstAckBlock > Frame->LargestAcknowledged) {
+    QUIC_VAR_INT Values[4];
+    if (!QuicVarIntDecodeArray(BufferLength, Buffer, Offset, ARRAYSIZE(Values), Values)) {
         return FALSE;
     }
-    return TRUE;
+    Frame->LargestAcknowledged = Values[0];
+    Frame->AckDelay = Values[1];
+    Frame->AdditionalAckBlockCount = Values[2];
+    Frame->FirstAckBlock = Values[3];
+    return Frame->FirstAckBlock <= Frame->LargestAcknowledged;
 }
 
 _Success_(return != FALSE)
@@ -131,10 +132,12 @@ QuicAckBlockDecode(
     _Out_ QUIC_ACK_BLOCK_EX* Block
     )
 {
-    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Block->Gap) ||
-        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Block->AckBlock)) {
+    QUIC_VAR_INT Values[2];
+    if (!QuicVarIntDecodeArray(BufferLength, Buffer, Offset, ARRAYSIZE(Values), Values)) {
         return FALSE;
     }
+    Block->Gap = Values[0];
+    Block->AckBlock = Values[1];
     return TRUE;
 }
 
@@ -183,6 +186,48 @@ QuicAckEcnDecode(
     return TRUE;
 }
 
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckBlocksEncode(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_ uint32_t HighIndex,
+    _In_ uint32_t LowIndex,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
+    )
+{
+    CXPLAT_DBG_ASSERT(HighIndex < QuicRangeSize(AckBlocks));
+    CXPLAT_DBG_ASSERT(LowIndex <= HighIndex);
+
+    uint32_t i = HighIndex;
+    uint64_t Largest = QuicRangeGet(AckBlocks, i)->Low - 1;
+
+    while (i != LowIndex) {
+
+        QUIC_SUBRANGE* Next = QuicRangeGet(AckBlocks, i - 1);
+        uint64_t NextLargest = QuicRangeGetHigh(Next);
+        uint64_t Count = Next->Count;
+
+        CXPLAT_DBG_ASSERT(Largest > NextLargest);
+        CXPLAT_DBG_ASSERT(Count > 0);
+
+        QUIC_ACK_BLOCK_EX Block = {
+            (Largest - NextLargest) - 1,    // Gap
+            Count - 1                       // AckBlock
+        };
+
+        if (!QuicAckBlockEncode(&Block, Offset, BufferLength, Buffer)) {
+            return FALSE;
+        }
+
+        Largest = Next->Low - 1;
+        i--;
+    }
+
+    return TRUE;
+}
+
 _Success_(return != FALSE)
 BOOLEAN
 QuicAckFrameEncode(
@@ -217,31 +262,53 @@ QuicAckFrameEncode(
     //
     // Write any additional ACK Blocks
     //
-    while (i != 0) {
+    if (!QuicAckBlocksEncode(AckBlocks, i, 0, Offset, BufferLength, Buffer)) {
+        CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
+        return FALSE;
+    }
 
-        CXPLAT_DBG_ASSERT(Largest >= Count);
-        Largest -= Count;
+    if (Ecn != NULL) {
+        if (!QuicAckEcnEncode(Ecn, Offset, BufferLength, Buffer)) {
+            return FALSE;
+        }
+    }
 
-        QUIC_SUBRANGE* Next = QuicRangeGet(AckBlocks, i - 1);
-        uint64_t NextLargest = QuicRangeGetHigh(Next);
-        Count = Next->Count;
+    return TRUE;
+}
 
-        CXPLAT_DBG_ASSERT(Largest > NextLargest);
-        CXPLAT_DBG_ASSERT(Count > 0);
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckFrameEncodeWithBlocks(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_ uint64_t AckDelay,
+    _In_opt_ QUIC_ACK_ECN_EX* Ecn,
+    _In_ uint16_t BlocksLength,
+    _In_reads_bytes_(BlocksLength)
+        const uint8_t* Blocks,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset) uint8_t* Buffer
+    )
+{
+    uint32_t i = QuicRangeSize(AckBlocks) - 1;
+    QUIC_SUBRANGE* LastSub = QuicRangeGet(AckBlocks, i);
 
-        QUIC_ACK_BLOCK_EX Block = {
-            (Largest - NextLargest) - 1,    // Gap
-            Count - 1                       // AckBlock
-        };
+    QUIC_ACK_EX Frame = {
+        QuicRangeGetHigh(LastSub),  // LargestAcknowledged
+        AckDelay,                   // AckDelay
+        i,                          // AdditionalAckBlockCount
+        LastSub->Count - 1          // FirstAckBlock
+    };
 
-        if (!QuicAckBlockEncode(&Block, Offset, BufferLength, Buffer)) {
-            CXPLAT_TEL_ASSERT(FALSE); // TODO - Support partial ACK array encoding by updating the 'AdditionalAckBlockCount' field.
-            return FALSE;
-        }
+    if (!QuicAckHeaderEncode(&Frame, Ecn, Offset, BufferLength, Buffer)) {
+        return FALSE;
+    }
 
-        Largest = NextLargest;
-        i--;
+    if (BufferLength < *Offset + BlocksLength) {
+        return FALSE;
     }
+    CxPlatCopyMemory(Buffer + *Offset, Blocks, BlocksLength);
+    *Offset += BlocksLength;
 
     if (Ecn != NULL) {
         if (!QuicAckEcnEncode(Ecn, Offset, BufferLength, Buffer)) {
@@ -1323,3 +1390,118 @@ QuicTimestampFrameDecode(
 
     return TRUE;
 }
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecSourceFrameEncodeEx(
+    _In_ QUIC_VAR_INT SymbolId,
+    _In_reads_(BufferCount)
+        const QUIC_BUFFER* const Buffers,
+    _In_ uint32_t BufferCount,
+    _In_ uint64_t TotalLength,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    )
+{
+    uint16_t RequiredLength =
+        QuicVarIntSize(QUIC_FRAME_FEC_SOURCE) +
+        QuicVarIntSize(SymbolId) +
+        QuicVarIntSize(TotalLength) +
+        (uint16_t)TotalLength;
+
+    if (BufferLength < *Offset + RequiredLength) {
+        return FALSE;
+    }
+
+    Buffer = Buffer + *Offset;
+    Buffer = QuicVarIntEncode(QUIC_FRAME_FEC_SOURCE, Buffer);
+    Buffer = QuicVarIntEncode(SymbolId, Buffer);
+    Buffer = QuicVarIntEncode(TotalLength, Buffer);
+    for (uint32_t i = 0; i < BufferCount; ++i) {
+        if (Buffers[i].Length != 0) {
+            CxPlatCopyMemory(Buffer, Buffers[i].Buffer, Buffers[i].Length);
+            Buffer += Buffers[i].Length;
+        }
+    }
+
+    *Offset += RequiredLength;
+
+    return TRUE;
+}
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecSourceFrameDecode(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Deref_in_range_(0, BufferLength)
+    _Inout_ uint16_t* Offset,
+    _Out_ QUIC_FEC_SOURCE_EX* Frame
+    )
+{
+    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->SymbolId) ||
+        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->Length) ||
+        BufferLength < Frame->Length + *Offset) {
+        return FALSE;
+    }
+    Frame->Data = Buffer + *Offset;
+    *Offset += (uint16_t)Frame->Length;
+    return TRUE;
+}
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecRepairFrameEncode(
+    _In_ const QUIC_FEC_REPAIR_EX * const Frame,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    )
+{
+    uint16_t RequiredLength =
+        QuicVarIntSize(QUIC_FRAME_FEC_REPAIR) +
+        QuicVarIntSize(Frame->BlockStart) +
+        QuicVarIntSize(Frame->LengthXor) +
+        QuicVarIntSize(Frame->Length) +
+        (uint16_t)Frame->Length;
+
+    if (BufferLength < *Offset + RequiredLength) {
+        return FALSE;
+    }
+
+    Buffer = Buffer + *Offset;
+    Buffer = QuicVarIntEncode(QUIC_FRAME_FEC_REPAIR, Buffer);
+    Buffer = QuicVarIntEncode(Frame->BlockStart, Buffer);
+    Buffer = QuicVarIntEncode(Frame->LengthXor, Buffer);
+    Buffer = QuicVarIntEncode(Frame->Length, Buffer);
+    CxPlatCopyMemory(Buffer, Frame->Data, (size_t)Frame->Length);
+    *Offset += RequiredLength;
+
+    return TRUE;
+}
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecRepairFrameDecode(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Deref_in_range_(0, BufferLength)
+    _Inout_ uint16_t* Offset,
+    _Out_ QUIC_FEC_REPAIR_EX* Frame
+    )
+{
+    if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->BlockStart) ||
+        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->LengthXor) ||
+        !QuicVarIntDecode(BufferLength, Buffer, Offset, &Frame->Length) ||
+        BufferLength < Frame->Length + *Offset) {
+        return FALSE;
+    }
+    Frame->Data = Buffer + *Offset;
+    *Offset += (uint16_t)Frame->Length;
+    return TRUE;
+}
@@ -159,6 +159,9 @@ typedef enum QUIC_FRAME_TYPE {
     QUIC_FRAME_IMMEDIATE_ACK        = 0x1fULL,
     /* 0xaf to 0x2f4 are unused currently */
     QUIC_FRAME_TIMESTAMP            = 0x2f5ULL,
+    /* 0x2f6 to 0x3feb are unused currently */
+    QUIC_FRAME_FEC_SOURCE           = 0x3fecULL,
+    QUIC_FRAME_FEC_REPAIR           = 0x3fedULL,
 
     QUIC_FRAME_MAX_SUPPORTED
 
@@ -177,7 +180,8 @@ CXPLAT_STATIC_ASSERT(
      (X >= QUIC_FRAME_DATAGRAM && X <= QUIC_FRAME_DATAGRAM_1) || \
       X == QUIC_FRAME_ACK_FREQUENCY || X == QUIC_FRAME_IMMEDIATE_ACK || \
       X == QUIC_FRAME_RELIABLE_RESET_STREAM || \
-      X == QUIC_FRAME_TIMESTAMP \
+      X == QUIC_FRAME_TIMESTAMP || \
+      X == QUIC_FRAME_FEC_SOURCE || X == QUIC_FRAME_FEC_REPAIR \
     )
 
 //
@@ -220,6 +224,42 @@ QuicAckFrameEncode(
         uint8_t* Buffer
     );
 
+//
+// Encodes the additional ACK blocks for the ranges in [LowIndex, HighIndex),
+// each relative to the range above it. With HighIndex as the largest range and
+// LowIndex of zero, this is everything that follows the ACK frame header.
+//
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckBlocksEncode(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_ uint32_t HighIndex,
+    _In_ uint32_t LowIndex,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
+//
+// Encodes an ACK frame, like QuicAckFrameEncode, with the additional ACK blocks
+// already encoded by QuicAckBlocksEncode.
+//
+_Success_(return != FALSE)
+BOOLEAN
+QuicAckFrameEncodeWithBlocks(
+    _In_ const QUIC_RANGE * const AckBlocks,
+    _In_ uint64_t AckDelay,
+    _In_opt_ QUIC_ACK_ECN_EX* Ecn,
+    _In_ uint16_t BlocksLength,
+    _In_reads_bytes_(BlocksLength)
+        const uint8_t* Blocks,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
 _Success_(return != FALSE)
 BOOLEAN
 QuicAckFrameDecode(
@@ -903,6 +943,79 @@ QuicTimestampFrameDecode(
     _Out_ QUIC_TIMESTAMP_EX* Frame
     );
 
+//
+// QUIC_FRAME_FEC_SOURCE Encoding/Decoding
+//
+
+typedef struct QUIC_FEC_SOURCE_EX {
+
+    QUIC_VAR_INT SymbolId;
+    QUIC_VAR_INT Length;
+    _Field_size_bytes_(Length)
+    const uint8_t* Data;
+
+} QUIC_FEC_SOURCE_EX;
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecSourceFrameEncodeEx(
+    _In_ QUIC_VAR_INT SymbolId,
+    _In_reads_(BufferCount)
+        const QUIC_BUFFER* const Buffers,
+    _In_ uint32_t BufferCount,
+    _In_ uint64_t TotalLength,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecSourceFrameDecode(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Deref_in_range_(0, BufferLength)
+    _Inout_ uint16_t* Offset,
+    _Out_ QUIC_FEC_SOURCE_EX* Frame
+    );
+
+//
+// QUIC_FRAME_FEC_REPAIR Encoding/Decoding
+//
+
+typedef struct QUIC_FEC_REPAIR_EX {
+
+    QUIC_VAR_INT BlockStart;    // Symbol ID of the first source datagram covered
+    QUIC_VAR_INT LengthXor;     // XOR of the covered source datagram lengths
+    QUIC_VAR_INT Length;
+    _Field_size_bytes_(Length)
+    const uint8_t* Data;        // XOR of the zero padded source datagrams
+
+} QUIC_FEC_REPAIR_EX;
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecRepairFrameEncode(
+    _In_ const QUIC_FEC_REPAIR_EX * const Frame,
+    _Inout_ uint16_t* Offset,
+    _In_ uint16_t BufferLength,
+    _Out_writes_to_(BufferLength, *Offset)
+        uint8_t* Buffer
+    );
+
+_Success_(return != FALSE)
+BOOLEAN
+QuicFecRepairFrameDecode(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Deref_in_range_(0, BufferLength)
+    _Inout_ uint16_t* Offset,
+    _Out_ QUIC_FEC_REPAIR_EX* Frame
+    );
+
 //
 // Helper functions
 //
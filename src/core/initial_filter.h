@@ -0,0 +1,199 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    A cheap filter for client Initial packets, run on the receive path before
+    any connection (or stateless operation) state is allocated. It only reads
+    the raw UDP payload and a small table of per-source counters, so the same
+    logic can be moved into the XDP program (datapath_raw_xdp_linux_kern.c)
+    with the counters in a BPF map.
+
+    The filter looks at the first packet in the datagram. Anything other than
+    a client Initial packet of a known version is passed through untouched,
+    leaving the normal validation to deal with it. Initial packets in
+    datagrams that are too small are dropped. The remaining ones are counted,
+    per source address, over a fixed time window. Once a source goes over the
+    Retry threshold, Initial packets without a token are answered with a
+    Retry. Once it goes over the drop threshold, all its Initial packets are
+    dropped. The window and thresholds come from QUIC_INITIAL_FILTER_CONFIG.
+
+    Each counter holds the address it is counting for. A different source
+    landing on the same counter takes it over and starts counting from zero,
+    so sources never share (and are never penalized for) each other's counts.
+    The counter is picked with a keyed hash, so sources can't be chosen to
+    collide on purpose.
+
+--*/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+//
+// The long header packet type of Initial packets. Duplicated from packet.h so
+// this file only depends on plain definitions.
+//
+#define QUIC_INITIAL_FILTER_TYPE_V1             0   // QUIC_INITIAL_V1
+#define QUIC_INITIAL_FILTER_TYPE_V2             1   // QUIC_INITIAL_V2
+
+//
+// A source IP address, with IPv4 addresses in their IPv4-mapped IPv6 form.
+//
+typedef struct QUIC_INITIAL_FILTER_KEY {
+    uint8_t Address[16];
+} QUIC_INITIAL_FILTER_KEY;
+
+typedef struct QUIC_INITIAL_FILTER_BUCKET {
+
+    //
+    // The source the counter is currently counting for.
+    //
+    QUIC_INITIAL_FILTER_KEY Key;
+
+    //
+    // The time (in ms) the current window started.
+    //
+    uint32_t WindowStartMs;
+
+    //
+    // The number of Initial packets counted in the current window.
+    //
+    uint32_t Count;
+
+} QUIC_INITIAL_FILTER_BUCKET;
+
+typedef enum QUIC_INITIAL_FILTER_ACTION {
+
+    QUIC_INITIAL_FILTER_PASS,           // Continue normal processing
+    QUIC_INITIAL_FILTER_RETRY,          // Respond with a Retry
+    QUIC_INITIAL_FILTER_DROP,           // Drop the datagram
+    QUIC_INITIAL_FILTER_COUNT           // Count against the source (QuicInitialFilterCount)
+
+} QUIC_INITIAL_FILTER_ACTION;
+
+//
+// Classifies the (client to server) datagram from its first packet alone.
+// Returns QUIC_INITIAL_FILTER_COUNT for well formed client Initial packets,
+// which must then be counted against their source with QuicInitialFilterCount.
+//
+QUIC_INLINE
+QUIC_INITIAL_FILTER_ACTION
+QuicInitialFilterClassify(
+    _In_reads_(Length)
+        const uint8_t* const Buffer,
+    _In_ uint16_t Length,
+    _Out_ BOOLEAN* HasToken
+    )
+{
+    *HasToken = FALSE;
+
+    //
+    // Long header: form bit, type bits, version, then the DestCid length.
+    //
+    if (Length < 6 || !(Buffer[0] & 0x80)) {
+        return QUIC_INITIAL_FILTER_PASS;
+    }
+
+    uint32_t Version;
+    CxPlatCopyMemory(&Version, Buffer + 1, sizeof(Version));
+    const uint8_t Type = (Buffer[0] >> 4) & 0x3;
+    switch (Version) {
+    case QUIC_VERSION_1:
+    case QUIC_VERSION_DRAFT_29:
+    case QUIC_VERSION_MS_1:
+        if (Type != QUIC_INITIAL_FILTER_TYPE_V1) {
+            return QUIC_INITIAL_FILTER_PASS;
+        }
+        break;
+    case QUIC_VERSION_2:
+        if (Type != QUIC_INITIAL_FILTER_TYPE_V2) {
+            return QUIC_INITIAL_FILTER_PASS;
+        }
+        break;
+    default:
+        return QUIC_INITIAL_FILTER_PASS;
+    }
+
+    //
+    // Clients must always pad datagrams with Initial packets to at least the
+    // minimum length.
+    //
+    if (Length < QUIC_MIN_INITIAL_PACKET_LENGTH) {
+        return QUIC_INITIAL_FILTER_DROP;
+    }
+
+    //
+    // Skip the CIDs to get to the token length.
+    //
+    uint16_t Offset = 5;
+    const uint8_t DestCidLen = Buffer[Offset];
+    if (DestCidLen > QUIC_MAX_CONNECTION_ID_LENGTH_V1) {
+        return QUIC_INITIAL_FILTER_DROP;
+    }
+    Offset += 1 + DestCidLen;
+    const uint8_t SourceCidLen = Buffer[Offset];
+    if (SourceCidLen > QUIC_MAX_CONNECTION_ID_LENGTH_V1) {
+        return QUIC_INITIAL_FILTER_DROP;
+    }
+    Offset += 1 + SourceCidLen;
+
+    //
+    // Only whether the token length is zero matters, so just OR together all
+    // the bytes of the variable length integer (minus the length prefix).
+    //
+    const uint8_t TokenLengthBytes = (uint8_t)(1 << (Buffer[Offset] >> 6));
+    uint8_t TokenLengthBits = Buffer[Offset] & 0x3F;
+    for (uint8_t i = 1; i < TokenLengthBytes; ++i) {
+        TokenLengthBits |= Buffer[Offset + i];
+    }
+    *HasToken = TokenLengthBits != 0;
+
+    return QUIC_INITIAL_FILTER_COUNT;
+}
+
+//
+// Counts a client Initial packet against its source and decides what to do
+// with it. SourceHash is a keyed hash of SourceKey, used to pick the counter
+// in Buckets.
+//
+// N.B. The counters are updated without synchronization. Concurrent updates
+// may lose counts, which is acceptable for the purposes of this filter.
+//
+QUIC_INLINE
+QUIC_INITIAL_FILTER_ACTION
+QuicInitialFilterCount(
+    _In_ const QUIC_INITIAL_FILTER_CONFIG* Config,
+    _In_ const QUIC_INITIAL_FILTER_KEY* SourceKey,
+    _In_ uint32_t SourceHash,
+    _In_ BOOLEAN HasToken,
+    _In_ uint32_t TimeMs,
+    _In_ uint32_t BucketCount,
+    _Inout_updates_(BucketCount)
+        QUIC_INITIAL_FILTER_BUCKET* Buckets
+    )
+{
+    CXPLAT_DBG_ASSERT((BucketCount & (BucketCount - 1)) == 0);
+    QUIC_INITIAL_FILTER_BUCKET* Bucket = &Buckets[SourceHash & (BucketCount - 1)];
+    if (TimeMs - Bucket->WindowStartMs >= Config->WindowMs ||
+        memcmp(&Bucket->Key, SourceKey, sizeof(*SourceKey)) != 0) {
+        Bucket->Key = *SourceKey;
+        Bucket->WindowStartMs = TimeMs;
+        Bucket->Count = 0;
+    }
+    const uint32_t Count = ++Bucket->Count;
+
+    if (Count > Config->DropThreshold) {
+        return QUIC_INITIAL_FILTER_DROP;
+    }
+    if (Count > Config->RetryThreshold && !HasToken) {
+        return QUIC_INITIAL_FILTER_RETRY;
+    }
+    return QUIC_INITIAL_FILTER_PASS;
+}
+
+#if defined(__cplusplus)
+}
+#endif
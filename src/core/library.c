@@ -35,7 +35,7 @@ QuicLibraryGetDatapathFeatures(
     )
 {
     CXPLAT_SOCKET_FLAGS SocketFlags = CXPLAT_SOCKET_FLAG_NONE;
-    if (MsQuicLib.Settings.XdpEnabled) {
+    if (QuicLibraryGetSettings()->XdpEnabled) {
         SocketFlags |= CXPLAT_SOCKET_FLAG_XDP;
     }
     CXPLAT_DBG_ASSERT(MsQuicLib.Datapath != NULL);
@@ -58,6 +58,7 @@ MsQuicLibraryLoad(
         CxPlatSystemLoad();
         CxPlatLockInitialize(&MsQuicLib.Lock);
         CxPlatDispatchLockInitialize(&MsQuicLib.DatapathLock);
+        CxPlatDispatchLockInitialize(&MsQuicLib.ReadSectionSyncLock);
 #if DEBUG
         QuicLibraryInitializeDbg();
 #endif
@@ -89,6 +90,7 @@ MsQuicLibraryUnload(
 #if DEBUG
         QuicLibraryUninitializeDbg();
 #endif
+        CxPlatDispatchLockUninitialize(&MsQuicLib.ReadSectionSyncLock);
         CxPlatDispatchLockUninitialize(&MsQuicLib.DatapathLock);
         CxPlatLockUninitialize(&MsQuicLib.Lock);
         CxPlatSystemUnload();
@@ -123,6 +125,7 @@ MsQuicLibraryFreePartitions(
     )
 {
     if (MsQuicLib.Partitions) {
+        QuicLibraryReclaim(TRUE);
         for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
             QuicPartitionUninitialize(&MsQuicLib.Partitions[i]);
         }
@@ -131,6 +134,54 @@ MsQuicLibraryFreePartitions(
     }
 }
 
+#ifndef _KERNEL_MODE
+//
+// Defaults the execution config to the processors the OS restricts the process
+// to, such as by a container's cgroup cpuset and CPU quota, with the worker
+// threads pinned to them. Otherwise the worker pool is sized from all the
+// host's processors and gets throttled. An app provided config wins.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryApplyProcessorRestrictions(
+    void
+    )
+{
+    if (MsQuicLib.ExecutionConfig != NULL) {
+        return;
+    }
+
+    const uint32_t ListLength = CxPlatProcCount();
+    uint16_t* ProcessorList =
+        CXPLAT_ALLOC_NONPAGED(sizeof(uint16_t) * ListLength, QUIC_POOL_TMP_ALLOC);
+    if (ProcessorList == NULL) {
+        return;
+    }
+
+    const uint32_t ProcessorCount =
+        CxPlatProcGetRestrictedList(ListLength, ProcessorList);
+    if (ProcessorCount != 0) {
+        const uint32_t ConfigLength =
+            QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE +
+            sizeof(uint16_t) * ProcessorCount;
+        QUIC_GLOBAL_EXECUTION_CONFIG* Config =
+            CXPLAT_ALLOC_NONPAGED(ConfigLength, QUIC_POOL_EXECUTION_CONFIG);
+        if (Config != NULL) {
+            CxPlatZeroMemory(Config, ConfigLength);
+            Config->Flags = QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_AFFINITIZE;
+            Config->ProcessorCount = ProcessorCount;
+            CxPlatCopyMemory(
+                Config->ProcessorList,
+                ProcessorList,
+                sizeof(uint16_t) * ProcessorCount);
+            MsQuicLib.ExecutionConfig = Config;
+        }
+    }
+
+    CXPLAT_FREE(ProcessorList, QUIC_POOL_TMP_ALLOC);
+}
+#endif
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicLibraryInitializePartitions(
@@ -300,6 +351,46 @@ QuicLibrarySumPerfCountersExternal(
     CxPlatLockRelease(&MsQuicLib.Lock);
 }
 
+//
+// Computes the receive rate of each partition since the last sample and marks
+// those well above the average as overloaded.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryUpdatePartitionLoad(
+    _In_ uint64_t TimeDiffUs
+    )
+{
+    if (MsQuicLib.Partitions == NULL || TimeDiffUs == 0) {
+        return;
+    }
+
+    uint64_t TotalRate = 0;
+    uint16_t LeastLoaded = 0;
+    for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+        QUIC_PARTITION* Partition = &MsQuicLib.Partitions[i];
+        const int64_t RecvPackets = Partition->PerfCounters[QUIC_PERF_COUNTER_UDP_RECV];
+        const int64_t RecvDelta = RecvPackets - Partition->RecvPacketsSample;
+        Partition->RecvPacketsSample = RecvPackets;
+        Partition->RecvRate =
+            RecvDelta > 0 ? (uint64_t)RecvDelta * 1000 * 1000 / TimeDiffUs : 0;
+        TotalRate += Partition->RecvRate;
+        if (Partition->RecvRate < MsQuicLib.Partitions[LeastLoaded].RecvRate) {
+            LeastLoaded = i;
+        }
+    }
+
+    const uint64_t OverloadRate =
+        CXPLAT_MAX(
+            QUIC_PARTITION_OVERLOAD_FACTOR * TotalRate / MsQuicLib.PartitionCount,
+            QUIC_PARTITION_OVERLOAD_MIN_RATE);
+    for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+        MsQuicLib.Partitions[i].Overloaded =
+            MsQuicLib.Partitions[i].RecvRate > OverloadRate;
+    }
+    MsQuicLib.LeastLoadedPartition = LeastLoaded;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicPerfCounterSnapShot(
@@ -308,6 +399,8 @@ QuicPerfCounterSnapShot(
 {
     UNREFERENCED_PARAMETER(TimeDiffUs); // Only used in asserts below.
 
+    QuicLibraryEvaluateMemoryPressure();
+
     int64_t PerfCounterSamples[QUIC_PERF_COUNTER_MAX];
     QuicLibrarySumPerfCounters(
         (uint8_t*)PerfCounterSamples,
@@ -338,6 +431,8 @@ QuicPerfCounterSnapShot(
         MsQuicLib.PerfCounterSamples,
         PerfCounterSamples,
         sizeof(PerfCounterSamples));
+
+    QuicLibraryUpdatePartitionLoad(TimeDiffUs);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -431,9 +526,16 @@ MsQuicLibraryOnSettingsChanged(
     }
 
     MsQuicLib.HandshakeMemoryLimit =
-        (MsQuicLib.Settings.RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
+        (QuicLibraryGetSettings()->RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
     QuicLibraryEvaluateSendRetryState();
 
+    MsQuicLib.SendBufferMemoryLimit =
+        (QUIC_DEFAULT_SEND_BUFFER_MEMORY_FRACTION * CxPlatTotalMemory) / UINT16_MAX;
+
+    MsQuicLib.MemoryLimit =
+        (QUIC_DEFAULT_MEMORY_LIMIT_FRACTION * CxPlatTotalMemory) / UINT16_MAX;
+    QuicLibraryEvaluateMemoryPressure();
+
     if (UpdateRegistrations) {
         CxPlatLockAcquire(&MsQuicLib.Lock);
 
@@ -448,6 +550,104 @@ MsQuicLibraryOnSettingsChanged(
     }
 }
 
+//
+// Allocates a new settings snapshot holding a full copy of Source, or empty
+// settings if there is no Source yet.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_LIBRARY_SETTINGS*
+QuicLibrarySettingsClone(
+    _In_opt_ const QUIC_SETTINGS_INTERNAL* Source
+    )
+{
+    QUIC_LIBRARY_SETTINGS* Snapshot =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_LIBRARY_SETTINGS), QUIC_POOL_LIBRARY_SETTINGS);
+    if (Snapshot == NULL) {
+        return NULL;
+    }
+    CxPlatZeroMemory(Snapshot, sizeof(QUIC_LIBRARY_SETTINGS));
+
+    if (Source != NULL) {
+        //
+        // Copy takes every value, Apply then carries over the IsSet flags.
+        //
+        QuicSettingsCopy(&Snapshot->Settings, Source);
+        if (!QuicSettingApply(&Snapshot->Settings, TRUE, TRUE, Source)) {
+            QuicSettingsCleanup(&Snapshot->Settings);
+            CXPLAT_FREE(Snapshot, QUIC_POOL_LIBRARY_SETTINGS);
+            return NULL;
+        }
+    }
+
+    return Snapshot;
+}
+
+//
+// Makes the snapshot the current settings. Readers may still be using the
+// previous snapshot (workers also cache it), so it is kept until the library
+// is uninitialized; settings change rarely enough for that not to matter.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Requires_lock_held_(MsQuicLib.SettingsLock)
+static
+void
+QuicLibrarySettingsPublish(
+    _In_ QUIC_LIBRARY_SETTINGS* Snapshot
+    )
+{
+    CxPlatListInsertTail(&MsQuicLib.SettingsSnapshots, &Snapshot->Link);
+    QuicWritePtrRelease((void**)&MsQuicLib.Settings, &Snapshot->Settings);
+}
+
+//
+// Applies NewSettings on top of a copy of the current settings and publishes
+// the result. Either all of NewSettings takes effect or none of it does.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+QUIC_STATUS
+QuicLibrarySettingsUpdate(
+    _In_ const QUIC_SETTINGS_INTERNAL* NewSettings
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    CxPlatLockAcquire(&MsQuicLib.SettingsLock);
+    QUIC_LIBRARY_SETTINGS* Snapshot = QuicLibrarySettingsClone(MsQuicLib.Settings);
+    if (Snapshot == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+    } else if (!QuicSettingApply(&Snapshot->Settings, TRUE, TRUE, NewSettings)) {
+        QuicSettingsCleanup(&Snapshot->Settings);
+        CXPLAT_FREE(Snapshot, QUIC_POOL_LIBRARY_SETTINGS);
+        Status = QUIC_STATUS_INVALID_PARAMETER;
+    } else {
+        QuicLibrarySettingsPublish(Snapshot);
+    }
+    CxPlatLockRelease(&MsQuicLib.SettingsLock);
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLibraryFreeSettings(
+    void
+    )
+{
+    while (!CxPlatListIsEmpty(&MsQuicLib.SettingsSnapshots)) {
+        QUIC_LIBRARY_SETTINGS* Snapshot =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&MsQuicLib.SettingsSnapshots),
+                QUIC_LIBRARY_SETTINGS,
+                Link);
+        QuicSettingsCleanup(&Snapshot->Settings);
+        CXPLAT_FREE(Snapshot, QUIC_POOL_LIBRARY_SETTINGS);
+    }
+    MsQuicLib.Settings = NULL;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 _Function_class_(CXPLAT_STORAGE_CHANGE_CALLBACK)
 void
@@ -455,13 +655,25 @@ MsQuicLibraryReadSettings(
     _In_opt_ void* Context
     )
 {
-    QuicSettingsSetDefault(&MsQuicLib.Settings);
+    CxPlatLockAcquire(&MsQuicLib.SettingsLock);
+    QUIC_LIBRARY_SETTINGS* Snapshot = QuicLibrarySettingsClone(MsQuicLib.Settings);
+    if (Snapshot == NULL) {
+        //
+        // Keep the current settings.
+        //
+        CxPlatLockRelease(&MsQuicLib.SettingsLock);
+        return;
+    }
+
+    QuicSettingsSetDefault(&Snapshot->Settings);
     if (MsQuicLib.Storage != NULL) {
-        QuicSettingsLoad(&MsQuicLib.Settings, MsQuicLib.Storage);
+        QuicSettingsLoad(&Snapshot->Settings, MsQuicLib.Storage);
         QuicLibraryLoadRetryConfig(MsQuicLib.Storage);
     }
 
-    QuicSettingsDump(&MsQuicLib.Settings);
+    QuicSettingsDump(&Snapshot->Settings);
+    QuicLibrarySettingsPublish(Snapshot);
+    CxPlatLockRelease(&MsQuicLib.SettingsLock);
 
     MsQuicLibraryOnSettingsChanged(Context != NULL);
 }
@@ -492,12 +704,37 @@ MsQuicLibraryInitialize(
 
     CxPlatDispatchRwLockInitialize(&MsQuicLib.StatelessRetry.Lock);
 
-    CxPlatZeroMemory(&MsQuicLib.Settings, sizeof(MsQuicLib.Settings));
+    MsQuicLib.Settings = NULL;
+    CxPlatLockInitialize(&MsQuicLib.SettingsLock);
+    CxPlatListInitializeHead(&MsQuicLib.SettingsSnapshots);
     CxPlatLockInitialize(&MsQuicLib.RegistrationCloseCleanupLock);
     CxPlatEventInitialize(&MsQuicLib.RegistrationCloseCleanupEvent, FALSE, FALSE);
     MsQuicLib.RegistrationCloseCleanupShutdown = FALSE;
     CxPlatListInitializeHead(&MsQuicLib.RegistrationCloseCleanupList);
     CxPlatRundownInitialize(&MsQuicLib.RegistrationCloseCleanupRundown);
+    CxPlatDispatchLockInitialize(&MsQuicLib.TlsOffloadLock);
+    CxPlatEventInitialize(&MsQuicLib.TlsOffloadEvent, FALSE, FALSE);
+    MsQuicLib.TlsOffloadShutdown = FALSE;
+    MsQuicLib.TlsOffloadThreadCount = 0;
+    CxPlatListInitializeHead(&MsQuicLib.TlsOffloadQueue);
+    CxPlatListInitializeHead(&MsQuicLib.CredentialLoadQueue);
+    CxPlatDispatchLockInitialize(&MsQuicLib.ProtectOffloadLock);
+    CxPlatEventInitialize(&MsQuicLib.ProtectOffloadEvent, FALSE, FALSE);
+    MsQuicLib.ProtectOffloadShutdown = FALSE;
+    MsQuicLib.ProtectOffloadThreadCount = 0;
+    CxPlatListInitializeHead(&MsQuicLib.ProtectOffloadQueue);
+    CxPlatDispatchLockInitialize(&MsQuicLib.PathMetricsCacheLock);
+    CxPlatZeroMemory(MsQuicLib.PathMetricsCache, sizeof(MsQuicLib.PathMetricsCache));
+    QuicPersistentCacheInitialize();
+    MsQuicLib.QlogConfig.SamplingInterval = 0;
+    MsQuicLib.QlogConfig.BufferSize = QUIC_QLOG_DEFAULT_BUFFER_SIZE;
+    MsQuicLib.QlogSampleCount = 0;
+    MsQuicLib.SlowCallbackThresholdUs = 0;
+    MsQuicLib.InitialFilterConfig.Enabled = QUIC_DEFAULT_INITIAL_FILTER_ENABLED;
+    MsQuicLib.InitialFilterConfig.BucketCount = QUIC_DEFAULT_INITIAL_FILTER_BUCKET_COUNT;
+    MsQuicLib.InitialFilterConfig.WindowMs = QUIC_DEFAULT_INITIAL_FILTER_WINDOW_MS;
+    MsQuicLib.InitialFilterConfig.RetryThreshold = QUIC_DEFAULT_INITIAL_FILTER_RETRY_THRESHOLD;
+    MsQuicLib.InitialFilterConfig.DropThreshold = QUIC_DEFAULT_INITIAL_FILTER_DROP_THRESHOLD;
 
     PlatformInitialized = TRUE;
 
@@ -513,6 +750,10 @@ MsQuicLibraryInitialize(
     }
 
     MsQuicLibraryReadSettings(NULL); // NULL means don't update registrations.
+    if (MsQuicLib.Settings == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
 
     CXPLAT_THREAD_CONFIG ThreadConfig = {
         0,
@@ -581,6 +822,14 @@ Error:
             MsQuicLib.DefaultCompatibilityList = NULL;
         }
         if (PlatformInitialized) {
+            QuicLibraryFreeSettings();
+            CxPlatLockUninitialize(&MsQuicLib.SettingsLock);
+            QuicPersistentCacheUninitialize();
+            CxPlatDispatchLockUninitialize(&MsQuicLib.PathMetricsCacheLock);
+            CxPlatEventUninitialize(MsQuicLib.ProtectOffloadEvent);
+            CxPlatDispatchLockUninitialize(&MsQuicLib.ProtectOffloadLock);
+            CxPlatEventUninitialize(MsQuicLib.TlsOffloadEvent);
+            CxPlatDispatchLockUninitialize(&MsQuicLib.TlsOffloadLock);
             CxPlatRundownUninitialize(&MsQuicLib.RegistrationCloseCleanupRundown);
             CxPlatEventUninitialize(MsQuicLib.RegistrationCloseCleanupEvent);
             CxPlatLockUninitialize(&MsQuicLib.RegistrationCloseCleanupLock);
@@ -693,7 +942,8 @@ MsQuicLibraryUninitialize(
         MsQuicLib.Storage = NULL;
     }
 
-    QuicSettingsCleanup(&MsQuicLib.Settings);
+    QuicLibraryFreeSettings();
+    CxPlatLockUninitialize(&MsQuicLib.SettingsLock);
 
     CXPLAT_FREE(MsQuicLib.DefaultCompatibilityList, QUIC_POOL_DEFAULT_COMPAT_VER_LIST);
     MsQuicLib.DefaultCompatibilityList = NULL;
@@ -710,6 +960,35 @@ MsQuicLibraryUninitialize(
     CxPlatEventUninitialize(MsQuicLib.RegistrationCloseCleanupEvent);
     CxPlatLockUninitialize(&MsQuicLib.RegistrationCloseCleanupLock);
 
+    //
+    // All connections and configurations are gone by now, so the TLS offload
+    // queues are empty.
+    //
+    CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&MsQuicLib.TlsOffloadQueue));
+    CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&MsQuicLib.CredentialLoadQueue));
+    MsQuicLib.TlsOffloadShutdown = TRUE;
+    CxPlatEventSet(MsQuicLib.TlsOffloadEvent);
+    for (uint32_t i = 0; i < MsQuicLib.TlsOffloadThreadCount; ++i) {
+        CxPlatThreadWait(&MsQuicLib.TlsOffloadThreads[i]);
+        CxPlatThreadDelete(&MsQuicLib.TlsOffloadThreads[i]);
+    }
+    MsQuicLib.TlsOffloadThreadCount = 0;
+    CxPlatEventUninitialize(MsQuicLib.TlsOffloadEvent);
+    CxPlatDispatchLockUninitialize(&MsQuicLib.TlsOffloadLock);
+
+    CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&MsQuicLib.ProtectOffloadQueue));
+    MsQuicLib.ProtectOffloadShutdown = TRUE;
+    CxPlatEventSet(MsQuicLib.ProtectOffloadEvent);
+    for (uint32_t i = 0; i < MsQuicLib.ProtectOffloadThreadCount; ++i) {
+        CxPlatThreadWait(&MsQuicLib.ProtectOffloadThreads[i]);
+        CxPlatThreadDelete(&MsQuicLib.ProtectOffloadThreads[i]);
+    }
+    MsQuicLib.ProtectOffloadThreadCount = 0;
+    CxPlatEventUninitialize(MsQuicLib.ProtectOffloadEvent);
+    CxPlatDispatchLockUninitialize(&MsQuicLib.ProtectOffloadLock);
+    QuicPersistentCacheUninitialize();
+    CxPlatDispatchLockUninitialize(&MsQuicLib.PathMetricsCacheLock);
+
     if (MsQuicLib.ExecutionConfig != NULL) {
         CXPLAT_FREE(MsQuicLib.ExecutionConfig, QUIC_POOL_EXECUTION_CONFIG);
         MsQuicLib.ExecutionConfig = NULL;
@@ -754,140 +1033,574 @@ CXPLAT_THREAD_CALLBACK(RegistrationCleanupWorker, Context)
     CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
 }
 
+CXPLAT_THREAD_CALLBACK(TlsOffloadWorker, Context)
+{
+    UNREFERENCED_PARAMETER(Context);
+
+    while (TRUE) {
+        CxPlatEventWaitForever(MsQuicLib.TlsOffloadEvent);
+
+        CxPlatDispatchLockAcquire(&MsQuicLib.TlsOffloadLock);
+        while (TRUE) {
+            //
+            // Handshakes are latency sensitive, so they go ahead of any
+            // credential loads.
+            //
+            CXPLAT_LIST_ENTRY* Entry;
+            BOOLEAN IsCredentialLoad;
+            if (!CxPlatListIsEmpty(&MsQuicLib.TlsOffloadQueue)) {
+                Entry = CxPlatListRemoveHead(&MsQuicLib.TlsOffloadQueue);
+                IsCredentialLoad = FALSE;
+            } else if (!CxPlatListIsEmpty(&MsQuicLib.CredentialLoadQueue)) {
+                Entry = CxPlatListRemoveHead(&MsQuicLib.CredentialLoadQueue);
+                IsCredentialLoad = TRUE;
+            } else {
+                break;
+            }
+            if (!CxPlatListIsEmpty(&MsQuicLib.TlsOffloadQueue) ||
+                !CxPlatListIsEmpty(&MsQuicLib.CredentialLoadQueue)) {
+                //
+                // Wake another thread to pick up the rest in parallel.
+                //
+                CxPlatEventSet(MsQuicLib.TlsOffloadEvent);
+            }
+            CxPlatDispatchLockRelease(&MsQuicLib.TlsOffloadLock);
+
+            if (IsCredentialLoad) {
+                QuicConfigurationProcessCredentialLoad(
+                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CREDENTIAL_LOAD, Link));
+            } else {
+                QuicCryptoProcessOffload(
+                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CRYPTO_OFFLOAD, Link));
+            }
+
+            CxPlatDispatchLockAcquire(&MsQuicLib.TlsOffloadLock);
+        }
+        const BOOLEAN Shutdown = MsQuicLib.TlsOffloadShutdown;
+        CxPlatDispatchLockRelease(&MsQuicLib.TlsOffloadLock);
+
+        if (Shutdown) {
+            CxPlatEventSet(MsQuicLib.TlsOffloadEvent); // Pass it on to the next thread.
+            break;
+        }
+    }
+
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
-MsQuicAddRef(
+QuicLibraryStartTlsOffload(
     void
     )
 {
-    //
-    // If you hit this assert, you are trying to call MsQuic API without
-    // actually loading/starting the library/driver.
-    //
-    CXPLAT_TEL_ASSERT(MsQuicLib.Loaded);
-    if (!MsQuicLib.Loaded) {
-        return QUIC_STATUS_INVALID_STATE;
-    }
-
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
 
     CxPlatLockAcquire(&MsQuicLib.Lock);
 
-    //
-    // Increment global ref count, and if this is the first ref, initialize all
-    // the global library state.
-    //
-    if (++MsQuicLib.OpenRefCount == 1) {
-        Status = MsQuicLibraryInitialize();
-        if (QUIC_FAILED(Status)) {
-            MsQuicLib.OpenRefCount--;
-            goto Error;
+    if (MsQuicLib.TlsOffloadThreadCount == 0) {
+        uint32_t ThreadCount = CxPlatProcCount();
+        if (ThreadCount > QUIC_MAX_TLS_OFFLOAD_THREADS) {
+            ThreadCount = QUIC_MAX_TLS_OFFLOAD_THREADS;
         }
-    }
 
+        CXPLAT_THREAD_CONFIG ThreadConfig = {
+            0,
+            0,
+            "TlsOffloadWorker",
+            TlsOffloadWorker,
+            NULL,
+        };
 
-Error:
+        for (uint32_t i = 0; i < ThreadCount; ++i) {
+            Status =
+                CxPlatThreadCreate(
+                    &ThreadConfig,
+                    &MsQuicLib.TlsOffloadThreads[MsQuicLib.TlsOffloadThreadCount]);
+            if (QUIC_FAILED(Status)) {
+                break;
+            }
+            MsQuicLib.TlsOffloadThreadCount++;
+        }
+
+        if (MsQuicLib.TlsOffloadThreadCount != 0) {
+            Status = QUIC_STATUS_SUCCESS; // Run with what we have.
+        }
+    }
 
     CxPlatLockRelease(&MsQuicLib.Lock);
 
     return Status;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryQueueTlsOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    )
+{
+    CXPLAT_DBG_ASSERT(MsQuicLib.TlsOffloadThreadCount != 0);
+    CxPlatDispatchLockAcquire(&MsQuicLib.TlsOffloadLock);
+    CxPlatListInsertTail(&MsQuicLib.TlsOffloadQueue, Link);
+    CxPlatDispatchLockRelease(&MsQuicLib.TlsOffloadLock);
+    CxPlatEventSet(MsQuicLib.TlsOffloadEvent);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-MsQuicRelease(
-    void
+QuicLibraryQueueCredentialLoad(
+    _In_ CXPLAT_LIST_ENTRY* Link
     )
 {
-    CxPlatLockAcquire(&MsQuicLib.Lock);
+    CXPLAT_DBG_ASSERT(MsQuicLib.TlsOffloadThreadCount != 0);
+    CxPlatDispatchLockAcquire(&MsQuicLib.TlsOffloadLock);
+    CxPlatListInsertTail(&MsQuicLib.CredentialLoadQueue, Link);
+    CxPlatDispatchLockRelease(&MsQuicLib.TlsOffloadLock);
+    CxPlatEventSet(MsQuicLib.TlsOffloadEvent);
+}
 
-    //
-    // Decrement global ref count and uninitialize the library if this is the
-    // last ref.
-    //
+CXPLAT_THREAD_CALLBACK(ProtectOffloadWorker, Context)
+{
+    UNREFERENCED_PARAMETER(Context);
 
-    CXPLAT_FRE_ASSERT(MsQuicLib.OpenRefCount > 0);
+    while (TRUE) {
+        CxPlatEventWaitForever(MsQuicLib.ProtectOffloadEvent);
 
-    if (--MsQuicLib.OpenRefCount == 0) {
-        MsQuicLibraryUninitialize();
+        CxPlatDispatchLockAcquire(&MsQuicLib.ProtectOffloadLock);
+        while (!CxPlatListIsEmpty(&MsQuicLib.ProtectOffloadQueue)) {
+            CXPLAT_LIST_ENTRY* Entry =
+                CxPlatListRemoveHead(&MsQuicLib.ProtectOffloadQueue);
+            CxPlatListInitializeHead(Entry); // Marks it as no longer queued.
+            if (!CxPlatListIsEmpty(&MsQuicLib.ProtectOffloadQueue)) {
+                //
+                // Wake another thread to pick up the rest in parallel.
+                //
+                CxPlatEventSet(MsQuicLib.ProtectOffloadEvent);
+            }
+            CxPlatDispatchLockRelease(&MsQuicLib.ProtectOffloadLock);
+
+            QuicPacketBuilderProcessProtectOffload(
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_PROTECT_OFFLOAD, Link));
+
+            CxPlatDispatchLockAcquire(&MsQuicLib.ProtectOffloadLock);
+        }
+        const BOOLEAN Shutdown = MsQuicLib.ProtectOffloadShutdown;
+        CxPlatDispatchLockRelease(&MsQuicLib.ProtectOffloadLock);
+
+        if (Shutdown) {
+            CxPlatEventSet(MsQuicLib.ProtectOffloadEvent); // Pass it on to the next thread.
+            break;
+        }
     }
 
-    CxPlatLockRelease(&MsQuicLib.Lock);
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
-QuicLibraryLazyInitialize(
-    BOOLEAN AcquireLock
+QuicLibraryStartProtectOffload(
+    void
     )
 {
-    const CXPLAT_UDP_DATAPATH_CALLBACKS DatapathCallbacks = {
-        QuicBindingReceive,
-        QuicBindingUnreachable,
-    };
-
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
-    BOOLEAN CreatedWorkerPool = FALSE;
-
-    if (AcquireLock) {
-        CxPlatLockAcquire(&MsQuicLib.Lock);
-    }
-
-    if (MsQuicLib.LazyInitComplete) {
-        goto Exit;
-    }
-
-    CXPLAT_DBG_ASSERT(MsQuicLib.Partitions == NULL);
-    CXPLAT_DBG_ASSERT(MsQuicLib.Datapath == NULL);
 
-    Status = QuicLibraryInitializePartitions();
-    if (QUIC_FAILED(Status)) {
-        goto Exit;
-    }
+    CxPlatLockAcquire(&MsQuicLib.Lock);
 
-#ifndef _KERNEL_MODE
-    if (MsQuicLib.WorkerPool == NULL) {
-        MsQuicLib.WorkerPool = CxPlatWorkerPoolCreate(MsQuicLib.ExecutionConfig, CXPLAT_WORKER_POOL_REF_LIBRARY);
-        if (!MsQuicLib.WorkerPool) {
-            Status = QUIC_STATUS_OUT_OF_MEMORY;
-            MsQuicLibraryFreePartitions();
-            goto Exit;
+    if (MsQuicLib.ProtectOffloadThreadCount == 0) {
+        //
+        // Leave at least one processor for the connection's own worker.
+        //
+        uint32_t ThreadCount = CxPlatProcCount() > 1 ? CxPlatProcCount() - 1 : 1;
+        if (ThreadCount > QUIC_MAX_PROTECT_OFFLOAD_THREADS) {
+            ThreadCount = QUIC_MAX_PROTECT_OFFLOAD_THREADS;
         }
-        CreatedWorkerPool = TRUE;
-    }
-#endif
 
-    CXPLAT_DATAPATH_INIT_CONFIG InitConfig = {0};
-    InitConfig.EnableDscpOnRecv = MsQuicLib.EnableDscpOnRecv;
+        CXPLAT_THREAD_CONFIG ThreadConfig = {
+            0,
+            0,
+            "ProtectOffloadWorker",
+            ProtectOffloadWorker,
+            NULL,
+        };
 
-    Status =
-        CxPlatDataPathInitialize(
-            sizeof(QUIC_RX_PACKET),
-            &DatapathCallbacks,
-            NULL,                   // TcpCallbacks
-            MsQuicLib.WorkerPool,
-            &InitConfig,
-            &MsQuicLib.Datapath);
-    if (QUIC_SUCCEEDED(Status)) {
-        if (MsQuicLib.ExecutionConfig &&
-            MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs != 0) {
-            CxPlatDataPathUpdatePollingIdleTimeout(
-                MsQuicLib.Datapath,
-                MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs);
+        for (uint32_t i = 0; i < ThreadCount; ++i) {
+            Status =
+                CxPlatThreadCreate(
+                    &ThreadConfig,
+                    &MsQuicLib.ProtectOffloadThreads[MsQuicLib.ProtectOffloadThreadCount]);
+            if (QUIC_FAILED(Status)) {
+                break;
+            }
+            MsQuicLib.ProtectOffloadThreadCount++;
         }
-    } else {
-        MsQuicLibraryFreePartitions();
-#ifndef _KERNEL_MODE
-        if (CreatedWorkerPool) {
-            CxPlatWorkerPoolDelete(MsQuicLib.WorkerPool, CXPLAT_WORKER_POOL_REF_LIBRARY);
-            MsQuicLib.WorkerPool = NULL;
+
+        if (MsQuicLib.ProtectOffloadThreadCount != 0) {
+            Status = QUIC_STATUS_SUCCESS; // Run with what we have.
         }
-#endif
-        goto Exit;
     }
 
-    CXPLAT_DBG_ASSERT(MsQuicLib.Partitions != NULL);
-    CXPLAT_DBG_ASSERT(MsQuicLib.Datapath != NULL);
+    CxPlatLockRelease(&MsQuicLib.Lock);
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryQueueProtectOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    )
+{
+    CXPLAT_DBG_ASSERT(MsQuicLib.ProtectOffloadThreadCount != 0);
+    CxPlatDispatchLockAcquire(&MsQuicLib.ProtectOffloadLock);
+    CxPlatListInsertTail(&MsQuicLib.ProtectOffloadQueue, Link);
+    CxPlatDispatchLockRelease(&MsQuicLib.ProtectOffloadLock);
+    CxPlatEventSet(MsQuicLib.ProtectOffloadEvent);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryCancelProtectOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    )
+{
+    //
+    // Offload threads leave the entries they dequeue linked to themselves.
+    //
+    CxPlatDispatchLockAcquire(&MsQuicLib.ProtectOffloadLock);
+    const BOOLEAN Queued = !CxPlatListIsEmpty(Link);
+    if (Queued) {
+        CxPlatListEntryRemove(Link);
+        CxPlatListInitializeHead(Link);
+    }
+    CxPlatDispatchLockRelease(&MsQuicLib.ProtectOffloadLock);
+    return Queued;
+}
+
+//
+// Returns the key path metrics are cached under for a remote address: the IP
+// address without the port, and for IPv6 just the /64 prefix, since hosts in
+// the same subnet (or one host rotating privacy addresses) share the path.
+//
+static
+void
+QuicLibraryGetPathMetricsKey(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _Out_ QUIC_ADDR* Key
+    )
+{
+    CxPlatZeroMemory(Key, sizeof(*Key));
+    QuicAddrSetFamily(Key, QuicAddrGetFamily(RemoteAddress));
+    if (QuicAddrGetFamily(RemoteAddress) == QUIC_ADDRESS_FAMILY_INET) {
+        Key->Ipv4.sin_addr = RemoteAddress->Ipv4.sin_addr;
+    } else {
+        CxPlatCopyMemory(&Key->Ipv6.sin6_addr, &RemoteAddress->Ipv6.sin6_addr, 8);
+    }
+}
+
+//
+// Finds the entry cached for the key, or NULL. The set is an LRU: the entry
+// found is moved to the front. Must be called with PathMetricsCacheLock held.
+//
+static
+QUIC_PATH_METRICS_CACHE_ENTRY*
+QuicLibraryLookupPathMetrics(
+    _In_ const QUIC_ADDR* Key,
+    _In_ BOOLEAN Insert
+    )
+{
+    QUIC_PATH_METRICS_CACHE_ENTRY* Set =
+        &MsQuicLib.PathMetricsCache[
+            (QuicAddrHash(Key) % QUIC_PATH_METRICS_CACHE_SETS) *
+                QUIC_PATH_METRICS_CACHE_WAYS];
+
+    uint32_t i;
+    for (i = 0; i < QUIC_PATH_METRICS_CACHE_WAYS - 1; ++i) {
+        if (Set[i].TimeUs == 0 || QuicAddrCompare(&Set[i].RemoteAddress, Key)) {
+            break;
+        }
+    }
+
+    QUIC_PATH_METRICS_CACHE_ENTRY Entry = Set[i];
+    if (Entry.TimeUs == 0 || !QuicAddrCompare(&Entry.RemoteAddress, Key)) {
+        if (!Insert) {
+            return NULL;
+        }
+        //
+        // Not found. Replace the last used entry of the set (or the first
+        // unused one).
+        //
+        CxPlatZeroMemory(&Entry, sizeof(Entry));
+        Entry.RemoteAddress = *Key;
+    }
+
+    CxPlatMoveMemory(&Set[1], &Set[0], i * sizeof(QUIC_PATH_METRICS_CACHE_ENTRY));
+    Set[0] = Entry;
+    return &Set[0];
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryGetPathMetrics(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ uint64_t MaxAgeUs,
+    _Out_ QUIC_PATH_METRICS* Metrics
+    )
+{
+    QUIC_ADDR Key;
+    QuicLibraryGetPathMetricsKey(RemoteAddress, &Key);
+    BOOLEAN Found = FALSE;
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.PathMetricsCacheLock);
+    const QUIC_PATH_METRICS_CACHE_ENTRY* Entry =
+        QuicLibraryLookupPathMetrics(&Key, FALSE);
+    if (Entry != NULL &&
+        CxPlatTimeDiff64(Entry->TimeUs, CxPlatTimeUs64()) < MaxAgeUs) {
+        *Metrics = Entry->Metrics;
+        Found = TRUE;
+    }
+    CxPlatDispatchLockRelease(&MsQuicLib.PathMetricsCacheLock);
+
+    if (!Found) {
+        CxPlatZeroMemory(Metrics, sizeof(*Metrics));
+    }
+    return Found;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryCachePathMetrics(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ const QUIC_PATH_METRICS* Metrics
+    )
+{
+    QUIC_ADDR Key;
+    QuicLibraryGetPathMetricsKey(RemoteAddress, &Key);
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.PathMetricsCacheLock);
+    QUIC_PATH_METRICS_CACHE_ENTRY* Entry =
+        QuicLibraryLookupPathMetrics(&Key, TRUE);
+    Entry->TimeUs = CxPlatTimeUs64();
+    if (Metrics->SmoothedRtt != 0) {
+        Entry->Metrics.SmoothedRtt = Metrics->SmoothedRtt;
+        Entry->Metrics.MinRtt = Metrics->MinRtt;
+        Entry->Metrics.CongestionWindow = Metrics->CongestionWindow;
+    }
+    if (Metrics->Mtu != 0) {
+        Entry->Metrics.Mtu = Metrics->Mtu;
+    }
+    Entry->Dirty = TRUE;
+    CxPlatDispatchLockRelease(&MsQuicLib.PathMetricsCacheLock);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryRestorePathMetrics(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ uint64_t AgeUs,
+    _In_ const QUIC_PATH_METRICS* Metrics
+    )
+{
+    QUIC_ADDR Key;
+    QuicLibraryGetPathMetricsKey(RemoteAddress, &Key);
+    const uint64_t TimeNow = CxPlatTimeUs64();
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.PathMetricsCacheLock);
+    QUIC_PATH_METRICS_CACHE_ENTRY* Entry =
+        QuicLibraryLookupPathMetrics(&Key, TRUE);
+    Entry->TimeUs = TimeNow > AgeUs ? TimeNow - AgeUs : 1;
+    Entry->Metrics = *Metrics;
+    Entry->Dirty = FALSE;
+    CxPlatDispatchLockRelease(&MsQuicLib.PathMetricsCacheLock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+MsQuicAddRef(
+    void
+    )
+{
+    //
+    // If you hit this assert, you are trying to call MsQuic API without
+    // actually loading/starting the library/driver.
+    //
+    CXPLAT_TEL_ASSERT(MsQuicLib.Loaded);
+    if (!MsQuicLib.Loaded) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+
+    CxPlatLockAcquire(&MsQuicLib.Lock);
+
+    //
+    // Increment global ref count, and if this is the first ref, initialize all
+    // the global library state.
+    //
+    if (++MsQuicLib.OpenRefCount == 1) {
+        Status = MsQuicLibraryInitialize();
+        if (QUIC_FAILED(Status)) {
+            MsQuicLib.OpenRefCount--;
+            goto Error;
+        }
+    }
+
+
+Error:
+
+    CxPlatLockRelease(&MsQuicLib.Lock);
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+MsQuicRelease(
+    void
+    )
+{
+    CxPlatLockAcquire(&MsQuicLib.Lock);
+
+    //
+    // Decrement global ref count and uninitialize the library if this is the
+    // last ref.
+    //
+
+    CXPLAT_FRE_ASSERT(MsQuicLib.OpenRefCount > 0);
+
+    if (--MsQuicLib.OpenRefCount == 0) {
+        MsQuicLibraryUninitialize();
+    }
+
+    CxPlatLockRelease(&MsQuicLib.Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicLibraryLazyInitialize(
+    BOOLEAN AcquireLock
+    )
+{
+    const CXPLAT_UDP_DATAPATH_CALLBACKS DatapathCallbacks = {
+        QuicBindingReceive,
+        QuicBindingUnreachable,
+    };
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    BOOLEAN CreatedWorkerPool = FALSE;
+
+    if (AcquireLock) {
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+    }
+
+    if (MsQuicLib.LazyInitComplete) {
+        goto Exit;
+    }
+
+    CXPLAT_DBG_ASSERT(MsQuicLib.Partitions == NULL);
+    CXPLAT_DBG_ASSERT(MsQuicLib.Datapath == NULL);
+
+    //
+    // Huge page arenas must be configured before any pool backed by them is
+    // created, so the setting only takes effect up to this point.
+    //
+    switch (QuicLibraryGetSettings()->HugePageMode) {
+    case QUIC_HUGE_PAGE_2MB:
+        CxPlatHugePagesConfigure(2 * 1024 * 1024);
+        break;
+    case QUIC_HUGE_PAGE_1GB:
+        CxPlatHugePagesConfigure(1024 * 1024 * 1024);
+        break;
+    default:
+        CxPlatHugePagesConfigure(0);
+        break;
+    }
+
+#ifndef _KERNEL_MODE
+    if (MsQuicLib.WorkerPool == NULL) {
+        QuicLibraryApplyProcessorRestrictions();
+    }
+#endif
+
+    Status = QuicLibraryInitializePartitions();
+    if (QUIC_FAILED(Status)) {
+        goto Exit;
+    }
+
+#ifndef _KERNEL_MODE
+    if (MsQuicLib.WorkerPool == NULL) {
+        MsQuicLib.WorkerPool = CxPlatWorkerPoolCreate(MsQuicLib.ExecutionConfig, CXPLAT_WORKER_POOL_REF_LIBRARY);
+        if (!MsQuicLib.WorkerPool) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            MsQuicLibraryFreePartitions();
+            goto Exit;
+        }
+        CreatedWorkerPool = TRUE;
+    }
+
+    for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+        QuicPartitionRegisterDynamicPools(&MsQuicLib.Partitions[i], MsQuicLib.WorkerPool);
+        if (MsQuicLib.RecvChunkPoolPoliciesSet) {
+            QuicPartitionSetRecvChunkPoolPolicies(
+                &MsQuicLib.Partitions[i], MsQuicLib.RecvChunkPoolPolicies);
+        }
+    }
+#endif
+
+    CXPLAT_DATAPATH_INIT_CONFIG InitConfig = {0};
+    InitConfig.EnableDscpOnRecv = MsQuicLib.EnableDscpOnRecv;
+    InitConfig.EnableRecvTimestamps = MsQuicLib.EnableRecvTimestamps;
+    InitConfig.EnableSendTxTime = MsQuicLib.EnableSendTxTime;
+    InitConfig.EnableFixedFiles =
+        MsQuicLib.ExecutionConfig != NULL &&
+        (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_URING_FIXED_FILES);
+    InitConfig.EnableXdpSharedUmem =
+        MsQuicLib.ExecutionConfig != NULL &&
+        (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_XDP_SHARED_UMEM);
+    InitConfig.XdpTxCompletionBatchSize = MsQuicLib.XdpTxCompletion.BatchSize;
+    InitConfig.XdpTxCompletionHighWatermark = MsQuicLib.XdpTxCompletion.HighWatermark;
+    InitConfig.EnableEdgeTriggered =
+        MsQuicLib.ExecutionConfig != NULL &&
+        (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_EPOLL_EDGE_TRIGGERED);
+    InitConfig.EnableSendBatching =
+        MsQuicLib.ExecutionConfig != NULL &&
+        (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_EPOLL_SEND_BATCHING);
+
+    Status =
+        CxPlatDataPathInitialize(
+            sizeof(QUIC_RX_PACKET),
+            &DatapathCallbacks,
+            NULL,                   // TcpCallbacks
+            MsQuicLib.WorkerPool,
+            &InitConfig,
+            &MsQuicLib.Datapath);
+    if (QUIC_SUCCEEDED(Status)) {
+        if (MsQuicLib.ExecutionConfig &&
+            MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs != 0) {
+            CxPlatDataPathUpdatePollingIdleTimeout(
+                MsQuicLib.Datapath,
+                MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs);
+        }
+        //
+        // The raw (XDP) datapath doesn't take departure times.
+        //
+        MsQuicLib.SendTxTimeSupported =
+            !QuicLibraryGetSettings()->XdpEnabled &&
+            !!(QuicLibraryGetDatapathFeatures() & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME);
+        MsQuicLib.SendSegmentationSupported =
+            !!(QuicLibraryGetDatapathFeatures() & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+    } else {
+        MsQuicLibraryFreePartitions();
+#ifndef _KERNEL_MODE
+        if (CreatedWorkerPool) {
+            CxPlatWorkerPoolDelete(MsQuicLib.WorkerPool, CXPLAT_WORKER_POOL_REF_LIBRARY);
+            MsQuicLib.WorkerPool = NULL;
+        }
+#endif
+        goto Exit;
+    }
+
+    CXPLAT_DBG_ASSERT(MsQuicLib.Partitions != NULL);
+    CXPLAT_DBG_ASSERT(MsQuicLib.Datapath != NULL);
     MsQuicLib.LazyInitComplete = TRUE;
 
 Exit:
@@ -971,21 +1684,36 @@ QuicLibApplyLoadBalancingSetting(
     void
     )
 {
-    switch (MsQuicLib.Settings.LoadBalancingMode) {
+    switch (QuicLibraryGetSettings()->LoadBalancingMode) {
     case QUIC_LOAD_BALANCING_DISABLED:
     default:
         MsQuicLib.CidServerIdLength = 0;
         break;
     case QUIC_LOAD_BALANCING_SERVER_ID_IP:    // 1 + 4 for IP address/suffix
     case QUIC_LOAD_BALANCING_SERVER_ID_FIXED: // 1 + 4 for fixed value
+    case QUIC_LOAD_BALANCING_SERVER_ID_STREAM_CIPHER:
+    case QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER:
         MsQuicLib.CidServerIdLength = 5;
         break;
     }
 
-    MsQuicLib.CidTotalLength =
-        MsQuicLib.CidServerIdLength +
-        QUIC_CID_PID_LENGTH +
-        QUIC_CID_PAYLOAD_LENGTH;
+    if (QuicLibraryGetSettings()->LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER) {
+        //
+        // Everything after the first byte is a single AES block.
+        //
+        MsQuicLib.CidTotalLength = 1 + QUIC_CID_LB_BLOCK_LENGTH;
+    } else {
+        MsQuicLib.CidTotalLength =
+            MsQuicLib.CidServerIdLength +
+            QUIC_CID_PID_LENGTH +
+            QUIC_CID_PAYLOAD_LENGTH;
+    }
+
+    if (QuicLibraryGetSettings()->LoadBalancingMode >= QUIC_LOAD_BALANCING_SERVER_ID_STREAM_CIPHER &&
+        !MsQuicLib.LoadBalancingKeySet) {
+        CxPlatRandom(sizeof(MsQuicLib.LoadBalancingKey), MsQuicLib.LoadBalancingKey);
+        MsQuicLib.LoadBalancingKeySet = TRUE;
+    }
 
     CXPLAT_FRE_ASSERT(MsQuicLib.CidServerIdLength <= QUIC_MAX_CID_SID_LENGTH);
     CXPLAT_FRE_ASSERT(MsQuicLib.CidTotalLength >= QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH);
@@ -993,37 +1721,113 @@ QuicLibApplyLoadBalancingSetting(
 
 }
 
-_IRQL_requires_max_(PASSIVE_LEVEL)
-QUIC_STATUS
-QuicLibrarySetGlobalParam(
-    _In_ uint32_t Param,
-    _In_ uint32_t BufferLength,
-    _In_reads_bytes_(BufferLength)
-        const void* Buffer
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryEncodeLoadBalancedCid(
+    _Inout_updates_(MsQuicLib.CidTotalLength)
+        uint8_t* CID
     )
 {
-    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
-    QUIC_SETTINGS_INTERNAL InternalSettings = {0};
+    QUIC_PARTITION* Partition = QuicLibraryGetCurrentPartition();
+    uint8_t Block[CXPLAT_HP_SAMPLE_LENGTH];
+    BOOLEAN Result = FALSE;
 
-    CXPLAT_DBG_ASSERT(MsQuicLib.Loaded);
-
-    switch (Param) {
-    case QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT:
+    CXPLAT_STATIC_ASSERT(
+        QUIC_CID_LB_BLOCK_LENGTH == CXPLAT_HP_SAMPLE_LENGTH,
+        "The block must be a single AES block");
+    CXPLAT_DBG_ASSERT(MsQuicLib.CidServerIdLength == QUIC_MAX_CID_SID_LENGTH);
 
-        if (BufferLength != sizeof(MsQuicLib.Settings.RetryMemoryLimit)) {
-            Status = QUIC_STATUS_INVALID_PARAMETER;
-            break;
-        }
+    //
+    // The first byte holds the config rotation bits (always 0) and the length
+    // of the rest of the CID, so the load balancer doesn't need to know it.
+    //
+    CID[0] = (uint8_t)(MsQuicLib.CidTotalLength - 1);
 
-        MsQuicLib.Settings.RetryMemoryLimit = *(uint16_t*)Buffer;
-        MsQuicLib.Settings.IsSet.RetryMemoryLimit = TRUE;
+    //
+    // Header protection keys are plain AES-ECB for AES-128-GCM, which is
+    // exactly the single block encryption needed here. They aren't safe for
+    // concurrent use, so each partition has its own, behind a lock.
+    //
+    CxPlatDispatchLockAcquire(&Partition->LoadBalancingKeyLock);
+
+    if (Partition->LoadBalancingKey == NULL &&
+        QUIC_FAILED(
+        CxPlatHpKeyCreate(
+            CXPLAT_AEAD_AES_128_GCM,
+            MsQuicLib.LoadBalancingKey,
+            &Partition->LoadBalancingKey))) {
+        goto Exit;
+    }
 
+    if (QuicLibraryGetSettings()->LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_STREAM_CIPHER) {
+        //
+        // Everything after the server ID (PID and payload) is left in the
+        // clear and used as the nonce. The server ID is XOR'ed with the
+        // encrypted (zero padded) nonce.
+        //
+        CxPlatZeroMemory(Block, sizeof(Block));
+        CxPlatCopyMemory(
+            Block,
+            CID + MsQuicLib.CidServerIdLength,
+            MsQuicLib.CidTotalLength - MsQuicLib.CidServerIdLength);
+        if (QUIC_FAILED(
+                CxPlatHpComputeMask(Partition->LoadBalancingKey, 1, Block, Block))) {
+            goto Exit;
+        }
+        for (uint8_t i = 1; i < MsQuicLib.CidServerIdLength; ++i) {
+            CID[i] ^= Block[i - 1];
+        }
+
+    } else {
+        CXPLAT_DBG_ASSERT(MsQuicLib.CidTotalLength == 1 + QUIC_CID_LB_BLOCK_LENGTH);
+        if (QUIC_FAILED(
+                CxPlatHpComputeMask(Partition->LoadBalancingKey, 1, CID + 1, Block))) {
+            goto Exit;
+        }
+        CxPlatCopyMemory(CID + 1, Block, QUIC_CID_LB_BLOCK_LENGTH);
+    }
+
+    Result = TRUE;
+
+Exit:
+
+    CxPlatDispatchLockRelease(&Partition->LoadBalancingKeyLock);
+
+    return Result;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicLibrarySetGlobalParam(
+    _In_ uint32_t Param,
+    _In_ uint32_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const void* Buffer
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    QUIC_SETTINGS_INTERNAL InternalSettings = {0};
+
+    CXPLAT_DBG_ASSERT(MsQuicLib.Loaded);
+
+    switch (Param) {
+    case QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT:
+
+        if (BufferLength != sizeof(InternalSettings.RetryMemoryLimit)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        InternalSettings.RetryMemoryLimit = *(uint16_t*)Buffer;
+        InternalSettings.IsSet.RetryMemoryLimit = TRUE;
+        Status = QuicLibrarySettingsUpdate(&InternalSettings);
+        if (QUIC_FAILED(Status)) {
+            break;
+        }
 
         MsQuicLib.HandshakeMemoryLimit =
-            (MsQuicLib.Settings.RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
+            (QuicLibraryGetSettings()->RetryMemoryLimit * CxPlatTotalMemory) / UINT16_MAX;
         QuicLibraryEvaluateSendRetryState();
-
-        Status = QUIC_STATUS_SUCCESS;
         break;
 
     case QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE: {
@@ -1033,24 +1837,25 @@ QuicLibrarySetGlobalParam(
             break;
         }
 
-        if (*(uint16_t*)Buffer > QUIC_LOAD_BALANCING_SERVER_ID_IP) {
+        if (*(uint16_t*)Buffer >= QUIC_LOAD_BALANCING_COUNT) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
         if (MsQuicLib.InUse &&
-            MsQuicLib.Settings.LoadBalancingMode != *(uint16_t*)Buffer) {
+            QuicLibraryGetSettings()->LoadBalancingMode != *(uint16_t*)Buffer) {
             Status = QUIC_STATUS_INVALID_STATE;
             break;
         }
 
-        MsQuicLib.Settings.LoadBalancingMode = *(uint16_t*)Buffer;
-        MsQuicLib.Settings.IsSet.LoadBalancingMode = TRUE;
+        InternalSettings.LoadBalancingMode = *(uint16_t*)Buffer;
+        InternalSettings.IsSet.LoadBalancingMode = TRUE;
+        Status = QuicLibrarySettingsUpdate(&InternalSettings);
+        if (QUIC_FAILED(Status)) {
+            break;
+        }
 
         QuicLibApplyLoadBalancingSetting();
-
-
-        Status = QUIC_STATUS_SUCCESS;
         break;
     }
 
@@ -1071,15 +1876,7 @@ QuicLibrarySetGlobalParam(
             break;
         }
 
-        if (!QuicSettingApply(
-                &MsQuicLib.Settings,
-                TRUE,
-                TRUE,
-                &InternalSettings)) {
-            Status = QUIC_STATUS_INVALID_PARAMETER;
-            break;
-        }
-
+        Status = QuicLibrarySettingsUpdate(&InternalSettings);
         if (QUIC_SUCCEEDED(Status)) {
             MsQuicLibraryOnSettingsChanged(TRUE);
         }
@@ -1103,15 +1900,7 @@ QuicLibrarySetGlobalParam(
             break;
         }
 
-        if (!QuicSettingApply(
-                &MsQuicLib.Settings,
-                TRUE,
-                TRUE,
-                &InternalSettings)) {
-            Status = QUIC_STATUS_INVALID_PARAMETER;
-            break;
-        }
-
+        Status = QuicLibrarySettingsUpdate(&InternalSettings);
         if (QUIC_SUCCEEDED(Status)) {
             MsQuicLibraryOnSettingsChanged(TRUE);
         }
@@ -1135,15 +1924,7 @@ QuicLibrarySetGlobalParam(
             break;
         }
 
-        if (!QuicSettingApply(
-                &MsQuicLib.Settings,
-                TRUE,
-                TRUE,
-                &InternalSettings)) {
-            QuicSettingsCleanup(&InternalSettings);
-            Status = QUIC_STATUS_INVALID_PARAMETER;
-            break;
-        }
+        Status = QuicLibrarySettingsUpdate(&InternalSettings);
         QuicSettingsCleanup(&InternalSettings);
 
         if (QUIC_SUCCEEDED(Status)) {
@@ -1290,6 +2071,72 @@ QuicLibrarySetGlobalParam(
         break;
     }
 
+    case QUIC_PARAM_GLOBAL_DATAPATH_RECV_TIMESTAMPS_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // Not allowed to change after the datapath is initialized.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.EnableRecvTimestamps = *(BOOLEAN*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_SEND_TXTIME_ENABLED: {
+
+        if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // Not allowed to change after the datapath is initialized.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        MsQuicLib.EnableSendTxTime = *(BOOLEAN*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_XDP_TX_COMPLETION: {
+
+        if (BufferLength != sizeof(QUIC_XDP_TX_COMPLETION_CONFIG) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.LazyInitComplete) {
+            //
+            // Not allowed to change after the datapath is initialized.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        CxPlatCopyMemory(
+            &MsQuicLib.XdpTxCompletion,
+            Buffer,
+            sizeof(QUIC_XDP_TX_COMPLETION_CONFIG));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
     case QUIC_PARAM_GLOBAL_VERSION_NEGOTIATION_ENABLED:
 
         if (Buffer == NULL ||
@@ -1298,10 +2145,9 @@ QuicLibrarySetGlobalParam(
             break;
         }
 
-        MsQuicLib.Settings.IsSet.VersionNegotiationExtEnabled = TRUE;
-        MsQuicLib.Settings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
-
-        Status = QUIC_STATUS_SUCCESS;
+        InternalSettings.IsSet.VersionNegotiationExtEnabled = TRUE;
+        InternalSettings.VersionNegotiationExtEnabled = *(BOOLEAN*)Buffer;
+        Status = QuicLibrarySettingsUpdate(&InternalSettings);
         break;
 
     case QUIC_PARAM_GLOBAL_STATELESS_RESET_KEY:
@@ -1328,6 +2174,76 @@ QuicLibrarySetGlobalParam(
         }
         break;
 
+    case QUIC_PARAM_GLOBAL_LOAD_BALANCING_KEY:
+        if (BufferLength != QUIC_LOAD_BALANCING_KEY_LENGTH * sizeof(uint8_t)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.InUse) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        CxPlatCopyMemory(
+            MsQuicLib.LoadBalancingKey, Buffer, QUIC_LOAD_BALANCING_KEY_LENGTH);
+        MsQuicLib.LoadBalancingKeySet = TRUE;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_ALLOCATION_STATISTICS:
+        if (BufferLength != sizeof(BOOLEAN)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Status =
+            CxPlatAllocTelemetryEnable(*(BOOLEAN*)Buffer) ?
+                QUIC_STATUS_SUCCESS : QUIC_STATUS_NOT_SUPPORTED;
+        break;
+
+#ifndef _KERNEL_MODE
+    case QUIC_PARAM_GLOBAL_RECV_POOL_POLICY: {
+        if (Buffer == NULL ||
+            BufferLength != QUIC_RECV_CHUNK_POOL_COUNT * sizeof(QUIC_POOL_POLICY)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_POOL_POLICY* Policies = (const QUIC_POOL_POLICY*)Buffer;
+        CXPLAT_POOL_EX_POLICY NewPolicies[QUIC_RECV_CHUNK_POOL_COUNT];
+        Status = QUIC_STATUS_SUCCESS;
+        for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+            if (Policies[i].LowWatermark > Policies[i].HighWatermark ||
+                Policies[i].DecayPercent > 100) {
+                Status = QUIC_STATUS_INVALID_PARAMETER;
+                break;
+            }
+            NewPolicies[i].LowWatermark = Policies[i].LowWatermark;
+            NewPolicies[i].HighWatermark = Policies[i].HighWatermark;
+            NewPolicies[i].PruneCount = Policies[i].PruneCount;
+            NewPolicies[i].DecayPercent = Policies[i].DecayPercent;
+        }
+        if (QUIC_FAILED(Status)) {
+            break;
+        }
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        CxPlatCopyMemory(
+            MsQuicLib.RecvChunkPoolPolicies, NewPolicies, sizeof(NewPolicies));
+        MsQuicLib.RecvChunkPoolPoliciesSet = TRUE;
+        if (MsQuicLib.LazyInitComplete) {
+            for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+                QuicPartitionSetRecvChunkPoolPolicies(
+                    &MsQuicLib.Partitions[i], NewPolicies);
+            }
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        break;
+    }
+#endif
+
     case QUIC_PARAM_GLOBAL_STATELESS_RETRY_CONFIG: {
         if (Buffer == NULL || BufferLength < sizeof(QUIC_STATELESS_RETRY_CONFIG)) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
@@ -1338,6 +2254,106 @@ QuicLibrarySetGlobalParam(
         break;
     }
 
+    case QUIC_PARAM_GLOBAL_PERSISTENT_CACHE_PATH:
+        if (BufferLength != 0 &&
+            (Buffer == NULL || ((const char*)Buffer)[BufferLength - 1] != '\0')) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        if (MsQuicLib.OpenRefCount == 0) {
+            Status = QUIC_STATUS_INVALID_STATE;
+        } else {
+            Status =
+                QuicPersistentCacheSetPath(
+                    BufferLength > 1 ? (const char*)Buffer : NULL);
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        break;
+
+    case QUIC_PARAM_GLOBAL_QLOG_CONFIG: {
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_QLOG_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QUIC_QLOG_CONFIG Config = *(const QUIC_QLOG_CONFIG*)Buffer;
+        if (Config.BufferSize == 0) {
+            Config.BufferSize = QUIC_QLOG_DEFAULT_BUFFER_SIZE;
+        } else if (Config.BufferSize < QUIC_QLOG_MIN_BUFFER_SIZE ||
+                   Config.BufferSize > QUIC_QLOG_MAX_BUFFER_SIZE) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        uint32_t BufferSize = QUIC_QLOG_MIN_BUFFER_SIZE;
+        while (BufferSize < Config.BufferSize) {
+            BufferSize <<= 1;
+        }
+        Config.BufferSize = BufferSize;
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        MsQuicLib.QlogConfig = Config;
+        MsQuicLib.QlogSampleCount = 0;
+        CxPlatLockRelease(&MsQuicLib.Lock);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SLOW_CALLBACK_THRESHOLD:
+        if (Buffer == NULL || BufferLength != sizeof(uint32_t)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.SlowCallbackThresholdUs = *(const uint32_t*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_PREWARM_CONFIG:
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_PREWARM_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        MsQuicLib.PrewarmConfig = *(const QUIC_PREWARM_CONFIG*)Buffer;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_INITIAL_FILTER_CONFIG: {
+        if (Buffer == NULL || BufferLength != sizeof(QUIC_INITIAL_FILTER_CONFIG)) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_INITIAL_FILTER_CONFIG* Config = (const QUIC_INITIAL_FILTER_CONFIG*)Buffer;
+        if (Config->BucketCount == 0 ||
+            Config->BucketCount > QUIC_MAX_INITIAL_FILTER_BUCKET_COUNT ||
+            (Config->BucketCount & (Config->BucketCount - 1)) != 0 ||
+            Config->WindowMs == 0) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        if (MsQuicLib.LazyInitComplete &&
+            Config->BucketCount != MsQuicLib.InitialFilterConfig.BucketCount) {
+            //
+            // The partitions' counter tables are already allocated.
+            //
+            Status = QUIC_STATUS_INVALID_STATE;
+        } else {
+            MsQuicLib.InitialFilterConfig = *Config;
+            Status = QUIC_STATUS_SUCCESS;
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        break;
+    }
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -1363,8 +2379,404 @@ QuicLibraryGetGlobalParam(
     switch (Param) {
     case QUIC_PARAM_GLOBAL_RETRY_MEMORY_PERCENT:
 
-        if (*BufferLength < sizeof(MsQuicLib.Settings.RetryMemoryLimit)) {
-            *BufferLength = sizeof(MsQuicLib.Settings.RetryMemoryLimit);
+        if (*BufferLength < sizeof(uint16_t)) {
+            *BufferLength = sizeof(uint16_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint16_t);
+        *(uint16_t*)Buffer = QuicLibraryGetSettings()->RetryMemoryLimit;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_SUPPORTED_VERSIONS:
+
+        if (*BufferLength < sizeof(QuicSupportedVersionList)) {
+            *BufferLength = sizeof(QuicSupportedVersionList);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QuicSupportedVersionList);
+        CxPlatCopyMemory(
+            Buffer,
+            QuicSupportedVersionList,
+            sizeof(QuicSupportedVersionList));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE:
+
+        if (*BufferLength < sizeof(uint16_t)) {
+            *BufferLength = sizeof(uint16_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(uint16_t);
+        *(uint16_t*)Buffer = QuicLibraryGetSettings()->LoadBalancingMode;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_PERF_COUNTERS: {
+
+        if (*BufferLength < sizeof(int64_t)) {
+            *BufferLength = sizeof(int64_t) * QUIC_PERF_COUNTER_MAX;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (*BufferLength < QUIC_PERF_COUNTER_MAX * sizeof(int64_t)) {
+            //
+            // Copy as many counters will fit completely in the buffer.
+            //
+            *BufferLength = (*BufferLength / sizeof(int64_t)) * sizeof(int64_t);
+        } else {
+            *BufferLength = QUIC_PERF_COUNTER_MAX * sizeof(int64_t);
+        }
+
+        QuicLibrarySumPerfCounters(Buffer, *BufferLength);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_RECV_DROP_COUNTERS: {
+
+        if (*BufferLength < sizeof(int64_t)) {
+            *BufferLength = sizeof(int64_t) * QUIC_RECV_DROP_REASON_COUNT;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        //
+        // Copy as many counters will fit completely in the buffer.
+        //
+        const uint32_t CounterCount =
+            CXPLAT_MIN(*BufferLength / sizeof(int64_t), QUIC_RECV_DROP_REASON_COUNT);
+        *BufferLength = CounterCount * sizeof(int64_t);
+
+        int64_t* Counters = (int64_t*)Buffer;
+        CxPlatZeroMemory(Counters, *BufferLength);
+        for (uint32_t i = 0; MsQuicLib.Partitions != NULL && i < MsQuicLib.PartitionCount; ++i) {
+            for (uint32_t j = 0; j < CounterCount; ++j) {
+                Counters[j] += MsQuicLib.Partitions[i].RecvDropCounters[j];
+            }
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_SETTINGS:
+
+        Status = QuicSettingsGetSettings(QuicLibraryGetSettings(), BufferLength, (QUIC_SETTINGS*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_VERSION_SETTINGS:
+
+        Status = QuicSettingsGetVersionSettings(QuicLibraryGetSettings(), BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_GLOBAL_SETTINGS:
+
+        Status = QuicSettingsGetGlobalSettings(QuicLibraryGetSettings(), BufferLength, (QUIC_GLOBAL_SETTINGS*)Buffer);
+        break;
+
+    case QUIC_PARAM_GLOBAL_LIBRARY_VERSION:
+
+        if (*BufferLength < sizeof(MsQuicLib.Version)) {
+            *BufferLength = sizeof(MsQuicLib.Version);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(MsQuicLib.Version);
+        CxPlatCopyMemory(Buffer, MsQuicLib.Version, sizeof(MsQuicLib.Version));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_LIBRARY_GIT_HASH:
+
+        GitHashLength = (uint32_t)strlen(MsQuicLib.GitHash) + 1;
+
+        if (*BufferLength < GitHashLength) {
+            *BufferLength = GitHashLength;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = GitHashLength;
+        CxPlatCopyMemory(Buffer, MsQuicLib.GitHash, GitHashLength);
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_EXECUTION_CONFIG: {
+        if (MsQuicLib.ExecutionConfig == NULL) {
+            *BufferLength = 0;
+            Status = QUIC_STATUS_SUCCESS;
+            break;
+        }
+
+        const uint32_t ConfigLength =
+            QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE +
+            sizeof(uint16_t) * MsQuicLib.ExecutionConfig->ProcessorCount;
+        const uint32_t NumaLength =
+            (uint32_t)QUIC_GLOBAL_EXECUTION_CONFIG_NUMA_SIZE(
+                MsQuicLib.ExecutionConfig->ProcessorCount);
+
+        if (*BufferLength < ConfigLength) {
+            *BufferLength = NumaLength;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        CxPlatCopyMemory(Buffer, MsQuicLib.ExecutionConfig, ConfigLength);
+        if (*BufferLength >= NumaLength) {
+            //
+            // Append the NUMA node mapping of the processor list.
+            //
+            QUIC_GLOBAL_EXECUTION_CONFIG* Config = (QUIC_GLOBAL_EXECUTION_CONFIG*)Buffer;
+            uint16_t* NumaNodes = QUIC_GLOBAL_EXECUTION_CONFIG_NUMA_NODES(Config);
+            for (uint32_t i = 0; i < Config->ProcessorCount; ++i) {
+                NumaNodes[i] = CxPlatProcNumaNode(Config->ProcessorList[i]);
+            }
+            *BufferLength = NumaLength;
+        } else {
+            *BufferLength = ConfigLength;
+        }
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_TLS_PROVIDER:
+
+        if (*BufferLength < sizeof(QUIC_TLS_PROVIDER)) {
+            *BufferLength = sizeof(QUIC_TLS_PROVIDER);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_TLS_PROVIDER);
+        *(QUIC_TLS_PROVIDER*)Buffer = CxPlatTlsGetProvider();
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_FEATURES: {
+        if (*BufferLength < sizeof(uint32_t)) {
+            *BufferLength = sizeof(uint32_t);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.Datapath == NULL) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        *BufferLength = sizeof(uint32_t);
+        *(uint32_t*)Buffer = QuicLibraryGetDatapathFeatures();
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_XDP_QUEUES: {
+        if (MsQuicLib.Datapath == NULL) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        uint32_t QueueCount = *BufferLength / sizeof(QUIC_XDP_QUEUE_INFO);
+        Status =
+            CxPlatDataPathGetXdpQueueInfo(
+                MsQuicLib.Datapath,
+                &QueueCount,
+                (QUIC_XDP_QUEUE_INFO*)Buffer);
+        *BufferLength = QueueCount * sizeof(QUIC_XDP_QUEUE_INFO);
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_STATISTICS: {
+
+        if (*BufferLength < sizeof(QUIC_DATAPATH_STATISTICS)) {
+            *BufferLength = sizeof(QUIC_DATAPATH_STATISTICS);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        if (MsQuicLib.Datapath == NULL) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        CXPLAT_DATAPATH_STATISTICS DatapathStats;
+        CxPlatDataPathGetStatistics(MsQuicLib.Datapath, &DatapathStats);
+
+        QUIC_DATAPATH_STATISTICS* Stats = (QUIC_DATAPATH_STATISTICS*)Buffer;
+        *BufferLength = sizeof(QUIC_DATAPATH_STATISTICS);
+        CxPlatZeroMemory(Stats, sizeof(*Stats));
+        Stats->RecvCalls = DatapathStats.RecvCallCount;
+        Stats->RecvMessages = DatapathStats.RecvMessageCount;
+        if (DatapathStats.RecvCallCount != 0) {
+            Stats->RecvBatchSizeAvg =
+                (uint32_t)(DatapathStats.RecvMessageCount / DatapathStats.RecvCallCount);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_GLOBAL_DATAPATH_XDP_TX_COMPLETION:
+
+        if (*BufferLength < sizeof(QUIC_XDP_TX_COMPLETION_CONFIG)) {
+            *BufferLength = sizeof(QUIC_XDP_TX_COMPLETION_CONFIG);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(QUIC_XDP_TX_COMPLETION_CONFIG);
+        CxPlatCopyMemory(
+            Buffer,
+            &MsQuicLib.XdpTxCompletion,
+            sizeof(QUIC_XDP_TX_COMPLETION_CONFIG));
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_VERSION_NEGOTIATION_ENABLED:
+
+        if (*BufferLength < sizeof(BOOLEAN)) {
+            *BufferLength = sizeof(BOOLEAN);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(BOOLEAN);
+        *(BOOLEAN*)Buffer = QuicLibraryGetSettings()->VersionNegotiationExtEnabled;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_IN_USE:
+
+        if (*BufferLength < sizeof(BOOLEAN)) {
+            *BufferLength = sizeof(BOOLEAN);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *BufferLength = sizeof(BOOLEAN);
+        *(BOOLEAN*)Buffer = MsQuicLib.InUse;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+    case QUIC_PARAM_GLOBAL_PLATFORM_WORKER_POOL:
+
+        if (*BufferLength != sizeof(CXPLAT_WORKER_POOL*)) {
+            *BufferLength = sizeof(CXPLAT_WORKER_POOL*);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        *(CXPLAT_WORKER_POOL**)Buffer = MsQuicLib.WorkerPool;
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
+#ifndef _KERNEL_MODE
+    case QUIC_PARAM_GLOBAL_WORKER_POLL_STATISTICS: {
+        if (MsQuicLib.WorkerPool == NULL) {
+            Status = QUIC_STATUS_INVALID_STATE;
+            break;
+        }
+
+        const uint32_t WorkerCount = CxPlatWorkerPoolGetCount(MsQuicLib.WorkerPool);
+        if (*BufferLength < WorkerCount * sizeof(QUIC_WORKER_POLL_STATISTICS)) {
+            *BufferLength = WorkerCount * sizeof(QUIC_WORKER_POLL_STATISTICS);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1374,16 +2786,21 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(MsQuicLib.Settings.RetryMemoryLimit);
-        *(uint16_t*)Buffer = MsQuicLib.Settings.RetryMemoryLimit;
+        QUIC_WORKER_POLL_STATISTICS* Statistics = (QUIC_WORKER_POLL_STATISTICS*)Buffer;
+        for (uint32_t i = 0; i < WorkerCount; ++i) {
+            CxPlatWorkerPoolGetPollStatistics(MsQuicLib.WorkerPool, i, &Statistics[i]);
+        }
+        *BufferLength = WorkerCount * sizeof(QUIC_WORKER_POLL_STATISTICS);
 
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_SUPPORTED_VERSIONS:
-
-        if (*BufferLength < sizeof(QuicSupportedVersionList)) {
-            *BufferLength = sizeof(QuicSupportedVersionList);
+    case QUIC_PARAM_GLOBAL_WORKER_LATENCY_HISTOGRAMS: {
+        const uint32_t HistogramsLength =
+            QUIC_WORKER_LATENCY_COUNT * sizeof(QUIC_LATENCY_HISTOGRAM);
+        if (*BufferLength < HistogramsLength) {
+            *BufferLength = HistogramsLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1393,38 +2810,62 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(QuicSupportedVersionList);
-        CxPlatCopyMemory(
-            Buffer,
-            QuicSupportedVersionList,
-            sizeof(QuicSupportedVersionList));
+        CxPlatZeroMemory(Buffer, HistogramsLength);
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        for (CXPLAT_LIST_ENTRY* Link = MsQuicLib.Registrations.Flink;
+            Link != &MsQuicLib.Registrations;
+            Link = Link->Flink) {
+            QUIC_REGISTRATION* Registration =
+                CXPLAT_CONTAINING_RECORD(Link, QUIC_REGISTRATION, Link);
+            if (Registration->WorkerPool != NULL) {
+                QuicWorkerPoolSumLatencyHistograms(
+                    Registration->WorkerPool, (QUIC_LATENCY_HISTOGRAM*)Buffer);
+            }
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        *BufferLength = HistogramsLength;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
+#endif
 
-    case QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE:
-
-        if (*BufferLength < sizeof(uint16_t)) {
-            *BufferLength = sizeof(uint16_t);
+    case QUIC_PARAM_GLOBAL_ALLOCATION_STATISTICS: {
+        const uint32_t TagCount = CxPlatAllocTelemetryGetTagCount();
+        if (*BufferLength < TagCount * sizeof(QUIC_ALLOCATION_STATISTICS)) {
+            *BufferLength = TagCount * sizeof(QUIC_ALLOCATION_STATISTICS);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
 
-        if (Buffer == NULL) {
+        if (Buffer == NULL && TagCount != 0) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
-        *BufferLength = sizeof(uint16_t);
-        *(uint16_t*)Buffer = MsQuicLib.Settings.LoadBalancingMode;
+        QUIC_ALLOCATION_STATISTICS* Statistics = (QUIC_ALLOCATION_STATISTICS*)Buffer;
+        for (uint32_t i = 0; i < TagCount; ++i) {
+            CXPLAT_ALLOC_TAG_STATS TagStats;
+            CxPlatAllocTelemetryGetTag(i, &TagStats);
+            Statistics[i].Tag = TagStats.Tag;
+            Statistics[i].AllocationsPerSecond = TagStats.AllocationsPerSecond;
+            Statistics[i].LiveBytes = TagStats.LiveBytes;
+            Statistics[i].PeakBytes = TagStats.PeakBytes;
+            Statistics[i].TotalAllocations = TagStats.TotalAllocations;
+        }
+        *BufferLength = TagCount * sizeof(QUIC_ALLOCATION_STATISTICS);
 
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_PERF_COUNTERS: {
-
-        if (*BufferLength < sizeof(int64_t)) {
-            *BufferLength = sizeof(int64_t) * QUIC_PERF_COUNTER_MAX;
+#ifndef _KERNEL_MODE
+    case QUIC_PARAM_GLOBAL_RECV_POOL_POLICY: {
+        const uint32_t PoliciesLength =
+            QUIC_RECV_CHUNK_POOL_COUNT * sizeof(QUIC_POOL_POLICY);
+        if (*BufferLength < PoliciesLength) {
+            *BufferLength = PoliciesLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1434,40 +2875,34 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        if (*BufferLength < QUIC_PERF_COUNTER_MAX * sizeof(int64_t)) {
-            //
-            // Copy as many counters will fit completely in the buffer.
-            //
-            *BufferLength = (*BufferLength / sizeof(int64_t)) * sizeof(int64_t);
-        } else {
-            *BufferLength = QUIC_PERF_COUNTER_MAX * sizeof(int64_t);
+        QUIC_POOL_POLICY* Policies = (QUIC_POOL_POLICY*)Buffer;
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+            if (MsQuicLib.RecvChunkPoolPoliciesSet) {
+                const CXPLAT_POOL_EX_POLICY* Policy = &MsQuicLib.RecvChunkPoolPolicies[i];
+                Policies[i].LowWatermark = Policy->LowWatermark;
+                Policies[i].HighWatermark = Policy->HighWatermark;
+                Policies[i].PruneCount = Policy->PruneCount;
+                Policies[i].DecayPercent = Policy->DecayPercent;
+            } else {
+                Policies[i].LowWatermark = 0;
+                Policies[i].HighWatermark = UINT32_MAX;
+                Policies[i].PruneCount = CXPLAT_POOL_EX_DEFAULT_PRUNE_COUNT;
+                Policies[i].DecayPercent = 0;
+            }
         }
-
-        QuicLibrarySumPerfCounters(Buffer, *BufferLength);
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        *BufferLength = PoliciesLength;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
     }
 
-    case QUIC_PARAM_GLOBAL_SETTINGS:
-
-        Status = QuicSettingsGetSettings(&MsQuicLib.Settings, BufferLength, (QUIC_SETTINGS*)Buffer);
-        break;
-
-    case QUIC_PARAM_GLOBAL_VERSION_SETTINGS:
-
-        Status = QuicSettingsGetVersionSettings(&MsQuicLib.Settings, BufferLength, (QUIC_VERSION_SETTINGS*)Buffer);
-        break;
-
-    case QUIC_PARAM_GLOBAL_GLOBAL_SETTINGS:
-
-        Status = QuicSettingsGetGlobalSettings(&MsQuicLib.Settings, BufferLength, (QUIC_GLOBAL_SETTINGS*)Buffer);
-        break;
-
-    case QUIC_PARAM_GLOBAL_LIBRARY_VERSION:
-
-        if (*BufferLength < sizeof(MsQuicLib.Version)) {
-            *BufferLength = sizeof(MsQuicLib.Version);
+    case QUIC_PARAM_GLOBAL_RECV_POOL_STATISTICS: {
+        const uint32_t StatisticsLength =
+            QUIC_RECV_CHUNK_POOL_COUNT * sizeof(QUIC_POOL_STATISTICS);
+        if (*BufferLength < StatisticsLength) {
+            *BufferLength = StatisticsLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1477,46 +2912,119 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(MsQuicLib.Version);
-        CxPlatCopyMemory(Buffer, MsQuicLib.Version, sizeof(MsQuicLib.Version));
+        QUIC_POOL_STATISTICS* Statistics = (QUIC_POOL_STATISTICS*)Buffer;
+        CxPlatZeroMemory(Statistics, StatisticsLength);
+        for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+            Statistics[i].EntrySize = 1UL << (QUIC_RECV_CHUNK_POOL_MIN_SHIFT + i);
+        }
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        if (MsQuicLib.LazyInitComplete) {
+            for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+                QuicPartitionAddRecvChunkPoolStats(&MsQuicLib.Partitions[i], Statistics);
+            }
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        *BufferLength = StatisticsLength;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
+#endif
 
-    case QUIC_PARAM_GLOBAL_LIBRARY_GIT_HASH:
+    case QUIC_PARAM_GLOBAL_PERSISTENT_CACHE_PATH: {
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        const char* Path = MsQuicLib.PersistentCache.Path;
+        const uint32_t PathLength = Path == NULL ? 0 : (uint32_t)strlen(Path) + 1;
+        if (*BufferLength < PathLength) {
+            *BufferLength = PathLength;
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+        } else if (PathLength != 0 && Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+        } else {
+            if (PathLength != 0) {
+                CxPlatCopyMemory(Buffer, Path, PathLength);
+            }
+            *BufferLength = PathLength;
+            Status = QUIC_STATUS_SUCCESS;
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        break;
+    }
 
-        GitHashLength = (uint32_t)strlen(MsQuicLib.GitHash) + 1;
+    case QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT: {
+        CxPlatLockAcquire(&MsQuicLib.Lock);
 
-        if (*BufferLength < GitHashLength) {
-            *BufferLength = GitHashLength;
+        const uint32_t PartitionCount =
+            MsQuicLib.Partitions == NULL ? 0 : MsQuicLib.PartitionCount;
+        uint32_t WorkerCount = 0;
+        for (CXPLAT_LIST_ENTRY* Link = MsQuicLib.Registrations.Flink;
+            Link != &MsQuicLib.Registrations;
+            Link = Link->Flink) {
+            QUIC_REGISTRATION* Registration =
+                CXPLAT_CONTAINING_RECORD(Link, QUIC_REGISTRATION, Link);
+            if (Registration->WorkerPool != NULL) {
+                WorkerCount += Registration->WorkerPool->WorkerCount;
+            }
+        }
+
+        const uint32_t SnapshotLength =
+            sizeof(QUIC_METRICS_SNAPSHOT) +
+            PartitionCount * sizeof(QUIC_PARTITION_METRICS) +
+            WorkerCount * sizeof(QUIC_WORKER_METRICS);
+        if (*BufferLength < SnapshotLength) {
+            CxPlatLockRelease(&MsQuicLib.Lock);
+            *BufferLength = SnapshotLength;
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
 
         if (Buffer == NULL) {
+            CxPlatLockRelease(&MsQuicLib.Lock);
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
 
-        *BufferLength = GitHashLength;
-        CxPlatCopyMemory(Buffer, MsQuicLib.GitHash, GitHashLength);
+        QUIC_METRICS_SNAPSHOT* Snapshot = (QUIC_METRICS_SNAPSHOT*)Buffer;
+        Snapshot->TimeUs = CxPlatTimeUs64();
+        Snapshot->PartitionCount = PartitionCount;
+        Snapshot->WorkerCount = WorkerCount;
+
+        QUIC_PARTITION_METRICS* PartitionMetrics = (QUIC_PARTITION_METRICS*)(Snapshot + 1);
+        for (uint32_t i = 0; i < PartitionCount; ++i) {
+            CxPlatCopyMemory(
+                PartitionMetrics[i].PerfCounters,
+                MsQuicLib.Partitions[i].PerfCounters,
+                sizeof(PartitionMetrics[i].PerfCounters));
+            CxPlatCopyMemory(
+                PartitionMetrics[i].RecvDropCounters,
+                MsQuicLib.Partitions[i].RecvDropCounters,
+                sizeof(PartitionMetrics[i].RecvDropCounters));
+        }
+
+        QUIC_WORKER_METRICS* WorkerMetrics =
+            (QUIC_WORKER_METRICS*)(PartitionMetrics + PartitionCount);
+        for (CXPLAT_LIST_ENTRY* Link = MsQuicLib.Registrations.Flink;
+            Link != &MsQuicLib.Registrations;
+            Link = Link->Flink) {
+            QUIC_REGISTRATION* Registration =
+                CXPLAT_CONTAINING_RECORD(Link, QUIC_REGISTRATION, Link);
+            if (Registration->WorkerPool != NULL) {
+                QuicWorkerPoolGetMetrics(Registration->WorkerPool, WorkerMetrics);
+                WorkerMetrics += Registration->WorkerPool->WorkerCount;
+            }
+        }
+
+        CxPlatLockRelease(&MsQuicLib.Lock);
+        *BufferLength = SnapshotLength;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_EXECUTION_CONFIG: {
-        if (MsQuicLib.ExecutionConfig == NULL) {
-            *BufferLength = 0;
-            Status = QUIC_STATUS_SUCCESS;
-            break;
-        }
-
-        const uint32_t ConfigLength =
-            QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE +
-            sizeof(uint16_t) * MsQuicLib.ExecutionConfig->ProcessorCount;
+    case QUIC_PARAM_GLOBAL_SLOW_CALLBACK_THRESHOLD:
 
-        if (*BufferLength < ConfigLength) {
-            *BufferLength = ConfigLength;
+        if (*BufferLength < sizeof(uint32_t)) {
+            *BufferLength = sizeof(uint32_t);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1526,16 +3034,16 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = ConfigLength;
-        CxPlatCopyMemory(Buffer, MsQuicLib.ExecutionConfig, ConfigLength);
+        *BufferLength = sizeof(uint32_t);
+        *(uint32_t*)Buffer = MsQuicLib.SlowCallbackThresholdUs;
+
         Status = QUIC_STATUS_SUCCESS;
         break;
-    }
 
-    case QUIC_PARAM_GLOBAL_TLS_PROVIDER:
+    case QUIC_PARAM_GLOBAL_PREWARM_CONFIG:
 
-        if (*BufferLength < sizeof(QUIC_TLS_PROVIDER)) {
-            *BufferLength = sizeof(QUIC_TLS_PROVIDER);
+        if (*BufferLength < sizeof(QUIC_PREWARM_CONFIG)) {
+            *BufferLength = sizeof(QUIC_PREWARM_CONFIG);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1545,15 +3053,16 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(QUIC_TLS_PROVIDER);
-        *(QUIC_TLS_PROVIDER*)Buffer = CxPlatTlsGetProvider();
+        *BufferLength = sizeof(QUIC_PREWARM_CONFIG);
+        *(QUIC_PREWARM_CONFIG*)Buffer = MsQuicLib.PrewarmConfig;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
 
-    case QUIC_PARAM_GLOBAL_DATAPATH_FEATURES: {
-        if (*BufferLength < sizeof(uint32_t)) {
-            *BufferLength = sizeof(uint32_t);
+    case QUIC_PARAM_GLOBAL_INITIAL_FILTER_CONFIG:
+
+        if (*BufferLength < sizeof(QUIC_INITIAL_FILTER_CONFIG)) {
+            *BufferLength = sizeof(QUIC_INITIAL_FILTER_CONFIG);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1563,22 +3072,16 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        if (MsQuicLib.Datapath == NULL) {
-            Status = QUIC_STATUS_INVALID_STATE;
-            break;
-        }
-
-        *BufferLength = sizeof(uint32_t);
-        *(uint32_t*)Buffer = QuicLibraryGetDatapathFeatures();
+        *BufferLength = sizeof(QUIC_INITIAL_FILTER_CONFIG);
+        *(QUIC_INITIAL_FILTER_CONFIG*)Buffer = MsQuicLib.InitialFilterConfig;
 
         Status = QUIC_STATUS_SUCCESS;
         break;
-    }
 
-    case QUIC_PARAM_GLOBAL_VERSION_NEGOTIATION_ENABLED:
+    case QUIC_PARAM_GLOBAL_SLOW_CALLBACK_STATISTICS: {
 
-        if (*BufferLength < sizeof(BOOLEAN)) {
-            *BufferLength = sizeof(BOOLEAN);
+        if (*BufferLength < sizeof(QUIC_SLOW_CALLBACK_STATISTICS)) {
+            *BufferLength = sizeof(QUIC_SLOW_CALLBACK_STATISTICS);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1588,16 +3091,31 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(BOOLEAN);
-        *(BOOLEAN*)Buffer = MsQuicLib.Settings.VersionNegotiationExtEnabled;
+        *BufferLength = sizeof(QUIC_SLOW_CALLBACK_STATISTICS);
+        QUIC_SLOW_CALLBACK_STATISTICS* Stats = (QUIC_SLOW_CALLBACK_STATISTICS*)Buffer;
+        CxPlatZeroMemory(Stats, sizeof(*Stats));
+
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        for (uint32_t i = 0; MsQuicLib.Partitions != NULL && i < MsQuicLib.PartitionCount; ++i) {
+            const QUIC_SLOW_CALLBACK_STATISTICS* Partition =
+                &MsQuicLib.Partitions[i].SlowCallbacks;
+            Stats->MaxDurationUs = CXPLAT_MAX(Stats->MaxDurationUs, Partition->MaxDurationUs);
+            for (uint32_t j = 0; j < QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES; ++j) {
+                Stats->Listener[j] += Partition->Listener[j];
+                Stats->Connection[j] += Partition->Connection[j];
+                Stats->Stream[j] += Partition->Stream[j];
+            }
+        }
+        CxPlatLockRelease(&MsQuicLib.Lock);
 
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
-    case QUIC_PARAM_GLOBAL_IN_USE:
+    case QUIC_PARAM_GLOBAL_QLOG_CONFIG:
 
-        if (*BufferLength < sizeof(BOOLEAN)) {
-            *BufferLength = sizeof(BOOLEAN);
+        if (*BufferLength < sizeof(QUIC_QLOG_CONFIG)) {
+            *BufferLength = sizeof(QUIC_QLOG_CONFIG);
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
@@ -1607,29 +3125,40 @@ QuicLibraryGetGlobalParam(
             break;
         }
 
-        *BufferLength = sizeof(BOOLEAN);
-        *(BOOLEAN*)Buffer = MsQuicLib.InUse;
+        *BufferLength = sizeof(QUIC_QLOG_CONFIG);
+        CxPlatLockAcquire(&MsQuicLib.Lock);
+        *(QUIC_QLOG_CONFIG*)Buffer = MsQuicLib.QlogConfig;
+        CxPlatLockRelease(&MsQuicLib.Lock);
 
         Status = QUIC_STATUS_SUCCESS;
         break;
 
-    case QUIC_PARAM_GLOBAL_PLATFORM_WORKER_POOL:
-
-        if (*BufferLength != sizeof(CXPLAT_WORKER_POOL*)) {
-            *BufferLength = sizeof(CXPLAT_WORKER_POOL*);
+    case QUIC_PARAM_GLOBAL_OBJECT_SIZES: {
+        static const uint32_t ObjectSizes[QUIC_OBJECT_SIZE_COUNT] = {
+            sizeof(QUIC_CONNECTION),
+            sizeof(QUIC_CONN_HANDSHAKE_STATE),
+            sizeof(QUIC_STREAM),
+            sizeof(QUIC_PATH),
+            sizeof(QUIC_PACKET_SPACE),
+            sizeof(QUIC_TRANSPORT_PARAMETERS)
+        };
+        uint32_t MaxSizes = *BufferLength / sizeof(uint32_t);
+        if (MaxSizes == 0) {
+            *BufferLength = sizeof(ObjectSizes); // Indicate the max size.
             Status = QUIC_STATUS_BUFFER_TOO_SMALL;
             break;
         }
-
         if (Buffer == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
             break;
         }
-
-        *(CXPLAT_WORKER_POOL**)Buffer = MsQuicLib.WorkerPool;
-
+        const uint32_t ToCopy =
+            CXPLAT_MIN(MaxSizes, QUIC_OBJECT_SIZE_COUNT) * sizeof(uint32_t);
+        CxPlatCopyMemory(Buffer, ObjectSizes, ToCopy);
+        *BufferLength = ToCopy;
         Status = QUIC_STATUS_SUCCESS;
         break;
+    }
 
     case QUIC_PARAM_GLOBAL_STATISTICS_V2_SIZES: {
         static const uint32_t StatSizes[] = {
@@ -1810,6 +3339,8 @@ QuicLibrarySetParam(
     case QUIC_PARAM_PREFIX_TLS_SCHANNEL:
         if (Connection == NULL || Connection->Crypto.TLS == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
+        } else if (Connection->Crypto.Offload != NULL) {
+            Status = QUIC_STATUS_INVALID_STATE; // TLS is in use on an offload thread.
         } else {
             Status = CxPlatTlsParamSet(Connection->Crypto.TLS, Param, BufferLength, Buffer);
         }
@@ -1944,7 +3475,8 @@ QuicLibraryGetParam(
     case QUIC_PARAM_PREFIX_TLS_SCHANNEL:
         if (Connection == NULL) {
             Status = QUIC_STATUS_INVALID_PARAMETER;
-        } else if (Connection->Crypto.TLS == NULL) {
+        } else if (Connection->Crypto.TLS == NULL ||
+                   Connection->Crypto.Offload != NULL) {
             Status = QUIC_STATUS_INVALID_STATE;
         } else {
             Status = CxPlatTlsParamGet(Connection->Crypto.TLS, Param, BufferLength, Buffer);
@@ -2039,6 +3571,8 @@ MsQuicOpenVersion(
     Api->StreamClose = MsQuicStreamClose;
     Api->StreamShutdown = MsQuicStreamShutdown;
     Api->StreamStart = MsQuicStreamStart;
+    Api->StreamStartBatch = MsQuicStreamStartBatch;
+    Api->DatagramSendBatch = MsQuicDatagramSendBatch;
     Api->StreamSend = MsQuicStreamSend;
     Api->StreamReceiveComplete = MsQuicStreamReceiveComplete;
     Api->StreamReceiveSetEnabled = MsQuicStreamReceiveSetEnabled;
@@ -2055,6 +3589,15 @@ MsQuicOpenVersion(
     Api->RegistrationClose2 = MsQuicRegistrationClose2;
 
     Api->ConnectionPoolCreate = MsQuicConnectionPoolCreate;
+    Api->ConnectionPoolOpen = MsQuicConnectionPoolOpen;
+    Api->ConnectionPoolClose = MsQuicConnectionPoolClose;
+    Api->ConnectionPoolAcquire = MsQuicConnectionPoolAcquire;
+    Api->ConnectionPoolRelease = MsQuicConnectionPoolRelease;
+
+    Api->ConnectionSetConfigurationBatch = MsQuicConnectionSetConfigurationBatch;
+    Api->ConnectionExecute = MsQuicConnectionExecute;
+    Api->StreamSendBatch = MsQuicStreamSendBatch;
+    Api->StreamSendFile = MsQuicStreamSendFile;
 
     *QuicApi = Api;
 
@@ -2467,6 +4010,34 @@ QuicLibraryOnHandshakeConnectionAdded(
         (int64_t*)&MsQuicLib.CurrentHandshakeMemoryUsage,
         (int64_t)QUIC_CONN_HANDSHAKE_MEMORY_USAGE);
     QuicLibraryEvaluateSendRetryState();
+    QuicLibraryEvaluateMemoryPressure();
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryOnSlowCallback(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_CALLBACK_TYPE Type,
+    _In_ uint32_t EventType,
+    _In_ uint64_t DurationUs
+    )
+{
+    QUIC_SLOW_CALLBACK_STATISTICS* Stats = &Partition->SlowCallbacks;
+    uint64_t* Counts =
+        Type == QUIC_CALLBACK_LISTENER ? Stats->Listener :
+        Type == QUIC_CALLBACK_CONNECTION ? Stats->Connection : Stats->Stream;
+    if (EventType < QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES) {
+        InterlockedIncrement64((int64_t*)&Counts[EventType]);
+    }
+
+    //
+    // Racing updates may keep a slightly smaller maximum, which is fine.
+    //
+    if (DurationUs > Stats->MaxDurationUs) {
+        Stats->MaxDurationUs = DurationUs;
+    }
+
+    QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_APP_CALLBACK_SLOW);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -2481,6 +4052,62 @@ QuicLibraryOnHandshakeConnectionRemoved(
     QuicLibraryEvaluateSendRetryState();
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryEvaluateMemoryPressure(
+    void
+    )
+{
+    static const uint8_t StartPercent[QUIC_MEMORY_PRESSURE_COUNT] = {
+        0,
+        QUIC_MEMORY_PRESSURE_SHRINK_RECV_PERCENT,
+        QUIC_MEMORY_PRESSURE_LIMIT_SEND_PERCENT,
+        QUIC_MEMORY_PRESSURE_REJECT_PERCENT
+    };
+
+    if (MsQuicLib.MemoryLimit == 0) {
+        return;
+    }
+
+    QuicLibraryRefreshSendBufferMemoryUsage();
+
+    //
+    // Estimate: per-connection state plus all the tracked buffer memory.
+    //
+    const long ConnectionCount = MsQuicLib.ConnectionCount;
+    const uint64_t Usage =
+        (uint64_t)CXPLAT_MAX(ConnectionCount, 0) * sizeof(QUIC_CONNECTION) +
+        MsQuicLib.CurrentHandshakeMemoryUsage +
+        MsQuicLib.CurrentSendBufferMemoryUsage +
+        MsQuicLib.CurrentRecvBufferMemoryUsage;
+
+    const long Current = MsQuicLib.MemoryPressure;
+    long New = QUIC_MEMORY_PRESSURE_NONE;
+    for (long Stage = QUIC_MEMORY_PRESSURE_COUNT - 1; Stage > QUIC_MEMORY_PRESSURE_NONE; --Stage) {
+        uint64_t Percent = StartPercent[Stage];
+        if (Stage <= Current) {
+            Percent -= QUIC_MEMORY_PRESSURE_HYSTERESIS_PERCENT;
+        }
+        if (Usage * 100 >= MsQuicLib.MemoryLimit * Percent) {
+            New = Stage;
+            break;
+        }
+    }
+
+    if (New != Current &&
+        InterlockedCompareExchange(&MsQuicLib.MemoryPressure, New, Current) == Current &&
+        MsQuicLib.Partitions != NULL) {
+        //
+        // The stage gauge is kept on the first partition only, so that the
+        // summed counter is the stage itself.
+        //
+        QuicPerfCounterAdd(
+            &MsQuicLib.Partitions[0],
+            QUIC_PERF_COUNTER_MEMORY_PRESSURE,
+            (int64_t)New - (int64_t)Current);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLibraryEvaluateSendRetryState(
@@ -2523,15 +4150,15 @@ QuicLibraryGenerateStatelessResetToken(
     )
 {
     uint8_t HashOutput[CXPLAT_HASH_SHA256_SIZE];
-    CxPlatLockAcquire(&Partition->ResetTokenLock);
+    QUIC_RESET_TOKEN_HASH* Entry = QuicPartitionAcquireResetTokenHash(Partition);
     QUIC_STATUS Status =
         CxPlatHashCompute(
-            Partition->ResetTokenHash,
+            Entry->Hash,
             CID,
             MsQuicLib.CidTotalLength,
             sizeof(HashOutput),
             HashOutput);
-    CxPlatLockRelease(&Partition->ResetTokenLock);
+    QuicPartitionReleaseResetTokenHash(Entry);
     if (QUIC_SUCCEEDED(Status)) {
         CxPlatCopyMemory(
             ResetToken,
@@ -2619,6 +4246,97 @@ MsQuicExecutionPoll(
 
 #endif
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryRefreshSendBufferMemoryUsage(
+    void
+    )
+{
+    if (MsQuicLib.Partitions == NULL) {
+        return;
+    }
+    int64_t Usage = 0;
+    for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+        Usage += MsQuicLib.Partitions[i].SendBufferMemoryUsage;
+    }
+    MsQuicLib.CurrentSendBufferMemoryUsage = (uint64_t)CXPLAT_MAX(Usage, 0);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryRetire(
+    _In_ QUIC_RETIRED_OBJECT* Objects
+    )
+{
+    QUIC_RETIRED_OBJECT* Last = Objects;
+    int64_t Count = 1;
+    while (Last->Next != NULL) {
+        Last = Last->Next;
+        Count++;
+    }
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.ReadSectionSyncLock);
+    Last->Next = MsQuicLib.RetiredObjects[0];
+    MsQuicLib.RetiredObjects[0] = Objects;
+    CxPlatDispatchLockRelease(&MsQuicLib.ReadSectionSyncLock);
+
+    InterlockedExchangeAdd64(&MsQuicLib.RetiredObjectCount, Count);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryReclaim(
+    _In_ BOOLEAN Wait
+    )
+{
+    do {
+        QUIC_RETIRED_OBJECT* Expired = NULL;
+        BOOLEAN Drained = TRUE;
+
+        //
+        // Each step first checks that every reader of the epoch before the
+        // current one has exited, and then moves the retired objects one stage
+        // on and flips the epoch. A reader may sample the epoch just before a
+        // flip and only count itself against it after, so an object is only
+        // freed once it has seen QUIC_RECLAIM_STAGES steps, by which point
+        // both epochs have drained since it was unlinked.
+        //
+        CxPlatDispatchLockAcquire(&MsQuicLib.ReadSectionSyncLock);
+        const uint32_t PrevEpoch = (uint32_t)(MsQuicLib.ReadSectionEpoch - 1) & 1;
+        for (uint16_t i = 0; i < MsQuicLib.PartitionCount; ++i) {
+            if (InterlockedCompareExchange(
+                    &MsQuicLib.Partitions[i].ReadSections[PrevEpoch], 0, 0) != 0) {
+                Drained = FALSE;
+                break;
+            }
+        }
+        if (Drained) {
+            Expired = MsQuicLib.RetiredObjects[QUIC_RECLAIM_STAGES - 1];
+            for (uint32_t i = QUIC_RECLAIM_STAGES - 1; i > 0; --i) {
+                MsQuicLib.RetiredObjects[i] = MsQuicLib.RetiredObjects[i - 1];
+            }
+            MsQuicLib.RetiredObjects[0] = NULL;
+            InterlockedIncrement(&MsQuicLib.ReadSectionEpoch);
+        }
+        CxPlatDispatchLockRelease(&MsQuicLib.ReadSectionSyncLock);
+
+        int64_t Count = 0;
+        while (Expired != NULL) {
+            QUIC_RETIRED_OBJECT* Next = Expired->Next;
+            Expired->Free(Expired);
+            Expired = Next;
+            Count++;
+        }
+        if (Count != 0) {
+            InterlockedExchangeAdd64(&MsQuicLib.RetiredObjectCount, -Count);
+        }
+
+        if (Wait && !Drained) {
+            CxPlatSchedulerYield();
+        }
+    } while (Wait && MsQuicLib.RetiredObjectCount != 0);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicLibrarySetRetryKeyConfig(
@@ -19,7 +19,8 @@ typedef enum QUIC_HANDLE_TYPE {
     QUIC_HANDLE_TYPE_LISTENER,
     QUIC_HANDLE_TYPE_CONNECTION_CLIENT,
     QUIC_HANDLE_TYPE_CONNECTION_SERVER,
-    QUIC_HANDLE_TYPE_STREAM
+    QUIC_HANDLE_TYPE_STREAM,
+    QUIC_HANDLE_TYPE_CONNECTION_POOL
 
 } QUIC_HANDLE_TYPE;
 
@@ -59,9 +60,77 @@ typedef struct QUIC_DBG_OBJECT_TRACKER {
 
 #endif // DEBUG
 
+//
+// What earlier connections learned about the path to a destination. Zero
+// fields are unknown.
+//
+typedef struct QUIC_PATH_METRICS {
+
+    uint64_t SmoothedRtt; // microseconds
+    uint64_t MinRtt; // microseconds
+
+    //
+    // The congestion window the connection had actually filled (bytes), i.e.
+    // the achieved bandwidth times the RTT.
+    //
+    uint32_t CongestionWindow;
+
+    uint16_t Mtu;
+
+} QUIC_PATH_METRICS;
+
+typedef struct QUIC_PATH_METRICS_CACHE_ENTRY {
+
+    //
+    // The destination, as returned by QuicLibraryGetPathMetricsKey.
+    //
+    QUIC_ADDR RemoteAddress;
+
+    //
+    // When the entry was last written. Zero if the entry is unused.
+    //
+    uint64_t TimeUs;
+
+    QUIC_PATH_METRICS Metrics;
+
+    //
+    // Whether the entry changed since it was last written to the persistent
+    // cache.
+    //
+    BOOLEAN Dirty;
+
+} QUIC_PATH_METRICS_CACHE_ENTRY;
+
 //
 // Represents the storage for global library state.
 //
+//
+// The stages of the memory governor. Each stage includes the actions of the
+// ones before it.
+//
+typedef enum QUIC_MEMORY_PRESSURE {
+    QUIC_MEMORY_PRESSURE_NONE,
+    QUIC_MEMORY_PRESSURE_SHRINK_RECV_WINDOWS,   // Stop growing and shrink auto-tuned receive windows.
+    QUIC_MEMORY_PRESSURE_LIMIT_SEND_BUFFERING,  // Cut every connection's send buffering.
+    QUIC_MEMORY_PRESSURE_REJECT_CONNECTIONS,    // Refuse new connections.
+    QUIC_MEMORY_PRESSURE_COUNT
+} QUIC_MEMORY_PRESSURE;
+
+//
+// An immutable snapshot of the library's settings. Updates publish a new
+// snapshot instead of modifying the current one in place.
+//
+typedef struct QUIC_LIBRARY_SETTINGS {
+
+    //
+    // Link in the library's SettingsSnapshots list.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    QUIC_SETTINGS_INTERNAL Settings;
+
+} QUIC_LIBRARY_SETTINGS;
+
 typedef struct QUIC_LIBRARY {
 
     //
@@ -91,6 +160,24 @@ typedef struct QUIC_LIBRARY {
     //
     BOOLEAN EnableDscpOnRecv : 1;
 
+    //
+    // Whether the datapath will be initialized to capture kernel receive
+    // timestamps.
+    //
+    BOOLEAN EnableRecvTimestamps : 1;
+
+    //
+    // Whether the datapath will be initialized to offload pacing to the
+    // kernel, and whether it ended up being supported.
+    //
+    BOOLEAN EnableSendTxTime : 1;
+    BOOLEAN SendTxTimeSupported : 1;
+
+    //
+    // Whether the datapath supports send segmentation offload (GSO/USO).
+    //
+    BOOLEAN SendSegmentationSupported : 1;
+
 #ifdef CxPlatVerifierEnabled
     //
     // The app or driver verifier is globally enabled.
@@ -110,6 +197,11 @@ typedef struct QUIC_LIBRARY {
     //
     BOOLEAN SendRetryEnabled;
 
+    //
+    // How the XDP datapath reaps TX completions.
+    //
+    QUIC_XDP_TX_COMPLETION_CONFIG XdpTxCompletion;
+
     //
     // Current binary version.
     //
@@ -121,9 +213,21 @@ typedef struct QUIC_LIBRARY {
     const char* GitHash;
 
     //
-    // Configurable (app & registry) settings.
+    // Configurable (app & registry) settings. Points into the most recently
+    // published snapshot; read with QuicLibraryGetSettings.
     //
-    QUIC_SETTINGS_INTERNAL Settings;
+    QUIC_SETTINGS_INTERNAL* Settings;
+
+    //
+    // Serializes settings updates. Never held by readers.
+    //
+    CXPLAT_LOCK SettingsLock;
+
+    //
+    // Every settings snapshot published so far. Readers may hold on to any of
+    // them without a reference, so they are only freed on uninitialize.
+    //
+    CXPLAT_LIST_ENTRY SettingsSnapshots;
 
     //
     // Controls access to all non-datapath internal state of the library.
@@ -135,6 +239,20 @@ typedef struct QUIC_LIBRARY {
     //
     CXPLAT_DISPATCH_LOCK DatapathLock;
 
+    //
+    // Serializes grace periods for read sections (see QuicLibraryReadBegin),
+    // and the current epoch readers count themselves against.
+    //
+    CXPLAT_DISPATCH_LOCK ReadSectionSyncLock;
+    long volatile ReadSectionEpoch;
+
+    //
+    // Objects waiting for a grace period to end, by how many epoch flips
+    // they have seen (see QuicLibraryReclaim), and their total count.
+    //
+    QUIC_RETIRED_OBJECT* RetiredObjects[QUIC_RECLAIM_STAGES];
+    int64_t volatile RetiredObjectCount;
+
     //
     // Total outstanding references from calls to MsQuicLoadLibrary.
     //
@@ -156,12 +274,10 @@ typedef struct QUIC_LIBRARY {
     //
     uint16_t PartitionMask;
 
-#if DEBUG
     //
     // Number of connections current allocated.
     //
     long ConnectionCount;
-#endif
 
     //
     // Estimated timer resolution for the platform.
@@ -177,6 +293,22 @@ typedef struct QUIC_LIBRARY {
     _Field_range_(QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH, QUIC_CID_MAX_LENGTH)
     uint8_t CidTotalLength;
 
+    //
+    // The key used to encrypt CIDs in the QUIC-LB stream and block cipher
+    // modes. Either set by the app or randomly generated.
+    //
+    uint8_t LoadBalancingKey[QUIC_LOAD_BALANCING_KEY_LENGTH];
+    BOOLEAN LoadBalancingKeySet;
+
+#ifndef _KERNEL_MODE
+    //
+    // The trimming policies for the partitions' receive chunk pools, if set by
+    // the app. Otherwise the platform default applies.
+    //
+    CXPLAT_POOL_EX_POLICY RecvChunkPoolPolicies[QUIC_RECV_CHUNK_POOL_COUNT];
+    BOOLEAN RecvChunkPoolPoliciesSet;
+#endif
+
     //
     // An identifier used for correlating connection logs and statistics.
     //
@@ -193,6 +325,37 @@ typedef struct QUIC_LIBRARY {
     //
     uint64_t CurrentHandshakeMemoryUsage;
 
+    //
+    // The maximum total memory usage for connection send buffers before each
+    // connection is limited to its fair share.
+    //
+    uint64_t SendBufferMemoryLimit;
+
+    //
+    // The total memory usage for connection send buffers, summed from the
+    // partitions' counters at most every QUIC_SEND_BUFFER_USAGE_REFRESH_US
+    // (as of SendBufferMemoryUsageTime).
+    //
+    uint64_t CurrentSendBufferMemoryUsage;
+    uint64_t SendBufferMemoryUsageTime;
+
+    //
+    // The current total memory usage for internally allocated stream receive
+    // buffers.
+    //
+    uint64_t CurrentRecvBufferMemoryUsage;
+
+    //
+    // The memory the library may use before the memory governor starts
+    // reacting. Derived from the (cgroup restricted on Linux) total memory.
+    //
+    uint64_t MemoryLimit;
+
+    //
+    // The memory governor's current stage (QUIC_MEMORY_PRESSURE).
+    //
+    long MemoryPressure;
+
     //
     // Handle to global persistent storage (registry).
     //
@@ -252,6 +415,68 @@ typedef struct QUIC_LIBRARY {
     //
     CXPLAT_RUNDOWN_REF RegistrationCloseCleanupRundown;
 
+    //
+    // Protects the TLS offload queue.
+    //
+    CXPLAT_DISPATCH_LOCK TlsOffloadLock;
+
+    //
+    // Event set when a TLS offload thread needs to wake.
+    //
+    CXPLAT_EVENT TlsOffloadEvent;
+
+    //
+    // Set to true to shut down the TLS offload threads.
+    //
+    BOOLEAN TlsOffloadShutdown;
+
+    //
+    // Threads that run offloaded server TLS handshakes, so expensive signing
+    // doesn't block the connection's worker, and asynchronous credential
+    // loads. Started on first use.
+    //
+    uint32_t TlsOffloadThreadCount;
+    CXPLAT_THREAD TlsOffloadThreads[QUIC_MAX_TLS_OFFLOAD_THREADS];
+
+    //
+    // List of QUIC_CRYPTO_OFFLOAD waiting for a TLS offload thread.
+    //
+    CXPLAT_LIST_ENTRY TlsOffloadQueue;
+
+    //
+    // List of QUIC_CREDENTIAL_LOAD waiting for a TLS offload thread. Only
+    // picked up when no handshake is waiting.
+    //
+    CXPLAT_LIST_ENTRY CredentialLoadQueue;
+
+    //
+    // Protects the packet protection offload queue.
+    //
+    CXPLAT_DISPATCH_LOCK ProtectOffloadLock;
+
+    //
+    // Event set when a packet protection offload thread needs to wake.
+    //
+    CXPLAT_EVENT ProtectOffloadEvent;
+
+    //
+    // Set to true to shut down the packet protection offload threads.
+    //
+    BOOLEAN ProtectOffloadShutdown;
+
+    //
+    // Threads that seal batches of 1-RTT packets for connections with
+    // parallel packet protection enabled. Started on first use.
+    //
+    uint32_t ProtectOffloadThreadCount;
+    CXPLAT_THREAD ProtectOffloadThreads[QUIC_MAX_PROTECT_OFFLOAD_THREADS];
+
+    //
+    // List of QUIC_PROTECT_OFFLOAD waiting for a packet protection offload
+    // thread.
+    //
+    CXPLAT_LIST_ENTRY ProtectOffloadQueue;
+
     //
     // Per-partition storage. Count of `PartitionCount`.
     //
@@ -311,6 +536,55 @@ typedef struct QUIC_LIBRARY {
     uint64_t PerfCounterSamplesTime;
     int64_t PerfCounterSamples[QUIC_PERF_COUNTER_MAX];
 
+    //
+    // Protects PathMetricsCache.
+    //
+    CXPLAT_DISPATCH_LOCK PathMetricsCacheLock;
+
+    //
+    // Path metrics of recent connections, per destination, used to warm start
+    // new connections to the same peer. Set associative by address hash, each
+    // set of QUIC_PATH_METRICS_CACHE_WAYS entries kept in LRU order.
+    //
+    QUIC_PATH_METRICS_CACHE_ENTRY PathMetricsCache[QUIC_PATH_METRICS_CACHE_SIZE];
+
+    //
+    // Persists resumption tickets and PathMetricsCache across restarts, when
+    // a cache file is configured.
+    //
+    QUIC_PERSISTENT_CACHE PersistentCache;
+
+    //
+    // Which new connections are traced with qlog, and the number of
+    // connections created since tracing was configured, to sample them.
+    //
+    QUIC_QLOG_CONFIG QlogConfig;
+    long QlogSampleCount;
+
+    //
+    // App callbacks taking this long (in microseconds) or longer are counted
+    // as slow. 0 disables timing the callbacks.
+    //
+    uint32_t SlowCallbackThresholdUs;
+
+    //
+    // How many objects each partition's pools are warmed up with when its
+    // worker starts.
+    //
+    QUIC_PREWARM_CONFIG PrewarmConfig;
+
+    //
+    // The Initial packet filter's configuration. The bucket count is only read
+    // when the partitions are created.
+    //
+    QUIC_INITIAL_FILTER_CONFIG InitialFilterConfig;
+
+    //
+    // The partition with the lowest receive rate in the last sample. Used as
+    // the target when moving connections off an overloaded partition.
+    //
+    uint16_t LeastLoadedPartition;
+
     //
     // The worker pool
     //
@@ -333,6 +607,19 @@ typedef struct QUIC_LIBRARY {
 
 extern QUIC_LIBRARY MsQuicLib;
 
+//
+// Returns the current settings snapshot. The snapshot never changes and stays
+// valid until the library is uninitialized.
+//
+QUIC_INLINE
+const QUIC_SETTINGS_INTERNAL*
+QuicLibraryGetSettings(
+    void
+    )
+{
+    return (const QUIC_SETTINGS_INTERNAL*)QuicReadPtrAcquire((void**)&MsQuicLib.Settings);
+}
+
 #if DEBUG // Enable all verifier checks in debug builds
 #define QUIC_LIB_VERIFY(Expr) CXPLAT_FRE_ASSERT(Expr)
 #elif defined(CxPlatVerifierEnabled)
@@ -386,6 +673,107 @@ QuicLibraryGetCurrentPartition(
     return QuicLibraryGetPartitionFromProcessorIndex(CurrentProc);
 }
 
+typedef enum QUIC_CALLBACK_TYPE {
+    QUIC_CALLBACK_LISTENER,
+    QUIC_CALLBACK_CONNECTION,
+    QUIC_CALLBACK_STREAM
+} QUIC_CALLBACK_TYPE;
+
+//
+// Returns when an app callback starts, or 0 if callbacks aren't timed.
+//
+QUIC_INLINE
+uint64_t
+QuicLibraryCallbackStart(
+    void
+    )
+{
+    return MsQuicLib.SlowCallbackThresholdUs != 0 ? CxPlatTimeUs64() : 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryOnSlowCallback(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_CALLBACK_TYPE Type,
+    _In_ uint32_t EventType,
+    _In_ uint64_t DurationUs
+    );
+
+//
+// Counts the app callback, started at StartTime, if it was slow.
+//
+QUIC_INLINE
+void
+QuicLibraryCallbackComplete(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ QUIC_CALLBACK_TYPE Type,
+    _In_ uint32_t EventType,
+    _In_ uint64_t StartTime
+    )
+{
+    if (StartTime != 0) {
+        const uint32_t ThresholdUs = MsQuicLib.SlowCallbackThresholdUs;
+        const uint64_t DurationUs = CxPlatTimeDiff64(StartTime, CxPlatTimeUs64());
+        if (ThresholdUs != 0 && DurationUs >= ThresholdUs) {
+            QuicLibraryOnSlowCallback(Partition, Type, EventType, DurationUs);
+        }
+    }
+}
+
+//
+// Enters a read section on the current partition. Returns the partition,
+// which must be passed back to QuicLibraryReadEnd. Objects that are read
+// without locks (such as the CID lookup tables and the retry key cache) are
+// only freed via QuicLibraryRetire, once unlinked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+QUIC_PARTITION*
+QuicLibraryReadBegin(
+    _Out_ uint32_t* Epoch
+    )
+{
+    QUIC_PARTITION* Partition = QuicLibraryGetCurrentPartition();
+    *Epoch = (uint32_t)MsQuicLib.ReadSectionEpoch & 1;
+    InterlockedIncrement(&Partition->ReadSections[*Epoch]);
+    return Partition;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicLibraryReadEnd(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ uint32_t Epoch
+    )
+{
+    InterlockedDecrement(&Partition->ReadSections[Epoch]);
+}
+
+//
+// Queues a chain (linked by Next) of unlinked objects to be freed once every
+// read section that might still reference them has exited. Never blocks, so
+// it may be called with locks held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryRetire(
+    _In_ QUIC_RETIRED_OBJECT* Objects
+    );
+
+//
+// Advances the grace period, if every read section of the previous epoch has
+// exited, and frees the objects whose grace period has ended. Called by the
+// workers while objects are waiting. With Wait, blocks until every retired
+// object is freed; it must then not be called from within a read section.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryReclaim(
+    _In_ BOOLEAN Wait
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
 uint16_t
@@ -449,9 +837,54 @@ QuicPerfCounterTrySnapShot(
     QuicPerfCounterSnapShot(TimeDiff);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryRefreshSendBufferMemoryUsage(
+    void
+    );
+
+//
+// Refreshes MsQuicLib.CurrentSendBufferMemoryUsage from the partitions'
+// counters, if it's older than QUIC_SEND_BUFFER_USAGE_REFRESH_US.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+void
+QuicLibraryTryRefreshSendBufferMemoryUsage(
+    _In_ uint64_t TimeNow
+    )
+{
+    uint64_t TimeLast = MsQuicLib.SendBufferMemoryUsageTime;
+    if (CxPlatTimeDiff64(TimeLast, TimeNow) < QUIC_SEND_BUFFER_USAGE_REFRESH_US) {
+        return;
+    }
+
+    if ((int64_t)TimeLast !=
+        InterlockedCompareExchange64(
+            (int64_t*)&MsQuicLib.SendBufferMemoryUsageTime,
+            (int64_t)TimeNow,
+            (int64_t)TimeLast)) {
+        return; // Someone else already is updating.
+    }
+
+    QuicLibraryRefreshSendBufferMemoryUsage();
+}
+
+//
+// Encrypts a newly generated CID in place, for the QUIC-LB stream and block
+// cipher modes, and sets its first byte.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryEncodeLoadBalancedCid(
+    _Inout_updates_(MsQuicLib.CidTotalLength)
+        uint8_t* CID
+    );
+
 //
 // Creates a random, new source connection ID, that will be used on the receive
-// path.
+// path. The random bytes come from Random if given, or else straight from the
+// platform.
 //
 QUIC_INLINE
 _Success_(return != NULL)
@@ -463,11 +896,13 @@ QuicCidNewRandomSource(
     _In_ uint16_t PartitionID,
     _In_ uint8_t PrefixLength,
     _In_reads_(PrefixLength)
-        const void* Prefix
+        const void* Prefix,
+    _In_reads_opt_(MsQuicLib.CidTotalLength)
+        const uint8_t* Random
     )
 {
     CXPLAT_DBG_ASSERT(MsQuicLib.CidTotalLength <= QUIC_MAX_CONNECTION_ID_LENGTH_V1);
-    CXPLAT_DBG_ASSERT(MsQuicLib.CidTotalLength == MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH + QUIC_CID_PAYLOAD_LENGTH);
+    CXPLAT_DBG_ASSERT(MsQuicLib.CidTotalLength >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH + QUIC_CID_PAYLOAD_LENGTH);
     CXPLAT_DBG_ASSERT(QUIC_CID_PAYLOAD_LENGTH > PrefixLength);
 
     QUIC_CID_HASH_ENTRY* Entry =
@@ -482,11 +917,19 @@ QuicCidNewRandomSource(
         CxPlatZeroMemory(&Entry->CID, sizeof(Entry->CID));
         Entry->CID.Length = MsQuicLib.CidTotalLength;
 
+        //
+        // Start fully random, then overwrite the fixed fields. What remains
+        // random is the server ID (if none), the payload and the padding.
+        //
         uint8_t* Data = Entry->CID.Data;
+        if (Random != NULL) {
+            CxPlatCopyMemory(Data, Random, MsQuicLib.CidTotalLength);
+        } else {
+            CxPlatRandom(MsQuicLib.CidTotalLength, Data);
+        }
+
         if (ServerID != NULL) {
             CxPlatCopyMemory(Data, ServerID, MsQuicLib.CidServerIdLength);
-        } else {
-            CxPlatRandom(MsQuicLib.CidServerIdLength, Data);
         }
         Data += MsQuicLib.CidServerIdLength;
 
@@ -496,10 +939,13 @@ QuicCidNewRandomSource(
 
         if (PrefixLength) {
             CxPlatCopyMemory(Data, Prefix, PrefixLength);
-            Data += PrefixLength;
         }
 
-        CxPlatRandom(QUIC_CID_PAYLOAD_LENGTH - PrefixLength, Data);
+        if (QuicLibraryGetSettings()->LoadBalancingMode >= QUIC_LOAD_BALANCING_SERVER_ID_STREAM_CIPHER &&
+            !QuicLibraryEncodeLoadBalancedCid(Entry->CID.Data)) {
+            CXPLAT_FREE(Entry, QUIC_POOL_CIDHASH);
+            Entry = NULL;
+        }
     }
 
     return Entry;
@@ -608,6 +1054,29 @@ QuicLibraryGetWorker(
     _In_ const QUIC_RX_PACKET* Packet
     );
 
+//
+// Re-evaluates the memory governor's stage from the library's current
+// estimated memory usage.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryEvaluateMemoryPressure(
+    void
+    );
+
+//
+// Returns the memory governor's current stage.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+QUIC_MEMORY_PRESSURE
+QuicLibraryGetMemoryPressure(
+    void
+    )
+{
+    return (QUIC_MEMORY_PRESSURE)MsQuicLib.MemoryPressure;
+}
+
 //
 // Called when a new (server) connection is added in the handshake state.
 //
@@ -645,6 +1114,97 @@ QuicLibrarySetRetryKeyConfig(
     _In_ const QUIC_STATELESS_RETRY_CONFIG* Config
     );
 
+//
+// Starts the TLS offload threads, if not already started.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicLibraryStartTlsOffload(
+    void
+    );
+
+//
+// Queues TLS processing to run on a TLS offload thread.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryQueueTlsOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    );
+
+//
+// Queues an asynchronous credential load to run on a TLS offload thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLibraryQueueCredentialLoad(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    );
+
+//
+// Starts the packet protection offload threads, if not already started.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicLibraryStartProtectOffload(
+    void
+    );
+
+//
+// Queues a batch of packets to be sealed on a packet protection offload
+// thread.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryQueueProtectOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    );
+
+//
+// Takes a batch back out of the packet protection offload queue. Returns
+// FALSE if an offload thread already picked it up.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryCancelProtectOffload(
+    _In_ CXPLAT_LIST_ENTRY* Link
+    );
+
+//
+// Copies out the path metrics cached for the remote address. Returns FALSE,
+// with the metrics zeroed, if there are none younger than MaxAgeUs.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLibraryGetPathMetrics(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ uint64_t MaxAgeUs,
+    _Out_ QUIC_PATH_METRICS* Metrics
+    );
+
+//
+// Caches path metrics for the remote address. The MTU and the RTT (with the
+// rest of the metrics) are each left unchanged if zero.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryCachePathMetrics(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ const QUIC_PATH_METRICS* Metrics
+    );
+
+//
+// Restores path metrics loaded from the persistent cache, which were cached
+// AgeUs ago.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLibraryRestorePathMetrics(
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_ uint64_t AgeUs,
+    _In_ const QUIC_PATH_METRICS* Metrics
+    );
+
 #if DEBUG
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
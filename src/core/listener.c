@@ -313,13 +313,27 @@ MsQuicListenerStart(
             UdpConfig.CibirIdLength);
     }
 
-    if (MsQuicLib.Settings.XdpEnabled) {
+    if (QuicLibraryGetSettings()->XdpEnabled) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_XDP;
     }
-    if (MsQuicLib.Settings.QTIPEnabled) {
+    if (QuicLibraryGetSettings()->QTIPEnabled) {
         UdpConfig.Flags |= CXPLAT_SOCKET_FLAG_QTIP;
     }
 
+    //
+    // Steer packets to the per-processor socket of the partition that owns
+    // their CID, so that lookups rarely cross partitions. Not possible when
+    // the partition ID is encrypted.
+    //
+    if (!Listener->Partitioned &&
+        MsQuicLib.ExecutionConfig != NULL &&
+        (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_CID_STEERING) &&
+        QuicLibraryGetSettings()->LoadBalancingMode != QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER) {
+        UdpConfig.CidSteeringPartitionCount = MsQuicLib.PartitionCount;
+        UdpConfig.CidSteeringPidMask = MsQuicLib.PartitionMask;
+        UdpConfig.CidSteeringPidOffset = MsQuicLib.CidServerIdLength;
+    }
+
     CXPLAT_TEL_ASSERT(Listener->Binding == NULL);
     Status =
         QuicLibraryGetBinding(
@@ -377,11 +391,16 @@ QuicListenerIndicateEvent(
     CXPLAT_PASSIVE_CODE();
     CXPLAT_FRE_ASSERT(Listener->ClientCallbackHandler);
     CXPLAT_DBG_ASSERT(!Listener->Partitioned || QuicListenerIsOnWorker(Listener));
-    return
+    const uint32_t EventType = Event->Type;
+    const uint64_t StartTime = QuicLibraryCallbackStart();
+    QUIC_STATUS Status =
         Listener->ClientCallbackHandler(
             (HQUIC)Listener,
             Listener->ClientContext,
             Event);
+    QuicLibraryCallbackComplete(
+        QuicLibraryGetCurrentPartition(), QUIC_CALLBACK_LISTENER, EventType, StartTime);
+    return Status;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -394,11 +413,18 @@ QuicListenerIndicateDispatchEvent(
     CXPLAT_DBG_ASSERT(Event->Type == QUIC_LISTENER_EVENT_DOS_MODE_CHANGED);
     CXPLAT_DBG_ASSERT(!Listener->Partitioned || QuicListenerIsOnWorker(Listener));
     CXPLAT_FRE_ASSERT(Listener->ClientCallbackHandler);
-    return
+    const uint64_t StartTime = QuicLibraryCallbackStart();
+    QUIC_STATUS Status =
         Listener->ClientCallbackHandler(
             (HQUIC)Listener,
             Listener->ClientContext,
             Event);
+    QuicLibraryCallbackComplete(
+        QuicLibraryGetCurrentPartition(),
+        QUIC_CALLBACK_LISTENER,
+        QUIC_LISTENER_EVENT_DOS_MODE_CHANGED,
+        StartTime);
+    return Status;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -629,6 +655,26 @@ QuicListenerMatchesAlpn(
     return FALSE;
 }
 
+//
+// A connection waiting in a worker's accept queue, along with its own copy of
+// the new connection info.
+//
+typedef struct QUIC_LISTENER_ACCEPT_ENTRY {
+
+    CXPLAT_LIST_ENTRY Link;
+    QUIC_LISTENER* Listener;
+    QUIC_CONNECTION* Connection;
+    QUIC_NEW_CONNECTION_INFO Info;
+    QUIC_ADDR LocalAddress;
+    QUIC_ADDR RemoteAddress;
+
+    //
+    // Followed by the info's crypto buffer, client ALPN list, negotiated ALPN
+    // and server name.
+    //
+
+} QUIC_LISTENER_ACCEPT_ENTRY;
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicListenerClaimConnection(
@@ -698,6 +744,82 @@ QuicListenerClaimConnection(
     return !Connection->State.HandleClosed;
 }
 
+//
+// Queues the connection on its worker's accept queue, instead of indicating it
+// to the app right away. Returns FALSE if the connection couldn't be queued.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicListenerQueueAccept(
+    _In_ QUIC_LISTENER* Listener,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_NEW_CONNECTION_INFO* Info
+    )
+{
+    CXPLAT_DBG_ASSERT(Connection->State.ExternalOwner == FALSE);
+
+    //
+    // The info's buffers point into the connection's receive state, which
+    // won't be around by the time the queue is indicated, so keep a copy.
+    //
+    QUIC_LISTENER_ACCEPT_ENTRY* Entry =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_LISTENER_ACCEPT_ENTRY) +
+            Info->CryptoBufferLength +
+            Info->ClientAlpnListLength +
+            Info->NegotiatedAlpnLength +
+            Info->ServerNameLength,
+            QUIC_POOL_ACCEPT_QUEUE);
+    if (Entry == NULL) {
+        return FALSE;
+    }
+
+    Entry->Listener = Listener;
+    Entry->Connection = Connection;
+    Entry->Info = *Info;
+    Entry->LocalAddress = *Info->LocalAddress;
+    Entry->RemoteAddress = *Info->RemoteAddress;
+    Entry->Info.LocalAddress = &Entry->LocalAddress;
+    Entry->Info.RemoteAddress = &Entry->RemoteAddress;
+
+    uint8_t* Buffer = (uint8_t*)(Entry + 1);
+    CxPlatCopyMemory(Buffer, Info->CryptoBuffer, Info->CryptoBufferLength);
+    Entry->Info.CryptoBuffer = Buffer;
+    Buffer += Info->CryptoBufferLength;
+    CxPlatCopyMemory(Buffer, Info->ClientAlpnList, Info->ClientAlpnListLength);
+    Entry->Info.ClientAlpnList = Buffer;
+    Buffer += Info->ClientAlpnListLength;
+    CxPlatCopyMemory(Buffer, Info->NegotiatedAlpn, Info->NegotiatedAlpnLength);
+    Entry->Info.NegotiatedAlpn = Buffer;
+    Buffer += Info->NegotiatedAlpnLength;
+    if (Info->ServerName != NULL) {
+        CxPlatCopyMemory(Buffer, Info->ServerName, Info->ServerNameLength);
+        Entry->Info.ServerName = (const char*)Buffer;
+    }
+
+    Connection->State.ListenerAccepted = TRUE;
+    Connection->State.AcceptQueued = TRUE;
+
+    if (Listener->Partitioned) {
+        Connection->State.Partitioned = TRUE;
+        CXPLAT_DBG_ASSERT(Connection->Partition->Index == Listener->PartitionIndex);
+    }
+
+    //
+    // The entry keeps both the connection and the listener (from completing its
+    // stop) alive until the queue is indicated.
+    //
+    QuicConnAddRef(Connection, QUIC_CONN_REF_ACCEPT_QUEUE);
+    QuicListenerStartReference(Listener);
+
+    QUIC_WORKER* Worker = Connection->Worker;
+    CxPlatListInsertTail(&Worker->AcceptQueue, &Entry->Link);
+    Worker->AcceptQueueCount++;
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicListenerAcceptConnection(
@@ -706,6 +828,15 @@ QuicListenerAcceptConnection(
     _In_ const QUIC_NEW_CONNECTION_INFO* Info
     )
 {
+    if (QuicLibraryGetMemoryPressure() >= QUIC_MEMORY_PRESSURE_REJECT_CONNECTIONS) {
+        QuicConnTransportError(
+            Connection,
+            QUIC_ERROR_CONNECTION_REFUSED);
+        Listener->TotalRejectedConnections++;
+        QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_MEMORY_REJECT);
+        return;
+    }
+
     if (!QuicRegistrationAcceptConnection(
             Listener->Registration,
             Connection)) {
@@ -730,6 +861,11 @@ QuicListenerAcceptConnection(
         return;
     }
 
+    if (Listener->AcceptQueueEnabled &&
+        QuicListenerQueueAccept(Listener, Connection, Info)) {
+        return; // Accepted or rejected later, when the queue is indicated.
+    }
+
     if (!QuicListenerClaimConnection(Listener, Connection, Info)) {
         Listener->TotalRejectedConnections++;
         QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_APP_REJECT);
@@ -739,6 +875,160 @@ QuicListenerAcceptConnection(
     Listener->TotalAcceptedConnections++;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicListenerAcceptEntryFree(
+    _In_ __drv_freesMem(Mem) QUIC_LISTENER_ACCEPT_ENTRY* Entry
+    )
+{
+    QUIC_LISTENER* Listener = Entry->Listener;
+    QuicConnRelease(Entry->Connection, QUIC_CONN_REF_ACCEPT_QUEUE);
+    CXPLAT_FREE(Entry, QUIC_POOL_ACCEPT_QUEUE);
+    QuicListenerStartRelease(Listener, TRUE);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicListenerIndicateAcceptQueue(
+    _Inout_ CXPLAT_LIST_ENTRY* AcceptQueue,
+    _In_ CXPLAT_THREAD_ID ThreadID
+    )
+{
+    QUIC_LISTENER_ACCEPT_ENTRY* Entries[QUIC_MAX_ACCEPT_QUEUE_BATCH];
+    HQUIC Connections[QUIC_MAX_ACCEPT_QUEUE_BATCH];
+    const QUIC_NEW_CONNECTION_INFO* Infos[QUIC_MAX_ACCEPT_QUEUE_BATCH];
+    QUIC_STATUS Statuses[QUIC_MAX_ACCEPT_QUEUE_BATCH];
+
+    while (!CxPlatListIsEmpty(AcceptQueue)) {
+        //
+        // Gather a batch of the connections for the listener at the head of
+        // the queue. The ones for other listeners are left for a later batch.
+        //
+        QUIC_LISTENER* Listener =
+            CXPLAT_CONTAINING_RECORD(
+                AcceptQueue->Flink, QUIC_LISTENER_ACCEPT_ENTRY, Link)->Listener;
+        uint32_t Count = 0;
+        CXPLAT_LIST_ENTRY* Link = AcceptQueue->Flink;
+        while (Link != AcceptQueue && Count < QUIC_MAX_ACCEPT_QUEUE_BATCH) {
+            QUIC_LISTENER_ACCEPT_ENTRY* Entry =
+                CXPLAT_CONTAINING_RECORD(Link, QUIC_LISTENER_ACCEPT_ENTRY, Link);
+            Link = Link->Flink;
+            if (Entry->Listener != Listener) {
+                continue;
+            }
+
+            CxPlatListEntryRemove(&Entry->Link);
+            QUIC_CONNECTION* Connection = Entry->Connection;
+            Connection->State.AcceptQueued = FALSE;
+            if (Connection->State.ShutdownComplete) {
+                //
+                // The connection died while it was waiting. It was never
+                // handed to the app, so there's nothing to indicate.
+                //
+                QuicListenerAcceptEntryFree(Entry);
+                continue;
+            }
+
+            //
+            // Let the app's API calls on the connection (e.g. closing it)
+            // execute inline, as they would for QUIC_LISTENER_EVENT_NEW_CONNECTION.
+            //
+            Connection->State.ExternalOwner = TRUE;
+            Connection->WorkerThreadID = ThreadID;
+
+            Entries[Count] = Entry;
+            Connections[Count] = (HQUIC)Connection;
+            Infos[Count] = &Entry->Info;
+            Statuses[Count] = QUIC_STATUS_SUCCESS;
+            Count++;
+        }
+
+        if (Count == 0) {
+            continue;
+        }
+
+        QUIC_LISTENER_EVENT Event;
+        Event.Type = QUIC_LISTENER_EVENT_NEW_CONNECTIONS;
+        Event.NEW_CONNECTIONS.Count = Count;
+        Event.NEW_CONNECTIONS.Connections = Connections;
+        Event.NEW_CONNECTIONS.Infos = Infos;
+        Event.NEW_CONNECTIONS.Statuses = Statuses;
+
+        QuicListenerAttachSilo(Listener);
+
+        QUIC_STATUS Status = QuicListenerIndicateEvent(Listener, &Event);
+
+        QuicListenerDetachSilo();
+
+        for (uint32_t i = 0; i < Count; ++i) {
+            QUIC_CONNECTION* Connection = Entries[i]->Connection;
+            Connection->WorkerThreadID = 0;
+
+            if (QUIC_FAILED(Status) || QUIC_FAILED(Statuses[i])) {
+                CXPLAT_FRE_ASSERTMSG(
+                    !Connection->State.HandleClosed,
+                    "App MUST not close and reject connection!");
+                Connection->State.ExternalOwner = FALSE;
+                QuicConnTransportError(
+                    Connection,
+                    QUIC_ERROR_CONNECTION_REFUSED);
+                Listener->TotalRejectedConnections++;
+                QuicPerfCounterIncrement(Connection->Partition, QUIC_PERF_COUNTER_CONN_APP_REJECT);
+                continue;
+            }
+
+            CXPLAT_FRE_ASSERTMSG(
+                Connection->State.HandleClosed ||
+                Connection->ClientCallbackHandler != NULL,
+                "App MUST set callback handler or close connection!");
+
+            if (!Connection->State.ShutdownComplete) {
+                //
+                // The connection isn't being processed right now, so it can't
+                // be moved to its partition's worker yet. Queue it so that
+                // happens the next time it's processed.
+                //
+                Connection->State.AcceptQueueMove = TRUE;
+                QuicWorkerQueueConnection(Connection->Worker, Connection);
+            }
+
+            Listener->TotalAcceptedConnections++;
+        }
+
+        //
+        // Each entry holds a start reference on the listener, so only free them
+        // once the listener isn't needed any more.
+        //
+        for (uint32_t i = 0; i < Count; ++i) {
+            QuicListenerAcceptEntryFree(Entries[i]);
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicListenerAbortAcceptQueue(
+    _Inout_ CXPLAT_LIST_ENTRY* AcceptQueue
+    )
+{
+    while (!CxPlatListIsEmpty(AcceptQueue)) {
+        QUIC_LISTENER_ACCEPT_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(AcceptQueue), QUIC_LISTENER_ACCEPT_ENTRY, Link);
+        QUIC_CONNECTION* Connection = Entry->Connection;
+        Connection->State.AcceptQueued = FALSE;
+        if (!Connection->State.ShutdownComplete) {
+            //
+            // The app never saw the connection, so shut it down so that it's
+            // not leaked.
+            //
+            QuicConnOnShutdownComplete(Connection);
+        }
+        QuicListenerAcceptEntryFree(Entry);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicListenerParamSet(
@@ -750,6 +1040,9 @@ QuicListenerParamSet(
     )
 {
     if (Param == QUIC_PARAM_LISTENER_CIBIR_ID) {
+        if (Listener->Binding != NULL) {
+            return QUIC_STATUS_INVALID_STATE; // The binding indexes it while started.
+        }
         if (BufferLength > QUIC_MAX_CIBIR_LENGTH + 1) {
             return QUIC_STATUS_INVALID_PARAMETER;
         }
@@ -765,6 +1058,10 @@ QuicListenerParamSet(
             return QUIC_STATUS_NOT_SUPPORTED; // Not yet supproted.
         }
 
+        if (QuicLibraryGetSettings()->LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER) {
+            return QUIC_STATUS_NOT_SUPPORTED; // The CIBIR ID would be encrypted.
+        }
+
         Listener->CibirId[0] = (uint8_t)BufferLength - 1;
         memcpy(Listener->CibirId + 1, Buffer, BufferLength);
 
@@ -782,6 +1079,14 @@ QuicListenerParamSet(
         }
     }
 
+    if (Param == QUIC_PARAM_LISTENER_ACCEPT_QUEUE) {
+        if (BufferLength != sizeof(BOOLEAN) || !Listener->Stopped) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+        Listener->AcceptQueueEnabled = *(BOOLEAN*)Buffer ? TRUE : FALSE;
+        return QUIC_STATUS_SUCCESS;
+    }
+
     if (Param == QUIC_PARAM_LISTENER_PARTITION_INDEX) {
         uint16_t PartitionIndex;
         if (BufferLength != sizeof(uint16_t)) {
@@ -794,7 +1099,8 @@ QuicListenerParamSet(
             !Listener->Stopped) {
             return QUIC_STATUS_INVALID_PARAMETER;
         }
-#if defined(__linux__) && !defined(CXPLAT_USE_IO_URING) && !defined(CXPLAT_LINUX_XDP_ENABLED)
+#if defined(__linux__) && !defined(CXPLAT_USE_IO_URING) && !defined(CXPLAT_LINUX_XDP_ENABLED) && \
+    !defined(CXPLAT_LINUX_DPDK_ENABLED)
         Listener->PartitionIndex = PartitionIndex;
         Listener->Partitioned = TRUE;
         QuicWorkerAssignListener(
@@ -927,6 +1233,22 @@ QuicListenerParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_LISTENER_ACCEPT_QUEUE:
+
+        if (*BufferLength < sizeof(BOOLEAN)) {
+            *BufferLength = sizeof(BOOLEAN);
+            return QUIC_STATUS_BUFFER_TOO_SMALL;
+        }
+
+        if (Buffer == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+
+        *BufferLength = sizeof(BOOLEAN);
+        *(BOOLEAN*)Buffer = Listener->AcceptQueueEnabled;
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+
     default:
         Status = QUIC_STATUS_INVALID_PARAMETER;
         break;
@@ -58,6 +58,12 @@ typedef struct QUIC_LISTENER {
     //
     BOOLEAN Partitioned : 1;
 
+    //
+    // Indicates accepted connections are queued on their worker and indicated
+    // to the app in batches, with QUIC_LISTENER_EVENT_NEW_CONNECTIONS.
+    //
+    BOOLEAN AcceptQueueEnabled : 1;
+
     //
     // The thread ID that the listener is actively indicating a stop compelete
     // callback on.
@@ -65,10 +71,16 @@ typedef struct QUIC_LISTENER {
     CXPLAT_THREAD_ID StopCompleteThreadID;
 
     //
-    // The link in the binding's list of listeners.
+    // The link in the binding's list of listeners, or in its list of CIBIR
+    // listeners if the listener has a CIBIR ID.
     //
     CXPLAT_LIST_ENTRY Link;
 
+    //
+    // The entry in the binding's CIBIR ID index.
+    //
+    CXPLAT_HASHTABLE_ENTRY CibirEntry;
+
     //
     // The top level registration.
     //
@@ -255,6 +267,28 @@ QuicListenerAcceptConnection(
     _In_ const QUIC_NEW_CONNECTION_INFO* Info
     );
 
+//
+// Indicates all the connections in a worker's accept queue to their listeners,
+// one QUIC_LISTENER_EVENT_NEW_CONNECTIONS event per batch. Must be called on
+// the worker thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicListenerIndicateAcceptQueue(
+    _Inout_ CXPLAT_LIST_ENTRY* AcceptQueue,
+    _In_ CXPLAT_THREAD_ID ThreadID
+    );
+
+//
+// Cleans up the connections left in a worker's accept queue, without
+// indicating them to the app.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicListenerAbortAcceptQueue(
+    _Inout_ CXPLAT_LIST_ENTRY* AcceptQueue
+    );
+
 //
 // Sets a Listener parameter.
 //
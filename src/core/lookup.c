@@ -7,111 +7,503 @@ Abstract:
 
     Lookup tables for connections.
 
+    Local CID lookups on a partitioned (server) lookup are read without taking
+    any lock. Readers only announce themselves in a per-partition read section
+    counter, and writers (still serialized by the lookup's RwLock) publish
+    changes with release semantics and retire what they unlink. Retired
+    entries are only freed, and the connection references they hold only
+    released, after a grace period during which every read section that might
+    still see them exits (see QuicLibraryReclaim). Writers never wait for it.
+
 --*/
 
 #include "precomp.h"
 
+//
+// The minimum number of buckets in a partitioned hash table.
+//
+#define QUIC_LOOKUP_MIN_BUCKET_COUNT    CXPLAT_HASH_MIN_SIZE
+
+//
+// The average number of entries per bucket before a table is grown.
+//
+#define QUIC_LOOKUP_MAX_LOAD_FACTOR     2
+
+//
+// A local CID entry in a partitioned hash table. Nodes belong to the table
+// rather than being embedded in the CID, so a node that a reader may still be
+// walking is never relinked; growing or rebuilding a table always creates new
+// nodes and retires the old ones.
+//
+typedef struct QUIC_LOOKUP_NODE {
+
+    struct QUIC_LOOKUP_NODE* volatile Next;
+
+    //
+    // Links nodes waiting for a grace period to end. Only used by writers.
+    //
+    QUIC_RETIRED_OBJECT Retired;
+
+    //
+    // The CID the node was created for. Only used by writers, which hold the
+    // lock that keeps it alive.
+    //
+    QUIC_CID_HASH_ENTRY* SourceCid;
+
+    QUIC_CONNECTION* Connection;
+    uint32_t Hash;
+    uint8_t CidLength;
+
+    //
+    // Set once the node is removed for its CID. The node then holds a
+    // reference on the connection until it's freed, so that readers that
+    // still find it can safely take their own.
+    //
+    BOOLEAN HoldsRef;
+
+    uint8_t Cid[0];
+
+} QUIC_LOOKUP_NODE;
+
+typedef struct QUIC_LOOKUP_BUCKETS {
+
+    QUIC_RETIRED_OBJECT Retired;
+    uint32_t Mask;
+    QUIC_LOOKUP_NODE* volatile Heads[0];
+
+} QUIC_LOOKUP_BUCKETS;
 
 typedef struct QUIC_CACHEALIGN QUIC_PARTITIONED_HASHTABLE {
 
-    CXPLAT_DISPATCH_RW_LOCK RwLock;
-    CXPLAT_HASHTABLE Table;
+    QUIC_LOOKUP_BUCKETS* volatile Buckets;
+    uint32_t NumEntries;
 
 } QUIC_PARTITIONED_HASHTABLE;
 
+typedef struct QUIC_LOOKUP_HASH {
+
+    QUIC_RETIRED_OBJECT Retired;
+    uint16_t PartitionCount;
+    QUIC_PARTITIONED_HASHTABLE Tables[0];
+
+} QUIC_LOOKUP_HASH;
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
-BOOLEAN
-QuicLookupInsertLocalCid(
-    _In_ QUIC_LOOKUP* Lookup,
-    _In_ uint32_t Hash,
-    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
-    _In_ BOOLEAN UpdateRefCount
-    );
+QUIC_INLINE
+uint16_t
+QuicLookupGetCidPartitionIndex(
+    _In_ uint16_t PartitionCount,
+    _In_ const uint8_t* const CID,
+    _In_ uint32_t Hash
+    )
+{
+    if (QuicLibraryGetSettings()->LoadBalancingMode == QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER) {
+        //
+        // The PID is encrypted, so just spread the CIDs by their hash. The
+        // low bits of the hash already pick the bucket.
+        //
+        return (uint16_t)((Hash >> 16) % PartitionCount);
+    }
+
+    CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
+    uint16_t PartitionIndex;
+    CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
+    PartitionIndex &= MsQuicLib.PartitionMask;
+    PartitionIndex %= PartitionCount;
+    return PartitionIndex;
+}
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
-void
-QuicLookupInitialize(
-    _Inout_ QUIC_LOOKUP* Lookup
+QUIC_LOOKUP_BUCKETS*
+QuicLookupBucketsCreate(
+    _In_ uint32_t BucketCount
     )
 {
-    CxPlatZeroMemory(Lookup, sizeof(QUIC_LOOKUP));
-    CxPlatDispatchRwLockInitialize(&Lookup->RwLock);
+    CXPLAT_DBG_ASSERT((BucketCount & (BucketCount - 1)) == 0);
+    QUIC_LOOKUP_BUCKETS* Buckets =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_LOOKUP_BUCKETS) + BucketCount * sizeof(QUIC_LOOKUP_NODE*),
+            QUIC_POOL_LOOKUP_HASHTABLE);
+    if (Buckets != NULL) {
+        Buckets->Mask = BucketCount - 1;
+        CxPlatZeroMemory((void*)Buckets->Heads, BucketCount * sizeof(QUIC_LOOKUP_NODE*));
+    }
+    return Buckets;
 }
 
+//
+// Frees the buckets and every node still linked in them.
+//
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
-QuicLookupUninitialize(
-    _In_ QUIC_LOOKUP* Lookup
+QuicLookupBucketsFree(
+    _In_ QUIC_LOOKUP_BUCKETS* Buckets
     )
 {
-    CXPLAT_DBG_ASSERT(Lookup->CidCount == 0);
-
-    if (Lookup->PartitionCount == 0) {
-        CXPLAT_DBG_ASSERT(Lookup->SINGLE.Connection == NULL);
-    } else {
-        CXPLAT_DBG_ASSERT(Lookup->HASH.Tables != NULL);
-        for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
-            QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[i];
-            CXPLAT_DBG_ASSERT(Table->Table.NumEntries == 0);
-#pragma warning(push)
-#pragma warning(disable:6001)
-            CxPlatHashtableUninitialize(&Table->Table);
-#pragma warning(pop)
-            CxPlatDispatchRwLockUninitialize(&Table->RwLock);
+    for (uint32_t i = 0; i <= Buckets->Mask; ++i) {
+        QUIC_LOOKUP_NODE* Node = Buckets->Heads[i];
+        while (Node != NULL) {
+            QUIC_LOOKUP_NODE* Next = Node->Next;
+            CXPLAT_FREE(Node, QUIC_POOL_LOOKUP_NODE);
+            Node = Next;
         }
-        CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
     }
+    CXPLAT_FREE(Buckets, QUIC_POOL_LOOKUP_HASHTABLE);
+}
 
-    if (Lookup->MaximizePartitioning) {
-        CXPLAT_DBG_ASSERT(Lookup->RemoteHashTable.NumEntries == 0);
-        CxPlatHashtableUninitialize(&Lookup->RemoteHashTable);
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupBucketsRetiredFree(
+    _In_ QUIC_RETIRED_OBJECT* Object
+    )
+{
+    QuicLookupBucketsFree(
+        CXPLAT_CONTAINING_RECORD(Object, QUIC_LOOKUP_BUCKETS, Retired));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_LOOKUP_NODE*
+QuicLookupNodeCreate(
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
+    _In_ uint32_t Hash
+    )
+{
+    QUIC_LOOKUP_NODE* Node =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_LOOKUP_NODE) + SourceCid->CID.Length,
+            QUIC_POOL_LOOKUP_NODE);
+    if (Node != NULL) {
+        Node->Next = NULL;
+        Node->Retired.Next = NULL;
+        Node->SourceCid = SourceCid;
+        Node->Connection = SourceCid->Connection;
+        Node->Hash = Hash;
+        Node->CidLength = SourceCid->CID.Length;
+        Node->HoldsRef = FALSE;
+        CxPlatCopyMemory(Node->Cid, SourceCid->CID.Data, SourceCid->CID.Length);
     }
+    return Node;
+}
 
-    CxPlatDispatchRwLockUninitialize(&Lookup->RwLock);
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupNodeFree(
+    _In_ QUIC_RETIRED_OBJECT* Object
+    )
+{
+    QUIC_LOOKUP_NODE* Node =
+        CXPLAT_CONTAINING_RECORD(Object, QUIC_LOOKUP_NODE, Retired);
+    if (Node->HoldsRef) {
+        //
+        // Released as a lookup result, so that if it's the last reference the
+        // connection is freed on its worker rather than here.
+        //
+        QuicConnRelease(Node->Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+    }
+    CXPLAT_FREE(Node, QUIC_POOL_LOOKUP_NODE);
 }
 
 //
-// Allocates and initializes a new partitioned hash table.
+// Retires a list of removed nodes, to be freed once no reader can still
+// reference them.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
-BOOLEAN
-QuicLookupCreateHashTable(
-    _In_ QUIC_LOOKUP* Lookup,
+void
+QuicLookupNodesRetire(
+    _In_opt_ QUIC_LOOKUP_NODE* Retired
+    )
+{
+    if (Retired != NULL) {
+        QuicLibraryRetire(&Retired->Retired);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_LOOKUP_HASH*
+QuicLookupHashCreate(
     _In_range_(>, 0) uint16_t PartitionCount
     )
 {
-    CXPLAT_DBG_ASSERT(Lookup->LookupTable == NULL);
     CXPLAT_FRE_ASSERT(PartitionCount > 0);
 
-    Lookup->HASH.Tables =
+    QUIC_LOOKUP_HASH* LookupHash =
         CXPLAT_ALLOC_NONPAGED(
-            sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount,
+            sizeof(QUIC_LOOKUP_HASH) +
+                sizeof(QUIC_PARTITIONED_HASHTABLE) * PartitionCount,
             QUIC_POOL_LOOKUP_HASHTABLE);
+    if (LookupHash == NULL) {
+        return NULL;
+    }
 
-    if (Lookup->HASH.Tables != NULL) {
-
-        uint16_t Cleanup = 0;
-        uint8_t Failed = FALSE;
-        for (uint16_t i = 0; i < PartitionCount; i++) {
-            if (!CxPlatHashtableInitializeEx(&Lookup->HASH.Tables[i].Table, CXPLAT_HASH_MIN_SIZE)) {
-                Cleanup = i;
-                Failed = TRUE;
-                break;
+    LookupHash->PartitionCount = PartitionCount;
+    for (uint16_t i = 0; i < PartitionCount; i++) {
+        LookupHash->Tables[i].NumEntries = 0;
+        LookupHash->Tables[i].Buckets =
+            QuicLookupBucketsCreate(QUIC_LOOKUP_MIN_BUCKET_COUNT);
+        if (LookupHash->Tables[i].Buckets == NULL) {
+            for (uint16_t j = 0; j < i; j++) {
+                QuicLookupBucketsFree(LookupHash->Tables[j].Buckets);
             }
-            CxPlatDispatchRwLockInitialize(&Lookup->HASH.Tables[i].RwLock);
+            CXPLAT_FREE(LookupHash, QUIC_POOL_LOOKUP_HASHTABLE);
+            return NULL;
         }
-        if (Failed) {
-            for (uint16_t i = 0; i < Cleanup; i++) {
-                CxPlatHashtableUninitialize(&Lookup->HASH.Tables[i].Table);
+    }
+
+    return LookupHash;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupHashFree(
+    _In_ QUIC_LOOKUP_HASH* LookupHash
+    )
+{
+    for (uint16_t i = 0; i < LookupHash->PartitionCount; i++) {
+        QuicLookupBucketsFree(LookupHash->Tables[i].Buckets);
+    }
+    CXPLAT_FREE(LookupHash, QUIC_POOL_LOOKUP_HASHTABLE);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupHashRetiredFree(
+    _In_ QUIC_RETIRED_OBJECT* Object
+    )
+{
+    QuicLookupHashFree(
+        CXPLAT_CONTAINING_RECORD(Object, QUIC_LOOKUP_HASH, Retired));
+}
+
+//
+// Doubles the number of buckets in the table. Both the buckets and the nodes
+// are rebuilt, so readers see either the complete old table or the complete
+// new one, and the old ones are retired together. On allocation failure the
+// table keeps its current buckets.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupTableGrow(
+    _In_ QUIC_PARTITIONED_HASHTABLE* Table,
+    _In_ BOOLEAN Published
+    )
+{
+    QUIC_LOOKUP_BUCKETS* OldBuckets = Table->Buckets;
+    QUIC_LOOKUP_BUCKETS* NewBuckets =
+        QuicLookupBucketsCreate((OldBuckets->Mask + 1) * 2);
+    if (NewBuckets == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i <= OldBuckets->Mask; ++i) {
+        for (QUIC_LOOKUP_NODE* Node = OldBuckets->Heads[i];
+             Node != NULL;
+             Node = Node->Next) {
+            QUIC_LOOKUP_NODE* NewNode =
+                QuicLookupNodeCreate(Node->SourceCid, Node->Hash);
+            if (NewNode == NULL) {
+                QuicLookupBucketsFree(NewBuckets);
+                return;
             }
-            CXPLAT_FREE(Lookup->HASH.Tables, QUIC_POOL_LOOKUP_HASHTABLE);
-            Lookup->HASH.Tables = NULL;
-        } else {
-            Lookup->PartitionCount = PartitionCount;
+            QUIC_LOOKUP_NODE* volatile* Head =
+                &NewBuckets->Heads[NewNode->Hash & NewBuckets->Mask];
+            NewNode->Next = *Head;
+            *Head = NewNode;
         }
     }
 
-    return Lookup->HASH.Tables != NULL;
+    QuicWritePtrRelease((void**)&Table->Buckets, NewBuckets);
+    if (Published) {
+        OldBuckets->Retired.Next = NULL;
+        OldBuckets->Retired.Free = QuicLookupBucketsRetiredFree;
+        QuicLibraryRetire(&OldBuckets->Retired);
+    } else {
+        QuicLookupBucketsFree(OldBuckets);
+    }
+}
+
+//
+// Inserts a new node for the source CID. Requires the Lookup->RwLock to be
+// exclusively held if the hash is published.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicLookupHashInsert(
+    _In_ QUIC_LOOKUP_HASH* LookupHash,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
+    _In_ uint32_t Hash,
+    _In_ BOOLEAN Published
+    )
+{
+    CXPLAT_DBG_ASSERT(SourceCid->CID.Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
+
+    QUIC_LOOKUP_NODE* Node = QuicLookupNodeCreate(SourceCid, Hash);
+    if (Node == NULL) {
+        return FALSE;
+    }
+
+    QUIC_PARTITIONED_HASHTABLE* Table =
+        &LookupHash->Tables[
+            QuicLookupGetCidPartitionIndex(
+                LookupHash->PartitionCount, SourceCid->CID.Data, Hash)];
+    QUIC_LOOKUP_BUCKETS* Buckets = Table->Buckets;
+    QUIC_LOOKUP_NODE* volatile* Head = &Buckets->Heads[Hash & Buckets->Mask];
+    Node->Next = *Head;
+    QuicWritePtrRelease((void**)Head, Node);
+
+    if (++Table->NumEntries > (Buckets->Mask + 1) * QUIC_LOOKUP_MAX_LOAD_FACTOR) {
+        QuicLookupTableGrow(Table, Published);
+    }
+
+    return TRUE;
+}
+
+//
+// Unlinks the source CID's node and returns it. The node must not be freed
+// until a grace period has passed. Requires the Lookup->RwLock to be
+// exclusively held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_LOOKUP_NODE*
+QuicLookupHashRemove(
+    _In_ QUIC_LOOKUP_HASH* LookupHash,
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid
+    )
+{
+    const uint32_t Hash = CxPlatHashSimple(SourceCid->CID.Length, SourceCid->CID.Data);
+    QUIC_PARTITIONED_HASHTABLE* Table =
+        &LookupHash->Tables[
+            QuicLookupGetCidPartitionIndex(
+                LookupHash->PartitionCount, SourceCid->CID.Data, Hash)];
+    QUIC_LOOKUP_BUCKETS* Buckets = Table->Buckets;
+
+    QUIC_LOOKUP_NODE* volatile* Prev = &Buckets->Heads[Hash & Buckets->Mask];
+    QUIC_LOOKUP_NODE* Node;
+    while ((Node = *Prev) != NULL) {
+        if (Node->SourceCid == SourceCid) {
+            //
+            // The node keeps its Next pointer so readers currently on it can
+            // continue walking the chain.
+            //
+            QuicWritePtrRelease((void**)Prev, Node->Next);
+            Table->NumEntries--;
+            return Node;
+        }
+        Prev = &Node->Next;
+    }
+
+    CXPLAT_DBG_ASSERT(FALSE);
+    return NULL;
+}
+
+//
+// Returns the bucket for the destination CID. Must be called either from a
+// read section or with the Lookup->RwLock held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+QUIC_LOOKUP_NODE* volatile*
+QuicLookupHashGetBucket(
+    _In_ QUIC_LOOKUP_HASH* LookupHash,
+    _In_reads_(Length)
+        const uint8_t* const DestCid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    )
+{
+    CXPLAT_DBG_ASSERT(Length >= QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH);
+    CXPLAT_DBG_ASSERT(DestCid != NULL);
+    UNREFERENCED_PARAMETER(Length);
+
+    //
+    // Use the destination connection ID to get the index into the partitioned
+    // hash table array, and look up the bucket in that hash table.
+    //
+    QUIC_PARTITIONED_HASHTABLE* Table =
+        &LookupHash->Tables[
+            QuicLookupGetCidPartitionIndex(LookupHash->PartitionCount, DestCid, Hash)];
+    QUIC_LOOKUP_BUCKETS* Buckets = QuicReadPtrAcquire((void**)&Table->Buckets);
+    return &Buckets->Heads[Hash & Buckets->Mask];
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicLookupHashFindInChain(
+    _In_opt_ QUIC_LOOKUP_NODE* Node,
+    _In_reads_(Length)
+        const uint8_t* const DestCid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    )
+{
+    while (Node != NULL) {
+        if (Node->Hash == Hash &&
+            Node->CidLength == Length &&
+            memcmp(DestCid, Node->Cid, Length) == 0) {
+            return Node->Connection;
+        }
+        Node = QuicReadPtrAcquire((void**)&Node->Next);
+    }
+
+    return NULL;
+}
+
+//
+// Looks up the connection in the partitioned hash tables. Must be called
+// either from a read section or with the Lookup->RwLock held.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_CONNECTION*
+QuicLookupHashFind(
+    _In_ QUIC_LOOKUP_HASH* LookupHash,
+    _In_reads_(Length)
+        const uint8_t* const DestCid,
+    _In_ uint8_t Length,
+    _In_ uint32_t Hash
+    )
+{
+    QUIC_LOOKUP_NODE* volatile* Bucket =
+        QuicLookupHashGetBucket(LookupHash, DestCid, Length, Hash);
+    return
+        QuicLookupHashFindInChain(
+            QuicReadPtrAcquire((void**)Bucket), DestCid, Length, Hash);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupInitialize(
+    _Inout_ QUIC_LOOKUP* Lookup
+    )
+{
+    CxPlatZeroMemory(Lookup, sizeof(QUIC_LOOKUP));
+    CxPlatDispatchRwLockInitialize(&Lookup->RwLock);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupUninitialize(
+    _In_ QUIC_LOOKUP* Lookup
+    )
+{
+    CXPLAT_DBG_ASSERT(Lookup->CidCount == 0);
+
+    if (Lookup->PartitionCount == 0) {
+        CXPLAT_DBG_ASSERT(Lookup->SINGLE.Connection == NULL);
+    } else {
+        CXPLAT_DBG_ASSERT(Lookup->HASH.Hash != NULL);
+#if DEBUG
+        for (uint16_t i = 0; i < Lookup->PartitionCount; i++) {
+            CXPLAT_DBG_ASSERT(Lookup->HASH.Hash->Tables[i].NumEntries == 0);
+        }
+#endif
+        QuicLookupHashFree(Lookup->HASH.Hash);
+    }
+
+    if (Lookup->MaximizePartitioning) {
+        CXPLAT_DBG_ASSERT(Lookup->RemoteHashTable.NumEntries == 0);
+        CxPlatHashtableUninitialize(&Lookup->RemoteHashTable);
+    }
+
+    CxPlatDispatchRwLockUninitialize(&Lookup->RwLock);
 }
 
 //
@@ -150,43 +542,45 @@ QuicLookupRebalance(
 
     if (PartitionCount > Lookup->PartitionCount) {
 
-        uint16_t PreviousPartitionCount = Lookup->PartitionCount;
-        void* PreviousLookup = Lookup->LookupTable;
-        Lookup->LookupTable = NULL;
-
         CXPLAT_DBG_ASSERT(PartitionCount != 0);
 
-        if (!QuicLookupCreateHashTable(Lookup, PartitionCount)) {
-            Lookup->LookupTable = PreviousLookup;
+        //
+        // Build the new tables off to the side, so lock-free readers only ever
+        // see a complete set.
+        //
+        QUIC_LOOKUP_HASH* NewHash = QuicLookupHashCreate(PartitionCount);
+        if (NewHash == NULL) {
             return FALSE;
         }
 
-        //
-        // Move the CIDs to the new table.
-        //
+        QUIC_LOOKUP_HASH* PreviousHash = Lookup->HASH.Hash;
+        BOOLEAN Success = TRUE;
 
-        if (PreviousPartitionCount == 0) {
+        if (Lookup->PartitionCount == 0) {
 
             //
             // Only a single connection before. Enumerate all CIDs on the
-            // connection and reinsert them into the new table(s).
+            // connection and insert them into the new table(s).
             //
 
-            if (PreviousLookup != NULL) {
+            if (Lookup->SINGLE.Connection != NULL) {
                 CXPLAT_SLIST_ENTRY* Entry =
-                    ((QUIC_CONNECTION*)PreviousLookup)->SourceCids.Next;
+                    Lookup->SINGLE.Connection->SourceCids.Next;
 
-                while (Entry != NULL) {
+                while (Success && Entry != NULL) {
                     QUIC_CID_HASH_ENTRY *CID =
                         CXPLAT_CONTAINING_RECORD(
                             Entry,
                             QUIC_CID_HASH_ENTRY,
                             Link);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
+                    if (CID->CID.IsInLookupTable) {
+                        Success =
+                            QuicLookupHashInsert(
+                                NewHash,
+                                CID,
+                                CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
+                                FALSE);
+                    }
                     Entry = Entry->Next;
                 }
             }
@@ -194,43 +588,37 @@ QuicLookupRebalance(
         } else {
 
             //
-            // Changes the number of partitioned tables. Remove all the CIDs
-            // from the old tables and insert them into the new tables.
+            // Changes the number of partitioned tables. Insert all the CIDs
+            // from the old tables into the new tables.
             //
 
-            QUIC_PARTITIONED_HASHTABLE* PreviousTable = PreviousLookup;
-            for (uint16_t i = 0; i < PreviousPartitionCount; i++) {
-                CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableEnumerateBegin(&PreviousTable[i].Table, &Enumerator);
-#pragma warning(pop)
-                while (TRUE) {
-                    CXPLAT_HASHTABLE_ENTRY* Entry =
-                        CxPlatHashtableEnumerateNext(&PreviousTable[i].Table, &Enumerator);
-                    if (Entry == NULL) {
-                        CxPlatHashtableEnumerateEnd(&PreviousTable[i].Table, &Enumerator);
-                        break;
+            for (uint16_t i = 0; Success && i < PreviousHash->PartitionCount; i++) {
+                QUIC_LOOKUP_BUCKETS* Buckets = PreviousHash->Tables[i].Buckets;
+                for (uint32_t j = 0; Success && j <= Buckets->Mask; j++) {
+                    for (QUIC_LOOKUP_NODE* Node = Buckets->Heads[j];
+                         Success && Node != NULL;
+                         Node = Node->Next) {
+                        Success =
+                            QuicLookupHashInsert(
+                                NewHash, Node->SourceCid, Node->Hash, FALSE);
                     }
-                    CxPlatHashtableRemove(&PreviousTable[i].Table, Entry, NULL);
-
-                    QUIC_CID_HASH_ENTRY *CID =
-                        CXPLAT_CONTAINING_RECORD(
-                            Entry,
-                            QUIC_CID_HASH_ENTRY,
-                            Entry);
-                    (void)QuicLookupInsertLocalCid(
-                        Lookup,
-                        CxPlatHashSimple(CID->CID.Length, CID->CID.Data),
-                        CID,
-                        FALSE);
                 }
-#pragma warning(push)
-#pragma warning(disable:6001)
-                CxPlatHashtableUninitialize(&PreviousTable[i].Table);
-#pragma warning(pop)
             }
-            CXPLAT_FREE(PreviousTable, QUIC_POOL_LOOKUP_HASHTABLE);
+        }
+
+        if (!Success) {
+            QuicLookupHashFree(NewHash);
+            return FALSE;
+        }
+
+        QuicWritePtrRelease((void**)&Lookup->HASH.Hash, NewHash);
+        Lookup->SINGLE.Connection = NULL;
+        Lookup->PartitionCount = PartitionCount;
+
+        if (PreviousHash != NULL) {
+            PreviousHash->Retired.Next = NULL;
+            PreviousHash->Retired.Free = QuicLookupHashRetiredFree;
+            QuicLibraryRetire(&PreviousHash->Retired);
         }
     }
 
@@ -249,7 +637,7 @@ QuicLookupMaximizePartitioning(
 
     if (!Lookup->MaximizePartitioning) {
         Result =
-            CxPlatHashtableInitializeEx(
+            CxPlatHashtableInitializeOpenEx(
                 &Lookup->RemoteHashTable, CXPLAT_HASH_MIN_SIZE);
         if (Result) {
             Lookup->MaximizePartitioning = TRUE;
@@ -297,38 +685,8 @@ QuicCidMatchConnection(
 }
 
 //
-// Uses the hash and destination connection ID to look up the connection in the
-// hash table. Returns the pointer to the connection if found; NULL otherwise.
+// Requires Lookup->RwLock to be held (shared or exclusive).
 //
-_IRQL_requires_max_(DISPATCH_LEVEL)
-QUIC_CONNECTION*
-QuicHashLookupConnection(
-    _In_ CXPLAT_HASHTABLE* Table,
-    _In_reads_(Length)
-        const uint8_t* const DestCid,
-    _In_ uint8_t Length,
-    _In_ uint32_t Hash
-    )
-{
-    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
-    CXPLAT_HASHTABLE_ENTRY* TableEntry =
-        CxPlatHashtableLookup(Table, Hash, &Context);
-
-    while (TableEntry != NULL) {
-        QUIC_CID_HASH_ENTRY* CIDEntry =
-            CXPLAT_CONTAINING_RECORD(TableEntry, QUIC_CID_HASH_ENTRY, Entry);
-
-        if (CIDEntry->CID.Length == Length &&
-            memcmp(DestCid, CIDEntry->CID.Data, Length) == 0) {
-            return CIDEntry->Connection;
-        }
-
-        TableEntry = CxPlatHashtableLookupNext(Table, &Context);
-    }
-
-    return NULL;
-}
-
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicLookupFindConnectionByLocalCidInternal(
@@ -352,29 +710,7 @@ QuicLookupFindConnectionByLocalCidInternal(
         }
 
     } else {
-        CXPLAT_DBG_ASSERT(CIDLen >= QUIC_MIN_INITIAL_CONNECTION_ID_LENGTH);
-        CXPLAT_DBG_ASSERT(CID != NULL);
-
-        //
-        // Use the destination connection ID to get the index into the
-        // partitioned hash table array, and look up the connection in that
-        // hash table.
-        //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, CID + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireShared(&Table->RwLock, PrevIrql);
-        Connection =
-            QuicHashLookupConnection(
-                &Table->Table,
-                CID,
-                CIDLen,
-                Hash);
-        CxPlatDispatchRwLockReleaseShared(&Table->RwLock, PrevIrql);
+        Connection = QuicLookupHashFind(Lookup->HASH.Hash, CID, CIDLen, Hash);
     }
 
 #if QUIC_DEBUG_HASHTABLE_LOOKUP
@@ -450,26 +786,8 @@ QuicLookupInsertLocalCid(
             Lookup->SINGLE.Connection = SourceCid->Connection;
         }
 
-    } else {
-        CXPLAT_DBG_ASSERT(SourceCid->CID.Length >= MsQuicLib.CidServerIdLength + QUIC_CID_PID_LENGTH);
-
-        //
-        // Insert the source connection ID into the hash table.
-        //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock, PrevIrql);
-        CxPlatHashtableInsert(
-            &Table->Table,
-            &SourceCid->Entry,
-            Hash,
-            NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock, PrevIrql);
+    } else if (!QuicLookupHashInsert(Lookup->HASH.Hash, SourceCid, Hash, TRUE)) {
+        return FALSE;
     }
 
     if (UpdateRefCount) {
@@ -539,13 +857,17 @@ QuicLookupInsertRemoteHash(
 
 //
 // Removes a source connection ID from the lookup table. Requires the
-// Lookup->RwLock to be exlusively held.
+// Lookup->RwLock to be exlusively held. Any unlinked node is added to the
+// Retired list, which must be passed to QuicLookupNodesRetire. The node takes
+// its own reference on the connection, so the lookup reference can be
+// released right away.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicLookupRemoveLocalCidInt(
     _In_ QUIC_LOOKUP* Lookup,
-    _In_ QUIC_CID_HASH_ENTRY* SourceCid
+    _In_ QUIC_CID_HASH_ENTRY* SourceCid,
+    _Inout_ QUIC_LOOKUP_NODE** Retired
     )
 {
     CXPLAT_DBG_ASSERT(SourceCid->CID.IsInLookupTable);
@@ -570,15 +892,14 @@ QuicLookupRemoveLocalCidInt(
         //
         // Remove the source connection ID from the multi-hash table.
         //
-        CXPLAT_STATIC_ASSERT(QUIC_CID_PID_LENGTH == 2, "The code below assumes 2 bytes");
-        uint16_t PartitionIndex;
-        CxPlatCopyMemory(&PartitionIndex, SourceCid->CID.Data + MsQuicLib.CidServerIdLength, 2);
-        PartitionIndex &= MsQuicLib.PartitionMask;
-        PartitionIndex %= Lookup->PartitionCount;
-        QUIC_PARTITIONED_HASHTABLE* Table = &Lookup->HASH.Tables[PartitionIndex];
-        CxPlatDispatchRwLockAcquireExclusive(&Table->RwLock, PrevIrql);
-        CxPlatHashtableRemove(&Table->Table, &SourceCid->Entry, NULL);
-        CxPlatDispatchRwLockReleaseExclusive(&Table->RwLock, PrevIrql);
+        QUIC_LOOKUP_NODE* Node = QuicLookupHashRemove(Lookup->HASH.Hash, SourceCid);
+        if (Node != NULL) {
+            QuicConnAddRef(Node->Connection, QUIC_CONN_REF_LOOKUP_RESULT);
+            Node->HoldsRef = TRUE;
+            Node->Retired.Free = QuicLookupNodeFree;
+            Node->Retired.Next = *Retired != NULL ? &(*Retired)->Retired : NULL;
+            *Retired = Node;
+        }
     }
 }
 
@@ -592,25 +913,98 @@ QuicLookupFindConnectionByLocalCid(
     )
 {
     uint32_t Hash = CxPlatHashSimple(CIDLen, CID);
+    QUIC_CONNECTION* ExistingConnection = NULL;
 
-    CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
+    //
+    // Partitioned tables are read without the lock. The connection stays
+    // alive for the whole read section because a removed node keeps a
+    // reference on it until the node is freed, after a grace period.
+    //
+    uint32_t Epoch;
+    QUIC_PARTITION* Partition = QuicLibraryReadBegin(&Epoch);
+    QUIC_LOOKUP_HASH* LookupHash = QuicReadPtrAcquire((void**)&Lookup->HASH.Hash);
+    if (LookupHash != NULL) {
+        ExistingConnection = QuicLookupHashFind(LookupHash, CID, CIDLen, Hash);
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+    }
+    QuicLibraryReadEnd(Partition, Epoch);
 
-    QUIC_CONNECTION* ExistingConnection =
-        QuicLookupFindConnectionByLocalCidInternal(
-            Lookup,
-            CID,
-            CIDLen,
-            Hash);
+    if (LookupHash == NULL) {
+        CxPlatDispatchRwLockAcquireShared(&Lookup->RwLock, PrevIrql);
 
-    if (ExistingConnection != NULL) {
-        QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
-    }
+        ExistingConnection =
+            QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                CID,
+                CIDLen,
+                Hash);
 
-    CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+        if (ExistingConnection != NULL) {
+            QuicConnAddRef(ExistingConnection, QUIC_CONN_REF_LOOKUP_RESULT);
+        }
+
+        CxPlatDispatchRwLockReleaseShared(&Lookup->RwLock, PrevIrql);
+    }
 
     return ExistingConnection;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFindConnectionsByLocalCid(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_range_(<=, QUIC_LOOKUP_BATCH_MAX) uint32_t Count,
+    _In_reads_(Count) const uint8_t* const* CIDs,
+    _In_reads_(Count) const uint8_t* CIDLens,
+    _Out_writes_(Count) QUIC_CONNECTION** Connections
+    )
+{
+    CXPLAT_DBG_ASSERT(Count <= QUIC_LOOKUP_BATCH_MAX);
+
+    uint32_t Hashes[QUIC_LOOKUP_BATCH_MAX];
+    QUIC_LOOKUP_NODE* Nodes[QUIC_LOOKUP_BATCH_MAX];
+
+    uint32_t Epoch;
+    QUIC_PARTITION* Partition = QuicLibraryReadBegin(&Epoch);
+    QUIC_LOOKUP_HASH* LookupHash = QuicReadPtrAcquire((void**)&Lookup->HASH.Hash);
+    if (LookupHash != NULL) {
+        //
+        // Hash all the CIDs and prefetch their buckets, then prefetch the
+        // first node of each bucket, and only then walk the chains, so the
+        // cache misses of the whole batch overlap.
+        //
+        QUIC_LOOKUP_NODE* volatile* Buckets[QUIC_LOOKUP_BATCH_MAX];
+        for (uint32_t i = 0; i < Count; ++i) {
+            Hashes[i] = CxPlatHashSimple(CIDLens[i], CIDs[i]);
+            Buckets[i] = QuicLookupHashGetBucket(LookupHash, CIDs[i], CIDLens[i], Hashes[i]);
+            CxPlatPrefetch((void*)Buckets[i]);
+        }
+        for (uint32_t i = 0; i < Count; ++i) {
+            Nodes[i] = QuicReadPtrAcquire((void**)Buckets[i]);
+            if (Nodes[i] != NULL) {
+                CxPlatPrefetch(Nodes[i]);
+            }
+        }
+        for (uint32_t i = 0; i < Count; ++i) {
+            Connections[i] =
+                QuicLookupHashFindInChain(Nodes[i], CIDs[i], CIDLens[i], Hashes[i]);
+            if (Connections[i] != NULL) {
+                QuicConnAddRef(Connections[i], QUIC_CONN_REF_LOOKUP_RESULT);
+            }
+        }
+    }
+    QuicLibraryReadEnd(Partition, Epoch);
+
+    if (LookupHash == NULL) {
+        for (uint32_t i = 0; i < Count; ++i) {
+            Connections[i] =
+                QuicLookupFindConnectionByLocalCid(Lookup, CIDs[i], CIDLens[i]);
+        }
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_CONNECTION*
 QuicLookupFindConnectionByRemoteHash(
@@ -723,6 +1117,40 @@ QuicLookupAddLocalCid(
     return Result;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+QuicLookupAddLocalCids(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ uint8_t Count,
+    _In_reads_(Count)
+        QUIC_CID_HASH_ENTRY** SourceCids
+    )
+{
+    uint8_t AddedCount = 0;
+
+    CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
+
+    for (uint8_t i = 0; i < Count; ++i) {
+        QUIC_CID_HASH_ENTRY* SourceCid = SourceCids[i];
+        uint32_t Hash = CxPlatHashSimple(SourceCid->CID.Length, SourceCid->CID.Data);
+
+        CXPLAT_DBG_ASSERT(!SourceCid->CID.IsInLookupTable);
+
+        if (QuicLookupFindConnectionByLocalCidInternal(
+                Lookup,
+                SourceCid->CID.Data,
+                SourceCid->CID.Length,
+                Hash) == NULL &&
+            QuicLookupInsertLocalCid(Lookup, Hash, SourceCid, TRUE)) {
+            ++AddedCount;
+        }
+    }
+
+    CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
+
+    return AddedCount;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicLookupAddRemoteHash(
@@ -785,12 +1213,17 @@ QuicLookupRemoveLocalCid(
     _In_ CXPLAT_SLIST_ENTRY** Entry
     )
 {
+    QUIC_LOOKUP_NODE* Retired = NULL;
+    QUIC_CONNECTION* Connection = SourceCid->Connection;
+
     CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
-    QuicLookupRemoveLocalCidInt(Lookup, SourceCid);
+    QuicLookupRemoveLocalCidInt(Lookup, SourceCid, &Retired);
     SourceCid->CID.IsInLookupTable = FALSE;
     *Entry = (*Entry)->Next;
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
-    QuicConnRelease(SourceCid->Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+
+    QuicLookupNodesRetire(Retired);
+    QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -826,6 +1259,7 @@ QuicLookupRemoveLocalCids(
     )
 {
     uint8_t ReleaseRefCount = 0;
+    QUIC_LOOKUP_NODE* Retired = NULL;
 
     CxPlatDispatchRwLockAcquireExclusive(&Lookup->RwLock, PrevIrql);
     while (Connection->SourceCids.Next != NULL) {
@@ -835,7 +1269,7 @@ QuicLookupRemoveLocalCids(
                 QUIC_CID_HASH_ENTRY,
                 Link);
         if (CID->CID.IsInLookupTable) {
-            QuicLookupRemoveLocalCidInt(Lookup, CID);
+            QuicLookupRemoveLocalCidInt(Lookup, CID, &Retired);
             CID->CID.IsInLookupTable = FALSE;
             ReleaseRefCount++;
         }
@@ -843,6 +1277,8 @@ QuicLookupRemoveLocalCids(
     }
     CxPlatDispatchRwLockReleaseExclusive(&Lookup->RwLock, PrevIrql);
 
+    QuicLookupNodesRetire(Retired);
+
     for (uint8_t i = 0; i < ReleaseRefCount; i++) {
 #pragma prefast(suppress:6001, "SAL doesn't understand ref counts")
         QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
@@ -858,6 +1294,8 @@ QuicLookupMoveLocalConnectionIDs(
     )
 {
     CXPLAT_SLIST_ENTRY* Entry = Connection->SourceCids.Next;
+    QUIC_LOOKUP_NODE* Retired = NULL;
+    uint8_t ReleaseRefCount = 0;
 
     CxPlatDispatchRwLockAcquireExclusive(&LookupSrc->RwLock, PrevIrql1);
     while (Entry != NULL) {
@@ -867,13 +1305,18 @@ QuicLookupMoveLocalConnectionIDs(
                 QUIC_CID_HASH_ENTRY,
                 Link);
         if (CID->CID.IsInLookupTable) {
-            QuicLookupRemoveLocalCidInt(LookupSrc, CID);
-            QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+            QuicLookupRemoveLocalCidInt(LookupSrc, CID, &Retired);
+            ReleaseRefCount++;
         }
         Entry = Entry->Next;
     }
     CxPlatDispatchRwLockReleaseExclusive(&LookupSrc->RwLock, PrevIrql1);
 
+    QuicLookupNodesRetire(Retired);
+    for (uint8_t i = 0; i < ReleaseRefCount; i++) {
+        QuicConnRelease(Connection, QUIC_CONN_REF_LOOKUP_TABLE);
+    }
+
     CxPlatDispatchRwLockAcquireExclusive(&LookupDest->RwLock, PrevIrql2);
 #pragma prefast(suppress:6001, "SAL doesn't understand ref counts")
     Entry = Connection->SourceCids.Next;
@@ -5,7 +5,12 @@
 
 --*/
 
-typedef struct QUIC_PARTITIONED_HASHTABLE QUIC_PARTITIONED_HASHTABLE;
+typedef struct QUIC_LOOKUP_HASH QUIC_LOOKUP_HASH;
+
+//
+// The maximum number of CIDs resolved by one batched lookup.
+//
+#define QUIC_LOOKUP_BATCH_MAX   16
 
 typedef struct QUIC_REMOTE_HASH_ENTRY {
 
@@ -47,22 +52,21 @@ typedef struct QUIC_LOOKUP {
     //
     // Local CID lookup.
     //
-    union {
-        void* LookupTable;
-        struct {
-            //
-            // Single client connection is bound.
-            //
-            QUIC_CONNECTION* Connection;
-        } SINGLE;
-        struct {
-            //
-            // Set of partitioned hash tables.
-            //
-            _Field_size_bytes_(PartitionCount * sizeof(QUIC_PARTITIONED_HASHTABLE))
-            QUIC_PARTITIONED_HASHTABLE* Tables;
-        } HASH;
-    };
+    struct {
+        //
+        // Single client connection is bound. Only used when PartitionCount
+        // is 0.
+        //
+        QUIC_CONNECTION* Connection;
+    } SINGLE;
+    struct {
+        //
+        // Set of partitioned hash tables, or NULL when PartitionCount is 0.
+        // Packet receive reads this without the lock, so it is only ever
+        // replaced by a fully built set.
+        //
+        QUIC_LOOKUP_HASH* volatile Hash;
+    } HASH;
 
     //
     // Remote Hash lookup.
@@ -110,6 +114,21 @@ QuicLookupFindConnectionByLocalCid(
     _In_ uint8_t CIDLen
     );
 
+//
+// Resolves a batch of local CIDs at once. Each entry of Connections is set
+// to the connection with the corresponding CID (with a lookup reference), or
+// NULL.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicLookupFindConnectionsByLocalCid(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_range_(<=, QUIC_LOOKUP_BATCH_MAX) uint32_t Count,
+    _In_reads_(Count) const uint8_t* const* CIDs,
+    _In_reads_(Count) const uint8_t* CIDLens,
+    _Out_writes_(Count) QUIC_CONNECTION** Connections
+    );
+
 //
 // Returns the connection with the given remote hash, or NULL.
 //
@@ -144,6 +163,20 @@ QuicLookupAddLocalCid(
     _Out_opt_ QUIC_CONNECTION** Collision
     );
 
+//
+// Attempts to insert several local CIDs into the lookup, under a single lock
+// acquisition. Returns the number inserted; the ones that weren't (because of
+// a collision or allocation failure) don't have IsInLookupTable set.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t
+QuicLookupAddLocalCids(
+    _In_ QUIC_LOOKUP* Lookup,
+    _In_ uint8_t Count,
+    _In_reads_(Count)
+        QUIC_CID_HASH_ENTRY** SourceCids
+    );
+
 //
 // Attempts to insert the remote hash into the lookup.
 //
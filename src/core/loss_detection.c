@@ -20,6 +20,12 @@ Abstract:
         sent more than QUIC_PACKET_REORDER_THRESHOLD packets ago is assumed
         lost.
 
+    Both thresholds adapt (see RFC 8985, section 6.2): when a packet we
+    declared lost turns out to have only been reordered, the time threshold
+    widens in steps of RTT/8 and the packet threshold grows to the observed
+    reordering distance. They return to their defaults once loss recovery has
+    happened QUIC_REORDER_WINDOW_PERSIST times without that recurring.
+
 
     There are three logical timers in this module:
 
@@ -83,6 +89,47 @@ QuicLossDetectionInitializeInternalState(
     LossDetection->TimeOfLastAckedPacketSent = 0;
     LossDetection->AdjustedLastAckedTime = 0;
     LossDetection->ProbeCount = 0;
+    LossDetection->TailProbeArmed = FALSE;
+    LossDetection->TailProbeSent = FALSE;
+    LossDetection->StreamAck.STREAM.Stream = NULL;
+    LossDetection->ReorderWindowMultiplier = 1;
+    LossDetection->ReorderWindowPersist = 0;
+    LossDetection->PacketReorderThreshold = QUIC_PACKET_REORDER_THRESHOLD;
+    LossDetection->ReorderWindowRoundEnd = 0;
+    LossDetection->LossRecoveryEnd = 0;
+}
+
+//
+// Feeds a lost 1-RTT packet to the path's black hole detection, and updates
+// the datagram send length if the path MTU had to fall back.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionCheckMtuBlackHole(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
+
+    uint8_t PathIndex;
+    QUIC_PATH* Path = QuicConnGetPathByID(Connection, Packet->PathId, &PathIndex);
+    UNREFERENCED_PARAMETER(PathIndex);
+    if (Path == NULL) {
+        return;
+    }
+
+    uint16_t PacketMtu =
+        PacketSizeFromUdpPayloadSize(
+            QuicAddrGetFamily(&Path->Route.RemoteAddress),
+            Packet->PacketLength);
+    if (QuicMtuDiscoveryOnPacketLost(
+            &Path->MtuDiscovery,
+            Connection,
+            Packet->PacketNumber,
+            PacketMtu)) {
+        QuicDatagramOnSendStateChanged(&Connection->Datagram);
+    }
 }
 
 #if DEBUG
@@ -224,9 +271,18 @@ QuicLossDetectionComputeProbeTimeout(
     //
     // Microseconds.
     //
+    uint64_t RttVarianceTerm = 4 * Path->RttVariance;
+    if (Connection->Settings.DatacenterModeEnabled &&
+        RttVarianceTerm < QUIC_DATACENTER_TIMER_GRANULARITY) {
+        //
+        // With datacenter RTTs the variance can round down to nothing, so
+        // keep a (microsecond) floor on it instead.
+        //
+        RttVarianceTerm = QUIC_DATACENTER_TIMER_GRANULARITY;
+    }
     uint64_t Pto =
         Path->SmoothedRtt +
-        4 * Path->RttVariance +
+        RttVarianceTerm +
         MS_TO_US(Connection->PeerTransportParams.MaxAckDelay);
     Pto *= Count;
     return Pto;
@@ -235,9 +291,32 @@ QuicLossDetectionComputeProbeTimeout(
 typedef enum QUIC_LOSS_TIMER_TYPE {
     LOSS_TIMER_INITIAL,
     LOSS_TIMER_RACK,
-    LOSS_TIMER_PROBE
+    LOSS_TIMER_PROBE,
+    LOSS_TIMER_TAIL_PROBE
 } QUIC_LOSS_TIMER_TYPE;
 
+//
+// Returns TRUE if the outstanding packets are the tail of a small flight that
+// an early tail probe may be sent for.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicLossDetectionCanTailProbe(
+    _In_ const QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    const QUIC_CONNECTION* Connection =
+        QuicLossDetectionGetConnection((QUIC_LOSS_DETECTION*)LossDetection);
+    return
+        LossDetection->TailProbeEnabled &&
+        !LossDetection->TailProbeSent &&
+        LossDetection->ProbeCount == 0 &&
+        LossDetection->PacketsInFlight <= QUIC_TAIL_PROBE_MAX_PACKETS &&
+        Connection->Crypto.TlsState.WriteKey == QUIC_PACKET_KEY_1_RTT &&
+        CxPlatListIsEmpty(&Connection->Send.SendStreams);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionUpdateTimer(
@@ -246,6 +325,7 @@ QuicLossDetectionUpdateTimer(
     )
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
+    LossDetection->TailProbeArmed = FALSE;
 
     if (Connection->State.ClosedLocally || Connection->State.ClosedRemotely) {
         //
@@ -299,7 +379,9 @@ QuicLossDetectionUpdateTimer(
         //
         TimeoutType = LOSS_TIMER_RACK;
         uint64_t RttUs = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
-        TimeFires = OldestPacket->SentTime + QUIC_TIME_REORDER_THRESHOLD(RttUs);
+        TimeFires =
+            OldestPacket->SentTime +
+            QUIC_TIME_REORDER_THRESHOLD(RttUs, LossDetection->ReorderWindowMultiplier);
 
     } else if (!Path->GotFirstRttSample) {
 
@@ -317,7 +399,23 @@ QuicLossDetectionUpdateTimer(
             LossDetection->TimeOfLastPacketSent +
             QuicLossDetectionComputeProbeTimeout(
                 LossDetection, Path, 1 << LossDetection->ProbeCount);
+
+        if (QuicLossDetectionCanTailProbe(LossDetection)) {
+            //
+            // Losing the last packet of a short exchange would otherwise cost
+            // a full PTO. Probe early instead.
+            //
+            const uint64_t TailProbeFires =
+                LossDetection->TimeOfLastPacketSent +
+                QUIC_TAIL_PROBE_TIMEOUT(Path->SmoothedRtt) +
+                MS_TO_US(Connection->PeerTransportParams.MaxAckDelay);
+            if (CxPlatTimeAtOrBefore64(TailProbeFires, TimeFires)) {
+                TimeoutType = LOSS_TIMER_TAIL_PROBE;
+                TimeFires = TailProbeFires;
+            }
+        }
     }
+    LossDetection->TailProbeArmed = TimeoutType == LOSS_TIMER_TAIL_PROBE;
 
     uint64_t Delay; // In microseconds
     if (CxPlatTimeAtOrBefore64(TimeFires, TimeNow)) {
@@ -410,6 +508,10 @@ QuicLossDetectionOnPacketSent(
 
     Connection->Stats.Send.TotalPackets++;
     Connection->Stats.Send.TotalBytes += TempSentPacket->PacketLength;
+    QuicWorkerRecordMetric(
+        Connection->Worker,
+        QUIC_METRIC_HISTOGRAM_SEND_PACKET_SIZE,
+        TempSentPacket->PacketLength);
     if (SentPacket->Flags.IsAckEliciting) {
 
         if (LossDetection->PacketsInFlight == 0) {
@@ -429,6 +531,14 @@ QuicLossDetectionOnPacketSent(
             &Connection->CongestionControl, SentPacket->PacketLength);
     }
 
+    QuicProbe4(
+        packet_sent,
+        Connection,
+        SentPacket->PacketNumber,
+        SentPacket->PacketLength,
+        LossDetection->PacketsInFlight);
+    QuicQlogPacketSent(Connection, SentPacket);
+
     uint64_t SendPostedBytes = Connection->SendBuffer.PostedBytes;
 
     CXPLAT_LIST_ENTRY* Entry = Connection->Send.SendStreams.Flink;
@@ -457,13 +567,74 @@ QuicLossDetectionOnPacketSent(
         SentPacket->LastAckedPacketInfo.SentTime = LossDetection->TimeOfLastAckedPacketSent;
         SentPacket->LastAckedPacketInfo.AckTime = LossDetection->TimeOfLastPacketAcked;
         SentPacket->LastAckedPacketInfo.AdjustedAckTime = LossDetection->AdjustedLastAckedTime;
-        SentPacket->LastAckedPacketInfo.TotalBytesSent = LossDetection->TotalBytesSentAtLastAck;
+        CXPLAT_DBG_ASSERT(
+            SentPacket->TotalBytesSent - LossDetection->TotalBytesSentAtLastAck <= UINT32_MAX);
+        SentPacket->LastAckedPacketInfo.TotalBytesSentDelta =
+            (uint32_t)(SentPacket->TotalBytesSent - LossDetection->TotalBytesSentAtLastAck);
         SentPacket->LastAckedPacketInfo.TotalBytesAcked = LossDetection->TotalBytesAcked;
     }
 
     QuicLossValidate(LossDetection);
 }
 
+//
+// Delivers any pending merged STREAM frame acknowledgement to its stream.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLossDetectionFlushStreamAck(
+    _In_ QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    QUIC_STREAM* Stream = LossDetection->StreamAck.STREAM.Stream;
+    if (Stream != NULL) {
+        LossDetection->StreamAck.STREAM.Stream = NULL;
+        QuicStreamOnAck(
+            Stream,
+            LossDetection->StreamAckPacketFlags,
+            &LossDetection->StreamAck);
+    }
+}
+
+//
+// Acknowledges a STREAM frame. For explicit ACKs, the frame is merged into
+// the pending acknowledgement when it directly follows it on the same stream
+// and key type; the merged range is delivered by
+// QuicLossDetectionFlushStreamAck. The packet (and so its reference on the
+// stream) stays alive until the whole ACK frame is processed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLossDetectionOnStreamFrameAcknowledged(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ QUIC_SENT_PACKET_METADATA* Packet,
+    _In_ QUIC_SENT_FRAME_METADATA* Frame,
+    _In_ BOOLEAN IsImplicit
+    )
+{
+    if (IsImplicit) {
+        QuicStreamOnAck(Frame->STREAM.Stream, Packet->Flags, Frame);
+        return;
+    }
+
+    QUIC_SENT_FRAME_METADATA* Pending = &LossDetection->StreamAck;
+    if (Pending->STREAM.Stream == Frame->STREAM.Stream &&
+        LossDetection->StreamAckPacketFlags.KeyType == Packet->Flags.KeyType &&
+        !(Pending->Flags & QUIC_SENT_FRAME_FLAG_STREAM_FIN) &&
+        Pending->StreamOffset + Pending->StreamLength == Frame->StreamOffset &&
+        (uint32_t)Pending->StreamLength + Frame->StreamLength <= UINT16_MAX) {
+        Pending->StreamLength += Frame->StreamLength;
+        Pending->Flags |= Frame->Flags;
+        return;
+    }
+
+    QuicLossDetectionFlushStreamAck(LossDetection);
+    *Pending = *Frame;
+    LossDetection->StreamAckPacketFlags = Packet->Flags;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionOnPacketAcknowledged(
@@ -499,6 +670,14 @@ QuicLossDetectionOnPacketAcknowledged(
     }
 
     for (uint8_t i = 0; i < Packet->FrameCount; i++) {
+        if (Packet->Frames[i].Type < QUIC_FRAME_STREAM ||
+            Packet->Frames[i].Type > QUIC_FRAME_STREAM_7) {
+            //
+            // Keep the stream's view ordered with respect to other frames.
+            //
+            QuicLossDetectionFlushStreamAck(LossDetection);
+        }
+
         switch (Packet->Frames[i].Type) {
 
         case QUIC_FRAME_ACK:
@@ -528,10 +707,8 @@ QuicLossDetectionOnPacketAcknowledged(
         case QUIC_FRAME_STREAM_5:
         case QUIC_FRAME_STREAM_6:
         case QUIC_FRAME_STREAM_7:
-            QuicStreamOnAck(
-                Packet->Frames[i].STREAM.Stream,
-                Packet->Flags,
-                &Packet->Frames[i]);
+            QuicLossDetectionOnStreamFrameAcknowledged(
+                LossDetection, Packet, &Packet->Frames[i], IsImplicit);
             break;
 
         case QUIC_FRAME_STREAM_DATA_BLOCKED:
@@ -586,6 +763,7 @@ QuicLossDetectionOnPacketAcknowledged(
 
         case QUIC_FRAME_DATAGRAM:
         case QUIC_FRAME_DATAGRAM_1:
+        case QUIC_FRAME_FEC_SOURCE:
             QuicDatagramIndicateSendStateChange(
                 Connection,
                 &Packet->Frames[i].DATAGRAM.ClientContext,
@@ -621,6 +799,12 @@ QuicLossDetectionOnPacketAcknowledged(
                     Connection)) {
                 ChangedMtu = TRUE;
             }
+        } else if (Packet->Flags.KeyType == QUIC_PACKET_KEY_1_RTT) {
+            QuicMtuDiscoveryOnPacketAcked(
+                &Path->MtuDiscovery,
+                Connection,
+                Packet->PacketNumber,
+                PacketMtu);
         }
         if (ChangedMtu) {
             QuicDatagramOnSendStateChanged(&Connection->Datagram);
@@ -797,7 +981,7 @@ QuicLossDetectionRetransmitFrames(
                 CXPLAT_DBG_ASSERT(Connection->Configuration != NULL);
                 uint64_t ValidationTimeout =
                     CXPLAT_MAX(QuicLossDetectionComputeProbeTimeout(LossDetection, Path, 3),
-                        6 * MS_TO_US(Connection->Settings.InitialRttMs));
+                        6 * QuicConnGetInitialRtt(Connection));
                 if (CxPlatTimeDiff64(Path->PathValidationStartTime, TimeNow) > ValidationTimeout) {
                     QuicPerfCounterIncrement(
                         Connection->Partition, QUIC_PERF_COUNTER_PATH_FAILURE);
@@ -821,6 +1005,7 @@ QuicLossDetectionRetransmitFrames(
 
         case QUIC_FRAME_DATAGRAM:
         case QUIC_FRAME_DATAGRAM_1:
+        case QUIC_FRAME_FEC_SOURCE:
             if (!Packet->Flags.SuspectedLost) {
                 QuicDatagramIndicateSendStateChange(
                     Connection,
@@ -923,7 +1108,8 @@ QuicLossDetectionDetectAndHandleLostPackets(
         //
         const QUIC_PATH* Path = &Connection->Paths[0]; // TODO - Correct?
         uint64_t Rtt = CXPLAT_MAX(Path->SmoothedRtt, Path->LatestRttSample);
-        uint64_t TimeReorderThreshold = QUIC_TIME_REORDER_THRESHOLD(Rtt);
+        uint64_t TimeReorderThreshold =
+            QUIC_TIME_REORDER_THRESHOLD(Rtt, LossDetection->ReorderWindowMultiplier);
         uint64_t LargestLostPacketNumber = 0;
         QUIC_SENT_PACKET_METADATA* PrevPacket = NULL;
         Packet = LossDetection->SentPackets;
@@ -941,7 +1127,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
                 continue;
             }
 
-            if (Packet->PacketNumber + QUIC_PACKET_REORDER_THRESHOLD < LossDetection->LargestAck) {
+            if (Packet->PacketNumber + LossDetection->PacketReorderThreshold < LossDetection->LargestAck) {
                 if (!NonretransmittableHandshakePacket) {
                 }
             } else if (Packet->PacketNumber < LossDetection->LargestAck &&
@@ -955,6 +1141,11 @@ QuicLossDetectionDetectAndHandleLostPackets(
             Connection->Stats.Send.SuspectedLostPackets++;
             QuicPerfCounterIncrement(
                 Connection->Partition, QUIC_PERF_COUNTER_PKTS_SUSPECTED_LOST);
+            QuicQlogPacketLost(Connection, Packet, TimeNow);
+            if (!Packet->Flags.IsMtuProbe &&
+                Packet->Flags.KeyType == QUIC_PACKET_KEY_1_RTT) {
+                QuicLossDetectionCheckMtuBlackHole(LossDetection, Packet);
+            }
             if (Packet->Flags.IsAckEliciting) {
                 LossDetection->PacketsInFlight--;
                 LostRetransmittableBytes += Packet->PacketLength;
@@ -983,6 +1174,21 @@ QuicLossDetectionDetectAndHandleLostPackets(
         QuicLossValidate(LossDetection);
 
         if (LostRetransmittableBytes > 0) {
+            if (LargestLostPacketNumber >= LossDetection->LossRecoveryEnd) {
+                //
+                // A new loss recovery. Enough of them in a row without any
+                // spurious loss drops the adapted reordering tolerance.
+                //
+                LossDetection->LossRecoveryEnd =
+                    LossDetection->LargestSentPacketNumber + 1;
+                if (LossDetection->ReorderWindowPersist > 0 &&
+                    --LossDetection->ReorderWindowPersist == 0) {
+                    LossDetection->ReorderWindowMultiplier = 1;
+                    LossDetection->PacketReorderThreshold =
+                        QUIC_PACKET_REORDER_THRESHOLD;
+                }
+            }
+
             if (LossDetection->ProbeCount > QUIC_PERSISTENT_CONGESTION_THRESHOLD) {
                 //
                 // On persistent congestion, reset the peer's packet tolerance
@@ -1000,6 +1206,7 @@ QuicLossDetectionDetectAndHandleLostPackets(
             };
 
             QuicCongestionControlOnDataLost(&Connection->CongestionControl, &LossEvent);
+            QuicQlogMetricsUpdated(Connection);
             //
             // Send packets from any previously blocked streams.
             //
@@ -1195,6 +1402,37 @@ QuicLossDetectionOnZeroRttRejected(
     }
 }
 
+//
+// Widens the reordering tolerance after packets we declared lost were acked,
+// i.e. they were only reordered (RFC 8985, section 6.2).
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionOnSpuriousLoss(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ uint64_t ReorderDistance
+    )
+{
+    if (ReorderDistance > LossDetection->PacketReorderThreshold) {
+        LossDetection->PacketReorderThreshold =
+            (uint32_t)CXPLAT_MIN(ReorderDistance, QUIC_MAX_PACKET_REORDER_THRESHOLD);
+    }
+
+    //
+    // Only widen the time window once per round trip, since a single reordering
+    // event usually makes several packets look lost.
+    //
+    if (LossDetection->LargestAck >= LossDetection->ReorderWindowRoundEnd) {
+        LossDetection->ReorderWindowRoundEnd =
+            LossDetection->LargestSentPacketNumber + 1;
+        if (LossDetection->ReorderWindowMultiplier < QUIC_MAX_REORDER_WINDOW_MULTIPLIER) {
+            LossDetection->ReorderWindowMultiplier++;
+        }
+    }
+
+    LossDetection->ReorderWindowPersist = QUIC_REORDER_WINDOW_PERSIST;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionProcessAckBlocks(
@@ -1214,14 +1452,30 @@ QuicLossDetectionProcessAckBlocks(
     uint32_t AckedRetransmittableBytes = 0;
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
     uint64_t TimeNow = CxPlatTimeUs64();
+    //
+    // RTT samples are taken when the ACK was received, if known, so they
+    // don't include any of our own queuing delay.
+    //
+    const uint64_t AckRecvTime = Packet->RecvTimeUs != 0 ? Packet->RecvTimeUs : TimeNow;
     uint64_t MinRtt = UINT64_MAX;
     BOOLEAN NewLargestAck = FALSE;
     BOOLEAN NewLargestAckRetransmittable = FALSE;
     BOOLEAN NewLargestAckDifferentPath = FALSE;
     uint64_t NewLargestAckTimestamp = 0;
+    BOOLEAN FoundSpuriousLoss = FALSE;
+    uint64_t SpuriousReorderDistance = 0;
 
     *InvalidAckBlock = FALSE;
 
+    //
+    // N.B. Both the ACK blocks and the two packet lists are in ascending packet
+    // number order, so they are walked as a single merge: each list cursor only
+    // moves forward, and the cost is O(blocks + acked + skipped), not
+    // O(outstanding) per block. The skipped packets in SentPackets are the
+    // unacknowledged holes below LargestAck, which are bounded by
+    // PacketReorderThreshold because QuicLossDetectionDetectAndHandleLostPackets
+    // moves anything older to LostPackets after every ACK.
+    //
     QUIC_SENT_PACKET_METADATA** LostPacketsStart = &LossDetection->LostPackets;
     QUIC_SENT_PACKET_METADATA** SentPacketsStart = &LossDetection->SentPackets;
     QUIC_SENT_PACKET_METADATA* LargestAckedPacket = NULL;
@@ -1260,6 +1514,14 @@ QuicLossDetectionProcessAckBlocks(
                 Connection->Stats.Send.SpuriousLostPackets++;
                 QuicPerfCounterDecrement(
                     Connection->Partition, QUIC_PERF_COUNTER_PKTS_SUSPECTED_LOST);
+                if ((*End)->Flags.IsAckEliciting) {
+                    Connection->Stats.Send.SpuriousRetransmissions++;
+                }
+                if (LossDetection->LargestAck > (*End)->PacketNumber &&
+                    LossDetection->LargestAck - (*End)->PacketNumber > SpuriousReorderDistance) {
+                    SpuriousReorderDistance = LossDetection->LargestAck - (*End)->PacketNumber;
+                }
+                FoundSpuriousLoss = TRUE;
                 //
                 // NOTE: we don't increment AckedRetransmittableBytes here
                 // because we already told the congestion control module that
@@ -1344,6 +1606,10 @@ CheckSentPackets:
         }
     }
 
+    if (FoundSpuriousLoss) {
+        QuicLossDetectionOnSpuriousLoss(LossDetection, SpuriousReorderDistance);
+    }
+
     if (AckedPackets == NULL) {
         //
         // Nothing was acknowledged, so we can exit now.
@@ -1365,11 +1631,14 @@ CheckSentPackets:
             //
             // The packet was not acknowledged with the same encryption level.
             //
+            QuicLossDetectionFlushStreamAck(LossDetection);
             *InvalidAckBlock = TRUE;
             return;
         }
 
-        uint64_t PacketRtt = CxPlatTimeDiff64(PacketMeta->SentTime, TimeNow);
+        uint64_t PacketRtt =
+            CxPlatTimeDiff64(
+                PacketMeta->SentTime, CXPLAT_MAX(AckRecvTime, PacketMeta->SentTime));
 
         MinRtt = CXPLAT_MIN(MinRtt, PacketRtt);
 
@@ -1382,6 +1651,8 @@ CheckSentPackets:
         QuicLossDetectionOnPacketAcknowledged(LossDetection, EncryptLevel, PacketMeta, FALSE, TimeNow, AckDelay);
     }
 
+    QuicLossDetectionFlushStreamAck(LossDetection);
+
     QuicLossValidate(LossDetection);
 
     if (NewLargestAckRetransmittable && !NewLargestAckDifferentPath) {
@@ -1416,8 +1687,15 @@ CheckSentPackets:
             BOOLEAN EcnValidated = TRUE;
             int64_t EctCeDeltaSum = 0;
             if (Ecn != NULL) {
+                //
+                // Packets are all sent with the same ECT codepoint: ECT(1) for
+                // L4S congestion controllers and ECT(0) otherwise.
+                //
+                const BOOLEAN IsL4S = Connection->CongestionControl.IsL4S;
+                const uint64_t EctCount = IsL4S ? Ecn->ECT_1_Count : Ecn->ECT_0_Count;
+                const uint64_t OtherEctCount = IsL4S ? Ecn->ECT_0_Count : Ecn->ECT_1_Count;
                 EctCeDeltaSum += Ecn->CE_Count - Packets->EcnCeCounter;
-                EctCeDeltaSum += Ecn->ECT_0_Count - Packets->EcnEctCounter;
+                EctCeDeltaSum += EctCount - Packets->EcnEctCounter;
                 //
                 // Conditions where ECN validation fails:
                 // 1. Reneging ECN counts from the peer.
@@ -1425,13 +1703,14 @@ CheckSentPackets:
                 //
                 if (EctCeDeltaSum < 0 ||
                     EctCeDeltaSum < EcnEctCounter ||
-                    Ecn->ECT_1_Count != 0 ||
-                    Connection->Send.NumPacketsSentWithEct < Ecn->ECT_0_Count) {
+                    OtherEctCount != 0 ||
+                    Connection->Send.NumPacketsSentWithEct < EctCount) {
                     EcnValidated = FALSE;
                 } else {
+                    uint64_t NewCePackets = Ecn->CE_Count - Packets->EcnCeCounter;
                     BOOLEAN NewCE = Ecn->CE_Count > Packets->EcnCeCounter;
                     Packets->EcnCeCounter = Ecn->CE_Count;
-                    Packets->EcnEctCounter = Ecn->ECT_0_Count;
+                    Packets->EcnEctCounter = EctCount;
                     if (Path->EcnValidationState <= ECN_VALIDATION_UNKNOWN) {
                         Path->EcnValidationState = ECN_VALIDATION_CAPABLE;
                     }
@@ -1441,6 +1720,7 @@ CheckSentPackets:
                         QUIC_ECN_EVENT EcnEvent = {
                             .LargestPacketNumberAcked = LargestAckedPacketNum,
                             .LargestSentPacketNumber = LossDetection->LargestSentPacketNumber,
+                            .NewCePackets = (uint32_t)CXPLAT_MIN(NewCePackets, UINT32_MAX),
                         };
                         QuicCongestionControlOnEcn(&Connection->CongestionControl, &EcnEvent);
                     }
@@ -1480,7 +1760,7 @@ CheckSentPackets:
             .MinRtt = MinRtt,
             .OneWayDelay = Path->OneWayDelay,
             .HasLoss = (LossDetection->LostPackets != NULL),
-            .AdjustedAckTime = TimeNow - AckDelay,
+            .AdjustedAckTime = AckRecvTime - AckDelay,
             .AckedPackets = AckedPackets,
             .NumTotalAckedRetransmittableBytes = LossDetection->TotalBytesAcked,
             .IsLargestAckedPacketAppLimited = IsLargestAckedPacketAppLimited,
@@ -1496,6 +1776,7 @@ CheckSentPackets:
     }
 
     LossDetection->ProbeCount = 0;
+    LossDetection->TailProbeSent = FALSE;
 
     AckedPacketsIterator = AckedPackets;
     while (AckedPacketsIterator != NULL) {
@@ -1504,6 +1785,8 @@ CheckSentPackets:
         QuicSentPacketPoolReturnPacketMetadata(PacketMeta, Connection);
     }
 
+    QuicQlogMetricsUpdated(Connection);
+
     //
     // At least one packet was ACKed. If all packets were ACKed then we'll
     // cancel the timer; otherwise we'll reset the timer.
@@ -1582,18 +1865,18 @@ QuicLossDetectionProcessAckFrame(
 }
 
 //
-// Schedules a fixed number of (ACK-eliciting) probe packets to be sent.
+// Queues NumPackets (ACK-eliciting) probe packets to be sent.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
+static
 void
-QuicLossDetectionScheduleProbe(
-    _In_ QUIC_LOSS_DETECTION* LossDetection
+QuicLossDetectionQueueProbePackets(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ uint8_t NumPackets
     )
 {
     QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
 
-    LossDetection->ProbeCount++;
-
     //
     // Below, we will schedule a fixed number packets to be retransmitted. What
     // we'd like to do here send only that number of packets' worth of fresh
@@ -1604,15 +1887,19 @@ QuicLossDetectionScheduleProbe(
     // something is sent.
     //
 
-    //
-    // The spec says that 1 probe packet is a MUST but 2 is a MAY. Based on
-    // GQUIC's previous experience, we go with 2.
-    //
-    uint8_t NumPackets = 2;
-    QuicCongestionControlSetExemption(&Connection->CongestionControl, NumPackets);
     QuicSendQueueFlush(&Connection->Send, REASON_PROBE);
     Connection->Send.TailLossProbeNeeded = TRUE;
 
+    if (Connection->Crypto.TlsState.WriteKey == QUIC_PACKET_KEY_1_RTT &&
+        Connection->PeerTransportParams.Flags & QUIC_TP_FLAG_MIN_ACK_DELAY &&
+        Connection->PeerPacketTolerance > QUIC_MIN_ACK_SEND_NUMBER) {
+        //
+        // The peer has been asked to ACK less often, so make sure the probe
+        // gets an ACK right away rather than waiting on the peer's threshold.
+        //
+        QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK);
+    }
+
     if (Connection->Crypto.TlsState.WriteKey == QUIC_PACKET_KEY_1_RTT) {
         //
         // Check to see if any streams have fresh data to send out.
@@ -1654,6 +1941,44 @@ QuicLossDetectionScheduleProbe(
     QuicSendSetSendFlag(&Connection->Send, QUIC_CONN_SEND_FLAG_PING);
 }
 
+//
+// Schedules a fixed number of (ACK-eliciting) probe packets to be sent.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionScheduleProbe(
+    _In_ QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    QUIC_CONNECTION* Connection = QuicLossDetectionGetConnection(LossDetection);
+
+    LossDetection->ProbeCount++;
+
+    //
+    // The spec says that 1 probe packet is a MUST but 2 is a MAY. Based on
+    // GQUIC's previous experience, we go with 2.
+    //
+    const uint8_t NumPackets = 2;
+    QuicCongestionControlSetExemption(&Connection->CongestionControl, NumPackets);
+    QuicLossDetectionQueueProbePackets(LossDetection, NumPackets);
+}
+
+//
+// Schedules a single early probe for the tail of a small flight. Unlike PTO
+// probes, it isn't exempt from congestion control and doesn't count towards
+// the PTO backoff. The regular PTO still follows if it goes unacknowledged.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicLossDetectionScheduleTailProbe(
+    _In_ QUIC_LOSS_DETECTION* LossDetection
+    )
+{
+    LossDetection->TailProbeSent = TRUE;
+    QuicLossDetectionQueueProbePackets(LossDetection, 1);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicLossDetectionProcessTimerOperation(
@@ -1711,7 +2036,11 @@ QuicLossDetectionProcessTimerOperation(
         // send probes.
         //
         if (!QuicLossDetectionDetectAndHandleLostPackets(LossDetection, TimeNow)) {
-            QuicLossDetectionScheduleProbe(LossDetection);
+            if (LossDetection->TailProbeArmed) {
+                QuicLossDetectionScheduleTailProbe(LossDetection);
+            } else {
+                QuicLossDetectionScheduleProbe(LossDetection);
+            }
         }
 
         QuicLossDetectionUpdateTimer(LossDetection, FALSE);
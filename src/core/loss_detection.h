@@ -82,11 +82,42 @@ typedef struct QUIC_LOSS_DETECTION {
     QUIC_SENT_PACKET_METADATA* LostPackets;
     QUIC_SENT_PACKET_METADATA** LostPacketsTail;
 
+    //
+    // STREAM frame acknowledgements gathered while processing a single ACK
+    // frame. Contiguous frames for the same stream are merged so the stream
+    // gets one range update (and one send completion pass) per run instead of
+    // one per frame. StreamAck.STREAM.Stream is NULL when nothing is pending.
+    //
+    QUIC_SENT_FRAME_METADATA StreamAck;
+    QUIC_SEND_PACKET_FLAGS StreamAckPacketFlags;
+
     //
     // Number of probes sent.
     //
     uint16_t ProbeCount;
 
+    //
+    // Tail protection: whether the app enabled it, whether the loss detection
+    // timer is currently set for an early tail probe, and whether one has
+    // been sent since the last ACK.
+    //
+    BOOLEAN TailProbeEnabled : 1;
+    BOOLEAN TailProbeArmed : 1;
+    BOOLEAN TailProbeSent : 1;
+
+    //
+    // Adaptive reordering tolerance (RACK-TLP reo_wnd, RFC 8985). A spurious
+    // loss widens the time threshold by another RTT/8 (at most once per round
+    // trip) and raises the packet threshold to the reordering distance seen.
+    // Both go back to their defaults after ReorderWindowPersist more loss
+    // recoveries without a spurious loss.
+    //
+    uint8_t ReorderWindowMultiplier;
+    uint8_t ReorderWindowPersist;
+    uint32_t PacketReorderThreshold;
+    uint64_t ReorderWindowRoundEnd; // Packet Number
+    uint64_t LossRecoveryEnd; // Packet Number
+
 } QUIC_LOSS_DETECTION;
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -179,6 +210,22 @@ QuicLossDetectionProcessAckFrame(
     _Out_ BOOLEAN* InvalidFrame
     );
 
+//
+// Processes the decoded ACK blocks of a received ACK frame.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicLossDetectionProcessAckBlocks(
+    _In_ QUIC_LOSS_DETECTION* LossDetection,
+    _In_ QUIC_PATH* Path,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_ QUIC_ENCRYPT_LEVEL EncryptLevel,
+    _In_ uint64_t AckDelay,
+    _In_ QUIC_RANGE* AckBlocks,
+    _Out_ BOOLEAN* InvalidAckBlock,
+    _In_opt_ QUIC_ACK_ECN_EX* Ecn
+    );
+
 //
 // Called when the loss detection timer fires.
 //
@@ -10,22 +10,29 @@ Abstract:
     Upon a new path being validated, MTU discovery is started on that path.
     This is done by sending a probe packet larger than the current MTU.
 
-    If the probe packet is acknowledged, that is set as the current MTU and a
-    new probe packet is sent. This is repeated until the maximum allowed MTU is
-    reached.
-
-    If a probe packet is not ACKed, the probe at the same size will be retried.
-    If this fails QUIC_DPLPMTUD_MAX_PROBES times, max MTU is considered found
-    and searching stops.
-
-    Once searching has stopped, discovery will stay idle until
-    QUIC_DPLPMTUD_RAISE_TIMER_TIMEOUT has passed. The next send will then
-    trigger a new MTU discovery period, unless maximum allowed MTU is already
-    reached.
-
-    The current algorithm is very simplistic, increasing by 80 bytes each
-    probe. A special case is added so 1500 is always a checked value, as 1500
-    is often the max allowed over the internet.
+    Probe sizes are picked by a binary search between the current MTU and the
+    largest size not yet known to fail, which starts as the maximum allowed
+    MTU. The top of the range is probed first, so paths that support it (such
+    as 9000 byte jumbo frames in a datacenter) converge in a single round trip.
+    1280 and 1500 are also checked early, as they are the most common limits
+    on the internet.
+
+    If a probe packet is acknowledged, that is set as the current MTU. If a
+    probe is not ACKed, the probe at the same size will be retried. If this
+    fails QUIC_DPLPMTUD_MAX_PROBES times, the size becomes the new top of the
+    search range. Searching stops once the range is narrower than
+    QUIC_DPLPMTUD_SEARCH_ACCURACY.
+
+    Once searching has stopped, the MTU is cached per destination address,
+    so the next connection to that peer starts searching at it, and
+    discovery will stay idle until QUIC_DPLPMTUD_RAISE_TIMER_TIMEOUT has
+    passed. The next send will then trigger a new MTU discovery period,
+    unless maximum allowed MTU is already reached.
+
+    If packets above the base MTU start to disappear while later ones don't
+    get through either (a black hole, for instance after a route change),
+    the path falls back to the base MTU and searches again below the size
+    that was lost.
 
 --*/
 
@@ -54,10 +61,13 @@ QuicMtuDiscoveryMoveToSearchComplete(
     )
 {
     (void)Connection;
-    // QUIC_PATH* Path =
-    //     CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
+    QUIC_PATH* Path =
+        CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
     MtuDiscovery->IsSearchComplete = TRUE;
     MtuDiscovery->SearchCompleteEnterTimeUs = CxPlatTimeUs64();
+    QUIC_PATH_METRICS Metrics = { 0 };
+    Metrics.Mtu = Path->Mtu;
+    QuicLibraryCachePathMetrics(&Path->Route.RemoteAddress, &Metrics);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -69,34 +79,45 @@ QuicGetNextProbeSize(
 {
     QUIC_PATH* Path =
         CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
+
     //
-    // N.B. This algorithm must always be increasing. Other logic in the module
-    // depends on that behavior.
+    // Returning the current MTU means the search is done.
     //
+    if (MtuDiscovery->SearchHigh <= Path->Mtu) {
+        return Path->Mtu;
+    }
 
     //
-    // Jump automatically to 1280 to return algorithm to ideal case. 1280 should
-    // be supported in most scenarios. With minimum being 1248, this will always
-    // be less then a full increment.
+    // Try the top of the range first. It's most often right for paths with
+    // a known MTU, from the cache or the interface.
     //
-    if (Path->Mtu < 1280) {
-        return CXPLAT_MIN(1280, MtuDiscovery->MaxMtu);
+    if (!MtuDiscovery->HasProbedHigh) {
+        MtuDiscovery->HasProbedHigh = TRUE;
+        return MtuDiscovery->SearchHigh;
     }
 
-    uint16_t Mtu = Path->Mtu + QUIC_DPLPMTUD_INCREMENT;
-    if (Mtu > MtuDiscovery->MaxMtu) {
-        Mtu = MtuDiscovery->MaxMtu;
+    if (MtuDiscovery->SearchHigh - Path->Mtu < QUIC_DPLPMTUD_SEARCH_ACCURACY) {
+        return Path->Mtu;
     }
 
     //
-    // Our increasing algorithm might not hit 1500 by default. Ensure that
-    // happens.
+    // Jump automatically to 1280 to return algorithm to ideal case. 1280 should
+    // be supported in most scenarios. Once 1280 is known to be too large, fall
+    // back to the binary search below it.
     //
-    if (!MtuDiscovery->HasProbed1500 && Mtu >= 1500) {
+    if (Path->Mtu < 1280 && MtuDiscovery->SearchHigh >= 1280) {
+        return 1280;
+    }
+
+    //
+    // 1500 is the most common limit, so make sure it gets checked.
+    //
+    if (!MtuDiscovery->HasProbed1500 && MtuDiscovery->SearchHigh >= 1500) {
         MtuDiscovery->HasProbed1500 = TRUE;
-        Mtu = 1500;
+        return 1500;
     }
-    return Mtu;
+
+    return (uint16_t)((Path->Mtu + MtuDiscovery->SearchHigh + 1) / 2);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -108,6 +129,14 @@ QuicMtuDiscoveryMoveToSearching(
 {
     QUIC_PATH* Path =
         CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
+    if (MtuDiscovery->IsSearchComplete) {
+        //
+        // A new search period. The path may support more than it used to.
+        //
+        MtuDiscovery->SearchHigh = MtuDiscovery->MaxMtu;
+        MtuDiscovery->HasProbedHigh = FALSE;
+        MtuDiscovery->HasProbed1500 = Path->Mtu >= 1500;
+    }
     MtuDiscovery->IsSearchComplete = FALSE;
     MtuDiscovery->ProbeCount = 0;
     //
@@ -148,9 +177,27 @@ QuicMtuDiscoveryPeerValidated(
     // default
     //
     MtuDiscovery->MaxMtu = QuicConnGetMaxMtuForPath(Connection, Path);
-    MtuDiscovery->HasProbed1500 = Path->Mtu >= 1500;
     CXPLAT_DBG_ASSERT(Path->Mtu <= MtuDiscovery->MaxMtu);
 
+    //
+    // Search up to the MTU an earlier connection found for the same peer, if
+    // there is one. The first probe then validates it directly.
+    //
+    QUIC_PATH_METRICS Metrics;
+    (void)QuicLibraryGetPathMetrics(
+        &Path->Route.RemoteAddress,
+        Connection->Settings.MtuDiscoverySearchCompleteTimeoutUs,
+        &Metrics);
+    if (Metrics.Mtu != 0 && Metrics.Mtu < MtuDiscovery->MaxMtu) {
+        MtuDiscovery->SearchHigh = CXPLAT_MAX(Metrics.Mtu, Path->Mtu);
+    } else {
+        MtuDiscovery->SearchHigh = MtuDiscovery->MaxMtu;
+    }
+    MtuDiscovery->HasProbedHigh = FALSE;
+    MtuDiscovery->HasProbed1500 = Path->Mtu >= 1500;
+    MtuDiscovery->LargestAckedFullPacket = 0;
+    MtuDiscovery->BlackHoleLossCount = 0;
+    MtuDiscovery->IsSearchComplete = FALSE;
 
     QuicMtuDiscoveryMoveToSearching(MtuDiscovery, Connection);
 }
@@ -177,6 +224,9 @@ QuicMtuDiscoveryOnAckedPacket(
     // higher, otherwise attept next MTU size.
     //
     Path->Mtu = MtuDiscovery->ProbeSize;
+    if (MtuDiscovery->SearchHigh < Path->Mtu) {
+        MtuDiscovery->SearchHigh = Path->Mtu;
+    }
 
     if (Path->Mtu == MtuDiscovery->MaxMtu) {
         QuicMtuDiscoveryMoveToSearchComplete(MtuDiscovery, Connection);
@@ -195,8 +245,8 @@ QuicMtuDiscoveryProbePacketDiscarded(
     _In_ uint16_t PacketMtu
     )
 {
-    // QUIC_PATH* Path =
-    //     CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
+    QUIC_PATH* Path =
+        CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
     //
     // If out of order receives are received, ignore the packet
     //
@@ -204,16 +254,83 @@ QuicMtuDiscoveryProbePacketDiscarded(
         return;
     }
 
-
     //
-    // If we've done max probes, we've found our max, enter search complete
-    // waiting phase. Otherwise send out another probe of the same size.
+    // If we've done max probes, this size doesn't get through. Keep searching
+    // below it, or enter the search complete waiting phase if the range is
+    // exhausted. Otherwise send out another probe of the same size.
     //
     if (MtuDiscovery->ProbeCount >=
             (int16_t)Connection->Settings.MtuDiscoveryMissingProbeCount - 1) {
-        QuicMtuDiscoveryMoveToSearchComplete(MtuDiscovery, Connection);
+        if (!Path->IsMinMtuValidated) {
+            QuicMtuDiscoveryMoveToSearchComplete(MtuDiscovery, Connection);
+            return;
+        }
+        MtuDiscovery->SearchHigh = MtuDiscovery->ProbeSize - 1;
+        QuicMtuDiscoveryMoveToSearching(MtuDiscovery, Connection);
         return;
     }
     MtuDiscovery->ProbeCount++;
     QuicMtuDiscoverySendProbePacket(Connection);
 }
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnPacketAcked(
+    _In_ QUIC_MTU_DISCOVERY* MtuDiscovery,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t PacketNumber,
+    _In_ uint16_t PacketMtu
+    )
+{
+    if (PacketMtu <= Connection->Settings.MinimumMtu) {
+        return;
+    }
+
+    if (PacketNumber > MtuDiscovery->LargestAckedFullPacket) {
+        MtuDiscovery->LargestAckedFullPacket = PacketNumber;
+    }
+    MtuDiscovery->BlackHoleLossCount = 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicMtuDiscoveryOnPacketLost(
+    _In_ QUIC_MTU_DISCOVERY* MtuDiscovery,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t PacketNumber,
+    _In_ uint16_t PacketMtu
+    )
+{
+    QUIC_PATH* Path =
+        CXPLAT_CONTAINING_RECORD(MtuDiscovery, QUIC_PATH, MtuDiscovery);
+    const uint16_t BaseMtu = Connection->Settings.MinimumMtu;
+
+    if (PacketMtu <= BaseMtu || Path->Mtu <= BaseMtu) {
+        return FALSE;
+    }
+
+    //
+    // If a later packet of the same size got through, this is just congestion.
+    //
+    if (PacketNumber < MtuDiscovery->LargestAckedFullPacket) {
+        return FALSE;
+    }
+
+    if (++MtuDiscovery->BlackHoleLossCount < QUIC_DPLPMTUD_BLACK_HOLE_LOSS_THRESHOLD) {
+        return FALSE;
+    }
+
+    //
+    // Packets this large no longer get through. Fall back to the base MTU,
+    // which was validated, and search again below the lost size.
+    //
+    MtuDiscovery->BlackHoleLossCount = 0;
+    Path->Mtu = BaseMtu;
+    MtuDiscovery->SearchHigh = PacketMtu - 1;
+    MtuDiscovery->HasProbedHigh = TRUE; // Just below what was lost; skip it.
+    MtuDiscovery->HasProbed1500 = FALSE;
+    MtuDiscovery->IsSearchComplete = FALSE;
+    QuicMtuDiscoveryMoveToSearching(MtuDiscovery, Connection);
+
+    return TRUE;
+}
@@ -12,6 +12,12 @@ typedef struct QUIC_MTU_DISCOVERY {
     //
     uint64_t SearchCompleteEnterTimeUs;
 
+    //
+    // The largest 1-RTT packet number, among packets above the base MTU, that
+    // has been acknowledged. Used to tell black holes apart from congestion.
+    //
+    uint64_t LargestAckedFullPacket;
+
     //
     // The maximum MTU allowed by the current path.
     //
@@ -22,6 +28,12 @@ typedef struct QUIC_MTU_DISCOVERY {
     //
     uint16_t ProbeSize;
 
+    //
+    // The largest MTU not yet known to fail. The binary search runs between
+    // the path's current MTU and this.
+    //
+    uint16_t SearchHigh;
+
     //
     // The amount of probes that have occured at the current size.
     //
@@ -37,6 +49,17 @@ typedef struct QUIC_MTU_DISCOVERY {
     //
     BOOLEAN HasProbed1500       : 1;
 
+    //
+    // Whether the top of the search range has been probed yet.
+    //
+    BOOLEAN HasProbedHigh       : 1;
+
+    //
+    // Consecutive losses of packets above the base MTU, sent after
+    // LargestAckedFullPacket.
+    //
+    uint8_t BlackHoleLossCount  : 2;
+
 } QUIC_MTU_DISCOVERY;
 
 //
@@ -70,6 +93,31 @@ QuicMtuDiscoveryOnAckedPacket(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Track the ack of a regular (non-probe) 1-RTT packet for black hole detection.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicMtuDiscoveryOnPacketAcked(
+    _In_ QUIC_MTU_DISCOVERY* MtuDiscovery,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t PacketNumber,
+    _In_ uint16_t PacketMtu
+    );
+
+//
+// Handle the loss of a regular (non-probe) 1-RTT packet. Returns TRUE if a
+// black hole was detected and the path MTU fell back to the base MTU.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicMtuDiscoveryOnPacketLost(
+    _In_ QUIC_MTU_DISCOVERY* MtuDiscovery,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t PacketNumber,
+    _In_ uint16_t PacketMtu
+    );
+
 //
 // Handle an MTU discovery probe being discarded by loss detection when lost.
 //
@@ -24,6 +24,54 @@ Abstract:
 
 #include "precomp.h"
 
+//
+// The number of operations each lane may dequeue per round. The control lane
+// isn't weighted; it is always drained first.
+//
+static const uint8_t QuicOperationLaneWeights[QUIC_OPERATION_LANE_COUNT] = {
+    0,  // QUIC_OPERATION_LANE_CONTROL
+    4,  // QUIC_OPERATION_LANE_TIMER
+    4,  // QUIC_OPERATION_LANE_RECEIVE
+    2,  // QUIC_OPERATION_LANE_APP
+};
+
+QUIC_INLINE
+QUIC_OPERATION_LANE
+QuicOperationGetLane(
+    _In_ const QUIC_OPERATION* Oper
+    )
+{
+    switch (Oper->Type) {
+    case QUIC_OPER_TYPE_TIMER_EXPIRED:
+    case QUIC_OPER_TYPE_FLUSH_SEND:
+        return QUIC_OPERATION_LANE_TIMER;
+    case QUIC_OPER_TYPE_FLUSH_RECV:
+    case QUIC_OPER_TYPE_UNREACHABLE:
+    case QUIC_OPER_TYPE_FLUSH_STREAM_RECV:
+    case QUIC_OPER_TYPE_ROUTE_COMPLETION:
+    case QUIC_OPER_TYPE_TLS_COMPLETION:
+        return QUIC_OPERATION_LANE_RECEIVE;
+    default:
+        return QUIC_OPERATION_LANE_APP;
+    }
+}
+
+//
+// Returns TRUE if all lanes are empty. Must be called with the lock held.
+//
+QUIC_INLINE
+BOOLEAN
+QuicOperationQueueIsEmpty(
+    _In_ const QUIC_OPERATION_QUEUE* OperQ
+    )
+{
+    for (uint32_t i = 0; i < QUIC_OPERATION_LANE_COUNT; ++i) {
+        if (!CxPlatListIsEmpty(&OperQ->Lanes[i])) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
@@ -32,9 +80,12 @@ QuicOperationQueueInitialize(
     )
 {
     OperQ->ActivelyProcessing = FALSE;
+    OperQ->CurrentLane = QUIC_OPERATION_LANE_TIMER;
+    OperQ->LaneCredit = QuicOperationLaneWeights[QUIC_OPERATION_LANE_TIMER];
     CxPlatDispatchLockInitialize(&OperQ->Lock);
-    CxPlatListInitializeHead(&OperQ->List);
-    OperQ->PriorityTail = &OperQ->List.Flink;
+    for (uint32_t i = 0; i < QUIC_OPERATION_LANE_COUNT; ++i) {
+        CxPlatListInitializeHead(&OperQ->Lanes[i]);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -44,8 +95,7 @@ QuicOperationQueueUninitialize(
     )
 {
     UNREFERENCED_PARAMETER(OperQ);
-    CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&OperQ->List));
-    CXPLAT_DBG_ASSERT(OperQ->PriorityTail == &OperQ->List.Flink);
+    CXPLAT_DBG_ASSERT(QuicOperationQueueIsEmpty(OperQ));
     CxPlatDispatchLockUninitialize(&OperQ->Lock);
 }
 
@@ -107,10 +157,24 @@ QuicOperationFree(
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_START) {
             CXPLAT_DBG_ASSERT(ApiCtx->Completed == NULL);
             QuicStreamRelease(ApiCtx->STRM_START.Stream, QUIC_STREAM_REF_OPERATION);
+        } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_START_BATCH) {
+            CXPLAT_DBG_ASSERT(ApiCtx->Completed == NULL);
+            for (uint32_t i = 0; i < ApiCtx->STRM_START_BATCH.StreamCount; ++i) {
+                QuicStreamRelease(
+                    ApiCtx->STRM_START_BATCH.Streams[i], QUIC_STREAM_REF_OPERATION);
+            }
+            CXPLAT_FREE(ApiCtx->STRM_START_BATCH.Streams, QUIC_POOL_STREAM_BATCH);
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_SHUTDOWN) {
             QuicStreamRelease(ApiCtx->STRM_SHUTDOWN.Stream, QUIC_STREAM_REF_OPERATION);
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_SEND) {
             QuicStreamRelease(ApiCtx->STRM_SEND.Stream, QUIC_STREAM_REF_OPERATION);
+        } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_SEND_BATCH) {
+            for (uint32_t i = 0; i < ApiCtx->STRM_SEND_BATCH.EntryCount; ++i) {
+                QUIC_STREAM_SEND_BATCH_ENTRY* Entry = &ApiCtx->STRM_SEND_BATCH.Entries[i];
+                CXPLAT_DBG_ASSERT(Entry->Rejected == NULL);
+                QuicStreamRelease(Entry->Stream, QUIC_STREAM_REF_OPERATION);
+            }
+            CXPLAT_FREE(ApiCtx->STRM_SEND_BATCH.Entries, QUIC_POOL_STREAM_SEND_BATCH);
         } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_RECV_COMPLETE) {
             if (ApiCtx->STRM_RECV_COMPLETE.Stream) {
                 QuicStreamRelease(ApiCtx->STRM_RECV_COMPLETE.Stream, QUIC_STREAM_REF_OPERATION);
@@ -152,8 +216,8 @@ QuicOperationEnqueue(
 #if DEBUG
     CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertTail(&OperQ->List, &Oper->Link);
+    StartProcessing = QuicOperationQueueIsEmpty(OperQ) && !OperQ->ActivelyProcessing;
+    CxPlatListInsertTail(&OperQ->Lanes[QuicOperationGetLane(Oper)], &Oper->Link);
     CxPlatDispatchLockRelease(&OperQ->Lock);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
@@ -173,9 +237,8 @@ QuicOperationEnqueuePriority(
 #if DEBUG
     CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertTail(*OperQ->PriorityTail, &Oper->Link);
-    OperQ->PriorityTail = &Oper->Link.Flink;
+    StartProcessing = QuicOperationQueueIsEmpty(OperQ) && !OperQ->ActivelyProcessing;
+    CxPlatListInsertTail(&OperQ->Lanes[QUIC_OPERATION_LANE_CONTROL], &Oper->Link);
     CxPlatDispatchLockRelease(&OperQ->Lock);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
@@ -195,11 +258,8 @@ QuicOperationEnqueueFront(
 #if DEBUG
     CXPLAT_DBG_ASSERT(Oper->Link.Flink == NULL);
 #endif
-    StartProcessing = CxPlatListIsEmpty(&OperQ->List) && !OperQ->ActivelyProcessing;
-    CxPlatListInsertHead(&OperQ->List, &Oper->Link);
-    if (OperQ->PriorityTail == &OperQ->List.Flink) {
-        OperQ->PriorityTail = &Oper->Link.Flink;
-    }
+    StartProcessing = QuicOperationQueueIsEmpty(OperQ) && !OperQ->ActivelyProcessing;
+    CxPlatListInsertHead(&OperQ->Lanes[QUIC_OPERATION_LANE_CONTROL], &Oper->Link);
     CxPlatDispatchLockRelease(&OperQ->Lock);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUED, 1);
     QuicPerfCounterAdd(Partition, QUIC_PERF_COUNTER_CONN_OPER_QUEUE_DEPTH, 1);
@@ -213,22 +273,37 @@ QuicOperationDequeue(
     _In_ QUIC_PARTITION* Partition
     )
 {
-    QUIC_OPERATION* Oper;
+    QUIC_OPERATION* Oper = NULL;
     CxPlatDispatchLockAcquire(&OperQ->Lock);
-    if (CxPlatListIsEmpty(&OperQ->List)) {
+    CXPLAT_LIST_ENTRY* Entry = NULL;
+    if (!CxPlatListIsEmpty(&OperQ->Lanes[QUIC_OPERATION_LANE_CONTROL])) {
+        Entry = CxPlatListRemoveHead(&OperQ->Lanes[QUIC_OPERATION_LANE_CONTROL]);
+    } else {
+        //
+        // Weighted round robin over the remaining lanes. Every lane gets
+        // checked once, plus the starting lane again with a fresh credit.
+        //
+        for (uint32_t i = 0; i < QUIC_OPERATION_LANE_COUNT; ++i) {
+            if (OperQ->LaneCredit != 0 &&
+                !CxPlatListIsEmpty(&OperQ->Lanes[OperQ->CurrentLane])) {
+                OperQ->LaneCredit--;
+                Entry = CxPlatListRemoveHead(&OperQ->Lanes[OperQ->CurrentLane]);
+                break;
+            }
+            OperQ->CurrentLane =
+                OperQ->CurrentLane + 1 == QUIC_OPERATION_LANE_COUNT ?
+                    QUIC_OPERATION_LANE_CONTROL + 1 : OperQ->CurrentLane + 1;
+            OperQ->LaneCredit = QuicOperationLaneWeights[OperQ->CurrentLane];
+        }
+    }
+    if (Entry == NULL) {
         OperQ->ActivelyProcessing = FALSE;
-        Oper = NULL;
     } else {
         OperQ->ActivelyProcessing = TRUE;
-        Oper =
-            CXPLAT_CONTAINING_RECORD(
-                CxPlatListRemoveHead(&OperQ->List), QUIC_OPERATION, Link);
+        Oper = CXPLAT_CONTAINING_RECORD(Entry, QUIC_OPERATION, Link);
 #if DEBUG
         Oper->Link.Flink = NULL;
 #endif
-        if (OperQ->PriorityTail == &Oper->Link.Flink) {
-            OperQ->PriorityTail = &OperQ->List.Flink;
-        }
     }
     CxPlatDispatchLockRelease(&OperQ->Lock);
 
@@ -250,8 +325,9 @@ QuicOperationQueueClear(
 
     CxPlatDispatchLockAcquire(&OperQ->Lock);
     OperQ->ActivelyProcessing = FALSE;
-    CxPlatListMoveItems(&OperQ->List, &OldList);
-    OperQ->PriorityTail = &OperQ->List.Flink;
+    for (uint32_t i = 0; i < QUIC_OPERATION_LANE_COUNT; ++i) {
+        CxPlatListMoveItems(&OperQ->Lanes[i], &OldList);
+    }
     CxPlatDispatchLockRelease(&OperQ->Lock);
 
     int64_t OperationsDequeued = 0;
@@ -276,6 +352,32 @@ QuicOperationQueueClear(
                             QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
                             0);
                     }
+                } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_START_BATCH) {
+                    CXPLAT_DBG_ASSERT(ApiCtx->Completed == NULL);
+                    for (uint32_t i = 0; i < ApiCtx->STRM_START_BATCH.StreamCount; ++i) {
+                        QUIC_STREAM* Stream = ApiCtx->STRM_START_BATCH.Streams[i];
+                        QuicStreamIndicateStartComplete(Stream, QUIC_STATUS_ABORTED);
+                        if (ApiCtx->STRM_START_BATCH.Flags & QUIC_STREAM_START_FLAG_SHUTDOWN_ON_FAIL) {
+                            QuicStreamShutdown(
+                                Stream,
+                                QUIC_STREAM_SHUTDOWN_FLAG_ABORT | QUIC_STREAM_SHUTDOWN_FLAG_IMMEDIATE,
+                                0);
+                        }
+                    }
+                } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_SEND_BATCH) {
+                    for (uint32_t i = 0; i < ApiCtx->STRM_SEND_BATCH.EntryCount; ++i) {
+                        QUIC_STREAM_SEND_BATCH_ENTRY* Entry = &ApiCtx->STRM_SEND_BATCH.Entries[i];
+                        if (Entry->Rejected != NULL) {
+                            QuicStreamCompleteSendRequest(
+                                Entry->Stream, Entry->Rejected, TRUE, FALSE);
+                            Entry->Rejected = NULL;
+                        }
+                    }
+                } else if (ApiCtx->Type == QUIC_API_TYPE_CONN_EXECUTE) {
+                    ApiCtx->CONN_EXECUTE.Handler(
+                        ApiCtx->CONN_EXECUTE.Connection,
+                        ApiCtx->CONN_EXECUTE.Context,
+                        QUIC_STATUS_ABORTED);
                 } else if (ApiCtx->Type == QUIC_API_TYPE_STRM_SEND &&
                     !ApiCtx->STRM_START.Stream->Flags.Started) {
                     QuicStreamShutdown(
@@ -29,6 +29,8 @@ typedef enum QUIC_OPERATION_TYPE {
     QUIC_OPER_TYPE_TIMER_EXPIRED,       // A timer expired.
     QUIC_OPER_TYPE_TRACE_RUNDOWN,       // A trace rundown was triggered.
     QUIC_OPER_TYPE_ROUTE_COMPLETION,    // Process route completion event.
+    QUIC_OPER_TYPE_TLS_COMPLETION,      // Process offloaded TLS completion.
+    QUIC_OPER_TYPE_DRAIN,               // The registration started draining.
 
     //
     // All stateless operations follow.
@@ -62,9 +64,21 @@ typedef enum QUIC_API_TYPE {
     QUIC_API_TYPE_CONN_COMPLETE_RESUMPTION_TICKET_VALIDATION,
     QUIC_API_TYPE_CONN_COMPLETE_CERTIFICATE_VALIDATION,
     QUIC_API_TYPE_STRM_PROVIDE_RECV_BUFFERS,
+    QUIC_API_TYPE_STRM_START_BATCH,
+    QUIC_API_TYPE_CONN_EXECUTE,
+    QUIC_API_TYPE_STRM_SEND_BATCH,
 
 } QUIC_API_TYPE;
 
+//
+// A stream send queued by StreamSendBatch. Rejected is set (instead of the
+// request being queued on the stream) if the stream couldn't send any more.
+//
+typedef struct QUIC_STREAM_SEND_BATCH_ENTRY {
+    QUIC_STREAM* Stream;
+    QUIC_SEND_REQUEST* Rejected;
+} QUIC_STREAM_SEND_BATCH_ENTRY;
+
 //
 // Context for an API call. This is allocated separately from QUIC_OPERATION
 // so that non-API-call operations will take less space.
@@ -138,6 +152,16 @@ typedef struct QUIC_API_CONTEXT {
             QUIC_STREAM* Stream;
             QUIC_STREAM_START_FLAGS Flags;
         } STRM_START;
+        struct {
+            QUIC_STREAM** Streams;
+            uint32_t StreamCount;
+            QUIC_STREAM_START_FLAGS Flags;
+        } STRM_START_BATCH;
+        struct {
+            HQUIC Connection;
+            QUIC_CONNECTION_EXECUTE_HANDLER* Handler;
+            void* Context;
+        } CONN_EXECUTE;
         struct {
             QUIC_STREAM* Stream;
             QUIC_STREAM_SHUTDOWN_FLAGS Flags;
@@ -146,6 +170,10 @@ typedef struct QUIC_API_CONTEXT {
         struct {
             QUIC_STREAM* Stream;
         } STRM_SEND;
+        struct {
+            QUIC_STREAM_SEND_BATCH_ENTRY* Entries;
+            uint32_t EntryCount;
+        } STRM_SEND_BATCH;
         struct {
             QUIC_STREAM* Stream;
         } STRM_RECV_COMPLETE;
@@ -176,12 +204,15 @@ typedef struct QUIC_API_CONTEXT {
 
 typedef enum QUIC_CONN_TIMER_TYPE {
 
-    QUIC_CONN_TIMER_PACING,
     QUIC_CONN_TIMER_ACK_DELAY,
     QUIC_CONN_TIMER_LOSS_DETECTION,
     QUIC_CONN_TIMER_KEEP_ALIVE,
     QUIC_CONN_TIMER_IDLE,
+    QUIC_CONN_TIMER_HIBERNATE,
+    QUIC_CONN_TIMER_STATS_SAMPLE,
     QUIC_CONN_TIMER_SHUTDOWN,
+    QUIC_CONN_TIMER_CORK,
+    QUIC_CONN_TIMER_RECV_BATCH,
 
     QUIC_CONN_TIMER_COUNT
 
@@ -269,6 +300,22 @@ QuicOperLog(
     }
 }
 
+//
+// The lanes of an operation queue. The control lane holds operations queued
+// with priority and is always serviced first. The remaining lanes are
+// serviced with weighted round robin, so that timer and send flush (ACK and
+// loss recovery) work and received packets don't wait behind bursts of app
+// API calls.
+//
+typedef enum QUIC_OPERATION_LANE {
+    QUIC_OPERATION_LANE_CONTROL,        // Priority and front of queue operations.
+    QUIC_OPERATION_LANE_TIMER,          // Expired timers and send flushes.
+    QUIC_OPERATION_LANE_RECEIVE,        // Receive flushes and network events.
+    QUIC_OPERATION_LANE_APP,            // App API calls and everything else.
+    QUIC_OPERATION_LANE_COUNT
+
+} QUIC_OPERATION_LANE;
+
 //
 // A queue of operations to be executed for a connection.
 //
@@ -280,11 +327,17 @@ typedef struct QUIC_OPERATION_QUEUE {
     BOOLEAN ActivelyProcessing;
 
     //
-    // Queue of pending operations.
+    // The weighted lane currently being serviced and the number of operations
+    // it may still dequeue before moving on to the next lane.
+    //
+    uint8_t CurrentLane;
+    uint8_t LaneCredit;
+
+    //
+    // Queues of pending operations, one per lane.
     //
     CXPLAT_DISPATCH_LOCK Lock;
-    CXPLAT_LIST_ENTRY List;
-    CXPLAT_LIST_ENTRY** PriorityTail; // Tail of the priority queue.
+    CXPLAT_LIST_ENTRY Lanes[QUIC_OPERATION_LANE_COUNT];
 
 } QUIC_OPERATION_QUEUE;
 
@@ -336,14 +389,14 @@ QuicOperationHasPriority(
     )
 {
     CxPlatDispatchLockAcquire(&OperQ->Lock);
-    BOOLEAN HasPriorityWork = (&OperQ->List.Flink != OperQ->PriorityTail);
+    BOOLEAN HasPriorityWork = !CxPlatListIsEmpty(&OperQ->Lanes[QUIC_OPERATION_LANE_CONTROL]);
     CxPlatDispatchLockRelease(&OperQ->Lock);
     return HasPriorityWork;
 }
 
 //
-// Enqueues an operation. Returns TRUE if the queue was previously empty and not
-// already being processed.
+// Enqueues an operation on the lane for its type. Returns TRUE if the queue was
+// previously empty and not already being processed.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
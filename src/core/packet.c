@@ -16,7 +16,7 @@ Abstract:
 // The list of supported QUIC version numbers and associated salts/secrets.
 // The list is in priority order (highest to lowest).
 //
-const QUIC_VERSION_INFO QuicSupportedVersionList[] = {
+const QUIC_VERSION_INFO QuicSupportedVersionList[QUIC_SUPPORTED_VERSION_COUNT] = {
     { QUIC_VERSION_2,
       { 0x0d, 0xed, 0xe3, 0xde, 0xf7, 0x00, 0xa6, 0xdb, 0x81, 0x93,
         0x81, 0xbe, 0x6e, 0x26, 0x9d, 0xcb, 0xf9, 0xbd, 0x2e, 0xd9 },
@@ -114,7 +114,7 @@ QuicPacketValidateInvariant(
     //
     if (Packet->AvailBufferLength == 0 ||
         Packet->AvailBufferLength < QuicMinPacketLengths[Packet->Invariant->IsLongHeader]) {
-        QuicPacketLogDrop(Owner, Packet, "Too small for Packet->Invariant");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Too small for Packet->Invariant");
         return FALSE;
     }
 
@@ -124,7 +124,7 @@ QuicPacketValidateInvariant(
 
         DestCidLen = Packet->Invariant->LONG_HDR.DestCidLength;
         if (Packet->AvailBufferLength < MIN_INV_LONG_HDR_LENGTH + DestCidLen) {
-            QuicPacketLogDrop(Owner, Packet, "LH no room for DestCid");
+            QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "LH no room for DestCid");
             return FALSE;
         }
 
@@ -133,7 +133,7 @@ QuicPacketValidateInvariant(
         SourceCidLen = *(DestCid + DestCidLen);
         Packet->HeaderLength = MIN_INV_LONG_HDR_LENGTH + DestCidLen + SourceCidLen;
         if (Packet->AvailBufferLength < Packet->HeaderLength) {
-            QuicPacketLogDrop(Owner, Packet, "LH no room for SourceCid");
+            QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "LH no room for SourceCid");
             return FALSE;
         }
         SourceCid = DestCid + sizeof(uint8_t) + DestCidLen;
@@ -150,7 +150,7 @@ QuicPacketValidateInvariant(
         Packet->HeaderLength = sizeof(uint8_t) + DestCidLen;
 
         if (Packet->AvailBufferLength < Packet->HeaderLength) {
-            QuicPacketLogDrop(Owner, Packet, "SH no room for DestCid");
+            QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "SH no room for DestCid");
             return FALSE;
         }
 
@@ -167,7 +167,7 @@ QuicPacketValidateInvariant(
 
         if (Packet->DestCidLen != DestCidLen ||
             memcmp(Packet->DestCid, DestCid, DestCidLen) != 0) {
-            QuicPacketLogDrop(Owner, Packet, "DestCid don't match");
+            QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "DestCid don't match");
             return FALSE;
         }
 
@@ -177,7 +177,7 @@ QuicPacketValidateInvariant(
 
             if (Packet->SourceCidLen != SourceCidLen ||
                 memcmp(Packet->SourceCid, SourceCid, SourceCidLen) != 0) {
-                QuicPacketLogDrop(Owner, Packet, "SourceCid don't match");
+                QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "SourceCid don't match");
                 return FALSE;
             }
         }
@@ -225,7 +225,11 @@ QuicPacketValidateLongHeaderV1(
 
     if (Packet->DestCidLen > QUIC_MAX_CONNECTION_ID_LENGTH_V1 ||
         Packet->SourceCidLen > QUIC_MAX_CONNECTION_ID_LENGTH_V1) {
-        QuicPacketLogDrop(Owner, Packet, "Greater than allowed max CID length");
+        QuicPacketLogDrop(
+            Owner,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Greater than allowed max CID length");
         return FALSE;
     }
 
@@ -235,7 +239,12 @@ QuicPacketValidateLongHeaderV1(
     CXPLAT_DBG_ASSERT(IsServer == 0 || IsServer == 1);
     if ((Packet->LH->Version != QUIC_VERSION_2 && QUIC_HEADER_TYPE_ALLOWED_V1[IsServer][Packet->LH->Type] == FALSE) ||
         (Packet->LH->Version == QUIC_VERSION_2 && QUIC_HEADER_TYPE_ALLOWED_V2[IsServer][Packet->LH->Type] == FALSE)) {
-        QuicPacketLogDropWithValue(Owner, Packet, "Invalid client/server packet type", Packet->LH->Type);
+        QuicPacketLogDropWithValue(
+            Owner,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Invalid client/server packet type",
+            Packet->LH->Type);
         return FALSE;
     }
 
@@ -243,7 +252,7 @@ QuicPacketValidateLongHeaderV1(
     // Check the Fixed bit to ensure it is set to 1, unless we ignore it.
     //
     if (IgnoreFixedBit == FALSE && Packet->LH->FixedBit == 0) {
-        QuicPacketLogDrop(Owner, Packet, "Invalid LH FixedBit bits values");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Invalid LH FixedBit bits values");
         return FALSE;
     }
 
@@ -260,7 +269,12 @@ QuicPacketValidateLongHeaderV1(
             //
             // All client initial packets need to be padded to a minimum length.
             //
-            QuicPacketLogDropWithValue(Owner, Packet, "Client Long header Initial packet too short", Packet->AvailBufferLength);
+            QuicPacketLogDropWithValue(
+                Owner,
+                Packet,
+                QUIC_RECV_DROP_INVALID_PACKET,
+                "Client Long header Initial packet too short",
+                Packet->AvailBufferLength);
             return FALSE;
         }
 
@@ -270,12 +284,21 @@ QuicPacketValidateLongHeaderV1(
                 Packet->AvailBuffer,
                 &Offset,
                 &TokenLengthVarInt)) {
-            QuicPacketLogDrop(Owner, Packet, "Long header has invalid token length");
+            QuicPacketLogDrop(
+                Owner,
+                Packet,
+                QUIC_RECV_DROP_INVALID_PACKET,
+                "Long header has invalid token length");
             return FALSE;
         }
 
         if ((uint64_t)Packet->AvailBufferLength < Offset + TokenLengthVarInt) {
-            QuicPacketLogDropWithValue(Owner, Packet, "Long header has token length larger than buffer length", TokenLengthVarInt);
+            QuicPacketLogDropWithValue(
+                Owner,
+                Packet,
+                QUIC_RECV_DROP_INVALID_PACKET,
+                "Long header has token length larger than buffer length",
+                TokenLengthVarInt);
             return FALSE;
         }
 
@@ -296,17 +319,30 @@ QuicPacketValidateLongHeaderV1(
             Packet->AvailBuffer,
             &Offset,
             &LengthVarInt)) {
-        QuicPacketLogDrop(Owner, Packet, "Long header has invalid payload length");
+        QuicPacketLogDrop(
+            Owner,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Long header has invalid payload length");
         return FALSE;
     }
 
     if ((uint64_t)Packet->AvailBufferLength < Offset + LengthVarInt) {
-        QuicPacketLogDropWithValue(Owner, Packet, "Long header has length larger than buffer length", LengthVarInt);
+        QuicPacketLogDropWithValue(
+            Owner,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Long header has length larger than buffer length",
+            LengthVarInt);
         return FALSE;
     }
 
     if (Packet->AvailBufferLength < Offset + sizeof(uint32_t)) {
-        QuicPacketLogDropWithValue(Owner, Packet, "Long Header doesn't have enough room for packet number",
+        QuicPacketLogDropWithValue(
+            Owner,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Long Header doesn't have enough room for packet number",
             Packet->AvailBufferLength);
         return FALSE;
     }
@@ -328,6 +364,7 @@ QuicPacketValidateLongHeaderV1(
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicPacketGenerateRetryIntegrity(
+    _In_ QUIC_PARTITION* Partition,
     _In_ const QUIC_VERSION_INFO* Version,
     _In_ uint8_t OrigDestCidLength,
     _In_reads_(OrigDestCidLength) const uint8_t* const OrigDestCid,
@@ -338,33 +375,14 @@ QuicPacketGenerateRetryIntegrity(
         uint8_t* IntegrityField
     )
 {
-    CXPLAT_SECRET Secret;
-    Secret.Hash = CXPLAT_HASH_SHA256;
-    Secret.Aead = CXPLAT_AEAD_AES_128_GCM;
-    CxPlatCopyMemory(
-        Secret.Secret,
-        Version->RetryIntegritySecret,
-        QUIC_VERSION_RETRY_INTEGRITY_SECRET_LENGTH);
-
-    uint8_t* RetryPseudoPacket = NULL;
-    QUIC_PACKET_KEY* RetryIntegrityKey = NULL;
-    QUIC_STATUS Status =
-        QuicPacketKeyDerive(
-            QUIC_PACKET_KEY_INITIAL,
-            &Version->HkdfLabels,
-            &Secret,
-            "RetryIntegrity",
-            FALSE,
-            &RetryIntegrityKey);
-    if (QUIC_FAILED(Status)) {
-        goto Exit;
-    }
+    const uint32_t VersionIndex = (uint32_t)(Version - QuicSupportedVersionList);
+    CXPLAT_DBG_ASSERT(VersionIndex < ARRAYSIZE(Partition->RetryIntegrityKeys));
 
     uint16_t RetryPseudoPacketLength = sizeof(uint8_t) + OrigDestCidLength + BufferLength;
-    RetryPseudoPacket = (uint8_t*)CXPLAT_ALLOC_PAGED(RetryPseudoPacketLength, QUIC_POOL_TMP_ALLOC);
+    uint8_t* RetryPseudoPacket =
+        (uint8_t*)CXPLAT_ALLOC_PAGED(RetryPseudoPacketLength, QUIC_POOL_TMP_ALLOC);
     if (RetryPseudoPacket == NULL) {
-        Status = QUIC_STATUS_OUT_OF_MEMORY;
-        goto Exit;
+        return QUIC_STATUS_OUT_OF_MEMORY;
     }
     uint8_t* RetryPseudoPacketCursor = RetryPseudoPacket;
 
@@ -374,20 +392,49 @@ QuicPacketGenerateRetryIntegrity(
     RetryPseudoPacketCursor += OrigDestCidLength;
     CxPlatCopyMemory(RetryPseudoPacketCursor, Buffer, BufferLength);
 
-    Status =
-        CxPlatEncrypt(
-            RetryIntegrityKey->PacketKey,
-            RetryIntegrityKey->Iv,
-            RetryPseudoPacketLength,
-            RetryPseudoPacket,
-            QUIC_RETRY_INTEGRITY_TAG_LENGTH_V1,
-            IntegrityField);
-
-Exit:
-    if (RetryPseudoPacket != NULL) {
-        CXPLAT_FREE(RetryPseudoPacket, QUIC_POOL_TMP_ALLOC);
+    //
+    // The integrity key only depends on the version, so each partition derives
+    // it once and keeps it. Keys aren't safe for concurrent use, hence the lock.
+    //
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    CxPlatDispatchLockAcquire(&Partition->RetryIntegrityKeysLock);
+
+    if (Partition->RetryIntegrityKeys[VersionIndex] == NULL) {
+        CXPLAT_SECRET Secret;
+        Secret.Hash = CXPLAT_HASH_SHA256;
+        Secret.Aead = CXPLAT_AEAD_AES_128_GCM;
+        CxPlatCopyMemory(
+            Secret.Secret,
+            Version->RetryIntegritySecret,
+            QUIC_VERSION_RETRY_INTEGRITY_SECRET_LENGTH);
+
+        Status =
+            QuicPacketKeyDerive(
+                QUIC_PACKET_KEY_INITIAL,
+                &Version->HkdfLabels,
+                &Secret,
+                "RetryIntegrity",
+                FALSE,
+                &Partition->RetryIntegrityKeys[VersionIndex]);
+        CxPlatSecureZeroMemory(&Secret, sizeof(Secret));
     }
-    QuicPacketKeyFree(RetryIntegrityKey);
+
+    if (QUIC_SUCCEEDED(Status)) {
+        const QUIC_PACKET_KEY* RetryIntegrityKey =
+            Partition->RetryIntegrityKeys[VersionIndex];
+        Status =
+            CxPlatEncrypt(
+                RetryIntegrityKey->PacketKey,
+                RetryIntegrityKey->Iv,
+                RetryPseudoPacketLength,
+                RetryPseudoPacket,
+                QUIC_RETRY_INTEGRITY_TAG_LENGTH_V1,
+                IntegrityField);
+    }
+
+    CxPlatDispatchLockRelease(&Partition->RetryIntegrityKeysLock);
+
+    CXPLAT_FREE(RetryPseudoPacket, QUIC_POOL_TMP_ALLOC);
     return Status;
 }
 
@@ -395,6 +442,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != 0)
 uint16_t
 QuicPacketEncodeRetryV1(
+    _In_ QUIC_PARTITION* Partition,
     _In_ uint32_t Version,
     _In_reads_(DestCidLength) const uint8_t* const DestCid,
     _In_ uint8_t DestCidLength,
@@ -459,6 +507,7 @@ QuicPacketEncodeRetryV1(
 
     if (QUIC_FAILED(
         QuicPacketGenerateRetryIntegrity(
+            Partition,
             VersionInfo,
             OrigDestCidLength,
             OrigDestCid,
@@ -520,32 +569,36 @@ QuicPacketValidateInitialToken(
 {
     const BOOLEAN IsNewToken = TokenBuffer[0] & 0x1;
     if (IsNewToken) {
-        QuicPacketLogDrop(Owner, Packet, "New Token not supported");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_TOKEN, "New Token not supported");
         *DropPacket = TRUE;
         return FALSE; // TODO - Support NEW_TOKEN tokens.
     }
 
     if (TokenLength != sizeof(QUIC_TOKEN_CONTENTS)) {
-        QuicPacketLogDrop(Owner, Packet, "Invalid Token Length");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Invalid Token Length");
         *DropPacket = TRUE;
         return FALSE;
     }
 
     QUIC_TOKEN_CONTENTS Token;
     if (!QuicRetryTokenDecrypt(Packet, TokenBuffer, &Token)) {
-        QuicPacketLogDrop(Owner, Packet, "Retry Token Decryption Failure");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_TOKEN, "Retry Token Decryption Failure");
         *DropPacket = TRUE;
         return FALSE;
     }
 
     if (Token.Encrypted.OrigConnIdLength > sizeof(Token.Encrypted.OrigConnId)) {
-        QuicPacketLogDrop(Owner, Packet, "Invalid Retry Token OrigConnId Length");
+        QuicPacketLogDrop(
+            Owner,
+            Packet,
+            QUIC_RECV_DROP_INVALID_PACKET,
+            "Invalid Retry Token OrigConnId Length");
         *DropPacket = TRUE;
         return FALSE;
     }
 
     if (!QuicAddrCompare(&Token.Encrypted.RemoteAddress, &Packet->Route->RemoteAddress)) {
-        QuicPacketLogDrop(Owner, Packet, "Retry Token Addr Mismatch");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_TOKEN, "Retry Token Addr Mismatch");
         *DropPacket = TRUE;
         return FALSE;
     }
@@ -574,7 +627,7 @@ QuicPacketValidateShortHeaderV1(
     // Check the Fixed bit to ensure it is set to 1, unless we ignore it.
     //
     if (IgnoreFixedBit == FALSE && Packet->SH->FixedBit == 0) {
-        QuicPacketLogDrop(Owner, Packet, "Invalid SH FixedBit bits values");
+        QuicPacketLogDrop(Owner, Packet, QUIC_RECV_DROP_INVALID_PACKET, "Invalid SH FixedBit bits values");
         return FALSE;
     }
 
@@ -626,6 +679,7 @@ void
 QuicPacketLogDrop(
     _In_ const void* Owner, // Binding or Connection depending on state
     _In_ const QUIC_RX_PACKET* Packet,
+    _In_ QUIC_RECV_DROP_REASON DropReason,
     _In_z_ const char* Reason
     )
 {
@@ -635,9 +689,10 @@ QuicPacketLogDrop(
     } else {
         InterlockedIncrement64((int64_t*)&((QUIC_BINDING*)Owner)->Stats.Recv.DroppedPackets);
     }
-    QuicPerfCounterIncrement(
-        &MsQuicLib.Partitions[Packet->PartitionIndex],
-        QUIC_PERF_COUNTER_PKTS_DROPPED);
+    QUIC_PARTITION* Partition = &MsQuicLib.Partitions[Packet->PartitionIndex];
+    QuicPerfCounterIncrement(Partition, QUIC_PERF_COUNTER_PKTS_DROPPED);
+    CXPLAT_DBG_ASSERT(DropReason < QUIC_RECV_DROP_REASON_COUNT);
+    InterlockedIncrement64(&Partition->RecvDropCounters[DropReason]);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -645,18 +700,11 @@ void
 QuicPacketLogDropWithValue(
     _In_ const void* Owner, // Binding or Connection depending on state
     _In_ const QUIC_RX_PACKET* Packet,
+    _In_ QUIC_RECV_DROP_REASON DropReason,
     _In_z_ const char* Reason,
     _In_ uint64_t Value
     )
 {
-    (void)Reason;
     (void)Value;
-    if (Packet->AssignedToConnection) {
-        InterlockedIncrement64((int64_t*)&((QUIC_CONNECTION*)Owner)->Stats.Recv.DroppedPackets);
-    } else {
-        InterlockedIncrement64((int64_t*)&((QUIC_BINDING*)Owner)->Stats.Recv.DroppedPackets);
-    }
-    QuicPerfCounterIncrement(
-        &MsQuicLib.Partitions[Packet->PartitionIndex],
-        QUIC_PERF_COUNTER_PKTS_DROPPED);
+    QuicPacketLogDrop(Owner, Packet, DropReason, Reason);
 }
@@ -35,7 +35,7 @@ typedef struct QUIC_VERSION_INFO {
 //
 // The list of supported QUIC versions.
 //
-extern const QUIC_VERSION_INFO QuicSupportedVersionList[4];
+extern const QUIC_VERSION_INFO QuicSupportedVersionList[QUIC_SUPPORTED_VERSION_COUNT];
 
 //
 // Prefixes used in packet logging.
@@ -499,6 +499,7 @@ QuicPacketEncodeLongHeaderV1(
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 QuicPacketGenerateRetryIntegrity(
+    _In_ QUIC_PARTITION* Partition,
     _In_ const QUIC_VERSION_INFO* Version,
     _In_ uint8_t OrigDestCidLength,
     _In_reads_(OrigDestCidLength) const uint8_t* const OrigDestCid,
@@ -516,6 +517,7 @@ _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != 0)
 uint16_t
 QuicPacketEncodeRetryV1(
+    _In_ QUIC_PARTITION* Partition,
     _In_ uint32_t Version,
     _In_reads_(DestCidLength) const uint8_t* const DestCid,
     _In_ uint8_t DestCidLength,
@@ -611,6 +613,7 @@ void
 QuicPacketLogDrop(
     _In_ const void* Owner, // Binding or Connection depending on state
     _In_ const QUIC_RX_PACKET* Packet,
+    _In_ QUIC_RECV_DROP_REASON DropReason,
     _In_z_ const char* Reason
     );
 
@@ -619,6 +622,7 @@ void
 QuicPacketLogDropWithValue(
     _In_ const void* Owner, // Binding or Connection depending on state
     _In_ const QUIC_RX_PACKET* Packet,
+    _In_ QUIC_RECV_DROP_REASON DropReason,
     _In_z_ const char* Reason,
     _In_ uint64_t Value
     );
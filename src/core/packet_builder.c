@@ -50,7 +50,8 @@ QuicPacketBuilderValidate(
 
     CXPLAT_DBG_ASSERT(Builder->Path != NULL);
     CXPLAT_DBG_ASSERT(Builder->Path->DestCid != NULL);
-    CXPLAT_DBG_ASSERT(Builder->BatchCount <= QUIC_MAX_CRYPTO_BATCH_COUNT);
+    CXPLAT_DBG_ASSERT(Builder->BatchCount <= Builder->BatchLimit);
+    CXPLAT_DBG_ASSERT(Builder->BatchLimit <= QUIC_MAX_SEND_CRYPTO_BATCH_COUNT);
 
     if (Builder->Key != NULL) {
         CXPLAT_DBG_ASSERT(Builder->Key->PacketKey != NULL);
@@ -95,8 +96,19 @@ QuicPacketBuilderInitialize(
     )
 {
     CXPLAT_DBG_ASSERT(Path->DestCid != NULL);
+    CXPLAT_DBG_ASSERT(Connection->Worker != NULL);
     Builder->Connection = Connection;
     Builder->Path = Path;
+    Builder->EncryptBatch = Connection->Worker->SendEncryptBatch;
+    Builder->CipherBatch = Connection->Worker->SendCipherBatch;
+    Builder->HpMask = Connection->Worker->SendHpMask;
+    //
+    // Parallel packet protection hands batches off to the offload threads as
+    // soon as they are offload sized.
+    //
+    Builder->BatchLimit =
+        Connection->ProtectOffloads != NULL ?
+            QUIC_MAX_CRYPTO_BATCH_COUNT : QUIC_MAX_SEND_CRYPTO_BATCH_COUNT;
     Builder->PacketBatchSent = FALSE;
     Builder->PacketBatchRetransmittable = FALSE;
     Builder->WrittenConnectionCloseFrame = FALSE;
@@ -115,18 +127,66 @@ QuicPacketBuilderInitialize(
             Link);
 
     uint64_t TimeNow = CxPlatTimeUs64();
-    uint64_t TimeSinceLastSend;
-    if (Connection->Send.LastFlushTimeValid) {
-        TimeSinceLastSend =
-            CxPlatTimeDiff64(Connection->Send.LastFlushTime, TimeNow);
-    } else {
-        TimeSinceLastSend = 0;
-    }
+    const uint64_t PacingRate =
+        QuicCongestionControlGetPacingRate(&Connection->CongestionControl);
+    Builder->PacingRate = MsQuicLib.SendTxTimeSupported ? PacingRate : 0;
+    Builder->Paced = FALSE;
+    Builder->EgressLimited = FALSE;
     Builder->SendAllowance =
         QuicCongestionControlGetSendAllowance(
-            &Connection->CongestionControl,
-            TimeSinceLastSend,
-            Connection->Send.LastFlushTimeValid);
+            &Connection->CongestionControl, 0, FALSE);
+    if (Builder->PacingRate != 0) {
+        //
+        // The kernel paces the sends out, so anything the congestion window
+        // allows can be handed down, as long as it doesn't get scheduled too
+        // far into the future.
+        //
+        if (CxPlatTimeAtOrBefore64(Connection->Send.NextTxTime, TimeNow)) {
+            Connection->Send.NextTxTime = TimeNow;
+        }
+        const uint64_t Backlog =
+            CxPlatTimeDiff64(TimeNow, Connection->Send.NextTxTime);
+        if (Backlog >= QUIC_SEND_TXTIME_HORIZON_US) {
+            Builder->SendAllowance = 0;
+        } else {
+            const uint64_t HorizonAllowance =
+                Builder->PacingRate * (QUIC_SEND_TXTIME_HORIZON_US - Backlog) /
+                CXPLAT_MICROSEC_PER_SEC;
+            if (Builder->SendAllowance > HorizonAllowance) {
+                Builder->SendAllowance = (uint32_t)HorizonAllowance;
+            }
+        }
+    } else if (PacingRate != 0 && Connection->Send.LastFlushTimeValid) {
+        //
+        // Pace the sends out in bursts from the connection's token bucket.
+        //
+        const uint32_t PacingAllowance =
+            QuicSendGetPacingAllowance(&Connection->Send, PacingRate, TimeNow);
+        if (Builder->SendAllowance > PacingAllowance) {
+            Builder->SendAllowance = PacingAllowance;
+        }
+        Builder->Paced = TRUE;
+    } else {
+        //
+        // Nothing to pace (yet). Start with a full bucket once pacing starts.
+        //
+        Connection->Send.PacerTokensValid = FALSE;
+        Connection->Send.PacerRate = 0;
+    }
+    if (Connection->Send.EgressRateLimit != 0 ||
+        (Connection->Registration != NULL &&
+         Connection->Registration->EgressRateLimit != 0)) {
+        //
+        // The app's egress rate limits apply on top of congestion control and
+        // pacing.
+        //
+        const uint32_t EgressAllowance =
+            QuicSendGetEgressAllowance(&Connection->Send, TimeNow);
+        if (Builder->SendAllowance > EgressAllowance) {
+            Builder->SendAllowance = EgressAllowance;
+        }
+        Builder->EgressLimited = TRUE;
+    }
     if (Builder->SendAllowance > Path->Allowance) {
         Builder->SendAllowance = Path->Allowance;
     }
@@ -143,6 +203,7 @@ QuicPacketBuilderCleanup(
     )
 {
     CXPLAT_DBG_ASSERT(Builder->SendData == NULL);
+    CXPLAT_DBG_ASSERT(Builder->ProtectOffloadCount == 0);
 
     if (Builder->PacketBatchSent && Builder->PacketBatchRetransmittable) {
         QuicLossDetectionUpdateTimer(&Builder->Connection->LossDetection, FALSE);
@@ -150,7 +211,76 @@ QuicPacketBuilderCleanup(
 
     QuicSentPacketMetadataReleaseFrames(Builder->Metadata, Builder->Connection);
 
-    CxPlatSecureZeroMemory(Builder->HpMask, sizeof(Builder->HpMask));
+    CxPlatSecureZeroMemory(
+        Builder->HpMask, CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_SEND_CRYPTO_BATCH_COUNT);
+}
+
+//
+// Writes a 1-RTT short header by copying the path's header template, rebuilt
+// first if it was invalidated, and encoding just the packet number after it.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Success_(return != 0)
+uint16_t
+QuicPacketBuilderEncodeShortHeader(
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
+    _In_ BOOLEAN KeyPhase,
+    _In_ BOOLEAN FixedBit,
+    _In_ uint16_t BufferLength,
+    _Out_writes_bytes_(BufferLength)
+        uint8_t* Buffer
+    )
+{
+    QUIC_PATH* Path = Builder->Path;
+
+    if (Path->ShortHeaderTemplateLength == 0 ||
+        (Path->ShortHeaderTemplate[0] & 0x03) != Builder->PacketNumberLength - 1) {
+        const uint16_t TemplateLength =
+            QuicPacketEncodeShortHeaderV1(
+                &Path->DestCid->CID,
+                0,
+                Builder->PacketNumberLength,
+                Path->SpinBit,
+                KeyPhase,
+                FixedBit,
+                sizeof(Path->ShortHeaderTemplate),
+                Path->ShortHeaderTemplate);
+        CXPLAT_DBG_ASSERT(TemplateLength > Builder->PacketNumberLength);
+        Path->ShortHeaderTemplateLength =
+            (uint8_t)(TemplateLength - Builder->PacketNumberLength);
+    }
+
+    const uint16_t HeaderLength =
+        Path->ShortHeaderTemplateLength + Builder->PacketNumberLength;
+    if (BufferLength < HeaderLength) {
+        return 0;
+    }
+
+    CxPlatCopyMemory(Buffer, Path->ShortHeaderTemplate, Path->ShortHeaderTemplateLength);
+    QuicPktNumEncode(
+        Builder->Metadata->PacketNumber,
+        Builder->PacketNumberLength,
+        Buffer + Path->ShortHeaderTemplateLength);
+
+#if DEBUG
+    //
+    // Catch any header field change that missed invalidating the template.
+    //
+    uint8_t Expected[sizeof(Path->ShortHeaderTemplate)];
+    CXPLAT_DBG_ASSERT(
+        QuicPacketEncodeShortHeaderV1(
+            &Path->DestCid->CID,
+            Builder->Metadata->PacketNumber,
+            Builder->PacketNumberLength,
+            Path->SpinBit,
+            KeyPhase,
+            FixedBit,
+            sizeof(Expected),
+            Expected) == HeaderLength);
+    CXPLAT_DBG_ASSERT(memcmp(Expected, Buffer, HeaderLength) == 0);
+#endif
+
+    return HeaderLength;
 }
 
 //
@@ -211,9 +341,13 @@ QuicPacketBuilderPrepare(
     QUIC_PARTITION* Partition = Connection->Partition;
     const uint64_t PartitionShifted = ((uint64_t)Partition->Index + 1) << 40;
 
+    const uint16_t MinSpareSpace =
+        Builder->PackStreamFrames ?
+            QUIC_MIN_STREAM_PACK_SPARE_SPACE : QUIC_MIN_PACKET_SPARE_SPACE;
+
     BOOLEAN NewQuicPacket = FALSE;
     if (Builder->PacketType != NewPacketType || IsPathMtuDiscovery ||
-        (Builder->Datagram != NULL && (Builder->Datagram->Length - Builder->DatagramLength) < QUIC_MIN_PACKET_SPARE_SPACE)) {
+        (Builder->Datagram != NULL && (Builder->Datagram->Length - Builder->DatagramLength) < MinSpareSpace)) {
         //
         // The current data cannot go in the current QUIC packet. Finalize the
         // current QUIC packet up so we can create another.
@@ -252,10 +386,18 @@ QuicPacketBuilderPrepare(
                     MaxUdpPayloadSizeForFamily(
                         QuicAddrGetFamily(&Builder->Path->Route.RemoteAddress),
                         DatagramSize),
-                Builder->EcnEctSet ? CXPLAT_ECN_ECT_0 : CXPLAT_ECN_NON_ECT,
+                Builder->EcnEctSet ?
+                    QuicCongestionControlGetEct(&Connection->CongestionControl) :
+                    CXPLAT_ECN_NON_ECT,
                 Builder->Connection->Registration->ExecProfile == QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT ?
                     CXPLAT_SEND_FLAGS_MAX_THROUGHPUT : CXPLAT_SEND_FLAGS_NONE,
-                Connection->DSCP
+                Connection->DSCP,
+                //
+                // Sends that aren't congestion controlled (i.e. pure ACKs when
+                // blocked) go out immediately.
+                //
+                Builder->PacingRate != 0 && Builder->SendAllowance > 0 ?
+                    Connection->Send.NextTxTime : 0
             };
             Builder->SendData =
                 CxPlatSendDataAlloc(Builder->Path->Binding->Socket, &SendConfig);
@@ -350,9 +492,6 @@ QuicPacketBuilderPrepare(
             Builder->EncryptionOverhead = 0;
         }
 
-        Builder->Metadata->PacketId =
-            PartitionShifted | InterlockedIncrement64((int64_t*)&Partition->SendPacketId);
-
         //
         // Occassionally skip a packet number for improved security.
         //
@@ -398,11 +537,8 @@ QuicPacketBuilderPrepare(
             case QUIC_VERSION_MS_1:
             case QUIC_VERSION_2:
                 Builder->HeaderLength =
-                    QuicPacketEncodeShortHeaderV1(
-                        &Builder->Path->DestCid->CID,
-                        Builder->Metadata->PacketNumber,
-                        Builder->PacketNumberLength,
-                        Builder->Path->SpinBit,
+                    QuicPacketBuilderEncodeShortHeader(
+                        Builder,
                         PacketSpace->CurrentKeyPhase,
                         FixedBit,
                         BufferSpaceAvailable,
@@ -640,20 +776,36 @@ QuicPacketBuilderPrepareForStreamFrames(
     return QuicPacketBuilderPrepare(Builder, PacketKeyType, IsTailLossProbe, FALSE);
 }
 
+//
+// Applies header protection to a batch of encrypted short header packets.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicPacketBuilderFinalizeHeaderProtection(
-    _Inout_ QUIC_PACKET_BUILDER* Builder
+QuicPacketBuilderProtectBatchHeaders(
+    _Inout_ QUIC_PACKET_BUILDER* Builder,
+    _In_ uint8_t BatchCount,
+    _In_reads_(BatchCount)
+        const CXPLAT_CRYPT_BATCH_PACKET* Batch
     )
 {
-    CXPLAT_DBG_ASSERT(Builder->Key != NULL);
+    if (!Builder->Connection->State.HeaderProtectionEnabled) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < BatchCount; ++i) {
+        CxPlatCopyMemory(
+            Builder->CipherBatch + i * CXPLAT_HP_SAMPLE_LENGTH,
+            Batch[i].Header + Batch[i].HeaderLength -
+                Builder->PacketNumberLength + 4,
+            CXPLAT_HP_SAMPLE_LENGTH);
+    }
 
     QUIC_STATUS Status;
     if (QUIC_FAILED(
         Status =
         CxPlatHpComputeMask(
             Builder->Key->HeaderKey,
-            Builder->BatchCount,
+            BatchCount,
             Builder->CipherBatch,
             Builder->HpMask))) {
         CXPLAT_TEL_ASSERT(FALSE);
@@ -661,16 +813,169 @@ QuicPacketBuilderFinalizeHeaderProtection(
         return;
     }
 
-    for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+    for (uint8_t i = 0; i < BatchCount; ++i) {
         uint16_t Offset = i * CXPLAT_HP_SAMPLE_LENGTH;
-        uint8_t* Header = Builder->HeaderBatch[i];
+        uint8_t* Header = Batch[i].Header;
         Header[0] ^= (Builder->HpMask[Offset] & 0x1f); // Bottom 5 bits for SH
         Header += 1 + Builder->Path->DestCid->CID.Length;
         for (uint8_t j = 0; j < Builder->PacketNumberLength; ++j) {
             Header[j] ^= Builder->HpMask[Offset + 1 + j];
         }
     }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacketBuilderProcessProtectOffload(
+    _Inout_ QUIC_PROTECT_OFFLOAD* Offload
+    )
+{
+    Offload->Status =
+        CxPlatEncryptBatch(
+            Offload->Key->PacketKey,
+            Offload->Key->Iv,
+            Offload->BatchCount,
+            Offload->EncryptBatch);
+    if (QUIC_FAILED(Offload->Status)) {
+        for (uint8_t i = 0; i < Offload->BatchCount; ++i) {
+            CxPlatSecureZeroMemory(
+                Offload->EncryptBatch[i].Header + Offload->EncryptBatch[i].HeaderLength,
+                Offload->EncryptBatch[i].PayloadLength);
+        }
+    }
+    InterlockedIncrement(&Offload->Complete);
+}
+
+//
+// Waits for all the batches out on packet protection offload threads, and
+// then applies header protection to them. Batches no thread picked up yet are
+// sealed inline.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacketBuilderWaitProtectOffloads(
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    )
+{
+    for (uint8_t i = 0; i < Builder->ProtectOffloadCount; ++i) {
+        QUIC_PROTECT_OFFLOAD* Offload = &Builder->Connection->ProtectOffloads[i];
+        if (QuicLibraryCancelProtectOffload(&Offload->Link)) {
+            QuicPacketBuilderProcessProtectOffload(Offload);
+        } else {
+            while (InterlockedCompareExchange(&Offload->Complete, 0, 0) == 0) {
+                //
+                // The offload thread is in the middle of sealing the batch,
+                // which takes a few microseconds.
+                //
+            }
+        }
 
+        if (QUIC_FAILED(Offload->Status)) {
+            QuicConnFatalError(Builder->Connection, Offload->Status, "Encryption failure");
+        } else {
+            QuicPacketBuilderProtectBatchHeaders(
+                Builder, Offload->BatchCount, Offload->EncryptBatch);
+        }
+    }
+    Builder->ProtectOffloadCount = 0;
+}
+
+//
+// Hands the full batch of short header packets off to a packet protection
+// offload thread. Returns FALSE if it has to be sealed inline instead.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicPacketBuilderQueueProtectOffload(
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    )
+{
+    QUIC_CONNECTION* Connection = Builder->Connection;
+    CXPLAT_DBG_ASSERT(Connection->ProtectOffloads != NULL);
+    CXPLAT_DBG_ASSERT(Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT);
+
+    if (Builder->ProtectOffloadCount == QUIC_MAX_PROTECT_OFFLOADS) {
+        QuicPacketBuilderWaitProtectOffloads(Builder);
+    }
+
+    QUIC_PROTECT_OFFLOAD* Offload =
+        &Connection->ProtectOffloads[Builder->ProtectOffloadCount];
+
+    //
+    // The IV changes with every key update, so it tells whether the private
+    // copy of the key is still current.
+    //
+    if (Offload->Key == NULL ||
+        memcmp(Offload->Key->Iv, Builder->Key->Iv, CXPLAT_IV_LENGTH) != 0) {
+        QuicPacketKeyFree(Offload->Key);
+        Offload->Key = NULL;
+        if (QUIC_FAILED(
+                QuicCryptoClonePacketKey(Connection, Builder->Key, &Offload->Key))) {
+            return FALSE;
+        }
+    }
+
+    CxPlatCopyMemory(
+        Offload->EncryptBatch,
+        Builder->EncryptBatch,
+        Builder->BatchCount * sizeof(CXPLAT_CRYPT_BATCH_PACKET));
+    Offload->BatchCount = Builder->BatchCount;
+    Offload->Status = QUIC_STATUS_SUCCESS;
+    Offload->Complete = 0;
+    Builder->ProtectOffloadCount++;
+    Builder->BatchCount = 0;
+
+    QuicLibraryQueueProtectOffload(&Offload->Link);
+    return TRUE;
+}
+
+//
+// Encrypts, and then applies header protection to, the batched short header
+// packets.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacketBuilderFinalizeBatch(
+    _Inout_ QUIC_PACKET_BUILDER* Builder
+    )
+{
+    CXPLAT_DBG_ASSERT(Builder->Key != NULL);
+
+    //
+    // With parallel packet protection, full batches are sealed on offload
+    // threads while the worker goes on building packets. Partial batches are
+    // only finalized right before a send, so they're sealed inline.
+    //
+    if (Builder->Connection->ProtectOffloads != NULL &&
+        Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT &&
+        QuicPacketBuilderQueueProtectOffload(Builder)) {
+        return;
+    }
+
+    QUIC_STATUS Status;
+    if (QUIC_FAILED(
+        Status =
+        CxPlatEncryptBatch(
+            Builder->Key->PacketKey,
+            Builder->Key->Iv,
+            Builder->BatchCount,
+            Builder->EncryptBatch))) {
+        //
+        // The packets are already queued up in the send data, so make sure
+        // they never go out in the clear.
+        //
+        for (uint8_t i = 0; i < Builder->BatchCount; ++i) {
+            CxPlatSecureZeroMemory(
+                Builder->EncryptBatch[i].Header + Builder->EncryptBatch[i].HeaderLength,
+                Builder->EncryptBatch[i].PayloadLength);
+        }
+        Builder->BatchCount = 0;
+        QuicConnFatalError(Builder->Connection, Status, "Encryption failure");
+        return;
+    }
+
+    QuicPacketBuilderProtectBatchHeaders(
+        Builder, Builder->BatchCount, Builder->EncryptBatch);
     Builder->BatchCount = 0;
 }
 
@@ -731,6 +1036,16 @@ QuicPacketBuilderFinalize(
     uint16_t ExpectedFinalDatagramLength =
         Builder->DatagramLength + Builder->EncryptionOverhead;
 
+    if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
+        //
+        // Track how full 1-RTT packets are, before any padding.
+        //
+        Connection->Stats.Send.PacketFillBytes +=
+            ExpectedFinalDatagramLength - Builder->PacketStart;
+        Connection->Stats.Send.PacketCapacityBytes +=
+            Builder->Datagram->Length - Builder->PacketStart;
+    }
+
     if (FlushBatchedDatagrams ||
         Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE ||
         (uint16_t)Builder->Datagram->Length - ExpectedFinalDatagramLength < QUIC_MIN_PACKET_SPARE_SPACE) {
@@ -792,7 +1107,7 @@ QuicPacketBuilderFinalize(
     }
 
     if (Builder->EncryptionOverhead != 0 &&
-        !(Builder->Key->Type == QUIC_PACKET_KEY_1_RTT && Connection->Paths[0].EncryptionOffloading)) {
+        !(Builder->Key->Type == QUIC_PACKET_KEY_1_RTT && Builder->Path->EncryptionOffloading)) {
 
         //
         // Encrypt the data.
@@ -804,47 +1119,48 @@ QuicPacketBuilderFinalize(
 
         uint8_t* Payload = Header + Builder->HeaderLength;
 
-        uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
-        QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
-
         QUIC_STATUS Status;
-        if (QUIC_FAILED(
-            Status =
-            CxPlatEncrypt(
-                Builder->Key->PacketKey,
-                Iv,
-                Builder->HeaderLength,
-                Header,
-                PayloadLength,
-                Payload))) {
-            QuicConnFatalError(Connection, Status, "Encryption failure");
-            goto Exit;
-        }
-
-
-        if (Connection->State.HeaderProtectionEnabled) {
+        if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
+            CXPLAT_DBG_ASSERT(Builder->BatchCount < Builder->BatchLimit);
 
-            uint8_t* PnStart = Payload - Builder->PacketNumberLength;
+            //
+            // Batch the encryption and header protection for short header
+            // packets. They are completed once the batch is full or before
+            // the send data goes out.
+            //
 
-            if (Builder->PacketType == SEND_PACKET_SHORT_HEADER_TYPE) {
-                CXPLAT_DBG_ASSERT(Builder->BatchCount < QUIC_MAX_CRYPTO_BATCH_COUNT);
+            CXPLAT_CRYPT_BATCH_PACKET* Packet = &Builder->EncryptBatch[Builder->BatchCount];
+            Packet->Header = Header;
+            Packet->PacketNumber = Builder->Metadata->PacketNumber;
+            Packet->HeaderLength = Builder->HeaderLength;
+            Packet->PayloadLength = PayloadLength;
 
-                //
-                // Batch the header protection for short header packets.
-                //
+            if (++Builder->BatchCount == Builder->BatchLimit) {
+                QuicPacketBuilderFinalizeBatch(Builder);
+            }
 
-                CxPlatCopyMemory(
-                    Builder->CipherBatch + Builder->BatchCount * CXPLAT_HP_SAMPLE_LENGTH,
-                    PnStart + 4,
-                    CXPLAT_HP_SAMPLE_LENGTH);
-                Builder->HeaderBatch[Builder->BatchCount] = Header;
+        } else {
+            CXPLAT_DBG_ASSERT(Builder->BatchCount == 0);
+
+            uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+            QuicCryptoCombineIvAndPacketNumber(Builder->Key->Iv, (uint8_t*) &Builder->Metadata->PacketNumber, Iv);
+
+            if (QUIC_FAILED(
+                Status =
+                CxPlatEncrypt(
+                    Builder->Key->PacketKey,
+                    Iv,
+                    Builder->HeaderLength,
+                    Header,
+                    PayloadLength,
+                    Payload))) {
+                QuicConnFatalError(Connection, Status, "Encryption failure");
+                goto Exit;
+            }
 
-                if (++Builder->BatchCount == QUIC_MAX_CRYPTO_BATCH_COUNT) {
-                    QuicPacketBuilderFinalizeHeaderProtection(Builder);
-                }
+            if (Connection->State.HeaderProtectionEnabled) {
 
-            } else {
-                CXPLAT_DBG_ASSERT(Builder->BatchCount == 0);
+                uint8_t* PnStart = Payload - Builder->PacketNumberLength;
 
                 //
                 // Individually do header protection for long header packets as
@@ -886,6 +1202,13 @@ QuicPacketBuilderFinalize(
             !PacketSpace->AwaitingKeyPhaseConfirmation &&
             Connection->State.HandshakeConfirmed) {
 
+            //
+            // The batched packets must be sealed with the current key.
+            //
+            if (Builder->BatchCount != 0) {
+                QuicPacketBuilderFinalizeBatch(Builder);
+            }
+
             Status = QuicCryptoGenerateNewKeys(Connection);
             if (QUIC_FAILED(Status)) {
                 QuicConnFatalError(Connection, Status, "Send-triggered key update");
@@ -916,6 +1239,11 @@ QuicPacketBuilderFinalize(
     Builder->Metadata->PacketLength =
         Builder->HeaderLength + PayloadLength;
     Builder->Metadata->Flags.EcnEctSet = Builder->EcnEctSet;
+    QuicProbe3(
+        packet_finalize,
+        Connection,
+        Builder->Metadata->PacketNumber,
+        Builder->Metadata->PacketLength);
     QuicLossDetectionOnPacketSent(
         &Connection->LossDetection,
         Builder->Path,
@@ -934,6 +1262,14 @@ QuicPacketBuilderFinalize(
         } else {
             Builder->SendAllowance -= Builder->Metadata->PacketLength;
         }
+        if (Builder->Paced) {
+            QuicSendOnPacedBytesSent(
+                &Connection->Send, Builder->Metadata->PacketLength);
+        }
+        if (Builder->EgressLimited) {
+            QuicSendOnEgressBytesSent(
+                &Connection->Send, Builder->Metadata->PacketLength);
+        }
     }
 
 Exit:
@@ -956,7 +1292,10 @@ Exit:
 
         if (FlushBatchedDatagrams || CxPlatSendDataIsFull(Builder->SendData)) {
             if (Builder->BatchCount != 0) {
-                QuicPacketBuilderFinalizeHeaderProtection(Builder);
+                QuicPacketBuilderFinalizeBatch(Builder);
+            }
+            if (Builder->ProtectOffloadCount != 0) {
+                QuicPacketBuilderWaitProtectOffloads(Builder);
             }
             CXPLAT_DBG_ASSERT(Builder->TotalCountDatagrams > 0);
             QuicPacketBuilderSendBatch(Builder);
@@ -974,6 +1313,9 @@ Exit:
         }
 
     } else if (FlushBatchedDatagrams) {
+        if (Builder->ProtectOffloadCount != 0) {
+            QuicPacketBuilderWaitProtectOffloads(Builder); // Before the packets are freed.
+        }
         if (Builder->Datagram != NULL) {
             CxPlatSendDataFreeBuffer(Builder->SendData, Builder->Datagram);
             Builder->Datagram = NULL;
@@ -983,6 +1325,7 @@ Exit:
             CxPlatSendDataFree(Builder->SendData);
             Builder->SendData = NULL;
         }
+        Builder->BatchCount = 0; // Any batched packets were just freed.
     }
 
     QuicPacketBuilderValidate(Builder, FALSE);
@@ -1007,6 +1350,12 @@ QuicPacketBuilderSendBatch(
         Builder->TotalDatagramsLength,
         Builder->TotalCountDatagrams);
 
+    if (Builder->PacingRate != 0) {
+        Builder->Connection->Send.NextTxTime +=
+            (uint64_t)Builder->TotalDatagramsLength * CXPLAT_MICROSEC_PER_SEC /
+            Builder->PacingRate;
+    }
+
     Builder->PacketBatchSent = TRUE;
     Builder->SendData = NULL;
     Builder->TotalDatagramsLength = 0;
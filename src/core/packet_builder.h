@@ -5,6 +5,40 @@
 
 --*/
 
+//
+// A full batch of short header packets sealed on a packet protection offload
+// thread, for connections with parallel packet protection enabled. Only the
+// AEAD runs there; the worker applies header protection once it completes.
+//
+typedef struct QUIC_PROTECT_OFFLOAD {
+
+    //
+    // Link in the library's packet protection offload queue. Linked to itself
+    // while not queued.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // Private copy of the 1-RTT write key, as the key objects aren't safe to
+    // use from multiple threads at once. Re-derived after key updates.
+    //
+    QUIC_PACKET_KEY* Key;
+
+    //
+    // The result of sealing the batch.
+    //
+    QUIC_STATUS Status;
+
+    //
+    // Set once the offload thread is done with the batch.
+    //
+    long volatile Complete;
+
+    uint8_t BatchCount;
+    CXPLAT_CRYPT_BATCH_PACKET EncryptBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+
+} QUIC_PROTECT_OFFLOAD;
+
 //
 // All the necessary state for building and sending QUIC packets.
 //
@@ -42,20 +76,20 @@ typedef struct QUIC_PACKET_BUILDER {
     QUIC_PACKET_KEY* Key;
 
     //
-    // Cipher text across multiple packets to batch header protection.
+    // Short header packets waiting to be encrypted together. Points into the
+    // worker's scratch space, with room for QUIC_MAX_SEND_CRYPTO_BATCH_COUNT.
     //
-    uint8_t CipherBatch[CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_CRYPTO_BATCH_COUNT];
+    CXPLAT_CRYPT_BATCH_PACKET* EncryptBatch;
 
     //
-    // Output header protection mask.
+    // Cipher text across multiple packets to batch header protection.
     //
-    uint8_t HpMask[CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_CRYPTO_BATCH_COUNT];
-
+    uint8_t* CipherBatch;
 
     //
-    // Headers that need to be batched.
+    // Output header protection mask.
     //
-    uint8_t* HeaderBatch[QUIC_MAX_CRYPTO_BATCH_COUNT];
+    uint8_t* HpMask;
 
     //
     // Indicates a batch of packets has been sent.
@@ -68,11 +102,6 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint8_t PacketBatchRetransmittable : 1;
 
-    //
-    // The number of batched packets to do header protection on.
-    //
-    uint8_t BatchCount : 4;
-
     //
     // Indicates whether ECN ECT bit is set on the packets to be sent.
     //
@@ -83,11 +112,43 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint8_t WrittenConnectionCloseFrame : 1;
 
+    //
+    // Indicates the current QUIC packet is being packed with frames from
+    // further streams, so it is kept open down to a smaller spare space.
+    //
+    uint8_t PackStreamFrames : 1;
+
+    //
+    // Indicates the send allowance is limited by the connection's pacer.
+    //
+    uint8_t Paced : 1;
+
+    //
+    // Indicates the send allowance is limited by an app egress rate limit.
+    //
+    uint8_t EgressLimited : 1;
+
     //
     // The total number of datagrams that have been created.
     //
     uint8_t TotalCountDatagrams;
 
+    //
+    // The number of batched packets to encrypt and do header protection on.
+    //
+    uint8_t BatchCount;
+
+    //
+    // The number of batched packets that triggers finalizing the batch.
+    //
+    uint8_t BatchLimit;
+
+    //
+    // The number of the connection's ProtectOffloads in use. They must all
+    // complete before the send data goes out or is freed.
+    //
+    uint8_t ProtectOffloadCount;
+
     //
     // The size of the encryption AEAD tag at the end of the current QUIC
     // packet.
@@ -146,6 +207,12 @@ typedef struct QUIC_PACKET_BUILDER {
     //
     uint32_t SendAllowance;
 
+    //
+    // The rate (bytes per second) the kernel is pacing this batch at, or 0 if
+    // pacing isn't offloaded.
+    //
+    uint64_t PacingRate;
+
     uint64_t BatchId;
 
     //
@@ -172,6 +239,15 @@ QuicPacketBuilderInitialize(
     _In_ QUIC_PATH* Path
     );
 
+//
+// Seals a batch of packets on a packet protection offload thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPacketBuilderProcessProtectOffload(
+    _Inout_ QUIC_PROTECT_OFFLOAD* Offload
+    );
+
 //
 // Cleans up any leftover data still buffered for send.
 //
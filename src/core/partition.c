@@ -19,31 +19,85 @@ QuicPartitionInitialize(
     _In_ uint32_t ResetHashKeyLength
     )
 {
-    QUIC_STATUS Status =
-        CxPlatHashCreate(
-            HashType,
-            ResetHashKey,
-            ResetHashKeyLength,
-            &Partition->ResetTokenHash);
-    if (QUIC_FAILED(Status)) {
-        return Status;
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        QUIC_STATUS Status =
+            CxPlatHashCreate(
+                HashType,
+                ResetHashKey,
+                ResetHashKeyLength,
+                &Partition->ResetTokenHashes[i].Hash);
+        if (QUIC_FAILED(Status)) {
+            for (uint32_t j = 0; j < i; ++j) {
+                CxPlatHashFree(Partition->ResetTokenHashes[j].Hash);
+                Partition->ResetTokenHashes[j].Hash = NULL;
+            }
+            return Status;
+        }
+    }
+
+    const uint32_t BucketCount = MsQuicLib.InitialFilterConfig.BucketCount;
+    Partition->InitialFilterBuckets =
+        CXPLAT_ALLOC_NONPAGED(
+            BucketCount * sizeof(QUIC_INITIAL_FILTER_BUCKET),
+            QUIC_POOL_INITIAL_FILTER);
+    if (Partition->InitialFilterBuckets == NULL) {
+        QuicTraceEvent(
+            AllocFailure,
+            "Allocation of '%s' failed. (%llu bytes)",
+            "Initial filter buckets",
+            BucketCount * sizeof(QUIC_INITIAL_FILTER_BUCKET));
+        for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+            CxPlatHashFree(Partition->ResetTokenHashes[i].Hash);
+            Partition->ResetTokenHashes[i].Hash = NULL;
+        }
+        return QUIC_STATUS_OUT_OF_MEMORY;
     }
+    CxPlatZeroMemory(
+        Partition->InitialFilterBuckets,
+        BucketCount * sizeof(QUIC_INITIAL_FILTER_BUCKET));
+    Partition->InitialFilterBucketCount = BucketCount;
 
     Partition->Index = Index;
     Partition->Processor = Processor;
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_CONNECTION), QUIC_POOL_CONN, &Partition->ConnectionPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_TRANSPORT_PARAMETERS), QUIC_POOL_TP, &Partition->TransportParamPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_PACKET_SPACE), QUIC_POOL_TP, &Partition->PacketSpacePool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_STREAM), QUIC_POOL_STREAM, &Partition->StreamPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_RECV_CHUNK)+QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, QUIC_POOL_SBUF, &Partition->DefaultReceiveBufferPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_SEND_REQUEST), QUIC_POOL_SEND_REQUEST, &Partition->SendRequestPool);
-    QuicSentPacketPoolInitialize(&Partition->SentPacketPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_API_CONTEXT), QUIC_POOL_API_CTX, &Partition->ApiContextPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_STATELESS_CONTEXT), QUIC_POOL_STATELESS_CTX, &Partition->StatelessContextPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_OPERATION), QUIC_POOL_OPER, &Partition->OperPool);
-    CxPlatPoolInitialize(FALSE, sizeof(QUIC_RECV_CHUNK), QUIC_POOL_APP_BUFFER_CHUNK, &Partition->AppBufferChunkPool);
-    CxPlatLockInitialize(&Partition->ResetTokenLock);
+
+    //
+    // Place the partition's pools on the NUMA node of its processor.
+    //
+    const uint16_t NumaNode = CxPlatProcNumaNode(Processor);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_CONNECTION), QUIC_POOL_CONN, NumaNode, &Partition->ConnectionPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_CONN_HANDSHAKE_STATE), QUIC_POOL_HANDSHAKE_STATE, NumaNode, &Partition->HandshakeStatePool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_TRANSPORT_PARAMETERS), QUIC_POOL_TP, NumaNode, &Partition->TransportParamPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_PACKET_SPACE), QUIC_POOL_TP, NumaNode, &Partition->PacketSpacePool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_STREAM), QUIC_POOL_STREAM, NumaNode, &Partition->StreamPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_RECV_CHUNK)+QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE, QUIC_POOL_SBUF, NumaNode, &Partition->DefaultReceiveBufferPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_SEND_REQUEST), QUIC_POOL_SEND_REQUEST, NumaNode, &Partition->SendRequestPool);
+    QuicSentPacketPoolInitialize(&Partition->SentPacketPool, NumaNode);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_API_CONTEXT), QUIC_POOL_API_CTX, NumaNode, &Partition->ApiContextPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_STATELESS_CONTEXT), QUIC_POOL_STATELESS_CTX, NumaNode, &Partition->StatelessContextPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_OPERATION), QUIC_POOL_OPER, NumaNode, &Partition->OperPool);
+    CxPlatPoolInitializeNuma(FALSE, sizeof(QUIC_RECV_CHUNK), QUIC_POOL_APP_BUFFER_CHUNK, NumaNode, &Partition->AppBufferChunkPool);
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+        CxPlatPoolInitializeNuma(
+            FALSE,
+            sizeof(QUIC_RECV_CHUNK) + (1UL << (QUIC_RECV_CHUNK_POOL_MIN_SHIFT + i)),
+            QUIC_POOL_RECVBUF,
+            NumaNode,
+            &Partition->RecvChunkPools[i].Pool.Base);
+        CxPlatPoolEnableHugePages(&Partition->RecvChunkPools[i].Pool.Base);
+    }
+
+    //
+    // Back the hottest (connection, stream and buffer) pools with the huge page
+    // arena, if configured, to cut TLB misses at high connection counts.
+    //
+    CxPlatPoolEnableHugePages(&Partition->ConnectionPool);
+    CxPlatPoolEnableHugePages(&Partition->StreamPool);
+    CxPlatPoolEnableHugePages(&Partition->DefaultReceiveBufferPool);
+    CxPlatPoolEnableHugePages(&Partition->SendRequestPool);
     CxPlatDispatchLockInitialize(&Partition->StatelessRetryKeysLock);
+    CxPlatDispatchLockInitialize(&Partition->LoadBalancingKeyLock);
+    CxPlatDispatchLockInitialize(&Partition->RetryIntegrityKeysLock);
+    CxPlatDispatchLockInitialize(&Partition->InitialSecretCacheLock);
 
     return QUIC_STATUS_SUCCESS;
 }
@@ -54,9 +108,13 @@ QuicPartitionUninitialize(
     )
 {
     for (size_t i = 0; i < ARRAYSIZE(Partition->StatelessRetryKeys); ++i) {
-        CxPlatKeyFree(Partition->StatelessRetryKeys[i].Key);
+        if (Partition->StatelessRetryKeys[i] != NULL) {
+            CxPlatKeyFree(Partition->StatelessRetryKeys[i]->Key);
+            CXPLAT_FREE(Partition->StatelessRetryKeys[i], QUIC_POOL_RETRY_KEY);
+        }
     }
     CxPlatPoolUninitialize(&Partition->ConnectionPool);
+    CxPlatPoolUninitialize(&Partition->HandshakeStatePool);
     CxPlatPoolUninitialize(&Partition->TransportParamPool);
     CxPlatPoolUninitialize(&Partition->PacketSpacePool);
     CxPlatPoolUninitialize(&Partition->StreamPool);
@@ -67,38 +125,188 @@ QuicPartitionUninitialize(
     CxPlatPoolUninitialize(&Partition->StatelessContextPool);
     CxPlatPoolUninitialize(&Partition->OperPool);
     CxPlatPoolUninitialize(&Partition->AppBufferChunkPool);
-    CxPlatLockUninitialize(&Partition->ResetTokenLock);
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+#ifndef _KERNEL_MODE
+        if (Partition->RecvChunkPoolsRegistered) {
+            CxPlatRemoveDynamicPoolAllocator(&Partition->RecvChunkPools[i].Pool);
+        }
+#endif
+        CxPlatPoolUninitialize(&Partition->RecvChunkPools[i].Pool.Base);
+    }
     CxPlatDispatchLockUninitialize(&Partition->StatelessRetryKeysLock);
-    CxPlatHashFree(Partition->ResetTokenHash);
+    CxPlatHpKeyFree(Partition->LoadBalancingKey);
+    CxPlatDispatchLockUninitialize(&Partition->LoadBalancingKeyLock);
+    for (size_t i = 0; i < ARRAYSIZE(Partition->RetryIntegrityKeys); ++i) {
+        QuicPacketKeyFree(Partition->RetryIntegrityKeys[i]);
+    }
+    CxPlatDispatchLockUninitialize(&Partition->RetryIntegrityKeysLock);
+    CxPlatSecureZeroMemory(Partition->InitialSecretCache, sizeof(Partition->InitialSecretCache));
+    CxPlatDispatchLockUninitialize(&Partition->InitialSecretCacheLock);
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        CxPlatHashFree(Partition->ResetTokenHashes[i].Hash);
+    }
+    CXPLAT_FREE(Partition->InitialFilterBuckets, QUIC_POOL_INITIAL_FILTER);
 }
 
 //
-// MUST be called while holding the per-partition StatelessRetryKeysLock to
-// ensure no-concurrent modification of the per-partition encryption key *AND*
-// while holding the the global MsQuicLib.StatelessRetry.Lock in shared mode to
-// ensure the configuration is read in a complete state.
+// Allocates Count entries from the pool and frees them all again, so they sit
+// in the pool's free list. The entries are chained through their own memory
+// while they're held.
 //
-_Requires_lock_held_(Partition->StatelessRetryKeysLock)
-_Requires_shared_lock_held_(MsQuicLib.StatelessRetry.Lock)
+static
+void
+QuicPartitionPrewarmPool(
+    _Inout_ CXPLAT_POOL* Pool,
+    _In_ uint32_t Count
+    )
+{
+    void* Head = NULL;
+    for (uint32_t i = 0; i < Count; ++i) {
+        void** Entry = (void**)CxPlatPoolAlloc(Pool);
+        if (Entry == NULL) {
+            break;
+        }
+        *Entry = Head;
+        Head = Entry;
+    }
+    while (Head != NULL) {
+        void* Next = *(void**)Head;
+        CxPlatPoolFree(Head);
+        Head = Next;
+    }
+}
+
+void
+QuicPartitionPrewarm(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_ const QUIC_PREWARM_CONFIG* Config
+    )
+{
+    if (InterlockedFetchAndSetBoolean(&Partition->Prewarmed)) {
+        return; // Another worker of the partition got here first.
+    }
+
+    const uint32_t ConnectionCount =
+        CXPLAT_MIN(Config->ConnectionCount, QUIC_MAX_POOL_PREWARM_COUNT);
+    const uint32_t StreamCount =
+        CXPLAT_MIN(Config->StreamCount, QUIC_MAX_POOL_PREWARM_COUNT);
+
+    QuicPartitionPrewarmPool(&Partition->ConnectionPool, ConnectionCount);
+    QuicPartitionPrewarmPool(&Partition->HandshakeStatePool, ConnectionCount);
+    QuicPartitionPrewarmPool(&Partition->TransportParamPool, ConnectionCount);
+    QuicPartitionPrewarmPool(&Partition->PacketSpacePool, ConnectionCount);
+    QuicPartitionPrewarmPool(&Partition->OperPool, ConnectionCount);
+    QuicPartitionPrewarmPool(&Partition->StreamPool, StreamCount);
+    QuicPartitionPrewarmPool(&Partition->SendRequestPool, StreamCount);
+    QuicPartitionPrewarmPool(&Partition->DefaultReceiveBufferPool, StreamCount);
+}
+
+#ifndef _KERNEL_MODE
+void
+QuicPartitionRegisterDynamicPools(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    )
+{
+    CXPLAT_DBG_ASSERT(!Partition->RecvChunkPoolsRegistered);
+    const uint16_t WorkerIndex =
+        (uint16_t)(Partition->Index % CxPlatWorkerPoolGetCount(WorkerPool));
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+        CxPlatAddDynamicPoolAllocator(
+            WorkerPool, &Partition->RecvChunkPools[i].Pool, WorkerIndex);
+    }
+    Partition->RecvChunkPoolsRegistered = TRUE;
+}
+
+void
+QuicPartitionSetRecvChunkPoolPolicies(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_reads_(QUIC_RECV_CHUNK_POOL_COUNT)
+        const CXPLAT_POOL_EX_POLICY* Policies
+    )
+{
+    CXPLAT_DBG_ASSERT(Partition->RecvChunkPoolsRegistered);
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+        QUIC_STATUS Status =
+            CxPlatDynamicPoolSetPolicy(
+                &Partition->RecvChunkPools[i].Pool, &Policies[i]);
+        CXPLAT_DBG_ASSERT(QUIC_SUCCEEDED(Status)); // Validated by the caller.
+        UNREFERENCED_PARAMETER(Status);
+    }
+}
+
+void
+QuicPartitionAddRecvChunkPoolStats(
+    _In_ QUIC_PARTITION* Partition,
+    _Inout_updates_(QUIC_RECV_CHUNK_POOL_COUNT)
+        QUIC_POOL_STATISTICS* Stats
+    )
+{
+    CXPLAT_DBG_ASSERT(Partition->RecvChunkPoolsRegistered);
+    for (uint32_t i = 0; i < QUIC_RECV_CHUNK_POOL_COUNT; ++i) {
+        CXPLAT_POOL_EX_STATS PoolStats;
+        CxPlatDynamicPoolGetStats(&Partition->RecvChunkPools[i].Pool, &PoolStats);
+        Stats[i].FreeDepth += PoolStats.FreeDepth;
+        Stats[i].AllocCount += PoolStats.AllocCount;
+        Stats[i].MissCount += PoolStats.MissCount;
+        Stats[i].PruneCount += PoolStats.PruneCount;
+    }
+}
+#endif
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
-_Ret_maybenull_
-CXPLAT_KEY*
-QuicPartitionGetStatelessRetryKey(
+void
+QuicPartitionRetryKeyFree(
+    _In_ QUIC_RETIRED_OBJECT* Object
+    )
+{
+    QUIC_RETRY_KEY* RetryKey =
+        CXPLAT_CONTAINING_RECORD(Object, QUIC_RETRY_KEY, Retired);
+    CxPlatKeyFree(RetryKey->Key);
+    CXPLAT_FREE(RetryKey, QUIC_POOL_RETRY_KEY);
+}
+
+//
+// Creates the key for the index, if it isn't already in the cache, and
+// publishes it. The key it replaces is retired, to be freed once no read
+// section can still be using it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPartitionCreateStatelessRetryKey(
     _In_ QUIC_PARTITION* Partition,
     _In_ int64_t KeyIndex
     )
 {
+    QUIC_RETRY_KEY* NewRetryKey = NULL;
+    QUIC_RETRY_KEY* OldRetryKey;
+    BOOLEAN Result = FALSE;
+
+    CxPlatDispatchLockAcquire(&Partition->StatelessRetryKeysLock);
+
     //
-    // Check if the key is already generated.
+    // Check if the key was generated in the meantime.
     //
-    if (Partition->StatelessRetryKeys[KeyIndex & 1].Index == KeyIndex) {
-        return Partition->StatelessRetryKeys[KeyIndex & 1].Key;
+    OldRetryKey = Partition->StatelessRetryKeys[KeyIndex & 1];
+    if (OldRetryKey != NULL && OldRetryKey->Index == KeyIndex) {
+        OldRetryKey = NULL;
+        Result = TRUE;
+        goto Exit;
+    }
+
+    NewRetryKey = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RETRY_KEY), QUIC_POOL_RETRY_KEY);
+    if (NewRetryKey == NULL) {
+        OldRetryKey = NULL;
+        goto Exit;
     }
 
     //
     // Generate a new key from the base retry secret using SP800-108 CTR-HMAC.
+    // The global lock is held in shared mode to ensure the configuration is
+    // read in a complete state.
     //
     uint8_t RawKey[CXPLAT_AEAD_MAX_SIZE];
+    CxPlatDispatchRwLockAcquireShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
     QUIC_STATUS Status =
         CxPlatKbKdfDerive(
             MsQuicLib.StatelessRetry.BaseSecret,
@@ -108,68 +316,139 @@ QuicPartitionGetStatelessRetryKey(
             sizeof(KeyIndex),
             MsQuicLib.StatelessRetry.SecretLength,
             RawKey);
+    if (QUIC_SUCCEEDED(Status)) {
+        Status =
+            CxPlatKeyCreate(
+                MsQuicLib.StatelessRetry.AeadAlgorithm,
+                RawKey,
+                &NewRetryKey->Key);
+    }
+    CxPlatDispatchRwLockReleaseShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
+    CxPlatSecureZeroMemory(RawKey, sizeof(RawKey));
     if (QUIC_FAILED(Status)) {
-        return NULL;
+        CXPLAT_FREE(NewRetryKey, QUIC_POOL_RETRY_KEY);
+        OldRetryKey = NULL;
+        goto Exit;
     }
 
-    CXPLAT_KEY* NewKey;
-    Status =
-        CxPlatKeyCreate(
-            MsQuicLib.StatelessRetry.AeadAlgorithm,
-            RawKey,
-            &NewKey);
-    if (QUIC_FAILED(Status)) {
-        CxPlatSecureZeroMemory(RawKey, sizeof(RawKey));
-        return NULL;
+    NewRetryKey->Index = KeyIndex;
+    QuicWritePtrRelease((void**)&Partition->StatelessRetryKeys[KeyIndex & 1], NewRetryKey);
+    Result = TRUE;
+
+Exit:
+
+    CxPlatDispatchLockRelease(&Partition->StatelessRetryKeysLock);
+
+    if (OldRetryKey != NULL) {
+        OldRetryKey->Retired.Next = NULL;
+        OldRetryKey->Retired.Free = QuicPartitionRetryKeyFree;
+        QuicLibraryRetire(&OldRetryKey->Retired);
     }
 
-    CxPlatKeyFree(Partition->StatelessRetryKeys[KeyIndex & 1].Key);
-    Partition->StatelessRetryKeys[KeyIndex & 1].Key = NewKey;
-    Partition->StatelessRetryKeys[KeyIndex & 1].Index = KeyIndex;
-    CxPlatSecureZeroMemory(RawKey, sizeof(RawKey));
+    return Result;
+}
 
-    return NewKey;
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+CXPLAT_KEY*
+QuicPartitionGetStatelessRetryKey(
+    _In_ QUIC_PARTITION* Partition,
+    _In_ int64_t KeyIndex,
+    _Out_ QUIC_PARTITION** ReadPartition,
+    _Out_ uint32_t* ReadEpoch
+    )
+{
+    do {
+        *ReadPartition = QuicLibraryReadBegin(ReadEpoch);
+        const QUIC_RETRY_KEY* RetryKey =
+            QuicReadPtrAcquire((void**)&Partition->StatelessRetryKeys[KeyIndex & 1]);
+        if (RetryKey != NULL && RetryKey->Index == KeyIndex) {
+            return RetryKey->Key;
+        }
+        QuicLibraryReadEnd(*ReadPartition, *ReadEpoch);
+    } while (QuicPartitionCreateStatelessRetryKey(Partition, KeyIndex));
+
+    return NULL;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
-_Requires_lock_held_(Partition->StatelessRetryKeysLock)
 _Ret_maybenull_
 CXPLAT_KEY*
 QuicPartitionGetCurrentStatelessRetryKey(
-    _In_ QUIC_PARTITION* Partition
+    _In_ QUIC_PARTITION* Partition,
+    _Out_ QUIC_PARTITION** ReadPartition,
+    _Out_ uint32_t* ReadEpoch
     )
 {
     const int64_t Now = CxPlatTimeEpochMs64();
-    CxPlatDispatchRwLockAcquireShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
     const int64_t KeyIndex = Now / MsQuicLib.StatelessRetry.KeyRotationMs;
-    CXPLAT_KEY* Key = QuicPartitionGetStatelessRetryKey(Partition, KeyIndex);
-    CxPlatDispatchRwLockReleaseShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
-    return Key;
+    return
+        QuicPartitionGetStatelessRetryKey(
+            Partition, KeyIndex, ReadPartition, ReadEpoch);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
-_Requires_lock_held_(Partition->StatelessRetryKeysLock)
 _Ret_maybenull_
 CXPLAT_KEY*
 QuicPartitionGetStatelessRetryKeyForTimestamp(
     _In_ QUIC_PARTITION* Partition,
-    _In_ int64_t Timestamp
+    _In_ int64_t Timestamp,
+    _Out_ QUIC_PARTITION** ReadPartition,
+    _Out_ uint32_t* ReadEpoch
     )
 {
     const int64_t Now = CxPlatTimeEpochMs64();
-    CxPlatDispatchRwLockAcquireShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
-    const int64_t CurrentKeyIndex = Now / MsQuicLib.StatelessRetry.KeyRotationMs;
-    const int64_t KeyIndex = Timestamp / MsQuicLib.StatelessRetry.KeyRotationMs;
+    const int64_t KeyRotationMs = MsQuicLib.StatelessRetry.KeyRotationMs;
+    const int64_t CurrentKeyIndex = Now / KeyRotationMs;
+    const int64_t KeyIndex = Timestamp / KeyRotationMs;
 
     if (KeyIndex < CurrentKeyIndex - 1 || KeyIndex > CurrentKeyIndex) {
         //
         // This key index is too old or too new.
         //
-        CxPlatDispatchRwLockReleaseShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
         return NULL;
     }
 
-    CXPLAT_KEY* Key = QuicPartitionGetStatelessRetryKey(Partition, KeyIndex);
-    CxPlatDispatchRwLockReleaseShared(&MsQuicLib.StatelessRetry.Lock, PrevIrql);
-    return Key;
+    return
+        QuicPartitionGetStatelessRetryKey(
+            Partition, KeyIndex, ReadPartition, ReadEpoch);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPartitionStatelessOperAdmit(
+    _In_ QUIC_PARTITION* Partition
+    )
+{
+    //
+    // The bucket holds MaxBindingStatelessOperations tokens and refills
+    // completely every StatelessOperationExpirationMs, which is the rate a
+    // single binding's operation table could sustain. Each token takes
+    // Interval to refill, so the bucket is full again at FullTime, and a new
+    // operation is allowed as long as that stays within one refill period of
+    // now. That single timestamp is updated with a compare-exchange, so no
+    // lock is needed.
+    //
+    const uint64_t MaxOperations = QuicLibraryGetSettings()->MaxBindingStatelessOperations;
+    if (MaxOperations == 0) {
+        return FALSE;
+    }
+    const uint64_t Period =
+        (uint64_t)QuicLibraryGetSettings()->StatelessOperationExpirationMs * CXPLAT_MICROSEC_PER_MS;
+    const uint64_t Interval = Period / MaxOperations;
+    const uint64_t TimeNow = CxPlatTimeUs64();
+
+    for (;;) {
+        const uint64_t FullTime = Partition->StatelessOperFullTimeUs;
+        const uint64_t NewFullTime = CXPLAT_MAX(FullTime, TimeNow) + Interval;
+        if (NewFullTime - TimeNow > Period) {
+            return FALSE;
+        }
+        if (InterlockedCompareExchange64(
+                (int64_t*)&Partition->StatelessOperFullTimeUs,
+                (int64_t)NewFullTime,
+                (int64_t)FullTime) == (int64_t)FullTime) {
+            return TRUE;
+        }
+    }
 }
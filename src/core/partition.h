@@ -43,11 +43,75 @@ Abstract:
 extern "C" {
 #endif
 
+//
+// An object that was unlinked from a structure read without locks, and is
+// waiting for a grace period to end before it's freed (see
+// QuicLibraryRetire).
+//
+typedef struct QUIC_RETIRED_OBJECT QUIC_RETIRED_OBJECT;
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_RETIRED_OBJECT_FREE)(
+    _In_ QUIC_RETIRED_OBJECT* Object
+    );
+
+struct QUIC_RETIRED_OBJECT {
+    QUIC_RETIRED_OBJECT* Next;
+    QUIC_RETIRED_OBJECT_FREE* Free;
+};
+
 typedef struct QUIC_RETRY_KEY {
+    QUIC_RETIRED_OBJECT Retired;
     CXPLAT_KEY* Key;
     int64_t Index;
 } QUIC_RETRY_KEY;
 
+//
+// The number of (direct mapped) entries in each partition's Initial secret
+// cache. Must be a power of 2.
+//
+#define QUIC_INITIAL_SECRET_CACHE_SIZE      16
+
+//
+// How long (in us) derived Initial secrets are kept for reuse. Long enough to
+// cover a client's Initial retransmissions.
+//
+#define QUIC_INITIAL_SECRET_CACHE_TTL_US    (3 * 1000 * 1000)
+
+typedef struct QUIC_INITIAL_SECRET_CACHE_ENTRY {
+    uint64_t TimeUs;    // When the secrets were derived. 0 if unused.
+    uint32_t Version;
+    uint8_t CidLength;
+    uint8_t Cid[QUIC_MAX_CONNECTION_ID_LENGTH_V1];
+    CXPLAT_SECRET ClientInitial;
+    CXPLAT_SECRET ServerInitial;
+} QUIC_INITIAL_SECRET_CACHE_ENTRY;
+
+//
+// A size-classed receive chunk pool. In user mode these are registered with
+// the partition's platform worker so that idle memory is pruned back.
+//
+typedef struct QUIC_RECV_CHUNK_POOL {
+#ifndef _KERNEL_MODE
+    CXPLAT_POOL_EX Pool;
+#else
+    struct {
+        CXPLAT_POOL Base;
+    } Pool;
+#endif
+} QUIC_RECV_CHUNK_POOL;
+
+//
+// A stateless reset token hash object. Hash objects can't be used by multiple
+// threads at once, so each token generation claims one for itself.
+//
+typedef struct QUIC_CACHEALIGN QUIC_RESET_TOKEN_HASH {
+    BOOLEAN volatile InUse;
+    CXPLAT_HASH* Hash;
+} QUIC_RESET_TOKEN_HASH;
+
 typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
 
     //
@@ -64,25 +128,50 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     // Log correlation ID for events.
     //
     uint64_t SendBatchId;
-    uint64_t SendPacketId;
     uint64_t ReceivePacketId;
 
     //
-    // Used for generating stateless reset hashes.
+    // Used for generating stateless reset hashes. Claimed without a lock, so
+    // servers issuing lots of CIDs don't serialize on token generation.
     //
-    CXPLAT_HASH* ResetTokenHash;
-    CXPLAT_LOCK ResetTokenLock;
+    QUIC_RESET_TOKEN_HASH ResetTokenHashes[QUIC_RESET_TOKEN_HASH_COUNT];
 
     //
-    // Two most recent keys used for generating stateless retries.
+    // Two most recent keys used for generating stateless retries. They are
+    // read from within a read section, without a lock. The lock only
+    // serializes creating new keys.
     //
     CXPLAT_DISPATCH_LOCK StatelessRetryKeysLock;
-    QUIC_RETRY_KEY StatelessRetryKeys[2];
+    QUIC_RETRY_KEY* volatile StatelessRetryKeys[2];
+
+    //
+    // Single block AES key for encrypting QUIC-LB connection IDs. Created on
+    // first use, from MsQuicLib.LoadBalancingKey.
+    //
+    CXPLAT_DISPATCH_LOCK LoadBalancingKeyLock;
+    CXPLAT_HP_KEY* LoadBalancingKey;
+
+    //
+    // Retry integrity keys, indexed like QuicSupportedVersionList. They only
+    // depend on the version, so they are derived on first use and kept.
+    //
+    CXPLAT_DISPATCH_LOCK RetryIntegrityKeysLock;
+    QUIC_PACKET_KEY* RetryIntegrityKeys[QUIC_SUPPORTED_VERSION_COUNT];
+
+    //
+    // Recently derived server Initial secrets, keyed by version and the
+    // client's original destination CID. Initial packet keys hold cipher state
+    // and can't be shared, but the secrets they are created from can, which
+    // saves the HKDF extract and expansions when the same CID shows up again.
+    //
+    CXPLAT_DISPATCH_LOCK InitialSecretCacheLock;
+    QUIC_INITIAL_SECRET_CACHE_ENTRY InitialSecretCache[QUIC_INITIAL_SECRET_CACHE_SIZE];
 
     //
     // Pools for allocations.
     //
     CXPLAT_POOL ConnectionPool;             // QUIC_CONNECTION
+    CXPLAT_POOL HandshakeStatePool;         // QUIC_CONN_HANDSHAKE_STATE
     CXPLAT_POOL TransportParamPool;         // QUIC_TRANSPORT_PARAMETER
     CXPLAT_POOL PacketSpacePool;            // QUIC_PACKET_SPACE
     CXPLAT_POOL StreamPool;                 // QUIC_STREAM
@@ -93,12 +182,68 @@ typedef struct QUIC_CACHEALIGN QUIC_PARTITION {
     CXPLAT_POOL StatelessContextPool;       // QUIC_STATELESS_CONTEXT
     CXPLAT_POOL OperPool;                   // QUIC_OPERATION
     CXPLAT_POOL AppBufferChunkPool;         // QUIC_RECV_CHUNK
+    QUIC_RECV_CHUNK_POOL RecvChunkPools[QUIC_RECV_CHUNK_POOL_COUNT]; // QUIC_RECV_CHUNK + 2^n
+
+    //
+    // Set once RecvChunkPools are registered for periodic pruning.
+    //
+    BOOLEAN RecvChunkPoolsRegistered;
+
+    //
+    // Set once the pools have been warmed up with QUIC_PREWARM_CONFIG.
+    //
+    BOOLEAN Prewarmed;
+
+    //
+    // Number of read sections (see QuicLibraryReadBegin) active on this
+    // partition, for each of the two epochs.
+    //
+    long volatile ReadSections[2];
+
+    //
+    // Token bucket (in its virtual scheduling form) limiting the rate of
+    // stateless operations queued from this partition. Holds the time (in us)
+    // at which the bucket would be full again.
+    //
+    uint64_t volatile StatelessOperFullTimeUs;
+
+    //
+    // Per-source counters for the Initial packet filter.
+    //
+    uint32_t InitialFilterBucketCount;
+    QUIC_INITIAL_FILTER_BUCKET* InitialFilterBuckets;
+
+    //
+    // Receive load, updated along with the perf counter samples. The rate is
+    // in packets per second.
+    //
+    int64_t RecvPacketsSample;
+    uint64_t RecvRate;
+    BOOLEAN Overloaded;
 
     //
     // Per-processor performance counters.
     //
     int64_t PerfCounters[QUIC_PERF_COUNTER_MAX];
 
+    //
+    // Memory used by the send buffers of the partition's connections. Only
+    // the sum over all partitions is meaningful, as a connection may free on
+    // a different partition than it allocated on.
+    //
+    int64_t SendBufferMemoryUsage;
+
+    //
+    // Received packets dropped, by QUIC_RECV_DROP_REASON.
+    //
+    int64_t RecvDropCounters[QUIC_RECV_DROP_REASON_COUNT];
+
+    //
+    // App callbacks that exceeded the slow callback threshold on this
+    // partition.
+    //
+    QUIC_SLOW_CALLBACK_STATISTICS SlowCallbacks;
+
 } QUIC_PARTITION;
 
 //
@@ -120,29 +265,121 @@ QuicPartitionUninitialize(
     _Inout_ QUIC_PARTITION* Partition
     );
 
+#ifndef _KERNEL_MODE
+//
+// Fills the partition's fixed-size pools with the configured number of free
+// entries. Only the first call does anything.
+//
+void
+QuicPartitionPrewarm(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_ const QUIC_PREWARM_CONFIG* Config
+    );
+
+//
+// Registers the partition's dynamic pools with the worker of the same index,
+// which returns idle pooled memory periodically.
+//
+void
+QuicPartitionRegisterDynamicPools(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    );
+
 //
-// Returns the current stateless retry key.
+// Applies a trimming policy to each of the registered RecvChunkPools.
+//
+void
+QuicPartitionSetRecvChunkPoolPolicies(
+    _Inout_ QUIC_PARTITION* Partition,
+    _In_reads_(QUIC_RECV_CHUNK_POOL_COUNT)
+        const CXPLAT_POOL_EX_POLICY* Policies
+    );
+
+//
+// Adds the statistics of each of the registered RecvChunkPools to Stats.
+//
+void
+QuicPartitionAddRecvChunkPoolStats(
+    _In_ QUIC_PARTITION* Partition,
+    _Inout_updates_(QUIC_RECV_CHUNK_POOL_COUNT)
+        QUIC_POOL_STATISTICS* Stats
+    );
+#endif
+
+//
+// Returns the current stateless retry key. On success, the caller is in a
+// read section and must call QuicLibraryReadEnd(*ReadPartition, *ReadEpoch)
+// once done with the key.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
-_Requires_lock_held_(Partition->StatelessRetryKeysLock)
 _Ret_maybenull_
 CXPLAT_KEY*
 QuicPartitionGetCurrentStatelessRetryKey(
-    _In_ QUIC_PARTITION* Partition
+    _In_ QUIC_PARTITION* Partition,
+    _Out_ QUIC_PARTITION** ReadPartition,
+    _Out_ uint32_t* ReadEpoch
     );
 
 //
-// Returns the stateless retry key for that timestamp.
+// Returns the stateless retry key for that timestamp. On success, the caller
+// is in a read section and must call QuicLibraryReadEnd(*ReadPartition,
+// *ReadEpoch) once done with the key.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
-_Requires_lock_held_(Partition->StatelessRetryKeysLock)
 _Ret_maybenull_
 CXPLAT_KEY*
 QuicPartitionGetStatelessRetryKeyForTimestamp(
     _In_ QUIC_PARTITION* Partition,
-    _In_ int64_t Timestamp
+    _In_ int64_t Timestamp,
+    _Out_ QUIC_PARTITION** ReadPartition,
+    _Out_ uint32_t* ReadEpoch
+    );
+
+//
+// Takes a token for a new stateless operation. Returns FALSE if the rate limit
+// has been reached and the operation should be dropped.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPartitionStatelessOperAdmit(
+    _In_ QUIC_PARTITION* Partition
     );
 
+//
+// Claims one of the partition's stateless reset token hash objects, starting
+// with the current processor's so concurrent callers rarely collide.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_INLINE
+QUIC_RESET_TOKEN_HASH*
+QuicPartitionAcquireResetTokenHash(
+    _In_ QUIC_PARTITION* Partition
+    )
+{
+    uint32_t Index = CxPlatProcCurrentNumber();
+    for (;;) {
+        for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i, ++Index) {
+            QUIC_RESET_TOKEN_HASH* Entry =
+                &Partition->ResetTokenHashes[Index % QUIC_RESET_TOKEN_HASH_COUNT];
+            if (!Entry->InUse && !InterlockedFetchAndSetBoolean(&Entry->InUse)) {
+                return Entry;
+            }
+        }
+        CxPlatSchedulerYield();
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_INLINE
+void
+QuicPartitionReleaseResetTokenHash(
+    _In_ QUIC_RESET_TOKEN_HASH* Entry
+    )
+{
+    InterlockedFetchAndClearBoolean(&Entry->InUse);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_INLINE
 QUIC_STATUS
@@ -154,21 +391,36 @@ QuicPartitionUpdateStatelessResetKey(
     _In_ uint32_t ResetHashKeyLength
     )
 {
-    CXPLAT_HASH* NewResetTokenHash = NULL;
-    QUIC_STATUS Status =
-        CxPlatHashCreate(
-            HashType,
-            ResetHashKey,
-            ResetHashKeyLength,
-            &NewResetTokenHash);
-    if (QUIC_FAILED(Status)) {
-        return Status;
+    CXPLAT_HASH* NewResetTokenHashes[QUIC_RESET_TOKEN_HASH_COUNT] = { 0 };
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        Status =
+            CxPlatHashCreate(
+                HashType,
+                ResetHashKey,
+                ResetHashKeyLength,
+                &NewResetTokenHashes[i]);
+        if (QUIC_FAILED(Status)) {
+            for (uint32_t j = 0; j < i; ++j) {
+                CxPlatHashFree(NewResetTokenHashes[j]);
+            }
+            return Status;
+        }
     }
 
-    CxPlatLockAcquire(&Partition->ResetTokenLock);
-    CxPlatHashFree(Partition->ResetTokenHash);
-    Partition->ResetTokenHash = NewResetTokenHash;
-    CxPlatLockRelease(&Partition->ResetTokenLock);
+    //
+    // Swap each hash object in while holding its claim, so it isn't freed out
+    // from under a token generation.
+    //
+    for (uint32_t i = 0; i < QUIC_RESET_TOKEN_HASH_COUNT; ++i) {
+        QUIC_RESET_TOKEN_HASH* Entry = &Partition->ResetTokenHashes[i];
+        while (InterlockedFetchAndSetBoolean(&Entry->InUse)) {
+            CxPlatSchedulerYield();
+        }
+        CxPlatHashFree(Entry->Hash);
+        Entry->Hash = NewResetTokenHashes[i];
+        QuicPartitionReleaseResetTokenHash(Entry);
+    }
 
     return QUIC_STATUS_SUCCESS;
 }
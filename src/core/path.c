@@ -28,7 +28,7 @@ QuicPathInitialize(
     Path->InUse = TRUE;
     Path->MinRtt = UINT32_MAX;
     Path->Mtu = Connection->Settings.MinimumMtu;
-    Path->SmoothedRtt = MS_TO_US(Connection->Settings.InitialRttMs);
+    Path->SmoothedRtt = QuicConnGetInitialRtt(Connection);
     Path->RttVariance = Path->SmoothedRtt / 2;
     Path->EcnValidationState =
         Connection->Settings.EcnEnabled ? ECN_VALIDATION_TESTING : ECN_VALIDATION_FAILED;
@@ -240,6 +240,66 @@ QuicConnGetPathForPacket(
     return Path;
 }
 
+//
+// Remembers the congestion state the connection built up on the active path,
+// before another path takes over.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicPathSaveCongestionState(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_PATH* Path = &Connection->Paths[0];
+    if (!Connection->State.HandshakeConfirmed || !Path->GotFirstRttSample) {
+        return;
+    }
+
+    //
+    // Only the part of the window that was actually filled has been shown to
+    // be safe for the path.
+    //
+    Path->SavedCongestionWindow =
+        CXPLAT_MIN(
+            QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl),
+            QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl));
+
+    if (Connection->Settings.PathMetricsCacheEnabled) {
+        QuicConnCachePathMetrics(Connection);
+    }
+}
+
+//
+// Restores the congestion state for the new active path: from when the
+// connection last used the path if it has, or from the library's path metrics
+// cache otherwise.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicPathRestoreCongestionState(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_PATH* Path = &Connection->Paths[0];
+    if (Path->SavedCongestionWindow != 0 && Path->GotFirstRttSample) {
+        QUIC_CONN_CAREFUL_RESUME_STATE CarefulResumeState = { 0 };
+        CarefulResumeState.SmoothedRtt = Path->SmoothedRtt;
+        CarefulResumeState.MinRtt = Path->MinRtt;
+        CarefulResumeState.RemoteEndpoint = Path->Route.RemoteAddress;
+        CarefulResumeState.Algorithm =
+            (QUIC_CONGESTION_CONTROL_ALGORITHM)Connection->Settings.CongestionControlAlgorithm;
+        CarefulResumeState.CongestionWindow = Path->SavedCongestionWindow;
+        QuicCongestionControlSetCarefulResume(
+            &Connection->CongestionControl, &CarefulResumeState);
+
+    } else if (Connection->Settings.PathMetricsCacheEnabled) {
+        QuicConnApplyCachedPathMetrics(Connection);
+    }
+    Path->SavedCongestionWindow = 0;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicPathSetActive(
@@ -257,6 +317,18 @@ QuicPathSetActive(
             QuicAddrGetFamily(&Path->Route.RemoteAddress) == QuicAddrGetFamily(&Connection->Paths[0].Route.RemoteAddress) &&
             QuicAddrCompareIp(&Path->Route.RemoteAddress, &Connection->Paths[0].Route.RemoteAddress);
 
+        if (Connection->Paths[0].EncryptionOffloading) {
+            //
+            // The offload is bound to the old path's addresses and CID. Fall
+            // back to software for the rest of the connection.
+            //
+            QuicPathUpdateQeo(Connection, &Connection->Paths[0], CXPLAT_QEO_OPERATION_REMOVE);
+        }
+
+        if (!UdpPortChangeOnly) {
+            QuicPathSaveCongestionState(Connection);
+        }
+
         QUIC_PATH PrevActivePath = Connection->Paths[0];
 
         PrevActivePath.IsActive = FALSE;
@@ -266,6 +338,25 @@ QuicPathSetActive(
             // We assume port only changes don't change the PMTU.
             //
             Path->IsMinMtuValidated = PrevActivePath.IsMinMtuValidated;
+
+            //
+            // A port only change is most likely a NAT rebinding, so the
+            // network path itself is the same. Carry the RTT estimates over
+            // along with the congestion state (RFC 9000, Section 9.4), so that
+            // loss detection doesn't fall back to the initial RTT while the
+            // new path is being validated. The amplification limit still
+            // applies until then.
+            //
+            if (PrevActivePath.GotFirstRttSample && !Path->GotFirstRttSample) {
+                Path->GotFirstRttSample = TRUE;
+                Path->SmoothedRtt = PrevActivePath.SmoothedRtt;
+                Path->LatestRttSample = PrevActivePath.LatestRttSample;
+                Path->MinRtt = PrevActivePath.MinRtt;
+                Path->MaxRtt = PrevActivePath.MaxRtt;
+                Path->RttVariance = PrevActivePath.RttVariance;
+                Path->OneWayDelay = PrevActivePath.OneWayDelay;
+                Path->OneWayDelayLatest = PrevActivePath.OneWayDelayLatest;
+            }
         }
 
         Connection->Paths[0] = *Path;
@@ -275,6 +366,9 @@ QuicPathSetActive(
 
     if (!UdpPortChangeOnly) {
         QuicCongestionControlReset(&Connection->CongestionControl, FALSE);
+        if (Path != &Connection->Paths[0]) {
+            QuicPathRestoreCongestionState(Connection);
+        }
     }
     CXPLAT_DBG_ASSERT(Path->DestCid != NULL);
     CXPLAT_DBG_ASSERT(!Path->DestCid->CID.Retired);
@@ -305,7 +399,7 @@ QuicPathUpdateQeo(
     {
         Operation,
         CXPLAT_QEO_DIRECTION_RECEIVE,
-        CXPLAT_QEO_DECRYPT_FAILURE_ACTION_DROP,
+        CXPLAT_QEO_DECRYPT_FAILURE_ACTION_CONTINUE, // So stateless resets still get through
         0, // KeyPhase
         0, // Reserved
         CXPLAT_QEO_CIPHER_TYPE_AEAD_AES_256_GCM,
@@ -40,7 +40,9 @@ typedef enum ECN_VALIDATION_STATE {
 } ECN_VALIDATION_STATE;
 
 //
-// Represents all the per-path information of a connection.
+// Represents all the per-path information of a connection. What every packet
+// sent on the path needs comes first, and the validation and MTU discovery
+// state last.
 //
 typedef struct QUIC_PATH {
 
@@ -116,11 +118,6 @@ typedef struct QUIC_PATH {
     //
     BOOLEAN EncryptionOffloading : 1;
 
-    //
-    // The ending time of ECN validation testing state in microseconds.
-    //
-    uint64_t EcnTestingEndingTime;
-
     //
     // The currently calculated path MTU.
     //
@@ -132,24 +129,42 @@ typedef struct QUIC_PATH {
     uint16_t LocalMtu;
 
     //
-    // MTU Discovery logic.
+    // Used on the server side until the client's IP address has been validated
+    // to prevent the server from being used for amplification attacks. A value
+    // of UINT32_MAX indicates this variable does not apply.
     //
-    QUIC_MTU_DISCOVERY MtuDiscovery;
+    uint32_t Allowance;
+
+    //
+    // The congestion window (in bytes) the connection had built up on this
+    // path when it last stopped being the active path, or zero. Used to
+    // carefully resume if the path becomes active again.
+    //
+    uint32_t SavedCongestionWindow;
 
     //
     // The binding used for sending/receiving UDP packets.
     //
     QUIC_BINDING* Binding;
 
+    //
+    // The destination CID used for sending on this path.
+    //
+    QUIC_CID_LIST_ENTRY* DestCid;
+
     //
     // The network route.
     //
     CXPLAT_ROUTE Route;
 
     //
-    // The destination CID used for sending on this path.
+    // The 1-RTT short header last used on this path, less the packet number.
+    // It only changes with the destination CID, spin bit, key phase or fixed
+    // bit, so it is copied as-is into each packet until invalidated (length
+    // of zero) by one of those changing.
     //
-    QUIC_CID_LIST_ENTRY* DestCid;
+    uint8_t ShortHeaderTemplateLength;
+    uint8_t ShortHeaderTemplate[1 + QUIC_MAX_CONNECTION_ID_LENGTH_V1 + 4];
 
     //
     // RTT moving average, computed as in RFC6298. Units of microseconds.
@@ -163,11 +178,18 @@ typedef struct QUIC_PATH {
     uint64_t OneWayDelayLatest;
 
     //
-    // Used on the server side until the client's IP address has been validated
-    // to prevent the server from being used for amplification attacks. A value
-    // of UINT32_MAX indicates this variable does not apply.
+    // Cold State
     //
-    uint32_t Allowance;
+
+    //
+    // The ending time of ECN validation testing state in microseconds.
+    //
+    uint64_t EcnTestingEndingTime;
+
+    //
+    // MTU Discovery logic.
+    //
+    QUIC_MTU_DISCOVERY MtuDiscovery;
 
     //
     // The last path challenge we received and needs to be sent back as in a
@@ -199,8 +221,14 @@ typedef struct QUIC_PATH {
 #endif
 
 CXPLAT_STATIC_ASSERT(
-    sizeof(QUIC_PATH) < 256,
+    sizeof(QUIC_PATH) < 288,
     "Ensure path struct stays small since we prealloc them");
+CXPLAT_STATIC_ASSERT(
+    CXPLAT_STRUCT_SIZE_THRU_FIELD(QUIC_PATH, DestCid) <= QUIC_CACHE_LINE_SIZE,
+    "Per-packet send state must stay in the first cache line");
+CXPLAT_STATIC_ASSERT(
+    CXPLAT_STRUCT_SIZE_THRU_FIELD(QUIC_PATH, Route) <= 2 * QUIC_CACHE_LINE_SIZE,
+    "The route must stay in the first two cache lines");
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
@@ -251,6 +279,19 @@ QuicPathDecrementAllowance(
         Path->Allowance <= Amount ? 0 : (Path->Allowance - Amount));
 }
 
+//
+// Forces the path's short header template to be rebuilt for the next 1-RTT
+// packet.
+//
+QUIC_INLINE
+void
+QuicPathInvalidateShortHeader(
+    _In_ QUIC_PATH* Path
+    )
+{
+    Path->ShortHeaderTemplateLength = 0;
+}
+
 //
 // Calculates the maximum size datagram payload from the path's MTU.
 //
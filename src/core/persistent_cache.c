@@ -0,0 +1,764 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The persistent cache keeps client resumption tickets and per-destination
+    path metrics in an append-only file, so that a restarted process resumes
+    its sessions and warm starts its connections like it did before.
+
+    The in-memory caches (the ticket list here and the library's path metrics
+    cache) are the source of truth. Once a second, the flush thread appends a
+    record for everything that changed since the last flush; a later record
+    for the same key supersedes earlier ones, and a ticket record without a
+    ticket deletes it. Once the file has grown to twice its size after the
+    last compaction, the flush thread instead writes out just the live entries
+    and atomically replaces the file with them.
+
+    Each record carries a checksum, so a record torn by a crash while it was
+    being appended ends the load, and the file is compacted right away.
+
+--*/
+
+#include "precomp.h"
+
+#define QUIC_PERSISTENT_CACHE_MAGIC         0x31435051 // "QPC1"
+
+typedef enum QUIC_PERSISTENT_RECORD_TYPE {
+    QUIC_PERSISTENT_RECORD_PATH_METRICS = 1,
+    QUIC_PERSISTENT_RECORD_TICKET       = 2
+} QUIC_PERSISTENT_RECORD_TYPE;
+
+typedef struct QUIC_PERSISTENT_RECORD_HEADER {
+
+    uint32_t Length;        // Of the whole record, including this header.
+    uint32_t Checksum;      // Of the rest of the record.
+    uint64_t EpochTimeMs;   // When the entry was written to its cache.
+    uint8_t Type;           // QUIC_PERSISTENT_RECORD_TYPE
+    uint8_t Reserved[7];
+
+} QUIC_PERSISTENT_RECORD_HEADER;
+
+typedef struct QUIC_PERSISTENT_PATH_METRICS_RECORD {
+
+    QUIC_PERSISTENT_RECORD_HEADER Header;
+    uint16_t Family;
+    uint16_t Mtu;
+    uint32_t CongestionWindow;
+    uint8_t Address[16];    // The cache key, see QuicLibraryGetPathMetricsKey.
+    uint64_t SmoothedRtt;
+    uint64_t MinRtt;
+
+} QUIC_PERSISTENT_PATH_METRICS_RECORD;
+
+typedef struct QUIC_PERSISTENT_TICKET_RECORD {
+
+    QUIC_PERSISTENT_RECORD_HEADER Header;
+    uint16_t ServerPort;
+    uint16_t ServerNameLength;
+    uint32_t TicketLength;  // Zero deletes the ticket.
+    //
+    // The server name and the ticket follow.
+    //
+
+} QUIC_PERSISTENT_TICKET_RECORD;
+
+//
+// FNV-1a. Only guards against torn or corrupted records.
+//
+static
+uint32_t
+QuicPersistentCacheChecksum(
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer,
+    _In_ uint32_t Length
+    )
+{
+    uint32_t Hash = 2166136261u;
+    for (uint32_t i = 0; i < Length; ++i) {
+        Hash = (Hash ^ Buffer[i]) * 16777619u;
+    }
+    return Hash;
+}
+
+static
+QUIC_PERSISTENT_TICKET*
+QuicPersistentCacheFindTicket(
+    _In_ QUIC_PERSISTENT_CACHE* Cache,
+    _In_reads_bytes_(ServerNameLength)
+        const uint8_t* ServerName,
+    _In_ uint16_t ServerNameLength,
+    _In_ uint16_t ServerPort
+    )
+{
+    for (CXPLAT_LIST_ENTRY* Entry = Cache->Tickets.Flink;
+         Entry != &Cache->Tickets;
+         Entry = Entry->Flink) {
+        QUIC_PERSISTENT_TICKET* Ticket =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_PERSISTENT_TICKET, Link);
+        if (Ticket->ServerPort == ServerPort &&
+            Ticket->ServerNameLength == ServerNameLength &&
+            memcmp(Ticket->Data, ServerName, ServerNameLength) == 0) {
+            return Ticket;
+        }
+    }
+    return NULL;
+}
+
+//
+// Removes a ticket from the cache. Tickets already in the file are kept until
+// the next flush writes their deletion. Called with the cache lock held.
+//
+static
+void
+QuicPersistentCacheRemoveTicket(
+    _In_ QUIC_PERSISTENT_CACHE* Cache,
+    _In_ QUIC_PERSISTENT_TICKET* Ticket
+    )
+{
+    CxPlatListEntryRemove(&Ticket->Link);
+    Cache->TicketCount--;
+    if (Ticket->Persisted) {
+        CxPlatListInsertTail(&Cache->DeletedTickets, &Ticket->Link);
+    } else {
+        CXPLAT_FREE(Ticket, QUIC_POOL_PERSISTENT_CACHE);
+    }
+}
+
+//
+// Adds a ticket to the front of the cache, replacing the one for the same
+// server and evicting the least recently stored one if the cache is full.
+// Called with the cache lock held.
+//
+static
+void
+QuicPersistentCacheInsertTicket(
+    _In_ QUIC_PERSISTENT_CACHE* Cache,
+    _In_ QUIC_PERSISTENT_TICKET* Ticket
+    )
+{
+    QUIC_PERSISTENT_TICKET* Old =
+        QuicPersistentCacheFindTicket(
+            Cache, Ticket->Data, Ticket->ServerNameLength, Ticket->ServerPort);
+    if (Old != NULL) {
+        //
+        // The new ticket's record supersedes the old one's in the file.
+        //
+        CxPlatListEntryRemove(&Old->Link);
+        Cache->TicketCount--;
+        CXPLAT_FREE(Old, QUIC_POOL_PERSISTENT_CACHE);
+    }
+
+    CxPlatListInsertHead(&Cache->Tickets, &Ticket->Link);
+    if (++Cache->TicketCount > QUIC_PERSISTENT_CACHE_MAX_TICKETS) {
+        QuicPersistentCacheRemoveTicket(
+            Cache,
+            CXPLAT_CONTAINING_RECORD(Cache->Tickets.Blink, QUIC_PERSISTENT_TICKET, Link));
+    }
+}
+
+static
+void
+QuicPersistentCacheFreeTickets(
+    _In_ QUIC_PERSISTENT_CACHE* Cache
+    )
+{
+    while (!CxPlatListIsEmpty(&Cache->Tickets)) {
+        CXPLAT_FREE(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Cache->Tickets), QUIC_PERSISTENT_TICKET, Link),
+            QUIC_POOL_PERSISTENT_CACHE);
+    }
+    while (!CxPlatListIsEmpty(&Cache->DeletedTickets)) {
+        CXPLAT_FREE(
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Cache->DeletedTickets), QUIC_PERSISTENT_TICKET, Link),
+            QUIC_POOL_PERSISTENT_CACHE);
+    }
+    Cache->TicketCount = 0;
+}
+
+//
+// Loads one record. Returns FALSE if the record is invalid.
+//
+static
+BOOLEAN
+QuicPersistentCacheLoadRecord(
+    _In_ QUIC_PERSISTENT_CACHE* Cache,
+    _In_reads_bytes_(Length)
+        const uint8_t* Record,
+    _In_ uint32_t Length,
+    _In_ uint64_t EpochTimeMs
+    )
+{
+    QUIC_PERSISTENT_RECORD_HEADER Header;
+    CxPlatCopyMemory(&Header, Record, sizeof(Header));
+    const uint64_t AgeMs =
+        EpochTimeMs > Header.EpochTimeMs ? EpochTimeMs - Header.EpochTimeMs : 0;
+
+    if (Header.Type == QUIC_PERSISTENT_RECORD_PATH_METRICS) {
+        QUIC_PERSISTENT_PATH_METRICS_RECORD PathRecord;
+        if (Length != sizeof(PathRecord)) {
+            return FALSE;
+        }
+        CxPlatCopyMemory(&PathRecord, Record, sizeof(PathRecord));
+        if (MS_TO_US(AgeMs) >= QUIC_PATH_METRICS_MAX_AGE) {
+            return TRUE; // Too old to be used anymore.
+        }
+
+        QUIC_ADDR RemoteAddress = {0};
+        QuicAddrSetFamily(&RemoteAddress, (QUIC_ADDRESS_FAMILY)PathRecord.Family);
+        if (PathRecord.Family == QUIC_ADDRESS_FAMILY_INET) {
+            CxPlatCopyMemory(
+                &RemoteAddress.Ipv4.sin_addr,
+                PathRecord.Address,
+                sizeof(RemoteAddress.Ipv4.sin_addr));
+        } else if (PathRecord.Family == QUIC_ADDRESS_FAMILY_INET6) {
+            CxPlatCopyMemory(
+                &RemoteAddress.Ipv6.sin6_addr,
+                PathRecord.Address,
+                sizeof(RemoteAddress.Ipv6.sin6_addr));
+        } else {
+            return FALSE;
+        }
+
+        QUIC_PATH_METRICS Metrics;
+        Metrics.SmoothedRtt = PathRecord.SmoothedRtt;
+        Metrics.MinRtt = PathRecord.MinRtt;
+        Metrics.CongestionWindow = PathRecord.CongestionWindow;
+        Metrics.Mtu = PathRecord.Mtu;
+        QuicLibraryRestorePathMetrics(&RemoteAddress, MS_TO_US(AgeMs), &Metrics);
+
+    } else if (Header.Type == QUIC_PERSISTENT_RECORD_TICKET) {
+        QUIC_PERSISTENT_TICKET_RECORD TicketRecord;
+        if (Length < sizeof(TicketRecord)) {
+            return FALSE;
+        }
+        CxPlatCopyMemory(&TicketRecord, Record, sizeof(TicketRecord));
+        if (Length !=
+                sizeof(TicketRecord) +
+                (uint64_t)TicketRecord.ServerNameLength + TicketRecord.TicketLength) {
+            return FALSE;
+        }
+        const uint8_t* ServerName = Record + sizeof(TicketRecord);
+
+        QUIC_PERSISTENT_TICKET* Old =
+            QuicPersistentCacheFindTicket(
+                Cache, ServerName, TicketRecord.ServerNameLength, TicketRecord.ServerPort);
+        if (Old != NULL) {
+            CxPlatListEntryRemove(&Old->Link);
+            Cache->TicketCount--;
+            CXPLAT_FREE(Old, QUIC_POOL_PERSISTENT_CACHE);
+        }
+        if (TicketRecord.TicketLength == 0 ||
+            AgeMs >= QUIC_PERSISTENT_CACHE_TICKET_MAX_AGE_MS) {
+            return TRUE;
+        }
+
+        const uint32_t DataLength =
+            TicketRecord.ServerNameLength + TicketRecord.TicketLength;
+        QUIC_PERSISTENT_TICKET* Ticket =
+            CXPLAT_ALLOC_NONPAGED(
+                sizeof(QUIC_PERSISTENT_TICKET) + DataLength,
+                QUIC_POOL_PERSISTENT_CACHE);
+        if (Ticket == NULL) {
+            return TRUE;
+        }
+        Ticket->EpochTimeMs = Header.EpochTimeMs;
+        Ticket->Persisted = TRUE;
+        Ticket->ServerPort = TicketRecord.ServerPort;
+        Ticket->ServerNameLength = TicketRecord.ServerNameLength;
+        Ticket->TicketLength = TicketRecord.TicketLength;
+        CxPlatCopyMemory(Ticket->Data, ServerName, DataLength);
+        QuicPersistentCacheInsertTicket(Cache, Ticket);
+
+    } else {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+//
+// Loads the cache file. Returns FALSE if it isn't entirely valid, so that it
+// gets rewritten from what could be loaded.
+//
+static
+BOOLEAN
+QuicPersistentCacheLoad(
+    _In_ QUIC_PERSISTENT_CACHE* Cache
+    )
+{
+    const uint8_t* Data;
+    uint64_t Length;
+    if (QUIC_FAILED(CxPlatStorageFileMap(Cache->File, &Data, &Length))) {
+        return FALSE;
+    }
+
+    Cache->FileSize = Length;
+    Cache->CompactedSize = Length;
+
+    BOOLEAN Valid = FALSE;
+    uint32_t Magic;
+    if (Length < sizeof(Magic) || Length > UINT32_MAX) {
+        goto Exit;
+    }
+    CxPlatCopyMemory(&Magic, Data, sizeof(Magic));
+    if (Magic != QUIC_PERSISTENT_CACHE_MAGIC) {
+        goto Exit;
+    }
+
+    const uint64_t EpochTimeMs = CxPlatTimeEpochMs64();
+    uint64_t Offset = sizeof(Magic);
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    while (Length - Offset >= sizeof(QUIC_PERSISTENT_RECORD_HEADER)) {
+        QUIC_PERSISTENT_RECORD_HEADER Header;
+        CxPlatCopyMemory(&Header, Data + Offset, sizeof(Header));
+        if (Header.Length < sizeof(Header) ||
+            Header.Length > Length - Offset ||
+            Header.Checksum !=
+                QuicPersistentCacheChecksum(
+                    Data + Offset + FIELD_OFFSET(QUIC_PERSISTENT_RECORD_HEADER, EpochTimeMs),
+                    Header.Length - FIELD_OFFSET(QUIC_PERSISTENT_RECORD_HEADER, EpochTimeMs)) ||
+            !QuicPersistentCacheLoadRecord(Cache, Data + Offset, Header.Length, EpochTimeMs)) {
+            break;
+        }
+        Offset += Header.Length;
+    }
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    Valid = Offset == Length;
+
+Exit:
+
+    CxPlatStorageFileUnmap(Cache->File, Data, Length);
+    return Valid;
+}
+
+//
+// Reserves space for a record at the end of the flush buffer.
+//
+static
+_Ret_maybenull_
+uint8_t*
+QuicPersistentCacheReserve(
+    _In_ QUIC_PERSISTENT_CACHE* Cache,
+    _In_ uint32_t Length
+    )
+{
+    if (Cache->BufferAllocLength - Cache->BufferLength < Length) {
+        uint32_t NewAllocLength =
+            CXPLAT_MAX(Cache->BufferAllocLength * 2, Cache->BufferLength + Length);
+        uint8_t* NewBuffer =
+            CXPLAT_ALLOC_NONPAGED(NewAllocLength, QUIC_POOL_PERSISTENT_CACHE);
+        if (NewBuffer == NULL) {
+            return NULL;
+        }
+        if (Cache->Buffer != NULL) {
+            CxPlatCopyMemory(NewBuffer, Cache->Buffer, Cache->BufferLength);
+            CXPLAT_FREE(Cache->Buffer, QUIC_POOL_PERSISTENT_CACHE);
+        }
+        Cache->Buffer = NewBuffer;
+        Cache->BufferAllocLength = NewAllocLength;
+    }
+
+    uint8_t* Record = Cache->Buffer + Cache->BufferLength;
+    Cache->BufferLength += Length;
+    return Record;
+}
+
+static
+void
+QuicPersistentCacheFinishRecord(
+    _Inout_updates_bytes_(Length)
+        uint8_t* Record,
+    _In_ uint32_t Length,
+    _In_ QUIC_PERSISTENT_RECORD_TYPE Type,
+    _In_ uint64_t EpochTimeMs
+    )
+{
+    QUIC_PERSISTENT_RECORD_HEADER Header = {0};
+    Header.Length = Length;
+    Header.EpochTimeMs = EpochTimeMs;
+    Header.Type = (uint8_t)Type;
+    CxPlatCopyMemory(Record, &Header, sizeof(Header));
+    Header.Checksum =
+        QuicPersistentCacheChecksum(
+            Record + FIELD_OFFSET(QUIC_PERSISTENT_RECORD_HEADER, EpochTimeMs),
+            Length - FIELD_OFFSET(QUIC_PERSISTENT_RECORD_HEADER, EpochTimeMs));
+    CxPlatCopyMemory(
+        Record + FIELD_OFFSET(QUIC_PERSISTENT_RECORD_HEADER, Checksum),
+        &Header.Checksum,
+        sizeof(Header.Checksum));
+}
+
+static
+BOOLEAN
+QuicPersistentCacheWriteTicket(
+    _In_ QUIC_PERSISTENT_CACHE* Cache,
+    _In_ const QUIC_PERSISTENT_TICKET* Ticket,
+    _In_ BOOLEAN Deleted
+    )
+{
+    QUIC_PERSISTENT_TICKET_RECORD TicketRecord = {0};
+    TicketRecord.ServerPort = Ticket->ServerPort;
+    TicketRecord.ServerNameLength = Ticket->ServerNameLength;
+    TicketRecord.TicketLength = Deleted ? 0 : Ticket->TicketLength;
+
+    const uint32_t Length =
+        sizeof(TicketRecord) + TicketRecord.ServerNameLength + TicketRecord.TicketLength;
+    uint8_t* Record = QuicPersistentCacheReserve(Cache, Length);
+    if (Record == NULL) {
+        return FALSE;
+    }
+
+    CxPlatCopyMemory(Record, &TicketRecord, sizeof(TicketRecord));
+    CxPlatCopyMemory(
+        Record + sizeof(TicketRecord),
+        Ticket->Data,
+        TicketRecord.ServerNameLength + TicketRecord.TicketLength);
+    QuicPersistentCacheFinishRecord(
+        Record, Length, QUIC_PERSISTENT_RECORD_TICKET, Ticket->EpochTimeMs);
+    return TRUE;
+}
+
+//
+// Writes what changed since the last flush to the file, or, when compacting,
+// replaces the file with all live entries. Only called on the flush thread.
+//
+static
+void
+QuicPersistentCacheFlush(
+    _In_ QUIC_PERSISTENT_CACHE* Cache
+    )
+{
+    const BOOLEAN Compact =
+        Cache->CompactNeeded ||
+        (Cache->FileSize >= QUIC_PERSISTENT_CACHE_COMPACT_MIN_SIZE &&
+         Cache->FileSize >= 2 * Cache->CompactedSize);
+    BOOLEAN Complete = TRUE;
+
+    Cache->BufferLength = 0;
+    if (Compact) {
+        const uint32_t Magic = QUIC_PERSISTENT_CACHE_MAGIC;
+        uint8_t* Header = QuicPersistentCacheReserve(Cache, sizeof(Magic));
+        if (Header == NULL) {
+            return;
+        }
+        CxPlatCopyMemory(Header, &Magic, sizeof(Magic));
+    }
+
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    const uint64_t EpochTimeMs = CxPlatTimeEpochMs64();
+
+    CxPlatDispatchLockAcquire(&MsQuicLib.PathMetricsCacheLock);
+    for (uint32_t i = 0; i < QUIC_PATH_METRICS_CACHE_SIZE; ++i) {
+        QUIC_PATH_METRICS_CACHE_ENTRY* Entry = &MsQuicLib.PathMetricsCache[i];
+        if (Entry->TimeUs == 0 || !(Compact || Entry->Dirty)) {
+            continue;
+        }
+        uint8_t* Record =
+            QuicPersistentCacheReserve(Cache, sizeof(QUIC_PERSISTENT_PATH_METRICS_RECORD));
+        if (Record == NULL) {
+            Complete = FALSE;
+            break;
+        }
+        QUIC_PERSISTENT_PATH_METRICS_RECORD PathRecord = {0};
+        PathRecord.Family = (uint16_t)QuicAddrGetFamily(&Entry->RemoteAddress);
+        if (PathRecord.Family == QUIC_ADDRESS_FAMILY_INET) {
+            CxPlatCopyMemory(
+                PathRecord.Address,
+                &Entry->RemoteAddress.Ipv4.sin_addr,
+                sizeof(Entry->RemoteAddress.Ipv4.sin_addr));
+        } else {
+            CxPlatCopyMemory(
+                PathRecord.Address,
+                &Entry->RemoteAddress.Ipv6.sin6_addr,
+                sizeof(Entry->RemoteAddress.Ipv6.sin6_addr));
+        }
+        PathRecord.Mtu = Entry->Metrics.Mtu;
+        PathRecord.CongestionWindow = Entry->Metrics.CongestionWindow;
+        PathRecord.SmoothedRtt = Entry->Metrics.SmoothedRtt;
+        PathRecord.MinRtt = Entry->Metrics.MinRtt;
+        CxPlatCopyMemory(Record, &PathRecord, sizeof(PathRecord));
+        QuicPersistentCacheFinishRecord(
+            Record,
+            sizeof(PathRecord),
+            QUIC_PERSISTENT_RECORD_PATH_METRICS,
+            EpochTimeMs - US_TO_MS(CxPlatTimeDiff64(Entry->TimeUs, TimeNow)));
+        Entry->Dirty = FALSE;
+    }
+    CxPlatDispatchLockRelease(&MsQuicLib.PathMetricsCacheLock);
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    for (CXPLAT_LIST_ENTRY* Entry = Cache->Tickets.Flink;
+         Complete && Entry != &Cache->Tickets;
+         Entry = Entry->Flink) {
+        QUIC_PERSISTENT_TICKET* Ticket =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_PERSISTENT_TICKET, Link);
+        if (Compact || !Ticket->Persisted) {
+            if (!QuicPersistentCacheWriteTicket(Cache, Ticket, FALSE)) {
+                Complete = FALSE;
+                break;
+            }
+            Ticket->Persisted = TRUE;
+        }
+    }
+    while (Complete && !CxPlatListIsEmpty(&Cache->DeletedTickets)) {
+        QUIC_PERSISTENT_TICKET* Ticket =
+            CXPLAT_CONTAINING_RECORD(
+                Cache->DeletedTickets.Flink, QUIC_PERSISTENT_TICKET, Link);
+        if (!Compact && !QuicPersistentCacheWriteTicket(Cache, Ticket, TRUE)) {
+            Complete = FALSE;
+            break;
+        }
+        CxPlatListEntryRemove(&Ticket->Link);
+        CXPLAT_FREE(Ticket, QUIC_POOL_PERSISTENT_CACHE);
+    }
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    if (Compact) {
+        if (Complete) {
+            Status =
+                CxPlatStorageFileReplace(Cache->File, Cache->BufferLength, Cache->Buffer);
+            if (QUIC_SUCCEEDED(Status)) {
+                Cache->FileSize = Cache->BufferLength;
+                Cache->CompactedSize = Cache->BufferLength;
+            }
+        }
+    } else if (Cache->BufferLength != 0) {
+        Status =
+            CxPlatStorageFileAppend(Cache->File, Cache->BufferLength, Cache->Buffer);
+        if (QUIC_SUCCEEDED(Status)) {
+            Cache->FileSize += Cache->BufferLength;
+        }
+    }
+
+    //
+    // Anything that didn't make it into the file is written by a compaction
+    // on the next flush.
+    //
+    Cache->CompactNeeded = !Complete || QUIC_FAILED(Status);
+}
+
+CXPLAT_THREAD_CALLBACK(QuicPersistentCacheFlushWorker, Context)
+{
+    QUIC_PERSISTENT_CACHE* Cache = (QUIC_PERSISTENT_CACHE*)Context;
+
+    BOOLEAN Shutdown;
+    do {
+        CxPlatEventWaitWithTimeout(
+            Cache->FlushEvent, QUIC_PERSISTENT_CACHE_FLUSH_INTERVAL_MS);
+        Shutdown = Cache->FlushShutdown;
+        QuicPersistentCacheFlush(Cache); // One last time on shutdown.
+    } while (!Shutdown);
+
+    CXPLAT_THREAD_RETURN(QUIC_STATUS_SUCCESS);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPersistentCacheInitialize(
+    void
+    )
+{
+    QUIC_PERSISTENT_CACHE* Cache = &MsQuicLib.PersistentCache;
+    CxPlatZeroMemory(Cache, sizeof(*Cache));
+    CxPlatDispatchLockInitialize(&Cache->Lock);
+    CxPlatListInitializeHead(&Cache->Tickets);
+    CxPlatListInitializeHead(&Cache->DeletedTickets);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPersistentCacheUninitialize(
+    void
+    )
+{
+    (void)QuicPersistentCacheSetPath(NULL);
+    CxPlatDispatchLockUninitialize(&MsQuicLib.PersistentCache.Lock);
+}
+
+static
+void
+QuicPersistentCacheClose(
+    _In_ QUIC_PERSISTENT_CACHE* Cache
+    )
+{
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    Cache->Enabled = FALSE;
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    if (Cache->FlushThread) {
+        Cache->FlushShutdown = TRUE;
+        CxPlatEventSet(Cache->FlushEvent);
+        CxPlatThreadWait(&Cache->FlushThread);
+        CxPlatThreadDelete(&Cache->FlushThread);
+        Cache->FlushThread = 0;
+        CxPlatEventUninitialize(Cache->FlushEvent);
+    }
+
+    CxPlatStorageFileClose(Cache->File);
+    Cache->File = NULL;
+    if (Cache->Path != NULL) {
+        CXPLAT_FREE(Cache->Path, QUIC_POOL_PERSISTENT_CACHE);
+        Cache->Path = NULL;
+    }
+    if (Cache->Buffer != NULL) {
+        CXPLAT_FREE(Cache->Buffer, QUIC_POOL_PERSISTENT_CACHE);
+        Cache->Buffer = NULL;
+        Cache->BufferAllocLength = 0;
+    }
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    QuicPersistentCacheFreeTickets(Cache);
+    CxPlatDispatchLockRelease(&Cache->Lock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicPersistentCacheSetPath(
+    _In_opt_z_ const char* Path
+    )
+{
+    QUIC_PERSISTENT_CACHE* Cache = &MsQuicLib.PersistentCache;
+
+    if (Cache->File != NULL) {
+        QuicPersistentCacheClose(Cache);
+    }
+
+    if (Path == NULL) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    QUIC_STATUS Status;
+    const size_t PathLength = strlen(Path) + 1;
+    Cache->Path = CXPLAT_ALLOC_NONPAGED(PathLength, QUIC_POOL_PERSISTENT_CACHE);
+    if (Cache->Path == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    CxPlatCopyMemory(Cache->Path, Path, PathLength);
+
+    Status = CxPlatStorageFileOpen(Path, &Cache->File);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Cache->CompactNeeded = !QuicPersistentCacheLoad(Cache);
+
+    CxPlatEventInitialize(&Cache->FlushEvent, FALSE, FALSE);
+    Cache->FlushShutdown = FALSE;
+    CXPLAT_THREAD_CONFIG ThreadConfig = {
+        0,
+        0,
+        "QuicPersistentCache",
+        QuicPersistentCacheFlushWorker,
+        Cache,
+    };
+    Status = CxPlatThreadCreate(&ThreadConfig, &Cache->FlushThread);
+    if (QUIC_FAILED(Status)) {
+        CxPlatEventUninitialize(Cache->FlushEvent);
+        Cache->FlushThread = 0;
+        goto Error;
+    }
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    Cache->Enabled = TRUE;
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    return QUIC_STATUS_SUCCESS;
+
+Error:
+
+    QuicPersistentCacheClose(Cache);
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPersistentCacheStoreTicket(
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint32_t TicketLength,
+    _In_reads_bytes_(TicketLength)
+        const uint8_t* Ticket
+    )
+{
+    QUIC_PERSISTENT_CACHE* Cache = &MsQuicLib.PersistentCache;
+
+    const size_t ServerNameLength = strlen(ServerName);
+    if (ServerNameLength > UINT16_MAX || TicketLength == 0 ||
+        TicketLength > UINT32_MAX - ServerNameLength - sizeof(QUIC_PERSISTENT_TICKET_RECORD)) {
+        return;
+    }
+
+    QUIC_PERSISTENT_TICKET* Entry =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_PERSISTENT_TICKET) + ServerNameLength + TicketLength,
+            QUIC_POOL_PERSISTENT_CACHE);
+    if (Entry == NULL) {
+        return;
+    }
+    Entry->EpochTimeMs = CxPlatTimeEpochMs64();
+    Entry->Persisted = FALSE;
+    Entry->ServerPort = ServerPort;
+    Entry->ServerNameLength = (uint16_t)ServerNameLength;
+    Entry->TicketLength = TicketLength;
+    CxPlatCopyMemory(Entry->Data, ServerName, ServerNameLength);
+    CxPlatCopyMemory(Entry->Data + ServerNameLength, Ticket, TicketLength);
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    if (Cache->Enabled) {
+        QuicPersistentCacheInsertTicket(Cache, Entry);
+        Entry = NULL;
+    }
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    if (Entry != NULL) {
+        CXPLAT_FREE(Entry, QUIC_POOL_PERSISTENT_CACHE);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPersistentCacheTakeTicket(
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _Outptr_result_buffer_(*TicketLength)
+        uint8_t** Ticket,
+    _Out_ uint32_t* TicketLength
+    )
+{
+    QUIC_PERSISTENT_CACHE* Cache = &MsQuicLib.PersistentCache;
+    BOOLEAN Found = FALSE;
+
+    const size_t ServerNameLength = strlen(ServerName);
+    if (ServerNameLength > UINT16_MAX) {
+        return FALSE;
+    }
+
+    CxPlatDispatchLockAcquire(&Cache->Lock);
+    QUIC_PERSISTENT_TICKET* Entry =
+        QuicPersistentCacheFindTicket(
+            Cache, (const uint8_t*)ServerName, (uint16_t)ServerNameLength, ServerPort);
+    if (Entry != NULL) {
+        if (CxPlatTimeEpochMs64() - Entry->EpochTimeMs <
+                QUIC_PERSISTENT_CACHE_TICKET_MAX_AGE_MS &&
+            (*Ticket =
+                CXPLAT_ALLOC_NONPAGED(Entry->TicketLength, QUIC_POOL_PERSISTENT_CACHE)) != NULL) {
+            CxPlatCopyMemory(
+                *Ticket, Entry->Data + Entry->ServerNameLength, Entry->TicketLength);
+            *TicketLength = Entry->TicketLength;
+            Found = TRUE;
+        }
+        QuicPersistentCacheRemoveTicket(Cache, Entry);
+    }
+    CxPlatDispatchLockRelease(&Cache->Lock);
+
+    return Found;
+}
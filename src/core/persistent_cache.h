@@ -0,0 +1,145 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    The persistent cache keeps client resumption tickets and per-destination
+    path metrics in a file, so they survive process restarts.
+
+--*/
+
+#pragma once
+
+//
+// A resumption ticket received from a server, kept per server name and port.
+//
+typedef struct QUIC_PERSISTENT_TICKET {
+
+    //
+    // Link in QUIC_PERSISTENT_CACHE.Tickets (most recently stored first) or
+    // QUIC_PERSISTENT_CACHE.DeletedTickets.
+    //
+    CXPLAT_LIST_ENTRY Link;
+
+    //
+    // When the ticket was received, in ms since the epoch.
+    //
+    uint64_t EpochTimeMs;
+
+    //
+    // Whether the ticket is already in the file.
+    //
+    BOOLEAN Persisted;
+
+    uint16_t ServerPort; // Host byte order
+    uint16_t ServerNameLength;
+    uint32_t TicketLength;
+
+    //
+    // The server name (not null-terminated), followed by the ticket.
+    //
+    _Field_size_bytes_(ServerNameLength + TicketLength)
+    uint8_t Data[0];
+
+} QUIC_PERSISTENT_TICKET;
+
+typedef struct QUIC_PERSISTENT_CACHE {
+
+    //
+    // Protects everything below, except the fields only used by the flush
+    // thread.
+    //
+    CXPLAT_DISPATCH_LOCK Lock;
+
+    //
+    // Set while a cache file is open.
+    //
+    BOOLEAN Enabled;
+
+    uint32_t TicketCount;
+    CXPLAT_LIST_ENTRY Tickets;
+
+    //
+    // Tickets removed from the cache that are still in the file.
+    //
+    CXPLAT_LIST_ENTRY DeletedTickets;
+
+    //
+    // The open cache file and its path.
+    //
+    CXPLAT_STORAGE_FILE* File;
+    char* Path;
+
+    //
+    // Flushes changes to the file and compacts it.
+    //
+    CXPLAT_THREAD FlushThread;
+    CXPLAT_EVENT FlushEvent;
+    BOOLEAN FlushShutdown;
+
+    //
+    // Flush thread state: the current file size, the size after the last
+    // compaction, whether the next flush must compact, and the buffer records
+    // are serialized into.
+    //
+    uint64_t FileSize;
+    uint64_t CompactedSize;
+    BOOLEAN CompactNeeded;
+    uint8_t* Buffer;
+    uint32_t BufferLength;
+    uint32_t BufferAllocLength;
+
+} QUIC_PERSISTENT_CACHE;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPersistentCacheInitialize(
+    void
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicPersistentCacheUninitialize(
+    void
+    );
+
+//
+// Opens the cache file at the path, loading what it holds into the ticket and
+// path metrics caches, and starts persisting to it. A NULL path closes the
+// current file. Called with the library lock held.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicPersistentCacheSetPath(
+    _In_opt_z_ const char* Path
+    );
+
+//
+// Caches the latest resumption ticket received from a server.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicPersistentCacheStoreTicket(
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _In_ uint32_t TicketLength,
+    _In_reads_bytes_(TicketLength)
+        const uint8_t* Ticket
+    );
+
+//
+// Removes the cached resumption ticket for a server, if any, and returns it.
+// Tickets are only handed out once. The caller frees the ticket with
+// QUIC_POOL_PERSISTENT_CACHE.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicPersistentCacheTakeTicket(
+    _In_z_ const char* ServerName,
+    _In_ uint16_t ServerPort,
+    _Outptr_result_buffer_(*TicketLength)
+        uint8_t** Ticket,
+    _Out_ uint32_t* TicketLength
+    );
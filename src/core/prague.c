@@ -0,0 +1,488 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Prague congestion control, the scalable (L4S, RFC 9331) congestion
+    controller.
+
+    Packets are marked ECT(1) so that an L4S bottleneck marks them CE at a
+    very shallow queue. Instead of treating CE as loss, the window is reduced
+    once per round trip in proportion to the fraction of packets marked
+    (Alpha, an EWMA of the per round CE ratio, as in DCTCP), which holds the
+    queue near zero while keeping the link full. Loss, or a path that fails
+    ECN validation, falls back to a classic Reno response.
+
+--*/
+
+#include "precomp.h"
+
+#include "prague.h"
+
+//
+// Alpha is measured in (1 / PRAGUE_ALPHA_UNIT).
+//
+#define PRAGUE_ALPHA_UNIT 1024
+
+//
+// Alpha is updated with a gain of 1 / (1 << PRAGUE_ALPHA_GAIN_SHIFT).
+//
+#define PRAGUE_ALPHA_GAIN_SHIFT 4
+
+//
+// Flows with an RTT below this grow their window more slowly, so that they
+// are no more aggressive (per unit of time) than a flow with this RTT.
+//
+#define PRAGUE_VIRTUAL_RTT_US 25000
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint16_t
+    PragueCongestionControlGetMss(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  return QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    PragueCongestionControlCanSend(_In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+  return Prague->BytesInFlight < Prague->CongestionWindow ||
+         Prague->Exemptions > 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlSetExemption(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint8_t NumPackets) {
+  Cc->Prague.Exemptions = NumPackets;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlReset(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ BOOLEAN FullReset) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  Prague->SlowStartThreshold = UINT32_MAX;
+  Prague->IsInRecovery = FALSE;
+  Prague->IsInPersistentCongestion = FALSE;
+  Prague->HasHadCongestionEvent = FALSE;
+  Prague->CongestionWindow =
+      PragueCongestionControlGetMss(Cc) * Prague->InitialWindowPackets;
+  Prague->BytesInFlightMax = Prague->CongestionWindow / 2;
+  Prague->LastSendAllowance = 0;
+  Prague->AiAccumulator = 0;
+  Prague->Alpha = PRAGUE_ALPHA_UNIT;
+  Prague->AckedPacketsInRound = 0;
+  Prague->CePacketsInRound = 0;
+  Prague->RoundEnd = Connection->Send.NextPacketNumber;
+  if (FullReset) {
+    Prague->BytesInFlight = 0;
+  }
+
+  QuicConnLogOutFlowStats(Connection);
+}
+
+//
+// As with Cubic, pace on the window expected in the next round trip so that
+// pacing doesn't slow the window growth. In congestion avoidance the window
+// grows slowly, so stay close to CongestionWindow / RTT to avoid bursts that
+// would trip the shallow L4S marking threshold.
+//
+static uint64_t PragueCongestionControlGetEstimatedWindow(
+    _In_ const QUIC_CONGESTION_CONTROL_PRAGUE *Prague) {
+  if (Prague->CongestionWindow < Prague->SlowStartThreshold) {
+    return CXPLAT_MIN((uint64_t)Prague->CongestionWindow << 1,
+                      Prague->SlowStartThreshold);
+  }
+  return Prague->CongestionWindow +
+         (Prague->CongestionWindow >> 3); // CongestionWindow * 1.125
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    PragueCongestionControlGetSendAllowance(
+        _In_ QUIC_CONGESTION_CONTROL *Cc,
+        _In_ uint64_t TimeSinceLastSend, // microsec
+        _In_ BOOLEAN TimeSinceLastSendValid) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+
+  uint32_t SendAllowance;
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  if (Prague->BytesInFlight >= Prague->CongestionWindow) {
+    //
+    // We are CC blocked, so we can't send anything.
+    //
+    SendAllowance = 0;
+
+  } else if (!TimeSinceLastSendValid || !Connection->Settings.PacingEnabled ||
+             !Connection->Paths[0].GotFirstRttSample ||
+             Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+    //
+    // We're not in the necessary state to pace.
+    //
+    SendAllowance = Prague->CongestionWindow - Prague->BytesInFlight;
+
+  } else {
+    //
+    // We are pacing, so send the estimated window spread evenly over the RTT.
+    //
+    uint64_t EstimatedWnd = PragueCongestionControlGetEstimatedWindow(Prague);
+
+    SendAllowance = Prague->LastSendAllowance +
+                    (uint32_t)((EstimatedWnd * TimeSinceLastSend) /
+                               Connection->Paths[0].SmoothedRtt);
+    if (SendAllowance < Prague->LastSendAllowance || // Overflow case
+        SendAllowance > (Prague->CongestionWindow - Prague->BytesInFlight)) {
+      SendAllowance = Prague->CongestionWindow - Prague->BytesInFlight;
+    }
+
+    Prague->LastSendAllowance = SendAllowance;
+  }
+  return SendAllowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint64_t
+    PragueCongestionControlGetPacingRate(
+        _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  const QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  if (!Connection->Settings.PacingEnabled ||
+      !Connection->Paths[0].GotFirstRttSample ||
+      Connection->Paths[0].SmoothedRtt < QUIC_MIN_PACING_RTT) {
+    return 0;
+  }
+  return PragueCongestionControlGetEstimatedWindow(&Cc->Prague) *
+         CXPLAT_MICROSEC_PER_SEC / Connection->Paths[0].SmoothedRtt;
+}
+
+//
+// Returns TRUE if we became unblocked.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    PragueCongestionControlUpdateBlockedState(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ BOOLEAN PreviousCanSendState) {
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  QuicConnLogOutFlowStats(Connection);
+  if (PreviousCanSendState != PragueCongestionControlCanSend(Cc)) {
+    if (PreviousCanSendState) {
+      QuicConnAddOutFlowBlockedReason(Connection,
+                                      QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+    } else {
+      QuicConnRemoveOutFlowBlockedReason(Connection,
+                                         QUIC_FLOW_BLOCKED_CONGESTION_CONTROL);
+      Connection->Send.LastFlushTime =
+          CxPlatTimeUs64(); // Reset last flush time
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL) void PragueCongestionControlOnDataSent(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ uint32_t NumRetransmittableBytes) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+
+  BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+  Prague->BytesInFlight += NumRetransmittableBytes;
+  if (Prague->BytesInFlightMax < Prague->BytesInFlight) {
+    Prague->BytesInFlightMax = Prague->BytesInFlight;
+    QuicSendBufferConnectionAdjust(QuicCongestionControlGetConnection(Cc));
+  }
+
+  if (NumRetransmittableBytes > Prague->LastSendAllowance) {
+    Prague->LastSendAllowance = 0;
+  } else {
+    Prague->LastSendAllowance -= NumRetransmittableBytes;
+  }
+
+  if (Prague->Exemptions > 0) {
+    --Prague->Exemptions;
+  }
+
+  PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    PragueCongestionControlOnDataInvalidated(_In_ QUIC_CONGESTION_CONTROL *Cc,
+                                             _In_ uint32_t
+                                                 NumRetransmittableBytes) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+
+  BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+  CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= NumRetransmittableBytes);
+  Prague->BytesInFlight -= NumRetransmittableBytes;
+
+  return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlGetNetworkStatistics(
+    _In_ const QUIC_CONNECTION *const Connection,
+    _In_ const QUIC_CONGESTION_CONTROL *const Cc,
+    _Out_ QUIC_NETWORK_STATISTICS *NetworkStatistics) {
+  const QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+  const QUIC_PATH *Path = &Connection->Paths[0];
+
+  NetworkStatistics->BytesInFlight = Prague->BytesInFlight;
+  NetworkStatistics->PostedBytes = Connection->SendBuffer.PostedBytes;
+  NetworkStatistics->IdealBytes = Connection->SendBuffer.IdealBytes;
+  NetworkStatistics->SmoothedRTT = Path->SmoothedRtt;
+  NetworkStatistics->CongestionWindow = Prague->CongestionWindow;
+  NetworkStatistics->Bandwidth = Prague->CongestionWindow / Path->SmoothedRtt;
+}
+
+//
+// Folds the CE ratio of the round trip that just ended into Alpha.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlOnRoundEnd(
+    _In_ QUIC_CONGESTION_CONTROL_PRAGUE *Prague) {
+  if (Prague->AckedPacketsInRound > 0) {
+    uint32_t CeRatio = (uint32_t)CXPLAT_MIN(
+        (uint64_t)Prague->CePacketsInRound * PRAGUE_ALPHA_UNIT /
+            Prague->AckedPacketsInRound,
+        PRAGUE_ALPHA_UNIT);
+    Prague->Alpha = Prague->Alpha - (Prague->Alpha >> PRAGUE_ALPHA_GAIN_SHIFT) +
+                    (CeRatio >> PRAGUE_ALPHA_GAIN_SHIFT);
+  }
+  Prague->AckedPacketsInRound = 0;
+  Prague->CePacketsInRound = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    PragueCongestionControlOnDataAcknowledged(
+        _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ACK_EVENT *AckEvent) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+  uint32_t BytesAcked = AckEvent->NumRetransmittableBytes;
+
+  CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= BytesAcked);
+  Prague->BytesInFlight -= BytesAcked;
+
+  //
+  // The peer's ECN counts cover every packet it received, so count every
+  // acknowledged packet (not just the retransmittable ones) for the CE ratio.
+  //
+  for (const QUIC_SENT_PACKET_METADATA *Packet = AckEvent->AckedPackets;
+       Packet != NULL; Packet = Packet->Next) {
+    Prague->AckedPacketsInRound++;
+  }
+
+  if (!AckEvent->IsImplicit && AckEvent->LargestAck >= Prague->RoundEnd) {
+    Prague->RoundEnd = Connection->Send.NextPacketNumber;
+    PragueCongestionControlOnRoundEnd(Prague);
+  }
+
+  if (Prague->IsInRecovery) {
+    if (AckEvent->LargestAck > Prague->RecoverySentPacketNumber) {
+      Prague->IsInRecovery = FALSE;
+      Prague->IsInPersistentCongestion = FALSE;
+    }
+    goto Exit;
+  } else if (BytesAcked == 0) {
+    goto Exit;
+  }
+
+  if (Prague->CongestionWindow < Prague->SlowStartThreshold) {
+    //
+    // Slow Start
+    //
+    Prague->CongestionWindow += BytesAcked;
+    BytesAcked = 0;
+    if (Prague->CongestionWindow >= Prague->SlowStartThreshold) {
+      BytesAcked = Prague->CongestionWindow - Prague->SlowStartThreshold;
+      Prague->CongestionWindow = Prague->SlowStartThreshold;
+    }
+  }
+
+  if (BytesAcked > 0) {
+    //
+    // Congestion Avoidance: grow by one packet per round trip, scaled down
+    // by (RTT / PRAGUE_VIRTUAL_RTT_US)^2 for short RTTs so that the growth
+    // rate in time doesn't depend on the RTT.
+    //
+    uint64_t Rtt = CXPLAT_MAX(AckEvent->SmoothedRtt, 1);
+    uint64_t ScaledBytesAcked = BytesAcked;
+    if (Rtt < PRAGUE_VIRTUAL_RTT_US) {
+      ScaledBytesAcked = ScaledBytesAcked * Rtt * Rtt /
+                         ((uint64_t)PRAGUE_VIRTUAL_RTT_US * PRAGUE_VIRTUAL_RTT_US);
+    }
+
+    Prague->AiAccumulator += (uint32_t)ScaledBytesAcked;
+    if (Prague->AiAccumulator >= Prague->CongestionWindow) {
+      Prague->AiAccumulator -= Prague->CongestionWindow;
+      Prague->CongestionWindow += PragueCongestionControlGetMss(Cc);
+    }
+  }
+
+  //
+  // Don't grow the window beyond what is actually being used.
+  //
+  if (Prague->CongestionWindow > 2 * Prague->BytesInFlightMax) {
+    Prague->CongestionWindow = 2 * Prague->BytesInFlightMax;
+  }
+
+Exit:
+
+  if (Connection->Settings.NetStatsEventEnabled) {
+    QUIC_CONNECTION_EVENT Event;
+    Event.Type = QUIC_CONNECTION_EVENT_NETWORK_STATISTICS;
+    PragueCongestionControlGetNetworkStatistics(Connection, Cc,
+                                                &Event.NETWORK_STATISTICS);
+    QuicConnIndicateEvent(Connection, &Event);
+  }
+
+  return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlOnDataLost(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_LOSS_EVENT *LossEvent) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+  QUIC_CONNECTION *Connection = QuicCongestionControlGetConnection(Cc);
+  const uint32_t MinWindow =
+      PragueCongestionControlGetMss(Cc) * QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS;
+
+  BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+  //
+  // Loss gets the classic (Reno) response, once per round trip.
+  //
+  if (!Prague->HasHadCongestionEvent ||
+      LossEvent->LargestPacketNumberLost > Prague->RecoverySentPacketNumber) {
+
+    Connection->Stats.Send.CongestionCount++;
+    Prague->RecoverySentPacketNumber = LossEvent->LargestSentPacketNumber;
+    Prague->HasHadCongestionEvent = TRUE;
+    Prague->IsInRecovery = TRUE;
+    Prague->PrevCongestionWindow = Prague->CongestionWindow;
+    Prague->PrevSlowStartThreshold = Prague->SlowStartThreshold;
+
+    if (LossEvent->PersistentCongestion && !Prague->IsInPersistentCongestion) {
+      Connection->Stats.Send.PersistentCongestionCount++;
+      Prague->IsInPersistentCongestion = TRUE;
+      Prague->SlowStartThreshold = CXPLAT_MAX(MinWindow, Prague->CongestionWindow / 2);
+      Prague->CongestionWindow = MinWindow;
+    } else {
+      Prague->SlowStartThreshold = Prague->CongestionWindow =
+          CXPLAT_MAX(MinWindow, Prague->CongestionWindow / 2);
+    }
+    Prague->AiAccumulator = 0;
+  }
+
+  CXPLAT_DBG_ASSERT(Prague->BytesInFlight >= LossEvent->NumRetransmittableBytes);
+  Prague->BytesInFlight -= LossEvent->NumRetransmittableBytes;
+
+  PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlOnEcn(
+    _In_ QUIC_CONGESTION_CONTROL *Cc, _In_ const QUIC_ECN_EVENT *EcnEvent) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+  const uint32_t MinWindow =
+      PragueCongestionControlGetMss(Cc) * QUIC_PERSISTENT_CONGESTION_WINDOW_PACKETS;
+
+  BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+  Prague->CePacketsInRound += EcnEvent->NewCePackets;
+
+  //
+  // Reduce the window in proportion to the marking rate, at most once per
+  // round trip. The connection doesn't enter recovery, so the window keeps
+  // probing (additively) for the edge of the marking threshold.
+  //
+  if (!Prague->HasHadCongestionEvent ||
+      EcnEvent->LargestPacketNumberAcked > Prague->RecoverySentPacketNumber) {
+
+    QuicCongestionControlGetConnection(Cc)->Stats.Send.EcnCongestionCount++;
+    Prague->RecoverySentPacketNumber = EcnEvent->LargestSentPacketNumber;
+    Prague->HasHadCongestionEvent = TRUE;
+
+    uint32_t Reduction = (uint32_t)((uint64_t)Prague->CongestionWindow *
+                                    Prague->Alpha / (2 * PRAGUE_ALPHA_UNIT));
+    Prague->SlowStartThreshold = Prague->CongestionWindow =
+        CXPLAT_MAX(MinWindow, Prague->CongestionWindow - Reduction);
+  }
+
+  PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    PragueCongestionControlOnSpuriousCongestionEvent(
+        _In_ QUIC_CONGESTION_CONTROL *Cc) {
+  QUIC_CONGESTION_CONTROL_PRAGUE *Prague = &Cc->Prague;
+
+  if (!Prague->IsInRecovery) {
+    return FALSE;
+  }
+
+  BOOLEAN PreviousCanSendState = PragueCongestionControlCanSend(Cc);
+
+  Prague->CongestionWindow = Prague->PrevCongestionWindow;
+  Prague->SlowStartThreshold = Prague->PrevSlowStartThreshold;
+  Prague->IsInRecovery = FALSE;
+  Prague->HasHadCongestionEvent = FALSE;
+
+  return PragueCongestionControlUpdateBlockedState(Cc, PreviousCanSendState);
+}
+
+uint32_t PragueCongestionControlGetBytesInFlightMax(
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Prague.BytesInFlightMax;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) uint8_t PragueCongestionControlGetExemptions(
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Prague.Exemptions;
+}
+
+uint32_t PragueCongestionControlGetCongestionWindow(
+    _In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  return Cc->Prague.CongestionWindow;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
+    PragueCongestionControlIsAppLimited(_In_ const QUIC_CONGESTION_CONTROL *Cc) {
+  UNREFERENCED_PARAMETER(Cc);
+  return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlSetAppLimited(
+    _In_ struct QUIC_CONGESTION_CONTROL *Cc) {
+  UNREFERENCED_PARAMETER(Cc);
+}
+
+static const QUIC_CONGESTION_CONTROL QuicCongestionControlPrague = {
+    .Name = "Prague",
+    .IsL4S = TRUE,
+    .QuicCongestionControlCanSend = PragueCongestionControlCanSend,
+    .QuicCongestionControlSetExemption = PragueCongestionControlSetExemption,
+    .QuicCongestionControlReset = PragueCongestionControlReset,
+    .QuicCongestionControlGetSendAllowance =
+        PragueCongestionControlGetSendAllowance,
+    .QuicCongestionControlGetPacingRate = PragueCongestionControlGetPacingRate,
+    .QuicCongestionControlOnDataSent = PragueCongestionControlOnDataSent,
+    .QuicCongestionControlOnDataInvalidated =
+        PragueCongestionControlOnDataInvalidated,
+    .QuicCongestionControlOnDataAcknowledged =
+        PragueCongestionControlOnDataAcknowledged,
+    .QuicCongestionControlOnDataLost = PragueCongestionControlOnDataLost,
+    .QuicCongestionControlOnEcn = PragueCongestionControlOnEcn,
+    .QuicCongestionControlOnSpuriousCongestionEvent =
+        PragueCongestionControlOnSpuriousCongestionEvent,
+    .QuicCongestionControlGetExemptions = PragueCongestionControlGetExemptions,
+    .QuicCongestionControlGetBytesInFlightMax =
+        PragueCongestionControlGetBytesInFlightMax,
+    .QuicCongestionControlIsAppLimited = PragueCongestionControlIsAppLimited,
+    .QuicCongestionControlSetAppLimited = PragueCongestionControlSetAppLimited,
+    .QuicCongestionControlGetCongestionWindow =
+        PragueCongestionControlGetCongestionWindow,
+    .QuicCongestionControlGetNetworkStatistics =
+        PragueCongestionControlGetNetworkStatistics};
+
+_IRQL_requires_max_(DISPATCH_LEVEL) void PragueCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL *Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL *Settings) {
+  *Cc = QuicCongestionControlPrague;
+
+  Cc->Prague.InitialWindowPackets = Settings->InitialWindowPackets;
+
+  PragueCongestionControlReset(Cc, TRUE);
+}
@@ -0,0 +1,102 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+--*/
+
+#pragma once
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct QUIC_CONGESTION_CONTROL_PRAGUE {
+
+    //
+    // TRUE if we have had at least one congestion event (loss or CE).
+    // If TRUE, RecoverySentPacketNumber is valid.
+    //
+    BOOLEAN HasHadCongestionEvent : 1;
+
+    //
+    // TRUE while recovering from a loss. CE marks don't put the connection in
+    // recovery.
+    //
+    BOOLEAN IsInRecovery : 1;
+
+    //
+    // TRUE while recovering from persistent congestion.
+    //
+    BOOLEAN IsInPersistentCongestion : 1;
+
+    //
+    // The size of the initial congestion window, in packets.
+    //
+    uint32_t InitialWindowPackets;
+
+    uint32_t CongestionWindow; // bytes
+    uint32_t PrevCongestionWindow; // bytes
+    uint32_t SlowStartThreshold; // bytes
+    uint32_t PrevSlowStartThreshold; // bytes
+
+    //
+    // Bytes acknowledged in congestion avoidance (scaled for RTT independence)
+    // since the window last grew by one packet.
+    //
+    uint32_t AiAccumulator; // bytes
+
+    //
+    // The number of bytes considered to be still in the network.
+    //
+    uint32_t BytesInFlight;
+    uint32_t BytesInFlightMax;
+
+    //
+    // The leftover send allowance from a previous send. Only used when pacing.
+    //
+    uint32_t LastSendAllowance; // bytes
+
+    //
+    // A count of packets which can be sent ignoring CongestionWindow.
+    //
+    uint8_t Exemptions;
+
+    //
+    // EWMA of the fraction of packets CE marked per round trip, in units of
+    // 1 / PRAGUE_ALPHA_UNIT. Scales the window reduction on CE.
+    //
+    uint32_t Alpha;
+
+    //
+    // Packets acknowledged, and packets reported CE marked, so far in the
+    // current round trip.
+    //
+    uint32_t AckedPacketsInRound;
+    uint32_t CePacketsInRound;
+
+    //
+    // Receiving acknowledgment of a packet at or after RoundEnd ends the
+    // current round trip.
+    //
+    uint64_t RoundEnd; // Packet Number
+
+    //
+    // The largest packet that was outstanding at the time of the last
+    // congestion response. An ACK (or CE report) for any packet number greater
+    // than this allows another response.
+    //
+    uint64_t RecoverySentPacketNumber;
+
+} QUIC_CONGESTION_CONTROL_PRAGUE;
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+PragueCongestionControlInitialize(
+    _In_ QUIC_CONGESTION_CONTROL* Cc,
+    _In_ const QUIC_SETTINGS_INTERNAL* Settings
+    );
+
+#if defined(__cplusplus)
+}
+#endif
@@ -48,7 +48,9 @@
 #include "timer_wheel.h"
 #include "settings.h"
 #include "sent_packet_metadata.h"
+#include "initial_filter.h"
 #include "partition.h"
+#include "persistent_cache.h"
 #include "library.h"
 #include "operation.h"
 #include "binding.h"
@@ -72,8 +74,12 @@
 #include "datagram.h"
 #include "version_neg.h"
 #include "connection.h"
+#include "qlog.h"
 #include "packet_builder.h"
 #include "listener.h"
 #include "cubic.h"
 #include "bbr.h"
+#include "bbr3.h"
+#include "prague.h"
+#include "custom_cc.h"
 #include "sliding_window_extremum.h"
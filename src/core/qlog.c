@@ -0,0 +1,176 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    qlog tracing of sampled connections. Events are encoded compactly (a
+    length byte, a type byte and QUIC variable length integers) into a
+    power-of-two ring buffer; once it is full, the oldest events are dropped
+    to make room. The app reads the trace with QUIC_PARAM_CONN_QLOG (typically
+    on QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE) and qlogconv turns it into
+    JSON-SEQ qlog.
+
+--*/
+
+#include "precomp.h"
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicQlogInitialize(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const uint32_t SamplingInterval = MsQuicLib.QlogConfig.SamplingInterval;
+    if (SamplingInterval == 0 ||
+        (uint32_t)InterlockedIncrement(&MsQuicLib.QlogSampleCount) % SamplingInterval != 0) {
+        return;
+    }
+
+    const uint32_t BufferSize = MsQuicLib.QlogConfig.BufferSize;
+    CXPLAT_DBG_ASSERT((BufferSize & (BufferSize - 1)) == 0);
+
+    QUIC_QLOG* Qlog =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_QLOG) + BufferSize, QUIC_POOL_QLOG);
+    if (Qlog == NULL) {
+        return; // Tracing is best effort.
+    }
+
+    CxPlatZeroMemory(Qlog, sizeof(QUIC_QLOG));
+    Qlog->StartTimeUs = Connection->Stats.Timing.Start;
+    Qlog->StartTimeEpochMs = CxPlatTimeEpochMs64();
+    Qlog->Mask = BufferSize - 1;
+    Connection->Qlog = Qlog;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicQlogUninitialize(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->Qlog != NULL) {
+        CXPLAT_FREE(Connection->Qlog, QUIC_POOL_QLOG);
+        Connection->Qlog = NULL;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogWriteEvent(
+    _In_ QUIC_QLOG* Qlog,
+    _In_ QUIC_QLOG_EVENT_TYPE Type,
+    _In_ uint64_t TimeUs,
+    _In_range_(0, QUIC_QLOG_MAX_FIELDS) uint8_t FieldCount,
+    _In_reads_(FieldCount) const uint64_t* Fields
+    )
+{
+    CXPLAT_DBG_ASSERT(FieldCount <= QUIC_QLOG_MAX_FIELDS);
+
+    uint8_t Event[2 + sizeof(uint64_t) * (1 + QUIC_QLOG_MAX_FIELDS)];
+    uint8_t* End =
+        QuicVarIntEncode(CxPlatTimeDiff64(Qlog->StartTimeUs, TimeUs), Event + 2);
+    for (uint8_t i = 0; i < FieldCount; ++i) {
+        End = QuicVarIntEncode(Fields[i], End);
+    }
+    const uint32_t EventLength = (uint32_t)(End - Event);
+    Event[0] = (uint8_t)(EventLength - 1);
+    Event[1] = (uint8_t)Type;
+
+    //
+    // Drop the oldest events until the new one fits.
+    //
+    const uint64_t BufferSize = (uint64_t)Qlog->Mask + 1;
+    while (Qlog->Tail + EventLength - Qlog->Head > BufferSize) {
+        Qlog->Head += 1 + (uint64_t)Qlog->Buffer[Qlog->Head & Qlog->Mask];
+        Qlog->DroppedEvents++;
+    }
+
+    const uint32_t Offset = (uint32_t)(Qlog->Tail & Qlog->Mask);
+    const uint32_t FirstLength =
+        CXPLAT_MIN(EventLength, (uint32_t)BufferSize - Offset);
+    CxPlatCopyMemory(Qlog->Buffer + Offset, Event, FirstLength);
+    CxPlatCopyMemory(Qlog->Buffer, Event + FirstLength, EventLength - FirstLength);
+    Qlog->Tail += EventLength;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogWriteMetrics(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    QUIC_QLOG* Qlog = Connection->Qlog;
+    const QUIC_PATH* Path = &Connection->Paths[0];
+    const uint64_t Metrics[] = {
+        QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl),
+        Connection->LossDetection.PacketsInFlight,
+        Path->SmoothedRtt,
+        Path->MinRtt,
+        Path->LatestRttSample,
+        Path->RttVariance
+    };
+    CXPLAT_STATIC_ASSERT(
+        sizeof(Metrics) == sizeof(Qlog->Metrics),
+        "Metrics must fit the last written values");
+
+    if (memcmp(Metrics, Qlog->Metrics, sizeof(Metrics)) == 0) {
+        return;
+    }
+    CxPlatCopyMemory(Qlog->Metrics, Metrics, sizeof(Metrics));
+
+    QuicQlogWriteEvent(
+        Qlog,
+        QUIC_QLOG_EVENT_METRICS_UPDATED,
+        CxPlatTimeUs64(),
+        ARRAYSIZE(Metrics),
+        Metrics);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicQlogGet(
+    _In_ const QUIC_CONNECTION* Connection,
+    _Inout_ uint32_t* BufferLength,
+    _Out_writes_bytes_opt_(*BufferLength)
+        void* Buffer
+    )
+{
+    const QUIC_QLOG* Qlog = Connection->Qlog;
+    if (Qlog == NULL) {
+        return QUIC_STATUS_NOT_FOUND;
+    }
+
+    const uint32_t Length = (uint32_t)(Qlog->Tail - Qlog->Head);
+    const uint32_t RequiredLength = sizeof(QUIC_QLOG_HEADER) + Length;
+    if (*BufferLength < RequiredLength) {
+        *BufferLength = RequiredLength;
+        return QUIC_STATUS_BUFFER_TOO_SMALL;
+    }
+
+    if (Buffer == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    QUIC_QLOG_HEADER Header = {
+        .Magic = QUIC_QLOG_MAGIC,
+        .Version = QUIC_QLOG_VERSION,
+        .IsServer = QuicConnIsServer(Connection),
+        .CorrelationId = Connection->Stats.CorrelationId,
+        .StartTimeEpochMs = Qlog->StartTimeEpochMs,
+        .DroppedEvents = Qlog->DroppedEvents,
+        .Length = Length
+    };
+    uint8_t* Output = (uint8_t*)Buffer;
+    CxPlatCopyMemory(Output, &Header, sizeof(Header));
+    Output += sizeof(Header);
+
+    const uint32_t Offset = (uint32_t)(Qlog->Head & Qlog->Mask);
+    const uint32_t FirstLength = CXPLAT_MIN(Length, Qlog->Mask + 1 - Offset);
+    CxPlatCopyMemory(Output, Qlog->Buffer + Offset, FirstLength);
+    CxPlatCopyMemory(Output + FirstLength, Qlog->Buffer, Length - FirstLength);
+
+    *BufferLength = RequiredLength;
+    return QUIC_STATUS_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    qlog tracing of sampled connections. Events are recorded in the binary
+    format described with QUIC_QLOG_HEADER (msquic.h), into a per-connection
+    ring buffer that keeps the most recent events. Only the connection's worker
+    writes to or reads the buffer, so no locking is needed.
+
+--*/
+
+#pragma once
+
+//
+// The most fields any event has.
+//
+#define QUIC_QLOG_MAX_FIELDS 6
+
+typedef struct QUIC_QLOG {
+
+    //
+    // When the connection was created. Event times are relative to it.
+    //
+    uint64_t StartTimeUs;
+    uint64_t StartTimeEpochMs;
+
+    //
+    // Monotonically increasing offsets of the oldest event and of where the
+    // next event is written. Masked to index into Buffer.
+    //
+    uint64_t Head;
+    uint64_t Tail;
+    uint32_t Mask;
+
+    //
+    // Events overwritten because the buffer was full.
+    //
+    uint32_t DroppedEvents;
+
+    //
+    // The metrics last written, so only changes are recorded.
+    //
+    uint64_t Metrics[QUIC_QLOG_MAX_FIELDS];
+
+    _Field_size_bytes_(Mask + 1)
+    uint8_t Buffer[0];
+
+} QUIC_QLOG;
+
+//
+// Starts tracing the new connection, if it is sampled.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicQlogInitialize(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicQlogUninitialize(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogWriteEvent(
+    _In_ QUIC_QLOG* Qlog,
+    _In_ QUIC_QLOG_EVENT_TYPE Type,
+    _In_ uint64_t TimeUs,
+    _In_range_(0, QUIC_QLOG_MAX_FIELDS) uint8_t FieldCount,
+    _In_reads_(FieldCount) const uint64_t* Fields
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicQlogWriteMetrics(
+    _In_ QUIC_CONNECTION* Connection
+    );
+
+//
+// Copies out the header and events, for QUIC_PARAM_CONN_QLOG.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+QuicQlogGet(
+    _In_ const QUIC_CONNECTION* Connection,
+    _Inout_ uint32_t* BufferLength,
+    _Out_writes_bytes_opt_(*BufferLength)
+        void* Buffer
+    );
+
+//
+// 1-RTT packets are logged as such, whatever key phase they use.
+//
+#define QuicQlogKeyType(KeyType) \
+    ((KeyType) > QUIC_PACKET_KEY_1_RTT ? QUIC_PACKET_KEY_1_RTT : (KeyType))
+
+QUIC_INLINE
+void
+QuicQlogPacketSent(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet
+    )
+{
+    if (Connection->Qlog != NULL) {
+        const uint64_t Fields[] = {
+            QuicQlogKeyType(Packet->Flags.KeyType),
+            Packet->PacketNumber,
+            Packet->PacketLength
+        };
+        QuicQlogWriteEvent(
+            Connection->Qlog,
+            QUIC_QLOG_EVENT_PACKET_SENT,
+            Packet->SentTime,
+            ARRAYSIZE(Fields),
+            Fields);
+    }
+}
+
+QUIC_INLINE
+void
+QuicQlogPacketReceived(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_RX_PACKET* Packet
+    )
+{
+    if (Connection->Qlog != NULL) {
+        const uint64_t Fields[] = {
+            QuicQlogKeyType(Packet->KeyType),
+            Packet->PacketNumber,
+            (uint64_t)Packet->HeaderLength + Packet->PayloadLength
+        };
+        QuicQlogWriteEvent(
+            Connection->Qlog,
+            QUIC_QLOG_EVENT_PACKET_RECEIVED,
+            CxPlatTimeUs64(),
+            ARRAYSIZE(Fields),
+            Fields);
+    }
+}
+
+QUIC_INLINE
+void
+QuicQlogPacketLost(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ const QUIC_SENT_PACKET_METADATA* Packet,
+    _In_ uint64_t TimeNow
+    )
+{
+    if (Connection->Qlog != NULL) {
+        const uint64_t Fields[] = {
+            QuicQlogKeyType(Packet->Flags.KeyType),
+            Packet->PacketNumber,
+            Packet->PacketLength
+        };
+        QuicQlogWriteEvent(
+            Connection->Qlog,
+            QUIC_QLOG_EVENT_PACKET_LOST,
+            TimeNow,
+            ARRAYSIZE(Fields),
+            Fields);
+    }
+}
+
+//
+// Records the congestion window and RTT estimates, if they changed.
+//
+QUIC_INLINE
+void
+QuicQlogMetricsUpdated(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->Qlog != NULL) {
+        QuicQlogWriteMetrics(Connection);
+    }
+}
+
+//
+// Streams that never got an ID (never started) aren't logged.
+//
+QUIC_INLINE
+void
+QuicQlogStreamState(
+    _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_QLOG_STREAM_STATE State
+    )
+{
+    if (Stream->Connection->Qlog != NULL && Stream->ID != UINT64_MAX) {
+        const uint64_t Fields[] = { Stream->ID, State };
+        QuicQlogWriteEvent(
+            Stream->Connection->Qlog,
+            QUIC_QLOG_EVENT_STREAM_STATE,
+            CxPlatTimeUs64(),
+            ARRAYSIZE(Fields),
+            Fields);
+    }
+}
@@ -74,10 +74,29 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 #define QUIC_PACKET_REORDER_THRESHOLD           3
 
 //
-// The max expected reordering in terms of time
-// (for RACK loss detection).
+// The most the packet reordering threshold adapts up to after spurious losses.
 //
-#define QUIC_TIME_REORDER_THRESHOLD(rtt)        ((rtt) + ((rtt) / 8))
+#define QUIC_MAX_PACKET_REORDER_THRESHOLD       64
+
+//
+// The max expected reordering in terms of time (for RACK loss detection),
+// given the current reordering window multiplier.
+//
+#define QUIC_TIME_REORDER_THRESHOLD(rtt, mult)  ((rtt) + ((rtt) / 8) * (mult))
+
+//
+// The time reordering window, in units of RTT/8, adapts (once per round trip
+// with a spurious loss) from 1 up to this, i.e. up to a threshold of 2 RTTs.
+// See reo_wnd_mult in RFC 8985.
+//
+#define QUIC_MAX_REORDER_WINDOW_MULTIPLIER      8
+
+//
+// The number of loss recoveries without a spurious loss after which the
+// adapted reordering tolerance goes back to its defaults. See reo_wnd_persist
+// in RFC 8985.
+//
+#define QUIC_REORDER_WINDOW_PERSIST             16
 
 //
 // Number of consecutive PTOs after which the network is considered to be
@@ -85,6 +104,15 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_PERSISTENT_CONGESTION_THRESHOLD    2
 
+//
+// With tail protection enabled, the first probe for a small flight (at most
+// QUIC_TAIL_PROBE_MAX_PACKETS ACK-eliciting packets, with nothing more queued)
+// is sent after this long instead of a full PTO. The peer's max ACK delay is
+// added on top.
+//
+#define QUIC_TAIL_PROBE_MAX_PACKETS             4
+#define QUIC_TAIL_PROBE_TIMEOUT(srtt)           ((srtt) + (srtt) / 4)
+
 //
 // The number of probe timeouts' worth of time to wait in the closing period
 // before timing out.
@@ -103,6 +131,12 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MIN_ACK_SEND_NUMBER                2
 
+//
+// When the peer supports the ACK frequency extension and we aren't scheduling
+// limited, we ask for roughly this many ACKs per congestion window.
+//
+#define QUIC_ACK_FREQUENCY_CWND_FRACTION        4
+
 //
 // The value for Reordering threshold when no ACK_FREQUENCY frame is received.
 // This means that the receiver will immediately acknowledge any out-of-order packets.
@@ -142,6 +176,14 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MAX_THROUGHPUT_PARTITION_OFFSET    2 // Two to skip over hyper-threaded cores
 
+//
+// A partition is considered overloaded, and connections are steered away from
+// it, when its receive rate is this many times the average of all partitions
+// and at least the minimum rate (in packets per second).
+//
+#define QUIC_PARTITION_OVERLOAD_FACTOR          2
+#define QUIC_PARTITION_OVERLOAD_MIN_RATE        10000
+
 //
 // The fraction ((0 to UINT16_MAX) / UINT16_MAX) of memory that must be
 // exhausted before enabling retry.
@@ -171,18 +213,75 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_STATELESS_OPERATION_EXPIRATION_MS  100
 
+//
+// The defaults of the Initial packet filter (QUIC_INITIAL_FILTER_CONFIG): off,
+// with 256 per-source counters per partition over one second windows, forcing
+// a Retry over 64 and dropping over 512 Initial packets per window. The number
+// of counters is capped so a partition's table stays under a few MB.
+//
+#define QUIC_DEFAULT_INITIAL_FILTER_ENABLED     FALSE
+#define QUIC_DEFAULT_INITIAL_FILTER_BUCKET_COUNT 256
+#define QUIC_DEFAULT_INITIAL_FILTER_WINDOW_MS   1000
+#define QUIC_DEFAULT_INITIAL_FILTER_RETRY_THRESHOLD 64
+#define QUIC_DEFAULT_INITIAL_FILTER_DROP_THRESHOLD 512
+#define QUIC_MAX_INITIAL_FILTER_BUCKET_COUNT    (64 * 1024)
+
 //
 // The maximum number of operations a connection will drain from its queue per
 // call to QuicConnDrainOperations.
 //
 #define QUIC_MAX_OPERATIONS_PER_DRAIN           16
 
+//
+// The bounds of the adaptive per-worker drain budget, used in place of
+// QUIC_MAX_OPERATIONS_PER_DRAIN when MaxOperationsPerDrain isn't explicitly
+// configured. The worker shrinks the budget when its queue delay goes above
+// the target (in us) and grows it back when the delay is well under it.
+//
+#define QUIC_MIN_ADAPTIVE_OPERATIONS_PER_DRAIN  2
+#define QUIC_MAX_ADAPTIVE_OPERATIONS_PER_DRAIN  64
+#define QUIC_DRAIN_BUDGET_TARGET_QUEUE_DELAY_US 1000
+
+//
+// Workers schedule their connections with deficit round robin. Each turn, a
+// connection is credited with QUIC_WORKER_SCHEDULING_QUANTUM_US of processing
+// time, scaled by its weight over QUIC_DEFAULT_CONN_SCHEDULING_WEIGHT, and
+// charged for the time it actually took. Connections that are in debt are
+// passed over while others are waiting. The debt is capped so a single long
+// operation doesn't starve the connection.
+//
+#define QUIC_DEFAULT_CONN_SCHEDULING_WEIGHT     16
+#define QUIC_WORKER_SCHEDULING_QUANTUM_US       100
+#define QUIC_WORKER_SCHEDULING_MAX_DEBT_US      (32 * QUIC_WORKER_SCHEDULING_QUANTUM_US)
+
+//
+// The maximum number of connections indicated to the app in a single
+// QUIC_LISTENER_EVENT_NEW_CONNECTIONS event. A worker also indicates its accept
+// queue early once this many connections are waiting in it.
+//
+#define QUIC_MAX_ACCEPT_QUEUE_BATCH             32
+
+//
+// The number of epoch flips an object retired from a lock-free structure must
+// see before it's freed, and how often (in us) idle workers check back while
+// retired objects are waiting.
+//
+#define QUIC_RECLAIM_STAGES                     3
+#define QUIC_RECLAIM_INTERVAL_US                1000
+
+//
+// How often (in us) the library-wide send buffer memory usage is summed from
+// the per-partition counters.
+//
+#define QUIC_SEND_BUFFER_USAGE_REFRESH_US       1000
+
 //
 // Used as a hint for the maximum number of UDP datagrams to send for each
 // FLUSH_SEND operation. The actual number will generally exceed this value up
-// to the limit of the current USO buffer being filled.
+// to the limit of the current USO buffer being filled. Matches the maximum
+// number of segments in a single Linux UDP_SEGMENT send.
 //
-#define QUIC_MAX_DATAGRAMS_PER_SEND             40
+#define QUIC_MAX_DATAGRAMS_PER_SEND             64
 
 //
 // The number of packets we write for a single stream before going to the next
@@ -190,16 +289,44 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_STREAM_SEND_BATCH_COUNT            8
 
+//
+// The number of urgency levels, and the default urgency level, for the urgency
+// stream scheduling scheme (RFC 9218).
+//
+#define QUIC_STREAM_URGENCY_COUNT               8
+#define QUIC_STREAM_URGENCY_DEFAULT             3
+
 //
 // The maximum number of received packets to batch process at a time.
 //
 #define QUIC_MAX_RECEIVE_BATCH_COUNT            32
 
 //
-// The maximum number of crypto operations to batch.
+// The number of stateless reset token hash objects per partition. Threads
+// generating tokens at the same time each claim their own.
+//
+#define QUIC_RESET_TOKEN_HASH_COUNT             4
+
+//
+// The maximum number of crypto operations to batch on receive, and the number
+// of packets sealed together by a packet protection offload.
 //
 #define QUIC_MAX_CRYPTO_BATCH_COUNT             8
 
+//
+// The maximum number of short header packets to batch encryption and header
+// protection for on send. Covers a full segmentation offload send, since each
+// datagram carries at most one short header packet.
+//
+#define QUIC_MAX_SEND_CRYPTO_BATCH_COUNT        QUIC_MAX_DATAGRAMS_PER_SEND
+
+//
+// The number of payload bytes decrypted in place to find a STREAM frame's
+// header before decrypting its data straight into an app-owned buffer. Large
+// enough for the longest possible STREAM frame header.
+//
+#define QUIC_DIRECT_DECRYPT_PREFIX_LENGTH       32
+
 //
 // The maximum number of received packets that may be processed in a single
 // flush operation.
@@ -223,6 +350,98 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_MAX_TLS_SERVER_SEND_BUFFER         (8 * 1024)
 
+//
+// The maximum number of threads used to run offloaded server handshakes and
+// asynchronous credential loads. One is started per processor, up to this.
+//
+#define QUIC_MAX_TLS_OFFLOAD_THREADS            32
+
+//
+// The maximum number of threads sealing packets for connections with
+// parallel packet protection enabled.
+//
+#define QUIC_MAX_PROTECT_OFFLOAD_THREADS        4
+
+//
+// The maximum number of full crypto batches a connection has out being sealed
+// on packet protection offload threads at once.
+//
+#define QUIC_MAX_PROTECT_OFFLOADS               8
+
+//
+// The longest (in us) auto-corking may hold back stream data waiting for a
+// full packet's worth.
+//
+#define QUIC_MAX_SEND_CORK_TIMEOUT_US           25000
+
+//
+// The most received datagrams gathered into one DATAGRAMS_RECEIVED indication.
+//
+#define QUIC_MAX_DATAGRAM_RECV_BATCH_COUNT      16
+
+//
+// The most objects a partition's pool is warmed up with, whatever the app
+// configured. Anything beyond the pool's depth would just be freed again.
+//
+#define QUIC_MAX_POOL_PREWARM_COUNT             256
+
+//
+// The number of random bytes a worker draws from the platform at a time, to
+// hand out for new connection IDs.
+//
+#define QUIC_WORKER_RANDOM_POOL_SIZE            256
+
+//
+// The default and maximum time (in us) a stream with receive batching holds
+// back its RECEIVE indication waiting for more data.
+//
+#define QUIC_DEFAULT_STREAM_RECV_BATCH_TIMEOUT_US   1000
+#define QUIC_MAX_STREAM_RECV_BATCH_TIMEOUT_US       25000
+
+//
+// The number of destinations whose path metrics are cached across
+// connections, and how many of them share a set of the cache.
+//
+#define QUIC_PATH_METRICS_CACHE_SIZE            256
+#define QUIC_PATH_METRICS_CACHE_WAYS            4
+#define QUIC_PATH_METRICS_CACHE_SETS \
+    (QUIC_PATH_METRICS_CACHE_SIZE / QUIC_PATH_METRICS_CACHE_WAYS)
+
+//
+// How long cached RTT and congestion window metrics are used to warm start new
+// connections (in us).
+//
+#define QUIC_PATH_METRICS_MAX_AGE               S_TO_US(600)
+
+//
+// How often the persistent cache appends changes to its file (in ms), and
+// the file size below which it is never compacted.
+//
+#define QUIC_PERSISTENT_CACHE_FLUSH_INTERVAL_MS 1000
+#define QUIC_PERSISTENT_CACHE_COMPACT_MIN_SIZE  (64 * 1024)
+
+//
+// The number of server resumption tickets the persistent cache keeps, and for
+// how long (in ms); TLS 1.3 tickets are valid for at most 7 days.
+//
+#define QUIC_PERSISTENT_CACHE_MAX_TICKETS       256
+#define QUIC_PERSISTENT_CACHE_TICKET_MAX_AGE_MS (7ull * 24 * 60 * 60 * 1000)
+
+//
+// The default and the bounds of the size of a sampled connection's qlog ring
+// buffer, in bytes.
+//
+#define QUIC_QLOG_DEFAULT_BUFFER_SIZE           (64 * 1024)
+#define QUIC_QLOG_MIN_BUFFER_SIZE               1024
+#define QUIC_QLOG_MAX_BUFFER_SIZE               (16 * 1024 * 1024)
+
+//
+// The default and maximum number of network statistics samples a connection
+// keeps, when sampling is enabled.
+//
+#define QUIC_STATS_SAMPLES_DEFAULT_COUNT        512
+#define QUIC_STATS_SAMPLES_MAX_COUNT            65536
+
 //
 // The initial stream FC window size reported to peers.
 //
@@ -233,6 +452,17 @@ typedef struct QUIC_RX_PACKET QUIC_RX_PACKET;
 //
 #define QUIC_DEFAULT_STREAM_RECV_BUFFER_SIZE    0x1000  // 4096
 
+//
+// Receive buffer chunks are pooled per partition in power-of-two size classes,
+// starting at twice the initial allocation (the smallest size a resize can
+// produce) up to QUIC_RECV_CHUNK_POOL_MAX_SIZE. Larger chunks come from the
+// general allocator.
+//
+#define QUIC_RECV_CHUNK_POOL_MIN_SHIFT          13  // 8KB
+#define QUIC_RECV_CHUNK_POOL_COUNT              6
+#define QUIC_RECV_CHUNK_POOL_MAX_SIZE \
+    (1UL << (QUIC_RECV_CHUNK_POOL_MIN_SHIFT + QUIC_RECV_CHUNK_POOL_COUNT - 1)) // 256KB
+
 //
 // The default connection flow control window value, in bytes.
 //
@@ -251,6 +481,17 @@ CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_DUPLICATE_PACKETS), "Must be
 CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_ACK_PACKETS), "Must be power of two");
 CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_MAX_RANGE_DECODE_ACKS), "Must be power of two");
 
+//
+// Size (in bytes) of an ACK tracker's cache of encoded ACK blocks. ACK frames
+// with more blocks than fit are encoded from scratch every time.
+//
+#define QUIC_ACK_BLOCK_CACHE_SIZE               128
+
+//
+// The cache line size assumed when laying out hot structure fields.
+//
+#define QUIC_CACHE_LINE_SIZE                    64
+
 //
 // Minimum MTU allowed to be configured. Must be able to fit a
 // QUIC_MIN_INITIAL_PACKET_LENGTH in an IPv6 datagram.
@@ -334,12 +575,50 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_DEFAULT_KEEP_ALIVE_INTERVAL        0
 
+//
+// The default amount of time (in milliseconds) the idle, keep alive and
+// shutdown timers may be deferred by in order to coalesce them with other
+// timers. Zero disables coalescing.
+//
+#define QUIC_DEFAULT_IDLE_TIMER_SLACK_MS        0
+#define QUIC_DEFAULT_KEEP_ALIVE_TIMER_SLACK_MS  0
+#define QUIC_DEFAULT_SHUTDOWN_TIMER_SLACK_MS    0
+
+//
+// The default maximum number of ACK eliciting packets that may be received
+// in order before an ACK is sent, while no loss or reordering is seen. Zero
+// disables ACK decimation.
+//
+#define QUIC_DEFAULT_ACK_DECIMATION_MAX_PACKETS 0
+
+//
+// The default amount of time (in milliseconds) a connection must go without
+// sending or receiving stream data before its idle memory is released. Zero
+// disables hibernation.
+//
+#define QUIC_DEFAULT_IDLE_HIBERNATE_TIMEOUT_MS  0
+
 //
 // The flow control window is doubled when more than (1 / ratio) of the current
 // window is delivered to the app within 1 RTT.
 //
 #define QUIC_RECV_BUFFER_DRAIN_RATIO            4
 
+//
+// The number of slots in a connection's direct-indexed stream lookup table.
+// Stream IDs are dense per type, so this covers the most recent
+// QUIC_STREAM_INDEX_SIZE / NUMBER_OF_STREAM_TYPES streams of each type.
+//
+#define QUIC_STREAM_INDEX_SIZE                  256
+CXPLAT_STATIC_ASSERT(IS_POWER_OF_TWO(QUIC_STREAM_INDEX_SIZE), "Must be power of two");
+
+//
+// The largest the connection-wide flow control window is grown to by
+// auto-tuning, unless ConnFlowControlWindow is configured larger. This bounds
+// the memory a single connection's receivers can be asked to buffer.
+//
+#define QUIC_MAX_AUTO_TUNED_CONN_FLOW_CONTROL_WINDOW 0x4000000  // 64MB
+
 //
 // The default value for send buffering being enabled or not.
 //
@@ -356,6 +635,24 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_MAX_IDEAL_SEND_BUFFER_SIZE         0x8000000 // 134217728
 
+//
+// The fraction (of UINT16_MAX) of total memory that all connections' send
+// buffers may use together before each connection is held to its fair share.
+//
+#define QUIC_DEFAULT_SEND_BUFFER_MEMORY_FRACTION 6554 // ~10%
+
+//
+// The fraction (of UINT16_MAX) of total memory the library as a whole may use
+// for connection state and buffers before the memory governor reacts, and the
+// percentages of that limit at which each governor stage starts. A stage ends
+// once usage drops QUIC_MEMORY_PRESSURE_HYSTERESIS_PERCENT below its start.
+//
+#define QUIC_DEFAULT_MEMORY_LIMIT_FRACTION      16384 // ~25%
+#define QUIC_MEMORY_PRESSURE_SHRINK_RECV_PERCENT    70
+#define QUIC_MEMORY_PRESSURE_LIMIT_SEND_PERCENT     85
+#define QUIC_MEMORY_PRESSURE_REJECT_PERCENT         95
+#define QUIC_MEMORY_PRESSURE_HYSTERESIS_PERCENT     5
+
 //
 // The minimum number of bytes of send allowance we must have before we will
 // send another packet.
@@ -368,6 +665,13 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_MIN_PACKET_SPARE_SPACE             64
 
+//
+// The minimum buffer space that we require before we will pack a frame from
+// another stream into a QUIC packet that already holds stream frames. Leaves
+// room for the AEAD tag and a small stream frame.
+//
+#define QUIC_MIN_STREAM_PACK_SPARE_SPACE        32
+
 //
 // The maximum number of paths a single connection will keep track of.
 //
@@ -401,6 +705,51 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_SEND_PACING_INTERVAL               1000
 
+//
+// How far ahead (in microseconds) sends may be scheduled when pacing is
+// offloaded to the kernel (SO_TXTIME).
+//
+#define QUIC_SEND_TXTIME_HORIZON_US             (4 * QUIC_SEND_PACING_INTERVAL)
+
+//
+// The default maximum number of packets the pacer releases in a single burst.
+// Zero sizes the burst to match segmentation offload (if supported).
+//
+#define QUIC_DEFAULT_PACING_BURST_PACKETS       0
+
+//
+// The pacer burst size, in packets, used by default with and without send
+// segmentation offload.
+//
+#define QUIC_PACING_GSO_BURST_PACKETS           16
+#define QUIC_PACING_NO_GSO_BURST_PACKETS        4
+
+//
+// The minimum number of microseconds worth of data (at the pacing rate) the
+// pacer releases in a single burst. This bounds the number of pacing wake ups
+// at high rates.
+//
+#define QUIC_PACING_MIN_BURST_INTERVAL_US       250
+
+//
+// The number of microseconds worth of data (at the app's egress rate limit) an
+// egress rate limit lets out in a single burst. Bursts are always at least one
+// full sized datagram.
+//
+#define QUIC_EGRESS_BURST_INTERVAL_US           1000
+
+//
+// When the next pacing deadline is less than this many microseconds away the
+// worker yields instead of waiting on its (millisecond granularity) event.
+//
+#define QUIC_WORKER_PACING_SPIN_US              1000
+
+//
+// The period over which a worker enforces its registration's CPU share. Once
+// the share of a period is used up, the worker sleeps for the rest of it.
+//
+#define QUIC_WORKER_CPU_SHARE_PERIOD_US         10000
+
 //
 // The maximum number of bytes to send in a given key phase
 // before performing a key phase update. Roughly, 274GB.
@@ -433,6 +782,11 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_DEFAULT_LOAD_BALANCING_MODE        QUIC_LOAD_BALANCING_DISABLED
 
+//
+// The default huge page mode used for pool arenas.
+//
+#define QUIC_DEFAULT_HUGE_PAGE_MODE             QUIC_HUGE_PAGE_DISABLED
+
 //
 // The default value for datagrams being enabled or not.
 //
@@ -501,9 +855,17 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_DPLPMTUD_RAISE_TIMER_TIMEOUT           S_TO_US(600)
 
 //
-// The amount of bytes to increase our PLMTU each probe
+// The binary search for the PLPMTU stops once the range between the largest
+// acknowledged probe and the smallest failed one is narrower than this.
 //
-#define QUIC_DPLPMTUD_INCREMENT                     80
+#define QUIC_DPLPMTUD_SEARCH_ACCURACY               16
+
+//
+// The number of consecutive losses of packets larger than the base MTU, with
+// no later such packet acknowledged, that is treated as a black hole. Must fit
+// in QUIC_MTU_DISCOVERY.BlackHoleLossCount (2 bits).
+//
+#define QUIC_DPLPMTUD_BLACK_HOLE_LOSS_THRESHOLD     3
 
 //
 // The default congestion control algorithm
@@ -566,7 +928,95 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_DEFAULT_STREAM_MULTI_RECEIVE_ENABLED    FALSE
 
 //
-// The number of rounds in Cubic Slow Start to sample RTT.
+// The default settings for delivering in-order stream data by reference to the
+// datapath receive buffers, when using multiple parallel receives.
+//
+#define QUIC_DEFAULT_STREAM_ZERO_COPY_RECEIVE_ENABLED FALSE
+
+//
+// Referencing stream data in place keeps the whole datapath receive buffer
+// alive, so only payloads close to a full packet are referenced, and only up
+// to a number of packets and datagram bytes per stream and per connection.
+// Anything past that is copied.
+//
+#define QUIC_MIN_RECV_REFERENCE_LENGTH              1024
+#define QUIC_MAX_STREAM_HELD_RECV_PACKETS           64
+#define QUIC_MAX_STREAM_HELD_RECV_BYTES             (96 * 1024)
+#define QUIC_MAX_CONN_HELD_RECV_PACKETS             256
+#define QUIC_MAX_CONN_HELD_RECV_BYTES               (384 * 1024)
+
+//
+// The default settings for the datacenter (low RTT) profile.
+//
+#define QUIC_DEFAULT_DATACENTER_MODE_ENABLED         FALSE
+
+//
+// The RTT assumed before the first sample in datacenter mode, unless the app
+// set InitialRttMs (in microseconds).
+//
+#define QUIC_DATACENTER_INITIAL_RTT                  1000
+
+//
+// The lower bound of the RTT variance term of the probe timeout in datacenter
+// mode, i.e. kGranularity from RFC 9002 (in microseconds).
+//
+#define QUIC_DATACENTER_TIMER_GRANULARITY            100
+
+//
+// The minimum RTT threshold to exit Cubic Slow Start in datacenter mode (in
+// microseconds).
+//
+#define QUIC_DATACENTER_HYSTART_MIN_ETA              16
+
+//
+// The default settings for forward error correction of datagrams.
+//
+#define QUIC_DEFAULT_FEC_ENABLED                     FALSE
+
+//
+// The default settings for warm starting connections from the path metrics of
+// earlier connections to the same destination.
+//
+#define QUIC_DEFAULT_PATH_METRICS_CACHE_ENABLED      FALSE
+
+//
+// The number of source datagrams covered by each FEC repair symbol. A single
+// loss per block can be recovered without retransmission.
+//
+#define QUIC_FEC_BLOCK_SIZE                          4
+
+//
+// The maximum block size accepted from the peer's transport parameter.
+//
+#define QUIC_FEC_MAX_BLOCK_SIZE                      32
+
+//
+// The largest datagram that is protected by FEC. Larger datagrams are sent
+// unprotected.
+//
+#define QUIC_FEC_MAX_SYMBOL_LENGTH                   1500
+
+//
+// The number of FEC blocks tracked concurrently by the receiver.
+//
+#define QUIC_FEC_RECV_BLOCK_COUNT                    4
+
+//
+// How much a rate limited datagram priority class may send in a single burst,
+// in milliseconds worth of its rate.
+//
+#define QUIC_DATAGRAM_CLASS_BURST_MS                 20
+
+//
+// The bounds of the exponential backoff a managed connection pool applies
+// before replacing a connection that failed to connect, in milliseconds.
+//
+#define QUIC_CONN_POOL_RETRY_DELAY_MIN_MS            100
+#define QUIC_CONN_POOL_RETRY_DELAY_MAX_MS            30000
+
+//
+// The number of RTT samples HyStart++ needs in a round before comparing its
+// minimum RTT to the previous round's.
 //
 #define QUIC_HYSTART_DEFAULT_N_SAMPLING             8
 
@@ -591,6 +1041,12 @@ CXPLAT_STATIC_ASSERT(
 //
 #define QUIC_CONSERVATIVE_SLOW_START_DEFAULT_GROWTH_DIVISOR 4
 
+//
+// The most (in packets) HyStart++ grows the window by per ACK when sends
+// aren't paced, to limit bursts (L in RFC 9406).
+//
+#define QUIC_HYSTART_DEFAULT_BURST_LIMIT            8
+
 /*************************************************************
                   TRANSPORT PARAMETERS
 *************************************************************/
@@ -622,6 +1078,20 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_TP_FLAG_TIMESTAMP_RECV_ENABLED                 0x01000000
 #define QUIC_TP_FLAG_TIMESTAMP_SEND_ENABLED                 0x02000000
 #define QUIC_TP_FLAG_TIMESTAMP_SHIFT                        24
+#define QUIC_TP_FLAG_FEC_ENABLED                            0x04000000
+
+//
+// The transport parameters that differ between connections even when they
+// share the same settings. All the others are derived from the settings.
+//
+#define QUIC_TP_FLAGS_PER_CONNECTION \
+    (QUIC_TP_FLAG_STATELESS_RESET_TOKEN | \
+     QUIC_TP_FLAG_PREFERRED_ADDRESS | \
+     QUIC_TP_FLAG_ORIGINAL_DESTINATION_CONNECTION_ID | \
+     QUIC_TP_FLAG_INITIAL_SOURCE_CONNECTION_ID | \
+     QUIC_TP_FLAG_RETRY_SOURCE_CONNECTION_ID | \
+     QUIC_TP_FLAG_VERSION_NEGOTIATION | \
+     QUIC_TP_FLAG_CIBIR_ENCODING)
 
 #define QUIC_TP_MAX_PACKET_SIZE_DEFAULT                     65527
 #define QUIC_TP_MAX_UDP_PAYLOAD_SIZE_MIN                    1200
@@ -654,6 +1124,7 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_SETTING_RETRY_MEMORY_FRACTION          "RetryMemoryFraction"
 #define QUIC_SETTING_LOAD_BALANCING_MODE            "LoadBalancingMode"
 #define QUIC_SETTING_FIXED_SERVER_ID                "FixedServerID"
+#define QUIC_SETTING_HUGE_PAGE_MODE                 "HugePageMode"
 #define QUIC_SETTING_MAX_WORKER_QUEUE_DELAY         "MaxWorkerQueueDelayMs"
 #define QUIC_SETTING_MAX_STATELESS_OPERATIONS       "MaxStatelessOperations"
 #define QUIC_SETTING_MAX_BINDING_STATELESS_OPERATIONS "MaxBindingStatelessOperations"
@@ -662,6 +1133,7 @@ CXPLAT_STATIC_ASSERT(
 
 #define QUIC_SETTING_SEND_BUFFERING_DEFAULT         "SendBufferingDefault"
 #define QUIC_SETTING_SEND_PACING_DEFAULT            "SendPacingDefault"
+#define QUIC_SETTING_PACING_BURST_PACKETS           "PacingBurstPackets"
 #define QUIC_SETTING_MIGRATION_ENABLED              "MigrationEnabled"
 #define QUIC_SETTING_DATAGRAM_RECEIVE_ENABLED       "DatagramReceiveEnabled"
 #define QUIC_SETTING_GREASE_QUIC_BIT_ENABLED        "GreaseQuicBitEnabled"
@@ -674,6 +1146,10 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_SETTING_ONE_WAY_DELAY_ENABLED          "OneWayDelayEnabled"
 #define QUIC_SETTING_NET_STATS_EVENT_ENABLED        "NetStatsEventEnabled"
 #define QUIC_SETTING_STREAM_MULTI_RECEIVE_ENABLED   "StreamMultiReceiveEnabled"
+#define QUIC_SETTING_DATACENTER_MODE_ENABLED        "DatacenterModeEnabled"
+#define QUIC_SETTING_FEC_ENABLED                    "FecEnabled"
+#define QUIC_SETTING_PATH_METRICS_CACHE_ENABLED     "PathMetricsCacheEnabled"
+#define QUIC_SETTING_STREAM_ZERO_COPY_RECEIVE_ENABLED "StreamZeroCopyReceiveEnabled"
 
 #define QUIC_SETTING_INITIAL_WINDOW_PACKETS         "InitialWindowPackets"
 #define QUIC_SETTING_SEND_IDLE_TIMEOUT_MS           "SendIdleTimeoutMs"
@@ -683,6 +1159,11 @@ CXPLAT_STATIC_ASSERT(
 #define QUIC_SETTING_MAX_ACK_DELAY                  "MaxAckDelayMs"
 #define QUIC_SETTING_DISCONNECT_TIMEOUT             "DisconnectTimeoutMs"
 #define QUIC_SETTING_KEEP_ALIVE_INTERVAL            "KeepAliveIntervalMs"
+#define QUIC_SETTING_IDLE_TIMER_SLACK               "IdleTimerSlackMs"
+#define QUIC_SETTING_KEEP_ALIVE_TIMER_SLACK         "KeepAliveTimerSlackMs"
+#define QUIC_SETTING_SHUTDOWN_TIMER_SLACK           "ShutdownTimerSlackMs"
+#define QUIC_SETTING_ACK_DECIMATION_MAX_PACKETS     "AckDecimationMaxPackets"
+#define QUIC_SETTING_IDLE_HIBERNATE_TIMEOUT         "IdleHibernateTimeoutMs"
 #define QUIC_SETTING_IDLE_TIMEOUT                   "IdleTimeoutMs"
 #define QUIC_SETTING_HANDSHAKE_IDLE_TIMEOUT         "HandshakeIdleTimeoutMs"
 
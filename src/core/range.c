@@ -21,6 +21,7 @@ QuicRangeInitialize(
     )
 {
     Range->UsedLength = 0;
+    Range->HeadLength = 0;
     Range->AllocLength = QUIC_RANGE_INITIAL_SUB_COUNT;
     Range->MaxAllocSize = MaxAllocSize;
     CXPLAT_FRE_ASSERT(sizeof(QUIC_SUBRANGE) * QUIC_RANGE_INITIAL_SUB_COUNT < MaxAllocSize);
@@ -34,7 +35,8 @@ QuicRangeUninitialize(
     )
 {
     if (Range->AllocLength != QUIC_RANGE_INITIAL_SUB_COUNT) {
-        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+        QUIC_SUBRANGE* Base = Range->SubRanges - Range->HeadLength;
+        CXPLAT_FREE(Base, QUIC_POOL_RANGE);
     }
 }
 
@@ -45,6 +47,30 @@ QuicRangeReset(
     )
 {
     Range->UsedLength = 0;
+    Range->SubRanges -= Range->HeadLength;
+    Range->HeadLength = 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeCompact(
+    _Inout_ QUIC_RANGE* Range
+    )
+{
+    if (Range->AllocLength == QUIC_RANGE_INITIAL_SUB_COUNT ||
+        Range->UsedLength > QUIC_RANGE_INITIAL_SUB_COUNT) {
+        return;
+    }
+
+    QUIC_SUBRANGE* OldSubRanges = Range->SubRanges - Range->HeadLength;
+    memcpy(
+        Range->PreAllocSubRanges,
+        Range->SubRanges,
+        Range->UsedLength * sizeof(QUIC_SUBRANGE));
+    CXPLAT_FREE(OldSubRanges, QUIC_POOL_RANGE);
+    Range->SubRanges = Range->PreAllocSubRanges;
+    Range->HeadLength = 0;
+    Range->AllocLength = QUIC_RANGE_INITIAL_SUB_COUNT;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -102,9 +128,11 @@ QuicRangeGrow(
     }
 
     if (Range->AllocLength != QUIC_RANGE_INITIAL_SUB_COUNT) {
-        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+        QUIC_SUBRANGE* Base = Range->SubRanges - Range->HeadLength;
+        CXPLAT_FREE(Base, QUIC_POOL_RANGE);
     }
     Range->SubRanges = NewSubRanges;
+    Range->HeadLength = 0;
     Range->AllocLength = NewAllocLength;
     Range->UsedLength++; // For the next write index.
 
@@ -124,6 +152,25 @@ QuicRangeMakeSpace(
 {
     CXPLAT_DBG_ASSERT(*Index <= Range->UsedLength);
 
+    if (Range->HeadLength != 0 &&
+        (*Index <= Range->UsedLength / 2 ||
+         Range->HeadLength + Range->UsedLength == Range->AllocLength)) {
+        //
+        // Take a slot from the free space at the front, shifting the subranges
+        // before the insertion point down by one.
+        //
+        if (*Index != 0) {
+            memmove(
+                Range->SubRanges - 1,
+                Range->SubRanges,
+                *Index * sizeof(QUIC_SUBRANGE));
+        }
+        Range->SubRanges--;
+        Range->HeadLength--;
+        Range->UsedLength++; // For the new write.
+        return Range->SubRanges + *Index;
+    }
+
     if (Range->UsedLength == Range->AllocLength) {
         if (!QuicRangeGrow(Range, *Index)) {
             //
@@ -178,7 +225,20 @@ QuicRangeRemoveSubranges(
     CXPLAT_DBG_ASSERT(Count > 0);
     CXPLAT_DBG_ASSERT(Index + Count <= Range->UsedLength);
 
-    if (Index + Count < Range->UsedLength) {
+    if (Index < Range->UsedLength - Index - Count) {
+        //
+        // Fewer subranges precede the removed ones than follow them, so shift
+        // those up and leave the freed slots at the front.
+        //
+        if (Index != 0) {
+            memmove(
+                Range->SubRanges + Count,
+                Range->SubRanges,
+                Index * sizeof(QUIC_SUBRANGE));
+        }
+        Range->SubRanges += Count;
+        Range->HeadLength += Count;
+    } else if (Index + Count < Range->UsedLength) {
         memmove(
             Range->SubRanges + Index,
             Range->SubRanges + Index + Count,
@@ -207,8 +267,10 @@ QuicRangeRemoveSubranges(
             NewSubRanges,
             Range->SubRanges,
             Range->UsedLength * sizeof(QUIC_SUBRANGE));
-        CXPLAT_FREE(Range->SubRanges, QUIC_POOL_RANGE);
+        QUIC_SUBRANGE* Base = Range->SubRanges - Range->HeadLength;
+        CXPLAT_FREE(Base, QUIC_POOL_RANGE);
         Range->SubRanges = NewSubRanges;
+        Range->HeadLength = 0;
         Range->AllocLength = NewAllocLength;
         return TRUE;
     }
@@ -263,7 +325,7 @@ QuicRangeAddRange(
         // The new range is somewhere before the end of the of the last subrange
         // so we must search for the first overlapping or adjacent subrange.
         //
-        int result = QuicRangeSearch(Range, &Key);
+        int result = QuicRangeSearchFromEnd(Range, &Key);
         if (IS_FIND_INDEX(result)) {
             //
             // We found 'an' overlapping subrange. We need to ensure this is the
@@ -396,22 +458,27 @@ QuicRangeRemoveRange(
     //
 
     uint32_t i;
-    QUIC_SUBRANGE* Sub = NULL;
+    QUIC_SUBRANGE* Sub;
     QUIC_SUBRANGE* Test;
+    QUIC_RANGE_SEARCH_KEY Key = { Low, Low + Count - 1 };
+
+    if (Count == 0) {
+        return TRUE;
+    }
 
     //
     // Find the leftmost overlapping subrange.
     //
-    for (i = 0; (Test = QuicRangeGetSafe(Range, i)) != NULL; i++) {
-        if (Test->Low < Low + Count &&
-            Test->Low + Test->Count > Low) {
-            Sub = Test;
-            break;
-        }
-    }
-    if (Sub == NULL) {
+    int Result = QuicRangeSearchFromEnd(Range, &Key);
+    if (IS_INSERT_INDEX(Result)) {
         return TRUE;
     }
+    i = (uint32_t)Result;
+    while ((Test = QuicRangeGetSafe(Range, i - 1)) != NULL &&
+            QuicRangeCompare(&Key, Test) == 0) {
+        --i;
+    }
+    Sub = QuicRangeGet(Range, i);
 
     if (Sub->Low + Sub->Count > Low + Count &&
         Sub->Low < Low) {
@@ -421,11 +488,12 @@ QuicRangeRemoveRange(
         // and the second part will be handled by the "left edge
         // overlaps" case.
         //
+        const QUIC_SUBRANGE Original = *Sub; // Sub is invalid if the array grows.
         QUIC_SUBRANGE* NewSub = QuicRangeMakeSpace(Range, &i);
         if (NewSub == NULL) {
             return FALSE;
         }
-        *NewSub = *Sub;
+        *NewSub = Original;
         Sub = NewSub;
     }
 
@@ -45,9 +45,10 @@ QuicRangeGetHigh(
 typedef struct QUIC_RANGE {
 
     //
-    // Array of subranges that represent the set of intervals.
+    // Array of subranges that represent the set of intervals. Points
+    // 'HeadLength' subranges into the allocation.
     //
-    _Field_size_(AllocLength)
+    _Field_size_(AllocLength - HeadLength)
     QUIC_SUBRANGE* SubRanges;
 
     //
@@ -56,7 +57,16 @@ typedef struct QUIC_RANGE {
     uint32_t UsedLength;
 
     //
-    // The number of allocated subranges in the 'SubRanges' array.
+    // The number of free subranges in the allocation before 'SubRanges'.
+    // Removing or inserting subranges near the front shifts the front of the
+    // array into/out of this space, so only the smaller side of the array is
+    // ever moved. This keeps heavily fragmented ranges (e.g. receive buffers
+    // under heavy reordering, where gaps fill from the front) cheap to update.
+    //
+    uint32_t HeadLength;
+
+    //
+    // The number of allocated subranges in the 'SubRanges' allocation.
     //
     _Field_range_(1, QUIC_MAX_RANGE_ALLOC_SIZE)
     uint32_t AllocLength;
@@ -199,6 +209,52 @@ QuicRangeSearch(
             FIND_INDEX_TO_INSERT_INDEX(Mid);
 }
 
+//
+// O(log(d)), where d is the distance of the match from the end.
+// Same contract as QuicRangeSearch, but gallops backwards from the last
+// subrange to bound the window before binary searching it. Newly received
+// packet numbers (and newly acknowledged offsets) almost always land near the
+// end, so this usually only touches the last few subranges even when the
+// range is heavily fragmented.
+//
+QUIC_INLINE
+int
+QuicRangeSearchFromEnd(
+    _In_ const QUIC_RANGE* Range,
+    _In_ const QUIC_RANGE_SEARCH_KEY* Key
+    )
+{
+    uint32_t Lo = 0;
+    uint32_t Hi = Range->UsedLength;
+    uint32_t Step = 1;
+    int Result;
+
+    while (Hi > Lo) {
+        uint32_t Probe = Hi > Lo + Step ? Hi - Step : Lo;
+        if ((Result = QuicRangeCompare(Key, QuicRangeGet(Range, Probe))) == 0) {
+            return (int)Probe;
+        } else if (Result > 0) {
+            Lo = Probe + 1;
+            break;
+        }
+        Hi = Probe;
+        Step *= 2;
+    }
+
+    while (Lo < Hi) {
+        uint32_t Mid = Lo + (Hi - Lo) / 2;
+        if ((Result = QuicRangeCompare(Key, QuicRangeGet(Range, Mid))) == 0) {
+            return (int)Mid;
+        } else if (Result < 0) {
+            Hi = Mid;
+        } else {
+            Lo = Mid + 1;
+        }
+    }
+
+    return FIND_INDEX_TO_INSERT_INDEX(Lo);
+}
+
 #else
 
 //
@@ -226,6 +282,8 @@ QuicRangeSearch(
     return FIND_INDEX_TO_INSERT_INDEX(i);
 }
 
+#define QuicRangeSearchFromEnd QuicRangeSearch
+
 #endif
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -250,6 +308,16 @@ QuicRangeReset(
     _Inout_ QUIC_RANGE* Range
     );
 
+//
+// Moves the subranges back into the preallocated array, if they fit, and frees
+// the larger allocation. Used to trim long-lived but quiet ranges.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicRangeCompact(
+    _Inout_ QUIC_RANGE* Range
+    );
+
 //
 // O(n)      when QUIC_RANGE_USE_BINARY_SEARCH == 0
 // O(log(n)) when QUIC_RANGE_USE_BINARY_SEARCH == 1
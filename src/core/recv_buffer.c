@@ -172,6 +172,9 @@ QuicRecvChunkInitialize(
     Chunk->Buffer = Buffer;
     Chunk->ExternalReference = FALSE;
     Chunk->AllocatedFromPool = AllocatedFromPool;
+    Chunk->DatapathOwned = FALSE;
+    Chunk->Internal = FALSE;
+    Chunk->Packet = NULL;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -180,6 +183,25 @@ QuicRecvChunkFree(
     _In_ QUIC_RECV_CHUNK* Chunk
     )
 {
+    if (Chunk->DatapathOwned) {
+        //
+        // Release the packet the chunk references. If the connection is still
+        // processing it, the connection returns it to the datapath when done.
+        //
+        QUIC_RX_PACKET* Packet = Chunk->Packet;
+        Packet->HeldByStream = FALSE;
+        if (Packet->ReleasedByConnection) {
+            CXPLAT_DBG_ASSERT(Packet->Next == NULL);
+            CxPlatRecvDataReturn((CXPLAT_RECV_DATA*)Packet);
+        }
+    }
+
+    if (Chunk->Internal) {
+        InterlockedExchangeAdd64(
+            (int64_t*)&MsQuicLib.CurrentRecvBufferMemoryUsage,
+            -1 * (int64_t)Chunk->AllocLength);
+    }
+
     //
     // The data buffer of the chunk is allocated in the same allocation
     // as the chunk itself if and only if it is owned by the receive buffer:
@@ -192,6 +214,51 @@ QuicRecvChunkFree(
     }
 }
 
+//
+// Allocates a chunk with a buffer of BufferLength bytes in the same
+// allocation, from the receive buffer's size-classed pools when possible.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+static
+QUIC_RECV_CHUNK*
+QuicRecvChunkAlloc(
+    _In_ const QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t BufferLength
+    )
+{
+    CXPLAT_DBG_ASSERT((BufferLength & (BufferLength - 1)) == 0); // Power of 2
+
+    QUIC_RECV_CHUNK* Chunk;
+    if (RecvBuffer->ChunkPools != NULL &&
+        BufferLength >= (1UL << QUIC_RECV_CHUNK_POOL_MIN_SHIFT) &&
+        BufferLength <= QUIC_RECV_CHUNK_POOL_MAX_SIZE) {
+        uint32_t Index = 0;
+        while ((1UL << (QUIC_RECV_CHUNK_POOL_MIN_SHIFT + Index)) < BufferLength) {
+            Index++;
+        }
+#ifndef _KERNEL_MODE
+        Chunk = CxPlatPoolExAlloc(&RecvBuffer->ChunkPools[Index].Pool);
+#else
+        Chunk = CxPlatPoolAlloc(&RecvBuffer->ChunkPools[Index].Pool.Base);
+#endif
+        if (Chunk != NULL) {
+            QuicRecvChunkInitialize(Chunk, BufferLength, (uint8_t*)(Chunk + 1), TRUE);
+        }
+    } else {
+        Chunk = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + BufferLength, QUIC_POOL_RECVBUF);
+        if (Chunk != NULL) {
+            QuicRecvChunkInitialize(Chunk, BufferLength, (uint8_t*)(Chunk + 1), FALSE);
+        }
+    }
+    if (Chunk != NULL) {
+        Chunk->Internal = TRUE;
+        InterlockedExchangeAdd64(
+            (int64_t*)&MsQuicLib.CurrentRecvBufferMemoryUsage,
+            (int64_t)BufferLength);
+    }
+    return Chunk;
+}
+
 #if DEBUG
 //
 // Validate the receive buffer invariants.
@@ -266,7 +333,8 @@ QuicRecvBufferInitialize(
     _In_ uint32_t AllocBufferLength,
     _In_ uint32_t VirtualBufferLength,
     _In_ QUIC_RECV_BUF_MODE RecvMode,
-    _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk
+    _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk,
+    _In_opt_ QUIC_RECV_CHUNK_POOL* ChunkPools
     )
 {
     CXPLAT_DBG_ASSERT(AllocBufferLength != 0 || RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
@@ -277,12 +345,16 @@ QuicRecvBufferInitialize(
     CXPLAT_DBG_ASSERT(AllocBufferLength <= VirtualBufferLength);
 
     RecvBuffer->BaseOffset = 0;
+    RecvBuffer->DirectWriteOffset = 0;
     RecvBuffer->ReadStart = 0;
     RecvBuffer->ReadPendingLength = 0;
     RecvBuffer->ReadLength = 0;
     RecvBuffer->RecvMode = RecvMode;
     RecvBuffer->RetiredChunk = NULL;
+    RecvBuffer->DatapathChunkCount = 0;
+    RecvBuffer->DatapathChunkBytes = 0;
     RecvBuffer->VirtualBufferLength = VirtualBufferLength;
+    RecvBuffer->ChunkPools = ChunkPools;
     QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &RecvBuffer->WrittenRanges);
     CxPlatListInitializeHead(&RecvBuffer->Chunks);
 
@@ -294,11 +366,10 @@ QuicRecvBufferInitialize(
         if (PreallocatedChunk != NULL) {
             Chunk = PreallocatedChunk;
         } else {
-            Chunk = CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + AllocBufferLength, QUIC_POOL_RECVBUF);
+            Chunk = QuicRecvChunkAlloc(RecvBuffer, AllocBufferLength);
             if (Chunk == NULL) {
                 return QUIC_STATUS_OUT_OF_MEMORY;
             }
-            QuicRecvChunkInitialize(Chunk, AllocBufferLength, (uint8_t*)(Chunk + 1), FALSE);
         }
         CxPlatListInsertHead(&RecvBuffer->Chunks, &Chunk->Link);
         RecvBuffer->Capacity = AllocBufferLength;
@@ -360,18 +431,29 @@ QuicRecvBufferGetSpan(
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
-BOOLEAN
-QuicRecvBufferHasUnreadData(
+uint64_t
+QuicRecvBufferGetUnreadLength(
     _In_ QUIC_RECV_BUFFER* RecvBuffer
     )
 {
     const QUIC_SUBRANGE* FirstRange = QuicRangeGetSafe(&RecvBuffer->WrittenRanges, 0);
     if (FirstRange == NULL || FirstRange->Low != 0) {
-        return FALSE;
+        return 0;
     }
     CXPLAT_DBG_ASSERT(FirstRange->Count >= RecvBuffer->BaseOffset);
     const uint64_t ContiguousLength = FirstRange->Count - RecvBuffer->BaseOffset;
-    return ContiguousLength > RecvBuffer->ReadPendingLength;
+    return
+        ContiguousLength > RecvBuffer->ReadPendingLength ?
+            ContiguousLength - RecvBuffer->ReadPendingLength : 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferHasUnreadData(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer
+    )
+{
+    return QuicRecvBufferGetUnreadLength(RecvBuffer) != 0;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -480,13 +562,11 @@ QuicRecvBufferResize(
     CXPLAT_DBG_ASSERT(TargetBufferLength > LastChunk->AllocLength); // Should only be called when buffer needs to grow
     BOOLEAN LastChunkIsFirst = LastChunk->Link.Blink == &RecvBuffer->Chunks;
 
-    QUIC_RECV_CHUNK* NewChunk =
-        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_RECV_CHUNK) + TargetBufferLength, QUIC_POOL_RECVBUF);
+    QUIC_RECV_CHUNK* NewChunk = QuicRecvChunkAlloc(RecvBuffer, TargetBufferLength);
     if (NewChunk == NULL) {
         return FALSE;
     }
 
-    QuicRecvChunkInitialize(NewChunk, TargetBufferLength, (uint8_t*)(NewChunk + 1), FALSE);
     CxPlatListInsertTail(&RecvBuffer->Chunks, &NewChunk->Link);
 
     if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE && LastChunk->ExternalReference) {
@@ -556,6 +636,37 @@ QuicRecvBufferResize(
     return TRUE;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicRecvBufferReserve(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t ReserveLength
+    )
+{
+    CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED);
+
+    if (ReserveLength <= QuicRecvBufferGetTotalAllocLength(RecvBuffer)) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    //
+    // Grow straight to the final size, rather than doubling (and copying) on
+    // each write that doesn't fit.
+    //
+    QUIC_RECV_CHUNK* LastChunk =
+        CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Blink, QUIC_RECV_CHUNK, Link);
+    uint32_t NewBufferLength = LastChunk->AllocLength << 1;
+    while (ReserveLength > NewBufferLength) {
+        NewBufferLength <<= 1;
+    }
+    if (!QuicRecvBufferResize(RecvBuffer, NewBufferLength)) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    QuicRecvBufferValidate(RecvBuffer);
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRecvBufferCopyIntoChunks(
@@ -594,7 +705,9 @@ QuicRecvBufferCopyIntoChunks(
     QUIC_BUFFER Buffer;
     while (WriteLength != 0 && QuicRecvChunkIteratorNext(&Iterator, FALSE, &Buffer)) {
         const uint32_t CopyLength = CXPLAT_MIN(Buffer.Length, WriteLength);
-        CxPlatCopyMemory(Buffer.Buffer, WriteBuffer, CopyLength);
+        if (Buffer.Buffer != WriteBuffer) { // Already in place for direct writes.
+            CxPlatCopyMemory(Buffer.Buffer, WriteBuffer, CopyLength);
+        }
         WriteBuffer += CopyLength;
         WriteLength -= (uint16_t)CopyLength;
     }
@@ -733,6 +846,188 @@ QuicRecvBufferWrite(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferWriteReference(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint16_t WriteLength,
+    _In_reads_bytes_(WriteLength) uint8_t const* WriteBuffer,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_ CXPLAT_POOL* ChunkPool,
+    _In_ uint64_t WriteQuota,
+    _Out_ uint64_t* QuotaConsumed,
+    _Out_ BOOLEAN* NewDataReady
+    )
+{
+    CXPLAT_DBG_ASSERT(WriteLength != 0);
+    *NewDataReady = FALSE;
+    *QuotaConsumed = 0;
+
+    if (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE ||
+        Packet->HeldByStream) {
+        //
+        // A packet is only ever referenced by a single chunk.
+        //
+        return FALSE;
+    }
+
+    //
+    // Holding a packet pins its whole receive buffer, which is only worth it
+    // for payloads close to a full packet, and only up to a limit.
+    //
+    if (WriteLength < QUIC_MIN_RECV_REFERENCE_LENGTH ||
+        RecvBuffer->DatapathChunkCount >= QUIC_MAX_STREAM_HELD_RECV_PACKETS ||
+        RecvBuffer->DatapathChunkBytes + Packet->BufferLength > QUIC_MAX_STREAM_HELD_RECV_BYTES) {
+        return FALSE;
+    }
+
+    //
+    // Only data directly following all the data received so far can be
+    // referenced: anything out of order or duplicate is copied.
+    //
+    const QUIC_SUBRANGE* FirstRange = QuicRangeGetSafe(&RecvBuffer->WrittenRanges, 0);
+    if (FirstRange != NULL &&
+        (FirstRange->Low != 0 || QuicRangeSize(&RecvBuffer->WrittenRanges) != 1)) {
+        return FALSE;
+    }
+    const uint64_t CurrentMaxLength = QuicRecvBufferGetTotalLength(RecvBuffer);
+    if (WriteOffset != CurrentMaxLength) {
+        return FALSE;
+    }
+
+    //
+    // Leave flow control violations to QuicRecvBufferWrite to report.
+    //
+    if (WriteOffset + WriteLength > RecvBuffer->BaseOffset + RecvBuffer->VirtualBufferLength ||
+        WriteLength > WriteQuota) {
+        return FALSE;
+    }
+
+    //
+    // The new chunk is inserted right before the last chunk, which always
+    // stays an internally allocated chunk so that it can keep being resized
+    // and recycled. That only preserves the layout of the buffer if the last
+    // chunk holds no data yet.
+    //
+    QUIC_RECV_CHUNK* LastChunk =
+        CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Blink, QUIC_RECV_CHUNK, Link);
+    uint64_t LastChunkOffset = 0;
+    if (LastChunk->Link.Blink != &RecvBuffer->Chunks) {
+        LastChunkOffset =
+            QuicRecvBufferGetTotalAllocLength(RecvBuffer) - LastChunk->AllocLength;
+    }
+    if (WriteOffset - RecvBuffer->BaseOffset != LastChunkOffset) {
+        return FALSE;
+    }
+
+    QUIC_RECV_CHUNK* Chunk = CxPlatPoolAlloc(ChunkPool);
+    if (Chunk == NULL) {
+        return FALSE;
+    }
+    QuicRecvChunkInitialize(Chunk, WriteLength, (uint8_t*)WriteBuffer, TRUE);
+    Chunk->DatapathOwned = TRUE;
+    Chunk->Packet = Packet;
+
+    BOOLEAN WrittenRangesUpdated;
+    QUIC_SUBRANGE* UpdatedRange =
+        QuicRangeAddRange(
+            &RecvBuffer->WrittenRanges,
+            WriteOffset,
+            WriteLength,
+            &WrittenRangesUpdated);
+    if (!UpdatedRange) {
+        CxPlatPoolFree(Chunk);
+        return FALSE;
+    }
+    CXPLAT_DBG_ASSERT(WrittenRangesUpdated && UpdatedRange->Low == 0);
+
+    CxPlatListInsertTail(&LastChunk->Link, &Chunk->Link);
+    if (Chunk->Link.Blink == &RecvBuffer->Chunks) {
+        //
+        // The last chunk was empty and alone; the new chunk becomes the first.
+        //
+        RecvBuffer->ReadStart = 0;
+        RecvBuffer->Capacity = WriteLength;
+    }
+    RecvBuffer->DatapathChunkCount++;
+    RecvBuffer->DatapathChunkBytes += Packet->BufferLength;
+    Packet->HeldByStream = TRUE;
+
+    RecvBuffer->ReadLength = (uint32_t)CXPLAT_MIN(
+        RecvBuffer->Capacity,
+        UpdatedRange->Count - RecvBuffer->BaseOffset);
+
+    *QuotaConsumed = WriteLength;
+    *NewDataReady = TRUE;
+
+    QuicRecvBufferValidate(RecvBuffer);
+    return TRUE;
+}
+
+//
+// Returns a pointer to the buffer space for the stream offsets
+// [WriteOffset, WriteOffset + WriteLength), or NULL if that space isn't
+// allocated or not contiguous.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t*
+QuicRecvBufferGetContiguousSpace(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint32_t WriteLength
+    )
+{
+    CXPLAT_DBG_ASSERT(WriteOffset >= RecvBuffer->BaseOffset);
+    const uint64_t RelativeOffset = WriteOffset - RecvBuffer->BaseOffset;
+    if (RelativeOffset + WriteLength > QuicRecvBufferGetTotalAllocLength(RecvBuffer)) {
+        return NULL;
+    }
+
+    QUIC_RECV_CHUNK_ITERATOR Iterator = QuicRecvBufferGetChunkIterator(RecvBuffer, RelativeOffset);
+    QUIC_BUFFER Buffer;
+    if (!QuicRecvChunkIteratorNext(&Iterator, FALSE, &Buffer) || Buffer.Length < WriteLength) {
+        return NULL;
+    }
+    return Buffer.Buffer;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t*
+QuicRecvBufferReserveDirectWrite(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint32_t WriteLength
+    )
+{
+    CXPLAT_DBG_ASSERT(WriteLength != 0);
+
+    if (RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED ||
+        WriteOffset < QuicRecvBufferGetTotalLength(RecvBuffer) ||
+        WriteOffset < RecvBuffer->DirectWriteOffset) {
+        return NULL;
+    }
+
+    uint8_t* Buffer = QuicRecvBufferGetContiguousSpace(RecvBuffer, WriteOffset, WriteLength);
+    if (Buffer != NULL) {
+        RecvBuffer->DirectWriteOffset = WriteOffset + WriteLength;
+    }
+    return Buffer;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t*
+QuicRecvBufferGetDirectWrite(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint32_t WriteLength
+    )
+{
+    CXPLAT_DBG_ASSERT(RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED);
+    CXPLAT_DBG_ASSERT(WriteOffset + WriteLength <= RecvBuffer->DirectWriteOffset);
+    return QuicRecvBufferGetContiguousSpace(RecvBuffer, WriteOffset, WriteLength);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 uint32_t
 QuicRecvBufferReadBufferNeededCount(
@@ -756,9 +1051,10 @@ QuicRecvBufferReadBufferNeededCount(
     if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE) {
         //
         // Multiple mode need up to three buffers to deal with wrap around and a
-        // potential second chunk for overflow data.
+        // potential second chunk for overflow data, plus one for each
+        // datapath-owned chunk.
         //
-        return 3;
+        return 3 + RecvBuffer->DatapathChunkCount;
     }
 
     //
@@ -850,13 +1146,16 @@ QuicRecvBufferRead(
     // Check that the invariants on the number of receive buffer are respected.
     //
     CXPLAT_DBG_ASSERT(
-        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED || ReadableDataLeft == 0);
+        RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvBuffer->DatapathChunkCount != 0 ||
+        ReadableDataLeft == 0);
     CXPLAT_DBG_ASSERT(
         RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_SINGLE || *BufferCount <= 1);
     CXPLAT_DBG_ASSERT(
         RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_CIRCULAR || *BufferCount <= 2);
     CXPLAT_DBG_ASSERT(
-        RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE || *BufferCount <= 3);
+        RecvBuffer->RecvMode != QUIC_RECV_BUF_MODE_MULTIPLE ||
+        *BufferCount <= 3 + RecvBuffer->DatapathChunkCount);
 
     QuicRecvBufferValidate(RecvBuffer);
 }
@@ -910,6 +1209,10 @@ QuicRecvBufferDrainFullChunks(
         QUIC_RECV_CHUNK* Chunk = CXPLAT_CONTAINING_RECORD(ChunkIt, QUIC_RECV_CHUNK, Link);
         ChunkIt = ChunkIt->Flink;
 
+        if (Chunk->DatapathOwned) {
+            RecvBuffer->DatapathChunkCount--;
+            RecvBuffer->DatapathChunkBytes -= Chunk->Packet->BufferLength;
+        }
         CxPlatListEntryRemove(&Chunk->Link);
         QuicRecvChunkFree(Chunk);
     }
@@ -1042,6 +1345,52 @@ QuicRecvBufferDrain(
     return RecvBuffer->ReadLength == 0;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferShrink(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t TargetBufferLength
+    )
+{
+    CXPLAT_DBG_ASSERT((TargetBufferLength & (TargetBufferLength - 1)) == 0); // Power of 2
+
+    if (RecvBuffer->RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED ||
+        RecvBuffer->ReadPendingLength != 0 ||
+        RecvBuffer->RetiredChunk != NULL ||
+        RecvBuffer->DatapathChunkCount != 0 ||
+        QuicRecvBufferGetSpan(RecvBuffer) != 0) {
+        return FALSE; // Still (or about to be) in use.
+    }
+
+    CXPLAT_DBG_ASSERT(!CxPlatListIsEmpty(&RecvBuffer->Chunks));
+    QUIC_RECV_CHUNK* Chunk =
+        CXPLAT_CONTAINING_RECORD(RecvBuffer->Chunks.Flink, QUIC_RECV_CHUNK, Link);
+    if (Chunk->Link.Flink != &RecvBuffer->Chunks ||
+        Chunk->ExternalReference ||
+        Chunk->AllocLength <= TargetBufferLength) {
+        return FALSE;
+    }
+
+    QUIC_RECV_CHUNK* NewChunk = QuicRecvChunkAlloc(RecvBuffer, TargetBufferLength);
+    if (NewChunk == NULL) {
+        return FALSE;
+    }
+
+    //
+    // Nothing is buffered, so there is no data to carry over.
+    //
+    CxPlatListEntryRemove(&Chunk->Link);
+    QuicRecvChunkFree(Chunk);
+    CxPlatListInsertHead(&RecvBuffer->Chunks, &NewChunk->Link);
+    RecvBuffer->ReadStart = 0;
+    RecvBuffer->ReadLength = 0;
+    RecvBuffer->Capacity = TargetBufferLength;
+    QuicRangeCompact(&RecvBuffer->WrittenRanges);
+
+    QuicRecvBufferValidate(RecvBuffer);
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicRecvBufferResetRead(
@@ -25,9 +25,13 @@ typedef struct QUIC_RECV_CHUNK {
     uint32_t AllocLength;            // Allocation size of Buffer
     uint8_t ExternalReference  : 1;  // Indicates the buffer is being used externally.
     uint8_t AllocatedFromPool  : 1;  // Indicates the buffer is was allocated from a pool.
+    uint8_t DatapathOwned      : 1;  // Indicates the buffer is a received packet's payload.
+    uint8_t Internal           : 1;  // Indicates the buffer was allocated by the receive buffer.
     uint8_t* Buffer;                 // Pointer to the buffer itself. Doesn't need to be freed independently:
                                      //  - for internally allocated buffers, points in the same allocation.
                                      //  - for app-owned buffers, the buffer isn't owned
+                                     //  - for datapath-owned buffers, points in Packet's payload.
+    QUIC_RX_PACKET* Packet;          // The received packet held by a datapath-owned chunk.
 } QUIC_RECV_CHUNK;
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -69,6 +73,12 @@ typedef struct QUIC_RECV_BUFFER {
     //
     uint64_t BaseOffset;
 
+    //
+    // The end of the stream offsets handed out by
+    // QuicRecvBufferReserveDirectWrite so far.
+    //
+    uint64_t DirectWriteOffset;
+
     //
     // Position of the reading head in the first chunk.
     //
@@ -94,12 +104,25 @@ typedef struct QUIC_RECV_BUFFER {
     //
     uint32_t Capacity;
 
+    //
+    // The number of datapath-owned chunks in the list, and the length of the
+    // received datagrams they hold.
+    //
+    uint32_t DatapathChunkCount;
+    uint32_t DatapathChunkBytes;
+
     //
     // Controls the behavior of the buffer, which changes the logic for
     // writing, reading and draining.
     //
     QUIC_RECV_BUF_MODE RecvMode;
 
+    //
+    // Optional size-classed pools (QUIC_RECV_CHUNK_POOL_COUNT of them) to
+    // allocate chunks from.
+    //
+    QUIC_RECV_CHUNK_POOL* ChunkPools;
+
 } QUIC_RECV_BUFFER;
 
 //
@@ -107,6 +130,7 @@ typedef struct QUIC_RECV_BUFFER {
 // Can only fail if PreallocatedChunk == NULL && RecvMode != QUIC_RECV_BUF_MODE_APP_OWNED.
 // PreallocatedChunk ownership is given to the receive buffer.
 // PreallocatedChunk must be null if RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED.
+// If ChunkPools is provided, chunks in its size range are allocated from it.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
@@ -115,7 +139,8 @@ QuicRecvBufferInitialize(
     _In_ uint32_t AllocBufferLength,
     _In_ uint32_t VirtualBufferLength,
     _In_ QUIC_RECV_BUF_MODE RecvMode,
-    _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk
+    _In_opt_ QUIC_RECV_CHUNK* PreallocatedChunk,
+    _In_opt_ QUIC_RECV_CHUNK_POOL* ChunkPools
     );
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -135,6 +160,15 @@ QuicRecvBufferGetTotalLength(
     _In_ QUIC_RECV_BUFFER* RecvBuffer
     );
 
+//
+// Returns the length of the contiguous data that is ready to be read.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicRecvBufferGetUnreadLength(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer
+    );
+
 //
 // Returns TRUE there is any unread data in the receive buffer.
 //
@@ -165,6 +199,18 @@ QuicRecvBufferProvideChunks(
     _Inout_ CXPLAT_LIST_ENTRY* /* QUIC_RECV_CHUNKS */ Chunks
     );
 
+//
+// Grows the buffer so that at least ReserveLength bytes, starting at
+// BaseOffset, can be written without any further reallocation.
+// Not valid for QUIC_RECV_BUF_MODE_APP_OWNED mode.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+QuicRecvBufferReserve(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t ReserveLength
+    );
+
 //
 // Buffers a (possibly out-of-order or duplicate) range of bytes.
 //
@@ -185,6 +231,60 @@ QuicRecvBufferWrite(
     _Out_ uint64_t* BufferSizeNeeded
     );
 
+//
+// Buffers an in-order range of bytes by referencing it in place in the
+// received packet, instead of copying it. Only valid in
+// QUIC_RECV_BUF_MODE_MULTIPLE mode, and only when nothing has been received
+// out of order. Returns FALSE, without changing the buffer, if the write
+// can't be done by reference and should go through QuicRecvBufferWrite.
+//
+// On success, the packet is held until all the referenced bytes are drained.
+// The chunk describing the reference is allocated from ChunkPool. Short writes
+// and writes past the stream's limits on held packets are not referenced.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferWriteReference(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint16_t WriteLength,
+    _In_reads_bytes_(WriteLength) uint8_t const* WriteBuffer,
+    _In_ QUIC_RX_PACKET* Packet,
+    _In_ CXPLAT_POOL* ChunkPool,
+    _In_ uint64_t WriteQuota,
+    _Out_ uint64_t* QuotaConsumed,
+    _Out_ BOOLEAN* NewDataReady
+    );
+
+//
+// Returns a pointer to the buffer space for the stream offsets
+// [WriteOffset, WriteOffset + WriteLength), so the caller can produce the data
+// there directly before passing that pointer to QuicRecvBufferWrite. Only valid
+// in QUIC_RECV_BUF_MODE_APP_OWNED mode, where buffer space never moves.
+//
+// Returns NULL if the range isn't contiguous in a single chunk, or overlaps
+// data already written or space already reserved.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t*
+QuicRecvBufferReserveDirectWrite(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint32_t WriteLength
+    );
+
+//
+// Returns the pointer previously returned by QuicRecvBufferReserveDirectWrite
+// for a range starting at WriteOffset, which must not be before BaseOffset.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint8_t*
+QuicRecvBufferGetDirectWrite(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint64_t WriteOffset,
+    _In_ uint32_t WriteLength
+    );
+
 //
 // Returns how many QUIC_BUFFERs should be passed to `QuicRecvBufferRead` to
 // read all the available data in the buffer.
@@ -228,6 +328,18 @@ QuicRecvBufferDrain(
     _In_ uint64_t DrainLength
     );
 
+//
+// Replaces the buffer's only chunk with a smaller one of TargetBufferLength
+// bytes, if everything received so far has been read and drained. The buffer
+// grows again as needed on later writes. Returns TRUE if the buffer shrank.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+QuicRecvBufferShrink(
+    _In_ QUIC_RECV_BUFFER* RecvBuffer,
+    _In_ uint32_t TargetBufferLength
+    );
+
 //
 // Indicates the caller is abandoning any pending read.
 //   N.B. Currently only supported for QUIC_RECV_BUF_MODE_SINGLE mode.
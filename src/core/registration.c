@@ -380,6 +380,11 @@ _IRQL_requires_max_(DISPATCH_LEVEL) BOOLEAN
                              ? 0
                              : QuicPartitionIdGetIndex(Connection->PartitionID);
 
+  if (Registration->Draining ||
+      !QuicRegistrationHasConnectionQuota(Registration)) {
+    return FALSE;
+  }
+
   //
   // TODO - Look for other worker instead if the proposed worker is overloaded?
   //
@@ -401,25 +406,238 @@ _IRQL_requires_max_(DISPATCH_LEVEL) void QuicRegistrationQueueNewConnection(
                              Connection);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL) uint32_t
+    QuicRegistrationGetEgressAllowance(_In_ QUIC_REGISTRATION *Registration,
+                                       _In_ uint64_t TimeNow) {
+  const uint64_t Rate = Registration->EgressRateLimit;
+  if (Rate == 0) {
+    return UINT32_MAX;
+  }
+
+  //
+  // Only the caller that wins the race to move the refill time forward adds
+  // the tokens for the elapsed time, so none are added twice.
+  //
+  const uint64_t RefillTime = Registration->EgressRefillTime;
+  if (RefillTime != TimeNow && CxPlatTimeAtOrBefore64(RefillTime, TimeNow) &&
+      (uint64_t)InterlockedCompareExchange64(
+          (int64_t *)&Registration->EgressRefillTime, (int64_t)TimeNow,
+          (int64_t)RefillTime) == RefillTime) {
+    const int64_t Refill = QuicSendGetEgressRefill(
+        Rate, Registration->EgressTokens,
+        CxPlatTimeDiff64(RefillTime, TimeNow));
+    if (Refill != 0) {
+      InterlockedExchangeAdd64(&Registration->EgressTokens, Refill);
+    }
+  }
+
+  const int64_t Tokens = Registration->EgressTokens;
+  return Tokens <= 0 ? 0 : (uint32_t)CXPLAT_MIN(Tokens, UINT32_MAX);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL) QUIC_STATUS
     QuicRegistrationParamSet(_In_ QUIC_REGISTRATION *Registration,
                              _In_ uint32_t Param, _In_ uint32_t BufferLength,
                              _In_reads_bytes_(BufferLength)
                                  const void *Buffer) {
-  UNREFERENCED_PARAMETER(Registration);
-  UNREFERENCED_PARAMETER(Param);
-  UNREFERENCED_PARAMETER(BufferLength);
-  UNREFERENCED_PARAMETER(Buffer);
-  return QUIC_STATUS_INVALID_PARAMETER;
+  QUIC_STATUS Status;
+
+  switch (Param) {
+  case QUIC_PARAM_REGISTRATION_CONGESTION_CONTROL: {
+
+    if (BufferLength != sizeof(QUIC_CONGESTION_CONTROL_CALLBACKS) ||
+        Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    const QUIC_CONGESTION_CONTROL_CALLBACKS *Callbacks =
+        (const QUIC_CONGESTION_CONTROL_CALLBACKS *)Buffer;
+    if (Callbacks->Create == NULL || Callbacks->GetCongestionWindow == NULL ||
+        Callbacks->OnDataAcknowledged == NULL ||
+        Callbacks->OnDataLost == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    //
+    // Connections hold on to the registration's copy of the callbacks, so it
+    // can only be set once, before there are any connections.
+    //
+    CxPlatDispatchLockAcquire(&Registration->ConnectionLock);
+    if (Registration->CongestionControl.Create != NULL ||
+        !CxPlatListIsEmpty(&Registration->Connections)) {
+      Status = QUIC_STATUS_INVALID_STATE;
+    } else {
+      Registration->CongestionControl = *Callbacks;
+      Status = QUIC_STATUS_SUCCESS;
+    }
+    CxPlatDispatchLockRelease(&Registration->ConnectionLock);
+    break;
+  }
+
+  case QUIC_PARAM_REGISTRATION_QUOTA: {
+
+    if (BufferLength != sizeof(QUIC_REGISTRATION_QUOTA) || Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    const QUIC_REGISTRATION_QUOTA *Quota =
+        (const QUIC_REGISTRATION_QUOTA *)Buffer;
+    if (Quota->WorkerCpuSharePercent > 100) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    //
+    // New limits only apply going forward; existing connections and buffered
+    // bytes over a lowered limit are not reclaimed.
+    //
+    Registration->Quota = *Quota;
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+  }
+
+  case QUIC_PARAM_REGISTRATION_DRAIN: {
+
+    if (BufferLength != sizeof(BOOLEAN) || Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    //
+    // Clearing the flag only stops refusing new connections; connections that
+    // were already told to drain still close once idle.
+    //
+    CxPlatDispatchLockAcquire(&Registration->ConnectionLock);
+    const BOOLEAN WasDraining = Registration->Draining;
+    Registration->Draining = *(const BOOLEAN *)Buffer;
+    if (Registration->Draining && !WasDraining) {
+      for (CXPLAT_LIST_ENTRY *Entry = Registration->Connections.Flink;
+           Entry != &Registration->Connections; Entry = Entry->Flink) {
+        QuicConnQueueDrain(CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION,
+                                                    RegistrationLink));
+      }
+    }
+    CxPlatDispatchLockRelease(&Registration->ConnectionLock);
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+  }
+
+  case QUIC_PARAM_REGISTRATION_EGRESS_RATE_LIMIT:
+
+    if (BufferLength != sizeof(uint64_t) || Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    //
+    // Resetting the refill time starts the bucket out full at the new rate.
+    //
+    Registration->EgressRateLimit = *(const uint64_t *)Buffer;
+    InterlockedExchange64((int64_t *)&Registration->EgressRefillTime, 0);
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+
+  default:
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    break;
+  }
+
+  return Status;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL) QUIC_STATUS QuicRegistrationParamGet(
     _In_ QUIC_REGISTRATION *Registration, _In_ uint32_t Param,
     _Inout_ uint32_t *BufferLength,
     _Out_writes_bytes_opt_(*BufferLength) void *Buffer) {
-  UNREFERENCED_PARAMETER(Registration);
-  UNREFERENCED_PARAMETER(Param);
-  UNREFERENCED_PARAMETER(BufferLength);
-  UNREFERENCED_PARAMETER(Buffer);
-  return QUIC_STATUS_INVALID_PARAMETER;
+  QUIC_STATUS Status;
+
+  switch (Param) {
+  case QUIC_PARAM_REGISTRATION_QUOTA:
+
+    if (*BufferLength < sizeof(QUIC_REGISTRATION_QUOTA)) {
+      *BufferLength = sizeof(QUIC_REGISTRATION_QUOTA);
+      Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+      break;
+    }
+
+    if (Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    *BufferLength = sizeof(QUIC_REGISTRATION_QUOTA);
+    *(QUIC_REGISTRATION_QUOTA *)Buffer = Registration->Quota;
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+
+  case QUIC_PARAM_REGISTRATION_USAGE: {
+
+    if (*BufferLength < sizeof(QUIC_REGISTRATION_USAGE)) {
+      *BufferLength = sizeof(QUIC_REGISTRATION_USAGE);
+      Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+      break;
+    }
+
+    if (Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    QUIC_REGISTRATION_USAGE *Usage = (QUIC_REGISTRATION_USAGE *)Buffer;
+    *BufferLength = sizeof(QUIC_REGISTRATION_USAGE);
+    Usage->BufferedBytes = Registration->BufferedBytes;
+    Usage->WorkerTimeUs = 0;
+    for (uint16_t i = 0; i < Registration->WorkerPool->WorkerCount; ++i) {
+      Usage->WorkerTimeUs += Registration->WorkerPool->Workers[i].BusyTimeUs;
+    }
+    Usage->ConnectionCount = Registration->ConnectionCount;
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+  }
+
+  case QUIC_PARAM_REGISTRATION_DRAIN:
+
+    if (*BufferLength < sizeof(BOOLEAN)) {
+      *BufferLength = sizeof(BOOLEAN);
+      Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+      break;
+    }
+
+    if (Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    *BufferLength = sizeof(BOOLEAN);
+    *(BOOLEAN *)Buffer = Registration->Draining;
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+
+  case QUIC_PARAM_REGISTRATION_EGRESS_RATE_LIMIT:
+
+    if (*BufferLength < sizeof(uint64_t)) {
+      *BufferLength = sizeof(uint64_t);
+      Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+      break;
+    }
+
+    if (Buffer == NULL) {
+      Status = QUIC_STATUS_INVALID_PARAMETER;
+      break;
+    }
+
+    *BufferLength = sizeof(uint64_t);
+    *(uint64_t *)Buffer = Registration->EgressRateLimit;
+    Status = QUIC_STATUS_SUCCESS;
+    break;
+
+  default:
+    Status = QUIC_STATUS_INVALID_PARAMETER;
+    break;
+  }
+
+  return Status;
 }
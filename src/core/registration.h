@@ -61,6 +61,12 @@ typedef struct QUIC_REGISTRATION {
     //
     BOOLEAN ShuttingDown : 1;
 
+    //
+    // Indicates the registration is draining: new connections are refused and
+    // existing ones close once they have no open streams.
+    //
+    BOOLEAN Draining : 1;
+
     //
     // App (optionally) configured execution profile.
     //
@@ -157,6 +163,40 @@ typedef struct QUIC_REGISTRATION {
     //
     void* CloseCompleteContext;
 
+    //
+    // The app's custom congestion controller, used by connections configured
+    // with QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM. Create is NULL if none
+    // was set.
+    //
+    QUIC_CONGESTION_CONTROL_CALLBACKS CongestionControl;
+
+    //
+    // App configured resource limits for all the registration's connections.
+    // Zero fields are unlimited.
+    //
+    QUIC_REGISTRATION_QUOTA Quota;
+
+    //
+    // Number of connections in the Connections list. Protected by
+    // ConnectionLock.
+    //
+    uint32_t ConnectionCount;
+
+    //
+    // Send bytes currently buffered by the registration's connections.
+    //
+    uint64_t BufferedBytes;
+
+    //
+    // The app's egress rate limit (in bytes per second) over all the
+    // registration's connections, or zero, and its token bucket. Connections
+    // on any worker take tokens out with interlocked operations, and whoever
+    // moves EgressRefillTime forward puts in the tokens for the elapsed time.
+    //
+    uint64_t EgressRateLimit;
+    uint64_t EgressRefillTime;
+    int64_t EgressTokens;
+
     //
     // Name of the application layer.
     //
@@ -221,6 +261,38 @@ QuicRegistrationRundownRelease(
     CxPlatRundownRelease(&Registration->Rundown);
 }
 
+//
+// Returns TRUE if the registration's connection quota allows another
+// connection. Not synchronized with connections being added, so the limit may
+// be briefly exceeded by racing opens.
+//
+QUIC_INLINE
+BOOLEAN
+QuicRegistrationHasConnectionQuota(
+    _In_ const QUIC_REGISTRATION* Registration
+    )
+{
+    return
+        Registration->Quota.MaxConnections == 0 ||
+        Registration->ConnectionCount < Registration->Quota.MaxConnections;
+}
+
+//
+// Returns TRUE if the registration's connections may buffer Size more send
+// bytes.
+//
+QUIC_INLINE
+BOOLEAN
+QuicRegistrationHasBufferQuota(
+    _In_ const QUIC_REGISTRATION* Registration,
+    _In_ uint32_t Size
+    )
+{
+    return
+        Registration->Quota.MaxBufferedBytes == 0 ||
+        Registration->BufferedBytes + Size <= Registration->Quota.MaxBufferedBytes;
+}
+
 //
 // Tracing rundown for the registration.
 //
@@ -261,6 +333,17 @@ QuicRegistrationQueueNewConnection(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Refills the registration's egress rate limit token bucket and returns the
+// number of bytes it currently allows to be sent. UINT32_MAX if unlimited.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicRegistrationGetEgressAllowance(
+    _In_ QUIC_REGISTRATION* Registration,
+    _In_ uint64_t TimeNow
+    );
+
 //
 // Sets a registration parameter.
 //
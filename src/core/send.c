@@ -32,6 +32,8 @@ QuicSendInitialize(
 {
     CxPlatListInitializeHead(&Send->SendStreams);
     Send->MaxData = Settings->ConnFlowControlWindow;
+    Send->ConnFlowControlWindow = Settings->ConnFlowControlWindow;
+    Send->ConnFlowControlWindowLastUpdate = CxPlatTimeUs64();
     Send->SkippedPacketNumber = UINT64_MAX;
 
     //
@@ -90,6 +92,7 @@ QuicSendApplyNewSettings(
     )
 {
     Send->MaxData = Settings->ConnFlowControlWindow;
+    Send->ConnFlowControlWindow = Settings->ConnFlowControlWindow;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -104,9 +107,10 @@ QuicSendReset(
         QuicConnTimerCancel(QuicSendGetConnection(Send), QUIC_CONN_TIMER_ACK_DELAY);
         Send->DelayedAckTimerActive = FALSE;
     }
-    QuicConnTimerCancel(
-        QuicSendGetConnection(Send),
-        QUIC_CONN_TIMER_PACING);
+    Send->PacerTokensValid = FALSE;
+    QuicWorkerPacingTimerCancel(
+        QuicSendGetConnection(Send)->Worker,
+        QuicSendGetConnection(Send));
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -148,19 +152,36 @@ QuicSendQueueFlush(
     }
 }
 
+//
+// Inserts the stream into the send queue, at the end of the streams with the
+// same priority.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
+static
 void
-QuicSendQueueFlushForStream(
+QuicSendInsertStream(
     _In_ QUIC_SEND* Send,
-    _In_ QUIC_STREAM* Stream,
-    _In_ BOOLEAN DelaySend
+    _In_ QUIC_STREAM* Stream
     )
 {
-    if (Stream->SendLink.Flink == NULL) {
+    CXPLAT_LIST_ENTRY* Entry;
+
+    if (QuicSendGetConnection(Send)->State.UseUrgencyStreamScheduling) {
         //
-        // Not previously queued, so add the stream to the end of the queue.
+        // Insert after the last stream of the same urgency, or of the closest
+        // more urgent level.
         //
-        CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
+        Entry = &Send->SendStreams;
+        for (int32_t i = Stream->SendUrgency; i >= 0; --i) {
+            if (Send->UrgencyTails[i] != NULL) {
+                Entry = &Send->UrgencyTails[i]->SendLink;
+                break;
+            }
+        }
+        Send->UrgencyTails[Stream->SendUrgency] = Stream;
+
+    } else {
+        Entry = Send->SendStreams.Blink;
         while (Entry != &Send->SendStreams) {
             //
             // Search back to front for the right place (based on priority) to
@@ -172,7 +193,98 @@ QuicSendQueueFlushForStream(
             }
             Entry = Entry->Blink;
         }
-        CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+    }
+
+    CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
+}
+
+//
+// Removes the stream from the send queue. The stream's urgency may have just
+// been changed, so it isn't used to find the urgency tail to update.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSendRemoveStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    for (uint32_t i = 0; i < QUIC_STREAM_URGENCY_COUNT; ++i) {
+        if (Send->UrgencyTails[i] == Stream) {
+            CXPLAT_LIST_ENTRY* Prev = Stream->SendLink.Blink;
+            QUIC_STREAM* PrevStream =
+                Prev != &Send->SendStreams ?
+                    CXPLAT_CONTAINING_RECORD(Prev, QUIC_STREAM, SendLink) :
+                    NULL;
+            Send->UrgencyTails[i] =
+                PrevStream != NULL && PrevStream->SendUrgency == i ?
+                    PrevStream : NULL;
+            break;
+        }
+    }
+
+    CxPlatListEntryRemove(&Stream->SendLink);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendCorkStreamData(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t Length
+    )
+{
+    QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    if (Send->CorkTimeoutUs == 0 || !Connection->State.Connected) {
+        return FALSE;
+    }
+
+    Send->CorkedBytes =
+        Length >= UINT32_MAX - Send->CorkedBytes ?
+            UINT32_MAX : Send->CorkedBytes + (uint32_t)Length;
+    if (Send->CorkedBytes >= QuicPathGetDatagramPayloadSize(&Connection->Paths[0])) {
+        //
+        // A full packet is ready, so the flush this triggers releases the
+        // cork.
+        //
+        return FALSE;
+    }
+
+    if (!Send->Corked) {
+        Send->Corked = TRUE;
+        QuicConnTimerSet(Connection, QUIC_CONN_TIMER_CORK, Send->CorkTimeoutUs);
+    }
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUncork(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_SEND_FLUSH_REASON Reason
+    )
+{
+    if (Send->Corked) {
+        Send->Corked = FALSE;
+        QuicConnTimerCancel(QuicSendGetConnection(Send), QUIC_CONN_TIMER_CORK);
+        QuicSendQueueFlush(Send, Reason);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendQueueFlushForStream(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_STREAM* Stream,
+    _In_ BOOLEAN DelaySend
+    )
+{
+    if (Stream->SendLink.Flink == NULL) {
+        //
+        // Not previously queued, so add the stream to the end of the queue.
+        //
+        QuicSendInsertStream(Send, Stream);
         QuicStreamAddRef(Stream, QUIC_STREAM_REF_SEND);
     }
 
@@ -202,21 +314,31 @@ QuicSendUpdateStreamPriority(
     )
 {
     CXPLAT_DBG_ASSERT(Stream->SendLink.Flink != NULL);
-    CxPlatListEntryRemove(&Stream->SendLink);
+    QuicSendRemoveStream(Send, Stream);
+    QuicSendInsertStream(Send, Stream);
+}
 
-    CXPLAT_LIST_ENTRY* Entry = Send->SendStreams.Blink;
-    while (Entry != &Send->SendStreams) {
-        //
-        // Search back to front for the right place (based on priority) to
-        // insert the stream.
-        //
-        if (Stream->SendPriority <=
-            CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, SendLink)->SendPriority) {
-            break;
-        }
-        Entry = Entry->Blink;
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUpdateStreamScheduling(
+    _In_ QUIC_SEND* Send
+    )
+{
+    CXPLAT_LIST_ENTRY Streams;
+    CxPlatListInitializeHead(&Streams);
+    CxPlatListMoveItems(&Send->SendStreams, &Streams);
+    CxPlatZeroMemory(Send->UrgencyTails, sizeof(Send->UrgencyTails));
+
+    //
+    // Requeue the streams in their current order, so that the order between
+    // streams of equal priority is kept.
+    //
+    while (!CxPlatListIsEmpty(&Streams)) {
+        QUIC_STREAM* Stream =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Streams), QUIC_STREAM, SendLink);
+        QuicSendInsertStream(Send, Stream);
     }
-    CxPlatListInsertHead(Entry, &Stream->SendLink); // Insert after current Entry
 }
 
 #if DEBUG
@@ -282,6 +404,7 @@ QuicSendClear(
 
         QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
     }
+    CxPlatZeroMemory(Send->UrgencyTails, sizeof(Send->UrgencyTails));
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -429,8 +552,6 @@ QuicSendClearStreamSendFlag(
     _In_ uint32_t SendFlags
     )
 {
-    UNREFERENCED_PARAMETER(Send);
-
     if (Stream->SendFlags & SendFlags) {
 
 
@@ -443,7 +564,7 @@ QuicSendClearStreamSendFlag(
             //
             // Since there are no flags left, remove the stream from the queue.
             //
-            CxPlatListEntryRemove(&Stream->SendLink);
+            QuicSendRemoveStream(Send, Stream);
             Stream->SendLink.Flink = NULL;
             QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
         }
@@ -555,6 +676,14 @@ QuicSendWriteFrames(
             //
             if (Builder->Key->Type == Connection->Crypto.TlsState.WriteKey) {
                 Send->SendFlags &= ~(QUIC_CONN_SEND_FLAG_CONNECTION_CLOSE | QUIC_CONN_SEND_FLAG_APPLICATION_CLOSE);
+                if (Connection->State.ClosedFast &&
+                    !Connection->State.ClosedRemotely) {
+                    //
+                    // Don't wait for the peer's response. Shutdown completes
+                    // after this flush, once the packet has gone out.
+                    //
+                    QuicConnOnFastCloseSent(Connection);
+                }
             }
 
             (void)QuicPacketBuilderAddFrame(
@@ -905,6 +1034,20 @@ QuicSendWriteFrames(
             }
         }
 
+        if (Send->SendFlags & QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK) {
+
+            if (Builder->DatagramLength < AvailableBufferLength) {
+                Builder->Datagram->Buffer[Builder->DatagramLength++] =
+                    QUIC_FRAME_IMMEDIATE_ACK;
+                Send->SendFlags &= ~QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK;
+                if (QuicPacketBuilderAddFrame(Builder, QUIC_FRAME_IMMEDIATE_ACK, TRUE)) {
+                    return TRUE;
+                }
+            } else {
+                RanOutOfRoom = TRUE;
+            }
+        }
+
         if (Send->SendFlags & QUIC_CONN_SEND_FLAG_DATAGRAM) {
             RanOutOfRoom = QuicDatagramWriteFrame(&Connection->Datagram, Builder);
             if (Builder->Metadata->FrameCount == QUIC_MAX_FRAMES_PER_PACKET) {
@@ -994,7 +1137,24 @@ QuicSendGetNextStream(
         //
         if (QuicSendCanSendStreamNow(Stream)) {
 
-            if (Connection->State.UseRoundRobinStreamScheduling) {
+            if (Connection->State.UseUrgencyStreamScheduling) {
+                //
+                // Streams are served in order of urgency. Non-incremental
+                // streams are sent one after another, while an incremental
+                // stream gets its weight in packets and then moves to the end
+                // of its urgency level.
+                //
+                if (Stream->SendIncremental) {
+                    if (Send->UrgencyTails[Stream->SendUrgency] != Stream) {
+                        QuicSendRemoveStream(Send, Stream);
+                        QuicSendInsertStream(Send, Stream);
+                    }
+                    *PacketCount = Stream->SendWeight;
+                } else {
+                    *PacketCount = UINT32_MAX;
+                }
+
+            } else if (Connection->State.UseRoundRobinStreamScheduling) {
                 //
                 // Move the stream after any streams of the same priority. Start
                 // with the "next" entry in the list and keep going until the
@@ -1170,6 +1330,229 @@ typedef enum QUIC_SEND_RESULT {
 
 #pragma warning(push)
 #pragma warning(disable:6001) // SAL is confused by the QuicConnAddRef followed by QuicConnRelease.
+//
+// Returns the maximum number of bytes the pacer releases in a single burst.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicSendGetPacingBurst(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t PacingRate
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    uint32_t BurstPackets = Connection->Settings.PacingBurstPackets;
+    if (BurstPackets == 0) {
+        BurstPackets =
+            MsQuicLib.SendSegmentationSupported ?
+                QUIC_PACING_GSO_BURST_PACKETS :
+                QUIC_PACING_NO_GSO_BURST_PACKETS;
+    }
+
+    uint64_t Burst =
+        (uint64_t)BurstPackets *
+        QuicPathGetDatagramPayloadSize(&Connection->Paths[0]);
+
+    //
+    // At high rates, a burst of a few packets drains so quickly that the
+    // wake ups would cost more than the pacing is worth. Grow the burst to
+    // cover a minimum interval instead.
+    //
+    const uint64_t IntervalBurst =
+        PacingRate * QUIC_PACING_MIN_BURST_INTERVAL_US / CXPLAT_MICROSEC_PER_SEC;
+    if (Burst < IntervalBurst) {
+        Burst = IntervalBurst;
+    }
+
+    return (uint32_t)CXPLAT_MIN(Burst, UINT32_MAX);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicSendGetPacingAllowance(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t PacingRate,
+    _In_ uint64_t TimeNow
+    )
+{
+    CXPLAT_DBG_ASSERT(PacingRate != 0);
+    const uint32_t Burst = QuicSendGetPacingBurst(Send, PacingRate);
+
+    if (!Send->PacerTokensValid) {
+        Send->PacerTokens = Burst;
+        Send->PacerTokensValid = TRUE;
+
+    } else if (Send->PacerTokens < Burst) {
+        const uint64_t Elapsed = CxPlatTimeDiff64(Send->PacerRefillTime, TimeNow);
+        const uint64_t Missing = Burst - Send->PacerTokens;
+        if (Elapsed >= Missing * CXPLAT_MICROSEC_PER_SEC / PacingRate) {
+            Send->PacerTokens = Burst;
+        } else {
+            Send->PacerTokens +=
+                (uint32_t)(PacingRate * Elapsed / CXPLAT_MICROSEC_PER_SEC);
+        }
+
+    } else {
+        //
+        // The burst may have shrunk since the bucket was last filled.
+        //
+        Send->PacerTokens = Burst;
+    }
+
+    Send->PacerRefillTime = TimeNow;
+    Send->PacerRate = PacingRate;
+    return Send->PacerTokens;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSendOnPacedBytesSent(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t Bytes
+    )
+{
+    if (Bytes > Send->PacerTokens) {
+        Send->PacerTokens = 0;
+    } else {
+        Send->PacerTokens -= Bytes;
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicSendGetEgressAllowance(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t TimeNow
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    uint32_t Allowance = UINT32_MAX;
+
+    if (Send->EgressRateLimit != 0) {
+        Send->EgressTokens +=
+            QuicSendGetEgressRefill(
+                Send->EgressRateLimit,
+                Send->EgressTokens,
+                CxPlatTimeDiff64(Send->EgressRefillTime, TimeNow));
+        Send->EgressRefillTime = TimeNow;
+        Allowance = Send->EgressTokens <= 0 ? 0 : (uint32_t)Send->EgressTokens;
+    }
+
+    if (Connection->Registration != NULL) {
+        const uint32_t RegistrationAllowance =
+            QuicRegistrationGetEgressAllowance(Connection->Registration, TimeNow);
+        if (Allowance > RegistrationAllowance) {
+            Allowance = RegistrationAllowance;
+        }
+    }
+
+    return Allowance;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSendOnEgressBytesSent(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t Bytes
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    if (Send->EgressRateLimit != 0) {
+        Send->EgressTokens -= Bytes;
+    }
+    if (Connection->Registration != NULL &&
+        Connection->Registration->EgressRateLimit != 0) {
+        InterlockedExchangeAdd64(
+            &Connection->Registration->EgressTokens, -(int64_t)Bytes);
+    }
+}
+
+//
+// Returns how long (in microseconds) until the egress rate limits allow a
+// full burst again, or zero if they aren't holding the sends back.
+//
+static
+uint64_t
+QuicSendGetEgressDelay(
+    _In_ QUIC_SEND* Send
+    )
+{
+    const QUIC_CONNECTION* Connection = QuicSendGetConnection(Send);
+    uint64_t Delay = 0;
+
+    const uint64_t Rate = Send->EgressRateLimit;
+    if (Rate != 0 && Send->EgressTokens <= 0) {
+        Delay =
+            (uint64_t)(QuicSendGetEgressBurst(Rate) - Send->EgressTokens) *
+            CXPLAT_MICROSEC_PER_SEC / Rate;
+    }
+
+    const QUIC_REGISTRATION* Registration = Connection->Registration;
+    if (Registration != NULL) {
+        const uint64_t RegistrationRate = Registration->EgressRateLimit;
+        const int64_t Tokens = Registration->EgressTokens;
+        if (RegistrationRate != 0 && Tokens <= 0) {
+            const uint64_t RegistrationDelay =
+                (uint64_t)(QuicSendGetEgressBurst(RegistrationRate) - Tokens) *
+                CXPLAT_MICROSEC_PER_SEC / RegistrationRate;
+            if (Delay < RegistrationDelay) {
+                Delay = RegistrationDelay;
+            }
+        }
+    }
+
+    return Delay;
+}
+
+//
+// Returns how long (in microseconds) to wait before the next paced send.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+QuicSendGetPacingDelay(
+    _In_ QUIC_SEND* Send,
+    _In_ const QUIC_PACKET_BUILDER* Builder
+    )
+{
+    if (Builder->EgressLimited) {
+        //
+        // The app's egress rate limit comes first. The pacer is checked again
+        // once it allows another burst.
+        //
+        const uint64_t EgressDelay = QuicSendGetEgressDelay(Send);
+        if (EgressDelay != 0) {
+            return EgressDelay;
+        }
+    }
+
+    if (Builder->PacingRate != 0) {
+        //
+        // The kernel is pacing. Come back once half the scheduled sends have
+        // gone out.
+        //
+        return QUIC_SEND_TXTIME_HORIZON_US / 2;
+    }
+
+    const uint32_t Burst =
+        Send->PacerRate != 0 ? QuicSendGetPacingBurst(Send, Send->PacerRate) : 0;
+    if (Send->PacerTokens >= Burst) {
+        //
+        // Something other than the pacer is holding the sends back.
+        //
+        return QUIC_SEND_PACING_INTERVAL;
+    }
+
+    //
+    // Wait for the bucket to hold a full burst again, so that the sends go
+    // out in (segmentation offload sized) batches.
+    //
+    return
+        CXPLAT_MAX(
+            1,
+            (uint64_t)(Burst - Send->PacerTokens) * CXPLAT_MICROSEC_PER_SEC /
+            Send->PacerRate);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 BOOLEAN
 QuicSendFlush(
@@ -1181,11 +1564,20 @@ QuicSendFlush(
 
     CXPLAT_DBG_ASSERT(!Connection->State.HandleClosed);
 
+    //
+    // Everything queued goes out now, so any auto-corked data with it.
+    //
+    if (Send->Corked) {
+        Send->Corked = FALSE;
+        QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_CORK);
+    }
+    Send->CorkedBytes = 0;
+
     if (!CxPlatIsRouteReady(Connection, Path)) {
         return TRUE;
     }
 
-    QuicConnTimerCancel(Connection, QUIC_CONN_TIMER_PACING);
+    QuicWorkerPacingTimerCancel(Connection->Worker, Connection);
     QuicConnRemoveOutFlowBlockedReason(
         Connection, QUIC_FLOW_BLOCKED_SCHEDULING | QUIC_FLOW_BLOCKED_PACING);
 
@@ -1195,6 +1587,7 @@ QuicSendFlush(
 
     uint64_t TimeNow = CxPlatTimeUs64();
     QuicMtuDiscoveryCheckSearchCompleteTimeout(Connection, TimeNow);
+    QuicDatagramRefillClassTokens(&Connection->Datagram, TimeNow);
 
     //
     // If path is active without being peer validated, disable MTU flag if set.
@@ -1236,6 +1629,8 @@ QuicSendFlush(
     }
     _Analysis_assume_(Builder.Metadata != NULL);
 
+    QuicProbe1(send_flush_entry, Connection);
+
     if (Builder.Path->EcnValidationState == ECN_VALIDATION_CAPABLE) {
         Builder.EcnEctSet = TRUE;
     } else if (Builder.Path->EcnValidationState == ECN_VALIDATION_TESTING) {
@@ -1297,10 +1692,10 @@ QuicSendFlush(
                     //
                     QuicConnAddOutFlowBlockedReason(
                         Connection, QUIC_FLOW_BLOCKED_PACING);
-                    QuicConnTimerSet(
+                    QuicWorkerPacingTimerSet(
+                        Connection->Worker,
                         Connection,
-                        QUIC_CONN_TIMER_PACING,
-                        QUIC_SEND_PACING_INTERVAL);
+                        CxPlatTimeUs64() + QuicSendGetPacingDelay(Send, &Builder));
                     Result = QUIC_SEND_DELAYED_PACING;
                 } else {
                     //
@@ -1322,11 +1717,13 @@ QuicSendFlush(
 
         BOOLEAN WrotePacketFrames;
         BOOLEAN FlushBatchedDatagrams = FALSE;
+        BOOLEAN StreamPackingMiss = FALSE;
         BOOLEAN SendConnectionControlData =
             (SendFlags & ~(QUIC_CONN_SEND_FLAG_DPLPMTUD |
                             QUIC_CONN_SEND_FLAG_PATH_CHALLENGE)) != 0;
         if (SendConnectionControlData) {
             CXPLAT_DBG_ASSERT(QuicSendCanSendFlagsNow(Send));
+            Builder.PackStreamFrames = FALSE;
             if (!QuicPacketBuilderPrepareForControlFrames(
                     &Builder,
                     Send->TailLossProbeNeeded,
@@ -1335,6 +1732,7 @@ QuicSendFlush(
             }
             WrotePacketFrames = QuicSendWriteFrames(Send, &Builder);
         } else if ((SendFlags & QUIC_CONN_SEND_FLAG_DPLPMTUD) != 0) {
+            Builder.PackStreamFrames = FALSE;
             if (!QuicPacketBuilderPrepareForPathMtuDiscovery(&Builder)) {
                 break;
             }
@@ -1375,14 +1773,22 @@ QuicSendFlush(
             //
             // Write the stream frames.
             //
-            WrotePacketFrames |= QuicStreamSendWrite(Stream, &Builder);
+            BOOLEAN WroteStreamFrames = QuicStreamSendWrite(Stream, &Builder);
+            WrotePacketFrames |= WroteStreamFrames;
+
+            //
+            // If the packet was being packed, a stream that didn't fit just
+            // means the packet is full, not that there is nothing left to
+            // send.
+            //
+            StreamPackingMiss = Builder.PackStreamFrames && !WroteStreamFrames;
 
             if (Stream->SendFlags == 0 && Stream->SendLink.Flink != NULL) {
                 //
                 // If the stream no longer has anything to send, remove it from the
                 // list and release Send's reference on it.
                 //
-                CxPlatListEntryRemove(&Stream->SendLink);
+                QuicSendRemoveStream(Send, Stream);
                 Stream->SendLink.Flink = NULL;
                 QuicStreamRelease(Stream, QUIC_STREAM_REF_SEND);
                 Stream = NULL;
@@ -1395,6 +1801,16 @@ QuicSendFlush(
                 Stream = NULL;
             }
 
+            //
+            // When moving on to the next stream, pack its frames into the rest
+            // of this packet instead of closing it at the usual spare space
+            // threshold. Workloads with many small streams would otherwise
+            // send mostly half-full packets.
+            //
+            Builder.PackStreamFrames =
+                WroteStreamFrames && Stream == NULL &&
+                !CxPlatListIsEmpty(&Send->SendStreams);
+
         } else {
             //
             // Nothing else left to send right now.
@@ -1405,15 +1821,21 @@ QuicSendFlush(
 
         Send->TailLossProbeNeeded = FALSE;
 
-        if (!WrotePacketFrames ||
+        const uint16_t MinSpareSpace =
+            Builder.PackStreamFrames ?
+                QUIC_MIN_STREAM_PACK_SPARE_SPACE : QUIC_MIN_PACKET_SPARE_SPACE;
+        if (!WrotePacketFrames || StreamPackingMiss ||
             Builder.Metadata->FrameCount == QUIC_MAX_FRAMES_PER_PACKET ||
-            Builder.Datagram->Length - Builder.DatagramLength < QUIC_MIN_PACKET_SPARE_SPACE) {
+            Builder.Datagram->Length - Builder.DatagramLength < MinSpareSpace) {
 
             //
             // We now have enough data in the current packet that we should
             // finalize it.
             //
-            if (!QuicPacketBuilderFinalize(&Builder, !WrotePacketFrames || FlushBatchedDatagrams)) {
+            Builder.PackStreamFrames = FALSE;
+            if (!QuicPacketBuilderFinalize(
+                    &Builder,
+                    (!WrotePacketFrames && !StreamPackingMiss) || FlushBatchedDatagrams)) {
                 //
                 // Don't have any more space to send.
                 //
@@ -1464,14 +1886,26 @@ QuicSendFlush(
             QuicConnUpdatePeerPacketTolerance(Connection, Builder.TotalCountDatagrams + 1);
         }
 
-    } else if (Builder.TotalCountDatagrams > Connection->PeerPacketTolerance) {
+    } else if (Builder.TotalCountDatagrams > 0) {
         //
-        // If we aren't scheduling limited, we should just use the current batch
-        // size as the packet tolerance for the peer to use for acknowledging
-        // packets.
+        // If we aren't scheduling limited, ask the peer for a fixed number of
+        // ACKs per congestion window instead of one every other packet. Only
+        // update when the target moves by 2x or more so that the window
+        // wobbling doesn't turn into a stream of ACK_FREQUENCY frames.
         //
-        // Temporarily disabled for now.
-        //QuicConnUpdatePeerPacketTolerance(Connection, Builder.TotalCountDatagrams);
+        const uint32_t PacketsPerWindow =
+            QuicCongestionControlGetCongestionWindow(&Connection->CongestionControl) /
+            CXPLAT_MAX(Connection->Paths[0].Mtu, 1);
+        uint32_t Tolerance = PacketsPerWindow / QUIC_ACK_FREQUENCY_CWND_FRACTION;
+        if (Tolerance < QUIC_MIN_ACK_SEND_NUMBER) {
+            Tolerance = QUIC_MIN_ACK_SEND_NUMBER;
+        } else if (Tolerance > UINT8_MAX) {
+            Tolerance = UINT8_MAX;
+        }
+        if (Tolerance >= 2 * (uint32_t)Connection->PeerPacketTolerance ||
+            2 * Tolerance <= (uint32_t)Connection->PeerPacketTolerance) {
+            QuicConnUpdatePeerPacketTolerance(Connection, (uint8_t)Tolerance);
+        }
     }
 
     //
@@ -1479,6 +1913,30 @@ QuicSendFlush(
     //
     QuicDatagramCancelBlocked(Connection);
 
+    if (Result == QUIC_SEND_COMPLETE && Connection->Datagram.ThrottledClasses != 0) {
+        //
+        // Rate limited datagrams are still waiting on their class's tokens.
+        // Come back once the first of them can go.
+        //
+        QuicWorkerPacingTimerSet(
+            Connection->Worker,
+            Connection,
+            QuicDatagramGetThrottledReadyTime(&Connection->Datagram, TimeNow));
+    }
+
+    if (Builder.TotalCountDatagrams > 0) {
+        QuicWorkerRecordMetric(
+            Connection->Worker,
+            QUIC_METRIC_HISTOGRAM_SEND_BATCH_SIZE,
+            Builder.TotalCountDatagrams);
+    }
+
+    QuicProbe3(
+        send_flush_exit,
+        Connection,
+        Builder.TotalCountDatagrams,
+        Builder.TotalDatagramsLength);
+
     return Result != QUIC_SEND_INCOMPLETE;
 }
 #pragma warning(pop)
@@ -145,6 +145,7 @@ QuicPacketTypeToEncryptLevelV2(
 #define QUIC_CONN_SEND_FLAG_ACK_FREQUENCY           0x00008000U
 #define QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED    0x00010000U
 #define QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED     0x00020000U
+#define QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK           0x00040000U
 #define QUIC_CONN_SEND_FLAG_DPLPMTUD                0x80000000U
 
 //
@@ -174,6 +175,7 @@ QuicPacketTypeToEncryptLevelV2(
     QUIC_CONN_SEND_FLAG_PING | \
     QUIC_CONN_SEND_FLAG_DATAGRAM | \
     QUIC_CONN_SEND_FLAG_ACK_FREQUENCY | \
+    QUIC_CONN_SEND_FLAG_IMMEDIATE_ACK | \
     QUIC_CONN_SEND_FLAG_DPLPMTUD | \
     QUIC_CONN_SEND_FLAG_BIDI_STREAMS_BLOCKED | \
     QUIC_CONN_SEND_FLAG_UNI_STREAMS_BLOCKED \
@@ -262,6 +264,23 @@ typedef struct QUIC_SEND {
     //
     BOOLEAN Uninitialized : 1;
 
+    //
+    // TRUE if the pacer's token bucket has been filled since the last reset.
+    //
+    BOOLEAN PacerTokensValid : 1;
+
+    //
+    // Send requests were queued by an inline StreamSend and need buffering
+    // once the current operation completes.
+    //
+    BOOLEAN BufferFillPending : 1;
+
+    //
+    // Stream data is being held back by auto-corking and the cork timer is
+    // armed.
+    //
+    BOOLEAN Corked : 1;
+
     //
     // The next packet number to use.
     //
@@ -283,6 +302,38 @@ typedef struct QUIC_SEND {
     //
     uint64_t LastFlushTime;
 
+    //
+    // The departure time of the next send when pacing is offloaded to the
+    // kernel.
+    //
+    uint64_t NextTxTime;
+
+    //
+    // The pacer's token bucket: the bytes that may currently be sent, the
+    // time the bucket was last refilled and the rate (in bytes per second) it
+    // was refilled at. A zero rate indicates the last flush wasn't paced.
+    //
+    uint64_t PacerRefillTime;
+    uint64_t PacerRate;
+    uint32_t PacerTokens;
+
+    //
+    // The app's egress rate limit (in bytes per second), or zero, and its
+    // token bucket. The tokens go negative when a packet is bigger than what
+    // was left, and the debt is paid off before the next send.
+    //
+    uint64_t EgressRateLimit;
+    uint64_t EgressRefillTime;
+    int64_t EgressTokens;
+
+    //
+    // The longest (in us) auto-corking holds back stream data the app sent
+    // without QUIC_SEND_FLAG_DELAY_SEND, or zero if auto-corking is disabled,
+    // and the bytes of stream data queued since the last flush.
+    //
+    uint32_t CorkTimeoutUs;
+    uint32_t CorkedBytes;
+
     //
     // The total number of packets sent with each corresponding ECT codepoint in all encryption
     // level.
@@ -318,6 +369,19 @@ typedef struct QUIC_SEND {
     //
     uint64_t OrderedStreamBytesDeliveredAccumulator;
 
+    //
+    // The current connection-wide flow control window. Starts at the
+    // ConnFlowControlWindow setting and is auto-tuned up from there, based on
+    // how quickly the app drains data relative to the RTT.
+    //
+    uint64_t ConnFlowControlWindow;
+
+    //
+    // The last time (in us) the connection-wide window was evaluated for
+    // tuning, i.e. the start of the current accumulator period.
+    //
+    uint64_t ConnFlowControlWindowLastUpdate;
+
     //
     // Set of flags indicating what data is ready to be sent out.
     //
@@ -328,6 +392,13 @@ typedef struct QUIC_SEND {
     //
     CXPLAT_LIST_ENTRY SendStreams;
 
+    //
+    // The last stream of each urgency level in SendStreams, when using the
+    // urgency stream scheduling scheme. Lets a stream be queued, or moved
+    // after a priority change, without walking the list.
+    //
+    QUIC_STREAM* UrgencyTails[QUIC_STREAM_URGENCY_COUNT];
+
     //
     // The current token to send with an Initial packet.
     //
@@ -399,6 +470,7 @@ typedef enum QUIC_SEND_FLUSH_REASON {
     REASON_AMP_PROTECTION,
     REASON_SCHEDULING,
     REASON_ROUTE_COMPLETION,
+    REASON_CORK_TIMEOUT,
 } QUIC_SEND_FLUSH_REASON;
 
 //
@@ -411,6 +483,28 @@ QuicSendQueueFlush(
     _In_ QUIC_SEND_FLUSH_REASON Reason
     );
 
+//
+// Called when the app queues Length bytes of stream data without asking for
+// the send to be delayed. Returns TRUE if auto-corking holds the data back
+// until a full packet's worth is queued or the cork timeout elapses.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicSendCorkStreamData(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t Length
+    );
+
+//
+// Releases any auto-corked stream data, e.g. on the cork timer expiring.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUncork(
+    _In_ QUIC_SEND* Send,
+    _In_ QUIC_SEND_FLUSH_REASON Reason
+    );
+
 //
 // Queues a FLUSH_SEND operation for stream data.
 //
@@ -432,6 +526,15 @@ QuicSendUpdateStreamPriority(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Reorders all queued streams in response to a scheduling scheme change.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicSendUpdateStreamScheduling(
+    _In_ QUIC_SEND* Send
+    );
+
 //
 // Tries to drain all queued data that needs to be sent. Returns TRUE if all the
 // data was drained.
@@ -442,6 +545,87 @@ QuicSendFlush(
     _In_ QUIC_SEND* Send
     );
 
+//
+// Refills the pacer's token bucket at the given rate and returns the number
+// of bytes that may currently be sent.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicSendGetPacingAllowance(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t PacingRate,
+    _In_ uint64_t TimeNow
+    );
+
+//
+// Removes sent bytes from the pacer's token bucket.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSendOnPacedBytesSent(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t Bytes
+    );
+
+//
+// The size (in bytes) of the token bucket of an egress rate limit.
+//
+QUIC_INLINE
+int64_t
+QuicSendGetEgressBurst(
+    _In_ uint64_t Rate
+    )
+{
+    const uint64_t Burst =
+        Rate / (CXPLAT_MICROSEC_PER_SEC / QUIC_EGRESS_BURST_INTERVAL_US);
+    return (int64_t)CXPLAT_MIN(CXPLAT_MAX(Burst, CXPLAT_MAX_MTU), INT32_MAX);
+}
+
+//
+// Returns the number of tokens to add to an egress rate limit's bucket,
+// currently holding Tokens, after Elapsed microseconds.
+//
+QUIC_INLINE
+int64_t
+QuicSendGetEgressRefill(
+    _In_ uint64_t Rate,
+    _In_ int64_t Tokens,
+    _In_ uint64_t Elapsed
+    )
+{
+    const int64_t Burst = QuicSendGetEgressBurst(Rate);
+    if (Tokens >= Burst) {
+        return 0;
+    }
+    const uint64_t Missing = (uint64_t)(Burst - Tokens);
+    if (Elapsed >= Missing * CXPLAT_MICROSEC_PER_SEC / Rate) {
+        return (int64_t)Missing;
+    }
+    return (int64_t)(Rate * Elapsed / CXPLAT_MICROSEC_PER_SEC);
+}
+
+//
+// Refills the egress rate limit token buckets of the connection and its
+// registration and returns the number of bytes they currently allow to be
+// sent.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+QuicSendGetEgressAllowance(
+    _In_ QUIC_SEND* Send,
+    _In_ uint64_t TimeNow
+    );
+
+//
+// Takes the sent bytes out of the egress rate limit token buckets.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicSendOnEgressBytesSent(
+    _In_ QUIC_SEND* Send,
+    _In_ uint32_t Bytes
+    );
+
 //
 // Starts the delayed ACK timer if not already running.
 //
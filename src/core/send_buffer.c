@@ -75,6 +75,35 @@ QuicSendBufferUninitialize(
     UNREFERENCED_PARAMETER(SendBuffer);
 }
 
+//
+// Returns the partition the connection's buffered bytes are counted on.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+QUIC_PARTITION*
+QuicSendBufferGetPartition(
+    _In_ QUIC_SEND_BUFFER* SendBuffer
+    )
+{
+    return CXPLAT_CONTAINING_RECORD(SendBuffer, QUIC_CONNECTION, SendBuffer)->Partition;
+}
+
+//
+// Returns the registration the connection's buffered bytes are charged to, if
+// any.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+QUIC_REGISTRATION*
+QuicSendBufferGetRegistration(
+    _In_ QUIC_SEND_BUFFER* SendBuffer
+    )
+{
+    QUIC_CONNECTION* Connection =
+        CXPLAT_CONTAINING_RECORD(SendBuffer, QUIC_CONNECTION, SendBuffer);
+    return Connection->State.Registered ? Connection->Registration : NULL;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != NULL)
 uint8_t*
@@ -83,10 +112,27 @@ QuicSendBufferAlloc(
     _In_ uint32_t Size
     )
 {
+    QUIC_REGISTRATION* Registration = QuicSendBufferGetRegistration(SendBuffer);
+    if (Registration != NULL && !QuicRegistrationHasBufferQuota(Registration, Size)) {
+        //
+        // Over the registration's quota. Like an allocation failure, this
+        // just leaves the request unbuffered until the quota frees up.
+        //
+        return NULL;
+    }
+
     uint8_t* Buf = (uint8_t*)CXPLAT_ALLOC_NONPAGED(Size, QUIC_POOL_SENDBUF);
 
     if (Buf != NULL) {
         SendBuffer->BufferedBytes += Size;
+        InterlockedExchangeAdd64(
+            &QuicSendBufferGetPartition(SendBuffer)->SendBufferMemoryUsage,
+            (int64_t)Size);
+        if (Registration != NULL) {
+            InterlockedExchangeAdd64(
+                (int64_t*)&Registration->BufferedBytes,
+                (int64_t)Size);
+        }
     } else {
     }
 
@@ -103,6 +149,56 @@ QuicSendBufferFree(
 {
     CXPLAT_FREE(Buf, QUIC_POOL_SENDBUF);
     SendBuffer->BufferedBytes -= Size;
+    InterlockedExchangeAdd64(
+        &QuicSendBufferGetPartition(SendBuffer)->SendBufferMemoryUsage,
+        -1 * (int64_t)Size);
+    QUIC_REGISTRATION* Registration = QuicSendBufferGetRegistration(SendBuffer);
+    if (Registration != NULL) {
+        InterlockedExchangeAdd64(
+            (int64_t*)&Registration->BufferedBytes,
+            -1 * (int64_t)Size);
+    }
+}
+
+//
+// Returns the connection's share of the library-wide send buffer budget. When
+// the memory governor is cutting send buffering, the budget is half of what is
+// currently buffered, so total buffering keeps shrinking while it lasts.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicSendBufferFairShare(
+    void
+    )
+{
+    const long ConnectionCount = MsQuicLib.ConnectionCount;
+    uint64_t Budget = MsQuicLib.SendBufferMemoryLimit;
+    if (QuicLibraryGetMemoryPressure() >= QUIC_MEMORY_PRESSURE_LIMIT_SEND_BUFFERING) {
+        Budget = CXPLAT_MIN(Budget, MsQuicLib.CurrentSendBufferMemoryUsage / 2);
+    }
+    return Budget / (uint64_t)CXPLAT_MAX(ConnectionCount, 1);
+}
+
+//
+// Returns the number of bytes the connection should currently buffer: the
+// ideal size, or the fair share if that is smaller and the library is over
+// its send buffer budget.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicSendBufferGetLimit(
+    _In_ const QUIC_SEND_BUFFER* SendBuffer
+    )
+{
+    if (SendBuffer->Constrained) {
+        const uint64_t FairShare = QuicSendBufferFairShare();
+        if (FairShare < SendBuffer->IdealBytes) {
+            return FairShare;
+        }
+    }
+    return SendBuffer->IdealBytes;
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -111,7 +207,40 @@ QuicSendBufferHasSpace(
     _Inout_ QUIC_SEND_BUFFER* SendBuffer
     )
 {
-    return SendBuffer->BufferedBytes < SendBuffer->IdealBytes;
+    return SendBuffer->BufferedBytes < QuicSendBufferGetLimit(SendBuffer);
+}
+
+//
+// Re-evaluates whether the connection must be held to its fair share of the
+// library-wide send buffer budget, and if that changed, tells every stream
+// its new ideal send buffer size.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicSendBufferEvaluateMemoryPressure(
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    const BOOLEAN Constrained =
+        MsQuicLib.CurrentSendBufferMemoryUsage >= MsQuicLib.SendBufferMemoryLimit ||
+        QuicLibraryGetMemoryPressure() >= QUIC_MEMORY_PRESSURE_LIMIT_SEND_BUFFERING;
+    if (Constrained == Connection->SendBuffer.Constrained ||
+        Connection->Streams.StreamTable == NULL) {
+        return;
+    }
+    Connection->SendBuffer.Constrained = Constrained;
+
+    CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+    CXPLAT_HASHTABLE_ENTRY* Entry;
+    CxPlatHashtableEnumerateBegin(Connection->Streams.StreamTable, &Enumerator);
+    while ((Entry = CxPlatHashtableEnumerateNext(Connection->Streams.StreamTable, &Enumerator)) != NULL) {
+        QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, TableEntry);
+        if (Stream->Flags.SendEnabled) {
+            QuicSendBufferStreamAdjust(Stream);
+        }
+    }
+    CxPlatHashtableEnumerateEnd(Connection->Streams.StreamTable, &Enumerator);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -141,6 +270,8 @@ QuicSendBufferFill(
 
     CXPLAT_DBG_ASSERT(Connection->Settings.SendBufferingEnabled);
 
+    QuicSendBufferEvaluateMemoryPressure(Connection);
+
     Entry = Connection->Send.SendStreams.Flink;
     while (QuicSendBufferHasSpace(&Connection->SendBuffer) && Entry != &(Connection->Send.SendStreams)) {
 
@@ -171,6 +302,14 @@ QuicSendBufferFill(
         // Buffer as many requests as we can before moving to the next stream.
         //
         while (Req != NULL && QuicSendBufferHasSpace(&Connection->SendBuffer)) {
+            if (Req->Flags & QUIC_SEND_FLAG_NO_BUFFERING) {
+                //
+                // The app asked for its buffers to be framed directly into
+                // packets. Buffering stops here so that completions stay in
+                // order; the request completes once its data is acknowledged.
+                //
+                break;
+            }
             if (QUIC_FAILED(QuicStreamSendBufferRequest(Stream, Req))) {
                 return;
             }
@@ -212,10 +351,11 @@ QuicSendBufferStreamAdjust(
 {
     //
     // Calculate the value to actually indicate to the app for this stream as
-    // a minimum of the connection-wide IdealBytes and the value based on the
-    // stream's estimated SendWindow.
+    // a minimum of the connection-wide limit (IdealBytes, or the fair share
+    // under memory pressure) and the value based on the stream's estimated
+    // SendWindow.
     //
-    uint64_t ByteCount = Stream->Connection->SendBuffer.IdealBytes;
+    uint64_t ByteCount = QuicSendBufferGetLimit(&Stream->Connection->SendBuffer);
     if ((uint64_t)Stream->SendWindow < ByteCount) {
         const uint64_t SendWindowIdealBytes =
             QuicGetNextIdealBytes(Stream->SendWindow);
@@ -245,9 +385,22 @@ QuicSendBufferConnectionAdjust(
         return; // Nothing to do.
     }
 
-    const uint64_t NewIdealBytes =
-        QuicGetNextIdealBytes(
-            QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl));
+    //
+    // Size the buffer for the larger of the bytes in flight observed so far
+    // and the congestion controller's BDP estimate (if it has one). The BDP
+    // estimate leads BytesInFlightMax by several round trips during startup,
+    // so the app is told the final size in one step instead of walking up
+    // through each intermediate threshold.
+    //
+    uint64_t BaseValue =
+        QuicCongestionControlGetBytesInFlightMax(&Connection->CongestionControl);
+    const uint64_t Bdp =
+        QuicCongestionControlGetBandwidthDelayProduct(&Connection->CongestionControl);
+    if (Bdp > BaseValue) {
+        BaseValue = CXPLAT_MIN(Bdp, QUIC_MAX_IDEAL_SEND_BUFFER_SIZE);
+    }
+
+    const uint64_t NewIdealBytes = QuicGetNextIdealBytes((uint32_t)BaseValue);
 
     //
     // TODO: Currently, IdealBytes only grows and never shrinks. Add appropriate
@@ -27,6 +27,12 @@ typedef struct QUIC_SEND_BUFFER {
     //
     uint64_t IdealBytes;
 
+    //
+    // TRUE when library-wide send buffer usage is over its limit and this
+    // connection is being held to its fair share.
+    //
+    BOOLEAN Constrained;
+
 } QUIC_SEND_BUFFER;
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -80,7 +86,7 @@ QuicSendBufferStreamAdjust(
     );
 
 //
-// Updates IdealBytes upon change of BytesInFlightMax.
+// Updates IdealBytes upon change of BytesInFlightMax or the BDP estimate.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
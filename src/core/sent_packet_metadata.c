@@ -51,6 +51,7 @@ QuicSentPacketMetadataReleaseFrames(
 #pragma warning(pop)
         case QUIC_FRAME_DATAGRAM:
         case QUIC_FRAME_DATAGRAM_1:
+        case QUIC_FRAME_FEC_SOURCE:
             if (Metadata->Frames[i].DATAGRAM.ClientContext != NULL) {
                 QuicDatagramIndicateSendStateChange(
                     Connection,
@@ -70,7 +71,8 @@ QuicSentPacketMetadataReleaseFrames(
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicSentPacketPoolInitialize(
-    _Inout_ QUIC_SENT_PACKET_POOL* Pool
+    _Inout_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_ uint16_t NumaNode
     )
 {
     for (uint32_t i = 0; i < ARRAYSIZE(Pool->Pools); i++) {
@@ -78,10 +80,11 @@ QuicSentPacketPoolInitialize(
             (i + 1) * sizeof(QUIC_SENT_FRAME_METADATA) +
             sizeof(QUIC_SENT_PACKET_METADATA);
 
-        CxPlatPoolInitialize(
+        CxPlatPoolInitializeNuma(
             FALSE,  // IsPaged
             PacketMetadataSize,
             QUIC_POOL_META,
+            NumaNode,
             Pool->Pools + i);
     }
 }
@@ -107,17 +107,6 @@ typedef struct QUIC_SEND_PACKET_FLAGS {
 //
 typedef struct LAST_ACKED_PACKET_INFO {
 
-    //
-    // Total bytes sent when the last acked packet was acked
-    //
-    uint64_t TotalBytesSent;
-
-    //
-    // Total bytes acked when the last acked packet was acked
-    // (including the last acked packet)
-    //
-    uint64_t TotalBytesAcked;
-
     //
     // SentTime of last acked packet
     //
@@ -133,6 +122,20 @@ typedef struct LAST_ACKED_PACKET_INFO {
     //
     uint64_t AdjustedAckTime;
 
+    //
+    // Total bytes acked when the last acked packet was acked (including the
+    // last acked packet). Bytes that are lost or never acked keep it falling
+    // behind the bytes sent, so it is kept as an absolute value.
+    //
+    uint64_t TotalBytesAcked;
+
+    //
+    // TotalBytesSent minus total bytes sent when the last acked packet was
+    // acked. Bounded by the bytes sent since the last ACK, so 32 bits is
+    // plenty. Use QuicSentPacketLastAckedTotalBytesSent to read the absolute
+    // value.
+    //
+    uint32_t TotalBytesSentDelta;
 
 } LAST_ACKED_PACKET_INFO;
 
@@ -143,7 +146,6 @@ typedef struct QUIC_SENT_PACKET_METADATA {
 
     struct QUIC_SENT_PACKET_METADATA *Next;
 
-    uint64_t PacketId;
     uint64_t PacketNumber;
     //
     // Total bytes sent when the packet was sent (including this packet)
@@ -153,10 +155,9 @@ typedef struct QUIC_SENT_PACKET_METADATA {
     uint16_t PacketLength;
     uint8_t PathId;
 
-    LAST_ACKED_PACKET_INFO LastAckedPacketInfo;
-
     //
-    // Hints about the QUIC packet and included frames.
+    // Hints about the QUIC packet and included frames. Kept next to the other
+    // small fields so they share a single 8-byte slot.
     //
     QUIC_SEND_PACKET_FLAGS Flags;
 
@@ -164,6 +165,8 @@ typedef struct QUIC_SENT_PACKET_METADATA {
     // Frames included in this packet.
     //
     uint8_t FrameCount;
+
+    LAST_ACKED_PACKET_INFO LastAckedPacketInfo;
     QUIC_SENT_FRAME_METADATA Frames[0];
 
 } QUIC_SENT_PACKET_METADATA;
@@ -171,6 +174,26 @@ typedef struct QUIC_SENT_PACKET_METADATA {
 #define SIZEOF_QUIC_SENT_PACKET_METADATA(FrameCount) \
     (sizeof(QUIC_SENT_PACKET_METADATA) + FrameCount * sizeof(QUIC_SENT_FRAME_METADATA))
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicSentPacketLastAckedTotalBytesSent(
+    _In_ const QUIC_SENT_PACKET_METADATA* Metadata
+    )
+{
+    return Metadata->TotalBytesSent - Metadata->LastAckedPacketInfo.TotalBytesSentDelta;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_INLINE
+uint64_t
+QuicSentPacketLastAckedTotalBytesAcked(
+    _In_ const QUIC_SENT_PACKET_METADATA* Metadata
+    )
+{
+    return Metadata->LastAckedPacketInfo.TotalBytesAcked;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_INLINE
 uint8_t
@@ -217,7 +240,8 @@ typedef struct QUIC_SENT_PACKET_POOL {
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicSentPacketPoolInitialize(
-    _Inout_ QUIC_SENT_PACKET_POOL* Pool
+    _Inout_ QUIC_SENT_PACKET_POOL* Pool,
+    _In_ uint16_t NumaNode
     );
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -49,6 +49,9 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.FixedServerID) {
         Settings->FixedServerID = 0;
     }
+    if (!Settings->IsSet.HugePageMode) {
+        Settings->HugePageMode = QUIC_DEFAULT_HUGE_PAGE_MODE;
+    }
     if (!Settings->IsSet.MaxWorkerQueueDelayUs) {
         Settings->MaxWorkerQueueDelayUs = MS_TO_US(QUIC_MAX_WORKER_QUEUE_DELAY);
     }
@@ -172,6 +175,36 @@ QuicSettingsSetDefault(
     if (!Settings->IsSet.StreamMultiReceiveEnabled) {
         Settings->StreamMultiReceiveEnabled = QUIC_DEFAULT_STREAM_MULTI_RECEIVE_ENABLED;
     }
+    if (!Settings->IsSet.IdleTimerSlackMs) {
+        Settings->IdleTimerSlackMs = QUIC_DEFAULT_IDLE_TIMER_SLACK_MS;
+    }
+    if (!Settings->IsSet.KeepAliveTimerSlackMs) {
+        Settings->KeepAliveTimerSlackMs = QUIC_DEFAULT_KEEP_ALIVE_TIMER_SLACK_MS;
+    }
+    if (!Settings->IsSet.ShutdownTimerSlackMs) {
+        Settings->ShutdownTimerSlackMs = QUIC_DEFAULT_SHUTDOWN_TIMER_SLACK_MS;
+    }
+    if (!Settings->IsSet.AckDecimationMaxPackets) {
+        Settings->AckDecimationMaxPackets = QUIC_DEFAULT_ACK_DECIMATION_MAX_PACKETS;
+    }
+    if (!Settings->IsSet.FecEnabled) {
+        Settings->FecEnabled = QUIC_DEFAULT_FEC_ENABLED;
+    }
+    if (!Settings->IsSet.StreamZeroCopyReceiveEnabled) {
+        Settings->StreamZeroCopyReceiveEnabled = QUIC_DEFAULT_STREAM_ZERO_COPY_RECEIVE_ENABLED;
+    }
+    if (!Settings->IsSet.PathMetricsCacheEnabled) {
+        Settings->PathMetricsCacheEnabled = QUIC_DEFAULT_PATH_METRICS_CACHE_ENABLED;
+    }
+    if (!Settings->IsSet.PacingBurstPackets) {
+        Settings->PacingBurstPackets = QUIC_DEFAULT_PACING_BURST_PACKETS;
+    }
+    if (!Settings->IsSet.IdleHibernateTimeoutMs) {
+        Settings->IdleHibernateTimeoutMs = QUIC_DEFAULT_IDLE_HIBERNATE_TIMEOUT_MS;
+    }
+    if (!Settings->IsSet.DatacenterModeEnabled) {
+        Settings->DatacenterModeEnabled = QUIC_DEFAULT_DATACENTER_MODE_ENABLED;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -205,6 +238,9 @@ QuicSettingsCopy(
     if (!Destination->IsSet.FixedServerID) {
         Destination->FixedServerID = Source->FixedServerID;
     }
+    if (!Destination->IsSet.HugePageMode) {
+        Destination->HugePageMode = Source->HugePageMode;
+    }
     if (!Destination->IsSet.MaxWorkerQueueDelayUs) {
         Destination->MaxWorkerQueueDelayUs = Source->MaxWorkerQueueDelayUs;
     }
@@ -346,6 +382,36 @@ QuicSettingsCopy(
     if (!Destination->IsSet.StreamMultiReceiveEnabled) {
         Destination->StreamMultiReceiveEnabled = Source->StreamMultiReceiveEnabled;
     }
+    if (!Destination->IsSet.IdleTimerSlackMs) {
+        Destination->IdleTimerSlackMs = Source->IdleTimerSlackMs;
+    }
+    if (!Destination->IsSet.KeepAliveTimerSlackMs) {
+        Destination->KeepAliveTimerSlackMs = Source->KeepAliveTimerSlackMs;
+    }
+    if (!Destination->IsSet.ShutdownTimerSlackMs) {
+        Destination->ShutdownTimerSlackMs = Source->ShutdownTimerSlackMs;
+    }
+    if (!Destination->IsSet.AckDecimationMaxPackets) {
+        Destination->AckDecimationMaxPackets = Source->AckDecimationMaxPackets;
+    }
+    if (!Destination->IsSet.DatacenterModeEnabled) {
+        Destination->DatacenterModeEnabled = Source->DatacenterModeEnabled;
+    }
+    if (!Destination->IsSet.FecEnabled) {
+        Destination->FecEnabled = Source->FecEnabled;
+    }
+    if (!Destination->IsSet.PathMetricsCacheEnabled) {
+        Destination->PathMetricsCacheEnabled = Source->PathMetricsCacheEnabled;
+    }
+    if (!Destination->IsSet.StreamZeroCopyReceiveEnabled) {
+        Destination->StreamZeroCopyReceiveEnabled = Source->StreamZeroCopyReceiveEnabled;
+    }
+    if (!Destination->IsSet.PacingBurstPackets) {
+        Destination->PacingBurstPackets = Source->PacingBurstPackets;
+    }
+    if (!Destination->IsSet.IdleHibernateTimeoutMs) {
+        Destination->IdleHibernateTimeoutMs = Source->IdleHibernateTimeoutMs;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -457,6 +523,13 @@ QuicSettingApply(
         Destination->FixedServerID = Source->FixedServerID;
         Destination->IsSet.FixedServerID = TRUE;
     }
+    if (Source->IsSet.HugePageMode && (!Destination->IsSet.HugePageMode || OverWrite)) {
+        if (Source->HugePageMode >= QUIC_HUGE_PAGE_COUNT) {
+            return FALSE;
+        }
+        Destination->HugePageMode = Source->HugePageMode;
+        Destination->IsSet.HugePageMode = TRUE;
+    }
     if (Source->IsSet.MaxWorkerQueueDelayUs && (!Destination->IsSet.MaxWorkerQueueDelayUs || OverWrite)) {
         Destination->MaxWorkerQueueDelayUs = Source->MaxWorkerQueueDelayUs;
         Destination->IsSet.MaxWorkerQueueDelayUs = TRUE;
@@ -730,6 +803,56 @@ QuicSettingApply(
         Destination->StreamMultiReceiveEnabled = Source->StreamMultiReceiveEnabled;
         Destination->IsSet.StreamMultiReceiveEnabled = TRUE;
     }
+
+    if (Source->IsSet.IdleTimerSlackMs && (!Destination->IsSet.IdleTimerSlackMs || OverWrite)) {
+        Destination->IdleTimerSlackMs = Source->IdleTimerSlackMs;
+        Destination->IsSet.IdleTimerSlackMs = TRUE;
+    }
+
+    if (Source->IsSet.KeepAliveTimerSlackMs && (!Destination->IsSet.KeepAliveTimerSlackMs || OverWrite)) {
+        Destination->KeepAliveTimerSlackMs = Source->KeepAliveTimerSlackMs;
+        Destination->IsSet.KeepAliveTimerSlackMs = TRUE;
+    }
+
+    if (Source->IsSet.ShutdownTimerSlackMs && (!Destination->IsSet.ShutdownTimerSlackMs || OverWrite)) {
+        Destination->ShutdownTimerSlackMs = Source->ShutdownTimerSlackMs;
+        Destination->IsSet.ShutdownTimerSlackMs = TRUE;
+    }
+
+    if (Source->IsSet.AckDecimationMaxPackets && (!Destination->IsSet.AckDecimationMaxPackets || OverWrite)) {
+        Destination->AckDecimationMaxPackets = Source->AckDecimationMaxPackets;
+        Destination->IsSet.AckDecimationMaxPackets = TRUE;
+    }
+
+    if (Source->IsSet.DatacenterModeEnabled && (!Destination->IsSet.DatacenterModeEnabled || OverWrite)) {
+        Destination->DatacenterModeEnabled = Source->DatacenterModeEnabled;
+        Destination->IsSet.DatacenterModeEnabled = TRUE;
+    }
+
+    if (Source->IsSet.FecEnabled && (!Destination->IsSet.FecEnabled || OverWrite)) {
+        Destination->FecEnabled = Source->FecEnabled;
+        Destination->IsSet.FecEnabled = TRUE;
+    }
+
+    if (Source->IsSet.PathMetricsCacheEnabled && (!Destination->IsSet.PathMetricsCacheEnabled || OverWrite)) {
+        Destination->PathMetricsCacheEnabled = Source->PathMetricsCacheEnabled;
+        Destination->IsSet.PathMetricsCacheEnabled = TRUE;
+    }
+
+    if (Source->IsSet.StreamZeroCopyReceiveEnabled && (!Destination->IsSet.StreamZeroCopyReceiveEnabled || OverWrite)) {
+        Destination->StreamZeroCopyReceiveEnabled = Source->StreamZeroCopyReceiveEnabled;
+        Destination->IsSet.StreamZeroCopyReceiveEnabled = TRUE;
+    }
+
+    if (Source->IsSet.PacingBurstPackets && (!Destination->IsSet.PacingBurstPackets || OverWrite)) {
+        Destination->PacingBurstPackets = Source->PacingBurstPackets;
+        Destination->IsSet.PacingBurstPackets = TRUE;
+    }
+
+    if (Source->IsSet.IdleHibernateTimeoutMs && (!Destination->IsSet.IdleHibernateTimeoutMs || OverWrite)) {
+        Destination->IdleHibernateTimeoutMs = Source->IdleHibernateTimeoutMs;
+        Destination->IsSet.IdleHibernateTimeoutMs = TRUE;
+    }
     return TRUE;
 }
 
@@ -856,6 +979,20 @@ QuicSettingsLoad(
             &ValueLen);
     }
 
+    if (!Settings->IsSet.HugePageMode &&
+        !MsQuicLib.InUse) {
+        Value = QUIC_DEFAULT_HUGE_PAGE_MODE;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_HUGE_PAGE_MODE,
+            (uint8_t*)&Value,
+            &ValueLen);
+        if (Value < QUIC_HUGE_PAGE_COUNT) {
+            Settings->HugePageMode = (uint16_t)Value;
+        }
+    }
+
     if (!Settings->IsSet.MaxWorkerQueueDelayUs) {
         Value = QUIC_MAX_WORKER_QUEUE_DELAY;
         ValueLen = sizeof(Value);
@@ -1398,6 +1535,106 @@ VersionSettingsFail:
             &ValueLen);
         Settings->StreamMultiReceiveEnabled = !!Value;
     }
+    if (!Settings->IsSet.IdleTimerSlackMs) {
+        Value = QUIC_DEFAULT_IDLE_TIMER_SLACK_MS;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_IDLE_TIMER_SLACK,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->IdleTimerSlackMs = Value;
+    }
+    if (!Settings->IsSet.KeepAliveTimerSlackMs) {
+        Value = QUIC_DEFAULT_KEEP_ALIVE_TIMER_SLACK_MS;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_KEEP_ALIVE_TIMER_SLACK,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->KeepAliveTimerSlackMs = Value;
+    }
+    if (!Settings->IsSet.ShutdownTimerSlackMs) {
+        Value = QUIC_DEFAULT_SHUTDOWN_TIMER_SLACK_MS;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_SHUTDOWN_TIMER_SLACK,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->ShutdownTimerSlackMs = Value;
+    }
+    if (!Settings->IsSet.AckDecimationMaxPackets) {
+        Value = QUIC_DEFAULT_ACK_DECIMATION_MAX_PACKETS;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_ACK_DECIMATION_MAX_PACKETS,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->AckDecimationMaxPackets = Value;
+    }
+    if (!Settings->IsSet.DatacenterModeEnabled) {
+        Value = QUIC_DEFAULT_DATACENTER_MODE_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_DATACENTER_MODE_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->DatacenterModeEnabled = !!Value;
+    }
+    if (!Settings->IsSet.FecEnabled) {
+        Value = QUIC_DEFAULT_FEC_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_FEC_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->FecEnabled = !!Value;
+    }
+    if (!Settings->IsSet.PathMetricsCacheEnabled) {
+        Value = QUIC_DEFAULT_PATH_METRICS_CACHE_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_PATH_METRICS_CACHE_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->PathMetricsCacheEnabled = !!Value;
+    }
+    if (!Settings->IsSet.StreamZeroCopyReceiveEnabled) {
+        Value = QUIC_DEFAULT_STREAM_ZERO_COPY_RECEIVE_ENABLED;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_STREAM_ZERO_COPY_RECEIVE_ENABLED,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->StreamZeroCopyReceiveEnabled = !!Value;
+    }
+    if (!Settings->IsSet.PacingBurstPackets) {
+        Value = QUIC_DEFAULT_PACING_BURST_PACKETS;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_PACING_BURST_PACKETS,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->PacingBurstPackets = Value;
+    }
+    if (!Settings->IsSet.IdleHibernateTimeoutMs) {
+        Value = QUIC_DEFAULT_IDLE_HIBERNATE_TIMEOUT_MS;
+        ValueLen = sizeof(Value);
+        CxPlatStorageReadValue(
+            Storage,
+            QUIC_SETTING_IDLE_HIBERNATE_TIMEOUT,
+            (uint8_t*)&Value,
+            &ValueLen);
+        Settings->IdleHibernateTimeoutMs = Value;
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -1440,6 +1677,8 @@ QuicSettingsDumpNew(
     }
     if (Settings->IsSet.FixedServerID) {
     }
+    if (Settings->IsSet.HugePageMode) {
+    }
     if (Settings->IsSet.MaxStatelessOperations) {
     }
     if (Settings->IsSet.MaxWorkerQueueDelayUs) {
@@ -1530,6 +1769,26 @@ QuicSettingsDumpNew(
     }
     if (Settings->IsSet.StreamMultiReceiveEnabled) {
     }
+    if (Settings->IsSet.IdleTimerSlackMs) {
+    }
+    if (Settings->IsSet.KeepAliveTimerSlackMs) {
+    }
+    if (Settings->IsSet.ShutdownTimerSlackMs) {
+    }
+    if (Settings->IsSet.AckDecimationMaxPackets) {
+    }
+    if (Settings->IsSet.DatacenterModeEnabled) {
+    }
+    if (Settings->IsSet.FecEnabled) {
+    }
+    if (Settings->IsSet.PathMetricsCacheEnabled) {
+    }
+    if (Settings->IsSet.StreamZeroCopyReceiveEnabled) {
+    }
+    if (Settings->IsSet.PacingBurstPackets) {
+    }
+    if (Settings->IsSet.IdleHibernateTimeoutMs) {
+    }
 }
 
 #define SETTING_COPY_TO_INTERNAL(Field, Settings, InternalSettings) \
@@ -1575,6 +1834,13 @@ QuicSettingsGlobalSettingsToInternal(
         SettingsSize,
         InternalSettings);
 
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        HugePageMode,
+        QUIC_GLOBAL_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
     return QUIC_STATUS_SUCCESS;
 }
 
@@ -1744,6 +2010,38 @@ QuicSettingsSettingsToInternal(
         SettingsSize,
         InternalSettings);
 
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        DatacenterModeEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        FecEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        PathMetricsCacheEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
+        Flags,
+        StreamZeroCopyReceiveEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
     SETTING_COPY_FLAG_TO_INTERNAL_SIZED(
         Flags,
         OneWayDelayEnabled,
@@ -1789,6 +2087,48 @@ QuicSettingsSettingsToInternal(
         SettingsSize,
         InternalSettings);
 
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        IdleTimerSlackMs,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        KeepAliveTimerSlackMs,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        ShutdownTimerSlackMs,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        AckDecimationMaxPackets,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        PacingBurstPackets,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
+    SETTING_COPY_TO_INTERNAL_SIZED(
+        IdleHibernateTimeoutMs,
+        QUIC_SETTINGS,
+        Settings,
+        SettingsSize,
+        InternalSettings);
+
     return QUIC_STATUS_SUCCESS;
 }
 
@@ -1929,6 +2269,38 @@ QuicSettingsGetSettings(
         *SettingsLength,
         InternalSettings);
 
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        DatacenterModeEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        FecEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        PathMetricsCacheEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
+        Flags,
+        StreamZeroCopyReceiveEnabled,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
     SETTING_COPY_FLAG_FROM_INTERNAL_SIZED(
         Flags,
         OneWayDelayEnabled,
@@ -1974,6 +2346,48 @@ QuicSettingsGetSettings(
         *SettingsLength,
         InternalSettings);
 
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        IdleTimerSlackMs,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        KeepAliveTimerSlackMs,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        ShutdownTimerSlackMs,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        AckDecimationMaxPackets,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        PacingBurstPackets,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        IdleHibernateTimeoutMs,
+        QUIC_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
     *SettingsLength = CXPLAT_MIN(*SettingsLength, sizeof(QUIC_SETTINGS));
 
     return QUIC_STATUS_SUCCESS;
@@ -2018,6 +2432,13 @@ QuicSettingsGetGlobalSettings(
         *SettingsLength,
         InternalSettings);
 
+    SETTING_COPY_FROM_INTERNAL_SIZED(
+        HugePageMode,
+        QUIC_GLOBAL_SETTINGS,
+        Settings,
+        *SettingsLength,
+        InternalSettings);
+
     *SettingsLength = CXPLAT_MIN(*SettingsLength, sizeof(QUIC_GLOBAL_SETTINGS));
 
     return QUIC_STATUS_SUCCESS;
@@ -64,7 +64,18 @@ typedef struct QUIC_SETTINGS_INTERNAL {
             uint64_t StreamMultiReceiveEnabled              : 1;
             uint64_t XdpEnabled                             : 1;
             uint64_t QTIPEnabled                            : 1;
-            uint64_t RESERVED                               : 14;
+            uint64_t IdleTimerSlackMs                       : 1;
+            uint64_t KeepAliveTimerSlackMs                  : 1;
+            uint64_t ShutdownTimerSlackMs                   : 1;
+            uint64_t AckDecimationMaxPackets                : 1;
+            uint64_t DatacenterModeEnabled                  : 1;
+            uint64_t FecEnabled                             : 1;
+            uint64_t PathMetricsCacheEnabled                : 1;
+            uint64_t PacingBurstPackets                     : 1;
+            uint64_t StreamZeroCopyReceiveEnabled           : 1;
+            uint64_t HugePageMode                           : 1;
+            uint64_t IdleHibernateTimeoutMs                 : 1;
+            uint64_t RESERVED                               : 3;
         } IsSet;
     };
 
@@ -90,11 +101,18 @@ typedef struct QUIC_SETTINGS_INTERNAL {
     uint32_t DisconnectTimeoutMs;
     uint32_t KeepAliveIntervalMs;
     uint32_t DestCidUpdateIdleTimeoutMs;
+    uint32_t IdleTimerSlackMs;
+    uint32_t KeepAliveTimerSlackMs;
+    uint32_t ShutdownTimerSlackMs;
+    uint32_t AckDecimationMaxPackets;
+    uint32_t PacingBurstPackets;
+    uint32_t IdleHibernateTimeoutMs;
     uint32_t FixedServerID;                 // Global only
     uint16_t PeerBidiStreamCount;
     uint16_t PeerUnidiStreamCount;
     uint16_t RetryMemoryLimit;              // Global only
     uint16_t LoadBalancingMode;             // Global only
+    uint16_t HugePageMode;                  // Global only
     uint16_t MinimumMtu;
     uint16_t MaximumMtu;
     uint16_t MaxBindingStatelessOperations;
@@ -117,6 +135,10 @@ typedef struct QUIC_SETTINGS_INTERNAL {
     uint8_t StreamMultiReceiveEnabled       : 1;
     uint8_t XdpEnabled                      : 1;
     uint8_t QTIPEnabled                     : 1;
+    uint8_t DatacenterModeEnabled           : 1;
+    uint8_t FecEnabled                      : 1;
+    uint8_t PathMetricsCacheEnabled         : 1;
+    uint8_t StreamZeroCopyReceiveEnabled    : 1;
     uint8_t MtuDiscoveryMissingProbeCount;
 } QUIC_SETTINGS_INTERNAL;
 
@@ -63,10 +63,15 @@ QuicStreamInitialize(
     Stream->Flags.ReceiveMultiple =
         Connection->Settings.StreamMultiReceiveEnabled &&
         !Stream->Flags.UseAppOwnedRecvBuffers;
+    Stream->Flags.ReceiveZeroCopy =
+        Stream->Flags.ReceiveMultiple &&
+        Connection->Settings.StreamZeroCopyReceiveEnabled;
     Stream->RecvMaxLength = UINT64_MAX;
     CxPlatRefInitialize(&Stream->RefCount);
     Stream->SendRequestsTail = &Stream->SendRequests;
     Stream->SendPriority = QUIC_STREAM_PRIORITY_DEFAULT;
+    Stream->SendUrgency = QUIC_STREAM_URGENCY_DEFAULT;
+    Stream->SendWeight = QUIC_STREAM_SEND_BATCH_COUNT;
     CxPlatDispatchLockInitialize(&Stream->ApiSendRequestLock);
     CxPlatRefInitialize(&Stream->RefCount);
     QuicRangeInitialize(
@@ -114,6 +119,13 @@ QuicStreamInitialize(
     QUIC_RECV_BUF_MODE RecvBufferMode = QUIC_RECV_BUF_MODE_CIRCULAR;
     if (Stream->Flags.UseAppOwnedRecvBuffers) {
         RecvBufferMode = QUIC_RECV_BUF_MODE_APP_OWNED;
+    } else if (Stream->Flags.RemoteNotAllowed) {
+        //
+        // Send-only streams never receive data, so don't allocate any receive
+        // buffer storage for them. App-owned mode is the only mode that
+        // starts without a chunk.
+        //
+        RecvBufferMode = QUIC_RECV_BUF_MODE_APP_OWNED;
     } else if (Stream->Flags.ReceiveMultiple) {
         RecvBufferMode = QUIC_RECV_BUF_MODE_MULTIPLE;
     }
@@ -142,10 +154,11 @@ QuicStreamInitialize(
     Status =
         QuicRecvBufferInitialize(
             &Stream->RecvBuffer,
-            InitialRecvBufferLength,
+            RecvBufferMode != QUIC_RECV_BUF_MODE_APP_OWNED ? InitialRecvBufferLength : 0,
             FlowControlWindowSize,
             RecvBufferMode,
-            PreallocatedRecvChunk);
+            PreallocatedRecvChunk,
+            Connection->Partition->RecvChunkPools);
     if (QUIC_FAILED(Status)) {
         goto Exit;
     }
@@ -212,6 +225,10 @@ QuicStreamFree(
 #endif
     QuicPerfCounterDecrement(Connection->Partition, QUIC_PERF_COUNTER_STRM_ACTIVE);
 
+    QuicStreamReleaseHeldRecvPackets(
+        Stream,
+        Stream->RecvBuffer.DatapathChunkCount,
+        Stream->RecvBuffer.DatapathChunkBytes);
     QuicRecvBufferUninitialize(&Stream->RecvBuffer);
     QuicRangeUninitialize(&Stream->SparseAckRanges);
     CxPlatDispatchLockUninitialize(&Stream->ApiSendRequestLock);
@@ -274,6 +291,7 @@ QuicStreamStart(
 
     Stream->Flags.Started = TRUE;
     Stream->Flags.IndicatePeerAccepted = !!(Flags & QUIC_STREAM_START_FLAG_INDICATE_PEER_ACCEPT);
+    QuicQlogStreamState(Stream, QUIC_QLOG_STREAM_STATE_OPEN);
 
     //
     // Cache flow blocked timings on connection so that the queried blocked timings only
@@ -323,6 +341,7 @@ QuicStreamStart(
             FALSE);
     }
 
+    QuicStreamSetFcSummaryRemove(&Stream->Connection->Streams, Stream);
     Stream->MaxAllowedSendOffset =
         QuicStreamGetInitialMaxDataFromTP(
             Stream->ID,
@@ -332,6 +351,7 @@ QuicStreamStart(
         QuicStreamAddOutFlowBlockedReason(Stream, QUIC_FLOW_BLOCKED_STREAM_FLOW_CONTROL);
     }
     Stream->SendWindow = (uint32_t)CXPLAT_MIN(Stream->MaxAllowedSendOffset, UINT32_MAX);
+    QuicStreamSetFcSummaryAdd(&Stream->Connection->Streams, Stream);
 
 Exit:
 
@@ -407,6 +427,22 @@ QuicStreamTraceRundown(
     // TODO - More state dump.
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamHibernate(
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    //
+    // Fall back to the initial receive buffer size if everything received so
+    // far was delivered. The buffer grows again on the next write.
+    //
+    (void)QuicRecvBufferShrink(
+        &Stream->RecvBuffer,
+        Stream->Connection->Settings.StreamRecvBufferDefault);
+    QuicRangeCompact(&Stream->SparseAckRanges);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicStreamIndicateEvent(
@@ -430,11 +466,19 @@ QuicStreamIndicateEvent(
             Stream->Connection->State.HandleClosed ||
             Stream->Flags.HandleClosed ||
             Event->Type == QUIC_STREAM_EVENT_START_COMPLETE);
+        QUIC_WORKER* Worker = Stream->Connection->Worker;
+        const QUIC_WORKER_ACTIVITY_TYPE PrevActivity =
+            QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_APP_CALLBACK);
+        const uint32_t EventType = Event->Type;
+        const uint64_t StartTime = QuicLibraryCallbackStart();
         Status =
             Stream->ClientCallbackHandler(
                 (HQUIC)Stream,
                 Stream->ClientContext,
                 Event);
+        QuicLibraryCallbackComplete(
+            Stream->Connection->Partition, QUIC_CALLBACK_STREAM, EventType, StartTime);
+        QuicWorkerSetActivity(Worker, PrevActivity);
     } else {
         Status = QUIC_STATUS_INVALID_STATE;
     }
@@ -471,6 +515,7 @@ QuicStreamIndicateShutdownComplete(
 {
     if (!Stream->Flags.HandleShutdown) {
         Stream->Flags.HandleShutdown = TRUE;
+        QuicQlogStreamState(Stream, QUIC_QLOG_STREAM_STATE_CLOSED);
 
         QUIC_STREAM_EVENT Event;
         Event.Type = QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE;
@@ -618,6 +663,66 @@ QuicStreamParamSet(
         break;
     }
 
+    case QUIC_PARAM_STREAM_URGENCY: {
+
+        if (BufferLength != sizeof(QUIC_STREAM_URGENCY) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_STREAM_URGENCY* Urgency = (const QUIC_STREAM_URGENCY*)Buffer;
+        if (Urgency->Urgency >= QUIC_STREAM_URGENCY_COUNT) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Stream->SendUrgency = Urgency->Urgency;
+        Stream->SendIncremental = !!Urgency->Incremental;
+        Stream->SendWeight =
+            Urgency->Weight != 0 ? Urgency->Weight : QUIC_STREAM_SEND_BATCH_COUNT;
+
+        if (Stream->Flags.Started && Stream->SendFlags != 0) {
+            //
+            // Update the stream's place in the send queue if necessary.
+            //
+            QuicSendUpdateStreamPriority(&Stream->Connection->Send, Stream);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_STREAM_RECEIVE_BATCHING: {
+
+        if (BufferLength != sizeof(QUIC_STREAM_RECEIVE_BATCHING) || Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        const QUIC_STREAM_RECEIVE_BATCHING* Batching =
+            (const QUIC_STREAM_RECEIVE_BATCHING*)Buffer;
+        if (Batching->TimeoutUs > QUIC_MAX_STREAM_RECV_BATCH_TIMEOUT_US) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        Stream->RecvBatchThreshold = Batching->Threshold;
+        Stream->RecvBatchTimeoutUs =
+            Batching->TimeoutUs != 0 ?
+                Batching->TimeoutUs : QUIC_DEFAULT_STREAM_RECV_BATCH_TIMEOUT_US;
+
+        if (Stream->RecvBatchLink.Flink != NULL && Stream->RecvBatchThreshold == 0) {
+            //
+            // Deliver whatever was being held back.
+            //
+            QuicStreamSetRecvBatchRemove(&Stream->Connection->Streams, Stream);
+            QuicStreamRecvQueueFlush(Stream, FALSE);
+        }
+
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
    case QUIC_PARAM_STREAM_RELIABLE_OFFSET:
 
         if (BufferLength != sizeof(uint64_t) || Buffer == NULL) {
@@ -769,6 +874,51 @@ QuicStreamParamGet(
         Status = QUIC_STATUS_SUCCESS;
         break;
 
+    case QUIC_PARAM_STREAM_URGENCY: {
+
+        if (*BufferLength < sizeof(QUIC_STREAM_URGENCY)) {
+            *BufferLength = sizeof(QUIC_STREAM_URGENCY);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QUIC_STREAM_URGENCY* Urgency = (QUIC_STREAM_URGENCY*)Buffer;
+        Urgency->Urgency = Stream->SendUrgency;
+        Urgency->Incremental = Stream->SendIncremental;
+        Urgency->Weight = Stream->SendWeight;
+
+        *BufferLength = sizeof(QUIC_STREAM_URGENCY);
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
+    case QUIC_PARAM_STREAM_RECEIVE_BATCHING: {
+
+        if (*BufferLength < sizeof(QUIC_STREAM_RECEIVE_BATCHING)) {
+            *BufferLength = sizeof(QUIC_STREAM_RECEIVE_BATCHING);
+            Status = QUIC_STATUS_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        if (Buffer == NULL) {
+            Status = QUIC_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        QUIC_STREAM_RECEIVE_BATCHING* Batching = (QUIC_STREAM_RECEIVE_BATCHING*)Buffer;
+        Batching->Threshold = Stream->RecvBatchThreshold;
+        Batching->TimeoutUs = Stream->RecvBatchTimeoutUs;
+
+        *BufferLength = sizeof(QUIC_STREAM_RECEIVE_BATCHING);
+        Status = QUIC_STATUS_SUCCESS;
+        break;
+    }
+
     case QUIC_PARAM_STREAM_STATISTICS: {
 
         if (*BufferLength < sizeof(QUIC_STREAM_STATISTICS)) {
@@ -904,6 +1054,10 @@ QuicStreamSwitchToAppOwnedBuffers(
     //
     // Reset the current receive buffer
     //
+    QuicStreamReleaseHeldRecvPackets(
+        Stream,
+        Stream->RecvBuffer.DatapathChunkCount,
+        Stream->RecvBuffer.DatapathChunkBytes);
     QuicRecvBufferUninitialize(&Stream->RecvBuffer);
 
     //
@@ -914,6 +1068,7 @@ QuicStreamSwitchToAppOwnedBuffers(
         0,
         InitialControlFlow,
         QUIC_RECV_BUF_MODE_APP_OWNED,
+        NULL,
         NULL);
     Stream->Flags.UseAppOwnedRecvBuffers = TRUE;
 }
@@ -927,6 +1082,8 @@ QuicStreamProvideRecvBuffers(
 {
     QUIC_STATUS Status = QuicRecvBufferProvideChunks(&Stream->RecvBuffer, Chunks);
     if (Status == QUIC_STATUS_SUCCESS) {
+        Stream->Connection->State.AppOwnedRecvBuffersUsed = TRUE;
+
         //
         // Update the maximum allowed received offset if the new chunks caused an update of the
         // virtual buffer size.
@@ -43,9 +43,23 @@ typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 //
 #define QUIC_SEND_FLAG_BUFFERED     ((QUIC_SEND_FLAGS)0x80000000)
 
+//
+// The request's only buffer is a file range mapped by StreamSendFile, owned by
+// a QUIC_SEND_FILE.
+//
+#define QUIC_SEND_FLAG_FILE         ((QUIC_SEND_FLAGS)0x40000000)
+
+//
+// The datagram priority class, for datagram send requests.
+//
+#define QUIC_SEND_FLAG_DGRAM_CLASS_SHIFT 28
+#define QUIC_SEND_FLAG_DGRAM_CLASS  ((QUIC_SEND_FLAGS)0x30000000)
+
 #define QUIC_SEND_FLAGS_INTERNAL \
 ( \
-    QUIC_SEND_FLAG_BUFFERED \
+    QUIC_SEND_FLAG_BUFFERED | \
+    QUIC_SEND_FLAG_FILE | \
+    QUIC_SEND_FLAG_DGRAM_CLASS \
 )
 
 #define QUIC_STREAM_PRIORITY_DEFAULT 0x7FFF // Medium priority by default
@@ -76,10 +90,18 @@ typedef struct QUIC_SEND_REQUEST {
     //
     QUIC_SEND_FLAGS Flags;
 
-    //
-    // The starting stream offset.
-    //
-    uint64_t StreamOffset;
+    union {
+        //
+        // The starting stream offset.
+        //
+        uint64_t StreamOffset;
+
+        //
+        // For datagrams, the time (in microseconds) after which the request is
+        // dropped instead of sent. Zero if there is no deadline.
+        //
+        uint64_t DeadlineUs;
+    };
 
     //
     // The length of all the Buffers.
@@ -98,6 +120,21 @@ typedef struct QUIC_SEND_REQUEST {
 
 } QUIC_SEND_REQUEST;
 
+//
+// A file range queued by StreamSendFile, kept mapped until its send request
+// completes.
+//
+typedef struct QUIC_SEND_FILE {
+
+    CXPLAT_FILE_RANGE Range;
+
+    //
+    // The send request's buffer, pointing into the mapping.
+    //
+    QUIC_BUFFER Buffer;
+
+} QUIC_SEND_FILE;
+
 //
 // Different flags of a stream.
 // Note - Keep quictypes.h's copy up to date.
@@ -138,6 +175,7 @@ typedef union QUIC_STREAM_FLAGS {
         BOOLEAN SendEnabled             : 1;    // Application is allowed to send data.
         BOOLEAN ReceiveEnabled          : 1;    // Application is ready for receive callbacks.
         BOOLEAN ReceiveMultiple         : 1;    // The app supports multiple parallel receive indications.
+        BOOLEAN ReceiveZeroCopy         : 1;    // In-order data may be indicated in place in datapath buffers.
         BOOLEAN UseAppOwnedRecvBuffers  : 1;    // The stream is using app provided receive buffers.
         BOOLEAN ReceiveFlushQueued      : 1;    // The receive flush operation is queued.
         BOOLEAN ReceiveDataPending      : 1;    // Data (or FIN) is queued and ready for delivery.
@@ -203,6 +241,11 @@ typedef enum QUIC_STREAM_REF {
 //
 // This structure represents all the per connection specific data.
 //
+// Fields are grouped by how often they are touched: the state the send path
+// checks for every scheduled stream comes first (the first two cache lines,
+// see the asserts below), then the rest of the send and receive state, with
+// the state only used during setup, shutdown or for diagnostics at the end.
+//
 typedef struct QUIC_STREAM {
 
 #ifdef __cplusplus
@@ -212,100 +255,83 @@ typedef struct QUIC_STREAM {
 #endif
 
     //
-    // Number of references to the handle.
+    // Hot Send State
     //
-    CXPLAT_REF_COUNT RefCount;
 
-#if DEBUG
     //
-    // Detailed ref counts.
-    // Note: These ref counts are biased by 1, so lowest they go is 1. It is an
-    // error for them to ever be zero.
+    // The parent connection for this stream.
     //
-    CXPLAT_REF_COUNT RefTypeBiasedCount[QUIC_STREAM_REF_COUNT];
-#endif
+    QUIC_CONNECTION* Connection;
 
     //
-    // Number of outstanding sent metadata items currently being tracked for
-    // this stream.
+    // Set of Send flags indicating data is ready to be sent.
     //
-    uint32_t OutstandingSentMetadata;
+    uint16_t SendFlags;
 
     //
-    // Linkage in the stream set
+    // Set of current reasons sending more packets is currently blocked.
     //
-    union {
-        //
-        // Link in the hash-table when the stream is open.
-        //
-        CXPLAT_HASHTABLE_ENTRY TableEntry;
-
-        //
-        // Link in the waiting list when the stream if waiting for stream
-        // id flow control.
-        //
-        CXPLAT_LIST_ENTRY WaitingLink;
-
-        //
-        // Link in the closed list when closed and waiting for clean up.
-        //
-        CXPLAT_LIST_ENTRY ClosedLink;
-    };
+    uint8_t OutFlowBlockedReasons; // Set of QUIC_FLOW_BLOCKED_* flags
 
     //
-    // The list entry in the output module's send list.
+    // The urgency level (0 is most urgent), whether the stream interleaves
+    // with others of the same urgency, and how many packets it gets per round
+    // robin turn. Only used by the urgency scheduling scheme.
     //
-    CXPLAT_LIST_ENTRY SendLink;
+    uint8_t SendUrgency;
 
-#if DEBUG
     //
-    // The list entry in the stream set's list of all allocated streams.
+    // The relative priority between the different streams that determines the
+    // order that queued data will be sent out.
     //
-    CXPLAT_LIST_ENTRY AllStreamsLink;
+    uint16_t SendPriority;
+
+    BOOLEAN SendIncremental;
+    uint8_t SendWeight;
 
     //
-    // The list entry in the global stream tracker list.
+    // Recovery window
     //
-    CXPLAT_LIST_ENTRY DbgObjectLink;
-#endif
+    uint64_t RecoveryNextOffset;
+    uint64_t RecoveryEndOffset;
+
+    #define RECOV_WINDOW_OPEN(S) ((S)->RecoveryNextOffset < (S)->RecoveryEndOffset)
 
     //
-    // The parent connection for this stream.
+    // The next offset we will start sending at.
     //
-    QUIC_CONNECTION* Connection;
+    uint64_t NextSendOffset;
 
     //
-    // The identifier for this stream.
+    // The total send offset for all queued send requests.
     //
-    uint64_t ID;
+    uint64_t QueuedSendOffset;
 
     //
-    // The current flags for this stream.
+    // The max allowed send offset according to per-stream flow control.
     //
-    QUIC_STREAM_FLAGS Flags;
-
+    uint64_t MaxAllowedSendOffset;
 
     //
-    // Set of Send flags indicating data is ready to be sent.
+    // The current flags for this stream.
     //
-    uint16_t SendFlags;
+    QUIC_STREAM_FLAGS Flags;
 
     //
-    // Set of current reasons sending more packets is currently blocked.
+    // The identifier for this stream.
     //
-    uint8_t OutFlowBlockedReasons; // Set of QUIC_FLOW_BLOCKED_* flags
+    uint64_t ID;
 
     //
-    // Send State
+    // The smallest offset for unacknowledged send data. This variable is
+    // similar to RFC793 SND.UNA.
     //
+    uint64_t UnAckedOffset;
 
     //
-    // API calls to StreamSend queue the send request here and then queue the
-    // send operation. That operation moves the send request onto the
-    // SendRequests list.
+    // The length of bytes that have been sent at least once.
     //
-    CXPLAT_DISPATCH_LOCK ApiSendRequestLock;
-    QUIC_SEND_REQUEST* ApiSendRequests;
+    uint64_t MaxSentLength;
 
     //
     // Queued send requests.
@@ -319,26 +345,29 @@ typedef struct QUIC_STREAM {
     QUIC_SEND_REQUEST* SendBookmark;
 
     //
-    // Shortcut pointer: NULL, or the next unbuffered send request.
+    // Send State
     //
-    QUIC_SEND_REQUEST* SendBufferBookmark;
 
     //
-    // The total send offset for all queued send requests.
+    // The list entry in the output module's send list.
     //
-    uint64_t QueuedSendOffset;
+    CXPLAT_LIST_ENTRY SendLink;
 
     //
-    // The contiguous length of queued 0RTT-permitted data, and the
-    // amount of data that was actually sent 0RTT.
+    // Number of references to the handle.
     //
-    uint64_t Queued0Rtt;
-    uint64_t Sent0Rtt;
+    CXPLAT_REF_COUNT RefCount;
 
     //
-    // The max allowed send offset according to per-stream flow control.
+    // Shortcut pointer: NULL, or the next unbuffered send request.
     //
-    uint64_t MaxAllowedSendOffset;
+    QUIC_SEND_REQUEST* SendBufferBookmark;
+
+    //
+    // Number of outstanding sent metadata items currently being tracked for
+    // this stream.
+    //
+    uint32_t OutstandingSentMetadata;
 
     //
     // Estimate of the peer's flow control window.
@@ -351,50 +380,39 @@ typedef struct QUIC_STREAM {
     uint64_t LastIdealSendBuffer;
 
     //
-    // The length of bytes that have been sent at least once.
-    //
-    uint64_t MaxSentLength;
-
-    //
-    // The smallest offset for unacknowledged send data. This variable is
-    // similar to RFC793 SND.UNA.
-    //
-    uint64_t UnAckedOffset;
-
-    //
-    // The next offset we will start sending at.
-    //
-    uint64_t NextSendOffset;
-
-    //
-    // Recovery window
+    // Linkage in the stream set
     //
-    uint64_t RecoveryNextOffset;
-    uint64_t RecoveryEndOffset;
+    union {
+        //
+        // Link in the hash-table when the stream is open.
+        //
+        CXPLAT_HASHTABLE_ENTRY TableEntry;
 
-    //
-    // If > 0, bytes up to offset must be re-transmitted and ACK'd from peer before we can abort this stream.
-    //
-    uint64_t ReliableOffsetSend;
+        //
+        // Link in the waiting list when the stream if waiting for stream
+        // id flow control.
+        //
+        CXPLAT_LIST_ENTRY WaitingLink;
 
-    #define RECOV_WINDOW_OPEN(S) ((S)->RecoveryNextOffset < (S)->RecoveryEndOffset)
+        //
+        // Link in the closed list when closed and waiting for clean up.
+        //
+        CXPLAT_LIST_ENTRY ClosedLink;
+    };
 
     //
-    // The error code for why the send path was shutdown.
+    // API calls to StreamSend queue the send request here and then queue the
+    // send operation. That operation moves the send request onto the
+    // SendRequests list. Kept together since they're written by app threads.
     //
-    QUIC_VAR_INT SendShutdownErrorCode;
+    CXPLAT_DISPATCH_LOCK ApiSendRequestLock;
+    QUIC_SEND_REQUEST* ApiSendRequests;
 
     //
     // The ACK ranges greater than 'UnAckedOffset', with holes between them.
     //
     QUIC_RANGE SparseAckRanges;
 
-    //
-    // The relative priority between the different streams that determines the
-    // order that queued data will be sent out.
-    //
-    uint16_t SendPriority;
-
     //
     // Recv State
     //
@@ -418,24 +436,29 @@ typedef struct QUIC_STREAM {
     uint64_t RecvWindowLastUpdate;
 
     //
-    // The structure for tracking received buffers.
+    // Maximum allowed inbound byte offset, established when the FIN is received.
     //
-    QUIC_RECV_BUFFER RecvBuffer;
+    uint64_t RecvMaxLength;
 
     //
-    // The maximum length of 0-RTT secured payload received.
+    // The number of bytes that are currently outstanding up to the app.
     //
-    uint64_t RecvMax0RttLength;
+    uint64_t RecvPendingLength;
 
     //
-    // Maximum allowed inbound byte offset, established when the FIN is received.
+    // Receive indications are held back until RecvBatchThreshold bytes are
+    // ready to be read, the FIN arrives or RecvBatchTimeoutUs passes. A zero
+    // threshold indicates data as soon as it arrives.
     //
-    uint64_t RecvMaxLength;
+    uint32_t RecvBatchThreshold;
+    uint32_t RecvBatchTimeoutUs;
 
     //
-    // The number of bytes that are currently outstanding up to the app.
+    // When a held back receive indication is due. Only valid while the stream
+    // is in the stream set's RecvBatchStreams list.
     //
-    uint64_t RecvPendingLength;
+    uint64_t RecvBatchDeadline;
+    CXPLAT_LIST_ENTRY RecvBatchLink;
 
     //
     // The number of received bytes the app has completed but not yet processed
@@ -447,11 +470,6 @@ typedef struct QUIC_STREAM {
     //
     volatile uint64_t RecvCompletionLength;
 
-    //
-    // The error code for why the receive path was shutdown.
-    //
-    QUIC_VAR_INT RecvShutdownErrorCode;
-
     //
     // The handler for the API client's callbacks.
     //
@@ -461,6 +479,46 @@ typedef struct QUIC_STREAM {
     // Preallocated operation for receive complete
     //
     QUIC_OPERATION* ReceiveCompleteOperation;
+
+    //
+    // The structure for tracking received buffers.
+    //
+    QUIC_RECV_BUFFER RecvBuffer;
+
+    //
+    // Cold State
+    //
+
+    //
+    // The contiguous length of queued 0RTT-permitted data, and the
+    // amount of data that was actually sent 0RTT.
+    //
+    uint64_t Queued0Rtt;
+    uint64_t Sent0Rtt;
+
+    //
+    // The maximum length of 0-RTT secured payload received.
+    //
+    uint64_t RecvMax0RttLength;
+
+    //
+    // If > 0, bytes up to offset must be re-transmitted and ACK'd from peer before we can abort this stream.
+    //
+    uint64_t ReliableOffsetSend;
+
+    //
+    // The error code for why the send path was shutdown.
+    //
+    QUIC_VAR_INT SendShutdownErrorCode;
+
+    //
+    // The error code for why the receive path was shutdown.
+    //
+    QUIC_VAR_INT RecvShutdownErrorCode;
+
+    //
+    // Storage for ReceiveCompleteOperation.
+    //
     QUIC_OPERATION ReceiveCompleteOperationStorage;
     QUIC_API_CONTEXT ReceiveCompleteApiCtxStorage;
 
@@ -477,8 +535,39 @@ typedef struct QUIC_STREAM {
         uint64_t CachedConnCongestionControlUs;
         uint64_t CachedConnFlowControlUs;
     } BlockedTimings;
+
+#if DEBUG
+    //
+    // Detailed ref counts.
+    // Note: These ref counts are biased by 1, so lowest they go is 1. It is an
+    // error for them to ever be zero.
+    //
+    CXPLAT_REF_COUNT RefTypeBiasedCount[QUIC_STREAM_REF_COUNT];
+
+    //
+    // The list entry in the stream set's list of all allocated streams.
+    //
+    CXPLAT_LIST_ENTRY AllStreamsLink;
+
+    //
+    // The list entry in the global stream tracker list.
+    //
+    CXPLAT_LIST_ENTRY DbgObjectLink;
+#endif
+
 } QUIC_STREAM;
 
+//
+// QuicStreamSendCanWriteDataFrames, called for every scheduled stream, should
+// only need the first cache line, and the rest of the send loop the second.
+//
+CXPLAT_STATIC_ASSERT(
+    CXPLAT_STRUCT_SIZE_THRU_FIELD(QUIC_STREAM, QueuedSendOffset) <= QUIC_CACHE_LINE_SIZE,
+    "Send scheduling state must stay in the first cache line");
+CXPLAT_STATIC_ASSERT(
+    CXPLAT_STRUCT_SIZE_THRU_FIELD(QUIC_STREAM, SendBookmark) <= 2 * QUIC_CACHE_LINE_SIZE,
+    "Hot send state must stay in the first two cache lines");
+
 //
 // There is an active receive to the app
 //
@@ -635,6 +724,16 @@ QuicStreamTraceRundown(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Releases the memory an idle stream doesn't currently need. It is allocated
+// again as needed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamHibernate(
+    _In_ QUIC_STREAM* Stream
+    );
+
 //
 // Indicates an event to the application layer.
 //
@@ -893,6 +992,19 @@ QuicStreamSendFlush(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Completes (indicates and frees) a send request. PreviouslyPosted is TRUE if
+// the request was enqueued on the stream (and counted as posted bytes).
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamCompleteSendRequest(
+    _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_SEND_REQUEST* SendRequest,
+    _In_ BOOLEAN Canceled,
+    _In_ BOOLEAN PreviouslyPosted
+    );
+
 //
 // Copies the bytes of a send request and completes it early.
 //
@@ -997,6 +1109,17 @@ QuicStreamReceiveCompletePending(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Queues a FLUSH_STREAM_RECV if there is data to indicate to the app, or
+// indicates it inline if allowed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamRecvQueueFlush(
+    _In_ QUIC_STREAM* Stream,
+    _In_ BOOLEAN AllowInlineFlush
+    );
+
 //
 // Processes a received frame for the given stream.
 //
@@ -1022,6 +1145,18 @@ QuicStreamRecvFlush(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Removes packets the stream's receive buffer no longer holds from the
+// connection's count of held receive packets.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicStreamReleaseHeldRecvPackets(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint32_t PacketCount,
+    _In_ uint32_t PacketBytes
+    );
+
 //
 // Enables or disables receive callbacks for the stream.
 //
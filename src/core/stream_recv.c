@@ -318,6 +318,7 @@ _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicStreamProcessStreamFrame(
     _In_ QUIC_STREAM* Stream,
+    _In_ QUIC_RX_PACKET* Packet,
     _In_ BOOLEAN EncryptedWith0Rtt,
     _In_ const QUIC_STREAM_EX* Frame
     )
@@ -409,20 +410,69 @@ QuicStreamProcessStreamFrame(
         uint64_t QuotaConsumed = 0;
         uint64_t BufferSizeNeeded = 0;
 
-        //
-        // Write any nonduplicate data to the receive buffer.
-        // QuicRecvBufferWrite will indicate if there is data to deliver.
-        //
-        Status =
-            QuicRecvBufferWrite(
+        QUIC_STREAM_EX DirectFrame;
+        if (Packet->DecryptedToStream &&
+            EndOffset > Stream->RecvBuffer.BaseOffset) {
+            //
+            // The payload was decrypted straight into the app-owned buffer,
+            // so point the frame at it there, skipping anything since drained.
+            //
+            CXPLAT_DBG_ASSERT(Stream->Flags.UseAppOwnedRecvBuffers);
+            DirectFrame = *Frame;
+            if (DirectFrame.Offset < Stream->RecvBuffer.BaseOffset) {
+                DirectFrame.Length -= Stream->RecvBuffer.BaseOffset - DirectFrame.Offset;
+                DirectFrame.Offset = Stream->RecvBuffer.BaseOffset;
+            }
+            DirectFrame.Data =
+                QuicRecvBufferGetDirectWrite(
+                    &Stream->RecvBuffer,
+                    DirectFrame.Offset,
+                    (uint32_t)DirectFrame.Length);
+            CXPLAT_DBG_ASSERT(DirectFrame.Data != NULL);
+            Frame = &DirectFrame;
+        }
+
+        QUIC_CONNECTION* Connection = Stream->Connection;
+        if (Stream->Flags.ReceiveZeroCopy &&
+            Packet->IsShortHeader &&
+            Connection->HeldRecvPacketCount < QUIC_MAX_CONN_HELD_RECV_PACKETS &&
+            Connection->HeldRecvPacketBytes + Packet->BufferLength <=
+                QUIC_MAX_CONN_HELD_RECV_BYTES &&
+            QuicRecvBufferWriteReference(
                 &Stream->RecvBuffer,
                 Frame->Offset,
                 (uint16_t)Frame->Length,
                 Frame->Data,
+                Packet,
+                &Connection->Partition->AppBufferChunkPool,
                 FlowControlQuota,
                 &QuotaConsumed,
-                &ReadyToDeliver,
-                &BufferSizeNeeded);
+                &ReadyToDeliver)) {
+            //
+            // The in-order data is indicated to the app in place, and the
+            // packet is held until the app completes the receive.
+            //
+            Status = QUIC_STATUS_SUCCESS;
+            InterlockedIncrement64(&Connection->HeldRecvPacketCount);
+            InterlockedExchangeAdd64(
+                &Connection->HeldRecvPacketBytes, Packet->BufferLength);
+
+        } else {
+            //
+            // Write any nonduplicate data to the receive buffer.
+            // QuicRecvBufferWrite will indicate if there is data to deliver.
+            //
+            Status =
+                QuicRecvBufferWrite(
+                    &Stream->RecvBuffer,
+                    Frame->Offset,
+                    (uint16_t)Frame->Length,
+                    Frame->Data,
+                    FlowControlQuota,
+                    &QuotaConsumed,
+                    &ReadyToDeliver,
+                    &BufferSizeNeeded);
+        }
 
         if (BufferSizeNeeded > 0 && Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_APP_OWNED) {
             CXPLAT_DBG_ASSERT(Status == QUIC_STATUS_BUFFER_TOO_SMALL);
@@ -497,9 +547,11 @@ QuicStreamProcessStreamFrame(
         (Stream->RecvBuffer.RecvMode == QUIC_RECV_BUF_MODE_MULTIPLE ||
          Stream->RecvBuffer.ReadPendingLength == 0)) {
         Stream->Flags.ReceiveDataPending = TRUE;
-        QuicStreamRecvQueueFlush(
-            Stream,
-            Stream->RecvBuffer.BaseOffset == Stream->RecvMaxLength);
+        if (!QuicStreamSetRecvBatchHold(&Stream->Connection->Streams, Stream)) {
+            QuicStreamRecvQueueFlush(
+                Stream,
+                Stream->RecvBuffer.BaseOffset == Stream->RecvMaxLength);
+        }
     }
 
 
@@ -565,6 +617,7 @@ QuicStreamRecv(
         }
 
         if (Stream->MaxAllowedSendOffset < Frame.MaximumData) {
+            QuicStreamSetFcSummaryRemove(&Stream->Connection->Streams, Stream);
             Stream->MaxAllowedSendOffset = Frame.MaximumData;
             *UpdatedFlowControl = TRUE;
 
@@ -581,6 +634,7 @@ QuicStreamRecv(
             //
             Stream->SendWindow =
                 (uint32_t)CXPLAT_MIN(Stream->MaxAllowedSendOffset - Stream->UnAckedOffset, UINT32_MAX);
+            QuicStreamSetFcSummaryAdd(&Stream->Connection->Streams, Stream);
 
             QuicSendBufferStreamAdjust(Stream);
 
@@ -643,7 +697,7 @@ QuicStreamRecv(
 
         Status =
             QuicStreamProcessStreamFrame(
-                Stream, Packet->EncryptedWith0Rtt, &Frame);
+                Stream, Packet, Packet->EncryptedWith0Rtt, &Frame);
 
         break;
     }
@@ -653,6 +707,75 @@ QuicStreamRecv(
     return Status;
 }
 
+//
+// Accounts for bytes delivered to the app on any stream, advancing the
+// connection-wide flow control limit and auto-tuning its window.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+void
+QuicConnOnBytesDelivered(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t BytesDelivered
+    )
+{
+    QUIC_SEND* Send = &Connection->Send;
+    Send->MaxData += BytesDelivered;
+
+    const uint64_t DrainThreshold =
+        Send->ConnFlowControlWindow / QUIC_RECV_BUFFER_DRAIN_RATIO;
+
+    Send->OrderedStreamBytesDeliveredAccumulator += BytesDelivered;
+    if (Send->OrderedStreamBytesDeliveredAccumulator < DrainThreshold) {
+        return;
+    }
+
+    if (QuicLibraryGetMemoryPressure() >= QUIC_MEMORY_PRESSURE_SHRINK_RECV_WINDOWS) {
+        //
+        // Under memory pressure, don't grow the window, and shrink an
+        // auto-tuned window back toward the configured one by withholding
+        // credit for part of what was just delivered.
+        //
+        const uint64_t Excess =
+            Send->ConnFlowControlWindow > Connection->Settings.ConnFlowControlWindow ?
+                Send->ConnFlowControlWindow - Connection->Settings.ConnFlowControlWindow : 0;
+        const uint64_t Withheld = CXPLAT_MIN(BytesDelivered, Excess);
+        Send->MaxData -= Withheld;
+        Send->ConnFlowControlWindow -= Withheld;
+        Send->ConnFlowControlWindowLastUpdate = CxPlatTimeUs64();
+        Send->OrderedStreamBytesDeliveredAccumulator = 0;
+        QuicSendSetSendFlag(Send, QUIC_CONN_SEND_FLAG_MAX_DATA);
+        return;
+    }
+
+    //
+    // Window tuning, the same as for stream receive buffers: if at least
+    // (1 / QUIC_RECV_BUFFER_DRAIN_RATIO) of the window was delivered within
+    // an RTT, the window is what limits throughput, so double it (up to the
+    // cap) and advertise the extra credit right away.
+    //
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    const uint64_t MaxWindow =
+        CXPLAT_MAX(
+            (uint64_t)Connection->Settings.ConnFlowControlWindow,
+            QUIC_MAX_AUTO_TUNED_CONN_FLOW_CONTROL_WINDOW);
+    if (DrainThreshold != 0 && Send->ConnFlowControlWindow < MaxWindow) {
+        const uint64_t TimeThreshold =
+            (Send->OrderedStreamBytesDeliveredAccumulator * Connection->Paths[0].SmoothedRtt) /
+            DrainThreshold;
+        if (CxPlatTimeDiff64(Send->ConnFlowControlWindowLastUpdate, TimeNow) <= TimeThreshold) {
+            const uint64_t NewWindow =
+                CXPLAT_MIN(Send->ConnFlowControlWindow * 2, MaxWindow);
+            Send->MaxData += NewWindow - Send->ConnFlowControlWindow;
+            Send->ConnFlowControlWindow = NewWindow;
+        }
+    }
+
+    Send->ConnFlowControlWindowLastUpdate = TimeNow;
+    Send->OrderedStreamBytesDeliveredAccumulator = 0;
+    QuicSendSetSendFlag(Send, QUIC_CONN_SEND_FLAG_MAX_DATA);
+}
+
 //
 // Criteria for sending MAX_DATA/MAX_STREAM_DATA frames:
 //
@@ -675,16 +798,7 @@ QuicStreamOnBytesDelivered(
         Stream->RecvBuffer.VirtualBufferLength / QUIC_RECV_BUFFER_DRAIN_RATIO;
 
     Stream->RecvWindowBytesDelivered += BytesDelivered;
-    Stream->Connection->Send.MaxData += BytesDelivered;
-
-    Stream->Connection->Send.OrderedStreamBytesDeliveredAccumulator += BytesDelivered;
-    if (Stream->Connection->Send.OrderedStreamBytesDeliveredAccumulator >=
-        Stream->Connection->Settings.ConnFlowControlWindow / QUIC_RECV_BUFFER_DRAIN_RATIO) {
-        Stream->Connection->Send.OrderedStreamBytesDeliveredAccumulator = 0;
-        QuicSendSetSendFlag(
-            &Stream->Connection->Send,
-            QUIC_CONN_SEND_FLAG_MAX_DATA);
-    }
+    QuicConnOnBytesDelivered(Stream->Connection, BytesDelivered);
 
     if (Stream->RecvWindowBytesDelivered >= RecvBufferDrainThreshold) {
 
@@ -695,8 +809,11 @@ QuicStreamOnBytesDelivered(
         // When using app-owned buffers, skip this: the virtual buffer length is entirely based
         // on the amount of buffer space provided by the app.
         //
+        // Under memory pressure, don't grow the stream window at all.
+        //
         if (Stream->RecvBuffer.VirtualBufferLength != 0 &&
-            Stream->RecvBuffer.VirtualBufferLength < Stream->Connection->Settings.ConnFlowControlWindow) {
+            Stream->RecvBuffer.VirtualBufferLength < Stream->Connection->Send.ConnFlowControlWindow &&
+            QuicLibraryGetMemoryPressure() < QUIC_MEMORY_PRESSURE_SHRINK_RECV_WINDOWS) {
 
             uint64_t TimeThreshold =
                 ((Stream->RecvWindowBytesDelivered * Stream->Connection->Paths[0].SmoothedRtt) / RecvBufferDrainThreshold);
@@ -769,6 +886,7 @@ QuicStreamRecvFlush(
     )
 {
     Stream->Flags.ReceiveFlushQueued = FALSE;
+    QuicStreamSetRecvBatchRemove(&Stream->Connection->Streams, Stream);
 
     if (!Stream->Flags.ReceiveDataPending) {
         //
@@ -930,6 +1048,21 @@ QuicStreamRecvFlush(
     }
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+QuicStreamReleaseHeldRecvPackets(
+    _In_ QUIC_STREAM* Stream,
+    _In_ uint32_t PacketCount,
+    _In_ uint32_t PacketBytes
+    )
+{
+    QUIC_CONNECTION* Connection = Stream->Connection;
+    InterlockedExchangeAdd64(&Connection->HeldRecvPacketCount, -(int64_t)PacketCount);
+    InterlockedExchangeAdd64(&Connection->HeldRecvPacketBytes, -(int64_t)PacketBytes);
+    CXPLAT_DBG_ASSERT(Connection->HeldRecvPacketCount >= 0);
+    CXPLAT_DBG_ASSERT(Connection->HeldRecvPacketBytes >= 0);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamReceiveCompletePending(
@@ -977,10 +1110,18 @@ QuicStreamReceiveComplete(
     //
     // Reclaim any buffer space comsumed by the app.
     //
+    const uint32_t HeldPacketCount = Stream->RecvBuffer.DatapathChunkCount;
+    const uint32_t HeldPacketBytes = Stream->RecvBuffer.DatapathChunkBytes;
     if (Stream->RecvPendingLength == 0 ||
         QuicRecvBufferDrain(&Stream->RecvBuffer, BufferLength)) {
         Stream->Flags.ReceiveDataPending = FALSE; // No more pending data to deliver.
     }
+    if (HeldPacketCount != Stream->RecvBuffer.DatapathChunkCount) {
+        QuicStreamReleaseHeldRecvPackets(
+            Stream,
+            HeldPacketCount - Stream->RecvBuffer.DatapathChunkCount,
+            HeldPacketBytes - Stream->RecvBuffer.DatapathChunkBytes);
+    }
 
     if (BufferLength != 0) {
         Stream->RecvPendingLength -= BufferLength;
@@ -35,16 +35,6 @@ Abstract:
 
 #include "precomp.h"
 
-
-_IRQL_requires_max_(PASSIVE_LEVEL)
-void
-QuicStreamCompleteSendRequest(
-    _In_ QUIC_STREAM* Stream,
-    _In_ QUIC_SEND_REQUEST* SendRequest,
-    _In_ BOOLEAN Canceled,
-    _In_ BOOLEAN PreviouslyPosted
-    );
-
 //
 // Enqueues a SendRequest from the temporary queue to the actual queue.
 //
@@ -95,6 +85,7 @@ QuicStreamIndicateSendShutdownComplete(
 
     if (!Stream->Flags.HandleSendShutdown) {
         Stream->Flags.HandleSendShutdown = TRUE;
+        QuicQlogStreamState(Stream, QUIC_QLOG_STREAM_STATE_SEND_CLOSED);
 
         QUIC_STREAM_EVENT Event;
         Event.Type = QUIC_STREAM_EVENT_SEND_SHUTDOWN_COMPLETE;
@@ -422,6 +413,13 @@ QuicStreamCompleteSendRequest(
         QuicStreamIndicateStartComplete(Stream, QUIC_STATUS_ABORTED);
     }
 
+    if (SendRequest->Flags & QUIC_SEND_FLAG_FILE) {
+        QUIC_SEND_FILE* SendFile =
+            CXPLAT_CONTAINING_RECORD(SendRequest->Buffers, QUIC_SEND_FILE, Buffer);
+        CxPlatFileRangeUnmap(&SendFile->Range);
+        CXPLAT_FREE(SendFile, QUIC_POOL_SEND_FILE);
+    }
+
     if (!(SendRequest->Flags & QUIC_SEND_FLAG_BUFFERED)) {
         QUIC_STREAM_EVENT Event;
         Event.Type = QUIC_STREAM_EVENT_SEND_COMPLETE;
@@ -622,10 +620,20 @@ QuicStreamSendFlush(
             &Stream->Connection->Send,
             Stream,
             QUIC_STREAM_SEND_FLAG_DATA,
-            !!(SendRequest->Flags & QUIC_SEND_FLAG_DELAY_SEND));
+            (SendRequest->Flags & QUIC_SEND_FLAG_DELAY_SEND) ||
+            QuicSendCorkStreamData(&Stream->Connection->Send, SendRequest->TotalLength));
 
         if (Stream->Connection->Settings.SendBufferingEnabled) {
-            QuicSendBufferFill(Stream->Connection);
+            if (Stream->Connection->State.InlineApiExecution) {
+                //
+                // Buffering completes requests, which must not be indicated
+                // from within the app's StreamSend call. The connection does it
+                // after the operation the app is being called from.
+                //
+                Stream->Connection->Send.BufferFillPending = TRUE;
+            } else {
+                QuicSendBufferFill(Stream->Connection);
+            }
         }
 
         CXPLAT_DBG_ASSERT(Stream->SendRequests != NULL);
@@ -1011,10 +1019,12 @@ QuicStreamWriteStreamFrames(
         }
 
         if (Stream->NextSendOffset < Right) {
+            QuicStreamSetFcSummaryRemove(&Stream->Connection->Streams, Stream);
             Stream->NextSendOffset = Right;
             if (Sack && Stream->NextSendOffset == Sack->Low) {
                 Stream->NextSendOffset += Sack->Count;
             }
+            QuicStreamSetFcSummaryAdd(&Stream->Connection->Streams, Stream);
         }
 
         if (Stream->MaxSentLength < Right) {
@@ -1413,7 +1423,9 @@ QuicStreamOnAck(
             }
 
             if (Stream->NextSendOffset < Stream->UnAckedOffset) {
+                QuicStreamSetFcSummaryRemove(&Stream->Connection->Streams, Stream);
                 Stream->NextSendOffset = Stream->UnAckedOffset;
+                QuicStreamSetFcSummaryAdd(&Stream->Connection->Streams, Stream);
             }
             if (Stream->RecoveryNextOffset < Stream->UnAckedOffset) {
                 Stream->RecoveryNextOffset = Stream->UnAckedOffset;
@@ -1489,7 +1501,9 @@ QuicStreamOnAck(
             //
             if (Stream->NextSendOffset >= Sack->Low &&
                 Stream->NextSendOffset < Sack->Low + Sack->Count) {
+                QuicStreamSetFcSummaryRemove(&Stream->Connection->Streams, Stream);
                 Stream->NextSendOffset = Sack->Low + Sack->Count;
+                QuicStreamSetFcSummaryAdd(&Stream->Connection->Streams, Stream);
             }
             if (Stream->RecoveryNextOffset >= Sack->Low &&
                 Stream->RecoveryNextOffset < Sack->Low + Sack->Count) {
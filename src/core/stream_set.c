@@ -72,6 +72,7 @@ QuicStreamSetInitialize(
 {
     CxPlatListInitializeHead(&StreamSet->ClosedStreams);
     CxPlatListInitializeHead(&StreamSet->WaitingStreams);
+    CxPlatListInitializeHead(&StreamSet->RecvBatchStreams);
 #if DEBUG
     CxPlatListInitializeHead(&StreamSet->AllStreams);
     CxPlatDispatchLockInitialize(&StreamSet->AllStreamsLock);
@@ -87,6 +88,9 @@ QuicStreamSetUninitialize(
     if (StreamSet->StreamTable != NULL) {
         CxPlatHashtableUninitialize(StreamSet->StreamTable);
     }
+    if (StreamSet->StreamIndex != NULL) {
+        CXPLAT_FREE(StreamSet->StreamIndex, QUIC_POOL_STREAM_INDEX);
+    }
 #if DEBUG
     CxPlatDispatchLockUninitialize(&StreamSet->AllStreamsLock);
 #endif
@@ -117,6 +121,40 @@ QuicStreamSetTraceRundown(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetHibernate(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    )
+{
+    if (StreamSet->StreamTable == NULL) {
+        return;
+    }
+
+    if (StreamSet->StreamTable->NumEntries != 0) {
+        CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+        CXPLAT_HASHTABLE_ENTRY* Entry;
+        CxPlatHashtableEnumerateBegin(StreamSet->StreamTable, &Enumerator);
+        while ((Entry = CxPlatHashtableEnumerateNext(StreamSet->StreamTable, &Enumerator)) != NULL) {
+            QuicStreamHibernate(
+                CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, TableEntry));
+        }
+        CxPlatHashtableEnumerateEnd(StreamSet->StreamTable, &Enumerator);
+
+    } else if (CxPlatListIsEmpty(&StreamSet->WaitingStreams)) {
+        //
+        // Waiting streams are later inserted into the table without handling
+        // a lazy init failure, so only free it while none are waiting.
+        //
+        CxPlatHashtableUninitialize(StreamSet->StreamTable);
+        StreamSet->StreamTable = NULL;
+        if (StreamSet->StreamIndex != NULL) {
+            CXPLAT_FREE(StreamSet->StreamIndex, QUIC_POOL_STREAM_INDEX);
+            StreamSet->StreamIndex = NULL;
+        }
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != FALSE)
 BOOLEAN
@@ -128,9 +166,23 @@ QuicStreamSetLazyInitStreamTable(
         //
         // Lazily initialize the hash table.
         //
-        if (!CxPlatHashtableInitialize(&StreamSet->StreamTable, CXPLAT_HASH_MIN_SIZE)) {
+        if (!CxPlatHashtableInitializeOpen(&StreamSet->StreamTable, CXPLAT_HASH_MIN_SIZE)) {
             return FALSE;
         }
+
+        //
+        // The direct index is only an accelerator, so failing to allocate it
+        // isn't fatal.
+        //
+        StreamSet->StreamIndex =
+            CXPLAT_ALLOC_NONPAGED(
+                sizeof(QUIC_STREAM*) * QUIC_STREAM_INDEX_SIZE,
+                QUIC_POOL_STREAM_INDEX);
+        if (StreamSet->StreamIndex != NULL) {
+            CxPlatZeroMemory(
+                StreamSet->StreamIndex,
+                sizeof(QUIC_STREAM*) * QUIC_STREAM_INDEX_SIZE);
+        }
     }
     return TRUE;
 }
@@ -147,11 +199,15 @@ QuicStreamSetInsertStream(
         return FALSE;
     }
     Stream->Flags.InStreamTable = TRUE;
+    QuicStreamSetFcSummaryAdd(StreamSet, Stream);
     CxPlatHashtableInsert(
         StreamSet->StreamTable,
         &Stream->TableEntry,
         (uint32_t)Stream->ID,
         NULL);
+    if (StreamSet->StreamIndex != NULL) {
+        StreamSet->StreamIndex[Stream->ID & (QUIC_STREAM_INDEX_SIZE - 1)] = Stream;
+    }
     return TRUE;
 }
 
@@ -167,6 +223,13 @@ QuicStreamSetLookupStream(
         return NULL; // No streams have been created yet.
     }
 
+    if (StreamSet->StreamIndex != NULL) {
+        QUIC_STREAM* Stream = StreamSet->StreamIndex[ID & (QUIC_STREAM_INDEX_SIZE - 1)];
+        if (Stream != NULL && Stream->ID == ID) {
+            return Stream;
+        }
+    }
+
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
     CXPLAT_HASHTABLE_ENTRY* Entry =
         CxPlatHashtableLookup(StreamSet->StreamTable, (uint32_t)ID, &Context);
@@ -228,12 +291,22 @@ QuicStreamSetReleaseStream(
     _In_ QUIC_STREAM* Stream
     )
 {
+    QuicStreamSetRecvBatchRemove(StreamSet, Stream);
+
     //
     // Remove the stream from the list of open streams.
     //
     if (Stream->Flags.InStreamTable) {
+        QuicStreamSetFcSummaryRemove(StreamSet, Stream);
         CxPlatHashtableRemove(StreamSet->StreamTable, &Stream->TableEntry, NULL);
         Stream->Flags.InStreamTable = FALSE;
+        if (StreamSet->StreamIndex != NULL) {
+            QUIC_STREAM** Slot =
+                &StreamSet->StreamIndex[Stream->ID & (QUIC_STREAM_INDEX_SIZE - 1)];
+            if (*Slot == Stream) {
+                *Slot = NULL;
+            }
+        }
     } else if (Stream->Flags.InWaitingList) {
         CxPlatListEntryRemove(&Stream->WaitingLink);
         Stream->Flags.InWaitingList = FALSE;
@@ -273,6 +346,90 @@ QuicStreamSetReleaseStream(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamSetRecvBatchHold(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (Stream->RecvBatchThreshold == 0 ||
+        Stream->RecvMaxLength != UINT64_MAX ||
+        QuicRecvBufferGetUnreadLength(&Stream->RecvBuffer) >= Stream->RecvBatchThreshold) {
+        QuicStreamSetRecvBatchRemove(StreamSet, Stream);
+        return FALSE;
+    }
+
+    if (Stream->RecvBatchLink.Flink == NULL) {
+        QUIC_CONNECTION* Connection = QuicStreamSetGetConnection(StreamSet);
+        const uint64_t TimeNow = CxPlatTimeUs64();
+        Stream->RecvBatchDeadline = TimeNow + Stream->RecvBatchTimeoutUs;
+        CxPlatListInsertTail(&StreamSet->RecvBatchStreams, &Stream->RecvBatchLink);
+        if (Stream->RecvBatchDeadline < Connection->ExpirationTimes[QUIC_CONN_TIMER_RECV_BATCH]) {
+            QuicConnTimerSetEx(
+                Connection,
+                QUIC_CONN_TIMER_RECV_BATCH,
+                Stream->RecvBatchTimeoutUs,
+                TimeNow);
+        }
+    }
+
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetRecvBatchRemove(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream
+    )
+{
+    if (Stream->RecvBatchLink.Flink != NULL) {
+        CxPlatListEntryRemove(&Stream->RecvBatchLink);
+        Stream->RecvBatchLink.Flink = NULL;
+        if (CxPlatListIsEmpty(&StreamSet->RecvBatchStreams)) {
+            QuicConnTimerCancel(
+                QuicStreamSetGetConnection(StreamSet), QUIC_CONN_TIMER_RECV_BATCH);
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetProcessRecvBatchTimer(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    )
+{
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    uint64_t NextDeadline = UINT64_MAX;
+
+    //
+    // The flushes are queued rather than run inline, as the app's callback
+    // could otherwise change the list while it's being walked.
+    //
+    CXPLAT_LIST_ENTRY* Link = StreamSet->RecvBatchStreams.Flink;
+    while (Link != &StreamSet->RecvBatchStreams) {
+        QUIC_STREAM* Stream =
+            CXPLAT_CONTAINING_RECORD(Link, QUIC_STREAM, RecvBatchLink);
+        Link = Link->Flink;
+        if (Stream->RecvBatchDeadline <= TimeNow) {
+            CxPlatListEntryRemove(&Stream->RecvBatchLink);
+            Stream->RecvBatchLink.Flink = NULL;
+            QuicStreamRecvQueueFlush(Stream, FALSE);
+        } else if (Stream->RecvBatchDeadline < NextDeadline) {
+            NextDeadline = Stream->RecvBatchDeadline;
+        }
+    }
+
+    if (NextDeadline != UINT64_MAX) {
+        QuicConnTimerSetEx(
+            QuicStreamSetGetConnection(StreamSet),
+            QUIC_CONN_TIMER_RECV_BATCH,
+            NextDeadline - TimeNow,
+            TimeNow);
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicStreamSetDrainClosedStreams(
@@ -393,9 +550,11 @@ QuicStreamSetInitializeTransportParameters(
                 &Connection->PeerTransportParams);
 
         if (Stream->MaxAllowedSendOffset < NewMaxAllowedSendOffset) {
+            QuicStreamSetFcSummaryRemove(StreamSet, Stream);
             Stream->MaxAllowedSendOffset = NewMaxAllowedSendOffset;
             FlowBlockedFlagsToRemove |= QUIC_FLOW_BLOCKED_STREAM_FLOW_CONTROL;
             Stream->SendWindow = (uint32_t)CXPLAT_MIN(Stream->MaxAllowedSendOffset, UINT32_MAX);
+            QuicStreamSetFcSummaryAdd(StreamSet, Stream);
         }
 
         if (FlowBlockedFlagsToRemove) {
@@ -559,30 +718,9 @@ QuicStreamSetGetFlowControlSummary(
     _Out_ uint64_t* SendWindow
     )
 {
-    *FcAvailable = 0;
-    *SendWindow = 0;
-
-    if (StreamSet->StreamTable != NULL) {
-        CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
-        CXPLAT_HASHTABLE_ENTRY* Entry;
-        CxPlatHashtableEnumerateBegin(StreamSet->StreamTable, &Enumerator);
-        while ((Entry = CxPlatHashtableEnumerateNext(StreamSet->StreamTable, &Enumerator)) != NULL) {
-            QUIC_STREAM* Stream = CXPLAT_CONTAINING_RECORD(Entry, QUIC_STREAM, TableEntry);
-
-            if ((UINT64_MAX - *FcAvailable) >= (Stream->MaxAllowedSendOffset - Stream->NextSendOffset)) {
-                *FcAvailable += Stream->MaxAllowedSendOffset - Stream->NextSendOffset;
-            } else {
-                *FcAvailable = UINT64_MAX;
-            }
-
-            if ((UINT64_MAX - *SendWindow) >= Stream->SendWindow) {
-                *SendWindow += Stream->SendWindow;
-            } else {
-                *SendWindow = UINT64_MAX;
-            }
-        }
-        CxPlatHashtableEnumerateEnd(StreamSet->StreamTable, &Enumerator);
-    }
+    *FcAvailable =
+        StreamSet->FcAvailableCarry != 0 ? UINT64_MAX : StreamSet->FcAvailable;
+    *SendWindow = StreamSet->SendWindow;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -46,6 +46,15 @@ typedef struct QUIC_STREAM_SET {
     //
     CXPLAT_HASHTABLE* StreamTable;
 
+    //
+    // Optional direct-indexed table (QUIC_STREAM_INDEX_SIZE slots, keyed by
+    // the low bits of the stream ID) in front of StreamTable. Since stream
+    // IDs are handed out densely, the active window of streams maps to
+    // distinct slots and lookups skip the hash table. Streams that collide
+    // with a newer one simply fall back to StreamTable.
+    //
+    QUIC_STREAM** StreamIndex;
+
     //
     // The list of streams that are waiting for stream id flow control.
     //
@@ -56,6 +65,20 @@ typedef struct QUIC_STREAM_SET {
     //
     CXPLAT_LIST_ENTRY ClosedStreams;
 
+    //
+    // The list of streams holding back a receive indication for batching.
+    //
+    CXPLAT_LIST_ENTRY RecvBatchStreams;
+
+    //
+    // Running sums, over the streams in StreamTable, of the send flow control
+    // credit left (MaxAllowedSendOffset - NextSendOffset) and the send window.
+    // FcAvailableCarry counts FcAvailable wrap arounds, so the sum is exact.
+    //
+    uint64_t FcAvailable;
+    uint64_t SendWindow;
+    uint32_t FcAvailableCarry;
+
 #if DEBUG
     //
     // The list of allocated streams for leak tracking.
@@ -93,6 +116,16 @@ QuicStreamSetTraceRundown(
     _In_ QUIC_STREAM_SET* StreamSet
     );
 
+//
+// Releases the memory of idle streams and, if there are no streams left, the
+// stream table itself. The table is lazily allocated again when needed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetHibernate(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    );
+
 //
 // Shuts down (silent, abortive) all streams.
 //
@@ -113,6 +146,37 @@ QuicStreamSetReleaseStream(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Holds back the stream's receive indication if it has receive batching
+// enabled and not enough data is ready yet. Returns FALSE if the indication
+// should be delivered now.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicStreamSetRecvBatchHold(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Removes the stream from the list of held back receive indications.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetRecvBatchRemove(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ QUIC_STREAM* Stream
+    );
+
+//
+// Delivers the held back receive indications that are due.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicStreamSetProcessRecvBatchTimer(
+    _Inout_ QUIC_STREAM_SET* StreamSet
+    );
+
 //
 // Final clean up for all closed streams
 //
@@ -166,6 +230,52 @@ QuicStreamSetGetCountAvailable(
     _In_ uint8_t Type
     );
 
+//
+// Adds a stream's send flow control state to the running sums, if the stream
+// is in the table. Called after the stream's offsets or window change.
+//
+QUIC_INLINE
+void
+QuicStreamSetFcSummaryAdd(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ const QUIC_STREAM* Stream
+    )
+{
+    if (Stream->Flags.InStreamTable) {
+        const uint64_t FcAvailable =
+            Stream->MaxAllowedSendOffset - Stream->NextSendOffset;
+        StreamSet->FcAvailable += FcAvailable;
+        if (StreamSet->FcAvailable < FcAvailable) {
+            StreamSet->FcAvailableCarry++;
+        }
+        StreamSet->SendWindow += Stream->SendWindow;
+    }
+}
+
+//
+// Removes a stream's send flow control state from the running sums, if the
+// stream is in the table. Called before the stream's offsets or window change.
+//
+QUIC_INLINE
+void
+QuicStreamSetFcSummaryRemove(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ const QUIC_STREAM* Stream
+    )
+{
+    if (Stream->Flags.InStreamTable) {
+        const uint64_t FcAvailable =
+            Stream->MaxAllowedSendOffset - Stream->NextSendOffset;
+        if (StreamSet->FcAvailable < FcAvailable) {
+            CXPLAT_DBG_ASSERT(StreamSet->FcAvailableCarry != 0);
+            StreamSet->FcAvailableCarry--;
+        }
+        StreamSet->FcAvailable -= FcAvailable;
+        CXPLAT_DBG_ASSERT(StreamSet->SendWindow >= Stream->SendWindow);
+        StreamSet->SendWindow -= Stream->SendWindow;
+    }
+}
+
 //
 // Returns available flow control and send window, as a sum of all streams.
 //
@@ -189,6 +299,17 @@ QuicStreamSetNewLocalStream(
     _In_ QUIC_STREAM* Stream
     );
 
+//
+// Looks up an existing stream object by its ID.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Ret_maybenull_
+QUIC_STREAM*
+QuicStreamSetLookupStream(
+    _Inout_ QUIC_STREAM_SET* StreamSet,
+    _In_ uint64_t ID
+    );
+
 //
 // Does a look up for a peer's stream object, by the stream ID. It may create
 // new streams up to StreamId if the CreateIfMissing flag is set.
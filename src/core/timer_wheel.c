@@ -43,6 +43,27 @@ Abstract:
     updating the timer wheel's next expiration if this connection was currently
     next to expire.
 
+    Alternatively, the timer wheel can be initialized with a hierarchical
+    layout, which is better suited to workers with a very large number of
+    mostly idle connections. It never resizes and never sorts:
+
+        Levels - Four levels of unsorted slots. Level 0 has 1024 slots of 1 ms
+        each (about a second), and each higher level has 64 slots, each slot
+        covering the entire span of the level below it (about a minute, an
+        hour and three days respectively).
+
+        Current Tick - The time (in ms) the wheel has been advanced to. Each
+        connection is placed in the lowest level whose span covers the distance
+        between the current tick and its expiration time.
+
+        Cascade - As the current tick crosses the boundary of a higher level
+        slot, all connections in that slot are redistributed into the lower
+        levels. A connection cascades at most once per level.
+
+    Insertion and removal are O(1). The next expiration time is only an
+    estimate (never later than the real next expiration): for higher levels it
+    is the start of the next occupied slot, which is when a cascade is due.
+
 --*/
 
 #include "precomp.h"
@@ -64,18 +85,58 @@ Abstract:
 #define TIME_TO_SLOT_INDEX(TimerWheel, TimeUs) \
     ((US_TO_MS(TimeUs) / 1000) % (TimerWheel)->SlotCount)
 
+//
+// Layout of the hierarchical timer wheel. All levels share the single Slots
+// array; level N starts at offset QUIC_TIMER_WHEEL_LEVEL_OFFSET(N).
+//
+#define QUIC_TIMER_WHEEL_LEVEL0_BITS            10
+#define QUIC_TIMER_WHEEL_LEVELN_BITS            6
+#define QUIC_TIMER_WHEEL_LEVEL_BITS(Level) \
+    ((Level) == 0 ? QUIC_TIMER_WHEEL_LEVEL0_BITS : QUIC_TIMER_WHEEL_LEVELN_BITS)
+#define QUIC_TIMER_WHEEL_LEVEL_SLOTS(Level) \
+    (1u << QUIC_TIMER_WHEEL_LEVEL_BITS(Level))
+#define QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level) \
+    ((Level) == 0 ? 0 : \
+        QUIC_TIMER_WHEEL_LEVEL0_BITS + ((Level) - 1) * QUIC_TIMER_WHEEL_LEVELN_BITS)
+#define QUIC_TIMER_WHEEL_LEVEL_OFFSET(Level) \
+    ((Level) == 0 ? 0 : \
+        (1u << QUIC_TIMER_WHEEL_LEVEL0_BITS) + \
+        ((Level) - 1) * (1u << QUIC_TIMER_WHEEL_LEVELN_BITS))
+#define QUIC_TIMER_WHEEL_HIERARCHICAL_SLOT_COUNT \
+    QUIC_TIMER_WHEEL_LEVEL_OFFSET(QUIC_TIMER_WHEEL_LEVEL_COUNT)
+
+//
+// Helper to get the slot for a given tick (ms) in a given level.
+//
+#define TICK_TO_LEVEL_SLOT(TimerWheel, Level, Tick) \
+    (&(TimerWheel)->Slots[ \
+        QUIC_TIMER_WHEEL_LEVEL_OFFSET(Level) + \
+        (uint32_t)(((Tick) >> QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level)) & \
+            (QUIC_TIMER_WHEEL_LEVEL_SLOTS(Level) - 1))])
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicTimerWheelInitialize(
-    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ BOOLEAN Hierarchical
     )
 {
     TimerWheel->NextExpirationTime = UINT64_MAX;
     TimerWheel->ConnectionCount = 0;
     TimerWheel->NextConnection = NULL;
-    TimerWheel->SlotCount = QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT;
+    TimerWheel->Hierarchical = Hierarchical;
+    TimerWheel->CurrentTick = US_TO_MS(CxPlatTimeUs64());
+    for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++i) {
+        TimerWheel->LevelConnectionCount[i] = 0;
+    }
+    TimerWheel->CascadeCount = 0;
+    TimerWheel->CascadedConnectionCount = 0;
+    TimerWheel->SlotCount =
+        Hierarchical ?
+            QUIC_TIMER_WHEEL_HIERARCHICAL_SLOT_COUNT :
+            QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT;
     TimerWheel->Slots =
-        CXPLAT_ALLOC_NONPAGED(QUIC_TIMER_WHEEL_INITIAL_SLOT_COUNT * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
+        CXPLAT_ALLOC_NONPAGED(TimerWheel->SlotCount * sizeof(CXPLAT_LIST_ENTRY), QUIC_POOL_TIMERWHEEL);
     if (TimerWheel->Slots == NULL) {
         return QUIC_STATUS_OUT_OF_MEMORY;
     }
@@ -188,6 +249,27 @@ QuicTimerWheelResize(
     CXPLAT_FREE(OldSlots, QUIC_POOL_TIMERWHEEL);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelReserve(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint32_t ConnectionCount
+    )
+{
+    if (TimerWheel->Hierarchical) {
+        return; // Fixed size.
+    }
+
+    while ((uint64_t)ConnectionCount >
+           (uint64_t)TimerWheel->SlotCount * QUIC_TIMER_WHEEL_MAX_LOAD_FACTOR) {
+        const uint32_t OldSlotCount = TimerWheel->SlotCount;
+        QuicTimerWheelResize(TimerWheel);
+        if (TimerWheel->SlotCount == OldSlotCount) {
+            break; // Max size reached or out of memory.
+        }
+    }
+}
+
 //
 // Called to update NextConnection and NextExpirationTime when the
 // current NextConnection is updated.
@@ -225,14 +307,292 @@ QuicTimerWheelUpdate(
     }
 }
 
+//
+// Places the connection in the lowest level of the hierarchical wheel that
+// covers its expiration time, relative to the current tick.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
-QuicTimerWheelRemoveConnection(
+QuicTimerWheelHierarchicalInsert(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    uint64_t Tick = US_TO_MS(Connection->EarliestExpirationTime);
+    if (Tick < TimerWheel->CurrentTick) {
+        //
+        // Already expired, so it goes in the current slot to be picked up by
+        // the next call to QuicTimerWheelGetExpired.
+        //
+        Tick = TimerWheel->CurrentTick;
+    }
+
+    uint8_t Level = 0;
+    for (; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        const uint32_t Shift = QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level);
+        if ((Tick >> Shift) - (TimerWheel->CurrentTick >> Shift) <
+            QUIC_TIMER_WHEEL_LEVEL_SLOTS(Level)) {
+            break;
+        }
+    }
+
+    if (Level == QUIC_TIMER_WHEEL_LEVEL_COUNT) {
+        //
+        // Beyond the span of the wheel. Park it in the furthest slot of the top
+        // level; it is re-placed when that slot cascades.
+        //
+        Level = QUIC_TIMER_WHEEL_LEVEL_COUNT - 1;
+        const uint32_t Shift = QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level);
+        Tick =
+            ((TimerWheel->CurrentTick >> Shift) +
+                QUIC_TIMER_WHEEL_LEVEL_SLOTS(Level) - 1) << Shift;
+    }
+
+    Connection->TimerWheelLevel = Level;
+    TimerWheel->LevelConnectionCount[Level]++;
+    CxPlatListInsertTail(
+        TICK_TO_LEVEL_SLOT(TimerWheel, Level, Tick),
+        &Connection->TimerLink);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelHierarchicalUnlink(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    CxPlatListEntryRemove(&Connection->TimerLink);
+    CXPLAT_DBG_ASSERT(TimerWheel->LevelConnectionCount[Connection->TimerWheelLevel] != 0);
+    TimerWheel->LevelConnectionCount[Connection->TimerWheelLevel]--;
+}
+
+//
+// Recalculates NextExpirationTime for the hierarchical wheel. Level 0 gives
+// an exact time; the higher levels give the start of their next occupied
+// slot, when a cascade is needed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelHierarchicalUpdate(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+    )
+{
+    TimerWheel->NextExpirationTime = UINT64_MAX;
+
+    if (TimerWheel->LevelConnectionCount[0] != 0) {
+        for (uint32_t i = 0; i < QUIC_TIMER_WHEEL_LEVEL_SLOTS(0); ++i) {
+            CXPLAT_LIST_ENTRY* ListHead =
+                TICK_TO_LEVEL_SLOT(TimerWheel, 0, TimerWheel->CurrentTick + i);
+            if (CxPlatListIsEmpty(ListHead)) {
+                continue;
+            }
+            for (CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
+                 Entry != ListHead;
+                 Entry = Entry->Flink) {
+                QUIC_CONNECTION* ConnectionEntry =
+                    CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
+                if (ConnectionEntry->EarliestExpirationTime < TimerWheel->NextExpirationTime) {
+                    TimerWheel->NextExpirationTime = ConnectionEntry->EarliestExpirationTime;
+                }
+            }
+            break;
+        }
+    }
+
+    for (uint8_t Level = 1; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+        if (TimerWheel->LevelConnectionCount[Level] == 0) {
+            continue;
+        }
+        const uint32_t Shift = QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level);
+        for (uint32_t i = 1; i < QUIC_TIMER_WHEEL_LEVEL_SLOTS(Level); ++i) {
+            uint64_t SlotTick = ((TimerWheel->CurrentTick >> Shift) + i) << Shift;
+            if (!CxPlatListIsEmpty(TICK_TO_LEVEL_SLOT(TimerWheel, Level, SlotTick))) {
+                if (MS_TO_US(SlotTick) < TimerWheel->NextExpirationTime) {
+                    TimerWheel->NextExpirationTime = MS_TO_US(SlotTick);
+                }
+                break;
+            }
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelHierarchicalUpdateConnection(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
     _Inout_ QUIC_CONNECTION* Connection
     )
 {
+    uint64_t ExpirationTime = Connection->EarliestExpirationTime;
+
     if (Connection->TimerLink.Flink != NULL) {
+        QuicTimerWheelHierarchicalUnlink(TimerWheel, Connection);
+
+        if (ExpirationTime == UINT64_MAX || Connection->State.ShutdownComplete) {
+            Connection->TimerLink.Flink = NULL;
+            if (--TimerWheel->ConnectionCount == 0) {
+                TimerWheel->NextExpirationTime = UINT64_MAX;
+            }
+            QuicConnRelease(Connection, QUIC_CONN_REF_TIMER_WHEEL);
+            return;
+        }
+
+    } else if (ExpirationTime != UINT64_MAX && !Connection->State.ShutdownComplete) {
+        if (TimerWheel->ConnectionCount++ == 0) {
+            //
+            // Nothing is relative to the current tick while the wheel is
+            // empty, so catch it up to avoid needless cascades.
+            //
+            uint64_t Now = US_TO_MS(CxPlatTimeUs64());
+            if (Now > TimerWheel->CurrentTick) {
+                TimerWheel->CurrentTick = Now;
+            }
+        }
+        QuicConnAddRef(Connection, QUIC_CONN_REF_TIMER_WHEEL);
+
+    } else {
+        return; // Ignore
+    }
+
+    QuicTimerWheelHierarchicalInsert(TimerWheel, Connection);
+
+    //
+    // A connection moving later may leave NextExpirationTime early, which
+    // only costs a spurious call to QuicTimerWheelGetExpired.
+    //
+    if (ExpirationTime < TimerWheel->NextExpirationTime) {
+        TimerWheel->NextExpirationTime = ExpirationTime;
+    }
+}
+
+//
+// Moves all connections in the given slot down to the lower levels.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelCascade(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint8_t Level
+    )
+{
+    CXPLAT_LIST_ENTRY* ListHead =
+        TICK_TO_LEVEL_SLOT(TimerWheel, Level, TimerWheel->CurrentTick);
+    if (CxPlatListIsEmpty(ListHead)) {
+        return;
+    }
+
+    CXPLAT_LIST_ENTRY Cascading;
+    CxPlatListInitializeHead(&Cascading);
+    CxPlatListMoveItems(ListHead, &Cascading);
+    TimerWheel->CascadeCount++;
+
+    while (!CxPlatListIsEmpty(&Cascading)) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Cascading),
+                QUIC_CONNECTION,
+                TimerLink);
+        TimerWheel->LevelConnectionCount[Level]--;
+        TimerWheel->CascadedConnectionCount++;
+        QuicTimerWheelHierarchicalInsert(TimerWheel, Connection);
+    }
+}
+
+//
+// Moves all connections in the current level 0 slot that have expired to the
+// output list.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelCollect(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
+    )
+{
+    CXPLAT_LIST_ENTRY* ListHead =
+        TICK_TO_LEVEL_SLOT(TimerWheel, 0, TimerWheel->CurrentTick);
+    CXPLAT_LIST_ENTRY* Entry = ListHead->Flink;
+    while (Entry != ListHead) {
+        QUIC_CONNECTION* ConnectionEntry =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
+        Entry = Entry->Flink;
+        if (ConnectionEntry->EarliestExpirationTime > TimeNow) {
+            continue; // Later in the same ms.
+        }
+        QuicTimerWheelHierarchicalUnlink(TimerWheel, ConnectionEntry);
+        CxPlatListInsertTail(OutputListHead, &ConnectionEntry->TimerLink);
+        QuicConnAddRef(ConnectionEntry, QUIC_CONN_REF_WORKER);
+        QuicConnRelease(ConnectionEntry, QUIC_CONN_REF_TIMER_WHEEL);
+        TimerWheel->ConnectionCount--;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelHierarchicalGetExpired(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint64_t TimeNow,
+    _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
+    )
+{
+    const uint64_t NowTick = US_TO_MS(TimeNow);
+
+    QuicTimerWheelCollect(TimerWheel, TimeNow, OutputListHead);
+
+    while (TimerWheel->CurrentTick < NowTick) {
+        //
+        // Advance to the next tick that has any work: the next ms if level 0
+        // is occupied, otherwise the next slot boundary of the lowest
+        // occupied level.
+        //
+        uint64_t NextTick = NowTick;
+        for (uint8_t Level = 0; Level < QUIC_TIMER_WHEEL_LEVEL_COUNT; ++Level) {
+            if (TimerWheel->LevelConnectionCount[Level] != 0) {
+                const uint32_t Shift = QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level);
+                uint64_t Boundary = ((TimerWheel->CurrentTick >> Shift) + 1) << Shift;
+                if (Boundary < NextTick) {
+                    NextTick = Boundary;
+                }
+                break;
+            }
+        }
+        TimerWheel->CurrentTick = NextTick;
+
+        for (uint8_t Level = QUIC_TIMER_WHEEL_LEVEL_COUNT - 1; Level > 0; --Level) {
+            const uint64_t Mask = (1ull << QUIC_TIMER_WHEEL_LEVEL_SHIFT(Level)) - 1;
+            if ((TimerWheel->CurrentTick & Mask) == 0) {
+                QuicTimerWheelCascade(TimerWheel, Level);
+            }
+        }
+
+        QuicTimerWheelCollect(TimerWheel, TimeNow, OutputListHead);
+    }
+
+    if (TimerWheel->ConnectionCount == 0) {
+        TimerWheel->NextExpirationTime = UINT64_MAX;
+    } else {
+        QuicTimerWheelHierarchicalUpdate(TimerWheel);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelRemoveConnection(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->TimerLink.Flink != NULL && TimerWheel->Hierarchical) {
+        QuicTimerWheelHierarchicalUnlink(TimerWheel, Connection);
+        Connection->TimerLink.Flink = NULL;
+        if (--TimerWheel->ConnectionCount == 0) {
+            TimerWheel->NextExpirationTime = UINT64_MAX;
+        }
+        QuicConnRelease(Connection, QUIC_CONN_REF_TIMER_WHEEL);
+
+    } else if (Connection->TimerLink.Flink != NULL) {
         //
         // If the connection was in the timer wheel, remove its entry in the
         // doubly-link list.
@@ -256,6 +616,11 @@ QuicTimerWheelUpdateConnection(
     _Inout_ QUIC_CONNECTION* Connection
     )
 {
+    if (TimerWheel->Hierarchical) {
+        QuicTimerWheelHierarchicalUpdateConnection(TimerWheel, Connection);
+        return;
+    }
+
     uint64_t ExpirationTime = Connection->EarliestExpirationTime;
 
     if (Connection->TimerLink.Flink != NULL) {
@@ -353,6 +718,11 @@ QuicTimerWheelGetExpired(
     _Inout_ CXPLAT_LIST_ENTRY* OutputListHead
     )
 {
+    if (TimerWheel->Hierarchical) {
+        QuicTimerWheelHierarchicalGetExpired(TimerWheel, TimeNow, OutputListHead);
+        return;
+    }
+
     //
     // Iterate through every slot to find all the connections that now have
     // expired timers.
@@ -7,6 +7,11 @@
 
 typedef struct QUIC_CONNECTION QUIC_CONNECTION;
 
+//
+// The number of levels in the hierarchical timer wheel.
+//
+#define QUIC_TIMER_WHEEL_LEVEL_COUNT    4
+
 typedef struct QUIC_TIMER_WHEEL {
 
     //
@@ -34,6 +39,36 @@ typedef struct QUIC_TIMER_WHEEL {
     //
     CXPLAT_LIST_ENTRY* Slots;
 
+    //
+    // Indicates the wheel uses the hierarchical (multi-level) layout instead
+    // of the single, resizable level of sorted slots.
+    //
+    BOOLEAN Hierarchical;
+
+    //
+    // The following are only used by the hierarchical layout.
+    //
+
+    //
+    // The time (in ms) the wheel has been advanced to.
+    //
+    uint64_t CurrentTick;
+
+    //
+    // Number of connections currently in each level.
+    //
+    uint32_t LevelConnectionCount[QUIC_TIMER_WHEEL_LEVEL_COUNT];
+
+    //
+    // Number of times a higher level slot was cascaded into lower levels.
+    //
+    uint64_t CascadeCount;
+
+    //
+    // Total number of connections moved down a level by cascades.
+    //
+    uint64_t CascadedConnectionCount;
+
 } QUIC_TIMER_WHEEL;
 
 //
@@ -42,7 +77,8 @@ typedef struct QUIC_TIMER_WHEEL {
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicTimerWheelInitialize(
-    _Inout_ QUIC_TIMER_WHEEL* TimerWheel
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ BOOLEAN Hierarchical
     );
 
 //
@@ -54,6 +90,17 @@ QuicTimerWheelUninitialize(
     _Inout_ QUIC_TIMER_WHEEL* TimerWheel
     );
 
+//
+// Grows the slots up front to hold ConnectionCount connections without being
+// resized while they're inserted.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicTimerWheelReserve(
+    _Inout_ QUIC_TIMER_WHEEL* TimerWheel,
+    _In_ uint32_t ConnectionCount
+    );
+
 //
 // Removes the connection from the timer wheel.
 //
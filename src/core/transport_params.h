@@ -115,6 +115,14 @@ typedef struct QUIC_TRANSPORT_PARAMETERS {
     QUIC_VAR_INT CibirLength;
     QUIC_VAR_INT CibirOffset;
 
+    //
+    // The number of source datagrams covered by each FEC repair symbol the
+    // endpoint sends. The presence of the parameter also advertises support
+    // for receiving FEC protected datagrams.
+    //
+    _Field_range_(2, QUIC_FEC_MAX_BLOCK_SIZE)
+    QUIC_VAR_INT FecBlockSize;
+
     //
     // Server specific.
     //
@@ -155,7 +163,26 @@ typedef struct QUIC_TRANSPORT_PARAMETERS {
 } QUIC_TRANSPORT_PARAMETERS;
 
 //
-// Allocates and encodes the QUIC TP buffer. Free with CXPLAT_FREE.
+// The encoding of the transport parameters not in QUIC_TP_FLAGS_PER_CONNECTION,
+// shared by all the server handshakes that produce the same values.
+//
+typedef struct QUIC_TP_ENCODE_CACHE {
+
+    //
+    // The parameters the encoding was built from. Only the fields not in
+    // QUIC_TP_FLAGS_PER_CONNECTION are meaningful.
+    //
+    QUIC_TRANSPORT_PARAMETERS Params;
+
+    uint16_t Length;
+    uint8_t Buffer[0];
+
+} QUIC_TP_ENCODE_CACHE;
+
+//
+// Allocates and encodes the QUIC TP buffer. Free with CXPLAT_FREE. If Cache is
+// provided, the static parameters are copied from the encoding it holds (built
+// on first use) instead of being encoded again.
 //
 _IRQL_requires_max_(DISPATCH_LEVEL)
 _Success_(return != NULL)
@@ -165,6 +192,7 @@ QuicCryptoTlsEncodeTransportParameters(
     _In_ BOOLEAN IsServerTP,
     _In_ const QUIC_TRANSPORT_PARAMETERS *TransportParams,
     _In_opt_ const QUIC_PRIVATE_TRANSPORT_PARAMETER* TestParam,
+    _Inout_opt_ QUIC_TP_ENCODE_CACHE** Cache,
     _Out_ uint32_t* TPLen
     );
 
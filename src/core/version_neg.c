@@ -38,12 +38,13 @@ QuicVersionNegotiationExtIsVersionServerSupported(
     _In_ uint32_t Version
     )
 {
-    if (MsQuicLib.Settings.IsSet.VersionSettings) {
+    const QUIC_SETTINGS_INTERNAL* Settings = QuicLibraryGetSettings();
+    if (Settings->IsSet.VersionSettings) {
         if (QuicIsVersionReserved(Version)) {
             return FALSE;
         }
-        for (uint32_t i = 0; i < MsQuicLib.Settings.VersionSettings->AcceptableVersionsLength; ++i) {
-            if (MsQuicLib.Settings.VersionSettings->AcceptableVersions[i] == Version) {
+        for (uint32_t i = 0; i < Settings->VersionSettings->AcceptableVersionsLength; ++i) {
+            if (Settings->VersionSettings->AcceptableVersions[i] == Version) {
                 return TRUE;
             }
         }
@@ -229,9 +230,10 @@ QuicVersionNegotiationExtEncodeVersionInfo(
     if (QuicConnIsServer(Connection)) {
         const uint32_t* AvailableVersionsList = NULL;
         uint32_t AvailableVersionsListLength = 0;
-        if (MsQuicLib.Settings.IsSet.VersionSettings) {
-            AvailableVersionsList = MsQuicLib.Settings.VersionSettings->FullyDeployedVersions;
-            AvailableVersionsListLength = MsQuicLib.Settings.VersionSettings->FullyDeployedVersionsLength;
+        const QUIC_SETTINGS_INTERNAL* Settings = QuicLibraryGetSettings();
+        if (Settings->IsSet.VersionSettings) {
+            AvailableVersionsList = Settings->VersionSettings->FullyDeployedVersions;
+            AvailableVersionsListLength = Settings->VersionSettings->FullyDeployedVersionsLength;
         } else {
             AvailableVersionsList = DefaultSupportedVersionsList;
             AvailableVersionsListLength = ARRAYSIZE(DefaultSupportedVersionsList);
@@ -61,15 +61,26 @@ QuicWorkerUninitialize(
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicWorkerInitialize(
-    _In_ const QUIC_REGISTRATION* Registration,
+    _In_ QUIC_REGISTRATION* Registration,
     _In_ QUIC_EXECUTION_PROFILE ExecProfile,
     _In_ QUIC_PARTITION* Partition,
     _Inout_ QUIC_WORKER* Worker
     )
 {
-    (void)Registration;
+    Worker->Registration = Registration;
+    Worker->Settings = QuicLibraryGetSettings();
     Worker->Enabled = TRUE;
     Worker->Partition = Partition;
+    Worker->NumaNode = CxPlatProcNumaNode(Partition->Processor);
+#ifndef QUIC_WORKER_LOCKFREE_QUEUE
+    //
+    // Stealing requires access to other workers' connection lists, which are
+    // only owned by their worker thread in the lock-free build.
+    //
+    Worker->WorkStealing =
+        MsQuicLib.ExecutionConfig != NULL &&
+        (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_WORK_STEALING);
+#endif
     CxPlatDispatchLockInitialize(&Worker->Lock);
     CxPlatEventInitialize(&Worker->Done, TRUE, FALSE);
     CxPlatEventInitialize(&Worker->Ready, FALSE, FALSE);
@@ -77,8 +88,43 @@ QuicWorkerInitialize(
     Worker->PriorityConnectionsTail = &Worker->Connections.Flink;
     CxPlatListInitializeHead(&Worker->Listeners);
     CxPlatListInitializeHead(&Worker->Operations);
+    CxPlatListInitializeHead(&Worker->PacingConnections);
+    CxPlatListInitializeHead(&Worker->AcceptQueue);
+    Worker->NextPacingTime = UINT64_MAX;
+    Worker->Activity = QUIC_WORKER_ACTIVITY_IDLE;
+    Worker->ActivityStartTime = CxPlatTimeUs64();
+
+    //
+    // Latency sensitive profiles favor short turns so connections get
+    // serviced quickly, while the throughput profile favors long turns so
+    // busy connections don't churn through the queue.
+    //
+    switch (ExecProfile) {
+    default:
+    case QUIC_EXECUTION_PROFILE_LOW_LATENCY:
+    case QUIC_EXECUTION_PROFILE_TYPE_SCAVENGER:
+        Worker->DrainBudgetMin = QUIC_MIN_ADAPTIVE_OPERATIONS_PER_DRAIN * 2;
+        Worker->DrainBudgetMax = QUIC_MAX_OPERATIONS_PER_DRAIN;
+        Worker->DrainBudgetTargetDelay = QUIC_DRAIN_BUDGET_TARGET_QUEUE_DELAY_US;
+        break;
+    case QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT:
+        Worker->DrainBudgetMin = QUIC_MAX_OPERATIONS_PER_DRAIN / 2;
+        Worker->DrainBudgetMax = QUIC_MAX_ADAPTIVE_OPERATIONS_PER_DRAIN;
+        Worker->DrainBudgetTargetDelay = QUIC_DRAIN_BUDGET_TARGET_QUEUE_DELAY_US * 4;
+        break;
+    case QUIC_EXECUTION_PROFILE_TYPE_REAL_TIME:
+        Worker->DrainBudgetMin = QUIC_MIN_ADAPTIVE_OPERATIONS_PER_DRAIN;
+        Worker->DrainBudgetMax = QUIC_MAX_OPERATIONS_PER_DRAIN / 2;
+        Worker->DrainBudgetTargetDelay = QUIC_DRAIN_BUDGET_TARGET_QUEUE_DELAY_US / 4;
+        break;
+    }
+    Worker->DrainBudget = CXPLAT_MIN(QUIC_MAX_OPERATIONS_PER_DRAIN, Worker->DrainBudgetMax);
 
-    QUIC_STATUS Status = QuicTimerWheelInitialize(&Worker->TimerWheel);
+    QUIC_STATUS Status =
+        QuicTimerWheelInitialize(
+            &Worker->TimerWheel,
+            MsQuicLib.ExecutionConfig != NULL &&
+            (MsQuicLib.ExecutionConfig->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_HIERARCHICAL_TIMERS));
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
@@ -196,6 +242,72 @@ QuicWorkerAssignConnection(
     Connection->Partition = Worker->Partition;
 }
 
+//
+// Called by an idle worker to claim a queued connection from the most
+// overloaded worker in the same pool and NUMA node. The connection isn't
+// processed here; it is only marked and moved to the front of the victim's
+// normal priority queue. The victim then hands it off (without draining it)
+// the next time it dequeues it, so that the timer wheel and connection state
+// are only ever touched by a single thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+QuicWorkerTrySteal(
+    _In_ QUIC_WORKER* Worker
+    )
+{
+    QUIC_WORKER_POOL* Pool = Worker->Pool;
+    QUIC_WORKER* Victim = NULL;
+    uint32_t MaxQueueDelay = 0;
+
+    for (uint16_t i = 0; i < Pool->WorkerCount; ++i) {
+        QUIC_WORKER* Candidate = &Pool->Workers[i];
+        if (Candidate != Worker &&
+            Candidate->Enabled &&
+            Candidate->NumaNode == Worker->NumaNode &&
+            QuicWorkerIsOverloaded(Candidate) &&
+            Candidate->AverageQueueDelay > MaxQueueDelay) {
+            MaxQueueDelay = Candidate->AverageQueueDelay;
+            Victim = Candidate;
+        }
+    }
+
+    if (Victim == NULL) {
+        return FALSE;
+    }
+
+    BOOLEAN Stolen = FALSE;
+    CxPlatDispatchLockAcquire(&Victim->Lock);
+
+    //
+    // Leave the victim at least one connection, and never take priority
+    // connections, which are expected to be processed by their current worker
+    // as soon as possible.
+    //
+    CXPLAT_LIST_ENTRY* Entry = Victim->Connections.Blink;
+    if (Entry != &Victim->Connections &&
+        Entry != Victim->Connections.Flink &&
+        Victim->PriorityConnectionsTail != &Entry->Flink) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, WorkerLink);
+        CXPLAT_DBG_ASSERT(!Connection->WorkerProcessing);
+        if (Connection->StealWorker == NULL && Connection->Worker == Victim) {
+            Connection->StealWorker = Worker;
+            CxPlatListEntryRemove(Entry);
+            CxPlatListInsertTail(*Victim->PriorityConnectionsTail, Entry);
+            Stolen = TRUE;
+        }
+    }
+
+    CxPlatDispatchLockRelease(&Victim->Lock);
+
+    if (Stolen) {
+        Worker->StolenConnectionCount++;
+    }
+
+    return Stolen;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerAssignListener(
@@ -218,6 +330,160 @@ QuicWorkerIsIdle(
         CxPlatListIsEmpty(&Worker->Operations);
 }
 
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+
+//
+// Bits in QUIC_CONNECTION::WorkerQueueState.
+//
+#define QUIC_WORKER_QUEUE_QUEUED            0x0001  // Has work queued
+#define QUIC_WORKER_QUEUE_PRIORITY          0x0002  // Has priority work queued
+#define QUIC_WORKER_QUEUE_PROCESSING        0x0004  // Worker is processing it
+#define QUIC_WORKER_QUEUE_PRIORITY_PENDING  0x0008  // In the priority inbox
+
+//
+// Atomically sets and clears bits of the connection's queue state. Returns the
+// previous state.
+//
+QUIC_INLINE
+short
+QuicWorkerUpdateQueueState(
+    _Inout_ QUIC_CONNECTION* Connection,
+    _In_ short Set,
+    _In_ short Clear
+    )
+{
+    short Old, New;
+    do {
+        Old = Connection->WorkerQueueState;
+        New = (short)((Old & ~Clear) | Set);
+    } while (InterlockedCompareExchange16(&Connection->WorkerQueueState, New, Old) != Old);
+    return Old;
+}
+
+//
+// Pushes an entry onto an inbox. Returns TRUE if the inbox was empty, in which
+// case the worker may need to be woken up.
+//
+QUIC_INLINE
+BOOLEAN
+QuicWorkerInboxPush(
+    _Inout_ CXPLAT_SLIST_ENTRY* volatile* Inbox,
+    _Inout_ CXPLAT_SLIST_ENTRY* Entry
+    )
+{
+    CXPLAT_SLIST_ENTRY* Head;
+    do {
+        Head = (CXPLAT_SLIST_ENTRY*)QuicReadPtrNoFence((void**)Inbox);
+        Entry->Next = Head;
+    } while (InterlockedCompareExchangePointer((void* volatile*)Inbox, Entry, Head) != Head);
+    return Head == NULL;
+}
+
+//
+// Removes all entries from an inbox and returns them in FIFO order. May only
+// be called by the owning worker.
+//
+QUIC_INLINE
+CXPLAT_SLIST_ENTRY*
+QuicWorkerInboxFlush(
+    _Inout_ CXPLAT_SLIST_ENTRY* volatile* Inbox
+    )
+{
+    if (QuicReadPtrNoFence((void**)Inbox) == NULL) {
+        return NULL;
+    }
+    CXPLAT_SLIST_ENTRY* Entry =
+        (CXPLAT_SLIST_ENTRY*)InterlockedExchangePointer((void* volatile*)Inbox, NULL);
+    CXPLAT_SLIST_ENTRY* Reversed = NULL;
+    while (Entry != NULL) {
+        CXPLAT_SLIST_ENTRY* Next = Entry->Next;
+        Entry->Next = Reversed;
+        Reversed = Entry;
+        Entry = Next;
+    }
+    return Reversed;
+}
+
+//
+// Inserts a connection into the worker's (thread owned) connection list.
+//
+QUIC_INLINE
+void
+QuicWorkerLinkConnection(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ BOOLEAN IsPriority
+    )
+{
+    CXPLAT_DBG_ASSERT(!Connection->WorkerLinked);
+    if (IsPriority) {
+        CxPlatListInsertTail(*Worker->PriorityConnectionsTail, &Connection->WorkerLink);
+        Worker->PriorityConnectionsTail = &Connection->WorkerLink.Flink;
+        Connection->HasPriorityWork = TRUE;
+    } else {
+        CxPlatListInsertTail(&Worker->Connections, &Connection->WorkerLink);
+    }
+    Connection->WorkerLinked = TRUE;
+}
+
+//
+// Moves everything pushed by other threads into the worker's own lists.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerDrainInboxes(
+    _In_ QUIC_WORKER* Worker
+    )
+{
+    CXPLAT_SLIST_ENTRY* Entry = QuicWorkerInboxFlush(&Worker->ConnectionInbox);
+    while (Entry != NULL) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, WorkerInboxLink);
+        Entry = Entry->Next;
+        QuicWorkerLinkConnection(
+            Worker,
+            Connection,
+            (Connection->WorkerQueueState & QUIC_WORKER_QUEUE_PRIORITY) != 0);
+    }
+
+    //
+    // Priority requests for connections that were already queued. Connections
+    // not currently linked (still in the normal inbox, or being processed) are
+    // placed correctly when linked later, so they are simply skipped here.
+    //
+    Entry = QuicWorkerInboxFlush(&Worker->PriorityConnectionInbox);
+    while (Entry != NULL) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, WorkerPriorityInboxLink);
+        Entry = Entry->Next;
+        const short State =
+            QuicWorkerUpdateQueueState(Connection, 0, QUIC_WORKER_QUEUE_PRIORITY_PENDING);
+        if (Connection->Worker == Worker &&
+            Connection->WorkerLinked &&
+            !Connection->HasPriorityWork &&
+            (State & QUIC_WORKER_QUEUE_PRIORITY)) {
+            CxPlatListEntryRemove(&Connection->WorkerLink);
+            Connection->WorkerLinked = FALSE;
+            QuicWorkerLinkConnection(Worker, Connection, TRUE);
+        }
+        QuicConnRelease(Connection, QUIC_CONN_REF_WORKER);
+    }
+
+    //
+    // N.B. The operation's Link.Flink doubles as the inbox link.
+    //
+    Entry = QuicWorkerInboxFlush(&Worker->OperationInbox);
+    while (Entry != NULL) {
+        QUIC_OPERATION* Operation =
+            CXPLAT_CONTAINING_RECORD(Entry, QUIC_OPERATION, Link);
+        Entry = Entry->Next;
+        CxPlatListInsertTail(&Worker->Operations, &Operation->Link);
+        Worker->OperationCount++;
+    }
+}
+
+#endif // QUIC_WORKER_LOCKFREE_QUEUE
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerQueueConnection(
@@ -229,6 +495,17 @@ QuicWorkerQueueConnection(
     BOOLEAN ConnectionQueued = FALSE;
     BOOLEAN WakeWorkerThread = FALSE;
 
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    const short State =
+        QuicWorkerUpdateQueueState(Connection, QUIC_WORKER_QUEUE_QUEUED, 0);
+    if (!(State & (QUIC_WORKER_QUEUE_QUEUED | QUIC_WORKER_QUEUE_PROCESSING))) {
+        Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+        QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+        WakeWorkerThread =
+            QuicWorkerInboxPush(&Worker->ConnectionInbox, &Connection->WorkerInboxLink);
+        ConnectionQueued = TRUE;
+    }
+#else
     CxPlatDispatchLockAcquire(&Worker->Lock);
 
     if (!Connection->WorkerProcessing && !Connection->HasQueuedWork) {
@@ -242,6 +519,7 @@ QuicWorkerQueueConnection(
     Connection->HasQueuedWork = TRUE;
 
     CxPlatDispatchLockRelease(&Worker->Lock);
+#endif
 
     if (ConnectionQueued) {
         if (WakeWorkerThread) {
@@ -262,6 +540,46 @@ QuicWorkerQueuePriorityConnection(
     BOOLEAN ConnectionQueued = FALSE;
     BOOLEAN WakeWorkerThread = FALSE;
 
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    short State, NewState;
+    do {
+        State = Connection->WorkerQueueState;
+        NewState = State | QUIC_WORKER_QUEUE_QUEUED;
+        if (!(State & QUIC_WORKER_QUEUE_PROCESSING)) {
+            NewState |= QUIC_WORKER_QUEUE_PRIORITY;
+            if ((State & QUIC_WORKER_QUEUE_QUEUED) &&
+                !(State & (QUIC_WORKER_QUEUE_PRIORITY | QUIC_WORKER_QUEUE_PRIORITY_PENDING))) {
+                NewState |= QUIC_WORKER_QUEUE_PRIORITY_PENDING;
+            }
+        }
+    } while (InterlockedCompareExchange16(&Connection->WorkerQueueState, NewState, State) != State);
+
+    if (!(State & (QUIC_WORKER_QUEUE_QUEUED | QUIC_WORKER_QUEUE_PROCESSING))) {
+        //
+        // Newly queued. The worker links it as priority based on the state.
+        //
+        Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+        QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+        WakeWorkerThread =
+            QuicWorkerInboxPush(&Worker->ConnectionInbox, &Connection->WorkerInboxLink);
+        ConnectionQueued = TRUE;
+    } else if ((NewState & ~State) & QUIC_WORKER_QUEUE_PRIORITY_PENDING) {
+        //
+        // Already queued for normal priority work. Ask the worker to move it.
+        //
+        QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+        WakeWorkerThread =
+            QuicWorkerInboxPush(
+                &Worker->PriorityConnectionInbox, &Connection->WorkerPriorityInboxLink);
+    }
+
+    if (WakeWorkerThread) {
+        QuicWorkerThreadWake(Worker);
+    }
+    if (ConnectionQueued) {
+        QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
+    }
+#else
     CxPlatDispatchLockAcquire(&Worker->Lock);
 
     if (!Connection->WorkerProcessing && !Connection->HasPriorityWork) {
@@ -288,6 +606,7 @@ QuicWorkerQueuePriorityConnection(
         }
         QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
     }
+#endif
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -299,6 +618,23 @@ QuicWorkerMoveConnection(
     )
 {
     CXPLAT_DBG_ASSERT(Connection->Worker != NULL);
+
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    //
+    // The connection is still marked as processing (and queued) so no other
+    // thread will try to queue it until it is pushed to the new worker here.
+    //
+    CXPLAT_DBG_ASSERT(Connection->WorkerQueueState & QUIC_WORKER_QUEUE_QUEUED);
+    Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+    QuicConnAddRef(Connection, QUIC_CONN_REF_WORKER);
+    (void)QuicWorkerUpdateQueueState(
+        Connection,
+        IsPriority ? QUIC_WORKER_QUEUE_PRIORITY : 0,
+        QUIC_WORKER_QUEUE_PROCESSING);
+    if (QuicWorkerInboxPush(&Worker->ConnectionInbox, &Connection->WorkerInboxLink)) {
+        QuicWorkerThreadWake(Worker);
+    }
+#else
     CXPLAT_DBG_ASSERT(Connection->HasQueuedWork);
 
     CxPlatDispatchLockAcquire(&Worker->Lock);
@@ -319,6 +655,7 @@ QuicWorkerMoveConnection(
     if (WakeWorkerThread) {
         QuicWorkerThreadWake(Worker);
     }
+#endif
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -353,6 +690,36 @@ QuicWorkerQueueListener(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerRandom(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint16_t Length,
+    _Out_writes_(Length)
+        uint8_t* Buffer
+    )
+{
+    if (Length > sizeof(Worker->RandomPool)) {
+        CxPlatRandom(Length, Buffer);
+        return;
+    }
+
+    if (Worker->RandomPoolLength < Length) {
+        //
+        // Whatever is left is dropped rather than stitched together with
+        // the next batch.
+        //
+        CxPlatRandom(sizeof(Worker->RandomPool), Worker->RandomPool);
+        Worker->RandomPoolLength = sizeof(Worker->RandomPool);
+    }
+
+    CxPlatCopyMemory(
+        Buffer,
+        Worker->RandomPool + sizeof(Worker->RandomPool) - Worker->RandomPoolLength,
+        Length);
+    Worker->RandomPoolLength -= Length;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerQueueOperation(
@@ -360,10 +727,28 @@ QuicWorkerQueueOperation(
     _In_ QUIC_OPERATION* Operation
     )
 {
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    BOOLEAN WakeWorkerThread;
+    if (InterlockedIncrement(&Worker->QueuedOperationCount) <=
+            (long)Worker->Settings->MaxStatelessOperations &&
+        QuicLibraryTryAddRefBinding(Operation->STATELESS.Context->Binding)) {
+        Operation->STATELESS.Context->HasBindingRef = TRUE;
+        WakeWorkerThread =
+            QuicWorkerInboxPush(
+                &Worker->OperationInbox, (CXPLAT_SLIST_ENTRY*)&Operation->Link);
+        Operation = NULL;
+        QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_WORK_OPER_QUEUE_DEPTH);
+        QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_WORK_OPER_QUEUED);
+    } else {
+        WakeWorkerThread = FALSE;
+        InterlockedDecrement(&Worker->QueuedOperationCount);
+        InterlockedIncrement64((int64_t*)&Worker->DroppedOperationCount);
+    }
+#else
     CxPlatDispatchLockAcquire(&Worker->Lock);
 
     BOOLEAN WakeWorkerThread;
-    if (Worker->OperationCount < MsQuicLib.Settings.MaxStatelessOperations &&
+    if (Worker->OperationCount < Worker->Settings->MaxStatelessOperations &&
         QuicLibraryTryAddRefBinding(Operation->STATELESS.Context->Binding)) {
         Operation->STATELESS.Context->HasBindingRef = TRUE;
         WakeWorkerThread = QuicWorkerIsIdle(Worker);
@@ -378,17 +763,30 @@ QuicWorkerQueueOperation(
     }
 
     CxPlatDispatchLockRelease(&Worker->Lock);
+#endif
 
     if (Operation != NULL) {
         const QUIC_BINDING* Binding = Operation->STATELESS.Context->Binding;
         const QUIC_RX_PACKET* Packet = Operation->STATELESS.Context->Packet;
-        QuicPacketLogDrop(Binding, Packet, "Worker operation limit reached");
+        QuicPacketLogDrop(Binding, Packet, QUIC_RECV_DROP_QUEUE_FULL, "Worker operation limit reached");
         QuicOperationFree(Operation);
     } else if (WakeWorkerThread) {
         QuicWorkerThreadWake(Worker);
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_INLINE
+void
+QuicWorkerRecordLatency(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_WORKER_LATENCY_TYPE Type,
+    _In_ uint64_t LatencyUs
+    )
+{
+    QuicLatencyHistogramRecord(&Worker->LatencyHistograms[Type], LatencyUs);
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicWorkerUpdateQueueDelay(
@@ -396,7 +794,24 @@ QuicWorkerUpdateQueueDelay(
     _In_ uint32_t TimeInQueueUs
     )
 {
+    QuicWorkerRecordLatency(Worker, QUIC_WORKER_LATENCY_QUEUE_DELAY, TimeInQueueUs);
     Worker->AverageQueueDelay = (7 * Worker->AverageQueueDelay + TimeInQueueUs) / 8;
+
+    //
+    // Adapt the drain budget: back off by a quarter when connections wait too
+    // long for their turn, and creep back up when the queue is short.
+    //
+    if (Worker->AverageQueueDelay > Worker->DrainBudgetTargetDelay) {
+        if (Worker->DrainBudget > Worker->DrainBudgetMin) {
+            uint8_t Decrease = CXPLAT_MAX(1, Worker->DrainBudget / 4);
+            Worker->DrainBudget =
+                CXPLAT_MAX(Worker->DrainBudgetMin, Worker->DrainBudget - Decrease);
+        }
+    } else if (Worker->AverageQueueDelay < Worker->DrainBudgetTargetDelay / 2) {
+        if (Worker->DrainBudget < Worker->DrainBudgetMax) {
+            Worker->DrainBudget++;
+        }
+    }
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -408,14 +823,48 @@ QuicWorkerResetQueueDelay(
     Worker->AverageQueueDelay = 0;
 }
 
+//
+// Returns the next connection to process, and the one queued behind it (if
+// any) so its processing can be prefetched. Queued connections hold a worker
+// reference and only this worker dequeues them, so the next connection stays
+// valid at least until it is returned by a later call.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_CONNECTION*
 QuicWorkerGetNextConnection(
-    _In_ QUIC_WORKER* Worker
+    _In_ QUIC_WORKER* Worker,
+    _Outptr_result_maybenull_ QUIC_CONNECTION** NextConnection
     )
 {
     QUIC_CONNECTION* Connection = NULL;
+    *NextConnection = NULL;
 
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    if (Worker->Enabled && !CxPlatListIsEmpty(&Worker->Connections)) {
+        Connection =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Worker->Connections), QUIC_CONNECTION, WorkerLink);
+        if (Worker->PriorityConnectionsTail == &Connection->WorkerLink.Flink) {
+            Worker->PriorityConnectionsTail = &Worker->Connections.Flink;
+        }
+        Connection->WorkerLinked = FALSE;
+        Connection->HasPriorityWork = FALSE;
+        const short State =
+            QuicWorkerUpdateQueueState(
+                Connection,
+                QUIC_WORKER_QUEUE_PROCESSING,
+                QUIC_WORKER_QUEUE_QUEUED | QUIC_WORKER_QUEUE_PRIORITY);
+        CXPLAT_DBG_ASSERT(State & QUIC_WORKER_QUEUE_QUEUED);
+        CXPLAT_DBG_ASSERT(!(State & QUIC_WORKER_QUEUE_PROCESSING));
+        UNREFERENCED_PARAMETER(State);
+        QuicPerfCounterDecrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
+        if (!CxPlatListIsEmpty(&Worker->Connections)) {
+            *NextConnection =
+                CXPLAT_CONTAINING_RECORD(
+                    Worker->Connections.Flink, QUIC_CONNECTION, WorkerLink);
+        }
+    }
+#else
     if (Worker->Enabled &&
         !CxPlatListIsEmptyNoFence(&Worker->Connections)) {
         CxPlatDispatchLockAcquire(&Worker->Lock);
@@ -432,13 +881,58 @@ QuicWorkerGetNextConnection(
             Connection->HasPriorityWork = FALSE;
             Connection->WorkerProcessing = TRUE;
             QuicPerfCounterDecrement(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH);
+            if (!CxPlatListIsEmpty(&Worker->Connections)) {
+                *NextConnection =
+                    CXPLAT_CONTAINING_RECORD(
+                        Worker->Connections.Flink, QUIC_CONNECTION, WorkerLink);
+            }
         }
         CxPlatDispatchLockRelease(&Worker->Lock);
     }
+#endif
 
     return Connection;
 }
 
+//
+// Prefetches the lines of a queued connection that processing it starts with:
+// its scheduling state, operation queue and timer state.
+//
+QUIC_INLINE
+void
+QuicWorkerPrefetchConnection(
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    CxPlatPrefetch(Connection);
+    CxPlatPrefetch(&Connection->Stats.Schedule);
+    CxPlatPrefetch(&Connection->OperQ);
+    CxPlatPrefetch(&Connection->OperQ.Lanes[QUIC_OPERATION_LANE_COUNT - 1]);
+    CxPlatPrefetch(&Connection->EarliestExpirationTime);
+}
+
+//
+// Prefetches the operation a queued connection will process first. Meant to be
+// called a while after QuicWorkerPrefetchConnection, once the operation queue
+// has likely arrived in the cache. The queue is read without its lock, since
+// the worst a race can cause is a useless prefetch.
+//
+QUIC_INLINE
+void
+QuicWorkerPrefetchFirstOperation(
+    _In_ const QUIC_CONNECTION* Connection
+    )
+{
+    const QUIC_OPERATION_QUEUE* OperQ = &Connection->OperQ;
+    const CXPLAT_LIST_ENTRY* Lane = &OperQ->Lanes[QUIC_OPERATION_LANE_CONTROL];
+    if (Lane->Flink == Lane) {
+        Lane = &OperQ->Lanes[OperQ->CurrentLane % QUIC_OPERATION_LANE_COUNT];
+    }
+    if (Lane->Flink != Lane) {
+        CxPlatPrefetch(CXPLAT_CONTAINING_RECORD(Lane->Flink, QUIC_OPERATION, Link));
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_LISTENER*
 QuicWorkerGetNextListener(
@@ -475,7 +969,9 @@ QuicWorkerGetNextOperation(
     QUIC_OPERATION* Operation = NULL;
 
     if (Worker->Enabled && Worker->OperationCount != 0) {
+#ifndef QUIC_WORKER_LOCKFREE_QUEUE
         CxPlatDispatchLockAcquire(&Worker->Lock);
+#endif
         Operation =
             CXPLAT_CONTAINING_RECORD(
                 CxPlatListRemoveHead(&Worker->Operations), QUIC_OPERATION, Link);
@@ -484,7 +980,11 @@ QuicWorkerGetNextOperation(
 #endif
         Worker->OperationCount--;
         QuicPerfCounterDecrement(Worker->Partition, QUIC_PERF_COUNTER_WORK_OPER_QUEUE_DEPTH);
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+        InterlockedDecrement(&Worker->QueuedOperationCount);
+#else
         CxPlatDispatchLockRelease(&Worker->Lock);
+#endif
     }
 
     return Operation;
@@ -503,7 +1003,15 @@ QuicWorkerProcessTimers(
     //
     CXPLAT_LIST_ENTRY ExpiredTimers;
     CxPlatListInitializeHead(&ExpiredTimers);
+    const uint64_t CascadedConnectionCount =
+        Worker->TimerWheel.CascadedConnectionCount;
     QuicTimerWheelGetExpired(&Worker->TimerWheel, TimeNow, &ExpiredTimers);
+    if (Worker->TimerWheel.CascadedConnectionCount != CascadedConnectionCount) {
+        QuicPerfCounterAdd(
+            Worker->Partition,
+            QUIC_PERF_COUNTER_TIMER_WHEEL_CASCADES,
+            (int64_t)(Worker->TimerWheel.CascadedConnectionCount - CascadedConnectionCount));
+    }
 
     //
     // Indicate to all the connections that have expired timers.
@@ -515,6 +1023,13 @@ QuicWorkerProcessTimers(
         QUIC_CONNECTION* Connection =
             CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, TimerLink);
 
+        if (Connection->EarliestExpirationTime <= TimeNow) {
+            QuicWorkerRecordLatency(
+                Worker,
+                QUIC_WORKER_LATENCY_TIMER_LATENESS,
+                TimeNow - Connection->EarliestExpirationTime);
+        }
+
         Connection->WorkerThreadID = ThreadID;
         QuicConfigurationAttachSilo(Connection->Configuration);
         QuicConnTimerExpired(Connection, TimeNow);
@@ -524,6 +1039,169 @@ QuicWorkerProcessTimers(
     }
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPacingTimerCancel(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    )
+{
+    if (Connection->PacingLink.Flink == NULL) {
+        return;
+    }
+
+    CxPlatListEntryRemove(&Connection->PacingLink);
+    Connection->PacingLink.Flink = NULL;
+    Worker->NextPacingTime =
+        CxPlatListIsEmpty(&Worker->PacingConnections) ?
+            UINT64_MAX :
+            CXPLAT_CONTAINING_RECORD(
+                Worker->PacingConnections.Flink,
+                QUIC_CONNECTION,
+                PacingLink)->PacingTime;
+    QuicConnRelease(Connection, QUIC_CONN_REF_PACING);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPacingTimerSet(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeUs
+    )
+{
+    if (Connection->State.ShutdownComplete) {
+        return;
+    }
+
+    if (Connection->PacingLink.Flink != NULL) {
+        CxPlatListEntryRemove(&Connection->PacingLink);
+    } else {
+        QuicConnAddRef(Connection, QUIC_CONN_REF_PACING);
+    }
+    Connection->PacingTime = TimeUs;
+
+    //
+    // Pacing deadlines are mostly scheduled in increasing order, so search for
+    // the insertion point from the back of the queue.
+    //
+    CXPLAT_LIST_ENTRY* Entry = Worker->PacingConnections.Blink;
+    while (Entry != &Worker->PacingConnections &&
+        CXPLAT_CONTAINING_RECORD(Entry, QUIC_CONNECTION, PacingLink)->PacingTime > TimeUs) {
+        Entry = Entry->Blink;
+    }
+    CxPlatListInsertHead(Entry, &Connection->PacingLink);
+
+    Worker->NextPacingTime =
+        CXPLAT_CONTAINING_RECORD(
+            Worker->PacingConnections.Flink,
+            QUIC_CONNECTION,
+            PacingLink)->PacingTime;
+}
+
+//
+// Flushes the sends of all the connections whose pacer is ready again.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerProcessPacing(
+    _In_ QUIC_WORKER* Worker,
+    _In_ CXPLAT_THREAD_ID ThreadID,
+    _In_ uint64_t TimeNow
+    )
+{
+    //
+    // Pull all the ready connections off first, since flushing may schedule
+    // them again.
+    //
+    CXPLAT_LIST_ENTRY Ready;
+    CxPlatListInitializeHead(&Ready);
+    while (!CxPlatListIsEmpty(&Worker->PacingConnections)) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(
+                Worker->PacingConnections.Flink, QUIC_CONNECTION, PacingLink);
+        if (Connection->PacingTime > TimeNow) {
+            break;
+        }
+        CxPlatListEntryRemove(&Connection->PacingLink);
+        CxPlatListInsertTail(&Ready, &Connection->PacingLink);
+    }
+    Worker->NextPacingTime =
+        CxPlatListIsEmpty(&Worker->PacingConnections) ?
+            UINT64_MAX :
+            CXPLAT_CONTAINING_RECORD(
+                Worker->PacingConnections.Flink,
+                QUIC_CONNECTION,
+                PacingLink)->PacingTime;
+
+    while (!CxPlatListIsEmpty(&Ready)) {
+        QUIC_CONNECTION* Connection =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Ready), QUIC_CONNECTION, PacingLink);
+        Connection->PacingLink.Flink = NULL;
+
+        QuicWorkerRecordLatency(
+            Worker,
+            QUIC_WORKER_LATENCY_TIMER_LATENESS,
+            TimeNow - Connection->PacingTime);
+
+        if (!Connection->State.ShutdownComplete) {
+            Connection->WorkerThreadID = ThreadID;
+            QuicConfigurationAttachSilo(Connection->Configuration);
+            (void)QuicSendFlush(&Connection->Send);
+            QuicConfigurationDetachSilo();
+            Connection->WorkerThreadID = 0;
+        }
+        QuicConnRelease(Connection, QUIC_CONN_REF_PACING);
+    }
+}
+
+//
+// Credits the connection with its weighted quantum for this turn. Returns FALSE
+// if it should be passed over, because it still owes processing time from
+// earlier turns and other connections are waiting.
+//
+QUIC_INLINE
+BOOLEAN
+QuicWorkerTakeSchedulingTurn(
+    _In_ QUIC_WORKER* Worker,
+    _Inout_ QUIC_CONNECTION* Connection
+    )
+{
+    Connection->SchedulingDeficitUs +=
+        (int32_t)(QUIC_WORKER_SCHEDULING_QUANTUM_US * Connection->SchedulingWeight /
+            QUIC_DEFAULT_CONN_SCHEDULING_WEIGHT);
+    if (Connection->SchedulingDeficitUs > 0) {
+        return TRUE;
+    }
+    return
+        CxPlatListIsEmptyNoFence(&Worker->Connections) ||
+        QuicOperationHasPriority(&Connection->OperQ);
+}
+
+//
+// Charges the connection for the time its turn took. A connection that ran
+// out of work doesn't keep its unused credit.
+//
+QUIC_INLINE
+void
+QuicWorkerChargeSchedulingTurn(
+    _Inout_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t DrainTimeUs,
+    _In_ BOOLEAN StillHasWorkToDo
+    )
+{
+    int64_t Deficit =
+        (int64_t)Connection->SchedulingDeficitUs -
+        (int64_t)CXPLAT_MIN(DrainTimeUs, QUIC_WORKER_SCHEDULING_MAX_DEBT_US);
+    if (Deficit < -QUIC_WORKER_SCHEDULING_MAX_DEBT_US) {
+        Deficit = -QUIC_WORKER_SCHEDULING_MAX_DEBT_US;
+    } else if (Deficit > 0 && !StillHasWorkToDo) {
+        Deficit = 0;
+    }
+    Connection->SchedulingDeficitUs = (int32_t)Deficit;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 QuicWorkerProcessConnection(
@@ -565,6 +1243,9 @@ QuicWorkerProcessConnection(
         //
         Connection->State.UpdateWorker = FALSE;
         QuicTimerWheelUpdateConnection(&Worker->TimerWheel, Connection);
+        if (Connection->OutFlowBlockedReasons & QUIC_FLOW_BLOCKED_PACING) {
+            QuicWorkerPacingTimerSet(Worker, Connection, Connection->PacingTime);
+        }
 
         //
         // When the worker changes the app layer needs to be informed so that
@@ -577,22 +1258,98 @@ QuicWorkerProcessConnection(
         (void)QuicConnIndicateEvent(Connection, &Event);
     }
 
-    //
-    // Process some operations.
-    //
+    if (Connection->StealWorker != NULL && Connection->State.AcceptQueued) {
+        //
+        // The connection is still in this worker's accept queue, so it can't
+        // be handed off yet.
+        //
+        Connection->StealWorker = NULL;
+    }
+
+    if (Connection->State.AcceptQueueMove) {
+        //
+        // The app accepted the connection from this worker's accept queue. Move
+        // it to its partition's worker now, as QuicListenerClaimConnection
+        // would have.
+        //
+        Connection->State.AcceptQueueMove = FALSE;
+        if (!Connection->State.ShutdownComplete) {
+            Connection->State.UpdateWorker = TRUE;
+        }
+    }
+
     BOOLEAN StillHasPriorityWork = FALSE;
-    BOOLEAN StillHasWorkToDo =
-        QuicConnDrainOperations(Connection, &StillHasPriorityWork) | Connection->State.UpdateWorker;
+    BOOLEAN StillHasWorkToDo;
+    if (Connection->StealWorker != NULL) {
+        //
+        // An idle worker has claimed this connection. Don't process anything
+        // here; just hand it off below, the same way as if it had changed
+        // partitions. Like a move for RSS, the connection takes an ID in the
+        // new partition, and new source CIDs that encode it.
+        //
+        const uint16_t PartitionIndex = Connection->StealWorker->Partition->Index;
+        if (QuicPartitionIdGetIndex(Connection->PartitionID) != PartitionIndex) {
+            Connection->PartitionID = QuicPartitionIdCreate(PartitionIndex);
+            if (Connection->State.Connected && !Connection->State.ShutdownComplete) {
+                QuicConnGenerateNewSourceCids(Connection, TRUE);
+            }
+        }
+        Connection->State.UpdateWorker = TRUE;
+        StillHasWorkToDo = TRUE;
+    } else if (!QuicWorkerTakeSchedulingTurn(Worker, Connection)) {
+        //
+        // The connection has recently used more than its share of the worker.
+        // Pass it over; it's requeued at the tail below.
+        //
+        StillHasWorkToDo = TRUE;
+    } else {
+        //
+        // Process some operations.
+        //
+        const uint64_t DrainStartTime = CxPlatTimeUs64();
+        StillHasWorkToDo =
+            QuicConnDrainOperations(Connection, &StillHasPriorityWork) | Connection->State.UpdateWorker;
+        *TimeNow = CxPlatTimeUs64();
+        const uint64_t DrainTime = CxPlatTimeDiff64(DrainStartTime, *TimeNow);
+        QuicWorkerRecordLatency(Worker, QUIC_WORKER_LATENCY_DRAIN_TIME, DrainTime);
+        QuicWorkerChargeSchedulingTurn(Connection, DrainTime, StillHasWorkToDo);
+    }
     Connection->WorkerThreadID = 0;
 
     //
     // Determine whether the connection needs to be requeued.
     //
+    BOOLEAN DoneWithConnection = TRUE;
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    if (!Connection->State.UpdateWorker) {
+        short State, NewState;
+        do {
+            State = Connection->WorkerQueueState;
+            NewState = State & ~QUIC_WORKER_QUEUE_PROCESSING;
+            if (StillHasWorkToDo || (State & QUIC_WORKER_QUEUE_QUEUED)) {
+                NewState |= QUIC_WORKER_QUEUE_QUEUED;
+                if (StillHasPriorityWork) {
+                    NewState |= QUIC_WORKER_QUEUE_PRIORITY;
+                }
+            }
+        } while (InterlockedCompareExchange16(&Connection->WorkerQueueState, NewState, State) != State);
+
+        if (NewState & QUIC_WORKER_QUEUE_QUEUED) {
+            Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
+            QuicWorkerLinkConnection(Worker, Connection, StillHasPriorityWork);
+            DoneWithConnection = FALSE;
+        }
+    } else {
+        //
+        // Stay marked as processing until pushed to the new worker.
+        //
+        (void)QuicWorkerUpdateQueueState(Connection, QUIC_WORKER_QUEUE_QUEUED, 0);
+    }
+#else
     CxPlatDispatchLockAcquire(&Worker->Lock);
     Connection->WorkerProcessing = FALSE;
     Connection->HasQueuedWork |= StillHasWorkToDo;
 
-    BOOLEAN DoneWithConnection = TRUE;
     if (!Connection->State.UpdateWorker) {
         if (Connection->HasQueuedWork) {
             Connection->Stats.Schedule.LastQueueTime = CxPlatTimeUs32();
@@ -608,6 +1365,7 @@ QuicWorkerProcessConnection(
         }
     }
     CxPlatDispatchLockRelease(&Worker->Lock);
+#endif
 
     QuicConfigurationDetachSilo();
 
@@ -620,8 +1378,14 @@ QuicWorkerProcessConnection(
             // processed on the other worker.
             //
             QuicTimerWheelRemoveConnection(&Worker->TimerWheel, Connection);
+            QuicWorkerPacingTimerCancel(Worker, Connection);
             CXPLAT_FRE_ASSERT(Connection->Registration != NULL);
-            QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
+            if (Connection->StealWorker != NULL) {
+                QuicWorkerAssignConnection(Connection->StealWorker, Connection);
+                Connection->StealWorker = NULL;
+            } else {
+                QuicRegistrationQueueNewConnection(Connection->Registration, Connection);
+            }
             CXPLAT_DBG_ASSERT(Worker != Connection->Worker);
             QuicWorkerMoveConnection(Connection->Worker, Connection, StillHasPriorityWork);
         }
@@ -684,6 +1448,9 @@ QuicWorkerLoopCleanup(
     // in it's list by the time clean up started. So it needs to release any
     // remaining references on connections.
     //
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    QuicWorkerDrainInboxes(Worker);
+#endif
     int64_t Dequeue = 0;
     while (!CxPlatListIsEmpty(&Worker->Connections)) {
         QUIC_CONNECTION* Connection =
@@ -704,6 +1471,16 @@ QuicWorkerLoopCleanup(
     }
     QuicPerfCounterAdd(Worker->Partition, QUIC_PERF_COUNTER_CONN_QUEUE_DEPTH, Dequeue);
 
+    QuicListenerAbortAcceptQueue(&Worker->AcceptQueue);
+    Worker->AcceptQueueCount = 0;
+
+    while (!CxPlatListIsEmpty(&Worker->PacingConnections)) {
+        QuicWorkerPacingTimerCancel(
+            Worker,
+            CXPLAT_CONTAINING_RECORD(
+                Worker->PacingConnections.Flink, QUIC_CONNECTION, PacingLink));
+    }
+
     Dequeue = 0;
     while (!CxPlatListIsEmpty(&Worker->Listeners)) {
         QUIC_LISTENER* Listener =
@@ -728,6 +1505,54 @@ QuicWorkerLoopCleanup(
     QuicPerfCounterAdd(Worker->Partition, QUIC_PERF_COUNTER_WORK_OPER_QUEUE_DEPTH, Dequeue);
 }
 
+//
+// Returns TRUE if the worker's registration has used up its CPU share of the
+// current period, starting a new period once the current one has elapsed.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+static
+BOOLEAN
+QuicWorkerCpuShareExhausted(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint64_t TimeNow
+    )
+{
+    const uint8_t SharePercent = Worker->Registration->Quota.WorkerCpuSharePercent;
+    if (SharePercent == 0 || SharePercent >= 100) {
+        return FALSE;
+    }
+
+    if (CxPlatTimeDiff64(Worker->CpuSharePeriodStart, TimeNow) >= QUIC_WORKER_CPU_SHARE_PERIOD_US) {
+        Worker->CpuSharePeriodStart = TimeNow;
+        Worker->CpuSharePeriodBusyUs = 0;
+        return FALSE;
+    }
+
+    return
+        Worker->CpuSharePeriodBusyUs * 100 >=
+            (uint64_t)QUIC_WORKER_CPU_SHARE_PERIOD_US * SharePercent;
+}
+
+//
+// Sizes the timer wheel and fills the partition's pools per the app's
+// QUIC_PREWARM_CONFIG. Done on the worker's own thread, so all the workers warm
+// up in parallel and the memory is first touched on the right processor.
+//
+static
+void
+QuicWorkerPrewarm(
+    _Inout_ QUIC_WORKER* Worker
+    )
+{
+    const QUIC_PREWARM_CONFIG Config = MsQuicLib.PrewarmConfig;
+    if (Config.ConnectionCount != 0) {
+        QuicTimerWheelReserve(&Worker->TimerWheel, Config.ConnectionCount);
+    }
+    if (Config.ConnectionCount != 0 || Config.StreamCount != 0) {
+        QuicPartitionPrewarm(Worker->Partition, &Config);
+    }
+}
+
 //
 // Runs one iteration of the worker loop. Returns FALSE when it's time to exit.
 //
@@ -745,32 +1570,95 @@ QuicWorkerLoop(
         return FALSE;
     }
 
+    if (!Worker->Prewarmed) {
+        Worker->Prewarmed = TRUE;
+        QuicWorkerPrewarm(Worker);
+    }
+
     if (!Worker->IsActive) {
         Worker->IsActive = TRUE;
     }
 
+    const QUIC_SETTINGS_INTERNAL* Settings = QuicLibraryGetSettings();
+    if (Worker->Settings != Settings) {
+        Worker->Settings = Settings;
+    }
+
+    if (QuicWorkerCpuShareExhausted(Worker, State->TimeNow)) {
+        //
+        // The registration used up its share of this worker for the current
+        // period. Queued work waits for the next one.
+        //
+        Worker->ExecutionContext.NextTimeUs =
+            Worker->CpuSharePeriodStart + QUIC_WORKER_CPU_SHARE_PERIOD_US;
+        return TRUE;
+    }
+    QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_OTHER);
+    const uint64_t LoopStartTime = State->TimeNow;
+
     //
     // Opportunistically try to snap-shot performance counters and do some
     // validation.
     //
     QuicPerfCounterTrySnapShot(State->TimeNow);
+    QuicLibraryTryRefreshSendBufferMemoryUsage(State->TimeNow);
+
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    QuicWorkerDrainInboxes(Worker);
+#endif
 
     //
     // For every loop of the worker thread, in an attempt to balance things,
-    // first the timer wheel is checked and any expired timers are processed.
-    // Then, a single connection will be processed (if available), followed by a
-    // single stateless operation (if available).
+    // first the pacing queue and timer wheel are checked and any ready paced
+    // sends and expired timers are processed. Then, a single connection will
+    // be processed (if available), followed by a single stateless operation
+    // (if available).
     //
 
+    if (Worker->NextPacingTime <= State->TimeNow) {
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_SEND);
+        QuicWorkerProcessPacing(Worker, State->ThreadID, State->TimeNow);
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_OTHER);
+        State->NoWorkCount = 0;
+    }
+
     if (Worker->TimerWheel.NextExpirationTime != UINT64_MAX &&
         Worker->TimerWheel.NextExpirationTime <= State->TimeNow) {
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_TIMERS);
         QuicWorkerProcessTimers(Worker, State->ThreadID, State->TimeNow);
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_OTHER);
         State->NoWorkCount = 0;
     }
 
-    QUIC_CONNECTION* Connection = QuicWorkerGetNextConnection(Worker);
+    //
+    // While a connection is processed, the next one's lines are prefetched, and
+    // then its first operation, to hide the cache misses of cold connections.
+    //
+    QUIC_CONNECTION* NextConnection;
+    QUIC_CONNECTION* Connection = QuicWorkerGetNextConnection(Worker, &NextConnection);
     if (Connection != NULL) {
+        if (NextConnection != NULL) {
+            QuicWorkerPrefetchConnection(NextConnection);
+        }
         QuicWorkerProcessConnection(Worker, Connection, State->ThreadID, &State->TimeNow);
+        if (NextConnection != NULL) {
+            QuicWorkerPrefetchFirstOperation(NextConnection);
+        }
+        Worker->ExecutionContext.Ready = TRUE;
+        State->NoWorkCount = 0;
+    }
+
+    if (Worker->AcceptQueueCount != 0 &&
+        (Connection == NULL ||
+         Worker->AcceptQueueCount >= QUIC_MAX_ACCEPT_QUEUE_BATCH)) {
+        //
+        // Indicate the accepted connections once there are no more connections
+        // queued ahead of them, or a full batch is waiting.
+        //
+        Worker->AcceptQueueCount = 0;
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_APP_CALLBACK);
+        QuicListenerIndicateAcceptQueue(&Worker->AcceptQueue, State->ThreadID);
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_OTHER);
         Worker->ExecutionContext.Ready = TRUE;
         State->NoWorkCount = 0;
     }
@@ -784,15 +1672,39 @@ QuicWorkerLoop(
 
     QUIC_OPERATION* Operation = QuicWorkerGetNextOperation(Worker);
     if (Operation != NULL) {
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_SEND);
         QuicBindingProcessStatelessOperation(
             Operation->Type,
             Operation->STATELESS.Context);
+        QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_OTHER);
         QuicOperationFree(Operation);
         QuicPerfCounterIncrement(Worker->Partition, QUIC_PERF_COUNTER_WORK_OPER_COMPLETED);
         Worker->ExecutionContext.Ready = TRUE;
         State->NoWorkCount = 0;
     }
 
+    if (State->NoWorkCount == 0) {
+        const uint64_t BusyUs = CxPlatTimeDiff64(LoopStartTime, CxPlatTimeUs64());
+        Worker->BusyTimeUs += BusyUs;
+        Worker->CpuSharePeriodBusyUs += BusyUs;
+    }
+
+    //
+    // Until the next loop, the thread is either waiting or running the
+    // datapath (for execution contexts sharing its thread).
+    //
+    QuicWorkerSetActivity(Worker, QUIC_WORKER_ACTIVITY_IDLE);
+
+    if (MsQuicLib.RetiredObjectCount != 0 &&
+        CxPlatTimeDiff64(Worker->LastReclaimTimeUs, State->TimeNow) >= QUIC_RECLAIM_INTERVAL_US) {
+        //
+        // Objects unlinked from the lock-free lookups are freed here, once
+        // their grace period has ended, rather than by the writers waiting.
+        //
+        Worker->LastReclaimTimeUs = State->TimeNow;
+        QuicLibraryReclaim(FALSE);
+    }
+
     if (Worker->ExecutionContext.Ready) {
         //
         // There is more work to be done.
@@ -800,6 +1712,15 @@ QuicWorkerLoop(
         return TRUE;
     }
 
+    if (Worker->WorkStealing && Worker->Pool->WorkerCount > 1) {
+        //
+        // Out of work. Try to take some off an overloaded neighbour before
+        // going idle. The stolen connection is queued here (and this worker
+        // woken up) once the neighbour hands it off.
+        //
+        (void)QuicWorkerTrySteal(Worker);
+    }
+
     if (MsQuicLib.ExecutionConfig &&
         (uint64_t)MsQuicLib.ExecutionConfig->PollingIdleTimeoutUs >
             CxPlatTimeDiff64(State->LastWorkTime, State->TimeNow)) {
@@ -813,10 +1734,21 @@ QuicWorkerLoop(
 
     //
     // We have no other work to process at the moment. Wait for work to come in
-    // or any timer to expire.
+    // or any timer or pacing deadline to expire.
     //
     Worker->IsActive = FALSE;
-    Worker->ExecutionContext.NextTimeUs = Worker->TimerWheel.NextExpirationTime;
+    Worker->ExecutionContext.NextTimeUs =
+        CXPLAT_MIN(Worker->TimerWheel.NextExpirationTime, Worker->NextPacingTime);
+    if (MsQuicLib.RetiredObjectCount != 0) {
+        //
+        // Check back for the retired objects, which may be holding the last
+        // references on connections.
+        //
+        Worker->ExecutionContext.NextTimeUs =
+            CXPLAT_MIN(
+                Worker->ExecutionContext.NextTimeUs,
+                State->TimeNow + QUIC_RECLAIM_INTERVAL_US);
+    }
     QuicWorkerResetQueueDelay(Worker);
     return TRUE;
 }
@@ -844,6 +1776,16 @@ CXPLAT_THREAD_CALLBACK(QuicWorkerThread, Context)
             if (EC->NextTimeUs == UINT64_MAX) {
                 CxPlatEventWaitForever(Worker->Ready);
 
+            } else if (EC->NextTimeUs > State.TimeNow &&
+                EC->NextTimeUs == Worker->NextPacingTime &&
+                EC->NextTimeUs - State.TimeNow < QUIC_WORKER_PACING_SPIN_US) {
+                //
+                // The event wait is only millisecond granular, which would
+                // delay (and bunch up) paced sends. Yield instead and check
+                // back soon.
+                //
+                CxPlatSchedulerYield();
+
             } else if (EC->NextTimeUs > State.TimeNow) {
                 uint64_t Delay = US_TO_MS(EC->NextTimeUs - State.TimeNow) + 1;
                 if (Delay >= (uint64_t)UINT32_MAX) {
@@ -863,7 +1805,7 @@ CXPLAT_THREAD_CALLBACK(QuicWorkerThread, Context)
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicWorkerPoolInitialize(
-    _In_ const QUIC_REGISTRATION* Registration,
+    _In_ QUIC_REGISTRATION* Registration,
     _In_ QUIC_EXECUTION_PROFILE ExecProfile,
     _Out_ QUIC_WORKER_POOL** NewWorkerPool
     )
@@ -888,6 +1830,7 @@ QuicWorkerPoolInitialize(
 
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     for (uint16_t i = 0; i < WorkerCount; i++) {
+        WorkerPool->Workers[i].Pool = WorkerPool;
         Status =
             QuicWorkerInitialize(
                 Registration,
@@ -926,6 +1869,57 @@ QuicWorkerPoolUninitialize(
     CXPLAT_FREE(WorkerPool, QUIC_POOL_WORKER);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPoolSumLatencyHistograms(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Inout_updates_(QUIC_WORKER_LATENCY_COUNT)
+        QUIC_LATENCY_HISTOGRAM* Histograms
+    )
+{
+    for (uint16_t i = 0; i < WorkerPool->WorkerCount; ++i) {
+        const QUIC_WORKER* Worker = &WorkerPool->Workers[i];
+        for (uint32_t Type = 0; Type < QUIC_WORKER_LATENCY_COUNT; ++Type) {
+            const QUIC_LATENCY_HISTOGRAM* Source = &Worker->LatencyHistograms[Type];
+            QUIC_LATENCY_HISTOGRAM* Sum = &Histograms[Type];
+            Sum->Count += Source->Count;
+            if (Source->MaxUs > Sum->MaxUs) {
+                Sum->MaxUs = Source->MaxUs;
+            }
+            for (uint32_t Bucket = 0; Bucket < QUIC_LATENCY_HISTOGRAM_BUCKET_COUNT; ++Bucket) {
+                Sum->Buckets[Bucket] += Source->Buckets[Bucket];
+            }
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPoolGetMetrics(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Out_writes_(WorkerPool->WorkerCount)
+        QUIC_WORKER_METRICS* Metrics
+    )
+{
+    for (uint16_t i = 0; i < WorkerPool->WorkerCount; ++i) {
+        const QUIC_WORKER* Worker = &WorkerPool->Workers[i];
+        CxPlatZeroMemory(Metrics[i].Reserved, sizeof(Metrics[i].Reserved));
+        Metrics[i].PartitionIndex = Worker->Partition->Index;
+        CxPlatCopyMemory(
+            Metrics[i].Latencies,
+            Worker->LatencyHistograms,
+            sizeof(Metrics[i].Latencies));
+        CxPlatCopyMemory(
+            Metrics[i].Histograms,
+            Worker->MetricHistograms,
+            sizeof(Metrics[i].Histograms));
+        CxPlatCopyMemory(
+            Metrics[i].ActivityTimeUs,
+            Worker->ActivityTimeUs,
+            sizeof(Metrics[i].ActivityTimeUs));
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 QuicWorkerPoolIsOverloaded(
@@ -20,6 +20,22 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     //
     QUIC_PARTITION* Partition;
 
+    //
+    // The pool this worker belongs to.
+    //
+    QUIC_WORKER_POOL* Pool;
+
+    //
+    // The registration that owns this worker.
+    //
+    QUIC_REGISTRATION* Registration;
+
+    //
+    // The NUMA node of the worker's processor. Work is only stolen between
+    // workers on the same node.
+    //
+    uint16_t NumaNode;
+
     //
     // Event to signal when the execution context (i.e. worker thread) is
     // complete.
@@ -41,16 +57,56 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     //
     BOOLEAN IsActive;
 
+    //
+    // TRUE if the worker may steal queued connections from overloaded workers
+    // in the same pool when it runs out of work.
+    //
+    BOOLEAN WorkStealing;
+
+    //
+    // TRUE once the worker has warmed up its timer wheel and partition.
+    //
+    BOOLEAN Prewarmed;
+
+    //
+    // The library settings snapshot the worker currently runs with. Refreshed
+    // by the worker at the start of each loop iteration, and only written when
+    // a new snapshot was published, so other threads can read it too.
+    //
+    const QUIC_SETTINGS_INTERNAL* Settings;
+
     //
     // The average queue delay connections experience, in microseconds.
     //
     uint32_t AverageQueueDelay;
 
+    //
+    // The queue delay (in microseconds) the drain budget is adapted against.
+    //
+    uint32_t DrainBudgetTargetDelay;
+
+    //
+    // The number of operations a connection may currently drain per turn on
+    // this worker, and the bounds it is adapted within, based on the profile.
+    //
+    uint8_t DrainBudget;
+    uint8_t DrainBudgetMin;
+    uint8_t DrainBudgetMax;
+
     //
     // Timers for the worker's connections.
     //
     QUIC_TIMER_WHEEL TimerWheel;
 
+    //
+    // Connections waiting on their pacer, sorted by the time they may send
+    // again, and the earliest of those times. Kept separate from the timer
+    // wheel so paced sends are released with microsecond precision. Only
+    // accessed on the worker thread.
+    //
+    CXPLAT_LIST_ENTRY PacingConnections;
+    uint64_t NextPacingTime;
+
     //
     // An event to kick the thread.
     //
@@ -64,8 +120,28 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     //
     // Serializes access to the connection, listener, and operation lists.
     //
+    // N.B. With QUIC_WORKER_LOCKFREE_QUEUE, only the listener list is protected
+    // by the lock. Other threads push connections and operations onto the
+    // inboxes below and the Connections and Operations lists are then owned
+    // by the worker thread alone.
+    //
     CXPLAT_DISPATCH_LOCK Lock;
 
+#ifdef QUIC_WORKER_LOCKFREE_QUEUE
+    //
+    // Intrusive multi-producer/single-consumer inboxes (LIFO stacks, reversed
+    // back into FIFO order when drained by the worker).
+    //
+    CXPLAT_SLIST_ENTRY* volatile ConnectionInbox;
+    CXPLAT_SLIST_ENTRY* volatile PriorityConnectionInbox;
+    CXPLAT_SLIST_ENTRY* volatile OperationInbox;
+
+    //
+    // Number of stateless operations in the inbox and the Operations list.
+    //
+    long volatile QueuedOperationCount;
+#endif
+
     //
     // Queue of connections with operations to be processed.
     //
@@ -84,8 +160,153 @@ typedef struct QUIC_CACHEALIGN QUIC_WORKER {
     uint32_t OperationCount;
     uint64_t DroppedOperationCount;
 
+    //
+    // Number of connections this worker has stolen from other workers.
+    //
+    uint64_t StolenConnectionCount;
+
+    //
+    // Connections accepted by listeners in accept queue mode, waiting to be
+    // indicated to the app in a batch. Only accessed on the worker thread.
+    //
+    CXPLAT_LIST_ENTRY AcceptQueue;
+    uint32_t AcceptQueueCount;
+
+    //
+    // Total time spent processing work.
+    //
+    uint64_t BusyTimeUs;
+
+    //
+    // Start of the current CPU share period and the time spent processing
+    // work in it. Only used when the registration has a CPU share quota.
+    //
+    uint64_t CpuSharePeriodStart;
+    uint64_t CpuSharePeriodBusyUs;
+
+    //
+    // The last time (in us) the worker freed retired objects (see
+    // QuicLibraryReclaim).
+    //
+    uint64_t LastReclaimTimeUs;
+
+    //
+    // Scratch space for the packet builder to batch encryption and header
+    // protection of sent short header packets. Too large for the stack, and
+    // only one builder is ever in use at a time on the worker thread.
+    //
+    CXPLAT_CRYPT_BATCH_PACKET SendEncryptBatch[QUIC_MAX_SEND_CRYPTO_BATCH_COUNT];
+    uint8_t SendCipherBatch[CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_SEND_CRYPTO_BATCH_COUNT];
+    uint8_t SendHpMask[CXPLAT_HP_SAMPLE_LENGTH * QUIC_MAX_SEND_CRYPTO_BATCH_COUNT];
+
+    //
+    // Histograms of the worker's queue delay, drain time and timer lateness.
+    // Only updated by the worker thread.
+    //
+    QUIC_LATENCY_HISTOGRAM LatencyHistograms[QUIC_WORKER_LATENCY_COUNT];
+
+    //
+    // Histograms of handshake durations, RTTs, packet and batch sizes of the
+    // worker's connections. Only updated by the worker thread.
+    //
+    QUIC_LATENCY_HISTOGRAM MetricHistograms[QUIC_METRIC_HISTOGRAM_COUNT];
+
+    //
+    // Time spent on each activity. The current activity (since
+    // ActivityStartTime) is charged when the worker switches to another one.
+    // Only updated by the worker thread.
+    //
+    QUIC_WORKER_ACTIVITY_TYPE Activity;
+    uint64_t ActivityStartTime;
+    uint64_t ActivityTimeUs[QUIC_WORKER_ACTIVITY_COUNT];
+
+    //
+    // Random bytes for new connection IDs, refilled in bulk so each new CID
+    // doesn't cost a call into the platform's random generator. Only used by
+    // the worker thread.
+    //
+    uint16_t RandomPoolLength;
+    uint8_t RandomPool[QUIC_WORKER_RANDOM_POOL_SIZE];
+
 } QUIC_WORKER;
 
+//
+// Returns the QUIC_LATENCY_HISTOGRAM bucket for the value.
+//
+QUIC_INLINE
+uint32_t
+QuicLatencyHistogramBucket(
+    _In_ uint32_t Value
+    )
+{
+    if (Value < 8) {
+        return Value;
+    }
+
+    uint32_t Log2 = 0;
+    uint32_t Temp = Value;
+    if (Temp & 0xFFFF0000) { Log2 += 16; Temp >>= 16; }
+    if (Temp & 0xFF00) { Log2 += 8; Temp >>= 8; }
+    if (Temp & 0xF0) { Log2 += 4; Temp >>= 4; }
+    if (Temp & 0xC) { Log2 += 2; Temp >>= 2; }
+    if (Temp & 0x2) { Log2 += 1; }
+
+    return ((Log2 - 2) << 3) + ((Value >> (Log2 - 3)) & 7);
+}
+
+QUIC_INLINE
+void
+QuicLatencyHistogramRecord(
+    _Inout_ QUIC_LATENCY_HISTOGRAM* Histogram,
+    _In_ uint64_t Value
+    )
+{
+    Histogram->Buckets[QuicLatencyHistogramBucket((uint32_t)CXPLAT_MIN(Value, UINT32_MAX))]++;
+    Histogram->Count++;
+    if (Value > Histogram->MaxUs) {
+        Histogram->MaxUs = Value;
+    }
+}
+
+//
+// Records a value in one of the worker's metric histograms. Must be called on
+// the worker's thread.
+//
+QUIC_INLINE
+void
+QuicWorkerRecordMetric(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_METRIC_HISTOGRAM_TYPE Type,
+    _In_ uint64_t Value
+    )
+{
+    QuicLatencyHistogramRecord(&Worker->MetricHistograms[Type], Value);
+}
+
+//
+// Charges the time since the last switch to the current activity and starts
+// timing the new one. Returns the previous activity, so nested activities (app
+// callbacks and TLS) can switch back to it. Must be called on the worker's
+// thread.
+//
+QUIC_INLINE
+QUIC_WORKER_ACTIVITY_TYPE
+QuicWorkerSetActivity(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_WORKER_ACTIVITY_TYPE Activity
+    )
+{
+    const QUIC_WORKER_ACTIVITY_TYPE PrevActivity = Worker->Activity;
+    if (Activity != PrevActivity) {
+        const uint64_t TimeNow = CxPlatTimeUs64();
+        Worker->ActivityTimeUs[PrevActivity] +=
+            CxPlatTimeDiff64(Worker->ActivityStartTime, TimeNow);
+        Worker->ActivityStartTime = TimeNow;
+        Worker->Activity = Activity;
+    }
+    return PrevActivity;
+}
+
 //
 // A set of workers.
 //
@@ -120,7 +341,7 @@ QuicWorkerIsOverloaded(
     _In_ QUIC_WORKER* Worker
     )
 {
-    return Worker->AverageQueueDelay > MsQuicLib.Settings.MaxWorkerQueueDelayUs;
+    return Worker->AverageQueueDelay > Worker->Settings->MaxWorkerQueueDelayUs;
 }
 
 //
@@ -129,7 +350,7 @@ QuicWorkerIsOverloaded(
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 QuicWorkerPoolInitialize(
-    _In_ const QUIC_REGISTRATION* Registration,
+    _In_ QUIC_REGISTRATION* Registration,
     _In_ QUIC_EXECUTION_PROFILE ExecProfile,
     _Out_ QUIC_WORKER_POOL** WorkerPool
     );
@@ -143,6 +364,29 @@ QuicWorkerPoolUninitialize(
     _In_ QUIC_WORKER_POOL* WorkerPool
     );
 
+//
+// Adds the latency histograms of all the pool's workers to Histograms.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPoolSumLatencyHistograms(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Inout_updates_(QUIC_WORKER_LATENCY_COUNT)
+        QUIC_LATENCY_HISTOGRAM* Histograms
+    );
+
+//
+// Copies the partition index and histograms of each of the pool's workers to
+// Metrics, which has room for all of them.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPoolGetMetrics(
+    _In_ const QUIC_WORKER_POOL* WorkerPool,
+    _Out_writes_(WorkerPool->WorkerCount)
+        QUIC_WORKER_METRICS* Metrics
+    );
+
 //
 // Returns TRUE if the all the workers in the pool are currently overloaded.
 //
@@ -193,6 +437,29 @@ QuicWorkerQueuePriorityConnection(
     _In_ QUIC_CONNECTION* Connection
     );
 
+//
+// Schedules the connection's next paced send on the worker. Must be called on
+// the worker thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPacingTimerSet(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t TimeUs
+    );
+
+//
+// Cancels the connection's scheduled paced send, if any. Must be called on the
+// worker thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerPacingTimerCancel(
+    _In_ QUIC_WORKER* Worker,
+    _In_ QUIC_CONNECTION* Connection
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 QuicWorkerAssignListener(
@@ -218,6 +485,19 @@ QuicWorkerQueueOperation(
     _In_ QUIC_OPERATION* Operation
     );
 
+//
+// Fills the buffer with random bytes from the worker's pool. Must be called
+// on the worker thread.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicWorkerRandom(
+    _In_ QUIC_WORKER* Worker,
+    _In_ uint16_t Length,
+    _Out_writes_(Length)
+        uint8_t* Buffer
+    );
+
 BOOLEAN
 QuicWorkerPoolIsInPartition(
     _In_ QUIC_WORKER_POOL* WorkerPool,
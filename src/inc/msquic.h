@@ -75,6 +75,11 @@ typedef _In_range_(0, QUIC_UINT62_MAX) uint64_t QUIC_UINT62;
 //
 #define QUIC_STATELESS_RESET_KEY_LENGTH       32
 
+//
+// The number of bytes of QUIC-LB connection ID encryption key.
+//
+#define QUIC_LOAD_BALANCING_KEY_LENGTH        16
+
 typedef enum QUIC_TLS_PROVIDER {
     QUIC_TLS_PROVIDER_SCHANNEL                  = 0x0000,
     QUIC_TLS_PROVIDER_OPENSSL                   = 0x0001,
@@ -91,10 +96,20 @@ typedef enum QUIC_LOAD_BALANCING_MODE {
     QUIC_LOAD_BALANCING_DISABLED,               // Default
     QUIC_LOAD_BALANCING_SERVER_ID_IP,           // Encodes IP address in Server ID
     QUIC_LOAD_BALANCING_SERVER_ID_FIXED,        // Encodes a fixed 4-byte value in Server ID
+    QUIC_LOAD_BALANCING_SERVER_ID_STREAM_CIPHER,// Encrypts a fixed 4-byte Server ID (QUIC-LB stream cipher)
+    QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER, // Encrypts a fixed 4-byte Server ID (QUIC-LB block cipher)
     QUIC_LOAD_BALANCING_COUNT,                  // The number of supported load balancing modes
                                                 // MUST BE LAST
 } QUIC_LOAD_BALANCING_MODE;
 
+typedef enum QUIC_HUGE_PAGE_MODE {
+    QUIC_HUGE_PAGE_DISABLED,                    // Default
+    QUIC_HUGE_PAGE_2MB,                         // Back pools with 2 MiB pages, when available
+    QUIC_HUGE_PAGE_1GB,                         // Back pools with 1 GiB pages, when available
+    QUIC_HUGE_PAGE_COUNT,                       // The number of supported huge page modes
+                                                // MUST BE LAST
+} QUIC_HUGE_PAGE_MODE;
+
 typedef enum QUIC_TLS_ALERT_CODES {
     QUIC_TLS_ALERT_CODE_SUCCESS = 0xFFFF,       // Not a real TlsAlert
     QUIC_TLS_ALERT_CODE_UNEXPECTED_MESSAGE = 10,
@@ -147,6 +162,7 @@ typedef enum QUIC_CREDENTIAL_FLAGS {
     QUIC_CREDENTIAL_FLAG_INPROC_PEER_CERTIFICATE                = 0x00080000, // Schannel only
     QUIC_CREDENTIAL_FLAG_SET_CA_CERTIFICATE_FILE                = 0x00100000, // OpenSSL only currently
     QUIC_CREDENTIAL_FLAG_DISABLE_AIA                            = 0x00200000, // Schannel only currently
+    QUIC_CREDENTIAL_FLAG_OFFLOAD_HANDSHAKE                      = 0x00400000, // Server only, OpenSSL only currently
 } QUIC_CREDENTIAL_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_CREDENTIAL_FLAGS)
@@ -170,6 +186,9 @@ DEFINE_ENUM_FLAG_OPERATORS(QUIC_CERTIFICATE_HASH_STORE_FLAGS)
 typedef enum QUIC_CONNECTION_SHUTDOWN_FLAGS {
     QUIC_CONNECTION_SHUTDOWN_FLAG_NONE      = 0x0000,
     QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT    = 0x0001,   // Don't send the close frame over the network.
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    QUIC_CONNECTION_SHUTDOWN_FLAG_FAST      = 0x0002,   // Send the close frame once and don't wait out the closing period.
+#endif
 } QUIC_CONNECTION_SHUTDOWN_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_CONNECTION_SHUTDOWN_FLAGS)
@@ -190,6 +209,7 @@ DEFINE_ENUM_FLAG_OPERATORS(QUIC_SEND_RESUMPTION_FLAGS)
 typedef enum QUIC_STREAM_SCHEDULING_SCHEME {
     QUIC_STREAM_SCHEDULING_SCHEME_FIFO          = 0x0000,   // Sends stream data first come, first served. (Default)
     QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN   = 0x0001,   // Sends stream data evenly multiplexed.
+    QUIC_STREAM_SCHEDULING_SCHEME_URGENCY       = 0x0002,   // Sends stream data by urgency level, weighted round robin between incremental streams.
     QUIC_STREAM_SCHEDULING_SCHEME_COUNT,                    // The number of stream scheduling schemes.
 } QUIC_STREAM_SCHEDULING_SCHEME;
 
@@ -249,6 +269,7 @@ typedef enum QUIC_SEND_FLAGS {
     QUIC_SEND_FLAG_CANCEL_ON_LOSS           = 0x0020,   // Indicates that a stream is to be cancelled when packet loss is detected.
     QUIC_SEND_FLAG_PRIORITY_WORK            = 0x0040,   // Higher priority than other connection work.
     QUIC_SEND_FLAG_CANCEL_ON_BLOCKED        = 0x0080,   // Indicates that a frame should be dropped when it can't be sent immediately.
+    QUIC_SEND_FLAG_NO_BUFFERING             = 0x0100,   // Indicates the app buffers must be used directly, without copying into the send buffer.
 } QUIC_SEND_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_SEND_FLAGS)
@@ -277,6 +298,15 @@ typedef enum QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS {
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_NO_IDEAL_PROC    = 0x0008,
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_HIGH_PRIORITY    = 0x0010,
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_AFFINITIZE       = 0x0020,
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_WORK_STEALING    = 0x0040,
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_HIERARCHICAL_TIMERS = 0x0080,
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL        = 0x0100, // Spin for PollingIdleTimeoutUs before blocking.
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_URING_FIXED_FILES = 0x0200, // Register socket fds with each io_uring (Linux io_uring only).
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_URING_SQPOLL  = 0x0400, // Kernel thread polls the io_uring submission queues (Linux io_uring only).
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_XDP_SHARED_UMEM  = 0x0800, // XDP queues polled by the same worker share one UMEM (Linux XDP only).
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_EPOLL_EDGE_TRIGGERED = 0x1000, // Edge triggered UDP receives, drained up to a budget (Linux epoll only).
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_CID_STEERING     = 0x2000, // Steer listener packets to the socket of the partition in their CID (Linux epoll and io_uring only).
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_EPOLL_SEND_BATCHING = 0x4000, // Queue sends on shared UDP sockets and flush them together at the end of the worker pass (Linux epoll only).
 } QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS)
@@ -297,6 +327,199 @@ typedef struct QUIC_GLOBAL_EXECUTION_CONFIG {
 #define QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE \
     (uint32_t)FIELD_OFFSET(QUIC_GLOBAL_EXECUTION_CONFIG, ProcessorList)
 
+//
+// When getting QUIC_PARAM_GLOBAL_EXECUTION_CONFIG with a large enough buffer,
+// the NUMA node of each processor in ProcessorList follows the list.
+//
+#define QUIC_GLOBAL_EXECUTION_CONFIG_NUMA_SIZE(ProcessorCount) \
+    (QUIC_GLOBAL_EXECUTION_CONFIG_MIN_SIZE + 2 * sizeof(uint16_t) * (ProcessorCount))
+#define QUIC_GLOBAL_EXECUTION_CONFIG_NUMA_NODES(Config) \
+    ((Config)->ProcessorList + (Config)->ProcessorCount)
+
+//
+// How a worker thread has spent its time. Only tracked for workers using
+// QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL.
+//
+typedef struct QUIC_WORKER_POLL_STATISTICS {
+    uint64_t BusyTimeUs;                // Time spent processing work.
+    uint64_t SpinTimeUs;                // Time spent polling without finding work.
+    uint64_t IdleTimeUs;                // Time spent blocked, waiting for work.
+} QUIC_WORKER_POLL_STATISTICS;
+
+//
+// The latencies each worker keeps a histogram of.
+//
+typedef enum QUIC_WORKER_LATENCY_TYPE {
+    QUIC_WORKER_LATENCY_QUEUE_DELAY,    // Time a connection waited in the worker queue.
+    QUIC_WORKER_LATENCY_DRAIN_TIME,     // Time spent draining a connection's operations.
+    QUIC_WORKER_LATENCY_TIMER_LATENESS, // Time a timer was processed after it expired.
+    QUIC_WORKER_LATENCY_COUNT
+} QUIC_WORKER_LATENCY_TYPE;
+
+//
+// A log-linear (HDR style) histogram of latencies, in microseconds. Values
+// below 8 each have their own bucket; every following power of two is split
+// into 8 linear sub-buckets, giving 12.5% relative precision over the full
+// 32-bit range. Bucket i (i >= 8) starts at (8 + (i & 7)) << ((i >> 3) - 1).
+//
+#define QUIC_LATENCY_HISTOGRAM_BUCKET_COUNT 240
+
+typedef struct QUIC_LATENCY_HISTOGRAM {
+    uint64_t Count;                     // Total number of samples.
+    uint64_t MaxUs;                     // Largest sample.
+    uint64_t Buckets[QUIC_LATENCY_HISTOGRAM_BUCKET_COUNT];
+} QUIC_LATENCY_HISTOGRAM;
+
+//
+// The other distributions each worker keeps a histogram of. They use the
+// QUIC_LATENCY_HISTOGRAM layout, with values in the unit given below (so
+// MaxUs is the largest value, in that unit).
+//
+typedef enum QUIC_METRIC_HISTOGRAM_TYPE {
+    QUIC_METRIC_HISTOGRAM_HANDSHAKE_DURATION,   // Microseconds from connection start to connected.
+    QUIC_METRIC_HISTOGRAM_RTT,                  // Microseconds, every RTT sample.
+    QUIC_METRIC_HISTOGRAM_SEND_PACKET_SIZE,     // Bytes.
+    QUIC_METRIC_HISTOGRAM_SEND_BATCH_SIZE,      // Packets sent per connection send flush.
+    QUIC_METRIC_HISTOGRAM_RECV_BATCH_SIZE,      // Packets processed per connection receive flush.
+    QUIC_METRIC_HISTOGRAM_COUNT
+} QUIC_METRIC_HISTOGRAM_TYPE;
+
+//
+// What a worker spends its time on. Time in the app's callbacks and in TLS is
+// taken out of the activity they were called from.
+//
+typedef enum QUIC_WORKER_ACTIVITY_TYPE {
+    QUIC_WORKER_ACTIVITY_RECEIVE,               // Processing received packets and stream data.
+    QUIC_WORKER_ACTIVITY_SEND,                  // Building and sending packets, including paced sends.
+    QUIC_WORKER_ACTIVITY_CRYPTO,                // Processing TLS messages.
+    QUIC_WORKER_ACTIVITY_TIMERS,                // Processing expired timers.
+    QUIC_WORKER_ACTIVITY_APP_CALLBACK,          // In the app's event callbacks.
+    QUIC_WORKER_ACTIVITY_OTHER,                 // API calls and worker bookkeeping.
+    QUIC_WORKER_ACTIVITY_IDLE,                  // Out of work (or sharing the thread with the datapath).
+    QUIC_WORKER_ACTIVITY_COUNT
+} QUIC_WORKER_ACTIVITY_TYPE;
+
+//
+// Memory usage of one allocation tag (e.g. QUIC_POOL_RECVBUF), counted only
+// while allocation statistics are enabled.
+//
+typedef struct QUIC_ALLOCATION_STATISTICS {
+    uint32_t Tag;                       // The pool tag passed to the allocator.
+    uint32_t AllocationsPerSecond;      // Since the previous query.
+    uint64_t LiveBytes;                 // Currently allocated.
+    uint64_t PeakBytes;                 // Sampled high water mark of LiveBytes.
+    uint64_t TotalAllocations;
+} QUIC_ALLOCATION_STATISTICS;
+
+//
+// The internal objects whose sizes are reported by
+// QUIC_PARAM_GLOBAL_OBJECT_SIZES, to track per-connection memory footprint.
+//
+typedef enum QUIC_OBJECT_SIZE_TYPE {
+    QUIC_OBJECT_SIZE_CONNECTION,            // Always allocated, for the connection's lifetime.
+    QUIC_OBJECT_SIZE_HANDSHAKE_STATE,       // Freed once the handshake is confirmed.
+    QUIC_OBJECT_SIZE_STREAM,
+    QUIC_OBJECT_SIZE_PATH,                  // Included in the connection size.
+    QUIC_OBJECT_SIZE_PACKET_SPACE,          // Allocated per encryption level, as needed.
+    QUIC_OBJECT_SIZE_TRANSPORT_PARAMETERS,  // Allocated during the handshake, as needed.
+    QUIC_OBJECT_SIZE_COUNT
+} QUIC_OBJECT_SIZE_TYPE;
+
+//
+// The trimming policy of one of the size-classed receive buffer pools. Once a
+// second, free buffers above HighWatermark are released, and then DecayPercent
+// of those above LowWatermark (but at least PruneCount of them).
+//
+typedef struct QUIC_POOL_POLICY {
+    uint32_t LowWatermark;
+    uint32_t HighWatermark;
+    uint16_t PruneCount;
+    uint8_t DecayPercent;               // 0 to 100.
+} QUIC_POOL_POLICY;
+
+typedef struct QUIC_POOL_STATISTICS {
+    uint32_t EntrySize;                 // Size of the pool's buffers.
+    uint32_t FreeDepth;                 // Free buffers currently held.
+    uint64_t AllocCount;
+    uint64_t MissCount;                 // Allocations no free buffer was available for.
+    uint64_t PruneCount;                // Free buffers released by the trimming policy.
+} QUIC_POOL_STATISTICS;
+
+//
+// How many objects each partition warms its pools up with, when its worker
+// starts, so the first connections don't pay for the allocations.
+//
+typedef struct QUIC_PREWARM_CONFIG {
+    uint32_t ConnectionCount;           // Per partition. Also sizes the worker's timer wheel.
+    uint32_t StreamCount;               // Per partition.
+} QUIC_PREWARM_CONFIG;
+
+//
+// The filter servers run on client Initial packets before any connection state
+// is allocated. Initial packets are counted per source IP address over windows
+// of WindowMs; a source over RetryThreshold is sent a Retry for Initial packets
+// without a token and a source over DropThreshold has its Initial packets
+// dropped. Off by default.
+//
+typedef struct QUIC_INITIAL_FILTER_CONFIG {
+    BOOLEAN Enabled;
+    uint32_t BucketCount;               // Per-source counters per partition. A power of two. Fixed once the library has started.
+    uint32_t WindowMs;
+    uint32_t RetryThreshold;
+    uint32_t DropThreshold;
+} QUIC_INITIAL_FILTER_CONFIG;
+
+//
+// qlog tracing of sampled connections. One in every SamplingInterval new
+// connections records its events into a ring buffer of BufferSize bytes,
+// overwriting the oldest events once full. A SamplingInterval of 0 turns
+// tracing off.
+//
+typedef struct QUIC_QLOG_CONFIG {
+    uint32_t SamplingInterval;
+    uint32_t BufferSize;                // Rounded up to a power of two.
+} QUIC_QLOG_CONFIG;
+
+//
+// The binary trace returned by QUIC_PARAM_CONN_QLOG: a QUIC_QLOG_HEADER, then
+// Length bytes of events, oldest first. Integers in the header are little
+// endian. Each event is a byte with the length of the rest of the event, a
+// QUIC_QLOG_EVENT_TYPE byte, the time since StartTimeEpochMs in microseconds
+// and then the event's fields, all encoded as QUIC variable length integers.
+//
+#define QUIC_QLOG_MAGIC                 0x474F4C51 // "QLOG"
+#define QUIC_QLOG_VERSION               1
+
+typedef struct QUIC_QLOG_HEADER {
+    uint32_t Magic;
+    uint16_t Version;
+    uint8_t IsServer;
+    uint8_t Reserved;
+    uint64_t CorrelationId;
+    uint64_t StartTimeEpochMs;
+    uint32_t DroppedEvents;             // Overwritten when the buffer was full.
+    uint32_t Length;
+} QUIC_QLOG_HEADER;
+
+typedef enum QUIC_QLOG_EVENT_TYPE {
+    QUIC_QLOG_EVENT_PACKET_SENT,        // KeyType, PacketNumber, Length
+    QUIC_QLOG_EVENT_PACKET_RECEIVED,    // KeyType, PacketNumber, Length
+    QUIC_QLOG_EVENT_PACKET_LOST,        // KeyType, PacketNumber, Length
+    QUIC_QLOG_EVENT_METRICS_UPDATED,    // CongestionWindow, PacketsInFlight, SmoothedRtt, MinRtt, LatestRtt, RttVariance
+    QUIC_QLOG_EVENT_STREAM_STATE,       // StreamId, QUIC_QLOG_STREAM_STATE
+    QUIC_QLOG_EVENT_COUNT
+} QUIC_QLOG_EVENT_TYPE;
+
+//
+// Packet KeyType values: 0 Initial, 1 0-RTT, 2 Handshake, 3 1-RTT.
+//
+
+typedef enum QUIC_QLOG_STREAM_STATE {
+    QUIC_QLOG_STREAM_STATE_OPEN,
+    QUIC_QLOG_STREAM_STATE_SEND_CLOSED,
+    QUIC_QLOG_STREAM_STATE_CLOSED
+} QUIC_QLOG_STREAM_STATE;
+
 #ifndef _KERNEL_MODE
 
 //
@@ -511,6 +734,9 @@ typedef enum QUIC_CONGESTION_CONTROL_ALGORITHM {
     QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC,
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
     QUIC_CONGESTION_CONTROL_ALGORITHM_BBR,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE,
+    QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM,   // Set with QUIC_PARAM_REGISTRATION_CONGESTION_CONTROL
 #endif
     QUIC_CONGESTION_CONTROL_ALGORITHM_MAX,
 } QUIC_CONGESTION_CONTROL_ALGORITHM;
@@ -578,6 +804,14 @@ typedef struct QUIC_STATISTICS {
     } Misc;
 } QUIC_STATISTICS;
 
+typedef enum QUIC_SLOW_START_EXIT_REASON {
+    QUIC_SLOW_START_EXIT_REASON_NONE,           // Still in (or never left) slow start.
+    QUIC_SLOW_START_EXIT_REASON_HYSTART,        // HyStart++ saw the RTT increase and Conservative Slow Start finished.
+    QUIC_SLOW_START_EXIT_REASON_LOSS,
+    QUIC_SLOW_START_EXIT_REASON_ECN,
+    QUIC_SLOW_START_EXIT_REASON_THRESHOLD,      // The window reached the slow start threshold.
+} QUIC_SLOW_START_EXIT_REASON;
+
 //
 // N.B. Consumers of this struct depend on it being the same for 32-bit and
 // 64-bit systems. DO NOT include any fields that have different sizes on those
@@ -637,6 +871,29 @@ typedef struct QUIC_STATISTICS_V2 {
 
     uint32_t RttVariance;                   // In microseconds
 
+    uint32_t DrainBudget;                   // Operations processed per worker turn, at most.
+
+    uint32_t SendPacketFillPercent;         // Average fill of sent 1-RTT packets, before padding.
+
+    uint32_t SlowStartExitReason;           // QUIC_SLOW_START_EXIT_REASON, for the last time slow start ended.
+    uint32_t SlowStartExitCongestionWindow; // Congestion window (bytes) when slow start last ended.
+
+    uint64_t SendSpuriousRetransmissions;   // Ack eliciting packets needlessly retransmitted (declared lost, then acked).
+    uint32_t SendPacketReorderThreshold;    // Current reordering tolerance, in packets.
+    uint32_t SendReorderWindowMultiplier;   // Current reordering tolerance, in eighths of an RTT.
+
+    uint64_t SendFecRepairSymbols;          // FEC repair frames sent to protect datagrams.
+    uint64_t RecvFecRecoveredDatagrams;     // Lost datagrams rebuilt from the peer's FEC repair frames.
+
+    //
+    // Where handshake time went. What remains of (TimingHandshakeComplete -
+    // TimingStart) after the three phases below is spent waiting on the network.
+    //
+    uint64_t TimingHandshakeComplete;       // Handshake completed (connected)
+    uint32_t HandshakeQueueDelay;           // In microseconds. Peer's packets waiting for the worker.
+    uint32_t HandshakeTlsTime;              // In microseconds. Processing in the TLS provider.
+    uint32_t HandshakeCertValidationTime;   // In microseconds. Peer certificate validation, including by the app.
+
     // N.B. New fields must be appended to end
 
 } QUIC_STATISTICS_V2;
@@ -652,6 +909,209 @@ typedef struct QUIC_NETWORK_STATISTICS
 
 } QUIC_NETWORK_STATISTICS;
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// Periodic sampling of a connection's congestion and RTT state, set with
+// QUIC_PARAM_CONN_NETWORK_STATISTICS_SAMPLING. The connection keeps the last
+// SampleCount samples, taken every IntervalMs. An IntervalMs of 0 stops
+// sampling and frees the samples.
+//
+typedef struct QUIC_NETWORK_STATISTICS_SAMPLING {
+    uint32_t IntervalMs;
+    uint32_t SampleCount;               // 0 for the default.
+} QUIC_NETWORK_STATISTICS_SAMPLING;
+
+typedef struct QUIC_NETWORK_STATISTICS_SAMPLE {
+    uint64_t TimeUs;                    // Since the connection started.
+    uint64_t SmoothedRtt;               // In microseconds.
+    uint64_t MinRtt;                    // In microseconds.
+    uint64_t RttVariance;               // In microseconds.
+    uint64_t Bandwidth;                 // Estimated, as for QUIC_NETWORK_STATISTICS.
+    uint64_t LostPackets;               // Suspected lost so far.
+    uint32_t CongestionWindow;
+    uint32_t BytesInFlight;
+} QUIC_NETWORK_STATISTICS_SAMPLE;
+#endif
+
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// A custom congestion controller, registered per registration with
+// QUIC_PARAM_REGISTRATION_CONGESTION_CONTROL and used by the connections that
+// select QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM. MsQuic keeps track of the
+// bytes in flight and of when the connection is congestion blocked; the
+// controller decides the congestion window (and optionally the pacing rate)
+// from the events it is given. Callbacks for a connection are invoked inline,
+// from the connection's worker thread, and must not block or call into MsQuic.
+//
+
+typedef struct QUIC_CONGESTION_CONTROL_ACK_EVENT {
+    uint64_t TimeNow;                       // In microseconds
+    uint64_t LargestAck;
+    uint64_t LargestSentPacketNumber;
+    uint64_t TotalAckedRetransmittableBytes;// Over the connection's lifetime
+    uint64_t SmoothedRtt;                   // In microseconds
+    uint64_t MinRtt;                        // In microseconds, of the packets just acknowledged. Only valid if MinRttValid.
+    uint64_t OneWayDelay;                   // In microseconds. Zero if unknown.
+    uint64_t AdjustedAckTime;               // In microseconds. Ack time minus ack delay.
+    uint32_t NumRetransmittableBytes;       // Newly acknowledged
+    uint32_t BytesInFlight;                 // After removing the acknowledged bytes
+    uint16_t DatagramPayloadSize;           // Current maximum packet payload size
+    BOOLEAN IsImplicit;
+    BOOLEAN HasLoss;
+    BOOLEAN IsLargestAckedPacketAppLimited;
+    BOOLEAN MinRttValid;
+} QUIC_CONGESTION_CONTROL_ACK_EVENT;
+
+typedef struct QUIC_CONGESTION_CONTROL_LOSS_EVENT {
+    uint64_t LargestPacketNumberLost;
+    uint64_t LargestSentPacketNumber;
+    uint32_t NumRetransmittableBytes;       // Newly declared lost
+    uint32_t BytesInFlight;                 // After removing the lost bytes
+    uint16_t DatagramPayloadSize;           // Current maximum packet payload size
+    BOOLEAN PersistentCongestion;
+} QUIC_CONGESTION_CONTROL_LOSS_EVENT;
+
+typedef struct QUIC_CONGESTION_CONTROL_ECN_EVENT {
+    uint64_t LargestPacketNumberAcked;
+    uint64_t LargestSentPacketNumber;
+    uint32_t NewCePackets;                  // Newly reported as CE marked
+    uint32_t BytesInFlight;
+    uint16_t DatagramPayloadSize;           // Current maximum packet payload size
+} QUIC_CONGESTION_CONTROL_ECN_EVENT;
+
+//
+// Creates the controller's state for a new connection.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONGESTION_CONTROL_CREATE_FN)(
+    _In_opt_ void* Context,
+    _In_ HQUIC Connection,
+    _In_ uint16_t DatagramPayloadSize,
+    _In_ uint32_t InitialWindowPackets,
+    _Outptr_ void** State
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_DELETE_FN)(
+    _In_ void* State
+    );
+
+//
+// Called when the path changes or the connection otherwise needs the
+// controller to start over. FullReset also clears the bytes in flight.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_RESET_FN)(
+    _In_ void* State,
+    _In_ BOOLEAN FullReset
+    );
+
+//
+// Returns the congestion window, in bytes.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint32_t
+(QUIC_API * QUIC_CONGESTION_CONTROL_GET_CONGESTION_WINDOW_FN)(
+    _In_ void* State
+    );
+
+//
+// Returns the rate (in bytes per second) to pace sends at, or 0 to not pace.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint64_t
+(QUIC_API * QUIC_CONGESTION_CONTROL_GET_PACING_RATE_FN)(
+    _In_ void* State
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_ON_DATA_SENT_FN)(
+    _In_ void* State,
+    _In_ uint32_t NumRetransmittableBytes,
+    _In_ uint32_t BytesInFlight
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_ON_DATA_ACKNOWLEDGED_FN)(
+    _In_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_ACK_EVENT* AckEvent
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_ON_DATA_LOST_FN)(
+    _In_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_LOSS_EVENT* LossEvent
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_ON_ECN_FN)(
+    _In_ void* State,
+    _In_ const QUIC_CONGESTION_CONTROL_ECN_EVENT* EcnEvent
+    );
+
+//
+// Called when all recently declared lost data was actually acknowledged, so
+// the controller can undo its response to the loss.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONGESTION_CONTROL_ON_SPURIOUS_CONGESTION_EVENT_FN)(
+    _In_ void* State
+    );
+
+typedef struct QUIC_CONGESTION_CONTROL_CALLBACKS {
+    const char* Name;                       // Must stay valid until the registration is closed.
+    void* Context;                          // Passed to Create.
+    BOOLEAN IsL4S;                          // Mark packets ECT(1) instead of ECT(0).
+    QUIC_CONGESTION_CONTROL_CREATE_FN Create;
+    QUIC_CONGESTION_CONTROL_DELETE_FN Delete;                                       // Optional
+    QUIC_CONGESTION_CONTROL_RESET_FN Reset;                                         // Optional
+    QUIC_CONGESTION_CONTROL_GET_CONGESTION_WINDOW_FN GetCongestionWindow;
+    QUIC_CONGESTION_CONTROL_GET_PACING_RATE_FN GetPacingRate;                       // Optional
+    QUIC_CONGESTION_CONTROL_ON_DATA_SENT_FN OnDataSent;                             // Optional
+    QUIC_CONGESTION_CONTROL_ON_DATA_ACKNOWLEDGED_FN OnDataAcknowledged;
+    QUIC_CONGESTION_CONTROL_ON_DATA_LOST_FN OnDataLost;
+    QUIC_CONGESTION_CONTROL_ON_ECN_FN OnEcn;                                        // Optional
+    QUIC_CONGESTION_CONTROL_ON_SPURIOUS_CONGESTION_EVENT_FN OnSpuriousCongestionEvent; // Optional
+} QUIC_CONGESTION_CONTROL_CALLBACKS;
+
+//
+// Resource limits for all the connections of a registration. Zero means no
+// limit for every field.
+//
+typedef struct QUIC_REGISTRATION_QUOTA {
+    uint64_t MaxBufferedBytes;              // Send bytes buffered on behalf of the app.
+    uint32_t MaxConnections;                // New connections are refused past this.
+    uint8_t WorkerCpuSharePercent;          // 1-100. Portion of each worker's time the registration may use.
+} QUIC_REGISTRATION_QUOTA;
+
+//
+// Current resource usage of a registration.
+//
+typedef struct QUIC_REGISTRATION_USAGE {
+    uint64_t BufferedBytes;                 // Send bytes currently buffered.
+    uint64_t WorkerTimeUs;                  // Total time spent processing, over all workers.
+    uint32_t ConnectionCount;               // Currently open connections.
+} QUIC_REGISTRATION_USAGE;
+#endif
+
 #define QUIC_STRUCT_SIZE_THRU_FIELD(Struct, Field) \
     (FIELD_OFFSET(Struct, Field) + sizeof(((Struct*)0)->Field))
 
@@ -703,10 +1163,76 @@ typedef enum QUIC_PERFORMANCE_COUNTERS {
     QUIC_PERF_COUNTER_SEND_STATELESS_RETRY, // Total stateless retry packets sent ever.
     QUIC_PERF_COUNTER_CONN_LOAD_REJECT,     // Total connections rejected due to worker load.
     QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH,   // Current listeners queued for processing.
+    QUIC_PERF_COUNTER_TIMER_WHEEL_CASCADES, // Total connections moved between timer wheel levels.
+    QUIC_PERF_COUNTER_MEMORY_PRESSURE,      // Current memory governor stage: 0 none, 1 shrinking receive windows, 2 limiting send buffering, 3 rejecting connections.
+    QUIC_PERF_COUNTER_CONN_MEMORY_REJECT,   // Total connections rejected due to memory pressure.
+    QUIC_PERF_COUNTER_APP_CALLBACK_SLOW,    // Total app callbacks slower than QUIC_PARAM_GLOBAL_SLOW_CALLBACK_THRESHOLD.
     QUIC_PERF_COUNTER_MAX,
 } QUIC_PERFORMANCE_COUNTERS;
 
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// Why received packets were dropped. QUIC_PARAM_GLOBAL_RECV_DROP_COUNTERS
+// returns a count for each, summed over all partitions; they add up to
+// QUIC_PERF_COUNTER_PKTS_DROPPED.
+//
+typedef enum QUIC_RECV_DROP_REASON {
+    QUIC_RECV_DROP_INVALID_PACKET,          // Malformed, or fails the header checks.
+    QUIC_RECV_DROP_NO_CONNECTION,           // No connection or listener to take it.
+    QUIC_RECV_DROP_DECRYPTION_FAILURE,
+    QUIC_RECV_DROP_DUPLICATE,               // Packet number already received.
+    QUIC_RECV_DROP_KEY_UNAVAILABLE,         // Keys discarded or not yet available, or 0-RTT rejected.
+    QUIC_RECV_DROP_QUEUE_FULL,              // Receive queue, operation or rate limits reached.
+    QUIC_RECV_DROP_OUT_OF_MEMORY,
+    QUIC_RECV_DROP_INVALID_TOKEN,           // Retry or NEW_TOKEN token failed validation.
+    QUIC_RECV_DROP_FILTERED,                // Initial packet filter or blocked source port.
+    QUIC_RECV_DROP_UNEXPECTED,              // Valid, but not expected in the connection's state.
+    QUIC_RECV_DROP_REASON_COUNT
+} QUIC_RECV_DROP_REASON;
+
+//
+// QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT returns a QUIC_METRICS_SNAPSHOT followed
+// by PartitionCount QUIC_PARTITION_METRICS and then WorkerCount
+// QUIC_WORKER_METRICS (of all registrations). The per-partition counters and
+// per-worker histograms are copied as they are, without summing them or
+// synchronizing with the threads updating them, so a scraper can take a
+// snapshot every second at no cost to the datapath. Counters only increase,
+// except the "current" ones, so rates come from the difference between two
+// snapshots.
+//
+typedef struct QUIC_METRICS_SNAPSHOT {
+    uint64_t TimeUs;                    // When the snapshot was taken (monotonic clock).
+    uint32_t PartitionCount;
+    uint32_t WorkerCount;
+} QUIC_METRICS_SNAPSHOT;
+
+typedef struct QUIC_PARTITION_METRICS {
+    int64_t PerfCounters[QUIC_PERF_COUNTER_MAX]; // Partition share; may be negative.
+    int64_t RecvDropCounters[QUIC_RECV_DROP_REASON_COUNT]; // By QUIC_RECV_DROP_REASON.
+} QUIC_PARTITION_METRICS;
+
+typedef struct QUIC_WORKER_METRICS {
+    uint16_t PartitionIndex;            // The partition the worker runs on.
+    uint16_t Reserved[3];
+    QUIC_LATENCY_HISTOGRAM Latencies[QUIC_WORKER_LATENCY_COUNT];
+    QUIC_LATENCY_HISTOGRAM Histograms[QUIC_METRIC_HISTOGRAM_COUNT];
+    uint64_t ActivityTimeUs[QUIC_WORKER_ACTIVITY_COUNT]; // Time spent, by QUIC_WORKER_ACTIVITY_TYPE.
+} QUIC_WORKER_METRICS;
+
+//
+// App callbacks (which run inline on MsQuic's workers, and so hold up all the
+// worker's other connections) that took QUIC_PARAM_GLOBAL_SLOW_CALLBACK_THRESHOLD
+// or longer, by event type, summed over all partitions.
+//
+#define QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES 32
+
+typedef struct QUIC_SLOW_CALLBACK_STATISTICS {
+    uint64_t MaxDurationUs;                                 // The slowest callback so far.
+    uint64_t Listener[QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES];  // By QUIC_LISTENER_EVENT_TYPE.
+    uint64_t Connection[QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES];// By QUIC_CONNECTION_EVENT_TYPE.
+    uint64_t Stream[QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES];    // By QUIC_STREAM_EVENT_TYPE.
+} QUIC_SLOW_CALLBACK_STATISTICS;
+
 typedef struct QUIC_VERSION_SETTINGS {
 
     const uint32_t* AcceptableVersions;
@@ -726,12 +1252,14 @@ typedef struct QUIC_GLOBAL_SETTINGS {
             uint64_t RetryMemoryLimit                       : 1;
             uint64_t LoadBalancingMode                      : 1;
             uint64_t FixedServerID                          : 1;
-            uint64_t RESERVED                               : 61;
+            uint64_t HugePageMode                           : 1;
+            uint64_t RESERVED                               : 60;
         } IsSet;
     };
     uint16_t RetryMemoryLimit;
     uint16_t LoadBalancingMode;
     uint32_t FixedServerID;
+    uint16_t HugePageMode;                  // QUIC_HUGE_PAGE_MODE
 } QUIC_GLOBAL_SETTINGS;
 
 typedef struct QUIC_SETTINGS {
@@ -786,7 +1314,17 @@ typedef struct QUIC_SETTINGS {
             uint64_t XdpEnabled                             : 1;
             uint64_t QTIPEnabled                            : 1;
             uint64_t ReservedRioEnabled                     : 1;
-            uint64_t RESERVED                               : 18;
+            uint64_t IdleTimerSlackMs                       : 1;
+            uint64_t KeepAliveTimerSlackMs                  : 1;
+            uint64_t ShutdownTimerSlackMs                   : 1;
+            uint64_t AckDecimationMaxPackets                : 1;
+            uint64_t DatacenterModeEnabled                  : 1;
+            uint64_t FecEnabled                             : 1;
+            uint64_t PathMetricsCacheEnabled                : 1;
+            uint64_t PacingBurstPackets                     : 1;
+            uint64_t StreamZeroCopyReceiveEnabled           : 1;
+            uint64_t IdleHibernateTimeoutMs                 : 1;
+            uint64_t RESERVED                               : 8;
 #else
             uint64_t RESERVED                               : 26;
 #endif
@@ -830,25 +1368,35 @@ typedef struct QUIC_SETTINGS {
     union {
         uint64_t Flags;
         struct {
-            uint64_t HyStartEnabled            : 1;
+            uint64_t HyStartEnabled               : 1;
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
-            uint64_t EncryptionOffloadAllowed  : 1;
-            uint64_t ReliableResetEnabled      : 1;
-            uint64_t OneWayDelayEnabled        : 1;
-            uint64_t NetStatsEventEnabled      : 1;
-            uint64_t StreamMultiReceiveEnabled : 1;
-            uint64_t XdpEnabled                : 1;
-            uint64_t QTIPEnabled               : 1;
-            uint64_t ReservedRioEnabled        : 1;
-            uint64_t ReservedFlags             : 55;
+            uint64_t EncryptionOffloadAllowed     : 1;
+            uint64_t ReliableResetEnabled         : 1;
+            uint64_t OneWayDelayEnabled           : 1;
+            uint64_t NetStatsEventEnabled         : 1;
+            uint64_t StreamMultiReceiveEnabled    : 1;
+            uint64_t XdpEnabled                   : 1;
+            uint64_t QTIPEnabled                  : 1;
+            uint64_t ReservedRioEnabled           : 1;
+            uint64_t DatacenterModeEnabled        : 1;
+            uint64_t FecEnabled                   : 1;
+            uint64_t PathMetricsCacheEnabled      : 1;
+            uint64_t StreamZeroCopyReceiveEnabled : 1;
+            uint64_t ReservedFlags                : 51;
 #else
-            uint64_t ReservedFlags             : 63;
+            uint64_t ReservedFlags                : 63;
 #endif
         };
     };
     uint32_t StreamRecvWindowBidiLocalDefault;
     uint32_t StreamRecvWindowBidiRemoteDefault;
     uint32_t StreamRecvWindowUnidiDefault;
+    uint32_t IdleTimerSlackMs;
+    uint32_t KeepAliveTimerSlackMs;
+    uint32_t ShutdownTimerSlackMs;
+    uint32_t AckDecimationMaxPackets;
+    uint32_t PacingBurstPackets;
+    uint32_t IdleHibernateTimeoutMs;
 
 } QUIC_SETTINGS;
 
@@ -887,6 +1435,28 @@ typedef struct QUIC_STREAM_STATISTICS {
     uint64_t StreamBlockedByAppUs;
 } QUIC_STREAM_STATISTICS;
 
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+//
+// RFC 9218 style stream priority, used by QUIC_STREAM_SCHEDULING_SCHEME_URGENCY.
+//
+typedef struct QUIC_STREAM_URGENCY {
+    uint8_t Urgency;                        // 0 (most urgent) to 7 (least urgent) - 3 (default)
+    BOOLEAN Incremental;                    // Interleave with other incremental streams of the same urgency.
+    uint8_t Weight;                         // Packets per round robin turn, if incremental. 0 uses the default.
+} QUIC_STREAM_URGENCY;
+
+//
+// Receive event batching, set with QUIC_PARAM_STREAM_RECEIVE_BATCHING. The
+// stream holds back QUIC_STREAM_EVENT_RECEIVE until Threshold bytes are ready,
+// the FIN arrives or TimeoutUs passes. A Threshold of 0 (the default)
+// indicates data as soon as it arrives.
+//
+typedef struct QUIC_STREAM_RECEIVE_BATCHING {
+    uint32_t Threshold;                     // Bytes.
+    uint32_t TimeoutUs;                     // 0 uses the default.
+} QUIC_STREAM_RECEIVE_BATCHING;
+#endif
+
 typedef enum QUIC_AEAD_ALGORITHM_TYPE {
     QUIC_AEAD_ALGORITHM_AES_128_GCM = 0,
     QUIC_AEAD_ALGORITHM_AES_256_GCM = 1,
@@ -973,10 +1543,36 @@ void
 #define QUIC_PARAM_GLOBAL_STATELESS_RESET_KEY           0x0100000B  // uint8_t[] - Array size is QUIC_STATELESS_RESET_KEY_LENGTH
 #define QUIC_PARAM_GLOBAL_STATISTICS_V2_SIZES           0x0100000C  // uint32_t[] - Array of sizes for each QUIC_STATISTICS_V2 version. Get-only. Pass a buffer of uint32_t, output count is variable. See documentation for details.
 #define QUIC_PARAM_GLOBAL_STATELESS_RETRY_CONFIG        0x0100000D  // QUIC_STATELESS_RETRY_CONFIG
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+#define QUIC_PARAM_GLOBAL_WORKER_POLL_STATISTICS        0x0100000E  // QUIC_WORKER_POLL_STATISTICS[] - One per worker thread. Get-only.
+#define QUIC_PARAM_GLOBAL_WORKER_LATENCY_HISTOGRAMS     0x0100000F  // QUIC_LATENCY_HISTOGRAM[QUIC_WORKER_LATENCY_COUNT] - Summed over all workers. Get-only.
+#endif
+#define QUIC_PARAM_GLOBAL_LOAD_BALANCING_KEY            0x01000010  // uint8_t[] - Array size is QUIC_LOAD_BALANCING_KEY_LENGTH. Set-only.
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+#define QUIC_PARAM_GLOBAL_ALLOCATION_STATISTICS         0x01000011  // QUIC_ALLOCATION_STATISTICS[] - One per tag. Set a BOOLEAN to enable or disable tracking.
+#define QUIC_PARAM_GLOBAL_OBJECT_SIZES                  0x01000012  // uint32_t[] - Indexed by QUIC_OBJECT_SIZE_TYPE. Get-only. Output count is variable.
+#define QUIC_PARAM_GLOBAL_RECV_POOL_POLICY              0x01000013  // QUIC_POOL_POLICY[] - One per receive buffer size class, smallest first.
+#define QUIC_PARAM_GLOBAL_RECV_POOL_STATISTICS          0x01000014  // QUIC_POOL_STATISTICS[] - One per receive buffer size class, summed over all partitions. Get-only.
+#define QUIC_PARAM_GLOBAL_PERSISTENT_CACHE_PATH         0x01000015  // char[] - Null-terminated path of the file client resumption tickets and path metrics persist in. Empty to stop persisting. Set after MsQuicOpen.
+#define QUIC_PARAM_GLOBAL_QLOG_CONFIG                   0x01000016  // QUIC_QLOG_CONFIG - Applies to connections created afterwards.
+#define QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT              0x01000017  // QUIC_METRICS_SNAPSHOT, then per-partition and per-worker metrics. Get-only.
+#define QUIC_PARAM_GLOBAL_SLOW_CALLBACK_THRESHOLD       0x01000018  // uint32_t - Microseconds an app callback may take before it's counted as slow. 0 (default) disables timing callbacks.
+#define QUIC_PARAM_GLOBAL_SLOW_CALLBACK_STATISTICS      0x01000019  // QUIC_SLOW_CALLBACK_STATISTICS - Get-only.
+#define QUIC_PARAM_GLOBAL_RECV_DROP_COUNTERS            0x0100001A  // uint64_t[] - Array size is QUIC_RECV_DROP_REASON_COUNT. Get-only.
+#define QUIC_PARAM_GLOBAL_PREWARM_CONFIG                0x0100001B  // QUIC_PREWARM_CONFIG - Applies to workers started afterwards.
+#define QUIC_PARAM_GLOBAL_INITIAL_FILTER_CONFIG         0x0100001C  // QUIC_INITIAL_FILTER_CONFIG
+#endif
 
 //
 // Parameters for Registration.
 //
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+#define QUIC_PARAM_REGISTRATION_CONGESTION_CONTROL      0x02000000  // QUIC_CONGESTION_CONTROL_CALLBACKS. Set-only, before any connection is opened.
+#define QUIC_PARAM_REGISTRATION_QUOTA                   0x02000001  // QUIC_REGISTRATION_QUOTA
+#define QUIC_PARAM_REGISTRATION_USAGE                   0x02000002  // QUIC_REGISTRATION_USAGE - Get-only.
+#define QUIC_PARAM_REGISTRATION_DRAIN                   0x02000003  // BOOLEAN - Refuse new connections and close each existing one once it has no open streams.
+#define QUIC_PARAM_REGISTRATION_EGRESS_RATE_LIMIT       0x02000004  // uint64_t - Bytes per second sent by all the registration's connections together. 0 (default) is unlimited.
+#endif
 
 //
 // Parameters for Configuration.
@@ -1002,6 +1598,7 @@ typedef struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W {
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_LISTENER_CIBIR_ID                    0x04000002  // uint8_t[] {offset, id[]}
 #define QUIC_PARAM_LISTENER_PARTITION_INDEX             0x04000005  // uint16_t
+#define QUIC_PARAM_LISTENER_ACCEPT_QUEUE                0x04000006  // BOOLEAN
 #endif
 #define QUIC_PARAM_DOS_MODE_EVENTS                      0x04000004  // BOOLEAN
 
@@ -1041,6 +1638,15 @@ typedef struct QUIC_SCHANNEL_CREDENTIAL_ATTRIBUTE_W {
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_CONN_NETWORK_STATISTICS              0x05000020  // struct QUIC_NETWORK_STATISTICS
 #define QUIC_PARAM_CONN_CLOSE_ASYNC                     0x0500001A  // uint8_t
+#define QUIC_PARAM_CONN_DATAGRAM_CLASS_RATES            0x0500001B  // uint32_t[QUIC_DATAGRAM_PRIORITY_CLASS_COUNT]
+#define QUIC_PARAM_CONN_QLOG                            0x0500001C  // uint8_t[] - QUIC_QLOG_HEADER and events. Get-only. Not found unless the connection was sampled.
+#define QUIC_PARAM_CONN_NETWORK_STATISTICS_SAMPLING     0x0500001D  // Set: QUIC_NETWORK_STATISTICS_SAMPLING. Get: QUIC_NETWORK_STATISTICS_SAMPLE[], oldest first.
+#define QUIC_PARAM_CONN_PARALLEL_PROTECTION             0x0500001E  // uint8_t (BOOLEAN) - Seal full 1-RTT packet batches on helper threads.
+#define QUIC_PARAM_CONN_SEND_CORK_TIMEOUT               0x0500001F  // uint32_t - Max us to hold small stream sends for coalescing. 0 (default) disables.
+#define QUIC_PARAM_CONN_DATAGRAM_RECEIVE_BATCHING       0x05000021  // uint8_t (BOOLEAN) - Indicate received datagrams as QUIC_CONNECTION_EVENT_DATAGRAMS_RECEIVED.
+#define QUIC_PARAM_CONN_EGRESS_RATE_LIMIT               0x05000022  // uint64_t - Bytes per second. 0 (default) is unlimited.
+#define QUIC_PARAM_CONN_SCHEDULING_WEIGHT               0x05000023  // uint8_t - 1-255. Share of its worker's time relative to other connections. Default 16.
+#define QUIC_PARAM_CONN_TAIL_PROTECTION                 0x05000024  // uint8_t (BOOLEAN) - Probe early (~1.25 SRTT) for the lost tail of small flights.
 #endif
 
 //
@@ -1074,6 +1680,8 @@ typedef struct QUIC_SCHANNEL_CONTEXT_ATTRIBUTE_EX_W {
 #define QUIC_PARAM_STREAM_STATISTICS                    0X08000004  // QUIC_STREAM_STATISTICS
 #ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
 #define QUIC_PARAM_STREAM_RELIABLE_OFFSET               0x08000005  // uint64_t
+#define QUIC_PARAM_STREAM_URGENCY                       0x08000006  // QUIC_STREAM_URGENCY
+#define QUIC_PARAM_STREAM_RECEIVE_BATCHING              0x08000007  // QUIC_STREAM_RECEIVE_BATCHING
 #endif
 
 typedef
@@ -1226,6 +1834,9 @@ typedef enum QUIC_LISTENER_EVENT_TYPE {
     QUIC_LISTENER_EVENT_NEW_CONNECTION      = 0,
     QUIC_LISTENER_EVENT_STOP_COMPLETE       = 1,
     QUIC_LISTENER_EVENT_DOS_MODE_CHANGED    = 2,
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+    QUIC_LISTENER_EVENT_NEW_CONNECTIONS     = 3,    // Only with QUIC_PARAM_LISTENER_ACCEPT_QUEUE set
+#endif
 } QUIC_LISTENER_EVENT_TYPE;
 
 typedef struct QUIC_LISTENER_EVENT {
@@ -1243,6 +1854,14 @@ typedef struct QUIC_LISTENER_EVENT {
             BOOLEAN DosModeEnabled : 1;
             BOOLEAN RESERVED       : 7;
         } DOS_MODE_CHANGED;
+#ifdef QUIC_API_ENABLE_PREVIEW_FEATURES
+        struct {
+            uint32_t Count;
+            const HQUIC* Connections;
+            const QUIC_NEW_CONNECTION_INFO* const* Infos;
+            QUIC_STATUS* Statuses;      // Set to a failure to reject that connection.
+        } NEW_CONNECTIONS;
+#endif
     };
 } QUIC_LISTENER_EVENT;
 
@@ -1337,6 +1956,7 @@ typedef enum QUIC_CONNECTION_EVENT_TYPE {
     QUIC_CONNECTION_EVENT_RELIABLE_RESET_NEGOTIATED         = 16,   // Only indicated if QUIC_SETTINGS.ReliableResetEnabled is TRUE.
     QUIC_CONNECTION_EVENT_ONE_WAY_DELAY_NEGOTIATED          = 17,   // Only indicated if QUIC_SETTINGS.OneWayDelayEnabled is TRUE.
     QUIC_CONNECTION_EVENT_NETWORK_STATISTICS                = 18,   // Only indicated if QUIC_SETTINGS.EnableNetStatsEvent is TRUE.
+    QUIC_CONNECTION_EVENT_DATAGRAMS_RECEIVED                = 19,   // Only indicated if QUIC_PARAM_CONN_DATAGRAM_RECEIVE_BATCHING is TRUE.
 #endif
 } QUIC_CONNECTION_EVENT_TYPE;
 
@@ -1420,6 +2040,11 @@ typedef struct QUIC_CONNECTION_EVENT {
             BOOLEAN ReceiveNegotiated;          // TRUE if receiving one-way delay timestamps is negotiated.
         } ONE_WAY_DELAY_NEGOTIATED;
         QUIC_NETWORK_STATISTICS NETWORK_STATISTICS;
+        struct {
+            const QUIC_BUFFER* Buffers;         // Valid only until the callback returns.
+            uint32_t BufferCount;
+            QUIC_RECEIVE_FLAGS Flags;           // Applies to every buffer in the batch.
+        } DATAGRAMS_RECEIVED;
 #endif
     };
 } QUIC_CONNECTION_EVENT;
@@ -1747,6 +2372,51 @@ QUIC_STATUS
     _In_reads_(BufferCount) const QUIC_BUFFER* Buffers
     );
 
+//
+// Starts a batch of streams, all opened on the same connection, with a single
+// queued operation. The flags apply to every stream, and each stream's start
+// completion is indicated individually, as for StreamStart.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_STREAM_START_BATCH_FN)(
+    _In_ uint32_t StreamCount,
+    _In_reads_(StreamCount) _Pre_defensive_ const HQUIC* Streams,
+    _In_ QUIC_STREAM_START_FLAGS Flags
+    );
+
+//
+// Datagrams are sent strictly in priority class order, highest first. Class 0
+// is the default, and QUIC_SEND_FLAG_DGRAM_PRIORITY selects the highest class.
+// Each class can also be rate limited (in bytes per second) with
+// QUIC_PARAM_CONN_DATAGRAM_CLASS_RATES.
+//
+#define QUIC_DATAGRAM_PRIORITY_CLASS_COUNT  4
+
+typedef struct QUIC_DATAGRAM_SEND_DESC {
+    const QUIC_BUFFER* Buffers;
+    uint32_t BufferCount;
+    QUIC_SEND_FLAGS Flags;
+    uint32_t DeadlineMs;                // Relative to the call. 0 means no deadline.
+    uint8_t PriorityClass;              // Less than QUIC_DATAGRAM_PRIORITY_CLASS_COUNT.
+    void* ClientContext;
+} QUIC_DATAGRAM_SEND_DESC;
+
+//
+// Queues a batch of datagrams with a single call. A datagram still queued when
+// its deadline passes is dropped and indicated as QUIC_DATAGRAM_SEND_CANCELED
+// instead of being sent late.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_DATAGRAM_SEND_BATCH_FN)(
+    _In_ _Pre_defensive_ HQUIC Connection,
+    _In_ uint32_t DatagramCount,
+    _In_reads_(DatagramCount) _Pre_defensive_ const QUIC_DATAGRAM_SEND_DESC* Datagrams
+    );
+
 #endif
 
 //
@@ -1778,6 +2448,7 @@ QUIC_STATUS
 typedef enum QUIC_CONNECTION_POOL_FLAGS {
     QUIC_CONNECTION_POOL_FLAG_NONE =                            0x00000000,
     QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE =                0x00000001,
+    QUIC_CONNECTION_POOL_FLAG_SHARE_RESUMPTION_TICKET =         0x00000002, // Managed pools only
 } QUIC_CONNECTION_POOL_FLAGS;
 
 DEFINE_ENUM_FLAG_OPERATORS(QUIC_CONNECTION_POOL_FLAGS);
@@ -1798,6 +2469,9 @@ typedef struct QUIC_CONNECTION_POOL_CONFIG {
         uint8_t** CibirIds;                     // Optional
     uint8_t CibirIdLength;                      // Zero if not using CIBIR
     QUIC_CONNECTION_POOL_FLAGS Flags;
+    _Field_size_bytes_opt_(ResumptionTicketLength)
+        const uint8_t* ResumptionTicket;        // Optional
+    uint32_t ResumptionTicketLength;
 } QUIC_CONNECTION_POOL_CONFIG;
 
 //
@@ -1807,6 +2481,10 @@ typedef struct QUIC_CONNECTION_POOL_CONFIG {
 // If NumberOfConnections is more than the number of RSS cores, then multiple
 // connections will be put on the same CPU.
 //
+// The handshakes run in parallel on the connections' RSS CPUs after this
+// returns. If ResumptionTicket is set, every connection resumes with it, and
+// may send 0-RTT data if the ticket allows it.
+//
 typedef
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
@@ -1816,6 +2494,152 @@ QUIC_STATUS
         HQUIC* ConnectionPool
     );
 
+//
+// Opens a managed pool of Config->NumberOfConnections connections, spread
+// across RSS CPUs like ConnectionPoolCreate. The pool owns the connections: it
+// replaces any that fail or shut down (with exponential backoff for ones that
+// fail to connect) and re-spreads them when the local address changes.
+//
+// All connection events are delivered to Config->Handler with the matching
+// Config->Context entry. The app must not close, or change the context or
+// callback handler of, pool connections.
+//
+// With QUIC_CONNECTION_POOL_FLAG_SHARE_RESUMPTION_TICKET, the latest ticket
+// received by any pool connection is used by the connections created after
+// it, instead of Config->ResumptionTicket. Only set it if the server allows
+// tickets to be reused.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONN_POOL_OPEN_FN)(
+    _In_ QUIC_CONNECTION_POOL_CONFIG* Config,
+    _Outptr_ _At_(*Pool, __drv_allocatesMem(Mem)) _Pre_defensive_
+        HQUIC* Pool
+    );
+
+//
+// Closes a managed connection pool and all its connections. Every connection
+// handed out by ConnectionPoolAcquire must have been released first. Must not
+// be called from a connection callback.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+(QUIC_API * QUIC_CONN_POOL_CLOSE_FN)(
+    _In_ _Pre_defensive_ __drv_freesMem(Mem)
+        HQUIC Pool
+    );
+
+//
+// Returns the least loaded connection of a managed pool, preferring connected
+// ones with congestion window headroom and the fewest streams in flight. The
+// connection stays valid until it is passed to ConnectionPoolRelease.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONN_POOL_ACQUIRE_FN)(
+    _In_ _Pre_defensive_ HQUIC Pool,
+    _Out_ HQUIC* Connection
+    );
+
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+(QUIC_API * QUIC_CONN_POOL_RELEASE_FN)(
+    _In_ _Pre_defensive_ HQUIC Pool,
+    _In_ _Pre_defensive_ HQUIC Connection
+    );
+
+//
+// Sets the same configuration on a batch of server connections, such as the
+// ones indicated by QUIC_LISTENER_EVENT_NEW_CONNECTIONS. The configuration is
+// validated once, and then queued on each connection as for
+// ConnectionSetConfiguration.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONNECTION_SET_CONFIGURATION_BATCH_FN)(
+    _In_ uint32_t ConnectionCount,
+    _In_reads_(ConnectionCount) _Pre_defensive_ const HQUIC* Connections,
+    _In_ _Pre_defensive_ HQUIC Configuration
+    );
+
+//
+// Runs app logic on the connection's worker, as part of its operation drain,
+// where API calls on the connection and its streams execute inline instead of
+// queuing operations. Status is QUIC_STATUS_ABORTED (and the connection must
+// not be used) if the connection was closed before the handler could run.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_CONNECTION_EXECUTE_HANDLER)
+void
+(QUIC_API QUIC_CONNECTION_EXECUTE_HANDLER)(
+    _In_ HQUIC Connection,
+    _In_opt_ void* Context,
+    _In_ QUIC_STATUS Status
+    );
+
+//
+// Runs the handler immediately if called from the connection's worker while
+// it is draining the connection (e.g. from one of its callbacks), returning
+// QUIC_STATUS_SUCCESS. Otherwise, queues it to the connection and returns
+// QUIC_STATUS_PENDING.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_CONNECTION_EXECUTE_FN)(
+    _In_ _Pre_defensive_ HQUIC Connection,
+    _In_ _Pre_defensive_ QUIC_CONNECTION_EXECUTE_HANDLER* Handler,
+    _In_opt_ void* Context
+    );
+
+typedef struct QUIC_STREAM_SEND_DESC {
+    HQUIC Stream;
+    const QUIC_BUFFER* Buffers;
+    uint32_t BufferCount;
+    QUIC_SEND_FLAGS Flags;
+    void* ClientSendContext;
+} QUIC_STREAM_SEND_DESC;
+
+//
+// Sends on a set of streams, all on the same connection, with a single queued
+// operation (and so a single send flush), e.g. to fan data out to many
+// streams. Each send completes individually, as for StreamSend; sends on a
+// stream whose send direction was already shut down complete as canceled.
+//
+typedef
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_STREAM_SEND_BATCH_FN)(
+    _In_ uint32_t SendCount,
+    _In_reads_(SendCount) _Pre_defensive_ const QUIC_STREAM_SEND_DESC* Sends
+    );
+
+//
+// Sends Length bytes of an open file, starting at Offset, on the stream. The
+// range is mapped read-only and packets are built straight from the mapped
+// pages, so the data never passes through an app buffer. The mapping is
+// released before QUIC_STREAM_EVENT_SEND_COMPLETE is indicated; the file must
+// not be truncated before then. Flags are as for StreamSend, except the data
+// is never copied into the send buffer.
+//
+typedef
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+(QUIC_API * QUIC_STREAM_SEND_FILE_FN)(
+    _In_ _Pre_defensive_ HQUIC Stream,
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _In_ QUIC_SEND_FLAGS Flags,
+    _In_opt_ void* ClientSendContext
+    );
+
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
 
 //
@@ -1882,6 +2706,17 @@ typedef struct QUIC_API_TABLE {
     QUIC_EXECUTION_POLL_FN              ExecutionPoll;      // Available from v2.5
 #endif // _KERNEL_MODE
     QUIC_REGISTRATION_CLOSE2_FN         RegistrationClose2; // Available from v2.6
+    QUIC_STREAM_START_BATCH_FN          StreamStartBatch;   // Available from v2.6
+    QUIC_DATAGRAM_SEND_BATCH_FN         DatagramSendBatch;  // Available from v2.6
+    QUIC_CONN_POOL_OPEN_FN              ConnectionPoolOpen;     // Available from v2.6
+    QUIC_CONN_POOL_CLOSE_FN             ConnectionPoolClose;    // Available from v2.6
+    QUIC_CONN_POOL_ACQUIRE_FN           ConnectionPoolAcquire;  // Available from v2.6
+    QUIC_CONN_POOL_RELEASE_FN           ConnectionPoolRelease;  // Available from v2.6
+    QUIC_CONNECTION_SET_CONFIGURATION_BATCH_FN
+                                        ConnectionSetConfigurationBatch; // Available from v2.6
+    QUIC_CONNECTION_EXECUTE_FN          ConnectionExecute;      // Available from v2.6
+    QUIC_STREAM_SEND_BATCH_FN           StreamSendBatch;        // Available from v2.6
+    QUIC_STREAM_SEND_FILE_FN            StreamSendFile;         // Available from v2.6
 #endif // QUIC_API_ENABLE_PREVIEW_FEATURES
 
 } QUIC_API_TABLE;
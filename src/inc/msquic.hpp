@@ -738,6 +738,10 @@ public:
     MsQuicSettings& SetOneWayDelayEnabled(bool value) { OneWayDelayEnabled = value; IsSet.OneWayDelayEnabled = TRUE; return *this; }
     MsQuicSettings& SetNetStatsEventEnabled(bool value) { NetStatsEventEnabled = value; IsSet.NetStatsEventEnabled = TRUE; return *this; }
     MsQuicSettings& SetStreamMultiReceiveEnabled(bool value) { StreamMultiReceiveEnabled = value; IsSet.StreamMultiReceiveEnabled = TRUE; return *this; }
+    MsQuicSettings& SetDatacenterModeEnabled(bool value) { DatacenterModeEnabled = value; IsSet.DatacenterModeEnabled = TRUE; return *this; }
+    MsQuicSettings& SetFecEnabled(bool value) { FecEnabled = value; IsSet.FecEnabled = TRUE; return *this; }
+    MsQuicSettings& SetPathMetricsCacheEnabled(bool value) { PathMetricsCacheEnabled = value; IsSet.PathMetricsCacheEnabled = TRUE; return *this; }
+    MsQuicSettings& SetStreamZeroCopyReceiveEnabled(bool value) { StreamZeroCopyReceiveEnabled = value; IsSet.StreamZeroCopyReceiveEnabled = TRUE; return *this; }
 #endif
 
     QUIC_STATUS
@@ -1434,6 +1438,18 @@ struct MsQuicConnection {
                 Length,
                 Value);
     }
+
+    //
+    // Runs Handler on the connection's worker; inline (returning success) if
+    // already there.
+    //
+    QUIC_STATUS
+    Execute(
+        _In_ QUIC_CONNECTION_EXECUTE_HANDLER* Handler,
+        _In_opt_ void* HandlerContext = nullptr
+        ) noexcept {
+        return MsQuic->ConnectionExecute(Handle, Handler, HandlerContext);
+    }
 #endif
 
     QUIC_STATUS GetInitStatus() const noexcept { return InitStatus; }
@@ -1933,4 +1949,524 @@ struct QuicBufferScope {
 
 static_assert(sizeof(QuicBufferScope) == sizeof(QUIC_BUFFER*), "Scope guards should be the same size as the guarded type");
 
+#if !defined(_KERNEL_MODE) && defined(__cpp_impl_coroutine)
+
+//
+// C++20 coroutine wrappers: co_await Connection.Connect(...), Stream.Send(...),
+// Stream.Receive() and so on. The coroutine is resumed inline on the MsQuic
+// worker that delivered the completion, so it must not block (the same as a
+// callback), unless an executor is given to post it to instead. No operation
+// allocates: a send's completion state lives in its awaiter, in the coroutine
+// frame, and is passed to MsQuic as the send context.
+//
+
+#include <coroutine>
+#include <mutex>
+
+struct MsQuicCoExecutor {
+    void (*Post)(void* Context, std::coroutine_handle<> Coroutine);
+    void* Context;
+};
+
+inline
+void
+MsQuicCoResume(
+    _In_opt_ const MsQuicCoExecutor* Executor,
+    _In_ std::coroutine_handle<> Coroutine
+    ) noexcept {
+    if (Executor) {
+        Executor->Post(Executor->Context, Coroutine);
+    } else {
+        Coroutine.resume();
+    }
+}
+
+//
+// Data received on a stream. It stays valid until the app calls
+// ReceiveComplete; after completing less than TotalLength, ReceiveSetEnabled
+// must be called to receive the rest.
+//
+struct MsQuicCoReceive {
+    QUIC_STATUS Status {QUIC_STATUS_SUCCESS}; // Failed if the stream was aborted.
+    const QUIC_BUFFER* Buffers {nullptr};
+    uint32_t BufferCount {0};
+    uint64_t TotalLength {0};
+    bool Fin {false};                         // No more data follows.
+};
+
+struct MsQuicCoStream : public MsQuicStream {
+    const MsQuicCoExecutor* Executor;
+    MsQuicCoStream* Next {nullptr};           // Connection's accept queue.
+
+    MsQuicCoStream(
+        _In_ const MsQuicConnection& Connection,
+        _In_ QUIC_STREAM_OPEN_FLAGS Flags = QUIC_STREAM_OPEN_FLAG_NONE,
+        _In_opt_ const MsQuicCoExecutor* Executor = nullptr
+        ) noexcept :
+        MsQuicStream(Connection, Flags, CleanUpManual, CoCallback, this),
+        Executor(Executor) { }
+
+    MsQuicCoStream(
+        _In_ HQUIC StreamHandle,
+        _In_opt_ const MsQuicCoExecutor* Executor = nullptr
+        ) noexcept :
+        MsQuicStream(StreamHandle, CleanUpManual, CoCallback, this),
+        Executor(Executor) { }
+
+    ~MsQuicCoStream() noexcept {
+        Close(); // Before the state the callback uses goes away.
+    }
+
+    struct StartAwaitable {
+        MsQuicCoStream* Stream;
+        QUIC_STREAM_START_FLAGS Flags;
+        QUIC_STATUS Status {QUIC_STATUS_SUCCESS};
+        std::coroutine_handle<> Coroutine {};
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> Handle) noexcept {
+            Coroutine = Handle;
+            Stream->StartWaiter = this;
+            QUIC_STATUS StartStatus = MsQuic->StreamStart(*Stream, Flags);
+            if (QUIC_FAILED(StartStatus)) {
+                Stream->StartWaiter = nullptr;
+                Status = StartStatus;
+                return false;
+            }
+            return true; // May already be resumed and gone.
+        }
+        QUIC_STATUS await_resume() const noexcept { return Status; }
+    };
+
+    //
+    // Starts the stream, completing when the peer allows it (or it fails).
+    //
+    StartAwaitable
+    Start(
+        _In_ QUIC_STREAM_START_FLAGS Flags = QUIC_STREAM_START_FLAG_NONE
+        ) noexcept {
+        return StartAwaitable{this, Flags};
+    }
+
+    struct SendAwaitable {
+        MsQuicCoStream* Stream;
+        const QUIC_BUFFER* Buffers;
+        uint32_t BufferCount;
+        QUIC_SEND_FLAGS Flags;
+        QUIC_STATUS Status {QUIC_STATUS_SUCCESS};
+        std::coroutine_handle<> Coroutine {};
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> Handle) noexcept {
+            Coroutine = Handle;
+            QUIC_STATUS SendStatus =
+                MsQuic->StreamSend(*Stream, Buffers, BufferCount, Flags, this);
+            if (QUIC_FAILED(SendStatus)) {
+                Status = SendStatus;
+                return false;
+            }
+            return true; // May already be resumed and gone.
+        }
+        QUIC_STATUS await_resume() const noexcept { return Status; }
+    };
+
+    //
+    // Sends on co_await, completing when MsQuic is done with the buffers,
+    // which (and the QUIC_BUFFER array) must stay valid until then. All sends
+    // on the stream must use this, as it owns the send context.
+    //
+    SendAwaitable
+    Send(
+        _In_reads_(BufferCount) const QUIC_BUFFER* Buffers,
+        _In_ uint32_t BufferCount = 1,
+        _In_ QUIC_SEND_FLAGS Flags = QUIC_SEND_FLAG_NONE
+        ) noexcept {
+        return SendAwaitable{this, Buffers, BufferCount, Flags};
+    }
+
+    struct ReceiveAwaitable {
+        MsQuicCoStream* Stream;
+        MsQuicCoReceive Result {};
+        std::coroutine_handle<> Coroutine {};
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> Handle) noexcept {
+            std::lock_guard<std::mutex> Lock(Stream->Lock);
+            if (Stream->TakeReceive(Result)) {
+                return false;
+            }
+            Coroutine = Handle;
+            Stream->ReceiveWaiter = this;
+            return true;
+        }
+        MsQuicCoReceive await_resume() const noexcept { return Result; }
+    };
+
+    //
+    // Completes with the next received data, a Fin once the peer finished
+    // sending, or a failure if the stream was aborted.
+    //
+    ReceiveAwaitable Receive() noexcept { return ReceiveAwaitable{this}; }
+
+private:
+    std::mutex Lock;
+    MsQuicCoReceive PendingReceive;
+    bool HasPendingReceive {false};
+    bool PeerSendShutdown {false};
+    QUIC_STATUS ShutdownStatus {QUIC_STATUS_SUCCESS};
+    StartAwaitable* StartWaiter {nullptr};
+    ReceiveAwaitable* ReceiveWaiter {nullptr};
+
+    //
+    // Gets the receive result, if there is one yet. Called with the lock held.
+    //
+    bool
+    TakeReceive(
+        _Out_ MsQuicCoReceive& Result
+        ) noexcept {
+        Result = MsQuicCoReceive();
+        if (HasPendingReceive) {
+            Result = PendingReceive;
+            HasPendingReceive = false;
+        } else if (PeerSendShutdown) {
+            Result.Fin = true;
+        } else if (QUIC_FAILED(ShutdownStatus)) {
+            Result.Status = ShutdownStatus;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    //
+    // Resumes the waiting receive, if the result is now known.
+    //
+    void
+    WakeReceive(
+        _In_ std::unique_lock<std::mutex>& Held
+        ) noexcept {
+        ReceiveAwaitable* Waiter = ReceiveWaiter;
+        if (Waiter && TakeReceive(Waiter->Result)) {
+            ReceiveWaiter = nullptr;
+            Held.unlock();
+            MsQuicCoResume(Executor, Waiter->Coroutine);
+        }
+    }
+
+    static
+    QUIC_STATUS
+    QUIC_API
+    CoCallback(
+        _In_ MsQuicStream* /* Stream */,
+        _In_opt_ void* Context,
+        _Inout_ QUIC_STREAM_EVENT* Event
+        ) noexcept {
+        auto pThis = (MsQuicCoStream*)Context; CXPLAT_DBG_ASSERT(pThis);
+        QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+        std::unique_lock<std::mutex> Held(pThis->Lock);
+        switch (Event->Type) {
+        case QUIC_STREAM_EVENT_START_COMPLETE: {
+            StartAwaitable* Waiter = pThis->StartWaiter;
+            pThis->StartWaiter = nullptr;
+            Held.unlock();
+            if (Waiter) {
+                Waiter->Status = Event->START_COMPLETE.Status;
+                MsQuicCoResume(pThis->Executor, Waiter->Coroutine);
+            }
+            break;
+        }
+        case QUIC_STREAM_EVENT_RECEIVE:
+            if (Event->RECEIVE.TotalBufferLength == 0) {
+                //
+                // Nothing to hold on to; a FIN is reported with PEER_SEND_SHUTDOWN.
+                //
+                break;
+            }
+            pThis->PendingReceive.Status = QUIC_STATUS_SUCCESS;
+            pThis->PendingReceive.Buffers = Event->RECEIVE.Buffers;
+            pThis->PendingReceive.BufferCount = Event->RECEIVE.BufferCount;
+            pThis->PendingReceive.TotalLength = Event->RECEIVE.TotalBufferLength;
+            pThis->PendingReceive.Fin = (Event->RECEIVE.Flags & QUIC_RECEIVE_FLAG_FIN) != 0;
+            pThis->HasPendingReceive = true;
+            Status = QUIC_STATUS_PENDING; // Until the app calls ReceiveComplete.
+            pThis->WakeReceive(Held);
+            break;
+        case QUIC_STREAM_EVENT_SEND_COMPLETE: {
+            Held.unlock();
+            auto Send = (SendAwaitable*)Event->SEND_COMPLETE.ClientContext;
+            Send->Status =
+                Event->SEND_COMPLETE.Canceled ? QUIC_STATUS_ABORTED : QUIC_STATUS_SUCCESS;
+            MsQuicCoResume(pThis->Executor, Send->Coroutine);
+            break;
+        }
+        case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
+            pThis->PeerSendShutdown = true;
+            pThis->WakeReceive(Held);
+            break;
+        case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
+            pThis->ShutdownStatus = QUIC_STATUS_ABORTED;
+            pThis->WakeReceive(Held);
+            break;
+        case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+            if (QUIC_SUCCEEDED(pThis->ShutdownStatus)) {
+                pThis->ShutdownStatus =
+                    Event->SHUTDOWN_COMPLETE.ConnectionShutdown &&
+                    QUIC_FAILED(Event->SHUTDOWN_COMPLETE.ConnectionCloseStatus) ?
+                        Event->SHUTDOWN_COMPLETE.ConnectionCloseStatus : QUIC_STATUS_ABORTED;
+            }
+            pThis->WakeReceive(Held);
+            break;
+        default:
+            break;
+        }
+        return Status;
+    }
+};
+
+struct MsQuicCoConnection : public MsQuicConnection {
+    const MsQuicCoExecutor* Executor;
+
+    MsQuicCoConnection(
+        _In_ const MsQuicRegistration& Registration,
+        _In_opt_ const MsQuicCoExecutor* Executor = nullptr
+        ) noexcept :
+        MsQuicConnection(Registration, CleanUpManual, CoCallback, this),
+        Executor(Executor) { }
+
+    //
+    // For a connection from QUIC_LISTENER_EVENT_NEW_CONNECTION.
+    //
+    MsQuicCoConnection(
+        _In_ HQUIC ConnectionHandle,
+        _In_opt_ const MsQuicCoExecutor* Executor = nullptr
+        ) noexcept :
+        MsQuicConnection(ConnectionHandle, CleanUpManual, CoCallback, this),
+        Executor(Executor) { }
+
+    ~MsQuicCoConnection() noexcept {
+        Close();
+        while (AcceptQueue) {
+            MsQuicCoStream* Stream = AcceptQueue;
+            AcceptQueue = Stream->Next;
+            delete Stream;
+        }
+    }
+
+    struct HandshakeAwaitable {
+        MsQuicCoConnection* Connection;
+        QUIC_STATUS Status {QUIC_STATUS_SUCCESS};
+        std::coroutine_handle<> Coroutine {};
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> Handle) noexcept {
+            std::lock_guard<std::mutex> Lock(Connection->Lock);
+            if (Connection->TakeHandshake(Status)) {
+                return false;
+            }
+            Coroutine = Handle;
+            Connection->HandshakeWaiter = this;
+            return true;
+        }
+        QUIC_STATUS await_resume() const noexcept { return Status; }
+    };
+
+    //
+    // Starts the handshake, completing when it does (or fails).
+    //
+    HandshakeAwaitable
+    Connect(
+        _In_ const MsQuicConfiguration& Config,
+        _In_reads_or_z_opt_(QUIC_MAX_SNI_LENGTH)
+            const char* ServerName,
+        _In_ uint16_t ServerPort // Host byte order
+        ) noexcept {
+        HandshakeAwaitable Awaitable{this};
+        QUIC_STATUS StartStatus = MsQuicConnection::Start(Config, ServerName, ServerPort);
+        if (QUIC_FAILED(StartStatus)) {
+            std::lock_guard<std::mutex> Lock(this->Lock);
+            if (QUIC_SUCCEEDED(HandshakeStatus)) {
+                HandshakeStatus = StartStatus;
+            }
+        }
+        return Awaitable;
+    }
+
+    //
+    // Completes when the handshake does (or fails). For accepted connections.
+    //
+    HandshakeAwaitable Connected() noexcept { return HandshakeAwaitable{this}; }
+
+    struct AcceptAwaitable {
+        MsQuicCoConnection* Connection;
+        MsQuicCoStream* Stream {nullptr};
+        std::coroutine_handle<> Coroutine {};
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> Handle) noexcept {
+            std::lock_guard<std::mutex> Lock(Connection->Lock);
+            if (Connection->TakeStream(Stream)) {
+                return false;
+            }
+            Coroutine = Handle;
+            Connection->AcceptWaiter = this;
+            return true;
+        }
+        MsQuicCoStream* await_resume() const noexcept { return Stream; }
+    };
+
+    //
+    // Completes with the next stream started by the peer, which the app then
+    // owns, or nullptr once the connection is shutting down.
+    //
+    AcceptAwaitable AcceptStream() noexcept { return AcceptAwaitable{this}; }
+
+    struct ShutdownAwaitable {
+        MsQuicCoConnection* Connection;
+        std::coroutine_handle<> Coroutine {};
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> Handle) noexcept {
+            std::lock_guard<std::mutex> Lock(Connection->Lock);
+            if (Connection->CoShutdownComplete) {
+                return false;
+            }
+            Coroutine = Handle;
+            Connection->ShutdownWaiter = this;
+            return true;
+        }
+        void await_resume() const noexcept { }
+    };
+
+    //
+    // Starts the shutdown; awaiting it waits for the shutdown to complete.
+    //
+    ShutdownAwaitable
+    Shutdown(
+        _In_ _Pre_defensive_ QUIC_UINT62 ErrorCode, // Application defined error code
+        _In_ QUIC_CONNECTION_SHUTDOWN_FLAGS Flags = QUIC_CONNECTION_SHUTDOWN_FLAG_NONE
+        ) noexcept {
+        MsQuicConnection::Shutdown(ErrorCode, Flags);
+        return ShutdownAwaitable{this};
+    }
+
+private:
+    std::mutex Lock;
+    bool CoHandshakeComplete {false};
+    QUIC_STATUS HandshakeStatus {QUIC_STATUS_SUCCESS}; // Failed once shutting down.
+    bool CoShutdownComplete {false};
+    MsQuicCoStream* AcceptQueue {nullptr};
+    MsQuicCoStream** AcceptQueueTail {&AcceptQueue};
+    HandshakeAwaitable* HandshakeWaiter {nullptr};
+    AcceptAwaitable* AcceptWaiter {nullptr};
+    ShutdownAwaitable* ShutdownWaiter {nullptr};
+
+    //
+    // The Take* functions get a result, if there is one yet. Called with the
+    // lock held.
+    //
+    bool
+    TakeHandshake(
+        _Out_ QUIC_STATUS& Status
+        ) noexcept {
+        Status = HandshakeStatus;
+        return CoHandshakeComplete || QUIC_FAILED(HandshakeStatus);
+    }
+
+    bool
+    TakeStream(
+        _Out_ MsQuicCoStream*& Stream
+        ) noexcept {
+        Stream = AcceptQueue;
+        if (Stream) {
+            if ((AcceptQueue = Stream->Next) == nullptr) {
+                AcceptQueueTail = &AcceptQueue;
+            }
+            Stream->Next = nullptr;
+            return true;
+        }
+        return QUIC_FAILED(HandshakeStatus) || CoShutdownComplete;
+    }
+
+    //
+    // Resumes each waiter whose result is now known.
+    //
+    void
+    Wake(
+        _In_ std::unique_lock<std::mutex>& Held
+        ) noexcept {
+        HandshakeAwaitable* Handshake = HandshakeWaiter;
+        if (Handshake && TakeHandshake(Handshake->Status)) {
+            HandshakeWaiter = nullptr;
+        } else {
+            Handshake = nullptr;
+        }
+        AcceptAwaitable* Accept = AcceptWaiter;
+        if (Accept && TakeStream(Accept->Stream)) {
+            AcceptWaiter = nullptr;
+        } else {
+            Accept = nullptr;
+        }
+        ShutdownAwaitable* Shutdown = ShutdownWaiter;
+        if (Shutdown && CoShutdownComplete) {
+            ShutdownWaiter = nullptr;
+        } else {
+            Shutdown = nullptr;
+        }
+        Held.unlock();
+        if (Handshake) {
+            MsQuicCoResume(Executor, Handshake->Coroutine);
+        }
+        if (Accept) {
+            MsQuicCoResume(Executor, Accept->Coroutine);
+        }
+        if (Shutdown) {
+            MsQuicCoResume(Executor, Shutdown->Coroutine);
+        }
+    }
+
+    static
+    QUIC_STATUS
+    QUIC_API
+    CoCallback(
+        _In_ MsQuicConnection* /* Connection */,
+        _In_opt_ void* Context,
+        _Inout_ QUIC_CONNECTION_EVENT* Event
+        ) noexcept {
+        auto pThis = (MsQuicCoConnection*)Context; CXPLAT_DBG_ASSERT(pThis);
+        std::unique_lock<std::mutex> Held(pThis->Lock);
+        switch (Event->Type) {
+        case QUIC_CONNECTION_EVENT_CONNECTED:
+            pThis->CoHandshakeComplete = true;
+            break;
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_TRANSPORT:
+            if (QUIC_SUCCEEDED(pThis->HandshakeStatus)) {
+                pThis->HandshakeStatus = Event->SHUTDOWN_INITIATED_BY_TRANSPORT.Status;
+            }
+            break;
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_INITIATED_BY_PEER:
+            if (QUIC_SUCCEEDED(pThis->HandshakeStatus)) {
+                pThis->HandshakeStatus = QUIC_STATUS_ABORTED;
+            }
+            break;
+        case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+            if (QUIC_SUCCEEDED(pThis->HandshakeStatus)) {
+                pThis->HandshakeStatus = QUIC_STATUS_ABORTED;
+            }
+            pThis->CoShutdownComplete = true;
+            break;
+        case QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED: {
+            auto Stream =
+                new(std::nothrow) MsQuicCoStream(
+                    Event->PEER_STREAM_STARTED.Stream, pThis->Executor);
+            if (!Stream) {
+                return QUIC_STATUS_OUT_OF_MEMORY;
+            }
+            *pThis->AcceptQueueTail = Stream;
+            pThis->AcceptQueueTail = &Stream->Next;
+            break;
+        }
+        default:
+            return QUIC_STATUS_SUCCESS;
+        }
+        pThis->Wake(Held);
+        return QUIC_STATUS_SUCCESS;
+    }
+};
+
+#endif // !_KERNEL_MODE && __cpp_impl_coroutine
+
 #endif  //  _MSQUIC_HPP_
@@ -176,6 +176,8 @@ typedef union QUIC_ADDR {
     struct sockaddr_in6 Ipv6;
 } QUIC_ADDR;
 
+typedef int QUIC_FILE_HANDLE;
+
 #ifndef RTL_FIELD_SIZE
 #define RTL_FIELD_SIZE(type, field)     (sizeof(((type *)0)->field))
 #endif
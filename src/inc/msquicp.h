@@ -126,6 +126,59 @@ typedef struct QUIC_PRIVATE_TRANSPORT_PARAMETER {
 //
 #define QUIC_PARAM_GLOBAL_DATAPATH_DSCP_RECV_ENABLED    0x81000007 // BOOLEAN
 
+//
+// Sets whether the datapath will be initialized to capture kernel receive
+// timestamps, which are then used for RTT samples and ACK delay instead of the
+// time the packet is processed.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_RECV_TIMESTAMPS_ENABLED 0x81000008 // BOOLEAN
+
+//
+// Sets whether the datapath will be initialized to hand send departure times to
+// the kernel (SO_TXTIME), so pacing is done by the qdisc instead of by the
+// pacing timer. Requires the fq qdisc (or similar) on the outgoing interface.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_SEND_TXTIME_ENABLED 0x81000009 // BOOLEAN
+
+typedef struct QUIC_XDP_QUEUE_INFO {
+    uint32_t InterfaceIndex;
+    uint16_t QueueId;
+    BOOLEAN NativeMode;     // The XDP program is attached in native (driver) mode.
+    BOOLEAN ZeroCopy;       // The AF_XDP socket is bound in zero-copy mode.
+    uint64_t TxRingFullCount;       // Sends dropped because the TX ring was full.
+    uint64_t FillRingEmptyCount;    // Times the fill ring was found drained.
+    uint32_t TxCompletionLag;       // TX frames submitted but not yet reaped.
+    uint32_t TxCompletionLagMax;    // The largest TxCompletionLag seen.
+} QUIC_XDP_QUEUE_INFO;
+
+//
+// Gets the mode and counters of each queue of the XDP datapath. Empty if the
+// XDP datapath isn't in use.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_XDP_QUEUES 0x8100000A // QUIC_XDP_QUEUE_INFO[] - Get-only.
+
+typedef struct QUIC_XDP_TX_COMPLETION_CONFIG {
+    uint32_t BatchSize;     // Min completions to reap at once. 0 = default.
+    uint32_t HighWatermark; // Outstanding TX frames above which all completions are reaped. 0 = default.
+} QUIC_XDP_TX_COMPLETION_CONFIG;
+
+//
+// Controls how the XDP datapath reaps TX completions. Only settable before
+// the datapath is initialized.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_XDP_TX_COMPLETION 0x8100000B // QUIC_XDP_TX_COMPLETION_CONFIG
+
+typedef struct QUIC_DATAPATH_STATISTICS {
+    uint64_t RecvCalls;         // Receive calls that returned data.
+    uint64_t RecvMessages;      // Messages (possibly coalesced) returned by them.
+    uint32_t RecvBatchSizeAvg;  // RecvMessages / RecvCalls.
+} QUIC_DATAPATH_STATISTICS;
+
+//
+// Gets the receive statistics of the (non-XDP) datapath.
+//
+#define QUIC_PARAM_GLOBAL_DATAPATH_STATISTICS 0x8100000C // QUIC_DATAPATH_STATISTICS - Get-only.
+
 //
 // The different private parameters for Configuration.
 //
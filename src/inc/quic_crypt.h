@@ -196,6 +196,38 @@ QuicPacketKeyCreateInitial(
     _Out_opt_ QUIC_PACKET_KEY** WriteKey
     );
 
+//
+// Derives the client and server Initial secrets from the static version
+// specific salt and the client's original destination CID.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatTlsDeriveInitialSecrets(
+    _In_reads_(CXPLAT_VERSION_SALT_LENGTH)
+        const uint8_t* const Salt,  // Version Specific
+    _In_reads_(CIDLength)
+        const uint8_t* const CID,
+    _In_ uint8_t CIDLength,
+    _Out_ CXPLAT_SECRET *ClientInitial,
+    _Out_ CXPLAT_SECRET *ServerInitial
+    );
+
+//
+// Creates Initial packet keys from already derived Initial secrets.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_When_(ReadKey != NULL, _At_(*ReadKey, __drv_allocatesMem(Mem)))
+_When_(WriteKey != NULL, _At_(*WriteKey, __drv_allocatesMem(Mem)))
+QUIC_STATUS
+QuicPacketKeyCreateInitialFromSecrets(
+    _In_ BOOLEAN IsServer,
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_ const CXPLAT_SECRET* ClientInitial,
+    _In_ const CXPLAT_SECRET* ServerInitial,
+    _Out_opt_ QUIC_PACKET_KEY** ReadKey,
+    _Out_opt_ QUIC_PACKET_KEY** WriteKey
+    );
+
 //
 // Frees the packet key.
 //
@@ -310,6 +342,35 @@ CxPlatEncrypt(
         uint8_t* Buffer
     );
 
+//
+// A single packet to encrypt or decrypt as part of a batch. The header is the
+// authenticated data and is directly followed by the payload. As with
+// CxPlatEncrypt and CxPlatDecrypt, 'PayloadLength' includes
+// CXPLAT_ENCRYPTION_OVERHEAD.
+//
+typedef struct CXPLAT_CRYPT_BATCH_PACKET {
+    uint8_t* Header;
+    uint64_t PacketNumber;
+    uint16_t HeaderLength;
+    uint16_t PayloadLength;
+} CXPLAT_CRYPT_BATCH_PACKET;
+
+//
+// Encrypts a batch of packets with the same key. Each packet's nonce is the
+// IV combined with its packet number. On failure, the state of all the
+// payloads in the batch is undefined.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_BATCH_PACKET* Packets
+    );
+
 //
 // Decrypts buffer with the given key. 'BufferLength' is the full encrypted
 // payload length on input. On output, the length shrinks by
@@ -329,6 +390,65 @@ CxPlatDecrypt(
         uint8_t* Buffer
     );
 
+//
+// Decrypts a buffer with the given key in two steps, so that the caller can
+// look at the start of the plaintext before choosing where the rest goes.
+//
+// CxPlatDecryptBegin decrypts the first PrefixLength bytes of the payload in
+// place, before they are authenticated. CxPlatDecryptEnd then decrypts the
+// remaining CipherTextLength bytes of the payload into Output, which doesn't
+// need to be in place, and authenticates the whole payload against Tag. The
+// key must not be used for any other decryption in between.
+//
+// CxPlatDecryptBegin returns QUIC_STATUS_NOT_SUPPORTED, without decrypting
+// anything, if the key can't decrypt in steps.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBegin(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength)
+        const uint8_t* const AuthData,
+    _In_ uint16_t PrefixLength,
+    _Inout_updates_bytes_(PrefixLength)
+        uint8_t* Prefix
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptEnd(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint16_t CipherTextLength,
+    _In_reads_bytes_(CipherTextLength)
+        const uint8_t* const CipherText,
+    _Out_writes_bytes_(CipherTextLength)
+        uint8_t* Output,
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD)
+        const uint8_t* const Tag
+    );
+
+//
+// Decrypts a batch of packets with the same key. Each packet's nonce is the
+// IV combined with its packet number. Results[i] is set to TRUE if the i-th
+// packet was successfully decrypted and authenticated. The payload of a
+// packet that failed is undefined.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_BATCH_PACKET* Packets,
+    _Out_writes_(BatchSize)
+        BOOLEAN* Results
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
@@ -271,7 +271,14 @@ typedef struct CXPLAT_RECV_DATA {
     uint16_t QueuedOnConnection : 1; // Used for debugging.
     uint16_t DatapathType : 2;       // CXPLAT_DATAPATH_TYPE
     uint16_t Reserved : 4;           // PACKET_TYPE (at least 3 bits)
-    uint16_t ReservedEx : 8;         // Header length
+    uint16_t Decrypted : 1;          // The datapath already removed the packet protection (QEO).
+    uint16_t ReservedEx : 7;
+
+    //
+    // The time (in us, on the CxPlatTimeUs64 clock) the datagram was received
+    // by the kernel, or 0 if unknown.
+    //
+    uint64_t RecvTimeUs;
 
     //
     // Variable length data (of size `ClientRecvContextLength` passed into
@@ -436,6 +443,9 @@ typedef enum CXPLAT_DATAPATH_FEATURES {
     CXPLAT_DATAPATH_FEATURE_TTL                = 0x00000080,
     CXPLAT_DATAPATH_FEATURE_SEND_DSCP          = 0x00000100,
     CXPLAT_DATAPATH_FEATURE_RECV_DSCP          = 0x00000200,
+    CXPLAT_DATAPATH_FEATURE_SEND_ZERO_COPY     = 0x00000400,
+    CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS    = 0x00000800,
+    CXPLAT_DATAPATH_FEATURE_SEND_TXTIME        = 0x00001000,
 } CXPLAT_DATAPATH_FEATURES;
 
 DEFINE_ENUM_FLAG_OPERATORS(CXPLAT_DATAPATH_FEATURES)
@@ -476,6 +486,49 @@ typedef struct CXPLAT_DATAPATH_INIT_CONFIG {
     // the Windows fast path causing a large performance regression.
     //
     BOOLEAN EnableDscpOnRecv;
+
+    //
+    // Whether socket fds should be registered with the event queue, when
+    // supported (io_uring), so IO on them skips the per-request fd lookup.
+    //
+    BOOLEAN EnableFixedFiles;
+
+    //
+    // Whether the datapath should report kernel receive timestamps, when
+    // supported, in CXPLAT_RECV_DATA.RecvTimeUs.
+    //
+    BOOLEAN EnableRecvTimestamps;
+
+    //
+    // Whether the datapath should hand send departure times to the kernel
+    // (SO_TXTIME), when supported, so pacing is done by the qdisc.
+    //
+    BOOLEAN EnableSendTxTime;
+
+    //
+    // Whether the XDP queues of an interface that are polled by the same
+    // worker should share one UMEM.
+    //
+    BOOLEAN EnableXdpSharedUmem;
+
+    //
+    // The watermarks for reaping XDP TX completions. Zero for the defaults.
+    //
+    uint32_t XdpTxCompletionBatchSize;
+    uint32_t XdpTxCompletionHighWatermark;
+
+    //
+    // Whether UDP sockets should be registered as edge triggered (epoll),
+    // and drained up to a budget on each notification.
+    //
+    BOOLEAN EnableEdgeTriggered;
+
+    //
+    // Whether sends on unconnected UDP sockets should be queued and flushed
+    // together, in one sendmmsg call per socket, at the end of the worker
+    // pass (epoll).
+    //
+    BOOLEAN EnableSendBatching;
 } CXPLAT_DATAPATH_INIT_CONFIG;
 
 //
@@ -522,6 +575,36 @@ CxPlatDataPathGetSupportedFeatures(
     _In_ CXPLAT_SOCKET_FLAGS SocketFlags
     );
 
+typedef struct CXPLAT_DATAPATH_STATISTICS {
+    uint64_t RecvCallCount;     // Receive calls (or completions) that returned data.
+    uint64_t RecvMessageCount;  // Messages returned by them.
+} CXPLAT_DATAPATH_STATISTICS;
+
+//
+// Queries the receive statistics of the (non-raw) datapath.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    );
+
+//
+// Queries the mode (copy vs zero-copy) of each XDP queue. On input QueueCount
+// is the capacity of QueueInfo; on output it's the number of queues.
+//
+struct QUIC_XDP_QUEUE_INFO;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDataPathGetXdpQueueInfo(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        struct QUIC_XDP_QUEUE_INFO* QueueInfo
+    );
+
 //
 // Gets whether the datapath prefers UDP datagrams padded to path MTU.
 //
@@ -622,6 +705,11 @@ typedef struct CXPLAT_UDP_CONFIG {
     uint8_t CibirIdOffsetSrc;           // CIBIR ID offset in source CID
     uint8_t CibirIdOffsetDst;           // CIBIR ID offset in destination CID
     uint8_t CibirId[6];                 // CIBIR ID data
+
+    // used for per-processor server sockets
+    uint16_t CidSteeringPartitionCount; // Value of 0 indicates CID steering isn't used
+    uint16_t CidSteeringPidMask;        // Mask applied to the partition ID
+    uint8_t CidSteeringPidOffset;       // Partition ID (little endian) offset in short header destination CID
 } CXPLAT_UDP_CONFIG;
 
 //
@@ -749,6 +837,7 @@ typedef struct CXPLAT_SEND_CONFIG {
     uint8_t ECN; // CXPLAT_ECN_TYPE
     uint8_t Flags; // CXPLAT_SEND_FLAGS
     uint8_t DSCP; // CXPLAT_DSCP_TYPE
+    uint64_t TxTimeUs; // Earliest departure time (CxPlatTimeUs64), or 0 for now
 } CXPLAT_SEND_CONFIG;
 
 //
@@ -944,6 +1033,24 @@ CxPlatDataPathRssConfigFree(
     _In_ CXPLAT_RSS_CONFIG* RssConfig
     );
 
+#ifdef CXPLAT_MEMORY_DATAPATH
+//
+// Delivers a datagram from outside the in-memory network to the socket bound
+// to the destination port, as if SourceAddress had sent it. The payload is
+// copied, and passes over the socket's inbound link like any other datagram.
+// Used to replay captured traffic.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatMemoryDataPathInject(
+    _In_ const QUIC_ADDR* SourceAddress,
+    _In_ const QUIC_ADDR* DestinationAddress,
+    _In_ uint16_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    );
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -11,6 +11,11 @@ Abstract:
     enumeration means enumeration that requires exclusive access to the table
     during the entire enumeration.
 
+    Tables created with CxPlatHashtableInitializeOpen use open addressing
+    instead of chained buckets: entries are found by comparing a group of
+    one byte tags at once (with SIMD where available), without walking a
+    linked list. The rest of the API is the same for both layouts.
+
 Usage examples:
 
     void
@@ -85,6 +90,7 @@ extern "C" {
 #pragma warning(disable:4201)  // nonstandard extension used: nameless struct/union
 
 #define CXPLAT_HASH_ALLOCATED_HEADER 0x00000001
+#define CXPLAT_HASH_OPEN_ADDRESSING  0x00000002
 
 #define CXPLAT_HASH_MIN_SIZE 128
 
@@ -111,8 +117,21 @@ typedef struct CXPLAT_HASHTABLE_LOOKUP_CONTEXT {
     // 3. Signature is used primarily as a safety check in insertion. This field
     //    must match the Signature of the entry being inserted.
     //
-    CXPLAT_LIST_ENTRY* ChainHead;
-    CXPLAT_LIST_ENTRY* PrevLinkage;
+    // For open addressing tables, Slot and Probe record where the last lookup
+    // stopped in the probe sequence instead. If it stopped in the overflow
+    // list, Slot is CXPLAT_HASH_OPEN_OVERFLOW_SLOT and PrevLinkage is the
+    // entry found.
+    //
+    union {
+        struct {
+            CXPLAT_LIST_ENTRY* ChainHead;
+            CXPLAT_LIST_ENTRY* PrevLinkage;
+        };
+        struct {
+            uint32_t Slot;
+            uint32_t Probe;
+        };
+    };
     uint64_t Signature;
 } CXPLAT_HASHTABLE_LOOKUP_CONTEXT;
 
@@ -145,6 +164,11 @@ typedef struct CXPLAT_HASHTABLE {
         void* Directory;
         CXPLAT_LIST_ENTRY* SecondLevelDir; // When TableSize <= HT_SECOND_LEVEL_DIR_MIN_SIZE
         CXPLAT_LIST_ENTRY** FirstLevelDir; // When TableSize > HT_SECOND_LEVEL_DIR_MIN_SIZE
+        struct {                           // When CXPLAT_HASH_OPEN_ADDRESSING
+            uint8_t* Control;
+            struct CXPLAT_HASHTABLE_ENTRY** Slots;
+            CXPLAT_LIST_ENTRY Overflow;    // Entries with no free slot
+        };
     };
 
 } CXPLAT_HASHTABLE;
@@ -170,6 +194,31 @@ CxPlatHashtableInitializeEx(
     return CxPlatHashtableInitialize(&HashTable, InitialSize);
 }
 
+//
+// Initializes an open addressing hash table. InitialSize is the initial
+// number of slots.
+//
+_Must_inspect_result_
+_Success_(return != FALSE)
+BOOLEAN
+CxPlatHashtableInitializeOpen(
+    _Inout_ _When_(NULL == *HashTable, _At_(*HashTable, __drv_allocatesMem(Mem) _Post_notnull_))
+        CXPLAT_HASHTABLE** HashTable,
+    _In_ uint32_t InitialSize
+    );
+
+QUIC_INLINE
+_Must_inspect_result_
+_Success_(return != FALSE)
+BOOLEAN
+CxPlatHashtableInitializeOpenEx(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ uint32_t InitialSize
+    )
+{
+    return CxPlatHashtableInitializeOpen(&HashTable, InitialSize);
+}
+
 void
 CxPlatHashtableUninitialize(
     _In_
@@ -74,12 +74,16 @@ void
 typedef CXPLAT_PCP_CALLBACK *CXPLAT_PCP_CALLBACK_HANDLER;
 
 //
-// Initializes the port control protocol interface on the data path.
+// Initializes the port control protocol interface on the data path. If a
+// worker pool is passed, mappings acquired with CxPlatPcpAcquireMapping are
+// renewed from it in the background; otherwise they are only renewed when
+// next acquired.
 //
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 CxPlatPcpInitialize(
     _In_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ CXPLAT_WORKER_POOL* WorkerPool,
     _In_ void* Context,
     _In_ CXPLAT_PCP_CALLBACK_HANDLER Handler,
     _Out_ CXPLAT_PCP** PcpContext
@@ -123,6 +127,36 @@ CxPlatPcpSendPeerRequest(
     _In_ uint32_t Lifetime          // Zero indicates delete. Nonce must match.
     );
 
+//
+// Acquires a reference on the cached MAP mapping for an internal UDP port,
+// shared by all users of that port. If the mapping is currently granted, its
+// external address is returned with QUIC_STATUS_SUCCESS and no request is
+// sent. Otherwise, a MAP request is sent (if one isn't already outstanding),
+// QUIC_STATUS_PENDING is returned, and the result is indicated with a
+// CXPLAT_PCP_EVENT_MAP or CXPLAT_PCP_EVENT_FAILURE event. The mapping is
+// renewed halfway through each granted lifetime until the last reference is
+// released.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatPcpAcquireMapping(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ uint16_t InternalPort,     // Host byte order
+    _In_ uint32_t Lifetime,         // Requested, in seconds. Must be non-zero.
+    _Out_ QUIC_ADDR* ExternalAddress
+    );
+
+//
+// Releases a reference acquired with CxPlatPcpAcquireMapping. The last
+// release deletes the mapping on the gateways.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatPcpReleaseMapping(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ uint16_t InternalPort      // Host byte order
+    );
+
 #if defined(__cplusplus)
 }
 #endif
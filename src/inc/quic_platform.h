@@ -161,6 +161,30 @@ typedef struct CXPLAT_SLIST_ENTRY {
 #define QUIC_POOL_DATAPATH_RSS_CONFIG       'F4cQ' // Qc4F - QUIC Datapath RSS configuration
 #define QUIC_POOL_TLS_AUX_DATA              '05cQ' // Qc50 - QUIC TLS Backing Aux data
 #define QUIC_POOL_TLS_RECORD_ENTRY          '15cQ' // Qc51 - QUIC TLS Backing Record storage
+#define QUIC_POOL_LOOKUP_NODE               '25cQ' // Qc52 - QUIC Lookup Hash Table Node
+#define QUIC_POOL_RETRY_KEY                 '35cQ' // Qc53 - QUIC Stateless Retry Key
+#define QUIC_POOL_QEO_OFFLOAD               '45cQ' // Qc54 - QUIC Encryption Offload state
+#define QUIC_POOL_TLS_OFFLOAD               '55cQ' // Qc55 - QUIC offloaded TLS handshake
+#define QUIC_POOL_FEC                       '65cQ' // Qc56 - QUIC FEC symbol buffers
+#define QUIC_POOL_STREAM_INDEX              '75cQ' // Qc57 - QUIC stream ID direct index
+#define QUIC_POOL_STREAM_BATCH              '85cQ' // Qc58 - QUIC stream start batch
+#define QUIC_POOL_CONN_POOL                 '95cQ' // Qc59 - QUIC managed connection pool
+#define QUIC_POOL_ACCEPT_QUEUE              'A5cQ' // Qc5A - QUIC listener accept queue entry
+#define QUIC_POOL_CONFIG_BATCH              'B5cQ' // Qc5B - QUIC set configuration batch
+#define QUIC_POOL_CONFIG_SETTINGS           'C5cQ' // Qc5C - QUIC configuration settings snapshot
+#define QUIC_POOL_CONFIG_RETIRED            'D5cQ' // Qc5D - QUIC retired security config
+#define QUIC_POOL_LIBRARY_SETTINGS          'E5cQ' // Qc5E - QUIC library settings snapshot
+#define QUIC_POOL_HANDSHAKE_STATE           'F5cQ' // Qc5F - QUIC connection handshake-only state
+#define QUIC_POOL_PERSISTENT_CACHE          'G5cQ' // Qc5G - QUIC persistent ticket and path metrics cache
+#define QUIC_POOL_STORAGE_FILE              'H5cQ' // Qc5H - QUIC platform storage file
+#define QUIC_POOL_QLOG                      'I5cQ' // Qc5I - QUIC connection qlog ring buffer
+#define QUIC_POOL_STATS_SAMPLES             'J5cQ' // Qc5J - QUIC connection network statistics samples
+#define QUIC_POOL_STREAM_SEND_BATCH         'K5cQ' // Qc5K - QUIC stream send batch
+#define QUIC_POOL_PROTECT_OFFLOAD           'L5cQ' // Qc5L - QUIC connection packet protection offloads
+#define QUIC_POOL_TP_CACHE                  'M5cQ' // Qc5M - QUIC pre-encoded transport parameters
+#define QUIC_POOL_SEND_FILE                 'N5cQ' // Qc5N - QUIC stream file send
+#define QUIC_POOL_CREDENTIAL_LOAD           'O5cQ' // Qc5O - QUIC asynchronous credential load
+#define QUIC_POOL_INITIAL_FILTER            'P5cQ' // Qc5P - QUIC Initial packet filter counters
 
 typedef enum CXPLAT_THREAD_FLAGS {
     CXPLAT_THREAD_FLAG_NONE               = 0x0000,
@@ -432,6 +456,7 @@ CxPlatListPopEntry(
 
 #include "quic_hashtable.h"
 #include "quic_toeplitz.h"
+#include "quic_probe.h"
 
 #ifdef DEBUG
 void
@@ -457,6 +482,7 @@ CxPlatGetAllocFailDenominator(
 
 typedef struct QUIC_EXECUTION QUIC_EXECUTION;
 typedef struct QUIC_GLOBAL_EXECUTION_CONFIG QUIC_GLOBAL_EXECUTION_CONFIG;
+typedef struct QUIC_WORKER_POLL_STATISTICS QUIC_WORKER_POLL_STATISTICS;
 typedef struct QUIC_EXECUTION_CONFIG QUIC_EXECUTION_CONFIG;
 typedef struct CXPLAT_EXECUTION_CONTEXT CXPLAT_EXECUTION_CONTEXT;
 
@@ -538,6 +564,13 @@ CxPlatWorkerPoolGetIdealProcessor(
     _In_ uint32_t Index // Into the worker pool
     );
 
+void
+CxPlatWorkerPoolGetPollStatistics(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ uint32_t Index, // Into the worker pool
+    _Out_ QUIC_WORKER_POLL_STATISTICS* Statistics
+    );
+
 CXPLAT_EVENTQ*
 CxPlatWorkerPoolGetEventQ(
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
@@ -556,6 +589,28 @@ CxPlatWorkerPoolWorkerPoll(
     _In_ QUIC_EXECUTION* Execution
     );
 
+//
+// How the platform worker trims a dynamic pool's free entries, once a period.
+// Entries above HighWatermark are released right away. Above LowWatermark,
+// DecayPercent of the excess (but at least PruneCount entries) is released,
+// so a burst's leftovers drain back down gradually.
+//
+typedef struct CXPLAT_POOL_EX_POLICY {
+    uint32_t LowWatermark;
+    uint32_t HighWatermark;
+    uint16_t PruneCount;
+    uint8_t DecayPercent;
+} CXPLAT_POOL_EX_POLICY;
+
+#define CXPLAT_POOL_EX_DEFAULT_PRUNE_COUNT 8
+
+typedef struct CXPLAT_POOL_EX_STATS {
+    uint32_t FreeDepth;     // Free entries currently held for pruning.
+    uint64_t AllocCount;    // Allocations made from the pool.
+    uint64_t MissCount;     // Allocations the free entries couldn't satisfy.
+    uint64_t PruneCount;    // Free entries released by the trimming policy.
+} CXPLAT_POOL_EX_STATS;
+
 //
 // Supports more dynamic operations, but must be submitted to the platform worker
 // to manage.
@@ -564,8 +619,24 @@ typedef struct CXPLAT_POOL_EX {
     CXPLAT_POOL Base;
     CXPLAT_LIST_ENTRY Link;
     void* Owner;
+    CXPLAT_POOL_EX_POLICY Policy;
+    int64_t AllocCount;
+    uint64_t PruneCount;
 } CXPLAT_POOL_EX;
 
+//
+// Allocates from the pool, counting the allocation for the pool's hit rate.
+//
+QUIC_INLINE
+void*
+CxPlatPoolExAlloc(
+    _Inout_ CXPLAT_POOL_EX* Pool
+    )
+{
+    InterlockedIncrement64(&Pool->AllocCount);
+    return CxPlatPoolAlloc(&Pool->Base);
+}
+
 void
 CxPlatAddDynamicPoolAllocator(
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
@@ -578,6 +649,22 @@ CxPlatRemoveDynamicPoolAllocator(
     _Inout_ CXPLAT_POOL_EX* Pool
     );
 
+//
+// Replaces the pool's trimming policy. Adding the pool resets it to the
+// default: CXPLAT_POOL_EX_DEFAULT_PRUNE_COUNT entries a period, no watermarks.
+//
+QUIC_STATUS
+CxPlatDynamicPoolSetPolicy(
+    _Inout_ CXPLAT_POOL_EX* Pool,
+    _In_ const CXPLAT_POOL_EX_POLICY* Policy
+    );
+
+void
+CxPlatDynamicPoolGetStats(
+    _In_ CXPLAT_POOL_EX* Pool,
+    _Out_ CXPLAT_POOL_EX_STATS* Stats
+    );
+
 #endif // !_KERNEL_MODE
 
 //
@@ -135,6 +135,16 @@ InterlockedAnd(
     return __sync_and_and_fetch(Destination, Value);
 }
 
+QUIC_INLINE
+int32_t
+InterlockedAnd32(
+    _Inout_ _Interlocked_operand_ int32_t volatile *Destination,
+    _In_ int32_t Value
+    )
+{
+    return __sync_fetch_and_and(Destination, Value);
+}
+
 QUIC_INLINE
 long
 InterlockedOr(
@@ -246,6 +256,17 @@ InterlockedExchangePointer(
     return __sync_lock_test_and_set(Target, Value);
 }
 
+QUIC_INLINE
+void*
+InterlockedCompareExchangePointer(
+    _Inout_ _Interlocked_operand_ void* volatile *Destination,
+    _In_opt_ void* ExChange,
+    _In_opt_ void* Comperand
+    )
+{
+    return __sync_val_compare_and_swap(Destination, Comperand, ExChange);
+}
+
 QUIC_INLINE
 void*
 InterlockedFetchAndClearPointer(
@@ -293,6 +314,12 @@ InterlockedDecrement64(
 
 #define QuicReadPtrNoFence(p) __atomic_load_n((p), __ATOMIC_RELAXED)
 
+#define QuicReadPtrAcquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+#define QuicWritePtrRelease(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#define CxPlatPrefetch(p) __builtin_prefetch((p))
+
 #define QuicReadLongPtrNoFence(p) __atomic_load_n((p), __ATOMIC_RELAXED)
 
 //
@@ -373,6 +400,121 @@ CxPlatFree(
     _In_ uint32_t Tag
     );
 
+//
+// Indicates an allocation has no NUMA node preference.
+//
+#define CXPLAT_NUMA_NODE_ANY 0xFFFF
+
+//
+// Allocates page aligned memory, backed by pages on the given NUMA node when
+// NUMA info is available. Must be freed with CxPlatFreeNuma, passing the same
+// ByteCount and NumaNode.
+//
+_Ret_maybenull_
+void*
+CxPlatAllocNuma(
+    _In_ size_t ByteCount,
+    _In_ uint32_t Tag,
+    _In_ uint16_t NumaNode
+    );
+
+void
+CxPlatFreeNuma(
+    __drv_freesMem(Mem) _Frees_ptr_ void* Mem,
+    _In_ size_t ByteCount,
+    _In_ uint32_t Tag,
+    _In_ uint16_t NumaNode
+    );
+
+//
+// The huge page size (in bytes) used for arena and buffer allocations, or 0 if
+// huge pages are disabled.
+//
+extern uint32_t CxPlatHugePageSize;
+
+//
+// Selects the huge page size to use from now on (0 disables huge pages). Only
+// affects pools and buffers created after the call.
+//
+void
+CxPlatHugePagesConfigure(
+    _In_ uint32_t PageSize
+    );
+
+//
+// Allocates ByteCount (rounded up to the huge page size) of memory backed by
+// huge pages. Explicit (hugetlbfs) pages are tried first, then transparent
+// huge pages. Returns NULL if huge pages are disabled or the mapping fails, in
+// which case the caller falls back to its regular allocator. Must be freed
+// with CxPlatFreeHugePages, passing the same ByteCount.
+//
+_Ret_maybenull_
+void*
+CxPlatAllocHugePages(
+    _In_ size_t ByteCount
+    );
+
+void
+CxPlatFreeHugePages(
+    _In_ void* Mem,
+    _In_ size_t ByteCount
+    );
+
+//
+// Carves a fixed size block out of the shared huge page arena. Blocks are
+// never returned to the arena; pools recycle them instead and the arena is
+// only unmapped by CxPlatUninitialize. Returns NULL if the arena is disabled
+// or exhausted.
+//
+_Ret_maybenull_
+void*
+CxPlatHugePageArenaAlloc(
+    _In_ uint32_t ByteCount
+    );
+
+BOOLEAN
+CxPlatHugePageArenaContains(
+    _In_ const void* Mem
+    );
+
+//
+// Optional per-tag allocation accounting. While enabled, every CxPlatAlloc and
+// CxPlatAllocNuma (and the matching frees) is counted against its tag in
+// per-processor shards.
+//
+
+typedef struct CXPLAT_ALLOC_TAG_STATS {
+    uint32_t Tag;
+    uint32_t AllocationsPerSecond;  // Since the previous query of this tag.
+    uint64_t LiveBytes;
+    uint64_t PeakBytes;             // Sampled, so short spikes may be missed.
+    uint64_t TotalAllocations;
+} CXPLAT_ALLOC_TAG_STATS;
+
+//
+// Turns accounting on or off. Counters are kept while disabled. Returns FALSE
+// if the platform doesn't support it.
+//
+BOOLEAN
+CxPlatAllocTelemetryEnable(
+    _In_ BOOLEAN Enable
+    );
+
+//
+// The number of distinct tags seen so far. Tags are indexed in the order they
+// were first seen, so indices stay stable.
+//
+uint32_t
+CxPlatAllocTelemetryGetTagCount(
+    void
+    );
+
+void
+CxPlatAllocTelemetryGetTag(
+    _In_ uint32_t Index,
+    _Out_ CXPLAT_ALLOC_TAG_STATS* Stats
+    );
+
 #define CXPLAT_ALLOC_PAGED(Size, Tag) CxPlatAlloc(Size, Tag)
 #define CXPLAT_ALLOC_NONPAGED(Size, Tag) CxPlatAlloc(Size, Tag)
 #define CXPLAT_FREE(Mem, Tag) CxPlatFree((void*)Mem, Tag)
@@ -486,7 +628,23 @@ CXPLAT_SLIST_ENTRY*
 CxPlatListPopEntry(
     _Inout_ CXPLAT_SLIST_ENTRY* ListHead
     );
-typedef struct CXPLAT_POOL {
+
+extern uint32_t CxPlatProcessorCount;
+
+uint32_t
+CxPlatProcCurrentNumber(
+    void
+    );
+
+#define CXPLAT_POOL_MAGAZINE_ALIGNMENT  64
+
+//
+// A per-processor cache of free entries in front of the pool's shared list
+// (the depot). Normally only the thread currently running on the processor
+// touches it, so Busy is only a try-lock for the rare preempted or migrated
+// thread; whoever finds it busy goes to the depot instead of waiting.
+//
+typedef struct __attribute__((aligned(CXPLAT_POOL_MAGAZINE_ALIGNMENT))) CXPLAT_POOL_MAGAZINE {
 
     //
     // List of free entries.
@@ -494,6 +652,35 @@ typedef struct CXPLAT_POOL {
 
     CXPLAT_SLIST_ENTRY ListHead;
 
+    //
+    // Non-zero while a thread is using the magazine.
+    //
+
+    long Busy;
+
+    //
+    // Number of free entries in the list.
+    //
+
+    uint16_t Depth;
+
+    //
+    // Number of entries the magazine may hold. Grows when the magazine and the
+    // depot run dry and shrinks when both overflow, so it follows demand.
+    //
+
+    uint16_t Capacity;
+
+} CXPLAT_POOL_MAGAZINE;
+
+typedef struct CXPLAT_POOL {
+
+    //
+    // List of free entries (the depot shared by all the magazines).
+    //
+
+    CXPLAT_SLIST_ENTRY ListHead;
+
     //
     // Number of free entries in the list.
     //
@@ -501,8 +688,8 @@ typedef struct CXPLAT_POOL {
     uint16_t ListDepth;
 
     //
-    // Lock to synchronize access to the List.
-    // LINUX_TODO: Check how to make this lock free?
+    // Lock to synchronize access to the List. Only taken to move batches of
+    // entries in and out of magazines, or when no magazine is available.
     //
 
     CXPLAT_LOCK Lock;
@@ -519,6 +706,43 @@ typedef struct CXPLAT_POOL {
 
     uint32_t Tag;
 
+    //
+    // The NUMA node entries are allocated on, or CXPLAT_NUMA_NODE_ANY. Node
+    // local entries are carved from slabs (linked on NumaSlabs) so that
+    // binding memory to the node isn't paid on every allocation. Like arena
+    // entries, they are kept on NumaFreeList (under Lock) once the pool
+    // doesn't cache them, and only released with the slabs.
+    //
+
+    uint16_t NumaNode;
+    uint32_t NumaSlabEntryCount;
+    CXPLAT_SLIST_ENTRY NumaSlabs;
+    CXPLAT_SLIST_ENTRY NumaFreeList;
+
+    //
+    // The per-processor magazines, or NULL if they couldn't be allocated.
+    // MagazinesAllocation is the unaligned allocation backing Magazines.
+    //
+
+    uint32_t MagazineCount;
+    CXPLAT_POOL_MAGAZINE* Magazines;
+    void* MagazinesAllocation;
+
+    //
+    // Set if new entries are carved from the huge page arena. Arena entries
+    // can't be freed individually, so the ones the pool doesn't cache are kept
+    // on ArenaFreeList (under Lock) for reuse instead.
+    //
+
+    BOOLEAN HugePages;
+    CXPLAT_SLIST_ENTRY ArenaFreeList;
+
+    //
+    // Number of allocations that had to allocate a new entry.
+    //
+
+    int64_t MissCount;
+
 } CXPLAT_POOL;
 
 #define CXPLAT_MEMORY_ALIGNMENT 16
@@ -542,6 +766,25 @@ typedef struct __attribute__((aligned(CXPLAT_MEMORY_ALIGNMENT))) CXPLAT_POOL_HEA
 #define CXPLAT_POOL_MAXIMUM_DEPTH   0   // TODO - Optimize this scenario better
 #endif
 
+//
+// The bounds for a magazine's adaptive capacity.
+//
+#define CXPLAT_POOL_MAGAZINE_MIN_CAPACITY   8
+#define CXPLAT_POOL_MAGAZINE_MAX_CAPACITY   128
+
+//
+// Node-local allocations are page granular, so only pools with entries at
+// least this large are placed on a specific NUMA node. Smaller entries rely
+// on the allocating (worker) thread's first-touch placement.
+//
+#define CXPLAT_NUMA_POOL_MIN_ENTRY_SIZE 4096
+
+//
+// The target size of the node-local slabs new entries are carved from. A slab
+// always holds at least one entry.
+//
+#define CXPLAT_NUMA_POOL_SLAB_SIZE      (256 * 1024)
+
 #if DEBUG
 int32_t
 CxPlatGetAllocFailDenominator(
@@ -559,10 +802,172 @@ CxPlatPoolInitialize(
 {
     Pool->Size = Size + sizeof(CXPLAT_POOL_HEADER); // Add space for the pool header
     Pool->Tag = Tag;
+    Pool->NumaNode = CXPLAT_NUMA_NODE_ANY;
+    Pool->NumaSlabEntryCount = 0;
+    CxPlatZeroMemory(&Pool->NumaSlabs, sizeof(Pool->NumaSlabs));
+    CxPlatZeroMemory(&Pool->NumaFreeList, sizeof(Pool->NumaFreeList));
     CxPlatLockInitialize(&Pool->Lock);
     Pool->ListDepth = 0;
     CxPlatZeroMemory(&Pool->ListHead, sizeof(Pool->ListHead));
+    Pool->HugePages = FALSE;
+    CxPlatZeroMemory(&Pool->ArenaFreeList, sizeof(Pool->ArenaFreeList));
+    Pool->MissCount = 0;
     UNREFERENCED_PARAMETER(IsPaged);
+
+    //
+    // Magazines are best effort: without them (processor count not known yet
+    // or out of memory) every operation just goes to the depot.
+    //
+    Pool->MagazineCount = CxPlatProcessorCount;
+    Pool->Magazines = NULL;
+    Pool->MagazinesAllocation = NULL;
+    if (CXPLAT_POOL_MAXIMUM_DEPTH != 0 && Pool->MagazineCount != 0) {
+        const size_t Length =
+            (Pool->MagazineCount + 1) * sizeof(CXPLAT_POOL_MAGAZINE);
+        Pool->MagazinesAllocation = CxPlatAlloc(Length, Tag);
+        if (Pool->MagazinesAllocation != NULL) {
+            CxPlatZeroMemory(Pool->MagazinesAllocation, Length);
+            Pool->Magazines =
+                (CXPLAT_POOL_MAGAZINE*)
+                    (((uintptr_t)Pool->MagazinesAllocation + CXPLAT_POOL_MAGAZINE_ALIGNMENT - 1) &
+                     ~(uintptr_t)(CXPLAT_POOL_MAGAZINE_ALIGNMENT - 1));
+            for (uint32_t i = 0; i < Pool->MagazineCount; ++i) {
+                Pool->Magazines[i].Capacity = CXPLAT_POOL_MAGAZINE_MIN_CAPACITY;
+            }
+        }
+    }
+}
+
+//
+// Initializes a pool whose entries are allocated on the given NUMA node.
+//
+QUIC_INLINE
+void
+CxPlatPoolInitializeNuma(
+    _In_ BOOLEAN IsPaged,
+    _In_ uint32_t Size,
+    _In_ uint32_t Tag,
+    _In_ uint16_t NumaNode,
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CxPlatPoolInitialize(IsPaged, Size, Tag, Pool);
+#ifdef CXPLAT_NUMA_AWARE
+    if (Pool->Size >= CXPLAT_NUMA_POOL_MIN_ENTRY_SIZE) {
+        Pool->Size =
+            (Pool->Size + CXPLAT_MEMORY_ALIGNMENT - 1) & ~(uint32_t)(CXPLAT_MEMORY_ALIGNMENT - 1);
+        Pool->NumaNode = NumaNode;
+        Pool->NumaSlabEntryCount =
+            CXPLAT_MAX(
+                1,
+                (CXPLAT_NUMA_POOL_SLAB_SIZE - CXPLAT_MEMORY_ALIGNMENT) / Pool->Size);
+    }
+#else
+    UNREFERENCED_PARAMETER(NumaNode);
+#endif
+}
+
+//
+// Backs the pool's new entries with the huge page arena, if it is enabled.
+// Must be called right after initialization, before any allocation.
+//
+QUIC_INLINE
+void
+CxPlatPoolEnableHugePages(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    Pool->HugePages = CxPlatHugePageSize != 0;
+}
+
+QUIC_INLINE
+size_t
+CxPlatPoolNumaSlabSize(
+    _In_ const CXPLAT_POOL* Pool
+    )
+{
+    //
+    // The slab's link in NumaSlabs takes the first CXPLAT_MEMORY_ALIGNMENT
+    // bytes, keeping the entries aligned.
+    //
+    return CXPLAT_MEMORY_ALIGNMENT + (size_t)Pool->NumaSlabEntryCount * Pool->Size;
+}
+
+//
+// Allocates a new node-local slab, returning its first entry and putting the
+// others on NumaFreeList.
+//
+QUIC_INLINE
+void*
+CxPlatPoolNumaSlabAlloc(
+    _In_ CXPLAT_POOL* Pool
+    )
+{
+    uint8_t* Slab =
+        (uint8_t*)CxPlatAllocNuma(CxPlatPoolNumaSlabSize(Pool), Pool->Tag, Pool->NumaNode);
+    if (Slab == NULL) {
+        return NULL;
+    }
+    uint8_t* Entries = Slab + CXPLAT_MEMORY_ALIGNMENT;
+    CxPlatLockAcquire(&Pool->Lock);
+    CxPlatListPushEntry(&Pool->NumaSlabs, (CXPLAT_SLIST_ENTRY*)Slab);
+    for (uint32_t i = 1; i < Pool->NumaSlabEntryCount; ++i) {
+        CxPlatListPushEntry(
+            &Pool->NumaFreeList, (CXPLAT_SLIST_ENTRY*)(Entries + (size_t)i * Pool->Size));
+    }
+    CxPlatLockRelease(&Pool->Lock);
+    return Entries;
+}
+
+QUIC_INLINE
+void*
+CxPlatPoolAllocEntry(
+    _In_ CXPLAT_POOL* Pool
+    )
+{
+    if (Pool->HugePages) {
+        CxPlatLockAcquire(&Pool->Lock);
+        void* Entry = CxPlatListPopEntry(&Pool->ArenaFreeList);
+        CxPlatLockRelease(&Pool->Lock);
+        if (Entry == NULL) {
+            Entry = CxPlatHugePageArenaAlloc(Pool->Size);
+        }
+        if (Entry != NULL) {
+            return Entry;
+        }
+    }
+    if (Pool->NumaNode != CXPLAT_NUMA_NODE_ANY) {
+        CxPlatLockAcquire(&Pool->Lock);
+        void* Entry = CxPlatListPopEntry(&Pool->NumaFreeList);
+        CxPlatLockRelease(&Pool->Lock);
+        if (Entry == NULL) {
+            Entry = CxPlatPoolNumaSlabAlloc(Pool);
+        }
+        return Entry;
+    }
+    return CxPlatAlloc(Pool->Size, Pool->Tag);
+}
+
+QUIC_INLINE
+void
+CxPlatPoolFreeEntry(
+    _In_ CXPLAT_POOL* Pool,
+    _In_ void* Entry
+    )
+{
+    if (Pool->HugePages && CxPlatHugePageArenaContains(Entry)) {
+        CxPlatLockAcquire(&Pool->Lock);
+        CxPlatListPushEntry(&Pool->ArenaFreeList, (CXPLAT_SLIST_ENTRY*)Entry);
+        CxPlatLockRelease(&Pool->Lock);
+        return;
+    }
+    if (Pool->NumaNode != CXPLAT_NUMA_NODE_ANY) {
+        CxPlatLockAcquire(&Pool->Lock);
+        CxPlatListPushEntry(&Pool->NumaFreeList, (CXPLAT_SLIST_ENTRY*)Entry);
+        CxPlatLockRelease(&Pool->Lock);
+    } else {
+        CxPlatFree(Entry, Pool->Tag);
+    }
 }
 
 QUIC_INLINE
@@ -572,36 +977,187 @@ CxPlatPoolUninitialize(
     )
 {
     CXPLAT_POOL_HEADER* Entry;
+    if (Pool->Magazines != NULL) {
+        for (uint32_t i = 0; i < Pool->MagazineCount; ++i) {
+            CXPLAT_POOL_MAGAZINE* Magazine = &Pool->Magazines[i];
+            while ((Entry = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Magazine->ListHead)) != NULL) {
+                CXPLAT_DBG_ASSERT(Entry->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
+                CxPlatPoolFreeEntry(Pool, Entry);
+            }
+        }
+        CxPlatFree(Pool->MagazinesAllocation, Pool->Tag);
+        Pool->MagazinesAllocation = NULL;
+        Pool->Magazines = NULL;
+    }
     while ((Entry = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead)) != NULL) {
         CXPLAT_DBG_ASSERT(Entry->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
-        CxPlatFree(Entry, Pool->Tag);
+        CxPlatPoolFreeEntry(Pool, Entry);
     }
+    //
+    // Arena entries stay mapped until the arena itself is released.
+    //
+    CxPlatZeroMemory(&Pool->ArenaFreeList, sizeof(Pool->ArenaFreeList));
+    CXPLAT_SLIST_ENTRY* Slab;
+    while ((Slab = CxPlatListPopEntry(&Pool->NumaSlabs)) != NULL) {
+        CxPlatFreeNuma(Slab, CxPlatPoolNumaSlabSize(Pool), Pool->Tag, Pool->NumaNode);
+    }
+    CxPlatZeroMemory(&Pool->NumaFreeList, sizeof(Pool->NumaFreeList));
     CxPlatLockUninitialize(&Pool->Lock);
 }
 
+//
+// Takes a magazine, unless another thread is using it.
+//
 QUIC_INLINE
-void*
-CxPlatPoolAlloc(
-    _Inout_ CXPLAT_POOL* Pool
+BOOLEAN
+CxPlatPoolMagazineTryAcquire(
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    return InterlockedCompareExchange(&Magazine->Busy, 1, 0) == 0;
+}
+
+//
+// Takes the current processor's magazine, or returns NULL if the pool has no
+// magazines or another thread is using it.
+//
+QUIC_INLINE
+CXPLAT_POOL_MAGAZINE*
+CxPlatPoolMagazineAcquire(
+    _In_ CXPLAT_POOL* Pool
     )
 {
+    if (Pool->Magazines == NULL) {
+        return NULL;
+    }
+    CXPLAT_POOL_MAGAZINE* Magazine =
+        &Pool->Magazines[CxPlatProcCurrentNumber() % Pool->MagazineCount];
+    if (!CxPlatPoolMagazineTryAcquire(Magazine)) {
+        return NULL;
+    }
+    return Magazine;
+}
+
+QUIC_INLINE
+void
+CxPlatPoolMagazineRelease(
+    _In_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    __atomic_store_n(&Magazine->Busy, 0, __ATOMIC_RELEASE);
+}
+
+//
+// Moves up to half a magazine's worth of entries from the depot into an empty
+// magazine. If the depot is empty too, the magazine was too small for the
+// demand on this processor, so it grows.
+//
+QUIC_INLINE
+void
+CxPlatPoolMagazineRefill(
+    _In_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    CXPLAT_DBG_ASSERT(Magazine->Depth == 0);
     CxPlatLockAcquire(&Pool->Lock);
-    CXPLAT_POOL_HEADER* Header =
-    #if DEBUG
-        CxPlatGetAllocFailDenominator() ? NULL : // No pool when using simulated alloc failures
-    #endif
-        (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead);
-    if (Header != NULL) {
+    while (Magazine->Depth < Magazine->Capacity / 2) {
+        CXPLAT_SLIST_ENTRY* Entry = CxPlatListPopEntry(&Pool->ListHead);
+        if (Entry == NULL) {
+            break;
+        }
         CXPLAT_DBG_ASSERT(Pool->ListDepth > 0);
-        CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
         Pool->ListDepth--;
+        CxPlatListPushEntry(&Magazine->ListHead, Entry);
+        Magazine->Depth++;
     }
     CxPlatLockRelease(&Pool->Lock);
+
+    if (Magazine->Depth == 0 &&
+        Magazine->Capacity < CXPLAT_POOL_MAGAZINE_MAX_CAPACITY) {
+        Magazine->Capacity *= 2;
+    }
+}
+
+//
+// Moves half of a full magazine's entries to the depot. Whatever the depot
+// has no room for is freed, and the magazine shrinks since this processor
+// frees more than it allocates.
+//
+QUIC_INLINE
+void
+CxPlatPoolMagazineFlush(
+    _In_ CXPLAT_POOL* Pool,
+    _Inout_ CXPLAT_POOL_MAGAZINE* Magazine
+    )
+{
+    CXPLAT_SLIST_ENTRY Excess = { NULL };
+    BOOLEAN Overflowed = FALSE;
+
+    CxPlatLockAcquire(&Pool->Lock);
+    while (Magazine->Depth > Magazine->Capacity / 2) {
+        CXPLAT_SLIST_ENTRY* Entry = CxPlatListPopEntry(&Magazine->ListHead);
+        Magazine->Depth--;
+        if (Pool->ListDepth < CXPLAT_POOL_MAXIMUM_DEPTH) {
+            CxPlatListPushEntry(&Pool->ListHead, Entry);
+            Pool->ListDepth++;
+        } else {
+            CxPlatListPushEntry(&Excess, Entry);
+            Overflowed = TRUE;
+        }
+    }
+    CxPlatLockRelease(&Pool->Lock);
+
+    CXPLAT_SLIST_ENTRY* Entry;
+    while ((Entry = CxPlatListPopEntry(&Excess)) != NULL) {
+        CxPlatPoolFreeEntry(Pool, Entry);
+    }
+
+    if (Overflowed &&
+        Magazine->Capacity > CXPLAT_POOL_MAGAZINE_MIN_CAPACITY) {
+        Magazine->Capacity /= 2;
+    }
+}
+
+QUIC_INLINE
+void*
+CxPlatPoolAlloc(
+    _Inout_ CXPLAT_POOL* Pool
+    )
+{
+    CXPLAT_POOL_HEADER* Header = NULL;
+#if DEBUG
+    if (!CxPlatGetAllocFailDenominator()) // No pool when using simulated alloc failures
+#endif
+    {
+        CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolMagazineAcquire(Pool);
+        if (Magazine != NULL) {
+            if (Magazine->Depth == 0) {
+                CxPlatPoolMagazineRefill(Pool, Magazine);
+            }
+            Header = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Magazine->ListHead);
+            if (Header != NULL) {
+                Magazine->Depth--;
+            }
+            CxPlatPoolMagazineRelease(Magazine);
+        } else {
+            CxPlatLockAcquire(&Pool->Lock);
+            Header = (CXPLAT_POOL_HEADER*)CxPlatListPopEntry(&Pool->ListHead);
+            if (Header != NULL) {
+                CXPLAT_DBG_ASSERT(Pool->ListDepth > 0);
+                Pool->ListDepth--;
+            }
+            CxPlatLockRelease(&Pool->Lock);
+        }
+    }
     if (Header == NULL) {
-        Header = (CXPLAT_POOL_HEADER*)CxPlatAlloc(Pool->Size, Pool->Tag);
+        InterlockedIncrement64(&Pool->MissCount);
+        Header = (CXPLAT_POOL_HEADER*)CxPlatPoolAllocEntry(Pool);
         if (Header == NULL) {
             return NULL;
         }
+    } else {
+        CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_FREE_FLAG);
     }
 #if DEBUG
     Header->SpecialFlag = CXPLAT_POOL_ALLOC_FLAG;
@@ -621,13 +1177,29 @@ CxPlatPoolFree(
 #if DEBUG
     CXPLAT_DBG_ASSERT(Header->SpecialFlag == CXPLAT_POOL_ALLOC_FLAG);
     if (CxPlatGetAllocFailDenominator()) {
-        CxPlatFree(Header, Pool->Tag);
+        CxPlatPoolFreeEntry(Pool, Header);
         return;
     }
     Header->SpecialFlag = CXPLAT_POOL_FREE_FLAG;
 #endif
+
+    //
+    // Frees go to the freeing processor's magazine, whichever thread or
+    // processor allocated the entry, so a cross-thread free stays local too.
+    //
+    CXPLAT_POOL_MAGAZINE* Magazine = CxPlatPoolMagazineAcquire(Pool);
+    if (Magazine != NULL) {
+        if (Magazine->Depth >= Magazine->Capacity) {
+            CxPlatPoolMagazineFlush(Pool, Magazine);
+        }
+        CxPlatListPushEntry(&Magazine->ListHead, &Header->Entry);
+        Magazine->Depth++;
+        CxPlatPoolMagazineRelease(Magazine);
+        return;
+    }
+
     if (Pool->ListDepth >= CXPLAT_POOL_MAXIMUM_DEPTH) {
-        CxPlatFree(Header, Pool->Tag);
+        CxPlatPoolFreeEntry(Pool, Header);
     } else {
         CxPlatLockAcquire(&Pool->Lock);
         CxPlatListPushEntry(&Pool->ListHead, &Header->Entry);
@@ -636,6 +1208,30 @@ CxPlatPoolFree(
     }
 }
 
+//
+// Returns the number of free entries in the depot and the magazines. The
+// magazines are read without synchronization, so the result is approximate.
+//
+QUIC_INLINE
+uint32_t
+CxPlatPoolGetDepth(
+    _In_ CXPLAT_POOL* Pool
+    )
+{
+    uint32_t Depth = Pool->ListDepth;
+    if (Pool->Magazines != NULL) {
+        for (uint32_t i = 0; i < Pool->MagazineCount; ++i) {
+            Depth += __atomic_load_n(&Pool->Magazines[i].Depth, __ATOMIC_RELAXED);
+        }
+    }
+    return Depth;
+}
+
+//
+// Frees one cached entry: from the depot if it has any, or else from the
+// first magazine that isn't in use, so that the memory held by idle
+// processors' magazines can be trimmed too.
+//
 QUIC_INLINE
 BOOLEAN
 CxPlatPoolPrune(
@@ -649,10 +1245,26 @@ CxPlatPoolPrune(
         Pool->ListDepth--;
     }
     CxPlatLockRelease(&Pool->Lock);
+
+    if (Entry == NULL && Pool->Magazines != NULL) {
+        for (uint32_t i = 0; i < Pool->MagazineCount && Entry == NULL; ++i) {
+            CXPLAT_POOL_MAGAZINE* Magazine = &Pool->Magazines[i];
+            if (__atomic_load_n(&Magazine->Depth, __ATOMIC_RELAXED) == 0 ||
+                !CxPlatPoolMagazineTryAcquire(Magazine)) {
+                continue;
+            }
+            Entry = CxPlatListPopEntry(&Magazine->ListHead);
+            if (Entry != NULL) {
+                Magazine->Depth--;
+            }
+            CxPlatPoolMagazineRelease(Magazine);
+        }
+    }
+
     if (Entry == NULL) {
         return FALSE;
     }
-    CxPlatFree(Entry, Pool->Tag);
+    CxPlatPoolFreeEntry(Pool, Entry);
     return TRUE;
 }
 
@@ -1064,6 +1676,7 @@ typedef struct CXPLAT_SQE {
 typedef enum CXPLAT_IO_RING_BUF_GROUP {
     CxPlatIoRingBufGroupSend,
     CxPlatIoRingBufGroupRecv,
+    CxPlatIoRingBufGroupRecvSmall,
 } CXPLAT_IO_RING_BUF_GROUP;
 
 QUIC_INLINE
@@ -1087,6 +1700,45 @@ CxPlatEventQInitialize(
     return 0 == io_uring_queue_init_params(4096, &Queue->Ring, &params); // TODO - make size configurable
 }
 
+//
+// Initializes the event queue with a kernel thread polling its submission
+// queue, so submitting doesn't need a syscall while that thread is awake. The
+// thread is shared with AttachQueue, if provided, or otherwise pinned to
+// SqThreadCpu (unless UINT32_MAX). Falls back to a regular event queue if
+// SQPOLL isn't available.
+//
+QUIC_INLINE
+BOOLEAN
+CxPlatEventQInitializeSqPoll(
+    _Out_ CXPLAT_EVENTQ* Queue,
+    _In_opt_ const CXPLAT_EVENTQ* AttachQueue,
+    _In_ uint32_t SqThreadCpu,
+    _In_ uint32_t SqThreadIdleMs
+    )
+{
+    CxPlatZeroMemory(Queue, sizeof(*Queue));
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SQPOLL // COOP_TASKRUN isn't allowed with SQPOLL
+#ifdef IORING_SETUP_SUBMIT_ALL
+        | IORING_SETUP_SUBMIT_ALL
+#endif
+        ;
+    params.sq_thread_idle = SqThreadIdleMs;
+    if (AttachQueue != NULL) {
+        params.flags |= IORING_SETUP_ATTACH_WQ;
+        params.wq_fd = (uint32_t)AttachQueue->Ring.ring_fd;
+    } else if (SqThreadCpu != UINT32_MAX) {
+        params.flags |= IORING_SETUP_SQ_AFF;
+        params.sq_thread_cpu = SqThreadCpu;
+    }
+    if (0 != io_uring_queue_init_params(4096, &Queue->Ring, &params)) {
+        return CxPlatEventQInitialize(Queue);
+    }
+    CxPlatLockInitialize(&Queue->Lock);
+    return TRUE;
+}
+
 QUIC_INLINE
 void
 CxPlatEventQCleanup(
@@ -1457,6 +2109,21 @@ CxPlatEventQEnqueue(
     return kevent(*queue, &event, 1, NULL, 0, NULL) == 0;
 }
 
+//
+// Filter changes made by the thread that dequeues from an event queue are
+// collected here and submitted along with its next dequeue, instead of each
+// costing a kevent call of its own.
+//
+#define CXPLAT_EVENTQ_MAX_PENDING_CHANGES 8
+
+typedef struct CXPLAT_EVENTQ_CHANGES {
+    const CXPLAT_EVENTQ* Queue; // The queue the current thread dequeues from.
+    int Count;
+    struct kevent Changes[CXPLAT_EVENTQ_MAX_PENDING_CHANGES];
+} CXPLAT_EVENTQ_CHANGES;
+
+extern __thread CXPLAT_EVENTQ_CHANGES CxPlatEventQChanges;
+
 QUIC_INLINE
 BOOLEAN
 CxPlatEventQEnqueueEx(
@@ -1467,6 +2134,25 @@ CxPlatEventQEnqueueEx(
     )
 {
     struct kevent event = {.ident = sqe->Handle, .filter = filter, .flags = flags, .fflags = 0, .data = 0, .udata = sqe};
+    CXPLAT_EVENTQ_CHANGES* changes = &CxPlatEventQChanges;
+    if (flags & EV_DELETE) {
+        //
+        // Deletes are applied right away, as the caller may close the fd (and
+        // free the SQE) next. Drop any pending change for the same SQE too.
+        //
+        if (changes->Queue == queue) {
+            int j = 0;
+            for (int i = 0; i < changes->Count; i++) {
+                if (changes->Changes[i].udata != sqe) {
+                    changes->Changes[j++] = changes->Changes[i];
+                }
+            }
+            changes->Count = j;
+        }
+    } else if (changes->Queue == queue && changes->Count < CXPLAT_EVENTQ_MAX_PENDING_CHANGES) {
+        changes->Changes[changes->Count++] = event;
+        return TRUE;
+    }
     return kevent(*queue, &event, 1, NULL, 0, NULL) == 0;
 }
 
@@ -1484,11 +2170,20 @@ CxPlatEventQDequeue(
         timeout.tv_sec = (wait_time / 1000);
         timeout.tv_nsec = ((wait_time % 1000) * 1000000);
     }
+    CXPLAT_EVENTQ_CHANGES* changes = &CxPlatEventQChanges;
+    changes->Queue = queue;
+    int change_count = changes->Count;
+    changes->Count = 0;
     int result;
     do {
-        result = kevent(*queue, NULL, 0, events, count, wait_time == UINT32_MAX ? NULL : &timeout);
+        //
+        // Any change that fails is reported back as an EV_ERROR event, which
+        // the SQE's completion treats like a spurious wake up.
+        //
+        result = kevent(*queue, changes->Changes, change_count, events, count, wait_time == UINT32_MAX ? NULL : &timeout);
+        change_count = 0;
     } while ((result == -1L) && (errno == EINTR));
-    return (uint32_t)result;
+    return result < 0 ? 0 : (uint32_t)result;
 }
 
 QUIC_INLINE
@@ -1641,6 +2336,25 @@ CxPlatProcCurrentNumber(
     void
     );
 
+//
+// Returns the NUMA node of the processor, or 0 if NUMA info isn't available.
+//
+uint16_t
+CxPlatProcNumaNode(
+    _In_ uint32_t Processor
+    );
+
+//
+// Fills in the processors the process is restricted to by its cgroup cpuset,
+// capped to the number of CPUs its cgroup CPU quota amounts to. Returns 0 if
+// the process isn't restricted to fewer than CxPlatProcCount() processors.
+//
+uint32_t
+CxPlatProcGetRestrictedList(
+    _In_ uint32_t ListLength,
+    _Out_writes_to_(ListLength, return) uint16_t* List
+    );
+
 //
 // Rundown Protection Interfaces.
 //
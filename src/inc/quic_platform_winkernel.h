@@ -389,6 +389,9 @@ typedef EX_SPIN_LOCK CXPLAT_DISPATCH_RW_LOCK;
 #define QuicReadLongPtrNoFence ReadNoFence
 #endif
 #define QuicReadPtrNoFence ReadPointerNoFence
+#define QuicReadPtrAcquire ReadPointerAcquire
+#define QuicWritePtrRelease WritePointerRelease
+#define CxPlatPrefetch(p) PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, (p))
 
 typedef LONG_PTR CXPLAT_REF_COUNT;
 
@@ -934,6 +937,39 @@ extern uint32_t CxPlatProcessorCount;
 #define CxPlatProcCount() CxPlatProcessorCount
 #define CxPlatProcCurrentNumber() (KeGetCurrentProcessorIndex() % CxPlatProcessorCount)
 
+//
+// Pools aren't explicitly placed on a NUMA node on Windows; entries follow
+// the allocating thread's ideal node.
+//
+#define CxPlatProcNumaNode(Processor) ((void)(Processor), (uint16_t)0)
+#define CxPlatProcGetRestrictedList(ListLength, List) \
+    ((void)(ListLength), (void)(List), (uint32_t)0)
+#define CxPlatPoolInitializeNuma(IsPaged, Size, Tag, NumaNode, Pool) \
+    ((void)(NumaNode), CxPlatPoolInitialize(IsPaged, Size, Tag, Pool))
+
+//
+// Huge page arenas aren't supported on Windows; pools always use the heap.
+//
+#define CxPlatHugePagesConfigure(PageSize) ((void)(PageSize))
+#define CxPlatPoolEnableHugePages(Pool) ((void)(Pool))
+
+//
+// Per-tag allocation accounting isn't implemented on Windows, which has its own
+// pool tag tooling.
+//
+typedef struct CXPLAT_ALLOC_TAG_STATS {
+    uint32_t Tag;
+    uint32_t AllocationsPerSecond;
+    uint64_t LiveBytes;
+    uint64_t PeakBytes;
+    uint64_t TotalAllocations;
+} CXPLAT_ALLOC_TAG_STATS;
+
+#define CxPlatAllocTelemetryEnable(Enable) ((void)(Enable), FALSE)
+#define CxPlatAllocTelemetryGetTagCount() ((uint32_t)0)
+#define CxPlatAllocTelemetryGetTag(Index, Stats) \
+    ((void)(Index), CxPlatZeroMemory(Stats, sizeof(CXPLAT_ALLOC_TAG_STATS)))
+
 //
 // Rundown Protection Interfaces
 //
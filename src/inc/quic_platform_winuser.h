@@ -326,6 +326,7 @@ typedef struct CXPLAT_POOL {
     uint32_t MaxDepth;
     CXPLAT_POOL_ALLOC_FN Allocate;
     CXPLAT_POOL_FREE_FN Free;
+    int64_t MissCount; // Allocations that had to allocate a new entry.
 } CXPLAT_POOL;
 
 #ifndef DISABLE_CXPLAT_POOL
@@ -380,6 +381,7 @@ CxPlatPoolInitialize(
     Pool->MaxDepth = CXPLAT_POOL_DEFAULT_MAX_DEPTH;
     Pool->Allocate = CxPlatPoolGenericAlloc;
     Pool->Free = CxPlatPoolGenericFree;
+    Pool->MissCount = 0;
     InitializeSListHead(&(Pool)->ListHead);
     UNREFERENCED_PARAMETER(IsPaged);
 }
@@ -400,6 +402,7 @@ CxPlatPoolInitializeEx(
     Pool->Tag = Tag;
     Pool->Allocate = Allocate ? Allocate : CxPlatPoolGenericAlloc;
     Pool->Free = Free ? Free : CxPlatPoolGenericFree;
+    Pool->MissCount = 0;
     InitializeSListHead(&(Pool)->ListHead);
     UNREFERENCED_PARAMETER(IsPaged);
     if (MaxDepth != 0) {
@@ -436,6 +439,7 @@ CxPlatPoolAlloc(
 #endif
         (CXPLAT_POOL_HEADER*)InterlockedPopEntrySList(&Pool->ListHead);
     if (Header == NULL) {
+        InterlockedIncrement64(&Pool->MissCount);
         Header = Pool->Allocate(Pool->Size, Pool->Tag, Pool);
         if (Header == NULL) {
             return NULL;
@@ -474,6 +478,18 @@ CxPlatPoolFree(
     }
 }
 
+//
+// Returns the number of free entries cached by the pool.
+//
+QUIC_INLINE
+uint32_t
+CxPlatPoolGetDepth(
+    _In_ CXPLAT_POOL* Pool
+    )
+{
+    return QueryDepthSList(&Pool->ListHead);
+}
+
 QUIC_INLINE
 BOOLEAN
 CxPlatPoolPrune(
@@ -579,10 +595,16 @@ typedef SRWLOCK CXPLAT_DISPATCH_RW_LOCK;
 
 #ifdef QUIC_RESTRICTED_BUILD
 #define QuicReadPtrNoFence(p) ((void*)(*p))
+#define QuicReadPtrAcquire(p) ((void*)(*(void* volatile*)(p)))
+#define QuicWritePtrRelease(p, v) (*(void* volatile*)(p) = (v))
 #else
 #define QuicReadPtrNoFence ReadPointerNoFence
+#define QuicReadPtrAcquire ReadPointerAcquire
+#define QuicWritePtrRelease WritePointerRelease
 #endif
 
+#define CxPlatPrefetch(p) PreFetchCacheLine(PF_TEMPORAL_LEVEL_1, (p))
+
 typedef LONG_PTR CXPLAT_REF_COUNT;
 
 QUIC_INLINE
@@ -1096,6 +1118,39 @@ CxPlatProcCurrentNumber(
     return CxPlatProcNumberToIndex(&ProcNumber);
 }
 
+//
+// Pools aren't explicitly placed on a NUMA node on Windows; entries follow
+// the allocating thread's ideal node.
+//
+#define CxPlatProcNumaNode(Processor) ((void)(Processor), (uint16_t)0)
+#define CxPlatProcGetRestrictedList(ListLength, List) \
+    ((void)(ListLength), (void)(List), (uint32_t)0)
+#define CxPlatPoolInitializeNuma(IsPaged, Size, Tag, NumaNode, Pool) \
+    ((void)(NumaNode), CxPlatPoolInitialize(IsPaged, Size, Tag, Pool))
+
+//
+// Huge page arenas aren't supported on Windows; pools always use the heap.
+//
+#define CxPlatHugePagesConfigure(PageSize) ((void)(PageSize))
+#define CxPlatPoolEnableHugePages(Pool) ((void)(Pool))
+
+//
+// Per-tag allocation accounting isn't implemented on Windows, which has its own
+// pool tag tooling.
+//
+typedef struct CXPLAT_ALLOC_TAG_STATS {
+    uint32_t Tag;
+    uint32_t AllocationsPerSecond;
+    uint64_t LiveBytes;
+    uint64_t PeakBytes;
+    uint64_t TotalAllocations;
+} CXPLAT_ALLOC_TAG_STATS;
+
+#define CxPlatAllocTelemetryEnable(Enable) ((void)(Enable), FALSE)
+#define CxPlatAllocTelemetryGetTagCount() ((uint32_t)0)
+#define CxPlatAllocTelemetryGetTag(Index, Stats) \
+    ((void)(Index), CxPlatZeroMemory(Stats, sizeof(CXPLAT_ALLOC_TAG_STATS)))
+
 
 //
 // Create Thread Interfaces
@@ -0,0 +1,46 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Static probes on the send and receive hot paths, for use with tools such
+    as bpftrace or perf (i.e. usdt:libmsquic.so:msquic:send_flush_entry).
+
+    When QUIC_USDT_PROBES is defined (Linux only), each probe compiles down to
+    a single nop instruction plus an ELF note describing its arguments, so a
+    disabled probe costs nothing beyond making its arguments available.
+    Otherwise, the probes compile away completely.
+
+    Probes:
+
+        send_flush_entry (Connection)
+        send_flush_exit (Connection, DatagramCount, DatagramBytes)
+        packet_finalize (Connection, PacketNumber, PacketLength)
+        packet_sent (Connection, PacketNumber, PacketLength, PacketsInFlight)
+        datapath_send (Binding, DatagramCount, DatagramBytes)
+        datapath_recv (Binding, DatagramCount, DatagramBytes)
+
+--*/
+
+#pragma once
+
+#if defined(QUIC_USDT_PROBES) && defined(CX_PLATFORM_LINUX)
+
+#include <sys/sdt.h>
+
+#define QuicProbe1(Name, A1) \
+    DTRACE_PROBE1(msquic, Name, A1)
+#define QuicProbe3(Name, A1, A2, A3) \
+    DTRACE_PROBE3(msquic, Name, A1, A2, A3)
+#define QuicProbe4(Name, A1, A2, A3, A4) \
+    DTRACE_PROBE4(msquic, Name, A1, A2, A3, A4)
+
+#else
+
+#define QuicProbe1(Name, A1)
+#define QuicProbe3(Name, A1, A2, A3)
+#define QuicProbe4(Name, A1, A2, A3, A4)
+
+#endif
@@ -251,6 +251,10 @@
 #define _Out_writes_(...)
 #endif
 
+#ifndef _Out_writes_opt_
+#define _Out_writes_opt_(...)
+#endif
+
 #ifndef _Field_z_
 #define _Field_z_
 #endif
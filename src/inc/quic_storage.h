@@ -130,6 +130,114 @@ CxPlatStorageClear(
 
 #endif // CXPLAT_STORAGE_ENABLE_WRITE_SUPPORT
 
+//
+// Storage files are plain files, written only by appending or by replacing
+// their whole contents, that persist caches across process restarts. They
+// are separate from the configuration store above.
+//
+typedef struct CXPLAT_STORAGE_FILE CXPLAT_STORAGE_FILE;
+
+//
+// Opens the file at the path, creating it (empty) if it doesn't exist.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileOpen(
+    _In_z_ const char * Path,
+    _Out_ CXPLAT_STORAGE_FILE** NewFile
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatStorageFileClose(
+    _In_opt_ _Post_invalid_ CXPLAT_STORAGE_FILE* File
+    );
+
+//
+// Maps the current contents of the file read-only. An empty file returns
+// NULL with a zero length. The mapping must be released with
+// CxPlatStorageFileUnmap.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileMap(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _Outptr_result_buffer_maybenull_(*Length)
+        const uint8_t** Data,
+    _Out_ uint64_t* Length
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatStorageFileUnmap(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _In_opt_ const uint8_t* Data,
+    _In_ uint64_t Length
+    );
+
+//
+// Appends to the end of the file.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileAppend(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _In_ uint32_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    );
+
+//
+// Atomically replaces the whole contents of the file. After a crash, the file
+// holds either the old or the new contents.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileReplace(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _In_ uint32_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    );
+
+//
+// A read-only mapping of part of an app-provided file.
+//
+typedef struct CXPLAT_FILE_RANGE {
+
+    //
+    // The mapped pages, which start at or before the requested offset.
+    //
+    void* Mapping;
+    size_t MappingLength;
+
+    //
+    // The start of the requested range, within the mapping.
+    //
+    const uint8_t* Data;
+
+} CXPLAT_FILE_RANGE;
+
+//
+// Maps Length bytes of the file, starting at Offset, read-only. The offset
+// doesn't need to be page aligned. The range must lie within the file. The
+// mapping must be released with CxPlatFileRangeUnmap.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatFileRangeMap(
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _Out_ CXPLAT_FILE_RANGE* Range
+    );
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatFileRangeUnmap(
+    _In_ CXPLAT_FILE_RANGE* Range
+    );
+
 #if defined(__cplusplus)
 }
 #endif
@@ -66,8 +66,14 @@ typedef struct CXPLAT_TOEPLITZ_LOOKUP_TABLE {
 
 typedef struct CXPLAT_TOEPLITZ_HASH {
     CXPLAT_TOEPLITZ_LOOKUP_TABLE LookupTableArray[CXPLAT_TOEPLITZ_LOOKUP_TABLE_COUNT_MAX];
+    //
+    // For each input byte offset, the next 95 bits of the key in reverse bit
+    // order, used by the carry-less multiply implementation.
+    //
+    uint64_t ClmulKeys[CXPLAT_TOEPLITZ_INPUT_SIZE_MAX][2];
     uint8_t HashKey[CXPLAT_TOEPLITZ_KEY_SIZE_MAX];
     CXPLAT_TOEPLITZ_INPUT_SIZE InputSize;
+    BOOLEAN UseClmul;
 } CXPLAT_TOEPLITZ_HASH;
 
 //
@@ -61,22 +61,32 @@ QuicVarIntEncode(
 {
     CXPLAT_DBG_ASSERT(Value <= QUIC_VAR_INT_MAX);
 
-    if (Value < 0x40) {
+    //
+    // Compute the 2-bit length prefix without a comparison chain; the
+    // compiler lowers each comparison to a flag set rather than a branch.
+    //
+    const uint8_t Prefix =
+        (uint8_t)((Value >= 0x40) + (Value >= 0x4000) + (Value >= 0x40000000));
+    switch (Prefix) {
+    case 0:
         Buffer[0] = (uint8_t)Value;
         return Buffer + sizeof(uint8_t);
-    } else if (Value < 0x4000) {
+    case 1: {
         const uint16_t tmp = CxPlatByteSwapUint16((0x40 << 8) | (uint16_t)Value);
         memcpy(Buffer, &tmp, sizeof(tmp));
         return Buffer + sizeof(uint16_t);
-    } else if (Value < 0x40000000) {
+    }
+    case 2: {
         const uint32_t tmp = CxPlatByteSwapUint32((0x80UL << 24) | (uint32_t)Value);
         memcpy(Buffer, &tmp, sizeof(tmp));
         return Buffer + sizeof(uint32_t);
-    } else {
+    }
+    default: {
         const uint64_t tmp = CxPlatByteSwapUint64((0xc0ULL << 56) | Value);
         memcpy(Buffer, &tmp, sizeof(tmp));
         return Buffer + sizeof(uint64_t);
     }
+    }
 }
 
 //
@@ -98,6 +108,45 @@ QuicVarIntEncode2Bytes(
     return Buffer + sizeof(uint16_t);
 }
 
+//
+// Decodes a variable-length integer that is already known to be fully
+// contained in the buffer. The encoded length comes straight from the two
+// high bits of the first byte, so decoding is a single dispatch.
+//
+QUIC_INLINE
+uint16_t
+QuicVarIntDecodeUnchecked(
+    _In_ const uint8_t * const Src,
+    _Out_ QUIC_VAR_INT* Value
+    )
+{
+    const uint8_t Prefix = Src[0] >> 6;
+    switch (Prefix) {
+    case 0:
+        *Value = Src[0];
+        CXPLAT_ANALYSIS_ASSERT(*Value < 0x100ULL);
+        break;
+    case 1:
+        *Value = ((uint64_t)(Src[0] & 0x3fUL) << 8) | Src[1];
+        CXPLAT_ANALYSIS_ASSERT(*Value < 0x10000ULL);
+        break;
+    case 2: {
+        uint32_t v;
+        memcpy(&v, Src, sizeof(uint32_t));
+        *Value = CxPlatByteSwapUint32(v) & 0x3fffffffUL;
+        CXPLAT_ANALYSIS_ASSERT(*Value < 0x100000000ULL);
+        break;
+    }
+    default: {
+        uint64_t v;
+        memcpy(&v, Src, sizeof(uint64_t));
+        *Value = CxPlatByteSwapUint64(v) & 0x3fffffffffffffffULL;
+        break;
+    }
+    }
+    return (uint16_t)(1u << Prefix);
+}
+
 //
 // Helper to decode a variable-length integer.
 //
@@ -115,38 +164,46 @@ QuicVarIntDecode(
     _Out_ QUIC_VAR_INT* Value
     )
 {
-    if (BufferLength < sizeof(uint8_t) + *Offset) {
+    if (BufferLength <= *Offset ||
+        BufferLength < (1u << (Buffer[*Offset] >> 6)) + *Offset) {
         return FALSE;
     }
-    if (Buffer[*Offset] < 0x40) {
-        *Value = Buffer[*Offset];
-        CXPLAT_ANALYSIS_ASSERT(*Value < 0x100ULL);
-        *Offset += sizeof(uint8_t);
-    } else if (Buffer[*Offset] < 0x80) {
-        if (BufferLength < sizeof(uint16_t) + *Offset) {
-            return FALSE;
-        }
-        *Value = ((uint64_t)(Buffer[*Offset] & 0x3fUL)) << 8;
-        *Value |= Buffer[*Offset + 1];
-        CXPLAT_ANALYSIS_ASSERT(*Value < 0x10000ULL);
-        *Offset += sizeof(uint16_t);
-    } else if (Buffer[*Offset] < 0xc0) {
-        if (BufferLength < sizeof(uint32_t) + *Offset) {
-            return FALSE;
+    *Offset += QuicVarIntDecodeUnchecked(Buffer + *Offset, Value);
+    return TRUE;
+}
+
+//
+// Decodes Count consecutive variable-length integers. When the remaining
+// buffer can hold Count maximum-length encodings, the per-value bounds
+// checks are skipped entirely. On failure, Offset and the already decoded
+// Values are left in an unspecified state.
+//
+QUIC_INLINE
+_Success_(return != FALSE)
+BOOLEAN
+QuicVarIntDecodeArray(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_
+    _Deref_in_range_(0, BufferLength)
+    _Deref_out_range_(0, BufferLength)
+        uint16_t* Offset,
+    _In_ uint16_t Count,
+    _Out_writes_(Count) QUIC_VAR_INT* Values
+    )
+{
+    if (BufferLength >= *Offset &&
+        (uint32_t)(BufferLength - *Offset) >= (uint32_t)Count * sizeof(uint64_t)) {
+        for (uint16_t i = 0; i < Count; ++i) {
+            *Offset += QuicVarIntDecodeUnchecked(Buffer + *Offset, &Values[i]);
         }
-        uint32_t v;
-        memcpy(&v, Buffer + *Offset, sizeof(uint32_t));
-        *Value = CxPlatByteSwapUint32(v) & 0x3fffffffUL;
-        CXPLAT_ANALYSIS_ASSERT(*Value < 0x100000000ULL);
-        *Offset += sizeof(uint32_t);
-    } else {
-        if (BufferLength < sizeof(uint64_t) + *Offset) {
+        return TRUE;
+    }
+    for (uint16_t i = 0; i < Count; ++i) {
+        if (!QuicVarIntDecode(BufferLength, Buffer, Offset, &Values[i])) {
             return FALSE;
         }
-        uint64_t v;
-        memcpy(&v, Buffer + *Offset, sizeof(uint64_t));
-        *Value = CxPlatByteSwapUint64(v) & 0x3fffffffffffffffULL;
-        *Offset += sizeof(uint64_t);
     }
     return TRUE;
 }
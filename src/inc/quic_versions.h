@@ -20,6 +20,11 @@ Abstract:
 #define QUIC_VERSION_MS_1       0x0000cdabU     // First Microsoft version (currently same as latest draft)
 #define QUIC_VERSION_DRAFT_29   0x1d0000ffU     // IETF draft 29
 
+//
+// The number of versions above (excluding 'Version Negotiation').
+//
+#define QUIC_SUPPORTED_VERSION_COUNT 4
+
 //
 // The QUIC version numbers, in host byte order.
 //
@@ -0,0 +1,1203 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Microbenchmarks for the hot core and platform kernels, run in isolation so
+    the effect of a change on them can be measured without end-to-end noise.
+
+    With -check, it instead runs randomized correctness checks of the fast
+    paths against simple reference models, and fails on any mismatch.
+
+    Each benchmark does its setup, then times a loop of State->Iterations
+    operations between PerfBenchStart and PerfBenchStop. The harness grows the
+    iteration count until a run takes at least the minimum time, then reports
+    the time per operation. Benchmarks that take a size (State->Count, e.g.
+    the number of table entries) start at Count iterations, so that a (possibly
+    slow) setup isn't redone for runs that are too short to measure anyway.
+
+--*/
+
+#include "precomp.h"
+
+#define PERF_BENCH_DEFAULT_MIN_TIME_MS  500
+#define PERF_BENCH_MAX_ITERATIONS       (1ull << 32)
+
+#define PERF_BENCH_POOL_TAG             'bPcQ' // Qc Pb - QUIC Perf Bench
+
+#define PERF_BENCH_TIMER_CONNECTIONS    1024
+#define PERF_BENCH_VAR_INT_COUNT        1024
+#define PERF_BENCH_PACKET_LENGTH        1200
+#define PERF_BENCH_MAX_PACKET_LENGTH    1500
+
+#define PERF_CHECK_VAR_INT_ROUNDS       (1u << 24)
+#define PERF_CHECK_RANGE_ROUNDS         64
+#define PERF_CHECK_RANGE_OPS            (1u << 16)
+#define PERF_CHECK_RANGE_VALUES         1024
+
+typedef struct PERF_BENCH_STATE {
+
+    //
+    // The number of operations to time, and the benchmark's arguments.
+    //
+    uint64_t Iterations;
+    uint32_t Arg;
+    uint32_t Count;
+
+    uint64_t StartUs;
+    uint64_t ElapsedUs;
+
+    //
+    // Set by the benchmark if it could not run.
+    //
+    BOOLEAN Skipped;
+
+} PERF_BENCH_STATE;
+
+typedef
+void
+PERF_BENCH_FN(
+    _Inout_ PERF_BENCH_STATE* State
+    );
+
+typedef struct PERF_BENCHMARK {
+    const char* Name;
+    PERF_BENCH_FN* Fn;
+    uint32_t Arg;
+    uint32_t Count;
+} PERF_BENCHMARK;
+
+//
+// Results are folded into this, so the compiler can't drop the timed work.
+//
+volatile uint64_t PerfBenchSink;
+
+QUIC_INLINE
+void
+PerfBenchStart(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    State->StartUs = CxPlatTimeUs64();
+}
+
+QUIC_INLINE
+void
+PerfBenchStop(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    State->ElapsedUs = CxPlatTimeDiff64(State->StartUs, CxPlatTimeUs64());
+}
+
+//
+// A cheap deterministic generator for benchmark inputs.
+//
+QUIC_INLINE
+uint64_t
+PerfBenchRandom(
+    _Inout_ uint64_t* Seed
+    )
+{
+    *Seed ^= *Seed << 13;
+    *Seed ^= *Seed >> 7;
+    *Seed ^= *Seed << 17;
+    return *Seed;
+}
+
+//
+// QUIC_RANGE
+//
+
+//
+// Adds Arg-spaced values (1 is in order, 2 leaves a gap after every value),
+// resetting every 1024 values.
+//
+void
+PerfBenchRangeAddValue(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_RANGE Range;
+    QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range);
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        if ((i & 1023) == 0) {
+            QuicRangeReset(&Range);
+        }
+        (void)QuicRangeAddValue(&Range, (i & 1023) * State->Arg);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchSink += QuicRangeSize(&Range);
+    QuicRangeUninitialize(&Range);
+}
+
+//
+// Adds values in random order within a window of Arg values, as reordered
+// packets would arrive.
+//
+void
+PerfBenchRangeAddReordered(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_RANGE Range;
+    QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range);
+    uint64_t Seed = 0x5eed;
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        if ((i & 1023) == 0) {
+            QuicRangeReset(&Range);
+        }
+        uint64_t Value = (i & 1023) + PerfBenchRandom(&Seed) % State->Arg;
+        (void)QuicRangeAddValue(&Range, Value);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchSink += QuicRangeSize(&Range);
+    QuicRangeUninitialize(&Range);
+}
+
+//
+// Searches a range holding Arg subranges.
+//
+void
+PerfBenchRangeSearch(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_RANGE Range;
+    QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range);
+    for (uint32_t i = 0; i < State->Arg; ++i) {
+        if (!QuicRangeAddValue(&Range, 2ull * i)) {
+            State->Skipped = TRUE;
+            QuicRangeUninitialize(&Range);
+            return;
+        }
+    }
+    uint64_t Seed = 0x5eed;
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        uint64_t Value = PerfBenchRandom(&Seed) % (2ull * State->Arg);
+        QUIC_RANGE_SEARCH_KEY Key = { Value, Value };
+        PerfBenchSink += (uint64_t)QuicRangeSearch(&Range, &Key);
+    }
+    PerfBenchStop(State);
+
+    QuicRangeUninitialize(&Range);
+}
+
+//
+// CXPLAT_HASHTABLE
+//
+
+typedef struct PERF_BENCH_HASH_ENTRY {
+    CXPLAT_HASHTABLE_ENTRY Entry;
+    uint64_t Key;
+} PERF_BENCH_HASH_ENTRY;
+
+//
+// Arg selects the chained (0) or open addressing (1) table, and Count the
+// number of entries in it.
+//
+_Success_(return != FALSE)
+BOOLEAN
+PerfBenchHashtableCreate(
+    _In_ uint32_t Arg,
+    _In_ uint32_t Count,
+    _Outptr_ CXPLAT_HASHTABLE** Table,
+    _Outptr_ PERF_BENCH_HASH_ENTRY** Entries
+    )
+{
+    *Table = NULL;
+    *Entries =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(PERF_BENCH_HASH_ENTRY) * Count,
+            PERF_BENCH_POOL_TAG);
+    if (*Entries == NULL) {
+        return FALSE;
+    }
+    BOOLEAN Success =
+        Arg == 0 ?
+            CxPlatHashtableInitialize(Table, CXPLAT_HASH_MIN_SIZE) :
+            CxPlatHashtableInitializeOpen(Table, CXPLAT_HASH_MIN_SIZE);
+    if (!Success) {
+        CXPLAT_FREE(*Entries, PERF_BENCH_POOL_TAG);
+        return FALSE;
+    }
+    uint64_t Seed = 0x5eed;
+    for (uint32_t i = 0; i < Count; ++i) {
+        (*Entries)[i].Key = PerfBenchRandom(&Seed);
+        CxPlatHashtableInsert(*Table, &(*Entries)[i].Entry, (*Entries)[i].Key, NULL);
+    }
+    return TRUE;
+}
+
+void
+PerfBenchHashtableDelete(
+    _In_ uint32_t Count,
+    _In_ CXPLAT_HASHTABLE* Table,
+    _In_ PERF_BENCH_HASH_ENTRY* Entries
+    )
+{
+    for (uint32_t i = 0; i < Count; ++i) {
+        CxPlatHashtableRemove(Table, &Entries[i].Entry, NULL);
+    }
+    CxPlatHashtableUninitialize(Table);
+    CXPLAT_FREE(Entries, PERF_BENCH_POOL_TAG);
+}
+
+void
+PerfBenchHashtableLookup(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    CXPLAT_HASHTABLE* Table;
+    PERF_BENCH_HASH_ENTRY* Entries;
+    if (!PerfBenchHashtableCreate(State->Arg, State->Count, &Table, &Entries)) {
+        State->Skipped = TRUE;
+        return;
+    }
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        uint64_t Key = Entries[i % State->Count].Key;
+        CXPLAT_HASHTABLE_ENTRY* Entry = CxPlatHashtableLookup(Table, Key, NULL);
+        PerfBenchSink += (uint64_t)(size_t)Entry;
+    }
+    PerfBenchStop(State);
+
+    PerfBenchHashtableDelete(State->Count, Table, Entries);
+}
+
+void
+PerfBenchHashtableInsertRemove(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    CXPLAT_HASHTABLE* Table;
+    PERF_BENCH_HASH_ENTRY* Entries;
+    if (!PerfBenchHashtableCreate(State->Arg, State->Count, &Table, &Entries)) {
+        State->Skipped = TRUE;
+        return;
+    }
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        PERF_BENCH_HASH_ENTRY* Entry = &Entries[i % State->Count];
+        CxPlatHashtableRemove(Table, &Entry->Entry, NULL);
+        CxPlatHashtableInsert(Table, &Entry->Entry, Entry->Key, NULL);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchHashtableDelete(State->Count, Table, Entries);
+}
+
+//
+// Toeplitz
+//
+
+void
+PerfBenchToeplitz(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    CXPLAT_TOEPLITZ_HASH Toeplitz;
+    CxPlatZeroMemory(&Toeplitz, sizeof(Toeplitz));
+    CxPlatRandom(sizeof(Toeplitz.HashKey), Toeplitz.HashKey);
+    Toeplitz.InputSize = CXPLAT_TOEPLITZ_INPUT_SIZE_QUIC;
+    CxPlatToeplitzHashInitialize(&Toeplitz);
+
+    uint8_t Input[CXPLAT_TOEPLITZ_INPUT_SIZE_QUIC];
+    CxPlatRandom(sizeof(Input), Input);
+    uint32_t Length = CXPLAT_MIN(State->Arg, (uint32_t)sizeof(Input));
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        Input[0] = (uint8_t)i;
+        PerfBenchSink += CxPlatToeplitzHashCompute(&Toeplitz, Input, Length, 0);
+    }
+    PerfBenchStop(State);
+}
+
+//
+// Variable-length integers
+//
+
+//
+// Fills Values with a mix of all four encoded lengths.
+//
+void
+PerfBenchVarIntValues(
+    _Out_writes_(PERF_BENCH_VAR_INT_COUNT) QUIC_VAR_INT* Values
+    )
+{
+    uint64_t Seed = 0x5eed;
+    for (uint32_t i = 0; i < PERF_BENCH_VAR_INT_COUNT; ++i) {
+        static const uint64_t Limits[] = { 0x40, 0x4000, 0x40000000, QUIC_VAR_INT_MAX };
+        Values[i] = PerfBenchRandom(&Seed) % Limits[i % ARRAYSIZE(Limits)];
+    }
+}
+
+void
+PerfBenchVarIntEncode(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_VAR_INT Values[PERF_BENCH_VAR_INT_COUNT];
+    uint8_t Buffer[PERF_BENCH_VAR_INT_COUNT * sizeof(uint64_t)];
+    PerfBenchVarIntValues(Values);
+
+    PerfBenchStart(State);
+    uint8_t* Head = Buffer;
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        uint32_t Index = (uint32_t)(i % PERF_BENCH_VAR_INT_COUNT);
+        if (Index == 0) {
+            Head = Buffer;
+        }
+        Head = QuicVarIntEncode(Values[Index], Head);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchSink += (uint64_t)(Head - Buffer);
+}
+
+void
+PerfBenchVarIntDecode(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_VAR_INT Values[PERF_BENCH_VAR_INT_COUNT];
+    uint8_t Buffer[PERF_BENCH_VAR_INT_COUNT * sizeof(uint64_t)];
+    PerfBenchVarIntValues(Values);
+    uint8_t* Head = Buffer;
+    for (uint32_t i = 0; i < PERF_BENCH_VAR_INT_COUNT; ++i) {
+        Head = QuicVarIntEncode(Values[i], Head);
+    }
+    const uint16_t Length = (uint16_t)(Head - Buffer);
+
+    PerfBenchStart(State);
+    uint16_t Offset = 0;
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        QUIC_VAR_INT Value = 0;
+        if (!QuicVarIntDecode(Length, Buffer, &Offset, &Value)) {
+            Offset = 0;
+            (void)QuicVarIntDecode(Length, Buffer, &Offset, &Value);
+        }
+        PerfBenchSink += Value;
+    }
+    PerfBenchStop(State);
+}
+
+//
+// ACK frame encoding
+//
+
+//
+// Encodes an ACK frame for Arg ACK ranges. QuicAckTrackerAckFrameEncode needs
+// a live connection and packet builder, so this times the frame encoding it
+// wraps.
+//
+void
+PerfBenchAckFrameEncode(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_RANGE Range;
+    QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range);
+    for (uint32_t i = 0; i < State->Arg; ++i) {
+        BOOLEAN Updated;
+        if (QuicRangeAddRange(&Range, 1000 + 10ull * i, 5, &Updated) == NULL) {
+            State->Skipped = TRUE;
+            QuicRangeUninitialize(&Range);
+            return;
+        }
+    }
+    uint8_t Buffer[PERF_BENCH_PACKET_LENGTH];
+    uint16_t Offset = 0;
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        Offset = 0;
+        (void)QuicAckFrameEncode(&Range, i & 0xFF, NULL, &Offset, sizeof(Buffer), Buffer);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchSink += Offset;
+    QuicRangeUninitialize(&Range);
+}
+
+//
+// ACK processing
+//
+
+//
+// Tracks one more sent 1-RTT packet, doing the loss detection and congestion
+// control bookkeeping that ACK processing undoes.
+//
+BOOLEAN
+PerfBenchAckSendPacket(
+    _In_ QUIC_CONNECTION* Connection,
+    _In_ uint64_t PacketNumber,
+    _In_ uint64_t TimeNow
+    )
+{
+    QUIC_LOSS_DETECTION* LossDetection = &Connection->LossDetection;
+    QUIC_SENT_PACKET_METADATA* Packet =
+        QuicSentPacketPoolGetPacketMetadata(&Connection->Partition->SentPacketPool, 1);
+    if (Packet == NULL) {
+        return FALSE;
+    }
+    CxPlatZeroMemory(Packet, SIZEOF_QUIC_SENT_PACKET_METADATA(1));
+    Packet->PacketNumber = PacketNumber;
+    Packet->SentTime = TimeNow;
+    Packet->PacketLength = PERF_BENCH_PACKET_LENGTH;
+    Packet->PathId = Connection->Paths[0].ID;
+    Packet->Flags.KeyType = QUIC_PACKET_KEY_1_RTT;
+    Packet->Flags.IsAckEliciting = TRUE;
+    Packet->FrameCount = 1;
+    Packet->Frames[0].Type = QUIC_FRAME_PING;
+
+    LossDetection->TotalBytesSent += Packet->PacketLength;
+    Packet->TotalBytesSent = LossDetection->TotalBytesSent;
+    LossDetection->LargestSentPacketNumber = PacketNumber;
+    *LossDetection->SentPacketsTail = Packet;
+    LossDetection->SentPacketsTail = &Packet->Next;
+    LossDetection->PacketsInFlight++;
+    LossDetection->TimeOfLastPacketSent = TimeNow;
+    QuicCongestionControlOnDataSent(&Connection->CongestionControl, Packet->PacketLength);
+    return TRUE;
+}
+
+//
+// Processes ACKs with Count packets in flight. Each iteration acknowledges the
+// oldest outstanding packet and sends a new one, so the in-flight count stays
+// constant. QuicLossDetectionProcessAckBlocks needs a connection; this uses a
+// zeroed stand-in with just the state the ACK path reads (settings, one path,
+// the 1-RTT packet space, congestion control, a sent packet pool, and a timer
+// wheel for the loss detection timer).
+//
+void
+PerfBenchAckProcess(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_PARTITION* Partition =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_PARTITION), PERF_BENCH_POOL_TAG);
+    QUIC_WORKER* Worker =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_WORKER), PERF_BENCH_POOL_TAG);
+    QUIC_CONNECTION* Connection =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_CONNECTION), PERF_BENCH_POOL_TAG);
+    QUIC_PACKET_SPACE* PacketSpace =
+        CXPLAT_ALLOC_NONPAGED(sizeof(QUIC_PACKET_SPACE), PERF_BENCH_POOL_TAG);
+    if (Partition == NULL || Worker == NULL || Connection == NULL || PacketSpace == NULL) {
+        State->Skipped = TRUE;
+        goto Exit;
+    }
+    CxPlatZeroMemory(Partition, sizeof(QUIC_PARTITION));
+    CxPlatZeroMemory(Worker, sizeof(QUIC_WORKER));
+    CxPlatZeroMemory(Connection, sizeof(QUIC_CONNECTION));
+    CxPlatZeroMemory(PacketSpace, sizeof(QUIC_PACKET_SPACE));
+
+    if (QUIC_FAILED(QuicTimerWheelInitialize(&Worker->TimerWheel, FALSE))) {
+        CXPLAT_FREE(Worker, PERF_BENCH_POOL_TAG);
+        Worker = NULL;
+        State->Skipped = TRUE;
+        goto Exit;
+    }
+    QuicSentPacketPoolInitialize(&Partition->SentPacketPool, 0);
+
+    ((QUIC_HANDLE*)Connection)->Type = QUIC_HANDLE_TYPE_CONNECTION_SERVER;
+    Connection->RefCount = 1;
+#if DEBUG
+    for (uint32_t j = 0; j < QUIC_CONN_REF_COUNT; ++j) {
+        Connection->RefTypeBiasedCount[j] = 1;
+    }
+#endif
+    Connection->Partition = Partition;
+    Connection->Worker = Worker;
+    Connection->State.HandshakeConfirmed = TRUE;
+    Connection->EarliestExpirationTime = UINT64_MAX;
+    for (uint32_t j = 0; j < QUIC_CONN_TIMER_COUNT; ++j) {
+        Connection->ExpirationTimes[j] = UINT64_MAX;
+    }
+    Connection->Send.SkippedPacketNumber = UINT64_MAX;
+    Connection->Packets[QUIC_ENCRYPT_LEVEL_1_RTT] = PacketSpace;
+    QuicSettingsSetDefault(&Connection->Settings);
+    //
+    // Open the congestion window wide enough that the connection never
+    // becomes congestion blocked (which would flush the send queue).
+    //
+    Connection->Settings.InitialWindowPackets = 2 * State->Count;
+    Connection->Stats.Timing.Start = CxPlatTimeUs64();
+    Connection->PathsCount = 1;
+    QuicPathInitialize(Connection, &Connection->Paths[0]);
+    Connection->Paths[0].IsActive = TRUE;
+    Connection->Paths[0].IsPeerValidated = TRUE;
+    QuicCongestionControlInitialize(&Connection->CongestionControl, &Connection->Settings);
+    QuicLossDetectionInitialize(&Connection->LossDetection);
+
+    QUIC_RANGE AckBlocks;
+    QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &AckBlocks);
+    BOOLEAN Updated;
+    if (QuicRangeAddRange(&AckBlocks, 0, 1, &Updated) == NULL) {
+        State->Skipped = TRUE;
+        goto Cleanup;
+    }
+
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    uint64_t NextPacketNumber = 0;
+    for (; NextPacketNumber < State->Count; ++NextPacketNumber) {
+        if (!PerfBenchAckSendPacket(Connection, NextPacketNumber, TimeNow)) {
+            State->Skipped = TRUE;
+            goto Cleanup;
+        }
+    }
+
+    QUIC_RX_PACKET Packet;
+    CxPlatZeroMemory(&Packet, sizeof(Packet));
+    Packet.SendTimestamp = UINT64_MAX;
+    BOOLEAN InvalidAckBlock = FALSE;
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations && !InvalidAckBlock; ++i) {
+        QuicRangeGet(&AckBlocks, 0)->Low = NextPacketNumber - State->Count;
+        QuicLossDetectionProcessAckBlocks(
+            &Connection->LossDetection,
+            &Connection->Paths[0],
+            &Packet,
+            QUIC_ENCRYPT_LEVEL_1_RTT,
+            0,
+            &AckBlocks,
+            &InvalidAckBlock,
+            NULL);
+        if (!PerfBenchAckSendPacket(Connection, NextPacketNumber++, TimeNow)) {
+            InvalidAckBlock = TRUE;
+        }
+    }
+    PerfBenchStop(State);
+
+    if (InvalidAckBlock || Connection->LossDetection.PacketsInFlight != State->Count) {
+        State->Skipped = TRUE;
+    }
+
+Cleanup:
+
+    while (Connection->LossDetection.SentPackets != NULL) {
+        QUIC_SENT_PACKET_METADATA* SentPacket = Connection->LossDetection.SentPackets;
+        Connection->LossDetection.SentPackets = SentPacket->Next;
+        QuicSentPacketPoolReturnPacketMetadata(SentPacket, Connection);
+    }
+    CXPLAT_DBG_ASSERT(Connection->LossDetection.LostPackets == NULL);
+    Connection->EarliestExpirationTime = UINT64_MAX;
+    QuicTimerWheelUpdateConnection(&Worker->TimerWheel, Connection);
+    QuicRangeUninitialize(&AckBlocks);
+    QuicSentPacketPoolUninitialize(&Partition->SentPacketPool);
+    QuicTimerWheelUninitialize(&Worker->TimerWheel);
+
+Exit:
+
+    if (PacketSpace != NULL) {
+        CXPLAT_FREE(PacketSpace, PERF_BENCH_POOL_TAG);
+    }
+    if (Connection != NULL) {
+        CXPLAT_FREE(Connection, PERF_BENCH_POOL_TAG);
+    }
+    if (Worker != NULL) {
+        CXPLAT_FREE(Worker, PERF_BENCH_POOL_TAG);
+    }
+    if (Partition != NULL) {
+        CXPLAT_FREE(Partition, PERF_BENCH_POOL_TAG);
+    }
+}
+
+//
+// Timer wheel
+//
+
+//
+// Reschedules connections in a wheel of PERF_BENCH_TIMER_CONNECTIONS. Arg
+// selects the sorted (0) or hierarchical (1) wheel. The connections are
+// zeroed stand-ins; the wheel only touches their timer fields and reference
+// count.
+//
+void
+PerfBenchTimerWheelUpdate(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    QUIC_TIMER_WHEEL TimerWheel;
+    if (QUIC_FAILED(QuicTimerWheelInitialize(&TimerWheel, State->Arg != 0))) {
+        State->Skipped = TRUE;
+        return;
+    }
+    QUIC_CONNECTION* Connections =
+        CXPLAT_ALLOC_NONPAGED(
+            sizeof(QUIC_CONNECTION) * PERF_BENCH_TIMER_CONNECTIONS,
+            PERF_BENCH_POOL_TAG);
+    if (Connections == NULL) {
+        QuicTimerWheelUninitialize(&TimerWheel);
+        State->Skipped = TRUE;
+        return;
+    }
+    CxPlatZeroMemory(Connections, sizeof(QUIC_CONNECTION) * PERF_BENCH_TIMER_CONNECTIONS);
+
+    const uint64_t Now = CxPlatTimeUs64();
+    uint64_t Seed = 0x5eed;
+    for (uint32_t i = 0; i < PERF_BENCH_TIMER_CONNECTIONS; ++i) {
+        Connections[i].RefCount = 1;
+#if DEBUG
+        for (uint32_t j = 0; j < QUIC_CONN_REF_COUNT; ++j) {
+            Connections[i].RefTypeBiasedCount[j] = 1;
+        }
+#endif
+        Connections[i].EarliestExpirationTime = Now + PerfBenchRandom(&Seed) % S_TO_US(10);
+        QuicTimerWheelUpdateConnection(&TimerWheel, &Connections[i]);
+    }
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        QUIC_CONNECTION* Connection = &Connections[i % PERF_BENCH_TIMER_CONNECTIONS];
+        Connection->EarliestExpirationTime = Now + PerfBenchRandom(&Seed) % S_TO_US(10);
+        QuicTimerWheelUpdateConnection(&TimerWheel, Connection);
+    }
+    PerfBenchStop(State);
+
+    for (uint32_t i = 0; i < PERF_BENCH_TIMER_CONNECTIONS; ++i) {
+        Connections[i].EarliestExpirationTime = UINT64_MAX;
+        QuicTimerWheelUpdateConnection(&TimerWheel, &Connections[i]);
+    }
+    CXPLAT_FREE(Connections, PERF_BENCH_POOL_TAG);
+    QuicTimerWheelUninitialize(&TimerWheel);
+}
+
+//
+// CXPLAT_POOL
+//
+
+//
+// Allocates Arg entries, then frees them, so Arg > 1 also exercises the pool
+// growing past its cached entries.
+//
+void
+PerfBenchPoolAllocFree(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    CXPLAT_POOL Pool;
+    CxPlatPoolInitialize(FALSE, 256, PERF_BENCH_POOL_TAG, &Pool);
+    void* Entries[64];
+    const uint32_t Count = CXPLAT_MIN(State->Arg, (uint32_t)ARRAYSIZE(Entries));
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; i += Count) {
+        for (uint32_t j = 0; j < Count; ++j) {
+            Entries[j] = CxPlatPoolAlloc(&Pool);
+        }
+        for (uint32_t j = 0; j < Count; ++j) {
+            if (Entries[j] != NULL) {
+                CxPlatPoolFree(Entries[j]);
+            }
+        }
+    }
+    PerfBenchStop(State);
+
+    CxPlatPoolUninitialize(&Pool);
+}
+
+//
+// Packet protection
+//
+
+//
+// Arg selects the AEAD, and Count the packet length (including the tag).
+//
+void
+PerfBenchEncrypt(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    CXPLAT_DBG_ASSERT(State->Count <= PERF_BENCH_MAX_PACKET_LENGTH);
+    uint8_t RawKey[32];
+    CxPlatRandom(sizeof(RawKey), RawKey);
+    CXPLAT_KEY* Key;
+    if (QUIC_FAILED(CxPlatKeyCreate((CXPLAT_AEAD_TYPE)State->Arg, RawKey, &Key))) {
+        State->Skipped = TRUE; // Cipher not supported by this TLS provider.
+        return;
+    }
+    uint8_t Iv[CXPLAT_IV_LENGTH] = {0};
+    uint8_t Header[32] = {0};
+    uint8_t Payload[PERF_BENCH_MAX_PACKET_LENGTH] = {0};
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        Iv[CXPLAT_IV_LENGTH - 1] = (uint8_t)i;
+        (void)CxPlatEncrypt(Key, Iv, sizeof(Header), Header, (uint16_t)State->Count, Payload);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchSink += Payload[0];
+    CxPlatKeyFree(Key);
+}
+
+void
+PerfBenchHpComputeMask(
+    _Inout_ PERF_BENCH_STATE* State
+    )
+{
+    uint8_t RawKey[32];
+    CxPlatRandom(sizeof(RawKey), RawKey);
+    CXPLAT_HP_KEY* Key;
+    if (QUIC_FAILED(CxPlatHpKeyCreate((CXPLAT_AEAD_TYPE)State->Arg, RawKey, &Key))) {
+        State->Skipped = TRUE;
+        return;
+    }
+    uint8_t Cipher[CXPLAT_HP_SAMPLE_LENGTH] = {0};
+    uint8_t Mask[CXPLAT_HP_SAMPLE_LENGTH];
+
+    PerfBenchStart(State);
+    for (uint64_t i = 0; i < State->Iterations; ++i) {
+        Cipher[0] = (uint8_t)i;
+        (void)CxPlatHpComputeMask(Key, 1, Cipher, Mask);
+    }
+    PerfBenchStop(State);
+
+    PerfBenchSink += Mask[0];
+    CxPlatHpKeyFree(Key);
+}
+
+const PERF_BENCHMARK PerfBenchmarks[] = {
+    { "range/add_value/in_order",             PerfBenchRangeAddValue,         1 },
+    { "range/add_value/gaps",                 PerfBenchRangeAddValue,         2 },
+    { "range/add_value/reordered_32",         PerfBenchRangeAddReordered,     32 },
+    { "range/search/16",                      PerfBenchRangeSearch,           16 },
+    { "range/search/1024",                    PerfBenchRangeSearch,           1024 },
+    { "hashtable/lookup/chained/10k",         PerfBenchHashtableLookup,       0, 10000 },
+    { "hashtable/lookup/open/10k",            PerfBenchHashtableLookup,       1, 10000 },
+    { "hashtable/lookup/chained/1m",          PerfBenchHashtableLookup,       0, 1000000 },
+    { "hashtable/lookup/open/1m",             PerfBenchHashtableLookup,       1, 1000000 },
+    { "hashtable/lookup/chained/10m",         PerfBenchHashtableLookup,       0, 10000000 },
+    { "hashtable/lookup/open/10m",            PerfBenchHashtableLookup,       1, 10000000 },
+    { "hashtable/insert_remove/chained/10k",  PerfBenchHashtableInsertRemove, 0, 10000 },
+    { "hashtable/insert_remove/open/10k",     PerfBenchHashtableInsertRemove, 1, 10000 },
+    { "hashtable/insert_remove/chained/1m",   PerfBenchHashtableInsertRemove, 0, 1000000 },
+    { "hashtable/insert_remove/open/1m",      PerfBenchHashtableInsertRemove, 1, 1000000 },
+    { "hashtable/insert_remove/chained/10m",  PerfBenchHashtableInsertRemove, 0, 10000000 },
+    { "hashtable/insert_remove/open/10m",     PerfBenchHashtableInsertRemove, 1, 10000000 },
+    { "toeplitz/ip",                          PerfBenchToeplitz,              CXPLAT_TOEPLITZ_INPUT_SIZE_IP },
+    { "toeplitz/quic",                        PerfBenchToeplitz,              CXPLAT_TOEPLITZ_INPUT_SIZE_QUIC },
+    { "varint/encode",                        PerfBenchVarIntEncode,          0 },
+    { "varint/decode",                        PerfBenchVarIntDecode,          0 },
+    { "ack_frame/encode/1",                   PerfBenchAckFrameEncode,        1 },
+    { "ack_frame/encode/32",                  PerfBenchAckFrameEncode,        32 },
+    { "ack_process/in_flight/1k",             PerfBenchAckProcess,            0, 1000 },
+    { "ack_process/in_flight/10k",            PerfBenchAckProcess,            0, 10000 },
+    { "ack_process/in_flight/50k",            PerfBenchAckProcess,            0, 50000 },
+    { "timer_wheel/update/sorted",            PerfBenchTimerWheelUpdate,      0 },
+    { "timer_wheel/update/hierarchical",      PerfBenchTimerWheelUpdate,      1 },
+    { "pool/alloc_free/1",                    PerfBenchPoolAllocFree,         1 },
+    { "pool/alloc_free/64",                   PerfBenchPoolAllocFree,         64 },
+    { "encrypt/aes128gcm/64",                 PerfBenchEncrypt,               CXPLAT_AEAD_AES_128_GCM, 64 },
+    { "encrypt/aes128gcm/1200",               PerfBenchEncrypt,               CXPLAT_AEAD_AES_128_GCM, 1200 },
+    { "encrypt/aes128gcm/1450",               PerfBenchEncrypt,               CXPLAT_AEAD_AES_128_GCM, 1450 },
+    { "encrypt/aes256gcm/64",                 PerfBenchEncrypt,               CXPLAT_AEAD_AES_256_GCM, 64 },
+    { "encrypt/aes256gcm/1200",               PerfBenchEncrypt,               CXPLAT_AEAD_AES_256_GCM, 1200 },
+    { "encrypt/aes256gcm/1450",               PerfBenchEncrypt,               CXPLAT_AEAD_AES_256_GCM, 1450 },
+    { "encrypt/chacha20poly1305/64",          PerfBenchEncrypt,               CXPLAT_AEAD_CHACHA20_POLY1305, 64 },
+    { "encrypt/chacha20poly1305/1200",        PerfBenchEncrypt,               CXPLAT_AEAD_CHACHA20_POLY1305, 1200 },
+    { "encrypt/chacha20poly1305/1450",        PerfBenchEncrypt,               CXPLAT_AEAD_CHACHA20_POLY1305, 1450 },
+    { "hp_mask/aes128",                       PerfBenchHpComputeMask,         CXPLAT_AEAD_AES_128_GCM },
+    { "hp_mask/aes256",                       PerfBenchHpComputeMask,         CXPLAT_AEAD_AES_256_GCM },
+    { "hp_mask/chacha20",                     PerfBenchHpComputeMask,         CXPLAT_AEAD_CHACHA20_POLY1305 },
+};
+
+//
+// Runs the benchmark with a growing iteration count until a run takes at
+// least MinTimeUs, and returns that run.
+//
+void
+PerfBenchRun(
+    _In_ const PERF_BENCHMARK* Benchmark,
+    _In_ uint64_t MinTimeUs,
+    _Out_ PERF_BENCH_STATE* State
+    )
+{
+    uint64_t Iterations = CXPLAT_MAX(Benchmark->Count, 1);
+    for (;;) {
+        CxPlatZeroMemory(State, sizeof(*State));
+        State->Iterations = Iterations;
+        State->Arg = Benchmark->Arg;
+        State->Count = Benchmark->Count;
+        Benchmark->Fn(State);
+        if (State->Skipped ||
+            State->ElapsedUs >= MinTimeUs ||
+            Iterations >= PERF_BENCH_MAX_ITERATIONS) {
+            return;
+        }
+
+        //
+        // Aim 20% past the minimum, growing at most 10x per step while the
+        // measurement is still too short to extrapolate from.
+        //
+        uint64_t Next = Iterations * 10;
+        if (State->ElapsedUs > MinTimeUs / 100) {
+            Next = CXPLAT_MIN(Next, Iterations * MinTimeUs * 6 / 5 / State->ElapsedUs);
+        }
+        Iterations = CXPLAT_MAX(Next, Iterations + 1);
+    }
+}
+
+//
+// The RFC 9000 variable-length integer decode, one byte at a time, as the
+// reference for the prefix-dispatched QuicVarIntDecode and its bulk variant.
+//
+BOOLEAN
+PerfCheckVarIntDecodeReference(
+    _In_ uint16_t BufferLength,
+    _In_reads_bytes_(BufferLength)
+        const uint8_t * const Buffer,
+    _Inout_ uint16_t* Offset,
+    _Out_ QUIC_VAR_INT* Value
+    )
+{
+    if (*Offset >= BufferLength) {
+        return FALSE;
+    }
+    const uint16_t Length = (uint16_t)(1u << (Buffer[*Offset] >> 6));
+    if (BufferLength - *Offset < Length) {
+        return FALSE;
+    }
+    *Value = Buffer[*Offset] & 0x3f;
+    for (uint16_t i = 1; i < Length; ++i) {
+        *Value = (*Value << 8) | Buffer[*Offset + i];
+    }
+    *Offset += Length;
+    return TRUE;
+}
+
+//
+// Compares QuicVarIntDecode and QuicVarIntDecodeArray against the reference
+// decode on random bytes at random offsets. Half the buffers end somewhere
+// inside the encoded values, so truncated input is covered for all four
+// encoded lengths, and for the bulk decode both with and without its bounds
+// check shortcut. Returns FALSE on the first mismatch.
+//
+BOOLEAN
+PerfCheckVarIntDecode(
+    void
+    )
+{
+    uint64_t Seed = 0x5eed;
+    uint8_t Buffer[64];
+    for (uint32_t i = 0; i < PERF_CHECK_VAR_INT_ROUNDS; ++i) {
+        for (uint32_t j = 0; j < sizeof(Buffer); j += sizeof(uint64_t)) {
+            const uint64_t Random = PerfBenchRandom(&Seed);
+            CxPlatCopyMemory(Buffer + j, &Random, sizeof(Random));
+        }
+        const uint64_t Random = PerfBenchRandom(&Seed);
+        const uint16_t Start = (uint16_t)(Random % 16);
+        const uint16_t Count = (uint16_t)(1 + (Random >> 8) % 4);
+
+        uint16_t EncodedLength = 0;
+        for (uint16_t j = 0; j < Count; ++j) {
+            EncodedLength += (uint16_t)(1u << (Buffer[Start + EncodedLength] >> 6));
+        }
+        const uint16_t BufferLength =
+            (Random & 0x10000) ?
+                (uint16_t)(Start + (Random >> 32) % (EncodedLength + 1u)) :
+                (uint16_t)(Start + EncodedLength + (Random >> 32) % 8);
+
+        //
+        // Single values.
+        //
+        uint16_t Offset = Start, RefOffset = Start;
+        QUIC_VAR_INT Value = 0, RefValue = 0;
+        BOOLEAN Result = QuicVarIntDecode(BufferLength, Buffer, &Offset, &Value);
+        BOOLEAN RefResult =
+            PerfCheckVarIntDecodeReference(BufferLength, Buffer, &RefOffset, &RefValue);
+        if (Result != RefResult || Offset != RefOffset || (Result && Value != RefValue)) {
+            printf(
+                "QuicVarIntDecode mismatch: first byte 0x%02x, offset %u, length %u\n",
+                Buffer[Start], Start, BufferLength);
+            return FALSE;
+        }
+
+        //
+        // Count values in bulk. Offset and the values are unspecified on
+        // failure, so only the result is compared then.
+        //
+        QUIC_VAR_INT Values[4], RefValues[4];
+        Offset = RefOffset = Start;
+        Result = QuicVarIntDecodeArray(BufferLength, Buffer, &Offset, Count, Values);
+        RefResult = TRUE;
+        for (uint16_t j = 0; j < Count && RefResult; ++j) {
+            RefResult =
+                PerfCheckVarIntDecodeReference(BufferLength, Buffer, &RefOffset, &RefValues[j]);
+        }
+        if (Result != RefResult ||
+            (Result &&
+             (Offset != RefOffset || memcmp(Values, RefValues, Count * sizeof(QUIC_VAR_INT)) != 0))) {
+            printf(
+                "QuicVarIntDecodeArray mismatch: %u values, offset %u, length %u\n",
+                Count, Start, BufferLength);
+            return FALSE;
+        }
+    }
+    printf("varint decode: %u random inputs match the reference\n", PERF_CHECK_VAR_INT_ROUNDS);
+    return TRUE;
+}
+
+//
+// Compares a range against a bitmap of the values it should hold.
+//
+BOOLEAN
+PerfCheckRangeMatches(
+    _In_ QUIC_RANGE* Range,
+    _In_reads_(PERF_CHECK_RANGE_VALUES) const BOOLEAN* Expected
+    )
+{
+    uint64_t Next = 0;
+    QUIC_SUBRANGE* Sub;
+    for (uint32_t i = 0; (Sub = QuicRangeGetSafe(Range, i)) != NULL; ++i) {
+        if (QuicRangeGetHigh(Sub) >= PERF_CHECK_RANGE_VALUES ||
+            (i != 0 && Sub->Low <= Next)) { // Must be sorted with gaps between.
+            return FALSE;
+        }
+        for (; Next < Sub->Low; ++Next) {
+            if (Expected[Next]) {
+                return FALSE;
+            }
+        }
+        for (; Next <= QuicRangeGetHigh(Sub); ++Next) {
+            if (!Expected[Next]) {
+                return FALSE;
+            }
+        }
+    }
+    for (; Next < PERF_CHECK_RANGE_VALUES; ++Next) {
+        if (Expected[Next]) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+//
+// Checks QUIC_RANGE against a bitmap under random adds, removes and SetMin
+// calls. Removing subranges from the front of a heap-allocated range leaves
+// free slots before SubRanges (HeadLength), so the range is also grown, then
+// drained from the front through its shrink path and uninitialized with
+// front slots outstanding. Run under ASan, a bad free on any of those paths
+// is caught too. Returns FALSE on the first mismatch.
+//
+BOOLEAN
+PerfCheckRange(
+    void
+    )
+{
+    uint64_t Seed = 0x5eed;
+    BOOLEAN Expected[PERF_CHECK_RANGE_VALUES];
+    QUIC_RANGE Range;
+    uint32_t Round;
+
+    for (Round = 0; Round < PERF_CHECK_RANGE_ROUNDS; ++Round) {
+        //
+        // Grow to Count disjoint subranges, then drop some from the front.
+        //
+        const uint32_t Count = 2 * QUIC_RANGE_INITIAL_SUB_COUNT + Round * 8;
+        QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range);
+        for (uint32_t i = 0; i < Count; ++i) {
+            if (!QuicRangeAddValue(&Range, 2ull * i)) {
+                QuicRangeUninitialize(&Range);
+                return FALSE;
+            }
+        }
+        if (Round & 1) {
+            while (QuicRangeSize(&Range) > 1) { // Through the shrink path.
+                (void)QuicRangeRemoveSubranges(&Range, 0, 1);
+            }
+        } else {
+            (void)QuicRangeRemoveSubranges(&Range, 0, 1 + Round % QUIC_RANGE_INITIAL_SUB_COUNT);
+        }
+        QuicRangeUninitialize(&Range);
+
+        //
+        // Random operations against the bitmap.
+        //
+        CxPlatZeroMemory(Expected, sizeof(Expected));
+        QuicRangeInitialize(QUIC_MAX_RANGE_ALLOC_SIZE, &Range);
+        uint64_t Min = 0;
+        for (uint32_t i = 0; i < PERF_CHECK_RANGE_OPS; ++i) {
+            const uint64_t Random = PerfBenchRandom(&Seed);
+            const uint64_t Value = (Random >> 8) % PERF_CHECK_RANGE_VALUES;
+            const uint64_t Length = 1 + (Random >> 24) % 16;
+            switch (Random % 8) {
+            default:
+                if (Value >= Min) {
+                    if (!QuicRangeAddValue(&Range, Value)) {
+                        goto Failed;
+                    }
+                    Expected[Value] = TRUE;
+                }
+                break;
+            case 5:
+            case 6:
+                if (!QuicRangeRemoveRange(&Range, Value, Length)) {
+                    goto Failed;
+                }
+                for (uint64_t j = Value; j < Value + Length && j < PERF_CHECK_RANGE_VALUES; ++j) {
+                    Expected[j] = FALSE;
+                }
+                break;
+            case 7:
+                if ((Random >> 40) % 64 == 0) { // Rarely, so the range can refill.
+                    Min = Value / 2;
+                    QuicRangeSetMin(&Range, Min);
+                    for (uint64_t j = 0; j < Min; ++j) {
+                        Expected[j] = FALSE;
+                    }
+                }
+                break;
+            }
+            if (!PerfCheckRangeMatches(&Range, Expected)) {
+                goto Failed;
+            }
+        }
+        QuicRangeUninitialize(&Range);
+    }
+
+    printf(
+        "range: %u random operations match the reference\n",
+        PERF_CHECK_RANGE_ROUNDS * PERF_CHECK_RANGE_OPS);
+    return TRUE;
+
+Failed:
+
+    printf("range mismatch in round %u\n", Round);
+    QuicRangeUninitialize(&Range);
+    return FALSE;
+}
+
+void
+PrintUsage(
+    void
+    )
+{
+    printf(
+        "Usage: quicmicrobench [-filter:<substring>] [-min_time:<ms>] [-format:<text|json>] [-list] [-check]\n");
+}
+
+_Null_terminated_ const char*
+GetValue(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_z_ const char* Name
+    )
+{
+    const size_t NameLength = strlen(Name);
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-' &&
+            strncmp(argv[i] + 1, Name, NameLength) == 0 &&
+            (argv[i][NameLength + 1] == ':' || argv[i][NameLength + 1] == '\0')) {
+            return argv[i][NameLength + 1] == ':' ? argv[i] + NameLength + 2 : "";
+        }
+    }
+    return NULL;
+}
+
+int
+QUIC_MAIN_EXPORT
+main(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    const char* Filter = GetValue(argc, argv, "filter");
+    const char* Value;
+    uint64_t MinTimeUs = MS_TO_US(PERF_BENCH_DEFAULT_MIN_TIME_MS);
+    BOOLEAN Json = FALSE;
+
+    if (GetValue(argc, argv, "help") || GetValue(argc, argv, "?")) {
+        PrintUsage();
+        return 0;
+    }
+    if (GetValue(argc, argv, "list")) {
+        for (uint32_t i = 0; i < ARRAYSIZE(PerfBenchmarks); ++i) {
+            printf("%s\n", PerfBenchmarks[i].Name);
+        }
+        return 0;
+    }
+    if ((Value = GetValue(argc, argv, "min_time")) != NULL) {
+        MinTimeUs = MS_TO_US(strtoull(Value, NULL, 10));
+    }
+    if ((Value = GetValue(argc, argv, "format")) != NULL) {
+        if (strcmp(Value, "json") == 0) {
+            Json = TRUE;
+        } else if (strcmp(Value, "text") != 0) {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    CxPlatSystemLoad();
+    if (QUIC_FAILED(CxPlatInitialize())) {
+        CxPlatSystemUnload();
+        return 1;
+    }
+
+    if (GetValue(argc, argv, "check")) {
+        const BOOLEAN Passed = PerfCheckVarIntDecode() && PerfCheckRange();
+        CxPlatUninitialize();
+        CxPlatSystemUnload();
+        return Passed ? 0 : 1;
+    }
+
+    if (!Json) {
+        printf("%-40s %14s %12s %14s\n", "Benchmark", "Iterations", "ns/op", "ops/sec");
+    }
+
+    for (uint32_t i = 0; i < ARRAYSIZE(PerfBenchmarks); ++i) {
+        const PERF_BENCHMARK* Benchmark = &PerfBenchmarks[i];
+        if (Filter != NULL && strstr(Benchmark->Name, Filter) == NULL) {
+            continue;
+        }
+
+        PERF_BENCH_STATE State;
+        PerfBenchRun(Benchmark, MinTimeUs, &State);
+        if (State.Skipped) {
+            if (Json) {
+                printf("{\"name\":\"%s\",\"skipped\":true}\n", Benchmark->Name);
+            } else {
+                printf("%-40s %14s\n", Benchmark->Name, "skipped");
+            }
+            continue;
+        }
+
+        const double NsPerOp = (double)State.ElapsedUs * 1000.0 / (double)State.Iterations;
+        const double OpsPerSec = NsPerOp > 0 ? 1e9 / NsPerOp : 0;
+        if (Json) {
+            printf(
+                "{\"name\":\"%s\",\"iterations\":%llu,\"elapsed_us\":%llu,"
+                "\"ns_per_op\":%.3f,\"ops_per_sec\":%.0f}\n",
+                Benchmark->Name,
+                (unsigned long long)State.Iterations,
+                (unsigned long long)State.ElapsedUs,
+                NsPerOp,
+                OpsPerSec);
+        } else {
+            printf("%-40s %14llu %12.2f %14.0f\n",
+                Benchmark->Name, (unsigned long long)State.Iterations, NsPerOp, OpsPerSec);
+        }
+        fflush(stdout);
+    }
+
+    CxPlatUninitialize();
+    CxPlatSystemUnload();
+    return 0;
+}
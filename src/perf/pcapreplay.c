@@ -0,0 +1,1786 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Replays captured QUIC traffic (pcap or pcapng) to measure the receive path
+    against real packet mixes.
+
+    The live phase injects the datagrams sent to the server port into a
+    listener on the in-memory datapath (CxPlatMemoryDataPathInject), at the
+    recorded timing or a multiple of it, so they go through QuicBindingReceive
+    and the rest of the receive path. The server's own keys and CIDs differ
+    from the captured server's, so after the client's first Initial packets
+    the replayed packets exercise demultiplexing and the drop paths rather than
+    connection processing. The CPU spent is reported by worker activity, from
+    QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT, next to the process CPU time.
+
+    The crypto phase removes header protection from, and decrypts, the client's
+    packets offline with the captured keys: Initial keys are derived from the
+    client's destination CID, and the other keys come from an NSS key log file
+    of the captured connections (as written from QUIC_PARAM_CONN_TLS_SECRETS).
+    Each step is timed over the whole packet mix.
+
+    Short header packets are matched to connections by the client's address,
+    and their destination CID length is learned from the server's long header
+    packets in the capture (or given with -cid_len).
+
+Environment:
+
+    Linux, built with QUIC_LINUX_MEMORY_DATAPATH.
+
+--*/
+
+#include "precomp.h"
+
+#include <stdio.h>
+#include <sys/resource.h>
+
+#define REPLAY_DEFAULT_ITERATIONS       10
+#define REPLAY_DEFAULT_DRAIN_MS         1000
+#define REPLAY_MAX_INTERFACES           64
+#define REPLAY_CLIENT_RANDOM_LENGTH     32
+
+//
+// Link types of the captured frames.
+//
+#define REPLAY_LINKTYPE_NULL            0
+#define REPLAY_LINKTYPE_ETHERNET        1
+#define REPLAY_LINKTYPE_RAW             101
+#define REPLAY_LINKTYPE_LOOP            108
+#define REPLAY_LINKTYPE_LINUX_SLL       113
+#define REPLAY_LINKTYPE_IPV4            228
+#define REPLAY_LINKTYPE_IPV6            229
+#define REPLAY_LINKTYPE_LINUX_SLL2      276
+
+//
+// A captured UDP datagram. The payload points into the capture file.
+//
+typedef struct REPLAY_DATAGRAM {
+
+    uint64_t TimeUs;
+    QUIC_ADDR Source;
+    QUIC_ADDR Destination;
+    const uint8_t* Buffer;
+    uint16_t Length;
+
+} REPLAY_DATAGRAM;
+
+typedef enum REPLAY_SECRET_TYPE {
+    REPLAY_SECRET_EARLY,
+    REPLAY_SECRET_HANDSHAKE,
+    REPLAY_SECRET_1_RTT,
+    REPLAY_SECRET_COUNT
+} REPLAY_SECRET_TYPE;
+
+static const char* const ReplaySecretLabels[REPLAY_SECRET_COUNT] = {
+    "CLIENT_EARLY_TRAFFIC_SECRET",
+    "CLIENT_HANDSHAKE_TRAFFIC_SECRET",
+    "CLIENT_TRAFFIC_SECRET_0"
+};
+
+//
+// A client traffic secret from the key log.
+//
+typedef struct REPLAY_SECRET {
+
+    uint8_t ClientRandom[REPLAY_CLIENT_RANDOM_LENGTH];
+    REPLAY_SECRET_TYPE Type;
+    uint8_t Length;
+    uint8_t Secret[CXPLAT_HASH_MAX_SIZE];
+
+} REPLAY_SECRET;
+
+//
+// The packet types reported by the crypto phase, and the keys a connection
+// can decrypt them with.
+//
+typedef enum REPLAY_PACKET_TYPE {
+    REPLAY_PACKET_INITIAL,
+    REPLAY_PACKET_0_RTT,
+    REPLAY_PACKET_HANDSHAKE,
+    REPLAY_PACKET_1_RTT,
+    REPLAY_PACKET_TYPE_COUNT
+} REPLAY_PACKET_TYPE;
+
+static const char* const ReplayPacketTypeNames[REPLAY_PACKET_TYPE_COUNT] = {
+    "initial", "0rtt", "handshake", "1rtt"
+};
+
+//
+// A captured client connection, for the crypto phase.
+//
+typedef struct REPLAY_CONNECTION {
+
+    QUIC_ADDR Client;
+    const QUIC_VERSION_INFO* Version;
+
+    //
+    // The length of the server's CIDs, or UINT8_MAX if not known yet.
+    //
+    uint8_t ServerCidLength;
+
+    BOOLEAN GotClientRandom;
+    uint8_t ClientRandom[REPLAY_CLIENT_RANDOM_LENGTH];
+
+    //
+    // The AEAD the key log secrets are used with. Only the secret length is
+    // logged, so 32 byte secrets are tried with AES-128-GCM first.
+    //
+    CXPLAT_AEAD_TYPE Aead;
+    BOOLEAN AeadConfirmed;
+
+    //
+    // The current keys by packet type, and the key for the next 1-RTT key
+    // phase. Keys are owned by the replay's key list, since the packets
+    // recorded for the timed passes keep using them.
+    //
+    QUIC_PACKET_KEY* Keys[REPLAY_PACKET_TYPE_COUNT];
+    QUIC_PACKET_KEY* NextOneRttKey;
+    CXPLAT_HP_KEY* OneRttHeaderKey;
+    uint8_t KeyPhase;
+
+    //
+    // The packet number expected next, in each packet number space.
+    //
+    uint64_t NextPacketNumber[3];
+
+} REPLAY_CONNECTION;
+
+//
+// A client packet the crypto phase could decrypt, prepared for the timed
+// passes.
+//
+typedef struct REPLAY_CRYPTO_PACKET {
+
+    CXPLAT_KEY* Key;
+    CXPLAT_HP_KEY* HeaderKey;
+
+    //
+    // The packet as captured, and a copy with header protection removed.
+    //
+    const uint8_t* Protected;
+    uint8_t* Unprotected;
+
+    uint8_t Nonce[CXPLAT_IV_LENGTH];
+    uint16_t SampleOffset;
+    uint16_t HeaderLength;
+    uint16_t PacketLength;
+    REPLAY_PACKET_TYPE Type;
+
+} REPLAY_CRYPTO_PACKET;
+
+typedef struct REPLAY {
+
+    //
+    // Options.
+    //
+    uint16_t ServerPort;
+    uint8_t ServerCidLength;
+    double Speed;
+    uint32_t Iterations;
+    uint32_t DrainMs;
+    const char* Alpn;
+    BOOLEAN Json;
+
+    //
+    // The capture.
+    //
+    uint8_t* File;
+    size_t FileLength;
+    REPLAY_DATAGRAM* Datagrams;
+    uint32_t DatagramCount;
+    uint32_t DatagramAlloc;
+    uint32_t SkippedFrames;
+
+    //
+    // The key log.
+    //
+    REPLAY_SECRET* Secrets;
+    uint32_t SecretCount;
+    uint32_t SecretAlloc;
+
+    //
+    // Crypto phase state.
+    //
+    REPLAY_CONNECTION* Connections;
+    uint32_t ConnectionCount;
+    uint32_t ConnectionAlloc;
+    QUIC_PACKET_KEY** Keys;
+    uint32_t KeyCount;
+    uint32_t KeyAlloc;
+    REPLAY_CRYPTO_PACKET* Packets;
+    uint32_t PacketCount;
+    uint32_t PacketAlloc;
+    uint32_t PacketTypeCounts[REPLAY_PACKET_TYPE_COUNT];
+    uint32_t NoKeyCount;
+    uint32_t DecryptFailCount;
+    uint32_t UnparsedCount;
+
+} REPLAY;
+
+//
+// Results are folded into this, so the compiler can't drop the timed work.
+//
+volatile uint64_t ReplaySink;
+
+//
+// Makes room for one more element in a growable array.
+//
+BOOLEAN
+ReplayGrow(
+    _Inout_ void** Array,
+    _Inout_ uint32_t* Alloc,
+    _In_ uint32_t Count,
+    _In_ size_t ElementSize
+    )
+{
+    if (Count < *Alloc) {
+        return TRUE;
+    }
+    const uint32_t NewAlloc = *Alloc == 0 ? 64 : 2 * *Alloc;
+    void* NewArray = realloc(*Array, NewAlloc * ElementSize);
+    if (NewArray == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return FALSE;
+    }
+    *Array = NewArray;
+    *Alloc = NewAlloc;
+    return TRUE;
+}
+
+QUIC_INLINE
+uint16_t
+ReplayRead16(
+    _In_reads_(2) const uint8_t* Buffer,
+    _In_ BOOLEAN BigEndian
+    )
+{
+    return BigEndian ?
+        (uint16_t)((Buffer[0] << 8) | Buffer[1]) :
+        (uint16_t)((Buffer[1] << 8) | Buffer[0]);
+}
+
+QUIC_INLINE
+uint32_t
+ReplayRead32(
+    _In_reads_(4) const uint8_t* Buffer,
+    _In_ BOOLEAN BigEndian
+    )
+{
+    return BigEndian ?
+        ((uint32_t)Buffer[0] << 24) | ((uint32_t)Buffer[1] << 16) |
+        ((uint32_t)Buffer[2] << 8) | Buffer[3] :
+        ((uint32_t)Buffer[3] << 24) | ((uint32_t)Buffer[2] << 16) |
+        ((uint32_t)Buffer[1] << 8) | Buffer[0];
+}
+
+//
+// Capture parsing
+//
+
+//
+// Adds the UDP datagram in an IPv4 or IPv6 packet. Fragments and other
+// protocols are skipped.
+//
+BOOLEAN
+ReplayAddIpPacket(
+    _Inout_ REPLAY* Replay,
+    _In_ uint64_t TimeUs,
+    _In_reads_(Length) const uint8_t* Packet,
+    _In_ uint32_t Length
+    )
+{
+    QUIC_ADDR Source = {0}, Destination = {0};
+    uint32_t Offset;
+
+    if (Length < 1) {
+        goto Skip;
+    }
+
+    if ((Packet[0] >> 4) == 4) {
+        const uint32_t HeaderLength = (Packet[0] & 0xF) * 4u;
+        if (Length < 20 || HeaderLength < 20 || Length < HeaderLength ||
+            Packet[9] != 17 || // UDP
+            (ReplayRead16(Packet + 6, TRUE) & 0x3FFF) != 0) { // Fragment
+            goto Skip;
+        }
+        const uint32_t TotalLength = ReplayRead16(Packet + 2, TRUE);
+        if (TotalLength >= HeaderLength && TotalLength < Length) {
+            Length = TotalLength; // Ignore link padding.
+        }
+        QuicAddrSetFamily(&Source, QUIC_ADDRESS_FAMILY_INET);
+        QuicAddrSetFamily(&Destination, QUIC_ADDRESS_FAMILY_INET);
+        CxPlatCopyMemory(&Source.Ipv4.sin_addr, Packet + 12, 4);
+        CxPlatCopyMemory(&Destination.Ipv4.sin_addr, Packet + 16, 4);
+        Offset = HeaderLength;
+
+    } else if ((Packet[0] >> 4) == 6) {
+        if (Length < 40) {
+            goto Skip;
+        }
+        const uint32_t TotalLength = 40u + ReplayRead16(Packet + 4, TRUE);
+        if (TotalLength < Length) {
+            Length = TotalLength;
+        }
+        uint8_t NextHeader = Packet[6];
+        Offset = 40;
+        while (NextHeader == 0 || NextHeader == 43 || NextHeader == 60) {
+            //
+            // Hop-by-hop, routing and destination options headers.
+            //
+            if (Offset + 8 > Length) {
+                goto Skip;
+            }
+            NextHeader = Packet[Offset];
+            Offset += (Packet[Offset + 1] + 1u) * 8;
+        }
+        if (NextHeader != 17 || Offset > Length) {
+            goto Skip;
+        }
+        QuicAddrSetFamily(&Source, QUIC_ADDRESS_FAMILY_INET6);
+        QuicAddrSetFamily(&Destination, QUIC_ADDRESS_FAMILY_INET6);
+        CxPlatCopyMemory(&Source.Ipv6.sin6_addr, Packet + 8, 16);
+        CxPlatCopyMemory(&Destination.Ipv6.sin6_addr, Packet + 24, 16);
+
+    } else {
+        goto Skip;
+    }
+
+    if (Offset + 8 > Length) {
+        goto Skip;
+    }
+    const uint8_t* Udp = Packet + Offset;
+    uint32_t PayloadLength = Length - Offset - 8;
+    const uint32_t UdpLength = ReplayRead16(Udp + 4, TRUE);
+    if (UdpLength >= 8 && UdpLength - 8 < PayloadLength) {
+        PayloadLength = UdpLength - 8;
+    }
+    if (PayloadLength == 0 || PayloadLength > UINT16_MAX) {
+        goto Skip;
+    }
+    QuicAddrSetPort(&Source, ReplayRead16(Udp, TRUE));
+    QuicAddrSetPort(&Destination, ReplayRead16(Udp + 2, TRUE));
+
+    if (!ReplayGrow(
+            (void**)&Replay->Datagrams,
+            &Replay->DatagramAlloc,
+            Replay->DatagramCount,
+            sizeof(REPLAY_DATAGRAM))) {
+        return FALSE;
+    }
+    REPLAY_DATAGRAM* Datagram = &Replay->Datagrams[Replay->DatagramCount++];
+    Datagram->TimeUs = TimeUs;
+    Datagram->Source = Source;
+    Datagram->Destination = Destination;
+    Datagram->Buffer = Udp + 8;
+    Datagram->Length = (uint16_t)PayloadLength;
+    return TRUE;
+
+Skip:
+
+    Replay->SkippedFrames++;
+    return TRUE;
+}
+
+//
+// Strips the link layer header from a captured frame.
+//
+BOOLEAN
+ReplayAddFrame(
+    _Inout_ REPLAY* Replay,
+    _In_ uint32_t LinkType,
+    _In_ uint64_t TimeUs,
+    _In_reads_(Length) const uint8_t* Frame,
+    _In_ uint32_t Length
+    )
+{
+    uint32_t Offset;
+    switch (LinkType) {
+    case REPLAY_LINKTYPE_NULL:
+    case REPLAY_LINKTYPE_LOOP:
+        //
+        // The address family is in the capturing host's byte order; the IP
+        // version is enough.
+        //
+        Offset = 4;
+        break;
+    case REPLAY_LINKTYPE_ETHERNET: {
+        Offset = 12;
+        uint16_t EtherType = 0;
+        while (Offset + 2 <= Length) {
+            EtherType = ReplayRead16(Frame + Offset, TRUE);
+            if (EtherType != 0x8100 && EtherType != 0x88A8) { // VLAN tags
+                break;
+            }
+            Offset += 4;
+        }
+        if (EtherType != 0x0800 && EtherType != 0x86DD) {
+            Replay->SkippedFrames++;
+            return TRUE;
+        }
+        Offset += 2;
+        break;
+    }
+    case REPLAY_LINKTYPE_RAW:
+    case REPLAY_LINKTYPE_IPV4:
+    case REPLAY_LINKTYPE_IPV6:
+        Offset = 0;
+        break;
+    case REPLAY_LINKTYPE_LINUX_SLL:
+        Offset = 16;
+        break;
+    case REPLAY_LINKTYPE_LINUX_SLL2:
+        Offset = 20;
+        break;
+    default:
+        Replay->SkippedFrames++;
+        return TRUE;
+    }
+
+    if (Offset >= Length) {
+        Replay->SkippedFrames++;
+        return TRUE;
+    }
+    return ReplayAddIpPacket(Replay, TimeUs, Frame + Offset, Length - Offset);
+}
+
+BOOLEAN
+ReplayParsePcap(
+    _Inout_ REPLAY* Replay
+    )
+{
+    const uint8_t* File = Replay->File;
+    const size_t Length = Replay->FileLength;
+    if (Length < 24) {
+        return FALSE;
+    }
+
+    BOOLEAN BigEndian;
+    BOOLEAN Nanoseconds;
+    const uint32_t Magic = ReplayRead32(File, FALSE);
+    if (Magic == 0xA1B2C3D4 || Magic == 0xA1B23C4D) {
+        BigEndian = FALSE;
+    } else if (Magic == 0xD4C3B2A1 || Magic == 0x4D3CB2A1) {
+        BigEndian = TRUE;
+    } else {
+        return FALSE;
+    }
+    Nanoseconds = ReplayRead32(File, BigEndian) == 0xA1B23C4D;
+    const uint32_t LinkType = ReplayRead32(File + 20, BigEndian) & 0xFFFF;
+
+    size_t Offset = 24;
+    while (Offset + 16 <= Length) {
+        const uint64_t Seconds = ReplayRead32(File + Offset, BigEndian);
+        const uint64_t Fraction = ReplayRead32(File + Offset + 4, BigEndian);
+        const uint32_t CapturedLength = ReplayRead32(File + Offset + 8, BigEndian);
+        Offset += 16;
+        if (CapturedLength > Length - Offset) {
+            break; // Truncated capture.
+        }
+        const uint64_t TimeUs =
+            S_TO_US(Seconds) + (Nanoseconds ? Fraction / 1000 : Fraction);
+        if (!ReplayAddFrame(Replay, LinkType, TimeUs, File + Offset, CapturedLength)) {
+            return FALSE;
+        }
+        Offset += CapturedLength;
+    }
+    return TRUE;
+}
+
+BOOLEAN
+ReplayParsePcapng(
+    _Inout_ REPLAY* Replay
+    )
+{
+    struct {
+        uint32_t LinkType;
+        uint64_t UnitsPerSecond;
+    } Interfaces[REPLAY_MAX_INTERFACES];
+    uint32_t InterfaceCount = 0;
+    BOOLEAN BigEndian = FALSE;
+
+    const uint8_t* File = Replay->File;
+    const size_t Length = Replay->FileLength;
+    size_t Offset = 0;
+    while (Offset + 12 <= Length) {
+        const uint8_t* Block = File + Offset;
+        if (ReplayRead32(Block, FALSE) == 0x0A0D0D0A) {
+            //
+            // A section header block starts a new section, with its own byte
+            // order and interfaces.
+            //
+            if (Offset + 12 > Length) {
+                break;
+            }
+            const uint32_t ByteOrderMagic = ReplayRead32(Block + 8, FALSE);
+            if (ByteOrderMagic == 0x1A2B3C4D) {
+                BigEndian = FALSE;
+            } else if (ByteOrderMagic == 0x4D3C2B1A) {
+                BigEndian = TRUE;
+            } else {
+                return FALSE;
+            }
+            InterfaceCount = 0;
+        }
+
+        const uint32_t Type = ReplayRead32(Block, BigEndian);
+        const uint32_t BlockLength = ReplayRead32(Block + 4, BigEndian);
+        if (BlockLength < 12 || (BlockLength & 3) != 0 || BlockLength > Length - Offset) {
+            break; // Truncated or corrupt capture.
+        }
+        const uint8_t* Body = Block + 8;
+        const uint32_t BodyLength = BlockLength - 12;
+
+        if (Type == 1 && BodyLength >= 8) { // Interface description block
+            if (InterfaceCount == REPLAY_MAX_INTERFACES) {
+                return FALSE;
+            }
+            Interfaces[InterfaceCount].LinkType = ReplayRead16(Body, BigEndian);
+            Interfaces[InterfaceCount].UnitsPerSecond = 1000000;
+            uint32_t OptionOffset = 8;
+            while (OptionOffset + 4 <= BodyLength) {
+                const uint16_t Code = ReplayRead16(Body + OptionOffset, BigEndian);
+                const uint16_t OptionLength = ReplayRead16(Body + OptionOffset + 2, BigEndian);
+                if (Code == 0 || OptionOffset + 4 + OptionLength > BodyLength) {
+                    break;
+                }
+                if (Code == 9 && OptionLength >= 1) { // if_tsresol
+                    const uint8_t Resolution = Body[OptionOffset + 4];
+                    const uint8_t Exponent = Resolution & 0x7F;
+                    if (Exponent < 63) {
+                        uint64_t Units = 1;
+                        for (uint8_t i = 0; i < Exponent; ++i) {
+                            Units *= (Resolution & 0x80) ? 2 : 10;
+                            if (Units > 1000000000000000000ull) {
+                                break;
+                            }
+                        }
+                        Interfaces[InterfaceCount].UnitsPerSecond = Units;
+                    }
+                }
+                OptionOffset += 4 + ((OptionLength + 3u) & ~3u);
+            }
+            InterfaceCount++;
+
+        } else if (Type == 6 && BodyLength >= 20) { // Enhanced packet block
+            const uint32_t InterfaceId = ReplayRead32(Body, BigEndian);
+            const uint64_t Timestamp =
+                ((uint64_t)ReplayRead32(Body + 4, BigEndian) << 32) |
+                ReplayRead32(Body + 8, BigEndian);
+            const uint32_t CapturedLength = ReplayRead32(Body + 12, BigEndian);
+            if (InterfaceId < InterfaceCount && CapturedLength <= BodyLength - 20) {
+                const uint64_t Units = Interfaces[InterfaceId].UnitsPerSecond;
+                const uint64_t TimeUs =
+                    S_TO_US(Timestamp / Units) + (Timestamp % Units) * 1000000 / Units;
+                if (!ReplayAddFrame(
+                        Replay,
+                        Interfaces[InterfaceId].LinkType,
+                        TimeUs,
+                        Body + 20,
+                        CapturedLength)) {
+                    return FALSE;
+                }
+            } else {
+                Replay->SkippedFrames++;
+            }
+
+        } else if (Type == 3 && BodyLength >= 4) { // Simple packet block
+            //
+            // No timestamp; it is replayed with the previous datagram.
+            //
+            uint32_t CapturedLength = ReplayRead32(Body, BigEndian);
+            if (CapturedLength > BodyLength - 4) {
+                CapturedLength = BodyLength - 4;
+            }
+            const uint64_t TimeUs =
+                Replay->DatagramCount == 0 ?
+                    0 : Replay->Datagrams[Replay->DatagramCount - 1].TimeUs;
+            if (InterfaceCount != 0) {
+                if (!ReplayAddFrame(
+                        Replay, Interfaces[0].LinkType, TimeUs, Body + 4, CapturedLength)) {
+                    return FALSE;
+                }
+            } else {
+                Replay->SkippedFrames++;
+            }
+        }
+
+        Offset += BlockLength;
+    }
+    return TRUE;
+}
+
+BOOLEAN
+ReplayReadFile(
+    _In_z_ const char* Path,
+    _Out_ uint8_t** Buffer,
+    _Out_ size_t* Length
+    )
+{
+    *Buffer = NULL;
+    *Length = 0;
+
+    FILE* File = fopen(Path, "rb");
+    if (File == NULL) {
+        fprintf(stderr, "Failed to open %s\n", Path);
+        return FALSE;
+    }
+
+    size_t AllocLength = 0;
+    for (;;) {
+        if (*Length == AllocLength) {
+            AllocLength = AllocLength == 0 ? 64 * 1024 : 2 * AllocLength;
+            uint8_t* NewBuffer = (uint8_t*)realloc(*Buffer, AllocLength + 1);
+            if (NewBuffer == NULL) {
+                fprintf(stderr, "Out of memory\n");
+                free(*Buffer);
+                *Buffer = NULL;
+                fclose(File);
+                return FALSE;
+            }
+            *Buffer = NewBuffer;
+        }
+        const size_t Read = fread(*Buffer + *Length, 1, AllocLength - *Length, File);
+        if (Read == 0) {
+            break;
+        }
+        *Length += Read;
+    }
+    (*Buffer)[*Length] = '\0'; // So text files can be parsed as a string.
+    fclose(File);
+    return TRUE;
+}
+
+//
+// Key log parsing
+//
+
+BOOLEAN
+ReplayDecodeHex(
+    _In_reads_(Length * 2) const char* Hex,
+    _In_ uint32_t Length,
+    _Out_writes_(Length) uint8_t* Output
+    )
+{
+    for (uint32_t i = 0; i < Length * 2; ++i) {
+        const char c = Hex[i];
+        uint8_t Nibble;
+        if (c >= '0' && c <= '9') {
+            Nibble = (uint8_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            Nibble = (uint8_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            Nibble = (uint8_t)(c - 'A' + 10);
+        } else {
+            return FALSE;
+        }
+        if (i & 1) {
+            Output[i / 2] |= Nibble;
+        } else {
+            Output[i / 2] = (uint8_t)(Nibble << 4);
+        }
+    }
+    return TRUE;
+}
+
+//
+// Reads the client traffic secrets from an NSS key log file. Other lines
+// are ignored.
+//
+BOOLEAN
+ReplayLoadKeyLog(
+    _Inout_ REPLAY* Replay,
+    _In_z_ const char* Path
+    )
+{
+    uint8_t* Text;
+    size_t Length;
+    if (!ReplayReadFile(Path, &Text, &Length)) {
+        return FALSE;
+    }
+
+    char* Line = (char*)Text;
+    while (Line != NULL && *Line != '\0') {
+        char* Next = strchr(Line, '\n');
+        if (Next != NULL) {
+            *Next++ = '\0';
+        }
+
+        for (uint32_t Type = 0; Type < REPLAY_SECRET_COUNT; ++Type) {
+            const size_t LabelLength = strlen(ReplaySecretLabels[Type]);
+            if (strncmp(Line, ReplaySecretLabels[Type], LabelLength) != 0 ||
+                Line[LabelLength] != ' ') {
+                continue;
+            }
+            const char* Random = Line + LabelLength + 1;
+            const char* Secret = Random + 2 * REPLAY_CLIENT_RANDOM_LENGTH + 1;
+            if (strlen(Random) < 2 * REPLAY_CLIENT_RANDOM_LENGTH + 1) {
+                break;
+            }
+            size_t SecretHexLength = strcspn(Secret, " \r");
+            if ((SecretHexLength != 64 && SecretHexLength != 96) ||
+                !ReplayGrow(
+                    (void**)&Replay->Secrets,
+                    &Replay->SecretAlloc,
+                    Replay->SecretCount,
+                    sizeof(REPLAY_SECRET))) {
+                break;
+            }
+            REPLAY_SECRET* Entry = &Replay->Secrets[Replay->SecretCount];
+            Entry->Type = (REPLAY_SECRET_TYPE)Type;
+            Entry->Length = (uint8_t)(SecretHexLength / 2);
+            if (ReplayDecodeHex(Random, REPLAY_CLIENT_RANDOM_LENGTH, Entry->ClientRandom) &&
+                ReplayDecodeHex(Secret, Entry->Length, Entry->Secret)) {
+                Replay->SecretCount++;
+            }
+            break;
+        }
+
+        Line = Next;
+    }
+
+    free(Text);
+    return TRUE;
+}
+
+//
+// Crypto phase
+//
+
+BOOLEAN
+ReplayTrackKey(
+    _Inout_ REPLAY* Replay,
+    _In_ QUIC_PACKET_KEY* Key
+    )
+{
+    if (!ReplayGrow(
+            (void**)&Replay->Keys, &Replay->KeyAlloc, Replay->KeyCount, sizeof(QUIC_PACKET_KEY*))) {
+        QuicPacketKeyFree(Key);
+        return FALSE;
+    }
+    Replay->Keys[Replay->KeyCount++] = Key;
+    return TRUE;
+}
+
+_Ret_maybenull_
+REPLAY_CONNECTION*
+ReplayFindConnection(
+    _In_ REPLAY* Replay,
+    _In_ const QUIC_ADDR* Client
+    )
+{
+    for (uint32_t i = 0; i < Replay->ConnectionCount; ++i) {
+        if (QuicAddrCompare(&Replay->Connections[i].Client, Client)) {
+            return &Replay->Connections[i];
+        }
+    }
+    return NULL;
+}
+
+//
+// Derives the 0-RTT, handshake and 1-RTT keys from the key log, once the
+// client random of the connection is known.
+//
+void
+ReplayDeriveKeys(
+    _Inout_ REPLAY* Replay,
+    _Inout_ REPLAY_CONNECTION* Connection
+    )
+{
+    static const REPLAY_PACKET_TYPE PacketTypes[REPLAY_SECRET_COUNT] = {
+        REPLAY_PACKET_0_RTT, REPLAY_PACKET_HANDSHAKE, REPLAY_PACKET_1_RTT
+    };
+    static const QUIC_PACKET_KEY_TYPE KeyTypes[REPLAY_SECRET_COUNT] = {
+        QUIC_PACKET_KEY_0_RTT, QUIC_PACKET_KEY_HANDSHAKE, QUIC_PACKET_KEY_1_RTT
+    };
+
+    for (uint32_t i = 0; i < Replay->SecretCount; ++i) {
+        const REPLAY_SECRET* Entry = &Replay->Secrets[i];
+        if (memcmp(Entry->ClientRandom, Connection->ClientRandom, REPLAY_CLIENT_RANDOM_LENGTH) != 0) {
+            continue;
+        }
+
+        CXPLAT_SECRET Secret;
+        CxPlatZeroMemory(&Secret, sizeof(Secret));
+        if (Entry->Length == 48) {
+            Secret.Hash = CXPLAT_HASH_SHA384;
+            Secret.Aead = CXPLAT_AEAD_AES_256_GCM;
+        } else {
+            Secret.Hash = CXPLAT_HASH_SHA256;
+            Secret.Aead = Connection->Aead;
+        }
+        CxPlatCopyMemory(Secret.Secret, Entry->Secret, Entry->Length);
+
+        QUIC_PACKET_KEY* Key;
+        if (QUIC_FAILED(
+                QuicPacketKeyDerive(
+                    KeyTypes[Entry->Type],
+                    &Connection->Version->HkdfLabels,
+                    &Secret,
+                    ReplaySecretLabels[Entry->Type],
+                    TRUE,
+                    &Key)) ||
+            !ReplayTrackKey(Replay, Key)) {
+            continue;
+        }
+        Connection->Keys[PacketTypes[Entry->Type]] = Key;
+        if (Entry->Type == REPLAY_SECRET_1_RTT) {
+            Connection->OneRttHeaderKey = Key->HeaderKey;
+            Connection->NextOneRttKey = NULL;
+            Connection->KeyPhase = 0;
+        }
+    }
+}
+
+//
+// Finds the client random in the ClientHello of a decrypted Initial payload.
+//
+BOOLEAN
+ReplayFindClientRandom(
+    _In_reads_(Length) const uint8_t* Payload,
+    _In_ uint16_t Length,
+    _Out_writes_(REPLAY_CLIENT_RANDOM_LENGTH) uint8_t* ClientRandom
+    )
+{
+    uint16_t Offset = 0;
+    while (Offset < Length) {
+        QUIC_VAR_INT FrameType;
+        if (!QuicVarIntDecode(Length, Payload, &Offset, &FrameType)) {
+            return FALSE;
+        }
+        if (FrameType == QUIC_FRAME_PADDING || FrameType == QUIC_FRAME_PING) {
+            continue;
+        }
+        if (FrameType == QUIC_FRAME_ACK || FrameType == QUIC_FRAME_ACK_1) {
+            QUIC_VAR_INT Value, RangeCount;
+            if (!QuicVarIntDecode(Length, Payload, &Offset, &Value) ||
+                !QuicVarIntDecode(Length, Payload, &Offset, &Value) ||
+                !QuicVarIntDecode(Length, Payload, &Offset, &RangeCount) ||
+                !QuicVarIntDecode(Length, Payload, &Offset, &Value)) {
+                return FALSE;
+            }
+            uint64_t Count = 2 * RangeCount + (FrameType == QUIC_FRAME_ACK_1 ? 3 : 0);
+            while (Count-- > 0) {
+                if (!QuicVarIntDecode(Length, Payload, &Offset, &Value)) {
+                    return FALSE;
+                }
+            }
+            continue;
+        }
+        if (FrameType != QUIC_FRAME_CRYPTO) {
+            return FALSE;
+        }
+
+        QUIC_VAR_INT CryptoOffset, CryptoLength;
+        if (!QuicVarIntDecode(Length, Payload, &Offset, &CryptoOffset) ||
+            !QuicVarIntDecode(Length, Payload, &Offset, &CryptoLength) ||
+            CryptoLength > (uint64_t)(Length - Offset)) {
+            return FALSE;
+        }
+        //
+        // Handshake type (1), length (3), legacy version (2), random (32).
+        //
+        if (CryptoOffset == 0 &&
+            CryptoLength >= 6 + REPLAY_CLIENT_RANDOM_LENGTH &&
+            Payload[Offset] == 1) { // ClientHello
+            CxPlatCopyMemory(ClientRandom, Payload + Offset + 6, REPLAY_CLIENT_RANDOM_LENGTH);
+            return TRUE;
+        }
+        Offset += (uint16_t)CryptoLength;
+    }
+    return FALSE;
+}
+
+//
+// Learns the server's CID length from its long header packets.
+//
+void
+ReplayProcessServerDatagram(
+    _Inout_ REPLAY* Replay,
+    _In_ const REPLAY_DATAGRAM* Datagram
+    )
+{
+    const uint8_t* Packet = Datagram->Buffer;
+    if (Datagram->Length < 7 || !(Packet[0] & 0x80) || ReplayRead32(Packet + 1, TRUE) == 0) {
+        return;
+    }
+    const uint8_t DestCidLength = Packet[5];
+    if (6u + DestCidLength >= Datagram->Length) {
+        return;
+    }
+    REPLAY_CONNECTION* Connection = ReplayFindConnection(Replay, &Datagram->Destination);
+    if (Connection != NULL && Connection->ServerCidLength == UINT8_MAX) {
+        Connection->ServerCidLength = Packet[6 + DestCidLength];
+    }
+}
+
+//
+// Removes the header protection of, and decrypts, one packet. Returns TRUE if
+// it worked, with the plaintext in Scratch.
+//
+BOOLEAN
+ReplayDecryptPacket(
+    _In_ const REPLAY_CONNECTION* Connection,
+    _In_ const QUIC_PACKET_KEY* Key,
+    _In_ CXPLAT_HP_KEY* HeaderKey,
+    _In_reads_(PacketLength) const uint8_t* Packet,
+    _In_ uint16_t PacketLength,
+    _In_ uint16_t PacketNumberOffset,
+    _In_ uint32_t Space,
+    _Inout_ REPLAY_CRYPTO_PACKET* Result,
+    _Out_writes_(PacketLength) uint8_t* Scratch,
+    _Out_ uint64_t* PacketNumber
+    )
+{
+    uint8_t Mask[CXPLAT_HP_SAMPLE_LENGTH];
+    Result->SampleOffset = PacketNumberOffset + 4;
+    if (QUIC_FAILED(CxPlatHpComputeMask(HeaderKey, 1, Packet + Result->SampleOffset, Mask))) {
+        return FALSE;
+    }
+
+    CxPlatCopyMemory(Result->Unprotected, Packet, PacketLength);
+    Result->Unprotected[0] ^= Mask[0] & ((Packet[0] & 0x80) ? 0x0F : 0x1F);
+    const uint8_t PacketNumberLength = (Result->Unprotected[0] & 0x03) + 1;
+    uint64_t CompressedPacketNumber = 0;
+    for (uint8_t i = 0; i < PacketNumberLength; ++i) {
+        Result->Unprotected[PacketNumberOffset + i] ^= Mask[1 + i];
+        CompressedPacketNumber =
+            (CompressedPacketNumber << 8) | Result->Unprotected[PacketNumberOffset + i];
+    }
+    *PacketNumber =
+        QuicPktNumDecompress(
+            Connection->NextPacketNumber[Space],
+            CompressedPacketNumber,
+            PacketNumberLength);
+
+    Result->Key = Key->PacketKey;
+    Result->HeaderKey = HeaderKey;
+    Result->HeaderLength = PacketNumberOffset + PacketNumberLength;
+    Result->PacketLength = PacketLength;
+    QuicCryptoCombineIvAndPacketNumber(Key->Iv, (uint8_t*)PacketNumber, Result->Nonce);
+
+    CxPlatCopyMemory(Scratch, Result->Unprotected, PacketLength);
+    return
+        QUIC_SUCCEEDED(
+        CxPlatDecrypt(
+            Result->Key,
+            Result->Nonce,
+            Result->HeaderLength,
+            Scratch,
+            PacketLength - Result->HeaderLength,
+            Scratch + Result->HeaderLength));
+}
+
+//
+// Decrypts the packets of a client datagram, recording the ones that worked.
+//
+BOOLEAN
+ReplayProcessClientDatagram(
+    _Inout_ REPLAY* Replay,
+    _In_ const REPLAY_DATAGRAM* Datagram
+    )
+{
+    uint8_t Scratch[UINT16_MAX];
+    REPLAY_CONNECTION* Connection = ReplayFindConnection(Replay, &Datagram->Source);
+
+    uint16_t Offset = 0;
+    while (Offset < Datagram->Length) {
+        const uint8_t* Packet = Datagram->Buffer + Offset;
+        const uint16_t Available = Datagram->Length - Offset;
+        REPLAY_PACKET_TYPE Type;
+        uint16_t PacketNumberOffset;
+        uint16_t PacketLength;
+
+        if (Packet[0] & 0x80) {
+            if (Available < 7) {
+                Replay->UnparsedCount++;
+                break;
+            }
+            const uint32_t Version = ReplayRead32(Packet + 1, TRUE);
+            const QUIC_VERSION_INFO* VersionInfo = NULL;
+            for (uint32_t i = 0; i < ARRAYSIZE(QuicSupportedVersionList); ++i) {
+                if (QuicSupportedVersionList[i].Number == CxPlatByteSwapUint32(Version)) {
+                    VersionInfo = &QuicSupportedVersionList[i];
+                    break;
+                }
+            }
+            if (VersionInfo == NULL) {
+                Replay->UnparsedCount++;
+                break;
+            }
+            const uint8_t DestCidLength = Packet[5];
+            const uint8_t* DestCid = Packet + 6;
+            if (7u + DestCidLength > Available ||
+                7u + DestCidLength + Packet[6 + DestCidLength] > Available) {
+                Replay->UnparsedCount++;
+                break;
+            }
+            uint16_t HeaderOffset = 7 + DestCidLength + Packet[6 + DestCidLength];
+
+            uint8_t LongType = (Packet[0] >> 4) & 0x3;
+            if (VersionInfo->Number == QUIC_VERSION_2) {
+                LongType = (LongType + 3) & 0x3; // Back to the version 1 numbering.
+            }
+            if (LongType == QUIC_RETRY_V1) {
+                break;
+            }
+            Type =
+                LongType == QUIC_INITIAL_V1 ? REPLAY_PACKET_INITIAL :
+                LongType == QUIC_0_RTT_PROTECTED_V1 ? REPLAY_PACKET_0_RTT :
+                REPLAY_PACKET_HANDSHAKE;
+
+            QUIC_VAR_INT Value;
+            if (Type == REPLAY_PACKET_INITIAL) {
+                if (!QuicVarIntDecode(Available, Packet, &HeaderOffset, &Value) ||
+                    Value > (uint64_t)(Available - HeaderOffset)) {
+                    Replay->UnparsedCount++;
+                    break;
+                }
+                HeaderOffset += (uint16_t)Value; // Token
+            }
+            if (!QuicVarIntDecode(Available, Packet, &HeaderOffset, &Value) ||
+                Value > (uint64_t)(Available - HeaderOffset)) {
+                Replay->UnparsedCount++;
+                break;
+            }
+            PacketNumberOffset = HeaderOffset;
+            PacketLength = HeaderOffset + (uint16_t)Value;
+
+            if (Connection == NULL && Type == REPLAY_PACKET_INITIAL) {
+                //
+                // The client's first Initial starts a connection, and its
+                // destination CID determines the Initial keys.
+                //
+                QUIC_PACKET_KEY* InitialKey;
+                if (!ReplayGrow(
+                        (void**)&Replay->Connections,
+                        &Replay->ConnectionAlloc,
+                        Replay->ConnectionCount,
+                        sizeof(REPLAY_CONNECTION))) {
+                    return FALSE;
+                }
+                if (QUIC_FAILED(
+                        QuicPacketKeyCreateInitial(
+                            TRUE,
+                            &VersionInfo->HkdfLabels,
+                            VersionInfo->Salt,
+                            DestCidLength,
+                            DestCid,
+                            &InitialKey,
+                            NULL)) ||
+                    !ReplayTrackKey(Replay, InitialKey)) {
+                    Replay->NoKeyCount++;
+                    break;
+                }
+                Connection = &Replay->Connections[Replay->ConnectionCount++];
+                CxPlatZeroMemory(Connection, sizeof(*Connection));
+                Connection->Client = Datagram->Source;
+                Connection->Version = VersionInfo;
+                Connection->ServerCidLength = Replay->ServerCidLength;
+                Connection->Aead = CXPLAT_AEAD_AES_128_GCM;
+                Connection->Keys[REPLAY_PACKET_INITIAL] = InitialKey;
+            }
+
+        } else {
+            if (Connection == NULL || Connection->ServerCidLength == UINT8_MAX) {
+                Replay->NoKeyCount++;
+                break;
+            }
+            Type = REPLAY_PACKET_1_RTT;
+            PacketNumberOffset = 1 + Connection->ServerCidLength;
+            PacketLength = Available;
+        }
+
+        Offset += PacketLength;
+        if (Connection == NULL || Connection->Keys[Type] == NULL) {
+            Replay->NoKeyCount++;
+            continue;
+        }
+        if (PacketNumberOffset + 4u + CXPLAT_HP_SAMPLE_LENGTH > PacketLength) {
+            Replay->UnparsedCount++;
+            continue;
+        }
+
+        if (!ReplayGrow(
+                (void**)&Replay->Packets,
+                &Replay->PacketAlloc,
+                Replay->PacketCount,
+                sizeof(REPLAY_CRYPTO_PACKET))) {
+            return FALSE;
+        }
+        REPLAY_CRYPTO_PACKET* Result = &Replay->Packets[Replay->PacketCount];
+        Result->Protected = Packet;
+        Result->Type = Type;
+        Result->Unprotected = (uint8_t*)malloc(PacketLength);
+        if (Result->Unprotected == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            return FALSE;
+        }
+
+        const uint32_t Space =
+            Type == REPLAY_PACKET_INITIAL ? 0 : Type == REPLAY_PACKET_HANDSHAKE ? 1 : 2;
+        CXPLAT_HP_KEY* HeaderKey =
+            Type == REPLAY_PACKET_1_RTT ?
+                Connection->OneRttHeaderKey : Connection->Keys[Type]->HeaderKey;
+        uint64_t PacketNumber;
+        BOOLEAN Decrypted =
+            ReplayDecryptPacket(
+                Connection, Connection->Keys[Type], HeaderKey, Packet, PacketLength,
+                PacketNumberOffset, Space, Result, Scratch, &PacketNumber);
+
+        if (!Decrypted && Type == REPLAY_PACKET_1_RTT &&
+            ((Result->Unprotected[0] >> 2) & 1) != Connection->KeyPhase) {
+            //
+            // The client updated its keys.
+            //
+            if (Connection->NextOneRttKey == NULL) {
+                QUIC_PACKET_KEY* NextKey;
+                if (QUIC_SUCCEEDED(
+                        QuicPacketKeyUpdate(
+                            &Connection->Version->HkdfLabels,
+                            Connection->Keys[REPLAY_PACKET_1_RTT],
+                            &NextKey)) &&
+                    ReplayTrackKey(Replay, NextKey)) {
+                    Connection->NextOneRttKey = NextKey;
+                }
+            }
+            if (Connection->NextOneRttKey != NULL &&
+                ReplayDecryptPacket(
+                    Connection, Connection->NextOneRttKey, HeaderKey, Packet, PacketLength,
+                    PacketNumberOffset, Space, Result, Scratch, &PacketNumber)) {
+                Decrypted = TRUE;
+                Connection->Keys[REPLAY_PACKET_1_RTT] = Connection->NextOneRttKey;
+                Connection->NextOneRttKey = NULL;
+                Connection->KeyPhase ^= 1;
+            }
+        }
+
+        if (!Decrypted && Type != REPLAY_PACKET_INITIAL &&
+            !Connection->AeadConfirmed &&
+            Connection->Aead == CXPLAT_AEAD_AES_128_GCM) {
+            //
+            // A 32 byte secret may be for ChaCha20-Poly1305 instead.
+            //
+            Connection->Aead = CXPLAT_AEAD_CHACHA20_POLY1305;
+            ReplayDeriveKeys(Replay, Connection);
+            Offset -= PacketLength;
+            free(Result->Unprotected);
+            continue;
+        }
+
+        if (!Decrypted) {
+            free(Result->Unprotected);
+            Replay->DecryptFailCount++;
+            continue;
+        }
+
+        if (Type != REPLAY_PACKET_INITIAL) {
+            Connection->AeadConfirmed = TRUE;
+        }
+        if (PacketNumber + 1 > Connection->NextPacketNumber[Space]) {
+            Connection->NextPacketNumber[Space] = PacketNumber + 1;
+        }
+        if (Type == REPLAY_PACKET_INITIAL && !Connection->GotClientRandom &&
+            ReplayFindClientRandom(
+                Scratch + Result->HeaderLength,
+                PacketLength - Result->HeaderLength - CXPLAT_ENCRYPTION_OVERHEAD,
+                Connection->ClientRandom)) {
+            Connection->GotClientRandom = TRUE;
+            ReplayDeriveKeys(Replay, Connection);
+        }
+
+        Replay->PacketTypeCounts[Type]++;
+        Replay->PacketCount++;
+    }
+
+    return TRUE;
+}
+
+void
+ReplayPrintPhase(
+    _In_ const REPLAY* Replay,
+    _In_z_ const char* Name,
+    _In_ uint64_t Count,
+    _In_ uint64_t ElapsedUs
+    )
+{
+    const double NsPerOp = Count == 0 ? 0 : (double)ElapsedUs * 1000.0 / (double)Count;
+    if (Replay->Json) {
+        printf(
+            "{\"name\":\"%s\",\"count\":%llu,\"elapsed_us\":%llu,\"ns_per_op\":%.3f}\n",
+            Name, (unsigned long long)Count, (unsigned long long)ElapsedUs, NsPerOp);
+    } else {
+        printf("%-36s %14llu %14llu %12.2f\n",
+            Name, (unsigned long long)Count, (unsigned long long)ElapsedUs, NsPerOp);
+    }
+}
+
+BOOLEAN
+ReplayCrypto(
+    _Inout_ REPLAY* Replay
+    )
+{
+    for (uint32_t i = 0; i < Replay->DatagramCount; ++i) {
+        const REPLAY_DATAGRAM* Datagram = &Replay->Datagrams[i];
+        if (QuicAddrGetPort(&Datagram->Destination) == Replay->ServerPort) {
+            if (!ReplayProcessClientDatagram(Replay, Datagram)) {
+                return FALSE;
+            }
+        } else if (QuicAddrGetPort(&Datagram->Source) == Replay->ServerPort) {
+            ReplayProcessServerDatagram(Replay, Datagram);
+        }
+    }
+
+    if (!Replay->Json) {
+        printf("crypto: %u connections, %u packets decrypted (",
+            Replay->ConnectionCount, Replay->PacketCount);
+        for (uint32_t Type = 0; Type < REPLAY_PACKET_TYPE_COUNT; ++Type) {
+            printf("%s%s %u", Type == 0 ? "" : ", ",
+                ReplayPacketTypeNames[Type], Replay->PacketTypeCounts[Type]);
+        }
+        printf("), %u without keys, %u failed, %u unparsed\n",
+            Replay->NoKeyCount, Replay->DecryptFailCount, Replay->UnparsedCount);
+    }
+    if (Replay->PacketCount == 0) {
+        return TRUE;
+    }
+
+    uint8_t Scratch[UINT16_MAX];
+    uint8_t Mask[CXPLAT_HP_SAMPLE_LENGTH];
+    const uint64_t Count = (uint64_t)Replay->PacketCount * Replay->Iterations;
+
+    uint64_t StartUs = CxPlatTimeUs64();
+    for (uint32_t Iteration = 0; Iteration < Replay->Iterations; ++Iteration) {
+        for (uint32_t i = 0; i < Replay->PacketCount; ++i) {
+            const REPLAY_CRYPTO_PACKET* Packet = &Replay->Packets[i];
+            (void)CxPlatHpComputeMask(
+                Packet->HeaderKey, 1, Packet->Protected + Packet->SampleOffset, Mask);
+            ReplaySink += Mask[0];
+        }
+    }
+    ReplayPrintPhase(
+        Replay, "crypto/hp_mask", Count, CxPlatTimeDiff64(StartUs, CxPlatTimeUs64()));
+
+    //
+    // Decryption is in place, so each packet is copied first. The copy alone
+    // is timed too, to be subtracted.
+    //
+    StartUs = CxPlatTimeUs64();
+    for (uint32_t Iteration = 0; Iteration < Replay->Iterations; ++Iteration) {
+        for (uint32_t i = 0; i < Replay->PacketCount; ++i) {
+            const REPLAY_CRYPTO_PACKET* Packet = &Replay->Packets[i];
+            CxPlatCopyMemory(Scratch, Packet->Unprotected, Packet->PacketLength);
+            ReplaySink += Scratch[Packet->PacketLength - 1];
+        }
+    }
+    ReplayPrintPhase(
+        Replay, "crypto/copy", Count, CxPlatTimeDiff64(StartUs, CxPlatTimeUs64()));
+
+    uint64_t Failures = 0;
+    StartUs = CxPlatTimeUs64();
+    for (uint32_t Iteration = 0; Iteration < Replay->Iterations; ++Iteration) {
+        for (uint32_t i = 0; i < Replay->PacketCount; ++i) {
+            const REPLAY_CRYPTO_PACKET* Packet = &Replay->Packets[i];
+            CxPlatCopyMemory(Scratch, Packet->Unprotected, Packet->PacketLength);
+            if (QUIC_FAILED(
+                    CxPlatDecrypt(
+                        Packet->Key,
+                        Packet->Nonce,
+                        Packet->HeaderLength,
+                        Scratch,
+                        Packet->PacketLength - Packet->HeaderLength,
+                        Scratch + Packet->HeaderLength))) {
+                Failures++;
+            }
+        }
+    }
+    ReplayPrintPhase(
+        Replay, "crypto/copy_decrypt", Count, CxPlatTimeDiff64(StartUs, CxPlatTimeUs64()));
+    ReplaySink += Failures;
+
+    return TRUE;
+}
+
+//
+// Live phase
+//
+
+static const char* const ReplayActivityNames[QUIC_WORKER_ACTIVITY_COUNT] = {
+    "worker/receive",
+    "worker/send",
+    "worker/crypto",
+    "worker/timers",
+    "worker/app_callback",
+    "worker/other",
+    "worker/idle"
+};
+
+static const char* const ReplayDropReasonNames[QUIC_RECV_DROP_REASON_COUNT] = {
+    "drop/invalid_packet",
+    "drop/no_connection",
+    "drop/decryption_failure",
+    "drop/duplicate",
+    "drop/key_unavailable",
+    "drop/queue_full",
+    "drop/out_of_memory",
+    "drop/invalid_token",
+    "drop/filtered",
+    "drop/unexpected"
+};
+
+static const struct {
+    QUIC_PERFORMANCE_COUNTERS Counter;
+    const char* Name;
+} ReplayCounters[] = {
+    { QUIC_PERF_COUNTER_UDP_RECV,               "counter/udp_recv" },
+    { QUIC_PERF_COUNTER_UDP_RECV_EVENTS,        "counter/udp_recv_events" },
+    { QUIC_PERF_COUNTER_PKTS_DROPPED,           "counter/pkts_dropped" },
+    { QUIC_PERF_COUNTER_PKTS_DECRYPTION_FAIL,   "counter/pkts_decryption_fail" },
+    { QUIC_PERF_COUNTER_CONN_CREATED,           "counter/conn_created" },
+    { QUIC_PERF_COUNTER_CONN_NO_ALPN,           "counter/conn_no_alpn" },
+    { QUIC_PERF_COUNTER_SEND_STATELESS_RESET,   "counter/send_stateless_reset" },
+    { QUIC_PERF_COUNTER_UDP_SEND,               "counter/udp_send" },
+};
+
+//
+// Library wide totals, summed from a metrics snapshot.
+//
+typedef struct REPLAY_METRICS {
+
+    int64_t PerfCounters[QUIC_PERF_COUNTER_MAX];
+    int64_t RecvDropCounters[QUIC_RECV_DROP_REASON_COUNT];
+    uint64_t ActivityTimeUs[QUIC_WORKER_ACTIVITY_COUNT];
+
+} REPLAY_METRICS;
+
+BOOLEAN
+ReplayGetMetrics(
+    _In_ const QUIC_API_TABLE* MsQuic,
+    _Out_ REPLAY_METRICS* Metrics
+    )
+{
+    CxPlatZeroMemory(Metrics, sizeof(*Metrics));
+
+    uint32_t Length = 0;
+    if (MsQuic->GetParam(NULL, QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT, &Length, NULL) !=
+            QUIC_STATUS_BUFFER_TOO_SMALL) {
+        return FALSE;
+    }
+    uint8_t* Buffer = (uint8_t*)malloc(Length);
+    if (Buffer == NULL) {
+        return FALSE;
+    }
+    if (QUIC_FAILED(
+            MsQuic->GetParam(NULL, QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT, &Length, Buffer))) {
+        free(Buffer);
+        return FALSE;
+    }
+
+    const QUIC_METRICS_SNAPSHOT* Snapshot = (const QUIC_METRICS_SNAPSHOT*)Buffer;
+    const QUIC_PARTITION_METRICS* Partitions = (const QUIC_PARTITION_METRICS*)(Snapshot + 1);
+    for (uint32_t i = 0; i < Snapshot->PartitionCount; ++i) {
+        for (uint32_t j = 0; j < QUIC_PERF_COUNTER_MAX; ++j) {
+            Metrics->PerfCounters[j] += Partitions[i].PerfCounters[j];
+        }
+        for (uint32_t j = 0; j < QUIC_RECV_DROP_REASON_COUNT; ++j) {
+            Metrics->RecvDropCounters[j] += Partitions[i].RecvDropCounters[j];
+        }
+    }
+    const QUIC_WORKER_METRICS* Workers =
+        (const QUIC_WORKER_METRICS*)(Partitions + Snapshot->PartitionCount);
+    for (uint32_t i = 0; i < Snapshot->WorkerCount; ++i) {
+        for (uint32_t j = 0; j < QUIC_WORKER_ACTIVITY_COUNT; ++j) {
+            Metrics->ActivityTimeUs[j] += Workers[i].ActivityTimeUs[j];
+        }
+    }
+
+    free(Buffer);
+    return TRUE;
+}
+
+uint64_t
+ReplayProcessCpuTimeUs(
+    void
+    )
+{
+    struct rusage Usage;
+    if (getrusage(RUSAGE_SELF, &Usage) != 0) {
+        return 0;
+    }
+    return
+        S_TO_US((uint64_t)Usage.ru_utime.tv_sec + (uint64_t)Usage.ru_stime.tv_sec) +
+        (uint64_t)Usage.ru_utime.tv_usec + (uint64_t)Usage.ru_stime.tv_usec;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_LISTENER_CALLBACK)
+QUIC_STATUS
+QUIC_API
+ReplayListenerCallback(
+    _In_ HQUIC Listener,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_LISTENER_EVENT* Event
+    )
+{
+    UNREFERENCED_PARAMETER(Listener);
+    UNREFERENCED_PARAMETER(Context);
+
+    //
+    // The replayed handshakes can't complete, since the server's keys differ
+    // from the captured server's.
+    //
+    return
+        Event->Type == QUIC_LISTENER_EVENT_NEW_CONNECTION ?
+            QUIC_STATUS_CONNECTION_REFUSED : QUIC_STATUS_SUCCESS;
+}
+
+//
+// Waits until the replay time of the datagram.
+//
+void
+ReplayWait(
+    _In_ const REPLAY* Replay,
+    _In_ uint64_t StartUs,
+    _In_ uint64_t CaptureStartUs,
+    _In_ uint64_t CaptureTimeUs
+    )
+{
+    if (Replay->Speed <= 0 || CaptureTimeUs <= CaptureStartUs) {
+        return;
+    }
+    const uint64_t TargetUs =
+        StartUs + (uint64_t)((double)(CaptureTimeUs - CaptureStartUs) / Replay->Speed);
+    for (;;) {
+        const uint64_t NowUs = CxPlatTimeUs64();
+        if (NowUs >= TargetUs) {
+            return;
+        }
+        if (TargetUs - NowUs > 2000) {
+            CxPlatSleep((uint32_t)US_TO_MS(TargetUs - NowUs) - 1);
+        } else {
+            CxPlatSchedulerYield();
+        }
+    }
+}
+
+BOOLEAN
+ReplayLive(
+    _In_ const REPLAY* Replay
+    )
+{
+    const QUIC_API_TABLE* MsQuic = NULL;
+    HQUIC Registration = NULL;
+    HQUIC Listener = NULL;
+    BOOLEAN Success = FALSE;
+    QUIC_STATUS Status;
+
+    if (QUIC_FAILED(Status = MsQuicOpen2(&MsQuic))) {
+        fprintf(stderr, "MsQuicOpen2 failed, 0x%x\n", Status);
+        return FALSE;
+    }
+
+    const QUIC_REGISTRATION_CONFIG RegConfig = {
+        "quicreplay", QUIC_EXECUTION_PROFILE_LOW_LATENCY
+    };
+    if (QUIC_FAILED(Status = MsQuic->RegistrationOpen(&RegConfig, &Registration))) {
+        fprintf(stderr, "RegistrationOpen failed, 0x%x\n", Status);
+        goto Exit;
+    }
+    if (QUIC_FAILED(
+            Status = MsQuic->ListenerOpen(Registration, ReplayListenerCallback, NULL, &Listener))) {
+        fprintf(stderr, "ListenerOpen failed, 0x%x\n", Status);
+        goto Exit;
+    }
+    const QUIC_BUFFER Alpn = { (uint32_t)strlen(Replay->Alpn), (uint8_t*)Replay->Alpn };
+    QUIC_ADDR Address;
+    CxPlatZeroMemory(&Address, sizeof(Address));
+    QuicAddrSetFamily(&Address, QUIC_ADDRESS_FAMILY_UNSPEC);
+    QuicAddrSetPort(&Address, Replay->ServerPort);
+    if (QUIC_FAILED(Status = MsQuic->ListenerStart(Listener, &Alpn, 1, &Address))) {
+        fprintf(stderr, "ListenerStart failed, 0x%x\n", Status);
+        goto Exit;
+    }
+
+    REPLAY_METRICS Before, After;
+    if (!ReplayGetMetrics(MsQuic, &Before)) {
+        fprintf(stderr, "Failed to get the metrics snapshot\n");
+        goto Exit;
+    }
+
+    uint64_t Injected = 0, Failed = 0, InjectedBytes = 0;
+    uint64_t CaptureStartUs = 0, CaptureEndUs = 0;
+    const uint64_t CpuStartUs = ReplayProcessCpuTimeUs();
+    const uint64_t StartUs = CxPlatTimeUs64();
+
+    for (uint32_t i = 0; i < Replay->DatagramCount; ++i) {
+        const REPLAY_DATAGRAM* Datagram = &Replay->Datagrams[i];
+        if (QuicAddrGetPort(&Datagram->Destination) != Replay->ServerPort) {
+            continue;
+        }
+        if (Injected + Failed == 0) {
+            CaptureStartUs = Datagram->TimeUs;
+        }
+        CaptureEndUs = Datagram->TimeUs;
+        ReplayWait(Replay, StartUs, CaptureStartUs, Datagram->TimeUs);
+        if (QUIC_SUCCEEDED(
+                CxPlatMemoryDataPathInject(
+                    &Datagram->Source,
+                    &Datagram->Destination,
+                    Datagram->Length,
+                    Datagram->Buffer))) {
+            Injected++;
+            InjectedBytes += Datagram->Length;
+        } else {
+            Failed++;
+        }
+    }
+    const uint64_t ReplayEndUs = CxPlatTimeUs64();
+
+    //
+    // Let the server finish with what was injected.
+    //
+    const uint64_t DrainEndUs = ReplayEndUs + MS_TO_US(Replay->DrainMs);
+    do {
+        CxPlatSleep(10);
+        if (!ReplayGetMetrics(MsQuic, &After)) {
+            fprintf(stderr, "Failed to get the metrics snapshot\n");
+            goto Exit;
+        }
+    } while (
+        (uint64_t)(After.PerfCounters[QUIC_PERF_COUNTER_UDP_RECV] -
+            Before.PerfCounters[QUIC_PERF_COUNTER_UDP_RECV]) < Injected &&
+        CxPlatTimeUs64() < DrainEndUs);
+    CxPlatSleep(10);
+    (void)ReplayGetMetrics(MsQuic, &After);
+    const uint64_t CpuUs = ReplayProcessCpuTimeUs() - CpuStartUs;
+    const uint64_t WallUs = CxPlatTimeDiff64(StartUs, CxPlatTimeUs64());
+
+    if (!Replay->Json) {
+        printf(
+            "live: %llu datagrams (%llu bytes) injected, %llu failed, "
+            "%llu ms captured, replayed in %llu ms\n",
+            (unsigned long long)Injected,
+            (unsigned long long)InjectedBytes,
+            (unsigned long long)Failed,
+            (unsigned long long)US_TO_MS(CaptureEndUs - CaptureStartUs),
+            (unsigned long long)US_TO_MS(ReplayEndUs - StartUs));
+        printf("%-36s %14s %14s %12s\n", "Phase", "Datagrams", "Time (us)", "ns/datagram");
+    }
+
+    //
+    // Worker activity times are wall times; what the process spent outside
+    // of them (datapath delivery and binding demultiplexing, mostly) is left
+    // unattributed.
+    //
+    uint64_t AttributedUs = 0;
+    for (uint32_t i = 0; i < QUIC_WORKER_ACTIVITY_COUNT; ++i) {
+        const uint64_t TimeUs = After.ActivityTimeUs[i] - Before.ActivityTimeUs[i];
+        if (i != QUIC_WORKER_ACTIVITY_IDLE) {
+            AttributedUs += TimeUs;
+            ReplayPrintPhase(Replay, ReplayActivityNames[i], Injected, TimeUs);
+        }
+    }
+    ReplayPrintPhase(Replay, "process/cpu", Injected, CpuUs);
+    ReplayPrintPhase(
+        Replay, "process/unattributed", Injected, CpuUs > AttributedUs ? CpuUs - AttributedUs : 0);
+    ReplayPrintPhase(Replay, "process/wall", Injected, WallUs);
+
+    for (uint32_t i = 0; i < ARRAYSIZE(ReplayCounters); ++i) {
+        const int64_t Delta =
+            After.PerfCounters[ReplayCounters[i].Counter] -
+            Before.PerfCounters[ReplayCounters[i].Counter];
+        if (Replay->Json) {
+            printf("{\"name\":\"%s\",\"value\":%lld}\n", ReplayCounters[i].Name, (long long)Delta);
+        } else {
+            printf("%-36s %14lld\n", ReplayCounters[i].Name, (long long)Delta);
+        }
+    }
+    for (uint32_t i = 0; i < QUIC_RECV_DROP_REASON_COUNT; ++i) {
+        const int64_t Delta = After.RecvDropCounters[i] - Before.RecvDropCounters[i];
+        if (Delta == 0) {
+            continue;
+        }
+        if (Replay->Json) {
+            printf("{\"name\":\"%s\",\"value\":%lld}\n", ReplayDropReasonNames[i], (long long)Delta);
+        } else {
+            printf("%-36s %14lld\n", ReplayDropReasonNames[i], (long long)Delta);
+        }
+    }
+
+    Success = TRUE;
+
+Exit:
+
+    if (Listener != NULL) {
+        MsQuic->ListenerClose(Listener);
+    }
+    if (Registration != NULL) {
+        MsQuic->RegistrationClose(Registration);
+    }
+    MsQuicClose(MsQuic);
+    return Success;
+}
+
+void
+PrintUsage(
+    void
+    )
+{
+    printf(
+        "Usage: quicreplay -pcap:<file> -port:<server port> [-keylog:<file>] [-speed:<x>]\n"
+        "                  [-phase:<live|crypto|all>] [-iterations:<n>] [-drain:<ms>]\n"
+        "                  [-alpn:<alpn>] [-cid_len:<n>] [-format:<text|json>]\n"
+        "\n"
+        "  -speed:<x>       Replays at x times the recorded rate; 0 sends back to back (1)\n"
+        "  -keylog:<file>   NSS key log with the client traffic secrets of the capture\n"
+        "  -iterations:<n>  Passes over the packets in each timed crypto step (%u)\n"
+        "  -drain:<ms>      How long to wait for the server to process the replay (%u)\n"
+        "  -alpn:<alpn>     The listener's ALPN (h3)\n"
+        "  -cid_len:<n>     The server's CID length, if its packets aren't captured\n",
+        REPLAY_DEFAULT_ITERATIONS,
+        REPLAY_DEFAULT_DRAIN_MS);
+}
+
+_Null_terminated_ const char*
+GetValue(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_z_ const char* Name
+    )
+{
+    const size_t NameLength = strlen(Name);
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-' &&
+            strncmp(argv[i] + 1, Name, NameLength) == 0 &&
+            (argv[i][NameLength + 1] == ':' || argv[i][NameLength + 1] == '\0')) {
+            return argv[i][NameLength + 1] == ':' ? argv[i] + NameLength + 2 : "";
+        }
+    }
+    return NULL;
+}
+
+int
+QUIC_MAIN_EXPORT
+main(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    REPLAY Replay;
+    CxPlatZeroMemory(&Replay, sizeof(Replay));
+    Replay.ServerCidLength = UINT8_MAX;
+    Replay.Speed = 1;
+    Replay.Iterations = REPLAY_DEFAULT_ITERATIONS;
+    Replay.DrainMs = REPLAY_DEFAULT_DRAIN_MS;
+    Replay.Alpn = "h3";
+    BOOLEAN RunLive = TRUE, RunCrypto = TRUE;
+    int Result = 1;
+
+    const char* PcapPath = GetValue(argc, argv, "pcap");
+    const char* KeyLogPath = GetValue(argc, argv, "keylog");
+    const char* Value;
+
+    if (GetValue(argc, argv, "help") || GetValue(argc, argv, "?")) {
+        PrintUsage();
+        return 0;
+    }
+    if (PcapPath == NULL || *PcapPath == '\0' ||
+        (Value = GetValue(argc, argv, "port")) == NULL ||
+        (Replay.ServerPort = (uint16_t)strtoul(Value, NULL, 10)) == 0) {
+        PrintUsage();
+        return 1;
+    }
+    if ((Value = GetValue(argc, argv, "speed")) != NULL) {
+        Replay.Speed = strtod(Value, NULL);
+    }
+    if ((Value = GetValue(argc, argv, "iterations")) != NULL) {
+        Replay.Iterations = (uint32_t)strtoul(Value, NULL, 10);
+    }
+    if ((Value = GetValue(argc, argv, "drain")) != NULL) {
+        Replay.DrainMs = (uint32_t)strtoul(Value, NULL, 10);
+    }
+    if ((Value = GetValue(argc, argv, "alpn")) != NULL && *Value != '\0') {
+        Replay.Alpn = Value;
+    }
+    if ((Value = GetValue(argc, argv, "cid_len")) != NULL) {
+        const unsigned long CidLength = strtoul(Value, NULL, 10);
+        if (CidLength > QUIC_MAX_CONNECTION_ID_LENGTH_V1) {
+            PrintUsage();
+            return 1;
+        }
+        Replay.ServerCidLength = (uint8_t)CidLength;
+    }
+    if ((Value = GetValue(argc, argv, "phase")) != NULL) {
+        if (strcmp(Value, "live") == 0) {
+            RunCrypto = FALSE;
+        } else if (strcmp(Value, "crypto") == 0) {
+            RunLive = FALSE;
+        } else if (strcmp(Value, "all") != 0) {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if ((Value = GetValue(argc, argv, "format")) != NULL) {
+        if (strcmp(Value, "json") == 0) {
+            Replay.Json = TRUE;
+        } else if (strcmp(Value, "text") != 0) {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (!ReplayReadFile(PcapPath, &Replay.File, &Replay.FileLength)) {
+        return 1;
+    }
+    if (!(Replay.FileLength >= 4 && ReplayRead32(Replay.File, FALSE) == 0x0A0D0D0A ?
+            ReplayParsePcapng(&Replay) : ReplayParsePcap(&Replay))) {
+        fprintf(stderr, "%s is not a supported pcap or pcapng capture\n", PcapPath);
+        goto Exit;
+    }
+    if (!Replay.Json) {
+        printf("capture: %u UDP datagrams, %u other frames skipped\n",
+            Replay.DatagramCount, Replay.SkippedFrames);
+    }
+    if (KeyLogPath != NULL && !ReplayLoadKeyLog(&Replay, KeyLogPath)) {
+        goto Exit;
+    }
+
+    if (RunLive && !ReplayLive(&Replay)) {
+        goto Exit;
+    }
+
+    if (RunCrypto) {
+        CxPlatSystemLoad();
+        if (QUIC_FAILED(CxPlatInitialize())) {
+            CxPlatSystemUnload();
+            goto Exit;
+        }
+        const BOOLEAN Success = ReplayCrypto(&Replay);
+        for (uint32_t i = 0; i < Replay.KeyCount; ++i) {
+            QuicPacketKeyFree(Replay.Keys[i]);
+        }
+        CxPlatUninitialize();
+        CxPlatSystemUnload();
+        if (!Success) {
+            goto Exit;
+        }
+    }
+
+    Result = 0;
+
+Exit:
+
+    for (uint32_t i = 0; i < Replay.PacketCount; ++i) {
+        free(Replay.Packets[i].Unprotected);
+    }
+    free(Replay.Packets);
+    free(Replay.Keys);
+    free(Replay.Connections);
+    free(Replay.Secrets);
+    free(Replay.Datagrams);
+    free(Replay.File);
+    return Result;
+}
@@ -0,0 +1,269 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Converts a binary qlog trace, as returned by QUIC_PARAM_CONN_QLOG, to
+    qlog JSON-SEQ (RFC 7464: each record is preceded by a record separator
+    and followed by a newline), for qvis and other qlog tools.
+
+--*/
+
+#define QUIC_API_ENABLE_PREVIEW_FEATURES 1
+
+#include "quic_platform.h"
+#include "msquic.h"
+#include "quic_var_int.h"
+
+#include <stdio.h>
+
+#define QLOG_RECORD_SEPARATOR   '\x1e'
+#define QLOG_MAX_FIELDS         6
+
+static const uint8_t QlogFieldCounts[QUIC_QLOG_EVENT_COUNT] = {
+    3, // QUIC_QLOG_EVENT_PACKET_SENT
+    3, // QUIC_QLOG_EVENT_PACKET_RECEIVED
+    3, // QUIC_QLOG_EVENT_PACKET_LOST
+    6, // QUIC_QLOG_EVENT_METRICS_UPDATED
+    2  // QUIC_QLOG_EVENT_STREAM_STATE
+};
+
+static const char* const QlogPacketTypes[] = {
+    "initial", "0RTT", "handshake", "1RTT"
+};
+
+static const char* const QlogStreamStates[] = {
+    "open", "half_closed_local", "closed"
+};
+
+//
+// Writes microseconds as (fractional) milliseconds, qlog's time unit.
+//
+void
+QlogWriteMs(
+    _In_ FILE* Output,
+    _In_ uint64_t TimeUs
+    )
+{
+    fprintf(
+        Output, "%llu.%03llu",
+        (unsigned long long)(TimeUs / 1000),
+        (unsigned long long)(TimeUs % 1000));
+}
+
+void
+QlogWritePacketEvent(
+    _In_ FILE* Output,
+    _In_z_ const char* Name,
+    _In_reads_(3) const uint64_t* Fields
+    )
+{
+    fprintf(
+        Output,
+        "\"name\":\"%s\",\"data\":{\"header\":{\"packet_type\":\"%s\",\"packet_number\":%llu},"
+        "\"raw\":{\"length\":%llu}}",
+        Name,
+        Fields[0] < ARRAYSIZE(QlogPacketTypes) ? QlogPacketTypes[Fields[0]] : "unknown",
+        (unsigned long long)Fields[1],
+        (unsigned long long)Fields[2]);
+}
+
+BOOLEAN
+QlogConvert(
+    _In_reads_bytes_(Length) const uint8_t* Trace,
+    _In_ size_t Length,
+    _In_ FILE* Output
+    )
+{
+    QUIC_QLOG_HEADER Header;
+    if (Length < sizeof(Header)) {
+        fprintf(stderr, "Trace too short\n");
+        return FALSE;
+    }
+    memcpy(&Header, Trace, sizeof(Header));
+    if (Header.Magic != QUIC_QLOG_MAGIC ||
+        Header.Version != QUIC_QLOG_VERSION ||
+        Header.Length > Length - sizeof(Header)) {
+        fprintf(stderr, "Not a version %u qlog trace\n", QUIC_QLOG_VERSION);
+        return FALSE;
+    }
+    if (Header.DroppedEvents != 0) {
+        fprintf(
+            stderr, "%u events were dropped from the start of the trace\n",
+            Header.DroppedEvents);
+    }
+
+    fprintf(
+        Output,
+        "%c{\"qlog_version\":\"0.4\",\"qlog_format\":\"JSON-SEQ\",\"title\":\"msquic\","
+        "\"trace\":{\"vantage_point\":{\"type\":\"%s\"},\"common_fields\":{"
+        "\"group_id\":\"%llu\",\"time_format\":\"relative\",\"reference_time\":%llu}}}\n",
+        QLOG_RECORD_SEPARATOR,
+        Header.IsServer ? "server" : "client",
+        (unsigned long long)Header.CorrelationId,
+        (unsigned long long)Header.StartTimeEpochMs);
+
+    const uint8_t* Event = Trace + sizeof(Header);
+    const uint8_t* End = Event + Header.Length;
+    while (Event < End) {
+        const uint16_t EventLength = Event[0];
+        if (EventLength < 2 || EventLength > End - Event - 1) {
+            fprintf(stderr, "Truncated event\n");
+            return FALSE;
+        }
+
+        const uint8_t Type = Event[1];
+        const uint8_t* Payload = Event + 2;
+        const uint16_t PayloadLength = EventLength - 1;
+        Event += 1 + EventLength;
+        if (Type >= QUIC_QLOG_EVENT_COUNT) {
+            continue; // From a newer version; skip it.
+        }
+
+        uint16_t Offset = 0;
+        QUIC_VAR_INT TimeUs;
+        QUIC_VAR_INT Fields[QLOG_MAX_FIELDS];
+        BOOLEAN Valid = QuicVarIntDecode(PayloadLength, Payload, &Offset, &TimeUs);
+        for (uint8_t i = 0; Valid && i < QlogFieldCounts[Type]; ++i) {
+            Valid = QuicVarIntDecode(PayloadLength, Payload, &Offset, &Fields[i]);
+        }
+        if (!Valid) {
+            fprintf(stderr, "Malformed event\n");
+            return FALSE;
+        }
+
+        fprintf(Output, "%c{\"time\":", QLOG_RECORD_SEPARATOR);
+        QlogWriteMs(Output, TimeUs);
+        fputc(',', Output);
+
+        switch (Type) {
+        case QUIC_QLOG_EVENT_PACKET_SENT:
+            QlogWritePacketEvent(Output, "transport:packet_sent", Fields);
+            break;
+        case QUIC_QLOG_EVENT_PACKET_RECEIVED:
+            QlogWritePacketEvent(Output, "transport:packet_received", Fields);
+            break;
+        case QUIC_QLOG_EVENT_PACKET_LOST:
+            QlogWritePacketEvent(Output, "recovery:packet_lost", Fields);
+            break;
+        case QUIC_QLOG_EVENT_METRICS_UPDATED:
+            fprintf(
+                Output,
+                "\"name\":\"recovery:metrics_updated\",\"data\":{\"congestion_window\":%llu,"
+                "\"packets_in_flight\":%llu,\"smoothed_rtt\":",
+                (unsigned long long)Fields[0],
+                (unsigned long long)Fields[1]);
+            QlogWriteMs(Output, Fields[2]);
+            fputs(",\"min_rtt\":", Output);
+            QlogWriteMs(Output, Fields[3]);
+            fputs(",\"latest_rtt\":", Output);
+            QlogWriteMs(Output, Fields[4]);
+            fputs(",\"rtt_variance\":", Output);
+            QlogWriteMs(Output, Fields[5]);
+            fputc('}', Output);
+            break;
+        case QUIC_QLOG_EVENT_STREAM_STATE:
+            fprintf(
+                Output,
+                "\"name\":\"transport:stream_state_updated\",\"data\":{\"stream_id\":%llu,\"new\":\"%s\"}",
+                (unsigned long long)Fields[0],
+                Fields[1] < ARRAYSIZE(QlogStreamStates) ? QlogStreamStates[Fields[1]] : "unknown");
+            break;
+        }
+
+        fputs("}\n", Output);
+    }
+
+    return TRUE;
+}
+
+void
+PrintUsage(
+    void
+    )
+{
+    printf("Usage: qlogconv -input:<binary trace> [-output:<JSON-SEQ file>]\n");
+}
+
+_Null_terminated_ const char*
+GetValue(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_z_ const char* Name
+    )
+{
+    const size_t NameLength = strlen(Name);
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] == '-' &&
+            strncmp(argv[i] + 1, Name, NameLength) == 0 &&
+            (argv[i][NameLength + 1] == ':' || argv[i][NameLength + 1] == '\0')) {
+            return argv[i][NameLength + 1] == ':' ? argv[i] + NameLength + 2 : "";
+        }
+    }
+    return NULL;
+}
+
+int
+QUIC_MAIN_EXPORT
+main(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    const char* InputPath = GetValue(argc, argv, "input");
+    const char* OutputPath = GetValue(argc, argv, "output");
+    if (GetValue(argc, argv, "help") || GetValue(argc, argv, "?")) {
+        PrintUsage();
+        return 0;
+    }
+    if (InputPath == NULL || *InputPath == '\0') {
+        PrintUsage();
+        return 1;
+    }
+
+    FILE* Input = fopen(InputPath, "rb");
+    if (Input == NULL) {
+        fprintf(stderr, "Failed to open %s\n", InputPath);
+        return 1;
+    }
+
+    uint8_t* Trace = NULL;
+    size_t Length = 0;
+    size_t AllocLength = 0;
+    for (;;) {
+        if (Length == AllocLength) {
+            AllocLength = AllocLength == 0 ? 64 * 1024 : 2 * AllocLength;
+            uint8_t* NewTrace = (uint8_t*)realloc(Trace, AllocLength);
+            if (NewTrace == NULL) {
+                fprintf(stderr, "Out of memory\n");
+                free(Trace);
+                fclose(Input);
+                return 1;
+            }
+            Trace = NewTrace;
+        }
+        const size_t Read = fread(Trace + Length, 1, AllocLength - Length, Input);
+        if (Read == 0) {
+            break;
+        }
+        Length += Read;
+    }
+    fclose(Input);
+
+    FILE* Output = stdout;
+    if (OutputPath != NULL && (Output = fopen(OutputPath, "w")) == NULL) {
+        fprintf(stderr, "Failed to open %s\n", OutputPath);
+        free(Trace);
+        return 1;
+    }
+
+    const BOOLEAN Success = QlogConvert(Trace, Length, Output);
+
+    if (Output != stdout) {
+        fclose(Output);
+    }
+    free(Trace);
+    return Success ? 0 : 1;
+}
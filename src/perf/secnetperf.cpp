@@ -0,0 +1,1100 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Throughput, request/response latency, handshake rate and connection scale
+    benchmarks, run between a secnetperf server and client.
+
+    On each stream the client first sends the number of bytes it wants back
+    (8 bytes, network byte order), then its upload bytes, then FIN. The server
+    answers with the requested number of bytes, then FIN.
+
+    When built with QUIC_LINUX_MEMORY_DATAPATH, "-io:memory" runs the server
+    in the client's process, over the in-memory datapath.
+
+--*/
+
+#define QUIC_API_ENABLE_PREVIEW_FEATURES 1
+#include "msquichelper.h"
+#include "msquic.hpp"
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+const MsQuicApi* MsQuic;
+
+#define PERF_DEFAULT_PORT               4433
+#define PERF_DEFAULT_RUN_TIME_MS        10000
+#define PERF_DEFAULT_CONN_COUNT         1
+#define PERF_DEFAULT_STREAM_COUNT       1
+#define PERF_DEFAULT_PARALLEL_COUNT     16
+#define PERF_DEFAULT_MAX_CONN_COUNT     1000
+#define PERF_DEFAULT_BULK_LENGTH        (100ull * 1000 * 1000)
+#define PERF_DEFAULT_REQUEST_LENGTH     0
+#define PERF_DEFAULT_RESPONSE_LENGTH    4096
+
+//
+// Bytes queued per StreamSend, and the number of sends kept outstanding on a
+// stream.
+//
+#define PERF_IO_SIZE                    0x10000
+#define PERF_MAX_OUTSTANDING_SENDS      8
+
+#define PERF_MAX_PEER_STREAM_COUNT      8192
+
+//
+// Cap on the number of latency samples kept per run; later requests are still
+// counted.
+//
+#define PERF_MAX_LATENCY_SAMPLES        (10 * 1000 * 1000)
+
+#define PERF_SHUTDOWN_TIMEOUT_MS        10000
+
+//
+// The datapath the build uses, unless XDP is asked for.
+//
+#if defined(CXPLAT_MEMORY_DATAPATH)
+#define PERF_DEFAULT_IO                 "memory"
+#elif defined(CXPLAT_USE_IO_URING)
+#define PERF_DEFAULT_IO                 "iouring"
+#else
+#define PERF_DEFAULT_IO                 "epoll"
+#endif
+
+const MsQuicAlpn PerfAlpn("perf");
+
+uint8_t PerfIoBuffer[PERF_IO_SIZE];
+QUIC_BUFFER PerfIoChunk = { PERF_IO_SIZE, PerfIoBuffer };
+
+enum PERF_SCENARIO {
+    PERF_SCENARIO_TPUT,
+    PERF_SCENARIO_RPS,
+    PERF_SCENARIO_HPS,
+    PERF_SCENARIO_MAX_CONNS
+};
+
+const char* const PerfScenarioNames[] = { "tput", "rps", "hps", "maxconns" };
+
+struct PERF_CONFIG {
+    bool Server {false};
+    PERF_SCENARIO Scenario {PERF_SCENARIO_TPUT};
+    const char* Target {nullptr};
+    uint16_t Port {PERF_DEFAULT_PORT};
+    const char* Io {PERF_DEFAULT_IO};
+    const char* Exec {"lowlat"};
+    QUIC_EXECUTION_PROFILE Profile {QUIC_EXECUTION_PROFILE_LOW_LATENCY};
+    const char* Cc {"cubic"};
+    bool Xdp {false};
+    bool Memory {false};
+    bool Json {false};
+    uint32_t RunTimeMs {PERF_DEFAULT_RUN_TIME_MS};
+    uint32_t Iterations {1};
+    uint32_t ConnCount {PERF_DEFAULT_CONN_COUNT};
+    uint32_t StreamCount {PERF_DEFAULT_STREAM_COUNT};
+    uint32_t ParallelCount {PERF_DEFAULT_PARALLEL_COUNT};
+    uint64_t Upload {0};
+    uint64_t Download {0};
+    uint64_t Request {PERF_DEFAULT_REQUEST_LENGTH};
+    uint64_t Response {PERF_DEFAULT_RESPONSE_LENGTH};
+};
+
+PERF_CONFIG Config;
+
+//
+// Streams a prefix and a run of bytes out on a stream, keeping a bounded
+// number of sends outstanding. Only used from the stream's callback, so needs
+// no synchronization.
+//
+struct PerfSender {
+    HQUIC Stream {nullptr};
+    uint64_t Remaining {0};
+    uint32_t Outstanding {0};
+    uint8_t Prefix[sizeof(uint64_t)];
+    QUIC_BUFFER PrefixBuffer {0, nullptr};
+    QUIC_BUFFER TailBuffer {0, nullptr};
+
+    void Start(HQUIC _Stream, uint64_t Length, const uint64_t* PrefixValue = nullptr) {
+        Stream = _Stream;
+        Remaining = Length;
+        if (PrefixValue != nullptr) {
+            for (uint32_t i = 0; i < sizeof(Prefix); ++i) {
+                Prefix[i] = (uint8_t)(*PrefixValue >> (8 * (sizeof(Prefix) - 1 - i)));
+            }
+            PrefixBuffer.Buffer = Prefix;
+            PrefixBuffer.Length = sizeof(Prefix);
+            Send(&PrefixBuffer);
+        } else if (Remaining == 0) {
+            MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_GRACEFUL, 0);
+            return;
+        }
+        SendMore();
+    }
+
+    void OnSendComplete() {
+        Outstanding--;
+        SendMore();
+    }
+
+private:
+    void SendMore() {
+        while (Remaining != 0 && Outstanding < PERF_MAX_OUTSTANDING_SENDS) {
+            QUIC_BUFFER* Buffer = &PerfIoChunk;
+            if (Remaining < PERF_IO_SIZE) {
+                TailBuffer.Buffer = PerfIoBuffer;
+                TailBuffer.Length = (uint32_t)Remaining;
+                Buffer = &TailBuffer;
+            }
+            Remaining -= Buffer->Length;
+            Send(Buffer);
+        }
+    }
+
+    void Send(const QUIC_BUFFER* Buffer) {
+        Outstanding++;
+        QUIC_STATUS Status =
+            MsQuic->StreamSend(
+                Stream,
+                Buffer,
+                1,
+                Remaining == 0 ? QUIC_SEND_FLAG_FIN : QUIC_SEND_FLAG_NONE,
+                nullptr);
+        if (QUIC_FAILED(Status)) {
+            Outstanding--;
+            Remaining = 0;
+            MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_ABORT, 0);
+        }
+    }
+};
+
+//
+// Server
+//
+
+struct PerfServerStream {
+    PerfSender Sender;
+    uint64_t ResponseLength {0};
+    uint32_t PrefixReceived {0};
+};
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_STREAM_CALLBACK)
+QUIC_STATUS
+QUIC_API
+PerfServerStreamCallback(
+    _In_ HQUIC Stream,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_STREAM_EVENT* Event
+    )
+{
+    auto ServerStream = (PerfServerStream*)Context;
+    switch (Event->Type) {
+    case QUIC_STREAM_EVENT_RECEIVE:
+        for (uint32_t i = 0;
+             i < Event->RECEIVE.BufferCount && ServerStream->PrefixReceived < sizeof(uint64_t);
+             ++i) {
+            const QUIC_BUFFER* Buffer = &Event->RECEIVE.Buffers[i];
+            for (uint32_t j = 0;
+                 j < Buffer->Length && ServerStream->PrefixReceived < sizeof(uint64_t);
+                 ++j) {
+                ServerStream->ResponseLength =
+                    (ServerStream->ResponseLength << 8) | Buffer->Buffer[j];
+                ServerStream->PrefixReceived++;
+            }
+        }
+        break;
+    case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
+        if (ServerStream->PrefixReceived < sizeof(uint64_t)) {
+            MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_ABORT, 0);
+        } else {
+            ServerStream->Sender.Start(Stream, ServerStream->ResponseLength);
+        }
+        break;
+    case QUIC_STREAM_EVENT_SEND_COMPLETE:
+        ServerStream->Sender.OnSendComplete();
+        break;
+    case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
+    case QUIC_STREAM_EVENT_PEER_RECEIVE_ABORTED:
+        MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_ABORT, 0);
+        break;
+    case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE:
+        delete ServerStream;
+        MsQuic->StreamClose(Stream);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_CONNECTION_CALLBACK)
+QUIC_STATUS
+QUIC_API
+PerfServerConnectionCallback(
+    _In_ HQUIC Connection,
+    _In_opt_ void* /* Context */,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    )
+{
+    switch (Event->Type) {
+    case QUIC_CONNECTION_EVENT_PEER_STREAM_STARTED: {
+        auto ServerStream = new(std::nothrow) PerfServerStream;
+        if (ServerStream == nullptr) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        MsQuic->SetCallbackHandler(
+            Event->PEER_STREAM_STARTED.Stream,
+            (void*)PerfServerStreamCallback,
+            ServerStream);
+        break;
+    }
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+        MsQuic->ConnectionClose(Connection);
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_LISTENER_CALLBACK)
+QUIC_STATUS
+QUIC_API
+PerfListenerCallback(
+    _In_ HQUIC /* Listener */,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_LISTENER_EVENT* Event
+    )
+{
+    if (Event->Type != QUIC_LISTENER_EVENT_NEW_CONNECTION) {
+        return QUIC_STATUS_SUCCESS;
+    }
+    HQUIC Connection = Event->NEW_CONNECTION.Connection;
+    MsQuic->SetCallbackHandler(Connection, (void*)PerfServerConnectionCallback, nullptr);
+    return MsQuic->ConnectionSetConfiguration(Connection, (HQUIC)Context);
+}
+
+struct PerfServer {
+    HQUIC Configuration {nullptr};
+    HQUIC Listener {nullptr};
+};
+
+void
+PerfServerStop(
+    _In_ const MsQuicRegistration& Registration,
+    _Inout_ PerfServer* Server
+    )
+{
+    if (Server->Listener != nullptr) {
+        MsQuic->ListenerClose(Server->Listener);
+        Server->Listener = nullptr;
+    }
+    MsQuic->RegistrationShutdown(Registration, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    if (Server->Configuration != nullptr) {
+        FreeServerConfiguration(MsQuic, Server->Configuration);
+        Server->Configuration = nullptr;
+    }
+}
+
+bool
+PerfServerStart(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_ const MsQuicRegistration& Registration,
+    _In_ const MsQuicSettings& Settings,
+    _Out_ PerfServer* Server
+    )
+{
+    Server->Listener = nullptr;
+    Server->Configuration =
+        GetServerConfigurationFromArgs(
+            argc,
+            argv,
+            MsQuic,
+            Registration,
+            PerfAlpn,
+            PerfAlpn.Length(),
+            &Settings,
+            sizeof(Settings));
+    if (Server->Configuration == nullptr) {
+        printf("Failed to load the server certificate (use -cert_file:/-cert_key: or -selfsign).\n");
+        return false;
+    }
+
+    QUIC_ADDR Address;
+    QuicAddrSetFamily(&Address, QUIC_ADDRESS_FAMILY_UNSPEC);
+    QuicAddrSetPort(&Address, Config.Port);
+
+    QUIC_STATUS Status =
+        MsQuic->ListenerOpen(
+            Registration, PerfListenerCallback, Server->Configuration, &Server->Listener);
+    if (QUIC_FAILED(Status)) {
+        printf("ListenerOpen failed, 0x%x\n", Status);
+        PerfServerStop(Registration, Server);
+        return false;
+    }
+    Status = MsQuic->ListenerStart(Server->Listener, PerfAlpn, PerfAlpn.Length(), &Address);
+    if (QUIC_FAILED(Status)) {
+        printf("ListenerStart failed, 0x%x\n", Status);
+        PerfServerStop(Registration, Server);
+        return false;
+    }
+    return true;
+}
+
+int
+PerfRunServer(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[],
+    _In_ const MsQuicRegistration& Registration,
+    _In_ const MsQuicSettings& Settings
+    )
+{
+    PerfServer Server;
+    if (!PerfServerStart(argc, argv, Registration, Settings, &Server)) {
+        return 1;
+    }
+
+    //
+    // Serve until the run time passes, if one was given, or until Enter is
+    // pressed.
+    //
+    if (TryGetValue(argc, argv, "run", &Config.RunTimeMs)) {
+        CxPlatSleep(Config.RunTimeMs);
+    } else {
+        printf("Listening on port %hu. Press Enter to exit.\n", Config.Port);
+        (void)getchar();
+    }
+
+    PerfServerStop(Registration, &Server);
+    return 0;
+}
+
+//
+// Client
+//
+
+//
+// State shared by all connections of one iteration.
+//
+struct PerfRun {
+    HQUIC Registration {nullptr};
+    HQUIC Configuration {nullptr};
+    std::atomic<bool> Running {true};
+    uint64_t StartUs {0};
+
+    //
+    // Connections not yet shut down; Done is set when this drops to zero.
+    //
+    std::atomic<uint32_t> ActiveConnections {0};
+    CxPlatEvent Done {true};
+
+    //
+    // Connections still to be started (hps/maxconns), and completion counts.
+    //
+    std::atomic<int64_t> ConnectionsToStart {0};
+    std::atomic<uint64_t> Connected {0};
+    std::atomic<uint64_t> Failed {0};
+    std::atomic<uint64_t> Completed {0};
+    std::atomic<uint64_t> BytesSent {0};
+    std::atomic<uint64_t> BytesReceived {0};
+    std::atomic<uint64_t> LastCompletionUs {0};
+
+    //
+    // Set once every maxconns connection is either connected or failed.
+    //
+    CxPlatEvent AllConnected {true};
+
+    std::vector<uint32_t> Latencies;
+    std::atomic<uint64_t> LatencyCount {0};
+
+    void RecordLatency(uint64_t LatencyUs) {
+        uint64_t Index = LatencyCount.fetch_add(1);
+        if (Index < Latencies.size()) {
+            Latencies[(size_t)Index] = (uint32_t)CXPLAT_MIN(LatencyUs, UINT32_MAX);
+        }
+    }
+};
+
+struct PerfClientConnection {
+    PerfRun* Run;
+    HQUIC Connection {nullptr};
+    bool IsConnected {false};
+    uint32_t ActiveStreams {0};
+};
+
+struct PerfClientStream {
+    PerfClientConnection* ClientConnection;
+    PerfSender Sender;
+    uint64_t StartUs;
+    uint64_t Received {0};
+    bool ReceiveComplete {false};
+};
+
+bool PerfClientStartConnection(PerfRun* Run);
+void PerfClientStartStream(PerfClientConnection* ClientConnection);
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_STREAM_CALLBACK)
+QUIC_STATUS
+QUIC_API
+PerfClientStreamCallback(
+    _In_ HQUIC Stream,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_STREAM_EVENT* Event
+    )
+{
+    auto ClientStream = (PerfClientStream*)Context;
+    auto ClientConnection = ClientStream->ClientConnection;
+    auto Run = ClientConnection->Run;
+    switch (Event->Type) {
+    case QUIC_STREAM_EVENT_RECEIVE:
+        ClientStream->Received += Event->RECEIVE.TotalBufferLength;
+        break;
+    case QUIC_STREAM_EVENT_PEER_SEND_SHUTDOWN:
+        ClientStream->ReceiveComplete = true;
+        break;
+    case QUIC_STREAM_EVENT_SEND_COMPLETE:
+        ClientStream->Sender.OnSendComplete();
+        break;
+    case QUIC_STREAM_EVENT_PEER_SEND_ABORTED:
+    case QUIC_STREAM_EVENT_PEER_RECEIVE_ABORTED:
+        MsQuic->StreamShutdown(Stream, QUIC_STREAM_SHUTDOWN_FLAG_ABORT, 0);
+        break;
+    case QUIC_STREAM_EVENT_SHUTDOWN_COMPLETE: {
+        uint64_t NowUs = CxPlatTimeUs64();
+        if (ClientStream->ReceiveComplete &&
+            !Event->SHUTDOWN_COMPLETE.ConnectionShutdown) {
+            if (Config.Scenario == PERF_SCENARIO_RPS) {
+                if (Run->Running) {
+                    Run->Completed++;
+                    Run->RecordLatency(CxPlatTimeDiff64(ClientStream->StartUs, NowUs));
+                }
+            } else {
+                Run->Completed++;
+                Run->BytesSent += Config.Upload;
+                Run->BytesReceived += ClientStream->Received;
+                Run->LastCompletionUs = NowUs;
+            }
+        } else {
+            Run->Failed++;
+        }
+        MsQuic->StreamClose(Stream);
+        delete ClientStream;
+
+        ClientConnection->ActiveStreams--;
+        if (Config.Scenario == PERF_SCENARIO_RPS && Run->Running) {
+            PerfClientStartStream(ClientConnection);
+        }
+        if (ClientConnection->ActiveStreams == 0) {
+            MsQuic->ConnectionShutdown(
+                ClientConnection->Connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+void
+PerfClientStartStream(
+    _In_ PerfClientConnection* ClientConnection
+    )
+{
+    auto ClientStream = new(std::nothrow) PerfClientStream;
+    if (ClientStream == nullptr) {
+        return;
+    }
+    ClientStream->ClientConnection = ClientConnection;
+
+    HQUIC Stream = nullptr;
+    if (QUIC_FAILED(
+        MsQuic->StreamOpen(
+            ClientConnection->Connection,
+            QUIC_STREAM_OPEN_FLAG_NONE,
+            PerfClientStreamCallback,
+            ClientStream,
+            &Stream))) {
+        delete ClientStream;
+        return;
+    }
+    if (QUIC_FAILED(MsQuic->StreamStart(Stream, QUIC_STREAM_START_FLAG_NONE))) {
+        MsQuic->StreamClose(Stream);
+        delete ClientStream;
+        return;
+    }
+
+    ClientConnection->ActiveStreams++;
+    ClientStream->StartUs = CxPlatTimeUs64();
+    if (Config.Scenario == PERF_SCENARIO_RPS) {
+        ClientStream->Sender.Start(Stream, Config.Request, &Config.Response);
+    } else {
+        ClientStream->Sender.Start(Stream, Config.Upload, &Config.Download);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(QUIC_CONNECTION_CALLBACK)
+QUIC_STATUS
+QUIC_API
+PerfClientConnectionCallback(
+    _In_ HQUIC Connection,
+    _In_opt_ void* Context,
+    _Inout_ QUIC_CONNECTION_EVENT* Event
+    )
+{
+    auto ClientConnection = (PerfClientConnection*)Context;
+    auto Run = ClientConnection->Run;
+    switch (Event->Type) {
+    case QUIC_CONNECTION_EVENT_CONNECTED:
+        ClientConnection->IsConnected = true;
+        switch (Config.Scenario) {
+        case PERF_SCENARIO_TPUT:
+        case PERF_SCENARIO_RPS:
+            for (uint32_t i = 0; i < Config.StreamCount; ++i) {
+                PerfClientStartStream(ClientConnection);
+            }
+            if (ClientConnection->ActiveStreams == 0) {
+                MsQuic->ConnectionShutdown(Connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+            }
+            break;
+        case PERF_SCENARIO_HPS:
+            if (Run->Running) {
+                Run->Completed++;
+            }
+            MsQuic->ConnectionShutdown(Connection, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+            break;
+        case PERF_SCENARIO_MAX_CONNS:
+            if (++Run->Connected + Run->Failed == Config.ConnCount) {
+                Run->LastCompletionUs = CxPlatTimeUs64();
+                Run->AllConnected.Set();
+            }
+            PerfClientStartConnection(Run);
+            break;
+        }
+        break;
+    case QUIC_CONNECTION_EVENT_SHUTDOWN_COMPLETE:
+        if (!ClientConnection->IsConnected) {
+            if (Config.Scenario == PERF_SCENARIO_MAX_CONNS) {
+                if (Run->Connected + ++Run->Failed == Config.ConnCount) {
+                    Run->LastCompletionUs = CxPlatTimeUs64();
+                    Run->AllConnected.Set();
+                }
+            } else {
+                Run->Failed++;
+            }
+        }
+        MsQuic->ConnectionClose(Connection);
+        delete ClientConnection;
+
+        if (Config.Scenario == PERF_SCENARIO_HPS ||
+            Config.Scenario == PERF_SCENARIO_MAX_CONNS) {
+            PerfClientStartConnection(Run);
+        }
+        if (--Run->ActiveConnections == 0) {
+            Run->Done.Set();
+        }
+        break;
+    default:
+        break;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Starts another connection if the run still needs one. Returns false if none
+// was started.
+//
+bool
+PerfClientStartConnection(
+    _In_ PerfRun* Run
+    )
+{
+    if (!Run->Running || --Run->ConnectionsToStart < 0) {
+        return false;
+    }
+
+    auto ClientConnection = new(std::nothrow) PerfClientConnection;
+    if (ClientConnection == nullptr) {
+        return false;
+    }
+    ClientConnection->Run = Run;
+
+    Run->ActiveConnections++;
+    QUIC_STATUS Status =
+        MsQuic->ConnectionOpen(
+            Run->Registration,
+            PerfClientConnectionCallback,
+            ClientConnection,
+            &ClientConnection->Connection);
+    if (QUIC_FAILED(Status)) {
+        delete ClientConnection;
+        Run->Failed++;
+        if (--Run->ActiveConnections == 0) {
+            Run->Done.Set();
+        }
+        return false;
+    }
+
+    //
+    // On failure the connection still completes shutdown, which cleans up.
+    //
+    (void)MsQuic->ConnectionStart(
+        ClientConnection->Connection,
+        Run->Configuration,
+        QUIC_ADDRESS_FAMILY_UNSPEC,
+        Config.Target,
+        Config.Port);
+    return true;
+}
+
+uint32_t
+PerfPercentile(
+    _In_ const std::vector<uint32_t>& Sorted,
+    _In_ double Percentile
+    )
+{
+    if (Sorted.empty()) {
+        return 0;
+    }
+    size_t Index = (size_t)(Percentile / 100.0 * (double)(Sorted.size() - 1));
+    return Sorted[Index];
+}
+
+void
+PerfReport(
+    _In_ uint32_t Iteration,
+    _In_ PerfRun& Run,
+    _In_ uint64_t ElapsedUs
+    )
+{
+    if (ElapsedUs == 0) {
+        ElapsedUs = 1;
+    }
+
+    const char* Scenario = PerfScenarioNames[Config.Scenario];
+    if (Config.Json) {
+        printf("{\"scenario\":\"%s\",\"io\":\"%s\",\"exec\":\"%s\",\"cc\":\"%s\","
+               "\"iteration\":%u,\"conns\":%u,\"streams\":%u,\"elapsed_us\":%llu,"
+               "\"failed\":%llu",
+            Scenario, Config.Io, Config.Exec, Config.Cc, Iteration,
+            Config.ConnCount, Config.StreamCount,
+            (unsigned long long)ElapsedUs, (unsigned long long)Run.Failed.load());
+    } else {
+        printf("[%s] iteration %u: ", Scenario, Iteration);
+    }
+
+    switch (Config.Scenario) {
+    case PERF_SCENARIO_TPUT: {
+        uint64_t UploadKbps = Run.BytesSent * 8 * 1000 / ElapsedUs;
+        uint64_t DownloadKbps = Run.BytesReceived * 8 * 1000 / ElapsedUs;
+        if (Config.Json) {
+            printf(",\"upload_bytes\":%llu,\"download_bytes\":%llu,"
+                   "\"upload_kbps\":%llu,\"download_kbps\":%llu",
+                (unsigned long long)Run.BytesSent.load(),
+                (unsigned long long)Run.BytesReceived.load(),
+                (unsigned long long)UploadKbps, (unsigned long long)DownloadKbps);
+        } else {
+            printf("upload %llu kbps, download %llu kbps in %llu ms",
+                (unsigned long long)UploadKbps, (unsigned long long)DownloadKbps,
+                (unsigned long long)(ElapsedUs / 1000));
+        }
+        break;
+    }
+    case PERF_SCENARIO_RPS: {
+        uint64_t Count = Run.Completed;
+        uint64_t Rps = Count * 1000000 / ElapsedUs;
+        size_t Samples = (size_t)CXPLAT_MIN(Run.LatencyCount.load(), (uint64_t)Run.Latencies.size());
+        std::vector<uint32_t> Sorted(Run.Latencies.begin(), Run.Latencies.begin() + Samples);
+        std::sort(Sorted.begin(), Sorted.end());
+        uint32_t P50 = PerfPercentile(Sorted, 50);
+        uint32_t P90 = PerfPercentile(Sorted, 90);
+        uint32_t P99 = PerfPercentile(Sorted, 99);
+        uint32_t P999 = PerfPercentile(Sorted, 99.9);
+        uint32_t Max = Sorted.empty() ? 0 : Sorted.back();
+        if (Config.Json) {
+            printf(",\"request_bytes\":%llu,\"response_bytes\":%llu,\"requests\":%llu,"
+                   "\"rps\":%llu,\"latency_us\":{\"p50\":%u,\"p90\":%u,\"p99\":%u,"
+                   "\"p99.9\":%u,\"max\":%u}",
+                (unsigned long long)Config.Request, (unsigned long long)Config.Response,
+                (unsigned long long)Count, (unsigned long long)Rps,
+                P50, P90, P99, P999, Max);
+        } else {
+            printf("%llu RPS, latency (us) p50 %u, p90 %u, p99 %u, p99.9 %u, max %u",
+                (unsigned long long)Rps, P50, P90, P99, P999, Max);
+        }
+        break;
+    }
+    case PERF_SCENARIO_HPS: {
+        uint64_t Hps = Run.Completed * 1000000 / ElapsedUs;
+        if (Config.Json) {
+            printf(",\"parallel\":%u,\"handshakes\":%llu,\"hps\":%llu",
+                Config.ParallelCount, (unsigned long long)Run.Completed.load(),
+                (unsigned long long)Hps);
+        } else {
+            printf("%llu handshakes/sec, %llu failed",
+                (unsigned long long)Hps, (unsigned long long)Run.Failed.load());
+        }
+        break;
+    }
+    case PERF_SCENARIO_MAX_CONNS:
+        if (Config.Json) {
+            printf(",\"parallel\":%u,\"connected\":%llu",
+                Config.ParallelCount, (unsigned long long)Run.Connected.load());
+        } else {
+            printf("%llu of %u connected (%llu failed) in %llu ms",
+                (unsigned long long)Run.Connected.load(), Config.ConnCount,
+                (unsigned long long)Run.Failed.load(),
+                (unsigned long long)(ElapsedUs / 1000));
+        }
+        break;
+    }
+
+    printf(Config.Json ? "}\n" : "\n");
+    fflush(stdout);
+}
+
+int
+PerfRunClientIteration(
+    _In_ uint32_t Iteration,
+    _In_ const MsQuicSettings& Settings
+    )
+{
+    //
+    // Each iteration gets its own registration, so shutting it down cleans
+    // up whatever the previous iteration left behind.
+    //
+    MsQuicRegistration Registration("secnetperf", Config.Profile, true);
+    if (!Registration.IsValid()) {
+        printf("RegistrationOpen failed, 0x%x\n", Registration.GetInitStatus());
+        return 1;
+    }
+    MsQuicCredentialConfig CredConfig(
+        QUIC_CREDENTIAL_FLAG_CLIENT | QUIC_CREDENTIAL_FLAG_NO_CERTIFICATE_VALIDATION);
+    MsQuicConfiguration Configuration(Registration, PerfAlpn, Settings, CredConfig);
+    if (!Configuration.IsValid()) {
+        printf("Configuration failed, 0x%x\n", Configuration.GetInitStatus());
+        return 1;
+    }
+
+    PerfRun Run;
+    Run.Registration = Registration;
+    Run.Configuration = Configuration;
+    if (Config.Scenario == PERF_SCENARIO_RPS) {
+        Run.Latencies.resize(PERF_MAX_LATENCY_SAMPLES);
+    }
+
+    uint32_t InitialCount = Config.ConnCount;
+    switch (Config.Scenario) {
+    case PERF_SCENARIO_TPUT:
+    case PERF_SCENARIO_RPS:
+        Run.ConnectionsToStart = Config.ConnCount;
+        break;
+    case PERF_SCENARIO_HPS:
+        Run.ConnectionsToStart = INT64_MAX;
+        InitialCount = Config.ParallelCount;
+        break;
+    case PERF_SCENARIO_MAX_CONNS:
+        Run.ConnectionsToStart = Config.ConnCount;
+        InitialCount = CXPLAT_MIN(Config.ParallelCount, Config.ConnCount);
+        break;
+    }
+
+    //
+    // Hold a reference on ActiveConnections while starting, so Done isn't set
+    // before every initial connection is started.
+    //
+    Run.ActiveConnections++;
+    Run.StartUs = CxPlatTimeUs64();
+    for (uint32_t i = 0; i < InitialCount; ++i) {
+        PerfClientStartConnection(&Run);
+    }
+    if (--Run.ActiveConnections == 0) {
+        Run.Done.Set();
+    }
+
+    uint64_t ElapsedUs = 0;
+    switch (Config.Scenario) {
+    case PERF_SCENARIO_TPUT:
+        //
+        // Runs until every stream has finished. The time includes the
+        // handshakes.
+        //
+        Run.Done.WaitForever();
+        if (Run.LastCompletionUs == 0) {
+            Run.LastCompletionUs = CxPlatTimeUs64();
+        }
+        ElapsedUs = CxPlatTimeDiff64(Run.StartUs, Run.LastCompletionUs);
+        break;
+    case PERF_SCENARIO_RPS:
+    case PERF_SCENARIO_HPS:
+        CxPlatSleep(Config.RunTimeMs);
+        Run.Running = false;
+        ElapsedUs = CxPlatTimeDiff64(Run.StartUs, CxPlatTimeUs64());
+        break;
+    case PERF_SCENARIO_MAX_CONNS:
+        if (!Run.AllConnected.WaitTimeout(Config.RunTimeMs)) {
+            Run.LastCompletionUs = CxPlatTimeUs64();
+        }
+        Run.Running = false;
+        ElapsedUs = CxPlatTimeDiff64(Run.StartUs, Run.LastCompletionUs);
+        break;
+    }
+
+    PerfReport(Iteration, Run, ElapsedUs);
+
+    Run.Running = false;
+    MsQuic->RegistrationShutdown(Registration, QUIC_CONNECTION_SHUTDOWN_FLAG_NONE, 0);
+    if (!Run.Done.WaitTimeout(PERF_SHUTDOWN_TIMEOUT_MS)) {
+        MsQuic->RegistrationShutdown(Registration, QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT, 0);
+        Run.Done.WaitForever();
+    }
+    return 0;
+}
+
+void
+PrintUsage()
+{
+    printf(
+        "Usage:\n"
+        "  secnetperf -server (-cert_file:<path> -cert_key:<path> | -selfsign) [options]\n"
+        "  secnetperf -target:<name> [-scenario:<tput|rps|hps|maxconns>] [options]\n"
+        "  secnetperf -io:memory (-cert_file:<path> -cert_key:<path> | -selfsign)\n"
+        "             [-scenario:<tput|rps|hps|maxconns>] [options]\n"
+        "\n"
+        "Common options:\n"
+        "  -port:<n>          UDP port (default %u)\n"
+        "  -io:<epoll|iouring|xdp|memory>\n"
+        "                     Datapath (default %s). epoll, io_uring and memory are\n"
+        "                     chosen at build time (QUIC_LINUX_IOURING_ENABLED,\n"
+        "                     QUIC_LINUX_MEMORY_DATAPATH); this checks it matches.\n"
+        "                     memory runs the server in the same process, with\n"
+        "                     the link configured by MSQUIC_MEMORY_DATAPATH_*.\n"
+        "  -exec:<lowlat|maxtput|scavenger|realtime>\n"
+        "                     Execution profile (default lowlat)\n"
+        "  -cc:<cubic|bbr>    Congestion control (default cubic)\n"
+        "  -run:<ms>          Run time for rps/hps, timeout for maxconns,\n"
+        "                     server lifetime (default %u)\n"
+        "\n"
+        "Client options:\n"
+        "  -up:<bytes> -down:<bytes>\n"
+        "                     tput bytes per stream (default: %llu down)\n"
+        "  -request:<bytes> -response:<bytes>\n"
+        "                     rps sizes (default %u/%u)\n"
+        "  -conns:<n>         Connections (default %u; maxconns: %u)\n"
+        "  -streams:<n>       Parallel streams per connection (default %u)\n"
+        "  -parallel:<n>      Handshakes in flight for hps/maxconns (default %u)\n"
+        "  -iterations:<n>    Number of runs (default 1)\n"
+        "  -format:<text|json>\n"
+        "                     Output format; json writes one object per run\n",
+        PERF_DEFAULT_PORT, PERF_DEFAULT_IO, PERF_DEFAULT_RUN_TIME_MS,
+        (unsigned long long)PERF_DEFAULT_BULK_LENGTH,
+        PERF_DEFAULT_REQUEST_LENGTH, PERF_DEFAULT_RESPONSE_LENGTH,
+        PERF_DEFAULT_CONN_COUNT, PERF_DEFAULT_MAX_CONN_COUNT,
+        PERF_DEFAULT_STREAM_COUNT, PERF_DEFAULT_PARALLEL_COUNT);
+}
+
+bool
+ParseArgs(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    Config.Server = GetFlag(argc, argv, "server");
+    Config.Target = GetValue(argc, argv, "target");
+
+    const char* Value;
+    if ((Value = GetValue(argc, argv, "scenario")) != nullptr) {
+        uint32_t i = 0;
+        for (; i < ARRAYSIZE(PerfScenarioNames); ++i) {
+            if (strcmp(Value, PerfScenarioNames[i]) == 0) {
+                Config.Scenario = (PERF_SCENARIO)i;
+                break;
+            }
+        }
+        if (i == ARRAYSIZE(PerfScenarioNames)) {
+            printf("Unknown scenario '%s'\n", Value);
+            return false;
+        }
+    }
+
+    if ((Value = GetValue(argc, argv, "io")) != nullptr) {
+        Config.Io = Value;
+    }
+    if (strcmp(Config.Io, "xdp") == 0) {
+#ifndef CXPLAT_LINUX_XDP_ENABLED
+        printf("XDP requested, but built without QUIC_LINUX_XDP_ENABLED\n");
+        return false;
+#endif
+        Config.Xdp = true;
+    } else if (strcmp(Config.Io, "iouring") == 0) {
+#if !defined(CXPLAT_USE_IO_URING) || defined(CXPLAT_MEMORY_DATAPATH)
+        printf("io_uring requested, but not built with (only) QUIC_LINUX_IOURING_ENABLED\n");
+        return false;
+#endif
+    } else if (strcmp(Config.Io, "epoll") == 0) {
+#if defined(CXPLAT_USE_IO_URING) || defined(CXPLAT_MEMORY_DATAPATH)
+        printf("epoll requested, but built with QUIC_LINUX_IOURING_ENABLED or QUIC_LINUX_MEMORY_DATAPATH\n");
+        return false;
+#endif
+    } else if (strcmp(Config.Io, "memory") == 0) {
+#ifndef CXPLAT_MEMORY_DATAPATH
+        printf("memory requested, but built without QUIC_LINUX_MEMORY_DATAPATH\n");
+        return false;
+#endif
+        if (Config.Server) {
+            printf("-io:memory runs the server in the client's process; drop -server\n");
+            return false;
+        }
+        Config.Memory = true;
+        if (Config.Target == nullptr) {
+            Config.Target = "localhost";
+        }
+    } else {
+        printf("Unknown io '%s'\n", Config.Io);
+        return false;
+    }
+
+    if (!Config.Server && Config.Target == nullptr) {
+        return false;
+    }
+
+    if ((Value = GetValue(argc, argv, "exec")) != nullptr) {
+        Config.Exec = Value;
+        if (strcmp(Value, "lowlat") == 0) {
+            Config.Profile = QUIC_EXECUTION_PROFILE_LOW_LATENCY;
+        } else if (strcmp(Value, "maxtput") == 0) {
+            Config.Profile = QUIC_EXECUTION_PROFILE_TYPE_MAX_THROUGHPUT;
+        } else if (strcmp(Value, "scavenger") == 0) {
+            Config.Profile = QUIC_EXECUTION_PROFILE_TYPE_SCAVENGER;
+        } else if (strcmp(Value, "realtime") == 0) {
+            Config.Profile = QUIC_EXECUTION_PROFILE_TYPE_REAL_TIME;
+        } else {
+            printf("Unknown execution profile '%s'\n", Value);
+            return false;
+        }
+    }
+
+    if ((Value = GetValue(argc, argv, "cc")) != nullptr) {
+        if (strcmp(Value, "cubic") != 0 && strcmp(Value, "bbr") != 0) {
+            printf("Unknown congestion control '%s'\n", Value);
+            return false;
+        }
+        Config.Cc = Value;
+    }
+
+    if ((Value = GetValue(argc, argv, "format")) != nullptr) {
+        if (strcmp(Value, "json") == 0) {
+            Config.Json = true;
+        } else if (strcmp(Value, "text") != 0) {
+            printf("Unknown format '%s'\n", Value);
+            return false;
+        }
+    }
+
+    if (Config.Scenario == PERF_SCENARIO_MAX_CONNS) {
+        Config.ConnCount = PERF_DEFAULT_MAX_CONN_COUNT;
+    }
+    TryGetValue(argc, argv, "port", &Config.Port);
+    TryGetValue(argc, argv, "run", &Config.RunTimeMs);
+    TryGetValue(argc, argv, "iterations", &Config.Iterations);
+    TryGetValue(argc, argv, "conns", &Config.ConnCount);
+    TryGetValue(argc, argv, "streams", &Config.StreamCount);
+    TryGetValue(argc, argv, "parallel", &Config.ParallelCount);
+    TryGetValue(argc, argv, "request", &Config.Request);
+    TryGetValue(argc, argv, "response", &Config.Response);
+    bool HasUpload = TryGetValue(argc, argv, "up", &Config.Upload);
+    bool HasDownload = TryGetValue(argc, argv, "down", &Config.Download);
+    if (!HasUpload && !HasDownload) {
+        Config.Download = PERF_DEFAULT_BULK_LENGTH;
+    }
+
+    if (Config.ConnCount == 0 || Config.StreamCount == 0 ||
+        Config.ParallelCount == 0 || Config.Iterations == 0 ||
+        Config.StreamCount > PERF_MAX_PEER_STREAM_COUNT) {
+        printf("Counts must be non-zero, and -streams at most %u\n", PERF_MAX_PEER_STREAM_COUNT);
+        return false;
+    }
+    return true;
+}
+
+int
+QUIC_MAIN_EXPORT
+main(
+    _In_ int argc,
+    _In_reads_(argc) _Null_terminated_ char* argv[]
+    )
+{
+    if (GetFlag(argc, argv, "help") || GetFlag(argc, argv, "?") || !ParseArgs(argc, argv)) {
+        PrintUsage();
+        return 1;
+    }
+
+    CxPlatSystemLoad();
+    if (QUIC_FAILED(CxPlatInitialize())) {
+        CxPlatSystemUnload();
+        return 1;
+    }
+
+    int Result = 1;
+    MsQuicApi* Api = new(std::nothrow) MsQuicApi;
+    if (Api == nullptr || QUIC_FAILED(Api->GetInitStatus())) {
+        printf("MsQuicOpen2 failed, 0x%x\n", Api ? Api->GetInitStatus() : QUIC_STATUS_OUT_OF_MEMORY);
+    } else {
+        MsQuic = Api;
+
+        MsQuicSettings Settings;
+        Settings.SetCongestionControlAlgorithm(
+            strcmp(Config.Cc, "bbr") == 0 ?
+                QUIC_CONGESTION_CONTROL_ALGORITHM_BBR :
+                QUIC_CONGESTION_CONTROL_ALGORITHM_CUBIC);
+        if (Config.Xdp) {
+            Settings.SetXdpEnabled(true);
+        }
+
+        if (Config.Server) {
+            Settings.SetPeerBidiStreamCount(PERF_MAX_PEER_STREAM_COUNT);
+            MsQuicRegistration Registration("secnetperf", Config.Profile, true);
+            if (!Registration.IsValid()) {
+                printf("RegistrationOpen failed, 0x%x\n", Registration.GetInitStatus());
+            } else {
+                Result = PerfRunServer(argc, argv, Registration, Settings);
+            }
+        } else if (Config.Memory) {
+            //
+            // The server runs alongside the client, in its own registration.
+            //
+            MsQuicSettings ServerSettings = Settings;
+            ServerSettings.SetPeerBidiStreamCount(PERF_MAX_PEER_STREAM_COUNT);
+            MsQuicRegistration ServerRegistration("secnetperf-server", Config.Profile, true);
+            PerfServer Server;
+            if (!ServerRegistration.IsValid()) {
+                printf("RegistrationOpen failed, 0x%x\n", ServerRegistration.GetInitStatus());
+            } else if (PerfServerStart(argc, argv, ServerRegistration, ServerSettings, &Server)) {
+                Result = 0;
+                for (uint32_t i = 0; i < Config.Iterations && Result == 0; ++i) {
+                    Result = PerfRunClientIteration(i, Settings);
+                }
+                PerfServerStop(ServerRegistration, &Server);
+            }
+        } else {
+            Result = 0;
+            for (uint32_t i = 0; i < Config.Iterations && Result == 0; ++i) {
+                Result = PerfRunClientIteration(i, Settings);
+            }
+        }
+    }
+    MsQuic = nullptr;
+    delete Api;
+
+    CxPlatUninitialize();
+    CxPlatSystemUnload();
+    return Result;
+}
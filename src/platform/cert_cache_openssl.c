@@ -0,0 +1,143 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Caches peer certificates that passed OpenSSL chain validation, for the
+    OpenSSL based TLS implementations.
+
+    The cache is direct mapped on a SHA-256 fingerprint of the leaf
+    certificate and the SNI. A hit means the exact same certificate was
+    validated, to a trusted root, for the same server name shortly before.
+    The TLS handshake still proves the peer holds its private key.
+
+--*/
+
+#include "platform_internal.h"
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable:4100) // Unreferenced parameter errcode in inline function
+#endif
+#include "openssl/evp.h"
+#include "openssl/x509.h"
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+
+void
+CxPlatCertCacheInitialize(
+    _Out_ CXPLAT_CERT_CACHE* Cache
+    )
+{
+    CxPlatZeroMemory(Cache, sizeof(*Cache));
+    CxPlatLockInitialize(&Cache->Lock);
+}
+
+void
+CxPlatCertCacheUninitialize(
+    _In_ CXPLAT_CERT_CACHE* Cache
+    )
+{
+    CxPlatLockUninitialize(&Cache->Lock);
+}
+
+static
+BOOLEAN
+CxPlatCertCacheFingerprint(
+    _In_ X509* Cert,
+    _In_opt_z_ const char* SNI,
+    _Out_writes_all_(CXPLAT_HASH_SHA256_SIZE) uint8_t* Fingerprint
+    )
+{
+    unsigned char* CertBuffer = NULL;
+    const int CertLength = i2d_X509(Cert, &CertBuffer);
+    if (CertLength <= 0) {
+        return FALSE;
+    }
+
+    BOOLEAN Result = FALSE;
+    unsigned int FingerprintLength = CXPLAT_HASH_SHA256_SIZE;
+    EVP_MD_CTX* Ctx = EVP_MD_CTX_new();
+    if (Ctx != NULL &&
+        EVP_DigestInit_ex(Ctx, EVP_sha256(), NULL) == 1 &&
+        EVP_DigestUpdate(Ctx, CertBuffer, (size_t)CertLength) == 1 &&
+        (SNI == NULL || EVP_DigestUpdate(Ctx, SNI, strlen(SNI) + 1) == 1) &&
+        EVP_DigestFinal_ex(Ctx, Fingerprint, &FingerprintLength) == 1) {
+        Result = TRUE;
+    }
+
+    EVP_MD_CTX_free(Ctx);
+    OPENSSL_free(CertBuffer);
+    return Result;
+}
+
+//
+// How long (in us) the validated chain may be cached: the TTL, cut short by
+// the earliest expiring certificate.
+//
+static
+uint64_t
+CxPlatCertCacheLifetime(
+    _In_ X509_STORE_CTX* X509Ctx
+    )
+{
+    uint64_t LifetimeUs = CXPLAT_CERT_CACHE_TTL_US;
+    STACK_OF(X509)* Chain = X509_STORE_CTX_get0_chain(X509Ctx);
+    const int ChainCount = sk_X509_num(Chain);
+    for (int i = 0; i < ChainCount; ++i) {
+        int Days, Seconds;
+        if (!ASN1_TIME_diff(&Days, &Seconds, NULL, X509_get0_notAfter(sk_X509_value(Chain, i)))) {
+            return 0;
+        }
+        const int64_t RemainingSeconds = (int64_t)Days * 24 * 60 * 60 + Seconds;
+        if (RemainingSeconds <= 0) {
+            return 0;
+        }
+        if ((uint64_t)RemainingSeconds * 1000 * 1000 < LifetimeUs) {
+            LifetimeUs = (uint64_t)RemainingSeconds * 1000 * 1000;
+        }
+    }
+    return LifetimeUs;
+}
+
+int
+CxPlatCertCacheVerify(
+    _In_ CXPLAT_CERT_CACHE* Cache,
+    _In_ X509_STORE_CTX* X509Ctx,
+    _In_opt_z_ const char* SNI
+    )
+{
+    uint8_t Fingerprint[CXPLAT_HASH_SHA256_SIZE];
+    X509* Cert = X509_STORE_CTX_get0_cert(X509Ctx);
+    if (Cert == NULL || !CxPlatCertCacheFingerprint(Cert, SNI, Fingerprint)) {
+        return X509_verify_cert(X509Ctx);
+    }
+
+    CXPLAT_CERT_CACHE_ENTRY* Entry =
+        &Cache->Entries[
+            CxPlatHashSimple(sizeof(Fingerprint), Fingerprint) & (CXPLAT_CERT_CACHE_SIZE - 1)];
+
+    CxPlatLockAcquire(&Cache->Lock);
+    const BOOLEAN Hit =
+        Entry->ExpiryUs != 0 &&
+        CxPlatTimeUs64() < Entry->ExpiryUs &&
+        memcmp(Entry->Fingerprint, Fingerprint, sizeof(Fingerprint)) == 0;
+    CxPlatLockRelease(&Cache->Lock);
+    if (Hit) {
+        return 1;
+    }
+
+    const int Result = X509_verify_cert(X509Ctx);
+    if (Result > 0) {
+        const uint64_t LifetimeUs = CxPlatCertCacheLifetime(X509Ctx);
+        if (LifetimeUs != 0) {
+            CxPlatLockAcquire(&Cache->Lock);
+            Entry->ExpiryUs = CxPlatTimeUs64() + LifetimeUs;
+            CxPlatCopyMemory(Entry->Fingerprint, Fingerprint, sizeof(Fingerprint));
+            CxPlatLockRelease(&Cache->Lock);
+        }
+    }
+    return Result;
+}
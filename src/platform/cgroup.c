@@ -7,7 +7,7 @@
 
 Abstract:
 
-    Read the memory limit for the current process
+    Read the memory and CPU limits for the current process
 
 Environment:
 
@@ -21,6 +21,7 @@ Environment:
 
 #include "quic_platform.h"
 #include <stdint.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,6 +46,12 @@ Environment:
 #define PROC_CGROUP_FILENAME "/proc/self/cgroup"
 #define CGROUP1_MEMORY_LIMIT_FILENAME "/memory.limit_in_bytes"
 #define CGROUP2_MEMORY_LIMIT_FILENAME "/memory.max"
+#define CGROUP1_CPU_QUOTA_FILENAME "/cpu.cfs_quota_us"
+#define CGROUP1_CPU_PERIOD_FILENAME "/cpu.cfs_period_us"
+#define CGROUP2_CPU_MAX_FILENAME "/cpu.max"
+#define CGROUP1_CPUSET_EFFECTIVE_FILENAME "/cpuset.effective_cpus"
+#define CGROUP1_CPUSET_FILENAME "/cpuset.cpus"
+#define CGROUP2_CPUSET_EFFECTIVE_FILENAME "/cpuset.cpus.effective"
 
 static int CGroupVersion = 0;
 static char* CGroupMemoryPath = NULL;
@@ -128,6 +135,26 @@ IsCGroup1MemorySubsystem(
     return strcmp("memory", strTok) == 0;
 }
 
+static
+_Success_(return != FALSE)
+BOOLEAN
+IsCGroup1CpuSubsystem(
+    _In_z_ const char *strTok
+    )
+{
+    return strcmp("cpu", strTok) == 0;
+}
+
+static
+_Success_(return != FALSE)
+BOOLEAN
+IsCGroup1CpusetSubsystem(
+    _In_z_ const char *strTok
+    )
+{
+    return strcmp("cpuset", strTok) == 0;
+}
+
 static
 _Success_(return == 1 || return == 2)
 int
@@ -571,3 +598,210 @@ Done:
 
     return PhysicalMemoryLimit;
 }
+
+//
+// Returns the first line of a file in the given cgroup directory, which the
+// caller frees, or NULL if it can't be read.
+//
+static
+_Success_(return != NULL)
+char*
+ReadCGroupLine(
+    _In_z_ const char* CGroupPath,
+    _In_z_ const char* Filename
+    )
+{
+    char* FullFilename = NULL;
+    if (asprintf(&FullFilename, "%s%s", CGroupPath, Filename) < 0) {
+        return NULL;
+    }
+
+    char* Line = NULL;
+    size_t LineLen = 0;
+    FILE* File = fopen(FullFilename, "r");
+    free(FullFilename);
+    if (File == NULL) {
+        return NULL;
+    }
+
+    if (getline(&Line, &LineLen, File) == -1) {
+        free(Line);
+        Line = NULL;
+    }
+    fclose(File);
+    return Line;
+}
+
+//
+// Returns the number of CPUs the cgroup's CPU quota amounts to, rounded up,
+// or 0 if there is no quota.
+//
+static
+uint32_t
+GetCGroupCpuQuotaCount(
+    void
+    )
+{
+    char* CGroupPath =
+        FindCGroupPath(CGroupVersion == 1 ? &IsCGroup1CpuSubsystem : NULL);
+    if (CGroupPath == NULL) {
+        return 0;
+    }
+
+    int64_t Quota = -1;
+    int64_t Period = 0;
+    char* Line;
+    if (CGroupVersion == 1) {
+        //
+        // A quota of -1 means unlimited.
+        //
+        if ((Line = ReadCGroupLine(CGroupPath, CGROUP1_CPU_QUOTA_FILENAME)) != NULL) {
+            if (sscanf(Line, "%" SCNd64, &Quota) != 1) {
+                Quota = -1;
+            }
+            free(Line);
+        }
+        if ((Line = ReadCGroupLine(CGroupPath, CGROUP1_CPU_PERIOD_FILENAME)) != NULL) {
+            if (sscanf(Line, "%" SCNd64, &Period) != 1) {
+                Period = 0;
+            }
+            free(Line);
+        }
+    } else if (CGroupVersion == 2) {
+        //
+        // Formatted as "$MAX $PERIOD", where $MAX is "max" if unlimited.
+        //
+        if ((Line = ReadCGroupLine(CGroupPath, CGROUP2_CPU_MAX_FILENAME)) != NULL) {
+            if (strncmp(Line, "max", 3) == 0 ||
+                sscanf(Line, "%" SCNd64 " %" SCNd64, &Quota, &Period) != 2) {
+                Quota = -1;
+            }
+            free(Line);
+        }
+    }
+
+    free(CGroupPath);
+
+    if (Quota <= 0 || Period <= 0) {
+        return 0;
+    }
+
+    const int64_t CpuCount = (Quota + Period - 1) / Period;
+    return CpuCount > UINT16_MAX ? UINT16_MAX : (uint32_t)CpuCount;
+}
+
+//
+// Parses a cpuset list (e.g. "0-3,8,10-11") into processor indexes below
+// ProcessorCount. Returns 0 if the list can't be parsed.
+//
+static
+uint32_t
+ParseCpusetList(
+    _In_z_ const char* Line,
+    _In_ uint32_t ProcessorCount,
+    _Out_writes_to_(ProcessorCount, return) uint16_t* ProcessorList
+    )
+{
+    uint32_t Count = 0;
+    const char* Ptr = Line;
+    while (*Ptr != '\0' && *Ptr != '\n') {
+        char* End = NULL;
+        const unsigned long First = strtoul(Ptr, &End, 10);
+        if (End == Ptr) {
+            return 0;
+        }
+        unsigned long Last = First;
+        Ptr = End;
+        if (*Ptr == '-') {
+            Last = strtoul(Ptr + 1, &End, 10);
+            if (End == Ptr + 1 || Last < First) {
+                return 0;
+            }
+            Ptr = End;
+        }
+        for (unsigned long i = First; i <= Last && i < ProcessorCount; ++i) {
+            if (Count == ProcessorCount) {
+                return Count;
+            }
+            ProcessorList[Count++] = (uint16_t)i;
+        }
+        if (*Ptr == ',') {
+            ++Ptr;
+        } else if (*Ptr != '\0' && *Ptr != '\n') {
+            return 0;
+        }
+    }
+    return Count;
+}
+
+//
+// Returns the processors in the cgroup's cpuset, or 0 if they can't be read.
+//
+static
+uint32_t
+GetCGroupCpuset(
+    _In_ uint32_t ProcessorCount,
+    _Out_writes_to_(ProcessorCount, return) uint16_t* ProcessorList
+    )
+{
+    char* CGroupPath =
+        FindCGroupPath(CGroupVersion == 1 ? &IsCGroup1CpusetSubsystem : NULL);
+    if (CGroupPath == NULL) {
+        return 0;
+    }
+
+    char* Line = NULL;
+    if (CGroupVersion == 1) {
+        Line = ReadCGroupLine(CGroupPath, CGROUP1_CPUSET_EFFECTIVE_FILENAME);
+        if (Line == NULL) {
+            Line = ReadCGroupLine(CGroupPath, CGROUP1_CPUSET_FILENAME);
+        }
+    } else if (CGroupVersion == 2) {
+        Line = ReadCGroupLine(CGroupPath, CGROUP2_CPUSET_EFFECTIVE_FILENAME);
+    }
+
+    uint32_t Count = 0;
+    if (Line != NULL) {
+        Count = ParseCpusetList(Line, ProcessorCount, ProcessorList);
+        free(Line);
+    }
+
+    free(CGroupPath);
+    return Count;
+}
+
+uint32_t
+CxPlatProcGetRestrictedList(
+    _In_ uint32_t ListLength,
+    _Out_writes_to_(ListLength, return) uint16_t* List
+    )
+{
+    const uint32_t ProcessorCount = CxPlatProcCount();
+    if (ListLength < ProcessorCount) {
+        return 0;
+    }
+
+    CGroupVersion = FindCGroupVersion();
+    if (CGroupVersion == 0) {
+        return 0;
+    }
+
+    uint32_t Count = GetCGroupCpuset(ProcessorCount, List);
+    if (Count == 0) {
+        for (uint32_t i = 0; i < ProcessorCount; ++i) {
+            List[i] = (uint16_t)i;
+        }
+        Count = ProcessorCount;
+    }
+
+    //
+    // Don't run more workers than the CPU quota can keep busy, or they just
+    // get throttled.
+    //
+    const uint32_t QuotaCount = GetCGroupCpuQuotaCount();
+    if (QuotaCount != 0 && QuotaCount < Count) {
+        Count = QuotaCount;
+    }
+
+    return Count < ProcessorCount ? Count : 0;
+}
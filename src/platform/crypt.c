@@ -85,6 +85,19 @@ CxPlatHkdfExpandLabel(
             Output);
 }
 
+//
+// The Initial secret expansion labels are the same for every version and
+// connection, so they are kept already formatted (see CxPlatHkdfFormatLabel).
+//
+#define CXPLAT_INITIAL_HKDF_LABEL(c0, c1, c2, c3, c4, c5, c6, c7, c8) { \
+    0, CXPLAT_HASH_SHA256_SIZE, CXPLAT_HKDF_PREFIX_LEN + 9, \
+    't', 'l', 's', '1', '3', ' ', c0, c1, c2, c3, c4, c5, c6, c7, c8, 0, 1 }
+
+static const uint8_t CxPlatClientInitialLabel[] =
+    CXPLAT_INITIAL_HKDF_LABEL('c', 'l', 'i', 'e', 'n', 't', ' ', 'i', 'n');
+static const uint8_t CxPlatServerInitialLabel[] =
+    CXPLAT_INITIAL_HKDF_LABEL('s', 'e', 'r', 'v', 'e', 'r', ' ', 'i', 'n');
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatTlsDeriveInitialSecrets(
@@ -149,10 +162,10 @@ CxPlatTlsDeriveInitialSecrets(
     ClientInitial->Hash = CXPLAT_HASH_SHA256;
     ClientInitial->Aead = CXPLAT_AEAD_AES_128_GCM;
     Status =
-        CxPlatHkdfExpandLabel(
+        CxPlatHashCompute(
             DerivedHash,
-            "client in",
-            sizeof(InitialSecret),
+            CxPlatClientInitialLabel,
+            sizeof(CxPlatClientInitialLabel),
             CXPLAT_HASH_SHA256_SIZE,
             ClientInitial->Secret);
     if (QUIC_FAILED(Status)) {
@@ -165,10 +178,10 @@ CxPlatTlsDeriveInitialSecrets(
     ServerInitial->Hash = CXPLAT_HASH_SHA256;
     ServerInitial->Aead = CXPLAT_AEAD_AES_128_GCM;
     Status =
-        CxPlatHkdfExpandLabel(
+        CxPlatHashCompute(
             DerivedHash,
-            "server in",
-            sizeof(InitialSecret),
+            CxPlatServerInitialLabel,
+            sizeof(CxPlatServerInitialLabel),
             CXPLAT_HASH_SHA256_SIZE,
             ServerInitial->Secret);
     if (QUIC_FAILED(Status)) {
@@ -322,6 +335,20 @@ QuicPacketKeyDeriveOffload(
     CXPLAT_DBG_ASSERT(SecretLength >= CXPLAT_IV_LENGTH);
     CXPLAT_DBG_ASSERT(SecretLength <= CXPLAT_HASH_MAX_SIZE);
 
+    switch (Secret->Aead) {
+    case CXPLAT_AEAD_AES_128_GCM:
+        Offload->CipherType = CXPLAT_QEO_CIPHER_TYPE_AEAD_AES_128_GCM;
+        break;
+    case CXPLAT_AEAD_AES_256_GCM:
+        Offload->CipherType = CXPLAT_QEO_CIPHER_TYPE_AEAD_AES_256_GCM;
+        break;
+    case CXPLAT_AEAD_CHACHA20_POLY1305:
+        Offload->CipherType = CXPLAT_QEO_CIPHER_TYPE_AEAD_CHACHA20_POLY1305;
+        break;
+    default:
+        return QUIC_STATUS_NOT_SUPPORTED;
+    }
+
     CxPlatTlsLogSecret(SecretName, Secret->Secret, SecretLength);
 
     CXPLAT_HASH* Hash = NULL;
@@ -375,39 +402,24 @@ _IRQL_requires_max_(DISPATCH_LEVEL)
 _When_(NewReadKey != NULL, _At_(*NewReadKey, __drv_allocatesMem(Mem)))
 _When_(NewWriteKey != NULL, _At_(*NewWriteKey, __drv_allocatesMem(Mem)))
 QUIC_STATUS
-QuicPacketKeyCreateInitial(
+QuicPacketKeyCreateInitialFromSecrets(
     _In_ BOOLEAN IsServer,
     _In_ const QUIC_HKDF_LABELS* HkdfLabels,
-    _In_reads_(CXPLAT_VERSION_SALT_LENGTH)
-        const uint8_t* const Salt,  // Version Specific
-    _In_ uint8_t CIDLength,
-    _In_reads_(CIDLength)
-        const uint8_t* const CID,
+    _In_ const CXPLAT_SECRET* ClientInitial,
+    _In_ const CXPLAT_SECRET* ServerInitial,
     _Out_opt_ QUIC_PACKET_KEY** NewReadKey,
     _Out_opt_ QUIC_PACKET_KEY** NewWriteKey
     )
 {
-    QUIC_STATUS Status;
-    CXPLAT_SECRET ClientInitial, ServerInitial;
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     QUIC_PACKET_KEY* ReadKey = NULL, *WriteKey = NULL;
 
-    Status =
-        CxPlatTlsDeriveInitialSecrets(
-            Salt,
-            CID,
-            CIDLength,
-            &ClientInitial,
-            &ServerInitial);
-    if (QUIC_FAILED(Status)) {
-        goto Error;
-    }
-
     if (NewWriteKey != NULL) {
         Status =
             QuicPacketKeyDerive(
                 QUIC_PACKET_KEY_INITIAL,
                 HkdfLabels,
-                IsServer ? &ServerInitial : &ClientInitial,
+                IsServer ? ServerInitial : ClientInitial,
                 IsServer ? "srv secret" : "cli secret",
                 TRUE,
                 &WriteKey);
@@ -421,7 +433,7 @@ QuicPacketKeyCreateInitial(
             QuicPacketKeyDerive(
                 QUIC_PACKET_KEY_INITIAL,
                 HkdfLabels,
-                IsServer ? &ClientInitial : &ServerInitial,
+                IsServer ? ClientInitial : ServerInitial,
                 IsServer ? "cli secret" : "srv secret",
                 TRUE,
                 &ReadKey);
@@ -445,6 +457,46 @@ Error:
     QuicPacketKeyFree(ReadKey);
     QuicPacketKeyFree(WriteKey);
 
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_When_(NewReadKey != NULL, _At_(*NewReadKey, __drv_allocatesMem(Mem)))
+_When_(NewWriteKey != NULL, _At_(*NewWriteKey, __drv_allocatesMem(Mem)))
+QUIC_STATUS
+QuicPacketKeyCreateInitial(
+    _In_ BOOLEAN IsServer,
+    _In_ const QUIC_HKDF_LABELS* HkdfLabels,
+    _In_reads_(CXPLAT_VERSION_SALT_LENGTH)
+        const uint8_t* const Salt,  // Version Specific
+    _In_ uint8_t CIDLength,
+    _In_reads_(CIDLength)
+        const uint8_t* const CID,
+    _Out_opt_ QUIC_PACKET_KEY** NewReadKey,
+    _Out_opt_ QUIC_PACKET_KEY** NewWriteKey
+    )
+{
+    QUIC_STATUS Status;
+    CXPLAT_SECRET ClientInitial, ServerInitial;
+
+    Status =
+        CxPlatTlsDeriveInitialSecrets(
+            Salt,
+            CID,
+            CIDLength,
+            &ClientInitial,
+            &ServerInitial);
+    if (QUIC_SUCCEEDED(Status)) {
+        Status =
+            QuicPacketKeyCreateInitialFromSecrets(
+                IsServer,
+                HkdfLabels,
+                &ClientInitial,
+                &ServerInitial,
+                NewReadKey,
+                NewWriteKey);
+    }
+
     CxPlatSecureZeroMemory(ClientInitial.Secret, sizeof(ClientInitial.Secret));
     CxPlatSecureZeroMemory(ServerInitial.Secret, sizeof(ServerInitial.Secret));
 
@@ -526,3 +578,68 @@ Error:
 
     return Status;
 }
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatEncryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_BATCH_PACKET* Packets
+    )
+{
+    //
+    // Neither OpenSSL nor BCrypt expose a multi-buffer AEAD interface, so the
+    // packets are still sealed one after another, just without returning to
+    // the caller in between.
+    //
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        uint8_t PacketIv[CXPLAT_MAX_IV_LENGTH];
+        QuicCryptoCombineIvAndPacketNumber(Iv, (uint8_t*)&Packets[i].PacketNumber, PacketIv);
+        QUIC_STATUS Status =
+            CxPlatEncrypt(
+                Key,
+                PacketIv,
+                Packets[i].HeaderLength,
+                Packets[i].Header,
+                Packets[i].PayloadLength,
+                Packets[i].Header + Packets[i].HeaderLength);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDecryptBatch(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint8_t BatchSize,
+    _In_reads_(BatchSize)
+        const CXPLAT_CRYPT_BATCH_PACKET* Packets,
+    _Out_writes_(BatchSize)
+        BOOLEAN* Results
+    )
+{
+    //
+    // As with CxPlatEncryptBatch, each packet is still opened on its own.
+    //
+    for (uint8_t i = 0; i < BatchSize; ++i) {
+        uint8_t PacketIv[CXPLAT_MAX_IV_LENGTH];
+        QuicCryptoCombineIvAndPacketNumber(Iv, (uint8_t*)&Packets[i].PacketNumber, PacketIv);
+        Results[i] =
+            QUIC_SUCCEEDED(
+            CxPlatDecrypt(
+                Key,
+                PacketIv,
+                Packets[i].HeaderLength,
+                Packets[i].Header,
+                Packets[i].PayloadLength,
+                Packets[i].Header + Packets[i].HeaderLength));
+    }
+}
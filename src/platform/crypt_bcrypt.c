@@ -448,6 +448,54 @@ CxPlatDecrypt(
     return NtStatusToQuicStatus(Status);
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBegin(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength)
+        const uint8_t* const AuthData,
+    _In_ uint16_t PrefixLength,
+    _Inout_updates_bytes_(PrefixLength)
+        uint8_t* Prefix
+    )
+{
+    //
+    // The key handles aren't set up for chained calls.
+    //
+    UNREFERENCED_PARAMETER(Key);
+    UNREFERENCED_PARAMETER(Iv);
+    UNREFERENCED_PARAMETER(AuthDataLength);
+    UNREFERENCED_PARAMETER(AuthData);
+    UNREFERENCED_PARAMETER(PrefixLength);
+    UNREFERENCED_PARAMETER(Prefix);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptEnd(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint16_t CipherTextLength,
+    _In_reads_bytes_(CipherTextLength)
+        const uint8_t* const CipherText,
+    _Out_writes_bytes_(CipherTextLength)
+        uint8_t* Output,
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD)
+        const uint8_t* const Tag
+    )
+{
+    UNREFERENCED_PARAMETER(Key);
+    UNREFERENCED_PARAMETER(CipherTextLength);
+    UNREFERENCED_PARAMETER(CipherText);
+    UNREFERENCED_PARAMETER(Output);
+    UNREFERENCED_PARAMETER(Tag);
+    CXPLAT_FRE_ASSERT(FALSE); // CxPlatDecryptBegin never succeeds.
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
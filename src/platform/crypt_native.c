@@ -0,0 +1,588 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Built-in AES-GCM, using the AES-NI and PCLMULQDQ instructions.
+
+    Counter mode encrypts four blocks at a time, so the AES rounds of
+    independent blocks overlap in the pipeline. GHASH works on byte reflected
+    blocks (as described in Intel's "Carry-Less Multiplication and Its Usage
+    for Computing the GCM Mode" white paper), and aggregates four blocks per
+    reduction by multiplying them with the precomputed powers H^4 to H^1.
+
+--*/
+
+#include "crypt_native.h"
+
+#ifdef CXPLAT_NATIVE_AES_GCM
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CXPLAT_NATIVE_TARGET
+#else
+#define CXPLAT_NATIVE_TARGET __attribute__((target("aes,pclmul,ssse3")))
+#endif
+
+BOOLEAN
+CxPlatNativeAesGcmSupported(
+    void
+    )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int CpuInfo[4];
+    __cpuid(CpuInfo, 1);
+    return
+        (CpuInfo[2] & (1 << 25)) != 0 && // AES
+        (CpuInfo[2] & (1 << 1)) != 0 &&  // PCLMULQDQ
+        (CpuInfo[2] & (1 << 9)) != 0;    // SSSE3
+#else
+    return
+        __builtin_cpu_supports("aes") &&
+        __builtin_cpu_supports("pclmul") &&
+        __builtin_cpu_supports("ssse3") ? TRUE : FALSE;
+#endif
+}
+
+//
+// AES
+//
+
+static
+CXPLAT_NATIVE_TARGET
+__m128i
+CxPlatNativeAes128Assist(
+    __m128i Key,
+    __m128i Assist
+    )
+{
+    Assist = _mm_shuffle_epi32(Assist, 0xff);
+    Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 4));
+    Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 4));
+    Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 4));
+    return _mm_xor_si128(Key, Assist);
+}
+
+static
+CXPLAT_NATIVE_TARGET
+__m128i
+CxPlatNativeAes256Assist(
+    __m128i Key,
+    __m128i Prev
+    )
+{
+    __m128i Assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(Prev, 0x00), 0xaa);
+    Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 4));
+    Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 4));
+    Key = _mm_xor_si128(Key, _mm_slli_si128(Key, 4));
+    return _mm_xor_si128(Key, Assist);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeAesInitialize(
+    _Out_ CXPLAT_NATIVE_AES* Aes,
+    _In_reads_(KeyLength) const uint8_t* RawKey,
+    _In_ uint8_t KeyLength
+    )
+{
+    __m128i* RoundKeys = (__m128i*)Aes->RoundKeys;
+    CXPLAT_DBG_ASSERT(KeyLength == 16 || KeyLength == 32);
+
+    if (KeyLength == 16) {
+        Aes->Rounds = 10;
+        __m128i K = _mm_loadu_si128((const __m128i*)RawKey);
+        _mm_storeu_si128(RoundKeys + 0, K);
+#define CXPLAT_AES128_ROUND(i, Rcon) \
+        K = CxPlatNativeAes128Assist(K, _mm_aeskeygenassist_si128(K, Rcon)); \
+        _mm_storeu_si128(RoundKeys + i, K)
+        CXPLAT_AES128_ROUND(1, 0x01);
+        CXPLAT_AES128_ROUND(2, 0x02);
+        CXPLAT_AES128_ROUND(3, 0x04);
+        CXPLAT_AES128_ROUND(4, 0x08);
+        CXPLAT_AES128_ROUND(5, 0x10);
+        CXPLAT_AES128_ROUND(6, 0x20);
+        CXPLAT_AES128_ROUND(7, 0x40);
+        CXPLAT_AES128_ROUND(8, 0x80);
+        CXPLAT_AES128_ROUND(9, 0x1b);
+        CXPLAT_AES128_ROUND(10, 0x36);
+#undef CXPLAT_AES128_ROUND
+
+    } else {
+        Aes->Rounds = 14;
+        __m128i K1 = _mm_loadu_si128((const __m128i*)RawKey);
+        __m128i K2 = _mm_loadu_si128((const __m128i*)(RawKey + 16));
+        _mm_storeu_si128(RoundKeys + 0, K1);
+        _mm_storeu_si128(RoundKeys + 1, K2);
+#define CXPLAT_AES256_ROUND(i, Rcon) \
+        K1 = CxPlatNativeAes128Assist(K1, _mm_aeskeygenassist_si128(K2, Rcon)); \
+        _mm_storeu_si128(RoundKeys + i, K1); \
+        K2 = CxPlatNativeAes256Assist(K2, K1); \
+        _mm_storeu_si128(RoundKeys + i + 1, K2)
+        CXPLAT_AES256_ROUND(2, 0x01);
+        CXPLAT_AES256_ROUND(4, 0x02);
+        CXPLAT_AES256_ROUND(6, 0x04);
+        CXPLAT_AES256_ROUND(8, 0x08);
+        CXPLAT_AES256_ROUND(10, 0x10);
+        CXPLAT_AES256_ROUND(12, 0x20);
+#undef CXPLAT_AES256_ROUND
+        K1 = CxPlatNativeAes128Assist(K1, _mm_aeskeygenassist_si128(K2, 0x40));
+        _mm_storeu_si128(RoundKeys + 14, K1);
+    }
+}
+
+static
+CXPLAT_NATIVE_TARGET
+__m128i
+CxPlatNativeAesEncryptBlock(
+    _In_ const CXPLAT_NATIVE_AES* Aes,
+    __m128i Block
+    )
+{
+    const __m128i* RoundKeys = (const __m128i*)Aes->RoundKeys;
+    Block = _mm_xor_si128(Block, _mm_loadu_si128(RoundKeys));
+    for (uint8_t i = 1; i < Aes->Rounds; ++i) {
+        Block = _mm_aesenc_si128(Block, _mm_loadu_si128(RoundKeys + i));
+    }
+    return _mm_aesenclast_si128(Block, _mm_loadu_si128(RoundKeys + Aes->Rounds));
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeAesEncryptBlocks(
+    _In_ const CXPLAT_NATIVE_AES* Aes,
+    _In_ uint32_t BlockCount,
+    _In_reads_bytes_(BlockCount * 16) const uint8_t* Input,
+    _Out_writes_bytes_(BlockCount * 16) uint8_t* Output
+    )
+{
+    for (uint32_t i = 0; i < BlockCount; ++i) {
+        _mm_storeu_si128(
+            (__m128i*)(Output + i * 16),
+            CxPlatNativeAesEncryptBlock(
+                Aes, _mm_loadu_si128((const __m128i*)(Input + i * 16))));
+    }
+}
+
+//
+// GHASH
+//
+
+//
+// Multiplies two byte reflected field elements, without the final reduction.
+//
+static
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeGfMul(
+    __m128i A,
+    __m128i B,
+    _Inout_ __m128i* Lo,
+    _Inout_ __m128i* Hi
+    )
+{
+    __m128i Mid =
+        _mm_xor_si128(
+            _mm_clmulepi64_si128(A, B, 0x10),
+            _mm_clmulepi64_si128(A, B, 0x01));
+    *Lo = _mm_xor_si128(*Lo, _mm_xor_si128(_mm_clmulepi64_si128(A, B, 0x00), _mm_slli_si128(Mid, 8)));
+    *Hi = _mm_xor_si128(*Hi, _mm_xor_si128(_mm_clmulepi64_si128(A, B, 0x11), _mm_srli_si128(Mid, 8)));
+}
+
+//
+// Shifts the (reflected) 256-bit product left by one bit and reduces it
+// modulo the GCM polynomial.
+//
+static
+CXPLAT_NATIVE_TARGET
+__m128i
+CxPlatNativeGfReduce(
+    __m128i Lo,
+    __m128i Hi
+    )
+{
+    __m128i T7 = _mm_srli_epi32(Lo, 31);
+    __m128i T8 = _mm_srli_epi32(Hi, 31);
+    Lo = _mm_slli_epi32(Lo, 1);
+    Hi = _mm_slli_epi32(Hi, 1);
+    __m128i T9 = _mm_srli_si128(T7, 12);
+    T8 = _mm_slli_si128(T8, 4);
+    T7 = _mm_slli_si128(T7, 4);
+    Lo = _mm_or_si128(Lo, T7);
+    Hi = _mm_or_si128(Hi, T8);
+    Hi = _mm_or_si128(Hi, T9);
+
+    T7 = _mm_xor_si128(
+            _mm_xor_si128(_mm_slli_epi32(Lo, 31), _mm_slli_epi32(Lo, 30)),
+            _mm_slli_epi32(Lo, 25));
+    T8 = _mm_srli_si128(T7, 4);
+    T7 = _mm_slli_si128(T7, 12);
+    Lo = _mm_xor_si128(Lo, T7);
+
+    __m128i T2 =
+        _mm_xor_si128(
+            _mm_xor_si128(_mm_srli_epi32(Lo, 1), _mm_srli_epi32(Lo, 2)),
+            _mm_xor_si128(_mm_srli_epi32(Lo, 7), T8));
+    Lo = _mm_xor_si128(Lo, T2);
+    return _mm_xor_si128(Hi, Lo);
+}
+
+static
+CXPLAT_NATIVE_TARGET
+__m128i
+CxPlatNativeGfMulReduce(
+    __m128i A,
+    __m128i B
+    )
+{
+    __m128i Lo = _mm_setzero_si128();
+    __m128i Hi = _mm_setzero_si128();
+    CxPlatNativeGfMul(A, B, &Lo, &Hi);
+    return CxPlatNativeGfReduce(Lo, Hi);
+}
+
+#define CXPLAT_NATIVE_BSWAP_MASK() \
+    _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)
+
+//
+// Loads up to 16 bytes, zero padded, as a byte reflected block.
+//
+static
+CXPLAT_NATIVE_TARGET
+__m128i
+CxPlatNativeGhashLoad(
+    _In_reads_(Length) const uint8_t* Data,
+    _In_ uint32_t Length
+    )
+{
+    uint8_t Block[16] = {0};
+    CxPlatCopyMemory(Block, Data, CXPLAT_MIN(Length, sizeof(Block)));
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)Block), CXPLAT_NATIVE_BSWAP_MASK());
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeAesGcmInitialize(
+    _Out_ CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_(KeyLength) const uint8_t* RawKey,
+    _In_ uint8_t KeyLength
+    )
+{
+    CxPlatNativeAesInitialize(&Key->Aes, RawKey, KeyLength);
+
+    const __m128i H =
+        _mm_shuffle_epi8(
+            CxPlatNativeAesEncryptBlock(&Key->Aes, _mm_setzero_si128()),
+            CXPLAT_NATIVE_BSWAP_MASK());
+    __m128i Power = H;
+    for (uint32_t i = 0; i < ARRAYSIZE(Key->HashKeys); ++i) {
+        _mm_storeu_si128((__m128i*)Key->HashKeys[i], Power);
+        Power = CxPlatNativeGfMulReduce(Power, H);
+    }
+}
+
+//
+// Starts encrypting or decrypting a message: derives the initial counter
+// block from the IV and hashes the authenticated data.
+//
+static
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeAesGcmStart(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _Out_ CXPLAT_NATIVE_AES_GCM_STATE* State
+    )
+{
+    const __m128i Bswap = CXPLAT_NATIVE_BSWAP_MASK();
+    const __m128i H1 = _mm_loadu_si128((const __m128i*)Key->HashKeys[0]);
+
+    //
+    // The counter is kept byte reflected, so the 32-bit block counter is the
+    // low lane and can simply be incremented.
+    //
+    uint8_t J0[16];
+    CxPlatCopyMemory(J0, Iv, CXPLAT_IV_LENGTH);
+    J0[12] = 0; J0[13] = 0; J0[14] = 0; J0[15] = 1;
+    _mm_storeu_si128(
+        (__m128i*)State->Counter,
+        _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)J0), Bswap));
+    _mm_storeu_si128(
+        (__m128i*)State->EncryptedJ0,
+        CxPlatNativeAesEncryptBlock(&Key->Aes, _mm_loadu_si128((const __m128i*)J0)));
+
+    __m128i Hash = _mm_setzero_si128();
+    for (uint32_t i = 0; i < AuthDataLength; i += 16) {
+        Hash =
+            CxPlatNativeGfMulReduce(
+                _mm_xor_si128(Hash, CxPlatNativeGhashLoad(AuthData + i, AuthDataLength - i)),
+                H1);
+    }
+    _mm_storeu_si128((__m128i*)State->Hash, Hash);
+
+    State->AuthDataLength = AuthDataLength;
+    State->Length = 0;
+    State->PartialLength = 0;
+}
+
+//
+// Encrypts or decrypts the next Length bytes of the message from Input to
+// Output (which may be the same buffer), and adds the cipher text to the hash.
+// A trailing partial block is kept in State, along with the rest of its key
+// stream, so the message can be split at any byte.
+//
+static
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeAesGcmUpdate(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _Inout_ CXPLAT_NATIVE_AES_GCM_STATE* State,
+    _In_ uint16_t Length,
+    _In_reads_bytes_(Length) const uint8_t* Input,
+    _Out_writes_bytes_(Length) uint8_t* Output,
+    _In_ BOOLEAN Encrypt
+    )
+{
+    const __m128i Bswap = CXPLAT_NATIVE_BSWAP_MASK();
+    const __m128i One = _mm_set_epi32(0, 0, 0, 1);
+    const __m128i* RoundKeys = (const __m128i*)Key->Aes.RoundKeys;
+    const uint8_t Rounds = Key->Aes.Rounds;
+    const __m128i H1 = _mm_loadu_si128((const __m128i*)Key->HashKeys[0]);
+    const __m128i H2 = _mm_loadu_si128((const __m128i*)Key->HashKeys[1]);
+    const __m128i H3 = _mm_loadu_si128((const __m128i*)Key->HashKeys[2]);
+    const __m128i H4 = _mm_loadu_si128((const __m128i*)Key->HashKeys[3]);
+    __m128i Counter = _mm_loadu_si128((const __m128i*)State->Counter);
+    __m128i Hash = _mm_loadu_si128((const __m128i*)State->Hash);
+    uint32_t Offset = 0;
+
+    State->Length += Length;
+
+    //
+    // Complete the partial block left over from the last call first.
+    //
+    if (State->PartialLength != 0) {
+        for (; Offset < Length && State->PartialLength < 16; ++Offset) {
+            const uint8_t In = Input[Offset];
+            const uint8_t Out = In ^ State->KeyStream[State->PartialLength];
+            Output[Offset] = Out;
+            State->Partial[State->PartialLength++] = Encrypt ? Out : In;
+        }
+        if (State->PartialLength == 16) {
+            Hash =
+                CxPlatNativeGfMulReduce(
+                    _mm_xor_si128(Hash, CxPlatNativeGhashLoad(State->Partial, 16)), H1);
+            State->PartialLength = 0;
+        }
+    }
+
+    for (; Offset + 64 <= Length; Offset += 64) {
+        const __m128i* In = (const __m128i*)(Input + Offset);
+        __m128i* Out = (__m128i*)(Output + Offset);
+        __m128i K0 = _mm_shuffle_epi8(Counter = _mm_add_epi32(Counter, One), Bswap);
+        __m128i K1 = _mm_shuffle_epi8(Counter = _mm_add_epi32(Counter, One), Bswap);
+        __m128i K2 = _mm_shuffle_epi8(Counter = _mm_add_epi32(Counter, One), Bswap);
+        __m128i K3 = _mm_shuffle_epi8(Counter = _mm_add_epi32(Counter, One), Bswap);
+        __m128i RoundKey = _mm_loadu_si128(RoundKeys);
+        K0 = _mm_xor_si128(K0, RoundKey);
+        K1 = _mm_xor_si128(K1, RoundKey);
+        K2 = _mm_xor_si128(K2, RoundKey);
+        K3 = _mm_xor_si128(K3, RoundKey);
+        for (uint8_t r = 1; r < Rounds; ++r) {
+            RoundKey = _mm_loadu_si128(RoundKeys + r);
+            K0 = _mm_aesenc_si128(K0, RoundKey);
+            K1 = _mm_aesenc_si128(K1, RoundKey);
+            K2 = _mm_aesenc_si128(K2, RoundKey);
+            K3 = _mm_aesenc_si128(K3, RoundKey);
+        }
+        RoundKey = _mm_loadu_si128(RoundKeys + Rounds);
+        K0 = _mm_aesenclast_si128(K0, RoundKey);
+        K1 = _mm_aesenclast_si128(K1, RoundKey);
+        K2 = _mm_aesenclast_si128(K2, RoundKey);
+        K3 = _mm_aesenclast_si128(K3, RoundKey);
+
+        __m128i In0 = _mm_loadu_si128(In + 0);
+        __m128i In1 = _mm_loadu_si128(In + 1);
+        __m128i In2 = _mm_loadu_si128(In + 2);
+        __m128i In3 = _mm_loadu_si128(In + 3);
+        __m128i Out0 = _mm_xor_si128(In0, K0);
+        __m128i Out1 = _mm_xor_si128(In1, K1);
+        __m128i Out2 = _mm_xor_si128(In2, K2);
+        __m128i Out3 = _mm_xor_si128(In3, K3);
+        _mm_storeu_si128(Out + 0, Out0);
+        _mm_storeu_si128(Out + 1, Out1);
+        _mm_storeu_si128(Out + 2, Out2);
+        _mm_storeu_si128(Out + 3, Out3);
+
+        if (Encrypt) {
+            In0 = Out0; In1 = Out1; In2 = Out2; In3 = Out3;
+        }
+        __m128i Lo = _mm_setzero_si128();
+        __m128i Hi = _mm_setzero_si128();
+        CxPlatNativeGfMul(_mm_xor_si128(Hash, _mm_shuffle_epi8(In0, Bswap)), H4, &Lo, &Hi);
+        CxPlatNativeGfMul(_mm_shuffle_epi8(In1, Bswap), H3, &Lo, &Hi);
+        CxPlatNativeGfMul(_mm_shuffle_epi8(In2, Bswap), H2, &Lo, &Hi);
+        CxPlatNativeGfMul(_mm_shuffle_epi8(In3, Bswap), H1, &Lo, &Hi);
+        Hash = CxPlatNativeGfReduce(Lo, Hi);
+    }
+
+    for (; Offset < Length; Offset += 16) {
+        const uint32_t BlockLength = CXPLAT_MIN(16u, (uint32_t)Length - Offset);
+        Counter = _mm_add_epi32(Counter, One);
+        _mm_storeu_si128(
+            (__m128i*)State->KeyStream,
+            CxPlatNativeAesEncryptBlock(&Key->Aes, _mm_shuffle_epi8(Counter, Bswap)));
+        for (uint32_t i = 0; i < BlockLength; ++i) {
+            const uint8_t In = Input[Offset + i];
+            const uint8_t Out = In ^ State->KeyStream[i];
+            Output[Offset + i] = Out;
+            State->Partial[i] = Encrypt ? Out : In;
+        }
+        if (BlockLength < 16) {
+            State->PartialLength = (uint8_t)BlockLength;
+        } else {
+            Hash =
+                CxPlatNativeGfMulReduce(
+                    _mm_xor_si128(Hash, CxPlatNativeGhashLoad(State->Partial, 16)), H1);
+        }
+    }
+
+    _mm_storeu_si128((__m128i*)State->Counter, Counter);
+    _mm_storeu_si128((__m128i*)State->Hash, Hash);
+}
+
+//
+// Hashes any partial block and the lengths, and computes the tag.
+//
+static
+CXPLAT_NATIVE_TARGET
+void
+CxPlatNativeAesGcmFinish(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_ const CXPLAT_NATIVE_AES_GCM_STATE* State,
+    _Out_writes_bytes_(CXPLAT_ENCRYPTION_OVERHEAD) uint8_t* Tag
+    )
+{
+    const __m128i Bswap = CXPLAT_NATIVE_BSWAP_MASK();
+    const __m128i H1 = _mm_loadu_si128((const __m128i*)Key->HashKeys[0]);
+    __m128i Hash = _mm_loadu_si128((const __m128i*)State->Hash);
+
+    if (State->PartialLength != 0) {
+        Hash =
+            CxPlatNativeGfMulReduce(
+                _mm_xor_si128(
+                    Hash, CxPlatNativeGhashLoad(State->Partial, State->PartialLength)),
+                H1);
+    }
+
+    //
+    // The lengths (in bits) block, byte reflected.
+    //
+    const __m128i Lengths =
+        _mm_set_epi64x(
+            (long long)((uint64_t)State->AuthDataLength * 8),
+            (long long)((uint64_t)State->Length * 8));
+    Hash = CxPlatNativeGfMulReduce(_mm_xor_si128(Hash, Lengths), H1);
+
+    _mm_storeu_si128(
+        (__m128i*)Tag,
+        _mm_xor_si128(
+            _mm_shuffle_epi8(Hash, Bswap),
+            _mm_loadu_si128((const __m128i*)State->EncryptedJ0)));
+}
+
+//
+// Constant time comparison of the tags.
+//
+static
+BOOLEAN
+CxPlatNativeAesGcmTagEqual(
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD) const uint8_t* Tag1,
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD) const uint8_t* Tag2
+    )
+{
+    uint8_t Difference = 0;
+    for (uint32_t i = 0; i < CXPLAT_ENCRYPTION_OVERHEAD; ++i) {
+        Difference |= Tag1[i] ^ Tag2[i];
+    }
+    return Difference == 0;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesGcmSeal(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _In_ uint16_t PlainTextLength,
+    _Inout_updates_bytes_(PlainTextLength + CXPLAT_ENCRYPTION_OVERHEAD) uint8_t* Buffer
+    )
+{
+    CXPLAT_NATIVE_AES_GCM_STATE State;
+    CxPlatNativeAesGcmStart(Key, Iv, AuthDataLength, AuthData, &State);
+    CxPlatNativeAesGcmUpdate(Key, &State, PlainTextLength, Buffer, Buffer, TRUE);
+    CxPlatNativeAesGcmFinish(Key, &State, Buffer + PlainTextLength);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatNativeAesGcmOpen(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _In_ uint16_t CipherTextLength,
+    _Inout_updates_bytes_(CipherTextLength + CXPLAT_ENCRYPTION_OVERHEAD) uint8_t* Buffer
+    )
+{
+    CXPLAT_NATIVE_AES_GCM_STATE State;
+    uint8_t Tag[CXPLAT_ENCRYPTION_OVERHEAD];
+    CxPlatNativeAesGcmStart(Key, Iv, AuthDataLength, AuthData, &State);
+    CxPlatNativeAesGcmUpdate(Key, &State, CipherTextLength, Buffer, Buffer, FALSE);
+    CxPlatNativeAesGcmFinish(Key, &State, Tag);
+    return CxPlatNativeAesGcmTagEqual(Tag, Buffer + CipherTextLength);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesGcmOpenBegin(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _In_ uint16_t PrefixLength,
+    _Inout_updates_bytes_(PrefixLength) uint8_t* Prefix,
+    _Out_ CXPLAT_NATIVE_AES_GCM_STATE* State
+    )
+{
+    CxPlatNativeAesGcmStart(Key, Iv, AuthDataLength, AuthData, State);
+    CxPlatNativeAesGcmUpdate(Key, State, PrefixLength, Prefix, Prefix, FALSE);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatNativeAesGcmOpenEnd(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _Inout_ CXPLAT_NATIVE_AES_GCM_STATE* State,
+    _In_ uint16_t CipherTextLength,
+    _In_reads_bytes_(CipherTextLength) const uint8_t* CipherText,
+    _Out_writes_bytes_(CipherTextLength) uint8_t* Output,
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD) const uint8_t* Tag
+    )
+{
+    uint8_t ComputedTag[CXPLAT_ENCRYPTION_OVERHEAD];
+    CxPlatNativeAesGcmUpdate(Key, State, CipherTextLength, CipherText, Output, FALSE);
+    CxPlatNativeAesGcmFinish(Key, State, ComputedTag);
+    return CxPlatNativeAesGcmTagEqual(ComputedTag, Tag);
+}
+
+#endif // CXPLAT_NATIVE_AES_GCM
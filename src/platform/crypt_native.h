@@ -0,0 +1,168 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    Built-in AES-GCM packet and header protection, used by the crypto
+    providers for 1-RTT (and all other) packet keys when the CPU supports it.
+    Only packet protection goes through here; TLS itself stays with the
+    provider.
+
+--*/
+
+#pragma once
+
+#include "platform_internal.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define CXPLAT_NATIVE_AES_GCM 1
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+#ifdef CXPLAT_NATIVE_AES_GCM
+
+#define CXPLAT_NATIVE_AES_MAX_ROUNDS 14
+
+//
+// An expanded AES-128 or AES-256 encryption key.
+//
+typedef struct CXPLAT_NATIVE_AES {
+    uint8_t RoundKeys[CXPLAT_NATIVE_AES_MAX_ROUNDS + 1][16];
+    uint8_t Rounds;
+} CXPLAT_NATIVE_AES;
+
+//
+// An AES-GCM key: the expanded AES key, along with the (byte reflected)
+// GHASH key powers H^1 to H^4.
+//
+typedef struct CXPLAT_NATIVE_AES_GCM_KEY {
+    CXPLAT_NATIVE_AES Aes;
+    uint8_t HashKeys[4][16];
+} CXPLAT_NATIVE_AES_GCM_KEY;
+
+//
+// The state of a message being decrypted in steps: the (byte reflected)
+// counter and running hash, the encrypted initial counter block for the tag,
+// and any partial block along with the rest of its key stream.
+//
+typedef struct CXPLAT_NATIVE_AES_GCM_STATE {
+    uint8_t Counter[16];
+    uint8_t Hash[16];
+    uint8_t EncryptedJ0[16];
+    uint8_t KeyStream[16];
+    uint8_t Partial[16];
+    uint16_t AuthDataLength;
+    uint16_t Length;
+    uint8_t PartialLength;
+} CXPLAT_NATIVE_AES_GCM_STATE;
+
+//
+// Returns TRUE if the CPU has the instructions the built-in AES-GCM needs.
+//
+BOOLEAN
+CxPlatNativeAesGcmSupported(
+    void
+    );
+
+//
+// Expands a 16 or 32 byte AES key.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesInitialize(
+    _Out_ CXPLAT_NATIVE_AES* Aes,
+    _In_reads_(KeyLength) const uint8_t* RawKey,
+    _In_ uint8_t KeyLength
+    );
+
+//
+// Encrypts BlockCount independent 16 byte blocks (i.e. AES-ECB), as used for
+// header protection.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesEncryptBlocks(
+    _In_ const CXPLAT_NATIVE_AES* Aes,
+    _In_ uint32_t BlockCount,
+    _In_reads_bytes_(BlockCount * 16) const uint8_t* Input,
+    _Out_writes_bytes_(BlockCount * 16) uint8_t* Output
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesGcmInitialize(
+    _Out_ CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_(KeyLength) const uint8_t* RawKey,
+    _In_ uint8_t KeyLength
+    );
+
+//
+// Encrypts Buffer in place and writes the CXPLAT_ENCRYPTION_OVERHEAD byte tag
+// directly after it.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesGcmSeal(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _In_ uint16_t PlainTextLength,
+    _Inout_updates_bytes_(PlainTextLength + CXPLAT_ENCRYPTION_OVERHEAD) uint8_t* Buffer
+    );
+
+//
+// Decrypts Buffer in place and verifies the CXPLAT_ENCRYPTION_OVERHEAD byte tag
+// directly after it. Returns FALSE if the tag doesn't match, in which case the
+// contents of Buffer are undefined.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatNativeAesGcmOpen(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _In_ uint16_t CipherTextLength,
+    _Inout_updates_bytes_(CipherTextLength + CXPLAT_ENCRYPTION_OVERHEAD) uint8_t* Buffer
+    );
+
+//
+// Decrypts a message in two steps. CxPlatNativeAesGcmOpenBegin decrypts the
+// first PrefixLength bytes in place (unauthenticated), and
+// CxPlatNativeAesGcmOpenEnd decrypts the rest from CipherText into Output and
+// verifies Tag against the whole message. The split can be at any byte.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatNativeAesGcmOpenBegin(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH) const uint8_t* Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength) const uint8_t* AuthData,
+    _In_ uint16_t PrefixLength,
+    _Inout_updates_bytes_(PrefixLength) uint8_t* Prefix,
+    _Out_ CXPLAT_NATIVE_AES_GCM_STATE* State
+    );
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatNativeAesGcmOpenEnd(
+    _In_ const CXPLAT_NATIVE_AES_GCM_KEY* Key,
+    _Inout_ CXPLAT_NATIVE_AES_GCM_STATE* State,
+    _In_ uint16_t CipherTextLength,
+    _In_reads_bytes_(CipherTextLength) const uint8_t* CipherText,
+    _Out_writes_bytes_(CipherTextLength) uint8_t* Output,
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD) const uint8_t* Tag
+    );
+
+#endif // CXPLAT_NATIVE_AES_GCM
+
+#if defined(__cplusplus)
+}
+#endif
@@ -10,6 +10,9 @@ Abstract:
 --*/
 
 #include "platform_internal.h"
+#ifdef CXPLAT_NATIVE_AEAD
+#include "crypt_native.h"
+#endif
 
 #include "openssl/opensslv.h"
 
@@ -100,9 +103,37 @@ CxPlatLoadHMACCTX(
     return 1;
 }
 
+#if defined(CXPLAT_NATIVE_AEAD) && defined(CXPLAT_NATIVE_AES_GCM)
+#define CXPLAT_USE_NATIVE_AES_GCM 1
+
+//
+// Set at initialization if the CPU supports the built-in AES-GCM, in which case
+// it is used for all AES-GCM packet and header protection keys.
+//
+static BOOLEAN CxPlatNativeAesGcmEnabled = FALSE;
+#endif
+
+//
+// Each key has a context per direction, fully initialized with the cipher and
+// key up front, so only the nonce has to be set for each packet.
+//
+typedef struct CXPLAT_KEY {
+    EVP_CIPHER_CTX* EncryptCtx;
+    EVP_CIPHER_CTX* DecryptCtx;
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    BOOLEAN UseNative;
+    CXPLAT_NATIVE_AES_GCM_KEY Native;
+    CXPLAT_NATIVE_AES_GCM_STATE NativeDecryptState; // Between CxPlatDecryptBegin and End.
+#endif
+} CXPLAT_KEY;
+
 typedef struct CXPLAT_HP_KEY {
     EVP_CIPHER_CTX* CipherCtx;
     CXPLAT_AEAD_TYPE Aead;
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    BOOLEAN UseNative;
+    CXPLAT_NATIVE_AES Native;
+#endif
 } CXPLAT_HP_KEY;
 
 QUIC_STATUS
@@ -150,6 +181,10 @@ CxPlatCryptInitialize(
     }
     EVP_MAC_free(mac);
 
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    CxPlatNativeAesGcmEnabled = CxPlatNativeAesGcmSupported();
+#endif
+
     return QUIC_STATUS_SUCCESS;
 
 Error:
@@ -221,10 +256,32 @@ CxPlatKeyCreate(
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     const EVP_CIPHER *Aead;
     OSSL_PARAM AlgParam[2];
-    size_t TagLength;
+    size_t IvLength;
+
+    CXPLAT_KEY* Key = CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_KEY), QUIC_POOL_TLS_KEY);
+    if (Key == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    Key->UseNative = FALSE;
+    if (CxPlatNativeAesGcmEnabled &&
+        (AeadType == CXPLAT_AEAD_AES_128_GCM || AeadType == CXPLAT_AEAD_AES_256_GCM)) {
+        Key->EncryptCtx = NULL;
+        Key->DecryptCtx = NULL;
+        Key->UseNative = TRUE;
+        CxPlatNativeAesGcmInitialize(
+            &Key->Native,
+            RawKey,
+            AeadType == CXPLAT_AEAD_AES_128_GCM ? 16 : 32);
+        *NewKey = Key;
+        return QUIC_STATUS_SUCCESS;
+    }
+#endif
 
-    EVP_CIPHER_CTX* CipherCtx = EVP_CIPHER_CTX_new();
-    if (CipherCtx == NULL) {
+    Key->EncryptCtx = EVP_CIPHER_CTX_new();
+    Key->DecryptCtx = EVP_CIPHER_CTX_new();
+    if (Key->EncryptCtx == NULL || Key->DecryptCtx == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
         goto Exit;
     }
@@ -248,21 +305,22 @@ CxPlatKeyCreate(
         goto Exit;
     }
 
-    TagLength = CXPLAT_IV_LENGTH;
-    AlgParam[0] = OSSL_PARAM_construct_size_t("ivlen", &TagLength);
+    IvLength = CXPLAT_IV_LENGTH;
+    AlgParam[0] = OSSL_PARAM_construct_size_t("ivlen", &IvLength);
     AlgParam[1] = OSSL_PARAM_construct_end();
 
-    if (EVP_CipherInit_ex2(CipherCtx, Aead, RawKey, NULL, 1, AlgParam) != 1) {
+    if (EVP_CipherInit_ex2(Key->EncryptCtx, Aead, RawKey, NULL, 1, AlgParam) != 1 ||
+        EVP_CipherInit_ex2(Key->DecryptCtx, Aead, RawKey, NULL, 0, AlgParam) != 1) {
         Status = QUIC_STATUS_TLS_ERROR;
         goto Exit;
     }
 
-    *NewKey = (CXPLAT_KEY*)CipherCtx;
-    CipherCtx = NULL;
+    *NewKey = Key;
+    Key = NULL;
 
 Exit:
 
-    CxPlatKeyFree((CXPLAT_KEY*)CipherCtx);
+    CxPlatKeyFree(Key);
 
     return Status;
 }
@@ -273,7 +331,16 @@ CxPlatKeyFree(
     _In_opt_ CXPLAT_KEY* Key
     )
 {
-    EVP_CIPHER_CTX_free((EVP_CIPHER_CTX*)Key);
+    if (Key) {
+        EVP_CIPHER_CTX_free(Key->EncryptCtx);
+        EVP_CIPHER_CTX_free(Key->DecryptCtx);
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+        if (Key->UseNative) {
+            CxPlatSecureZeroMemory(&Key->Native, sizeof(Key->Native));
+        }
+#endif
+        CXPLAT_FREE(Key, QUIC_POOL_TLS_KEY);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -297,10 +364,18 @@ CxPlatEncrypt(
     uint8_t *Tag = Buffer + PlainTextLength;
     int OutLen;
 
-    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    if (Key->UseNative) {
+        CxPlatNativeAesGcmSeal(
+            &Key->Native, Iv, AuthDataLength, AuthData, PlainTextLength, Buffer);
+        return QUIC_STATUS_SUCCESS;
+    }
+#endif
+
+    EVP_CIPHER_CTX* CipherCtx = Key->EncryptCtx;
     OSSL_PARAM AlgParam[2];
 
-    if (EVP_EncryptInit_ex(CipherCtx, NULL, NULL, NULL, Iv) != 1) {
+    if (EVP_CipherInit_ex2(CipherCtx, NULL, NULL, Iv, -1, NULL) != 1) {
         return QUIC_STATUS_TLS_ERROR;
     }
 
@@ -347,10 +422,19 @@ CxPlatDecrypt(
     uint8_t *Tag = Buffer + CipherTextLength;
     int OutLen;
 
-    EVP_CIPHER_CTX* CipherCtx = (EVP_CIPHER_CTX*)Key;
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    if (Key->UseNative) {
+        return
+            CxPlatNativeAesGcmOpen(
+                &Key->Native, Iv, AuthDataLength, AuthData, CipherTextLength, Buffer) ?
+            QUIC_STATUS_SUCCESS : QUIC_STATUS_TLS_ERROR;
+    }
+#endif
+
+    EVP_CIPHER_CTX* CipherCtx = Key->DecryptCtx;
     OSSL_PARAM AlgParam[2];
 
-    if (EVP_DecryptInit_ex(CipherCtx, NULL, NULL, NULL, Iv) != 1) {
+    if (EVP_CipherInit_ex2(CipherCtx, NULL, NULL, Iv, -1, NULL) != 1) {
         return QUIC_STATUS_TLS_ERROR;
     }
 
@@ -377,6 +461,97 @@ CxPlatDecrypt(
     return QUIC_STATUS_SUCCESS;
 }
 
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptBegin(
+    _In_ CXPLAT_KEY* Key,
+    _In_reads_bytes_(CXPLAT_IV_LENGTH)
+        const uint8_t* const Iv,
+    _In_ uint16_t AuthDataLength,
+    _In_reads_bytes_opt_(AuthDataLength)
+        const uint8_t* const AuthData,
+    _In_ uint16_t PrefixLength,
+    _Inout_updates_bytes_(PrefixLength)
+        uint8_t* Prefix
+    )
+{
+    int OutLen;
+
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    if (Key->UseNative) {
+        CxPlatNativeAesGcmOpenBegin(
+            &Key->Native, Iv, AuthDataLength, AuthData, PrefixLength, Prefix,
+            &Key->NativeDecryptState);
+        return QUIC_STATUS_SUCCESS;
+    }
+#endif
+
+    EVP_CIPHER_CTX* CipherCtx = Key->DecryptCtx;
+
+    if (EVP_CipherInit_ex2(CipherCtx, NULL, NULL, Iv, -1, NULL) != 1) {
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (AuthData != NULL &&
+        EVP_DecryptUpdate(CipherCtx, NULL, &OutLen, AuthData, (int)AuthDataLength) != 1) {
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (EVP_DecryptUpdate(CipherCtx, Prefix, &OutLen, Prefix, (int)PrefixLength) != 1) {
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatDecryptEnd(
+    _In_ CXPLAT_KEY* Key,
+    _In_ uint16_t CipherTextLength,
+    _In_reads_bytes_(CipherTextLength)
+        const uint8_t* const CipherText,
+    _Out_writes_bytes_(CipherTextLength)
+        uint8_t* Output,
+    _In_reads_bytes_(CXPLAT_ENCRYPTION_OVERHEAD)
+        const uint8_t* const Tag
+    )
+{
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    if (Key->UseNative) {
+        return
+            CxPlatNativeAesGcmOpenEnd(
+                &Key->Native, &Key->NativeDecryptState, CipherTextLength,
+                CipherText, Output, Tag) ?
+            QUIC_STATUS_SUCCESS : QUIC_STATUS_TLS_ERROR;
+    }
+#endif
+
+    EVP_CIPHER_CTX* CipherCtx = Key->DecryptCtx;
+    OSSL_PARAM AlgParam[2];
+    uint8_t FinalOut[CXPLAT_ENCRYPTION_OVERHEAD];
+    int OutLen;
+
+    if (EVP_DecryptUpdate(CipherCtx, Output, &OutLen, CipherText, (int)CipherTextLength) != 1) {
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    AlgParam[0] =
+        OSSL_PARAM_construct_octet_string(
+            "tag", (uint8_t*)Tag, CXPLAT_ENCRYPTION_OVERHEAD);
+    AlgParam[1] = OSSL_PARAM_construct_end();
+
+    if (EVP_CIPHER_CTX_set_params(CipherCtx, AlgParam) != 1) {
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    if (EVP_DecryptFinal_ex(CipherCtx, FinalOut, &OutLen) != 1) {
+        return QUIC_STATUS_TLS_ERROR;
+    }
+
+    return QUIC_STATUS_SUCCESS;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatHpKeyCreate(
@@ -397,6 +572,21 @@ CxPlatHpKeyCreate(
 
     Key->Aead = AeadType;
 
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    Key->UseNative = FALSE;
+    if (CxPlatNativeAesGcmEnabled &&
+        (AeadType == CXPLAT_AEAD_AES_128_GCM || AeadType == CXPLAT_AEAD_AES_256_GCM)) {
+        Key->CipherCtx = NULL;
+        Key->UseNative = TRUE;
+        CxPlatNativeAesInitialize(
+            &Key->Native,
+            RawKey,
+            AeadType == CXPLAT_AEAD_AES_128_GCM ? 16 : 32);
+        *NewKey = Key;
+        return QUIC_STATUS_SUCCESS;
+    }
+#endif
+
     Key->CipherCtx = EVP_CIPHER_CTX_new();
     if (Key->CipherCtx == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
@@ -445,6 +635,11 @@ CxPlatHpKeyFree(
 {
     if (Key != NULL) {
         EVP_CIPHER_CTX_free(Key->CipherCtx);
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+        if (Key->UseNative) {
+            CxPlatSecureZeroMemory(&Key->Native, sizeof(Key->Native));
+        }
+#endif
         CXPLAT_FREE(Key, QUIC_POOL_TLS_HP_KEY);
     }
 }
@@ -460,6 +655,13 @@ CxPlatHpComputeMask(
         uint8_t* Mask
     )
 {
+#ifdef CXPLAT_USE_NATIVE_AES_GCM
+    if (Key->UseNative) {
+        CxPlatNativeAesEncryptBlocks(&Key->Native, BatchSize, Cipher, Mask);
+        return QUIC_STATUS_SUCCESS;
+    }
+#endif
+
     int OutLen = 0;
     if (Key->Aead == CXPLAT_AEAD_CHACHA20_POLY1305) {
         static const uint8_t Zero[] = { 0, 0, 0, 0, 0 };
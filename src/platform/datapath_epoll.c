@@ -93,6 +93,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_BUFFER ClientBuffer;
 
+    //
+    // The earliest departure time (CxPlatTimeUs64) passed to the kernel with
+    // SCM_TXTIME, or 0 to send immediately.
+    //
+    uint64_t TxTimeUs;
+
     //
     // Total number of packet buffers allocated (and iovecs used if !GSO).
     //
@@ -134,6 +140,9 @@ typedef struct CXPLAT_SEND_DATA {
         CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
     #ifdef UDP_SEGMENT
         + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+    #ifdef SO_TXTIME
+        + CMSG_SPACE(sizeof(uint64_t))          // SCM_TXTIME
     #endif
         ];
     CXPLAT_STATIC_ASSERT(
@@ -161,7 +170,8 @@ typedef struct CXPLAT_SEND_DATA {
 
 typedef struct CXPLAT_RECV_MSG_CONTROL_BUFFER {
     char Data[CMSG_SPACE(sizeof(struct in6_pktinfo)) + // IP_PKTINFO
-              3 * CMSG_SPACE(sizeof(int))]; // TOS + IP_TTL
+              3 * CMSG_SPACE(sizeof(int)) + // TOS + IP_TTL
+              CMSG_SPACE(sizeof(struct timespec))]; // SO_TIMESTAMPNS
 
 } CXPLAT_RECV_MSG_CONTROL_BUFFER;
 
@@ -169,6 +179,12 @@ CXPLAT_EVENT_COMPLETION CxPlatSocketContextUninitializeEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatSocketContextFlushTxEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatSocketContextIoEventComplete;
 
+BOOLEAN
+CxPlatProcessorContextFlushTx(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    );
+
 void
 CxPlatProcessorContextInitialize(
     _In_ CXPLAT_DATAPATH* Datapath,
@@ -181,8 +197,27 @@ CxPlatProcessorContextInitialize(
     DatapathPartition->PartitionIndex = PartitionIndex;
     DatapathPartition->EventQ = CxPlatWorkerPoolGetEventQ(Datapath->WorkerPool, PartitionIndex);
     CxPlatRefInitialize(&DatapathPartition->RefCount);
-    CxPlatPoolInitialize(TRUE, Datapath->RecvBlockSize, QUIC_POOL_DATA, &DatapathPartition->RecvBlockPool);
-    CxPlatPoolInitialize(TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
+    const uint16_t NumaNode =
+        CxPlatProcNumaNode(
+            CxPlatWorkerPoolGetIdealProcessor(Datapath->WorkerPool, PartitionIndex));
+    CxPlatPoolInitializeNuma(TRUE, Datapath->RecvBlockSize, QUIC_POOL_DATA, NumaNode, &DatapathPartition->RecvBlockPool);
+    CxPlatPoolInitializeNuma(TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, NumaNode, &DatapathPartition->SendBlockPool);
+    CxPlatPoolEnableHugePages(&DatapathPartition->RecvBlockPool);
+    CxPlatPoolEnableHugePages(&DatapathPartition->SendBlockPool);
+
+    if (Datapath->SendBatching) {
+        //
+        // The flush execution context holds a reference on the partition
+        // until it's shut down.
+        //
+        CxPlatListInitializeHead(&DatapathPartition->TxFlushList);
+        DatapathPartition->TxFlushEc.Context = DatapathPartition;
+        DatapathPartition->TxFlushEc.Callback = CxPlatProcessorContextFlushTx;
+        DatapathPartition->TxFlushEc.NextTimeUs = UINT64_MAX;
+        CxPlatRefIncrement(&DatapathPartition->RefCount);
+        CxPlatWorkerPoolAddExecutionContext(
+            Datapath->WorkerPool, &DatapathPartition->TxFlushEc, PartitionIndex);
+    }
 }
 
 QUIC_STATUS
@@ -196,7 +231,6 @@ DataPathInitialize(
     )
 {
     UNREFERENCED_PARAMETER(TcpCallbacks);
-    UNREFERENCED_PARAMETER(InitConfig);
 
     if (NewDatapath == NULL) {
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -241,6 +275,14 @@ DataPathInitialize(
     Datapath->Features |= CXPLAT_DATAPATH_FEATURE_TCP;
     CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
     CxPlatDataPathCalculateFeatureSupport(Datapath);
+    if (InitConfig->EnableRecvTimestamps) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS;
+    }
+    if (InitConfig->EnableSendTxTime && CxPlatDataPathIsTxTimeSupported()) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+    }
+    Datapath->EdgeTriggered = InitConfig->EnableEdgeTriggered;
+    Datapath->SendBatching = InitConfig->EnableSendBatching;
 
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
         Datapath->SendDataSize = sizeof(CXPLAT_SEND_DATA);
@@ -335,6 +377,11 @@ DataPathUninitialize(
 #endif
         const uint16_t PartitionCount = Datapath->PartitionCount;
         for (uint32_t i = 0; i < PartitionCount; i++) {
+            if (Datapath->SendBatching) {
+                Datapath->Partitions[i].TxFlushShutdown = TRUE;
+                Datapath->Partitions[i].TxFlushEc.Ready = TRUE;
+                CxPlatWakeExecutionContext(&Datapath->Partitions[i].TxFlushEc);
+            }
             CxPlatProcessorContextRelease(&Datapath->Partitions[i]);
         }
     }
@@ -596,6 +643,38 @@ CxPlatSocketContextInitialize(
         }
     #endif
 
+        if (SocketContext->DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS) {
+            Option = TRUE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TIMESTAMPNS,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                Status = errno;
+                goto Exit;
+            }
+        }
+
+    #ifdef SO_TXTIME
+        if (SocketContext->DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME) {
+            struct sock_txtime TxTime = { CLOCK_MONOTONIC, 0 };
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TXTIME,
+                    (const void*)&TxTime,
+                    sizeof(TxTime));
+            if (Result == SOCKET_ERROR) {
+                Status = errno;
+                goto Exit;
+            }
+        }
+    #endif
+
         //
         // The socket is shared by multiple QUIC endpoints, so increase the receive
         // buffer size.
@@ -798,6 +877,11 @@ CxPlatSocketContextUninitializeComplete(
     SocketContext->Freed = TRUE;
 #endif
 
+    if (SocketContext->TxFlushQueued) {
+        CxPlatListEntryRemove(&SocketContext->TxFlushEntry);
+        SocketContext->TxFlushQueued = FALSE;
+    }
+
     while (!CxPlatListIsEmpty(&SocketContext->TxQueue)) {
         CxPlatSendDataFree(
             CXPLAT_CONTAINING_RECORD(
@@ -886,6 +970,12 @@ CxPlatSocketContextSetEvents(
     _In_ uint32_t Events
     )
 {
+    if (SocketContext->DatapathPartition->Datapath->EdgeTriggered &&
+        SocketContext->Binding->Type == CXPLAT_SOCKET_UDP) {
+        Events |= EPOLLET;
+    }
+    SocketContext->EpollEvents = Events;
+
     struct epoll_event SockFdEpEvt = {
         .events = Events, .data = { .ptr = &SocketContext->IoSqe.Sqe, } };
 
@@ -973,7 +1063,12 @@ SocketCreateUdp(
         // round robin, but each flow will be sent to the same socket, just not
         // based on RSS.
         //
-        (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        if (Config->CidSteeringPartitionCount == 0 || SocketCount == 1 ||
+            QUIC_FAILED(
+                CxPlatSocketConfigureCidSteering(
+                    &Binding->SocketContexts[0], SocketCount, Config))) {
+            (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        }
     }
 
     CxPlatConvertFromMappedV6(&Binding->LocalAddress, &Binding->LocalAddress);
@@ -1378,6 +1473,7 @@ CxPlatSocketContextRecvComplete(
         uint8_t TOS = 0;
         int HopLimitTTL = 0;
         uint16_t SegmentLength = 0;
+        uint64_t RecvTimeUs = 0;
         BOOLEAN FoundLocalAddr = FALSE, FoundTOS = FALSE, FoundTTL = FALSE;
         QUIC_ADDR* LocalAddr = &IoBlock->Route.LocalAddress;
         QUIC_ADDR* RemoteAddr = &IoBlock->Route.RemoteAddress;
@@ -1431,6 +1527,13 @@ CxPlatSocketContextRecvComplete(
                     SegmentLength = *(uint16_t*)CMSG_DATA(CMsg);
                 }
 #endif
+            } else if (CMsg->cmsg_level == SOL_SOCKET) {
+                if (CMsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    CXPLAT_DBG_ASSERT_CMSG(CMsg, struct timespec);
+                    struct timespec Timestamp;
+                    CxPlatCopyMemory(&Timestamp, CMSG_DATA(CMsg), sizeof(Timestamp));
+                    RecvTimeUs = CxPlatSocketRecvTimestampToUs(&Timestamp);
+                }
             } else {
                 CXPLAT_DBG_ASSERT(FALSE);
             }
@@ -1471,10 +1574,12 @@ CxPlatSocketContextRecvComplete(
             RecvData->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
             RecvData->TypeOfService = TOS;
             RecvData->HopLimitTTL = (uint8_t)HopLimitTTL;
+            RecvData->RecvTimeUs = RecvTimeUs;
             RecvData->Allocated = TRUE;
             RecvData->Route->DatapathType = RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             RecvData->QueuedOnConnection = FALSE;
             RecvData->Reserved = FALSE;
+            RecvData->Decrypted = FALSE;
 
             *DatagramTail = RecvData;
             DatagramTail = &RecvData->Next;
@@ -1503,64 +1608,16 @@ CxPlatSocketContextRecvComplete(
     }
 }
 
-void
-CxPlatSocketReceiveCoalesced(
-    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
-    )
-{
-    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
-    DATAPATH_RX_IO_BLOCK* IoBlock = NULL;
-    struct mmsghdr RecvMsgHdr;
-    CXPLAT_RECV_MSG_CONTROL_BUFFER RecvMsgControl;
-    struct iovec RecvIov;
-
-    do {
-        uint32_t RetryCount = 0;
-        do {
-            IoBlock = CxPlatPoolAlloc(&DatapathPartition->RecvBlockPool);
-        } while (IoBlock == NULL && ++RetryCount < 10);
-        if (IoBlock == NULL) {
-            goto Exit;
-        }
-
-        CxPlatZeroMemory(&IoBlock->Route, sizeof(CXPLAT_ROUTE));
-        IoBlock->Route.State = RouteResolved;
-
-        struct msghdr* MsgHdr = &RecvMsgHdr.msg_hdr;
-        MsgHdr->msg_name = &IoBlock->Route.RemoteAddress;
-        MsgHdr->msg_namelen = sizeof(IoBlock->Route.RemoteAddress);
-        MsgHdr->msg_iov = &RecvIov;
-        MsgHdr->msg_iovlen = 1;
-        MsgHdr->msg_control = &RecvMsgControl.Data;
-        MsgHdr->msg_controllen = sizeof(RecvMsgControl.Data);
-        MsgHdr->msg_flags = 0;
-        RecvIov.iov_base = (char*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset;
-        RecvIov.iov_len = CXPLAT_LARGE_IO_BUFFER_SIZE;
-
-        int Ret =
-            recvmmsg(
-                SocketContext->SocketFd,
-                &RecvMsgHdr,
-                1,
-                0,
-                NULL);
-        if (Ret < 0) {
-            if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            }
-            break;
-        }
-
-        CXPLAT_DBG_ASSERT(Ret == 1);
-        CxPlatSocketContextRecvComplete(SocketContext, &IoBlock, &RecvMsgHdr, Ret);
-
-    } while (TRUE);
-
-Exit:
+//
+// The most recvmmsg calls made for a single receive notification, so one busy
+// socket can't starve the others on the partition.
+//
+#define CXPLAT_RECV_CALL_BUDGET 16
 
-    if (IoBlock) {
-        CxPlatPoolFree(IoBlock);
-    }
-}
+//
+// The most GRO sized buffers posted to a single recvmmsg call.
+//
+#define CXPLAT_MAX_COALESCED_RECV_BATCH_SIZE 8
 
 void
 CxPlatSocketReceiveMessages(
@@ -1568,15 +1625,33 @@ CxPlatSocketReceiveMessages(
     )
 {
     CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    CXPLAT_DATAPATH* Datapath = DatapathPartition->Datapath;
+    const BOOLEAN Coalesced =
+        !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING);
+    const uint16_t MaxBatchSize =
+        Coalesced ? CXPLAT_MAX_COALESCED_RECV_BATCH_SIZE : CXPLAT_MAX_IO_BATCH_SIZE;
     DATAPATH_RX_IO_BLOCK* IoBlocks[CXPLAT_MAX_IO_BATCH_SIZE];
     struct mmsghdr RecvMsgHdr[CXPLAT_MAX_IO_BATCH_SIZE];
     CXPLAT_RECV_MSG_CONTROL_BUFFER RecvMsgControl[CXPLAT_MAX_IO_BATCH_SIZE];
     struct iovec RecvIov[CXPLAT_MAX_IO_BATCH_SIZE];
+    BOOLEAN Drained = FALSE;
     CxPlatZeroMemory(IoBlocks, sizeof(IoBlocks));
 
-    do {
+    for (uint32_t Calls = 0; Calls < CXPLAT_RECV_CALL_BUDGET; ++Calls) {
+        uint16_t BatchSize = SocketContext->RecvBatchSize;
+        if (BatchSize == 0 || BatchSize > MaxBatchSize) {
+            BatchSize = MaxBatchSize;
+        }
+
+        //
+        // Only post as many buffers as the batch size; any left over from
+        // the previous call are still set up and are reused.
+        //
         uint32_t RetryCount = 0;
-        for (uint32_t i = 0; i < CXPLAT_MAX_IO_BATCH_SIZE && IoBlocks[i] == NULL; ++i) {
+        for (uint32_t i = 0; i < BatchSize; ++i) {
+            if (IoBlocks[i] != NULL) {
+                continue;
+            }
 
             DATAPATH_RX_IO_BLOCK* IoBlock;
             do {
@@ -1598,30 +1673,55 @@ CxPlatSocketReceiveMessages(
             MsgHdr->msg_control = &RecvMsgControl[i].Data;
             MsgHdr->msg_controllen = sizeof(RecvMsgControl[i].Data);
             MsgHdr->msg_flags = 0;
-            RecvIov[i].iov_base = (char*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset;
-            RecvIov[i].iov_len = CXPLAT_SMALL_IO_BUFFER_SIZE;
+            RecvIov[i].iov_base = (char*)IoBlock + Datapath->RecvBlockBufferOffset;
+            RecvIov[i].iov_len =
+                Coalesced ? CXPLAT_LARGE_IO_BUFFER_SIZE : CXPLAT_SMALL_IO_BUFFER_SIZE;
         }
 
         int Ret =
             recvmmsg(
                 SocketContext->SocketFd,
                 RecvMsgHdr,
-                (int)CXPLAT_MAX_IO_BATCH_SIZE,
+                (int)BatchSize,
                 0,
                 NULL);
         if (Ret < 0) {
             if (errno != EAGAIN && errno != EWOULDBLOCK) {
             }
+            Drained = TRUE;
             break;
         }
 
-        CXPLAT_DBG_ASSERT(Ret <= CXPLAT_MAX_IO_BATCH_SIZE);
-        CxPlatSocketContextRecvComplete(SocketContext, IoBlocks, RecvMsgHdr, Ret);
+        CXPLAT_DBG_ASSERT(Ret <= BatchSize);
+        DatapathPartition->RecvCallCount++;
+        DatapathPartition->RecvMessageCount += (uint64_t)Ret;
 
-    } while (TRUE);
+        //
+        // Size the next batch from the yield of this one: grow when the
+        // batch filled up, shrink when it was mostly unused.
+        //
+        if (Ret == BatchSize && BatchSize < MaxBatchSize) {
+            SocketContext->RecvBatchSize = (uint16_t)CXPLAT_MIN(BatchSize * 2, MaxBatchSize);
+        } else if (Ret * 4 <= BatchSize && BatchSize > 1) {
+            SocketContext->RecvBatchSize = BatchSize / 2;
+        } else {
+            SocketContext->RecvBatchSize = BatchSize;
+        }
+
+        CxPlatSocketContextRecvComplete(SocketContext, IoBlocks, RecvMsgHdr, Ret);
+    }
 
 Exit:
 
+    if (!Drained && Datapath->EdgeTriggered) {
+        //
+        // An edge triggered socket that still has data queued won't be
+        // signaled again on its own, so rearm it.
+        //
+        CxPlatSocketContextSetEvents(
+            SocketContext, EPOLL_CTL_MOD, SocketContext->EpollEvents);
+    }
+
     for (uint32_t i = 0; i < CXPLAT_MAX_IO_BATCH_SIZE; ++i) {
         if (IoBlocks[i]) {
             CxPlatPoolFree(IoBlocks[i]);
@@ -1682,6 +1782,7 @@ CxPlatSocketReceiveTcpData(
             Data->Route = &IoBlock->Route;
             Data->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
             Data->TypeOfService = 0;
+            Data->RecvTimeUs = 0;
             Data->Allocated = TRUE;
             Data->Route->DatapathType = Data->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             Data->QueuedOnConnection = FALSE;
@@ -1707,11 +1808,7 @@ CxPlatSocketReceive(
     )
 {
     if (SocketContext->Binding->Type == CXPLAT_SOCKET_UDP) {
-        if (SocketContext->DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
-            CxPlatSocketReceiveCoalesced(SocketContext);
-        } else {
-            CxPlatSocketReceiveMessages(SocketContext);
-        }
+        CxPlatSocketReceiveMessages(SocketContext);
     } else {
         CxPlatSocketReceiveTcpData(SocketContext);
     }
@@ -1770,6 +1867,9 @@ SendDataAlloc(
         SendData->ControlBufferLength = 0;
         SendData->ECN = Config->ECN;
         SendData->DSCP = Config->DSCP;
+        SendData->TxTimeUs =
+            (Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME)
+                ? Config->TxTimeUs : 0;
         SendData->Flags = Config->Flags;
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
@@ -1807,10 +1907,15 @@ CxPlatSendDataFinalizeSendBuffer(
     SendData->BufferCount++;
     SendData->TotalSize += SendData->ClientBuffer.Length;
     if (SendData->SegmentationSupported) {
+        //
+        // All segments but the last must be SegmentSize, so a short buffer
+        // ends the send as its tail segment.
+        //
         SendData->Iovs[0].iov_len += SendData->ClientBuffer.Length;
         if (SendData->SegmentSize == 0 ||
             SendData->ClientBuffer.Length < SendData->SegmentSize ||
-            SendData->TotalSize + SendData->SegmentSize > sizeof(SendData->Buffer)) {
+            SendData->TotalSize + SendData->SegmentSize > sizeof(SendData->Buffer) ||
+            SendData->BufferCount == CXPLAT_MAX_GSO_SEGMENTS) {
             SendData->ClientBuffer.Buffer = NULL;
         } else {
             SendData->ClientBuffer.Buffer += SendData->SegmentSize;
@@ -1884,6 +1989,34 @@ CxPlatSendDataSend(
     _In_ CXPLAT_SEND_DATA* SendData
     );
 
+//
+// Schedules a flush of the socket context's (newly non-empty) send queue. On
+// the partition's own thread, the flush is left to the end of the current
+// worker pass, so all the sends queued during the pass go out together
+// without a trip through the event queue.
+//
+void
+CxPlatSocketContextQueueFlushTx(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    if (DatapathPartition->Datapath->SendBatching &&
+        CxPlatWorkerIsThisThread(&DatapathPartition->TxFlushEc)) {
+        if (!SocketContext->TxFlushQueued) {
+            SocketContext->TxFlushQueued = TRUE;
+            CxPlatListInsertTail(&DatapathPartition->TxFlushList, &SocketContext->TxFlushEntry);
+        }
+        DatapathPartition->TxFlushEc.Ready = TRUE;
+        CxPlatWakeExecutionContext(&DatapathPartition->TxFlushEc);
+    } else {
+        CXPLAT_FRE_ASSERT(
+            CxPlatEventQEnqueue(
+                DatapathPartition->EventQ,
+                &SocketContext->FlushTxSqe));
+    }
+}
+
 void
 SocketSend(
     _In_ CXPLAT_SOCKET* Socket,
@@ -1905,24 +2038,28 @@ SocketSend(
     SendData->LocalAddress = Route->LocalAddress;
 
     //
-    // Check to see if we need to pend because there's already queue.
+    // Check to see if we need to pend because there's already queue. With
+    // send batching, sends on unconnected UDP sockets are always queued, so
+    // that the sends of all the connections sharing the socket in a worker
+    // pass go out in one sendmmsg call when the queue is flushed.
     //
     BOOLEAN SendPending = FALSE, FlushTxQueue = FALSE;
     CXPLAT_SOCKET_CONTEXT* SocketContext = SendData->SocketContext;
+    const BOOLEAN Batch =
+        Socket->Datapath->SendBatching &&
+        Socket->Type == CXPLAT_SOCKET_UDP &&
+        !SendData->OnConnectedSocket;
     CxPlatLockAcquire(&SocketContext->TxQueueLock);
     if (/*SendData->Flags & CXPLAT_SEND_FLAGS_MAX_THROUGHPUT ||*/
-        !CxPlatListIsEmpty(&SocketContext->TxQueue)) {
-        FlushTxQueue = CxPlatListIsEmpty(&SocketContext->TxQueue);
+        Batch || !CxPlatListIsEmpty(&SocketContext->TxQueue)) {
+        FlushTxQueue = Batch && CxPlatListIsEmpty(&SocketContext->TxQueue);
         CxPlatListInsertTail(&SocketContext->TxQueue, &SendData->TxEntry);
         SendPending = TRUE;
     }
     CxPlatLockRelease(&SocketContext->TxQueueLock);
     if (SendPending) {
         if (FlushTxQueue) {
-            CXPLAT_FRE_ASSERT(
-                CxPlatEventQEnqueue(
-                    SocketContext->DatapathPartition->EventQ,
-                    &SocketContext->FlushTxSqe));
+            CxPlatSocketContextQueueFlushTx(SocketContext);
         }
         return;
     }
@@ -2011,28 +2148,67 @@ CxPlatSendDataPopulateAncillaryData(
     }
 #endif
 
+#ifdef SO_TXTIME
+    if (SendData->TxTimeUs != 0) {
+        //
+        // Applies to the whole message, so all the segments of a GSO send
+        // leave together and the qdisc paces at the granularity of the send.
+        //
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *((uint64_t*)CMSG_DATA(CMsg)) = US_TO_NS(SendData->TxTimeUs);
+    }
+#endif
+
     CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
 
+void
+CxPlatSendDataBuildMessage(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ struct iovec* Iov,
+    _Out_ struct msghdr* Mhdr
+    )
+{
+    Mhdr->msg_name = (void*)&SendData->RemoteAddress;
+    Mhdr->msg_namelen = sizeof(SendData->RemoteAddress);
+    Mhdr->msg_iov = Iov;
+    Mhdr->msg_iovlen = 1;
+    Mhdr->msg_flags = 0;
+    Mhdr->msg_control = SendData->ControlBuffer;
+    if (SendData->ControlBufferLength == 0) {
+        CxPlatSendDataPopulateAncillaryData(SendData, Mhdr);
+    } else {
+        Mhdr->msg_controllen = SendData->ControlBufferLength;
+    }
+}
+
+//
+// The number of messages needed to send the remainder of the send data: one
+// for a segmented send, or one per (unsent) buffer otherwise.
+//
+QUIC_INLINE
+uint16_t
+CxPlatSendDataMessageCount(
+    _In_ const CXPLAT_SEND_DATA* SendData
+    )
+{
+    return
+        SendData->SegmentationSupported ?
+            1 : SendData->BufferCount - SendData->AlreadySentCount;
+}
+
 BOOLEAN
 CxPlatSendDataSendSegmented(
     _In_ CXPLAT_SEND_DATA* SendData
     )
 {
     struct msghdr msghdr;
-    msghdr.msg_name = (void*)&SendData->RemoteAddress;
-    msghdr.msg_namelen = sizeof(SendData->RemoteAddress);
-    msghdr.msg_iov = SendData->Iovs;
-    msghdr.msg_iovlen = 1;
-    msghdr.msg_flags = 0;
-    msghdr.msg_control = SendData->ControlBuffer;
-    msghdr.msg_controllen = SendData->ControlBufferLength;
-    if (SendData->ControlBufferLength == 0) {
-        CxPlatSendDataPopulateAncillaryData(SendData, &msghdr);
-    } else {
-        msghdr.msg_controllen = SendData->ControlBufferLength;
-    }
+    CxPlatSendDataBuildMessage(SendData, SendData->Iovs, &msghdr);
 
     if (sendmsg(SendData->SocketContext->SocketFd, &msghdr, 0) < 0) {
         return FALSE;
@@ -2074,21 +2250,8 @@ CxPlatSendDataSendMessages(
 {
     struct mmsghdr Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
     for (uint16_t i = SendData->AlreadySentCount; i < SendData->BufferCount; ++i) {
-        struct msghdr* Mhdr = &Mhdrs[i].msg_hdr;
         Mhdrs[i].msg_len = 0;
-        Mhdr->msg_name = (void*)&SendData->RemoteAddress;
-        Mhdr->msg_namelen = sizeof(SendData->RemoteAddress);
-        Mhdr->msg_iov = SendData->Iovs + i;
-        Mhdr->msg_iovlen = 1;
-        Mhdr->msg_flags = 0;
-        Mhdr->msg_control = SendData->ControlBuffer;
-        Mhdr->msg_controllen = SendData->ControlBufferLength;
-
-        if (SendData->ControlBufferLength == 0) {
-            CxPlatSendDataPopulateAncillaryData(SendData, Mhdr);
-        } else {
-            Mhdr->msg_controllen = SendData->ControlBufferLength;
-        }
+        CxPlatSendDataBuildMessage(SendData, SendData->Iovs + i, &Mhdrs[i].msg_hdr);
     }
 
     while (SendData->AlreadySentCount < SendData->BufferCount) {
@@ -2198,6 +2361,94 @@ CxPlatSendDataSend(
     return Status;
 }
 
+//
+// Sends the messages of as many queued (UDP) sends as fit in a single
+// sendmmsg call, and completes the ones fully sent. Returns FALSE if the send
+// at the head of the queue couldn't be (fully) sent, leaving it to the caller
+// to retry it on its own and handle the error.
+//
+// N.B. Only the EventQ thread removes sends from the queue, so the ones
+// collected here stay at its head while the lock is released.
+//
+BOOLEAN
+CxPlatSocketContextSendBatch(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_SEND_DATA* Batch[CXPLAT_MAX_IO_BATCH_SIZE];
+    struct mmsghdr Mhdrs[CXPLAT_MAX_IO_BATCH_SIZE];
+    uint32_t SendCount = 0, MessageCount = 0;
+
+    CxPlatLockAcquire(&SocketContext->TxQueueLock);
+    for (CXPLAT_LIST_ENTRY* Entry = SocketContext->TxQueue.Flink;
+         Entry != &SocketContext->TxQueue;
+         Entry = Entry->Flink) {
+        CXPLAT_SEND_DATA* SendData =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_SEND_DATA, TxEntry);
+        if (MessageCount + CxPlatSendDataMessageCount(SendData) > CXPLAT_MAX_IO_BATCH_SIZE) {
+            break;
+        }
+        Batch[SendCount++] = SendData;
+        MessageCount += CxPlatSendDataMessageCount(SendData);
+    }
+    CxPlatLockRelease(&SocketContext->TxQueueLock);
+
+    uint32_t MessageIndex = 0;
+    for (uint32_t i = 0; i < SendCount; ++i) {
+        CXPLAT_SEND_DATA* SendData = Batch[i];
+        if (SendData->SegmentationSupported) {
+            Mhdrs[MessageIndex].msg_len = 0;
+            CxPlatSendDataBuildMessage(
+                SendData, SendData->Iovs, &Mhdrs[MessageIndex++].msg_hdr);
+        } else {
+            for (uint16_t j = SendData->AlreadySentCount; j < SendData->BufferCount; ++j) {
+                Mhdrs[MessageIndex].msg_len = 0;
+                CxPlatSendDataBuildMessage(
+                    SendData, SendData->Iovs + j, &Mhdrs[MessageIndex++].msg_hdr);
+            }
+        }
+    }
+
+    uint32_t SentCount = 0;
+    while (SentCount < MessageCount) {
+        int Result =
+            cxplat_sendmmsg(
+                SocketContext->SocketFd,
+                Mhdrs + SentCount,
+                MessageCount - SentCount,
+                0);
+        CXPLAT_FRE_ASSERT(Result != 0);
+        if (Result < 0) {
+            break;
+        }
+        SentCount += (uint32_t)Result;
+    }
+
+    //
+    // Account for the sent messages, completing the sends that are done.
+    //
+    uint32_t CompletedCount = 0;
+    for (uint32_t i = 0; i < SendCount && SentCount > 0; ++i) {
+        CXPLAT_SEND_DATA* SendData = Batch[i];
+        const uint16_t Count = CxPlatSendDataMessageCount(SendData);
+        if (SentCount < Count) {
+            SendData->AlreadySentCount += (uint16_t)SentCount; // Partial, non-segmented
+            break;
+        }
+        SentCount -= Count;
+        CompletedCount++;
+    }
+
+    for (uint32_t i = 0; i < CompletedCount; ++i) {
+        CxPlatLockAcquire(&SocketContext->TxQueueLock);
+        CxPlatListRemoveHead(&SocketContext->TxQueue);
+        CxPlatLockRelease(&SocketContext->TxQueueLock);
+        CxPlatSendDataFree(Batch[i]);
+    }
+
+    return CompletedCount != 0;
+}
+
 //
 // Returns TRUE if the queue was completely drained, and FALSE if there are
 // still pending sends.
@@ -2220,6 +2471,22 @@ CxPlatSocketContextFlushTxQueue(
     CxPlatLockRelease(&SocketContext->TxQueueLock);
 
     while (SendData != NULL) {
+        if (SocketContext->Binding->Type == CXPLAT_SOCKET_UDP &&
+            CxPlatSocketContextSendBatch(SocketContext)) {
+            CxPlatLockAcquire(&SocketContext->TxQueueLock);
+            if (!CxPlatListIsEmpty(&SocketContext->TxQueue)) {
+                SendData =
+                    CXPLAT_CONTAINING_RECORD(
+                        SocketContext->TxQueue.Flink,
+                        CXPLAT_SEND_DATA,
+                        TxEntry);
+            } else {
+                SendData = NULL;
+            }
+            CxPlatLockRelease(&SocketContext->TxQueueLock);
+            continue;
+        }
+
         QUIC_STATUS Status = CxPlatSendDataSend(SendData);
         if (Status == QUIC_STATUS_PENDING) {
             if (!SendAlreadyPending) {
@@ -2271,6 +2538,38 @@ CxPlatSocketContextFlushTxEventComplete(
     CxPlatSocketContextFlushTxQueue(SocketContext, FALSE);
 }
 
+//
+// Runs at the end of the worker pass (as an execution context) to flush the
+// send queues of the socket contexts that sends were queued on during it.
+//
+BOOLEAN
+CxPlatProcessorContextFlushTx(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = (CXPLAT_DATAPATH_PARTITION*)Context;
+    UNREFERENCED_PARAMETER(State);
+
+    if (DatapathPartition->TxFlushShutdown) {
+        CXPLAT_DBG_ASSERT(CxPlatListIsEmpty(&DatapathPartition->TxFlushList));
+        CxPlatProcessorContextRelease(DatapathPartition);
+        return FALSE;
+    }
+
+    while (!CxPlatListIsEmpty(&DatapathPartition->TxFlushList)) {
+        CXPLAT_SOCKET_CONTEXT* SocketContext =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&DatapathPartition->TxFlushList),
+                CXPLAT_SOCKET_CONTEXT,
+                TxFlushEntry);
+        SocketContext->TxFlushQueued = FALSE;
+        CxPlatSocketContextFlushTxQueue(SocketContext, FALSE);
+    }
+
+    return TRUE;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 QUIC_STATUS
 CxPlatSocketGetTcpStatistics(
@@ -51,6 +51,11 @@ typedef struct __attribute__((aligned(CXPLAT_MEMORY_ALIGNMENT))) DATAPATH_RX_IO_
     //
     CXPLAT_DATAPATH_PARTITION* DatapathPartition;
 
+    //
+    // The registered buffer pool this packet is allocated from.
+    //
+    CXPLAT_REGISTERED_BUFFER_POOL* Pool;
+
     //
     // An array of packets to represent the datagram and metadata returned to
     // the app.
@@ -126,6 +131,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     QUIC_BUFFER ClientBuffer;
 
+    //
+    // The earliest departure time (CxPlatTimeUs64) passed to the kernel with
+    // SCM_TXTIME, or 0 to send immediately.
+    //
+    uint64_t TxTimeUs;
+
     //
     // Total number of packet buffers allocated (and iovecs used if !GSO).
     //
@@ -158,6 +169,12 @@ typedef struct CXPLAT_SEND_DATA {
     //
     uint8_t SegmentationSupported : 1;
 
+    //
+    // Indicates the send was submitted as zero-copy, so the buffers must be
+    // kept until the kernel's notification completion.
+    //
+    uint8_t ZeroCopy : 1;
+
     //
     // The message header for the send.
     //
@@ -172,6 +189,9 @@ typedef struct CXPLAT_SEND_DATA {
         CMSG_SPACE(sizeof(struct in6_pktinfo))  // IP_PKTINFO || IPV6_PKTINFO
     #ifdef UDP_SEGMENT
         + CMSG_SPACE(sizeof(uint16_t))          // UDP_SEGMENT
+    #endif
+    #ifdef SO_TXTIME
+        + CMSG_SPACE(sizeof(uint64_t))          // SCM_TXTIME
     #endif
         ];
     CXPLAT_STATIC_ASSERT(
@@ -203,12 +223,14 @@ typedef struct CXPLAT_SEND_DATA {
 
 typedef struct CXPLAT_RECV_MSG_CONTROL_BUFFER {
     char Data[CMSG_SPACE(sizeof(struct in6_pktinfo)) + // IP_PKTINFO
-              3 * CMSG_SPACE(sizeof(int))]; // TOS + IP_TTL
+              3 * CMSG_SPACE(sizeof(int)) + // TOS + IP_TTL
+              CMSG_SPACE(sizeof(struct timespec))]; // SO_TIMESTAMPNS
 
 } CXPLAT_RECV_MSG_CONTROL_BUFFER;
 
 CXPLAT_EVENT_COMPLETION CxPlatSocketContextUninitializeEventComplete;
 CXPLAT_EVENT_BATCH_COMPLETION CxPlatSocketContextIoEventComplete;
+CXPLAT_EVENT_COMPLETION CxPlatSocketContextRecvCancelEventComplete;
 
 const struct msghdr CxPlatRecvMsgHdr = {
     .msg_namelen = ALIGN_UP_BY(sizeof(QUIC_ADDR), CXPLAT_MEMORY_ALIGNMENT),
@@ -216,6 +238,24 @@ const struct msghdr CxPlatRecvMsgHdr = {
 };
 const uint32_t RecvBufCount = 1024;
 
+//
+// The number of GRO sized receive buffers. These are around 40 times larger
+// than the non-GRO ones, so fewer of them are kept, with RecvBufCount
+// non-GRO buffers as a fallback for when they run out.
+//
+const uint32_t RecvGroBufCount = 256;
+
+//
+// The minimum number of bytes in a send for it to use zero-copy. Below this,
+// pinning the pages and the extra notification cost more than the copy.
+//
+#define CXPLAT_SEND_ZERO_COPY_MIN_LENGTH 8192
+
+//
+// The size of each partition's registered file table.
+//
+#define CXPLAT_FIXED_FILE_COUNT 1024
+
 void
 CxPlatSocketIoStart(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -271,7 +311,11 @@ CxPlatFreeBufferPool(
         Pool->Buffers = NULL;
     }
     if (Pool->Ring != NULL) {
-        free(Pool->Ring);
+        if (Pool->HugePages) {
+            CxPlatFreeHugePages(Pool->Ring, Pool->TotalSize);
+        } else {
+            CxPlatFreeNuma(Pool->Ring, Pool->TotalSize, QUIC_POOL_DATA, Pool->NumaNode);
+        }
         Pool->Ring = NULL;
     }
 }
@@ -294,7 +338,22 @@ CxPlatCreateBufferPool(
     CxPlatLockInitialize(&Pool->Lock);
 
     Pool->TotalSize = BufferCount * (sizeof(struct io_uring_buf) + BufferSize);
-    if (posix_memalign(&Pool->Ring, getpagesize(), Pool->TotalSize)) {
+    Pool->NumaNode =
+        CxPlatProcNumaNode(
+            CxPlatWorkerPoolGetIdealProcessor(
+                DatapathPartition->Datapath->WorkerPool, DatapathPartition->PartitionIndex));
+
+    //
+    // Prefer huge pages for the (large, long lived) ring; they aren't NUMA
+    // aware, but the saved TLB misses matter more for a buffer this size.
+    //
+    Pool->Ring = CxPlatAllocHugePages(Pool->TotalSize);
+    if (Pool->Ring != NULL) {
+        Pool->HugePages = TRUE;
+    } else {
+        Pool->Ring = CxPlatAllocNuma(Pool->TotalSize, QUIC_POOL_DATA, Pool->NumaNode);
+    }
+    if (Pool->Ring == NULL) {
         Status = QUIC_STATUS_OUT_OF_MEMORY;
         goto Exit;
     }
@@ -313,13 +372,9 @@ CxPlatCreateBufferPool(
             goto Exit;
     }
 
-    //
-    // Review: we may also want to io_uring_register_buffers for
-    // io_uring_prep_send_zc_fixed.
-    //
-
     Pool->Buffers = (uint8_t*)Pool->Ring + sizeof(struct io_uring_buf) * BufferCount;
     Pool->BufferSize = BufferSize;
+    Pool->BufferCount = BufferCount;
 
 Exit:
 
@@ -330,6 +385,165 @@ Exit:
     return Status;
 }
 
+//
+// Creates the (sparse) registered file table for the partition's io_uring. On
+// failure, socket fds just aren't registered.
+//
+void
+CxPlatProcessorContextInitializeFixedFiles(
+    _Inout_ CXPLAT_DATAPATH_PARTITION* DatapathPartition
+    )
+{
+    BOOLEAN* FixedFileSlots =
+        CXPLAT_ALLOC_NONPAGED(CXPLAT_FIXED_FILE_COUNT * sizeof(BOOLEAN), QUIC_POOL_DATAPATH);
+    if (FixedFileSlots == NULL) {
+        return;
+    }
+    CxPlatZeroMemory(FixedFileSlots, CXPLAT_FIXED_FILE_COUNT * sizeof(BOOLEAN));
+
+    if (io_uring_register_files_sparse(
+            &DatapathPartition->EventQ->Ring, CXPLAT_FIXED_FILE_COUNT) != 0) {
+        CXPLAT_FREE(FixedFileSlots, QUIC_POOL_DATAPATH);
+        return;
+    }
+
+    DatapathPartition->FixedFileSlots = FixedFileSlots;
+}
+
+//
+// Registers the socket's fd in a free slot of the partition's registered file
+// table, if it has one.
+//
+void
+CxPlatSocketContextRegisterFixedFile(
+    _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    SocketContext->FixedFileIndex = -1;
+    if (DatapathPartition->FixedFileSlots == NULL) {
+        return;
+    }
+
+    CxPlatLockAcquire(&DatapathPartition->EventQ->Lock);
+    for (int i = 0; i < CXPLAT_FIXED_FILE_COUNT; ++i) {
+        if (!DatapathPartition->FixedFileSlots[i]) {
+            if (io_uring_register_files_update(
+                    &DatapathPartition->EventQ->Ring, (unsigned)i,
+                    &SocketContext->SocketFd, 1) == 1) {
+                DatapathPartition->FixedFileSlots[i] = TRUE;
+                SocketContext->FixedFileIndex = i;
+            }
+            break;
+        }
+    }
+    CxPlatLockRelease(&DatapathPartition->EventQ->Lock);
+}
+
+void
+CxPlatSocketContextUnregisterFixedFile(
+    _Inout_ CXPLAT_SOCKET_CONTEXT* SocketContext
+    )
+{
+    CXPLAT_DATAPATH_PARTITION* DatapathPartition = SocketContext->DatapathPartition;
+    if (SocketContext->FixedFileIndex < 0) {
+        return;
+    }
+
+    int Fd = -1;
+    CxPlatLockAcquire(&DatapathPartition->EventQ->Lock);
+    (void)io_uring_register_files_update(
+        &DatapathPartition->EventQ->Ring, (unsigned)SocketContext->FixedFileIndex, &Fd, 1);
+    DatapathPartition->FixedFileSlots[SocketContext->FixedFileIndex] = FALSE;
+    CxPlatLockRelease(&DatapathPartition->EventQ->Lock);
+    SocketContext->FixedFileIndex = -1;
+}
+
+//
+// Points the SQE at the socket's registered file, if it has one, instead of
+// its fd.
+//
+QUIC_INLINE
+void
+CxPlatSocketContextSetFixedFile(
+    _In_ const CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _Inout_ struct io_uring_sqe* Sqe
+    )
+{
+    if (SocketContext->FixedFileIndex >= 0) {
+        Sqe->fd = SocketContext->FixedFileIndex;
+        Sqe->flags |= IOSQE_FIXED_FILE;
+    }
+}
+
+QUIC_STATUS
+CxPlatRecvBufferPoolInitialize(
+    _In_ CXPLAT_DATAPATH_PARTITION* DatapathPartition,
+    _In_ uint32_t BufferSize,
+    _In_ uint32_t BufferCount,
+    _In_ CXPLAT_IO_RING_BUF_GROUP BufferGroup,
+    _Out_ CXPLAT_REGISTERED_BUFFER_POOL* Pool
+    )
+{
+    const uint32_t BufferOffset = DatapathPartition->Datapath->RecvBlockBufferOffset;
+    QUIC_STATUS Status =
+        CxPlatCreateBufferPool(DatapathPartition, BufferSize, BufferCount, BufferGroup, Pool);
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    for (uint32_t i = 0; i < BufferCount; i++) {
+        DATAPATH_RX_IO_BLOCK* IoBlock =
+            (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(Pool, i);
+        IoBlock->BufferIndex = i;
+        IoBlock->DatapathPartition = DatapathPartition;
+        IoBlock->Pool = Pool;
+        io_uring_buf_ring_add(
+            Pool->Ring,
+            (uint8_t*)IoBlock + BufferOffset,
+            CxPlatGetBufferPoolBufferSize(Pool) - BufferOffset,
+            i, io_uring_buf_ring_mask(BufferCount), i);
+    }
+    io_uring_buf_ring_advance(Pool->Ring, BufferCount);
+    Pool->AvailableCount = BufferCount;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Returns a run of receive buffers to the pool's ring, started with
+// CxPlatLockAcquire(&Pool->Lock) and filled with io_uring_buf_ring_add, with a
+// single tail update.
+//
+void
+CxPlatRecvBufferPoolReturnEnd(
+    _In_opt_ CXPLAT_REGISTERED_BUFFER_POOL* Pool,
+    _In_ uint32_t Count
+    )
+{
+    if (Pool != NULL) {
+        io_uring_buf_ring_advance(Pool->Ring, (int)Count);
+        InterlockedExchangeAdd64(&Pool->AvailableCount, (int64_t)Count);
+        CxPlatLockRelease(&Pool->Lock);
+    }
+}
+
+void
+CxPlatRecvBufferReturn(
+    _In_ DATAPATH_RX_IO_BLOCK* IoBlock
+    )
+{
+    CXPLAT_REGISTERED_BUFFER_POOL* Pool = IoBlock->Pool;
+    const uint32_t BufferOffset = IoBlock->DatapathPartition->Datapath->RecvBlockBufferOffset;
+    CxPlatLockAcquire(&Pool->Lock);
+    io_uring_buf_ring_add(
+        Pool->Ring,
+        (uint8_t*)IoBlock + BufferOffset,
+        CxPlatGetBufferPoolBufferSize(Pool) - BufferOffset,
+        IoBlock->BufferIndex, io_uring_buf_ring_mask(Pool->BufferCount), 0);
+    CxPlatRecvBufferPoolReturnEnd(Pool, 1);
+}
+
 QUIC_STATUS
 CxPlatProcessorContextInitialize(
     _In_ CXPLAT_DATAPATH* Datapath,
@@ -348,28 +562,34 @@ CxPlatProcessorContextInitialize(
     CxPlatPoolInitialize(
         TRUE, Datapath->SendDataSize, QUIC_POOL_DATA, &DatapathPartition->SendBlockPool);
 
-    Status =
-        CxPlatCreateBufferPool(
-            DatapathPartition, Datapath->RecvBlockSize, RecvBufCount,
-            CxPlatIoRingBufGroupRecv, &DatapathPartition->RecvRegisteredBufferPool);
-    if (QUIC_FAILED(Status)) {
-        goto Exit;
-    }
+    if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_COALESCING) {
+        Status =
+            CxPlatRecvBufferPoolInitialize(
+                DatapathPartition, Datapath->RecvBlockSize, RecvGroBufCount,
+                CxPlatIoRingBufGroupRecv, &DatapathPartition->RecvRegisteredBufferPool);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
 
-    for (uint32_t i = 0; i < RecvBufCount; i++) {
-        DATAPATH_RX_IO_BLOCK* IoBlock =
-            (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(
-                &DatapathPartition->RecvRegisteredBufferPool, i);
-        IoBlock->BufferIndex = i;
-        IoBlock->DatapathPartition = DatapathPartition;
-        io_uring_buf_ring_add(
-            DatapathPartition->RecvRegisteredBufferPool.Ring,
-            (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset,
-            CxPlatGetBufferPoolBufferSize(&DatapathPartition->RecvRegisteredBufferPool) -
-                DatapathPartition->Datapath->RecvBlockBufferOffset,
-            i, io_uring_buf_ring_mask(RecvBufCount), i);
+        //
+        // The non-GRO buffers keep the same offset, so they have room for the
+        // same number of packets should a coalesced datagram fit.
+        //
+        Status =
+            CxPlatRecvBufferPoolInitialize(
+                DatapathPartition,
+                ALIGN_UP_BY(
+                    Datapath->RecvBlockBufferOffset + CXPLAT_SMALL_IO_BUFFER_SIZE,
+                    CXPLAT_MEMORY_ALIGNMENT),
+                RecvBufCount,
+                CxPlatIoRingBufGroupRecvSmall,
+                &DatapathPartition->RecvSmallRegisteredBufferPool);
+    } else {
+        Status =
+            CxPlatRecvBufferPoolInitialize(
+                DatapathPartition, Datapath->RecvBlockSize, RecvBufCount,
+                CxPlatIoRingBufGroupRecv, &DatapathPartition->RecvRegisteredBufferPool);
     }
-    io_uring_buf_ring_advance(DatapathPartition->RecvRegisteredBufferPool.Ring, RecvBufCount);
 
 Exit:
 
@@ -387,7 +607,6 @@ DataPathInitialize(
     )
 {
     UNREFERENCED_PARAMETER(TcpCallbacks);
-    UNREFERENCED_PARAMETER(InitConfig);
 
     if (NewDatapath == NULL) {
         return QUIC_STATUS_INVALID_PARAMETER;
@@ -432,6 +651,12 @@ DataPathInitialize(
     Datapath->Features = CXPLAT_DATAPATH_FEATURE_LOCAL_PORT_SHARING;
     CxPlatRefInitializeEx(&Datapath->RefCount, Datapath->PartitionCount);
     CxPlatDataPathCalculateFeatureSupport(Datapath);
+    if (InitConfig->EnableRecvTimestamps) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS;
+    }
+    if (InitConfig->EnableSendTxTime && CxPlatDataPathIsTxTimeSupported()) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+    }
 
     if (Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION) {
         Datapath->SendDataSize = sizeof(CXPLAT_SEND_DATA);
@@ -471,7 +696,25 @@ DataPathInitialize(
         if (QUIC_FAILED(Status)) {
             return Status;
         }
+        if (InitConfig->EnableFixedFiles) {
+            CxPlatProcessorContextInitializeFixedFiles(&Datapath->Partitions[i]);
+        }
+    }
+
+#ifdef IORING_CQE_F_NOTIF
+    //
+    // Zero-copy sends need IORING_OP_SENDMSG_ZC (Linux 6.1+), since the
+    // ancillary data (GSO, ECN, PKTINFO) requires the sendmsg form.
+    //
+    struct io_uring_probe* Probe =
+        io_uring_get_probe_ring(&Datapath->Partitions[0].EventQ->Ring);
+    if (Probe != NULL) {
+        if (io_uring_opcode_supported(Probe, IORING_OP_SENDMSG_ZC)) {
+            Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_ZERO_COPY;
+        }
+        io_uring_free_probe(Probe);
     }
+#endif
 
     CXPLAT_FRE_ASSERT(CxPlatWorkerPoolAddRef(WorkerPool, CXPLAT_WORKER_POOL_REF_IOURING));
     *NewDatapath = Datapath;
@@ -510,6 +753,13 @@ CxPlatProcessorContextRelease(
         CxPlatFreeBufferPool(
             DatapathPartition, CxPlatIoRingBufGroupRecv,
             &DatapathPartition->RecvRegisteredBufferPool);
+        CxPlatFreeBufferPool(
+            DatapathPartition, CxPlatIoRingBufGroupRecvSmall,
+            &DatapathPartition->RecvSmallRegisteredBufferPool);
+        if (DatapathPartition->FixedFileSlots != NULL) {
+            (void)io_uring_unregister_files(&DatapathPartition->EventQ->Ring);
+            CXPLAT_FREE(DatapathPartition->FixedFileSlots, QUIC_POOL_DATAPATH);
+        }
         CxPlatPoolUninitialize(&DatapathPartition->SendBlockPool);
         CxPlatDataPathRelease(DatapathPartition->Datapath);
     }
@@ -540,6 +790,7 @@ CxPlatSocketContextSqeInitialize(
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     // CXPLAT_SOCKET* Binding = SocketContext->Binding;
     BOOLEAN ShutdownSqeInitialized = FALSE;
+    BOOLEAN RecvCancelSqeInitialized = FALSE;
 
     if (!CxPlatSqeInitialize(
             SocketContext->DatapathPartition->EventQ,
@@ -551,6 +802,15 @@ CxPlatSocketContextSqeInitialize(
     ShutdownSqeInitialized = TRUE;
     CxPlatSocketIoStart(SocketContext, IoTagShutdown);
 
+    if (!CxPlatSqeInitialize(
+            SocketContext->DatapathPartition->EventQ,
+            CxPlatSocketContextRecvCancelEventComplete,
+            &SocketContext->RecvCancelSqe)) {
+        Status = errno;
+        goto Exit;
+    }
+    RecvCancelSqeInitialized = TRUE;
+
     if (!CxPlatBatchSqeInitialize(
             SocketContext->DatapathPartition->EventQ,
             CxPlatSocketContextIoEventComplete,
@@ -565,6 +825,9 @@ CxPlatSocketContextSqeInitialize(
 
 Exit:
 
+    if (RecvCancelSqeInitialized) {
+        CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->RecvCancelSqe);
+    }
     if (ShutdownSqeInitialized) {
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->ShutdownSqe);
     }
@@ -777,6 +1040,38 @@ CxPlatSocketContextInitialize(
         }
     #endif
 
+        if (SocketContext->DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS) {
+            Option = TRUE;
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TIMESTAMPNS,
+                    (const void*)&Option,
+                    sizeof(Option));
+            if (Result == SOCKET_ERROR) {
+                Status = errno;
+                goto Exit;
+            }
+        }
+
+    #ifdef SO_TXTIME
+        if (SocketContext->DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME) {
+            struct sock_txtime TxTime = { CLOCK_MONOTONIC, 0 };
+            Result =
+                setsockopt(
+                    SocketContext->SocketFd,
+                    SOL_SOCKET,
+                    SO_TXTIME,
+                    (const void*)&TxTime,
+                    sizeof(TxTime));
+            if (Result == SOCKET_ERROR) {
+                Status = errno;
+                goto Exit;
+            }
+        }
+    #endif
+
         //
         // The socket is shared by multiple QUIC endpoints, so increase the receive
         // buffer size.
@@ -924,6 +1219,8 @@ Exit:
     if (QUIC_FAILED(Status)) {
         close(SocketContext->SocketFd);
         SocketContext->SocketFd = INVALID_SOCKET;
+    } else if (SocketContext->SocketFd != INVALID_SOCKET) {
+        CxPlatSocketContextRegisterFixedFile(SocketContext);
     }
 
     return Status;
@@ -966,11 +1263,13 @@ CxPlatSocketContextUninitializeComplete(
     CXPLAT_DBG_ASSERT(SocketContext->AcceptSocket == NULL);
 
     if (SocketContext->SocketFd != INVALID_SOCKET) {
+        CxPlatSocketContextUnregisterFixedFile(SocketContext);
         close(SocketContext->SocketFd);
     }
 
     if (SocketContext->SqeInitialized) {
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->ShutdownSqe);
+        CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->RecvCancelSqe);
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->IoSqe.Sqe);
         CxPlatSqeCleanup(SocketContext->DatapathPartition->EventQ, &SocketContext->FlushTxSqe);
     }
@@ -1011,6 +1310,21 @@ CxPlatSocketContextUninitializeEventComplete(
     CxPlatSocketIoComplete(SocketContext, IoTagShutdown);
 }
 
+void
+CxPlatSocketContextRecvCancelEventComplete(
+    _In_ CXPLAT_CQE* Cqe
+    )
+{
+    CXPLAT_SOCKET_CONTEXT* SocketContext =
+        CXPLAT_CONTAINING_RECORD(CxPlatCqeGetSqe(Cqe), CXPLAT_SOCKET_CONTEXT, RecvCancelSqe);
+
+    //
+    // Nothing to do here; the receive completes separately with -ECANCELED
+    // (or has already ended on its own) and is resubmitted from there.
+    //
+    CxPlatSocketIoComplete(SocketContext, IoTagRecvCancel);
+}
+
 void
 CxPlatSocketContextUninitialize(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
@@ -1076,8 +1390,9 @@ CxPlatSocketContextStartMultiRecvUnderLock(
 
     io_uring_prep_recvmsg_multishot(
         Sqe, SocketContext->SocketFd, (struct msghdr*)&CxPlatRecvMsgHdr, MSG_TRUNC);
+    CxPlatSocketContextSetFixedFile(SocketContext, Sqe);
     Sqe->flags |= IOSQE_BUFFER_SELECT;
-    Sqe->buf_group = CxPlatIoRingBufGroupRecv;
+    Sqe->buf_group = SocketContext->RecvBufferGroup;
     io_uring_sqe_set_data(Sqe, &SocketContext->IoSqe.Sqe);
     CxPlatEventQSubmit(EventQ);
 
@@ -1145,6 +1460,8 @@ SocketCreateUdp(
     for (uint32_t i = 0; i < SocketCount; i++) {
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
+        Binding->SocketContexts[i].FixedFileIndex = -1;
+        Binding->SocketContexts[i].RecvBufferGroup = CxPlatIoRingBufGroupRecv;
         CxPlatListInitializeHead(&Binding->SocketContexts[i].TxQueue);
         CxPlatRundownInitialize(&Binding->SocketContexts[i].UpcallRundown);
     }
@@ -1168,7 +1485,12 @@ SocketCreateUdp(
         // round robin, but each flow will be sent to the same socket, just not
         // based on RSS.
         //
-        (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        if (Config->CidSteeringPartitionCount == 0 || SocketCount == 1 ||
+            QUIC_FAILED(
+                CxPlatSocketConfigureCidSteering(
+                    &Binding->SocketContexts[0], SocketCount, Config))) {
+            (void)CxPlatSocketConfigureRss(&Binding->SocketContexts[0], SocketCount);
+        }
     }
 
     CxPlatConvertFromMappedV6(&Binding->LocalAddress, &Binding->LocalAddress);
@@ -1334,6 +1656,7 @@ CxPlatSocketContextRecvComplete(
         uint8_t TOS = 0;
         int HopLimitTTL = 0;
         uint16_t SegmentLength = 0;
+        uint64_t RecvTimeUs = 0;
         BOOLEAN FoundLocalAddr = FALSE, FoundTOS = FALSE, FoundTTL = FALSE;
         QUIC_ADDR* LocalAddr = &IoBlock->Route.LocalAddress;
         QUIC_ADDR* RemoteAddr = RecvMsgHdr->msg_name;
@@ -1387,6 +1710,13 @@ CxPlatSocketContextRecvComplete(
                     SegmentLength = *(uint16_t*)CMSG_DATA(CMsg);
                 }
 #endif
+            } else if (CMsg->cmsg_level == SOL_SOCKET) {
+                if (CMsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    CXPLAT_DBG_ASSERT_CMSG(CMsg, struct timespec);
+                    struct timespec Timestamp;
+                    CxPlatCopyMemory(&Timestamp, CMSG_DATA(CMsg), sizeof(Timestamp));
+                    RecvTimeUs = CxPlatSocketRecvTimestampToUs(&Timestamp);
+                }
             } else {
                 CXPLAT_DBG_ASSERT(FALSE);
             }
@@ -1426,10 +1756,12 @@ CxPlatSocketContextRecvComplete(
             RecvData->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
             RecvData->TypeOfService = TOS;
             RecvData->HopLimitTTL = (uint8_t)HopLimitTTL;
+            RecvData->RecvTimeUs = RecvTimeUs;
             RecvData->Allocated = TRUE;
             RecvData->Route->DatapathType = RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
             RecvData->QueuedOnConnection = FALSE;
             RecvData->Reserved = FALSE;
+            RecvData->Decrypted = FALSE;
 
             *DatagramTail = RecvData;
             DatagramTail = &RecvData->Next;
@@ -1475,11 +1807,21 @@ CxPlatSocketReceiveComplete(
     struct iovec RecvIov;
     uint32_t BufferIndex;
     struct io_uring_recvmsg_out* RecvMsgOut;
+    CXPLAT_REGISTERED_BUFFER_POOL* Pool =
+        SocketContext->RecvBufferGroup == CxPlatIoRingBufGroupRecvSmall ?
+            &DatapathPartition->RecvSmallRegisteredBufferPool :
+            &DatapathPartition->RecvRegisteredBufferPool;
 
     if (Cqe->res == -ENOBUFS) {
         //
-        // Ignore packet loss indications for now.
+        // The buffer group ran dry, which ends the multishot receive. The
+        // datagrams stay queued on the socket until it is resubmitted.
         //
+        DatapathPartition->RecvBufferStarvationCount++;
+        goto Exit;
+    }
+
+    if (Cqe->res == -ECANCELED && SocketContext->LockedFlags.RecvCancelPending) {
         goto Exit;
     }
 
@@ -1494,13 +1836,22 @@ CxPlatSocketReceiveComplete(
     CXPLAT_DBG_ASSERT(Cqe->flags & IORING_CQE_F_BUFFER);
 
     BufferIndex = Cqe->flags >> 16;
-    IoBlock =
-        (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(
-            &DatapathPartition->RecvRegisteredBufferPool, BufferIndex);
+    IoBlock = (DATAPATH_RX_IO_BLOCK*)CxPlatGetBufferPoolBuffer(Pool, BufferIndex);
+    InterlockedDecrement64(&Pool->AvailableCount);
     IoPayload = (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset;
     RecvMsgOut = io_uring_recvmsg_validate(IoPayload, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
     CXPLAT_FRE_ASSERT(RecvMsgOut != NULL); // Review: can this legally fail?
 
+    if (RecvMsgOut->flags & MSG_TRUNC) {
+        //
+        // Generally only seen with the non-GRO buffers, when a coalesced
+        // datagram is received into them.
+        //
+        DatapathPartition->RecvTruncatedCount++;
+        CxPlatRecvBufferReturn(IoBlock);
+        goto Exit;
+    }
+
     CXPLAT_DBG_ASSERT((uintptr_t)IoBlock % CXPLAT_MEMORY_ALIGNMENT == 0);
 
     IoBlock->Route.State = RouteResolved;
@@ -1521,6 +1872,8 @@ CxPlatSocketReceiveComplete(
     RecvIov.iov_len =
         io_uring_recvmsg_payload_length(RecvMsgOut, Cqe->res, (struct msghdr*)&CxPlatRecvMsgHdr);
 
+    DatapathPartition->RecvCallCount++;
+    DatapathPartition->RecvMessageCount++;
     CxPlatSocketContextRecvComplete(SocketContext, &IoBlock, RecvMsgHdrs);
 
 Exit:
@@ -1529,11 +1882,44 @@ Exit:
         CXPLAT_DBG_ASSERT(SocketContext->LockedFlags.MultiRecvStarted);
         CXPLAT_DBG_ONLY(SocketContext->LockedFlags.MultiRecvStarted = FALSE);
 
+        //
+        // Fall back to the non-GRO buffers when the GRO ones run out, and
+        // move back to the GRO ones otherwise.
+        //
+        if (Cqe->res == -ENOBUFS &&
+            SocketContext->RecvBufferGroup == CxPlatIoRingBufGroupRecv &&
+            DatapathPartition->RecvSmallRegisteredBufferPool.Ring != NULL) {
+            SocketContext->RecvBufferGroup = CxPlatIoRingBufGroupRecvSmall;
+        } else {
+            SocketContext->RecvBufferGroup = CxPlatIoRingBufGroupRecv;
+        }
+        SocketContext->LockedFlags.RecvCancelPending = FALSE;
+
         if (!SocketContext->LockedFlags.Shutdown) {
+            DatapathPartition->RecvRearmCount++;
             CxPlatSocketContextStartMultiRecvUnderLock(SocketContext);
         }
 
         CxPlatSocketIoComplete(SocketContext, IoTagRecv);
+
+    } else if (
+        SocketContext->RecvBufferGroup == CxPlatIoRingBufGroupRecvSmall &&
+        !SocketContext->LockedFlags.RecvCancelPending &&
+        !SocketContext->LockedFlags.Shutdown &&
+        DatapathPartition->RecvRegisteredBufferPool.AvailableCount >=
+            DatapathPartition->RecvRegisteredBufferPool.BufferCount / 2) {
+        //
+        // Enough GRO buffers have been returned. Cancel the receive so it is
+        // resubmitted on them.
+        //
+        struct io_uring_sqe* Sqe = CxPlatSocketAllocSqe(SocketContext);
+        if (Sqe != NULL) {
+            io_uring_prep_cancel(Sqe, &SocketContext->IoSqe.Sqe, 0);
+            io_uring_sqe_set_data(Sqe, &SocketContext->RecvCancelSqe);
+            SocketContext->LockedFlags.RecvCancelPending = TRUE;
+            CxPlatSocketIoStart(SocketContext, IoTagRecvCancel);
+            CxPlatEventQSubmit(DatapathPartition->EventQ);
+        }
     }
 }
 
@@ -1543,27 +1929,35 @@ RecvDataReturn(
     )
 {
     CXPLAT_RECV_DATA* Datagram;
+    CXPLAT_REGISTERED_BUFFER_POOL* Pool = NULL;
+    uint32_t Count = 0;
+
+    //
+    // Chains are generally made up of runs of buffers from the same pool, so
+    // each run is returned under a single lock and tail update.
+    //
     while ((Datagram = RecvDataChain) != NULL) {
         RecvDataChain = RecvDataChain->Next;
         DATAPATH_RX_IO_BLOCK* IoBlock =
             CXPLAT_CONTAINING_RECORD(Datagram, DATAPATH_RX_PACKET, Data)->IoBlock;
         if (InterlockedDecrement(&IoBlock->RefCount) == 0) {
-            CXPLAT_DATAPATH_PARTITION* DatapathPartition = IoBlock->DatapathPartition;
-            //
-            // Review: this is amenable to batching, but the added complexity
-            // may not be worth it.
-            //
-            CxPlatLockAcquire(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+            if (IoBlock->Pool != Pool) {
+                CxPlatRecvBufferPoolReturnEnd(Pool, Count);
+                Pool = IoBlock->Pool;
+                Count = 0;
+                CxPlatLockAcquire(&Pool->Lock);
+            }
+            const uint32_t BufferOffset =
+                IoBlock->DatapathPartition->Datapath->RecvBlockBufferOffset;
             io_uring_buf_ring_add(
-                DatapathPartition->RecvRegisteredBufferPool.Ring,
-                (uint8_t*)IoBlock + DatapathPartition->Datapath->RecvBlockBufferOffset,
-                CxPlatGetBufferPoolBufferSize(&DatapathPartition->RecvRegisteredBufferPool) -
-                    DatapathPartition->Datapath->RecvBlockBufferOffset,
-                IoBlock->BufferIndex, io_uring_buf_ring_mask(RecvBufCount), 0);
-            io_uring_buf_ring_advance(DatapathPartition->RecvRegisteredBufferPool.Ring, 1);
-            CxPlatLockRelease(&DatapathPartition->RecvRegisteredBufferPool.Lock);
+                Pool->Ring,
+                (uint8_t*)IoBlock + BufferOffset,
+                CxPlatGetBufferPoolBufferSize(Pool) - BufferOffset,
+                IoBlock->BufferIndex, io_uring_buf_ring_mask(Pool->BufferCount), (int)Count);
+            Count++;
         }
     }
+    CxPlatRecvBufferPoolReturnEnd(Pool, Count);
 }
 
 //
@@ -1616,10 +2010,14 @@ SendDataAlloc(
         SendData->ControlBufferLength = 0;
         SendData->ECN = Config->ECN;
         SendData->DSCP = Config->DSCP;
+        SendData->TxTimeUs =
+            (Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_TXTIME)
+                ? Config->TxTimeUs : 0;
         SendData->Flags = Config->Flags;
         SendData->OnConnectedSocket = Socket->Connected;
         SendData->SegmentationSupported =
             !!(Socket->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
+        SendData->ZeroCopy = FALSE;
         SendData->Iovs[0].iov_len = 0;
         SendData->Iovs[0].iov_base = SendData->Buffer;
         SendData->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
@@ -1655,10 +2053,15 @@ CxPlatSendDataFinalizeSendBuffer(
     SendData->BufferCount++;
     SendData->TotalSize += SendData->ClientBuffer.Length;
     if (SendData->SegmentationSupported) {
+        //
+        // All segments but the last must be SegmentSize, so a short buffer
+        // ends the send as its tail segment.
+        //
         SendData->Iovs[0].iov_len += SendData->ClientBuffer.Length;
         if (SendData->SegmentSize == 0 ||
             SendData->ClientBuffer.Length < SendData->SegmentSize ||
-            SendData->TotalSize + SendData->SegmentSize > sizeof(SendData->Buffer)) {
+            SendData->TotalSize + SendData->SegmentSize > sizeof(SendData->Buffer) ||
+            SendData->BufferCount == CXPLAT_MAX_GSO_SEGMENTS) {
             SendData->ClientBuffer.Buffer = NULL;
         } else {
             SendData->ClientBuffer.Buffer += SendData->SegmentSize;
@@ -1821,6 +2224,21 @@ CxPlatSendDataPopulateAncillaryData(
     }
 #endif
 
+#ifdef SO_TXTIME
+    if (SendData->TxTimeUs != 0) {
+        //
+        // Applies to the whole message, so all the segments of a GSO send
+        // leave together and the qdisc paces at the granularity of the send.
+        //
+        Mhdr->msg_controllen += CMSG_SPACE(sizeof(uint64_t));
+        CMsg = CXPLAT_CMSG_NXTHDR(CMsg);
+        CMsg->cmsg_level = SOL_SOCKET;
+        CMsg->cmsg_type = SCM_TXTIME;
+        CMsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        *((uint64_t*)CMSG_DATA(CMsg)) = US_TO_NS(SendData->TxTimeUs);
+    }
+#endif
+
     CXPLAT_DBG_ASSERT(Mhdr->msg_controllen <= sizeof(SendData->ControlBuffer));
     SendData->ControlBufferLength = (uint8_t)Mhdr->msg_controllen;
 }
@@ -1875,7 +2293,26 @@ CxPlatSendDataSendSegmented(
         SendData->MsgHdr.msg_controllen = SendData->ControlBufferLength;
     }
 
+#ifdef IORING_CQE_F_NOTIF
+    //
+    // Review: registering the send blocks with io_uring_register_buffers would
+    // save zero-copy sends from pinning pages on every send, but the send pool
+    // doesn't allocate them from a single region, and fixed buffers need
+    // kernel support for vectored zero-copy sends (sendmsg_zc) to be usable
+    // here, since GSO, ECN and PKTINFO all need ancillary data.
+    //
+    SendData->ZeroCopy =
+        (DatapathPartition->Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_ZERO_COPY) &&
+        SendData->TotalSize >= CXPLAT_SEND_ZERO_COPY_MIN_LENGTH;
+    if (SendData->ZeroCopy) {
+        io_uring_prep_sendmsg_zc(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+    } else {
+        io_uring_prep_sendmsg(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+    }
+#else
     io_uring_prep_sendmsg(Sqe, SendData->SocketContext->SocketFd, &SendData->MsgHdr, 0);
+#endif
+    CxPlatSocketContextSetFixedFile(SocketContext, Sqe);
     io_uring_sqe_set_data(Sqe, (void*)&SendData->Sqe);
     CxPlatBatchSqeInitialize(
         DatapathPartition->EventQ, CxPlatSocketContextIoEventComplete, &SendData->Sqe.Sqe);
@@ -1972,9 +2409,45 @@ CxPlatSocketContextSendComplete(
 {
     CXPLAT_SQE* Sqe = CxPlatCqeGetSqe(&Cqe);
     CXPLAT_SEND_DATA* SendData = CXPLAT_CONTAINING_RECORD(Sqe, CXPLAT_SEND_DATA, Sqe);
+    BOOLEAN NotificationPending = FALSE;
+
+#ifdef IORING_CQE_F_NOTIF
+    if (SendData->ZeroCopy) {
+        if (Cqe->flags & IORING_CQE_F_NOTIF) {
+            //
+            // The kernel no longer references the buffers. The send itself
+            // already completed (and flushed the queue) on the first CQE.
+            //
+            CxPlatSendDataFree(SendData);
+            goto Exit;
+        }
+
+        if (Cqe->res == -EOPNOTSUPP) {
+            //
+            // The socket doesn't support zero-copy, so fall back to copying
+            // sends on the datapath globally. Completions for other partitions
+            // may update the features concurrently, so clear it atomically.
+            //
+            CXPLAT_STATIC_ASSERT(
+                sizeof(CXPLAT_DATAPATH_FEATURES) == sizeof(int32_t),
+                "Features must be updatable with InterlockedAnd32");
+            InterlockedAnd32(
+                (int32_t volatile*)&SocketContext->DatapathPartition->Datapath->Features,
+                ~(int32_t)CXPLAT_DATAPATH_FEATURE_SEND_ZERO_COPY);
+        }
+
+        //
+        // If the send made it to the kernel, its buffers stay pinned until
+        // the notification CQE.
+        //
+        NotificationPending = !!(Cqe->flags & IORING_CQE_F_MORE);
+    }
+#endif
 
     CXPLAT_DBG_ASSERT(SendDataUpdateState(SendData, SendStateSendComplete) == SendStateSending);
-    CxPlatSendDataFree(SendData);
+    if (!NotificationPending) {
+        CxPlatSendDataFree(SendData);
+    }
     SendData = NULL;
 
     if (SocketContext->LockedFlags.Shutdown) {
@@ -2013,7 +2486,9 @@ CxPlatSocketContextSendComplete(
 
 Exit:
 
-    CxPlatSocketIoComplete(SocketContext, IoTagSend);
+    if (!NotificationPending) {
+        CxPlatSocketIoComplete(SocketContext, IoTagSend);
+    }
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -40,10 +40,57 @@ struct in_pktinfo {
 CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Length) <= sizeof(size_t)), "(sizeof(QUIC_BUFFER.Length) == sizeof(size_t) must be TRUE.");
 CXPLAT_STATIC_ASSERT((SIZEOF_STRUCT_MEMBER(QUIC_BUFFER, Buffer) == sizeof(void*)), "(sizeof(QUIC_BUFFER.Buffer) == sizeof(void*) must be TRUE.");
 
+#if defined(CXPLAT_USE_MSG_X)
 //
-// TODO: Support batching.
+// recvmsg_x and sendmsg_x are the Darwin batch versions of recvmsg and
+// sendmsg, taking an array of message headers. They aren't in the public SDK
+// headers, so they are declared here and weak linked; they are NULL on OS
+// versions without them.
 //
+struct msghdr_x {
+    void* msg_name;
+    socklen_t msg_namelen;
+    struct iovec* msg_iov;
+    int msg_iovlen;
+    void* msg_control;
+    socklen_t msg_controllen;
+    int msg_flags;
+    size_t msg_datalen;
+};
+
+extern ssize_t recvmsg_x(int s, const struct msghdr_x* msgp, u_int cnt, int flags) __attribute__((weak_import));
+extern ssize_t sendmsg_x(int s, const struct msghdr_x* msgp, u_int cnt, int flags) __attribute__((weak_import));
+
+//
+// A msghdr_x starts with a msghdr, so the same headers can be passed to
+// recvmsg when recvmsg_x isn't available.
+//
+CXPLAT_STATIC_ASSERT(
+    offsetof(struct msghdr_x, msg_flags) == offsetof(struct msghdr, msg_flags),
+    "msghdr_x must start with a msghdr");
+
+typedef struct msghdr_x CXPLAT_RECV_MSGHDR;
+
+#define CXPLAT_MAX_BATCH_RECEIVE 16
+
+//
+// The number of datagrams a send context holds. Each is sent as a separate
+// datagram; on connected sockets, all of them in one sendmsg_x call.
+//
+#define CXPLAT_MAX_BATCH_SEND 16
+
+//
+// The socket's TOS hasn't been set, or can't be set.
+//
+#define CXPLAT_SEND_TOS_UNSET       -1
+#define CXPLAT_SEND_TOS_UNSUPPORTED -2
+#else
+typedef struct msghdr CXPLAT_RECV_MSGHDR;
+
+#define CXPLAT_MAX_BATCH_RECEIVE 1
+
 #define CXPLAT_MAX_BATCH_SEND 1
+#endif
 
 //
 // The maximum single buffer size for sending coalesced payloads.
@@ -168,26 +215,35 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     CXPLAT_SQE IoSqe;
 
     //
-    // The I/O vector for receive datagrams.
+    // The I/O vectors for receive datagrams.
     //
-    struct iovec RecvIov;
+    struct iovec RecvIov[CXPLAT_MAX_BATCH_RECEIVE];
 
     //
-    // The control buffer used in RecvMsgHdr.
+    // The control buffers used in RecvMsgHdr.
     //
-    char RecvMsgControl[CMSG_SPACE(sizeof(struct in6_pktinfo)) +
+    char RecvMsgControl[CXPLAT_MAX_BATCH_RECEIVE][
+                        CMSG_SPACE(sizeof(struct in6_pktinfo)) +
                         CMSG_SPACE(sizeof(struct in_pktinfo)) +
                         2 * CMSG_SPACE(sizeof(int))];
 
     //
-    // The buffer used to receive msg headers on socket.
+    // The buffers used to receive msg headers on socket.
+    //
+    CXPLAT_RECV_MSGHDR RecvMsgHdr[CXPLAT_MAX_BATCH_RECEIVE];
+
+    //
+    // The receive blocks currently being used for receives on this socket.
     //
-    struct msghdr RecvMsgHdr;
+    DATAPATH_RX_IO_BLOCK* CurrentRecvBlocks[CXPLAT_MAX_BATCH_RECEIVE];
 
+#if defined(CXPLAT_USE_MSG_X)
     //
-    // The receive block currently being used for receives on this socket.
+    // The TOS currently set on the socket, for sends batched with sendmsg_x
+    // (which doesn't take control messages).
     //
-    DATAPATH_RX_IO_BLOCK* CurrentRecvBlock;
+    int SendTos;
+#endif
 
     //
     // The head of list containg all pending sends on this socket.
@@ -557,6 +613,31 @@ CxPlatDataPathGetSupportedFeatures(
     return Datapath->Features;
 }
 
+QUIC_STATUS
+CxPlatDataPathGetXdpQueueInfo(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(QueueInfo);
+    *QueueCount = 0;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+}
+
 BOOLEAN
 CxPlatDataPathIsPaddingPreferred(
     _In_ CXPLAT_DATAPATH* Datapath,
@@ -877,8 +958,10 @@ CxPlatSocketContextUninitializeComplete(
     SocketContext->Freed = TRUE;
 #endif
 
-    if (SocketContext->CurrentRecvBlock != NULL) {
-        CxPlatRecvDataReturn(&SocketContext->CurrentRecvBlock->RecvPacket);
+    for (uint32_t i = 0; i < CXPLAT_MAX_BATCH_RECEIVE; i++) {
+        if (SocketContext->CurrentRecvBlocks[i] != NULL) {
+            CxPlatRecvDataReturn(&SocketContext->CurrentRecvBlocks[i]->RecvPacket);
+        }
     }
 
     while (!CxPlatListIsEmpty(&SocketContext->PendingSendDataHead)) {
@@ -951,29 +1034,38 @@ CxPlatSocketContextPrepareReceive(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext
     )
 {
-    if (SocketContext->CurrentRecvBlock == NULL) {
-        SocketContext->CurrentRecvBlock =
-            CxPlatDataPathAllocRxIoBlock(SocketContext->DatapathPartition);
-        if (SocketContext->CurrentRecvBlock == NULL) {
-            return QUIC_STATUS_OUT_OF_MEMORY;
+    //
+    // Prepares every receive slot. On failure, the slots before the first
+    // one without a receive block are still usable.
+    //
+    for (uint32_t i = 0; i < CXPLAT_MAX_BATCH_RECEIVE; i++) {
+        if (SocketContext->CurrentRecvBlocks[i] == NULL) {
+            SocketContext->CurrentRecvBlocks[i] =
+                CxPlatDataPathAllocRxIoBlock(SocketContext->DatapathPartition);
+            if (SocketContext->CurrentRecvBlocks[i] == NULL) {
+                return QUIC_STATUS_OUT_OF_MEMORY;
+            }
         }
-    }
 
-    SocketContext->RecvIov.iov_base = SocketContext->CurrentRecvBlock->RecvPacket.Buffer;
-    SocketContext->CurrentRecvBlock->RecvPacket.Next = NULL;
-    SocketContext->CurrentRecvBlock->RecvPacket.BufferLength = SocketContext->RecvIov.iov_len;
-    SocketContext->CurrentRecvBlock->RecvPacket.Route = &SocketContext->CurrentRecvBlock->Route;
+        DATAPATH_RX_IO_BLOCK* RecvBlock = SocketContext->CurrentRecvBlocks[i];
+        CXPLAT_RECV_MSGHDR* RecvMsgHdr = &SocketContext->RecvMsgHdr[i];
+
+        SocketContext->RecvIov[i].iov_base = RecvBlock->RecvPacket.Buffer;
+        RecvBlock->RecvPacket.Next = NULL;
+        RecvBlock->RecvPacket.BufferLength = SocketContext->RecvIov[i].iov_len;
+        RecvBlock->RecvPacket.Route = &RecvBlock->Route;
 
-    CxPlatZeroMemory(&SocketContext->RecvMsgHdr, sizeof(SocketContext->RecvMsgHdr));
-    CxPlatZeroMemory(&SocketContext->RecvMsgControl, sizeof(SocketContext->RecvMsgControl));
+        CxPlatZeroMemory(RecvMsgHdr, sizeof(*RecvMsgHdr));
+        CxPlatZeroMemory(SocketContext->RecvMsgControl[i], sizeof(SocketContext->RecvMsgControl[i]));
 
-    SocketContext->RecvMsgHdr.msg_name = &SocketContext->CurrentRecvBlock->RecvPacket.Route->RemoteAddress;
-    SocketContext->RecvMsgHdr.msg_namelen = sizeof(SocketContext->CurrentRecvBlock->RecvPacket.Route->RemoteAddress);
-    SocketContext->RecvMsgHdr.msg_iov = &SocketContext->RecvIov;
-    SocketContext->RecvMsgHdr.msg_iovlen = 1;
-    SocketContext->RecvMsgHdr.msg_control = SocketContext->RecvMsgControl;
-    SocketContext->RecvMsgHdr.msg_controllen = sizeof(SocketContext->RecvMsgControl);
-    SocketContext->RecvMsgHdr.msg_flags = 0;
+        RecvMsgHdr->msg_name = &RecvBlock->RecvPacket.Route->RemoteAddress;
+        RecvMsgHdr->msg_namelen = sizeof(RecvBlock->RecvPacket.Route->RemoteAddress);
+        RecvMsgHdr->msg_iov = &SocketContext->RecvIov[i];
+        RecvMsgHdr->msg_iovlen = 1;
+        RecvMsgHdr->msg_control = SocketContext->RecvMsgControl[i];
+        RecvMsgHdr->msg_controllen = sizeof(SocketContext->RecvMsgControl[i]);
+        RecvMsgHdr->msg_flags = 0;
+    }
 
     return QUIC_STATUS_SUCCESS;
 }
@@ -1002,17 +1094,20 @@ Error:
     return Status;
 }
 
-void
+//
+// Takes the datagram received in the given slot, returning it for indication.
+//
+CXPLAT_RECV_DATA*
 CxPlatSocketContextRecvComplete(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
-    _In_ ssize_t BytesTransferred
+    _In_ uint32_t Index,
+    _In_ size_t BytesTransferred
     )
 {
-    QUIC_STATUS Status = QUIC_STATUS_SUCCESS; // cppcheck-suppress unreadVariable
-
-    CXPLAT_DBG_ASSERT(SocketContext->CurrentRecvBlock != NULL);
-    CXPLAT_RECV_DATA* RecvPacket = &SocketContext->CurrentRecvBlock->RecvPacket;
-    SocketContext->CurrentRecvBlock = NULL;
+    CXPLAT_DBG_ASSERT(SocketContext->CurrentRecvBlocks[Index] != NULL);
+    CXPLAT_RECV_DATA* RecvPacket = &SocketContext->CurrentRecvBlocks[Index]->RecvPacket;
+    CXPLAT_RECV_MSGHDR* RecvMsgHdr = &SocketContext->RecvMsgHdr[Index];
+    SocketContext->CurrentRecvBlocks[Index] = NULL;
 
     BOOLEAN FoundLocalAddr = FALSE; // cppcheck-suppress unreadVariable
     BOOLEAN FoundTOS = FALSE; // cppcheck-suppress unreadVariable
@@ -1029,12 +1124,13 @@ CxPlatSocketContextRecvComplete(
 
     RecvPacket->Route->Queue = (CXPLAT_QUEUE*)SocketContext;
     RecvPacket->TypeOfService = 0;
+    RecvPacket->RecvTimeUs = 0;
     RecvPacket->HopLimitTTL = 0; // TODO: We are not supporting this on MacOS (yet) unless there's a business need.
 
     struct cmsghdr *CMsg;
-    for (CMsg = CMSG_FIRSTHDR(&SocketContext->RecvMsgHdr);
+    for (CMsg = CMSG_FIRSTHDR(RecvMsgHdr);
          CMsg != NULL;
-         CMsg = CMSG_NXTHDR(&SocketContext->RecvMsgHdr, CMsg)) {
+         CMsg = CMSG_NXTHDR(RecvMsgHdr, CMsg)) {
 
         if (CMsg->cmsg_level == IPPROTO_IPV6) {
             if (CMsg->cmsg_type == IPV6_PKTINFO) {
@@ -1097,27 +1193,48 @@ CxPlatSocketContextRecvComplete(
 
     RecvPacket->PartitionIndex = SocketContext->DatapathPartition->PartitionIndex;
 
-    if (!SocketContext->Binding->PcpBinding) {
-        CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath->UdpHandlers.Receive);
-        SocketContext->Binding->Datapath->UdpHandlers.Receive(
-            SocketContext->Binding,
-            SocketContext->Binding->ClientContext,
-            RecvPacket);
-    } else {
-        CxPlatPcpRecvCallback(
-            SocketContext->Binding,
-            SocketContext->Binding->ClientContext,
-            RecvPacket);
-    }
+    return RecvPacket;
+}
 
-    int32_t RetryCount = 0;
-    do {
-        Status = CxPlatSocketContextPrepareReceive(SocketContext);
-    } while (!QUIC_SUCCEEDED(Status) && ++RetryCount < 10);
+//
+// Receives into the first SlotCount receive slots, returning the number of
+// datagrams received (with their lengths), or -1 with errno set.
+//
+static
+int
+CxPlatSocketContextReceive(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t SlotCount,
+    _Out_writes_(SlotCount) size_t* Lengths
+    )
+{
+#if defined(CXPLAT_USE_MSG_X)
+    if (recvmsg_x != NULL) {
+        ssize_t Ret =
+            recvmsg_x(
+                SocketContext->SocketFd,
+                SocketContext->RecvMsgHdr,
+                SlotCount,
+                0);
+        for (ssize_t i = 0; i < Ret; i++) {
+            Lengths[i] = SocketContext->RecvMsgHdr[i].msg_datalen;
+        }
+        return (int)Ret;
+    }
+#else
+    UNREFERENCED_PARAMETER(SlotCount);
+#endif
 
-    if (!QUIC_SUCCEEDED(Status)) {
-        CXPLAT_DBG_ASSERT(Status == QUIC_STATUS_OUT_OF_MEMORY);
+    ssize_t Ret =
+        recvmsg(
+            SocketContext->SocketFd,
+            (struct msghdr*)&SocketContext->RecvMsgHdr[0],
+            0);
+    if (Ret < 0) {
+        return -1;
     }
+    Lengths[0] = (size_t)Ret;
+    return 1;
 }
 
 //
@@ -1220,16 +1337,21 @@ CxPlatSocketContextIoEventComplete(
 
     if (Cqe->filter == EVFILT_READ) {
         //
-        // Read up to 4 receives before moving to another event.
+        // Read up to 4 batches of receives before moving to another event.
         //
         for (int i = 0; i < 4; i++) {
-            CXPLAT_DBG_ASSERT(SocketContext->CurrentRecvBlock != NULL);
+            uint32_t SlotCount = 0;
+            while (SlotCount < CXPLAT_MAX_BATCH_RECEIVE &&
+                   SocketContext->CurrentRecvBlocks[SlotCount] != NULL) {
+                SlotCount++;
+            }
+            CXPLAT_DBG_ASSERT(SlotCount != 0);
+            if (SlotCount == 0) {
+                break;
+            }
 
-            ssize_t Ret =
-                recvmsg(
-                    SocketContext->SocketFd,
-                    &SocketContext->RecvMsgHdr,
-                    0);
+            size_t Lengths[CXPLAT_MAX_BATCH_RECEIVE];
+            int Ret = CxPlatSocketContextReceive(SocketContext, SlotCount, Lengths);
             if (Ret < 0) {
                 int ErrNum = errno;
                 if (ErrNum != EAGAIN && ErrNum != EWOULDBLOCK) {
@@ -1253,7 +1375,43 @@ CxPlatSocketContextIoEventComplete(
                 }
                 break;
             }
-            CxPlatSocketContextRecvComplete(SocketContext, Ret);
+
+            CXPLAT_RECV_DATA* RecvDataChain = NULL;
+            CXPLAT_RECV_DATA** RecvDataTail = &RecvDataChain;
+            for (int j = 0; j < Ret; j++) {
+                *RecvDataTail =
+                    CxPlatSocketContextRecvComplete(SocketContext, (uint32_t)j, Lengths[j]);
+                RecvDataTail = &(*RecvDataTail)->Next;
+            }
+
+            if (RecvDataChain != NULL) {
+                if (!SocketContext->Binding->PcpBinding) {
+                    CXPLAT_DBG_ASSERT(SocketContext->Binding->Datapath->UdpHandlers.Receive);
+                    SocketContext->Binding->Datapath->UdpHandlers.Receive(
+                        SocketContext->Binding,
+                        SocketContext->Binding->ClientContext,
+                        RecvDataChain);
+                } else {
+                    CxPlatPcpRecvCallback(
+                        SocketContext->Binding,
+                        SocketContext->Binding->ClientContext,
+                        RecvDataChain);
+                }
+            }
+
+            QUIC_STATUS Status;
+            int32_t RetryCount = 0;
+            do {
+                Status = CxPlatSocketContextPrepareReceive(SocketContext);
+            } while (!QUIC_SUCCEEDED(Status) && ++RetryCount < 10);
+
+            if (!QUIC_SUCCEEDED(Status)) {
+                CXPLAT_DBG_ASSERT(Status == QUIC_STATUS_OUT_OF_MEMORY);
+            }
+
+            if ((uint32_t)Ret < SlotCount) {
+                break; // The socket has been drained.
+            }
         }
     }
 
@@ -1308,8 +1466,13 @@ CxPlatSocketCreateUdp(
     for (uint32_t i = 0; i < SocketCount; i++) {
         Binding->SocketContexts[i].Binding = Binding;
         Binding->SocketContexts[i].SocketFd = INVALID_SOCKET;
-        Binding->SocketContexts[i].RecvIov.iov_len =
-            Binding->Mtu - CXPLAT_MIN_IPV4_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE;
+        for (uint32_t j = 0; j < CXPLAT_MAX_BATCH_RECEIVE; j++) {
+            Binding->SocketContexts[i].RecvIov[j].iov_len =
+                Binding->Mtu - CXPLAT_MIN_IPV4_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE;
+        }
+#if defined(CXPLAT_USE_MSG_X)
+        Binding->SocketContexts[i].SendTos = CXPLAT_SEND_TOS_UNSET;
+#endif
         Binding->SocketContexts[i].DatapathPartition =
             IsServerSocket ?
                 &Datapath->Partitions[i % Datapath->PartitionCount] :
@@ -1764,6 +1927,49 @@ CxPlatSendDataComplete(
     CxPlatSendDataFree(SendData);
 }
 
+#if defined(CXPLAT_USE_MSG_X)
+//
+// Sets the TOS used for all sends on the (connected) socket, since sendmsg_x
+// doesn't take control messages. Returns FALSE if it can't be set.
+//
+static
+BOOLEAN
+CxPlatSocketContextSetSendTos(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ QUIC_ADDRESS_FAMILY Family,
+    _In_ int Tos
+    )
+{
+    if (SocketContext->SendTos == Tos) {
+        return TRUE;
+    }
+    if (SocketContext->SendTos == CXPLAT_SEND_TOS_UNSUPPORTED) {
+        return FALSE;
+    }
+
+    int Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            Family == QUIC_ADDRESS_FAMILY_INET ? IPPROTO_IP : IPPROTO_IPV6,
+            Family == QUIC_ADDRESS_FAMILY_INET ? IP_TOS : IPV6_TCLASS,
+            (const void*)&Tos,
+            sizeof(Tos));
+    if (Result == SOCKET_ERROR) {
+        QuicTraceEvent(
+            DatapathErrorStatus,
+            "[data][%p] ERROR, %u, %s.",
+            SocketContext->Binding,
+            errno,
+            "setsockopt(IP_TOS/IPV6_TCLASS) failed");
+        SocketContext->SendTos = CXPLAT_SEND_TOS_UNSUPPORTED;
+        return FALSE;
+    }
+
+    SocketContext->SendTos = Tos;
+    return TRUE;
+}
+#endif
+
 QUIC_STATUS
 CxPlatSocketSendInternal(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -1823,11 +2029,45 @@ CxPlatSocketSendInternal(
         MappedRemoteAddress.Ipv6.sin6_family = AF_INET6;
     }
 
+    const int Tos = SendData->ECN | (SendData->DSCP << 2);
+
+#if defined(CXPLAT_USE_MSG_X)
+    if (sendmsg_x != NULL &&
+        SocketContext->Binding->Connected &&
+        CxPlatSocketContextSetSendTos(SocketContext, RemoteAddress->Ip.sa_family, Tos)) {
+        //
+        // Send all the remaining datagrams in one call. Connected sockets need
+        // neither an address nor packet info, and the TOS is set on the socket.
+        //
+        struct msghdr_x Mhdrs[CXPLAT_MAX_BATCH_SEND];
+        const uint32_t Count = SendData->BufferCount - SendData->CurrentIndex;
+        CxPlatZeroMemory(Mhdrs, Count * sizeof(struct msghdr_x));
+        for (uint32_t i = 0; i < Count; ++i) {
+            Mhdrs[i].msg_iov = &SendData->Iovs[SendData->CurrentIndex + i];
+            Mhdrs[i].msg_iovlen = 1;
+        }
+
+        SentByteCount = sendmsg_x(SocketContext->SocketFd, Mhdrs, Count, 0);
+        if (SentByteCount >= 0) {
+            SendData->CurrentIndex += (uint32_t)SentByteCount;
+            if (SendData->CurrentIndex < SendData->BufferCount) {
+                //
+                // A partial send means the socket buffer is full. Pend the
+                // rest, the same as for a failed sendmsg.
+                //
+                SentByteCount = -1;
+                errno = EAGAIN;
+            }
+        }
+        goto SendComplete;
+    }
+#endif
+
     struct msghdr Mhdr = {
         .msg_name = NULL,
         .msg_namelen = 0,
-        .msg_iov = SendData->Iovs,
-        .msg_iovlen = SendData->BufferCount,
+        .msg_iov = NULL,
+        .msg_iovlen = 1,
         .msg_control = ControlBuffer,
         .msg_controllen = CMSG_SPACE(sizeof(int)),
         .msg_flags = 0
@@ -1837,7 +2077,7 @@ CxPlatSocketSendInternal(
     CMsg->cmsg_level = RemoteAddress->Ip.sa_family == QUIC_ADDRESS_FAMILY_INET ? IPPROTO_IP : IPPROTO_IPV6;
     CMsg->cmsg_type = RemoteAddress->Ip.sa_family == QUIC_ADDRESS_FAMILY_INET ? IP_TOS : IPV6_TCLASS;
     CMsg->cmsg_len = CMSG_LEN(sizeof(int));
-    *(int *)CMSG_DATA(CMsg) = SendData->ECN | (SendData->DSCP << 2);
+    *(int *)CMSG_DATA(CMsg) = Tos;
 
     if (!SocketContext->Binding->Connected) {
         Mhdr.msg_name = &MappedRemoteAddress;
@@ -1872,7 +2112,22 @@ CxPlatSocketSendInternal(
         }
     }
 
-    SentByteCount = sendmsg(SocketContext->SocketFd, &Mhdr, 0);
+    //
+    // Each buffer is sent as its own datagram, picking up from where a
+    // previous (pended) attempt left off.
+    //
+    while (SendData->CurrentIndex < SendData->BufferCount) {
+        Mhdr.msg_iov = &SendData->Iovs[SendData->CurrentIndex];
+        SentByteCount = sendmsg(SocketContext->SocketFd, &Mhdr, 0);
+        if (SentByteCount < 0) {
+            break;
+        }
+        ++SendData->CurrentIndex;
+    }
+
+#if defined(CXPLAT_USE_MSG_X)
+SendComplete:
+#endif
 
     if (SentByteCount < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
@@ -22,10 +22,19 @@ CxPlatSocketUpdateQeo(
     _In_ uint32_t OffloadCount
     )
 {
-    UNREFERENCED_PARAMETER(Socket);
-    UNREFERENCED_PARAMETER(Offloads);
-    UNREFERENCED_PARAMETER(OffloadCount);
-    return QUIC_STATUS_NOT_SUPPORTED;
+    //
+    // Only the raw datapath supports offloads, so they only apply to traffic
+    // that doesn't fall back to the normal socket.
+    //
+    if (!Socket->RawSocketAvailable) {
+        return QUIC_STATUS_NOT_SUPPORTED;
+    }
+    for (uint32_t i = 0; i < OffloadCount; ++i) {
+        if (IS_LOOPBACK(Offloads[i].Address)) {
+            return QUIC_STATUS_NOT_SUPPORTED;
+        }
+    }
+    return RawSocketUpdateQeo(CxPlatSocketToRaw(Socket), Offloads, OffloadCount);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -70,6 +79,20 @@ DataPathIsPaddingPreferred(
     return !!(Datapath->Features & CXPLAT_DATAPATH_FEATURE_SEND_SEGMENTATION);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+DataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    CxPlatZeroMemory(Statistics, sizeof(*Statistics));
+    for (uint32_t i = 0; i < Datapath->PartitionCount; i++) {
+        Statistics->RecvCallCount += Datapath->Partitions[i].RecvCallCount;
+        Statistics->RecvMessageCount += Datapath->Partitions[i].RecvMessageCount;
+    }
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 DataPathUpdatePollingIdleTimeout(
@@ -189,6 +212,57 @@ Error:
     Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_DSCP;
 }
 
+BOOLEAN
+CxPlatDataPathIsTxTimeSupported(
+    void
+    )
+{
+#ifdef SO_TXTIME
+    int Socket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    if (Socket == INVALID_SOCKET) {
+        return FALSE;
+    }
+    //
+    // CxPlatTimeUs64 is based on CLOCK_MONOTONIC, so the departure times can
+    // be passed down as is (in ns).
+    //
+    struct sock_txtime TxTime = { CLOCK_MONOTONIC, 0 };
+    const BOOLEAN Supported =
+        setsockopt(Socket, SOL_SOCKET, SO_TXTIME, &TxTime, sizeof(TxTime)) != SOCKET_ERROR;
+    close(Socket);
+    return Supported;
+#else
+    return FALSE;
+#endif
+}
+
+uint64_t
+CxPlatSocketRecvTimestampToUs(
+    _In_ const struct timespec* Timestamp
+    )
+{
+    //
+    // The kernel stamps with the real time clock, so go by how long ago that
+    // was, which is much smaller than any realtime/monotonic skew.
+    //
+    struct timespec RealNow;
+    if (clock_gettime(CLOCK_REALTIME, &RealNow) != 0) {
+        return 0;
+    }
+    const uint64_t Now = CxPlatTimeUs64();
+
+    const int64_t AgeUs =
+        ((int64_t)RealNow.tv_sec - (int64_t)Timestamp->tv_sec) * (int64_t)CXPLAT_MICROSEC_PER_SEC +
+        ((int64_t)RealNow.tv_nsec - (int64_t)Timestamp->tv_nsec) / (int64_t)CXPLAT_NANOSEC_PER_MICROSEC;
+    if (AgeUs <= 0) {
+        return Now; // The real time clock was stepped back.
+    }
+    if ((uint64_t)AgeUs >= Now) {
+        return 0;
+    }
+    return Now - (uint64_t)AgeUs;
+}
+
 QUIC_STATUS
 CxPlatSocketConfigureRss(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -228,6 +302,64 @@ CxPlatSocketConfigureRss(
 #endif
 }
 
+QUIC_STATUS
+CxPlatSocketConfigureCidSteering(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t SocketCount,
+    _In_ const CXPLAT_UDP_CONFIG* Config
+    )
+{
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    int Result = 0;
+
+    //
+    // The program runs on the UDP payload. Short header packets are steered
+    // by the partition ID following the destination CID's server ID, which
+    // picks the socket with the same index. Long header packets (mostly
+    // handshakes, with client chosen CIDs) are steered by the receiving CPU.
+    //
+    const uint32_t PidOffset = 1 + Config->CidSteeringPidOffset;
+    struct sock_filter BpfCode[] = {
+        {BPF_LD | BPF_B | BPF_ABS, 0, 0, 0}, // Load the first byte
+        {BPF_JMP | BPF_JSET | BPF_K, 8, 0, 0x80}, // Long header? Go by CPU
+        {BPF_LD | BPF_B | BPF_ABS, 0, 0, PidOffset + 1}, // Load PID high byte
+        {BPF_ALU | BPF_LSH | BPF_K, 0, 0, 8},
+        {BPF_MISC | BPF_TAX, 0, 0, 0},
+        {BPF_LD | BPF_B | BPF_ABS, 0, 0, PidOffset}, // Load PID low byte
+        {BPF_ALU | BPF_OR | BPF_X, 0, 0, 0},
+        {BPF_ALU | BPF_AND | BPF_K, 0, 0, Config->CidSteeringPidMask},
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, Config->CidSteeringPartitionCount}, // Partition index
+        {BPF_RET | BPF_A, 0, 0, 0}, // Return
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF | SKF_AD_CPU}, // Load CPU number
+        {BPF_ALU | BPF_MOD, 0, 0, SocketCount}, // MOD by SocketCount
+        {BPF_RET | BPF_A, 0, 0, 0} // Return
+    };
+
+    struct sock_fprog BpfConfig = {0};
+    BpfConfig.len = ARRAYSIZE(BpfCode);
+    BpfConfig.filter = BpfCode;
+
+    Result =
+        setsockopt(
+            SocketContext->SocketFd,
+            SOL_SOCKET,
+            SO_ATTACH_REUSEPORT_CBPF,
+            (const void*)&BpfConfig,
+            sizeof(BpfConfig));
+    if (Result == SOCKET_ERROR) {
+        Status = errno;
+    }
+
+    return Status;
+#else
+    UNREFERENCED_PARAMETER(SocketContext);
+    UNREFERENCED_PARAMETER(SocketCount);
+    UNREFERENCED_PARAMETER(Config);
+    return QUIC_STATUS_NOT_SUPPORTED;
+#endif
+}
+
 void
 CxPlatSocketHandleError(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
@@ -10,6 +10,7 @@
 #include <fcntl.h>
 #include <linux/filter.h>
 #include <linux/in6.h>
+#include <linux/net_tstamp.h>
 #include <linux/stddef.h>
 #include <netinet/udp.h>
 
@@ -31,6 +32,12 @@
 //
 #define CXPLAT_MAX_IO_BATCH_SIZE ((uint16_t)(CXPLAT_LARGE_IO_BUFFER_SIZE / (1280 - CXPLAT_MIN_IPV6_HEADER_SIZE - CXPLAT_UDP_HEADER_SIZE)))
 
+//
+// The maximum number of segments the kernel accepts in a single UDP_SEGMENT
+// send (UDP_MAX_SEGMENTS).
+//
+#define CXPLAT_MAX_GSO_SEGMENTS             64
+
 #define CXPLAT_DBG_ASSERT_CMSG(CMsg, type) \
     CXPLAT_DBG_ASSERT((CMsg)->cmsg_len >= CMSG_LEN(sizeof(type)))
 
@@ -39,12 +46,42 @@ CxPlatDataPathCalculateFeatureSupport(
     _Inout_ CXPLAT_DATAPATH* Datapath
     );
 
+//
+// Converts a kernel (SCM_TIMESTAMPNS, CLOCK_REALTIME) receive timestamp to the
+// CxPlatTimeUs64 clock. Returns 0 if it can't be converted.
+//
+uint64_t
+CxPlatSocketRecvTimestampToUs(
+    _In_ const struct timespec* Timestamp
+    );
+
+//
+// Returns whether SO_TXTIME (CLOCK_MONOTONIC departure times) can be enabled
+// on UDP sockets.
+//
+BOOLEAN
+CxPlatDataPathIsTxTimeSupported(
+    void
+    );
+
 QUIC_STATUS
 CxPlatSocketConfigureRss(
     _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
     _In_ uint32_t SocketCount
     );
 
+//
+// Steers short header packets to the per-processor socket of the partition
+// encoded in their destination CID, and everything else as for
+// CxPlatSocketConfigureRss.
+//
+QUIC_STATUS
+CxPlatSocketConfigureCidSteering(
+    _In_ CXPLAT_SOCKET_CONTEXT* SocketContext,
+    _In_ uint32_t SocketCount,
+    _In_ const CXPLAT_UDP_CONFIG* Config
+    );
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 void
 DataPathUpdatePollingIdleTimeout(
@@ -0,0 +1,1494 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    QUIC in-memory datapath. Replaces the socket datapath (when built with
+    CXPLAT_MEMORY_DATAPATH) with a network that only exists inside the process,
+    so client and server in the same process exchange datagrams without any
+    system calls. Used to measure and profile the protocol code on its own.
+
+    Each socket has an inbound link with a configurable one-way delay, random
+    loss, random reordering, bandwidth and queue size. Datagrams are handed to
+    the receiving socket through lock-free inboxes that are drained by
+    execution contexts on the worker pool, which deliver them once their link
+    arrival time is reached.
+
+    The link is configured with environment variables, read when the first
+    datapath is initialized:
+
+        MSQUIC_MEMORY_DATAPATH_DELAY_US         One-way delay (default 0)
+        MSQUIC_MEMORY_DATAPATH_LOSS_PPM         Loss rate, per million (0)
+        MSQUIC_MEMORY_DATAPATH_REORDER_PPM      Reorder rate, per million (0)
+        MSQUIC_MEMORY_DATAPATH_REORDER_DELAY_US Extra delay of reordered
+                                                datagrams (1000)
+        MSQUIC_MEMORY_DATAPATH_BANDWIDTH_KBPS   Link rate, 0 for unlimited (0)
+        MSQUIC_MEMORY_DATAPATH_QUEUE_BYTES      Bytes queued at the link
+                                                before tail drop (1048576)
+        MSQUIC_MEMORY_DATAPATH_SEED             Loss and reorder seed (1)
+
+    Ports are the only part of an address that identifies a socket; every IP
+    address reaches the same (local) host. Delivery times are only as precise
+    as the worker's timer, which waits in whole milliseconds.
+
+Environment:
+
+    Linux
+
+--*/
+
+#include "platform_internal.h"
+#include <stdlib.h>
+
+//
+// The number of datagrams a send context holds.
+//
+#define CXPLAT_MEMORY_MAX_BATCH_SEND 16
+
+//
+// The largest datagram payload a send buffer can hold.
+//
+#define CXPLAT_MEMORY_MAX_PAYLOAD_LENGTH CXPLAT_MAX_MTU
+
+//
+// The range ephemeral ports are allocated from.
+//
+#define CXPLAT_MEMORY_EPHEMERAL_PORT_MIN 49152
+#define CXPLAT_MEMORY_PORT_COUNT 65536
+
+//
+// Configuration of every socket's inbound link.
+//
+typedef struct CXPLAT_MEMORY_LINK_CONFIG {
+
+    uint64_t DelayUs;
+    uint64_t LossPpm;
+    uint64_t ReorderPpm;
+    uint64_t ReorderDelayUs;
+    uint64_t BandwidthKbps;
+    uint64_t QueueBytes;
+    uint64_t Seed;
+
+} CXPLAT_MEMORY_LINK_CONFIG;
+
+//
+// A datagram in flight. The send buffer given out by CxPlatSendDataAllocBuffer
+// is the payload of the datagram the receiver is given, so nothing is copied.
+//
+typedef struct CXPLAT_MEMORY_DATAGRAM {
+
+    //
+    // Link in the receiving socket context's inbox.
+    //
+    CXPLAT_SLIST_ENTRY Link;
+
+    //
+    // Next datagram in the receiving socket context's pending list.
+    //
+    struct CXPLAT_MEMORY_DATAGRAM* Next;
+
+    //
+    // When the datagram reaches the receiver, in microseconds.
+    //
+    uint64_t DeliverTimeUs;
+
+    //
+    // The route the datagram was received on.
+    //
+    CXPLAT_ROUTE Route;
+
+    //
+    // Publicly visible receive data. Followed by the client's receive context
+    // and then (at CXPLAT_DATAPATH.PayloadOffset) the payload.
+    //
+    CXPLAT_RECV_DATA RecvData;
+
+} CXPLAT_MEMORY_DATAGRAM;
+
+//
+// Send context.
+//
+typedef struct CXPLAT_SEND_DATA {
+
+    //
+    // The datapath owning this send context.
+    //
+    CXPLAT_DATAPATH* Datapath;
+
+    //
+    // Earliest departure time, or 0 for now.
+    //
+    uint64_t TxTimeUs;
+
+    //
+    // The ECN markings and DSCP value to send with.
+    //
+    uint8_t ECN; // CXPLAT_ECN_TYPE
+    uint8_t DSCP;
+
+    //
+    // Total number of Buffers currently in use.
+    //
+    uint32_t BufferCount;
+
+    //
+    // The buffers given out and the datagrams they belong to.
+    //
+    QUIC_BUFFER Buffers[CXPLAT_MEMORY_MAX_BATCH_SEND];
+    CXPLAT_MEMORY_DATAGRAM* Datagrams[CXPLAT_MEMORY_MAX_BATCH_SEND];
+
+} CXPLAT_SEND_DATA;
+
+//
+// Receives and delivers datagrams for a socket on one worker.
+//
+typedef struct QUIC_CACHEALIGN CXPLAT_MEMORY_SOCKET_CONTEXT {
+
+    //
+    // The socket this context belongs to.
+    //
+    CXPLAT_SOCKET* Socket;
+
+    //
+    // Drains the inbox and delivers the datagrams that have arrived.
+    //
+    CXPLAT_EXECUTION_CONTEXT Ec;
+
+    //
+    // Datagrams pushed by senders (most recent first). Only the execution
+    // context removes entries.
+    //
+    CXPLAT_SLIST_ENTRY* volatile Inbox;
+
+    //
+    // Datagrams moved from the inbox that haven't arrived yet, in order of
+    // delivery time. Only used by the execution context.
+    //
+    CXPLAT_MEMORY_DATAGRAM* PendingHead;
+    CXPLAT_MEMORY_DATAGRAM* PendingTail;
+
+    //
+    // The worker (and partition) datagrams are delivered on.
+    //
+    uint16_t PartitionIndex;
+
+} CXPLAT_MEMORY_SOCKET_CONTEXT;
+
+//
+// Datapath binding.
+//
+typedef struct CXPLAT_SOCKET {
+
+    //
+    // A pointer to datapath object.
+    //
+    CXPLAT_DATAPATH* Datapath;
+
+    //
+    // The client context for this binding.
+    //
+    void *ClientContext;
+
+    //
+    // The local address for the binding.
+    //
+    QUIC_ADDR LocalAddress;
+
+    //
+    //  The remote address for the binding.
+    //
+    QUIC_ADDR RemoteAddress;
+
+    //
+    // References from the creator (until delete), each running socket
+    // context and each send in progress to this socket.
+    //
+    CXPLAT_REF_COUNT RefCount;
+
+    //
+    // The number of socket contexts still running, and the event set once
+    // they have all stopped after the socket is deleted.
+    //
+    short volatile RunningContexts;
+    CXPLAT_EVENT StoppedEvent;
+
+    //
+    // The inbound link: when it's done serializing the datagrams already
+    // sent to it, and the state of its random number generator.
+    //
+    int64_t volatile LinkNextFreeUs;
+    int64_t volatile LinkRandomState;
+
+    //
+    // The next socket bound to the same port. Protected by the network lock.
+    //
+    struct CXPLAT_SOCKET* NextOnPort;
+
+    //
+    // The MTU for this binding.
+    //
+    uint16_t Mtu;
+
+    //
+    // The number of socket contexts.
+    //
+    uint16_t ContextCount;
+
+    //
+    // Indicates the port can be shared with other sharing sockets.
+    //
+    BOOLEAN Share : 1;
+
+    //
+    // Indicates the binding connected to a remote IP address.
+    //
+    BOOLEAN Connected : 1;
+
+    //
+    // Flag indicates the binding is being used for PCP.
+    //
+    BOOLEAN PcpBinding : 1;
+
+    //
+    // Set when the socket is deleted.
+    //
+    BOOLEAN volatile Shutdown;
+
+#if DEBUG
+    uint8_t Uninitialized : 1;
+#endif
+
+    //
+    // Per worker contexts (just one for connected sockets).
+    //
+    CXPLAT_MEMORY_SOCKET_CONTEXT Contexts[];
+
+} CXPLAT_SOCKET;
+
+//
+// Main datapath object.
+//
+typedef struct CXPLAT_DATAPATH {
+
+    //
+    // UDP handlers.
+    //
+    CXPLAT_UDP_DATAPATH_CALLBACKS UdpHandlers;
+
+    //
+    // The worker pool datagrams are delivered on.
+    //
+    CXPLAT_WORKER_POOL* WorkerPool;
+
+    //
+    // Synchronization mechanism for cleanup. Each socket holds a reference.
+    //
+    CXPLAT_REF_COUNT RefCount;
+
+    //
+    // Set of supported features.
+    //
+    CXPLAT_DATAPATH_FEATURES Features;
+
+    //
+    // The offset of the payload in a datagram.
+    //
+    uint32_t PayloadOffset;
+
+    //
+    // Pools of datagrams and send contexts.
+    //
+    CXPLAT_POOL DatagramPool;
+    CXPLAT_POOL SendDataPool;
+
+    //
+    // Receive statistics.
+    //
+    int64_t volatile RecvCallCount;
+    int64_t volatile RecvMessageCount;
+
+#if DEBUG
+    BOOLEAN Uninitialized : 1;
+    BOOLEAN Freed : 1;
+#endif
+
+} CXPLAT_DATAPATH;
+
+//
+// The network all in-memory sockets are attached to.
+//
+typedef struct CXPLAT_MEMORY_NETWORK {
+
+    //
+    // The number of initialized datapaths. Datapaths are initialized and
+    // uninitialized by the library, under its lock.
+    //
+    uint32_t DatapathCount;
+
+    //
+    // Protects the fields below.
+    //
+    CXPLAT_DISPATCH_RW_LOCK Lock;
+
+    //
+    // The sockets bound to each port.
+    //
+    CXPLAT_SOCKET** Ports;
+
+    //
+    // The next ephemeral port to try.
+    //
+    uint16_t NextEphemeralPort;
+
+    CXPLAT_MEMORY_LINK_CONFIG Link;
+
+} CXPLAT_MEMORY_NETWORK;
+
+static CXPLAT_MEMORY_NETWORK MemoryNetwork;
+
+static
+uint64_t
+CxPlatMemoryReadConfig(
+    _In_z_ const char* Name,
+    _In_ uint64_t Default
+    )
+{
+    const char* Value = getenv(Name);
+    if (Value == NULL || *Value == '\0') {
+        return Default;
+    }
+    return strtoull(Value, NULL, 0);
+}
+
+static
+BOOLEAN
+CxPlatMemoryAddrIsWildcard(
+    _In_ const QUIC_ADDR* Address
+    )
+{
+    if (QuicAddrGetFamily(Address) == QUIC_ADDRESS_FAMILY_INET) {
+        return Address->Ipv4.sin_addr.s_addr == 0;
+    }
+    if (QuicAddrGetFamily(Address) == QUIC_ADDRESS_FAMILY_INET6) {
+        return IN6_IS_ADDR_UNSPECIFIED(&Address->Ipv6.sin6_addr);
+    }
+    return TRUE;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDataPathInitialize(
+    _In_ uint32_t ClientRecvContextLength,
+    _In_opt_ const CXPLAT_UDP_DATAPATH_CALLBACKS* UdpCallbacks,
+    _In_opt_ const CXPLAT_TCP_DATAPATH_CALLBACKS* TcpCallbacks,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ CXPLAT_DATAPATH_INIT_CONFIG* InitConfig,
+    _Out_ CXPLAT_DATAPATH** NewDatapath
+    )
+{
+    UNREFERENCED_PARAMETER(TcpCallbacks);
+
+    if (NewDatapath == NULL || WorkerPool == NULL) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+    if (UdpCallbacks != NULL) {
+        if (UdpCallbacks->Receive == NULL || UdpCallbacks->Unreachable == NULL) {
+            return QUIC_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    CXPLAT_DATAPATH* Datapath =
+        (CXPLAT_DATAPATH*)CXPLAT_ALLOC_PAGED(sizeof(CXPLAT_DATAPATH), QUIC_POOL_DATAPATH);
+    if (Datapath == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    CxPlatZeroMemory(Datapath, sizeof(*Datapath));
+
+    if (MemoryNetwork.DatapathCount == 0) {
+        MemoryNetwork.Ports =
+            CXPLAT_ALLOC_NONPAGED(
+                CXPLAT_MEMORY_PORT_COUNT * sizeof(CXPLAT_SOCKET*),
+                QUIC_POOL_DATAPATH);
+        if (MemoryNetwork.Ports == NULL) {
+            CXPLAT_FREE(Datapath, QUIC_POOL_DATAPATH);
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
+        CxPlatZeroMemory(
+            MemoryNetwork.Ports,
+            CXPLAT_MEMORY_PORT_COUNT * sizeof(CXPLAT_SOCKET*));
+        CxPlatDispatchRwLockInitialize(&MemoryNetwork.Lock);
+        MemoryNetwork.NextEphemeralPort = CXPLAT_MEMORY_EPHEMERAL_PORT_MIN;
+
+        CXPLAT_MEMORY_LINK_CONFIG* Link = &MemoryNetwork.Link;
+        Link->DelayUs = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_DELAY_US", 0);
+        Link->LossPpm = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_LOSS_PPM", 0);
+        Link->ReorderPpm = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_REORDER_PPM", 0);
+        Link->ReorderDelayUs = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_REORDER_DELAY_US", 1000);
+        Link->BandwidthKbps = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_BANDWIDTH_KBPS", 0);
+        Link->QueueBytes = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_QUEUE_BYTES", 1024 * 1024);
+        Link->Seed = CxPlatMemoryReadConfig("MSQUIC_MEMORY_DATAPATH_SEED", 1);
+    }
+    MemoryNetwork.DatapathCount++;
+
+    if (UdpCallbacks) {
+        Datapath->UdpHandlers = *UdpCallbacks;
+    }
+    Datapath->WorkerPool = WorkerPool;
+    CxPlatRefInitialize(&Datapath->RefCount);
+
+    //
+    // Receive timestamps are the link arrival times, and departure times are
+    // honored by the link, so both are always available.
+    //
+    if (InitConfig->EnableRecvTimestamps) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_RECV_TIMESTAMPS;
+    }
+    if (InitConfig->EnableSendTxTime) {
+        Datapath->Features |= CXPLAT_DATAPATH_FEATURE_SEND_TXTIME;
+    }
+
+    Datapath->PayloadOffset =
+        (uint32_t)ALIGN_UP(sizeof(CXPLAT_MEMORY_DATAGRAM) + ClientRecvContextLength, uint64_t);
+    CxPlatPoolInitialize(
+        FALSE,
+        Datapath->PayloadOffset + CXPLAT_MEMORY_MAX_PAYLOAD_LENGTH,
+        QUIC_POOL_DATA,
+        &Datapath->DatagramPool);
+    CxPlatPoolInitialize(
+        FALSE,
+        sizeof(CXPLAT_SEND_DATA),
+        QUIC_POOL_PLATFORM_SENDCTX,
+        &Datapath->SendDataPool);
+
+    CXPLAT_FRE_ASSERT(CxPlatWorkerPoolAddRef(WorkerPool, CXPLAT_WORKER_POOL_REF_TOOL));
+    *NewDatapath = Datapath;
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+static
+void
+CxPlatDataPathRelease(
+    _In_ CXPLAT_DATAPATH* Datapath
+    )
+{
+    if (CxPlatRefDecrement(&Datapath->RefCount)) {
+#if DEBUG
+        CXPLAT_DBG_ASSERT(!Datapath->Freed);
+        CXPLAT_DBG_ASSERT(Datapath->Uninitialized);
+        Datapath->Freed = TRUE;
+#endif
+        CxPlatPoolUninitialize(&Datapath->SendDataPool);
+        CxPlatPoolUninitialize(&Datapath->DatagramPool);
+        CxPlatWorkerPoolRelease(Datapath->WorkerPool, CXPLAT_WORKER_POOL_REF_TOOL);
+        CXPLAT_FREE(Datapath, QUIC_POOL_DATAPATH);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathUninitialize(
+    _In_ CXPLAT_DATAPATH* Datapath
+    )
+{
+    if (Datapath != NULL) {
+#if DEBUG
+        CXPLAT_DBG_ASSERT(!Datapath->Uninitialized);
+        Datapath->Uninitialized = TRUE;
+#endif
+        CXPLAT_DBG_ASSERT(MemoryNetwork.DatapathCount > 0);
+        if (--MemoryNetwork.DatapathCount == 0) {
+            CxPlatDispatchRwLockUninitialize(&MemoryNetwork.Lock);
+            CXPLAT_FREE(MemoryNetwork.Ports, QUIC_POOL_DATAPATH);
+            MemoryNetwork.Ports = NULL;
+        }
+        CxPlatDataPathRelease(Datapath);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathUpdatePollingIdleTimeout(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ uint32_t PollingIdleTimeoutUs
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(PollingIdleTimeoutUs);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_DATAPATH_FEATURES
+CxPlatDataPathGetSupportedFeatures(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ CXPLAT_SOCKET_FLAGS SocketFlags
+    )
+{
+    UNREFERENCED_PARAMETER(SocketFlags);
+    return Datapath->Features;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    Statistics->RecvCallCount = (uint64_t)Datapath->RecvCallCount;
+    Statistics->RecvMessageCount = (uint64_t)Datapath->RecvMessageCount;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDataPathGetXdpQueueInfo(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(QueueInfo);
+    *QueueCount = 0;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatDataPathIsPaddingPreferred(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(SendData);
+    return FALSE;
+}
+
+static
+void
+CxPlatMemoryDatagramListFree(
+    _In_opt_ CXPLAT_SLIST_ENTRY* Entry
+    )
+{
+    while (Entry != NULL) {
+        CXPLAT_SLIST_ENTRY* Next = Entry->Next;
+        CxPlatPoolFree(CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_MEMORY_DATAGRAM, Link));
+        Entry = Next;
+    }
+}
+
+static
+void
+CxPlatMemorySocketRelease(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    if (CxPlatRefDecrement(&Socket->RefCount)) {
+        //
+        // Sends that were in progress when the socket contexts stopped may
+        // have left datagrams in the inboxes.
+        //
+        for (uint16_t i = 0; i < Socket->ContextCount; ++i) {
+            CxPlatMemoryDatagramListFree(Socket->Contexts[i].Inbox);
+        }
+        CXPLAT_DATAPATH* Datapath = Socket->Datapath;
+        CxPlatEventUninitialize(Socket->StoppedEvent);
+        CXPLAT_FREE(Socket, QUIC_POOL_SOCKET);
+        CxPlatDataPathRelease(Datapath);
+    }
+}
+
+//
+// Pushes a datagram onto a socket context's inbox, waking up its execution
+// context if the inbox was empty.
+//
+static
+void
+CxPlatMemorySocketContextPush(
+    _In_ CXPLAT_MEMORY_SOCKET_CONTEXT* SocketContext,
+    _In_ CXPLAT_MEMORY_DATAGRAM* Datagram
+    )
+{
+    CXPLAT_SLIST_ENTRY* Head;
+    do {
+        Head = (CXPLAT_SLIST_ENTRY*)QuicReadPtrNoFence((void**)&SocketContext->Inbox);
+        Datagram->Link.Next = Head;
+    } while (InterlockedCompareExchangePointer(
+                (void* volatile*)&SocketContext->Inbox, &Datagram->Link, Head) != Head);
+
+    if (Head == NULL) {
+        SocketContext->Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&SocketContext->Ec);
+    }
+}
+
+//
+// Moves the inbox to the pending list, which is kept in order of delivery
+// time. Datagrams mostly arrive in order, so they are usually appended.
+//
+static
+void
+CxPlatMemorySocketContextFlushInbox(
+    _In_ CXPLAT_MEMORY_SOCKET_CONTEXT* SocketContext
+    )
+{
+    if (QuicReadPtrNoFence((void**)&SocketContext->Inbox) == NULL) {
+        return;
+    }
+
+    CXPLAT_SLIST_ENTRY* Entry =
+        (CXPLAT_SLIST_ENTRY*)InterlockedExchangePointer(
+            (void* volatile*)&SocketContext->Inbox, NULL);
+    CXPLAT_SLIST_ENTRY* Reversed = NULL;
+    while (Entry != NULL) {
+        CXPLAT_SLIST_ENTRY* Next = Entry->Next;
+        Entry->Next = Reversed;
+        Reversed = Entry;
+        Entry = Next;
+    }
+
+    while (Reversed != NULL) {
+        CXPLAT_MEMORY_DATAGRAM* Datagram =
+            CXPLAT_CONTAINING_RECORD(Reversed, CXPLAT_MEMORY_DATAGRAM, Link);
+        Reversed = Reversed->Next;
+        Datagram->Next = NULL;
+
+        if (SocketContext->PendingTail == NULL) {
+            SocketContext->PendingHead = SocketContext->PendingTail = Datagram;
+        } else if (Datagram->DeliverTimeUs >= SocketContext->PendingTail->DeliverTimeUs) {
+            SocketContext->PendingTail->Next = Datagram;
+            SocketContext->PendingTail = Datagram;
+        } else {
+            CXPLAT_MEMORY_DATAGRAM** Prev = &SocketContext->PendingHead;
+            while ((*Prev)->DeliverTimeUs <= Datagram->DeliverTimeUs) {
+                Prev = &(*Prev)->Next;
+            }
+            Datagram->Next = *Prev;
+            *Prev = Datagram;
+        }
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+_Function_class_(CXPLAT_EXECUTION_FN)
+static
+BOOLEAN
+CxPlatMemorySocketContextRun(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    )
+{
+    CXPLAT_MEMORY_SOCKET_CONTEXT* SocketContext = (CXPLAT_MEMORY_SOCKET_CONTEXT*)Context;
+    CXPLAT_SOCKET* Socket = SocketContext->Socket;
+    UNREFERENCED_PARAMETER(State);
+
+    if (Socket->Shutdown) {
+        CxPlatMemoryDatagramListFree(
+            (CXPLAT_SLIST_ENTRY*)InterlockedExchangePointer(
+                (void* volatile*)&SocketContext->Inbox, NULL));
+        while (SocketContext->PendingHead != NULL) {
+            CXPLAT_MEMORY_DATAGRAM* Datagram = SocketContext->PendingHead;
+            SocketContext->PendingHead = Datagram->Next;
+            CxPlatPoolFree(Datagram);
+        }
+        SocketContext->PendingTail = NULL;
+        if (InterlockedDecrement16(&Socket->RunningContexts) == 0) {
+            CxPlatEventSet(Socket->StoppedEvent);
+        }
+        CxPlatMemorySocketRelease(Socket);
+        return FALSE; // The socket context must not be touched after this.
+    }
+
+    CxPlatMemorySocketContextFlushInbox(SocketContext);
+
+    //
+    // Deliver everything that has arrived as one chain.
+    //
+    const uint64_t Now = CxPlatTimeUs64();
+    CXPLAT_RECV_DATA* RecvDataChain = NULL;
+    CXPLAT_RECV_DATA** RecvDataTail = &RecvDataChain;
+    uint32_t RecvCount = 0;
+    while (SocketContext->PendingHead != NULL &&
+           SocketContext->PendingHead->DeliverTimeUs <= Now) {
+        CXPLAT_MEMORY_DATAGRAM* Datagram = SocketContext->PendingHead;
+        SocketContext->PendingHead = Datagram->Next;
+        *RecvDataTail = &Datagram->RecvData;
+        RecvDataTail = &Datagram->RecvData.Next;
+        RecvCount++;
+    }
+    if (SocketContext->PendingHead == NULL) {
+        SocketContext->PendingTail = NULL;
+        SocketContext->Ec.NextTimeUs = UINT64_MAX;
+    } else {
+        SocketContext->Ec.NextTimeUs = SocketContext->PendingHead->DeliverTimeUs;
+    }
+
+    if (RecvDataChain != NULL) {
+        CXPLAT_DATAPATH* Datapath = Socket->Datapath;
+        InterlockedIncrement64(&Datapath->RecvCallCount);
+        InterlockedExchangeAdd64(&Datapath->RecvMessageCount, RecvCount);
+        if (Socket->PcpBinding || Datapath->UdpHandlers.Receive == NULL) {
+            CxPlatRecvDataReturn(RecvDataChain);
+        } else {
+            Datapath->UdpHandlers.Receive(Socket, Socket->ClientContext, RecvDataChain);
+        }
+    }
+
+    return TRUE;
+}
+
+//
+// Binds the socket to its port. Called with the network lock held.
+//
+static
+QUIC_STATUS
+CxPlatMemorySocketBind(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    uint16_t Port = QuicAddrGetPort(&Socket->LocalAddress);
+    if (Port == 0) {
+        const uint32_t EphemeralCount =
+            CXPLAT_MEMORY_PORT_COUNT - CXPLAT_MEMORY_EPHEMERAL_PORT_MIN;
+        for (uint32_t i = 0; i < EphemeralCount; ++i) {
+            uint16_t Candidate = MemoryNetwork.NextEphemeralPort;
+            MemoryNetwork.NextEphemeralPort =
+                Candidate == UINT16_MAX ?
+                    CXPLAT_MEMORY_EPHEMERAL_PORT_MIN : (uint16_t)(Candidate + 1);
+            if (MemoryNetwork.Ports[Candidate] == NULL) {
+                Port = Candidate;
+                break;
+            }
+        }
+        if (Port == 0) {
+            return QUIC_STATUS_ADDRESS_IN_USE;
+        }
+        QuicAddrSetPort(&Socket->LocalAddress, Port);
+    } else {
+        //
+        // Like SO_REUSEADDR, a port can only be shared if every socket on it
+        // agrees to.
+        //
+        for (CXPLAT_SOCKET* Bound = MemoryNetwork.Ports[Port];
+                Bound != NULL; Bound = Bound->NextOnPort) {
+            if (!Socket->Share || !Bound->Share) {
+                return QUIC_STATUS_ADDRESS_IN_USE;
+            }
+        }
+    }
+
+    Socket->NextOnPort = MemoryNetwork.Ports[Port];
+    MemoryNetwork.Ports[Port] = Socket;
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Finds the socket a datagram from the source address to the port goes to:
+// the socket connected to the source, or else one of the unconnected sockets
+// picked by hashing the source, like SO_REUSEPORT. Called with the network
+// lock held.
+//
+static
+CXPLAT_SOCKET*
+CxPlatMemorySocketLookup(
+    _In_ uint16_t Port,
+    _In_ const QUIC_ADDR* SourceAddress
+    )
+{
+    const uint16_t SourcePort = QuicAddrGetPort(SourceAddress);
+    uint32_t UnconnectedCount = 0;
+    for (CXPLAT_SOCKET* Bound = MemoryNetwork.Ports[Port];
+            Bound != NULL; Bound = Bound->NextOnPort) {
+        if (!Bound->Connected) {
+            UnconnectedCount++;
+        } else if (QuicAddrGetPort(&Bound->RemoteAddress) == SourcePort) {
+            return Bound;
+        }
+    }
+
+    if (UnconnectedCount == 0) {
+        return NULL;
+    }
+    uint32_t Index = QuicAddrHash(SourceAddress) % UnconnectedCount;
+    for (CXPLAT_SOCKET* Bound = MemoryNetwork.Ports[Port];
+            Bound != NULL; Bound = Bound->NextOnPort) {
+        if (!Bound->Connected && Index-- == 0) {
+            return Bound;
+        }
+    }
+    return NULL;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatSocketCreateUdp(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_ const CXPLAT_UDP_CONFIG* Config,
+    _Out_ CXPLAT_SOCKET** NewSocket
+    )
+{
+    const uint16_t WorkerCount = (uint16_t)CxPlatWorkerPoolGetCount(Datapath->WorkerPool);
+    const BOOLEAN Connected = Config->RemoteAddress != NULL;
+
+    //
+    // Unconnected sockets receive on every worker, with datagrams spread by
+    // source address, like RSS would.
+    //
+    const uint16_t ContextCount =
+        (Connected || (Config->Flags & CXPLAT_SOCKET_FLAG_PARTITIONED)) ? 1 : WorkerCount;
+    const size_t SocketLength =
+        sizeof(CXPLAT_SOCKET) + ContextCount * sizeof(CXPLAT_MEMORY_SOCKET_CONTEXT);
+
+    CXPLAT_SOCKET* Socket = CXPLAT_ALLOC_PAGED(SocketLength, QUIC_POOL_SOCKET);
+    if (Socket == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    CxPlatZeroMemory(Socket, SocketLength);
+
+    Socket->Datapath = Datapath;
+    Socket->ClientContext = Config->CallbackContext;
+    Socket->Mtu = CXPLAT_MAX_MTU;
+    Socket->Connected = Connected;
+    Socket->Share = !!(Config->Flags & CXPLAT_SOCKET_FLAG_SHARE);
+    Socket->PcpBinding = !!(Config->Flags & CXPLAT_SOCKET_FLAG_PCP);
+    Socket->ContextCount = ContextCount;
+    Socket->RunningContexts = (short)ContextCount;
+    CxPlatRefInitializeEx(&Socket->RefCount, 1 + ContextCount);
+    CxPlatEventInitialize(&Socket->StoppedEvent, TRUE, FALSE);
+
+    if (Connected) {
+        Socket->RemoteAddress = *Config->RemoteAddress;
+        //
+        // Every address is local, so an unspecified local address takes the
+        // IP address of the remote.
+        //
+        if (Config->LocalAddress == NULL ||
+            CxPlatMemoryAddrIsWildcard(Config->LocalAddress)) {
+            Socket->LocalAddress = *Config->RemoteAddress;
+            QuicAddrSetPort(
+                &Socket->LocalAddress,
+                Config->LocalAddress ? QuicAddrGetPort(Config->LocalAddress) : 0);
+        } else {
+            Socket->LocalAddress = *Config->LocalAddress;
+        }
+    } else if (Config->LocalAddress != NULL) {
+        Socket->LocalAddress = *Config->LocalAddress;
+    } else {
+        QuicAddrSetFamily(&Socket->LocalAddress, QUIC_ADDRESS_FAMILY_INET6);
+    }
+
+    for (uint16_t i = 0; i < ContextCount; ++i) {
+        CXPLAT_MEMORY_SOCKET_CONTEXT* SocketContext = &Socket->Contexts[i];
+        SocketContext->Socket = Socket;
+        SocketContext->PartitionIndex =
+            ContextCount == 1 ? (uint16_t)(Config->PartitionIndex % WorkerCount) : i;
+        SocketContext->Ec.Context = SocketContext;
+        SocketContext->Ec.Callback = CxPlatMemorySocketContextRun;
+        SocketContext->Ec.NextTimeUs = UINT64_MAX;
+        CxPlatWorkerPoolAddExecutionContext(
+            Datapath->WorkerPool,
+            &SocketContext->Ec,
+            SocketContext->PartitionIndex);
+    }
+
+    CxPlatRefIncrement(&Datapath->RefCount);
+
+    CxPlatDispatchRwLockAcquireExclusive(&MemoryNetwork.Lock, PrevIrql);
+    QUIC_STATUS Status = CxPlatMemorySocketBind(Socket);
+    if (QUIC_SUCCEEDED(Status)) {
+        Socket->LinkRandomState =
+            (int64_t)((MemoryNetwork.Link.Seed ^
+                (QuicAddrGetPort(&Socket->LocalAddress) * 0x9E3779B97F4A7C15ull)) | 1);
+    }
+    CxPlatDispatchRwLockReleaseExclusive(&MemoryNetwork.Lock, PrevIrql);
+
+    if (QUIC_FAILED(Status)) {
+        //
+        // The execution contexts are already running; they clean up the
+        // socket once they see it shut down.
+        //
+        Socket->Shutdown = TRUE;
+        for (uint16_t i = 0; i < ContextCount; ++i) {
+            Socket->Contexts[i].Ec.Ready = TRUE;
+            CxPlatWakeExecutionContext(&Socket->Contexts[i].Ec);
+        }
+        CxPlatMemorySocketRelease(Socket);
+        return Status;
+    }
+
+    *NewSocket = Socket;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatSocketCreateTcp(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ const QUIC_ADDR* LocalAddress,
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_opt_ void* CallbackContext,
+    _Out_ CXPLAT_SOCKET** Socket
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(LocalAddress);
+    UNREFERENCED_PARAMETER(RemoteAddress);
+    UNREFERENCED_PARAMETER(CallbackContext);
+    UNREFERENCED_PARAMETER(Socket);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatSocketCreateTcpListener(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ const QUIC_ADDR* LocalAddress,
+    _In_opt_ void* CallbackContext,
+    _Out_ CXPLAT_SOCKET** Socket
+    )
+{
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(LocalAddress);
+    UNREFERENCED_PARAMETER(CallbackContext);
+    UNREFERENCED_PARAMETER(Socket);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatSocketDelete(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+
+#if DEBUG
+    CXPLAT_DBG_ASSERT(!Socket->Uninitialized);
+    Socket->Uninitialized = TRUE;
+#endif
+
+    CxPlatDispatchRwLockAcquireExclusive(&MemoryNetwork.Lock, PrevIrql);
+    CXPLAT_SOCKET** Link = &MemoryNetwork.Ports[QuicAddrGetPort(&Socket->LocalAddress)];
+    while (*Link != Socket) {
+        CXPLAT_DBG_ASSERT(*Link != NULL);
+        Link = &(*Link)->NextOnPort;
+    }
+    *Link = Socket->NextOnPort;
+    CxPlatDispatchRwLockReleaseExclusive(&MemoryNetwork.Lock, PrevIrql);
+
+    Socket->Shutdown = TRUE;
+    BOOLEAN OnWorker = FALSE;
+    for (uint16_t i = 0; i < Socket->ContextCount; ++i) {
+        if (CxPlatWorkerIsThisThread(&Socket->Contexts[i].Ec)) {
+            OnWorker = TRUE;
+        }
+        Socket->Contexts[i].Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Socket->Contexts[i].Ec);
+    }
+
+    //
+    // Wait for the receive upcalls in progress to complete, unless this is
+    // the thread of one of the socket contexts, which can't be running then.
+    //
+    if (!OnWorker) {
+        CxPlatEventWaitForever(Socket->StoppedEvent);
+    }
+
+    CxPlatMemorySocketRelease(Socket);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatSocketUpdateQeo(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_reads_(OffloadCount)
+        const CXPLAT_QEO_CONNECTION* Offloads,
+    _In_ uint32_t OffloadCount
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(Offloads);
+    UNREFERENCED_PARAMETER(OffloadCount);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint16_t
+CxPlatSocketGetLocalMtu(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ CXPLAT_ROUTE* Route
+    )
+{
+    UNREFERENCED_PARAMETER(Route);
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+    return Socket->Mtu;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSocketGetLocalAddress(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Out_ QUIC_ADDR* Address
+    )
+{
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+    *Address = Socket->LocalAddress;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSocketGetRemoteAddress(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Out_ QUIC_ADDR* Address
+    )
+{
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+    *Address = Socket->RemoteAddress;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatSocketRawSocketAvailable(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+    return FALSE;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatRecvDataReturn(
+    _In_opt_ CXPLAT_RECV_DATA* RecvDataChain
+    )
+{
+    CXPLAT_RECV_DATA* RecvData;
+    while ((RecvData = RecvDataChain) != NULL) {
+        RecvDataChain = RecvDataChain->Next;
+        CxPlatPoolFree(
+            CXPLAT_CONTAINING_RECORD(RecvData, CXPLAT_MEMORY_DATAGRAM, RecvData));
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+CXPLAT_SEND_DATA*
+CxPlatSendDataAlloc(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Inout_ CXPLAT_SEND_CONFIG* Config
+    )
+{
+    CXPLAT_DBG_ASSERT(Socket != NULL);
+
+    CXPLAT_SEND_DATA* SendData = CxPlatPoolAlloc(&Socket->Datapath->SendDataPool);
+    if (SendData != NULL) {
+        SendData->Datapath = Socket->Datapath;
+        SendData->TxTimeUs = Config->TxTimeUs;
+        SendData->ECN = Config->ECN;
+        SendData->DSCP = Config->DSCP;
+        SendData->BufferCount = 0;
+    }
+
+    return SendData;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSendDataFree(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    for (uint32_t i = 0; i < SendData->BufferCount; ++i) {
+        if (SendData->Datagrams[i] != NULL) {
+            CxPlatPoolFree(SendData->Datagrams[i]);
+        }
+    }
+
+    CxPlatPoolFree(SendData);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+_Success_(return != NULL)
+QUIC_BUFFER*
+CxPlatSendDataAllocBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ uint16_t MaxBufferLength
+    )
+{
+    CXPLAT_DBG_ASSERT(MaxBufferLength <= CXPLAT_MEMORY_MAX_PAYLOAD_LENGTH);
+
+    if (SendData->BufferCount == CXPLAT_MEMORY_MAX_BATCH_SEND) {
+        return NULL;
+    }
+
+    CXPLAT_MEMORY_DATAGRAM* Datagram =
+        CxPlatPoolAlloc(&SendData->Datapath->DatagramPool);
+    if (Datagram == NULL) {
+        return NULL;
+    }
+
+    QUIC_BUFFER* Buffer = &SendData->Buffers[SendData->BufferCount];
+    Buffer->Buffer = (uint8_t*)Datagram + SendData->Datapath->PayloadOffset;
+    Buffer->Length = MaxBufferLength;
+    SendData->Datagrams[SendData->BufferCount] = Datagram;
+    SendData->BufferCount++;
+
+    return Buffer;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSendDataFreeBuffer(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ QUIC_BUFFER* Buffer
+    )
+{
+    //
+    // This must be the final send buffer; intermediate buffers cannot be freed.
+    //
+    CXPLAT_DBG_ASSERT(SendData->BufferCount > 0);
+    CXPLAT_DBG_ASSERT(Buffer == &SendData->Buffers[SendData->BufferCount - 1]);
+    UNREFERENCED_PARAMETER(Buffer);
+
+    SendData->BufferCount--;
+    CxPlatPoolFree(SendData->Datagrams[SendData->BufferCount]);
+    SendData->Datagrams[SendData->BufferCount] = NULL;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatSendDataIsFull(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    return SendData->BufferCount == CXPLAT_MEMORY_MAX_BATCH_SEND;
+}
+
+//
+// Returns the next value of the link's random number generator (xorshift64*).
+//
+static
+uint64_t
+CxPlatMemoryLinkRandom(
+    _In_ CXPLAT_SOCKET* Socket
+    )
+{
+    int64_t Old, New;
+    do {
+        Old = Socket->LinkRandomState;
+        uint64_t Value = (uint64_t)Old;
+        Value ^= Value >> 12;
+        Value ^= Value << 25;
+        Value ^= Value >> 27;
+        New = (int64_t)Value;
+    } while (InterlockedCompareExchange64(&Socket->LinkRandomState, New, Old) != Old);
+    return (uint64_t)New * 0x2545F4914F6CDD1Dull;
+}
+
+//
+// Passes a datagram over a socket's inbound link. Returns FALSE if the link
+// drops it, otherwise when it arrives.
+//
+static
+BOOLEAN
+CxPlatMemoryLinkTransmit(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ uint32_t Length,
+    _In_ uint64_t DepartureTimeUs,
+    _Out_ uint64_t* DeliverTimeUs
+    )
+{
+    const CXPLAT_MEMORY_LINK_CONFIG* Config = &MemoryNetwork.Link;
+
+    if (Config->LossPpm != 0 &&
+        CxPlatMemoryLinkRandom(Socket) % 1000000 < Config->LossPpm) {
+        return FALSE;
+    }
+
+    uint64_t ArrivalTimeUs = DepartureTimeUs;
+    if (Config->BandwidthKbps != 0) {
+        //
+        // The datagram is serialized after the ones already queued, unless
+        // that would exceed the queue.
+        //
+        const uint64_t SerializationUs =
+            ((uint64_t)Length * 8000 + Config->BandwidthKbps - 1) / Config->BandwidthKbps;
+        int64_t Old, New;
+        do {
+            Old = Socket->LinkNextFreeUs;
+            const uint64_t StartUs = CXPLAT_MAX((uint64_t)Old, DepartureTimeUs);
+            const uint64_t QueuedBytes =
+                (StartUs - DepartureTimeUs) * Config->BandwidthKbps / 8000;
+            if (QueuedBytes + Length > Config->QueueBytes) {
+                return FALSE;
+            }
+            New = (int64_t)(StartUs + SerializationUs);
+        } while (InterlockedCompareExchange64(&Socket->LinkNextFreeUs, New, Old) != Old);
+        ArrivalTimeUs = (uint64_t)New;
+    }
+
+    ArrivalTimeUs += Config->DelayUs;
+    if (Config->ReorderPpm != 0 &&
+        CxPlatMemoryLinkRandom(Socket) % 1000000 < Config->ReorderPpm) {
+        ArrivalTimeUs += Config->ReorderDelayUs;
+    }
+
+    *DeliverTimeUs = ArrivalTimeUs;
+    return TRUE;
+}
+
+//
+// Fills in the receive data of a datagram that made it over the link and
+// pushes it to the receiving socket context.
+//
+static
+void
+CxPlatMemoryDatagramDeliver(
+    _In_ CXPLAT_MEMORY_SOCKET_CONTEXT* SocketContext,
+    _In_ CXPLAT_MEMORY_DATAGRAM* Datagram,
+    _In_ const QUIC_ADDR* SourceAddress,
+    _In_ const QUIC_ADDR* DestinationAddress,
+    _In_ uint8_t* Buffer,
+    _In_ uint16_t Length,
+    _In_ uint8_t TypeOfService
+    )
+{
+    CxPlatZeroMemory(&Datagram->Route, sizeof(Datagram->Route));
+    Datagram->Route.RemoteAddress = *SourceAddress;
+    Datagram->Route.LocalAddress = *DestinationAddress;
+    Datagram->Route.State = RouteResolved;
+    Datagram->Route.DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
+
+    CXPLAT_RECV_DATA* RecvData = &Datagram->RecvData;
+    RecvData->Next = NULL;
+    RecvData->Route = &Datagram->Route;
+    RecvData->Buffer = Buffer;
+    RecvData->BufferLength = Length;
+    RecvData->PartitionIndex = SocketContext->PartitionIndex;
+    RecvData->TypeOfService = TypeOfService;
+    RecvData->HopLimitTTL = 64;
+    RecvData->RecvTimeUs = Datagram->DeliverTimeUs;
+    RecvData->Allocated = TRUE;
+    RecvData->QueuedOnConnection = FALSE;
+    RecvData->DatapathType = CXPLAT_DATAPATH_TYPE_NORMAL;
+    RecvData->Reserved = 0;
+    RecvData->Decrypted = FALSE;
+
+    CxPlatMemorySocketContextPush(SocketContext, Datagram);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatSocketSend(
+    _In_ CXPLAT_SOCKET* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    QUIC_ADDR SourceAddress = Route->LocalAddress;
+    QuicAddrSetPort(&SourceAddress, QuicAddrGetPort(&Socket->LocalAddress));
+    const uint16_t DestinationPort = QuicAddrGetPort(&Route->RemoteAddress);
+
+    //
+    // Find the destination and hold a reference on it. Datagrams to nowhere
+    // are dropped.
+    //
+    CXPLAT_SOCKET* Destination = NULL;
+    if (!Socket->PcpBinding) {
+        CxPlatDispatchRwLockAcquireShared(&MemoryNetwork.Lock, PrevIrql);
+        Destination = CxPlatMemorySocketLookup(DestinationPort, &SourceAddress);
+        if (Destination != NULL) {
+            CxPlatRefIncrement(&Destination->RefCount);
+        }
+        CxPlatDispatchRwLockReleaseShared(&MemoryNetwork.Lock, PrevIrql);
+    }
+
+    if (Destination != NULL) {
+        CXPLAT_MEMORY_SOCKET_CONTEXT* SocketContext =
+            &Destination->Contexts[
+                Destination->ContextCount == 1 ?
+                    0 : QuicAddrHash(&SourceAddress) % Destination->ContextCount];
+
+        const uint64_t Now = CxPlatTimeUs64();
+        const uint64_t DepartureTimeUs = CXPLAT_MAX(Now, SendData->TxTimeUs);
+
+        for (uint32_t i = 0; i < SendData->BufferCount; ++i) {
+            CXPLAT_MEMORY_DATAGRAM* Datagram = SendData->Datagrams[i];
+            const uint32_t Length = SendData->Buffers[i].Length;
+            if (!CxPlatMemoryLinkTransmit(
+                    Destination, Length, DepartureTimeUs, &Datagram->DeliverTimeUs)) {
+                continue; // Freed with the send data.
+            }
+            SendData->Datagrams[i] = NULL;
+
+            CxPlatMemoryDatagramDeliver(
+                SocketContext,
+                Datagram,
+                &SourceAddress,
+                &Route->RemoteAddress,
+                SendData->Buffers[i].Buffer,
+                (uint16_t)Length,
+                (uint8_t)(SendData->ECN | (SendData->DSCP << 2)));
+        }
+
+        CxPlatMemorySocketRelease(Destination);
+    }
+
+    CxPlatSendDataFree(SendData);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatMemoryDataPathInject(
+    _In_ const QUIC_ADDR* SourceAddress,
+    _In_ const QUIC_ADDR* DestinationAddress,
+    _In_ uint16_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    )
+{
+    if (Length > CXPLAT_MEMORY_MAX_PAYLOAD_LENGTH) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (MemoryNetwork.DatapathCount == 0) {
+        return QUIC_STATUS_INVALID_STATE;
+    }
+
+    CxPlatDispatchRwLockAcquireShared(&MemoryNetwork.Lock, PrevIrql);
+    CXPLAT_SOCKET* Destination =
+        CxPlatMemorySocketLookup(QuicAddrGetPort(DestinationAddress), SourceAddress);
+    if (Destination != NULL) {
+        CxPlatRefIncrement(&Destination->RefCount);
+    }
+    CxPlatDispatchRwLockReleaseShared(&MemoryNetwork.Lock, PrevIrql);
+
+    if (Destination == NULL) {
+        return QUIC_STATUS_NOT_FOUND;
+    }
+
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    CXPLAT_MEMORY_DATAGRAM* Datagram =
+        CxPlatPoolAlloc(&Destination->Datapath->DatagramPool);
+    if (Datagram == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    if (!CxPlatMemoryLinkTransmit(
+            Destination, Length, CxPlatTimeUs64(), &Datagram->DeliverTimeUs)) {
+        CxPlatPoolFree(Datagram);
+        goto Exit; // Dropped by the link, like a sent datagram would be.
+    }
+
+    uint8_t* Payload = (uint8_t*)Datagram + Destination->Datapath->PayloadOffset;
+    CxPlatCopyMemory(Payload, Buffer, Length);
+
+    CxPlatMemoryDatagramDeliver(
+        &Destination->Contexts[
+            Destination->ContextCount == 1 ?
+                0 : QuicAddrHash(SourceAddress) % Destination->ContextCount],
+        Datagram,
+        SourceAddress,
+        DestinationAddress,
+        Payload,
+        Length,
+        0);
+
+Exit:
+
+    CxPlatMemorySocketRelease(Destination);
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatSocketGetTcpStatistics(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Out_ CXPLAT_TCP_STATISTICS* Statistics
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(Statistics);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+QuicCopyRouteInfo(
+    _Inout_ CXPLAT_ROUTE* DstRoute,
+    _In_ CXPLAT_ROUTE* SrcRoute
+    )
+{
+    *DstRoute = *SrcRoute;
+}
+
+void
+CxPlatResolveRouteComplete(
+    _In_ void* Context,
+    _Inout_ CXPLAT_ROUTE* Route,
+    _In_reads_bytes_(6) const uint8_t* PhysicalAddress,
+    _In_ uint8_t PathId
+    )
+{
+    UNREFERENCED_PARAMETER(Context);
+    UNREFERENCED_PARAMETER(Route);
+    UNREFERENCED_PARAMETER(PhysicalAddress);
+    UNREFERENCED_PARAMETER(PathId);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatResolveRoute(
+    _In_ CXPLAT_SOCKET* Socket,
+    _Inout_ CXPLAT_ROUTE* Route,
+    _In_ uint8_t PathId,
+    _In_ void* Context,
+    _In_ CXPLAT_ROUTE_RESOLUTION_CALLBACK_HANDLER Callback
+    )
+{
+    UNREFERENCED_PARAMETER(Socket);
+    UNREFERENCED_PARAMETER(PathId);
+    UNREFERENCED_PARAMETER(Context);
+    UNREFERENCED_PARAMETER(Callback);
+    Route->State = RouteResolved;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatUpdateRoute(
+    _Inout_ CXPLAT_ROUTE* DstRoute,
+    _In_ CXPLAT_ROUTE* SrcRoute
+    )
+{
+    UNREFERENCED_PARAMETER(DstRoute);
+    UNREFERENCED_PARAMETER(SrcRoute);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDataPathRssConfigGet(
+    _In_ uint32_t InterfaceIndex,
+    _Outptr_ _At_(*RssConfig, __drv_allocatesMem(Mem))
+        CXPLAT_RSS_CONFIG** RssConfig
+    )
+{
+    UNREFERENCED_PARAMETER(InterfaceIndex);
+    UNREFERENCED_PARAMETER(RssConfig);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathRssConfigFree(
+    _In_ CXPLAT_RSS_CONFIG* RssConfig
+    )
+{
+    UNREFERENCED_PARAMETER(RssConfig);
+    CXPLAT_FRE_ASSERTMSG(FALSE, "CxPlatDataPathRssConfigFree not supported");
+}
@@ -22,6 +22,7 @@ RawDataPathInitialize(
     _In_ uint32_t ClientRecvContextLength,
     _In_opt_ const CXPLAT_DATAPATH* ParentDataPath,
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig,
     _Outptr_result_maybenull_ CXPLAT_DATAPATH_RAW** NewDataPath
     )
 {
@@ -46,7 +47,7 @@ RawDataPathInitialize(
     }
     SockPoolInitialized = TRUE;
 
-    Status = CxPlatDpRawInitialize(DataPath, ClientRecvContextLength, WorkerPool);
+    Status = CxPlatDpRawInitialize(DataPath, ClientRecvContextLength, WorkerPool, InitConfig);
     if (QUIC_FAILED(Status)) {
         goto Error;
     }
@@ -133,6 +134,18 @@ RawDataPathGetSupportedFeatures(
         CXPLAT_DATAPATH_FEATURE_SEND_DSCP | CXPLAT_DATAPATH_FEATURE_RECV_DSCP;
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+RawDataPathGetXdpQueueInfo(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    )
+{
+    return CxPlatDpRawGetQueueInfo(Datapath, QueueCount, QueueInfo);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 RawDataPathIsPaddingPreferred(
@@ -170,6 +183,7 @@ RawSocketDelete(
     CxPlatDpRawPlumbRulesOnSocket(Socket, FALSE);
     CxPlatRemoveSocket(&Socket->RawDatapath->SocketPool, Socket);
     CxPlatRundownReleaseAndWait(&Socket->RawRundown);
+    CxPlatDpRawQeoCleanup(Socket);
     if (Socket->PausedTcpSend) {
         CxPlatDpRawTxFree(Socket->PausedTcpSend);
     }
@@ -190,6 +204,97 @@ RawSocketGetLocalMtu(
 
 }
 
+//
+// The number of short header destination CID bytes compared when grouping
+// received packets. The datapath doesn't know the real CID length, so only a
+// prefix no longer than the minimum server CID length is used.
+//
+#define CXPLAT_RX_GRO_SHORT_CID_LENGTH 8
+
+static
+uint8_t
+CxPlatDpRawRxGetDestCid(
+    _In_ const CXPLAT_RECV_DATA* Packet,
+    _Outptr_result_buffer_maybenull_(return) const uint8_t** DestCid
+    )
+{
+    *DestCid = NULL;
+    if (Packet->BufferLength < 1) {
+        return 0;
+    }
+
+    if (Packet->Buffer[0] & 0x80) {
+        //
+        // Long header: 1 byte flags, 4 byte version, 1 byte DCID length.
+        //
+        if (Packet->BufferLength < 6 ||
+            Packet->BufferLength < 6 + (uint32_t)Packet->Buffer[5]) {
+            return 0;
+        }
+        *DestCid = Packet->Buffer + 6;
+        return Packet->Buffer[5];
+    }
+
+    *DestCid = Packet->Buffer + 1;
+    return (uint8_t)CXPLAT_MIN(Packet->BufferLength - 1, CXPLAT_RX_GRO_SHORT_CID_LENGTH);
+}
+
+static
+BOOLEAN
+CxPlatDpRawRxIsSameFlow(
+    _In_ const CXPLAT_RECV_DATA* Packet1,
+    _In_ const CXPLAT_RECV_DATA* Packet2
+    )
+{
+    if (Packet1->Reserved != Packet2->Reserved ||
+        (Packet1->Reserved != L4_TYPE_UDP && Packet1->Reserved != L4_TYPE_TCP) ||
+        !QuicAddrCompare(&Packet1->Route->RemoteAddress, &Packet2->Route->RemoteAddress) ||
+        !QuicAddrCompare(&Packet1->Route->LocalAddress, &Packet2->Route->LocalAddress)) {
+        return FALSE;
+    }
+
+    const uint8_t* DestCid1;
+    const uint8_t* DestCid2;
+    const uint8_t DestCidLength1 = CxPlatDpRawRxGetDestCid(Packet1, &DestCid1);
+    const uint8_t DestCidLength2 = CxPlatDpRawRxGetDestCid(Packet2, &DestCid2);
+    return
+        DestCidLength1 == DestCidLength2 &&
+        (DestCidLength1 == 0 || memcmp(DestCid1, DestCid2, DestCidLength1) == 0);
+}
+
+//
+// Software GRO: stably reorders the receive batch so that packets with the
+// same 4-tuple and destination CID are adjacent. The relative order of packets
+// within a flow is preserved, so this only merges interleaved flows into
+// longer chains for the delivery loop and the binding's DCID grouping.
+//
+static
+void
+CxPlatDpRawRxGroup(
+    _Inout_updates_(PacketCount)
+        CXPLAT_RECV_DATA** Packets,
+    _In_ uint16_t PacketCount
+    )
+{
+    for (uint16_t i = 0; i + 1 < PacketCount; i++) {
+        uint16_t Insert = i + 1;
+        for (uint16_t j = i + 1; j < PacketCount; j++) {
+            if (CxPlatDpRawRxIsSameFlow(Packets[i], Packets[j])) {
+                if (j != Insert) {
+                    CXPLAT_RECV_DATA* Packet = Packets[j];
+                    CxPlatMoveMemory(
+                        &Packets[Insert + 1],
+                        &Packets[Insert],
+                        (j - Insert) * sizeof(CXPLAT_RECV_DATA*));
+                    Packets[Insert] = Packet;
+                }
+                Insert++;
+            }
+        }
+        i = Insert - 1; // Skip over the group just built.
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 CxPlatDpRawRxEthernet(
@@ -199,6 +304,10 @@ CxPlatDpRawRxEthernet(
     _In_ uint16_t PacketCount
     )
 {
+    if (PacketCount > 1) {
+        CxPlatDpRawRxGroup(Packets, PacketCount);
+    }
+
     for (uint16_t i = 0; i < PacketCount; i++) {
         CXPLAT_SOCKET_RAW* Socket = NULL;
         CXPLAT_RECV_DATA* PacketChain = Packets[i];
@@ -230,7 +339,10 @@ CxPlatDpRawRxEthernet(
                     CXPLAT_DBG_ASSERT(Packets[i+1]->Next == NULL);
                     i++;
                 }
-                Datapath->ParentDataPath->UdpHandlers.Receive(CxPlatRawToSocket(Socket), Socket->ClientContext, PacketChain);
+                CxPlatDpRawQeoRx(Socket, &PacketChain);
+                if (PacketChain != NULL) {
+                    Datapath->ParentDataPath->UdpHandlers.Receive(CxPlatRawToSocket(Socket), Socket->ClientContext, PacketChain);
+                }
             } else if (PacketChain->Reserved == L4_TYPE_TCP_SYN || PacketChain->Reserved == L4_TYPE_TCP_SYNACK) {
                 CxPlatDpRawSocketAckSyn(Socket, PacketChain);
                 CxPlatDpRawRxFree(PacketChain);
@@ -332,10 +444,16 @@ RawSocketSend(
     CXPLAT_DBG_ASSERT(Route->State == RouteResolved);
     CXPLAT_DBG_ASSERT(Route->Queue != NULL);
 
+    const BOOLEAN L4XsumOffloaded = CxPlatDpRawIsL4TxXsumOffloadedOnQueue(Route->Queue);
+    if (!CxPlatDpRawQeoTx(Socket, Route, SendData, !L4XsumOffloaded)) {
+        CxPlatDpRawTxFree(SendData);
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
     CxPlatFramingWriteHeaders(
         Socket, Route, SendData, &SendData->Buffer, SendData->ECN, SendData->DSCP,
         CxPlatDpRawIsL3TxXsumOffloadedOnQueue(Route->Queue),
-        CxPlatDpRawIsL4TxXsumOffloadedOnQueue(Route->Queue),
+        L4XsumOffloaded,
         Route->TcpState.SequenceNumber,
         Route->TcpState.AckNumber,
         TH_ACK);
@@ -20,6 +20,46 @@ typedef struct CXPLAT_SOCKET_POOL {
 } CXPLAT_SOCKET_POOL;
 
 
+//
+// The number of (direct mapped) entries in the shared route cache. Must be a
+// power of 2.
+//
+#define CXPLAT_ROUTE_CACHE_SIZE             256
+
+//
+// Cached routes older than this (in us) are still used, but refreshed in the
+// background. Route and neighbor change notifications force a refresh sooner.
+//
+#define CXPLAT_ROUTE_CACHE_REFRESH_US       (30 * 1000 * 1000)
+
+//
+// Cached routes older than this (in us) are no longer used.
+//
+#define CXPLAT_ROUTE_CACHE_EXPIRY_US        (5 * 60 * 1000 * 1000)
+
+//
+// How often (in ms) the route worker checks for change notifications, when
+// it has nothing else to do.
+//
+#define CXPLAT_ROUTE_CACHE_NOTIFY_POLL_MS   100
+
+//
+// A resolved route to a remote IP address.
+//
+typedef struct CXPLAT_ROUTE_CACHE_ENTRY {
+    QUIC_ADDR RemoteAddress;    // Port is always 0.
+    QUIC_ADDR LocalAddress;     // Only valid if HasLocalAddress.
+    QUIC_ADDR NextHop;
+    uint64_t ResolvedTimeUs;
+    uint32_t IfIndex;
+    uint8_t NextHopLinkLayerAddress[6];
+    BOOLEAN Valid : 1;
+    BOOLEAN HasLocalAddress : 1;
+    BOOLEAN NextHopResolved : 1;
+    BOOLEAN Stale : 1;          // Changes were notified since it was resolved.
+    BOOLEAN RefreshQueued : 1;
+} CXPLAT_ROUTE_CACHE_ENTRY;
+
 //
 // A worker thread for draining queued route resolution operations.
 //
@@ -42,6 +82,18 @@ typedef struct QUIC_CACHEALIGN CXPLAT_ROUTE_RESOLUTION_WORKER {
     //
     CXPLAT_DISPATCH_LOCK Lock;
     CXPLAT_LIST_ENTRY Operations;
+
+    //
+    // Netlink socket subscribed to route and neighbor changes, or -1.
+    //
+    int NotificationSocket;
+
+    //
+    // Routes resolved for any socket on the datapath, so connections to the
+    // same destinations don't each query the routing and neighbor tables.
+    //
+    CXPLAT_DISPATCH_LOCK CacheLock;
+    CXPLAT_ROUTE_CACHE_ENTRY Cache[CXPLAT_ROUTE_CACHE_SIZE];
 } CXPLAT_ROUTE_RESOLUTION_WORKER;
 
 typedef struct CXPLAT_DATAPATH_RAW {
@@ -90,6 +142,13 @@ typedef struct CXPLAT_SEND_DATA {
 
     QUIC_BUFFER Buffer;
 
+    //
+    // The (folded, not complemented) one's complement sum of Buffer, if it
+    // was computed in the same pass that protected the payload.
+    //
+    uint16_t PayloadChecksum;
+    BOOLEAN PayloadChecksumValid;
+
 } CXPLAT_SEND_DATA;
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -112,7 +171,8 @@ QUIC_STATUS
 CxPlatDpRawInitialize(
     _Inout_ CXPLAT_DATAPATH_RAW* Datapath,
     _In_ uint32_t ClientRecvContextLength,
-    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig
     );
 
 //
@@ -143,6 +203,19 @@ CxPlatDpRawUpdatePollingIdleTimeout(
     _In_ uint32_t PollingIdleTimeoutUs
     );
 
+//
+// Reports the mode each queue ended up in. On input QueueCount is the capacity
+// of QueueInfo; on output it's the number of queues.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawGetQueueInfo(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    );
+
 //
 // Called on creation and deletion of a socket. It indicates to the raw datapath
 // that it should update any filtering rules as necessary.
@@ -311,6 +384,10 @@ typedef struct CXPLAT_SOCKET_RAW {
     CXPLAT_SEND_DATA* PausedTcpSend; // Paused TCP send data *before* framing
     CXPLAT_SEND_DATA* CachedRstSend; // Cached TCP RST send data *after* framing
 
+    CXPLAT_RW_LOCK QeoLock;          // Protects QeoOffloads
+    CXPLAT_HASHTABLE* QeoOffloads;   // Encryption offloads. NULL until the first one is added
+    uint8_t QeoRxCidLength;          // Length of (our) CIDs of receive offloads
+
     CXPLAT_SOCKET;
 } CXPLAT_SOCKET_RAW;
 
@@ -373,6 +450,58 @@ CxPlatRemoveSocket(
     _In_ CXPLAT_SOCKET_RAW* Socket
     );
 
+//
+// QUIC Encryption Offload (QEO) helpers, applying the packet protection of
+// offloaded connections on the datapath.
+//
+
+//
+// Adds or removes the offloads for a connection.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawQeoUpdate(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(OffloadCount)
+        const CXPLAT_QEO_CONNECTION* Offloads,
+    _In_ uint32_t OffloadCount
+    );
+
+//
+// Frees all the offload state of a socket being deleted.
+//
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawQeoCleanup(
+    _In_ CXPLAT_SOCKET_RAW* Socket
+    );
+
+//
+// Protects an (unframed) datagram of an offloaded connection. Returns FALSE if
+// the datagram needs protecting but couldn't be, and must not be sent. If
+// ComputeChecksum is set, the transport checksum of the payload is computed
+// right after protecting it, while it's still in cache.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatDpRawQeoTx(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _Inout_ CXPLAT_SEND_DATA* SendData,
+    _In_ BOOLEAN ComputeChecksum
+    );
+
+//
+// Unprotects the received datagrams of offloaded connections, marking them
+// as Decrypted. Datagrams that fail to decrypt may be dropped from the chain.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawQeoRx(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _Inout_ CXPLAT_RECV_DATA** PacketChain
+    );
+
 //
 // Network framing helpers. Used for Ethernet, IP (v4 & v6) and UDP.
 //
@@ -408,6 +537,17 @@ CxPlatDpRawSocketAckFin(
     _In_ CXPLAT_RECV_DATA* Packet
     );
 
+//
+// Computes the (folded, not complemented) one's complement sum of the buffer.
+//
+_IRQL_requires_max_(DISPATCH_LEVEL)
+uint16_t
+CxPlatFramingChecksum(
+    _In_reads_(Length) uint8_t* Data,
+    _In_ uint32_t Length,
+    _In_ uint64_t InitialChecksum
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 CxPlatFramingWriteHeaders(
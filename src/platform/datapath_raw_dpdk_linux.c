@@ -0,0 +1,1104 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    QUIC Raw Datapath DPDK (poll mode driver) backend. Packet framing, sockets
+    and route resolution are shared with the other raw backends; this file only
+    moves frames between the NIC queues and the raw datapath.
+
+    Each worker (partition) owns one RX/TX queue pair on every port and an mbuf
+    pool that both its RX queues and sends allocate from. Workers register
+    themselves with DPDK the first time they poll, so they get an lcore ID and
+    the pool's per-lcore cache. Sends from other threads are batched onto the
+    route's queue under a lock and flushed by the owning worker.
+
+    Packets are spread across the queues by RSS. Where the NIC supports it,
+    short header packets to our UDP ports are also steered by the partition ID
+    in their destination CID (rte_flow), so they land on the queue of the worker
+    that owns the connection.
+
+--*/
+
+#include "datapath_raw_linux.h"
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_flow.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+
+#define RX_BATCH_SIZE       32
+#define TX_BATCH_SIZE       32
+#define RING_SIZE           1024
+#define MBUF_COUNT          (8192 * 2 - 1) // Per partition. Optimal for mempools is 2^n - 1.
+#define MBUF_CACHE_SIZE     256
+#define MAX_ETH_FRAME_SIZE  1514
+
+#define IF_TAG              'IpdD' // DdpI
+#define QUEUE_TAG           'QpdD' // DdpQ
+#define RULE_TAG            'UpdD' // DdpU
+
+//
+// The EAL arguments, separated by spaces. The EAL can only be initialized once
+// per process, so if the app already did, these are ignored.
+//
+#define DPDK_EAL_ARGS_ENV           "MSQUIC_DPDK_EAL_ARGS"
+#define DPDK_EAL_ARGS_DEFAULT       "--in-memory"
+#define DPDK_EAL_MAX_ARGS           32
+
+//
+// The length of the server ID our CIDs start with, which the partition ID
+// follows: 0 unless a load balancing mode is set (QUIC_PARAM_GLOBAL_LOAD_BALACING_MODE),
+// in which case it's 5.
+//
+#define DPDK_CID_SID_LENGTH_ENV     "MSQUIC_DPDK_CID_SERVER_ID_LENGTH"
+
+typedef struct DPDK_DATAPATH DPDK_DATAPATH;
+typedef struct DPDK_PARTITION DPDK_PARTITION;
+
+typedef struct DPDK_INTERFACE {
+    CXPLAT_INTERFACE;
+    uint16_t PortId;
+    uint16_t QueueCount;
+    CXPLAT_QUEUE* Queues; // An array of queues, one per partition.
+    BOOLEAN Configured;
+    BOOLEAN Started;
+    BOOLEAN Isolated;       // Only traffic matching our flow rules is received.
+    CXPLAT_LOCK RulesLock;
+    CXPLAT_LIST_ENTRY Rules;
+} DPDK_INTERFACE;
+
+//
+// The flow rules for one local UDP port on an interface.
+//
+typedef struct DPDK_PORT_RULE {
+    CXPLAT_LIST_ENTRY Link;
+    uint16_t Port;          // Network byte order.
+    uint16_t RefCount;      // The number of sockets bound to the port.
+    uint32_t FlowCount;
+    struct rte_flow* Flows[0];
+} DPDK_PORT_RULE;
+
+typedef struct CXPLAT_QUEUE {
+    const DPDK_INTERFACE* Interface;
+    DPDK_PARTITION* Partition;
+    struct CXPLAT_QUEUE* Next;
+    uint16_t QueueId;
+
+    //
+    // Sends batched for the NIC. Sends are issued from any thread, so they
+    // are synchronized by TxLock.
+    //
+    CXPLAT_LOCK TxLock;
+    uint16_t TxCount;
+    struct rte_mbuf* TxBatch[TX_BATCH_SIZE];
+
+    //
+    // Diagnostic counters, updated under TxLock.
+    //
+    uint32_t TxSubmitted;
+    uint64_t TxRingFullCount;
+} CXPLAT_QUEUE;
+
+typedef struct QUIC_CACHEALIGN DPDK_PARTITION {
+    CXPLAT_EXECUTION_CONTEXT Ec;
+    CXPLAT_SQE ShutdownSqe;
+    const struct DPDK_DATAPATH* Dpdk;
+    CXPLAT_EVENTQ* EventQ;
+    CXPLAT_QUEUE* Queues; // A linked list of queues, accessed by Next.
+    struct rte_mempool* MbufPool;
+    uint16_t PartitionIndex;
+    uint16_t Processor;
+    BOOLEAN LcoreRegistered;
+    BOOLEAN ShutdownSqeInitialized;
+} DPDK_PARTITION;
+
+typedef struct DPDK_DATAPATH {
+    CXPLAT_DATAPATH_RAW;
+    CXPLAT_REF_COUNT RefCount;
+    uint32_t PartitionCount;
+    uint8_t CidServerIdLength;
+    BOOLEAN Running;        // Signal to stop workers.
+    DPDK_PARTITION Partitions[0];
+} DPDK_DATAPATH;
+
+//
+// Both are stored in the private area of their mbuf.
+//
+typedef struct DPDK_RX_PACKET {
+    struct rte_mbuf* Mbuf;
+    CXPLAT_ROUTE RouteStorage;
+    CXPLAT_RECV_DATA RecvData;
+    // Followed by:
+    // uint8_t ClientContext[...];
+} DPDK_RX_PACKET;
+
+typedef struct DPDK_TX_PACKET {
+    CXPLAT_SEND_DATA;
+    struct rte_mbuf* Mbuf;
+    CXPLAT_QUEUE* Queue;
+} DPDK_TX_PACKET;
+
+CXPLAT_EVENT_COMPLETION CxPlatPartitionShutdownEventComplete;
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+CxPlatDpdkExecute(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    );
+
+static
+QUIC_STATUS
+CxPlatDpdkEalInitialize(
+    void
+    )
+{
+    static BOOLEAN EalInitialized = FALSE;
+    if (EalInitialized) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    const char* EnvArgs = getenv(DPDK_EAL_ARGS_ENV);
+    char Args[512];
+    snprintf(Args, sizeof(Args), "%s", EnvArgs != NULL ? EnvArgs : DPDK_EAL_ARGS_DEFAULT);
+
+    char* Argv[DPDK_EAL_MAX_ARGS + 1] = { "msquic" };
+    int Argc = 1;
+    char* SavePtr = NULL;
+    for (char* Arg = strtok_r(Args, " ", &SavePtr);
+         Arg != NULL && Argc < DPDK_EAL_MAX_ARGS;
+         Arg = strtok_r(NULL, " ", &SavePtr)) {
+        Argv[Argc++] = Arg;
+    }
+
+    if (rte_eal_init(Argc, Argv) < 0 && rte_errno != EALREADY) {
+        return QUIC_STATUS_INTERNAL_ERROR;
+    }
+
+    //
+    // N.B. The EAL is never cleaned up, as it can't be initialized again.
+    //
+    EalInitialized = TRUE;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawAssignQueue(
+    _In_ const CXPLAT_INTERFACE* _Interface,
+    _Inout_ CXPLAT_ROUTE* Route
+    )
+{
+    //
+    // Prefer the queue of the worker on the current processor, so its sends
+    // are flushed without a cross-thread wake.
+    //
+    const DPDK_INTERFACE* Interface = (const DPDK_INTERFACE*)_Interface;
+    const uint32_t Processor = CxPlatProcCurrentNumber();
+    Route->Queue = &Interface->Queues[0];
+    for (uint16_t i = 0; i < Interface->QueueCount; i++) {
+        if (Interface->Queues[i].Partition->Processor == Processor) {
+            Route->Queue = &Interface->Queues[i];
+            break;
+        }
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+const CXPLAT_INTERFACE*
+CxPlatDpRawGetInterfaceFromQueue(
+    _In_ const CXPLAT_QUEUE* Queue
+    )
+{
+    return (const CXPLAT_INTERFACE*)Queue->Interface;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+size_t
+CxPlatDpRawGetDatapathSize(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    )
+{
+    const uint32_t PartitionCount = CxPlatWorkerPoolGetCount(WorkerPool);
+    return sizeof(DPDK_DATAPATH) + (PartitionCount * sizeof(DPDK_PARTITION));
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawInterfaceUninitialize(
+    _Inout_ DPDK_INTERFACE* Interface
+    )
+{
+    while (!CxPlatListIsEmpty(&Interface->Rules)) {
+        DPDK_PORT_RULE* Rule =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Interface->Rules), DPDK_PORT_RULE, Link);
+        for (uint32_t i = 0; i < Rule->FlowCount; i++) {
+            if (Rule->Flows[i] != NULL) {
+                rte_flow_destroy(Interface->PortId, Rule->Flows[i], NULL);
+            }
+        }
+        CxPlatFree(Rule, RULE_TAG);
+    }
+
+    if (Interface->Started) {
+        rte_eth_dev_stop(Interface->PortId);
+    }
+    if (Interface->Configured) {
+        rte_eth_dev_close(Interface->PortId);
+    }
+
+    for (uint32_t i = 0; Interface->Queues != NULL && i < Interface->QueueCount; i++) {
+        CXPLAT_QUEUE* Queue = &Interface->Queues[i];
+        rte_pktmbuf_free_bulk(Queue->TxBatch, Queue->TxCount);
+        CxPlatLockUninitialize(&Queue->TxLock);
+    }
+
+    if (Interface->Queues != NULL) {
+        CxPlatFree(Interface->Queues, QUEUE_TAG);
+    }
+
+    CxPlatLockUninitialize(&Interface->RulesLock);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawInterfaceInitialize(
+    _In_ DPDK_DATAPATH* Dpdk,
+    _Inout_ DPDK_INTERFACE* Interface
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    struct rte_eth_dev_info DevInfo;
+
+    CxPlatLockInitialize(&Interface->RulesLock);
+    CxPlatListInitializeHead(&Interface->Rules);
+
+    if (rte_eth_dev_info_get(Interface->PortId, &DevInfo) != 0) {
+        Status = QUIC_STATUS_INTERNAL_ERROR;
+        goto Error;
+    }
+
+    //
+    // Routes are resolved with the kernel's tables, so only ports that still
+    // have a kernel interface (bifurcated drivers) can be used.
+    //
+    if (DevInfo.if_index == 0) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
+        goto Error;
+    }
+    Interface->IfIndex = Interface->ActualIfIndex = DevInfo.if_index;
+
+    struct rte_ether_addr MacAddress;
+    if (rte_eth_macaddr_get(Interface->PortId, &MacAddress) != 0) {
+        Status = QUIC_STATUS_INTERNAL_ERROR;
+        goto Error;
+    }
+    CXPLAT_STATIC_ASSERT(
+        sizeof(MacAddress.addr_bytes) == sizeof(Interface->PhysicalAddress),
+        "MAC address sizes must match");
+    CxPlatCopyMemory(Interface->PhysicalAddress, MacAddress.addr_bytes, sizeof(Interface->PhysicalAddress));
+
+    //
+    // Receive only the traffic our flow rules match (see
+    // CxPlatDpRawPlumbRulesOnSocket), leaving the rest to the kernel. Not all
+    // NICs support it, in which case the datapath drops what isn't ours.
+    //
+    Interface->Isolated = rte_flow_isolate(Interface->PortId, 1, NULL) == 0;
+
+    Interface->QueueCount =
+        (uint16_t)CXPLAT_MIN(Dpdk->PartitionCount, CXPLAT_MIN(DevInfo.max_rx_queues, DevInfo.max_tx_queues));
+    if (Interface->QueueCount == 0) {
+        Status = QUIC_STATUS_NOT_SUPPORTED;
+        goto Error;
+    }
+
+    struct rte_eth_conf PortConf;
+    CxPlatZeroMemory(&PortConf, sizeof(PortConf));
+    PortConf.rxmode.mq_mode = RTE_ETH_MQ_RX_RSS;
+    PortConf.rx_adv_conf.rss_conf.rss_hf =
+        (RTE_ETH_RSS_IP | RTE_ETH_RSS_UDP | RTE_ETH_RSS_TCP) & DevInfo.flow_type_rss_offloads;
+    PortConf.txmode.offloads =
+        DevInfo.tx_offload_capa &
+        (RTE_ETH_TX_OFFLOAD_IPV4_CKSUM | RTE_ETH_TX_OFFLOAD_UDP_CKSUM | RTE_ETH_TX_OFFLOAD_TCP_CKSUM);
+    Interface->OffloadStatus.Transmit.NetworkLayerXsum =
+        !!(PortConf.txmode.offloads & RTE_ETH_TX_OFFLOAD_IPV4_CKSUM);
+    Interface->OffloadStatus.Transmit.TransportLayerXsum =
+        (PortConf.txmode.offloads & (RTE_ETH_TX_OFFLOAD_UDP_CKSUM | RTE_ETH_TX_OFFLOAD_TCP_CKSUM)) ==
+        (RTE_ETH_TX_OFFLOAD_UDP_CKSUM | RTE_ETH_TX_OFFLOAD_TCP_CKSUM);
+
+    if (rte_eth_dev_configure(
+            Interface->PortId, Interface->QueueCount, Interface->QueueCount, &PortConf) != 0) {
+        Status = QUIC_STATUS_INTERNAL_ERROR;
+        goto Error;
+    }
+    Interface->Configured = TRUE;
+
+    uint16_t RxRingSize = RING_SIZE;
+    uint16_t TxRingSize = RING_SIZE;
+    rte_eth_dev_adjust_nb_rx_tx_desc(Interface->PortId, &RxRingSize, &TxRingSize);
+
+    Interface->Queues =
+        CxPlatAlloc(Interface->QueueCount * sizeof(*Interface->Queues), QUEUE_TAG);
+    if (Interface->Queues == NULL) {
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Error;
+    }
+    CxPlatZeroMemory(Interface->Queues, Interface->QueueCount * sizeof(*Interface->Queues));
+
+    const int SocketId = rte_eth_dev_socket_id(Interface->PortId);
+    for (uint16_t i = 0; i < Interface->QueueCount; i++) {
+        CXPLAT_QUEUE* Queue = &Interface->Queues[i];
+        DPDK_PARTITION* Partition = &Dpdk->Partitions[i];
+        Queue->Interface = Interface;
+        Queue->QueueId = i;
+        CxPlatLockInitialize(&Queue->TxLock);
+
+        if (rte_eth_rx_queue_setup(
+                Interface->PortId, i, RxRingSize, SocketId, NULL, Partition->MbufPool) != 0 ||
+            rte_eth_tx_queue_setup(
+                Interface->PortId, i, TxRingSize, SocketId, NULL) != 0) {
+            Interface->QueueCount = i + 1;
+            Status = QUIC_STATUS_INTERNAL_ERROR;
+            goto Error;
+        }
+    }
+
+    if (rte_eth_dev_start(Interface->PortId) != 0) {
+        Status = QUIC_STATUS_INTERNAL_ERROR;
+        goto Error;
+    }
+    Interface->Started = TRUE;
+
+    //
+    // Only now that the port is up, hand its queues to the partitions.
+    //
+    for (uint16_t i = 0; i < Interface->QueueCount; i++) {
+        CXPLAT_QUEUE* Queue = &Interface->Queues[i];
+        DPDK_PARTITION* Partition = &Dpdk->Partitions[i];
+        CXPLAT_QUEUE** Tail = &Partition->Queues;
+        while (*Tail != NULL) {
+            Tail = &(*Tail)->Next;
+        }
+        *Tail = Queue;
+        Queue->Partition = Partition;
+    }
+
+Error:
+    if (QUIC_FAILED(Status)) {
+        CxPlatDpRawInterfaceUninitialize(Interface);
+    }
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawInitialize(
+    _Inout_ CXPLAT_DATAPATH_RAW* Datapath,
+    _In_ uint32_t ClientRecvContextLength,
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig
+    )
+{
+    UNREFERENCED_PARAMETER(InitConfig);
+    DPDK_DATAPATH* Dpdk = (DPDK_DATAPATH*)Datapath;
+    QUIC_STATUS Status;
+
+    CxPlatListInitializeHead(&Dpdk->Interfaces);
+    Dpdk->PartitionCount = CxPlatWorkerPoolGetCount(WorkerPool);
+    const char* SidLength = getenv(DPDK_CID_SID_LENGTH_ENV);
+    Dpdk->CidServerIdLength = SidLength != NULL ? (uint8_t)atoi(SidLength) : 0;
+
+    Status = CxPlatDpdkEalInitialize();
+    if (QUIC_FAILED(Status)) {
+        return Status;
+    }
+
+    //
+    // The private area of each mbuf holds either the receive or the send
+    // bookkeeping (and the client's receive context).
+    //
+    const uint16_t PrivateSize = (uint16_t)
+        RTE_ALIGN_CEIL(
+            CXPLAT_MAX(sizeof(DPDK_RX_PACKET) + ClientRecvContextLength, sizeof(DPDK_TX_PACKET)),
+            RTE_MBUF_PRIV_ALIGN);
+    static long PoolId = 0;
+    const long DatapathId = InterlockedIncrement(&PoolId);
+
+    for (uint32_t i = 0; i < Dpdk->PartitionCount; i++) {
+        DPDK_PARTITION* Partition = &Dpdk->Partitions[i];
+        Partition->Dpdk = Dpdk;
+        Partition->PartitionIndex = (uint16_t)i;
+        Partition->Processor = (uint16_t)CxPlatWorkerPoolGetIdealProcessor(WorkerPool, i);
+
+        char PoolName[RTE_MEMPOOL_NAMESIZE];
+        snprintf(PoolName, sizeof(PoolName), "msquic_%ld_%u", DatapathId, i);
+        Partition->MbufPool =
+            rte_pktmbuf_pool_create(
+                PoolName,
+                MBUF_COUNT,
+                MBUF_CACHE_SIZE,
+                PrivateSize,
+                RTE_MBUF_DEFAULT_BUF_SIZE,
+                SOCKET_ID_ANY);
+        if (Partition->MbufPool == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Error;
+        }
+    }
+
+    uint16_t PortId;
+    RTE_ETH_FOREACH_DEV(PortId) {
+        DPDK_INTERFACE* Interface = CxPlatAlloc(sizeof(DPDK_INTERFACE), IF_TAG);
+        if (Interface == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Error;
+        }
+        CxPlatZeroMemory(Interface, sizeof(*Interface));
+        Interface->PortId = PortId;
+        if (QUIC_FAILED(CxPlatDpRawInterfaceInitialize(Dpdk, Interface))) {
+            CxPlatFree(Interface, IF_TAG);
+            continue;
+        }
+        CxPlatListInsertTail(&Dpdk->Interfaces, &Interface->Link);
+    }
+
+    if (CxPlatListIsEmpty(&Dpdk->Interfaces)) {
+        Status = QUIC_STATUS_NOT_FOUND;
+        goto Error;
+    }
+
+    Dpdk->Running = TRUE;
+    CxPlatRefInitialize(&Dpdk->RefCount);
+    for (uint32_t i = 0; i < Dpdk->PartitionCount; i++) {
+        DPDK_PARTITION* Partition = &Dpdk->Partitions[i];
+        if (Partition->Queues == NULL) {
+            //
+            // The NICs have fewer queues than there are workers. Queues are
+            // assigned in order, so no later worker has any either.
+            //
+            Dpdk->PartitionCount = i;
+            break;
+        }
+
+        Partition->Ec.Ready = TRUE;
+        Partition->Ec.NextTimeUs = UINT64_MAX;
+        Partition->Ec.Callback = CxPlatDpdkExecute;
+        Partition->Ec.Context = Partition;
+        Partition->EventQ = CxPlatWorkerPoolGetEventQ(WorkerPool, (uint16_t)i);
+
+        if (!CxPlatSqeInitialize(
+                Partition->EventQ,
+                CxPlatPartitionShutdownEventComplete,
+                &Partition->ShutdownSqe)) {
+            Status = QUIC_STATUS_INTERNAL_ERROR;
+            goto Error;
+        }
+        Partition->ShutdownSqeInitialized = TRUE;
+    }
+
+    //
+    // Nothing can fail from here on, so the workers can start polling.
+    //
+    for (uint32_t i = 0; i < Dpdk->PartitionCount; i++) {
+        CxPlatRefIncrement(&Dpdk->RefCount);
+        CxPlatWorkerPoolAddExecutionContext(
+            WorkerPool, &Dpdk->Partitions[i].Ec, Dpdk->Partitions[i].PartitionIndex);
+    }
+
+    return QUIC_STATUS_SUCCESS;
+
+Error:
+    Dpdk->Running = FALSE;
+    while (!CxPlatListIsEmpty(&Dpdk->Interfaces)) {
+        DPDK_INTERFACE* Interface =
+            CXPLAT_CONTAINING_RECORD(CxPlatListRemoveHead(&Dpdk->Interfaces), DPDK_INTERFACE, Link);
+        CxPlatDpRawInterfaceUninitialize(Interface);
+        CxPlatFree(Interface, IF_TAG);
+    }
+    for (uint32_t i = 0; i < CxPlatWorkerPoolGetCount(WorkerPool); i++) {
+        DPDK_PARTITION* Partition = &Dpdk->Partitions[i];
+        if (Partition->ShutdownSqeInitialized) {
+            CxPlatSqeCleanup(Partition->EventQ, &Partition->ShutdownSqe);
+        }
+        rte_mempool_free(Partition->MbufPool); // NULL is ignored.
+        Partition->MbufPool = NULL;
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawRelease(
+    _In_ DPDK_DATAPATH* Dpdk
+    )
+{
+    if (CxPlatRefDecrement(&Dpdk->RefCount)) {
+        while (!CxPlatListIsEmpty(&Dpdk->Interfaces)) {
+            DPDK_INTERFACE* Interface =
+                CXPLAT_CONTAINING_RECORD(CxPlatListRemoveHead(&Dpdk->Interfaces), DPDK_INTERFACE, Link);
+            CxPlatDpRawInterfaceUninitialize(Interface);
+            CxPlatFree(Interface, IF_TAG);
+        }
+        for (uint32_t i = 0; i < Dpdk->PartitionCount; i++) {
+            CxPlatSqeCleanup(Dpdk->Partitions[i].EventQ, &Dpdk->Partitions[i].ShutdownSqe);
+        }
+        for (uint32_t i = 0; i < CxPlatWorkerPoolGetCount(Dpdk->WorkerPool); i++) {
+            rte_mempool_free(Dpdk->Partitions[i].MbufPool);
+        }
+        CxPlatDataPathUninitializeComplete((CXPLAT_DATAPATH_RAW*)Dpdk);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawUninitialize(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath
+    )
+{
+    DPDK_DATAPATH* Dpdk = (DPDK_DATAPATH*)Datapath;
+    Dpdk->Running = FALSE; // Each partition calls CxPlatDpRawRelease.
+    for (uint32_t i = 0; i < Dpdk->PartitionCount; i++) {
+        Dpdk->Partitions[i].Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Dpdk->Partitions[i].Ec);
+    }
+    CxPlatDpRawRelease(Dpdk);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawUpdatePollingIdleTimeout(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath,
+    _In_ uint32_t PollingIdleTimeoutUs
+    )
+{
+    //
+    // Poll mode queues have no notifications to wait on, so the workers always
+    // poll.
+    //
+    UNREFERENCED_PARAMETER(Datapath);
+    UNREFERENCED_PARAMETER(PollingIdleTimeoutUs);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawGetQueueInfo(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    )
+{
+    DPDK_DATAPATH* Dpdk = (DPDK_DATAPATH*)Datapath;
+    const uint32_t Capacity = QueueInfo != NULL ? *QueueCount : 0;
+    uint32_t Count = 0;
+
+    CXPLAT_LIST_ENTRY* Entry = Dpdk->Interfaces.Flink;
+    for (; Entry != &Dpdk->Interfaces; Entry = Entry->Flink) {
+        DPDK_INTERFACE* Interface =
+            (DPDK_INTERFACE*)CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_INTERFACE, Link);
+        for (uint16_t i = 0; i < Interface->QueueCount; i++, Count++) {
+            if (Count < Capacity) {
+                CxPlatZeroMemory(&QueueInfo[Count], sizeof(QueueInfo[Count]));
+                QueueInfo[Count].InterfaceIndex = Interface->IfIndex;
+                QueueInfo[Count].QueueId = i;
+                QueueInfo[Count].NativeMode = TRUE;
+                QueueInfo[Count].ZeroCopy = TRUE;
+                QueueInfo[Count].TxRingFullCount = Interface->Queues[i].TxRingFullCount;
+            }
+        }
+    }
+
+    *QueueCount = Count;
+    return Count > Capacity ? QUIC_STATUS_BUFFER_TOO_SMALL : QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+RawSocketUpdateQeo(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(OffloadCount)
+        const CXPLAT_QEO_CONNECTION* Offloads,
+    _In_ uint32_t OffloadCount
+    )
+{
+    //
+    // NIC crypto offloads aren't programmed through DPDK (yet), so they are
+    // applied in-line by the datapath.
+    //
+    return CxPlatDpRawQeoUpdate(Socket, Offloads, OffloadCount);
+}
+
+//
+// Creates the flow rules for a local UDP port, for one address family:
+//
+// - Short header packets are steered to the queue of the partition encoded
+//   in their destination CID, where the NIC can match on the payload.
+// - On isolated ports, everything else (UDP and, for QTIP, TCP) is spread
+//   across the queues with RSS.
+//
+// Rules the NIC doesn't support are left NULL; RSS covers for them.
+//
+static
+void
+CxPlatDpdkCreatePortFlows(
+    _In_ const DPDK_DATAPATH* Dpdk,
+    _In_ const DPDK_INTERFACE* Interface,
+    _In_ BOOLEAN IsIpv6,
+    _Inout_ DPDK_PORT_RULE* Rule
+    )
+{
+    const struct rte_flow_attr CidAttr = { .priority = 0, .ingress = 1 };
+    const struct rte_flow_attr RssAttr = { .priority = 1, .ingress = 1 };
+    const struct rte_flow_item_udp UdpSpec = { .hdr.dst_port = Rule->Port };
+    const struct rte_flow_item_udp UdpMask = { .hdr.dst_port = 0xFFFF };
+    const struct rte_flow_item_tcp TcpSpec = { .hdr.dst_port = Rule->Port };
+    const struct rte_flow_item_tcp TcpMask = { .hdr.dst_port = 0xFFFF };
+    const enum rte_flow_item_type L3Type =
+        IsIpv6 ? RTE_FLOW_ITEM_TYPE_IPV6 : RTE_FLOW_ITEM_TYPE_IPV4;
+
+    //
+    // The partition ID follows the first byte and the server ID. Its first
+    // (little endian) byte holds the partition index in the low bits (see
+    // QuicPartitionIdCreate).
+    //
+    uint8_t PartitionMask = 0;
+    while (PartitionMask < 0xFF && (uint32_t)PartitionMask + 1 < Dpdk->PartitionCount) {
+        PartitionMask = (uint8_t)((PartitionMask << 1) | 1);
+    }
+    uint8_t CidPattern[1 + UINT8_MAX + 1] = {0};
+    uint8_t CidPatternMask[1 + UINT8_MAX + 1] = {0};
+    const uint16_t CidPatternLength = (uint16_t)(1 + Dpdk->CidServerIdLength + 1);
+    CidPatternMask[0] = 0x80; // Short header.
+    CidPatternMask[CidPatternLength - 1] = PartitionMask;
+    const struct rte_flow_item_raw CidMask = {
+        .relative = 1, .search = 1, .offset = -1, .limit = 0xFFFF,
+        .length = 0xFFFF, .pattern = CidPatternMask
+    };
+
+    for (uint32_t Value = 0; Value <= PartitionMask; Value++) {
+        CidPattern[CidPatternLength - 1] = (uint8_t)Value;
+        const struct rte_flow_item_raw CidSpec = {
+            .relative = 1, .offset = 0, .length = CidPatternLength, .pattern = CidPattern
+        };
+        const struct rte_flow_item Pattern[] = {
+            { .type = RTE_FLOW_ITEM_TYPE_ETH },
+            { .type = L3Type },
+            { .type = RTE_FLOW_ITEM_TYPE_UDP, .spec = &UdpSpec, .mask = &UdpMask },
+            { .type = RTE_FLOW_ITEM_TYPE_RAW, .spec = &CidSpec, .mask = &CidMask },
+            { .type = RTE_FLOW_ITEM_TYPE_END }
+        };
+        //
+        // The same mapping as QuicPartitionIdGetIndex, folded onto the queues
+        // when there are fewer queues than partitions.
+        //
+        const struct rte_flow_action_queue QueueAction = {
+            .index = (uint16_t)((Value % Dpdk->PartitionCount) % Interface->QueueCount)
+        };
+        const struct rte_flow_action Actions[] = {
+            { .type = RTE_FLOW_ACTION_TYPE_QUEUE, .conf = &QueueAction },
+            { .type = RTE_FLOW_ACTION_TYPE_END }
+        };
+        Rule->Flows[Rule->FlowCount++] =
+            rte_flow_create(Interface->PortId, &CidAttr, Pattern, Actions, NULL);
+    }
+
+    if (!Interface->Isolated) {
+        return;
+    }
+
+    uint16_t Queues[RTE_MAX_QUEUES_PER_PORT];
+    for (uint16_t i = 0; i < Interface->QueueCount; i++) {
+        Queues[i] = i;
+    }
+    for (uint32_t i = 0; i < 2; i++) {
+        const BOOLEAN IsTcp = i == 1;
+        const struct rte_flow_action_rss RssAction = {
+            .func = RTE_ETH_HASH_FUNCTION_DEFAULT,
+            .types = RTE_ETH_RSS_IP | (IsTcp ? RTE_ETH_RSS_TCP : RTE_ETH_RSS_UDP),
+            .queue_num = Interface->QueueCount,
+            .queue = Queues
+        };
+        const struct rte_flow_item Pattern[] = {
+            { .type = RTE_FLOW_ITEM_TYPE_ETH },
+            { .type = L3Type },
+            IsTcp ?
+                (struct rte_flow_item){ .type = RTE_FLOW_ITEM_TYPE_TCP, .spec = &TcpSpec, .mask = &TcpMask } :
+                (struct rte_flow_item){ .type = RTE_FLOW_ITEM_TYPE_UDP, .spec = &UdpSpec, .mask = &UdpMask },
+            { .type = RTE_FLOW_ITEM_TYPE_END }
+        };
+        const struct rte_flow_action Actions[] = {
+            { .type = RTE_FLOW_ACTION_TYPE_RSS, .conf = &RssAction },
+            { .type = RTE_FLOW_ACTION_TYPE_END }
+        };
+        Rule->Flows[Rule->FlowCount++] =
+            rte_flow_create(Interface->PortId, &RssAttr, Pattern, Actions, NULL);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawPlumbRulesOnSocket(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_ BOOLEAN IsCreated
+    )
+{
+    const DPDK_DATAPATH* Dpdk = (const DPDK_DATAPATH*)Socket->RawDatapath;
+    const uint16_t Port = Socket->LocalAddress.Ipv4.sin_port;
+
+    CXPLAT_LIST_ENTRY* Entry = Dpdk->Interfaces.Flink;
+    for (; Entry != &Dpdk->Interfaces; Entry = Entry->Flink) {
+        DPDK_INTERFACE* Interface =
+            (DPDK_INTERFACE*)CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_INTERFACE, Link);
+
+        CxPlatLockAcquire(&Interface->RulesLock);
+        DPDK_PORT_RULE* Rule = NULL;
+        CXPLAT_LIST_ENTRY* RuleEntry = Interface->Rules.Flink;
+        for (; RuleEntry != &Interface->Rules; RuleEntry = RuleEntry->Flink) {
+            DPDK_PORT_RULE* Candidate = CXPLAT_CONTAINING_RECORD(RuleEntry, DPDK_PORT_RULE, Link);
+            if (Candidate->Port == Port) {
+                Rule = Candidate;
+                break;
+            }
+        }
+
+        if (IsCreated) {
+            if (Rule != NULL) {
+                Rule->RefCount++;
+            } else {
+                //
+                // Per address family: one CID rule per partition mask value,
+                // plus the UDP and TCP RSS rules.
+                //
+                const uint32_t MaxFlowCount = 2 * (UINT8_MAX + 1 + 2);
+                Rule =
+                    CxPlatAlloc(
+                        sizeof(DPDK_PORT_RULE) + MaxFlowCount * sizeof(struct rte_flow*),
+                        RULE_TAG);
+                if (Rule != NULL) {
+                    Rule->Port = Port;
+                    Rule->RefCount = 1;
+                    Rule->FlowCount = 0;
+                    CxPlatDpdkCreatePortFlows(Dpdk, Interface, FALSE, Rule);
+                    CxPlatDpdkCreatePortFlows(Dpdk, Interface, TRUE, Rule);
+                    CxPlatListInsertTail(&Interface->Rules, &Rule->Link);
+                }
+            }
+        } else if (Rule != NULL && --Rule->RefCount == 0) {
+            CxPlatListEntryRemove(&Rule->Link);
+            for (uint32_t i = 0; i < Rule->FlowCount; i++) {
+                if (Rule->Flows[i] != NULL) {
+                    rte_flow_destroy(Interface->PortId, Rule->Flows[i], NULL);
+                }
+            }
+            CxPlatFree(Rule, RULE_TAG);
+        }
+        CxPlatLockRelease(&Interface->RulesLock);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatDpRawIsL3TxXsumOffloadedOnQueue(
+    _In_ const CXPLAT_QUEUE* Queue
+    )
+{
+    return Queue->Interface->OffloadStatus.Transmit.NetworkLayerXsum;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatDpRawIsL4TxXsumOffloadedOnQueue(
+    _In_ const CXPLAT_QUEUE* Queue
+    )
+{
+    return Queue->Interface->OffloadStatus.Transmit.TransportLayerXsum;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawRxFree(
+    _In_opt_ const CXPLAT_RECV_DATA* PacketChain
+    )
+{
+    while (PacketChain) {
+        const DPDK_RX_PACKET* Packet =
+            CXPLAT_CONTAINING_RECORD(PacketChain, DPDK_RX_PACKET, RecvData);
+        PacketChain = PacketChain->Next;
+        rte_pktmbuf_free(Packet->Mbuf);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+CXPLAT_SEND_DATA*
+CxPlatDpRawTxAlloc(
+    _Inout_ CXPLAT_SEND_CONFIG* Config
+    )
+{
+    CXPLAT_DBG_ASSERT(Config->MaxPacketSize <= MAX_UDP_PAYLOAD_LENGTH);
+    CXPLAT_QUEUE* Queue = Config->Route->Queue;
+    struct rte_mbuf* Mbuf = rte_pktmbuf_alloc(Queue->Partition->MbufPool);
+    if (Mbuf == NULL) {
+        return NULL;
+    }
+
+    DPDK_TX_PACKET* Packet = (DPDK_TX_PACKET*)rte_mbuf_to_priv(Mbuf);
+    HEADER_BACKFILL HeaderBackfill = CxPlatDpRawCalculateHeaderBackFill(Config->Route);
+    CXPLAT_DBG_ASSERT(Config->MaxPacketSize + HeaderBackfill.AllLayer <= rte_pktmbuf_tailroom(Mbuf));
+    Packet->Mbuf = Mbuf;
+    Packet->Queue = Queue;
+    Packet->Buffer.Length = Config->MaxPacketSize;
+    Packet->Buffer.Buffer = rte_pktmbuf_mtod(Mbuf, uint8_t*) + HeaderBackfill.AllLayer;
+    Packet->ECN = Config->ECN;
+    Packet->DSCP = Config->DSCP;
+    Packet->PayloadChecksumValid = FALSE;
+    Packet->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_RAW;
+
+    return (CXPLAT_SEND_DATA*)Packet;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxFree(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    rte_pktmbuf_free(((DPDK_TX_PACKET*)SendData)->Mbuf);
+}
+
+//
+// Hands the batched sends to the NIC. Called with the queue's TxLock held.
+//
+static
+uint16_t
+CxPlatDpdkFlushTx(
+    _In_ CXPLAT_QUEUE* Queue
+    )
+{
+    if (Queue->TxCount == 0) {
+        return 0;
+    }
+
+    const uint16_t Sent =
+        rte_eth_tx_burst(Queue->Interface->PortId, Queue->QueueId, Queue->TxBatch, Queue->TxCount);
+    if (Sent < Queue->TxCount) {
+        //
+        // The TX ring is full. Like a full XDP TX ring, the rest are dropped
+        // and left to loss recovery.
+        //
+        Queue->TxRingFullCount++;
+        rte_pktmbuf_free_bulk(&Queue->TxBatch[Sent], Queue->TxCount - Sent);
+    }
+    Queue->TxSubmitted += Sent;
+    Queue->TxCount = 0;
+    return Sent;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxEnqueue(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    DPDK_TX_PACKET* Packet = (DPDK_TX_PACKET*)SendData;
+    CXPLAT_QUEUE* Queue = Packet->Queue;
+    DPDK_PARTITION* Partition = Queue->Partition;
+    struct rte_mbuf* Mbuf = Packet->Mbuf;
+
+    //
+    // The headers were framed in front of the payload, so the frame starts
+    // at Buffer now.
+    //
+    Mbuf->data_off = (uint16_t)(Packet->Buffer.Buffer - (uint8_t*)Mbuf->buf_addr);
+    Mbuf->data_len = (uint16_t)Packet->Buffer.Length;
+    Mbuf->pkt_len = Packet->Buffer.Length;
+
+    CxPlatLockAcquire(&Queue->TxLock);
+    Queue->TxBatch[Queue->TxCount++] = Mbuf;
+    const BOOLEAN Flushed = Queue->TxCount == TX_BATCH_SIZE;
+    if (Flushed) {
+        CxPlatDpdkFlushTx(Queue);
+    }
+    CxPlatLockRelease(&Queue->TxLock);
+
+    if (!Flushed) {
+        Partition->Ec.Ready = TRUE;
+        CxPlatWakeExecutionContext(&Partition->Ec);
+    }
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxSetL3ChecksumOffload(
+    _In_ CXPLAT_SEND_DATA* SendData
+    )
+{
+    struct rte_mbuf* Mbuf = ((DPDK_TX_PACKET*)SendData)->Mbuf;
+    Mbuf->ol_flags |= RTE_MBUF_F_TX_IPV4 | RTE_MBUF_F_TX_IP_CKSUM;
+    Mbuf->l2_len = sizeof(ETHERNET_HEADER);
+    Mbuf->l3_len = sizeof(IPV4_HEADER);
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawTxSetL4ChecksumOffload(
+    _In_ CXPLAT_SEND_DATA* SendData,
+    _In_ BOOLEAN IsIpv6,
+    _In_ BOOLEAN IsTcp,
+    _In_ uint8_t L4HeaderLength
+    )
+{
+    //
+    // The framing already put the pseudo header checksum in the transport
+    // header, as the NIC expects.
+    //
+    struct rte_mbuf* Mbuf = ((DPDK_TX_PACKET*)SendData)->Mbuf;
+    Mbuf->ol_flags |=
+        (IsIpv6 ? RTE_MBUF_F_TX_IPV6 : RTE_MBUF_F_TX_IPV4) |
+        (IsTcp ? RTE_MBUF_F_TX_TCP_CKSUM : RTE_MBUF_F_TX_UDP_CKSUM);
+    Mbuf->l2_len = sizeof(ETHERNET_HEADER);
+    Mbuf->l3_len = IsIpv6 ? sizeof(IPV6_HEADER) : sizeof(IPV4_HEADER);
+    Mbuf->l4_len = L4HeaderLength;
+}
+
+static
+BOOLEAN // Did work?
+CxPlatDpdkRx(
+    _In_ const DPDK_DATAPATH* Dpdk,
+    _In_ CXPLAT_QUEUE* Queue,
+    _In_ uint16_t PartitionIndex
+    )
+{
+    struct rte_mbuf* Mbufs[RX_BATCH_SIZE];
+    const uint16_t Rcvd =
+        rte_eth_rx_burst(Queue->Interface->PortId, Queue->QueueId, Mbufs, RX_BATCH_SIZE);
+
+    CXPLAT_RECV_DATA* Buffers[RX_BATCH_SIZE];
+    uint16_t PacketCount = 0;
+    for (uint16_t i = 0; i < Rcvd; i++) {
+        struct rte_mbuf* Mbuf = Mbufs[i];
+        if (i + 1 < Rcvd) {
+            //
+            // Warm up the next frame's headers while this one is being parsed.
+            //
+            CxPlatPrefetch(rte_pktmbuf_mtod(Mbufs[i + 1], void*));
+        }
+
+        DPDK_RX_PACKET* Packet = (DPDK_RX_PACKET*)rte_mbuf_to_priv(Mbuf);
+        CxPlatZeroMemory(Packet, sizeof(*Packet));
+        Packet->Mbuf = Mbuf;
+        Packet->RouteStorage.Queue = Queue;
+        Packet->RecvData.Route = &Packet->RouteStorage;
+        Packet->RecvData.Route->DatapathType = Packet->RecvData.DatapathType = CXPLAT_DATAPATH_TYPE_RAW;
+        Packet->RecvData.PartitionIndex = PartitionIndex;
+
+        CxPlatDpRawParseEthernet(
+            (CXPLAT_DATAPATH*)Dpdk,
+            &Packet->RecvData,
+            rte_pktmbuf_mtod(Mbuf, uint8_t*),
+            (uint16_t)rte_pktmbuf_data_len(Mbuf));
+
+        //
+        // The route has been filled in with the packet's src/dst IP and ETH addresses, so
+        // mark it resolved. This allows stateless sends to be issued without performing
+        // a route lookup.
+        //
+        Packet->RecvData.Route->State = RouteResolved;
+
+        if (Packet->RecvData.Buffer) {
+            Packet->RecvData.Allocated = TRUE;
+            Buffers[PacketCount++] = &Packet->RecvData;
+        } else {
+            rte_pktmbuf_free(Mbuf);
+        }
+    }
+
+    if (PacketCount) {
+        CxPlatDpRawRxEthernet((CXPLAT_DATAPATH_RAW*)Dpdk, Buffers, PacketCount);
+    }
+    return Rcvd > 0;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+CxPlatDpdkExecute(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    )
+{
+    DPDK_PARTITION* Partition = (DPDK_PARTITION*)Context;
+    const DPDK_DATAPATH* Dpdk = Partition->Dpdk;
+
+    if (!Dpdk->Running) {
+        CxPlatEventQEnqueue(Partition->EventQ, &Partition->ShutdownSqe);
+        return FALSE;
+    }
+
+    if (!Partition->LcoreRegistered) {
+        //
+        // Give the worker thread an lcore ID, so its mbuf allocations and frees
+        // go through the pool's per-lcore cache. Without one (out of lcores)
+        // they still work, just uncached.
+        //
+        rte_thread_register();
+        Partition->LcoreRegistered = TRUE;
+    }
+
+    BOOLEAN DidWork = FALSE;
+    CXPLAT_QUEUE* Queue = Partition->Queues;
+    while (Queue) {
+        DidWork |= CxPlatDpdkRx(Dpdk, Queue, Partition->PartitionIndex);
+        CxPlatLockAcquire(&Queue->TxLock);
+        DidWork |= CxPlatDpdkFlushTx(Queue) > 0;
+        CxPlatLockRelease(&Queue->TxLock);
+        Queue = Queue->Next;
+    }
+
+    if (DidWork) {
+        State->NoWorkCount = 0;
+    }
+
+    //
+    // Poll mode: there's no notification for received packets.
+    //
+    Partition->Ec.Ready = TRUE;
+    return TRUE;
+}
+
+void
+CxPlatPartitionShutdownEventComplete(
+    _In_ CXPLAT_CQE* Cqe
+    )
+{
+    DPDK_PARTITION* Partition =
+        CXPLAT_CONTAINING_RECORD(CxPlatCqeGetSqe(Cqe), DPDK_PARTITION, ShutdownSqe);
+    CxPlatDpRawRelease((DPDK_DATAPATH*)Partition->Dpdk);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDataPathRssConfigGet(
+    _In_ uint32_t InterfaceIndex,
+    _Outptr_ _At_(*RssConfig, __drv_allocatesMem(Mem))
+        CXPLAT_RSS_CONFIG** RssConfig
+    )
+{
+    UNREFERENCED_PARAMETER(InterfaceIndex);
+    UNREFERENCED_PARAMETER(RssConfig);
+    return QUIC_STATUS_NOT_SUPPORTED;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathRssConfigFree(
+    _In_ CXPLAT_RSS_CONFIG* RssConfig
+    )
+{
+    UNREFERENCED_PARAMETER(RssConfig);
+    CXPLAT_FRE_ASSERTMSG(FALSE, "CxPlatDataPathRssConfigFree not supported");
+}
@@ -34,8 +34,28 @@ CxPlatDataPathRouteWorkerUninitialize(
         CxPlatThreadDelete(&Worker->Thread);
     }
 
+    //
+    // Fail any resolutions the thread didn't get to.
+    //
+    while (!CxPlatListIsEmpty(&Worker->Operations)) {
+        CXPLAT_ROUTE_RESOLUTION_OPERATION* Operation =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&Worker->Operations),
+                CXPLAT_ROUTE_RESOLUTION_OPERATION,
+                WorkerLink);
+        if (Operation->Callback != NULL) {
+            Operation->Callback(Operation->Context, NULL, Operation->PathId, FALSE);
+        }
+        CxPlatPoolFree(Operation);
+    }
+
+    if (Worker->NotificationSocket >= 0) {
+        close(Worker->NotificationSocket);
+    }
+
     CxPlatEventUninitialize(Worker->Ready);
     CxPlatDispatchLockUninitialize(&Worker->Lock);
+    CxPlatDispatchLockUninitialize(&Worker->CacheLock);
     CxPlatPoolUninitialize(&Worker->OperationPool);
     CXPLAT_FREE(Worker, QUIC_POOL_ROUTE_RESOLUTION_WORKER);
 }
@@ -55,11 +75,32 @@ CxPlatDataPathRouteWorkerInitialize(
         goto Error;
     }
 
+    CxPlatZeroMemory(Worker, sizeof(*Worker));
     Worker->Enabled = TRUE;
     CxPlatEventInitialize(&Worker->Ready, FALSE, FALSE);
     CxPlatDispatchLockInitialize(&Worker->Lock);
+    CxPlatDispatchLockInitialize(&Worker->CacheLock);
     CxPlatListInitializeHead(&Worker->Operations);
 
+    //
+    // Subscribe to route and neighbor changes, to know when cached routes are
+    // stale. The cache still works (with periodic refreshes) without it.
+    //
+    Worker->NotificationSocket =
+        socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (Worker->NotificationSocket >= 0) {
+        struct sockaddr_nl NotificationAddress = {0};
+        NotificationAddress.nl_family = AF_NETLINK;
+        NotificationAddress.nl_groups = RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE | RTMGRP_NEIGH;
+        if (bind(
+                Worker->NotificationSocket,
+                (struct sockaddr*)&NotificationAddress,
+                sizeof(NotificationAddress)) < 0) {
+            close(Worker->NotificationSocket);
+            Worker->NotificationSocket = -1;
+        }
+    }
+
     CxPlatPoolInitialize(
         FALSE,
         sizeof(CXPLAT_ROUTE_RESOLUTION_OPERATION),
@@ -101,6 +142,7 @@ RawSocketCreateUdp(
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
 
     CxPlatRundownInitialize(&NewSocket->RawRundown);
+    CxPlatRwLockInitialize(&NewSocket->QeoLock);
     NewSocket->RawDatapath = Raw;
     NewSocket->CibirIdLength = Config->CibirIdLength;
     NewSocket->CibirIdOffsetSrc = Config->CibirIdOffsetSrc;
@@ -158,6 +200,7 @@ Error:
     if (QUIC_FAILED(Status)) {
         if (NewSocket != NULL) {
             CxPlatRundownUninitialize(&NewSocket->RawRundown);
+            CxPlatRwLockUninitialize(&NewSocket->QeoLock);
             CxPlatZeroMemory(NewSocket, sizeof(CXPLAT_SOCKET_RAW) - sizeof(CXPLAT_SOCKET));
             NewSocket = NULL;
         }
@@ -166,8 +209,150 @@ Error:
     return Status;
 }
 
+//
+// Drains pending route and neighbor change notifications. Returns TRUE if there
+// were any (or some were lost), in which case cached routes may be out of date.
+//
+static
+BOOLEAN
+CxPlatRouteWorkerDrainNotifications(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker
+    )
+{
+    BOOLEAN Changed = FALSE;
+    uint8_t Buffer[8192];
+    for (;;) {
+        ssize_t Length = recv(Worker->NotificationSocket, Buffer, sizeof(Buffer), MSG_DONTWAIT);
+        if (Length > 0) {
+            Changed = TRUE;
+        } else if (Length < 0 && errno == ENOBUFS) {
+            Changed = TRUE; // Overflowed; assume anything changed.
+        } else if (Length < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    return Changed;
+}
+
+static
+void
+CxPlatRouteWorkerMarkStale(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker
+    )
+{
+    CxPlatDispatchLockAcquire(&Worker->CacheLock);
+    for (uint32_t i = 0; i < CXPLAT_ROUTE_CACHE_SIZE; ++i) {
+        Worker->Cache[i].Stale = TRUE;
+    }
+    CxPlatDispatchLockRelease(&Worker->CacheLock);
+}
+
+//
+// Re-resolves a cached route in the background, replacing (or, if it no longer
+// resolves, removing) the cache entry.
+//
+static
+void
+CxPlatRouteWorkerRefresh(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ CXPLAT_ROUTE_RESOLUTION_OPERATION* Operation
+    )
+{
+    CXPLAT_ROUTE_CACHE_ENTRY Entry;
+    CxPlatZeroMemory(&Entry, sizeof(Entry));
+    Entry.RemoteAddress = Operation->RemoteAddress;
+    QuicAddrSetFamily(&Entry.LocalAddress, QuicAddrGetFamily(&Operation->RemoteAddress));
+
+    int oif = -1;
+    if (QUIC_SUCCEEDED(
+            ResolveBestL3Route(
+                &Operation->RemoteAddress, &Entry.LocalAddress, &Entry.NextHop, &oif))) {
+        Entry.Valid = TRUE;
+        Entry.IfIndex = (uint32_t)oif;
+        Entry.ResolvedTimeUs = CxPlatTimeUs64();
+        Entry.HasLocalAddress = !QuicAddrIsWildCard(&Entry.LocalAddress);
+        Entry.NextHopResolved =
+            QUIC_SUCCEEDED(
+                ResolveRemotePhysicalAddress(&Entry.NextHop, Entry.NextHopLinkLayerAddress));
+    }
+
+    CxPlatRouteCacheUpdate(Worker, &Entry);
+}
+
+//
+// Resolves the link layer address of a new route's next hop, caches it and
+// completes the route resolution.
+//
+static
+void
+CxPlatRouteWorkerResolveNextHop(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ CXPLAT_ROUTE_RESOLUTION_OPERATION* Operation
+    )
+{
+    uint8_t NextHopLinkLayerAddress[6];
+    const BOOLEAN Succeeded =
+        QUIC_SUCCEEDED(
+            ResolveRemotePhysicalAddress(&Operation->NextHop, NextHopLinkLayerAddress));
+
+    if (Succeeded) {
+        const uint32_t Index =
+            QuicAddrHash(&Operation->RemoteAddress) & (CXPLAT_ROUTE_CACHE_SIZE - 1);
+        CXPLAT_ROUTE_CACHE_ENTRY* CacheEntry = &Worker->Cache[Index];
+        CxPlatDispatchLockAcquire(&Worker->CacheLock);
+        if (CacheEntry->Valid &&
+            QuicAddrCompareIp(&CacheEntry->RemoteAddress, &Operation->RemoteAddress) &&
+            QuicAddrCompareIp(&CacheEntry->NextHop, &Operation->NextHop)) {
+            CxPlatCopyMemory(
+                CacheEntry->NextHopLinkLayerAddress,
+                NextHopLinkLayerAddress,
+                sizeof(NextHopLinkLayerAddress));
+            CacheEntry->NextHopResolved = TRUE;
+        }
+        CxPlatDispatchLockRelease(&Worker->CacheLock);
+    }
+
+    Operation->Callback(
+        Operation->Context, NextHopLinkLayerAddress, Operation->PathId, Succeeded);
+}
+
 CXPLAT_THREAD_CALLBACK(CxPlatRouteResolutionWorkerThread, Context)
 {
-    UNREFERENCED_PARAMETER(Context);
-    return 0;
+    CXPLAT_ROUTE_RESOLUTION_WORKER* Worker = (CXPLAT_ROUTE_RESOLUTION_WORKER*)Context;
+
+    while (Worker->Enabled) {
+        CxPlatEventWaitWithTimeout(Worker->Ready, CXPLAT_ROUTE_CACHE_NOTIFY_POLL_MS);
+        if (!Worker->Enabled) {
+            break;
+        }
+
+        if (Worker->NotificationSocket >= 0 &&
+            CxPlatRouteWorkerDrainNotifications(Worker)) {
+            CxPlatRouteWorkerMarkStale(Worker);
+        }
+
+        CXPLAT_LIST_ENTRY Operations;
+        CxPlatListInitializeHead(&Operations);
+        CxPlatDispatchLockAcquire(&Worker->Lock);
+        CxPlatListMoveItems(&Worker->Operations, &Operations);
+        CxPlatDispatchLockRelease(&Worker->Lock);
+
+        while (!CxPlatListIsEmpty(&Operations)) {
+            CXPLAT_ROUTE_RESOLUTION_OPERATION* Operation =
+                CXPLAT_CONTAINING_RECORD(
+                    CxPlatListRemoveHead(&Operations),
+                    CXPLAT_ROUTE_RESOLUTION_OPERATION,
+                    WorkerLink);
+            if (Operation->Refresh) {
+                CxPlatRouteWorkerRefresh(Worker, Operation);
+            } else {
+                CxPlatRouteWorkerResolveNextHop(Worker, Operation);
+            }
+            CxPlatPoolFree(Operation);
+        }
+    }
+
+    CXPLAT_THREAD_RETURN(0);
 }
@@ -31,6 +31,9 @@
 #include <netlink/route/link.h>
 #include <netlink/route/neighbour.h>
 
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
 QUIC_STATUS
 ResolveBestL3Route(
     QUIC_ADDR* RemoteAddress,
@@ -39,6 +42,12 @@ ResolveBestL3Route(
     int* oif
     );
 
+QUIC_STATUS
+ResolveRemotePhysicalAddress(
+    QUIC_ADDR* RemoteAddr,
+    uint8_t NextHopLinkLayerAddress[6]
+    );
+
 typedef struct CXPLAT_ROUTE_RESOLUTION_OPERATION {
     //
     // Link in the worker's operation queue.
@@ -46,10 +55,31 @@ typedef struct CXPLAT_ROUTE_RESOLUTION_OPERATION {
     //
     CXPLAT_LIST_ENTRY WorkerLink;
 
-    // TODO: MIB_IPNET_ROW2 IpnetRow;
+    //
+    // The route cache key, and the next hop whose link layer address is
+    // needed.
+    //
+    QUIC_ADDR RemoteAddress;
+    QUIC_ADDR NextHop;
+
+    //
+    // Background refreshes of a cache entry re-resolve the whole route and
+    // have no callback.
+    //
+    BOOLEAN Refresh;
 
     void* Context;
     uint8_t PathId;
     CXPLAT_ROUTE_RESOLUTION_CALLBACK_HANDLER Callback;
 } CXPLAT_ROUTE_RESOLUTION_OPERATION;
 
+//
+// Stores a resolved route in the cache, replacing whatever entry it maps to.
+// An invalid Entry removes any entry for the same remote address.
+//
+void
+CxPlatRouteCacheUpdate(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ const CXPLAT_ROUTE_CACHE_ENTRY* Entry
+    );
+
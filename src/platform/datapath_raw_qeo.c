@@ -0,0 +1,656 @@
+/*++
+
+    Copyright (c) Microsoft Corporation.
+    Licensed under the MIT License.
+
+Abstract:
+
+    QUIC Encryption Offload (QEO) for the raw datapath. Once a connection
+    offloads its 1-RTT keys, the datapath applies the packet protection (AEAD
+    and header protection) for it: right before framing on send, and right
+    after parsing on receive.
+
+    There is no common Linux interface for programming QUIC crypto offloads
+    into a NIC, so the offloads are currently applied in-line, on the sending
+    thread and on the XDP queue's thread. A NIC specific provider only has to
+    take over CxPlatDpRawQeoUpdate for the connections it can offload.
+
+    Only datagrams whose (last) 1-RTT packet matches an offload are touched.
+    Everything else, including received packets that don't decrypt with the
+    offloaded key, is passed through for QUIC to process in software.
+
+--*/
+
+#include "datapath_raw.h"
+#include "quic_var_int.h"
+
+#pragma warning(disable:4100) // unreferenced formal parameter
+
+#define SHORT_HEADER_FORM_BIT       0x80
+#define SHORT_HEADER_KEY_PHASE_BIT  0x04
+#define SHORT_HEADER_PN_LENGTH_MASK 0x03
+#define SHORT_HEADER_HP_MASK        0x1f
+
+//
+// The state for one direction of an offloaded connection.
+//
+typedef struct CXPLAT_QEO_OFFLOAD {
+
+    CXPLAT_HASHTABLE_ENTRY Entry;
+
+    uint8_t Direction;              // CXPLAT_QEO_DIRECTION
+    uint8_t DecryptFailureAction;   // CXPLAT_QEO_DECRYPT_FAILURE_ACTION
+    uint8_t KeyPhase;
+    uint8_t ConnectionIdLength;
+    uint8_t ConnectionId[20];
+
+    //
+    // The remote address for transmit offloads and the local address for
+    // receive offloads.
+    //
+    QUIC_ADDR Address;
+
+    //
+    // Serializes the use of the state below. Several senders, or several XDP
+    // queues, can process packets of the same connection at once, while the
+    // socket's QeoLock is only held shared.
+    //
+    CXPLAT_DISPATCH_LOCK Lock;
+
+    //
+    // The next packet number expected to be sent or received, used to
+    // decompress packet numbers.
+    //
+    uint64_t NextPacketNumber;
+
+    CXPLAT_KEY* PacketKey;
+    CXPLAT_HP_KEY* HeaderKey;
+    uint8_t Iv[CXPLAT_IV_LENGTH];
+
+} CXPLAT_QEO_OFFLOAD;
+
+//
+// Transmit offloads are looked up by remote address, as the length of the
+// peer's CID isn't known from the packet. Receive offloads are looked up by
+// (our) CID, which has the same length for all connections on the socket.
+//
+QUIC_INLINE
+uint64_t
+CxPlatDpRawQeoSignature(
+    _In_ uint8_t Direction,
+    _In_ const QUIC_ADDR* Address,
+    _In_reads_(ConnectionIdLength)
+        const uint8_t* ConnectionId,
+    _In_ uint8_t ConnectionIdLength
+    )
+{
+    return
+        Direction == CXPLAT_QEO_DIRECTION_TRANSMIT ?
+            QuicAddrHash(Address) :
+            CxPlatHashSimple(ConnectionIdLength, ConnectionId);
+}
+
+static
+CXPLAT_QEO_OFFLOAD*
+CxPlatDpRawQeoLookup(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_ uint8_t Direction,
+    _In_ const QUIC_ADDR* Address,
+    _In_reads_(ConnectionIdLength)
+        const uint8_t* ConnectionId,
+    _In_ uint8_t ConnectionIdLength
+    )
+{
+    CXPLAT_HASHTABLE_LOOKUP_CONTEXT Context;
+    CXPLAT_HASHTABLE_ENTRY* Entry =
+        CxPlatHashtableLookup(
+            Socket->QeoOffloads,
+            CxPlatDpRawQeoSignature(Direction, Address, ConnectionId, ConnectionIdLength),
+            &Context);
+    while (Entry != NULL) {
+        CXPLAT_QEO_OFFLOAD* Offload =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_QEO_OFFLOAD, Entry);
+        if (Offload->Direction == Direction &&
+            Offload->ConnectionIdLength <= ConnectionIdLength &&
+            memcmp(Offload->ConnectionId, ConnectionId, Offload->ConnectionIdLength) == 0 &&
+            QuicAddrCompare(&Offload->Address, Address)) {
+            return Offload;
+        }
+        Entry = CxPlatHashtableLookupNext(Socket->QeoOffloads, &Context);
+    }
+    return NULL;
+}
+
+static
+void
+CxPlatDpRawQeoFree(
+    _In_ CXPLAT_QEO_OFFLOAD* Offload
+    )
+{
+    CxPlatKeyFree(Offload->PacketKey);
+    CxPlatHpKeyFree(Offload->HeaderKey);
+    CxPlatSecureZeroMemory(Offload->Iv, sizeof(Offload->Iv));
+    CxPlatDispatchLockUninitialize(&Offload->Lock);
+    CXPLAT_FREE(Offload, QUIC_POOL_QEO_OFFLOAD);
+}
+
+static
+QUIC_STATUS
+CxPlatDpRawQeoCreate(
+    _In_ const CXPLAT_QEO_CONNECTION* Connection,
+    _Out_ CXPLAT_QEO_OFFLOAD** NewOffload
+    )
+{
+    CXPLAT_AEAD_TYPE AeadType;
+    switch (Connection->CipherType) {
+    case CXPLAT_QEO_CIPHER_TYPE_AEAD_AES_128_GCM:
+        AeadType = CXPLAT_AEAD_AES_128_GCM;
+        break;
+    case CXPLAT_QEO_CIPHER_TYPE_AEAD_AES_256_GCM:
+        AeadType = CXPLAT_AEAD_AES_256_GCM;
+        break;
+    case CXPLAT_QEO_CIPHER_TYPE_AEAD_CHACHA20_POLY1305:
+        AeadType = CXPLAT_AEAD_CHACHA20_POLY1305;
+        break;
+    default:
+        return QUIC_STATUS_NOT_SUPPORTED;
+    }
+
+    if (Connection->ConnectionIdLength > sizeof(Connection->ConnectionId)) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    CXPLAT_QEO_OFFLOAD* Offload =
+        CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_QEO_OFFLOAD), QUIC_POOL_QEO_OFFLOAD);
+    if (Offload == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+    CxPlatZeroMemory(Offload, sizeof(*Offload));
+    CxPlatDispatchLockInitialize(&Offload->Lock);
+
+    Offload->Direction = (uint8_t)Connection->Direction;
+    Offload->DecryptFailureAction = (uint8_t)Connection->DecryptFailureAction;
+    Offload->KeyPhase = (uint8_t)Connection->KeyPhase;
+    Offload->ConnectionIdLength = Connection->ConnectionIdLength;
+    CxPlatCopyMemory(Offload->ConnectionId, Connection->ConnectionId, Connection->ConnectionIdLength);
+    Offload->Address = Connection->Address;
+    Offload->NextPacketNumber =
+        Connection->Direction == CXPLAT_QEO_DIRECTION_TRANSMIT ?
+            Connection->NextPacketNumber : Connection->NextPacketNumber + 1;
+    CxPlatCopyMemory(Offload->Iv, Connection->PayloadIv, CXPLAT_IV_LENGTH);
+
+    QUIC_STATUS Status =
+        CxPlatKeyCreate(AeadType, Connection->PayloadKey, &Offload->PacketKey);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    Status = CxPlatHpKeyCreate(AeadType, Connection->HeaderKey, &Offload->HeaderKey);
+    if (QUIC_FAILED(Status)) {
+        goto Error;
+    }
+
+    *NewOffload = Offload;
+    return QUIC_STATUS_SUCCESS;
+
+Error:
+
+    CxPlatDpRawQeoFree(Offload);
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawQeoUpdate(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_reads_(OffloadCount)
+        const CXPLAT_QEO_CONNECTION* Offloads,
+    _In_ uint32_t OffloadCount
+    )
+{
+    QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    CXPLAT_QEO_OFFLOAD* NewOffloads[2] = { NULL, NULL };
+
+    if (OffloadCount > ARRAYSIZE(NewOffloads)) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    //
+    // Create all the new key state up front, so the update either fully
+    // succeeds or doesn't change anything.
+    //
+    for (uint32_t i = 0; i < OffloadCount; ++i) {
+        if (Offloads[i].Operation != CXPLAT_QEO_OPERATION_ADD) {
+            continue;
+        }
+        if (Offloads[i].Direction == CXPLAT_QEO_DIRECTION_RECEIVE &&
+            Socket->QeoRxCidLength != 0 &&
+            Socket->QeoRxCidLength != Offloads[i].ConnectionIdLength) {
+            Status = QUIC_STATUS_NOT_SUPPORTED;
+            goto Exit;
+        }
+        Status = CxPlatDpRawQeoCreate(&Offloads[i], &NewOffloads[i]);
+        if (QUIC_FAILED(Status)) {
+            goto Exit;
+        }
+    }
+
+    CxPlatRwLockAcquireExclusive(&Socket->QeoLock);
+
+    if (Socket->QeoOffloads == NULL &&
+        !CxPlatHashtableInitialize(&Socket->QeoOffloads, CXPLAT_HASH_MIN_SIZE)) {
+        CxPlatRwLockReleaseExclusive(&Socket->QeoLock);
+        Status = QUIC_STATUS_OUT_OF_MEMORY;
+        goto Exit;
+    }
+
+    for (uint32_t i = 0; i < OffloadCount; ++i) {
+        //
+        // Adds replace any existing offload for the same connection.
+        //
+        CXPLAT_QEO_OFFLOAD* OldOffload =
+            CxPlatDpRawQeoLookup(
+                Socket,
+                (uint8_t)Offloads[i].Direction,
+                &Offloads[i].Address,
+                Offloads[i].ConnectionId,
+                Offloads[i].ConnectionIdLength);
+        if (OldOffload != NULL) {
+            CxPlatHashtableRemove(Socket->QeoOffloads, &OldOffload->Entry, NULL);
+            CxPlatDpRawQeoFree(OldOffload);
+        }
+
+        if (NewOffloads[i] != NULL) {
+            if (NewOffloads[i]->Direction == CXPLAT_QEO_DIRECTION_RECEIVE) {
+                Socket->QeoRxCidLength = NewOffloads[i]->ConnectionIdLength;
+            }
+            CxPlatHashtableInsert(
+                Socket->QeoOffloads,
+                &NewOffloads[i]->Entry,
+                CxPlatDpRawQeoSignature(
+                    NewOffloads[i]->Direction,
+                    &NewOffloads[i]->Address,
+                    NewOffloads[i]->ConnectionId,
+                    NewOffloads[i]->ConnectionIdLength),
+                NULL);
+            NewOffloads[i] = NULL;
+        }
+    }
+
+    CxPlatRwLockReleaseExclusive(&Socket->QeoLock);
+
+Exit:
+
+    for (uint32_t i = 0; i < ARRAYSIZE(NewOffloads); ++i) {
+        if (NewOffloads[i] != NULL) {
+            CxPlatDpRawQeoFree(NewOffloads[i]);
+        }
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDpRawQeoCleanup(
+    _In_ CXPLAT_SOCKET_RAW* Socket
+    )
+{
+    if (Socket->QeoOffloads != NULL) {
+        //
+        // Any offloads left belong to connections that didn't remove them
+        // before the socket was deleted.
+        //
+        CXPLAT_HASHTABLE_ENTRY* Entry;
+        do {
+            CXPLAT_HASHTABLE_ENUMERATOR Enumerator;
+            CxPlatHashtableEnumerateBegin(Socket->QeoOffloads, &Enumerator);
+            Entry = CxPlatHashtableEnumerateNext(Socket->QeoOffloads, &Enumerator);
+            CxPlatHashtableEnumerateEnd(Socket->QeoOffloads, &Enumerator);
+            if (Entry != NULL) {
+                CxPlatHashtableRemove(Socket->QeoOffloads, Entry, NULL);
+                CxPlatDpRawQeoFree(CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_QEO_OFFLOAD, Entry));
+            }
+        } while (Entry != NULL);
+        CxPlatHashtableUninitialize(Socket->QeoOffloads);
+        Socket->QeoOffloads = NULL;
+    }
+    CxPlatRwLockUninitialize(&Socket->QeoLock);
+}
+
+//
+// Decompresses a packet number relative to the next expected one (RFC 9000,
+// Appendix A.3).
+//
+QUIC_INLINE
+uint64_t
+CxPlatDpRawQeoPktNumDecompress(
+    _In_ uint64_t ExpectedPacketNumber,
+    _In_ uint64_t CompressedPacketNumber,
+    _In_ uint8_t CompressedPacketNumberBytes
+    )
+{
+    const uint64_t Window = 1ULL << (8 * CompressedPacketNumberBytes);
+    const uint64_t HalfWindow = Window / 2;
+    const uint64_t Candidate =
+        (ExpectedPacketNumber & ~(Window - 1)) | CompressedPacketNumber;
+    if (Candidate + HalfWindow <= ExpectedPacketNumber &&
+        Candidate < (1ULL << 62) - Window) {
+        return Candidate + Window;
+    }
+    if (Candidate > ExpectedPacketNumber + HalfWindow && Candidate >= Window) {
+        return Candidate - Window;
+    }
+    return Candidate;
+}
+
+//
+// Returns the offset of the first short header packet in the datagram, or
+// Length if there isn't one. Long header packets are skipped using their
+// (unprotected) Length field.
+//
+static
+uint16_t
+CxPlatDpRawQeoFindShortHeader(
+    _In_reads_(Length)
+        const uint8_t* Datagram,
+    _In_ uint16_t Length
+    )
+{
+    uint16_t Offset = 0;
+    while (Offset < Length && (Datagram[Offset] & SHORT_HEADER_FORM_BIT)) {
+        if (Length - Offset < 7) {
+            return Length;
+        }
+        uint32_t Version;
+        CxPlatCopyMemory(&Version, Datagram + Offset + 1, sizeof(Version));
+        const uint8_t Type = (Datagram[Offset] >> 4) & 0x3;
+        const BOOLEAN IsInitial =
+            Version == QUIC_VERSION_2 ? Type == 1 : Type == 0;
+
+        Offset += 5;
+        Offset += 1 + Datagram[Offset]; // DestCid
+        if (Offset >= Length) {
+            return Length;
+        }
+        Offset += 1 + Datagram[Offset]; // SourceCid
+
+        QUIC_VAR_INT Value;
+        if (IsInitial) {
+            if (!QuicVarIntDecode(Length, Datagram, &Offset, &Value) ||
+                Value > (uint64_t)(Length - Offset)) {
+                return Length;
+            }
+            Offset += (uint16_t)Value; // Token
+        }
+        if (!QuicVarIntDecode(Length, Datagram, &Offset, &Value) ||
+            Value > (uint64_t)(Length - Offset)) {
+            return Length;
+        }
+        Offset += (uint16_t)Value; // Packet number and payload
+    }
+    return Offset;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+BOOLEAN
+CxPlatDpRawQeoTx(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _In_ const CXPLAT_ROUTE* Route,
+    _Inout_ CXPLAT_SEND_DATA* SendData,
+    _In_ BOOLEAN ComputeChecksum
+    )
+{
+    if (Socket->QeoOffloads == NULL) {
+        return TRUE;
+    }
+
+    uint8_t* Datagram = SendData->Buffer.Buffer;
+    const uint16_t Length = (uint16_t)SendData->Buffer.Length;
+    const uint16_t Offset = CxPlatDpRawQeoFindShortHeader(Datagram, Length);
+    if (Offset >= Length) {
+        return TRUE;
+    }
+
+    uint8_t* Header = Datagram + Offset;
+    const uint16_t PacketLength = Length - Offset;
+    BOOLEAN Result = TRUE;
+
+    CxPlatRwLockAcquireShared(&Socket->QeoLock);
+
+    CXPLAT_QEO_OFFLOAD* Offload =
+        CxPlatDpRawQeoLookup(
+            Socket,
+            CXPLAT_QEO_DIRECTION_TRANSMIT,
+            &Route->RemoteAddress,
+            Header + 1,
+            (uint8_t)CXPLAT_MIN(PacketLength - 1u, sizeof(Offload->ConnectionId)));
+    if (Offload == NULL) {
+        goto Exit;
+    }
+
+    //
+    // The packet was left unprotected by QUIC: the header (and packet number)
+    // is in the clear and no space was used for the tag yet. From here on,
+    // the datagram must never be sent if it can't be protected.
+    //
+    Result = FALSE;
+    const uint8_t PnLength = (Header[0] & SHORT_HEADER_PN_LENGTH_MASK) + 1;
+    const uint16_t HeaderLength = 1 + Offload->ConnectionIdLength + PnLength;
+    if (PacketLength < HeaderLength ||
+        PacketLength + CXPLAT_ENCRYPTION_OVERHEAD < 1 + Offload->ConnectionIdLength + 4 + CXPLAT_HP_SAMPLE_LENGTH) {
+        goto Exit;
+    }
+
+    CxPlatDispatchLockAcquire(&Offload->Lock);
+
+    uint8_t* PnStart = Header + 1 + Offload->ConnectionIdLength;
+    uint64_t CompressedPacketNumber = 0;
+    for (uint8_t i = 0; i < PnLength; ++i) {
+        CompressedPacketNumber = (CompressedPacketNumber << 8) | PnStart[i];
+    }
+    const uint64_t PacketNumber =
+        CxPlatDpRawQeoPktNumDecompress(
+            Offload->NextPacketNumber, CompressedPacketNumber, PnLength);
+    if (PacketNumber >= Offload->NextPacketNumber) {
+        Offload->NextPacketNumber = PacketNumber + 1;
+    }
+
+    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+    QuicCryptoCombineIvAndPacketNumber(Offload->Iv, (uint8_t*)&PacketNumber, Iv);
+
+    const uint16_t PayloadLength = PacketLength - HeaderLength + CXPLAT_ENCRYPTION_OVERHEAD;
+    if (QUIC_FAILED(
+        CxPlatEncrypt(
+            Offload->PacketKey,
+            Iv,
+            HeaderLength,
+            Header,
+            PayloadLength,
+            Header + HeaderLength))) {
+        CxPlatDispatchLockRelease(&Offload->Lock);
+        goto Exit;
+    }
+    SendData->Buffer.Length += CXPLAT_ENCRYPTION_OVERHEAD;
+
+    uint8_t HpMask[CXPLAT_HP_SAMPLE_LENGTH];
+    const QUIC_STATUS HpStatus =
+        CxPlatHpComputeMask(
+            Offload->HeaderKey,
+            1,
+            PnStart + 4,
+            HpMask);
+    CxPlatDispatchLockRelease(&Offload->Lock);
+    if (QUIC_FAILED(HpStatus)) {
+        goto Exit;
+    }
+    Header[0] ^= HpMask[0] & SHORT_HEADER_HP_MASK;
+    for (uint8_t i = 0; i < PnLength; ++i) {
+        PnStart[i] ^= HpMask[1 + i];
+    }
+
+    if (ComputeChecksum) {
+        //
+        // Sum up the datagram now, instead of reading all of it back from
+        // memory again when the headers are framed.
+        //
+        SendData->PayloadChecksum =
+            CxPlatFramingChecksum(Datagram, SendData->Buffer.Length, 0);
+        SendData->PayloadChecksumValid = TRUE;
+    }
+    Result = TRUE;
+
+Exit:
+
+    CxPlatRwLockReleaseShared(&Socket->QeoLock);
+
+    return Result;
+}
+
+//
+// Removes the packet protection from a received datagram, if it's a (single)
+// 1-RTT packet of an offloaded connection. Returns FALSE if the datagram
+// failed to decrypt and must be dropped.
+//
+static
+BOOLEAN
+CxPlatDpRawQeoRxPacket(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _Inout_ CXPLAT_RECV_DATA* Packet
+    )
+{
+    uint8_t* Header = Packet->Buffer;
+    const uint16_t Length = Packet->BufferLength;
+    const uint8_t CidLength = Socket->QeoRxCidLength;
+    if (Length == 0 || (Header[0] & SHORT_HEADER_FORM_BIT) ||
+        Length < 1 + CidLength + 4 + CXPLAT_HP_SAMPLE_LENGTH) {
+        return TRUE;
+    }
+
+    CXPLAT_QEO_OFFLOAD* Offload =
+        CxPlatDpRawQeoLookup(
+            Socket,
+            CXPLAT_QEO_DIRECTION_RECEIVE,
+            &Packet->Route->LocalAddress,
+            Header + 1,
+            CidLength);
+    if (Offload == NULL) {
+        return TRUE;
+    }
+
+    //
+    // Decryption is in place, so unless failures are dropped, the protected
+    // packet is saved to hand it to QUIC intact if it doesn't decrypt. Larger
+    // packets are left to QUIC.
+    //
+    const BOOLEAN DropOnFailure =
+        Offload->DecryptFailureAction == CXPLAT_QEO_DECRYPT_FAILURE_ACTION_DROP;
+    uint8_t ProtectedPacket[CXPLAT_MAX_MTU];
+    if (!DropOnFailure && Length > sizeof(ProtectedPacket)) {
+        return TRUE;
+    }
+
+    BOOLEAN Result = TRUE;
+    CxPlatDispatchLockAcquire(&Offload->Lock);
+
+    uint8_t* PnStart = Header + 1 + CidLength;
+    uint8_t HpMask[CXPLAT_HP_SAMPLE_LENGTH];
+    if (QUIC_FAILED(
+        CxPlatHpComputeMask(
+            Offload->HeaderKey,
+            1,
+            PnStart + 4,
+            HpMask))) {
+        goto Exit;
+    }
+
+    const uint8_t FirstByte = Header[0] ^ (HpMask[0] & SHORT_HEADER_HP_MASK);
+    if (!!(FirstByte & SHORT_HEADER_KEY_PHASE_BIT) != Offload->KeyPhase) {
+        //
+        // The peer changed keys; QUIC takes it from here.
+        //
+        goto Exit;
+    }
+
+    const uint8_t PnLength = (FirstByte & SHORT_HEADER_PN_LENGTH_MASK) + 1;
+    const uint16_t HeaderLength = 1 + CidLength + PnLength;
+    if (Length < HeaderLength + CXPLAT_ENCRYPTION_OVERHEAD) {
+        goto Exit;
+    }
+
+    if (!DropOnFailure) {
+        CxPlatCopyMemory(ProtectedPacket, Header, Length);
+    }
+
+    Header[0] = FirstByte;
+    uint64_t CompressedPacketNumber = 0;
+    for (uint8_t i = 0; i < PnLength; ++i) {
+        PnStart[i] ^= HpMask[1 + i];
+        CompressedPacketNumber = (CompressedPacketNumber << 8) | PnStart[i];
+    }
+    const uint64_t PacketNumber =
+        CxPlatDpRawQeoPktNumDecompress(
+            Offload->NextPacketNumber, CompressedPacketNumber, PnLength);
+
+    uint8_t Iv[CXPLAT_MAX_IV_LENGTH];
+    QuicCryptoCombineIvAndPacketNumber(Offload->Iv, (uint8_t*)&PacketNumber, Iv);
+
+    if (QUIC_FAILED(
+        CxPlatDecrypt(
+            Offload->PacketKey,
+            Iv,
+            HeaderLength,
+            Header,
+            Length - HeaderLength,
+            Header + HeaderLength))) {
+        if (DropOnFailure) {
+            Result = FALSE;
+        } else {
+            //
+            // Hand QUIC the packet as received, so that it can still detect
+            // stateless resets and account for the failure itself.
+            //
+            CxPlatCopyMemory(Header, ProtectedPacket, Length);
+        }
+        goto Exit;
+    }
+
+    if (PacketNumber >= Offload->NextPacketNumber) {
+        Offload->NextPacketNumber = PacketNumber + 1;
+    }
+    Packet->BufferLength -= CXPLAT_ENCRYPTION_OVERHEAD;
+    Packet->Decrypted = TRUE;
+
+Exit:
+
+    CxPlatDispatchLockRelease(&Offload->Lock);
+    return Result;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatDpRawQeoRx(
+    _In_ CXPLAT_SOCKET_RAW* Socket,
+    _Inout_ CXPLAT_RECV_DATA** PacketChain
+    )
+{
+    if (Socket->QeoOffloads == NULL || Socket->QeoRxCidLength == 0) {
+        return;
+    }
+
+    CxPlatRwLockAcquireShared(&Socket->QeoLock);
+
+    CXPLAT_RECV_DATA** Link = PacketChain;
+    while (*Link != NULL) {
+        CXPLAT_RECV_DATA* Packet = *Link;
+        if (CxPlatDpRawQeoRxPacket(Socket, Packet)) {
+            Link = &Packet->Next;
+        } else {
+            *Link = Packet->Next;
+            Packet->Next = NULL;
+            CxPlatDpRawRxFree(Packet);
+        }
+    }
+
+    CxPlatRwLockReleaseShared(&Socket->QeoLock);
+}
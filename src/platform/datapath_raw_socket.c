@@ -11,6 +11,19 @@ Abstract:
 
 #include "datapath_raw.h"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define CXPLAT_FRAMING_CHECKSUM_SSE2 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define CXPLAT_FRAMING_CHECKSUM_NEON 1
+#endif
+
+//
+// The number of bytes summed into the 32-bit vector lanes before they are
+// folded into the 64-bit checksum, so the lanes never overflow.
+//
+#define CXPLAT_FRAMING_CHECKSUM_BLOCK 0x10000
 
 #if defined(CX_PLATFORM_LINUX) || defined(CX_PLATFORM_DARWIN)
 #define CxPlatSocketError() errno
@@ -375,12 +388,61 @@ CxPlatFramingChecksum(
     )
 {
     //
-    // Add up all bytes in 3 steps:
-    // 1. Add the odd byte to the checksum if the length is odd.
-    // 2. If the length is divisible by 2 but not 4, add the last 2 bytes.
-    // 3. Sum up the rest as 32-bit words.
+    // Add up all bytes in 4 steps:
+    // 1. Sum up as many 64-byte blocks as possible as 16-bit words in vector
+    //    registers (where available).
+    // 2. Add the odd byte to the checksum if the remaining length is odd.
+    // 3. If the remaining length is divisible by 2 but not 4, add the last 2
+    //    bytes.
+    // 4. Sum up the rest as 32-bit words.
+    //
+    // Since 64-byte blocks are an even number of bytes, the order of 16-bit
+    // words in the sum stays the same as the scalar loop.
     //
 
+#if defined(CXPLAT_FRAMING_CHECKSUM_SSE2) || defined(CXPLAT_FRAMING_CHECKSUM_NEON)
+    while (Length >= 64) {
+        uint32_t BlockLength = CXPLAT_MIN(Length, CXPLAT_FRAMING_CHECKSUM_BLOCK) & ~63u;
+        const uint8_t* End = Data + BlockLength;
+#if defined(CXPLAT_FRAMING_CHECKSUM_SSE2)
+        const __m128i Zero = _mm_setzero_si128();
+        __m128i Sum0 = Zero;
+        __m128i Sum1 = Zero;
+        for (; Data < End; Data += 64) {
+            __m128i V0 = _mm_loadu_si128((const __m128i*)(Data));
+            __m128i V1 = _mm_loadu_si128((const __m128i*)(Data + 16));
+            __m128i V2 = _mm_loadu_si128((const __m128i*)(Data + 32));
+            __m128i V3 = _mm_loadu_si128((const __m128i*)(Data + 48));
+            Sum0 = _mm_add_epi32(Sum0, _mm_unpacklo_epi16(V0, Zero));
+            Sum1 = _mm_add_epi32(Sum1, _mm_unpackhi_epi16(V0, Zero));
+            Sum0 = _mm_add_epi32(Sum0, _mm_unpacklo_epi16(V1, Zero));
+            Sum1 = _mm_add_epi32(Sum1, _mm_unpackhi_epi16(V1, Zero));
+            Sum0 = _mm_add_epi32(Sum0, _mm_unpacklo_epi16(V2, Zero));
+            Sum1 = _mm_add_epi32(Sum1, _mm_unpackhi_epi16(V2, Zero));
+            Sum0 = _mm_add_epi32(Sum0, _mm_unpacklo_epi16(V3, Zero));
+            Sum1 = _mm_add_epi32(Sum1, _mm_unpackhi_epi16(V3, Zero));
+        }
+        uint32_t Lanes[8];
+        _mm_storeu_si128((__m128i*)Lanes, Sum0);
+        _mm_storeu_si128((__m128i*)(Lanes + 4), Sum1);
+        for (uint32_t j = 0; j < ARRAYSIZE(Lanes); ++j) {
+            InitialChecksum += Lanes[j];
+        }
+#else
+        uint32x4_t Sum0 = vdupq_n_u32(0);
+        uint32x4_t Sum1 = vdupq_n_u32(0);
+        for (; Data < End; Data += 64) {
+            Sum0 = vpadalq_u16(Sum0, vld1q_u16((const uint16_t*)(Data)));
+            Sum1 = vpadalq_u16(Sum1, vld1q_u16((const uint16_t*)(Data + 16)));
+            Sum0 = vpadalq_u16(Sum0, vld1q_u16((const uint16_t*)(Data + 32)));
+            Sum1 = vpadalq_u16(Sum1, vld1q_u16((const uint16_t*)(Data + 48)));
+        }
+        InitialChecksum += vaddlvq_u32(Sum0) + vaddlvq_u32(Sum1);
+#endif
+        Length -= BlockLength;
+    }
+#endif
+
     if ((Length & 1) != 0) {
         --Length;
         InitialChecksum += Data[Length];
@@ -414,6 +476,8 @@ CxPlatFramingTransportChecksum(
     _In_ uint16_t NextHeader,
     _In_reads_(IPPayloadLength) uint8_t* IPPayload,
     _In_ uint32_t IPPayloadLength,
+    _In_ uint32_t SumLength,
+    _In_ uint16_t PrecomputedChecksum,
     _In_ BOOLEAN PseudoHeaderOnly
     )
 {
@@ -425,9 +489,12 @@ CxPlatFramingTransportChecksum(
     if (!PseudoHeaderOnly) {
         //
         // Pseudoheader is always in 32-bit words. So, cross 16-bit boundary adjustment isn't
-        // needed.
+        // needed. The same goes for the precomputed checksum of the bytes after
+        // SumLength, as long as SumLength is even.
         //
-        Checksum = ~CxPlatFramingChecksum(IPPayload, IPPayloadLength, Checksum);
+        CXPLAT_DBG_ASSERT(SumLength == IPPayloadLength || (SumLength & 1) == 0);
+        Checksum += PrecomputedChecksum;
+        Checksum = ~CxPlatFramingChecksum(IPPayload, SumLength, Checksum);
     }
 
     return (uint16_t)Checksum;
@@ -606,6 +673,17 @@ CxPlatFramingWriteHeaders(
         TransportProtocol = IPPROTO_UDP;
     }
 
+    //
+    // The payload may already have been summed up while it was still in
+    // cache (see CxPlatDpRawQeoTx), leaving only the transport header.
+    //
+    uint32_t TransportSumLength = TransportLength + (uint32_t)Buffer->Length;
+    uint16_t PayloadChecksum = 0;
+    if (SendData->PayloadChecksumValid) {
+        TransportSumLength = TransportLength;
+        PayloadChecksum = SendData->PayloadChecksum;
+    }
+
     //
     // Fill IPv4/IPv6 header.
     //
@@ -639,6 +717,7 @@ CxPlatFramingWriteHeaders(
                     sizeof(Route->LocalAddress.Ipv4.sin_addr),
                     IPPROTO_TCP,
                     (uint8_t*)TCP, sizeof(TCP_HEADER) + Buffer->Length,
+                    TransportSumLength, PayloadChecksum,
                     SkipTransportLayerXsum);
         } else {
             *((volatile uint16_t*)(&UDP->Checksum)) = 0;
@@ -648,6 +727,7 @@ CxPlatFramingWriteHeaders(
                     sizeof(Route->LocalAddress.Ipv4.sin_addr),
                     IPPROTO_UDP,
                     (uint8_t*)UDP, sizeof(UDP_HEADER) + Buffer->Length,
+                    TransportSumLength, PayloadChecksum,
                     SkipTransportLayerXsum);
         }
         if (SkipTransportLayerXsum) {
@@ -693,6 +773,7 @@ CxPlatFramingWriteHeaders(
                     sizeof(Route->LocalAddress.Ipv6.sin6_addr),
                     IPPROTO_TCP,
                     (uint8_t*)TCP, sizeof(TCP_HEADER) + Buffer->Length,
+                    TransportSumLength, PayloadChecksum,
                     SkipTransportLayerXsum);
         } else {
             *((volatile uint16_t*)(&UDP->Checksum)) = 0;
@@ -702,6 +783,7 @@ CxPlatFramingWriteHeaders(
                     sizeof(Route->LocalAddress.Ipv6.sin6_addr),
                     IPPROTO_UDP,
                     (uint8_t*)UDP, sizeof(UDP_HEADER) + Buffer->Length,
+                    TransportSumLength, PayloadChecksum,
                     SkipTransportLayerXsum);
             if (!SkipTransportLayerXsum) {
                 UDP->Checksum = UDP->Checksum != 0 ? UDP->Checksum : ~0;
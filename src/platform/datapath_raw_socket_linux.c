@@ -226,6 +226,107 @@ ResolveRemotePhysicalAddress(
     return Status;
 }
 
+static
+CXPLAT_ROUTE_CACHE_ENTRY*
+CxPlatRouteCacheGetEntry(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ const QUIC_ADDR* RemoteAddress // Port must be 0.
+    )
+{
+    return &Worker->Cache[QuicAddrHash(RemoteAddress) & (CXPLAT_ROUTE_CACHE_SIZE - 1)];
+}
+
+void
+CxPlatRouteCacheUpdate(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ const CXPLAT_ROUTE_CACHE_ENTRY* Entry
+    )
+{
+    CXPLAT_ROUTE_CACHE_ENTRY* CacheEntry =
+        CxPlatRouteCacheGetEntry(Worker, &Entry->RemoteAddress);
+    CxPlatDispatchLockAcquire(&Worker->CacheLock);
+    if (Entry->Valid) {
+        *CacheEntry = *Entry;
+    } else if (QuicAddrCompareIp(&CacheEntry->RemoteAddress, &Entry->RemoteAddress)) {
+        CacheEntry->Valid = FALSE;
+    }
+    CxPlatDispatchLockRelease(&Worker->CacheLock);
+}
+
+//
+// Copies out the cached route to RemoteAddress, if there is a usable one.
+// Queues a background refresh when the route is getting old.
+//
+static
+BOOLEAN
+CxPlatRouteCacheLookup(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ const QUIC_ADDR* RemoteAddress, // Port must be 0.
+    _Out_ CXPLAT_ROUTE_CACHE_ENTRY* Entry,
+    _Out_ BOOLEAN* RefreshNeeded
+    )
+{
+    CXPLAT_ROUTE_CACHE_ENTRY* CacheEntry = CxPlatRouteCacheGetEntry(Worker, RemoteAddress);
+    const uint64_t TimeNow = CxPlatTimeUs64();
+    BOOLEAN Found = FALSE;
+    *RefreshNeeded = FALSE;
+
+    CxPlatDispatchLockAcquire(&Worker->CacheLock);
+    if (CacheEntry->Valid &&
+        QuicAddrCompareIp(&CacheEntry->RemoteAddress, RemoteAddress) &&
+        CxPlatTimeDiff64(CacheEntry->ResolvedTimeUs, TimeNow) < CXPLAT_ROUTE_CACHE_EXPIRY_US) {
+        if (!CacheEntry->RefreshQueued &&
+            (CacheEntry->Stale ||
+             CxPlatTimeDiff64(CacheEntry->ResolvedTimeUs, TimeNow) >= CXPLAT_ROUTE_CACHE_REFRESH_US)) {
+            CacheEntry->RefreshQueued = TRUE;
+            *RefreshNeeded = TRUE;
+        }
+        *Entry = *CacheEntry;
+        Found = TRUE;
+    }
+    CxPlatDispatchLockRelease(&Worker->CacheLock);
+
+    return Found;
+}
+
+static
+QUIC_STATUS
+CxPlatRouteWorkerQueue(
+    _In_ CXPLAT_ROUTE_RESOLUTION_WORKER* Worker,
+    _In_ const QUIC_ADDR* RemoteAddress,
+    _In_opt_ const QUIC_ADDR* NextHop,
+    _In_ uint8_t PathId,
+    _In_opt_ void* Context,
+    _In_opt_ CXPLAT_ROUTE_RESOLUTION_CALLBACK_HANDLER Callback
+    )
+{
+    CXPLAT_ROUTE_RESOLUTION_OPERATION* Operation = CxPlatPoolAlloc(&Worker->OperationPool);
+    if (Operation == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    Operation->RemoteAddress = *RemoteAddress;
+    if (NextHop != NULL) {
+        Operation->NextHop = *NextHop;
+    }
+    Operation->Refresh = (Callback == NULL);
+    Operation->Context = Context;
+    Operation->PathId = PathId;
+    Operation->Callback = Callback;
+
+    CxPlatDispatchLockAcquire(&Worker->Lock);
+    CxPlatListInsertTail(&Worker->Operations, &Operation->WorkerLink);
+    CxPlatDispatchLockRelease(&Worker->Lock);
+    CxPlatEventSet(Worker->Ready);
+
+    return QUIC_STATUS_SUCCESS;
+}
+
+//
+// Resolves the route with the cache or, on a miss, from the routing table. The
+// next hop's link layer address is resolved by the route worker if it isn't
+// cached, so sends never wait on the neighbor table.
+//
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 RawResolveRoute(
@@ -236,27 +337,52 @@ RawResolveRoute(
     _In_ CXPLAT_ROUTE_RESOLUTION_CALLBACK_HANDLER Callback
     )
 {
-    UNREFERENCED_PARAMETER(Callback);
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
+    CXPLAT_ROUTE_RESOLUTION_WORKER* Worker = Socket->RawDatapath->RouteResolutionWorker;
 
     CXPLAT_DBG_ASSERT(!QuicAddrIsWildCard(&Route->RemoteAddress));
 
     Route->State = RouteResolving;
 
+    QUIC_ADDR RemoteAddress = Route->RemoteAddress;
+    QuicAddrSetPort(&RemoteAddress, 0);
 
-    QUIC_ADDR NextHop = {0};
-    int oif = -1;
-    // get best next hop
-    Status = ResolveBestL3Route(&Route->RemoteAddress, &Route->LocalAddress, &NextHop, &oif);
-    if (QUIC_FAILED(Status)) {
-        return Status;
+    CXPLAT_ROUTE_CACHE_ENTRY Entry;
+    BOOLEAN RefreshNeeded;
+    if (CxPlatRouteCacheLookup(Worker, &RemoteAddress, &Entry, &RefreshNeeded)) {
+        if (RefreshNeeded &&
+            QUIC_FAILED(CxPlatRouteWorkerQueue(Worker, &RemoteAddress, NULL, 0, NULL, NULL))) {
+            Entry.Valid = FALSE; // Have the next lookup miss instead.
+            CxPlatRouteCacheUpdate(Worker, &Entry);
+        }
+
+    } else {
+        int oif = -1;
+        CxPlatZeroMemory(&Entry, sizeof(Entry));
+        Entry.RemoteAddress = RemoteAddress;
+        QuicAddrSetFamily(&Entry.LocalAddress, QuicAddrGetFamily(&RemoteAddress));
+        Status = ResolveBestL3Route(&RemoteAddress, &Entry.LocalAddress, &Entry.NextHop, &oif);
+        if (QUIC_FAILED(Status)) {
+            return Status;
+        }
+        Entry.Valid = TRUE;
+        Entry.IfIndex = (uint32_t)oif;
+        Entry.ResolvedTimeUs = CxPlatTimeUs64();
+        Entry.HasLocalAddress = !QuicAddrIsWildCard(&Entry.LocalAddress);
+        CxPlatRouteCacheUpdate(Worker, &Entry);
+    }
+
+    if (Entry.HasLocalAddress) {
+        const uint16_t LocalPort = QuicAddrGetPort(&Route->LocalAddress);
+        Route->LocalAddress = Entry.LocalAddress;
+        QuicAddrSetPort(&Route->LocalAddress, LocalPort);
     }
 
     // get local IP and mac
-    CXPLAT_LIST_ENTRY* Entry = Socket->RawDatapath->Interfaces.Flink;
-    for (; Entry != &Socket->RawDatapath->Interfaces; Entry = Entry->Flink) {
-        CXPLAT_INTERFACE* Interface = CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_INTERFACE, Link);
-        if (Interface->IfIndex == (uint32_t)oif) {
+    CXPLAT_LIST_ENTRY* Link = Socket->RawDatapath->Interfaces.Flink;
+    for (; Link != &Socket->RawDatapath->Interfaces; Link = Link->Flink) {
+        CXPLAT_INTERFACE* Interface = CXPLAT_CONTAINING_RECORD(Link, CXPLAT_INTERFACE, Link);
+        if (Interface->IfIndex == Entry.IfIndex) {
             CXPLAT_DBG_ASSERT(sizeof(Interface->PhysicalAddress) == sizeof(Route->LocalLinkLayerAddress));
             CxPlatCopyMemory(&Route->LocalLinkLayerAddress, Interface->PhysicalAddress, sizeof(Route->LocalLinkLayerAddress));
             CxPlatDpRawAssignQueue(Interface, Route);
@@ -264,13 +390,14 @@ RawResolveRoute(
         }
     }
 
-    // get remote mac
-    Status = ResolveRemotePhysicalAddress(&NextHop, Route->NextHopLinkLayerAddress);
-    if (QUIC_FAILED(Status)) {
-        return Status;
+    if (Entry.NextHopResolved) {
+        CxPlatResolveRouteComplete(Context, Route, Entry.NextHopLinkLayerAddress, PathId);
+        return QUIC_STATUS_SUCCESS;
     }
 
-    CxPlatResolveRouteComplete(Context, Route, Route->NextHopLinkLayerAddress, PathId);
-
-    return Status;
+    // get remote mac
+    Status =
+        CxPlatRouteWorkerQueue(
+            Worker, &RemoteAddress, &Entry.NextHop, PathId, Context, Callback);
+    return QUIC_FAILED(Status) ? Status : QUIC_STATUS_PENDING;
 }
@@ -31,24 +31,61 @@ Abstract:
 #define FRAME_SIZE         XSK_UMEM__DEFAULT_FRAME_SIZE // TODO: 2K mode
 #define INVALID_UMEM_FRAME UINT64_MAX
 
+//
+// Default watermarks for reaping TX completions. Completions are left on the
+// completion ring until there are at least TX_COMPLETION_BATCH_SIZE of them,
+// unless more than TX_COMPLETION_HIGH_WATERMARK frames are outstanding or the
+// UMEM runs out of free frames.
+//
+#define TX_COMPLETION_BATCH_SIZE        32
+#define TX_COMPLETION_HIGH_WATERMARK    512
+
+//
+// How many completion ring entries (one cache line) to prefetch ahead.
+//
+#define TX_COMPLETION_PREFETCH          8
+
+//
+// AF_XDP TX metadata lets the kernel (copy mode) or the driver (zero-copy)
+// fill in the transport checksum of a frame, starting from the pseudo-header
+// checksum left in the checksum field.
+//
+#if defined(XDP_UMEM_TX_METADATA_LEN) && defined(XDP_TXMD_FLAGS_CHECKSUM)
+#define CXPLAT_XDP_TX_METADATA 1
+#endif
+
 struct XskSocketInfo {
     struct xsk_ring_cons Rx;
     struct xsk_ring_prod Tx;
+    struct xsk_ring_prod Fq;
+    struct xsk_ring_cons Cq;
     struct XskUmemInfo *UmemInfo;
     struct xsk_socket *Xsk;
-
-    CXPLAT_LOCK UmemLock;
-    uint64_t UmemFrameAddr[NUM_FRAMES];
-    uint32_t UmemFrameFree;
 };
 
 struct XskUmemInfo {
+    //
+    // The fill and completion rings created with the UMEM. They are handed
+    // over to (copied into) the first socket bound to it; sockets sharing the
+    // UMEM afterwards get rings of their own.
+    //
     struct xsk_ring_prod Fq;
     struct xsk_ring_cons Cq;
     struct xsk_umem *Umem;
     void *Buffer;
+    size_t BufferSize;
+    BOOLEAN HugePages;      // Buffer was allocated with CxPlatAllocHugePages.
     uint32_t RxHeadRoom;
     uint32_t TxHeadRoom;
+    uint32_t RingSize;      // The size of the rings of each socket.
+    uint32_t RefCount;      // The number of queues using the UMEM.
+    uint32_t SocketCount;   // The number of sockets bound to the UMEM.
+    BOOLEAN ZeroCopy;       // Sockets sharing the UMEM inherit its mode.
+    BOOLEAN TxMetadata;     // Registered with room for TX metadata.
+
+    CXPLAT_LOCK UmemLock;
+    uint64_t UmemFrameAddr[NUM_FRAMES];
+    uint32_t UmemFrameFree;
 };
 
 // TODO: remove this exception when finalizing members
@@ -63,8 +100,12 @@ typedef struct XDP_DATAPATH { // NOLINT(clang-analyzer-optin.performance.Padding
     uint32_t BufferCount;
 
     uint32_t PollingIdleTimeoutUs;
+    uint32_t TxCompletionBatchSize;
+    uint32_t TxCompletionHighWatermark;
+    BOOLEAN SharedUmem;     // Queues of an interface on the same worker share a UMEM.
     BOOLEAN TxAlwaysPoke;
     BOOLEAN SkipXsum;
+    BOOLEAN ZeroCopyTxChecksum; // Trust zero-copy drivers with TX checksum requests.
     BOOLEAN Running;        // Signal to stop workers.
 
     CXPLAT_RUNDOWN_REF Rundown;
@@ -105,6 +146,27 @@ typedef struct CXPLAT_QUEUE {
     CXPLAT_LOCK CqLock;
 
     struct XskSocketInfo* XskInfo;
+
+    //
+    // The AF_XDP socket is bound in zero-copy mode.
+    //
+    BOOLEAN ZeroCopy;
+
+    //
+    // The socket is set up for busy polling (SO_PREFER_BUSY_POLL), so each
+    // poll of the queue has to drive the NIC with a syscall.
+    //
+    BOOLEAN BusyPoll;
+
+    //
+    // Diagnostic counters. TxSubmitted is updated under TxLock and
+    // TxCompleted under CqLock; the rest are updated without synchronization.
+    //
+    uint32_t TxSubmitted;
+    uint32_t TxCompleted;
+    uint32_t TxCompletionLagMax;
+    uint64_t TxRingFullCount;
+    uint64_t FillRingEmptyCount;
 } CXPLAT_QUEUE;
 
 typedef struct __attribute__((aligned(64))) XDP_RX_PACKET {
@@ -122,9 +184,20 @@ typedef struct __attribute__((aligned(64))) XDP_TX_PACKET {
     uint64_t UmemRelativeAddr;
     CXPLAT_QUEUE* Queue;
     CXPLAT_LIST_ENTRY Link;
+    BOOLEAN L4ChecksumOffload;
+#ifdef CXPLAT_XDP_TX_METADATA
+    struct xsk_tx_metadata TxMetadata; // Read by the kernel right before the frame.
+#endif
     uint8_t FrameBuffer[MAX_ETH_FRAME_SIZE];
 } XDP_TX_PACKET;
 
+#ifdef CXPLAT_XDP_TX_METADATA
+CXPLAT_STATIC_ASSERT(
+    FIELD_OFFSET(XDP_TX_PACKET, TxMetadata) + sizeof(struct xsk_tx_metadata) ==
+        FIELD_OFFSET(XDP_TX_PACKET, FrameBuffer),
+    "TX metadata must immediately precede the frame");
+#endif
+
 CXPLAT_EVENT_COMPLETION CxPlatPartitionShutdownEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatQueueRxIoEventComplete;
 CXPLAT_EVENT_COMPLETION CxPlatQueueTxIoEventComplete;
@@ -194,13 +267,25 @@ CxPlatXdpReadConfig(
     // Default config.
     //
     Xdp->TxAlwaysPoke = FALSE;
+
+    //
+    // Zero-copy drivers without TX metadata support silently ignore checksum
+    // requests, so checksum offload in zero-copy mode is opt-in.
+    //
+    const char* ZeroCopyTxChecksum = getenv("MSQUIC_XDP_ZEROCOPY_TX_CHECKSUM");
+    Xdp->ZeroCopyTxChecksum = ZeroCopyTxChecksum != NULL && atoi(ZeroCopyTxChecksum) != 0;
 }
 
 void UninitializeUmem(struct XskUmemInfo* UmemInfo)
 {
     if (xsk_umem__delete(UmemInfo->Umem) != 0) {
     }
-    free(UmemInfo->Buffer);
+    if (UmemInfo->HugePages) {
+        CxPlatFreeHugePages(UmemInfo->Buffer, UmemInfo->BufferSize);
+    } else {
+        free(UmemInfo->Buffer);
+    }
+    CxPlatLockUninitialize(&UmemInfo->UmemLock);
     free(UmemInfo);
 }
 
@@ -237,10 +322,14 @@ CxPlatDpRawInterfaceUninitialize(
                 }
                 xsk_socket__delete(Queue->XskInfo->Xsk);
             }
-            if (Queue->XskInfo->UmemInfo) {
-                UninitializeUmem(Queue->XskInfo->UmemInfo);
+            //
+            // Sockets are deleted in queue order, so by the time the last
+            // queue using a (shared) UMEM is reached, all its sockets are gone.
+            //
+            struct XskUmemInfo* UmemInfo = Queue->XskInfo->UmemInfo;
+            if (UmemInfo && --UmemInfo->RefCount == 0) {
+                UninitializeUmem(UmemInfo);
             }
-            CxPlatLockUninitialize(&Queue->XskInfo->UmemLock);
             free(Queue->XskInfo);
         }
 
@@ -265,40 +354,101 @@ CxPlatDpRawInterfaceUninitialize(
     }
 }
 
-static QUIC_STATUS InitializeUmem(uint32_t FrameSize, uint32_t NumFrames, uint32_t RxHeadRoom, uint32_t TxHeadRoom, struct XskUmemInfo* UmemInfo)
+static QUIC_STATUS InitializeUmem(uint32_t FrameSize, uint32_t NumFrames, uint32_t RingSize, uint32_t RxHeadRoom, uint32_t TxHeadRoom, BOOLEAN TxMetadata, struct XskUmemInfo* UmemInfo)
 {
-    void *Buffer = NULL;
-    if (posix_memalign(&Buffer, getpagesize(), (size_t)(FrameSize) * NumFrames)) {
-        return QUIC_STATUS_OUT_OF_MEMORY;
+    const size_t BufferSize = (size_t)(FrameSize) * NumFrames;
+    BOOLEAN HugePages = TRUE;
+    void *Buffer = CxPlatAllocHugePages(BufferSize);
+    if (Buffer == NULL) {
+        HugePages = FALSE;
+        if (posix_memalign(&Buffer, getpagesize(), BufferSize)) {
+            return QUIC_STATUS_OUT_OF_MEMORY;
+        }
     }
 
     struct xsk_umem_config UmemConfig = {
-        .fill_size = PROD_NUM_DESCS,
-        .comp_size = CONS_NUM_DESCS,
+        .fill_size = RingSize,
+        .comp_size = RingSize,
         .frame_size = FrameSize, // frame_size is really sensitive to become EINVAL
         .frame_headroom = RxHeadRoom,
         .flags = 0
     };
+#ifdef CXPLAT_XDP_TX_METADATA
+    if (TxMetadata) {
+        UmemConfig.flags |= XDP_UMEM_TX_METADATA_LEN;
+        UmemConfig.tx_metadata_len = sizeof(struct xsk_tx_metadata);
+    }
+#else
+    CXPLAT_DBG_ASSERT(!TxMetadata);
+#endif
 
-    int Ret = xsk_umem__create(&UmemInfo->Umem, Buffer, (uint64_t)(FrameSize) * NumFrames, &UmemInfo->Fq, &UmemInfo->Cq, &UmemConfig);
+    int Ret = xsk_umem__create(&UmemInfo->Umem, Buffer, (uint64_t)BufferSize, &UmemInfo->Fq, &UmemInfo->Cq, &UmemConfig);
     if (Ret) {
         errno = -Ret;
-        free(Buffer);
+        if (HugePages) {
+            CxPlatFreeHugePages(Buffer, BufferSize);
+        } else {
+            free(Buffer);
+        }
         return QUIC_STATUS_INTERNAL_ERROR;
     }
 
     UmemInfo->Buffer = Buffer;
+    UmemInfo->BufferSize = BufferSize;
+    UmemInfo->HugePages = HugePages;
     UmemInfo->RxHeadRoom = RxHeadRoom;
     UmemInfo->TxHeadRoom = TxHeadRoom;
+    UmemInfo->TxMetadata = TxMetadata;
+    UmemInfo->RingSize = RingSize;
+    for (uint32_t i = 0; i < NumFrames; i++) {
+        UmemInfo->UmemFrameAddr[i] = (uint64_t)i * FrameSize;
+    }
+    UmemInfo->UmemFrameFree = NumFrames;
     return QUIC_STATUS_SUCCESS;
 }
 
-static uint64_t XskUmemFreeFrames(struct XskSocketInfo *Xsk)
+//
+// Sizes the rings of the sockets sharing a UMEM so that their fill rings can
+// take at most half of its frames, leaving the rest for sends.
+//
+static uint32_t XskRingSize(uint32_t QueueCount)
+{
+    uint32_t RingSize = PROD_NUM_DESCS;
+    while (RingSize > 64 && RingSize * QueueCount > PROD_NUM_DESCS) {
+        RingSize >>= 1;
+    }
+    return RingSize;
+}
+
+static struct XskUmemInfo* CreateUmem(uint32_t RingSize, uint32_t RxHeadRoom, uint32_t TxHeadRoom)
+{
+    struct XskUmemInfo *UmemInfo = calloc(1, sizeof(struct XskUmemInfo));
+    if (!UmemInfo) {
+        return NULL;
+    }
+    BOOLEAN TxMetadata = FALSE;
+#ifdef CXPLAT_XDP_TX_METADATA
+    //
+    // Kernels older than 6.11 reject the TX metadata length.
+    //
+    TxMetadata =
+        QUIC_SUCCEEDED(InitializeUmem(FRAME_SIZE, NUM_FRAMES, RingSize, RxHeadRoom, TxHeadRoom, TRUE, UmemInfo));
+#endif
+    if (!TxMetadata &&
+        QUIC_FAILED(InitializeUmem(FRAME_SIZE, NUM_FRAMES, RingSize, RxHeadRoom, TxHeadRoom, FALSE, UmemInfo))) {
+        free(UmemInfo);
+        return NULL;
+    }
+    CxPlatLockInitialize(&UmemInfo->UmemLock);
+    return UmemInfo;
+}
+
+static uint64_t XskUmemFreeFrames(struct XskUmemInfo *Xsk)
 {
     return Xsk->UmemFrameFree;
 }
 
-static uint64_t XskUmemFrameAlloc(struct XskSocketInfo *Xsk)
+static uint64_t XskUmemFrameAlloc(struct XskUmemInfo *Xsk)
 {
     uint64_t Frame;
     if (Xsk->UmemFrameFree == 0) {
@@ -309,7 +459,7 @@ static uint64_t XskUmemFrameAlloc(struct XskSocketInfo *Xsk)
     return Frame;
 }
 
-static void XskUmemFrameFree(struct XskSocketInfo *Xsk, uint64_t Frame)
+static void XskUmemFrameFree(struct XskUmemInfo *Xsk, uint64_t Frame)
 {
     assert(Xsk->UmemFrameFree < NUM_FRAMES);
     Xsk->UmemFrameAddr[Xsk->UmemFrameFree++] = Frame;
@@ -323,13 +473,15 @@ AttachXdpProgram(struct xdp_program *Prog, XDP_INTERFACE *Interface, struct xsk_
 
     // WARN: Attaching HW mode (error) affects doing
     //       with DRV/SKB mode. Need report to libxdp team
-    // NOTE: eth0 on azure VM doesn't work with XDP_FLAGS_DRV_MODE
+    // NOTE: eth0 on azure VM doesn't work with XDP_FLAGS_DRV_MODE, in which
+    //       case the attach fails and SKB mode is used instead.
+    // NOTE: Zero-copy AF_XDP sockets need the program in native mode.
     static const struct AttachTypePair {
         enum xdp_attach_mode mode;
         unsigned int xdp_flag;
     } AttachTypePairs[]  = {
         // { XDP_MODE_HW, XDP_FLAGS_HW_MODE },
-        // { XDP_MODE_NATIVE, XDP_FLAGS_DRV_MODE },
+        { XDP_MODE_NATIVE, XDP_FLAGS_DRV_MODE },
         { XDP_MODE_SKB, XDP_FLAGS_SKB_MODE },
     };
     for (uint32_t i = 0; i < ARRAYSIZE(AttachTypePairs); i++) {
@@ -396,6 +548,30 @@ OpenXdpProgram(struct xdp_program **Prog)
     return QUIC_STATUS_SUCCESS;
 }
 
+static int
+CxPlatXskSocketCreate(
+    _Inout_ struct XskSocketInfo* XskInfo,
+    _In_z_ const char* IfName,
+    _In_ uint32_t QueueId,
+    _In_ const struct xsk_socket_config* XskCfg
+    )
+{
+    int RetryCount = 10;
+    int Ret = 0;
+    do {
+        Ret = xsk_socket__create_shared(&XskInfo->Xsk, IfName,
+                    QueueId, XskInfo->UmemInfo->Umem, &XskInfo->Rx,
+                    &XskInfo->Tx, &XskInfo->Fq, &XskInfo->Cq, XskCfg);
+        if (Ret == -EBUSY) {
+            CxPlatSleep(100);
+        }
+    } while (Ret == -EBUSY && RetryCount-- > 0);
+    if (Ret < 0) {
+        XskInfo->Xsk = NULL;
+    }
+    return Ret;
+}
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 CxPlatDpRawInterfaceInitialize(
@@ -408,12 +584,14 @@ CxPlatDpRawInterfaceInitialize(
     libbpf_set_print(NULL);
 
     const uint32_t RxHeadroom = ALIGN_UP(sizeof(XDP_RX_PACKET) + ClientRecvContextLength, 32);
-    const uint32_t TxHeadroom = ALIGN_UP(FIELD_OFFSET(XDP_TX_PACKET, FrameBuffer), 32);
-    // WARN: variable frame size cause unexpected behavior
-    // TODO: 2K mode
-    const uint32_t FrameSize = FRAME_SIZE;
+    //
+    // TX descriptors point exactly at FrameBuffer, so that the TX metadata
+    // preceding it is where the kernel looks for it.
+    //
+    const uint32_t TxHeadroom = FIELD_OFFSET(XDP_TX_PACKET, FrameBuffer);
     QUIC_STATUS Status = QUIC_STATUS_SUCCESS;
     int SocketCreated = 0;
+    struct XskUmemInfo** SharedUmems = NULL;
 
     // TODO: setup offload features
 
@@ -426,8 +604,10 @@ CxPlatDpRawInterfaceInitialize(
     XskCfg->rx_size = CONS_NUM_DESCS;
     XskCfg->tx_size = PROD_NUM_DESCS;
     XskCfg->libbpf_flags = XSK_LIBBPF_FLAGS__INHIBIT_PROG_LOAD;
-    // TODO: check ZEROCOPY feature, change Tx/Rx behavior based on feature
-    //       refer xdp-tools/xdp-loader/xdp-loader features <ifname>
+    //
+    // Copy mode is the baseline. Zero-copy is attempted per queue (see
+    // CxPlatXskSocketCreate) when the program is attached in native mode.
+    //
     XskCfg->bind_flags &= ~XDP_ZEROCOPY;
     XskCfg->bind_flags |= XDP_COPY;
     XskCfg->bind_flags |= XDP_USE_NEED_WAKEUP;
@@ -465,6 +645,14 @@ CxPlatDpRawInterfaceInitialize(
 
     CxPlatZeroMemory(Interface->Queues, Interface->QueueCount * sizeof(*Interface->Queues));
 
+    if (Xdp->SharedUmem) {
+        SharedUmems = calloc(Xdp->PartitionCount, sizeof(*SharedUmems));
+        if (!SharedUmems) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Error;
+        }
+    }
+
     for (uint16_t i = 0; i < Interface->QueueCount; i++) {
         CXPLAT_QUEUE* Queue = &Interface->Queues[i];
 
@@ -476,17 +664,27 @@ CxPlatDpRawInterfaceInitialize(
         CxPlatLockInitialize(&Queue->FqLock);
         CxPlatLockInitialize(&Queue->CqLock);
 
-        // Initialize shared packet_buffer for umem usage
-        struct XskUmemInfo *UmemInfo = calloc(1, sizeof(struct XskUmemInfo));
-        if (!UmemInfo) {
-            Status = QUIC_STATUS_OUT_OF_MEMORY;
-            goto Error;
-        }
-
-        Status = InitializeUmem(FRAME_SIZE, NUM_FRAMES, RxHeadroom, TxHeadroom, UmemInfo);
-        if (QUIC_FAILED(Status)) {
-            free(UmemInfo);
-            goto Error;
+        //
+        // Without sharing, each queue gets a UMEM of its own. With sharing,
+        // the queues of the interface that end up on the same worker (see
+        // below) share one, which keeps the UMEM memory per worker instead of
+        // per queue.
+        //
+        const uint32_t PartitionIndex = i % Xdp->PartitionCount;
+        struct XskUmemInfo *UmemInfo = SharedUmems ? SharedUmems[PartitionIndex] : NULL;
+        if (UmemInfo == NULL) {
+            const uint32_t UmemQueueCount =
+                SharedUmems ?
+                    (Interface->QueueCount - PartitionIndex + Xdp->PartitionCount - 1) / Xdp->PartitionCount :
+                    1;
+            UmemInfo = CreateUmem(XskRingSize(UmemQueueCount), RxHeadroom, TxHeadroom);
+            if (!UmemInfo) {
+                Status = QUIC_STATUS_OUT_OF_MEMORY;
+                goto Error;
+            }
+            if (SharedUmems) {
+                SharedUmems[PartitionIndex] = UmemInfo;
+            }
         }
 
         //
@@ -495,28 +693,69 @@ CxPlatDpRawInterfaceInitialize(
         struct XskSocketInfo *XskInfo = calloc(1, sizeof(*XskInfo));
         if (!XskInfo) {
             Status = QUIC_STATUS_OUT_OF_MEMORY;
-            free(UmemInfo->Buffer);
-            free(UmemInfo);
+            if (UmemInfo->RefCount == 0) {
+                UninitializeUmem(UmemInfo);
+                if (SharedUmems) {
+                    SharedUmems[PartitionIndex] = NULL;
+                }
+            }
             goto Error;
         }
-        CxPlatLockInitialize(&XskInfo->UmemLock);
         Queue->XskInfo = XskInfo;
         XskInfo->UmemInfo = UmemInfo;
+        UmemInfo->RefCount++;
+
+        struct xsk_socket_config QueueCfg = *XskCfg;
+        QueueCfg.rx_size = UmemInfo->RingSize;
+        QueueCfg.tx_size = UmemInfo->RingSize;
 
-        int RetryCount = 10;
         int Ret = 0;
-        do {
-            Ret = xsk_socket__create(&XskInfo->Xsk, Interface->IfName,
-                        i, UmemInfo->Umem, &XskInfo->Rx,
-                        &XskInfo->Tx, XskCfg);
-            if (Ret == -EBUSY) {
-                CxPlatSleep(100);
+        if (UmemInfo->SocketCount > 0) {
+            //
+            // Sockets binding to an already bound UMEM (XDP_SHARED_UMEM)
+            // inherit its mode.
+            //
+            Ret = CxPlatXskSocketCreate(XskInfo, Interface->IfName, i, &QueueCfg);
+        } else {
+            if (Interface->AttachMode == XDP_MODE_NATIVE) {
+                struct xsk_socket_config ZeroCopyCfg = QueueCfg;
+                ZeroCopyCfg.bind_flags &= ~XDP_COPY;
+                ZeroCopyCfg.bind_flags |= XDP_ZEROCOPY;
+                Ret = CxPlatXskSocketCreate(XskInfo, Interface->IfName, i, &ZeroCopyCfg);
+                if (Ret == 0) {
+                    UmemInfo->ZeroCopy = TRUE;
+                } else {
+                    //
+                    // The driver doesn't support zero-copy on this queue. A
+                    // failed bind leaves the UMEM's rings half set up, so
+                    // start over with a fresh UMEM for the copy mode bind.
+                    // Nothing else uses the UMEM yet.
+                    //
+                    CXPLAT_DBG_ASSERT(UmemInfo->RefCount == 1);
+                    const uint32_t RingSize = UmemInfo->RingSize;
+                    UninitializeUmem(UmemInfo);
+                    UmemInfo = CreateUmem(RingSize, RxHeadroom, TxHeadroom);
+                    XskInfo->UmemInfo = UmemInfo;
+                    if (SharedUmems) {
+                        SharedUmems[PartitionIndex] = UmemInfo;
+                    }
+                    if (!UmemInfo) {
+                        Status = QUIC_STATUS_OUT_OF_MEMORY;
+                        goto Error;
+                    }
+                    UmemInfo->RefCount = 1;
+                }
+            }
+            if (!UmemInfo->ZeroCopy) {
+                Ret = CxPlatXskSocketCreate(XskInfo, Interface->IfName, i, &QueueCfg);
             }
-        } while (Ret == -EBUSY && RetryCount-- > 0);
+        }
         if (Ret < 0) {
             Status = QUIC_STATUS_INTERNAL_ERROR;
             goto Error;
         }
+        UmemInfo->SocketCount++;
+        Queue->ZeroCopy = UmemInfo->ZeroCopy;
         CxPlatRundownAcquire(&Xdp->Rundown);
         SocketCreated++;
 
@@ -525,28 +764,42 @@ CxPlatDpRawInterfaceInitialize(
             goto Error;
         }
 
-        for (int i = 0; i < NUM_FRAMES; i++) {
-            XskInfo->UmemFrameAddr[i] = i * FrameSize;
-        }
-        XskInfo->UmemFrameFree = NUM_FRAMES;
-
         // Setup fill queue for Rx
         uint32_t FqIdx = 0;
-        Ret = xsk_ring_prod__reserve(&XskInfo->UmemInfo->Fq, PROD_NUM_DESCS, &FqIdx);
-        if (Ret != PROD_NUM_DESCS) {
-            return QUIC_STATUS_OUT_OF_MEMORY;
+        CxPlatLockAcquire(&UmemInfo->UmemLock);
+        const uint32_t FillCount =
+            (uint32_t)CXPLAT_MIN(UmemInfo->RingSize, XskUmemFreeFrames(UmemInfo));
+        if (xsk_ring_prod__reserve(&XskInfo->Fq, FillCount, &FqIdx) != FillCount) {
+            CxPlatLockRelease(&UmemInfo->UmemLock);
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Error;
         }
-        for (uint32_t i = 0; i < PROD_NUM_DESCS; i ++) {
-            uint64_t Addr = XskUmemFrameAlloc(XskInfo);
-            if (Addr == INVALID_UMEM_FRAME) {
-                break;
-            }
-            *xsk_ring_prod__fill_addr(&XskInfo->UmemInfo->Fq, FqIdx++) = Addr;
+        for (uint32_t j = 0; j < FillCount; j++) {
+            *xsk_ring_prod__fill_addr(&XskInfo->Fq, FqIdx++) = XskUmemFrameAlloc(UmemInfo);
         }
+        CxPlatLockRelease(&UmemInfo->UmemLock);
 
-        xsk_ring_prod__submit(&XskInfo->UmemInfo->Fq, PROD_NUM_DESCS);
+        xsk_ring_prod__submit(&XskInfo->Fq, FillCount);
     }
 
+#ifdef CXPLAT_XDP_TX_METADATA
+    //
+    // Offload the transport checksum only if every queue can take the request.
+    // The IPv4 header checksum has no TX metadata request and stays in
+    // software.
+    //
+    BOOLEAN TxChecksum = TRUE;
+    for (uint16_t i = 0; i < Interface->QueueCount; i++) {
+        const CXPLAT_QUEUE* Queue = &Interface->Queues[i];
+        if (!Queue->XskInfo->UmemInfo->TxMetadata ||
+            (Queue->ZeroCopy && !Xdp->ZeroCopyTxChecksum)) {
+            TxChecksum = FALSE;
+            break;
+        }
+    }
+    Interface->OffloadStatus.Transmit.TransportLayerXsum = TxChecksum;
+#endif
+
     //
     // Add each queue to a worker (round robin).
     //
@@ -555,6 +808,7 @@ CxPlatDpRawInterfaceInitialize(
     }
 
 Error:
+    free(SharedUmems);
     if (QUIC_FAILED(Status)) {
         while (SocketCreated--) {CxPlatRundownRelease(&Xdp->Rundown);}
         CxPlatDpRawInterfaceUninitialize(Interface);
@@ -602,13 +856,24 @@ QUIC_STATUS
 CxPlatDpRawInitialize(
     _Inout_ CXPLAT_DATAPATH_RAW* Datapath,
     _In_ uint32_t ClientRecvContextLength,
-    _In_ CXPLAT_WORKER_POOL* WorkerPool
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig
     )
 {
     XDP_DATAPATH* Xdp = (XDP_DATAPATH*)Datapath;
 
     CxPlatListInitializeHead(&Xdp->Interfaces);
     Xdp->PollingIdleTimeoutUs = 0;
+    Xdp->SharedUmem = InitConfig->EnableXdpSharedUmem;
+    Xdp->TxCompletionBatchSize =
+        InitConfig->XdpTxCompletionBatchSize != 0 ?
+            InitConfig->XdpTxCompletionBatchSize : TX_COMPLETION_BATCH_SIZE;
+    Xdp->TxCompletionHighWatermark =
+        InitConfig->XdpTxCompletionHighWatermark != 0 ?
+            InitConfig->XdpTxCompletionHighWatermark : TX_COMPLETION_HIGH_WATERMARK;
+    if (Xdp->TxCompletionHighWatermark < Xdp->TxCompletionBatchSize) {
+        Xdp->TxCompletionHighWatermark = Xdp->TxCompletionBatchSize;
+    }
     Xdp->PartitionCount = CxPlatWorkerPoolGetCount(WorkerPool);
     for (uint32_t i = 0; i < Xdp->PartitionCount; i++) {
         Xdp->Partitions[i].Processor = (uint16_t)
@@ -799,6 +1064,68 @@ CxPlatDpRawUpdatePollingIdleTimeout(
 {
     XDP_DATAPATH* Xdp = (XDP_DATAPATH*)Datapath;
     Xdp->PollingIdleTimeoutUs = PollingIdleTimeoutUs;
+
+#if defined(SO_PREFER_BUSY_POLL) && defined(SO_BUSY_POLL_BUDGET)
+    //
+    // While the workers poll, have the sockets prefer busy polling, so the
+    // NIC is driven from the worker loop and its interrupts stay deferred
+    // (given napi_defer_hard_irqs and gro_flush_timeout are set up on the
+    // interface).
+    //
+    const int PreferBusyPoll = PollingIdleTimeoutUs != 0;
+    const int BusyPollUs = (int)PollingIdleTimeoutUs;
+    const int BusyPollBudget = RX_BATCH_SIZE;
+    CXPLAT_LIST_ENTRY* Entry = Xdp->Interfaces.Flink;
+    for (; Entry != &Xdp->Interfaces; Entry = Entry->Flink) {
+        XDP_INTERFACE* Interface =
+            (XDP_INTERFACE*)CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_INTERFACE, Link);
+        for (uint16_t i = 0; i < Interface->QueueCount; i++) {
+            CXPLAT_QUEUE* Queue = &Interface->Queues[i];
+            const int Fd = xsk_socket__fd(Queue->XskInfo->Xsk);
+            Queue->BusyPoll =
+                setsockopt(Fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &PreferBusyPoll, sizeof(PreferBusyPoll)) == 0 &&
+                setsockopt(Fd, SOL_SOCKET, SO_BUSY_POLL, &BusyPollUs, sizeof(BusyPollUs)) == 0 &&
+                setsockopt(Fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &BusyPollBudget, sizeof(BusyPollBudget)) == 0 &&
+                PreferBusyPoll;
+        }
+    }
+#endif
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDpRawGetQueueInfo(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    )
+{
+    XDP_DATAPATH* Xdp = (XDP_DATAPATH*)Datapath;
+    const uint32_t Capacity = QueueInfo != NULL ? *QueueCount : 0;
+    uint32_t Count = 0;
+
+    CXPLAT_LIST_ENTRY* Entry = Xdp->Interfaces.Flink;
+    for (; Entry != &Xdp->Interfaces; Entry = Entry->Flink) {
+        XDP_INTERFACE* Interface =
+            (XDP_INTERFACE*)CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_INTERFACE, Link);
+        for (uint16_t i = 0; i < Interface->QueueCount; i++, Count++) {
+            if (Count < Capacity) {
+                QueueInfo[Count].InterfaceIndex = Interface->IfIndex;
+                QueueInfo[Count].QueueId = i;
+                QueueInfo[Count].NativeMode = Interface->AttachMode == XDP_MODE_NATIVE;
+                QueueInfo[Count].ZeroCopy = Interface->Queues[i].ZeroCopy;
+                QueueInfo[Count].TxRingFullCount = Interface->Queues[i].TxRingFullCount;
+                QueueInfo[Count].FillRingEmptyCount = Interface->Queues[i].FillRingEmptyCount;
+                QueueInfo[Count].TxCompletionLag =
+                    Interface->Queues[i].TxSubmitted - Interface->Queues[i].TxCompleted;
+                QueueInfo[Count].TxCompletionLagMax = Interface->Queues[i].TxCompletionLagMax;
+            }
+        }
+    }
+
+    *QueueCount = Count;
+    return Count > Capacity ? QUIC_STATUS_BUFFER_TOO_SMALL : QUIC_STATUS_SUCCESS;
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -810,10 +1137,11 @@ RawSocketUpdateQeo(
     _In_ uint32_t OffloadCount
     )
 {
-    UNREFERENCED_PARAMETER(Socket);
-    UNREFERENCED_PARAMETER(Offloads);
-    UNREFERENCED_PARAMETER(OffloadCount);
-    return QUIC_STATUS_NOT_SUPPORTED;
+    //
+    // NIC offloads can't be programmed through AF_XDP, so they are applied
+    // in-line by the datapath.
+    //
+    return CxPlatDpRawQeoUpdate(Socket, Offloads, OffloadCount);
 }
 
 _IRQL_requires_max_(PASSIVE_LEVEL)
@@ -905,21 +1233,69 @@ CxPlatDpRawRxFree(
             CXPLAT_CONTAINING_RECORD(PacketChain, XDP_RX_PACKET, RecvData);
         XskInfo = Packet->Queue->XskInfo;
 
-        CxPlatLockAcquire(&XskInfo->UmemLock);
+        CxPlatLockAcquire(&XskInfo->UmemInfo->UmemLock);
         while (PacketChain) {
             Packet =
                 CXPLAT_CONTAINING_RECORD(PacketChain, XDP_RX_PACKET, RecvData);
             PacketChain = PacketChain->Next;
-            XskUmemFrameFree(Packet->Queue->XskInfo, Packet->Addr);
+            XskUmemFrameFree(Packet->Queue->XskInfo->UmemInfo, Packet->Addr);
             Count++;
         }
     }
 
     if (Count > 0) {
-        CxPlatLockRelease(&XskInfo->UmemLock);
+        CxPlatLockRelease(&XskInfo->UmemInfo->UmemLock);
     }
 }
 
+//
+// Returns the frames of completed sends to the UMEM. Unless Force is set,
+// completions are only reaped in batches (see TX_COMPLETION_BATCH_SIZE).
+//
+static
+uint32_t
+CxPlatXdpReapTxCompletions(
+    _In_ CXPLAT_QUEUE* Queue,
+    _In_ BOOLEAN Force
+    )
+{
+    const XDP_DATAPATH* Xdp = Queue->Partition->Xdp;
+    struct XskSocketInfo* XskInfo = Queue->XskInfo;
+    uint32_t Completed;
+    uint32_t CqIdx;
+
+    CxPlatLockAcquire(&Queue->CqLock);
+    const uint32_t Lag = Queue->TxSubmitted - Queue->TxCompleted;
+    if (Lag > Queue->TxCompletionLagMax) {
+        Queue->TxCompletionLagMax = Lag;
+    }
+    if (!Force && Lag < Xdp->TxCompletionHighWatermark &&
+        xsk_cons_nb_avail(&XskInfo->Cq, Xdp->TxCompletionBatchSize) < Xdp->TxCompletionBatchSize) {
+        CxPlatLockRelease(&Queue->CqLock);
+        return 0;
+    }
+
+    Completed = xsk_ring_cons__peek(&XskInfo->Cq, CONS_NUM_DESCS, &CqIdx);
+    if (Completed > 0) {
+        const uint64_t TxHeadRoom = XskInfo->UmemInfo->TxHeadRoom;
+        CxPlatLockAcquire(&XskInfo->UmemInfo->UmemLock);
+        for (uint32_t i = 0; i < Completed; i++, CqIdx++) {
+            if ((i % TX_COMPLETION_PREFETCH) == 0 && i + TX_COMPLETION_PREFETCH < Completed) {
+                CxPlatPrefetch(xsk_ring_cons__comp_addr(&XskInfo->Cq, CqIdx + TX_COMPLETION_PREFETCH));
+            }
+            uint64_t addr = *xsk_ring_cons__comp_addr(&XskInfo->Cq, CqIdx) - TxHeadRoom;
+            XskUmemFrameFree(XskInfo->UmemInfo, addr);
+        }
+        CxPlatLockRelease(&XskInfo->UmemInfo->UmemLock);
+
+        xsk_ring_cons__release(&XskInfo->Cq, Completed);
+        Queue->TxCompleted += Completed;
+    }
+    CxPlatLockRelease(&Queue->CqLock);
+
+    return Completed;
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 CXPLAT_SEND_DATA*
 CxPlatDpRawTxAlloc(
@@ -930,11 +1306,22 @@ CxPlatDpRawTxAlloc(
     XDP_TX_PACKET* Packet = NULL;
     CXPLAT_QUEUE* Queue = Config->Route->Queue;
     struct XskSocketInfo* XskInfo = Queue->XskInfo;
-    CxPlatLockAcquire(&XskInfo->UmemLock);
-    uint64_t BaseAddr = XskUmemFrameAlloc(XskInfo);
-    CxPlatLockRelease(&XskInfo->UmemLock);
+    CxPlatLockAcquire(&XskInfo->UmemInfo->UmemLock);
+    uint64_t BaseAddr = XskUmemFrameAlloc(XskInfo->UmemInfo);
+    CxPlatLockRelease(&XskInfo->UmemInfo->UmemLock);
     if (BaseAddr == INVALID_UMEM_FRAME) {
-        goto Error;
+        //
+        // Out of frames. Reap whatever completions are pending and try again.
+        //
+        if (CxPlatXdpReapTxCompletions(Queue, TRUE) == 0) {
+            goto Error;
+        }
+        CxPlatLockAcquire(&XskInfo->UmemInfo->UmemLock);
+        BaseAddr = XskUmemFrameAlloc(XskInfo->UmemInfo);
+        CxPlatLockRelease(&XskInfo->UmemInfo->UmemLock);
+        if (BaseAddr == INVALID_UMEM_FRAME) {
+            goto Error;
+        }
     }
 
     Packet = (XDP_TX_PACKET*)xsk_umem__get_data(XskInfo->UmemInfo->Buffer, BaseAddr);
@@ -946,6 +1333,8 @@ CxPlatDpRawTxAlloc(
         Packet->Buffer.Buffer = &Packet->FrameBuffer[HeaderBackfill.AllLayer];
         Packet->ECN = Config->ECN;
         Packet->DSCP = Config->DSCP;
+        Packet->PayloadChecksumValid = FALSE;
+        Packet->L4ChecksumOffload = FALSE;
         Packet->UmemRelativeAddr = BaseAddr;
         Packet->DatapathType = Config->Route->DatapathType = CXPLAT_DATAPATH_TYPE_RAW;
     }
@@ -983,21 +1372,7 @@ KickTx(
         XdpSocketContextSetEvents(Queue, EPOLL_CTL_MOD, EPOLLIN);
     }
 
-    uint32_t Completed;
-    uint32_t CqIdx;
-    CxPlatLockAcquire(&Queue->CqLock);
-    Completed = xsk_ring_cons__peek(&XskInfo->UmemInfo->Cq, CONS_NUM_DESCS, &CqIdx);
-    if (Completed > 0) {
-        CxPlatLockAcquire(&XskInfo->UmemLock);
-        for (uint32_t i = 0; i < Completed; i++) {
-            uint64_t addr = *xsk_ring_cons__comp_addr(&XskInfo->UmemInfo->Cq, CqIdx++) - XskInfo->UmemInfo->TxHeadRoom;
-            XskUmemFrameFree(XskInfo, addr);
-        }
-        CxPlatLockRelease(&XskInfo->UmemLock);
-
-        xsk_ring_cons__release(&XskInfo->UmemInfo->Cq, Completed);
-    }
-    CxPlatLockRelease(&Queue->CqLock);
+    CxPlatXdpReapTxCompletions(Queue, FALSE);
 }
 
 _IRQL_requires_max_(DISPATCH_LEVEL)
@@ -1014,9 +1389,11 @@ CxPlatDpRawTxEnqueue(
     uint32_t TxIdx = 0;
     CxPlatLockAcquire(&Queue->TxLock);
     if (xsk_ring_prod__reserve(&XskInfo->Tx, 1, &TxIdx) != 1) {
-        CxPlatLockAcquire(&XskInfo->UmemLock);
-        XskUmemFrameFree(XskInfo, Packet->UmemRelativeAddr);
-        CxPlatLockRelease(&XskInfo->UmemLock);
+        Queue->TxRingFullCount++;
+        CxPlatLockRelease(&Queue->TxLock);
+        CxPlatLockAcquire(&XskInfo->UmemInfo->UmemLock);
+        XskUmemFrameFree(XskInfo->UmemInfo, Packet->UmemRelativeAddr);
+        CxPlatLockRelease(&XskInfo->UmemInfo->UmemLock);
         return;
     }
 
@@ -1024,10 +1401,24 @@ CxPlatDpRawTxEnqueue(
     CXPLAT_FRE_ASSERT(tx_desc != NULL);
     tx_desc->addr = Packet->UmemRelativeAddr + XskInfo->UmemInfo->TxHeadRoom;
     tx_desc->len = SendData->Buffer.Length;
+#ifdef CXPLAT_XDP_TX_METADATA
+    tx_desc->options = Packet->L4ChecksumOffload ? XDP_TX_METADATA : 0;
+#else
+    tx_desc->options = 0;
+#endif
     xsk_ring_prod__submit(&XskInfo->Tx, 1);
+    Queue->TxSubmitted++;
+    const BOOLEAN NeedsWakeup = xsk_ring_prod__needs_wakeup(&XskInfo->Tx);
     CxPlatLockRelease(&Queue->TxLock);
 
-    KickTx(Packet->Queue, FALSE);
+    //
+    // Only poke the kernel when it asked for it (always the case in copy
+    // mode). Otherwise the driver picks the descriptor up on its own and the
+    // worker reaps the completion, saving a syscall per frame.
+    //
+    if (NeedsWakeup || Partition->Xdp->TxAlwaysPoke) {
+        KickTx(Packet->Queue, FALSE);
+    }
 
     Partition->Ec.Ready = TRUE;
     CxPlatWakeExecutionContext(&Partition->Ec);
@@ -1051,10 +1442,20 @@ CxPlatDpRawTxSetL4ChecksumOffload(
     _In_ uint8_t L4HeaderLength
     )
 {
+    UNREFERENCED_PARAMETER(L4HeaderLength);
+#ifdef CXPLAT_XDP_TX_METADATA
+    XDP_TX_PACKET* Packet = (XDP_TX_PACKET*)SendData;
+    Packet->TxMetadata.flags = XDP_TXMD_FLAGS_CHECKSUM;
+    Packet->TxMetadata.request.csum_start =
+        sizeof(ETHERNET_HEADER) + (IsIpv6 ? sizeof(IPV6_HEADER) : sizeof(IPV4_HEADER));
+    Packet->TxMetadata.request.csum_offset =
+        IsTcp ? FIELD_OFFSET(TCP_HEADER, Checksum) : FIELD_OFFSET(UDP_HEADER, Checksum);
+    Packet->L4ChecksumOffload = TRUE;
+#else
     UNREFERENCED_PARAMETER(SendData);
     UNREFERENCED_PARAMETER(IsIpv6);
     UNREFERENCED_PARAMETER(IsTcp);
-    UNREFERENCED_PARAMETER(L4HeaderLength);
+#endif
 }
 
 static
@@ -1065,8 +1466,7 @@ CxPlatXdpTx(
     )
 {
     UNREFERENCED_PARAMETER(Xdp);
-    UNREFERENCED_PARAMETER(Queue);
-    return FALSE;
+    return CxPlatXdpReapTxCompletions(Queue, FALSE) > 0;
 }
 
 static
@@ -1132,6 +1532,14 @@ CxPlatXdpRx(
     uint32_t RxIdx = 0, FqIdx = 0;
     unsigned int ret;
 
+    if (Queue->BusyPoll) {
+        //
+        // Busy polling happens in the syscall, which drives the NIC's NAPI
+        // context to fill the RX ring.
+        //
+        recvfrom(xsk_socket__fd(XskInfo->Xsk), NULL, 0, MSG_DONTWAIT, NULL, NULL);
+    }
+
     CxPlatLockAcquire(&Queue->RxLock);
     Rcvd = xsk_ring_cons__peek(&XskInfo->Rx, RX_BATCH_SIZE, &RxIdx);
 
@@ -1142,6 +1550,18 @@ CxPlatXdpRx(
         uint64_t Addr = xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx)->addr;
         uint32_t Len = xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx++)->len;
         uint8_t *FrameBuffer = xsk_umem__get_data(XskInfo->UmemInfo->Buffer, Addr);
+        if (i + 1 < Rcvd) {
+            //
+            // Warm up the next frame's headroom and headers while this one is
+            // being parsed.
+            //
+            uint8_t* NextFrame =
+                xsk_umem__get_data(
+                    XskInfo->UmemInfo->Buffer,
+                    xsk_ring_cons__rx_desc(&XskInfo->Rx, RxIdx)->addr);
+            CxPlatPrefetch(NextFrame - XskInfo->UmemInfo->RxHeadRoom);
+            CxPlatPrefetch(NextFrame);
+        }
         XDP_RX_PACKET* Packet = (XDP_RX_PACKET*)(FrameBuffer - XskInfo->UmemInfo->RxHeadRoom);
         CxPlatZeroMemory(Packet, XskInfo->UmemInfo->RxHeadRoom);
 
@@ -1170,7 +1590,7 @@ CxPlatXdpRx(
             Packet->RecvData.Allocated = TRUE;
             Buffers[PacketCount++] = &Packet->RecvData;
         } else {
-            XskUmemFrameFree(XskInfo, Addr - (XDP_PACKET_HEADROOM + XskInfo->UmemInfo->RxHeadRoom));
+            XskUmemFrameFree(XskInfo->UmemInfo, Addr - (XDP_PACKET_HEADROOM + XskInfo->UmemInfo->RxHeadRoom));
         }
     }
 
@@ -1179,30 +1599,44 @@ CxPlatXdpRx(
     }
     CxPlatLockRelease(&Queue->RxLock);
 
-    CxPlatLockAcquire(&XskInfo->UmemLock);
+    CxPlatLockAcquire(&XskInfo->UmemInfo->UmemLock);
     CxPlatLockAcquire(&Queue->FqLock);
+    if (xsk_prod_nb_free(&XskInfo->Fq, XskInfo->UmemInfo->RingSize) >= XskInfo->UmemInfo->RingSize) {
+        //
+        // The kernel consumed every fill entry, so it may have had nowhere to
+        // put received packets.
+        //
+        Queue->FillRingEmptyCount++;
+    }
     // Stuff the ring with as much frames as possible
-    Available = xsk_prod_nb_free(&XskInfo->UmemInfo->Fq, XskUmemFreeFrames(XskInfo));
+    Available = xsk_prod_nb_free(&XskInfo->Fq, XskUmemFreeFrames(XskInfo->UmemInfo));
     if (Available > 0) {
-        ret = xsk_ring_prod__reserve(&XskInfo->UmemInfo->Fq, Available, &FqIdx);
+        ret = xsk_ring_prod__reserve(&XskInfo->Fq, Available, &FqIdx);
 
         // This should not happen, but just in case
         while (ret != Available) {
-            ret = xsk_ring_prod__reserve(&XskInfo->UmemInfo->Fq, Rcvd, &FqIdx);
+            ret = xsk_ring_prod__reserve(&XskInfo->Fq, Rcvd, &FqIdx);
         }
         for (i = 0; i < Available; i++) {
-            uint64_t addr = XskUmemFrameAlloc(XskInfo);
+            uint64_t addr = XskUmemFrameAlloc(XskInfo->UmemInfo);
             if (addr == INVALID_UMEM_FRAME) {
                 break;
             }
-            *xsk_ring_prod__fill_addr(&XskInfo->UmemInfo->Fq, FqIdx++) = addr;
+            *xsk_ring_prod__fill_addr(&XskInfo->Fq, FqIdx++) = addr;
         }
         if (i > 0) {
-            xsk_ring_prod__submit(&XskInfo->UmemInfo->Fq, i);
+            xsk_ring_prod__submit(&XskInfo->Fq, i);
+            if (!Queue->BusyPoll && xsk_ring_prod__needs_wakeup(&XskInfo->Fq)) {
+                //
+                // With XDP_USE_NEED_WAKEUP the driver (zero-copy mode) stops
+                // polling the fill ring once it runs dry, so kick it.
+                //
+                recvfrom(xsk_socket__fd(XskInfo->Xsk), NULL, 0, MSG_DONTWAIT, NULL, NULL);
+            }
         }
     }
     CxPlatLockRelease(&Queue->FqLock);
-    CxPlatLockRelease(&XskInfo->UmemLock);
+    CxPlatLockRelease(&XskInfo->UmemInfo->UmemLock);
 
     if (PacketCount) {
         CxPlatDpRawRxEthernet(
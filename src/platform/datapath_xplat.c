@@ -49,6 +49,7 @@ CxPlatDataPathInitialize(
         ClientRecvContextLength,
         *NewDataPath,
         WorkerPool,
+        InitConfig,
         &((*NewDataPath)->RawDataPath));
 
 Error:
@@ -96,6 +97,32 @@ CxPlatDataPathGetSupportedFeatures(
     return DataPathGetSupportedFeatures(Datapath);
 }
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatDataPathGetXdpQueueInfo(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    )
+{
+    if (Datapath->RawDataPath) {
+        return RawDataPathGetXdpQueueInfo(Datapath->RawDataPath, QueueCount, QueueInfo);
+    }
+    *QueueCount = 0;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatDataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    )
+{
+    DataPathGetStatistics(Datapath, Statistics);
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 CxPlatDataPathIsPaddingPreferred(
@@ -462,6 +462,398 @@ Return Value:
     Context->Signature = Signature;
 }
 
+//
+// Open addressing layout (CXPLAT_HASH_OPEN_ADDRESSING).
+//
+// The table is a power-of-two array of entry pointers, split into groups of
+// CXPLAT_HASH_GROUP_WIDTH slots. Each slot has a one byte control value: the
+// top bit set for an empty or deleted slot, or 7 bits of the mixed hash for a
+// full slot. A lookup probes whole groups (triangular sequence over the group
+// index), comparing all the control bytes of a group at once, and only
+// dereferences entries whose control byte matches. Probing stops at the first
+// group that has an empty slot.
+//
+// TableSize is the number of slots, DivisorMask the group count minus one and
+// NonEmptyBuckets the number of slots that are either full or deleted.
+//
+// The table can't be resized while enumerators are active. If it fills up in
+// the meantime, further entries are linked (by their Linkage) on the Overflow
+// list, which lookups, removals and enumerations check after the slots. The
+// list is moved back into the slots by the next resize, which the end of the
+// last enumeration triggers.
+//
+
+#define CXPLAT_HASH_GROUP_WIDTH     16
+#define CXPLAT_HASH_CTRL_EMPTY      ((uint8_t)0x80)
+#define CXPLAT_HASH_CTRL_DELETED    ((uint8_t)0xFE)
+
+#define CXPLAT_HASH_OPEN_OVERFLOW_SLOT  (UINT32_MAX - 1)
+
+//
+// The open addressing table is grown once more than 7/8 of the slots are
+// full or deleted.
+//
+#define CXPLAT_HASH_OPEN_MAX_LOAD(Size) ((Size) - (Size) / 8)
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define CXPLAT_HASH_SSE2 1
+#endif
+
+static
+uint32_t
+CxPlatHashGroupMatch(
+    _In_reads_(CXPLAT_HASH_GROUP_WIDTH) const uint8_t* Group,
+    _In_ uint8_t Value
+    )
+{
+#ifdef CXPLAT_HASH_SSE2
+    const __m128i Ctrl = _mm_loadu_si128((const __m128i*)Group);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8((char)Value), Ctrl));
+#else
+    uint32_t Mask = 0;
+    for (uint32_t i = 0; i < CXPLAT_HASH_GROUP_WIDTH; ++i) {
+        Mask |= (uint32_t)(Group[i] == Value) << i;
+    }
+    return Mask;
+#endif
+}
+
+//
+// Returns the mask of empty or deleted slots in the group.
+//
+static
+uint32_t
+CxPlatHashGroupMatchFree(
+    _In_reads_(CXPLAT_HASH_GROUP_WIDTH) const uint8_t* Group
+    )
+{
+#ifdef CXPLAT_HASH_SSE2
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)Group));
+#else
+    uint32_t Mask = 0;
+    for (uint32_t i = 0; i < CXPLAT_HASH_GROUP_WIDTH; ++i) {
+        Mask |= (uint32_t)(Group[i] >> 7) << i;
+    }
+    return Mask;
+#endif
+}
+
+static
+uint32_t
+CxPlatHashLowestBit(
+    _In_ uint32_t Mask
+    )
+{
+    CXPLAT_DBG_ASSERT(Mask != 0);
+#ifdef _WIN32
+    unsigned long Index;
+    _BitScanForward(&Index, Mask);
+    return (uint32_t)Index;
+#else
+    return (uint32_t)__builtin_ctz(Mask);
+#endif
+}
+
+//
+// Mixes the signature, since callers commonly use weak hashes or sequential
+// values (e.g. stream IDs).
+//
+static
+QUIC_NO_SANITIZE("unsigned-integer-overflow")
+uint64_t
+CxPlatHashMix(
+    _In_ uint64_t Signature
+    )
+{
+    return Signature * 0x9E3779B97F4A7C15ull;
+}
+
+#define CXPLAT_HASH_TAG(Mixed)      ((uint8_t)((Mixed) >> 57))
+#define CXPLAT_HASH_GROUP(Mixed)    ((uint32_t)((Mixed) >> 24))
+
+static
+BOOLEAN
+CxPlatHashOpenAllocate(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ uint32_t TableSize
+    )
+{
+    uint8_t* Control =
+        CXPLAT_ALLOC_NONPAGED(
+            TableSize + TableSize * sizeof(CXPLAT_HASHTABLE_ENTRY*),
+            QUIC_POOL_HASHTABLE_MEMBER);
+    if (Control == NULL) {
+        return FALSE;
+    }
+
+    memset(Control, CXPLAT_HASH_CTRL_EMPTY, TableSize);
+    HashTable->Control = Control;
+    HashTable->Slots = (CXPLAT_HASHTABLE_ENTRY**)(Control + TableSize);
+    HashTable->TableSize = TableSize;
+    HashTable->DivisorMask = TableSize / CXPLAT_HASH_GROUP_WIDTH - 1;
+    HashTable->NonEmptyBuckets = 0;
+    return TRUE;
+}
+
+//
+// Places the entry in the first free slot of its probe sequence. Returns FALSE
+// if every slot is full.
+//
+static
+BOOLEAN
+CxPlatHashOpenPlace(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ CXPLAT_HASHTABLE_ENTRY* Entry
+    )
+{
+    const uint64_t Mixed = CxPlatHashMix(Entry->Signature);
+    uint32_t Group = CXPLAT_HASH_GROUP(Mixed) & HashTable->DivisorMask;
+    for (uint32_t Probe = 1; ; ++Probe) {
+        uint8_t* Control = HashTable->Control + Group * CXPLAT_HASH_GROUP_WIDTH;
+        const uint32_t Free = CxPlatHashGroupMatchFree(Control);
+        if (Free != 0) {
+            const uint32_t Offset = CxPlatHashLowestBit(Free);
+            if (Control[Offset] == CXPLAT_HASH_CTRL_EMPTY) {
+                HashTable->NonEmptyBuckets++;
+            }
+            Control[Offset] = CXPLAT_HASH_TAG(Mixed);
+            HashTable->Slots[Group * CXPLAT_HASH_GROUP_WIDTH + Offset] = Entry;
+            return TRUE;
+        }
+        if (Probe > HashTable->DivisorMask) {
+            return FALSE;
+        }
+        Group = (Group + Probe) & HashTable->DivisorMask;
+    }
+}
+
+//
+// Rebuilds the slot array with the given size, dropping all deleted slots and
+// moving in what fits of the overflow list. On allocation failure the table
+// is left untouched.
+//
+static
+BOOLEAN
+CxPlatHashOpenResize(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ uint32_t TableSize
+    )
+{
+    uint8_t* OldControl = HashTable->Control;
+    CXPLAT_HASHTABLE_ENTRY** OldSlots = HashTable->Slots;
+    const uint32_t OldTableSize = HashTable->TableSize;
+    const uint32_t OldDivisorMask = HashTable->DivisorMask;
+    const uint32_t OldNonEmptyBuckets = HashTable->NonEmptyBuckets;
+
+    if (!CxPlatHashOpenAllocate(HashTable, TableSize)) {
+        HashTable->Control = OldControl;
+        HashTable->Slots = OldSlots;
+        HashTable->TableSize = OldTableSize;
+        HashTable->DivisorMask = OldDivisorMask;
+        HashTable->NonEmptyBuckets = OldNonEmptyBuckets;
+        return FALSE;
+    }
+
+    for (uint32_t i = 0; i < OldTableSize; ++i) {
+        if (!(OldControl[i] & CXPLAT_HASH_CTRL_EMPTY)) {
+            BOOLEAN Placed = CxPlatHashOpenPlace(HashTable, OldSlots[i]);
+            CXPLAT_DBG_ASSERT(Placed);
+            UNREFERENCED_PARAMETER(Placed);
+        }
+    }
+
+    CXPLAT_DBG_ASSERT(HashTable->NumEnumerators == 0);
+    CXPLAT_LIST_ENTRY* Link = HashTable->Overflow.Flink;
+    while (Link != &HashTable->Overflow) {
+        CXPLAT_HASHTABLE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Link, CXPLAT_HASHTABLE_ENTRY, Linkage);
+        Link = Link->Flink;
+        if (CxPlatHashOpenPlace(HashTable, Entry)) {
+            CxPlatListEntryRemove(&Entry->Linkage);
+        }
+    }
+
+    CXPLAT_FREE(OldControl, QUIC_POOL_HASHTABLE_MEMBER);
+    return TRUE;
+}
+
+//
+// Continues a probe for the signature from the given slot (exclusive) and
+// probe count. Returns the slot index of the next match, or UINT32_MAX.
+//
+static
+uint32_t
+CxPlatHashOpenFind(
+    _In_ const CXPLAT_HASHTABLE* HashTable,
+    _In_ uint64_t Signature,
+    _Inout_ uint32_t* Probe,
+    _In_ uint32_t Slot
+    )
+{
+    const uint64_t Mixed = CxPlatHashMix(Signature);
+    const uint8_t Tag = CXPLAT_HASH_TAG(Mixed);
+
+    uint32_t Group;
+    uint32_t Skip;
+    if (Slot == UINT32_MAX) {
+        Group = CXPLAT_HASH_GROUP(Mixed) & HashTable->DivisorMask;
+        Skip = 0;
+    } else {
+        Group = Slot / CXPLAT_HASH_GROUP_WIDTH;
+        Skip = (Slot % CXPLAT_HASH_GROUP_WIDTH) + 1;
+    }
+
+    while (TRUE) {
+        const uint8_t* Control = HashTable->Control + Group * CXPLAT_HASH_GROUP_WIDTH;
+        uint32_t Match = CxPlatHashGroupMatch(Control, Tag);
+        if (Skip != 0) {
+            Match &= ~((1u << Skip) - 1);
+            Skip = 0;
+        }
+        while (Match != 0) {
+            const uint32_t Offset = CxPlatHashLowestBit(Match);
+            const uint32_t Index = Group * CXPLAT_HASH_GROUP_WIDTH + Offset;
+            if (HashTable->Slots[Index]->Signature == Signature) {
+                return Index;
+            }
+            Match &= Match - 1;
+        }
+        if (CxPlatHashGroupMatch(Control, CXPLAT_HASH_CTRL_EMPTY) != 0 ||
+            *Probe > HashTable->DivisorMask) {
+            return UINT32_MAX;
+        }
+        Group = (Group + ++(*Probe)) & HashTable->DivisorMask;
+    }
+}
+
+//
+// Returns the next entry on the overflow list after Link that has the
+// signature, skipping enumerators, or NULL.
+//
+static
+CXPLAT_HASHTABLE_ENTRY*
+CxPlatHashOpenFindOverflow(
+    _In_ const CXPLAT_HASHTABLE* HashTable,
+    _In_ uint64_t Signature,
+    _In_ const CXPLAT_LIST_ENTRY* Link
+    )
+{
+    for (Link = Link->Flink; Link != &HashTable->Overflow; Link = Link->Flink) {
+        CXPLAT_HASHTABLE_ENTRY* Entry =
+            CXPLAT_CONTAINING_RECORD(Link, CXPLAT_HASHTABLE_ENTRY, Linkage);
+        if (Entry->Signature == Signature) {
+            return Entry;
+        }
+    }
+    return NULL;
+}
+
+//
+// Continues a lookup from the context, through the slots and then the
+// overflow list. Returns the next entry with the signature, or NULL.
+//
+static
+CXPLAT_HASHTABLE_ENTRY*
+CxPlatHashOpenLookup(
+    _In_ const CXPLAT_HASHTABLE* HashTable,
+    _Inout_ CXPLAT_HASHTABLE_LOOKUP_CONTEXT* Context
+    )
+{
+    const CXPLAT_LIST_ENTRY* Link = &HashTable->Overflow;
+    if (Context->Slot == CXPLAT_HASH_OPEN_OVERFLOW_SLOT) {
+        Link = Context->PrevLinkage;
+    } else {
+        const uint32_t Slot =
+            CxPlatHashOpenFind(
+                HashTable, Context->Signature, &Context->Probe, Context->Slot);
+        if (Slot != UINT32_MAX) {
+            Context->Slot = Slot;
+            return HashTable->Slots[Slot];
+        }
+    }
+
+    CXPLAT_HASHTABLE_ENTRY* Entry =
+        CxPlatHashOpenFindOverflow(HashTable, Context->Signature, Link);
+    if (Entry != NULL) {
+        Context->Slot = CXPLAT_HASH_OPEN_OVERFLOW_SLOT;
+        Context->PrevLinkage = &Entry->Linkage;
+    }
+    return Entry;
+}
+
+static
+void
+CxPlatHashOpenInsert(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ CXPLAT_HASHTABLE_ENTRY* Entry
+    )
+{
+    if (HashTable->NonEmptyBuckets + 1 > CXPLAT_HASH_OPEN_MAX_LOAD(HashTable->TableSize) &&
+        HashTable->NumEnumerators == 0) {
+        //
+        // Mostly deleted slots just need to be cleaned up; otherwise double.
+        // If that fails, keep going on the remaining free slots.
+        //
+        const uint32_t TableSize =
+            (HashTable->NumEntries < HashTable->TableSize / 2) ?
+                HashTable->TableSize : HashTable->TableSize * 2;
+        (void)CxPlatHashOpenResize(HashTable, TableSize);
+    }
+
+    HashTable->NumEntries++;
+    if (!CxPlatHashOpenPlace(HashTable, Entry)) {
+        //
+        // Full, and it couldn't grow (enumerators are active or out of
+        // memory).
+        //
+        CxPlatListInsertTail(&HashTable->Overflow, &Entry->Linkage);
+    }
+}
+
+static
+void
+CxPlatHashOpenRemove(
+    _Inout_ CXPLAT_HASHTABLE* HashTable,
+    _In_ CXPLAT_HASHTABLE_ENTRY* Entry
+    )
+{
+    const uint64_t Mixed = CxPlatHashMix(Entry->Signature);
+    const uint8_t Tag = CXPLAT_HASH_TAG(Mixed);
+    uint32_t Group = CXPLAT_HASH_GROUP(Mixed) & HashTable->DivisorMask;
+
+    for (uint32_t Probe = 1; Probe <= HashTable->DivisorMask + 1; ++Probe) {
+        uint8_t* Control = HashTable->Control + Group * CXPLAT_HASH_GROUP_WIDTH;
+        uint32_t Match = CxPlatHashGroupMatch(Control, Tag);
+        while (Match != 0) {
+            const uint32_t Offset = CxPlatHashLowestBit(Match);
+            const uint32_t Index = Group * CXPLAT_HASH_GROUP_WIDTH + Offset;
+            if (HashTable->Slots[Index] == Entry) {
+                //
+                // A group with an empty slot has never been full, so no probe
+                // has ever gone past it and the slot can go back to empty.
+                //
+                if (CxPlatHashGroupMatch(Control, CXPLAT_HASH_CTRL_EMPTY) != 0) {
+                    Control[Offset] = CXPLAT_HASH_CTRL_EMPTY;
+                    HashTable->NonEmptyBuckets--;
+                } else {
+                    Control[Offset] = CXPLAT_HASH_CTRL_DELETED;
+                }
+                HashTable->Slots[Index] = NULL;
+                HashTable->NumEntries--;
+                return;
+            }
+            Match &= Match - 1;
+        }
+        Group = (Group + Probe) & HashTable->DivisorMask;
+    }
+
+    CXPLAT_FRE_ASSERTMSG(!CxPlatListIsEmpty(&HashTable->Overflow), "Entry not in hash table");
+    CxPlatListEntryRemove(&Entry->Linkage);
+    HashTable->NumEntries--;
+}
+
 _Must_inspect_result_
 _Success_(return != FALSE)
 BOOLEAN
@@ -597,6 +989,69 @@ Return Value:
     return TRUE;
 }
 
+_Must_inspect_result_
+_Success_(return != FALSE)
+BOOLEAN
+CxPlatHashtableInitializeOpen(
+    _Inout_ _When_(NULL == *HashTable, _At_(*HashTable, __drv_allocatesMem(Mem) _Post_notnull_))
+        CXPLAT_HASHTABLE* *HashTable,
+    _In_ uint32_t InitialSize
+    )
+/*++
+
+Routine Description:
+
+    Creates an open addressing hash table. Takes a pointer to a pointer to
+    CXPLAT_HASHTABLE, the same as CxPlatHashtableInitialize.
+
+Arguments:
+
+    HashTable - Pointer to a pointer to a hash Table to be initialized.
+
+    InitialSize - The initial number of slots in the hash table. Must be a
+        power of two, and at least CXPLAT_HASH_GROUP_WIDTH.
+
+Return Value:
+
+    TRUE if creation and initialization succeeded, FALSE otherwise.
+
+--*/
+{
+    if (!IS_POWER_OF_TWO(InitialSize) ||
+        (InitialSize < CXPLAT_HASH_GROUP_WIDTH)) {
+        return FALSE;
+    }
+
+    uint32_t LocalFlags = CXPLAT_HASH_OPEN_ADDRESSING;
+    CXPLAT_HASHTABLE* Table;
+    if (*HashTable == NULL) {
+        Table = CXPLAT_ALLOC_NONPAGED(sizeof(CXPLAT_HASHTABLE), QUIC_POOL_HASHTABLE);
+        if (Table == NULL) {
+            return FALSE;
+        }
+
+        LocalFlags |= CXPLAT_HASH_ALLOCATED_HEADER;
+
+    } else {
+        Table = *HashTable;
+    }
+
+    CxPlatZeroMemory(Table, sizeof(CXPLAT_HASHTABLE));
+    Table->Flags = LocalFlags;
+    CxPlatListInitializeHead(&Table->Overflow);
+
+    if (!CxPlatHashOpenAllocate(Table, InitialSize)) {
+        if (LocalFlags & CXPLAT_HASH_ALLOCATED_HEADER) {
+            CXPLAT_FREE(Table, QUIC_POOL_HASHTABLE);
+        }
+        return FALSE;
+    }
+
+    *HashTable = Table;
+
+    return TRUE;
+}
+
 void
 CxPlatHashtableUninitialize(
     _In_
@@ -628,7 +1083,14 @@ Arguments:
     CXPLAT_DBG_ASSERT(HashTable->NumEnumerators == 0);
     CXPLAT_DBG_ASSERT(HashTable->NumEntries == 0);
 
-    if (HashTable->TableSize <= HT_SECOND_LEVEL_DIR_MIN_SIZE) {
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+
+        if (HashTable->Control != NULL) {
+            CXPLAT_FREE(HashTable->Control, QUIC_POOL_HASHTABLE_MEMBER);
+            HashTable->Control = NULL;
+        }
+
+    } else if (HashTable->TableSize <= HT_SECOND_LEVEL_DIR_MIN_SIZE) {
 
         if (HashTable->SecondLevelDir != NULL) {
             CXPLAT_FREE(HashTable->SecondLevelDir, QUIC_POOL_HASHTABLE_MEMBER);
@@ -732,6 +1194,12 @@ Arguments:
 
     Entry->Signature = Signature;
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        UNREFERENCED_PARAMETER(Context);
+        CxPlatHashOpenInsert(HashTable, Entry);
+        return;
+    }
+
     HashTable->NumEntries++;
 
     if (Context == NULL) {
@@ -812,6 +1280,17 @@ Arguments:
     uint64_t Signature = Entry->Signature;
 
     CXPLAT_DBG_ASSERT(HashTable->NumEntries > 0);
+
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        CxPlatHashOpenRemove(HashTable, Entry);
+        if (Context != NULL) {
+            Context->Slot = UINT32_MAX;
+            Context->Probe = 0;
+            Context->Signature = Signature;
+        }
+        return;
+    }
+
     HashTable->NumEntries--;
 
     if (Entry->Linkage.Flink == Entry->Linkage.Blink) {
@@ -901,6 +1380,13 @@ Return Value:
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT* ContextPtr =
         (Context != NULL) ? Context : &LocalContext; // cppcheck-suppress uninitvar
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        ContextPtr->Probe = 0;
+        ContextPtr->Signature = Signature;
+        ContextPtr->Slot = UINT32_MAX;
+        return CxPlatHashOpenLookup(HashTable, ContextPtr);
+    }
+
     CxPlatPopulateContext(HashTable, ContextPtr, Signature);
 
     CXPLAT_LIST_ENTRY* CurEntry = ContextPtr->PrevLinkage->Flink;
@@ -957,6 +1443,12 @@ Return Value:
 --*/
 {
     CXPLAT_DBG_ASSERT(NULL != Context);
+
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        CXPLAT_DBG_ASSERT(Context->Slot != UINT32_MAX);
+        return CxPlatHashOpenLookup(HashTable, Context);
+    }
+
     CXPLAT_DBG_ASSERT(NULL != Context->ChainHead);
     CXPLAT_DBG_ASSERT(Context->PrevLinkage->Flink != Context->ChainHead);
 
@@ -1045,6 +1537,19 @@ Arguments:
 {
     CXPLAT_DBG_ASSERT(Enumerator != NULL);
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        //
+        // BucketIndex is the next slot to look at. Once past the slots, the
+        // enumerator's entry is linked into the overflow list (and ChainHead
+        // set), like it is into a chain of the chained layout.
+        //
+        HashTable->NumEnumerators++;
+        Enumerator->BucketIndex = 0;
+        Enumerator->ChainHead = NULL;
+        Enumerator->HashEntry.Signature = CXPLAT_HASH_RESERVED_SIGNATURE;
+        return;
+    }
+
     CXPLAT_HASHTABLE_LOOKUP_CONTEXT LocalContext;
     CxPlatPopulateContext(HashTable, &LocalContext, 0);
     HashTable->NumEnumerators++;
@@ -1099,6 +1604,33 @@ Return Value:
 --*/
 {
     CXPLAT_DBG_ASSERT(Enumerator != NULL);
+
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        for (uint32_t i = Enumerator->BucketIndex; i < HashTable->TableSize; i++) {
+            if (!(HashTable->Control[i] & CXPLAT_HASH_CTRL_EMPTY)) {
+                Enumerator->BucketIndex = i + 1;
+                return HashTable->Slots[i];
+            }
+        }
+        Enumerator->BucketIndex = HashTable->TableSize;
+        if (Enumerator->ChainHead == NULL) {
+            Enumerator->ChainHead = &HashTable->Overflow;
+            CxPlatListInsertHead(&HashTable->Overflow, &Enumerator->HashEntry.Linkage);
+        }
+        CXPLAT_LIST_ENTRY* Link = Enumerator->HashEntry.Linkage.Flink;
+        while (Link != &HashTable->Overflow) {
+            CXPLAT_HASHTABLE_ENTRY* Entry =
+                CXPLAT_CONTAINING_RECORD(Link, CXPLAT_HASHTABLE_ENTRY, Linkage);
+            if (Entry->Signature != CXPLAT_HASH_RESERVED_SIGNATURE) {
+                CxPlatListEntryRemove(&Enumerator->HashEntry.Linkage);
+                CxPlatListInsertHead(Link, &Enumerator->HashEntry.Linkage);
+                return Entry;
+            }
+            Link = Link->Flink;
+        }
+        return NULL;
+    }
+
     CXPLAT_DBG_ASSERT(Enumerator->ChainHead != NULL);
     CXPLAT_DBG_ASSERT(CXPLAT_HASH_RESERVED_SIGNATURE == Enumerator->HashEntry.Signature);
 
@@ -1185,6 +1717,24 @@ Arguments:
     CXPLAT_DBG_ASSERT(HashTable->NumEnumerators > 0);
     HashTable->NumEnumerators--;
 
+    if (HashTable->Flags & CXPLAT_HASH_OPEN_ADDRESSING) {
+        if (Enumerator->ChainHead != NULL) {
+            CxPlatListEntryRemove(&Enumerator->HashEntry.Linkage);
+            Enumerator->ChainHead = NULL;
+        }
+        if (HashTable->NumEnumerators == 0 && !CxPlatListIsEmpty(&HashTable->Overflow)) {
+            //
+            // Now the table can grow to take the entries that didn't fit.
+            //
+            uint32_t TableSize = HashTable->TableSize * 2;
+            while (CXPLAT_HASH_OPEN_MAX_LOAD(TableSize) < HashTable->NumEntries) {
+                TableSize *= 2;
+            }
+            (void)CxPlatHashOpenResize(HashTable, TableSize);
+        }
+        return;
+    }
+
     if (!CxPlatListIsEmpty(&(Enumerator->HashEntry.Linkage))) {
         CXPLAT_DBG_ASSERT(Enumerator->ChainHead != NULL);
 
@@ -121,6 +121,34 @@ const uint16_t PCP_PEER_REQUEST_SIZE = SIZEOF_THROUGH_FIELD(PCP_REQUEST, PEER.Re
 const uint16_t PCP_MAP_RESPONSE_SIZE = SIZEOF_THROUGH_FIELD(PCP_RESPONSE, MAP.AssignedExternalIpAddress);
 const uint16_t PCP_PEER_RESPONSE_SIZE = SIZEOF_THROUGH_FIELD(PCP_RESPONSE, PEER.RemotePeerIpAddress);
 
+//
+// Retransmission of unanswered MAP requests starts at the RFC 6887 initial
+// retransmission time and doubles up to its maximum.
+//
+#define PCP_RETRY_INTERVAL_INITIAL_US   (3 * 1000 * 1000)
+#define PCP_RETRY_INTERVAL_MAX_US       (1024ull * 1000 * 1000)
+
+//
+// A MAP mapping shared by every user of the same internal port.
+//
+typedef struct CXPLAT_PCP_MAPPING {
+
+    CXPLAT_LIST_ENTRY Link;
+
+    uint32_t RefCount;
+    uint16_t InternalPort;          // Host byte order
+    BOOLEAN Granted;                // ExternalAddress holds a live mapping
+    uint8_t Nonce[CXPLAT_PCP_NONCE_LENGTH];
+    uint32_t Lifetime;              // Requested, in seconds
+
+    QUIC_ADDR ExternalAddress;
+
+    uint64_t ExpirationTimeUs;      // When the granted mapping lapses
+    uint64_t RenewTimeUs;           // When the next MAP request is sent
+    uint64_t RetryIntervalUs;
+
+} CXPLAT_PCP_MAPPING;
+
 //
 // Main structure for PCP
 //
@@ -129,6 +157,22 @@ typedef struct CXPLAT_PCP {
     void* ClientContext;
     CXPLAT_PCP_CALLBACK_HANDLER ClientCallback;
 
+    //
+    // Cached MAP mappings, see CxPlatPcpAcquireMapping.
+    //
+    CXPLAT_DISPATCH_LOCK MappingLock;
+    CXPLAT_LIST_ENTRY Mappings;
+
+#ifndef _KERNEL_MODE
+    //
+    // Renews the cached mappings in the background, if a worker pool was given.
+    //
+    CXPLAT_EXECUTION_CONTEXT RenewEc;
+    CXPLAT_EVENT RenewShutdownEvent;
+    BOOLEAN RenewEcActive;
+    BOOLEAN RenewShutdown;
+#endif
+
     uint32_t GatewayCount;
 
     _Field_size_(GatewayCount)
@@ -136,10 +180,20 @@ typedef struct CXPLAT_PCP {
 
 } CXPLAT_PCP;
 
+#ifndef _KERNEL_MODE
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+CxPlatPcpRenewExecute(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    );
+#endif
+
 _IRQL_requires_max_(PASSIVE_LEVEL)
 QUIC_STATUS
 CxPlatPcpInitialize(
     _In_ CXPLAT_DATAPATH* Datapath,
+    _In_opt_ CXPLAT_WORKER_POOL* WorkerPool,
     _In_ void* Context,
     _In_ CXPLAT_PCP_CALLBACK_HANDLER Handler,
     _Out_ CXPLAT_PCP** NewPcpContext
@@ -171,6 +225,8 @@ CxPlatPcpInitialize(
     CxPlatZeroMemory(PcpContext, PcpContextSize);
     PcpContext->ClientContext = Context;
     PcpContext->ClientCallback = Handler;
+    CxPlatDispatchLockInitialize(&PcpContext->MappingLock);
+    CxPlatListInitializeHead(&PcpContext->Mappings);
     PcpContext->GatewayCount = GatewayAddressesCount;
 
     CXPLAT_UDP_CONFIG UdpConfig = {0};
@@ -192,6 +248,20 @@ CxPlatPcpInitialize(
         }
     }
 
+#ifndef _KERNEL_MODE
+    if (WorkerPool != NULL) {
+        CxPlatEventInitialize(&PcpContext->RenewShutdownEvent, TRUE, FALSE);
+        PcpContext->RenewEc.Context = PcpContext;
+        PcpContext->RenewEc.Callback = CxPlatPcpRenewExecute;
+        PcpContext->RenewEc.NextTimeUs = UINT64_MAX;
+        PcpContext->RenewEcActive = TRUE;
+        CxPlatWorkerPoolAddExecutionContext(WorkerPool, &PcpContext->RenewEc, 0);
+    }
+#else
+    UNREFERENCED_PARAMETER(WorkerPool);
+    CXPLAT_DBG_ASSERT(WorkerPool == NULL);
+#endif
+
     *NewPcpContext = PcpContext;
     Status = QUIC_STATUS_SUCCESS;
 
@@ -218,15 +288,289 @@ CxPlatPcpUninitialize(
 {
     CXPLAT_DBG_ASSERT(PcpContext != NULL);
 
+#ifndef _KERNEL_MODE
+    if (PcpContext->RenewEcActive) {
+        //
+        // The renewal execution context removes itself on its next run and
+        // then signals the event.
+        //
+        PcpContext->RenewShutdown = TRUE;
+        PcpContext->RenewEc.Ready = TRUE;
+        CxPlatWakeExecutionContext(&PcpContext->RenewEc);
+        CxPlatEventWaitForever(PcpContext->RenewShutdownEvent);
+        CxPlatEventUninitialize(PcpContext->RenewShutdownEvent);
+    }
+#endif
+
     for (uint32_t i = 0; i < PcpContext->GatewayCount; ++i) {
         if (PcpContext->GatewaySockets[i] != NULL) {
             CxPlatSocketDelete(PcpContext->GatewaySockets[i]);
         }
     }
 
+    while (!CxPlatListIsEmpty(&PcpContext->Mappings)) {
+        CXPLAT_PCP_MAPPING* Mapping =
+            CXPLAT_CONTAINING_RECORD(
+                CxPlatListRemoveHead(&PcpContext->Mappings),
+                CXPLAT_PCP_MAPPING,
+                Link);
+        CXPLAT_FREE(Mapping, QUIC_POOL_PCP);
+    }
+
+    CxPlatDispatchLockUninitialize(&PcpContext->MappingLock);
     CXPLAT_FREE(PcpContext, QUIC_POOL_PCP);
 }
 
+//
+// Finds the cached mapping for the internal port. Called with the mapping lock
+// held.
+//
+static
+CXPLAT_PCP_MAPPING*
+CxPlatPcpFindMapping(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ uint16_t InternalPort
+    )
+{
+    for (CXPLAT_LIST_ENTRY* Entry = PcpContext->Mappings.Flink;
+         Entry != &PcpContext->Mappings;
+         Entry = Entry->Flink) {
+        CXPLAT_PCP_MAPPING* Mapping =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_PCP_MAPPING, Link);
+        if (Mapping->InternalPort == InternalPort) {
+            return Mapping;
+        }
+    }
+    return NULL;
+}
+
+//
+// Sends MAP requests for every cached mapping due for renewal (or a retry) and
+// returns the earliest time another one is due. Called with the mapping lock
+// held.
+//
+static
+uint64_t
+CxPlatPcpProcessMappings(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ uint64_t TimeNow
+    )
+{
+    uint64_t NextTimeUs = UINT64_MAX;
+    for (CXPLAT_LIST_ENTRY* Entry = PcpContext->Mappings.Flink;
+         Entry != &PcpContext->Mappings;
+         Entry = Entry->Flink) {
+        CXPLAT_PCP_MAPPING* Mapping =
+            CXPLAT_CONTAINING_RECORD(Entry, CXPLAT_PCP_MAPPING, Link);
+        if (Mapping->Granted && Mapping->ExpirationTimeUs <= TimeNow) {
+            Mapping->Granted = FALSE;
+        }
+        if (Mapping->RenewTimeUs <= TimeNow) {
+            (void)CxPlatPcpSendMapRequest(
+                PcpContext,
+                Mapping->Nonce,
+                NULL,
+                Mapping->InternalPort,
+                Mapping->Lifetime);
+            Mapping->RenewTimeUs = TimeNow + Mapping->RetryIntervalUs;
+            Mapping->RetryIntervalUs =
+                CXPLAT_MIN(Mapping->RetryIntervalUs * 2, PCP_RETRY_INTERVAL_MAX_US);
+        }
+        if (Mapping->RenewTimeUs < NextTimeUs) {
+            NextTimeUs = Mapping->RenewTimeUs;
+        }
+    }
+    return NextTimeUs;
+}
+
+//
+// Signals the renewal execution context that the mapping schedule changed.
+//
+static
+void
+CxPlatPcpWakeRenewal(
+    _In_ CXPLAT_PCP* PcpContext
+    )
+{
+#ifndef _KERNEL_MODE
+    if (PcpContext->RenewEcActive) {
+        PcpContext->RenewEc.Ready = TRUE;
+        CxPlatWakeExecutionContext(&PcpContext->RenewEc);
+    }
+#else
+    UNREFERENCED_PARAMETER(PcpContext);
+#endif
+}
+
+#ifndef _KERNEL_MODE
+_IRQL_requires_max_(PASSIVE_LEVEL)
+BOOLEAN
+CxPlatPcpRenewExecute(
+    _Inout_ void* Context,
+    _Inout_ CXPLAT_EXECUTION_STATE* State
+    )
+{
+    CXPLAT_PCP* PcpContext = (CXPLAT_PCP*)Context;
+
+    if (PcpContext->RenewShutdown) {
+        CxPlatEventSet(PcpContext->RenewShutdownEvent);
+        return FALSE;
+    }
+
+    CxPlatDispatchLockAcquire(&PcpContext->MappingLock);
+    PcpContext->RenewEc.NextTimeUs =
+        CxPlatPcpProcessMappings(PcpContext, State->TimeNow);
+    CxPlatDispatchLockRelease(&PcpContext->MappingLock);
+
+    return TRUE;
+}
+#endif
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+QUIC_STATUS
+CxPlatPcpAcquireMapping(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ uint16_t InternalPort,
+    _In_ uint32_t Lifetime,
+    _Out_ QUIC_ADDR* ExternalAddress
+    )
+{
+    CXPLAT_DBG_ASSERT(PcpContext != NULL);
+    CXPLAT_DBG_ASSERT(Lifetime != 0);
+
+    QUIC_STATUS Status = QUIC_STATUS_PENDING;
+    BOOLEAN WakeRenewal = FALSE;
+    uint64_t TimeNow = CxPlatTimeUs64();
+
+    CxPlatZeroMemory(ExternalAddress, sizeof(*ExternalAddress));
+
+    CxPlatDispatchLockAcquire(&PcpContext->MappingLock);
+
+    CXPLAT_PCP_MAPPING* Mapping = CxPlatPcpFindMapping(PcpContext, InternalPort);
+    if (Mapping == NULL) {
+        Mapping =
+            (CXPLAT_PCP_MAPPING*)CXPLAT_ALLOC_NONPAGED(
+                sizeof(CXPLAT_PCP_MAPPING), QUIC_POOL_PCP);
+        if (Mapping == NULL) {
+            Status = QUIC_STATUS_OUT_OF_MEMORY;
+            goto Exit;
+        }
+        CxPlatZeroMemory(Mapping, sizeof(*Mapping));
+        Mapping->InternalPort = InternalPort;
+        Mapping->Lifetime = Lifetime;
+        Status = CxPlatRandom(sizeof(Mapping->Nonce), Mapping->Nonce);
+        if (QUIC_FAILED(Status)) {
+            CXPLAT_FREE(Mapping, QUIC_POOL_PCP);
+            goto Exit;
+        }
+        Mapping->RenewTimeUs = TimeNow;
+        Mapping->RetryIntervalUs = PCP_RETRY_INTERVAL_INITIAL_US;
+        CxPlatListInsertTail(&PcpContext->Mappings, &Mapping->Link);
+        WakeRenewal = TRUE;
+        Status = QUIC_STATUS_PENDING;
+    }
+
+    Mapping->RefCount++;
+
+    //
+    // Without a renewal execution context, due renewals are sent here instead.
+    //
+    (void)CxPlatPcpProcessMappings(PcpContext, TimeNow);
+
+    if (Mapping->Granted) {
+        CxPlatCopyMemory(ExternalAddress, &Mapping->ExternalAddress, sizeof(QUIC_ADDR));
+        Status = QUIC_STATUS_SUCCESS;
+    }
+
+Exit:
+
+    CxPlatDispatchLockRelease(&PcpContext->MappingLock);
+
+    if (WakeRenewal) {
+        CxPlatPcpWakeRenewal(PcpContext);
+    }
+
+    return Status;
+}
+
+_IRQL_requires_max_(DISPATCH_LEVEL)
+void
+CxPlatPcpReleaseMapping(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ uint16_t InternalPort
+    )
+{
+    CXPLAT_DBG_ASSERT(PcpContext != NULL);
+
+    CxPlatDispatchLockAcquire(&PcpContext->MappingLock);
+
+    CXPLAT_PCP_MAPPING* Mapping = CxPlatPcpFindMapping(PcpContext, InternalPort);
+    CXPLAT_DBG_ASSERT(Mapping != NULL && Mapping->RefCount != 0);
+    if (Mapping != NULL && --Mapping->RefCount == 0) {
+        CxPlatListEntryRemove(&Mapping->Link);
+    } else {
+        Mapping = NULL;
+    }
+
+    CxPlatDispatchLockRelease(&PcpContext->MappingLock);
+
+    if (Mapping != NULL) {
+        //
+        // A zero lifetime with the mapping's nonce deletes it on the gateways.
+        //
+        (void)CxPlatPcpSendMapRequest(
+            PcpContext,
+            Mapping->Nonce,
+            NULL,
+            Mapping->InternalPort,
+            0);
+        CXPLAT_FREE(Mapping, QUIC_POOL_PCP);
+    }
+}
+
+//
+// Updates the cached mapping, if any, that a MAP response is for.
+//
+static
+void
+CxPlatPcpUpdateMapping(
+    _In_ CXPLAT_PCP* PcpContext,
+    _In_ const CXPLAT_PCP_EVENT* Event,
+    _In_ uint16_t InternalPort
+    )
+{
+    BOOLEAN WakeRenewal = FALSE;
+    uint64_t TimeNow = CxPlatTimeUs64();
+
+    CxPlatDispatchLockAcquire(&PcpContext->MappingLock);
+
+    CXPLAT_PCP_MAPPING* Mapping = CxPlatPcpFindMapping(PcpContext, InternalPort);
+    if (Mapping != NULL &&
+        memcmp(Mapping->Nonce, Event->MAP.Nonce, CXPLAT_PCP_NONCE_LENGTH) == 0) {
+        if (Event->Type == CXPLAT_PCP_EVENT_MAP && Event->MAP.LifetimeSeconds != 0) {
+            uint64_t LifetimeUs = S_TO_US((uint64_t)Event->MAP.LifetimeSeconds);
+            CxPlatCopyMemory(
+                &Mapping->ExternalAddress,
+                Event->MAP.ExternalAddress,
+                sizeof(QUIC_ADDR));
+            Mapping->Granted = TRUE;
+            Mapping->ExpirationTimeUs = TimeNow + LifetimeUs;
+            Mapping->RenewTimeUs = TimeNow + LifetimeUs / 2; // RFC 6887, 11.2.1
+            Mapping->RetryIntervalUs = PCP_RETRY_INTERVAL_INITIAL_US;
+            WakeRenewal = TRUE;
+        }
+        //
+        // Failures leave the retry already scheduled by the last request.
+        //
+    }
+
+    CxPlatDispatchLockRelease(&PcpContext->MappingLock);
+
+    if (WakeRenewal) {
+        CxPlatPcpWakeRenewal(PcpContext);
+    }
+}
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 CxPlatPcpProcessDatagram(
@@ -306,6 +650,14 @@ CxPlatPcpProcessDatagram(
         return;
     }
 
+    if (Event.Type != CXPLAT_PCP_EVENT_PEER &&
+        Response->Opcode == PCP_OPCODE_MAP) {
+        CxPlatPcpUpdateMapping(
+            PcpContext,
+            &Event,
+            CxPlatByteSwapUint16(Response->MAP.InternalPort));
+    }
+
     PcpContext->ClientCallback(
         PcpContext,
         PcpContext->ClientContext,
@@ -716,6 +716,50 @@ CxPlatCryptUninitialize(
     void
     );
 
+//
+// Peer certificate validation cache. Remembers leaf certificates (along with
+// the SNI they were validated for) that recently passed full chain validation,
+// so clients repeatedly connecting to the same servers skip chain building and
+// signature checks. Entries expire after CXPLAT_CERT_CACHE_TTL_US, so trust
+// store changes are picked up, or when any certificate in the chain does.
+//
+
+#define CXPLAT_CERT_CACHE_SIZE      64 // Must be a power of 2
+#define CXPLAT_CERT_CACHE_TTL_US    (60 * 1000 * 1000)
+
+typedef struct CXPLAT_CERT_CACHE_ENTRY {
+    uint64_t ExpiryUs; // 0 if unused.
+    uint8_t Fingerprint[CXPLAT_HASH_SHA256_SIZE];
+} CXPLAT_CERT_CACHE_ENTRY;
+
+typedef struct CXPLAT_CERT_CACHE {
+    CXPLAT_LOCK Lock;
+    CXPLAT_CERT_CACHE_ENTRY Entries[CXPLAT_CERT_CACHE_SIZE];
+} CXPLAT_CERT_CACHE;
+
+void
+CxPlatCertCacheInitialize(
+    _Out_ CXPLAT_CERT_CACHE* Cache
+    );
+
+void
+CxPlatCertCacheUninitialize(
+    _In_ CXPLAT_CERT_CACHE* Cache
+    );
+
+struct x509_store_ctx_st;
+
+//
+// Validates the peer's chain with X509_verify_cert, unless its leaf is in the
+// cache. Returns X509_verify_cert's result.
+//
+int
+CxPlatCertCacheVerify(
+    _In_ CXPLAT_CERT_CACHE* Cache,
+    _In_ struct x509_store_ctx_st* X509Ctx,
+    _In_opt_z_ const char* SNI
+    );
+
 //
 // Queries the raw datapath stack for the total size needed to allocate the
 // datapath structure.
@@ -726,7 +770,7 @@ CxPlatDpRawGetDatapathSize(
     _In_ CXPLAT_WORKER_POOL* WorkerPool
     );
 
-#if defined(CX_PLATFORM_LINUX)
+#if defined(CX_PLATFORM_LINUX) && !defined(CXPLAT_MEMORY_DATAPATH)
 
 typedef struct CXPLAT_DATAPATH_PARTITION CXPLAT_DATAPATH_PARTITION;
 
@@ -743,6 +787,7 @@ typedef enum CXPLAT_SOCKET_IO_TAG {
     IoTagShutdown,
     IoTagRecv,
     IoTagSend,
+    IoTagRecvCancel,
     IoTagMax
 } CXPLAT_SOCKET_IO_TAG;
 
@@ -783,6 +828,14 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     //
     CXPLAT_SQE FlushTxSqe;
 
+#ifdef CXPLAT_USE_IO_URING
+    //
+    // The submission queue event for cancelling the multishot receive, to
+    // move it back to the large buffer group.
+    //
+    CXPLAT_SQE RecvCancelSqe;
+#endif
+
     //
     // The head of list containg all pending sends on this socket.
     //
@@ -807,6 +860,27 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     int64_t IoCountTags[IoTagMax];
 #endif // defined(CXPLAT_USE_IO_URING) && defined(DEBUG)
 
+#ifndef CXPLAT_USE_IO_URING
+    //
+    // The events the socket is currently registered for with epoll.
+    //
+    uint32_t EpollEvents;
+
+    //
+    // The number of messages to receive in the next recvmmsg call, adapted
+    // to the recent yield. Zero until the first receive.
+    //
+    uint16_t RecvBatchSize;
+
+    //
+    // Entry in the partition's TxFlushList, when a flush of the send queue is
+    // pending at the end of the worker pass. Only used on the partition's
+    // thread.
+    //
+    CXPLAT_LIST_ENTRY TxFlushEntry;
+    BOOLEAN TxFlushQueued;
+#endif
+
     //
     // Inidicates the SQEs have been initialized.
     //
@@ -818,12 +892,30 @@ typedef struct QUIC_CACHEALIGN CXPLAT_SOCKET_CONTEXT {
     BOOLEAN IoStarted : 1;
 
 #ifdef CXPLAT_USE_IO_URING
+    //
+    // The index of the socket in the io_uring's registered file table, or -1
+    // if it isn't registered.
+    //
+    int FixedFileIndex;
+
+    //
+    // The buffer group (CXPLAT_IO_RING_BUF_GROUP) the multishot receive
+    // selects buffers from.
+    //
+    uint16_t RecvBufferGroup;
+
     struct {
         //
         // Indicates if the socket has started shutting down.
         //
         BOOLEAN Shutdown : 1;
 
+        //
+        // Indicates a cancel of the multishot receive has been submitted to
+        // move it back to the large buffer group.
+        //
+        BOOLEAN RecvCancelPending : 1;
+
 #if DEBUG
         //
         // Indicates if the socket socket has a multi recv outstanding.
@@ -909,7 +1001,11 @@ typedef struct CXPLAT_REGISTERED_BUFFER_POOL {
     void* Ring;
     uint8_t* Buffers;
     uint32_t BufferSize;
+    uint32_t BufferCount;
     uint32_t TotalSize;
+    uint16_t NumaNode;
+    BOOLEAN HugePages;          // Ring was allocated with CxPlatAllocHugePages
+    int64_t AvailableCount;     // Buffers currently in the ring
     CXPLAT_LOCK Lock;
 } CXPLAT_REGISTERED_BUFFER_POOL;
 
@@ -950,11 +1046,28 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
 
 #ifdef CXPLAT_USE_IO_URING
     //
-    // Backing pool of registered buffers for the RecvBlockPool.
+    // Backing pool of registered buffers for the RecvBlockPool. When receive
+    // coalescing is enabled, these are sized for GRO and the small pool is
+    // used as a fallback when they run out.
     //
     CXPLAT_REGISTERED_BUFFER_POOL RecvRegisteredBufferPool;
+    CXPLAT_REGISTERED_BUFFER_POOL RecvSmallRegisteredBufferPool;
+
+    //
+    // Receive buffer statistics, updated only on the partition's EventQ
+    // thread.
+    //
+    uint64_t RecvRearmCount;            // Multishot receives resubmitted
+    uint64_t RecvBufferStarvationCount; // Multishot receives ended by ENOBUFS
+    uint64_t RecvTruncatedCount;        // Datagrams dropped for not fitting
 #endif
 
+    //
+    // Receive statistics, updated only on the partition's EventQ thread.
+    //
+    uint64_t RecvCallCount;             // Receive calls (or completions) that returned data
+    uint64_t RecvMessageCount;          // Messages returned by them
+
     //
     // Pool of send packet contexts and buffers to be shared by all sockets
     // on this core.
@@ -966,6 +1079,12 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
     // Backing pool of registered buffers for the SendBlockPool.
     //
     CXPLAT_REGISTERED_BUFFER_POOL SendRegisteredBufferPool;
+
+    //
+    // Which slots of the io_uring's registered file table are in use, or NULL
+    // if socket fds aren't registered. Protected by the EventQ lock.
+    //
+    BOOLEAN* FixedFileSlots;
 #endif
 
     //
@@ -973,6 +1092,17 @@ typedef struct QUIC_CACHEALIGN CXPLAT_DATAPATH_PARTITION {
     //
     CXPLAT_THREAD_ID OwningThreadID;
 
+#ifndef CXPLAT_USE_IO_URING
+    //
+    // With send batching, the socket contexts whose send queues are flushed
+    // by TxFlushEc at the end of the worker pass. Only used on the
+    // partition's thread.
+    //
+    CXPLAT_EXECUTION_CONTEXT TxFlushEc;
+    CXPLAT_LIST_ENTRY TxFlushList;
+    BOOLEAN TxFlushShutdown;
+#endif
+
 } CXPLAT_DATAPATH_PARTITION;
 
 //
@@ -1030,6 +1160,17 @@ typedef struct CXPLAT_DATAPATH {
 
     uint8_t ReserveAuxTcpSock : 1;
 
+    //
+    // UDP sockets are registered with epoll as edge triggered.
+    //
+    uint8_t EdgeTriggered : 1;
+
+    //
+    // Sends on unconnected UDP sockets are queued and flushed together at the
+    // end of the worker pass.
+    //
+    uint8_t SendBatching : 1;
+
     //
     // The per proc datapath contexts.
     //
@@ -1037,7 +1178,7 @@ typedef struct CXPLAT_DATAPATH {
 
 } CXPLAT_DATAPATH;
 
-#endif // CX_PLATFORM_LINUX
+#endif // CX_PLATFORM_LINUX && !CXPLAT_MEMORY_DATAPATH
 
 #if defined(CX_PLATFORM_LINUX) || _WIN32
 
@@ -1112,6 +1253,13 @@ DataPathIsPaddingPreferred(
     _In_ CXPLAT_DATAPATH* Datapath
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+DataPathGetStatistics(
+    _In_ CXPLAT_DATAPATH* Datapath,
+    _Out_ CXPLAT_DATAPATH_STATISTICS* Statistics
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 void
 RecvDataReturn(
@@ -1194,6 +1342,7 @@ RawDataPathInitialize(
     _In_ uint32_t ClientRecvContextLength,
     _In_opt_ const CXPLAT_DATAPATH* ParentDataPath,
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ const CXPLAT_DATAPATH_INIT_CONFIG* InitConfig,
     _Outptr_result_maybenull_ CXPLAT_DATAPATH_RAW** DataPath
     );
 
@@ -1216,6 +1365,15 @@ RawDataPathGetSupportedFeatures(
     _In_ CXPLAT_DATAPATH_RAW* Datapath
     );
 
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+RawDataPathGetXdpQueueInfo(
+    _In_ CXPLAT_DATAPATH_RAW* Datapath,
+    _Inout_ uint32_t* QueueCount,
+    _Out_writes_opt_(*QueueCount)
+        QUIC_XDP_QUEUE_INFO* QueueInfo
+    );
+
 _IRQL_requires_max_(DISPATCH_LEVEL)
 BOOLEAN
 RawDataPathIsPaddingPreferred(
@@ -23,7 +23,13 @@ Environment:
 #include <dlfcn.h>
 #include <fcntl.h>
 #include <limits.h>
+#if __APPLE__
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
 #include <sched.h>
+#include <sys/mman.h>
 #include <syslog.h>
 #define QUIC_VERSION_ONLY 1
 #include "msquic.ver"
@@ -50,8 +56,64 @@ uint32_t CxPlatProcessorCount;
 
 uint64_t CxPlatTotalMemory;
 
+uint32_t CxPlatHugePageSize;
+
+//
+// The huge page arena is a set of huge page mappings ("chunks") that pool
+// entries are carved from. The chunk array is append-only, so lookups only
+// need the published count.
+//
+#define CXPLAT_HUGE_PAGE_ARENA_MAX_CHUNKS 64
+#define CXPLAT_HUGE_PAGE_ARENA_2MB_CHUNK_SIZE (64 * 1024 * 1024)
+
+typedef struct CXPLAT_HUGE_PAGE_ARENA {
+  CXPLAT_LOCK Lock;
+  uint32_t ChunkCount;
+  size_t ChunkSize;
+  size_t Offset; // Carve offset into the last chunk.
+  uint8_t *Chunks[CXPLAT_HUGE_PAGE_ARENA_MAX_CHUNKS];
+} CXPLAT_HUGE_PAGE_ARENA;
+
+static CXPLAT_HUGE_PAGE_ARENA CxPlatHugePageArena;
+
+//
+// Per-tag allocation accounting. Tags get a dense index the first time they are
+// seen (under Lock); a hash from tag to index makes later lookups lock free.
+// Counters are sharded by processor so concurrent allocations don't share
+// cache lines; live bytes are the sum over all shards.
+//
+#define CXPLAT_ALLOC_TELEMETRY_MAX_TAGS 256
+#define CXPLAT_ALLOC_TELEMETRY_HASH_SIZE (2 * CXPLAT_ALLOC_TELEMETRY_MAX_TAGS)
+#define CXPLAT_ALLOC_TELEMETRY_SHARD_COUNT 16
+#define CXPLAT_ALLOC_TELEMETRY_PEAK_SAMPLE_MASK 63 // Sample the peak every 64 allocations.
+
+typedef struct CXPLAT_ALLOC_TELEMETRY_COUNTERS {
+  int64_t Bytes;
+  int64_t Allocations;
+} CXPLAT_ALLOC_TELEMETRY_COUNTERS;
+
+typedef struct __attribute__((aligned(64))) CXPLAT_ALLOC_TELEMETRY_SHARD {
+  CXPLAT_ALLOC_TELEMETRY_COUNTERS Tags[CXPLAT_ALLOC_TELEMETRY_MAX_TAGS];
+} CXPLAT_ALLOC_TELEMETRY_SHARD;
+
+typedef struct CXPLAT_ALLOC_TELEMETRY {
+  BOOLEAN Enabled;
+  CXPLAT_LOCK Lock;
+  uint32_t TagCount;
+  uint32_t Tags[CXPLAT_ALLOC_TELEMETRY_MAX_TAGS];
+  uint16_t Hash[CXPLAT_ALLOC_TELEMETRY_HASH_SIZE]; // Index + 1, or 0 if free.
+  uint64_t Peak[CXPLAT_ALLOC_TELEMETRY_MAX_TAGS];
+  uint64_t LastQueryTimeUs[CXPLAT_ALLOC_TELEMETRY_MAX_TAGS];
+  int64_t LastQueryAllocations[CXPLAT_ALLOC_TELEMETRY_MAX_TAGS];
+  uint64_t EnableTimeUs;
+  CXPLAT_ALLOC_TELEMETRY_SHARD Shards[CXPLAT_ALLOC_TELEMETRY_SHARD_COUNT];
+} CXPLAT_ALLOC_TELEMETRY;
+
+static CXPLAT_ALLOC_TELEMETRY CxPlatAllocTelemetry;
+
 #if __APPLE__ || __FreeBSD__
 uintptr_t CxPlatCurrentSqe = 0x80000000;
+__thread CXPLAT_EVENTQ_CHANGES CxPlatEventQChanges;
 #endif
 
 #ifdef __clang__
@@ -226,17 +288,171 @@ CxPlatInitialize(void) {
 
   CxPlatTotalMemory = CGroupGetMemoryLimit();
 
+  CxPlatLockInitialize(&CxPlatHugePageArena.Lock);
+  CxPlatLockInitialize(&CxPlatAllocTelemetry.Lock);
 
   return QUIC_STATUS_SUCCESS;
 }
 
 void CxPlatUninitialize(void) {
+  for (uint32_t i = 0; i < CxPlatHugePageArena.ChunkCount; ++i) {
+    CxPlatFreeHugePages(CxPlatHugePageArena.Chunks[i],
+                        CxPlatHugePageArena.ChunkSize);
+  }
+  CxPlatHugePageArena.ChunkCount = 0;
+  CxPlatHugePageArena.Offset = 0;
+  CxPlatHugePageSize = 0;
+  CxPlatLockUninitialize(&CxPlatHugePageArena.Lock);
+  CxPlatAllocTelemetry.Enabled = FALSE;
+  CxPlatLockUninitialize(&CxPlatAllocTelemetry.Lock);
   CxPlatCryptUninitialize();
   close(RandomFd);
 }
 
+static uint32_t CxPlatAllocTelemetryHash(_In_ uint32_t Tag) {
+  return (Tag * 0x9E3779B1u) >> 23; // 9 bits, for CXPLAT_ALLOC_TELEMETRY_HASH_SIZE
+}
+
+//
+// Returns the dense index of the tag, adding it if it's new, or UINT32_MAX if
+// the table is full.
+//
+static uint32_t CxPlatAllocTelemetryTagIndex(_In_ uint32_t Tag) {
+  CXPLAT_ALLOC_TELEMETRY *Telemetry = &CxPlatAllocTelemetry;
+  uint32_t Slot = CxPlatAllocTelemetryHash(Tag);
+  for (uint32_t i = 0; i < CXPLAT_ALLOC_TELEMETRY_HASH_SIZE; ++i) {
+    const uint16_t Entry =
+        __atomic_load_n(&Telemetry->Hash[Slot], __ATOMIC_ACQUIRE);
+    if (Entry == 0) {
+      break;
+    }
+    if (Telemetry->Tags[Entry - 1] == Tag) {
+      return Entry - 1;
+    }
+    Slot = (Slot + 1) % CXPLAT_ALLOC_TELEMETRY_HASH_SIZE;
+  }
+
+  uint32_t Index = UINT32_MAX;
+  CxPlatLockAcquire(&Telemetry->Lock);
+  Slot = CxPlatAllocTelemetryHash(Tag);
+  for (uint32_t i = 0; i < CXPLAT_ALLOC_TELEMETRY_HASH_SIZE; ++i) {
+    const uint16_t Entry = Telemetry->Hash[Slot];
+    if (Entry == 0) {
+      if (Telemetry->TagCount < CXPLAT_ALLOC_TELEMETRY_MAX_TAGS) {
+        Index = Telemetry->TagCount;
+        Telemetry->Tags[Index] = Tag;
+        Telemetry->LastQueryTimeUs[Index] = Telemetry->EnableTimeUs;
+        __atomic_store_n(&Telemetry->Hash[Slot], (uint16_t)(Index + 1),
+                         __ATOMIC_RELEASE);
+        __atomic_store_n(&Telemetry->TagCount, Index + 1, __ATOMIC_RELEASE);
+      }
+      break;
+    }
+    if (Telemetry->Tags[Entry - 1] == Tag) {
+      Index = Entry - 1;
+      break;
+    }
+    Slot = (Slot + 1) % CXPLAT_ALLOC_TELEMETRY_HASH_SIZE;
+  }
+  CxPlatLockRelease(&Telemetry->Lock);
+  return Index;
+}
+
+static int64_t CxPlatAllocTelemetryLiveBytes(_In_ uint32_t Index) {
+  int64_t Bytes = 0;
+  for (uint32_t i = 0; i < CXPLAT_ALLOC_TELEMETRY_SHARD_COUNT; ++i) {
+    Bytes += __atomic_load_n(&CxPlatAllocTelemetry.Shards[i].Tags[Index].Bytes,
+                             __ATOMIC_RELAXED);
+  }
+  //
+  // Frees of memory allocated before accounting was enabled can make the sum
+  // negative.
+  //
+  return Bytes < 0 ? 0 : Bytes;
+}
+
+static void CxPlatAllocTelemetryUpdatePeak(_In_ uint32_t Index) {
+  const uint64_t Live = (uint64_t)CxPlatAllocTelemetryLiveBytes(Index);
+  uint64_t Peak = __atomic_load_n(&CxPlatAllocTelemetry.Peak[Index],
+                                  __ATOMIC_RELAXED);
+  while (Live > Peak &&
+         !__atomic_compare_exchange_n(&CxPlatAllocTelemetry.Peak[Index], &Peak,
+                                      Live, FALSE, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+  }
+}
+
+static void CxPlatAllocTelemetryRecord(_In_ uint32_t Tag, _In_ int64_t Bytes) {
+  const uint32_t Index = CxPlatAllocTelemetryTagIndex(Tag);
+  if (Index == UINT32_MAX) {
+    return;
+  }
+  CXPLAT_ALLOC_TELEMETRY_COUNTERS *Counters =
+      &CxPlatAllocTelemetry
+           .Shards[CxPlatProcCurrentNumber() % CXPLAT_ALLOC_TELEMETRY_SHARD_COUNT]
+           .Tags[Index];
+  __atomic_add_fetch(&Counters->Bytes, Bytes, __ATOMIC_RELAXED);
+  if (Bytes > 0 &&
+      (__atomic_add_fetch(&Counters->Allocations, 1, __ATOMIC_RELAXED) &
+       CXPLAT_ALLOC_TELEMETRY_PEAK_SAMPLE_MASK) == 0) {
+    CxPlatAllocTelemetryUpdatePeak(Index);
+  }
+}
+
+#if __APPLE__
+#define CxPlatAllocUsableSize(Mem) malloc_size(Mem)
+#else
+#define CxPlatAllocUsableSize(Mem) malloc_usable_size(Mem)
+#endif
+
+BOOLEAN
+CxPlatAllocTelemetryEnable(_In_ BOOLEAN Enable) {
+  CxPlatLockAcquire(&CxPlatAllocTelemetry.Lock);
+  if (Enable && !CxPlatAllocTelemetry.Enabled) {
+    CxPlatAllocTelemetry.EnableTimeUs = CxPlatTimeUs64();
+  }
+  __atomic_store_n(&CxPlatAllocTelemetry.Enabled, Enable, __ATOMIC_RELEASE);
+  CxPlatLockRelease(&CxPlatAllocTelemetry.Lock);
+  return TRUE;
+}
+
+uint32_t CxPlatAllocTelemetryGetTagCount(void) {
+  return __atomic_load_n(&CxPlatAllocTelemetry.TagCount, __ATOMIC_ACQUIRE);
+}
+
+void CxPlatAllocTelemetryGetTag(_In_ uint32_t Index,
+                                _Out_ CXPLAT_ALLOC_TAG_STATS *Stats) {
+  CXPLAT_ALLOC_TELEMETRY *Telemetry = &CxPlatAllocTelemetry;
+  CXPLAT_DBG_ASSERT(Index < CxPlatAllocTelemetryGetTagCount());
+
+  int64_t Allocations = 0;
+  for (uint32_t i = 0; i < CXPLAT_ALLOC_TELEMETRY_SHARD_COUNT; ++i) {
+    Allocations += __atomic_load_n(&Telemetry->Shards[i].Tags[Index].Allocations,
+                                   __ATOMIC_RELAXED);
+  }
+  CxPlatAllocTelemetryUpdatePeak(Index);
+
+  Stats->Tag = Telemetry->Tags[Index];
+  Stats->LiveBytes = (uint64_t)CxPlatAllocTelemetryLiveBytes(Index);
+  Stats->PeakBytes = __atomic_load_n(&Telemetry->Peak[Index], __ATOMIC_RELAXED);
+  Stats->TotalAllocations = (uint64_t)Allocations;
+
+  CxPlatLockAcquire(&Telemetry->Lock);
+  const uint64_t Now = CxPlatTimeUs64();
+  const uint64_t ElapsedUs =
+      CxPlatTimeDiff64(Telemetry->LastQueryTimeUs[Index], Now);
+  Stats->AllocationsPerSecond =
+      ElapsedUs == 0
+          ? 0
+          : (uint32_t)((uint64_t)(Allocations -
+                                  Telemetry->LastQueryAllocations[Index]) *
+                       1000000 / ElapsedUs);
+  Telemetry->LastQueryTimeUs[Index] = Now;
+  Telemetry->LastQueryAllocations[Index] = Allocations;
+  CxPlatLockRelease(&Telemetry->Lock);
+}
+
 void *CxPlatAlloc(_In_ size_t ByteCount, _In_ uint32_t Tag) {
-  UNREFERENCED_PARAMETER(Tag);
 #ifdef DEBUG
   CXPLAT_DBG_ASSERT(ByteCount != 0);
   uint32_t Rand;
@@ -250,14 +466,172 @@ void *CxPlatAlloc(_In_ size_t ByteCount, _In_ uint32_t Tag) {
     return NULL;
   }
 #endif
-  return malloc(ByteCount);
+  void *Mem = malloc(ByteCount);
+  if (Mem != NULL &&
+      __atomic_load_n(&CxPlatAllocTelemetry.Enabled, __ATOMIC_RELAXED)) {
+    CxPlatAllocTelemetryRecord(Tag, (int64_t)CxPlatAllocUsableSize(Mem));
+  }
+  return Mem;
 }
 
 void CxPlatFree(__drv_freesMem(Mem) _Frees_ptr_ void *Mem, _In_ uint32_t Tag) {
-  UNREFERENCED_PARAMETER(Tag);
+  if (Mem != NULL &&
+      __atomic_load_n(&CxPlatAllocTelemetry.Enabled, __ATOMIC_RELAXED)) {
+    CxPlatAllocTelemetryRecord(Tag, -(int64_t)CxPlatAllocUsableSize(Mem));
+  }
   free(Mem);
 }
 
+void *CxPlatAllocNuma(_In_ size_t ByteCount, _In_ uint32_t Tag,
+                      _In_ uint16_t NumaNode) {
+  CXPLAT_DBG_ASSERT(ByteCount != 0);
+  void *Mem = NULL;
+#ifdef CXPLAT_NUMA_AWARE
+  if (NumaNode < CxPlatNumaNodeCount) {
+    Mem = numa_alloc_onnode(ByteCount, (int)NumaNode);
+  } else
+#else
+  UNREFERENCED_PARAMETER(NumaNode);
+#endif // CXPLAT_NUMA_AWARE
+  if (posix_memalign(&Mem, (size_t)getpagesize(), ByteCount) != 0) {
+    Mem = NULL;
+  }
+  if (Mem != NULL &&
+      __atomic_load_n(&CxPlatAllocTelemetry.Enabled, __ATOMIC_RELAXED)) {
+    CxPlatAllocTelemetryRecord(Tag, (int64_t)ByteCount);
+  }
+  return Mem;
+}
+
+void CxPlatFreeNuma(__drv_freesMem(Mem) _Frees_ptr_ void *Mem,
+                    _In_ size_t ByteCount, _In_ uint32_t Tag,
+                    _In_ uint16_t NumaNode) {
+  if (__atomic_load_n(&CxPlatAllocTelemetry.Enabled, __ATOMIC_RELAXED)) {
+    CxPlatAllocTelemetryRecord(Tag, -(int64_t)ByteCount);
+  }
+#ifdef CXPLAT_NUMA_AWARE
+  if (NumaNode < CxPlatNumaNodeCount) {
+    numa_free(Mem, ByteCount);
+    return;
+  }
+#else
+  UNREFERENCED_PARAMETER(NumaNode);
+#endif // CXPLAT_NUMA_AWARE
+  UNREFERENCED_PARAMETER(ByteCount);
+  free(Mem);
+}
+
+void CxPlatHugePagesConfigure(_In_ uint32_t PageSize) {
+  CxPlatLockAcquire(&CxPlatHugePageArena.Lock);
+  if (CxPlatHugePageArena.ChunkCount == 0) {
+    //
+    // The chunk size can only change while the arena is empty.
+    //
+    CxPlatHugePageSize = PageSize;
+    CxPlatHugePageArena.ChunkSize =
+        CXPLAT_MAX(PageSize, CXPLAT_HUGE_PAGE_ARENA_2MB_CHUNK_SIZE);
+  }
+  CxPlatLockRelease(&CxPlatHugePageArena.Lock);
+}
+
+static size_t CxPlatHugePagesRoundUp(_In_ size_t ByteCount,
+                                     _In_ size_t PageSize) {
+  return (ByteCount + PageSize - 1) & ~(PageSize - 1);
+}
+
+void *CxPlatAllocHugePages(_In_ size_t ByteCount) {
+  CXPLAT_DBG_ASSERT(ByteCount != 0);
+  const size_t PageSize = CxPlatHugePageSize;
+  if (PageSize == 0 || ByteCount < PageSize / 2) {
+    //
+    // Disabled, or too small to be worth rounding up to a whole huge page.
+    //
+    return NULL;
+  }
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  const size_t Length = CxPlatHugePagesRoundUp(ByteCount, PageSize);
+  int SizeFlag = 0;
+  for (size_t i = PageSize; i > 1; i >>= 1) {
+    ++SizeFlag;
+  }
+  void *Mem = mmap(NULL, Length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                       (SizeFlag << MAP_HUGE_SHIFT),
+                   -1, 0);
+  if (Mem != MAP_FAILED) {
+    return Mem;
+  }
+
+  //
+  // No (or not enough) reserved huge pages. Fall back to transparent huge
+  // pages, which only apply to 2 MiB aligned ranges.
+  //
+  Mem = mmap(NULL, Length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+             -1, 0);
+  if (Mem == MAP_FAILED) {
+    return NULL;
+  }
+#ifdef MADV_HUGEPAGE
+  (void)madvise(Mem, Length, MADV_HUGEPAGE);
+#endif
+  return Mem;
+#else
+  UNREFERENCED_PARAMETER(ByteCount);
+  return NULL;
+#endif
+}
+
+void CxPlatFreeHugePages(_In_ void *Mem, _In_ size_t ByteCount) {
+  CXPLAT_DBG_ASSERT(CxPlatHugePageSize != 0);
+  munmap(Mem, CxPlatHugePagesRoundUp(ByteCount, CxPlatHugePageSize));
+}
+
+void *CxPlatHugePageArenaAlloc(_In_ uint32_t ByteCount) {
+  CXPLAT_HUGE_PAGE_ARENA *Arena = &CxPlatHugePageArena;
+  void *Mem = NULL;
+  const size_t Length =
+      CxPlatHugePagesRoundUp(ByteCount, CXPLAT_MEMORY_ALIGNMENT);
+
+  if (CxPlatHugePageSize == 0 || Length > Arena->ChunkSize) {
+    return NULL;
+  }
+
+  CxPlatLockAcquire(&Arena->Lock);
+  if (Arena->ChunkCount == 0 || Arena->Offset + Length > Arena->ChunkSize) {
+    if (Arena->ChunkCount == CXPLAT_HUGE_PAGE_ARENA_MAX_CHUNKS) {
+      goto Exit;
+    }
+    uint8_t *Chunk = CxPlatAllocHugePages(Arena->ChunkSize);
+    if (Chunk == NULL) {
+      goto Exit;
+    }
+    Arena->Chunks[Arena->ChunkCount] = Chunk;
+    __atomic_store_n(&Arena->ChunkCount, Arena->ChunkCount + 1,
+                     __ATOMIC_RELEASE);
+    Arena->Offset = 0;
+  }
+  Mem = Arena->Chunks[Arena->ChunkCount - 1] + Arena->Offset;
+  Arena->Offset += Length;
+
+Exit:
+  CxPlatLockRelease(&Arena->Lock);
+  return Mem;
+}
+
+BOOLEAN
+CxPlatHugePageArenaContains(_In_ const void *Mem) {
+  const CXPLAT_HUGE_PAGE_ARENA *Arena = &CxPlatHugePageArena;
+  const uint32_t ChunkCount =
+      __atomic_load_n(&Arena->ChunkCount, __ATOMIC_ACQUIRE);
+  for (uint32_t i = 0; i < ChunkCount; ++i) {
+    if ((const uint8_t *)Mem >= Arena->Chunks[i] &&
+        (const uint8_t *)Mem < Arena->Chunks[i] + Arena->ChunkSize) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
 void CxPlatRefInitialize(_Inout_ CXPLAT_REF_COUNT *RefCount) { *RefCount = 1; }
 
 void CxPlatRefInitializeEx(_Inout_ CXPLAT_REF_COUNT *RefCount,
@@ -434,6 +808,20 @@ uint32_t CxPlatProcCurrentNumber(void) {
 #endif // CX_PLATFORM_DARWIN
 }
 
+uint16_t CxPlatProcNumaNode(_In_ uint32_t Processor) {
+#ifdef CXPLAT_NUMA_AWARE
+  if (CxPlatNumaNodeCount != 0) {
+    int Node = numa_node_of_cpu((int)Processor);
+    if (Node >= 0) {
+      return (uint16_t)Node;
+    }
+  }
+#else
+  UNREFERENCED_PARAMETER(Processor);
+#endif // CXPLAT_NUMA_AWARE
+  return 0;
+}
+
 QUIC_STATUS
 CxPlatRandom(_In_ uint32_t BufferLen,
              _Out_writes_bytes_(BufferLen) void *Buffer) {
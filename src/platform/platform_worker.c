@@ -73,11 +73,33 @@ typedef struct QUIC_CACHEALIGN CXPLAT_WORKER {
     uint64_t CqeCount;
 #endif
 
+    //
+    // Time (in us) to keep polling without work before blocking, when busy
+    // polling.
+    //
+    uint32_t SpinBudgetUs;
+
+    //
+    // Poll statistics, only tracked when busy polling.
+    //
+    uint64_t BusyTimeUs;
+    uint64_t SpinTimeUs;
+    uint64_t IdleTimeUs;
+
     //
     // The ideal processor for the worker thread.
     //
     uint16_t IdealProcessor;
 
+#ifdef CXPLAT_USE_IO_URING
+    //
+    // The SQPOLL configuration for the event queue, when SqPoll is set.
+    //
+    CXPLAT_EVENTQ* SqPollAttachQueue;
+    uint32_t SqPollProcessor;
+    uint32_t SqPollIdleMs;
+#endif
+
     //
     // Flags to indicate what has been initialized.
     //
@@ -90,6 +112,10 @@ typedef struct QUIC_CACHEALIGN CXPLAT_WORKER {
     BOOLEAN StoppingThread : 1;
     BOOLEAN StoppedThread : 1;
     BOOLEAN DestroyedThread : 1;
+    BOOLEAN BusyPoll : 1;
+#ifdef CXPLAT_USE_IO_URING
+    BOOLEAN SqPoll : 1;
+#endif
 #if DEBUG // Debug flags - Must not be in the bitfield.
     BOOLEAN ThreadStarted;
     BOOLEAN ThreadFinished;
@@ -176,7 +202,19 @@ CxPlatWorkerPoolInitWorker(
     if (EventQ != NULL) {
         Worker->EventQ = *EventQ;
     } else {
-        if (!CxPlatEventQInitialize(&Worker->EventQ)) {
+#ifdef CXPLAT_USE_IO_URING
+        const BOOLEAN Initialized =
+            Worker->SqPoll ?
+                CxPlatEventQInitializeSqPoll(
+                    &Worker->EventQ,
+                    Worker->SqPollAttachQueue,
+                    Worker->SqPollProcessor,
+                    Worker->SqPollIdleMs) :
+                CxPlatEventQInitialize(&Worker->EventQ);
+#else
+        const BOOLEAN Initialized = CxPlatEventQInitialize(&Worker->EventQ);
+#endif
+        if (!Initialized) {
             return FALSE;
         }
         Worker->InitializedEventQ = TRUE;
@@ -245,6 +283,31 @@ CxPlatWorkerPoolDestroyWorker(
     }
 }
 
+#ifdef CXPLAT_USE_IO_URING
+//
+// Returns the first processor not used by any worker, to dedicate to the
+// SQPOLL thread, or UINT32_MAX if there is none.
+//
+static
+uint32_t
+CxPlatWorkerPoolGetSqPollProcessor(
+    _In_reads_opt_(ProcessorCount) const uint16_t* ProcessorList,
+    _In_ uint32_t ProcessorCount
+    )
+{
+    for (uint32_t Processor = 0; Processor < CxPlatProcCount(); ++Processor) {
+        BOOLEAN Used = ProcessorList == NULL && Processor < ProcessorCount;
+        for (uint32_t i = 0; ProcessorList != NULL && i < ProcessorCount && !Used; ++i) {
+            Used = ProcessorList[i] == Processor;
+        }
+        if (!Used) {
+            return Processor;
+        }
+    }
+    return UINT32_MAX;
+}
+#endif
+
 CXPLAT_WORKER_POOL*
 CxPlatWorkerPoolCreate(
     _In_opt_ QUIC_GLOBAL_EXECUTION_CONFIG* Config,
@@ -314,6 +377,24 @@ CxPlatWorkerPoolCreate(
         CXPLAT_DBG_ASSERT(IdealProcessor < CxPlatProcCount());
 
         CXPLAT_WORKER* Worker = &WorkerPool->Workers[i];
+        if (Config &&
+            (Config->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL) &&
+            Config->PollingIdleTimeoutUs != 0) {
+            Worker->BusyPoll = TRUE;
+            Worker->SpinBudgetUs = Config->PollingIdleTimeoutUs;
+        }
+#ifdef CXPLAT_USE_IO_URING
+        if (Config && (Config->Flags & QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_URING_SQPOLL)) {
+            //
+            // All the workers' rings share the SQPOLL thread of the first one.
+            //
+            Worker->SqPoll = TRUE;
+            Worker->SqPollAttachQueue = i == 0 ? NULL : &WorkerPool->Workers[0].EventQ;
+            Worker->SqPollProcessor =
+                CxPlatWorkerPoolGetSqPollProcessor(ProcessorList, ProcessorCount);
+            Worker->SqPollIdleMs = Config->PollingIdleTimeoutUs / 1000;
+        }
+#endif
         if (!CxPlatWorkerPoolInitWorker(
                 Worker, IdealProcessor, NULL, &ThreadConfig)) {
             goto Error;
@@ -489,6 +570,21 @@ CxPlatWorkerPoolGetIdealProcessor(
     return WorkerPool->Workers[Index].IdealProcessor;
 }
 
+void
+CxPlatWorkerPoolGetPollStatistics(
+    _In_ CXPLAT_WORKER_POOL* WorkerPool,
+    _In_ uint32_t Index,
+    _Out_ QUIC_WORKER_POLL_STATISTICS* Statistics
+    )
+{
+    CXPLAT_DBG_ASSERT(WorkerPool);
+    CXPLAT_FRE_ASSERT(Index < WorkerPool->WorkerCount);
+    const CXPLAT_WORKER* Worker = &WorkerPool->Workers[Index];
+    Statistics->BusyTimeUs = Worker->BusyTimeUs;
+    Statistics->SpinTimeUs = Worker->SpinTimeUs;
+    Statistics->IdleTimeUs = Worker->IdleTimeUs;
+}
+
 CXPLAT_EVENTQ*
 CxPlatWorkerPoolGetEventQ(
     _In_ CXPLAT_WORKER_POOL* WorkerPool,
@@ -639,7 +735,6 @@ CxPlatWorkerPoolWorkerPoll(
 }
 
 #define DYNAMIC_POOL_PROCESSING_PERIOD  1000000 // 1 second
-#define DYNAMIC_POOL_PRUNE_COUNT        8
 
 void
 CxPlatAddDynamicPoolAllocator(
@@ -652,6 +747,12 @@ CxPlatAddDynamicPoolAllocator(
     CXPLAT_FRE_ASSERT(Index < WorkerPool->WorkerCount);
     CXPLAT_WORKER* Worker = &WorkerPool->Workers[Index];
     Pool->Owner = Worker;
+    Pool->Policy.LowWatermark = 0;
+    Pool->Policy.HighWatermark = UINT32_MAX;
+    Pool->Policy.PruneCount = CXPLAT_POOL_EX_DEFAULT_PRUNE_COUNT;
+    Pool->Policy.DecayPercent = 0;
+    Pool->AllocCount = 0;
+    Pool->PruneCount = 0;
     CxPlatLockAcquire(&Worker->ECLock);
     CxPlatListInsertTail(&Worker->DynamicPoolList, &Pool->Link);
     CxPlatLockRelease(&Worker->ECLock);
@@ -668,15 +769,71 @@ CxPlatRemoveDynamicPoolAllocator(
     CxPlatLockRelease(&Worker->ECLock);
 }
 
+QUIC_STATUS
+CxPlatDynamicPoolSetPolicy(
+    _Inout_ CXPLAT_POOL_EX* Pool,
+    _In_ const CXPLAT_POOL_EX_POLICY* Policy
+    )
+{
+    if (Policy->LowWatermark > Policy->HighWatermark ||
+        Policy->DecayPercent > 100) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    CXPLAT_WORKER* Worker = (CXPLAT_WORKER*)Pool->Owner;
+    CxPlatLockAcquire(&Worker->ECLock);
+    Pool->Policy = *Policy;
+    CxPlatLockRelease(&Worker->ECLock);
+    return QUIC_STATUS_SUCCESS;
+}
+
+void
+CxPlatDynamicPoolGetStats(
+    _In_ CXPLAT_POOL_EX* Pool,
+    _Out_ CXPLAT_POOL_EX_STATS* Stats
+    )
+{
+    CXPLAT_WORKER* Worker = (CXPLAT_WORKER*)Pool->Owner;
+    CxPlatLockAcquire(&Worker->ECLock);
+    Stats->FreeDepth = CxPlatPoolGetDepth(&Pool->Base);
+    Stats->AllocCount = (uint64_t)Pool->AllocCount;
+    Stats->MissCount = (uint64_t)Pool->Base.MissCount;
+    Stats->PruneCount = Pool->PruneCount;
+    CxPlatLockRelease(&Worker->ECLock);
+}
+
 void
 CxPlatProcessDynamicPoolAllocator(
     _Inout_ CXPLAT_POOL_EX* Pool
     )
 {
-    for (uint32_t i = 0; i < DYNAMIC_POOL_PRUNE_COUNT; ++i) {
+    const CXPLAT_POOL_EX_POLICY* Policy = &Pool->Policy;
+    const uint32_t Depth = CxPlatPoolGetDepth(&Pool->Base);
+    if (Depth <= Policy->LowWatermark) {
+        return;
+    }
+
+    //
+    // Everything above the high watermark goes right away, and then a share of
+    // what's left above the low watermark decays.
+    //
+    uint32_t Count = 0;
+    if (Depth > Policy->HighWatermark) {
+        Count = Depth - Policy->HighWatermark;
+    }
+    const uint32_t Excess = Depth - Count - Policy->LowWatermark;
+    uint32_t DecayCount =
+        (uint32_t)(((uint64_t)Excess * Policy->DecayPercent) / 100);
+    if (DecayCount < Policy->PruneCount) {
+        DecayCount = CXPLAT_MIN(Policy->PruneCount, Excess);
+    }
+    Count += DecayCount;
+
+    for (uint32_t i = 0; i < Count; ++i) {
         if (!CxPlatPoolPrune((CXPLAT_POOL*)Pool)) {
             return;
         }
+        Pool->PruneCount++;
     }
 }
 
@@ -702,12 +859,17 @@ CxPlatProcessEvents(
     )
 {
     CXPLAT_CQE Cqes[16];
+    const uint64_t WaitStart =
+        Worker->BusyPoll && Worker->State.WaitTime != 0 ? CxPlatTimeUs64() : 0;
     uint32_t CqeCount =
         CxPlatEventQDequeue(
             &Worker->EventQ,
             Cqes,
             ARRAYSIZE(Cqes),
             Worker->State.WaitTime);
+    if (WaitStart != 0) {
+        Worker->IdleTimeUs += CxPlatTimeDiff64(WaitStart, CxPlatTimeUs64());
+    }
     uint32_t CurrentCqeCount = CqeCount;
     CXPLAT_CQE* CurrentCqe = Cqes;
 
@@ -749,6 +911,22 @@ CxPlatProcessEvents(
 //
 #define CXPLAT_WORKER_IDLE_WORK_THRESHOLD_COUNT 10
 
+//
+// Returns TRUE if the worker is busy polling and hasn't run out of its spin
+// budget since it last found work.
+//
+QUIC_INLINE
+BOOLEAN
+CxPlatWorkerIsSpinning(
+    _In_ const CXPLAT_WORKER* Worker
+    )
+{
+    return
+        Worker->BusyPoll &&
+        CxPlatTimeDiff64(Worker->State.LastWorkTime, Worker->State.TimeNow) <
+            Worker->SpinBudgetUs;
+}
+
 CXPLAT_THREAD_CALLBACK(CxPlatWorkerThread, Context)
 {
     CXPLAT_WORKER* Worker = (CXPLAT_WORKER*)Context;
@@ -768,6 +946,8 @@ CXPLAT_THREAD_CALLBACK(CxPlatWorkerThread, Context)
         ++Worker->LoopCount;
 #endif
         Worker->State.TimeNow = CxPlatTimeUs64();
+        const uint64_t LoopStart = Worker->State.TimeNow;
+        const uint64_t IdleTimeUs = Worker->IdleTimeUs;
 
         CxPlatRunExecutionContexts(Worker);
         if (Worker->State.WaitTime && InterlockedFetchAndClearBoolean(&Worker->Running)) {
@@ -775,12 +955,33 @@ CXPLAT_THREAD_CALLBACK(CxPlatWorkerThread, Context)
             CxPlatRunExecutionContexts(Worker); // Run once more to handle race conditions
         }
 
+        if (Worker->State.WaitTime != 0 && CxPlatWorkerIsSpinning(Worker)) {
+            //
+            // Keep polling the event queue (and with it the datapath) instead
+            // of blocking, until the spin budget runs out.
+            //
+            Worker->State.WaitTime = 0;
+        }
+
         CxPlatProcessEvents(Worker);
 
+        if (Worker->BusyPoll) {
+            const uint64_t Elapsed =
+                CxPlatTimeDiff64(LoopStart, CxPlatTimeUs64()) -
+                (Worker->IdleTimeUs - IdleTimeUs);
+            if (Worker->State.NoWorkCount == 0) {
+                Worker->BusyTimeUs += Elapsed;
+            } else {
+                Worker->SpinTimeUs += Elapsed;
+            }
+        }
+
         if (Worker->State.NoWorkCount == 0) {
             Worker->State.LastWorkTime = Worker->State.TimeNow;
         } else if (Worker->State.NoWorkCount > CXPLAT_WORKER_IDLE_WORK_THRESHOLD_COUNT) {
-            CxPlatSchedulerYield();
+            if (!CxPlatWorkerIsSpinning(Worker)) {
+                CxPlatSchedulerYield();
+            }
             Worker->State.NoWorkCount = 0;
         }
 
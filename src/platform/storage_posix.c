@@ -14,6 +14,10 @@ Environment:
 --*/
 
 #include "platform_internal.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 QUIC_STATUS
@@ -101,3 +105,238 @@ CxPlatStorageClear(
     UNREFERENCED_PARAMETER(Storage);
     return QUIC_STATUS_NOT_SUPPORTED;
 }
+
+typedef struct CXPLAT_STORAGE_FILE {
+
+    //
+    // Opened for appending.
+    //
+    int Fd;
+
+    //
+    // The path, followed by the path of the temporary file used by
+    // CxPlatStorageFileReplace.
+    //
+    char* Path;
+    char* TempPath;
+
+} CXPLAT_STORAGE_FILE;
+
+static
+QUIC_STATUS
+CxPlatStorageFileWriteAll(
+    _In_ int Fd,
+    _In_ uint32_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    )
+{
+    while (Length != 0) {
+        ssize_t Written = write(Fd, Buffer, Length);
+        if (Written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (QUIC_STATUS)errno;
+        }
+        Buffer += Written;
+        Length -= (uint32_t)Written;
+    }
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileOpen(
+    _In_z_ const char * Path,
+    _Out_ CXPLAT_STORAGE_FILE** NewFile
+    )
+{
+    const size_t PathLength = strlen(Path);
+    const size_t AllocLength =
+        sizeof(CXPLAT_STORAGE_FILE) + (PathLength + 1) + (PathLength + sizeof(".tmp"));
+    CXPLAT_STORAGE_FILE* File =
+        CXPLAT_ALLOC_PAGED(AllocLength, QUIC_POOL_STORAGE_FILE);
+    if (File == NULL) {
+        return QUIC_STATUS_OUT_OF_MEMORY;
+    }
+
+    File->Path = (char*)(File + 1);
+    CxPlatCopyMemory(File->Path, Path, PathLength + 1);
+    File->TempPath = File->Path + PathLength + 1;
+    CxPlatCopyMemory(File->TempPath, Path, PathLength);
+    CxPlatCopyMemory(File->TempPath + PathLength, ".tmp", sizeof(".tmp"));
+
+    File->Fd = open(Path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (File->Fd < 0) {
+        QUIC_STATUS Status = (QUIC_STATUS)errno;
+        CXPLAT_FREE(File, QUIC_POOL_STORAGE_FILE);
+        return Status;
+    }
+
+    *NewFile = File;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatStorageFileClose(
+    _In_opt_ _Post_invalid_ CXPLAT_STORAGE_FILE* File
+    )
+{
+    if (File != NULL) {
+        close(File->Fd);
+        CXPLAT_FREE(File, QUIC_POOL_STORAGE_FILE);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileMap(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _Outptr_result_buffer_maybenull_(*Length)
+        const uint8_t** Data,
+    _Out_ uint64_t* Length
+    )
+{
+    *Data = NULL;
+    *Length = 0;
+
+    struct stat Stat;
+    if (fstat(File->Fd, &Stat) != 0) {
+        return (QUIC_STATUS)errno;
+    }
+    if (Stat.st_size == 0) {
+        return QUIC_STATUS_SUCCESS;
+    }
+
+    void* Mapping = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, File->Fd, 0);
+    if (Mapping == MAP_FAILED) {
+        return (QUIC_STATUS)errno;
+    }
+
+    *Data = (const uint8_t*)Mapping;
+    *Length = (uint64_t)Stat.st_size;
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatStorageFileUnmap(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _In_opt_ const uint8_t* Data,
+    _In_ uint64_t Length
+    )
+{
+    UNREFERENCED_PARAMETER(File);
+    if (Data != NULL) {
+        munmap((void*)Data, (size_t)Length);
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatFileRangeMap(
+    _In_ QUIC_FILE_HANDLE File,
+    _In_ uint64_t Offset,
+    _In_ uint32_t Length,
+    _Out_ CXPLAT_FILE_RANGE* Range
+    )
+{
+    CxPlatZeroMemory(Range, sizeof(*Range));
+
+    //
+    // Touching mapped pages past the end of the file raises SIGBUS, so the
+    // range is checked against the file's current size first.
+    //
+    struct stat Stat;
+    if (fstat(File, &Stat) != 0) {
+        return (QUIC_STATUS)errno;
+    }
+    if (Length == 0 || Offset > (uint64_t)Stat.st_size ||
+        Length > (uint64_t)Stat.st_size - Offset) {
+        return QUIC_STATUS_INVALID_PARAMETER;
+    }
+
+    const uint64_t PageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+    const uint64_t MappingOffset = Offset - (Offset % PageSize);
+    const size_t MappingLength = (size_t)(Offset - MappingOffset + Length);
+
+    void* Mapping =
+        mmap(NULL, MappingLength, PROT_READ, MAP_PRIVATE, File, (off_t)MappingOffset);
+    if (Mapping == MAP_FAILED) {
+        return (QUIC_STATUS)errno;
+    }
+    (void)madvise(Mapping, MappingLength, MADV_SEQUENTIAL);
+
+    Range->Mapping = Mapping;
+    Range->MappingLength = MappingLength;
+    Range->Data = (const uint8_t*)Mapping + (Offset - MappingOffset);
+    return QUIC_STATUS_SUCCESS;
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+void
+CxPlatFileRangeUnmap(
+    _In_ CXPLAT_FILE_RANGE* Range
+    )
+{
+    if (Range->Mapping != NULL) {
+        munmap(Range->Mapping, Range->MappingLength);
+        Range->Mapping = NULL;
+    }
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileAppend(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _In_ uint32_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    )
+{
+    return CxPlatStorageFileWriteAll(File->Fd, Length, Buffer);
+}
+
+_IRQL_requires_max_(PASSIVE_LEVEL)
+QUIC_STATUS
+CxPlatStorageFileReplace(
+    _In_ CXPLAT_STORAGE_FILE* File,
+    _In_ uint32_t Length,
+    _In_reads_bytes_(Length)
+        const uint8_t* Buffer
+    )
+{
+    //
+    // Write the new contents to a temporary file and rename it over the old
+    // one, so a crash never leaves a partially written file behind.
+    //
+    int TempFd = open(File->TempPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (TempFd < 0) {
+        return (QUIC_STATUS)errno;
+    }
+
+    QUIC_STATUS Status = CxPlatStorageFileWriteAll(TempFd, Length, Buffer);
+    if (QUIC_SUCCEEDED(Status) && fsync(TempFd) != 0) {
+        Status = (QUIC_STATUS)errno;
+    }
+    close(TempFd);
+
+    if (QUIC_SUCCEEDED(Status) && rename(File->TempPath, File->Path) != 0) {
+        Status = (QUIC_STATUS)errno;
+    }
+    if (QUIC_FAILED(Status)) {
+        unlink(File->TempPath);
+        return Status;
+    }
+
+    int NewFd = open(File->Path, O_RDWR | O_APPEND | O_CLOEXEC);
+    if (NewFd < 0) {
+        return (QUIC_STATUS)errno;
+    }
+    close(File->Fd);
+    File->Fd = NewFd;
+
+    return QUIC_STATUS_SUCCESS;
+}
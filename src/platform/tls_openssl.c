@@ -65,6 +65,11 @@ typedef struct CXPLAT_SEC_CONFIG {
     //
     CXPLAT_TLS_CREDENTIAL_FLAGS TlsFlags;
 
+    //
+    // Recently validated peer certificates (client only).
+    //
+    CXPLAT_CERT_CACHE CertCache;
+
 } CXPLAT_SEC_CONFIG;
 
 //
@@ -800,6 +805,19 @@ const size_t OpenSslFilePrefixLength = sizeof("..\\..\\..\\..\\..\\..\\submodule
 
 #define PFX_PASSWORD_LENGTH 33
 
+//
+// Certificate compression (RFC 8879) needs OpenSSL 3.2 or newer, built with at
+// least one compression algorithm.
+//
+#if defined(TLSEXT_comp_cert_none) && !defined(OPENSSL_NO_COMP_ALG)
+#define CXPLAT_TLS_CERT_COMPRESSION
+static int CxPlatTlsCertCompressionAlgs[] = {
+    TLSEXT_comp_cert_brotli,
+    TLSEXT_comp_cert_zstd,
+    TLSEXT_comp_cert_zlib
+};
+#endif
+
 //
 // Default list of Cipher used.
 //
@@ -984,6 +1002,20 @@ CxPlatTlsCertificateVerifyCallback(
             if (!CertificateVerified) {
                 X509_STORE_CTX_set_error(X509Ctx, X509_V_ERR_CERT_REJECTED);
             }
+        } else if ((TlsContext->SecConfig->Flags &
+                    (QUIC_CREDENTIAL_FLAG_CLIENT |
+                     QUIC_CREDENTIAL_FLAG_INDICATE_CERTIFICATE_RECEIVED |
+                     QUIC_CREDENTIAL_FLAG_DEFER_CERTIFICATE_VALIDATION)) ==
+                    QUIC_CREDENTIAL_FLAG_CLIENT) {
+            //
+            // Nothing but the verdict is needed, so a recently validated
+            // certificate can be taken from the cache.
+            //
+            CertificateVerified =
+                CxPlatCertCacheVerify(
+                    &TlsContext->SecConfig->CertCache,
+                    X509Ctx,
+                    TlsContext->SNI);
         } else {
             CertificateVerified = X509_verify_cert(X509Ctx);
 
@@ -1147,7 +1179,7 @@ CxPlatTlsClientHelloCallback(
 // @brief Callback invoked when a TLS session ticket is received by the client.
 //
 // This function is called by OpenSSL when the server issues a session
-// ticket to the client. It serializes the session into PEM format and
+// ticket to the client. It serializes the session into DER format and
 // passes the data to the QUIC layer using the registered
 // @c ReceiveTicket callback.
 //
@@ -1169,22 +1201,22 @@ CxPlatTlsOnClientSessionTicketReceived(
 {
     CXPLAT_TLS* TlsContext = SSL_get_app_data(Ssl);
 
-    BIO* Bio = BIO_new(BIO_s_mem());
-    if (Bio) {
-        if (PEM_write_bio_SSL_SESSION(Bio, Session) == 1) {
-            uint8_t* Data = NULL;
-            long Length = BIO_get_mem_data(Bio, &Data);
-            if (Length < UINT16_MAX) {
+    //
+    // The session is passed up in its (binary) DER encoding.
+    //
+    int Length = i2d_SSL_SESSION(Session, NULL);
+    if (Length > 0 && Length < UINT16_MAX) {
+        uint8_t* Data = CXPLAT_ALLOC_NONPAGED((size_t)Length, QUIC_POOL_TLS_BUFFER);
+        if (Data != NULL) {
+            uint8_t* End = Data;
+            if (i2d_SSL_SESSION(Session, &End) == Length) {
                 TlsContext->SecConfig->Callbacks.ReceiveTicket(
                     TlsContext->Connection,
                     (uint32_t)Length,
                     Data);
-            } else {
             }
-        } else {
+            CXPLAT_FREE(Data, QUIC_POOL_TLS_BUFFER);
         }
-        BIO_free(Bio);
-    } else {
     }
 
     //
@@ -1599,6 +1631,7 @@ CxPlatTlsSecConfigCreate(
     CXPLAT_SEC_CONFIG* SecurityConfig = NULL;
     X509* X509Cert = NULL;
     EVP_PKEY* PrivateKey = NULL;
+    STACK_OF(X509)* CaCertificates = NULL;
     char* CipherSuiteString = NULL;
 
     //
@@ -1612,6 +1645,7 @@ CxPlatTlsSecConfigCreate(
     }
 
     CxPlatZeroMemory(SecurityConfig, sizeof(CXPLAT_SEC_CONFIG));
+    CxPlatCertCacheInitialize(&SecurityConfig->CertCache);
     SecurityConfig->Callbacks = *TlsCallbacks;
     SecurityConfig->Flags = CredConfigFlags;
     SecurityConfig->TlsFlags = TlsCredFlags;
@@ -1642,6 +1676,17 @@ CxPlatTlsSecConfigCreate(
         goto Exit;
     }
 
+#ifdef CXPLAT_TLS_CERT_COMPRESSION
+    //
+    // Prefer the better compressing algorithms for certificate compression
+    // (RFC 8879). Those OpenSSL wasn't built with are ignored.
+    //
+    (void)SSL_CTX_set1_cert_comp_preference(
+        SecurityConfig->SSLCtx,
+        CxPlatTlsCertCompressionAlgs,
+        ARRAYSIZE(CxPlatTlsCertCompressionAlgs));
+#endif
+
     char* CipherSuites = CXPLAT_TLS_DEFAULT_SSL_CIPHERS;
     if (CredConfigFlags & QUIC_CREDENTIAL_FLAG_SET_ALLOWED_CIPHER_SUITES) {
         //
@@ -1858,19 +1903,8 @@ CxPlatTlsSecConfigCreate(
             goto Exit;
         }
 
-        STACK_OF(X509) *CaCertificates = NULL;
         Ret =
             PKCS12_parse(Pkcs12, Password, &PrivateKey, &X509Cert, &CaCertificates);
-        if (CaCertificates) {
-            X509* CaCert;
-            while ((CaCert = sk_X509_pop(CaCertificates)) != NULL) {
-                //
-                // This transfers ownership to SSLCtx and CaCert does not need to be freed.
-                //
-                SSL_CTX_add_extra_chain_cert(SecurityConfig->SSLCtx, CaCert);
-            }
-            sk_X509_free(CaCertificates);
-        }
         if (Pkcs12) {
             PKCS12_free(Pkcs12);
         }
@@ -1900,6 +1934,23 @@ CxPlatTlsSecConfigCreate(
             Status = QUIC_STATUS_TLS_ERROR;
             goto Exit;
         }
+
+        //
+        // The PKCS12 CA certificates become the certificate's own chain, so
+        // that building the chain below can use them.
+        //
+        X509* CaCert;
+        while (CaCertificates != NULL &&
+               (CaCert = sk_X509_shift(CaCertificates)) != NULL) {
+            //
+            // This transfers ownership to SSLCtx on success.
+            //
+            if (SSL_CTX_add0_chain_cert(SecurityConfig->SSLCtx, CaCert) != 1) {
+                X509_free(CaCert);
+                Status = QUIC_STATUS_TLS_ERROR;
+                goto Exit;
+            }
+        }
     }
 
     if (CredConfig->Type != QUIC_CREDENTIAL_TYPE_NONE) {
@@ -1945,6 +1996,37 @@ CxPlatTlsSecConfigCreate(
         SSL_CTX_clear_options(SecurityConfig->SSLCtx, SSL_OP_ENABLE_MIDDLEBOX_COMPAT);
         SSL_CTX_set_mode(SecurityConfig->SSLCtx, SSL_MODE_RELEASE_BUFFERS);
 
+        if (CredConfig->Type != QUIC_CREDENTIAL_TYPE_NONE) {
+            //
+            // Build the certificate chain once, now, instead of letting each
+            // handshake look it up in the store. Intermediates come from the
+            // certificate's own chain (the chain file, or the PKCS12 CA
+            // certificates) and the store; extra chain certificates are not
+            // used. The root is left out since the peer must already have it.
+            // If the chain can't be completed, what was found is still served.
+            //
+            Ret =
+                SSL_CTX_build_cert_chain(
+                    SecurityConfig->SSLCtx,
+                    SSL_BUILD_CHAIN_FLAG_UNTRUSTED |
+                    SSL_BUILD_CHAIN_FLAG_NO_ROOT |
+                    SSL_BUILD_CHAIN_FLAG_IGNORE_ERROR |
+                    SSL_BUILD_CHAIN_FLAG_CLEAR_ERROR);
+            if (Ret != 0) {
+                SSL_CTX_set_mode(SecurityConfig->SSLCtx, SSL_MODE_NO_AUTO_CHAIN);
+            }
+
+#ifdef CXPLAT_TLS_CERT_COMPRESSION
+            //
+            // Compress the chain once per configuration, now, so handshakes
+            // don't pay for it. A compressed chain keeps the first server
+            // flight under the anti-amplification limit. The chain goes out
+            // uncompressed if this fails or the client doesn't support it.
+            //
+            (void)SSL_CTX_compress_certs(SecurityConfig->SSLCtx, 0);
+#endif
+        }
+
         if (CredConfigFlags & QUIC_CREDENTIAL_FLAG_INDICATE_CERTIFICATE_RECEIVED ||
             CredConfigFlags & QUIC_CREDENTIAL_FLAG_REQUIRE_CLIENT_AUTHENTICATION) {
             SSL_CTX_set_cert_verify_callback(
@@ -2007,6 +2089,10 @@ Exit:
         EVP_PKEY_free(PrivateKey);
     }
 
+    if (CaCertificates != NULL) {
+        sk_X509_pop_free(CaCertificates, X509_free);
+    }
+
     return Status;
 }
 
@@ -2043,6 +2129,7 @@ CxPlatTlsSecConfigDelete(
         CXPLAT_FREE(SecurityConfig->TicketKey, QUIC_POOL_TLS_TICKET_KEY);
     }
 
+    CxPlatCertCacheUninitialize(&SecurityConfig->CertCache);
     CXPLAT_FREE(SecurityConfig, QUIC_POOL_TLS_SECCONF);
 }
 
@@ -2346,20 +2433,27 @@ CxPlatTlsInitialize(
         if (Config->ResumptionTicketLength != 0) {
             CXPLAT_DBG_ASSERT(Config->ResumptionTicketBuffer != NULL);
 
-            BIO* Bio =
-                BIO_new_mem_buf(
-                    Config->ResumptionTicketBuffer,
-                    (int)Config->ResumptionTicketLength);
-            if (Bio) {
-                SSL_SESSION* Session = PEM_read_bio_SSL_SESSION(Bio, NULL, 0, NULL);
-                if (Session) {
-                    if (!SSL_set_session(TlsContext->Ssl, Session)) {
-                    }
-                    SSL_SESSION_free(Session);
-                } else {
+            SSL_SESSION* Session = NULL;
+            if (Config->ResumptionTicketBuffer[0] == '-') {
+                //
+                // Tickets from older versions are PEM encoded.
+                //
+                BIO* Bio =
+                    BIO_new_mem_buf(
+                        Config->ResumptionTicketBuffer,
+                        (int)Config->ResumptionTicketLength);
+                if (Bio) {
+                    Session = PEM_read_bio_SSL_SESSION(Bio, NULL, 0, NULL);
+                    BIO_free(Bio);
                 }
-                BIO_free(Bio);
             } else {
+                const uint8_t* Data = Config->ResumptionTicketBuffer;
+                Session = d2i_SSL_SESSION(NULL, &Data, (long)Config->ResumptionTicketLength);
+            }
+            if (Session) {
+                if (!SSL_set_session(TlsContext->Ssl, Session)) {
+                }
+                SSL_SESSION_free(Session);
             }
         }
 
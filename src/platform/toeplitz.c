@@ -44,10 +44,142 @@ Notes:
     is, no byte need be processed partially in the array passed in by the
     caller.
 
+    Where the CPU supports a 64-bit carry-less multiply (PCLMULQDQ on x64,
+    PMULL on ARM64), the input is instead processed eight bytes at a time. If
+    X is the big endian value of eight input bytes (input bit i at position
+    63 - i) and K holds the key bits starting at the same offset in reverse
+    order (key bit j at position j), then bit (63 + r) of the carry-less
+    product X * K is the XOR of (input bit i AND key bit i + r) over all i,
+    which is exactly output bit r. The product is linear, so the partial
+    results of each eight byte chunk are XORed together and the bits are put
+    back in output order once at the end. The result is identical to the
+    table based computation.
+
 --*/
 
 #include "platform_internal.h"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#include <wmmintrin.h>
+#define CXPLAT_TOEPLITZ_CLMUL 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CXPLAT_TOEPLITZ_CLMUL_TARGET
+#else
+#define CXPLAT_TOEPLITZ_CLMUL_TARGET __attribute__((target("pclmul,sse2")))
+#endif
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#define CXPLAT_TOEPLITZ_CLMUL 1
+#define CXPLAT_TOEPLITZ_CLMUL_TARGET
+#endif
+
+#ifdef CXPLAT_TOEPLITZ_CLMUL
+
+//
+// Returns TRUE if the carry-less multiply instructions are available.
+//
+static
+BOOLEAN
+CxPlatToeplitzClmulSupported(
+    void
+    )
+{
+#if defined(__aarch64__)
+    return TRUE; // Required at compile time.
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int CpuInfo[4];
+    __cpuid(CpuInfo, 1);
+    return (CpuInfo[2] & (1 << 1)) != 0;
+#else
+    return __builtin_cpu_supports("pclmul") ? TRUE : FALSE;
+#endif
+}
+
+static
+uint32_t
+CxPlatToeplitzBitReverse32(
+    _In_ uint32_t Value
+    )
+{
+    Value = ((Value >> 1) & 0x55555555) | ((Value & 0x55555555) << 1);
+    Value = ((Value >> 2) & 0x33333333) | ((Value & 0x33333333) << 2);
+    Value = ((Value >> 4) & 0x0F0F0F0F) | ((Value & 0x0F0F0F0F) << 4);
+    return CxPlatByteSwapUint32(Value);
+}
+
+//
+// Loads up to eight input bytes as a big endian value, zero padded.
+//
+QUIC_INLINE
+uint64_t
+CxPlatToeplitzLoadInput(
+    _In_reads_(Length) const uint8_t* Input,
+    _In_ uint32_t Length
+    )
+{
+    uint64_t Value = 0;
+    if (Length >= sizeof(Value)) {
+        CxPlatCopyMemory(&Value, Input, sizeof(Value));
+        return CxPlatByteSwapUint64(Value);
+    }
+    for (uint32_t i = 0; i < Length; i++) {
+        Value |= (uint64_t)Input[i] << (56 - 8 * i);
+    }
+    return Value;
+}
+
+static
+CXPLAT_TOEPLITZ_CLMUL_TARGET
+uint32_t
+CxPlatToeplitzHashComputeClmul(
+    _In_ const CXPLAT_TOEPLITZ_HASH* Toeplitz,
+    _In_reads_(HashInputLength)
+        const uint8_t* HashInput,
+    _In_ uint32_t HashInputLength,
+    _In_ uint32_t HashInputOffset
+    )
+{
+    //
+    // Accumulate the products of the input with the low and high halves of
+    // the key, then extract bits 63 to 94 of the combined product.
+    //
+#if defined(__aarch64__)
+    uint64x2_t Lo = vdupq_n_u64(0);
+    uint64x2_t Hi = vdupq_n_u64(0);
+    for (uint32_t i = 0; i < HashInputLength; i += 8) {
+        const poly64_t X = (poly64_t)CxPlatToeplitzLoadInput(HashInput + i, HashInputLength - i);
+        const uint64_t* Key = Toeplitz->ClmulKeys[HashInputOffset + i];
+        Lo = veorq_u64(Lo, vreinterpretq_u64_p128(vmull_p64(X, (poly64_t)Key[0])));
+        Hi = veorq_u64(Hi, vreinterpretq_u64_p128(vmull_p64(X, (poly64_t)Key[1])));
+    }
+    const uint64_t LoLo = vgetq_lane_u64(Lo, 0);
+    const uint64_t LoHi = vgetq_lane_u64(Lo, 1);
+    const uint64_t HiLo = vgetq_lane_u64(Hi, 0);
+#else
+    __m128i Lo = _mm_setzero_si128();
+    __m128i Hi = _mm_setzero_si128();
+    for (uint32_t i = 0; i < HashInputLength; i += 8) {
+        const __m128i X =
+            _mm_cvtsi64_si128(
+                (long long)CxPlatToeplitzLoadInput(HashInput + i, HashInputLength - i));
+        const __m128i K =
+            _mm_loadu_si128((const __m128i*)Toeplitz->ClmulKeys[HashInputOffset + i]);
+        Lo = _mm_xor_si128(Lo, _mm_clmulepi64_si128(X, K, 0x00));
+        Hi = _mm_xor_si128(Hi, _mm_clmulepi64_si128(X, K, 0x10));
+    }
+    const uint64_t LoLo = (uint64_t)_mm_cvtsi128_si64(Lo);
+    const uint64_t LoHi = (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(Lo, Lo));
+    const uint64_t HiLo = (uint64_t)_mm_cvtsi128_si64(Hi);
+#endif
+
+    return
+        CxPlatToeplitzBitReverse32(
+            (uint32_t)((LoLo >> 63) | ((LoHi ^ HiLo) << 1)));
+}
+
+#endif // CXPLAT_TOEPLITZ_CLMUL
+
 
 //
 // Initializes the state required for a Toeplitz hash computation. We
@@ -127,6 +259,29 @@ CxPlatToeplitzHashInitialize(
             }
         }
     }
+
+    //
+    // Initialize the Toeplitz->ClmulKeys. Key bits past the end of the key
+    // are only ever multiplied by zero padding, so they are left as zero.
+    //
+    const uint32_t KeyBits =
+        ((uint32_t)Toeplitz->InputSize + CXPLAT_TOEPLITZ_OUPUT_SIZE) * 8;
+    for (uint32_t i = 0; i < (uint32_t)Toeplitz->InputSize; i++) {
+        Toeplitz->ClmulKeys[i][0] = 0;
+        Toeplitz->ClmulKeys[i][1] = 0;
+        for (uint32_t j = 0; j < 95 && i * 8 + j < KeyBits; j++) {
+            const uint32_t Bit = i * 8 + j;
+            if ((Toeplitz->HashKey[Bit / 8] >> (7 - Bit % 8)) & 1) {
+                Toeplitz->ClmulKeys[i][j / 64] |= 1ull << (j % 64);
+            }
+        }
+    }
+
+#ifdef CXPLAT_TOEPLITZ_CLMUL
+    Toeplitz->UseClmul = CxPlatToeplitzClmulSupported();
+#else
+    Toeplitz->UseClmul = FALSE;
+#endif
 }
 
 //
@@ -154,6 +309,17 @@ CxPlatToeplitzHashCompute(
     CXPLAT_DBG_ASSERT(
         (BaseOffset + HashInputLength * NIBBLES_PER_BYTE) <= (uint32_t)(Toeplitz->InputSize * NIBBLES_PER_BYTE));
 
+#ifdef CXPLAT_TOEPLITZ_CLMUL
+    //
+    // Short inputs (ports, IPv4 addresses) are cheaper with the tables.
+    //
+    if (Toeplitz->UseClmul && HashInputLength >= 8) {
+        return
+            CxPlatToeplitzHashComputeClmul(
+                Toeplitz, HashInput, HashInputLength, HashInputOffset);
+    }
+#endif
+
     for (uint32_t i = 0; i < HashInputLength; i++) {
         Result ^= Toeplitz->LookupTableArray[BaseOffset].Table[(HashInput[i] >> 4) & 0xf];
         BaseOffset++;
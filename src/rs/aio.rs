@@ -0,0 +1,532 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+//! Async connections, streams and listeners (the "async" feature).
+//!
+//! These wrap the callback based handles: each handle's callback records the
+//! event in state shared with the wrapper and wakes whichever future is waiting
+//! on it. No executor is assumed, the futures only use [Waker]s, so they work
+//! with any runtime.
+//!
+//! Data is not copied. Received buffers are lent out by [Stream::read] until the
+//! returned [RecvChunk] is dropped, which completes the receive. Sent buffers
+//! are owned by the send until MsQuic completes it, so they stay in place even
+//! if the future writing them is dropped.
+
+use crate::{
+    Addr, BufferRef, ConnectionEvent, ConnectionRef, ConnectionShutdownFlags, ListenerEvent,
+    ListenerRef, ReceiveGuard, SendFlags, Status, StatusCode, StreamEvent, StreamOpenFlags,
+    StreamRef, StreamShutdownFlags, StreamStartFlags,
+};
+use std::collections::VecDeque;
+use std::future::poll_fn;
+use std::sync::{Arc, Mutex};
+use std::task::{Context, Poll, Waker};
+
+fn wake(waker: &mut Option<Waker>) {
+    if let Some(w) = waker.take() {
+        w.wake();
+    }
+}
+
+#[derive(Default)]
+struct ConnectionState {
+    connected: bool,
+    /// Why the connection shut down, once it started to.
+    error: Option<Status>,
+    shutdown_complete: bool,
+    /// Peer started streams not yet accepted.
+    streams: VecDeque<Stream>,
+    connect_waker: Option<Waker>,
+    accept_waker: Option<Waker>,
+    shutdown_waker: Option<Waker>,
+}
+
+/// A connection whose handshake, stream accepts and shutdown can be awaited.
+pub struct Connection {
+    inner: crate::Connection,
+    state: Arc<Mutex<ConnectionState>>,
+}
+
+impl Connection {
+    /// Opens a client connection and waits for its handshake to complete.
+    pub async fn connect(
+        registration: &crate::Registration,
+        configuration: &crate::Configuration,
+        server_name: &str,
+        server_port: u16,
+    ) -> Result<Self, Status> {
+        let state = Arc::new(Mutex::new(ConnectionState::default()));
+        let callback_state = state.clone();
+        let inner = crate::Connection::open(registration, move |conn, event| {
+            Self::on_event(&callback_state, conn, event)
+        })?;
+        let connection = Self { inner, state };
+        connection
+            .inner
+            .start(configuration, server_name, server_port)?;
+        connection.connected().await?;
+        Ok(connection)
+    }
+
+    /// Takes over a connection from [ListenerEvent::NewConnection].
+    fn from_new_connection(inner: crate::Connection) -> Self {
+        let state = Arc::new(Mutex::new(ConnectionState::default()));
+        let callback_state = state.clone();
+        inner.set_callback_handler(move |conn, event| Self::on_event(&callback_state, conn, event));
+        Self { inner, state }
+    }
+
+    fn on_event(
+        state: &Mutex<ConnectionState>,
+        _conn: ConnectionRef,
+        event: ConnectionEvent,
+    ) -> Result<(), Status> {
+        let mut s = state.lock().unwrap();
+        match event {
+            ConnectionEvent::Connected { .. } => {
+                s.connected = true;
+                wake(&mut s.connect_waker);
+            }
+            ConnectionEvent::ShutdownInitiatedByTransport { status, .. } => {
+                s.error.get_or_insert(status);
+                wake(&mut s.connect_waker);
+                wake(&mut s.accept_waker);
+            }
+            ConnectionEvent::ShutdownInitiatedByPeer { .. } => {
+                s.error
+                    .get_or_insert(Status::new(StatusCode::QUIC_STATUS_ABORTED));
+                wake(&mut s.connect_waker);
+                wake(&mut s.accept_waker);
+            }
+            ConnectionEvent::ShutdownComplete { .. } => {
+                s.error
+                    .get_or_insert(Status::new(StatusCode::QUIC_STATUS_ABORTED));
+                s.shutdown_complete = true;
+                // Close the streams nobody accepted before the connection goes.
+                let streams = std::mem::take(&mut s.streams);
+                wake(&mut s.connect_waker);
+                wake(&mut s.accept_waker);
+                wake(&mut s.shutdown_waker);
+                drop(s);
+                drop(streams);
+            }
+            ConnectionEvent::PeerStreamStarted { stream, .. } => {
+                let stream = Stream::from_peer_stream(&stream);
+                s.streams.push_back(stream);
+                wake(&mut s.accept_waker);
+            }
+            _ => {}
+        }
+        Ok(())
+    }
+
+    fn poll_connected(&self, cx: &mut Context<'_>) -> Poll<Result<(), Status>> {
+        let mut s = self.state.lock().unwrap();
+        if s.connected {
+            Poll::Ready(Ok(()))
+        } else if let Some(e) = &s.error {
+            Poll::Ready(Err(e.clone()))
+        } else {
+            s.connect_waker = Some(cx.waker().clone());
+            Poll::Pending
+        }
+    }
+
+    /// Waits for the handshake to complete. Accepted connections are returned
+    /// by [Listener::accept] before their handshake completes.
+    pub async fn connected(&self) -> Result<(), Status> {
+        poll_fn(|cx| self.poll_connected(cx)).await
+    }
+
+    fn poll_accept(&self, cx: &mut Context<'_>) -> Poll<Result<Stream, Status>> {
+        let mut s = self.state.lock().unwrap();
+        if let Some(stream) = s.streams.pop_front() {
+            Poll::Ready(Ok(stream))
+        } else if let Some(e) = &s.error {
+            Poll::Ready(Err(e.clone()))
+        } else {
+            s.accept_waker = Some(cx.waker().clone());
+            Poll::Pending
+        }
+    }
+
+    /// Waits for the peer to start a stream. Fails once the connection is
+    /// shutting down.
+    pub async fn accept_stream(&self) -> Result<Stream, Status> {
+        poll_fn(|cx| self.poll_accept(cx)).await
+    }
+
+    /// Opens and starts a stream, waiting until the peer allows it.
+    pub async fn open_stream(&self, flags: StreamOpenFlags) -> Result<Stream, Status> {
+        let stream_state = Arc::new(Mutex::new(StreamState::default()));
+        let callback_state = stream_state.clone();
+        let inner = crate::Stream::open(&self.inner, flags, move |stream, event| {
+            Stream::on_event(&callback_state, stream, event)
+        })?;
+        let stream = Stream {
+            inner,
+            state: stream_state,
+        };
+        stream.inner.start(StreamStartFlags::NONE)?;
+        poll_fn(|cx| stream.poll_started(cx)).await?;
+        Ok(stream)
+    }
+
+    /// Starts shutting down the connection, and waits for it to complete.
+    pub async fn shutdown(&self, flags: ConnectionShutdownFlags, error_code: crate::u62) {
+        self.inner.shutdown(flags, error_code);
+        poll_fn(|cx| {
+            let mut s = self.state.lock().unwrap();
+            if s.shutdown_complete {
+                Poll::Ready(())
+            } else {
+                s.shutdown_waker = Some(cx.waker().clone());
+                Poll::Pending
+            }
+        })
+        .await
+    }
+
+    /// The underlying connection, for params and statistics.
+    /// Its callback handler must not be replaced.
+    pub fn as_connection(&self) -> &crate::Connection {
+        &self.inner
+    }
+}
+
+#[derive(Default)]
+struct StreamState {
+    /// Result of starting a locally opened stream.
+    started: Option<Result<(), Status>>,
+    /// Received data not yet read.
+    recv: Option<ReceiveGuard>,
+    recv_fin: bool,
+    /// Why the stream was aborted or shut down, once it was.
+    error: Option<Status>,
+    start_waker: Option<Waker>,
+    recv_waker: Option<Waker>,
+}
+
+/// A stream that can be read and written asynchronously.
+pub struct Stream {
+    inner: crate::Stream,
+    state: Arc<Mutex<StreamState>>,
+}
+
+/// Buffers of a send, kept alive (and in place) until MsQuic completes it.
+/// Owned by the send future and, through the client context, by MsQuic.
+struct SendRequest {
+    _data: Box<dyn Send + Sync>,
+    buffers: Vec<BufferRef>,
+    state: Mutex<SendState>,
+}
+
+// The buffers point into _data, which is not touched while the send is pending.
+unsafe impl Send for SendRequest {}
+unsafe impl Sync for SendRequest {}
+
+#[derive(Default)]
+struct SendState {
+    /// Whether it was cancelled, once complete.
+    complete: Option<bool>,
+    waker: Option<Waker>,
+}
+
+impl Stream {
+    fn from_peer_stream(stream: &StreamRef) -> Self {
+        let state = Arc::new(Mutex::new(StreamState {
+            started: Some(Ok(())),
+            ..Default::default()
+        }));
+        let callback_state = state.clone();
+        stream.set_callback_handler(move |stream, event| {
+            Self::on_event(&callback_state, stream, event)
+        });
+        // The connection hands stream ownership to the app.
+        let inner = unsafe { crate::Stream::from_raw(stream.as_raw()) };
+        Self { inner, state }
+    }
+
+    fn on_event(
+        state: &Mutex<StreamState>,
+        stream: StreamRef,
+        event: StreamEvent,
+    ) -> Result<(), Status> {
+        let mut s = state.lock().unwrap();
+        match event {
+            StreamEvent::StartComplete { status, .. } => {
+                s.started = Some(Status::ok_from_raw(status.0));
+                wake(&mut s.start_waker);
+            }
+            StreamEvent::Receive {
+                total_buffer_length,
+                buffers,
+                ..
+            } => {
+                if *total_buffer_length == 0 {
+                    return Ok(());
+                }
+                // The stream is only closed once the guard is dropped (see
+                // Drop for Stream).
+                s.recv = Some(unsafe { stream.lend_receive(buffers, *total_buffer_length) });
+                wake(&mut s.recv_waker);
+            }
+            StreamEvent::SendComplete {
+                cancelled,
+                client_context,
+            } => {
+                let request = unsafe { Arc::from_raw(client_context as *const SendRequest) };
+                let mut send = request.state.lock().unwrap();
+                send.complete = Some(cancelled);
+                wake(&mut send.waker);
+            }
+            StreamEvent::PeerSendShutdown => {
+                s.recv_fin = true;
+                wake(&mut s.recv_waker);
+            }
+            StreamEvent::PeerSendAborted { .. } => {
+                s.error
+                    .get_or_insert(Status::new(StatusCode::QUIC_STATUS_ABORTED));
+                wake(&mut s.recv_waker);
+            }
+            StreamEvent::ShutdownComplete {
+                connection_shutdown,
+                connection_close_status,
+                ..
+            } => {
+                let status = if connection_shutdown && !connection_close_status.is_ok() {
+                    connection_close_status
+                } else {
+                    Status::new(StatusCode::QUIC_STATUS_ABORTED)
+                };
+                s.started.get_or_insert(Err(status.clone()));
+                s.error.get_or_insert(status);
+                wake(&mut s.start_waker);
+                wake(&mut s.recv_waker);
+            }
+            _ => {}
+        }
+        Ok(())
+    }
+
+    fn poll_started(&self, cx: &mut Context<'_>) -> Poll<Result<(), Status>> {
+        let mut s = self.state.lock().unwrap();
+        match &s.started {
+            Some(result) => Poll::Ready(result.clone()),
+            None => {
+                s.start_waker = Some(cx.waker().clone());
+                Poll::Pending
+            }
+        }
+    }
+
+    fn poll_read(&self, cx: &mut Context<'_>) -> Poll<Result<Option<ReceiveGuard>, Status>> {
+        let mut s = self.state.lock().unwrap();
+        if let Some(recv) = s.recv.take() {
+            Poll::Ready(Ok(Some(recv)))
+        } else if s.recv_fin {
+            Poll::Ready(Ok(None))
+        } else if let Some(e) = &s.error {
+            Poll::Ready(Err(e.clone()))
+        } else {
+            s.recv_waker = Some(cx.waker().clone());
+            Poll::Pending
+        }
+    }
+
+    /// Waits for received data, which is lent out until the returned chunk is
+    /// dropped; no more is received meanwhile. Returns None once the peer has
+    /// finished sending.
+    pub async fn read(&self) -> Result<Option<RecvChunk<'_>>, Status> {
+        let recv = poll_fn(|cx| self.poll_read(cx)).await?;
+        Ok(recv.map(|guard| RecvChunk {
+            guard,
+            _stream: self,
+        }))
+    }
+
+    /// Sends the buffers without copying them, and waits for MsQuic to be done
+    /// with them (sent, or buffered if send buffering is on). Fails if the send
+    /// was cancelled.
+    pub async fn write_vectored<B>(&self, data: Vec<B>, flags: SendFlags) -> Result<(), Status>
+    where
+        B: AsRef<[u8]> + Send + Sync + 'static,
+    {
+        // The buffers are described once the data is boxed, so the pointers
+        // stay valid however the request moves.
+        let data = Box::new(data);
+        let buffers = data.iter().map(|b| BufferRef::from(b.as_ref())).collect();
+        let request = Arc::new(SendRequest {
+            _data: data,
+            buffers,
+            state: Mutex::new(SendState::default()),
+        });
+        self.start_send(&request, flags)?;
+
+        let cancelled = poll_fn(|cx| {
+            let mut send = request.state.lock().unwrap();
+            match send.complete {
+                Some(cancelled) => Poll::Ready(cancelled),
+                None => {
+                    send.waker = Some(cx.waker().clone());
+                    Poll::Pending
+                }
+            }
+        })
+        .await;
+        if cancelled {
+            Err(Status::new(StatusCode::QUIC_STATUS_ABORTED))
+        } else {
+            Ok(())
+        }
+    }
+
+    /// Gives MsQuic a reference to the request, returned with SendComplete.
+    fn start_send(&self, request: &Arc<SendRequest>, flags: SendFlags) -> Result<(), Status> {
+        let context = Arc::into_raw(request.clone());
+        unsafe {
+            self.inner
+                .send(&request.buffers, flags, context as *const _)
+        }
+        .inspect_err(|_| {
+            // Take the reference back, as the send never started.
+            drop(unsafe { Arc::from_raw(context) });
+        })
+    }
+
+    /// Sends one buffer without copying it, optionally finishing the stream.
+    pub async fn write<B>(&self, data: B, fin: bool) -> Result<(), Status>
+    where
+        B: AsRef<[u8]> + Send + Sync + 'static,
+    {
+        let flags = if fin { SendFlags::FIN } else { SendFlags::NONE };
+        self.write_vectored(vec![data], flags).await
+    }
+
+    /// Gracefully finishes sending.
+    pub fn finish(&self) -> Result<(), Status> {
+        self.inner.shutdown(StreamShutdownFlags::GRACEFUL, 0)
+    }
+
+    /// Aborts both directions of the stream.
+    pub fn abort(&self, error_code: crate::u62) -> Result<(), Status> {
+        self.inner.shutdown(StreamShutdownFlags::ABORT, error_code)
+    }
+
+    /// The underlying stream, for params. Its callback handler must not be
+    /// replaced.
+    pub fn as_stream(&self) -> &crate::Stream {
+        &self.inner
+    }
+}
+
+impl Drop for Stream {
+    fn drop(&mut self) {
+        // Complete an unread receive while the stream is still open.
+        let recv = self.state.lock().unwrap().recv.take();
+        drop(recv);
+    }
+}
+
+/// Received buffers borrowed from MsQuic, see [ReceiveGuard]. Borrows the
+/// stream so it stays open until the receive is completed.
+pub struct RecvChunk<'a> {
+    guard: ReceiveGuard,
+    _stream: &'a Stream,
+}
+
+impl std::ops::Deref for RecvChunk<'_> {
+    type Target = ReceiveGuard;
+
+    fn deref(&self) -> &Self::Target {
+        &self.guard
+    }
+}
+
+impl std::ops::DerefMut for RecvChunk<'_> {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.guard
+    }
+}
+
+#[derive(Default)]
+struct ListenerState {
+    connections: VecDeque<Connection>,
+    stopped: bool,
+    accept_waker: Option<Waker>,
+}
+
+/// A listener whose new connections can be awaited.
+pub struct Listener {
+    inner: crate::Listener,
+    state: Arc<Mutex<ListenerState>>,
+}
+
+impl Listener {
+    /// Opens a listener that gives new connections the configuration.
+    pub fn open(
+        registration: &crate::Registration,
+        configuration: Arc<crate::Configuration>,
+    ) -> Result<Self, Status> {
+        let state = Arc::new(Mutex::new(ListenerState::default()));
+        let callback_state = state.clone();
+        let inner = crate::Listener::open(registration, move |listener, event| {
+            Self::on_event(&callback_state, &configuration, listener, event)
+        })?;
+        Ok(Self { inner, state })
+    }
+
+    fn on_event(
+        state: &Mutex<ListenerState>,
+        configuration: &crate::Configuration,
+        _listener: ListenerRef,
+        event: ListenerEvent,
+    ) -> Result<(), Status> {
+        match event {
+            ListenerEvent::NewConnection { connection, .. } => {
+                let connection = Connection::from_new_connection(connection);
+                connection.inner.set_configuration(configuration)?;
+                let mut s = state.lock().unwrap();
+                s.connections.push_back(connection);
+                wake(&mut s.accept_waker);
+            }
+            ListenerEvent::StopComplete { .. } => {
+                let mut s = state.lock().unwrap();
+                s.stopped = true;
+                wake(&mut s.accept_waker);
+            }
+        }
+        Ok(())
+    }
+
+    pub fn start(&self, alpn: &[BufferRef], local_address: Option<&Addr>) -> Result<(), Status> {
+        self.inner.start(alpn, local_address)
+    }
+
+    pub fn stop(&self) {
+        self.inner.stop()
+    }
+
+    pub fn local_addr(&self) -> Result<Addr, Status> {
+        self.inner.get_local_addr()
+    }
+
+    fn poll_accept(&self, cx: &mut Context<'_>) -> Poll<Option<Connection>> {
+        let mut s = self.state.lock().unwrap();
+        if let Some(connection) = s.connections.pop_front() {
+            Poll::Ready(Some(connection))
+        } else if s.stopped {
+            Poll::Ready(None)
+        } else {
+            s.accept_waker = Some(cx.waker().clone());
+            Poll::Pending
+        }
+    }
+
+    /// Waits for a new connection, whose handshake may still be in progress
+    /// (see [Connection::connected]). Returns None once the listener stopped.
+    pub async fn accept(&self) -> Option<Connection> {
+        poll_fn(|cx| self.poll_accept(cx)).await
+    }
+}
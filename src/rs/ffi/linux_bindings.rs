@@ -150,6 +150,10 @@ pub const QUIC_MAX_ALPN_LENGTH: u32 = 255;
 pub const QUIC_MAX_SNI_LENGTH: u32 = 65535;
 pub const QUIC_MAX_RESUMPTION_APP_DATA_LENGTH: u32 = 1000;
 pub const QUIC_STATELESS_RESET_KEY_LENGTH: u32 = 32;
+pub const QUIC_LOAD_BALANCING_KEY_LENGTH: u32 = 16;
+pub const QUIC_LATENCY_HISTOGRAM_BUCKET_COUNT: u32 = 240;
+pub const QUIC_QLOG_MAGIC: u32 = 1196379217;
+pub const QUIC_QLOG_VERSION: u32 = 1;
 pub const QUIC_MAX_TICKET_KEY_COUNT: u32 = 16;
 pub const QUIC_TLS_SECRETS_MAX_SECRET_LEN: u32 = 64;
 pub const QUIC_PARAM_PREFIX_GLOBAL: u32 = 16777216;
@@ -175,6 +179,26 @@ pub const QUIC_PARAM_GLOBAL_TLS_PROVIDER: u32 = 16777226;
 pub const QUIC_PARAM_GLOBAL_STATELESS_RESET_KEY: u32 = 16777227;
 pub const QUIC_PARAM_GLOBAL_STATISTICS_V2_SIZES: u32 = 16777228;
 pub const QUIC_PARAM_GLOBAL_STATELESS_RETRY_CONFIG: u32 = 16777229;
+pub const QUIC_PARAM_GLOBAL_WORKER_POLL_STATISTICS: u32 = 16777230;
+pub const QUIC_PARAM_GLOBAL_WORKER_LATENCY_HISTOGRAMS: u32 = 16777231;
+pub const QUIC_PARAM_GLOBAL_LOAD_BALANCING_KEY: u32 = 16777232;
+pub const QUIC_PARAM_GLOBAL_ALLOCATION_STATISTICS: u32 = 16777233;
+pub const QUIC_PARAM_GLOBAL_OBJECT_SIZES: u32 = 16777234;
+pub const QUIC_PARAM_GLOBAL_RECV_POOL_POLICY: u32 = 16777235;
+pub const QUIC_PARAM_GLOBAL_RECV_POOL_STATISTICS: u32 = 16777236;
+pub const QUIC_PARAM_GLOBAL_PERSISTENT_CACHE_PATH: u32 = 16777237;
+pub const QUIC_PARAM_GLOBAL_QLOG_CONFIG: u32 = 16777238;
+pub const QUIC_PARAM_GLOBAL_METRICS_SNAPSHOT: u32 = 16777239;
+pub const QUIC_PARAM_GLOBAL_SLOW_CALLBACK_THRESHOLD: u32 = 16777240;
+pub const QUIC_PARAM_GLOBAL_SLOW_CALLBACK_STATISTICS: u32 = 16777241;
+pub const QUIC_PARAM_GLOBAL_RECV_DROP_COUNTERS: u32 = 16777242;
+pub const QUIC_PARAM_GLOBAL_PREWARM_CONFIG: u32 = 16777243;
+pub const QUIC_PARAM_GLOBAL_INITIAL_FILTER_CONFIG: u32 = 16777244;
+pub const QUIC_PARAM_REGISTRATION_CONGESTION_CONTROL: u32 = 33554432;
+pub const QUIC_PARAM_REGISTRATION_QUOTA: u32 = 33554433;
+pub const QUIC_PARAM_REGISTRATION_USAGE: u32 = 33554434;
+pub const QUIC_PARAM_REGISTRATION_DRAIN: u32 = 33554435;
+pub const QUIC_PARAM_REGISTRATION_EGRESS_RATE_LIMIT: u32 = 33554436;
 pub const QUIC_PARAM_CONFIGURATION_SETTINGS: u32 = 50331648;
 pub const QUIC_PARAM_CONFIGURATION_TICKET_KEYS: u32 = 50331649;
 pub const QUIC_PARAM_CONFIGURATION_VERSION_SETTINGS: u32 = 50331650;
@@ -183,6 +207,7 @@ pub const QUIC_PARAM_LISTENER_LOCAL_ADDRESS: u32 = 67108864;
 pub const QUIC_PARAM_LISTENER_STATS: u32 = 67108865;
 pub const QUIC_PARAM_LISTENER_CIBIR_ID: u32 = 67108866;
 pub const QUIC_PARAM_LISTENER_PARTITION_INDEX: u32 = 67108869;
+pub const QUIC_PARAM_LISTENER_ACCEPT_QUEUE: u32 = 67108870;
 pub const QUIC_PARAM_DOS_MODE_EVENTS: u32 = 67108868;
 pub const QUIC_PARAM_CONN_QUIC_VERSION: u32 = 83886080;
 pub const QUIC_PARAM_CONN_LOCAL_ADDRESS: u32 = 83886081;
@@ -211,6 +236,15 @@ pub const QUIC_PARAM_CONN_ORIG_DEST_CID: u32 = 83886104;
 pub const QUIC_PARAM_CONN_SEND_DSCP: u32 = 83886105;
 pub const QUIC_PARAM_CONN_NETWORK_STATISTICS: u32 = 83886112;
 pub const QUIC_PARAM_CONN_CLOSE_ASYNC: u32 = 83886106;
+pub const QUIC_PARAM_CONN_DATAGRAM_CLASS_RATES: u32 = 83886107;
+pub const QUIC_PARAM_CONN_QLOG: u32 = 83886108;
+pub const QUIC_PARAM_CONN_NETWORK_STATISTICS_SAMPLING: u32 = 83886109;
+pub const QUIC_PARAM_CONN_PARALLEL_PROTECTION: u32 = 83886110;
+pub const QUIC_PARAM_CONN_SEND_CORK_TIMEOUT: u32 = 83886111;
+pub const QUIC_PARAM_CONN_DATAGRAM_RECEIVE_BATCHING: u32 = 83886113;
+pub const QUIC_PARAM_CONN_EGRESS_RATE_LIMIT: u32 = 83886114;
+pub const QUIC_PARAM_CONN_SCHEDULING_WEIGHT: u32 = 83886115;
+pub const QUIC_PARAM_CONN_TAIL_PROTECTION: u32 = 83886116;
 pub const QUIC_PARAM_TLS_HANDSHAKE_INFO: u32 = 100663296;
 pub const QUIC_PARAM_TLS_NEGOTIATED_ALPN: u32 = 100663297;
 pub const QUIC_PARAM_STREAM_ID: u32 = 134217728;
@@ -219,10 +253,13 @@ pub const QUIC_PARAM_STREAM_IDEAL_SEND_BUFFER_SIZE: u32 = 134217730;
 pub const QUIC_PARAM_STREAM_PRIORITY: u32 = 134217731;
 pub const QUIC_PARAM_STREAM_STATISTICS: u32 = 134217732;
 pub const QUIC_PARAM_STREAM_RELIABLE_OFFSET: u32 = 134217733;
+pub const QUIC_PARAM_STREAM_URGENCY: u32 = 134217734;
+pub const QUIC_PARAM_STREAM_RECEIVE_BATCHING: u32 = 134217735;
 pub const QUIC_API_VERSION_1: u32 = 1;
 pub const QUIC_API_VERSION_2: u32 = 2;
 pub type BOOLEAN = ::std::os::raw::c_uchar;
 pub type QUIC_ADDRESS_FAMILY = sa_family_t;
+pub type QUIC_FILE_HANDLE = ::std::os::raw::c_int;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct QUIC_ADDR_STR {
@@ -273,8 +310,17 @@ pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_DISABLED: QUIC_LOAD_BALAN
 pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_IP: QUIC_LOAD_BALANCING_MODE = 1;
 pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_FIXED: QUIC_LOAD_BALANCING_MODE =
     2;
-pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_COUNT: QUIC_LOAD_BALANCING_MODE = 3;
+pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_STREAM_CIPHER:
+    QUIC_LOAD_BALANCING_MODE = 3;
+pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_SERVER_ID_BLOCK_CIPHER:
+    QUIC_LOAD_BALANCING_MODE = 4;
+pub const QUIC_LOAD_BALANCING_MODE_QUIC_LOAD_BALANCING_COUNT: QUIC_LOAD_BALANCING_MODE = 5;
 pub type QUIC_LOAD_BALANCING_MODE = ::std::os::raw::c_uint;
+pub const QUIC_HUGE_PAGE_MODE_QUIC_HUGE_PAGE_DISABLED: QUIC_HUGE_PAGE_MODE = 0;
+pub const QUIC_HUGE_PAGE_MODE_QUIC_HUGE_PAGE_2MB: QUIC_HUGE_PAGE_MODE = 1;
+pub const QUIC_HUGE_PAGE_MODE_QUIC_HUGE_PAGE_1GB: QUIC_HUGE_PAGE_MODE = 2;
+pub const QUIC_HUGE_PAGE_MODE_QUIC_HUGE_PAGE_COUNT: QUIC_HUGE_PAGE_MODE = 3;
+pub type QUIC_HUGE_PAGE_MODE = ::std::os::raw::c_uint;
 pub const QUIC_TLS_ALERT_CODES_QUIC_TLS_ALERT_CODE_SUCCESS: QUIC_TLS_ALERT_CODES = 65535;
 pub const QUIC_TLS_ALERT_CODES_QUIC_TLS_ALERT_CODE_UNEXPECTED_MESSAGE: QUIC_TLS_ALERT_CODES = 10;
 pub const QUIC_TLS_ALERT_CODES_QUIC_TLS_ALERT_CODE_BAD_CERTIFICATE: QUIC_TLS_ALERT_CODES = 42;
@@ -343,6 +389,8 @@ pub const QUIC_CREDENTIAL_FLAGS_QUIC_CREDENTIAL_FLAG_INPROC_PEER_CERTIFICATE:
 pub const QUIC_CREDENTIAL_FLAGS_QUIC_CREDENTIAL_FLAG_SET_CA_CERTIFICATE_FILE:
     QUIC_CREDENTIAL_FLAGS = 1048576;
 pub const QUIC_CREDENTIAL_FLAGS_QUIC_CREDENTIAL_FLAG_DISABLE_AIA: QUIC_CREDENTIAL_FLAGS = 2097152;
+pub const QUIC_CREDENTIAL_FLAGS_QUIC_CREDENTIAL_FLAG_OFFLOAD_HANDSHAKE:
+    QUIC_CREDENTIAL_FLAGS = 4194304;
 pub type QUIC_CREDENTIAL_FLAGS = ::std::os::raw::c_uint;
 pub const QUIC_ALLOWED_CIPHER_SUITE_FLAGS_QUIC_ALLOWED_CIPHER_SUITE_NONE:
     QUIC_ALLOWED_CIPHER_SUITE_FLAGS = 0;
@@ -362,6 +410,8 @@ pub const QUIC_CONNECTION_SHUTDOWN_FLAGS_QUIC_CONNECTION_SHUTDOWN_FLAG_NONE:
     QUIC_CONNECTION_SHUTDOWN_FLAGS = 0;
 pub const QUIC_CONNECTION_SHUTDOWN_FLAGS_QUIC_CONNECTION_SHUTDOWN_FLAG_SILENT:
     QUIC_CONNECTION_SHUTDOWN_FLAGS = 1;
+pub const QUIC_CONNECTION_SHUTDOWN_FLAGS_QUIC_CONNECTION_SHUTDOWN_FLAG_FAST:
+    QUIC_CONNECTION_SHUTDOWN_FLAGS = 2;
 pub type QUIC_CONNECTION_SHUTDOWN_FLAGS = ::std::os::raw::c_uint;
 pub const QUIC_SERVER_RESUMPTION_LEVEL_QUIC_SERVER_NO_RESUME: QUIC_SERVER_RESUMPTION_LEVEL = 0;
 pub const QUIC_SERVER_RESUMPTION_LEVEL_QUIC_SERVER_RESUME_ONLY: QUIC_SERVER_RESUMPTION_LEVEL = 1;
@@ -376,8 +426,10 @@ pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_FIFO:
     QUIC_STREAM_SCHEDULING_SCHEME = 0;
 pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_ROUND_ROBIN:
     QUIC_STREAM_SCHEDULING_SCHEME = 1;
-pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_COUNT:
+pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_URGENCY:
     QUIC_STREAM_SCHEDULING_SCHEME = 2;
+pub const QUIC_STREAM_SCHEDULING_SCHEME_QUIC_STREAM_SCHEDULING_SCHEME_COUNT:
+    QUIC_STREAM_SCHEDULING_SCHEME = 3;
 pub type QUIC_STREAM_SCHEDULING_SCHEME = ::std::os::raw::c_uint;
 pub const QUIC_STREAM_OPEN_FLAGS_QUIC_STREAM_OPEN_FLAG_NONE: QUIC_STREAM_OPEN_FLAGS = 0;
 pub const QUIC_STREAM_OPEN_FLAGS_QUIC_STREAM_OPEN_FLAG_UNIDIRECTIONAL: QUIC_STREAM_OPEN_FLAGS = 1;
@@ -424,6 +476,7 @@ pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_DELAY_SEND: QUIC_SEND_FLAGS = 16;
 pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_CANCEL_ON_LOSS: QUIC_SEND_FLAGS = 32;
 pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_PRIORITY_WORK: QUIC_SEND_FLAGS = 64;
 pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_CANCEL_ON_BLOCKED: QUIC_SEND_FLAGS = 128;
+pub const QUIC_SEND_FLAGS_QUIC_SEND_FLAG_NO_BUFFERING: QUIC_SEND_FLAGS = 256;
 pub type QUIC_SEND_FLAGS = ::std::os::raw::c_uint;
 pub const QUIC_DATAGRAM_SEND_STATE_QUIC_DATAGRAM_SEND_UNKNOWN: QUIC_DATAGRAM_SEND_STATE = 0;
 pub const QUIC_DATAGRAM_SEND_STATE_QUIC_DATAGRAM_SEND_SENT: QUIC_DATAGRAM_SEND_STATE = 1;
@@ -442,6 +495,24 @@ pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_H
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 16;
 pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_AFFINITIZE:
     QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 32;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_WORK_STEALING:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 64;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_HIERARCHICAL_TIMERS:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 128;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_BUSY_POLL:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 256;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_URING_FIXED_FILES:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 512;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_IO_URING_SQPOLL:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 1024;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_XDP_SHARED_UMEM:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 2048;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_EPOLL_EDGE_TRIGGERED:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 4096;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_CID_STEERING:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 8192;
+pub const QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS_QUIC_GLOBAL_EXECUTION_CONFIG_FLAG_EPOLL_SEND_BATCHING:
+    QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = 16384;
 pub type QUIC_GLOBAL_EXECUTION_CONFIG_FLAGS = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -468,6 +539,263 @@ const _: () = {
 };
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
+pub struct QUIC_WORKER_POLL_STATISTICS {
+    pub BusyTimeUs: u64,
+    pub SpinTimeUs: u64,
+    pub IdleTimeUs: u64,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_WORKER_POLL_STATISTICS"]
+        [::std::mem::size_of::<QUIC_WORKER_POLL_STATISTICS>() - 24usize];
+    ["Alignment of QUIC_WORKER_POLL_STATISTICS"]
+        [::std::mem::align_of::<QUIC_WORKER_POLL_STATISTICS>() - 8usize];
+    ["Offset of field: QUIC_WORKER_POLL_STATISTICS::BusyTimeUs"]
+        [::std::mem::offset_of!(QUIC_WORKER_POLL_STATISTICS, BusyTimeUs) - 0usize];
+    ["Offset of field: QUIC_WORKER_POLL_STATISTICS::SpinTimeUs"]
+        [::std::mem::offset_of!(QUIC_WORKER_POLL_STATISTICS, SpinTimeUs) - 8usize];
+    ["Offset of field: QUIC_WORKER_POLL_STATISTICS::IdleTimeUs"]
+        [::std::mem::offset_of!(QUIC_WORKER_POLL_STATISTICS, IdleTimeUs) - 16usize];
+};
+pub const QUIC_WORKER_LATENCY_TYPE_QUIC_WORKER_LATENCY_QUEUE_DELAY: QUIC_WORKER_LATENCY_TYPE = 0;
+pub const QUIC_WORKER_LATENCY_TYPE_QUIC_WORKER_LATENCY_DRAIN_TIME: QUIC_WORKER_LATENCY_TYPE = 1;
+pub const QUIC_WORKER_LATENCY_TYPE_QUIC_WORKER_LATENCY_TIMER_LATENESS: QUIC_WORKER_LATENCY_TYPE = 2;
+pub const QUIC_WORKER_LATENCY_TYPE_QUIC_WORKER_LATENCY_COUNT: QUIC_WORKER_LATENCY_TYPE = 3;
+pub type QUIC_WORKER_LATENCY_TYPE = ::std::os::raw::c_uint;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_LATENCY_HISTOGRAM {
+    pub Count: u64,
+    pub MaxUs: u64,
+    pub Buckets: [u64; 240usize],
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_LATENCY_HISTOGRAM"][::std::mem::size_of::<QUIC_LATENCY_HISTOGRAM>() - 1936usize];
+    ["Alignment of QUIC_LATENCY_HISTOGRAM"]
+        [::std::mem::align_of::<QUIC_LATENCY_HISTOGRAM>() - 8usize];
+    ["Offset of field: QUIC_LATENCY_HISTOGRAM::Count"]
+        [::std::mem::offset_of!(QUIC_LATENCY_HISTOGRAM, Count) - 0usize];
+    ["Offset of field: QUIC_LATENCY_HISTOGRAM::MaxUs"]
+        [::std::mem::offset_of!(QUIC_LATENCY_HISTOGRAM, MaxUs) - 8usize];
+    ["Offset of field: QUIC_LATENCY_HISTOGRAM::Buckets"]
+        [::std::mem::offset_of!(QUIC_LATENCY_HISTOGRAM, Buckets) - 16usize];
+};
+pub const QUIC_METRIC_HISTOGRAM_TYPE_QUIC_METRIC_HISTOGRAM_HANDSHAKE_DURATION:
+    QUIC_METRIC_HISTOGRAM_TYPE = 0;
+pub const QUIC_METRIC_HISTOGRAM_TYPE_QUIC_METRIC_HISTOGRAM_RTT: QUIC_METRIC_HISTOGRAM_TYPE = 1;
+pub const QUIC_METRIC_HISTOGRAM_TYPE_QUIC_METRIC_HISTOGRAM_SEND_PACKET_SIZE:
+    QUIC_METRIC_HISTOGRAM_TYPE = 2;
+pub const QUIC_METRIC_HISTOGRAM_TYPE_QUIC_METRIC_HISTOGRAM_SEND_BATCH_SIZE:
+    QUIC_METRIC_HISTOGRAM_TYPE = 3;
+pub const QUIC_METRIC_HISTOGRAM_TYPE_QUIC_METRIC_HISTOGRAM_RECV_BATCH_SIZE:
+    QUIC_METRIC_HISTOGRAM_TYPE = 4;
+pub const QUIC_METRIC_HISTOGRAM_TYPE_QUIC_METRIC_HISTOGRAM_COUNT: QUIC_METRIC_HISTOGRAM_TYPE = 5;
+pub type QUIC_METRIC_HISTOGRAM_TYPE = ::std::os::raw::c_uint;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_RECEIVE: QUIC_WORKER_ACTIVITY_TYPE = 0;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_SEND: QUIC_WORKER_ACTIVITY_TYPE = 1;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_CRYPTO: QUIC_WORKER_ACTIVITY_TYPE = 2;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_TIMERS: QUIC_WORKER_ACTIVITY_TYPE = 3;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_APP_CALLBACK:
+    QUIC_WORKER_ACTIVITY_TYPE = 4;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_OTHER: QUIC_WORKER_ACTIVITY_TYPE = 5;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_IDLE: QUIC_WORKER_ACTIVITY_TYPE = 6;
+pub const QUIC_WORKER_ACTIVITY_TYPE_QUIC_WORKER_ACTIVITY_COUNT: QUIC_WORKER_ACTIVITY_TYPE = 7;
+pub type QUIC_WORKER_ACTIVITY_TYPE = ::std::os::raw::c_uint;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_INVALID_PACKET: QUIC_RECV_DROP_REASON = 0;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_NO_CONNECTION: QUIC_RECV_DROP_REASON = 1;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_DECRYPTION_FAILURE: QUIC_RECV_DROP_REASON = 2;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_DUPLICATE: QUIC_RECV_DROP_REASON = 3;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_KEY_UNAVAILABLE: QUIC_RECV_DROP_REASON = 4;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_QUEUE_FULL: QUIC_RECV_DROP_REASON = 5;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_OUT_OF_MEMORY: QUIC_RECV_DROP_REASON = 6;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_INVALID_TOKEN: QUIC_RECV_DROP_REASON = 7;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_FILTERED: QUIC_RECV_DROP_REASON = 8;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_UNEXPECTED: QUIC_RECV_DROP_REASON = 9;
+pub const QUIC_RECV_DROP_REASON_QUIC_RECV_DROP_REASON_COUNT: QUIC_RECV_DROP_REASON = 10;
+pub type QUIC_RECV_DROP_REASON = ::std::os::raw::c_uint;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_ALLOCATION_STATISTICS {
+    pub Tag: u32,
+    pub AllocationsPerSecond: u32,
+    pub LiveBytes: u64,
+    pub PeakBytes: u64,
+    pub TotalAllocations: u64,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_ALLOCATION_STATISTICS"]
+        [::std::mem::size_of::<QUIC_ALLOCATION_STATISTICS>() - 32usize];
+    ["Alignment of QUIC_ALLOCATION_STATISTICS"]
+        [::std::mem::align_of::<QUIC_ALLOCATION_STATISTICS>() - 8usize];
+    ["Offset of field: QUIC_ALLOCATION_STATISTICS::Tag"]
+        [::std::mem::offset_of!(QUIC_ALLOCATION_STATISTICS, Tag) - 0usize];
+    ["Offset of field: QUIC_ALLOCATION_STATISTICS::AllocationsPerSecond"]
+        [::std::mem::offset_of!(QUIC_ALLOCATION_STATISTICS, AllocationsPerSecond) - 4usize];
+    ["Offset of field: QUIC_ALLOCATION_STATISTICS::LiveBytes"]
+        [::std::mem::offset_of!(QUIC_ALLOCATION_STATISTICS, LiveBytes) - 8usize];
+    ["Offset of field: QUIC_ALLOCATION_STATISTICS::PeakBytes"]
+        [::std::mem::offset_of!(QUIC_ALLOCATION_STATISTICS, PeakBytes) - 16usize];
+    ["Offset of field: QUIC_ALLOCATION_STATISTICS::TotalAllocations"]
+        [::std::mem::offset_of!(QUIC_ALLOCATION_STATISTICS, TotalAllocations) - 24usize];
+};
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_CONNECTION: QUIC_OBJECT_SIZE_TYPE = 0;
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_HANDSHAKE_STATE: QUIC_OBJECT_SIZE_TYPE = 1;
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_STREAM: QUIC_OBJECT_SIZE_TYPE = 2;
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_PATH: QUIC_OBJECT_SIZE_TYPE = 3;
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_PACKET_SPACE: QUIC_OBJECT_SIZE_TYPE = 4;
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_TRANSPORT_PARAMETERS: QUIC_OBJECT_SIZE_TYPE = 5;
+pub const QUIC_OBJECT_SIZE_TYPE_QUIC_OBJECT_SIZE_COUNT: QUIC_OBJECT_SIZE_TYPE = 6;
+pub type QUIC_OBJECT_SIZE_TYPE = ::std::os::raw::c_uint;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_POOL_POLICY {
+    pub LowWatermark: u32,
+    pub HighWatermark: u32,
+    pub PruneCount: u16,
+    pub DecayPercent: u8,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_POOL_POLICY"][::std::mem::size_of::<QUIC_POOL_POLICY>() - 12usize];
+    ["Alignment of QUIC_POOL_POLICY"][::std::mem::align_of::<QUIC_POOL_POLICY>() - 4usize];
+    ["Offset of field: QUIC_POOL_POLICY::LowWatermark"]
+        [::std::mem::offset_of!(QUIC_POOL_POLICY, LowWatermark) - 0usize];
+    ["Offset of field: QUIC_POOL_POLICY::HighWatermark"]
+        [::std::mem::offset_of!(QUIC_POOL_POLICY, HighWatermark) - 4usize];
+    ["Offset of field: QUIC_POOL_POLICY::PruneCount"]
+        [::std::mem::offset_of!(QUIC_POOL_POLICY, PruneCount) - 8usize];
+    ["Offset of field: QUIC_POOL_POLICY::DecayPercent"]
+        [::std::mem::offset_of!(QUIC_POOL_POLICY, DecayPercent) - 10usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_POOL_STATISTICS {
+    pub EntrySize: u32,
+    pub FreeDepth: u32,
+    pub AllocCount: u64,
+    pub MissCount: u64,
+    pub PruneCount: u64,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_POOL_STATISTICS"][::std::mem::size_of::<QUIC_POOL_STATISTICS>() - 32usize];
+    ["Alignment of QUIC_POOL_STATISTICS"]
+        [::std::mem::align_of::<QUIC_POOL_STATISTICS>() - 8usize];
+    ["Offset of field: QUIC_POOL_STATISTICS::EntrySize"]
+        [::std::mem::offset_of!(QUIC_POOL_STATISTICS, EntrySize) - 0usize];
+    ["Offset of field: QUIC_POOL_STATISTICS::FreeDepth"]
+        [::std::mem::offset_of!(QUIC_POOL_STATISTICS, FreeDepth) - 4usize];
+    ["Offset of field: QUIC_POOL_STATISTICS::AllocCount"]
+        [::std::mem::offset_of!(QUIC_POOL_STATISTICS, AllocCount) - 8usize];
+    ["Offset of field: QUIC_POOL_STATISTICS::MissCount"]
+        [::std::mem::offset_of!(QUIC_POOL_STATISTICS, MissCount) - 16usize];
+    ["Offset of field: QUIC_POOL_STATISTICS::PruneCount"]
+        [::std::mem::offset_of!(QUIC_POOL_STATISTICS, PruneCount) - 24usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_PREWARM_CONFIG {
+    pub ConnectionCount: u32,
+    pub StreamCount: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_PREWARM_CONFIG"][::std::mem::size_of::<QUIC_PREWARM_CONFIG>() - 8usize];
+    ["Alignment of QUIC_PREWARM_CONFIG"][::std::mem::align_of::<QUIC_PREWARM_CONFIG>() - 4usize];
+    ["Offset of field: QUIC_PREWARM_CONFIG::ConnectionCount"]
+        [::std::mem::offset_of!(QUIC_PREWARM_CONFIG, ConnectionCount) - 0usize];
+    ["Offset of field: QUIC_PREWARM_CONFIG::StreamCount"]
+        [::std::mem::offset_of!(QUIC_PREWARM_CONFIG, StreamCount) - 4usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_INITIAL_FILTER_CONFIG {
+    pub Enabled: BOOLEAN,
+    pub BucketCount: u32,
+    pub WindowMs: u32,
+    pub RetryThreshold: u32,
+    pub DropThreshold: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_INITIAL_FILTER_CONFIG"]
+        [::std::mem::size_of::<QUIC_INITIAL_FILTER_CONFIG>() - 20usize];
+    ["Alignment of QUIC_INITIAL_FILTER_CONFIG"]
+        [::std::mem::align_of::<QUIC_INITIAL_FILTER_CONFIG>() - 4usize];
+    ["Offset of field: QUIC_INITIAL_FILTER_CONFIG::Enabled"]
+        [::std::mem::offset_of!(QUIC_INITIAL_FILTER_CONFIG, Enabled) - 0usize];
+    ["Offset of field: QUIC_INITIAL_FILTER_CONFIG::BucketCount"]
+        [::std::mem::offset_of!(QUIC_INITIAL_FILTER_CONFIG, BucketCount) - 4usize];
+    ["Offset of field: QUIC_INITIAL_FILTER_CONFIG::WindowMs"]
+        [::std::mem::offset_of!(QUIC_INITIAL_FILTER_CONFIG, WindowMs) - 8usize];
+    ["Offset of field: QUIC_INITIAL_FILTER_CONFIG::RetryThreshold"]
+        [::std::mem::offset_of!(QUIC_INITIAL_FILTER_CONFIG, RetryThreshold) - 12usize];
+    ["Offset of field: QUIC_INITIAL_FILTER_CONFIG::DropThreshold"]
+        [::std::mem::offset_of!(QUIC_INITIAL_FILTER_CONFIG, DropThreshold) - 16usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_QLOG_CONFIG {
+    pub SamplingInterval: u32,
+    pub BufferSize: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_QLOG_CONFIG"][::std::mem::size_of::<QUIC_QLOG_CONFIG>() - 8usize];
+    ["Alignment of QUIC_QLOG_CONFIG"][::std::mem::align_of::<QUIC_QLOG_CONFIG>() - 4usize];
+    ["Offset of field: QUIC_QLOG_CONFIG::SamplingInterval"]
+        [::std::mem::offset_of!(QUIC_QLOG_CONFIG, SamplingInterval) - 0usize];
+    ["Offset of field: QUIC_QLOG_CONFIG::BufferSize"]
+        [::std::mem::offset_of!(QUIC_QLOG_CONFIG, BufferSize) - 4usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_QLOG_HEADER {
+    pub Magic: u32,
+    pub Version: u16,
+    pub IsServer: u8,
+    pub Reserved: u8,
+    pub CorrelationId: u64,
+    pub StartTimeEpochMs: u64,
+    pub DroppedEvents: u32,
+    pub Length: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_QLOG_HEADER"][::std::mem::size_of::<QUIC_QLOG_HEADER>() - 32usize];
+    ["Alignment of QUIC_QLOG_HEADER"][::std::mem::align_of::<QUIC_QLOG_HEADER>() - 8usize];
+    ["Offset of field: QUIC_QLOG_HEADER::Magic"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, Magic) - 0usize];
+    ["Offset of field: QUIC_QLOG_HEADER::Version"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, Version) - 4usize];
+    ["Offset of field: QUIC_QLOG_HEADER::IsServer"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, IsServer) - 6usize];
+    ["Offset of field: QUIC_QLOG_HEADER::Reserved"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, Reserved) - 7usize];
+    ["Offset of field: QUIC_QLOG_HEADER::CorrelationId"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, CorrelationId) - 8usize];
+    ["Offset of field: QUIC_QLOG_HEADER::StartTimeEpochMs"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, StartTimeEpochMs) - 16usize];
+    ["Offset of field: QUIC_QLOG_HEADER::DroppedEvents"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, DroppedEvents) - 24usize];
+    ["Offset of field: QUIC_QLOG_HEADER::Length"]
+        [::std::mem::offset_of!(QUIC_QLOG_HEADER, Length) - 28usize];
+};
+pub const QUIC_QLOG_EVENT_TYPE_QUIC_QLOG_EVENT_PACKET_SENT: QUIC_QLOG_EVENT_TYPE = 0;
+pub const QUIC_QLOG_EVENT_TYPE_QUIC_QLOG_EVENT_PACKET_RECEIVED: QUIC_QLOG_EVENT_TYPE = 1;
+pub const QUIC_QLOG_EVENT_TYPE_QUIC_QLOG_EVENT_PACKET_LOST: QUIC_QLOG_EVENT_TYPE = 2;
+pub const QUIC_QLOG_EVENT_TYPE_QUIC_QLOG_EVENT_METRICS_UPDATED: QUIC_QLOG_EVENT_TYPE = 3;
+pub const QUIC_QLOG_EVENT_TYPE_QUIC_QLOG_EVENT_STREAM_STATE: QUIC_QLOG_EVENT_TYPE = 4;
+pub const QUIC_QLOG_EVENT_TYPE_QUIC_QLOG_EVENT_COUNT: QUIC_QLOG_EVENT_TYPE = 5;
+pub type QUIC_QLOG_EVENT_TYPE = ::std::os::raw::c_uint;
+pub const QUIC_QLOG_STREAM_STATE_QUIC_QLOG_STREAM_STATE_OPEN: QUIC_QLOG_STREAM_STATE = 0;
+pub const QUIC_QLOG_STREAM_STATE_QUIC_QLOG_STREAM_STATE_SEND_CLOSED: QUIC_QLOG_STREAM_STATE = 1;
+pub const QUIC_QLOG_STREAM_STATE_QUIC_QLOG_STREAM_STATE_CLOSED: QUIC_QLOG_STREAM_STATE = 2;
+pub type QUIC_QLOG_STREAM_STATE = ::std::os::raw::c_uint;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
 pub struct QUIC_EXECUTION_CONFIG {
     pub IdealProcessor: u32,
     pub EventQ: *mut QUIC_EVENTQ,
@@ -791,8 +1119,14 @@ pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_CU
     QUIC_CONGESTION_CONTROL_ALGORITHM = 0;
 pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_BBR:
     QUIC_CONGESTION_CONTROL_ALGORITHM = 1;
-pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_MAX:
+pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_BBR3:
     QUIC_CONGESTION_CONTROL_ALGORITHM = 2;
+pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_PRAGUE:
+    QUIC_CONGESTION_CONTROL_ALGORITHM = 3;
+pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_CUSTOM:
+    QUIC_CONGESTION_CONTROL_ALGORITHM = 4;
+pub const QUIC_CONGESTION_CONTROL_ALGORITHM_QUIC_CONGESTION_CONTROL_ALGORITHM_MAX:
+    QUIC_CONGESTION_CONTROL_ALGORITHM = 5;
 pub type QUIC_CONGESTION_CONTROL_ALGORITHM = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -1157,6 +1491,14 @@ impl QUIC_STATISTICS {
         __bindgen_bitfield_unit
     }
 }
+pub const QUIC_SLOW_START_EXIT_REASON_QUIC_SLOW_START_EXIT_REASON_NONE: QUIC_SLOW_START_EXIT_REASON = 0;
+pub const QUIC_SLOW_START_EXIT_REASON_QUIC_SLOW_START_EXIT_REASON_HYSTART: QUIC_SLOW_START_EXIT_REASON =
+    1;
+pub const QUIC_SLOW_START_EXIT_REASON_QUIC_SLOW_START_EXIT_REASON_LOSS: QUIC_SLOW_START_EXIT_REASON = 2;
+pub const QUIC_SLOW_START_EXIT_REASON_QUIC_SLOW_START_EXIT_REASON_ECN: QUIC_SLOW_START_EXIT_REASON = 3;
+pub const QUIC_SLOW_START_EXIT_REASON_QUIC_SLOW_START_EXIT_REASON_THRESHOLD:
+    QUIC_SLOW_START_EXIT_REASON = 4;
+pub type QUIC_SLOW_START_EXIT_REASON = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct QUIC_STATISTICS_V2 {
@@ -1195,10 +1537,23 @@ pub struct QUIC_STATISTICS_V2 {
     pub SendEcnCongestionCount: u32,
     pub HandshakeHopLimitTTL: u8,
     pub RttVariance: u32,
+    pub DrainBudget: u32,
+    pub SendPacketFillPercent: u32,
+    pub SlowStartExitReason: u32,
+    pub SlowStartExitCongestionWindow: u32,
+    pub SendSpuriousRetransmissions: u64,
+    pub SendPacketReorderThreshold: u32,
+    pub SendReorderWindowMultiplier: u32,
+    pub SendFecRepairSymbols: u64,
+    pub RecvFecRecoveredDatagrams: u64,
+    pub TimingHandshakeComplete: u64,
+    pub HandshakeQueueDelay: u32,
+    pub HandshakeTlsTime: u32,
+    pub HandshakeCertValidationTime: u32,
 }
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_STATISTICS_V2"][::std::mem::size_of::<QUIC_STATISTICS_V2>() - 208usize];
+    ["Size of QUIC_STATISTICS_V2"][::std::mem::size_of::<QUIC_STATISTICS_V2>() - 280usize];
     ["Alignment of QUIC_STATISTICS_V2"][::std::mem::align_of::<QUIC_STATISTICS_V2>() - 8usize];
     ["Offset of field: QUIC_STATISTICS_V2::CorrelationId"]
         [::std::mem::offset_of!(QUIC_STATISTICS_V2, CorrelationId) - 0usize];
@@ -1266,6 +1621,32 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_STATISTICS_V2, HandshakeHopLimitTTL) - 200usize];
     ["Offset of field: QUIC_STATISTICS_V2::RttVariance"]
         [::std::mem::offset_of!(QUIC_STATISTICS_V2, RttVariance) - 204usize];
+    ["Offset of field: QUIC_STATISTICS_V2::DrainBudget"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, DrainBudget) - 208usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendPacketFillPercent"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendPacketFillPercent) - 212usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SlowStartExitReason"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SlowStartExitReason) - 216usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SlowStartExitCongestionWindow"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SlowStartExitCongestionWindow) - 220usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendSpuriousRetransmissions"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendSpuriousRetransmissions) - 224usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendPacketReorderThreshold"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendPacketReorderThreshold) - 232usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendReorderWindowMultiplier"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendReorderWindowMultiplier) - 236usize];
+    ["Offset of field: QUIC_STATISTICS_V2::SendFecRepairSymbols"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, SendFecRepairSymbols) - 240usize];
+    ["Offset of field: QUIC_STATISTICS_V2::RecvFecRecoveredDatagrams"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, RecvFecRecoveredDatagrams) - 248usize];
+    ["Offset of field: QUIC_STATISTICS_V2::TimingHandshakeComplete"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, TimingHandshakeComplete) - 256usize];
+    ["Offset of field: QUIC_STATISTICS_V2::HandshakeQueueDelay"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, HandshakeQueueDelay) - 264usize];
+    ["Offset of field: QUIC_STATISTICS_V2::HandshakeTlsTime"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, HandshakeTlsTime) - 268usize];
+    ["Offset of field: QUIC_STATISTICS_V2::HandshakeCertValidationTime"]
+        [::std::mem::offset_of!(QUIC_STATISTICS_V2, HandshakeCertValidationTime) - 272usize];
 };
 impl QUIC_STATISTICS_V2 {
     #[inline]
@@ -1609,6 +1990,328 @@ const _: () = {
 };
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
+pub struct QUIC_NETWORK_STATISTICS_SAMPLING {
+    pub IntervalMs: u32,
+    pub SampleCount: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_NETWORK_STATISTICS_SAMPLING"]
+        [::std::mem::size_of::<QUIC_NETWORK_STATISTICS_SAMPLING>() - 8usize];
+    ["Alignment of QUIC_NETWORK_STATISTICS_SAMPLING"]
+        [::std::mem::align_of::<QUIC_NETWORK_STATISTICS_SAMPLING>() - 4usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLING::IntervalMs"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLING, IntervalMs) - 0usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLING::SampleCount"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLING, SampleCount) - 4usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_METRICS_SNAPSHOT {
+    pub TimeUs: u64,
+    pub PartitionCount: u32,
+    pub WorkerCount: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_METRICS_SNAPSHOT"][::std::mem::size_of::<QUIC_METRICS_SNAPSHOT>() - 16usize];
+    ["Alignment of QUIC_METRICS_SNAPSHOT"]
+        [::std::mem::align_of::<QUIC_METRICS_SNAPSHOT>() - 8usize];
+    ["Offset of field: QUIC_METRICS_SNAPSHOT::TimeUs"]
+        [::std::mem::offset_of!(QUIC_METRICS_SNAPSHOT, TimeUs) - 0usize];
+    ["Offset of field: QUIC_METRICS_SNAPSHOT::PartitionCount"]
+        [::std::mem::offset_of!(QUIC_METRICS_SNAPSHOT, PartitionCount) - 8usize];
+    ["Offset of field: QUIC_METRICS_SNAPSHOT::WorkerCount"]
+        [::std::mem::offset_of!(QUIC_METRICS_SNAPSHOT, WorkerCount) - 12usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_NETWORK_STATISTICS_SAMPLE {
+    pub TimeUs: u64,
+    pub SmoothedRtt: u64,
+    pub MinRtt: u64,
+    pub RttVariance: u64,
+    pub Bandwidth: u64,
+    pub LostPackets: u64,
+    pub CongestionWindow: u32,
+    pub BytesInFlight: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_NETWORK_STATISTICS_SAMPLE"]
+        [::std::mem::size_of::<QUIC_NETWORK_STATISTICS_SAMPLE>() - 56usize];
+    ["Alignment of QUIC_NETWORK_STATISTICS_SAMPLE"]
+        [::std::mem::align_of::<QUIC_NETWORK_STATISTICS_SAMPLE>() - 8usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::TimeUs"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, TimeUs) - 0usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::SmoothedRtt"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, SmoothedRtt) - 8usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::MinRtt"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, MinRtt) - 16usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::RttVariance"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, RttVariance) - 24usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::Bandwidth"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, Bandwidth) - 32usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::LostPackets"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, LostPackets) - 40usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::CongestionWindow"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, CongestionWindow) - 48usize];
+    ["Offset of field: QUIC_NETWORK_STATISTICS_SAMPLE::BytesInFlight"]
+        [::std::mem::offset_of!(QUIC_NETWORK_STATISTICS_SAMPLE, BytesInFlight) - 52usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_CONGESTION_CONTROL_ACK_EVENT {
+    pub TimeNow: u64,
+    pub LargestAck: u64,
+    pub LargestSentPacketNumber: u64,
+    pub TotalAckedRetransmittableBytes: u64,
+    pub SmoothedRtt: u64,
+    pub MinRtt: u64,
+    pub OneWayDelay: u64,
+    pub AdjustedAckTime: u64,
+    pub NumRetransmittableBytes: u32,
+    pub BytesInFlight: u32,
+    pub DatagramPayloadSize: u16,
+    pub IsImplicit: BOOLEAN,
+    pub HasLoss: BOOLEAN,
+    pub IsLargestAckedPacketAppLimited: BOOLEAN,
+    pub MinRttValid: BOOLEAN,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_CONGESTION_CONTROL_ACK_EVENT"][::std::mem::size_of::<QUIC_CONGESTION_CONTROL_ACK_EVENT>() - 80usize];
+    ["Alignment of QUIC_CONGESTION_CONTROL_ACK_EVENT"][::std::mem::align_of::<QUIC_CONGESTION_CONTROL_ACK_EVENT>() - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::TimeNow"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, TimeNow) - 0usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::LargestAck"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, LargestAck) - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::LargestSentPacketNumber"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, LargestSentPacketNumber) - 16usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::TotalAckedRetransmittableBytes"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, TotalAckedRetransmittableBytes) - 24usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::SmoothedRtt"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, SmoothedRtt) - 32usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::MinRtt"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, MinRtt) - 40usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::OneWayDelay"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, OneWayDelay) - 48usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::AdjustedAckTime"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, AdjustedAckTime) - 56usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::NumRetransmittableBytes"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, NumRetransmittableBytes) - 64usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::BytesInFlight"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, BytesInFlight) - 68usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::DatagramPayloadSize"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, DatagramPayloadSize) - 72usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::IsImplicit"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, IsImplicit) - 74usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::HasLoss"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, HasLoss) - 75usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::IsLargestAckedPacketAppLimited"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, IsLargestAckedPacketAppLimited) - 76usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ACK_EVENT::MinRttValid"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ACK_EVENT, MinRttValid) - 77usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_CONGESTION_CONTROL_LOSS_EVENT {
+    pub LargestPacketNumberLost: u64,
+    pub LargestSentPacketNumber: u64,
+    pub NumRetransmittableBytes: u32,
+    pub BytesInFlight: u32,
+    pub DatagramPayloadSize: u16,
+    pub PersistentCongestion: BOOLEAN,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_CONGESTION_CONTROL_LOSS_EVENT"][::std::mem::size_of::<QUIC_CONGESTION_CONTROL_LOSS_EVENT>() - 32usize];
+    ["Alignment of QUIC_CONGESTION_CONTROL_LOSS_EVENT"][::std::mem::align_of::<QUIC_CONGESTION_CONTROL_LOSS_EVENT>() - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_LOSS_EVENT::LargestPacketNumberLost"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_LOSS_EVENT, LargestPacketNumberLost) - 0usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_LOSS_EVENT::LargestSentPacketNumber"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_LOSS_EVENT, LargestSentPacketNumber) - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_LOSS_EVENT::NumRetransmittableBytes"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_LOSS_EVENT, NumRetransmittableBytes) - 16usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_LOSS_EVENT::BytesInFlight"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_LOSS_EVENT, BytesInFlight) - 20usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_LOSS_EVENT::DatagramPayloadSize"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_LOSS_EVENT, DatagramPayloadSize) - 24usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_LOSS_EVENT::PersistentCongestion"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_LOSS_EVENT, PersistentCongestion) - 26usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_CONGESTION_CONTROL_ECN_EVENT {
+    pub LargestPacketNumberAcked: u64,
+    pub LargestSentPacketNumber: u64,
+    pub NewCePackets: u32,
+    pub BytesInFlight: u32,
+    pub DatagramPayloadSize: u16,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_CONGESTION_CONTROL_ECN_EVENT"][::std::mem::size_of::<QUIC_CONGESTION_CONTROL_ECN_EVENT>() - 32usize];
+    ["Alignment of QUIC_CONGESTION_CONTROL_ECN_EVENT"][::std::mem::align_of::<QUIC_CONGESTION_CONTROL_ECN_EVENT>() - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ECN_EVENT::LargestPacketNumberAcked"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ECN_EVENT, LargestPacketNumberAcked) - 0usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ECN_EVENT::LargestSentPacketNumber"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ECN_EVENT, LargestSentPacketNumber) - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ECN_EVENT::NewCePackets"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ECN_EVENT, NewCePackets) - 16usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ECN_EVENT::BytesInFlight"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ECN_EVENT, BytesInFlight) - 20usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_ECN_EVENT::DatagramPayloadSize"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_ECN_EVENT, DatagramPayloadSize) - 24usize];
+};
+pub type QUIC_CONGESTION_CONTROL_CREATE_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Context: *mut ::std::os::raw::c_void,
+        Connection: HQUIC,
+        DatagramPayloadSize: u16,
+        InitialWindowPackets: u32,
+        State: *mut *mut ::std::os::raw::c_void,
+    ) -> QUIC_STATUS,
+>;
+pub type QUIC_CONGESTION_CONTROL_DELETE_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+    ),
+>;
+pub type QUIC_CONGESTION_CONTROL_RESET_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+        FullReset: BOOLEAN,
+    ),
+>;
+pub type QUIC_CONGESTION_CONTROL_GET_CONGESTION_WINDOW_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+    ) -> u32,
+>;
+pub type QUIC_CONGESTION_CONTROL_GET_PACING_RATE_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+    ) -> u64,
+>;
+pub type QUIC_CONGESTION_CONTROL_ON_DATA_SENT_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+        NumRetransmittableBytes: u32,
+        BytesInFlight: u32,
+    ),
+>;
+pub type QUIC_CONGESTION_CONTROL_ON_DATA_ACKNOWLEDGED_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+        AckEvent: *const QUIC_CONGESTION_CONTROL_ACK_EVENT,
+    ),
+>;
+pub type QUIC_CONGESTION_CONTROL_ON_DATA_LOST_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+        LossEvent: *const QUIC_CONGESTION_CONTROL_LOSS_EVENT,
+    ),
+>;
+pub type QUIC_CONGESTION_CONTROL_ON_ECN_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+        EcnEvent: *const QUIC_CONGESTION_CONTROL_ECN_EVENT,
+    ),
+>;
+pub type QUIC_CONGESTION_CONTROL_ON_SPURIOUS_CONGESTION_EVENT_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        State: *mut ::std::os::raw::c_void,
+    ),
+>;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_CONGESTION_CONTROL_CALLBACKS {
+    pub Name: *const ::std::os::raw::c_char,
+    pub Context: *mut ::std::os::raw::c_void,
+    pub IsL4S: BOOLEAN,
+    pub Create: QUIC_CONGESTION_CONTROL_CREATE_FN,
+    pub Delete: QUIC_CONGESTION_CONTROL_DELETE_FN,
+    pub Reset: QUIC_CONGESTION_CONTROL_RESET_FN,
+    pub GetCongestionWindow: QUIC_CONGESTION_CONTROL_GET_CONGESTION_WINDOW_FN,
+    pub GetPacingRate: QUIC_CONGESTION_CONTROL_GET_PACING_RATE_FN,
+    pub OnDataSent: QUIC_CONGESTION_CONTROL_ON_DATA_SENT_FN,
+    pub OnDataAcknowledged: QUIC_CONGESTION_CONTROL_ON_DATA_ACKNOWLEDGED_FN,
+    pub OnDataLost: QUIC_CONGESTION_CONTROL_ON_DATA_LOST_FN,
+    pub OnEcn: QUIC_CONGESTION_CONTROL_ON_ECN_FN,
+    pub OnSpuriousCongestionEvent: QUIC_CONGESTION_CONTROL_ON_SPURIOUS_CONGESTION_EVENT_FN,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_CONGESTION_CONTROL_CALLBACKS"][::std::mem::size_of::<QUIC_CONGESTION_CONTROL_CALLBACKS>() - 104usize];
+    ["Alignment of QUIC_CONGESTION_CONTROL_CALLBACKS"][::std::mem::align_of::<QUIC_CONGESTION_CONTROL_CALLBACKS>() - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::Name"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, Name) - 0usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::Context"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, Context) - 8usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::IsL4S"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, IsL4S) - 16usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::Create"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, Create) - 24usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::Delete"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, Delete) - 32usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::Reset"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, Reset) - 40usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::GetCongestionWindow"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, GetCongestionWindow) - 48usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::GetPacingRate"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, GetPacingRate) - 56usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::OnDataSent"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, OnDataSent) - 64usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::OnDataAcknowledged"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, OnDataAcknowledged) - 72usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::OnDataLost"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, OnDataLost) - 80usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::OnEcn"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, OnEcn) - 88usize];
+    ["Offset of field: QUIC_CONGESTION_CONTROL_CALLBACKS::OnSpuriousCongestionEvent"]
+        [::std::mem::offset_of!(QUIC_CONGESTION_CONTROL_CALLBACKS, OnSpuriousCongestionEvent) - 96usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_REGISTRATION_QUOTA {
+    pub MaxBufferedBytes: u64,
+    pub MaxConnections: u32,
+    pub WorkerCpuSharePercent: u8,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_REGISTRATION_QUOTA"][::std::mem::size_of::<QUIC_REGISTRATION_QUOTA>() - 16usize];
+    ["Alignment of QUIC_REGISTRATION_QUOTA"]
+        [::std::mem::align_of::<QUIC_REGISTRATION_QUOTA>() - 8usize];
+    ["Offset of field: QUIC_REGISTRATION_QUOTA::MaxBufferedBytes"]
+        [::std::mem::offset_of!(QUIC_REGISTRATION_QUOTA, MaxBufferedBytes) - 0usize];
+    ["Offset of field: QUIC_REGISTRATION_QUOTA::MaxConnections"]
+        [::std::mem::offset_of!(QUIC_REGISTRATION_QUOTA, MaxConnections) - 8usize];
+    ["Offset of field: QUIC_REGISTRATION_QUOTA::WorkerCpuSharePercent"]
+        [::std::mem::offset_of!(QUIC_REGISTRATION_QUOTA, WorkerCpuSharePercent) - 12usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_REGISTRATION_USAGE {
+    pub BufferedBytes: u64,
+    pub WorkerTimeUs: u64,
+    pub ConnectionCount: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_REGISTRATION_USAGE"][::std::mem::size_of::<QUIC_REGISTRATION_USAGE>() - 24usize];
+    ["Alignment of QUIC_REGISTRATION_USAGE"]
+        [::std::mem::align_of::<QUIC_REGISTRATION_USAGE>() - 8usize];
+    ["Offset of field: QUIC_REGISTRATION_USAGE::BufferedBytes"]
+        [::std::mem::offset_of!(QUIC_REGISTRATION_USAGE, BufferedBytes) - 0usize];
+    ["Offset of field: QUIC_REGISTRATION_USAGE::WorkerTimeUs"]
+        [::std::mem::offset_of!(QUIC_REGISTRATION_USAGE, WorkerTimeUs) - 8usize];
+    ["Offset of field: QUIC_REGISTRATION_USAGE::ConnectionCount"]
+        [::std::mem::offset_of!(QUIC_REGISTRATION_USAGE, ConnectionCount) - 16usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
 pub struct QUIC_LISTENER_STATISTICS {
     pub TotalAcceptedConnections: u64,
     pub TotalRejectedConnections: u64,
@@ -1683,8 +2386,40 @@ pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_CONN_LOAD_REJECT: QUIC_PER
     31;
 pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_LISTEN_QUEUE_DEPTH:
     QUIC_PERFORMANCE_COUNTERS = 32;
-pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MAX: QUIC_PERFORMANCE_COUNTERS = 33;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_TIMER_WHEEL_CASCADES:
+    QUIC_PERFORMANCE_COUNTERS = 33;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MEMORY_PRESSURE: QUIC_PERFORMANCE_COUNTERS =
+    34;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_CONN_MEMORY_REJECT:
+    QUIC_PERFORMANCE_COUNTERS = 35;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_APP_CALLBACK_SLOW:
+    QUIC_PERFORMANCE_COUNTERS = 36;
+pub const QUIC_PERFORMANCE_COUNTERS_QUIC_PERF_COUNTER_MAX: QUIC_PERFORMANCE_COUNTERS = 37;
 pub type QUIC_PERFORMANCE_COUNTERS = ::std::os::raw::c_uint;
+pub const QUIC_SLOW_CALLBACK_MAX_EVENT_TYPES: u32 = 32;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_SLOW_CALLBACK_STATISTICS {
+    pub MaxDurationUs: u64,
+    pub Listener: [u64; 32usize],
+    pub Connection: [u64; 32usize],
+    pub Stream: [u64; 32usize],
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_SLOW_CALLBACK_STATISTICS"]
+        [::std::mem::size_of::<QUIC_SLOW_CALLBACK_STATISTICS>() - 776usize];
+    ["Alignment of QUIC_SLOW_CALLBACK_STATISTICS"]
+        [::std::mem::align_of::<QUIC_SLOW_CALLBACK_STATISTICS>() - 8usize];
+    ["Offset of field: QUIC_SLOW_CALLBACK_STATISTICS::MaxDurationUs"]
+        [::std::mem::offset_of!(QUIC_SLOW_CALLBACK_STATISTICS, MaxDurationUs) - 0usize];
+    ["Offset of field: QUIC_SLOW_CALLBACK_STATISTICS::Listener"]
+        [::std::mem::offset_of!(QUIC_SLOW_CALLBACK_STATISTICS, Listener) - 8usize];
+    ["Offset of field: QUIC_SLOW_CALLBACK_STATISTICS::Connection"]
+        [::std::mem::offset_of!(QUIC_SLOW_CALLBACK_STATISTICS, Connection) - 264usize];
+    ["Offset of field: QUIC_SLOW_CALLBACK_STATISTICS::Stream"]
+        [::std::mem::offset_of!(QUIC_SLOW_CALLBACK_STATISTICS, Stream) - 520usize];
+};
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct QUIC_VERSION_SETTINGS {
@@ -1720,6 +2455,7 @@ pub struct QUIC_GLOBAL_SETTINGS {
     pub RetryMemoryLimit: u16,
     pub LoadBalancingMode: u16,
     pub FixedServerID: u32,
+    pub HugePageMode: u16,
 }
 #[repr(C)]
 #[derive(Copy, Clone)]
@@ -1841,14 +2577,47 @@ impl QUIC_GLOBAL_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         }
     }
     #[inline]
+    pub fn HugePageMode(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(3usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_HugePageMode(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(3usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn HugePageMode_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                3usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_HugePageMode_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                3usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
     pub fn RESERVED(&self) -> u64 {
-        unsafe { ::std::mem::transmute(self._bitfield_1.get(3usize, 61u8) as u64) }
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(4usize, 60u8) as u64) }
     }
     #[inline]
     pub fn set_RESERVED(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
-            self._bitfield_1.set(3usize, 61u8, val as u64)
+            self._bitfield_1.set(4usize, 60u8, val as u64)
         }
     }
     #[inline]
@@ -1856,8 +2625,8 @@ impl QUIC_GLOBAL_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
-                3usize,
-                61u8,
+                4usize,
+                60u8,
             ) as u64)
         }
     }
@@ -1867,8 +2636,8 @@ impl QUIC_GLOBAL_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                3usize,
-                61u8,
+                4usize,
+                60u8,
                 val as u64,
             )
         }
@@ -1878,6 +2647,7 @@ impl QUIC_GLOBAL_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         RetryMemoryLimit: u64,
         LoadBalancingMode: u64,
         FixedServerID: u64,
+        HugePageMode: u64,
         RESERVED: u64,
     ) -> __BindgenBitfieldUnit<[u8; 8usize]> {
         let mut __bindgen_bitfield_unit: __BindgenBitfieldUnit<[u8; 8usize]> = Default::default();
@@ -1893,7 +2663,11 @@ impl QUIC_GLOBAL_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
             let FixedServerID: u64 = unsafe { ::std::mem::transmute(FixedServerID) };
             FixedServerID as u64
         });
-        __bindgen_bitfield_unit.set(3usize, 61u8, {
+        __bindgen_bitfield_unit.set(3usize, 1u8, {
+            let HugePageMode: u64 = unsafe { ::std::mem::transmute(HugePageMode) };
+            HugePageMode as u64
+        });
+        __bindgen_bitfield_unit.set(4usize, 60u8, {
             let RESERVED: u64 = unsafe { ::std::mem::transmute(RESERVED) };
             RESERVED as u64
         });
@@ -1913,7 +2687,7 @@ const _: () = {
 };
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_GLOBAL_SETTINGS"][::std::mem::size_of::<QUIC_GLOBAL_SETTINGS>() - 16usize];
+    ["Size of QUIC_GLOBAL_SETTINGS"][::std::mem::size_of::<QUIC_GLOBAL_SETTINGS>() - 24usize];
     ["Alignment of QUIC_GLOBAL_SETTINGS"][::std::mem::align_of::<QUIC_GLOBAL_SETTINGS>() - 8usize];
     ["Offset of field: QUIC_GLOBAL_SETTINGS::RetryMemoryLimit"]
         [::std::mem::offset_of!(QUIC_GLOBAL_SETTINGS, RetryMemoryLimit) - 8usize];
@@ -1921,6 +2695,8 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_GLOBAL_SETTINGS, LoadBalancingMode) - 10usize];
     ["Offset of field: QUIC_GLOBAL_SETTINGS::FixedServerID"]
         [::std::mem::offset_of!(QUIC_GLOBAL_SETTINGS, FixedServerID) - 12usize];
+    ["Offset of field: QUIC_GLOBAL_SETTINGS::HugePageMode"]
+        [::std::mem::offset_of!(QUIC_GLOBAL_SETTINGS, HugePageMode) - 16usize];
 };
 #[repr(C)]
 #[derive(Copy, Clone)]
@@ -1959,6 +2735,12 @@ pub struct QUIC_SETTINGS {
     pub StreamRecvWindowBidiLocalDefault: u32,
     pub StreamRecvWindowBidiRemoteDefault: u32,
     pub StreamRecvWindowUnidiDefault: u32,
+    pub IdleTimerSlackMs: u32,
+    pub KeepAliveTimerSlackMs: u32,
+    pub ShutdownTimerSlackMs: u32,
+    pub AckDecimationMaxPackets: u32,
+    pub PacingBurstPackets: u32,
+    pub IdleHibernateTimeoutMs: u32,
 }
 #[repr(C)]
 #[derive(Copy, Clone)]
@@ -3389,111 +4171,441 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         }
     }
     #[inline]
-    pub unsafe fn set_StreamMultiReceiveEnabled_raw(this: *mut Self, val: u64) {
+    pub unsafe fn set_StreamMultiReceiveEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                42usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn XdpEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(43usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_XdpEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(43usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn XdpEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                43usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_XdpEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                43usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn QTIPEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(44usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_QTIPEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(44usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn QTIPEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                44usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_QTIPEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                44usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn ReservedRioEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(45usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_ReservedRioEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(45usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn ReservedRioEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                45usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_ReservedRioEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                45usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn IdleTimerSlackMs(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(46usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_IdleTimerSlackMs(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(46usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn IdleTimerSlackMs_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                46usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_IdleTimerSlackMs_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                46usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn KeepAliveTimerSlackMs(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(47usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_KeepAliveTimerSlackMs(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(47usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn KeepAliveTimerSlackMs_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                47usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_KeepAliveTimerSlackMs_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                47usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn ShutdownTimerSlackMs(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(48usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_ShutdownTimerSlackMs(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(48usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn ShutdownTimerSlackMs_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                48usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_ShutdownTimerSlackMs_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                48usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn AckDecimationMaxPackets(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(49usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_AckDecimationMaxPackets(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(49usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn AckDecimationMaxPackets_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                49usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_AckDecimationMaxPackets_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                49usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn DatacenterModeEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(50usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_DatacenterModeEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(50usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn DatacenterModeEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                50usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_DatacenterModeEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                50usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn FecEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(51usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_FecEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(51usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn FecEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                51usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_FecEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                51usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn PathMetricsCacheEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(52usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_PathMetricsCacheEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(52usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn PathMetricsCacheEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                52usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_PathMetricsCacheEnabled_raw(this: *mut Self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                42usize,
+                52usize,
                 1u8,
                 val as u64,
             )
         }
     }
     #[inline]
-    pub fn XdpEnabled(&self) -> u64 {
-        unsafe { ::std::mem::transmute(self._bitfield_1.get(43usize, 1u8) as u64) }
+    pub fn PacingBurstPackets(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(53usize, 1u8) as u64) }
     }
     #[inline]
-    pub fn set_XdpEnabled(&mut self, val: u64) {
+    pub fn set_PacingBurstPackets(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
-            self._bitfield_1.set(43usize, 1u8, val as u64)
+            self._bitfield_1.set(53usize, 1u8, val as u64)
         }
     }
     #[inline]
-    pub unsafe fn XdpEnabled_raw(this: *const Self) -> u64 {
+    pub unsafe fn PacingBurstPackets_raw(this: *const Self) -> u64 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
-                43usize,
+                53usize,
                 1u8,
             ) as u64)
         }
     }
     #[inline]
-    pub unsafe fn set_XdpEnabled_raw(this: *mut Self, val: u64) {
+    pub unsafe fn set_PacingBurstPackets_raw(this: *mut Self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                43usize,
+                53usize,
                 1u8,
                 val as u64,
             )
         }
     }
     #[inline]
-    pub fn QTIPEnabled(&self) -> u64 {
-        unsafe { ::std::mem::transmute(self._bitfield_1.get(44usize, 1u8) as u64) }
+    pub fn StreamZeroCopyReceiveEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(54usize, 1u8) as u64) }
     }
     #[inline]
-    pub fn set_QTIPEnabled(&mut self, val: u64) {
+    pub fn set_StreamZeroCopyReceiveEnabled(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
-            self._bitfield_1.set(44usize, 1u8, val as u64)
+            self._bitfield_1.set(54usize, 1u8, val as u64)
         }
     }
     #[inline]
-    pub unsafe fn QTIPEnabled_raw(this: *const Self) -> u64 {
+    pub unsafe fn StreamZeroCopyReceiveEnabled_raw(this: *const Self) -> u64 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
-                44usize,
+                54usize,
                 1u8,
             ) as u64)
         }
     }
     #[inline]
-    pub unsafe fn set_QTIPEnabled_raw(this: *mut Self, val: u64) {
+    pub unsafe fn set_StreamZeroCopyReceiveEnabled_raw(this: *mut Self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                44usize,
+                54usize,
                 1u8,
                 val as u64,
             )
         }
     }
     #[inline]
-    pub fn ReservedRioEnabled(&self) -> u64 {
-        unsafe { ::std::mem::transmute(self._bitfield_1.get(45usize, 1u8) as u64) }
+    pub fn IdleHibernateTimeoutMs(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(55usize, 1u8) as u64) }
     }
     #[inline]
-    pub fn set_ReservedRioEnabled(&mut self, val: u64) {
+    pub fn set_IdleHibernateTimeoutMs(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
-            self._bitfield_1.set(45usize, 1u8, val as u64)
+            self._bitfield_1.set(55usize, 1u8, val as u64)
         }
     }
     #[inline]
-    pub unsafe fn ReservedRioEnabled_raw(this: *const Self) -> u64 {
+    pub unsafe fn IdleHibernateTimeoutMs_raw(this: *const Self) -> u64 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
-                45usize,
+                55usize,
                 1u8,
             ) as u64)
         }
     }
     #[inline]
-    pub unsafe fn set_ReservedRioEnabled_raw(this: *mut Self, val: u64) {
+    pub unsafe fn set_IdleHibernateTimeoutMs_raw(this: *mut Self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                45usize,
+                55usize,
                 1u8,
                 val as u64,
             )
@@ -3501,13 +4613,13 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
     }
     #[inline]
     pub fn RESERVED(&self) -> u64 {
-        unsafe { ::std::mem::transmute(self._bitfield_1.get(46usize, 18u8) as u64) }
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(56usize, 8u8) as u64) }
     }
     #[inline]
     pub fn set_RESERVED(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
-            self._bitfield_1.set(46usize, 18u8, val as u64)
+            self._bitfield_1.set(56usize, 8u8, val as u64)
         }
     }
     #[inline]
@@ -3515,8 +4627,8 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
-                46usize,
-                18u8,
+                56usize,
+                8u8,
             ) as u64)
         }
     }
@@ -3526,8 +4638,8 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                46usize,
-                18u8,
+                56usize,
+                8u8,
                 val as u64,
             )
         }
@@ -3580,6 +4692,16 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
         XdpEnabled: u64,
         QTIPEnabled: u64,
         ReservedRioEnabled: u64,
+        IdleTimerSlackMs: u64,
+        KeepAliveTimerSlackMs: u64,
+        ShutdownTimerSlackMs: u64,
+        AckDecimationMaxPackets: u64,
+        DatacenterModeEnabled: u64,
+        FecEnabled: u64,
+        PathMetricsCacheEnabled: u64,
+        PacingBurstPackets: u64,
+        StreamZeroCopyReceiveEnabled: u64,
+        IdleHibernateTimeoutMs: u64,
         RESERVED: u64,
     ) -> __BindgenBitfieldUnit<[u8; 8usize]> {
         let mut __bindgen_bitfield_unit: __BindgenBitfieldUnit<[u8; 8usize]> = Default::default();
@@ -3789,7 +4911,53 @@ impl QUIC_SETTINGS__bindgen_ty_1__bindgen_ty_1 {
             let ReservedRioEnabled: u64 = unsafe { ::std::mem::transmute(ReservedRioEnabled) };
             ReservedRioEnabled as u64
         });
-        __bindgen_bitfield_unit.set(46usize, 18u8, {
+        __bindgen_bitfield_unit.set(46usize, 1u8, {
+            let IdleTimerSlackMs: u64 = unsafe { ::std::mem::transmute(IdleTimerSlackMs) };
+            IdleTimerSlackMs as u64
+        });
+        __bindgen_bitfield_unit.set(47usize, 1u8, {
+            let KeepAliveTimerSlackMs: u64 =
+                unsafe { ::std::mem::transmute(KeepAliveTimerSlackMs) };
+            KeepAliveTimerSlackMs as u64
+        });
+        __bindgen_bitfield_unit.set(48usize, 1u8, {
+            let ShutdownTimerSlackMs: u64 = unsafe { ::std::mem::transmute(ShutdownTimerSlackMs) };
+            ShutdownTimerSlackMs as u64
+        });
+        __bindgen_bitfield_unit.set(49usize, 1u8, {
+            let AckDecimationMaxPackets: u64 =
+                unsafe { ::std::mem::transmute(AckDecimationMaxPackets) };
+            AckDecimationMaxPackets as u64
+        });
+        __bindgen_bitfield_unit.set(50usize, 1u8, {
+            let DatacenterModeEnabled: u64 =
+                unsafe { ::std::mem::transmute(DatacenterModeEnabled) };
+            DatacenterModeEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(51usize, 1u8, {
+            let FecEnabled: u64 = unsafe { ::std::mem::transmute(FecEnabled) };
+            FecEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(52usize, 1u8, {
+            let PathMetricsCacheEnabled: u64 =
+                unsafe { ::std::mem::transmute(PathMetricsCacheEnabled) };
+            PathMetricsCacheEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(53usize, 1u8, {
+            let PacingBurstPackets: u64 = unsafe { ::std::mem::transmute(PacingBurstPackets) };
+            PacingBurstPackets as u64
+        });
+        __bindgen_bitfield_unit.set(54usize, 1u8, {
+            let StreamZeroCopyReceiveEnabled: u64 =
+                unsafe { ::std::mem::transmute(StreamZeroCopyReceiveEnabled) };
+            StreamZeroCopyReceiveEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(55usize, 1u8, {
+            let IdleHibernateTimeoutMs: u64 =
+                unsafe { ::std::mem::transmute(IdleHibernateTimeoutMs) };
+            IdleHibernateTimeoutMs as u64
+        });
+        __bindgen_bitfield_unit.set(56usize, 8u8, {
             let RESERVED: u64 = unsafe { ::std::mem::transmute(RESERVED) };
             RESERVED as u64
         });
@@ -4125,14 +5293,146 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
         }
     }
     #[inline]
+    pub fn DatacenterModeEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(9usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_DatacenterModeEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(9usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn DatacenterModeEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                9usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_DatacenterModeEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                9usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn FecEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(10usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_FecEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(10usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn FecEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                10usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_FecEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                10usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn PathMetricsCacheEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(11usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_PathMetricsCacheEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(11usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn PathMetricsCacheEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                11usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_PathMetricsCacheEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                11usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
+    pub fn StreamZeroCopyReceiveEnabled(&self) -> u64 {
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(12usize, 1u8) as u64) }
+    }
+    #[inline]
+    pub fn set_StreamZeroCopyReceiveEnabled(&mut self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            self._bitfield_1.set(12usize, 1u8, val as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn StreamZeroCopyReceiveEnabled_raw(this: *const Self) -> u64 {
+        unsafe {
+            ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
+                ::std::ptr::addr_of!((*this)._bitfield_1),
+                12usize,
+                1u8,
+            ) as u64)
+        }
+    }
+    #[inline]
+    pub unsafe fn set_StreamZeroCopyReceiveEnabled_raw(this: *mut Self, val: u64) {
+        unsafe {
+            let val: u64 = ::std::mem::transmute(val);
+            <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
+                ::std::ptr::addr_of_mut!((*this)._bitfield_1),
+                12usize,
+                1u8,
+                val as u64,
+            )
+        }
+    }
+    #[inline]
     pub fn ReservedFlags(&self) -> u64 {
-        unsafe { ::std::mem::transmute(self._bitfield_1.get(9usize, 55u8) as u64) }
+        unsafe { ::std::mem::transmute(self._bitfield_1.get(13usize, 51u8) as u64) }
     }
     #[inline]
     pub fn set_ReservedFlags(&mut self, val: u64) {
         unsafe {
             let val: u64 = ::std::mem::transmute(val);
-            self._bitfield_1.set(9usize, 55u8, val as u64)
+            self._bitfield_1.set(13usize, 51u8, val as u64)
         }
     }
     #[inline]
@@ -4140,8 +5440,8 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
         unsafe {
             ::std::mem::transmute(<__BindgenBitfieldUnit<[u8; 8usize]>>::raw_get(
                 ::std::ptr::addr_of!((*this)._bitfield_1),
-                9usize,
-                55u8,
+                13usize,
+                51u8,
             ) as u64)
         }
     }
@@ -4151,8 +5451,8 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
             let val: u64 = ::std::mem::transmute(val);
             <__BindgenBitfieldUnit<[u8; 8usize]>>::raw_set(
                 ::std::ptr::addr_of_mut!((*this)._bitfield_1),
-                9usize,
-                55u8,
+                13usize,
+                51u8,
                 val as u64,
             )
         }
@@ -4168,6 +5468,10 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
         XdpEnabled: u64,
         QTIPEnabled: u64,
         ReservedRioEnabled: u64,
+        DatacenterModeEnabled: u64,
+        FecEnabled: u64,
+        PathMetricsCacheEnabled: u64,
+        StreamZeroCopyReceiveEnabled: u64,
         ReservedFlags: u64,
     ) -> __BindgenBitfieldUnit<[u8; 8usize]> {
         let mut __bindgen_bitfield_unit: __BindgenBitfieldUnit<[u8; 8usize]> = Default::default();
@@ -4209,7 +5513,26 @@ impl QUIC_SETTINGS__bindgen_ty_2__bindgen_ty_1 {
             let ReservedRioEnabled: u64 = unsafe { ::std::mem::transmute(ReservedRioEnabled) };
             ReservedRioEnabled as u64
         });
-        __bindgen_bitfield_unit.set(9usize, 55u8, {
+        __bindgen_bitfield_unit.set(9usize, 1u8, {
+            let DatacenterModeEnabled: u64 =
+                unsafe { ::std::mem::transmute(DatacenterModeEnabled) };
+            DatacenterModeEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(10usize, 1u8, {
+            let FecEnabled: u64 = unsafe { ::std::mem::transmute(FecEnabled) };
+            FecEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(11usize, 1u8, {
+            let PathMetricsCacheEnabled: u64 =
+                unsafe { ::std::mem::transmute(PathMetricsCacheEnabled) };
+            PathMetricsCacheEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(12usize, 1u8, {
+            let StreamZeroCopyReceiveEnabled: u64 =
+                unsafe { ::std::mem::transmute(StreamZeroCopyReceiveEnabled) };
+            StreamZeroCopyReceiveEnabled as u64
+        });
+        __bindgen_bitfield_unit.set(13usize, 51u8, {
             let ReservedFlags: u64 = unsafe { ::std::mem::transmute(ReservedFlags) };
             ReservedFlags as u64
         });
@@ -4227,7 +5550,7 @@ const _: () = {
 };
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_SETTINGS"][::std::mem::size_of::<QUIC_SETTINGS>() - 144usize];
+    ["Size of QUIC_SETTINGS"][::std::mem::size_of::<QUIC_SETTINGS>() - 168usize];
     ["Alignment of QUIC_SETTINGS"][::std::mem::align_of::<QUIC_SETTINGS>() - 8usize];
     ["Offset of field: QUIC_SETTINGS::MaxBytesPerKey"]
         [::std::mem::offset_of!(QUIC_SETTINGS, MaxBytesPerKey) - 8usize];
@@ -4289,6 +5612,18 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_SETTINGS, StreamRecvWindowBidiRemoteDefault) - 132usize];
     ["Offset of field: QUIC_SETTINGS::StreamRecvWindowUnidiDefault"]
         [::std::mem::offset_of!(QUIC_SETTINGS, StreamRecvWindowUnidiDefault) - 136usize];
+    ["Offset of field: QUIC_SETTINGS::IdleTimerSlackMs"]
+        [::std::mem::offset_of!(QUIC_SETTINGS, IdleTimerSlackMs) - 140usize];
+    ["Offset of field: QUIC_SETTINGS::KeepAliveTimerSlackMs"]
+        [::std::mem::offset_of!(QUIC_SETTINGS, KeepAliveTimerSlackMs) - 144usize];
+    ["Offset of field: QUIC_SETTINGS::ShutdownTimerSlackMs"]
+        [::std::mem::offset_of!(QUIC_SETTINGS, ShutdownTimerSlackMs) - 148usize];
+    ["Offset of field: QUIC_SETTINGS::AckDecimationMaxPackets"]
+        [::std::mem::offset_of!(QUIC_SETTINGS, AckDecimationMaxPackets) - 152usize];
+    ["Offset of field: QUIC_SETTINGS::PacingBurstPackets"]
+        [::std::mem::offset_of!(QUIC_SETTINGS, PacingBurstPackets) - 156usize];
+    ["Offset of field: QUIC_SETTINGS::IdleHibernateTimeoutMs"]
+        [::std::mem::offset_of!(QUIC_SETTINGS, IdleHibernateTimeoutMs) - 160usize];
 };
 impl QUIC_SETTINGS {
     #[inline]
@@ -4888,6 +6223,41 @@ const _: () = {
     ["Offset of field: QUIC_STREAM_STATISTICS::StreamBlockedByAppUs"]
         [::std::mem::offset_of!(QUIC_STREAM_STATISTICS, StreamBlockedByAppUs) - 56usize];
 };
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_STREAM_URGENCY {
+    pub Urgency: u8,
+    pub Incremental: BOOLEAN,
+    pub Weight: u8,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_STREAM_URGENCY"][::std::mem::size_of::<QUIC_STREAM_URGENCY>() - 3usize];
+    ["Alignment of QUIC_STREAM_URGENCY"][::std::mem::align_of::<QUIC_STREAM_URGENCY>() - 1usize];
+    ["Offset of field: QUIC_STREAM_URGENCY::Urgency"]
+        [::std::mem::offset_of!(QUIC_STREAM_URGENCY, Urgency) - 0usize];
+    ["Offset of field: QUIC_STREAM_URGENCY::Incremental"]
+        [::std::mem::offset_of!(QUIC_STREAM_URGENCY, Incremental) - 1usize];
+    ["Offset of field: QUIC_STREAM_URGENCY::Weight"]
+        [::std::mem::offset_of!(QUIC_STREAM_URGENCY, Weight) - 2usize];
+};
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_STREAM_RECEIVE_BATCHING {
+    pub Threshold: u32,
+    pub TimeoutUs: u32,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_STREAM_RECEIVE_BATCHING"]
+        [::std::mem::size_of::<QUIC_STREAM_RECEIVE_BATCHING>() - 8usize];
+    ["Alignment of QUIC_STREAM_RECEIVE_BATCHING"]
+        [::std::mem::align_of::<QUIC_STREAM_RECEIVE_BATCHING>() - 4usize];
+    ["Offset of field: QUIC_STREAM_RECEIVE_BATCHING::Threshold"]
+        [::std::mem::offset_of!(QUIC_STREAM_RECEIVE_BATCHING, Threshold) - 0usize];
+    ["Offset of field: QUIC_STREAM_RECEIVE_BATCHING::TimeoutUs"]
+        [::std::mem::offset_of!(QUIC_STREAM_RECEIVE_BATCHING, TimeoutUs) - 4usize];
+};
 pub const QUIC_AEAD_ALGORITHM_TYPE_QUIC_AEAD_ALGORITHM_AES_128_GCM: QUIC_AEAD_ALGORITHM_TYPE = 0;
 pub const QUIC_AEAD_ALGORITHM_TYPE_QUIC_AEAD_ALGORITHM_AES_256_GCM: QUIC_AEAD_ALGORITHM_TYPE = 1;
 pub type QUIC_AEAD_ALGORITHM_TYPE = ::std::os::raw::c_uint;
@@ -5010,6 +6380,8 @@ pub const QUIC_LISTENER_EVENT_TYPE_QUIC_LISTENER_EVENT_NEW_CONNECTION: QUIC_LIST
 pub const QUIC_LISTENER_EVENT_TYPE_QUIC_LISTENER_EVENT_STOP_COMPLETE: QUIC_LISTENER_EVENT_TYPE = 1;
 pub const QUIC_LISTENER_EVENT_TYPE_QUIC_LISTENER_EVENT_DOS_MODE_CHANGED: QUIC_LISTENER_EVENT_TYPE =
     2;
+pub const QUIC_LISTENER_EVENT_TYPE_QUIC_LISTENER_EVENT_NEW_CONNECTIONS: QUIC_LISTENER_EVENT_TYPE =
+    3;
 pub type QUIC_LISTENER_EVENT_TYPE = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Copy, Clone)]
@@ -5023,6 +6395,7 @@ pub union QUIC_LISTENER_EVENT__bindgen_ty_1 {
     pub NEW_CONNECTION: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_1,
     pub STOP_COMPLETE: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_2,
     pub DOS_MODE_CHANGED: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_3,
+    pub NEW_CONNECTIONS: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4,
 }
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -5237,10 +6610,37 @@ impl QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_3 {
         __bindgen_bitfield_unit
     }
 }
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4 {
+    pub Count: u32,
+    pub Connections: *const HQUIC,
+    pub Infos: *const *const QUIC_NEW_CONNECTION_INFO,
+    pub Statuses: *mut ::std::os::raw::c_uint,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4"]
+        [::std::mem::size_of::<QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4>() - 32usize];
+    ["Alignment of QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4"]
+        [::std::mem::align_of::<QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4>() - 8usize];
+    ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4::Count"]
+        [::std::mem::offset_of!(QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4, Count) - 0usize];
+    ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4::Connections"][::std::mem::offset_of!(
+        QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4,
+        Connections
+    ) - 8usize];
+    ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4::Infos"]
+        [::std::mem::offset_of!(QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4, Infos) - 16usize];
+    ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4::Statuses"][::std::mem::offset_of!(
+        QUIC_LISTENER_EVENT__bindgen_ty_1__bindgen_ty_4,
+        Statuses
+    ) - 24usize];
+};
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
     ["Size of QUIC_LISTENER_EVENT__bindgen_ty_1"]
-        [::std::mem::size_of::<QUIC_LISTENER_EVENT__bindgen_ty_1>() - 16usize];
+        [::std::mem::size_of::<QUIC_LISTENER_EVENT__bindgen_ty_1>() - 32usize];
     ["Alignment of QUIC_LISTENER_EVENT__bindgen_ty_1"]
         [::std::mem::align_of::<QUIC_LISTENER_EVENT__bindgen_ty_1>() - 8usize];
     ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1::NEW_CONNECTION"]
@@ -5249,10 +6649,12 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_LISTENER_EVENT__bindgen_ty_1, STOP_COMPLETE) - 0usize];
     ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1::DOS_MODE_CHANGED"]
         [::std::mem::offset_of!(QUIC_LISTENER_EVENT__bindgen_ty_1, DOS_MODE_CHANGED) - 0usize];
+    ["Offset of field: QUIC_LISTENER_EVENT__bindgen_ty_1::NEW_CONNECTIONS"]
+        [::std::mem::offset_of!(QUIC_LISTENER_EVENT__bindgen_ty_1, NEW_CONNECTIONS) - 0usize];
 };
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_LISTENER_EVENT"][::std::mem::size_of::<QUIC_LISTENER_EVENT>() - 24usize];
+    ["Size of QUIC_LISTENER_EVENT"][::std::mem::size_of::<QUIC_LISTENER_EVENT>() - 40usize];
     ["Alignment of QUIC_LISTENER_EVENT"][::std::mem::align_of::<QUIC_LISTENER_EVENT>() - 8usize];
     ["Offset of field: QUIC_LISTENER_EVENT::Type"]
         [::std::mem::offset_of!(QUIC_LISTENER_EVENT, Type) - 0usize];
@@ -5320,6 +6722,8 @@ pub const QUIC_CONNECTION_EVENT_TYPE_QUIC_CONNECTION_EVENT_ONE_WAY_DELAY_NEGOTIA
     QUIC_CONNECTION_EVENT_TYPE = 17;
 pub const QUIC_CONNECTION_EVENT_TYPE_QUIC_CONNECTION_EVENT_NETWORK_STATISTICS:
     QUIC_CONNECTION_EVENT_TYPE = 18;
+pub const QUIC_CONNECTION_EVENT_TYPE_QUIC_CONNECTION_EVENT_DATAGRAMS_RECEIVED:
+    QUIC_CONNECTION_EVENT_TYPE = 19;
 pub type QUIC_CONNECTION_EVENT_TYPE = ::std::os::raw::c_uint;
 #[repr(C)]
 #[derive(Copy, Clone)]
@@ -5349,6 +6753,7 @@ pub union QUIC_CONNECTION_EVENT__bindgen_ty_1 {
     pub RELIABLE_RESET_NEGOTIATED: QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_17,
     pub ONE_WAY_DELAY_NEGOTIATED: QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_18,
     pub NETWORK_STATISTICS: QUIC_NETWORK_STATISTICS,
+    pub DATAGRAMS_RECEIVED: QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19,
 }
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -5852,6 +7257,35 @@ const _: () = {
     )
         - 1usize];
 };
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19 {
+    pub Buffers: *const QUIC_BUFFER,
+    pub BufferCount: u32,
+    pub Flags: QUIC_RECEIVE_FLAGS,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19"]
+        [::std::mem::size_of::<QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19>() - 16usize];
+    ["Alignment of QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19"]
+        [::std::mem::align_of::<QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19>() - 8usize];
+    ["Offset of field: QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19::Buffers"][::std::mem::offset_of!(
+        QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19,
+        Buffers
+    )
+        - 0usize];
+    ["Offset of field: QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19::BufferCount"][::std::mem::offset_of!(
+        QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19,
+        BufferCount
+    )
+        - 8usize];
+    ["Offset of field: QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19::Flags"][::std::mem::offset_of!(
+        QUIC_CONNECTION_EVENT__bindgen_ty_1__bindgen_ty_19,
+        Flags
+    )
+        - 12usize];
+};
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
     ["Size of QUIC_CONNECTION_EVENT__bindgen_ty_1"]
@@ -5922,6 +7356,8 @@ const _: () = {
     ) - 0usize];
     ["Offset of field: QUIC_CONNECTION_EVENT__bindgen_ty_1::NETWORK_STATISTICS"]
         [::std::mem::offset_of!(QUIC_CONNECTION_EVENT__bindgen_ty_1, NETWORK_STATISTICS) - 0usize];
+    ["Offset of field: QUIC_CONNECTION_EVENT__bindgen_ty_1::DATAGRAMS_RECEIVED"]
+        [::std::mem::offset_of!(QUIC_CONNECTION_EVENT__bindgen_ty_1, DATAGRAMS_RECEIVED) - 0usize];
 };
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
@@ -6549,6 +7985,49 @@ pub type QUIC_STREAM_PROVIDE_RECEIVE_BUFFERS_FN = ::std::option::Option<
         Buffers: *const QUIC_BUFFER,
     ) -> ::std::os::raw::c_uint,
 >;
+pub type QUIC_STREAM_START_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        StreamCount: u32,
+        Streams: *const HQUIC,
+        Flags: QUIC_STREAM_START_FLAGS,
+    ) -> ::std::os::raw::c_uint,
+>;
+pub const QUIC_DATAGRAM_PRIORITY_CLASS_COUNT: u32 = 4;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_DATAGRAM_SEND_DESC {
+    pub Buffers: *const QUIC_BUFFER,
+    pub BufferCount: u32,
+    pub Flags: QUIC_SEND_FLAGS,
+    pub DeadlineMs: u32,
+    pub PriorityClass: u8,
+    pub ClientContext: *mut ::std::os::raw::c_void,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_DATAGRAM_SEND_DESC"][::std::mem::size_of::<QUIC_DATAGRAM_SEND_DESC>() - 32usize];
+    ["Alignment of QUIC_DATAGRAM_SEND_DESC"]
+        [::std::mem::align_of::<QUIC_DATAGRAM_SEND_DESC>() - 8usize];
+    ["Offset of field: QUIC_DATAGRAM_SEND_DESC::Buffers"]
+        [::std::mem::offset_of!(QUIC_DATAGRAM_SEND_DESC, Buffers) - 0usize];
+    ["Offset of field: QUIC_DATAGRAM_SEND_DESC::BufferCount"]
+        [::std::mem::offset_of!(QUIC_DATAGRAM_SEND_DESC, BufferCount) - 8usize];
+    ["Offset of field: QUIC_DATAGRAM_SEND_DESC::Flags"]
+        [::std::mem::offset_of!(QUIC_DATAGRAM_SEND_DESC, Flags) - 12usize];
+    ["Offset of field: QUIC_DATAGRAM_SEND_DESC::DeadlineMs"]
+        [::std::mem::offset_of!(QUIC_DATAGRAM_SEND_DESC, DeadlineMs) - 16usize];
+    ["Offset of field: QUIC_DATAGRAM_SEND_DESC::PriorityClass"]
+        [::std::mem::offset_of!(QUIC_DATAGRAM_SEND_DESC, PriorityClass) - 20usize];
+    ["Offset of field: QUIC_DATAGRAM_SEND_DESC::ClientContext"]
+        [::std::mem::offset_of!(QUIC_DATAGRAM_SEND_DESC, ClientContext) - 24usize];
+};
+pub type QUIC_DATAGRAM_SEND_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Connection: HQUIC,
+        DatagramCount: u32,
+        Datagrams: *const QUIC_DATAGRAM_SEND_DESC,
+    ) -> ::std::os::raw::c_uint,
+>;
 pub type QUIC_DATAGRAM_SEND_FN = ::std::option::Option<
     unsafe extern "C" fn(
         Connection: HQUIC,
@@ -6561,6 +8040,8 @@ pub type QUIC_DATAGRAM_SEND_FN = ::std::option::Option<
 pub const QUIC_CONNECTION_POOL_FLAGS_QUIC_CONNECTION_POOL_FLAG_NONE: QUIC_CONNECTION_POOL_FLAGS = 0;
 pub const QUIC_CONNECTION_POOL_FLAGS_QUIC_CONNECTION_POOL_FLAG_CLOSE_ON_FAILURE:
     QUIC_CONNECTION_POOL_FLAGS = 1;
+pub const QUIC_CONNECTION_POOL_FLAGS_QUIC_CONNECTION_POOL_FLAG_SHARE_RESUMPTION_TICKET:
+    QUIC_CONNECTION_POOL_FLAGS = 2;
 pub type QUIC_CONNECTION_POOL_FLAGS = ::std::os::raw::c_uint;
 #[repr(C)]
 pub struct QUIC_CONNECTION_POOL_CONFIG {
@@ -6576,11 +8057,13 @@ pub struct QUIC_CONNECTION_POOL_CONFIG {
     pub CibirIds: *mut *mut u8,
     pub CibirIdLength: u8,
     pub Flags: QUIC_CONNECTION_POOL_FLAGS,
+    pub ResumptionTicket: *const u8,
+    pub ResumptionTicketLength: u32,
 }
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
     ["Size of QUIC_CONNECTION_POOL_CONFIG"]
-        [::std::mem::size_of::<QUIC_CONNECTION_POOL_CONFIG>() - 72usize];
+        [::std::mem::size_of::<QUIC_CONNECTION_POOL_CONFIG>() - 88usize];
     ["Alignment of QUIC_CONNECTION_POOL_CONFIG"]
         [::std::mem::align_of::<QUIC_CONNECTION_POOL_CONFIG>() - 8usize];
     ["Offset of field: QUIC_CONNECTION_POOL_CONFIG::Registration"]
@@ -6607,6 +8090,10 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_CONNECTION_POOL_CONFIG, CibirIdLength) - 64usize];
     ["Offset of field: QUIC_CONNECTION_POOL_CONFIG::Flags"]
         [::std::mem::offset_of!(QUIC_CONNECTION_POOL_CONFIG, Flags) - 68usize];
+    ["Offset of field: QUIC_CONNECTION_POOL_CONFIG::ResumptionTicket"]
+        [::std::mem::offset_of!(QUIC_CONNECTION_POOL_CONFIG, ResumptionTicket) - 72usize];
+    ["Offset of field: QUIC_CONNECTION_POOL_CONFIG::ResumptionTicketLength"]
+        [::std::mem::offset_of!(QUIC_CONNECTION_POOL_CONFIG, ResumptionTicketLength) - 80usize];
 };
 pub type QUIC_CONN_POOL_CREATE_FN = ::std::option::Option<
     unsafe extern "C" fn(
@@ -6614,6 +8101,77 @@ pub type QUIC_CONN_POOL_CREATE_FN = ::std::option::Option<
         ConnectionPool: *mut HQUIC,
     ) -> ::std::os::raw::c_uint,
 >;
+pub type QUIC_CONN_POOL_OPEN_FN = ::std::option::Option<
+    unsafe extern "C" fn(Config: *mut QUIC_CONNECTION_POOL_CONFIG, Pool: *mut HQUIC) -> ::std::os::raw::c_uint,
+>;
+pub type QUIC_CONN_POOL_CLOSE_FN = ::std::option::Option<unsafe extern "C" fn(Pool: HQUIC)>;
+pub type QUIC_CONN_POOL_ACQUIRE_FN = ::std::option::Option<
+    unsafe extern "C" fn(Pool: HQUIC, Connection: *mut HQUIC) -> ::std::os::raw::c_uint,
+>;
+pub type QUIC_CONN_POOL_RELEASE_FN =
+    ::std::option::Option<unsafe extern "C" fn(Pool: HQUIC, Connection: HQUIC)>;
+pub type QUIC_CONNECTION_SET_CONFIGURATION_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        ConnectionCount: u32,
+        Connections: *const HQUIC,
+        Configuration: HQUIC,
+    ) -> ::std::os::raw::c_uint,
+>;
+pub type QUIC_CONNECTION_EXECUTE_HANDLER = ::std::option::Option<
+    unsafe extern "C" fn(
+        Connection: HQUIC,
+        Context: *mut ::std::os::raw::c_void,
+        Status: ::std::os::raw::c_uint,
+    ),
+>;
+pub type QUIC_CONNECTION_EXECUTE_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Connection: HQUIC,
+        Handler: QUIC_CONNECTION_EXECUTE_HANDLER,
+        Context: *mut ::std::os::raw::c_void,
+    ) -> ::std::os::raw::c_uint,
+>;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct QUIC_STREAM_SEND_DESC {
+    pub Stream: HQUIC,
+    pub Buffers: *const QUIC_BUFFER,
+    pub BufferCount: u32,
+    pub Flags: QUIC_SEND_FLAGS,
+    pub ClientSendContext: *mut ::std::os::raw::c_void,
+}
+#[allow(clippy::unnecessary_operation, clippy::identity_op)]
+const _: () = {
+    ["Size of QUIC_STREAM_SEND_DESC"][::std::mem::size_of::<QUIC_STREAM_SEND_DESC>() - 32usize];
+    ["Alignment of QUIC_STREAM_SEND_DESC"]
+        [::std::mem::align_of::<QUIC_STREAM_SEND_DESC>() - 8usize];
+    ["Offset of field: QUIC_STREAM_SEND_DESC::Stream"]
+        [::std::mem::offset_of!(QUIC_STREAM_SEND_DESC, Stream) - 0usize];
+    ["Offset of field: QUIC_STREAM_SEND_DESC::Buffers"]
+        [::std::mem::offset_of!(QUIC_STREAM_SEND_DESC, Buffers) - 8usize];
+    ["Offset of field: QUIC_STREAM_SEND_DESC::BufferCount"]
+        [::std::mem::offset_of!(QUIC_STREAM_SEND_DESC, BufferCount) - 16usize];
+    ["Offset of field: QUIC_STREAM_SEND_DESC::Flags"]
+        [::std::mem::offset_of!(QUIC_STREAM_SEND_DESC, Flags) - 20usize];
+    ["Offset of field: QUIC_STREAM_SEND_DESC::ClientSendContext"]
+        [::std::mem::offset_of!(QUIC_STREAM_SEND_DESC, ClientSendContext) - 24usize];
+};
+pub type QUIC_STREAM_SEND_BATCH_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        SendCount: u32,
+        Sends: *const QUIC_STREAM_SEND_DESC,
+    ) -> ::std::os::raw::c_uint,
+>;
+pub type QUIC_STREAM_SEND_FILE_FN = ::std::option::Option<
+    unsafe extern "C" fn(
+        Stream: HQUIC,
+        File: QUIC_FILE_HANDLE,
+        Offset: u64,
+        Length: u32,
+        Flags: QUIC_SEND_FLAGS,
+        ClientSendContext: *mut ::std::os::raw::c_void,
+    ) -> ::std::os::raw::c_uint,
+>;
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct QUIC_API_TABLE {
@@ -6655,10 +8213,20 @@ pub struct QUIC_API_TABLE {
     pub ExecutionDelete: QUIC_EXECUTION_DELETE_FN,
     pub ExecutionPoll: QUIC_EXECUTION_POLL_FN,
     pub RegistrationClose2: QUIC_REGISTRATION_CLOSE2_FN,
+    pub StreamStartBatch: QUIC_STREAM_START_BATCH_FN,
+    pub DatagramSendBatch: QUIC_DATAGRAM_SEND_BATCH_FN,
+    pub ConnectionPoolOpen: QUIC_CONN_POOL_OPEN_FN,
+    pub ConnectionPoolClose: QUIC_CONN_POOL_CLOSE_FN,
+    pub ConnectionPoolAcquire: QUIC_CONN_POOL_ACQUIRE_FN,
+    pub ConnectionPoolRelease: QUIC_CONN_POOL_RELEASE_FN,
+    pub ConnectionSetConfigurationBatch: QUIC_CONNECTION_SET_CONFIGURATION_BATCH_FN,
+    pub ConnectionExecute: QUIC_CONNECTION_EXECUTE_FN,
+    pub StreamSendBatch: QUIC_STREAM_SEND_BATCH_FN,
+    pub StreamSendFile: QUIC_STREAM_SEND_FILE_FN,
 }
 #[allow(clippy::unnecessary_operation, clippy::identity_op)]
 const _: () = {
-    ["Size of QUIC_API_TABLE"][::std::mem::size_of::<QUIC_API_TABLE>() - 304usize];
+    ["Size of QUIC_API_TABLE"][::std::mem::size_of::<QUIC_API_TABLE>() - 384usize];
     ["Alignment of QUIC_API_TABLE"][::std::mem::align_of::<QUIC_API_TABLE>() - 8usize];
     ["Offset of field: QUIC_API_TABLE::SetContext"]
         [::std::mem::offset_of!(QUIC_API_TABLE, SetContext) - 0usize];
@@ -6740,6 +8308,26 @@ const _: () = {
         [::std::mem::offset_of!(QUIC_API_TABLE, ExecutionPoll) - 288usize];
     ["Offset of field: QUIC_API_TABLE::RegistrationClose2"]
         [::std::mem::offset_of!(QUIC_API_TABLE, RegistrationClose2) - 296usize];
+    ["Offset of field: QUIC_API_TABLE::StreamStartBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, StreamStartBatch) - 304usize];
+    ["Offset of field: QUIC_API_TABLE::DatagramSendBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, DatagramSendBatch) - 312usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionPoolOpen"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionPoolOpen) - 320usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionPoolClose"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionPoolClose) - 328usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionPoolAcquire"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionPoolAcquire) - 336usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionPoolRelease"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionPoolRelease) - 344usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionSetConfigurationBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionSetConfigurationBatch) - 352usize];
+    ["Offset of field: QUIC_API_TABLE::ConnectionExecute"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, ConnectionExecute) - 360usize];
+    ["Offset of field: QUIC_API_TABLE::StreamSendBatch"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, StreamSendBatch) - 368usize];
+    ["Offset of field: QUIC_API_TABLE::StreamSendFile"]
+        [::std::mem::offset_of!(QUIC_API_TABLE, StreamSendFile) - 376usize];
 };
 pub const QUIC_STATUS_SUCCESS: QUIC_STATUS = 0;
 pub const QUIC_STATUS_PENDING: QUIC_STATUS = 4294967294;
@@ -11,6 +11,7 @@ use c_types::{sa_family_t, sockaddr_in, sockaddr_in6, socklen_t};
 use ffi::{HQUIC, QUIC_API_TABLE, QUIC_BUFFER, QUIC_CREDENTIAL_CONFIG, QUIC_SETTINGS, QUIC_STATUS};
 use libc::c_void;
 use socket2::SockAddr;
+use std::cell::Cell;
 use std::fmt::Debug;
 use std::io;
 use std::mem;
@@ -30,6 +31,8 @@ pub use types::{
 };
 mod settings;
 pub use settings::{ServerResumptionLevel, Settings};
+#[cfg(feature = "async")]
+pub mod aio;
 mod config;
 pub use config::{
     AllowedCipherSuiteFlags, CertificateFile, CertificateFileProtected, CertificateHash,
@@ -164,7 +167,8 @@ pub const SEND_RESUMPTION_FLAG_FINAL: SendResumptionFlags = 1;
 pub type StreamSchedulingScheme = u32;
 pub const STREAM_SCHEDULING_SCHEME_FIFO: StreamSchedulingScheme = 0;
 pub const STREAM_SCHEDULING_SCHEME_ROUND_ROBIN: StreamSchedulingScheme = 1;
-pub const STREAM_SCHEDULING_SCHEME_COUNT: StreamSchedulingScheme = 2;
+pub const STREAM_SCHEDULING_SCHEME_URGENCY: StreamSchedulingScheme = 2;
+pub const STREAM_SCHEDULING_SCHEME_COUNT: StreamSchedulingScheme = 3;
 
 /// Key information for TLS session ticket encryption.
 #[repr(C)]
@@ -1140,6 +1144,12 @@ define_quic_handle_ctx_fn!(Listener, ListenerCallback);
 /// msquic never executes stream callback on the same stream in parallel.
 pub type StreamCallback = dyn FnMut(StreamRef, StreamEvent) -> Result<(), Status> + 'static;
 
+thread_local! {
+    /// Set by [Stream::lend_receive] during the stream callback, so it returns
+    /// QUIC_STATUS_PENDING and msquic keeps the buffers.
+    static RECEIVE_LENT: Cell<bool> = const { Cell::new(false) };
+}
+
 extern "C" fn raw_stream_callback(
     stream: HQUIC,
     context: *mut c_void,
@@ -1152,7 +1162,12 @@ extern "C" fn raw_stream_callback(
     };
     let stream_ref = unsafe { StreamRef::from_raw(stream) };
     let event = StreamEvent::from(unsafe { event.as_mut().expect("cannot get event ref") });
-    match f(stream_ref, event) {
+    // Callbacks can nest (e.g. inline shutdown), so save the outer one's flag.
+    let outer_lent = RECEIVE_LENT.replace(false);
+    let result = f(stream_ref, event);
+    let lent = RECEIVE_LENT.replace(outer_lent);
+    match result {
+        Ok(_) if lent => StatusCode::QUIC_STATUS_PENDING.into(),
         Ok(_) => StatusCode::QUIC_STATUS_SUCCESS.into(),
         Err(e) => e.0,
     }
@@ -1253,6 +1268,38 @@ impl Stream {
         unsafe { Api::ffi_ref().StreamReceiveComplete.unwrap()(self.handle, buffer_length) }
     }
 
+    /// Resumes (or pauses) receive callbacks. They are paused after
+    /// [Stream::receive_complete] takes less than all of the received data.
+    pub fn receive_set_enabled(&self, enabled: bool) -> Result<(), Status> {
+        let status = unsafe {
+            Api::ffi_ref().StreamReceiveSetEnabled.unwrap()(self.handle, enabled as BOOLEAN)
+        };
+        Status::ok_from_raw(status)
+    }
+
+    /// Keeps the buffers of a [StreamEvent::Receive] past the callback, without
+    /// copying them: the callback returns QUIC_STATUS_PENDING, and the receive
+    /// is completed when the guard is dropped. No more data is received
+    /// meanwhile, so msquic keeps batching the data that arrives.
+    ///
+    /// # Safety
+    /// Only call from the stream's receive callback, with the event's buffers
+    /// and total length, and at most once per event. The stream must not be
+    /// closed before the guard is dropped.
+    pub unsafe fn lend_receive(
+        &self,
+        buffers: &[BufferRef],
+        total_buffer_length: u64,
+    ) -> ReceiveGuard {
+        RECEIVE_LENT.set(true);
+        ReceiveGuard {
+            stream: self.handle,
+            buffers: buffers.iter().map(|b| b.0).collect(),
+            length: total_buffer_length,
+            consumed: total_buffer_length,
+        }
+    }
+
     pub fn get_stream_id(&self) -> Result<u64, Status> {
         unsafe { Api::get_param_auto(self.handle, ffi::QUIC_PARAM_STREAM_ID) }
     }
@@ -1262,6 +1309,54 @@ define_quic_handle_impl!(Stream);
 define_quic_handle_ref!(Stream, StreamRef);
 define_quic_handle_ctx_fn!(Stream, StreamCallback);
 
+/// Received buffers lent out of the receive callback by [Stream::lend_receive].
+/// Dropping the guard completes the receive with the bytes consumed (all of
+/// them, unless [ReceiveGuard::consume] says otherwise); what is left is
+/// received again.
+#[derive(Debug)]
+pub struct ReceiveGuard {
+    stream: HQUIC,
+    buffers: Vec<QUIC_BUFFER>,
+    length: u64,
+    consumed: u64,
+}
+// msquic allows completing a receive from any thread.
+unsafe impl Send for ReceiveGuard {}
+unsafe impl Sync for ReceiveGuard {}
+
+impl ReceiveGuard {
+    /// The received buffers, in stream order.
+    pub fn buffers(&self) -> &[BufferRef] {
+        BufferRef::slice_from_ffi_ref(&self.buffers)
+    }
+
+    /// Total length of the buffers.
+    pub fn len(&self) -> u64 {
+        self.length
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.length == 0
+    }
+
+    /// Only complete the first `length` bytes.
+    pub fn consume(&mut self, length: u64) {
+        self.consumed = length.min(self.length);
+    }
+}
+
+impl Drop for ReceiveGuard {
+    fn drop(&mut self) {
+        unsafe {
+            Api::ffi_ref().StreamReceiveComplete.unwrap()(self.stream, self.consumed);
+            if self.consumed < self.length {
+                // msquic pauses receives after a partial completion.
+                Api::ffi_ref().StreamReceiveSetEnabled.unwrap()(self.stream, 1);
+            }
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
 
@@ -175,6 +175,14 @@ impl Settings {
     define_settings_entry_bitflag2!(set_NetStatsEventEnabled);
     #[cfg(feature = "preview-api")]
     define_settings_entry_bitflag2!(set_StreamMultiReceiveEnabled);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry_bitflag2!(set_DatacenterModeEnabled);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry_bitflag2!(set_FecEnabled);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry_bitflag2!(set_PathMetricsCacheEnabled);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry_bitflag2!(set_StreamZeroCopyReceiveEnabled);
 
     define_settings_entry!(
         set_StreamRecvWindowBidiLocalDefault,
@@ -191,6 +199,18 @@ impl Settings {
         StreamRecvWindowUnidiDefault,
         u32
     );
+    #[cfg(feature = "preview-api")]
+    define_settings_entry!(set_IdleTimerSlackMs, IdleTimerSlackMs, u32);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry!(set_KeepAliveTimerSlackMs, KeepAliveTimerSlackMs, u32);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry!(set_ShutdownTimerSlackMs, ShutdownTimerSlackMs, u32);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry!(set_AckDecimationMaxPackets, AckDecimationMaxPackets, u32);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry!(set_PacingBurstPackets, PacingBurstPackets, u32);
+    #[cfg(feature = "preview-api")]
+    define_settings_entry!(set_IdleHibernateTimeoutMs, IdleHibernateTimeoutMs, u32);
 }
 
 #[cfg(test)]